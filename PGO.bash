@@ -0,0 +1,52 @@
+#!/usr/bin/env bash
+
+# libRSF - A Robust Sensor Fusion Library
+#
+# Copyright (C) 2019 Chair of Automation Technology / TU Chemnitz
+# For more information see https://www.tu-chemnitz.de/etit/proaut/self-tuning
+#
+# libRSF is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# libRSF is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with libRSF.  If not, see <http://www.gnu.org/licenses/>.
+#
+# Author: Tim Pfeifer (tim.pfeifer@etit.tu-chemnitz.de)
+
+# This script builds the libRSF with profile-guided optimization:
+# 1. build instrumented binaries
+# 2. record profiles by running the applications on the bundled datasets
+# 3. rebuild with the profiles
+# Additional CMake options (e.g. -DLIBRSF_ENABLE_LTO=ON -DLIBRSF_ARCH=native) are passed through.
+
+# stop script on any error
+set -e
+
+PROFILE_DIR=$(pwd)/build/pgo
+
+# instrumented build
+mkdir -p build_pgo && cd build_pgo
+cmake -G "Unix Makefiles" -DCMAKE_BUILD_TYPE=Release -DLIBRSF_ENABLE_PGO=ON -DLIBRSF_PGO_PHASE=GENERATE -DLIBRSF_PGO_DIR="$PROFILE_DIR" "$@" ..
+make all -j$(getconf _NPROCESSORS_ONLN)
+
+# training run
+rm -rf "$PROFILE_DIR"
+make pgo_train
+cd ..
+
+# clang writes raw profiles that have to be merged
+if ls "$PROFILE_DIR"/*.profraw > /dev/null 2>&1; then
+  llvm-profdata merge -output="$PROFILE_DIR/default.profdata" "$PROFILE_DIR"/*.profraw
+fi
+
+# optimized build
+mkdir -p build && cd build
+cmake -G "Unix Makefiles" -DCMAKE_BUILD_TYPE=Release -DLIBRSF_ENABLE_PGO=ON -DLIBRSF_PGO_PHASE=USE -DLIBRSF_PGO_DIR="$PROFILE_DIR" "$@" ..
+make all -j$(getconf _NPROCESSORS_ONLN)
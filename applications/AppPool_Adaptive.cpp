@@ -23,24 +23,31 @@
 
 #include "AppPool_Adaptive.h"
 
+#include <algorithm>
+#include <functional>
+#include <vector>
 
-bool AdaptErrorModel(libRSF::FactorGraph &Graph,
-                     const libRSF::FactorGraphConfig &Config,
-                     libRSF::Data &IterationSummary)
+
+bool AdaptiveErrorModel::adapt(libRSF::FactorGraph &Graph,
+                               const libRSF::FactorGraphConfig &Config,
+                               libRSF::Data &IterationSummary)
 {
-  bool HasAdapted = false;
+  LIBRSF_TRACE_SCOPE("adapt");
 
   /** measure runtime */
   libRSF::Timer AdaptionTimer;
 
+  /** the models of different sensors are independent, so they are adapted concurrently */
+  std::vector<std::function<void()>> Tasks;
+
   if(Config.GNSS.IsActive)
   {
     if(Config.GNSS.ErrorModel.Type == libRSF::ErrorModelType::GMM)
     {
       if (Config.GNSS.ErrorModel.GMM.TuningType != libRSF::ErrorModelTuningType::None)
       {
-        AdaptGeneric1D(Graph, Config.GNSS.Type, Config.GNSS.ErrorModel, true, false);
-        HasAdapted = true;
+        Models1D_[Config.GNSS.Type];
+        Tasks.emplace_back([this, &Graph, &Config](){this->adaptGeneric1D_(Graph, Config.GNSS.Type, Config.GNSS.ErrorModel, true, false);});
       }
     }
   }
@@ -51,8 +58,8 @@ bool AdaptErrorModel(libRSF::FactorGraph &Graph,
     {
       if (Config.Ranging.ErrorModel.GMM.TuningType != libRSF::ErrorModelTuningType::None)
       {
-        AdaptGeneric1D(Graph, Config.Ranging.Type, Config.Ranging.ErrorModel, false, false);
-        HasAdapted = true;
+        Models1D_[Config.Ranging.Type];
+        Tasks.emplace_back([this, &Graph, &Config](){this->adaptGeneric1D_(Graph, Config.Ranging.Type, Config.Ranging.ErrorModel, false, false);});
       }
     }
   }
@@ -63,12 +70,17 @@ bool AdaptErrorModel(libRSF::FactorGraph &Graph,
     {
       if (Config.LoopClosure.ErrorModel.GMM.TuningType != libRSF::ErrorModelTuningType::None)
       {
-        AdaptGeneric2D(Graph, Config.LoopClosure.Type, Config.LoopClosure.ErrorModel, true);
-        HasAdapted = true;
+        Models2D_[Config.LoopClosure.Type];
+        Tasks.emplace_back([this, &Graph, &Config](){this->adaptGeneric2D_(Graph, Config.LoopClosure.Type, Config.LoopClosure.ErrorModel, true);});
       }
     }
   }
 
+  /** the maps are filled above, each task only touches the entry and the error models of its own factor type,
+   *  the only shared data is the raw error cache of the graph, which is synchronized */
+  libRSF::RunConcurrently(Tasks);
+  const bool HasAdapted = !Tasks.empty();
+
   /** save runtime */
   if (HasAdapted)
   {
@@ -80,19 +92,62 @@ bool AdaptErrorModel(libRSF::FactorGraph &Graph,
   return HasAdapted;
 }
 
-void AdaptGeneric1D(libRSF::FactorGraph &Graph,
-                  const libRSF::FactorType Factor,
-                  const libRSF::FactorGraphConfig::ErrorModelConfig &ErrorConfig,
-                  const bool RemoveOffset,
-                  const bool UseAsymmetricInit)
+AdaptionCallback::AdaptionCallback(AdaptiveErrorModel &Adaptive,
+                                   libRSF::FactorGraph &Graph,
+                                   const libRSF::FactorGraphConfig &Config,
+                                   libRSF::Data &IterationSummary,
+                                   const int Interval) :
+    Adaptive_(Adaptive), Graph_(Graph), Config_(Config), IterationSummary_(IterationSummary), Interval_(std::max(1, Interval))
 {
-  /** calculate error */
+}
+
+ceres::CallbackReturnType AdaptionCallback::operator()(const ceres::IterationSummary &Summary)
+{
+  /** iteration zero is the initial evaluation */
+  if (Summary.iteration > 0 && Summary.step_is_successful && Summary.iteration % Interval_ == 0)
+  {
+    Adaptive_.adapt(Graph_, Config_, IterationSummary_);
+  }
+  return ceres::SOLVER_CONTINUE;
+}
+
+void AdaptiveErrorModel::reset()
+{
+  Models1D_.clear();
+  Models2D_.clear();
+}
+
+void AdaptiveErrorModel::adaptGeneric1D_(libRSF::FactorGraph &Graph,
+                                         const libRSF::FactorType Factor,
+                                         const libRSF::FactorGraphConfig::ErrorModelConfig &ErrorConfig,
+                                         const bool RemoveOffset,
+                                         const bool UseAsymmetricInit)
+{
+  Model1D &Model = Models1D_[Factor];
+  libRSF::GaussianMixture<1> &GMM = Model.GMM;
+
+  /** calculate error, the online tuning uses only factors that were added since the last adaption */
+  double NewestTime = Model.LastAdaptedTime;
   libRSF::Matrix Error;
-  Graph.computeUnweightedErrorMatrix(Factor, Error);
+  if (ErrorConfig.GMM.OnlineTuning)
+  {
+    Graph.computeUnweightedErrorMatrix(Factor, Model.LastAdaptedTime, Error, NewestTime);
+  }
+  else
+  {
+    Graph.computeUnweightedErrorMatrix(Factor, Error);
+  }
 
   /** init model */
-  static libRSF::GaussianMixture<1> GMM;
-  if (ErrorConfig.GMM.IncrementalTuning && Error.size() > 0)
+  if (ErrorConfig.GMM.OnlineTuning)
+  {
+    /** keep the model, its statistics are updated incrementally */
+    if(GMM.getNumberOfComponents() == 0)
+    {
+      GMM.initSpread(ErrorConfig.GMM.NumberComponents, ErrorConfig.GMM.BaseStandardDeviation, UseAsymmetricInit);
+    }
+  }
+  else if (ErrorConfig.GMM.IncrementalTuning && Error.size() > 0)
   {
       /** add first component if empty */
       if(GMM.getNumberOfComponents() == 0)
@@ -129,7 +184,15 @@ void AdaptGeneric1D(libRSF::FactorGraph &Graph,
   Config.MergeSimilarComponents = false;
 
   /** adapt error model */
-  if(!GMM.estimate(Error, Config))
+  if (ErrorConfig.GMM.OnlineTuning)
+  {
+    if(!GMM.estimateOnline(Error, Config))
+    {
+      return;
+    }
+    Model.LastAdaptedTime = NewestTime;
+  }
+  else if(!GMM.estimate(Error, Config))
   {
     return;
   }
@@ -170,10 +233,10 @@ void AdaptGeneric1D(libRSF::FactorGraph &Graph,
   }
 }
 
-void AdaptGeneric2D(libRSF::FactorGraph &Graph,
-                    const libRSF::FactorType Factor,
-                    const libRSF::FactorGraphConfig::ErrorModelConfig &ErrorConfig,
-                    const bool EstimateMean)
+void AdaptiveErrorModel::adaptGeneric2D_(libRSF::FactorGraph &Graph,
+                                         const libRSF::FactorType Factor,
+                                         const libRSF::FactorGraphConfig::ErrorModelConfig &ErrorConfig,
+                                         const bool EstimateMean)
 {
   /** only tune with enough samples */
   if (Graph.countFactorsOfType(Factor) < 15)
@@ -186,7 +249,7 @@ void AdaptGeneric2D(libRSF::FactorGraph &Graph,
   Graph.computeUnweightedErrorMatrix(Factor, Error);
 
   /** init model */
-  static libRSF::GaussianMixture<2> GMM;
+  libRSF::GaussianMixture<2> &GMM = Models2D_[Factor];
 
   if (ErrorConfig.GMM.IncrementalTuning)
   {
@@ -34,19 +34,74 @@
 
 #include "libRSF.h"
 
-bool AdaptErrorModel(libRSF::FactorGraph &Graph,
+#include <limits>
+#include <map>
+
+/** \brief Adaptation state of the error models of one graph, one mixture per factor type.
+ *
+ * Each graph owns its own object, so independent graphs can be adapted in parallel.
+ */
+class AdaptiveErrorModel
+{
+  public:
+    AdaptiveErrorModel() = default;
+    ~AdaptiveErrorModel() = default;
+
+    /** adapt all configured error models of the graph, returns true if one was adapted */
+    bool adapt(libRSF::FactorGraph &Graph,
+               const libRSF::FactorGraphConfig &Config,
+               libRSF::Data &IterationSummary);
+
+    /** forget all learned mixtures */
+    void reset();
+
+  private:
+    void adaptGeneric1D_(libRSF::FactorGraph &Graph,
+                         libRSF::FactorType Factor,
+                         const libRSF::FactorGraphConfig::ErrorModelConfig &ErrorConfig,
+                         bool RemoveOffset,
+                         bool UseAsymmetricInit);
+
+    void adaptGeneric2D_(libRSF::FactorGraph &Graph,
+                         libRSF::FactorType Factor,
+                         const libRSF::FactorGraphConfig::ErrorModelConfig &ErrorConfig,
+                         bool EstimateMean);
+
+    struct Model1D
+    {
+      libRSF::GaussianMixture<1> GMM;
+      /** newest factor that was used by the online tuning */
+      double LastAdaptedTime = std::numeric_limits<double>::lowest();
+    };
+
+    std::map<libRSF::FactorType, Model1D> Models1D_;
+    std::map<libRSF::FactorType, libRSF::GaussianMixture<2>> Models2D_;
+};
+
+/** \brief Adapts the error models between the iterations of a running solve.
+ *
+ * Replaces the outer solve-adapt loop of batch problems. The errors are evaluated directly on the state
+ * memory, so the solver has to run with update_state_every_iteration. Only successful steps trigger an
+ * adaption, the first step after a new model is still compared with the cost of the old one.
+ */
+class AdaptionCallback : public ceres::IterationCallback
+{
+  public:
+    AdaptionCallback(AdaptiveErrorModel &Adaptive,
+                     libRSF::FactorGraph &Graph,
                      const libRSF::FactorGraphConfig &Config,
-                     libRSF::Data &IterationSummary);
-
-void AdaptGeneric1D(libRSF::FactorGraph &Graph,
-                    libRSF::FactorType Factor,
-                    const libRSF::FactorGraphConfig::ErrorModelConfig &ErrorConfig,
-                    bool RemoveOffset,
-                    bool UseAsymmetricInit);
-
-void AdaptGeneric2D(libRSF::FactorGraph &Graph,
-                    libRSF::FactorType Factor,
-                    const libRSF::FactorGraphConfig::ErrorModelConfig &ErrorConfig,
-                    bool EstimateMean);
+                     libRSF::Data &IterationSummary,
+                     int Interval);
+    ~AdaptionCallback() override = default;
+
+    ceres::CallbackReturnType operator()(const ceres::IterationSummary &Summary) override;
+
+  private:
+    AdaptiveErrorModel &Adaptive_;
+    libRSF::FactorGraph &Graph_;
+    const libRSF::FactorGraphConfig &Config_;
+    libRSF::Data &IterationSummary_;
+    int Interval_;
+};
 
 #endif // APPPOOL_ADAPTIVE_H
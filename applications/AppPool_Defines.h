@@ -39,6 +39,10 @@
 #define ORIENTATION_STATE "Orientation"
 #define ANGLE_STATE "Angle"
 
+/** background smoother next to a window or filter */
+#define POSITION_SMOOTHED_STATE "PositionSmoothed"
+#define ORIENTATION_SMOOTHED_STATE "OrientationSmoothed"
+
 /** helper variables for non-integrating IMU factor */
 #define ORIENTATION_IMU_STATE "OrientationIMU"
 #define POSITION_IMU_STATE "PositionIMU"
@@ -55,6 +59,7 @@
 
 /** run time */
 #define SOLVE_TIME_STATE "SolveTime"
+#define SOLVER_ITERATION_STATE "SolverIteration"
 
 /** for switchable constraints */
 #define SWITCH_STATE "Switch"
@@ -22,6 +22,15 @@
 
 #include "AppPool_Init.h"
 
+double PseudorangeQuality(const libRSF::Data &Pseudorange)
+{
+  const double Elevation = Pseudorange.getValue(libRSF::DataElement::SatElevation)(0) * M_PI / 180.0;
+  const double SNR = Pseudorange.getValue(libRSF::DataElement::SNR)(0);
+
+  /** SNR is zero in some datasets, so elevation still matters */
+  return std::sin(std::max(Elevation, 0.0)) * (1.0 + std::max(SNR, 0.0));
+}
+
 void PseudoRangeRANSAC(libRSF::FactorGraph &Graph,
                        const libRSF::FactorGraphConfig &Config,
                        const libRSF::SensorDataSet &Measurements,
@@ -46,7 +55,7 @@ void PseudoRangeRANSAC(libRSF::FactorGraph &Graph,
     SolverOptions.trust_region_strategy_type = ceres::TrustRegionStrategyType::DOGLEG;
     SolverOptions.dogleg_type = ceres::DoglegType::SUBSPACE_DOGLEG;
     SolverOptions.max_num_iterations = 15;
-    SolverOptions.num_threads = 1;
+    SolverOptions.num_threads = 1; /**< the hypotheses are already parallel */
 
     /** create uncertainty for priors */
     libRSF::GaussianDiagonal<3> GaussianPriorPos;
@@ -54,6 +63,13 @@ void PseudoRangeRANSAC(libRSF::FactorGraph &Graph,
     libRSF::GaussianDiagonal<1> GaussianPriorClock;
     GaussianPriorClock.setStdDevSharedDiagonal(30);
 
+    /** hypotheses are evaluated in parallel, each thread solves its own small problems */
+    const int ThreadNumber = std::max(1, std::min(Config.SolverConfig.num_threads, Iterations));
+
+    /** minimal set and the probability to draw at least one outlier free set */
+    constexpr int MinimalSet = 4;
+    constexpr double Confidence = 0.99;
+
     /** set up random generator */
     std::mt19937 Generator{std::random_device{}()};
 
@@ -67,7 +83,7 @@ void PseudoRangeRANSAC(libRSF::FactorGraph &Graph,
       double TimePosition, TimeClock;
       bool HasState;
       if (Graph.getStateData().getTimeBelowOrEqual(POSITION_STATE, Time, TimePosition) &&
-          Graph.getStateData().getTimeBelowOrEqual(POSITION_STATE, Time, TimeClock))
+          Graph.getStateData().getTimeBelowOrEqual(CLOCK_ERROR_STATE, Time, TimeClock))
       {
         HasState = true;
         OldPosition = Graph.getStateData().getElement(POSITION_STATE, TimePosition, 0).getMean();
@@ -75,26 +91,30 @@ void PseudoRangeRANSAC(libRSF::FactorGraph &Graph,
       }
       else
       {
+        HasState = false;
         OldPosition.setZero();
         OldClock.setZero();
       }
 
-      /** get current set of GNSS measurements */
-      const std::vector<libRSF::Data> PseudoRanges = Measurements.getElements(libRSF::DataType::Pseudorange3, Time);
-      const int DataSize = static_cast<int>(PseudoRanges.size());
-
-      /** create full graph */
-      libRSF::FactorGraph FullGraph;
-      FullGraph.addState(POSITION_STATE, libRSF::DataType::Point3, Time);
-      FullGraph.addState(CLOCK_ERROR_STATE, libRSF::DataType::ClockError, Time);
-      for (const libRSF::Data &PR : PseudoRanges)
+      /** get current set of GNSS measurements, sorted by quality for a PROSAC-like sampling */
+      std::vector<libRSF::Data> PseudoRanges = Measurements.getElements(libRSF::DataType::Pseudorange3, Time);
+      std::stable_sort(PseudoRanges.begin(), PseudoRanges.end(), [](const libRSF::Data &A, const libRSF::Data &B)
       {
-        AddPseudorange3(FullGraph, Config, PR,Time);
-      }
+        return PseudorangeQuality(A) > PseudorangeQuality(B);
+      });
+      const int DataSize = static_cast<int>(PseudoRanges.size());
 
-      /** find another initial guess if the current one is zero (not initialized)*/
+      /** find another initial guess with all measurements if the current one is zero (not initialized)*/
       if (OldPosition.isZero())
       {
+        libRSF::FactorGraph FullGraph;
+        FullGraph.addState(POSITION_STATE, libRSF::DataType::Point3, Time);
+        FullGraph.addState(CLOCK_ERROR_STATE, libRSF::DataType::ClockError, Time);
+        for (const libRSF::Data &PR : PseudoRanges)
+        {
+          AddPseudorange3(FullGraph, Config, PR,Time);
+        }
+
         FullGraph.solve(SolverOptions);
         OldPosition = FullGraph.getStateData().getElement(POSITION_STATE, Time, 0).getMean();
         OldClock = FullGraph.getStateData().getElement(CLOCK_ERROR_STATE, Time, 0).getMean();
@@ -106,82 +126,145 @@ void PseudoRangeRANSAC(libRSF::FactorGraph &Graph,
       libRSF::Data PriorClock(libRSF::DataType::ClockError, Time);
       PriorClock.setMean(OldClock);
 
-      /** set up partial optimization problem */
-      libRSF::FactorGraph PartialGraph;
-      PartialGraph.addState(POSITION_STATE, libRSF::DataType::Point3, Time);
-      PartialGraph.addState(CLOCK_ERROR_STATE, libRSF::DataType::ClockError, Time);
-      PartialGraph.addFactor<libRSF::FactorType::Prior3>(libRSF::StateID(POSITION_STATE, Time, 0), PriorPos, GaussianPriorPos);
-      PartialGraph.addFactor<libRSF::FactorType::Prior1>(libRSF::StateID(CLOCK_ERROR_STATE, Time, 0), PriorClock, GaussianPriorClock);
-
-      /** prepare index vector */
-      std::vector<int> Index;
-      Index.resize(DataSize);
-      std::iota(std::begin(Index), std::end(Index), 0);
-
-      /** RANSAC loop */
+      /** best hypothesis over all threads */
+      std::mutex BestMutex;
       double BestConsensus = 0;
       libRSF::Vector3 BestPosition = OldPosition;
       libRSF::Vector1 BestClock = OldClock;
-      for (int n = 0; n < Iterations; n++)
-      {
-        /** create random order */
-        std::shuffle(std::begin(Index), std::end(Index), Generator);
 
-        /** add random set of 4 pseudo ranges */
-        for (int m = 0; m < std::min(DataSize, 4); m++)
-        {
-          AddPseudorange3(PartialGraph, Config, PseudoRanges.at(Index.at(m)), Time);
-        }
+      /** shared iteration counter, the limit shrinks if a good hypothesis is found */
+      std::atomic<int> NextIteration(0);
+      std::atomic<int> RequiredIterations(Iterations);
 
-        /** use old state as initialization */
-        PartialGraph.getStateData().getElement(POSITION_STATE, Time, 0).setMean(OldPosition);
-        PartialGraph.getStateData().getElement(CLOCK_ERROR_STATE, Time, 0).setMean(OldClock);
+      /** the sampling pool grows from the best measurements to all of them within the first half */
+      const int GrowthIterations = std::max(1, Iterations / 2);
 
-        /** solve */
-        PartialGraph.solve(SolverOptions);
+      /** geometry of all satellites for the closed-form hypotheses */
+      const bool UseSagnac = (Config.GNSS.Type == libRSF::FactorType::Pseudorange3_ECEF);
+      std::vector<libRSF::Vector3> SatPositions;
+      std::vector<double> Ranges;
+      for (const libRSF::Data &PR : PseudoRanges)
+      {
+        SatPositions.emplace_back(PR.getValue(libRSF::DataElement::SatPos));
+        Ranges.push_back(PR.getMean()(0));
+      }
 
-        /** clean up */
-        PartialGraph.removeFactor(Config.GNSS.Type, Time);
+      /** a hypothesis needs a minimal set, otherwise only the refinement is done */
+      if (DataSize < MinimalSet)
+      {
+        RequiredIterations = 0;
+      }
 
-        /** apply the new estimation to the full graph*/
-        FullGraph.getStateData().getElement(POSITION_STATE, Time, 0).setMean(PartialGraph.getStateData().getElement(POSITION_STATE, Time, 0).getMean());
-        FullGraph.getStateData().getElement(CLOCK_ERROR_STATE, Time, 0).setMean(PartialGraph.getStateData().getElement(CLOCK_ERROR_STATE, Time, 0).getMean());
+      auto Hypothesize = [&](const unsigned int Seed)
+      {
+        std::mt19937 LocalGenerator{Seed};
 
-        /** get residual for all measurements from the full graph */
-        std::vector<double> CurrentResiduals;
-        FullGraph.computeUnweightedError(Config.GNSS.Type, CurrentResiduals);
+        std::vector<int> Index(DataSize);
+        std::vector<double> CurrentResiduals(DataSize);
 
-        /** evaluate true consensus */
-        double CurrentConsensus = 0;
-        for (const double Res : CurrentResiduals)
+        for (int n = NextIteration++; n < RequiredIterations; n = NextIteration++)
         {
-          /** normalize residual */
-          if (std::abs(Res) < Threshold)
+          /** draw a random minimal set from the currently best measurements */
+          const int PoolSize = std::min(DataSize, MinimalSet + (DataSize - MinimalSet) * n / GrowthIterations);
+          std::iota(std::begin(Index), std::end(Index), 0);
+          for (int m = 0; m < MinimalSet; m++)
           {
-            /** RANSAC */
-//            CurrentConsensus += 1.0;
+            std::uniform_int_distribution<int> Draw(m, PoolSize - 1);
+            std::swap(Index.at(m), Index.at(Draw(LocalGenerator)));
+          }
 
-            /** MSAC */
-            CurrentConsensus += 1 - std::abs(Res) / Threshold;
+          /** solve the minimal set in closed form */
+          libRSF::Matrix34 SatPos;
+          libRSF::Vector4 SetRanges;
+          for (int m = 0; m < MinimalSet; m++)
+          {
+            SatPos.col(m) = SatPositions.at(Index.at(m));
+            SetRanges(m) = Ranges.at(Index.at(m));
+          }
+
+          /** use old state as initialization */
+          libRSF::Vector3 Position = OldPosition;
+          double ClockError = OldClock(0);
+          if (!libRSF::SolveMinimalPseudoranges(SatPos, SetRanges, UseSagnac, Position, ClockError))
+          {
+            continue;
+          }
+          const libRSF::Vector1 Clock = libRSF::Vector1::Constant(ClockError);
+
+          /** get residual for all measurements */
+          for (int m = 0; m < DataSize; m++)
+          {
+            CurrentResiduals.at(m) = libRSF::PseudorangeError(Position, ClockError, SatPositions.at(m), Ranges.at(m), UseSagnac);
+          }
+
+          /** evaluate true consensus */
+          double CurrentConsensus = 0;
+          int Inliers = 0;
+          for (const double Res : CurrentResiduals)
+          {
+            /** normalize residual */
+            if (std::abs(Res) < Threshold)
+            {
+              /** RANSAC */
+//              CurrentConsensus += 1.0;
+
+              /** MSAC */
+              CurrentConsensus += 1 - std::abs(Res) / Threshold;
+              Inliers++;
+            }
+          }
+
+          /** store best result */
+          std::lock_guard<std::mutex> Lock(BestMutex);
+          if (CurrentConsensus > BestConsensus)
+          {
+            BestConsensus = CurrentConsensus;
+            BestPosition = Position;
+            BestClock = Clock;
+
+            /** terminate early, if an outlier free set was drawn with high probability */
+            const double InlierRatio = static_cast<double>(Inliers) / DataSize;
+            const double SetProbability = std::pow(InlierRatio, MinimalSet);
+            if (SetProbability >= 1.0)
+            {
+              RequiredIterations = std::min(RequiredIterations.load(), n + 1);
+            }
+            else if (SetProbability > 0.0)
+            {
+              const double Required = std::ceil(std::log(1.0 - Confidence) / std::log(1.0 - SetProbability));
+              if (Required < RequiredIterations)
+              {
+                RequiredIterations = std::max(n + 1, static_cast<int>(Required));
+              }
+            }
           }
         }
-        /** store best result */
-        if (CurrentConsensus > BestConsensus)
-        {
-          BestConsensus = CurrentConsensus;
-          BestPosition = PartialGraph.getStateData().getElement(POSITION_STATE, Time, 0).getMean();
-          BestClock = PartialGraph.getStateData().getElement(CLOCK_ERROR_STATE, Time, 0).getMean();
-        }
+      };
+
+      /** run hypotheses in parallel, each thread has its own seed */
+      std::vector<unsigned int> Seeds(ThreadNumber);
+      for (unsigned int &Seed : Seeds)
+      {
+        Seed = Generator();
       }
+      libRSF::GetThreadPool().parallelRun(ThreadNumber, [&](const size_t Thread)
+      {
+        Hypothesize(Seeds.at(Thread));
+      });
+
+      /** set up partial optimization problem for the refinement */
+      libRSF::FactorGraph PartialGraph;
+      PartialGraph.addState(POSITION_STATE, libRSF::DataType::Point3, Time);
+      PartialGraph.addState(CLOCK_ERROR_STATE, libRSF::DataType::ClockError, Time);
+      PartialGraph.addFactor<libRSF::FactorType::Prior3>(libRSF::StateID(POSITION_STATE, Time, 0), PriorPos, GaussianPriorPos);
+      PartialGraph.addFactor<libRSF::FactorType::Prior1>(libRSF::StateID(CLOCK_ERROR_STATE, Time, 0), PriorClock, GaussianPriorClock);
+      PartialGraph.getStateData().getElement(POSITION_STATE, Time, 0).setMean(BestPosition);
+      PartialGraph.getStateData().getElement(CLOCK_ERROR_STATE, Time, 0).setMean(BestClock);
 
-      /** refine the best result using the whole consensus set*/
-      std::vector<double> BestResiduals;
-      FullGraph.getStateData().getElement(POSITION_STATE, Time, 0).setMean(BestPosition);
-      FullGraph.getStateData().getElement(CLOCK_ERROR_STATE, Time, 0).setMean(BestClock);
-      FullGraph.computeUnweightedError(Config.GNSS.Type, BestResiduals);
-      for (int m = 0; m < static_cast<int>(BestResiduals.size()); m++)
+      /** refine the best result using the whole consensus set, only this step uses Ceres */
+      for (int m = 0; m < DataSize; m++)
       {
-        if (std::abs(BestResiduals.at(m)) < Threshold)
+        if (std::abs(libRSF::PseudorangeError(BestPosition, BestClock(0), SatPositions.at(m), Ranges.at(m), UseSagnac)) < Threshold)
         {
           AddPseudorange3(PartialGraph, Config, PseudoRanges.at(m), Time);
         }
@@ -208,6 +291,208 @@ void PseudoRangeRANSAC(libRSF::FactorGraph &Graph,
   }
 }
 
+bool PseudoRangeConsensus(const std::vector<libRSF::Data> &PseudoRanges,
+                          const bool UseSagnac,
+                          const int Iterations,
+                          const double Threshold,
+                          const unsigned int Seed,
+                          libRSF::Vector3 &Position,
+                          double &ClockError)
+{
+  constexpr int MinimalSet = 4;
+  constexpr double Confidence = 0.99;
+
+  /** sample the best satellites first */
+  std::vector<const libRSF::Data *> Sorted;
+  for (const libRSF::Data &PR : PseudoRanges)
+  {
+    Sorted.push_back(&PR);
+  }
+  std::stable_sort(Sorted.begin(), Sorted.end(), [](const libRSF::Data *A, const libRSF::Data *B)
+  {
+    return PseudorangeQuality(*A) > PseudorangeQuality(*B);
+  });
+
+  const int DataSize = static_cast<int>(Sorted.size());
+  if (DataSize < MinimalSet)
+  {
+    return false;
+  }
+
+  std::vector<libRSF::Vector3> SatPositions;
+  std::vector<double> Ranges;
+  for (const libRSF::Data *PR : Sorted)
+  {
+    SatPositions.emplace_back(PR->getValue(libRSF::DataElement::SatPos));
+    Ranges.push_back(PR->getMean()(0));
+  }
+
+  std::mt19937 Generator{Seed};
+  std::vector<int> Index(DataSize);
+  const int GrowthIterations = std::max(1, Iterations / 2);
+
+  double BestConsensus = 0;
+  libRSF::Vector3 BestPosition = Position;
+  double BestClock = ClockError;
+
+  int RequiredIterations = Iterations;
+  for (int n = 0; n < RequiredIterations; n++)
+  {
+    /** draw a random minimal set from the currently best measurements */
+    const int PoolSize = std::min(DataSize, MinimalSet + (DataSize - MinimalSet) * n / GrowthIterations);
+    std::iota(std::begin(Index), std::end(Index), 0);
+    for (int m = 0; m < MinimalSet; m++)
+    {
+      std::uniform_int_distribution<int> Draw(m, PoolSize - 1);
+      std::swap(Index.at(m), Index.at(Draw(Generator)));
+    }
+
+    libRSF::Matrix34 SatPos;
+    libRSF::Vector4 SetRanges;
+    for (int m = 0; m < MinimalSet; m++)
+    {
+      SatPos.col(m) = SatPositions.at(Index.at(m));
+      SetRanges(m) = Ranges.at(Index.at(m));
+    }
+
+    libRSF::Vector3 CurrentPosition = Position;
+    double CurrentClock = ClockError;
+    if (!libRSF::SolveMinimalPseudoranges(SatPos, SetRanges, UseSagnac, CurrentPosition, CurrentClock))
+    {
+      continue;
+    }
+
+    /** MSAC consensus over all measurements */
+    double CurrentConsensus = 0;
+    int Inliers = 0;
+    for (int m = 0; m < DataSize; m++)
+    {
+      const double Res = std::abs(libRSF::PseudorangeError(CurrentPosition, CurrentClock, SatPositions.at(m), Ranges.at(m), UseSagnac));
+      if (Res < Threshold)
+      {
+        CurrentConsensus += 1 - Res / Threshold;
+        Inliers++;
+      }
+    }
+
+    if (CurrentConsensus > BestConsensus)
+    {
+      BestConsensus = CurrentConsensus;
+      BestPosition = CurrentPosition;
+      BestClock = CurrentClock;
+
+      /** terminate early, if an outlier free set was drawn with high probability */
+      const double SetProbability = std::pow(static_cast<double>(Inliers) / DataSize, MinimalSet);
+      if (SetProbability >= 1.0)
+      {
+        break;
+      }
+      if (SetProbability > 0.0)
+      {
+        const double Required = std::ceil(std::log(1.0 - Confidence) / std::log(1.0 - SetProbability));
+        RequiredIterations = std::min(RequiredIterations, std::max(n + 1, static_cast<int>(Required)));
+      }
+    }
+  }
+
+  if (BestConsensus <= 0)
+  {
+    return false;
+  }
+
+  /** refine with the whole consensus set */
+  std::vector<libRSF::Vector3> InlierPositions;
+  std::vector<double> InlierRanges;
+  for (int m = 0; m < DataSize; m++)
+  {
+    if (std::abs(libRSF::PseudorangeError(BestPosition, BestClock, SatPositions.at(m), Ranges.at(m), UseSagnac)) < Threshold)
+    {
+      InlierPositions.push_back(SatPositions.at(m));
+      InlierRanges.push_back(Ranges.at(m));
+    }
+  }
+
+  libRSF::Vector3 RefinedPosition = BestPosition;
+  double RefinedClock = BestClock;
+  if (libRSF::SolvePseudoranges(InlierPositions, InlierRanges, UseSagnac, RefinedPosition, RefinedClock))
+  {
+    BestPosition = RefinedPosition;
+    BestClock = RefinedClock;
+  }
+
+  Position = BestPosition;
+  ClockError = BestClock;
+  return true;
+}
+
+int SolveEpochsWithGNSS(const libRSF::FactorGraphConfig &Config,
+                        const libRSF::SensorDataSet &Measurements,
+                        const double TimeStart,
+                        const double TimeEnd,
+                        const int Iterations,
+                        const double Threshold,
+                        GNSSEpochCache &Cache)
+{
+  Cache.clear();
+
+  std::vector<double> Times;
+  if (!Measurements.getTimesBetween(libRSF::DataType::Pseudorange3, TimeStart, TimeEnd, Times))
+  {
+    PRINT_WARNING("No pseudorange measurements available between ", TimeStart, " and ", TimeEnd, "!");
+    return 0;
+  }
+
+  const bool UseSagnac = (Config.GNSS.Type == libRSF::FactorType::Pseudorange3_ECEF);
+
+  /** epochs are independent, the seed depends only on the epoch to keep the result independent of the thread number */
+  std::vector<libRSF::Vector4> Solutions(Times.size());
+  std::vector<char> IsSolved(Times.size(), 0);
+  libRSF::GetThreadPool().parallelFor(Times.size(), [&](const size_t n)
+  {
+    const std::vector<libRSF::Data> PseudoRanges = Measurements.getElements(libRSF::DataType::Pseudorange3, Times[n]);
+
+    /** the origin is the tangent point in a local frame and converges from the earth center in ECEF */
+    libRSF::Vector3 Position = libRSF::Vector3::Zero();
+    double ClockError = 0.0;
+    if (PseudoRangeConsensus(PseudoRanges, UseSagnac, Iterations, Threshold, static_cast<unsigned int>(n), Position, ClockError))
+    {
+      Solutions[n] << Position, ClockError;
+      IsSolved[n] = 1;
+    }
+  }, Config.SolverConfig.num_threads);
+
+  int Solved = 0;
+  for (size_t n = 0; n < Times.size(); n++)
+  {
+    if (IsSolved[n] != 0)
+    {
+      Cache.emplace_hint(Cache.end(), Times[n], Solutions[n]);
+      Solved++;
+    }
+  }
+  return Solved;
+}
+
+void SeedWithGNSS(libRSF::FactorGraph &Graph,
+                  const GNSSEpochCache &Cache,
+                  const double TimeOld,
+                  const double TimeNow)
+{
+  for (auto It = Cache.upper_bound(TimeOld); It != Cache.end() && It->first <= TimeNow; ++It)
+  {
+    /** the clock error belongs to the GNSS timestamp, the position to the closest state */
+    double TimePosition;
+    if (Graph.getStateData().checkElement(CLOCK_ERROR_STATE, It->first))
+    {
+      Graph.getStateData().getElement(CLOCK_ERROR_STATE, It->first, 0).setMean(It->second.tail<1>());
+    }
+    if (Graph.getStateData().getTimeCloseTo(POSITION_STATE, It->first, TimePosition))
+    {
+      Graph.getStateData().getElement(POSITION_STATE, TimePosition, 0).setMean(It->second.head<3>());
+    }
+  }
+}
+
 void PseudoRangeSampling(libRSF::FactorGraph &Graph,
                          const double Time,
                          const int Iterations,
@@ -283,7 +568,7 @@ void InitWithGNSS(libRSF::FactorGraph &Graph,
   SolverOptions.trust_region_strategy_type = ceres::TrustRegionStrategyType::DOGLEG;
   SolverOptions.dogleg_type = ceres::DoglegType::SUBSPACE_DOGLEG;
   SolverOptions.max_num_iterations = 200;
-  SolverOptions.num_threads = 1;
+  SolverOptions.num_threads = Config.SolverConfig.num_threads;
 
   /** create a simple static gaussian config*/
   libRSF::FactorGraphConfig SimpleConfig = Config;
@@ -368,7 +653,7 @@ void InitWithUWB(libRSF::FactorGraph &Graph,
   SolverOptions.trust_region_strategy_type = ceres::TrustRegionStrategyType::DOGLEG;
   SolverOptions.dogleg_type = ceres::DoglegType::SUBSPACE_DOGLEG;
   SolverOptions.max_num_iterations = 100;
-  SolverOptions.num_threads = static_cast<int>(std::thread::hardware_concurrency());
+  SolverOptions.num_threads = Config.SolverConfig.num_threads;
 
   /** construct new graph */
   libRSF::FactorGraph SimpleGraph;
@@ -38,8 +38,19 @@
 #include "libRSF.h"
 
 #include <algorithm>
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <thread>
 
-/** use the current set of GNSS measurements to estimate position based on random sample consensus  */
+/** single-point solutions as position and clock error (last element), indexed by the GNSS timestamp */
+using GNSSEpochCache = std::map<double, libRSF::Vector4>;
+
+/** quality of a pseudo range based on elevation and SNR, used to sample the best satellites first */
+double PseudorangeQuality(const libRSF::Data &Pseudorange);
+
+/** use the current set of GNSS measurements to estimate position based on random sample consensus,
+ * hypotheses are evaluated on Config.SolverConfig.num_threads threads and terminate early */
 void PseudoRangeRANSAC(libRSF::FactorGraph &Graph,
                        const libRSF::FactorGraphConfig &Config,
                        const libRSF::SensorDataSet &Measurements,
@@ -48,6 +59,31 @@ void PseudoRangeRANSAC(libRSF::FactorGraph &Graph,
                        int Iterations,
                        double Threshold);
 
+/** robust single-point solution of one epoch from minimal sets with MSAC and a least squares refinement of the consensus set,
+ * runs sequentially without Ceres, so many epochs can be solved concurrently; Position and ClockError are the initial guess */
+bool PseudoRangeConsensus(const std::vector<libRSF::Data> &PseudoRanges,
+                          bool UseSagnac,
+                          int Iterations,
+                          double Threshold,
+                          unsigned int Seed,
+                          libRSF::Vector3 &Position,
+                          double &ClockError);
+
+/** solve all GNSS epochs between TimeStart and TimeEnd independently and in parallel, returns the number of solved epochs */
+int SolveEpochsWithGNSS(const libRSF::FactorGraphConfig &Config,
+                        const libRSF::SensorDataSet &Measurements,
+                        double TimeStart,
+                        double TimeEnd,
+                        int Iterations,
+                        double Threshold,
+                        GNSSEpochCache &Cache);
+
+/** overwrite the position and clock error states of all cached epochs in (TimeOld, TimeNow] */
+void SeedWithGNSS(libRSF::FactorGraph &Graph,
+                  const GNSSEpochCache &Cache,
+                  double TimeOld,
+                  double TimeNow);
+
 /** sample state around the current mean to get a good initial guess */
 void PseudoRangeSampling(libRSF::FactorGraph &Graph,
                          double Time,
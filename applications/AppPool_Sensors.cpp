@@ -22,25 +22,50 @@
 
 #include "AppPool_Sensors.h"
 
-void AddIMU(libRSF::FactorGraph &Graph,
-            const libRSF::FactorGraphConfig &Config,
-            const libRSF::SensorDataSet &Measurements,
-            const double TimeOld,
-            const double TimeNow)
+bool PreintegrateIMU(const libRSF::FactorGraphConfig &Config,
+                     const libRSF::SensorDataSet &Measurements,
+                     const std::vector<double> &Times,
+                     const libRSF::Vector6 &Bias,
+                     IMUIntervalCache &Cache)
 {
-  /** get measurements */
-  double TimeOldNext;
-  std::vector<libRSF::Data> MeasurementsIMU;
-  if (Measurements.getTimeAbove(libRSF::DataType::IMU, TimeOld, TimeOldNext))
+  /** copy the raw samples once */
+  libRSF::IMUSampleBuffer Samples(static_cast<size_t>(Measurements.countElements(libRSF::DataType::IMU)));
+  for (const libRSF::Data &IMU : Measurements.getElementsOfID(libRSF::DataType::IMU))
+  {
+    Samples.add(IMU);
+  }
+
+  std::vector<libRSF::PreintegratedIMUResult> Results;
+  if (!libRSF::IMUPreintegrator::integrateIntervals(Samples, Times,
+                                                    Bias.head(3), Bias.tail(3),
+                                                    Config.IMU.Parameter(0),
+                                                    Config.IMU.Parameter(1),
+                                                    Config.IMU.Parameter(2),
+                                                    Config.IMU.Parameter(3),
+                                                    Results,
+                                                    Config.SolverConfig.num_threads))
   {
-    MeasurementsIMU = Measurements.getElementsBetween(libRSF::DataType::IMU, TimeOldNext, TimeNow);
+    return false;
   }
 
-  /** do not use measurements from the future */
-  if (TimeOldNext > TimeNow)
+  Cache.clear();
+  for (size_t n = 0; n < Results.size(); n++)
   {
-    MeasurementsIMU.clear();
+    Cache.emplace(Times.at(n + 1), Results.at(n));
   }
+  return true;
+}
+
+void AddIMU(libRSF::FactorGraph &Graph,
+            const libRSF::FactorGraphConfig &Config,
+            const libRSF::SensorDataSet &Measurements,
+            const double TimeOld,
+            const double TimeNow,
+            const IMUIntervalCache *Cache)
+{
+  /** get measurements, they are modified below */
+  const auto RangeIMU = Measurements.rangeAfter(libRSF::DataType::IMU, TimeOld, TimeNow);
+  std::vector<libRSF::Data> MeasurementsIMU(RangeIMU.begin(), RangeIMU.end());
 
   /** catch cases where no IMU measurements are available */
   if (MeasurementsIMU.empty())
@@ -168,27 +193,72 @@ void AddIMU(libRSF::FactorGraph &Graph,
   {
     /** create pre-integration */
     const libRSF::Vector6 Bias = Graph.getStateData().getElement(IMU_STATE, TimeOld).getMean().tail(6);
-    libRSF::IMUPreintegrator PreInt(Bias.head(3), Bias.tail(3),
-                                    Config.IMU.Parameter(0),
-                                    Config.IMU.Parameter(1),
-                                    Config.IMU.Parameter(2),
-                                    Config.IMU.Parameter(3),
-                                    TimeOld);
-    /** pre-integrate measurements */
-    for (const libRSF::Data &IMU : MeasurementsIMU)
+
+    /** an interval that was pre-integrated in advance can be used, if it starts here with a similar bias */
+    libRSF::PreintegratedIMUResult Preintegration;
+    const auto Cached = (Cache != nullptr) ? Cache->find(TimeNow) : IMUIntervalCache::const_iterator();
+    if (Cache != nullptr && Cached != Cache->end() &&
+        Cached->second.StartTime == TimeOld &&
+        !libRSF::IMUPreintegrator::NeedsReintegration(Cached->second, Bias.head(3), Bias.tail(3), Config.IMU.Parameter(4)))
+    {
+      Preintegration = Cached->second;
+    }
+    else
     {
-      PreInt.addMeasurement(IMU);
+      libRSF::IMUPreintegrator PreInt(Bias.head(3), Bias.tail(3),
+                                      Config.IMU.Parameter(0),
+                                      Config.IMU.Parameter(1),
+                                      Config.IMU.Parameter(2),
+                                      Config.IMU.Parameter(3),
+                                      TimeOld);
+      /** pre-integrate measurements */
+      for (const libRSF::Data &IMU : MeasurementsIMU)
+      {
+        PreInt.addMeasurement(IMU);
+      }
+      Preintegration = PreInt.getPreintegratedState();
     }
 
     /** add factor */
-    libRSF::StateList IMUStates;
-    IMUStates.add(POSITION_STATE, TimeOld);
-    IMUStates.add(ORIENTATION_STATE, TimeOld);
-    IMUStates.add(IMU_STATE, TimeOld);
-    IMUStates.add(POSITION_STATE, TimeNow);
-    IMUStates.add(ORIENTATION_STATE, TimeNow);
-    IMUStates.add(IMU_STATE, TimeNow);
-    Graph.addIMUPreintegrationFactor(IMUStates, PreInt.getPreintegratedState());
+    AddIMUPreintegration(Graph, Config, Preintegration, TimeOld, TimeNow);
+  }
+}
+
+void AddIMUPreintegration(libRSF::FactorGraph &Graph,
+                          const libRSF::FactorGraphConfig &Config,
+                          const libRSF::PreintegratedIMUResult &Preintegration,
+                          const double TimeOld,
+                          const double TimeNow)
+{
+  /** construct states if missing */
+  Graph.addStateWithCheck(POSITION_STATE, libRSF::DataType::Point3, TimeOld);
+  Graph.addStateWithCheck(POSITION_STATE, libRSF::DataType::Point3, TimeNow);
+  Graph.addStateWithCheck(ORIENTATION_STATE, libRSF::DataType::Quaternion, TimeOld);
+  Graph.addStateWithCheck(ORIENTATION_STATE, libRSF::DataType::Quaternion, TimeNow);
+  Graph.addStateWithCheck(IMU_STATE, libRSF::DataType::IMUBias, TimeOld);
+  Graph.addStateWithCheck(IMU_STATE, libRSF::DataType::IMUBias, TimeNow);
+
+  /** add factor */
+  Graph.setIMURelinearizationThreshold(Config.IMU.Parameter(4));
+  libRSF::StateList IMUStates;
+  IMUStates.add(POSITION_STATE, TimeOld);
+  IMUStates.add(ORIENTATION_STATE, TimeOld);
+  IMUStates.add(IMU_STATE, TimeOld);
+  IMUStates.add(POSITION_STATE, TimeNow);
+  IMUStates.add(ORIENTATION_STATE, TimeNow);
+  IMUStates.add(IMU_STATE, TimeNow);
+  Graph.addIMUPreintegrationFactor(IMUStates, Preintegration);
+}
+
+void FeedbackIMUBias(const libRSF::FactorGraph &Graph,
+                     const double TimeNow,
+                     libRSF::AsyncPreintegrator &Preintegrator)
+{
+  libRSF::Data Bias;
+  if (Graph.getStateData().getElement(IMU_STATE, TimeNow, 0, Bias))
+  {
+    const libRSF::Vector6 BiasMean = Bias.getMean().tail(6);
+    Preintegrator.updateBias(BiasMean.head(3), BiasMean.tail(3));
   }
 }
 
@@ -257,18 +327,8 @@ void AddOdometry(libRSF::FactorGraph &Graph,
                  const double TimeNow)
 {
   /** get measurements */
-  double TimeOldNext;
-  std::vector<libRSF::Data> MeasurementsOdom;
-  if (Measurements.getTimeAbove(SensorConfig, TimeOld, TimeOldNext))
-  {
-    MeasurementsOdom = Measurements.getElementsBetween(SensorConfig, TimeOldNext, TimeNow);
-  }
-
-  /** do not use measurements from the future */
-  if (TimeOldNext > TimeNow)
-  {
-    MeasurementsOdom.clear();
-  }
+  const auto RangeOdom = Measurements.rangeAfter(SensorConfig, TimeOld, TimeNow);
+  std::vector<libRSF::Data> MeasurementsOdom(RangeOdom.begin(), RangeOdom.end());
 
   /** catch cases where no Odom measurements are available */
   if (MeasurementsOdom.empty())
@@ -309,16 +369,7 @@ void AddOdometry(libRSF::FactorGraph &Graph,
       {
         /** integrate odometry to relative pose */
         libRSF::OdometryIntegrator Integrator;
-        double T1 = TimeOld;
-        double T2 = 0.0;
-        for (const libRSF::Data &Odom : MeasurementsOdom)
-        {
-          T2 = Odom.getTimestamp();
-          Integrator.addMeasurement(Odom, T2 - T1);
-          T1 = T2;
-        }
-        /** add last measurement again to cover the full period between TimeOld and TimeNow */
-        Integrator.addMeasurement(MeasurementsOdom.back(), TimeNow - T2);
+        Integrator.addMeasurements(MeasurementsOdom, TimeOld, TimeNow);
 
         /** convert to relative measurement */
         libRSF::Data PoseInt(libRSF::DataType::Pose3, TimeNow);
@@ -433,28 +484,17 @@ void AddMotionModel(libRSF::FactorGraph &Graph,
 void AddPressure(libRSF::FactorGraph &Graph,
                  const libRSF::FactorType FactorConfig,
                  const libRSF::SensorDataSet &Measurements,
+                 PressureMemory &Memory,
                  const double TimeOld,
                  const double TimeNow)
 {
-  /** remember if we had an initial value */
-  static bool IsInitialized = false;
-
-  /** store the last measurement */
-  static libRSF::Data Pressure(libRSF::DataType::AirPressure, TimeNow);
+  /** the last measurement and if we had an initial value */
+  bool &IsInitialized = Memory.IsInitialized;
+  libRSF::Data &Pressure = Memory.Pressure;
 
   /** get measurements */
-  double TimeOldNext;
-  std::vector<libRSF::Data> MeasurementsPressure;
-  if (Measurements.getTimeAbove(libRSF::DataType::AirPressure, TimeOld, TimeOldNext))
-  {
-    MeasurementsPressure = Measurements.getElementsBetween(libRSF::DataType::AirPressure, TimeOldNext, TimeNow);
-  }
-
-  /** do not use measurements from the future */
-  if (TimeOldNext > TimeNow)
-  {
-    MeasurementsPressure.clear();
-  }
+  const auto RangePressure = Measurements.rangeAfter(libRSF::DataType::AirPressure, TimeOld, TimeNow);
+  const std::vector<libRSF::Data> MeasurementsPressure(RangePressure.begin(), RangePressure.end());
 
   /** average pressure over past interval */
   libRSF::Data PressureNew(libRSF::DataType::AirPressure, TimeNow);
@@ -542,36 +582,24 @@ void AddUWB(libRSF::FactorGraph &Graph,
             const double TimeNow)
 {
   /** get measurements */
-  double TimeOldNext;
-  std::vector<libRSF::Data> MeasurementsUWB;
-  if (Measurements.getTimeAbove(libRSF::DataType::Range3, TimeOld, TimeOldNext))
-  {
-    MeasurementsUWB = Measurements.getElementsBetween(libRSF::DataType::Range3, TimeOldNext, TimeNow);
-  }
+  const auto MeasurementsUWB = Measurements.rangeAfter(libRSF::DataType::Range3, TimeOld, TimeNow);
 
   if (!MeasurementsUWB.empty())
   {
+    /** decide to which state each measurement should be connected, in one pass over both */
+    std::vector<libRSF::StateDataSet::TimeBracket> States;
+    if (!Graph.getStateData().associate(POSITION_STATE, MeasurementsUWB, States))
+    {
+      PRINT_ERROR("There is no exiting Position!");
+      return;
+    }
+
     /** loop over measurements */
-    double TimeState;
-    double TimeUWBOld = MeasurementsUWB.at(0).getTimestamp() - 1;
+    size_t nRange = 0;
     for (const libRSF::Data &Range : MeasurementsUWB)
     {
-      const double TimeUWB = Range.getTimestamp();
-
-      /** if time changes */
-      if (TimeUWB != TimeUWBOld)
-      {
-        /** decide to which state it should be connected */
-        if (!Graph.getStateData().getTimeCloseTo(POSITION_STATE, TimeUWB, TimeState))
-        {
-          PRINT_ERROR("There is no exiting Position!");
-          return;
-        }
-        TimeUWBOld = TimeUWB;
-      }
-
       /** add range factor */
-      AddRange3(Graph, Config, Range, TimeState);
+      AddRange3(Graph, Config, Range, States.at(nRange++).getTimeClose());
     }
   }
   else
@@ -587,18 +615,57 @@ void AddGNSS(libRSF::FactorGraph &Graph,
              const double TimeNow)
 {
   /** get measurements */
-  double TimeOldNext;
-  std::vector<libRSF::Data> MeasurementsGNSS;
-  if (Measurements.getTimeAbove(libRSF::DataType::Pseudorange3, TimeOld, TimeOldNext))
-  {
-    MeasurementsGNSS = Measurements.getElementsBetween(libRSF::DataType::Pseudorange3, TimeOldNext, TimeNow);
-  }
+  const auto MeasurementsGNSS = Measurements.rangeAfter(libRSF::DataType::Pseudorange3, TimeOld, TimeNow);
 
   if (!MeasurementsGNSS.empty())
   {
+    /** decide to which state each measurement should be connected, in one pass over both */
+    std::vector<libRSF::StateDataSet::TimeBracket> States;
+    if (!Graph.getStateData().associate(POSITION_STATE, MeasurementsGNSS, States))
+    {
+      PRINT_ERROR("There is no exiting Position!");
+      return;
+    }
+    size_t nPseudorange = 0;
+
     /** loop over measurements */
-    double TimeState;
-    double TimeGNSSOld = MeasurementsGNSS.at(0).getTimestamp() - 1;
+    double TimeState = 0.0;
+    double TimeGNSSOld = MeasurementsGNSS.begin()->getTimestamp() - 1;
+    std::vector<libRSF::Data> Epoch;
+    SystemBiasKeys BiasKeys;
+
+    /** these types and the screening collect all measurements of one timestamp first */
+    const bool IsEpochType = (Config.GNSS.Type == libRSF::FactorType::Pseudorange3_Epoch ||
+                              Config.GNSS.Type == libRSF::FactorType::Pseudorange3_Bias ||
+                              Config.GNSS.Screening.IsActive);
+    const auto AddEpoch = [&](const double TimePosition)
+    {
+      if (Config.GNSS.Screening.IsActive)
+      {
+        ScreenPseudoranges(Graph, Config, Epoch, TimePosition);
+        if (Epoch.empty())
+        {
+          return;
+        }
+      }
+
+      if (Config.GNSS.Type == libRSF::FactorType::Pseudorange3_Bias)
+      {
+        AddPseudorange3BiasEpoch(Graph, Config, Epoch, TimePosition, BiasKeys);
+      }
+      else if (Config.GNSS.Type == libRSF::FactorType::Pseudorange3_Epoch)
+      {
+        AddPseudorange3Epoch(Graph, Config, Epoch, TimePosition);
+      }
+      else
+      {
+        for (const libRSF::Data &Pseudorange : Epoch)
+        {
+          AddPseudorange3(Graph, Config, Pseudorange, TimePosition);
+        }
+      }
+      Epoch.clear();
+    };
     for (const libRSF::Data& Pseudorange : MeasurementsGNSS)
     {
       const double TimeGNSS = Pseudorange.getTimestamp();
@@ -623,32 +690,34 @@ void AddGNSS(libRSF::FactorGraph &Graph,
         }
       }
 
-      if (Config.GNSS.Type == libRSF::FactorType::Pseudorange3_Bias)
-      {
-        /** different bias for each satellite system*/
-        const std::string InterSysBiasName = addSatSysToName(SYSTEM_BIAS_STATE, static_cast<int>(Pseudorange.getValue(libRSF::DataElement::SatSys)(0)));
-
-        /** check if inter-system bias exists*/
-        if(Graph.getStateData().countElements(InterSysBiasName)  < 1)
-        {
-          /** create a single ISB state so far in the future, that it will never be marginalized */
-          AddInterSystemBiasModel(Graph,Config,InterSysBiasName,TimeGNSS + 1e20);
-        }
-      }
-
       /** if time changes, find next state */
       if (TimeGNSS != TimeGNSSOld)
       {
-        if (!Graph.getStateData().getTimeCloseTo(POSITION_STATE, TimeGNSS, TimeState))
+        /** the epoch factor combines all measurements of the previous timestamp */
+        if (!Epoch.empty())
         {
-          PRINT_ERROR("There is no exiting Position!");
-          return;
+          AddEpoch(TimeState);
         }
+
+        TimeState = States.at(nPseudorange).getTimeClose();
         TimeGNSSOld = TimeGNSS;
       }
+      nPseudorange++;
 
       /** add pseudorange factor */
-      AddPseudorange3(Graph, Config, Pseudorange, TimeState);
+      if (IsEpochType)
+      {
+        Epoch.push_back(Pseudorange);
+      }
+      else
+      {
+        AddPseudorange3(Graph, Config, Pseudorange, TimeState);
+      }
+    }
+
+    if (!Epoch.empty())
+    {
+      AddEpoch(TimeState);
     }
   }
   else
@@ -686,6 +755,140 @@ void AddInterSystemBiasModel(libRSF::FactorGraph &Graph,
   }
 }
 
+int ScreenPseudoranges(libRSF::FactorGraph &Graph,
+                       const libRSF::FactorGraphConfig &Config,
+                       std::vector<libRSF::Data> &Pseudoranges,
+                       const double TimePosition)
+{
+  const libRSF::FactorGraphConfig::ScreeningConfig &Screening = Config.GNSS.Screening;
+  const size_t SizeBefore = Pseudoranges.size();
+
+  /** elevation and SNR only depend on the measurement */
+  Pseudoranges.erase(std::remove_if(Pseudoranges.begin(), Pseudoranges.end(), [&Screening](const libRSF::Data &Pseudorange)
+  {
+    const double SNR = Pseudorange.getValue(libRSF::DataElement::SNR)(0);
+    return Pseudorange.getValue(libRSF::DataElement::SatElevation)(0) < Screening.MinElevation ||
+           (Screening.MinSNR > 0.0 && SNR > 0.0 && SNR < Screening.MinSNR);
+  }), Pseudoranges.end());
+
+  /** residuals w.r.t. the predicted position, the median removes the unknown clock error */
+  if (Screening.MaxResidual > 0.0 && Pseudoranges.size() > 4 && Graph.getStateData().checkElement(POSITION_STATE, TimePosition))
+  {
+    const libRSF::Vector3 Position = Graph.getStateData().getElement(POSITION_STATE, TimePosition).getMean();
+    const bool UseSagnac = (Config.GNSS.Type == libRSF::FactorType::Pseudorange3_ECEF);
+
+    std::vector<double> Residuals(Pseudoranges.size());
+    for (size_t n = 0; n < Pseudoranges.size(); n++)
+    {
+      Residuals.at(n) = libRSF::PseudorangeError(Position, 0.0,
+                                                 Pseudoranges.at(n).getValue(libRSF::DataElement::SatPos),
+                                                 Pseudoranges.at(n).getMean()(0),
+                                                 UseSagnac);
+    }
+    const double Offset = libRSF::Median(Residuals);
+
+    const auto Accepted = std::count_if(Residuals.begin(), Residuals.end(), [&Screening, Offset](const double Residual)
+    {
+      return std::abs(Residual - Offset) <= Screening.MaxResidual;
+    });
+
+    /** a bad prediction should not remove the epoch, so at least four satellites are required to keep the position observable */
+    if (Accepted >= 4)
+    {
+      size_t nKept = 0;
+      for (size_t n = 0; n < Pseudoranges.size(); n++)
+      {
+        if (std::abs(Residuals.at(n) - Offset) <= Screening.MaxResidual)
+        {
+          if (nKept != n)
+          {
+            Pseudoranges.at(nKept) = std::move(Pseudoranges.at(n));
+          }
+          nKept++;
+        }
+      }
+      Pseudoranges.resize(nKept);
+    }
+  }
+
+  return static_cast<int>(SizeBefore - Pseudoranges.size());
+}
+
+bool IsSameMixtureConfig(const libRSF::FactorGraphConfig::GaussianMixtureConfig &A,
+                         const libRSF::FactorGraphConfig::GaussianMixtureConfig &B)
+{
+  const auto SameVector = [](const libRSF::Vector &V1, const libRSF::Vector &V2)
+  {
+    return V1.size() == V2.size() && V1 == V2;
+  };
+
+  return A.MixtureType == B.MixtureType &&
+         A.TuningType == B.TuningType &&
+         A.NumberComponents == B.NumberComponents &&
+         A.BaseStandardDeviation == B.BaseStandardDeviation &&
+         SameVector(A.Mean, B.Mean) &&
+         SameVector(A.StdDev, B.StdDev) &&
+         SameVector(A.Weight, B.Weight);
+}
+
+const libRSF::StateKey &GetSystemBiasKey(SystemBiasKeys &Keys, const int SatSys)
+{
+  auto It = Keys.find(SatSys);
+  if (It == Keys.end())
+  {
+    It = Keys.emplace(SatSys, libRSF::StateKey(addSatSysToName(SYSTEM_BIAS_STATE, SatSys))).first;
+  }
+  return It->second;
+}
+
+void AddPseudorange3BiasEpoch(libRSF::FactorGraph &Graph,
+                              const libRSF::FactorGraphConfig &Config,
+                              const std::vector<libRSF::Data> &Pseudoranges,
+                              const double TimePosition,
+                              SystemBiasKeys &Keys)
+{
+  const double TimeGNSS = Pseudoranges.front().getTimestamp();
+
+  /** position and clock error are shared by all satellites */
+  const libRSF::StateKey PositionKey(POSITION_STATE);
+  const libRSF::StateKey ClockErrorKey(CLOCK_ERROR_STATE);
+  Graph.addStateWithCheck(PositionKey, libRSF::DataType::Point3, TimePosition);
+  Graph.addStateWithCheck(ClockErrorKey, libRSF::DataType::ClockError, TimeGNSS);
+
+  /** group satellites by their system, the order inside a system is kept */
+  std::map<int, std::vector<const libRSF::Data*>> Systems;
+  for (const libRSF::Data &Pseudorange : Pseudoranges)
+  {
+    Systems[static_cast<int>(Pseudorange.getValue(libRSF::DataElement::SatSys)(0))].push_back(&Pseudorange);
+  }
+
+  for (const auto &[SatSys, Satellites] : Systems)
+  {
+    const libRSF::StateKey &ISBKey = GetSystemBiasKey(Keys, SatSys);
+
+    /** create a single ISB state so far in the future, that it will never be marginalized */
+    if (Graph.getStateData().countElements(ISBKey) < 1)
+    {
+      AddInterSystemBiasModel(Graph, Config, ISBKey, TimeGNSS + 1e20);
+    }
+
+    /** find closest ISB variable*/
+    double TimeISB;
+    Graph.getStateData().getTimeCloseTo(ISBKey, TimeGNSS, TimeISB);
+
+    /** all satellites of one system share the same states */
+    libRSF::StateList States;
+    States.add(PositionKey, TimePosition);
+    States.add(ClockErrorKey, TimeGNSS);
+    States.add(ISBKey, TimeISB);
+
+    for (const libRSF::Data *Pseudorange : Satellites)
+    {
+      AddPseudorange3Factor<libRSF::FactorType::Pseudorange3_Bias>(Graph, Config, *Pseudorange, States);
+    }
+  }
+}
+
 void AddPseudorange3(libRSF::FactorGraph &Graph,
                      const libRSF::FactorGraphConfig &Config,
                      const libRSF::Data &Pseudorange,
@@ -703,12 +906,73 @@ void AddPseudorange3(libRSF::FactorGraph &Graph,
   {
     AddPseudorange3Generic<libRSF::FactorType::Pseudorange3_ECEF>(Graph, Config, Pseudorange, TimePosition);
   }
+  else if (Config.GNSS.Type == libRSF::FactorType::Pseudorange3_Epoch)
+  {
+    /** an epoch with a single satellite */
+    AddPseudorange3Epoch(Graph, Config, {Pseudorange}, TimePosition);
+  }
   else
   {
     PRINT_ERROR("Wrong pseudo range factor type!");
   }
 }
 
+void AddPseudorange3Epoch(libRSF::FactorGraph &Graph,
+                          const libRSF::FactorGraphConfig &Config,
+                          const std::vector<libRSF::Data> &Pseudoranges,
+                          const double TimePosition)
+{
+  const double TimeGNSS = Pseudoranges.front().getTimestamp();
+
+  /** construct states if missing */
+  Graph.addStateWithCheck(POSITION_STATE, libRSF::DataType::Point3, TimePosition);
+  Graph.addStateWithCheck(CLOCK_ERROR_STATE, libRSF::DataType::ClockError, TimeGNSS);
+
+  const libRSF::StateID Position(POSITION_STATE, TimePosition);
+  const libRSF::StateID ClockError(CLOCK_ERROR_STATE, TimeGNSS);
+
+  switch (Config.GNSS.ErrorModel.Type)
+  {
+    case libRSF::ErrorModelType::Gaussian:
+    {
+      /** the individual standard deviations are applied by the factor */
+      libRSF::GaussianDiagonal<1> Noise;
+      Noise.setStdDevSharedDiagonal(1.0);
+
+      Graph.addPseudorangeEpochFactor(Position, ClockError, Pseudoranges, Noise, true);
+    }
+    break;
+
+    case libRSF::ErrorModelType::GMM:
+    {
+      if (Config.GNSS.ErrorModel.GMM.MixtureType == libRSF::ErrorModelMixtureType::MaxMix)
+      {
+        libRSF::MaxMix1 MixtureNoise = GetMixturePrototype<libRSF::MaxMix1, 1>(Config.GNSS.ErrorModel.GMM);
+        Graph.addPseudorangeEpochFactor(Position, ClockError, Pseudoranges, MixtureNoise, false);
+      }
+      else if (Config.GNSS.ErrorModel.GMM.MixtureType == libRSF::ErrorModelMixtureType::SumMix)
+      {
+        libRSF::SumMix1 MixtureNoise = GetMixturePrototype<libRSF::SumMix1, 1>(Config.GNSS.ErrorModel.GMM);
+        Graph.addPseudorangeEpochFactor(Position, ClockError, Pseudoranges, MixtureNoise, false);
+      }
+      else if (Config.GNSS.ErrorModel.GMM.MixtureType == libRSF::ErrorModelMixtureType::MaxSumMix)
+      {
+        libRSF::MaxSumMix1 MixtureNoise = GetMixturePrototype<libRSF::MaxSumMix1, 1>(Config.GNSS.ErrorModel.GMM);
+        Graph.addPseudorangeEpochFactor(Position, ClockError, Pseudoranges, MixtureNoise, false);
+      }
+      else
+      {
+        PRINT_ERROR("Wrong mixture type!");
+      }
+    }
+    break;
+
+    default:
+      PRINT_ERROR("The pseudorange epoch factor supports only Gaussian and GMM error models!");
+      break;
+  }
+}
+
 bool AddLoopClosures(libRSF::FactorGraph &Graph,
                      const libRSF::FactorGraphConfig &Config,
                      const libRSF::SensorDataSet &Measurements,
@@ -719,16 +983,7 @@ bool AddLoopClosures(libRSF::FactorGraph &Graph,
   if (Measurements.checkID(libRSF::DataType::LoopClosure))
   {
     /** get measurements */
-    double TimeOldNext;
-    std::vector<libRSF::Data> Loops;
-    if (Measurements.getTimeAbove(libRSF::DataType::LoopClosure, TimeOld, TimeOldNext))
-    {
-      /** do not use measurements from the future */
-      if (TimeOldNext <= TimeNow)
-      {
-        Loops = Measurements.getElementsBetween(libRSF::DataType::LoopClosure, TimeOldNext, TimeNow);
-      }
-    }
+    const auto Loops = Measurements.rangeAfter(libRSF::DataType::LoopClosure, TimeOld, TimeNow);
 
     /** loop over measurements */
     if (Config.LoopClosure.Type == libRSF::FactorType::ConstVal3)
@@ -777,13 +1032,10 @@ void AddLoopClosure3(libRSF::FactorGraph &Graph,
       break;
     case libRSF::ErrorModelType::GMM:
       {
-        /** init model */
-        libRSF::GaussianMixture<3> GMM(Config.LoopClosure.ErrorModel.GMM);
-
         /**Max-Mixture GMM [Olson et al.]*/
         if(Config.LoopClosure.ErrorModel.GMM.MixtureType == libRSF::ErrorModelMixtureType::MaxMix)
         {
-          libRSF::MaxMix3 MixtureNoise(GMM);
+          libRSF::MaxMix3 MixtureNoise = GetMixturePrototype<libRSF::MaxMix3, 3>(Config.LoopClosure.ErrorModel.GMM);
           Graph.addFactor<libRSF::FactorType::ConstVal3>(libRSF::StateID(POSITION_STATE, Time1),
                                                          libRSF::StateID(POSITION_STATE, Time2),
                                                          MixtureNoise);
@@ -791,7 +1043,7 @@ void AddLoopClosure3(libRSF::FactorGraph &Graph,
         /**Sum-Mixture GMM [Rosen et al.]*/
         else if(Config.LoopClosure.ErrorModel.GMM.MixtureType == libRSF::ErrorModelMixtureType::SumMix)
         {
-          libRSF::SumMix3 MixtureNoise(GMM);
+          libRSF::SumMix3 MixtureNoise = GetMixturePrototype<libRSF::SumMix3, 3>(Config.LoopClosure.ErrorModel.GMM);
           Graph.addFactor<libRSF::FactorType::ConstVal3>(libRSF::StateID(POSITION_STATE, Time1),
                                                          libRSF::StateID(POSITION_STATE, Time2),
                                                          MixtureNoise);
@@ -799,7 +1051,7 @@ void AddLoopClosure3(libRSF::FactorGraph &Graph,
         /**Max-Sum-Mix-Mixture GMM [Pfeifer et al.]*/
         else if(Config.LoopClosure.ErrorModel.GMM.MixtureType == libRSF::ErrorModelMixtureType::MaxSumMix)
         {
-          libRSF::MaxSumMix3 MixtureNoise(GMM);
+          libRSF::MaxSumMix3 MixtureNoise = GetMixturePrototype<libRSF::MaxSumMix3, 3>(Config.LoopClosure.ErrorModel.GMM);
           Graph.addFactor<libRSF::FactorType::ConstVal3>(libRSF::StateID(POSITION_STATE, Time1),
                                                          libRSF::StateID(POSITION_STATE, Time2),
                                                          MixtureNoise);
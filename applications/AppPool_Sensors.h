@@ -36,6 +36,9 @@
 #include "AppPool_Defines.h"
 #include "libRSF.h"
 
+#include <deque>
+#include <map>
+
 void AddGNSS(libRSF::FactorGraph &Graph,
              const libRSF::FactorGraphConfig &Config,
              const libRSF::SensorDataSet &Measurements,
@@ -95,15 +98,46 @@ void AddClockModel(libRSF::FactorGraph &Graph,
                    const std::string &ClockDriftNameEnd,
                    double TimeNow);
 
+/** pre-integrated IMU intervals, indexed by their end time */
+using IMUIntervalCache = std::map<double, libRSF::PreintegratedIMUResult>;
+
 void AddIMU(libRSF::FactorGraph &Graph,
             const libRSF::FactorGraphConfig &Config,
             const libRSF::SensorDataSet &Measurements,
             double TimeOld,
-            double TimeNow);
+            double TimeNow,
+            const IMUIntervalCache *Cache = nullptr);
+
+/** add a pre-integration that was computed outside, e.g. by an AsyncPreintegrator */
+void AddIMUPreintegration(libRSF::FactorGraph &Graph,
+                          const libRSF::FactorGraphConfig &Config,
+                          const libRSF::PreintegratedIMUResult &Preintegration,
+                          double TimeOld,
+                          double TimeNow);
+
+/** hand the newest bias estimate back to the integration thread */
+void FeedbackIMUBias(const libRSF::FactorGraph &Graph,
+                     double TimeNow,
+                     libRSF::AsyncPreintegrator &Preintegrator);
+
+/** pre-integrate the IMU between all consecutive timestamps at once, for offline processing */
+bool PreintegrateIMU(const libRSF::FactorGraphConfig &Config,
+                     const libRSF::SensorDataSet &Measurements,
+                     const std::vector<double> &Times,
+                     const libRSF::Vector6 &Bias,
+                     IMUIntervalCache &Cache);
+
+/** barometric pressure of the last iteration, owned by the caller */
+struct PressureMemory
+{
+  bool IsInitialized = false;
+  libRSF::Data Pressure = libRSF::Data(libRSF::DataType::AirPressure, 0.0);
+};
 
 void AddPressure(libRSF::FactorGraph &Graph,
                  libRSF::FactorType FactorConfig,
                  const libRSF::SensorDataSet &Measurements,
+                 PressureMemory &Memory,
                  double TimeOld,
                  double TimeNow);
 
@@ -112,6 +146,12 @@ void AddPseudorange3(libRSF::FactorGraph &Graph,
                      const libRSF::Data &Pseudorange,
                      double TimePosition);
 
+/** all pseudo ranges of one timestamp in a single factor */
+void AddPseudorange3Epoch(libRSF::FactorGraph &Graph,
+                          const libRSF::FactorGraphConfig &Config,
+                          const std::vector<libRSF::Data> &Pseudoranges,
+                          double TimePosition);
+
 void AddInterSystemBiasModel(libRSF::FactorGraph &Graph,
                              const libRSF::FactorGraphConfig &Config,
                              const std::string &ISBName,
@@ -119,6 +159,24 @@ void AddInterSystemBiasModel(libRSF::FactorGraph &Graph,
 
 std::string addSatSysToName(const std::string &BaseName, int SatSys);
 
+/** removes pseudo ranges by elevation, SNR and their residual w.r.t. the predicted position, returns the number of removed ones */
+int ScreenPseudoranges(libRSF::FactorGraph &Graph,
+                       const libRSF::FactorGraphConfig &Config,
+                       std::vector<libRSF::Data> &Pseudoranges,
+                       double TimePosition);
+
+/** keys of the inter-system bias states, so that the name of each satellite system is built only once */
+using SystemBiasKeys = std::map<int, libRSF::StateKey>;
+
+const libRSF::StateKey &GetSystemBiasKey(SystemBiasKeys &Keys, int SatSys);
+
+/** all pseudo ranges of one timestamp with their inter-system biases, the states are looked up once per satellite system */
+void AddPseudorange3BiasEpoch(libRSF::FactorGraph &Graph,
+                              const libRSF::FactorGraphConfig &Config,
+                              const std::vector<libRSF::Data> &Pseudoranges,
+                              double TimePosition,
+                              SystemBiasKeys &Keys);
+
 bool AddLoopClosures(libRSF::FactorGraph &Graph,
                      const libRSF::FactorGraphConfig &Config,
                      const libRSF::SensorDataSet &Measurements,
@@ -129,6 +187,35 @@ void AddLoopClosure3(libRSF::FactorGraph &Graph,
                      const libRSF::FactorGraphConfig &Config,
                      const libRSF::Data &Loop);
 
+/** compares everything that a mixture error model is constructed from */
+bool IsSameMixtureConfig(const libRSF::FactorGraphConfig::GaussianMixtureConfig &A,
+                         const libRSF::FactorGraphConfig::GaussianMixtureConfig &B);
+
+/** mixture error models only depend on the config, so they are constructed once per thread and copied for every factor */
+template <typename MixtureModelType, int Dim>
+const MixtureModelType &GetMixturePrototype(const libRSF::FactorGraphConfig::GaussianMixtureConfig &Config)
+{
+  struct Prototype
+  {
+    libRSF::FactorGraphConfig::GaussianMixtureConfig Config;
+    MixtureModelType Model;
+  };
+
+  /** a deque keeps the returned references valid */
+  thread_local std::deque<Prototype> Prototypes;
+
+  for (const Prototype &Entry : Prototypes)
+  {
+    if (IsSameMixtureConfig(Entry.Config, Config))
+    {
+      return Entry.Model;
+    }
+  }
+
+  Prototypes.push_back({Config, MixtureModelType(libRSF::GaussianMixture<Dim>(Config))});
+  return Prototypes.back().Model;
+}
+
 template <libRSF::FactorType RangeFactorType>
 void AddRangeGeneric(libRSF::FactorGraph &Graph,
                      const libRSF::FactorGraphConfig &Config,
@@ -158,7 +245,7 @@ void AddRangeGeneric(libRSF::FactorGraph &Graph,
       ListOfPoints.add(POSITION_STATE, TimePosition);
 
       /** landmark position*/
-      const std::string LM_ID_STATE = LANDMARK_STATE + std::to_string(Range.getValue(libRSF::DataElement::SatID)(0));
+      const libRSF::StateKey LM_ID_STATE = LANDMARK_STATE + std::to_string(Range.getValue(libRSF::DataElement::SatID)(0));
       Graph.addStateWithCheck(LM_ID_STATE, libRSF::DataType::Point2, 0.0);
       ListOfPoints.add(LM_ID_STATE, 0.0);
       break;
@@ -171,7 +258,7 @@ void AddRangeGeneric(libRSF::FactorGraph &Graph,
       ListOfPoints.add(POSITION_STATE, TimePosition);
 
       /** landmark position*/
-      const std::string LM_ID_STATE = LANDMARK_STATE + std::to_string(Range.getValue(libRSF::DataElement::SatID)(0));
+      const libRSF::StateKey LM_ID_STATE = LANDMARK_STATE + std::to_string(Range.getValue(libRSF::DataElement::SatID)(0));
       Graph.addStateWithCheck(LM_ID_STATE, libRSF::DataType::Point3, 0.0);
       ListOfPoints.add(LM_ID_STATE, 0.0);
       break;
@@ -200,13 +287,10 @@ void AddRangeGeneric(libRSF::FactorGraph &Graph,
 
     case libRSF::ErrorModelType::GMM:
     {
-      /** Use default init */
-      libRSF::GaussianMixture<1> GMM(Config.Ranging.ErrorModel.GMM);
-
       /**Max-Mixture GMM [Olson et al.]*/
       if (Config.Ranging.ErrorModel.GMM.MixtureType == libRSF::ErrorModelMixtureType::MaxMix)
       {
-        libRSF::MaxMix1 MixtureNoise(GMM);
+        libRSF::MaxMix1 MixtureNoise = GetMixturePrototype<libRSF::MaxMix1, 1>(Config.Ranging.ErrorModel.GMM);
 
         Graph.addFactor<RangeFactorType>(
             ListOfPoints,
@@ -216,7 +300,7 @@ void AddRangeGeneric(libRSF::FactorGraph &Graph,
       /**Sum-Mixture GMM [Rosen et al.]*/
       else if (Config.Ranging.ErrorModel.GMM.MixtureType == libRSF::ErrorModelMixtureType::SumMix)
       {
-        libRSF::SumMix1 MixtureNoise(GMM);
+        libRSF::SumMix1 MixtureNoise = GetMixturePrototype<libRSF::SumMix1, 1>(Config.Ranging.ErrorModel.GMM);
 
         Graph.addFactor<RangeFactorType>(
             ListOfPoints,
@@ -226,7 +310,7 @@ void AddRangeGeneric(libRSF::FactorGraph &Graph,
       /**LSE-Mixture GMM [Pfeifer et al.]*/
       else if (Config.Ranging.ErrorModel.GMM.MixtureType == libRSF::ErrorModelMixtureType::MaxSumMix)
       {
-        libRSF::MaxSumMix1 MixtureNoise(GMM);
+        libRSF::MaxSumMix1 MixtureNoise = GetMixturePrototype<libRSF::MaxSumMix1, 1>(Config.Ranging.ErrorModel.GMM);
 
         Graph.addFactor<RangeFactorType>(
             ListOfPoints,
@@ -270,19 +354,18 @@ void AddRangeGeneric(libRSF::FactorGraph &Graph,
           ListOfPoints,
           Range,
           Noise,
-          new libRSF::DCSLoss(Config.Ranging.ErrorModel.Parameter));
+          Graph.getSharedLoss<libRSF::DCSLoss>(Config.Ranging.ErrorModel.Parameter));
     }
     break;
 
     case libRSF::ErrorModelType::DCE:
     {
-      /**add covariance variable */
-      Graph.addState(COV_STATE, libRSF::DataType::Covariance1, TimeRange);
-      const int CovIndex = Graph.getStateData().countElement(COV_STATE, TimeRange) - 1;
+      /**add covariance variable, initialized with its lower bound */
       const libRSF::Vector1 Cov = Range.getCovarianceDiagonal();
-
-      /** set initial value */
-      Graph.getStateData().getElement(COV_STATE, TimeRange, CovIndex).setMean(Cov);
+      libRSF::Data CovState(libRSF::DataType::Covariance1, TimeRange);
+      CovState.setMean(Cov);
+      Graph.addState(COV_STATE, CovState);
+      const int CovIndex = Graph.getStateData().countElement(COV_STATE, TimeRange) - 1;
 
       /** set lower bound */
       Graph.setLowerBound(COV_STATE, TimeRange, CovIndex, Cov);
@@ -307,7 +390,7 @@ void AddRangeGeneric(libRSF::FactorGraph &Graph,
           ListOfPoints,
           Range,
           Noise,
-          new libRSF::cDCELoss(Range.getStdDevDiagonal()(0)));
+          Graph.getSharedLoss<libRSF::cDCELoss>(Range.getStdDevDiagonal()(0)));
     }
     break;
 
@@ -317,37 +400,15 @@ void AddRangeGeneric(libRSF::FactorGraph &Graph,
   }
 }
 
+/** the error model specific part, that may add own states to the list */
 template <libRSF::FactorType PseudorangeFactorType>
-void AddPseudorange3Generic(libRSF::FactorGraph &Graph,
-                            const libRSF::FactorGraphConfig &Config,
-                            const libRSF::Data &Pseudorange,
-                            const double TimePosition)
+void AddPseudorange3Factor(libRSF::FactorGraph &Graph,
+                           const libRSF::FactorGraphConfig &Config,
+                           const libRSF::Data &Pseudorange,
+                           libRSF::StateList States)
 {
   const double TimeGNSS = Pseudorange.getTimestamp();
 
-  /** construct position if missing */
-  Graph.addStateWithCheck(POSITION_STATE, libRSF::DataType::Point3, TimePosition);
-
-  /** construct clock error if missing */
-  Graph.addStateWithCheck(CLOCK_ERROR_STATE, libRSF::DataType::ClockError, TimeGNSS);
-
-  /** collect states */
-  libRSF::StateList States;
-  States.add(POSITION_STATE, TimePosition);
-  States.add(CLOCK_ERROR_STATE, TimeGNSS);
-
-  /** add inter system bias */
-  if constexpr (PseudorangeFactorType == libRSF::FactorType::Pseudorange3_Bias)
-  {
-    /** get string*/
-    const std::string InterSystemBiasName = addSatSysToName(SYSTEM_BIAS_STATE, static_cast<int>(Pseudorange.getValue(libRSF::DataElement::SatSys)(0)));
-
-    /** find closest ISB variable*/
-    double TimeISB;
-    Graph.getStateData().getTimeCloseTo(InterSystemBiasName, TimeGNSS, TimeISB);
-    States.add(InterSystemBiasName, TimeISB);
-  }
-
   /** add pseudorange */
   switch (Config.GNSS.ErrorModel.Type)
   {
@@ -362,27 +423,24 @@ void AddPseudorange3Generic(libRSF::FactorGraph &Graph,
 
     case libRSF::ErrorModelType::GMM:
     {
-      /** Use default init */
-      libRSF::GaussianMixture<1> GMM(Config.GNSS.ErrorModel.GMM);
-
       /**Max-Mixture GMM [Olson et al.]*/
       if (Config.GNSS.ErrorModel.GMM.MixtureType == libRSF::ErrorModelMixtureType::MaxMix)
       {
-        libRSF::MaxMix1 MixtureNoise(GMM);
+        libRSF::MaxMix1 MixtureNoise = GetMixturePrototype<libRSF::MaxMix1, 1>(Config.GNSS.ErrorModel.GMM);
 
         Graph.addFactor<PseudorangeFactorType>(States, Pseudorange, MixtureNoise);
       }
       /**Sum-Mixture GMM [Rosen et al.]*/
       else if (Config.GNSS.ErrorModel.GMM.MixtureType == libRSF::ErrorModelMixtureType::SumMix)
       {
-        libRSF::SumMix1 MixtureNoise(GMM);
+        libRSF::SumMix1 MixtureNoise = GetMixturePrototype<libRSF::SumMix1, 1>(Config.GNSS.ErrorModel.GMM);
 
         Graph.addFactor<PseudorangeFactorType>(States, Pseudorange, MixtureNoise);
       }
       /**MaxSumMix-Mixture GMM [Pfeifer et al.]*/
       else if (Config.GNSS.ErrorModel.GMM.MixtureType == libRSF::ErrorModelMixtureType::MaxSumMix)
       {
-        libRSF::MaxSumMix1 MixtureNoise(GMM);
+        libRSF::MaxSumMix1 MixtureNoise = GetMixturePrototype<libRSF::MaxSumMix1, 1>(Config.GNSS.ErrorModel.GMM);
 
         Graph.addFactor<PseudorangeFactorType>(States, Pseudorange, MixtureNoise);
       }
@@ -417,21 +475,20 @@ void AddPseudorange3Generic(libRSF::FactorGraph &Graph,
       Noise.setStdDevDiagonal(Pseudorange.getStdDevDiagonal());
 
       Graph.addFactor<PseudorangeFactorType>(States, Pseudorange, Noise,
-                                             new libRSF::DCSLoss(Config.GNSS.ErrorModel.Parameter));
+                                             Graph.getSharedLoss<libRSF::DCSLoss>(Config.GNSS.ErrorModel.Parameter));
     }
     break;
 
     case libRSF::ErrorModelType::DCE:
     {
-      /**add covariance variable */
-      Graph.addState(COV_STATE, libRSF::DataType::Covariance1, TimeGNSS);
-      const int CovIndex = Graph.getStateData().countElement(COV_STATE, TimeGNSS) - 1;
+      /**add covariance variable, initialized with its lower bound */
       const libRSF::Vector1 Cov = Pseudorange.getCovarianceDiagonal();
+      libRSF::Data CovState(libRSF::DataType::Covariance1, TimeGNSS);
+      CovState.setMean(Cov);
+      Graph.addState(COV_STATE, CovState);
+      const int CovIndex = Graph.getStateData().countElement(COV_STATE, TimeGNSS) - 1;
       States.add(COV_STATE, TimeGNSS, CovIndex);
 
-      /** set initial value */
-      Graph.getStateData().getElement(COV_STATE, TimeGNSS, CovIndex).setMean(Cov);
-
       /** set lower bound */
       Graph.setLowerBound(COV_STATE, TimeGNSS, CovIndex, Cov);
       //Graph.setUpperBound(COV_STATE, TimeGNSS, CovIndex, Cov*1e12); /** for better numerical stability*/
@@ -450,7 +507,7 @@ void AddPseudorange3Generic(libRSF::FactorGraph &Graph,
       Noise.setStdDevDiagonal(libRSF::Matrix11::Ones());
 
       Graph.addFactor<PseudorangeFactorType>(States, Pseudorange, Noise,
-                                             new libRSF::cDCELoss(Pseudorange.getStdDevDiagonal()(0)));
+                                             Graph.getSharedLoss<libRSF::cDCELoss>(Pseudorange.getStdDevDiagonal()(0)));
     }
     break;
 
@@ -460,4 +517,38 @@ void AddPseudorange3Generic(libRSF::FactorGraph &Graph,
   }
 }
 
+template <libRSF::FactorType PseudorangeFactorType>
+void AddPseudorange3Generic(libRSF::FactorGraph &Graph,
+                            const libRSF::FactorGraphConfig &Config,
+                            const libRSF::Data &Pseudorange,
+                            const double TimePosition)
+{
+  const double TimeGNSS = Pseudorange.getTimestamp();
+
+  /** construct position if missing */
+  Graph.addStateWithCheck(POSITION_STATE, libRSF::DataType::Point3, TimePosition);
+
+  /** construct clock error if missing */
+  Graph.addStateWithCheck(CLOCK_ERROR_STATE, libRSF::DataType::ClockError, TimeGNSS);
+
+  /** collect states */
+  libRSF::StateList States;
+  States.add(POSITION_STATE, TimePosition);
+  States.add(CLOCK_ERROR_STATE, TimeGNSS);
+
+  /** add inter system bias */
+  if constexpr (PseudorangeFactorType == libRSF::FactorType::Pseudorange3_Bias)
+  {
+    /** get string*/
+    const std::string InterSystemBiasName = addSatSysToName(SYSTEM_BIAS_STATE, static_cast<int>(Pseudorange.getValue(libRSF::DataElement::SatSys)(0)));
+
+    /** find closest ISB variable*/
+    double TimeISB;
+    Graph.getStateData().getTimeCloseTo(InterSystemBiasName, TimeGNSS, TimeISB);
+    States.add(InterSystemBiasName, TimeISB);
+  }
+
+  AddPseudorange3Factor<PseudorangeFactorType>(Graph, Config, Pseudorange, States);
+}
+
 #endif  // APPPOOL_SENSORS_H
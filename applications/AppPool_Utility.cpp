@@ -22,6 +22,7 @@
 
 #include "AppPool_Utility.h"
 
+#include <limits>
 
 
 bool GetFirstTimestamp (const libRSF::SensorDataSet &Measurements,
@@ -31,21 +32,11 @@ bool GetFirstTimestamp (const libRSF::SensorDataSet &Measurements,
   if(Config.Solution.IsAsync)
   {
     /** if async, take first overall timestamp */
-    double Time, TimeFirst;
+    const libRSF::SensorDataSet::EventCursor Events = Measurements.cursorAll();
 
-    if(Measurements.getTimeFirst(Measurements.begin()->first, TimeFirst))
+    if(Events.valid())
     {
-      for(const auto &Sensor : Measurements)
-      {
-        if(Measurements.getTimeFirst(Sensor.first, Time))
-        {
-          if (Time < TimeFirst)
-          {
-            TimeFirst = Time;
-          }
-        }
-      }
-      Timestamp = TimeFirst;
+      Timestamp = Events.getTime();
     }
     else
     {
@@ -115,23 +106,368 @@ bool IncrementTime(const libRSF::FactorGraphConfig &Config,
     return false;
   }
 
-  if(Config.Solution.IsAsync)
+  if(Config.Solution.IsAsync && !Config.Solution.AsyncEvents)
   {
     /** simply increment with predefined rate */
     TimeNew = TimeOld + 1.0/Config.Solution.AsyncRate;
     return true;
   }
 
+  if(Config.Solution.IsAsync)
+  {
+    /** next measurement of any sensor, but not faster than the async rate */
+    const double TimeMin = TimeOld + 1.0/Config.Solution.AsyncRate;
+    double TimeAbove = std::numeric_limits<double>::infinity();
+    double TimeBelow = TimeOld;
+    for(const auto &Sensor : Measurements)
+    {
+      double Time = TimeOld;
+      while(Measurements.getTimeAbove(Sensor.first, Time, Time))
+      {
+        if(Time >= TimeMin)
+        {
+          TimeAbove = std::min(TimeAbove, Time);
+          break;
+        }
+        TimeBelow = std::max(TimeBelow, Time);
+      }
+    }
+
+    /** events that come too fast are merged into the following epoch, the last one is never skipped */
+    if(TimeAbove < std::numeric_limits<double>::infinity())
+    {
+      TimeNew = TimeAbove;
+    }
+    else if(TimeBelow > TimeOld)
+    {
+      TimeNew = TimeBelow;
+    }
+    else
+    {
+      return false;
+    }
+    return true;
+  }
+
       /** increment to timestamp of next measurement */
     return Measurements.getTimeNext(Config.Solution.SyncSensor, TimeOld, TimeNew);
 
 }
 
+EpochCursor::EpochCursor(const libRSF::FactorGraphConfig &Config, const libRSF::SensorDataSet &Measurements):
+  UseEvents_(Config.Solution.IsAsync && Config.Solution.AsyncEvents)
+{
+  if(UseEvents_)
+  {
+    Events_ = Measurements.cursorAll();
+  }
+  else
+  {
+    Sync_ = Measurements.cursor(Config.Solution.SyncSensor);
+  }
+}
+
+bool EpochCursor::valid() const
+{
+  return UseEvents_ ? Events_.valid() : Sync_.valid();
+}
+
+double EpochCursor::getTime() const
+{
+  return UseEvents_ ? Events_.getTime() : Sync_.getTime();
+}
+
+bool EpochCursor::seekAbove(const double Time)
+{
+  return UseEvents_ ? Events_.seekAbove(Time) : Sync_.seekAbove(Time);
+}
+
+bool IncrementTime(const libRSF::FactorGraphConfig &Config,
+                   EpochCursor &Epochs,
+                   double &TimeOld,
+                   double &TimeNew,
+                   const double TimeLast)
+{
+  /** store old timestamp */
+  TimeOld = TimeNew;
+
+  /** check for time limit */
+  if(TimeOld >= TimeLast)
+  {
+    return false;
+  }
+
+  if(Config.Solution.IsAsync && !Config.Solution.AsyncEvents)
+  {
+    /** simply increment with predefined rate */
+    TimeNew = TimeOld + 1.0/Config.Solution.AsyncRate;
+    return true;
+  }
+
+  /** the cursor only moves forward, so the whole loop visits each timestamp once */
+  if(!Epochs.seekAbove(TimeOld))
+  {
+    return false;
+  }
+  TimeNew = Epochs.getTime();
+
+  /** events that come too fast are merged into the following epoch, the last one is never skipped */
+  if(Config.Solution.IsAsync)
+  {
+    const double TimeMin = TimeOld + 1.0/Config.Solution.AsyncRate;
+    while(TimeNew < TimeMin && Epochs.seekAbove(TimeNew))
+    {
+      TimeNew = Epochs.getTime();
+    }
+  }
+  return true;
+}
+
+size_t CountEpochs(const libRSF::FactorGraphConfig &Config,
+                   const libRSF::SensorDataSet &Measurements,
+                   const double TimeFirst,
+                   const double TimeLast)
+{
+  size_t Epochs = 1;
+  double TimeOld = TimeFirst - 1;
+  double TimeNow = TimeFirst;
+  EpochCursor Epochs(Config, Measurements);
+  while (IncrementTime(Config, Epochs, TimeOld, TimeNow, TimeLast))
+  {
+    Epochs++;
+  }
+  return Epochs;
+}
+
+void ReserveGraph(libRSF::FactorGraph &Graph,
+                  const libRSF::SensorDataSet &Measurements,
+                  const size_t Epochs)
+{
+  /** each epoch repeats the initial states and connects them with about one factor each */
+  const size_t StatesPerEpoch = std::max<size_t>(1, Graph.getStateData().getKeysAll().size());
+
+  /** nearly every measurement becomes a factor */
+  size_t MeasurementNumber = 0;
+  for (const auto &Sensor : Measurements)
+  {
+    MeasurementNumber += static_cast<size_t>(Measurements.countElements(Sensor.first));
+  }
+
+  Graph.reserve(Epochs * StatesPerEpoch, MeasurementNumber + Epochs * StatesPerEpoch);
+}
+
+bool GetFirstTimestamp (const libRSF::SensorDataSource &Source,
+                        const libRSF::FactorGraphConfig &Config,
+                        double &Timestamp)
+{
+  if(Config.Solution.IsAsync)
+  {
+    /** if async, take first overall timestamp */
+    bool HasMeasurement = false;
+    double Time;
+
+    for(const libRSF::DataType Type : Source.getKeysAll())
+    {
+      if(Source.getTimeFirst(Type, Time) && (!HasMeasurement || Time < Timestamp))
+      {
+        Timestamp = Time;
+        HasMeasurement = true;
+      }
+    }
+
+    if(!HasMeasurement)
+    {
+      PRINT_WARNING("There is no measurement!");
+    }
+  }
+  else
+  {
+    /** if sync take timestamp from sync sensor*/
+    if(!Source.getTimeFirst(Config.Solution.SyncSensor, Timestamp))
+    {
+       PRINT_ERROR("There is no measurement of: ", Config.Solution.SyncSensor);
+       return false;
+    }
+  }
+
+  return true;
+}
+
+bool GetLastTimestamp (const libRSF::SensorDataSource &Source,
+                       const libRSF::FactorGraphConfig &Config,
+                       double &Timestamp)
+{
+  if(Config.Solution.IsAsync)
+  {
+    /** if async, take last overall timestamp */
+    double Time = 0;
+    Timestamp = 0;
+    for(const libRSF::DataType Type : Source.getKeysAll())
+    {
+      if(Source.getTimeLast(Type, Time) && Time > Timestamp)
+      {
+        Timestamp = Time;
+      }
+    }
+  }
+  else
+  {
+    /** if sync take timestamp from sync sensor*/
+    if(!Source.getTimeLast(Config.Solution.SyncSensor, Timestamp))
+    {
+       PRINT_ERROR("There is no measurement of: ", Config.Solution.SyncSensor);
+       return false;
+    }
+  }
+
+  return true;
+}
+
+bool IncrementTime(const libRSF::FactorGraphConfig &Config,
+                   libRSF::SensorDataSource &Source,
+                   double &TimeOld,
+                   double &TimeNew,
+                   const double TimeLast)
+{
+  /** store old timestamp */
+  TimeOld = TimeNew;
+
+  /** check for time limit */
+  if(TimeOld >= TimeLast)
+  {
+    return false;
+  }
+
+  if(Config.Solution.IsAsync && !Config.Solution.AsyncEvents)
+  {
+    /** simply increment with predefined rate */
+    TimeNew = TimeOld + 1.0/Config.Solution.AsyncRate;
+    return true;
+  }
+
+  if(Config.Solution.IsAsync)
+  {
+    /** next measurement of any sensor, but not faster than the async rate */
+    const double TimeMin = TimeOld + 1.0/Config.Solution.AsyncRate;
+    double TimeAbove = std::numeric_limits<double>::infinity();
+    double TimeBelow = TimeOld;
+    for(const libRSF::DataType Type : Source.getKeysAll())
+    {
+      double Time = TimeOld;
+      while(Source.getTimeNext(Type, Time, Time))
+      {
+        if(Time >= TimeMin)
+        {
+          TimeAbove = std::min(TimeAbove, Time);
+          break;
+        }
+        TimeBelow = std::max(TimeBelow, Time);
+      }
+    }
+
+    /** events that come too fast are merged into the following epoch, the last one is never skipped */
+    if(TimeAbove < std::numeric_limits<double>::infinity())
+    {
+      TimeNew = TimeAbove;
+    }
+    else if(TimeBelow > TimeOld)
+    {
+      TimeNew = TimeBelow;
+    }
+    else
+    {
+      return false;
+    }
+    return true;
+  }
+
+  /** increment to timestamp of next measurement */
+  return Source.getTimeNext(Config.Solution.SyncSensor, TimeOld, TimeNew);
+}
+
+void UpdateMeasurements(libRSF::SensorDataSource &Source,
+                        libRSF::SensorDataSet &Measurements,
+                        const double TimeOld,
+                        const double TimeNow)
+{
+  Source.getMeasurementsUntil(TimeNow, Measurements);
+
+  /** keep the last measurement before TimeOld, some sensors fall back to it */
+  for(const libRSF::DataType Type : Source.getKeysAll())
+  {
+    double TimeFirst, TimeSecond;
+    while(Measurements.getTimeFirst(Type, TimeFirst) &&
+          Measurements.getTimeAbove(Type, TimeFirst, TimeSecond) &&
+          TimeSecond <= TimeOld)
+    {
+      Measurements.removeElement(Type, TimeFirst);
+    }
+  }
+}
+
+bool LoadInitialValues(const libRSF::FactorGraphConfig &Config,
+                       libRSF::StateDataSet &Values)
+{
+  if (Config.Solution.InitialValues.empty())
+  {
+    return false;
+  }
+
+  if (!libRSF::ReadResultFromBinaryFile(Config.Solution.InitialValues, Values))
+  {
+    PRINT_WARNING("Could not read initial values, all states are predicted.");
+    Values.clear();
+    return false;
+  }
+  return true;
+}
+
+int ApplyInitialValues(libRSF::FactorGraph &Graph,
+                       const libRSF::StateDataSet &Values,
+                       const double TimeOld,
+                       const double TimeNow)
+{
+  libRSF::StateDataSet &States = Graph.getStateData();
+
+  int Initialized = 0;
+  for (const std::string &ID : Values.getKeysAll())
+  {
+    if (!States.checkID(ID))
+    {
+      continue;
+    }
+
+    double Time;
+    bool HasNext = Values.getTimeAbove(ID, TimeOld, Time);
+    while (HasNext && Time <= TimeNow)
+    {
+      const int Number = std::min(Values.countElement(ID, Time), States.countElement(ID, Time));
+      for (int n = 0; n < Number; n++)
+      {
+        libRSF::Data Previous;
+        Values.getElement(ID, Time, n, Previous);
+        libRSF::Data &State = States.getElement(ID, Time, n);
+
+        /** a different type means a different graph structure */
+        if (Previous.getType() == State.getType() && Previous.getMean().size() == State.getMean().size())
+        {
+          State.setMean(Previous.getMean());
+          Initialized++;
+        }
+      }
+      HasNext = Values.getTimeNext(ID, Time, Time);
+    }
+  }
+  return Initialized;
+}
 
 void Solve(libRSF::FactorGraph &Graph,
            const libRSF::FactorGraphConfig &Config,
+           AdaptiveErrorModel &Adaptive,
+           libRSF::FixedLagSmoother &Window,
            libRSF::Data & IterationSummary,
-           const bool ForceSolve)
+           const bool ForceSolve,
+           const libRSF::Deadline &Limit)
 {
   const double TimeNow = IterationSummary.getTimestamp();
 
@@ -157,28 +493,44 @@ void Solve(libRSF::FactorGraph &Graph,
           Graph.solve(Config.SolverConfig);
 
           /** adapt error model */
-          int n = 0;
-          do
+          if (Config.Solution.AdaptionInterval > 0)
           {
-            AdaptErrorModel(Graph, Config, IterationSummary);
+            /** one solve that adapts the models between its iterations */
+            Adaptive.adapt(Graph, Config, IterationSummary);
+
+            AdaptionCallback Callback(Adaptive, Graph, Config, IterationSummary, Config.Solution.AdaptionInterval);
+            ceres::Solver::Options Options = Config.SolverConfig;
+            Options.update_state_every_iteration = true;
+            Options.callbacks.push_back(&Callback);
+            Graph.solve(Options);
+
+            /** converge with the last model, this also drops the callback from the stored options */
             Graph.solve(Config.SolverConfig);
-            n++;
           }
-          while (Graph.getSolverSummary().num_successful_steps > 2 && n < 10);
+          else
+          {
+            libRSF::SolveAdaptive(Graph, Config, [&]()
+            {
+              return Adaptive.adapt(Graph, Config, IterationSummary);
+            });
+          }
 
           /** compute covariance */
           if(Config.Solution.EstimateCov)
           {
-            Graph.computeCovariance(POSITION_STATE);
+            /** all types share one factorization */
+            std::vector<std::string> CovarianceTypes = {POSITION_STATE};
 
             if(Graph.getStateData().checkID(ORIENTATION_STATE))
             {
-              Graph.computeCovariance(ORIENTATION_STATE);
+              CovarianceTypes.emplace_back(ORIENTATION_STATE);
             }
-          if(Graph.getStateData().checkID(ANGLE_STATE))
-          {
-            Graph.computeCovariance(ANGLE_STATE);
-          }
+            if(Graph.getStateData().checkID(ANGLE_STATE))
+            {
+              CovarianceTypes.emplace_back(ANGLE_STATE);
+            }
+
+            Graph.computeCovariances(CovarianceTypes);
           }
         }
       }
@@ -189,73 +541,101 @@ void Solve(libRSF::FactorGraph &Graph,
         if(Config.GNSS.IsActive || Config.LoopClosure.IsActive || Config.Ranging.IsActive)
         {
           /** for GNSS, we have RANSAC to get a initial solution */
-          AdaptErrorModel(Graph, Config, IterationSummary);
-          Graph.solve(Config.SolverConfig);
+          if (!Limit.hasPassed())
+          {
+            Adaptive.adapt(Graph, Config, IterationSummary);
+          }
+          Graph.solve(Config.SolverConfig, Limit);
         }
         else
         {
-          /** without GNSS, we solve first before we adapt the error model */
-          Graph.solve(Config.SolverConfig);
-          if(AdaptErrorModel(Graph, Config, IterationSummary))
+          /** without GNSS, we solve first before we adapt the error model, the first solution gets half of the budget */
+          Graph.solve(Config.SolverConfig, Limit.getFraction(0.5));
+          if(!Limit.hasPassed() && Adaptive.adapt(Graph, Config, IterationSummary))
           {
-            Graph.solve(Config.SolverConfig);
+            Graph.solve(Config.SolverConfig, Limit);
           }
         }
 
         /** compute covariance */
-        if(Config.Solution.EstimateCov)
+        if(Config.Solution.EstimateCov && Config.Solution.IncrementalCovariance)
         {
-          Graph.computeCovariance(POSITION_STATE, TimeNow);
+          Graph.computeCovarianceIncremental(POSITION_STATE, TimeNow);
 
           if(Graph.getStateData().checkID(ORIENTATION_STATE))
           {
-            Graph.computeCovariance(ORIENTATION_STATE, TimeNow);
+            Graph.computeCovarianceIncremental(ORIENTATION_STATE, TimeNow);
           }
           if(Graph.getStateData().checkID(ANGLE_STATE))
           {
-            Graph.computeCovariance(ANGLE_STATE, TimeNow);
+            Graph.computeCovarianceIncremental(ANGLE_STATE, TimeNow);
           }
         }
-
-        /** reduce size */
-        if (Config.Solution.Marginalize)
-        {
-          Graph.marginalizeAllStatesOutsideWindow(Config.Solution.WindowLength, TimeNow, 1.01);
-        }
-        else
+        else if(Config.Solution.EstimateCov)
         {
-          Graph.removeAllStatesOutsideWindow(Config.Solution.WindowLength, TimeNow);
+          Graph.computeMarginalCovariance(POSITION_STATE, TimeNow);
+
+          if(Graph.getStateData().checkID(ORIENTATION_STATE))
+          {
+            Graph.computeMarginalCovariance(ORIENTATION_STATE, TimeNow);
+          }
+          if(Graph.getStateData().checkID(ANGLE_STATE))
+          {
+            Graph.computeMarginalCovariance(ANGLE_STATE, TimeNow);
+          }
         }
+
+        /** reduce size, the smoother decides when it is worth it */
+        Window.update(TimeNow);
+        IterationSummary.setValueScalar(libRSF::DataElement::WindowLength, Window.getLag());
       }
       break;
 
     case libRSF::SolutionType::Smoother:
       {
         /** adapt error model at first */
-        AdaptErrorModel(Graph, Config, IterationSummary);
+        Adaptive.adapt(Graph, Config, IterationSummary);
 
-        /** solve graph afterwards */
-        Graph.solve(Config.SolverConfig);
+        /** solve graph afterwards, the final solution is always a complete one */
+        if(Config.Solution.Incremental && !ForceSolve)
+        {
+          Graph.solveIncremental(Config.SolverConfig);
+        }
+        else
+        {
+          Graph.solve(Config.SolverConfig);
+        }
 
         if(ForceSolve && Config.Solution.EstimateCov)
         {
           /** compute covariance */
-          Graph.computeCovariance(POSITION_STATE);
+          std::vector<std::string> CovarianceTypes = {POSITION_STATE};
           if(Graph.getStateData().checkID(ORIENTATION_STATE))
           {
-            Graph.computeCovariance(ORIENTATION_STATE);
+            CovarianceTypes.emplace_back(ORIENTATION_STATE);
           }
+          Graph.computeCovariances(CovarianceTypes);
         }
       }
       break;
 
     case libRSF::SolutionType::SmootherRT:
       {
-        /** adapt error model at first */
-        AdaptErrorModel(Graph, Config, IterationSummary);
+        /** adapt error model at first, if there is time left */
+        if (!Limit.hasPassed())
+        {
+          Adaptive.adapt(Graph, Config, IterationSummary);
+        }
 
         /** solve graph afterwards */
-        Graph.solve(Config.SolverConfig);
+        if(Config.Solution.Incremental)
+        {
+          Graph.solveIncremental(Config.SolverConfig);
+        }
+        else
+        {
+          Graph.solve(Config.SolverConfig, Limit);
+        }
 
         if(Config.Solution.EstimateCov)
         {
@@ -271,32 +651,19 @@ void Solve(libRSF::FactorGraph &Graph,
           }
         }
 
-        Graph.setAllConstantOutsideWindow(Config.Solution.WindowLength, TimeNow);
+        Graph.setAllConstantOutsideWindow(Window.getLag(), TimeNow);
+        IterationSummary.setValueScalar(libRSF::DataElement::WindowLength, Window.getLag());
       }
       break;
 
     case libRSF::SolutionType::Filter:
       {
         /** adapt error model at first */
-        AdaptErrorModel(Graph, Config, IterationSummary);
-
-        /** solve with one step */
-        Graph.solve(Config.SolverConfig);
+        Adaptive.adapt(Graph, Config, IterationSummary);
 
-        /** compute covariance */
-        if(Config.Solution.EstimateCov)
-        {
-          Graph.computeCovariance(POSITION_STATE, TimeNow);
-
-          if(Graph.getStateData().checkID(ORIENTATION_STATE))
-          {
-            Graph.computeCovariance(ORIENTATION_STATE, TimeNow);
-          }
-          if(Graph.getStateData().checkID(ANGLE_STATE))
-          {
-            Graph.computeCovariance(ANGLE_STATE, TimeNow);
-          }
-        }
+        /** the previous states become a prior, so the graph keeps a constant size */
+        libRSF::RecursiveFilter Filter(Graph, Config);
+        Filter.step(TimeNow, Config.SolverConfig, Limit);
 
       }
       break;
@@ -311,35 +678,62 @@ void Solve(libRSF::FactorGraph &Graph,
   }
 }
 
+void SaveMemoryUsage(const libRSF::FactorGraph &Graph,
+                     libRSF::Data &IterationSummary)
+{
+  const libRSF::MemoryUsage Usage = Graph.getMemoryUsage();
+
+  /** [states, sensor data, structure, factors] in bytes */
+  libRSF::Vector4 Bytes;
+  Bytes << static_cast<double>(Usage.StateData),
+           static_cast<double>(Usage.SensorData),
+           static_cast<double>(Usage.Structure),
+           static_cast<double>(Usage.Factors);
+  IterationSummary.setValue(libRSF::DataElement::MemoryUsage, Bytes);
+}
+
 void Save(libRSF::FactorGraph &Graph,
           const libRSF::FactorGraphConfig &Config,
           libRSF::Data & IterationSummary,
-          libRSF::StateDataSet &Result,
+          libRSF::ResultSink &Sink,
           const bool SaveFinal)
 {
   const double TimeNow = IterationSummary.getTimestamp();
 
+  /** iterations of all solves since the last call belong to this epoch */
+  if (Config.Solution.IterationTelemetry)
+  {
+    std::vector<libRSF::SolverIteration> Iterations;
+    Graph.getIterationTelemetryAndReset(Iterations);
+    for (const libRSF::SolverIteration &Iteration : Iterations)
+    {
+      Sink.addElement(SOLVER_ITERATION_STATE, Iteration.toData(TimeNow));
+    }
+  }
+
   switch(Config.Solution.Type)
   {
     case libRSF::SolutionType::Batch:
       if (SaveFinal)
       {
         /** save state data */
-        Result = Graph.getStateData();
+        Sink.addAll(Graph.getStateData());
 
         /** save runtime information */
         IterationSummary.setValueScalar(libRSF::DataElement::DurationSolver, Graph.getSolverDurationAndReset());
         IterationSummary.setValueScalar(libRSF::DataElement::DurationCovariance, Graph.getCovarianceDurationAndReset());
         IterationSummary.setValueScalar(libRSF::DataElement::IterationSolver, Graph.getSolverIterationsAndReset());
+        IterationSummary.setValueScalar(libRSF::DataElement::DeadlineMisses, Graph.getDeadlineMissesAndReset());
         IterationSummary.setValueScalar(libRSF::DataElement::DurationMarginal, Graph.getMarginalDurationAndReset());
-        Result.addElement(SOLVE_TIME_STATE, IterationSummary);
+        SaveMemoryUsage(Graph, IterationSummary);
+        Sink.addElement(SOLVE_TIME_STATE, IterationSummary);
       }
       break;
 
     case libRSF::SolutionType::Smoother:
       if (SaveFinal)
       {
-        Result.merge(Graph.getStateData());
+        Sink.addAll(Graph.getStateData());
       }
       if (!SaveFinal)
       {
@@ -347,8 +741,10 @@ void Save(libRSF::FactorGraph &Graph,
         IterationSummary.setValueScalar(libRSF::DataElement::DurationSolver, Graph.getSolverDurationAndReset());
         IterationSummary.setValueScalar(libRSF::DataElement::DurationCovariance, Graph.getCovarianceDurationAndReset());
         IterationSummary.setValueScalar(libRSF::DataElement::IterationSolver, Graph.getSolverIterationsAndReset());
+        IterationSummary.setValueScalar(libRSF::DataElement::DeadlineMisses, Graph.getDeadlineMissesAndReset());
         IterationSummary.setValueScalar(libRSF::DataElement::DurationMarginal, Graph.getMarginalDurationAndReset());
-        Result.addElement(SOLVE_TIME_STATE, IterationSummary);
+        SaveMemoryUsage(Graph, IterationSummary);
+        Sink.addElement(SOLVE_TIME_STATE, IterationSummary);
       }
     break;
 
@@ -356,68 +752,73 @@ void Save(libRSF::FactorGraph &Graph,
     case libRSF::SolutionType::Window:
       if (!SaveFinal)
       {
-        Result.addElement(POSITION_STATE, Graph.getStateData().getElement(POSITION_STATE, TimeNow, 0));
+        Sink.addElement(POSITION_STATE, Graph.getStateData().getElement(POSITION_STATE, TimeNow, 0));
 
         /** 3DOF Quaternion */
         if(Graph.getStateData().checkElement(ORIENTATION_STATE, TimeNow, 0))
         {
-          Result.addElement(ORIENTATION_STATE, Graph.getStateData().getElement(ORIENTATION_STATE, TimeNow, 0));
+          Sink.addElement(ORIENTATION_STATE, Graph.getStateData().getElement(ORIENTATION_STATE, TimeNow, 0));
         }
         /** 1DOF angle */
         if(Graph.getStateData().checkElement(ANGLE_STATE, TimeNow, 0))
         {
-          Result.addElement(ANGLE_STATE, Graph.getStateData().getElement(ANGLE_STATE, TimeNow, 0));
+          Sink.addElement(ANGLE_STATE, Graph.getStateData().getElement(ANGLE_STATE, TimeNow, 0));
         }
         /** IMU Speed+Bias */
         if(Graph.getStateData().checkElement(IMU_STATE, TimeNow, 0))
         {
-          Result.addElement(IMU_STATE, Graph.getStateData().getElement(IMU_STATE, TimeNow, 0));
+          Sink.addElement(IMU_STATE, Graph.getStateData().getElement(IMU_STATE, TimeNow, 0));
         }
 
         /** save run time information */
         IterationSummary.setValueScalar(libRSF::DataElement::DurationSolver, Graph.getSolverDurationAndReset());
         IterationSummary.setValueScalar(libRSF::DataElement::DurationCovariance, Graph.getCovarianceDurationAndReset());
         IterationSummary.setValueScalar(libRSF::DataElement::IterationSolver, Graph.getSolverIterationsAndReset());
+        IterationSummary.setValueScalar(libRSF::DataElement::DeadlineMisses, Graph.getDeadlineMissesAndReset());
         IterationSummary.setValueScalar(libRSF::DataElement::DurationMarginal, Graph.getMarginalDurationAndReset());
-        Result.addElement(SOLVE_TIME_STATE, IterationSummary);
+        SaveMemoryUsage(Graph, IterationSummary);
+        Sink.addElement(SOLVE_TIME_STATE, IterationSummary);
       }
       break;
 
     case libRSF::SolutionType::Filter:
       if (!SaveFinal)
       {
-        Result.addElement(POSITION_STATE, Graph.getStateData().getElement(POSITION_STATE, TimeNow, 0));
+        Sink.addElement(POSITION_STATE, Graph.getStateData().getElement(POSITION_STATE, TimeNow, 0));
 
         /** 3DOF Quaternion */
         if(Graph.getStateData().checkElement(ORIENTATION_STATE, TimeNow, 0))
         {
-          Result.addElement(ORIENTATION_STATE, Graph.getStateData().getElement(ORIENTATION_STATE, TimeNow, 0));
+          Sink.addElement(ORIENTATION_STATE, Graph.getStateData().getElement(ORIENTATION_STATE, TimeNow, 0));
         }
         /** 1DOF angle */
         if(Graph.getStateData().checkElement(ANGLE_STATE, TimeNow, 0))
         {
-          Result.addElement(ANGLE_STATE, Graph.getStateData().getElement(ANGLE_STATE, TimeNow, 0));
+          Sink.addElement(ANGLE_STATE, Graph.getStateData().getElement(ANGLE_STATE, TimeNow, 0));
         }
 
         /** save run time information */
         IterationSummary.setValueScalar(libRSF::DataElement::DurationSolver, Graph.getSolverDurationAndReset());
         IterationSummary.setValueScalar(libRSF::DataElement::DurationCovariance, Graph.getCovarianceDurationAndReset());
         IterationSummary.setValueScalar(libRSF::DataElement::IterationSolver, Graph.getSolverIterationsAndReset());
+        IterationSummary.setValueScalar(libRSF::DataElement::DeadlineMisses, Graph.getDeadlineMissesAndReset());
         IterationSummary.setValueScalar(libRSF::DataElement::DurationMarginal, Graph.getMarginalDurationAndReset());
-        Result.addElement(SOLVE_TIME_STATE, IterationSummary);
+        SaveMemoryUsage(Graph, IterationSummary);
+        Sink.addElement(SOLVE_TIME_STATE, IterationSummary);
       }
       break;
 
     case libRSF::SolutionType::None:
       if (SaveFinal)
       {
-        Result = Graph.getStateData();
+        Sink.addAll(Graph.getStateData());
 
         /** save zero solution information */
         IterationSummary.setValue(libRSF::DataElement::DurationSolver, libRSF::Vector1::Zero());
         IterationSummary.setValue(libRSF::DataElement::IterationSolver, libRSF::Vector1::Zero());
         IterationSummary.setValue(libRSF::DataElement::DurationMarginal, libRSF::Vector1::Zero());
-        Result.addElement(SOLVE_TIME_STATE, IterationSummary);
+        SaveMemoryUsage(Graph, IterationSummary);
+        Sink.addElement(SOLVE_TIME_STATE, IterationSummary);
       }
       break;
 
@@ -426,3 +827,83 @@ void Save(libRSF::FactorGraph &Graph,
       break;
   }
 }
+
+void Save(libRSF::FactorGraph &Graph,
+          const libRSF::FactorGraphConfig &Config,
+          libRSF::Data & IterationSummary,
+          libRSF::StateDataSet &Result,
+          const bool SaveFinal)
+{
+  libRSF::MemoryResultSink Sink(Result);
+  Save(Graph, Config, IterationSummary, Sink, SaveFinal);
+}
+
+void AdaptWindowLength(libRSF::WindowController &Controller,
+                       libRSF::FixedLagSmoother &Window,
+                       const libRSF::Data &IterationSummary)
+{
+  if (!Controller.isActive())
+  {
+    return;
+  }
+
+  /** everything except the handling of the measurements scales with the window */
+  double Duration = 0.0;
+  for (const libRSF::DataElement Element : {libRSF::DataElement::DurationSolver,
+                                            libRSF::DataElement::DurationCovariance,
+                                            libRSF::DataElement::DurationMarginal,
+                                            libRSF::DataElement::DurationAdaptive})
+  {
+    if (IterationSummary.checkElement(Element))
+    {
+      Duration += IterationSummary.getValue(Element)(0);
+    }
+  }
+
+  Window.setLag(Controller.update(Duration));
+}
+
+MetricsExport::MetricsExport(const libRSF::FactorGraphConfig &Config, libRSF::FactorGraph &Graph) : File_(Config.Solution.MetricsFile)
+{
+  if (Config.Solution.MetricsPort <= 0 && File_.empty())
+  {
+    return;
+  }
+
+  Metrics_ = std::make_shared<libRSF::GraphMetrics>();
+  Graph.setMetrics(Metrics_);
+
+  if (Config.Solution.MetricsPort > 0)
+  {
+    Server_ = std::make_unique<libRSF::MetricsServer>();
+    if (!Server_->start(Config.Solution.MetricsPort))
+    {
+      Server_.reset();
+    }
+  }
+}
+
+MetricsExport::~MetricsExport()
+{
+  /** the last state of the run remains for the collector */
+  if (Metrics_ != nullptr && !File_.empty())
+  {
+    libRSF::GetMetricsRegistry().writeToFile(File_);
+  }
+}
+
+void MetricsExport::recordEpoch(const libRSF::Data &IterationSummary)
+{
+  if (Metrics_ == nullptr)
+  {
+    return;
+  }
+
+  Metrics_->recordEpoch(IterationSummary);
+
+  if (!File_.empty() && FileTimer_.getSeconds() >= 1.0)
+  {
+    libRSF::GetMetricsRegistry().writeToFile(File_);
+    FileTimer_.reset();
+  }
+}
@@ -44,6 +44,34 @@ bool IncrementTime(const libRSF::FactorGraphConfig &Config,
                    double &TimeNew,
                    double TimeLast);
 
+/** epochs of an offline run: the sync sensor or, for event-driven async, the merged measurements of all sensors */
+class EpochCursor
+{
+  public:
+    /** the cursor is invalidated by modifications of the measurements */
+    EpochCursor(const libRSF::FactorGraphConfig &Config, const libRSF::SensorDataSet &Measurements);
+
+    [[nodiscard]] bool valid() const;
+
+    /** only valid if valid() is true */
+    [[nodiscard]] double getTime() const;
+
+    /** move to the first epoch above Time, the cursor never moves backwards */
+    bool seekAbove(double Time);
+
+  private:
+    bool UseEvents_;
+    libRSF::SensorDataSet::TimeCursor Sync_;
+    libRSF::SensorDataSet::EventCursor Events_;
+};
+
+/** same as above, but the epochs are tracked by a persistent cursor instead of a search per step */
+bool IncrementTime(const libRSF::FactorGraphConfig &Config,
+                   EpochCursor &Epochs,
+                   double &TimeOld,
+                   double &TimeNew,
+                   double TimeLast);
+
 bool GetFirstTimestamp (const libRSF::SensorDataSet &Measurements,
                         const libRSF::FactorGraphConfig &Config,
                         double &Timestamp);
@@ -52,15 +80,98 @@ bool GetLastTimestamp (const libRSF::SensorDataSet &Measurements,
                        const libRSF::FactorGraphConfig &Config,
                        double &Timestamp);
 
+/** number of epochs between TimeFirst and TimeLast as visited by IncrementTime() */
+size_t CountEpochs(const libRSF::FactorGraphConfig &Config,
+                   const libRSF::SensorDataSet &Measurements,
+                   double TimeFirst,
+                   double TimeLast);
+
+/** capacity hint for offline problems, the initialized graph has to contain the states of one epoch */
+void ReserveGraph(libRSF::FactorGraph &Graph,
+                  const libRSF::SensorDataSet &Measurements,
+                  size_t Epochs);
+
+/** streaming variants, that only keep the relevant part of the data in memory */
+bool IncrementTime(const libRSF::FactorGraphConfig &Config,
+                   libRSF::SensorDataSource &Source,
+                   double &TimeOld,
+                   double &TimeNew,
+                   double TimeLast);
+
+bool GetFirstTimestamp (const libRSF::SensorDataSource &Source,
+                        const libRSF::FactorGraphConfig &Config,
+                        double &Timestamp);
+
+bool GetLastTimestamp (const libRSF::SensorDataSource &Source,
+                       const libRSF::FactorGraphConfig &Config,
+                       double &Timestamp);
+
+/** load new measurements up to TimeNow and drop the ones that are older than TimeOld */
+void UpdateMeasurements(libRSF::SensorDataSource &Source,
+                        libRSF::SensorDataSet &Measurements,
+                        double TimeOld,
+                        double TimeNow);
+
+/** read the binary result of a previous run, returns false if it is not configured or could not be read */
+bool LoadInitialValues(const libRSF::FactorGraphConfig &Config,
+                       libRSF::StateDataSet &Values);
+
+/** copy the previous estimates to all states in (TimeOld, TimeNow] with the same ID, timestamp, number and type,
+ * states without a match keep their prediction, returns the number of initialized states */
+int ApplyInitialValues(libRSF::FactorGraph &Graph,
+                       const libRSF::StateDataSet &Values,
+                       double TimeOld,
+                       double TimeNow);
+
 void Solve(libRSF::FactorGraph &Graph,
            const libRSF::FactorGraphConfig &Config,
+           AdaptiveErrorModel &Adaptive,
+           libRSF::FixedLagSmoother &Window,
            libRSF::Data & IterationSummary,
-           bool ForceSolve);
+           bool ForceSolve,
+           const libRSF::Deadline &Limit = libRSF::Deadline());
 
+/** store the memory breakdown of the graph in the summary */
+void SaveMemoryUsage(const libRSF::FactorGraph &Graph,
+                     libRSF::Data &IterationSummary);
+
+/** pass the final estimates of this step to the sink */
+void Save(libRSF::FactorGraph &Graph,
+          const libRSF::FactorGraphConfig &Config,
+          libRSF::Data & IterationSummary,
+          libRSF::ResultSink &Sink,
+          bool SaveFinal);
+
+/** collect all estimates in memory */
 void Save(libRSF::FactorGraph &Graph,
           const libRSF::FactorGraphConfig &Config,
           libRSF::Data & IterationSummary,
           libRSF::StateDataSet &Result,
           bool SaveFinal);
 
+/** set the window length of the next epoch from the durations of the saved summary */
+void AdaptWindowLength(libRSF::WindowController &Controller,
+                       libRSF::FixedLagSmoother &Window,
+                       const libRSF::Data &IterationSummary);
+
+/** optional monitoring, the metrics are served on solution/metrics_port and/or written to solution/metrics_file */
+class MetricsExport
+{
+  public:
+    MetricsExport(const libRSF::FactorGraphConfig &Config, libRSF::FactorGraph &Graph);
+    ~MetricsExport();
+
+    MetricsExport(const MetricsExport &) = delete;
+    MetricsExport &operator=(const MetricsExport &) = delete;
+
+    /** record the durations of a finished epoch, the file is written at most once per second */
+    void recordEpoch(const libRSF::Data &IterationSummary);
+
+  private:
+    std::shared_ptr<libRSF::GraphMetrics> Metrics_;
+    std::unique_ptr<libRSF::MetricsServer> Server_;
+    std::string File_;
+    libRSF::Timer FileTimer_;
+};
+
 #endif // APPPOOL_UTILITY_H
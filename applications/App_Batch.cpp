@@ -0,0 +1,486 @@
+/***************************************************************************
+ * libRSF - A Robust Sensor Fusion Library
+ *
+ * Copyright (C) 2026 Chair of Automation Technology / TU Chemnitz
+ * For more information see https://www.tu-chemnitz.de/etit/proaut/libRSF
+ *
+ * libRSF is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libRSF is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with libRSF.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Tim Pfeifer (tim.pfeifer@etit.tu-chemnitz.de)
+ ***************************************************************************/
+
+/**
+ * @file App_Batch.cpp
+ * @author Tim Pfeifer
+ * @date 14.10.2026
+ * @brief Runs many GNSS estimation jobs in parallel within one process or on many nodes through a shared job directory.
+ * @copyright GNU Public License.
+ *
+ */
+
+#include "App_Batch.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <thread>
+
+#include <dirent.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/** subdirectories of a job directory */
+static const std::string OpenDirectory = "/open/";
+static const std::string RunningDirectory = "/running/";
+static const std::string DoneDirectory = "/done/";
+static const std::string JobExtension = ".job";
+static const std::string ResultExtension = ".result";
+
+static std::vector<std::string> SplitArguments(const std::string &Line)
+{
+  std::istringstream Stream(Line);
+  std::vector<std::string> Arguments;
+  std::string Argument;
+  while (Stream >> Argument)
+  {
+    Arguments.push_back(Argument);
+  }
+  return Arguments;
+}
+
+static bool HasExtension(const std::string &Name, const std::string &Extension)
+{
+  return Name.size() >= Extension.size() && Name.compare(Name.size() - Extension.size(), Extension.size(), Extension) == 0;
+}
+
+/** files of a directory with the given extension, sorted by name */
+static std::vector<std::string> ListDirectory(const std::string &Directory, const std::string &Extension)
+{
+  std::vector<std::string> Files;
+  DIR *Handle = opendir(Directory.c_str());
+  if (Handle == nullptr)
+  {
+    return Files;
+  }
+  for (const dirent *Entry = readdir(Handle); Entry != nullptr; Entry = readdir(Handle))
+  {
+    const std::string Name = Entry->d_name;
+    if (Name.front() != '.' && HasExtension(Name, Extension))
+    {
+      Files.push_back(Name);
+    }
+  }
+  closedir(Handle);
+
+  std::sort(Files.begin(), Files.end());
+  return Files;
+}
+
+static bool MakeDirectory(const std::string &Directory)
+{
+  if (mkdir(Directory.c_str(), 0775) != 0 && errno != EEXIST)
+  {
+    PRINT_ERROR("Could not create directory: ", Directory);
+    return false;
+  }
+  return true;
+}
+
+/** other nodes never see a partially written file */
+static bool WriteFileAtomic(const std::string &Filename, const std::string &Content)
+{
+  const std::string Temporary = Filename + ".tmp";
+  {
+    std::ofstream File(Temporary);
+    File << Content;
+    if (!File)
+    {
+      PRINT_ERROR("Could not write file: ", Temporary);
+      return false;
+    }
+  }
+  return std::rename(Temporary.c_str(), Filename.c_str()) == 0;
+}
+
+static double GetPeakMemory()
+{
+  rusage Usage{};
+  getrusage(RUSAGE_SELF, &Usage);
+  return static_cast<double>(Usage.ru_maxrss) / 1024.0;
+}
+
+/** unique over all nodes */
+static std::string GetWorkerName(const size_t Slot)
+{
+  char Host[256] = {};
+  gethostname(Host, sizeof(Host) - 1);
+  return std::string(Host) + "_" + std::to_string(getpid()) + "_" + std::to_string(Slot);
+}
+
+bool ReadJobFile(const std::string &JobFile,
+                 std::vector<std::vector<std::string>> &Jobs)
+{
+  std::ifstream File(JobFile);
+  if (!File.is_open())
+  {
+    PRINT_ERROR("Could not open job file: ", JobFile);
+    return false;
+  }
+
+  std::string Line;
+  int LineNumber = 0;
+  while (std::getline(File, Line))
+  {
+    LineNumber++;
+
+    /** split into arguments */
+    const std::vector<std::string> Arguments = SplitArguments(Line);
+
+    /** skip empty lines and comments */
+    if (Arguments.empty() || Arguments.front().front() == '#')
+    {
+      continue;
+    }
+
+    if (Arguments.size() != 3 && Arguments.size() != 4)
+    {
+      PRINT_ERROR("Line ", LineNumber, " of ", JobFile, " should contain [ConfigFile InputFile OutputFile GTFile(optional)]!");
+      return false;
+    }
+
+    Jobs.push_back(Arguments);
+  }
+
+  return true;
+}
+
+bool RunJob(const std::vector<std::string> &Arguments,
+            const int SolverThreads,
+            JobResult &Result)
+{
+  libRSF::Timer JobTimer;
+  Result = JobResult();
+
+  /** every job has its own configuration */
+  libRSF::FactorGraphConfig Config;
+  if (!Config.ReadCommandLineOptions({Arguments.begin(), Arguments.begin() + 3}))
+  {
+    PRINT_ERROR("Could not read configuration: ", Arguments.front());
+    return false;
+  }
+
+  /** share the cores between all workers */
+  Config.SolverConfig.num_threads = SolverThreads;
+
+  /** data structure for estimates*/
+  libRSF::StateDataSet Estimate;
+
+  /** solve the estimation problem */
+  if (CreateGraphAndSolve(Config, Estimate) != 0)
+  {
+    PRINT_ERROR("Something gone wrong while estimating GNSS position for: ", Config.InputFile);
+    return false;
+  }
+
+  /** export position estimate, additional estimates and timing information to file */
+  libRSF::WriteDataToFile(Config.OutputFile, {POSITION_STATE, ORIENTATION_STATE, ANGLE_STATE, SOLVE_TIME_STATE}, Estimate);
+
+  Result.Duration = JobTimer.getSeconds();
+  Result.PeakMemory = GetPeakMemory();
+  Result.Success = true;
+
+  /** evaluate against the optional ground truth */
+  if (Arguments.size() > 3)
+  {
+    libRSF::SensorDataSet GT;
+    if (!libRSF::ReadGroundTruth(Arguments.at(3), GT))
+    {
+      Result.Success = false;
+      return false;
+    }
+    Result.ATE = libRSF::EvaluateTrajectory(GT, libRSF::DataType::Point3, Estimate, POSITION_STATE).ATE;
+    Result.Success = std::isfinite(Result.ATE);
+  }
+
+  return Result.Success;
+}
+
+int RunBatch(const std::vector<std::vector<std::string>> &Jobs,
+             int WorkerNumber)
+{
+  const int CoreNumber = libRSF::GetThreadNumber();
+  const int JobNumber = static_cast<int>(Jobs.size());
+
+  /** one worker per core by default, but not more than jobs */
+  if (WorkerNumber <= 0)
+  {
+    WorkerNumber = CoreNumber;
+  }
+  WorkerNumber = std::max(1, std::min(WorkerNumber, JobNumber));
+
+  /** avoid oversubscription by the threads of the solver */
+  const int SolverThreads = std::max(1, CoreNumber / WorkerNumber);
+
+  /** idle workers take the next open job, so long jobs do not block the remaining ones */
+  std::atomic<int> NextJob(0);
+  std::atomic<int> FailedJobs(0);
+
+  auto Work = [&](size_t)
+  {
+    JobResult Result;
+    for (int Job = NextJob++; Job < JobNumber; Job = NextJob++)
+    {
+      if (!RunJob(Jobs.at(Job), SolverThreads, Result))
+      {
+        FailedJobs++;
+      }
+    }
+  };
+
+  libRSF::GetThreadPool().parallelRun(WorkerNumber, Work);
+
+  return FailedJobs;
+}
+
+bool SubmitJobs(const std::vector<std::vector<std::string>> &Jobs,
+                const std::string &JobDirectory)
+{
+  if (!MakeDirectory(JobDirectory) ||
+      !MakeDirectory(JobDirectory + OpenDirectory) ||
+      !MakeDirectory(JobDirectory + RunningDirectory) ||
+      !MakeDirectory(JobDirectory + DoneDirectory))
+  {
+    return false;
+  }
+
+  /** a second submission to the same directory continues the numbering */
+  size_t FirstJob = 0;
+  for (const std::string &Directory : {OpenDirectory, RunningDirectory, DoneDirectory})
+  {
+    for (const std::string &File : ListDirectory(JobDirectory + Directory, ""))
+    {
+      unsigned long Number = 0;
+      if (std::sscanf(File.c_str(), "job_%lu", &Number) == 1)
+      {
+        FirstJob = std::max(FirstJob, static_cast<size_t>(Number) + 1);
+      }
+    }
+  }
+
+  for (size_t nJob = 0; nJob < Jobs.size(); nJob++)
+  {
+    std::ostringstream Name;
+    Name << "job_" << std::setw(6) << std::setfill('0') << FirstJob + nJob;
+
+    std::ostringstream Content;
+    for (const std::string &Argument : Jobs.at(nJob))
+    {
+      Content << Argument << " ";
+    }
+    Content << std::endl;
+
+    if (!WriteFileAtomic(JobDirectory + OpenDirectory + Name.str() + JobExtension, Content.str()))
+    {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+/** take the first open job that no other worker took before */
+static bool ClaimJob(const std::string &JobDirectory,
+                     const std::string &Worker,
+                     std::string &Name,
+                     std::string &RunningFile,
+                     std::vector<std::string> &Arguments)
+{
+  for (const std::string &File : ListDirectory(JobDirectory + OpenDirectory, JobExtension))
+  {
+    Name = File.substr(0, File.size() - JobExtension.size());
+    RunningFile = JobDirectory + RunningDirectory + Name + "." + Worker;
+    if (std::rename((JobDirectory + OpenDirectory + File).c_str(), RunningFile.c_str()) != 0)
+    {
+      continue;
+    }
+
+    std::ifstream Stream(RunningFile);
+    std::string Line;
+    std::getline(Stream, Line);
+    Arguments = SplitArguments(Line);
+    return true;
+  }
+  return false;
+}
+
+int WorkOnJobDirectory(const std::string &JobDirectory,
+                       int WorkerNumber)
+{
+  const int CoreNumber = libRSF::GetThreadNumber();
+  if (WorkerNumber <= 0)
+  {
+    WorkerNumber = CoreNumber;
+  }
+  const int SolverThreads = std::max(1, CoreNumber / WorkerNumber);
+
+  std::atomic<int> FailedJobs(0);
+
+  auto Work = [&](const size_t Slot)
+  {
+    const std::string Worker = GetWorkerName(Slot);
+
+    std::string Name;
+    std::string RunningFile;
+    std::vector<std::string> Arguments;
+    while (ClaimJob(JobDirectory, Worker, Name, RunningFile, Arguments))
+    {
+      JobResult Result;
+      if (Arguments.size() < 3 || !RunJob(Arguments, SolverThreads, Result))
+      {
+        FailedJobs++;
+      }
+
+      /** name success duration[s] memory[MB] ate[m] worker arguments */
+      std::ostringstream Line;
+      Line << std::setprecision(6) << std::fixed
+           << Name << " "
+           << Result.Success << " "
+           << Result.Duration << " "
+           << Result.PeakMemory << " "
+           << Result.ATE << " "
+           << Worker;
+      for (const std::string &Argument : Arguments)
+      {
+        Line << " " << Argument;
+      }
+      Line << std::endl;
+
+      WriteFileAtomic(JobDirectory + DoneDirectory + Name + ResultExtension, Line.str());
+      std::remove(RunningFile.c_str());
+    }
+  };
+
+  libRSF::GetThreadPool().parallelRun(WorkerNumber, Work);
+
+  return FailedJobs;
+}
+
+int CollectJobResults(const std::string &JobDirectory,
+                      const std::string &ReportFile)
+{
+  std::ofstream Report(ReportFile);
+  if (!Report.is_open())
+  {
+    PRINT_ERROR("Could not write job report: ", ReportFile);
+    return -1;
+  }
+
+  Report << "# job success duration[s] memory[MB] ate[m] worker config input output gt" << std::endl;
+
+  /** the file names keep the order of submission */
+  int FailedJobs = 0;
+  for (const std::string &File : ListDirectory(JobDirectory + DoneDirectory, ResultExtension))
+  {
+    std::ifstream Stream(JobDirectory + DoneDirectory + File);
+    std::string Line;
+    std::getline(Stream, Line);
+
+    const std::vector<std::string> Fields = SplitArguments(Line);
+    if (Fields.size() < 2 || Fields.at(1) != "1")
+    {
+      FailedJobs++;
+    }
+    Report << Line << std::endl;
+  }
+
+  const size_t OpenJobs = ListDirectory(JobDirectory + OpenDirectory, JobExtension).size();
+  const size_t RunningJobs = ListDirectory(JobDirectory + RunningDirectory, "").size();
+  if (OpenJobs + RunningJobs > 0)
+  {
+    PRINT_WARNING(OpenJobs, " jobs are still open and ", RunningJobs, " are running!");
+  }
+
+  return FailedJobs;
+}
+
+int main(int ArgC, char ** ArgV)
+{
+  google::InitGoogleLogging(ArgV[0]);
+
+  /** parse command line arguments */
+  if (ArgC < 2)
+  {
+    PRINT_ERROR("Usage: libRSF_batch JobFile [WorkerNumber]");
+    PRINT_ERROR("       libRSF_batch --submit JobFile JobDirectory");
+    PRINT_ERROR("       libRSF_batch --work JobDirectory [WorkerNumber]");
+    PRINT_ERROR("       libRSF_batch --collect JobDirectory ReportFile");
+    return 1;
+  }
+  const std::string Mode = ArgV[1];
+
+  /** distributed mode over a shared directory */
+  if (Mode == "--submit" || Mode == "--collect")
+  {
+    if (ArgC < 4)
+    {
+      PRINT_ERROR("Missing arguments for ", Mode);
+      return 1;
+    }
+
+    if (Mode == "--collect")
+    {
+      const int FailedJobs = CollectJobResults(ArgV[2], ArgV[3]);
+      return (FailedJobs == 0) ? 0 : 1;
+    }
+
+    std::vector<std::vector<std::string>> Jobs;
+    return (ReadJobFile(ArgV[2], Jobs) && SubmitJobs(Jobs, ArgV[3])) ? 0 : 1;
+  }
+
+  if (Mode == "--work")
+  {
+    if (ArgC < 3)
+    {
+      PRINT_ERROR("Missing job directory for --work");
+      return 1;
+    }
+    const int WorkerNumber = (ArgC > 3) ? std::stoi(ArgV[3]) : 0;
+    return (WorkOnJobDirectory(ArgV[2], WorkerNumber) == 0) ? 0 : 1;
+  }
+
+  /** local mode */
+  const int WorkerNumber = (ArgC > 2) ? std::stoi(ArgV[2]) : 0;
+
+  std::vector<std::vector<std::string>> Jobs;
+  if (!ReadJobFile(ArgV[1], Jobs))
+  {
+    return 1;
+  }
+
+  /** solve all estimation problems */
+  const int FailedJobs = RunBatch(Jobs, WorkerNumber);
+  if (FailedJobs > 0)
+  {
+    PRINT_ERROR(FailedJobs, " of ", Jobs.size(), " jobs failed!");
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,78 @@
+/***************************************************************************
+ * libRSF - A Robust Sensor Fusion Library
+ *
+ * Copyright (C) 2026 Chair of Automation Technology / TU Chemnitz
+ * For more information see https://www.tu-chemnitz.de/etit/proaut/libRSF
+ *
+ * libRSF is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libRSF is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with libRSF.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Tim Pfeifer (tim.pfeifer@etit.tu-chemnitz.de)
+ ***************************************************************************/
+
+ /**
+ * @file App_Batch.h
+ * @author Tim Pfeifer
+ * @date 14.10.2026
+ * @brief Runs many GNSS estimation jobs in parallel within one process or on many nodes through a shared job directory.
+ * @copyright GNU Public License.
+ *
+ */
+
+#ifndef APP_BATCH_H
+#define APP_BATCH_H
+
+#include "App_GNSS.h"
+
+#include <limits>
+#include <string>
+#include <vector>
+
+/** outcome of one job as reported by the worker */
+struct JobResult
+{
+  bool Success = false;
+  double Duration = 0.0;      /**< in seconds */
+  double PeakMemory = 0.0;    /**< peak resident memory of the worker process at the end of the job in MB */
+  double ATE = std::numeric_limits<double>::quiet_NaN();  /**< only with a ground truth file */
+};
+
+/** each non-empty line that is not a comment (#) contains: ConfigFile InputFile OutputFile [GTFile] */
+bool ReadJobFile(const std::string &JobFile,
+                 std::vector<std::vector<std::string>> &Jobs);
+
+/** solve one job and write its estimates, the solver uses the given number of threads */
+bool RunJob(const std::vector<std::string> &Arguments,
+            int SolverThreads,
+            JobResult &Result);
+
+/** process all jobs on a set of workers, returns the number of failed jobs */
+int RunBatch(const std::vector<std::vector<std::string>> &Jobs,
+             int WorkerNumber);
+
+/** the job directory is shared by all nodes:
+ *  - open/ contains one file per submitted job
+ *  - a worker claims a job by renaming it into running/, which is atomic, so every job is taken once
+ *  - done/ contains one result line per finished job */
+bool SubmitJobs(const std::vector<std::vector<std::string>> &Jobs,
+                const std::string &JobDirectory);
+
+/** process open jobs of the directory until there are none left, returns the number of failed jobs */
+int WorkOnJobDirectory(const std::string &JobDirectory,
+                       int WorkerNumber);
+
+/** merge the results into one report sorted by job, returns the number of failed jobs */
+int CollectJobResults(const std::string &JobDirectory,
+                      const std::string &ReportFile);
+
+#endif // APP_BATCH_H
@@ -35,12 +35,13 @@ void Predict(libRSF::FactorGraph &Graph,
              const libRSF::FactorGraphConfig &Config,
              const libRSF::SensorDataSet &Measurements,
              const double TimeOld,
-             const double TimeNow)
+             const double TimeNow,
+             const IMUIntervalCache *IMUCache = nullptr)
 {
   /** IMU */
   if (Config.IMU.IsActive)
   {
-    AddIMU(Graph, Config, Measurements, TimeOld, TimeNow);
+    AddIMU(Graph, Config, Measurements, TimeOld, TimeNow, IMUCache);
   }
 
   /** Odometry */
@@ -82,6 +83,47 @@ void Measure(libRSF::FactorGraph &Graph,
   }
 }
 
+void MeasureLate(libRSF::FactorGraph &Graph,
+                 const libRSF::FactorGraphConfig &Config,
+                 libRSF::SensorDataSource &Source,
+                 const double TimeNow)
+{
+  /** everything that arrived behind the already processed time, in one batch */
+  libRSF::SensorDataSet Late;
+  if (!Source.getLateMeasurements(Late))
+  {
+    return;
+  }
+
+  /** older states are already marginalized and can not be reopened */
+  double TimeHorizon;
+  if (!Graph.getStateData().getTimeFirst(POSITION_STATE, TimeHorizon))
+  {
+    return;
+  }
+
+  for (const libRSF::DataType Type : Late.getKeysAll())
+  {
+    const int Expired = Late.removeElementsBefore(Type, TimeHorizon);
+    if (Expired > 0)
+    {
+      PRINT_WARNING(Expired, " late measurements are older than the first state at ", TimeHorizon, " and are dropped!");
+    }
+
+    /** relative measurements are already part of the predicted states */
+    if (Type != libRSF::DataType::Pseudorange3 && Late.countElements(Type) > 0)
+    {
+      PRINT_WARNING(Late.countElements(Type), " late measurements can not be inserted into the past predictions and are dropped!");
+    }
+  }
+
+  /** pseudo ranges are connected to the closest existing states */
+  if (Config.GNSS.IsActive)
+  {
+    AddGNSS(Graph, Config, Late, std::nextafter(TimeHorizon, -std::numeric_limits<double>::infinity()), TimeNow);
+  }
+}
+
 void InitGraph(libRSF::FactorGraph &Graph,
                libRSF::SensorDataSet &Measurements,
                const libRSF::FactorGraphConfig &Config,
@@ -129,13 +171,85 @@ void InitGraph(libRSF::FactorGraph &Graph,
 int CreateGraphAndSolve(const libRSF::FactorGraphConfig &Config,
                         libRSF::StateDataSet &Result)
 {
-
-  /** read input data */
+  /** read input data, either completely or step by step */
   libRSF::SensorDataSet Measurements;
-  libRSF::ReadDataFromFile(Config.InputFile, Measurements);
+  std::unique_ptr<libRSF::SensorDataSource> Source;
+  if (Config.Solution.IsStreaming)
+  {
+    /** live measurements from another process, possibly out of order */
+    const std::string SharedMemoryPrefix = "shm:";
+    if (Config.InputFile.compare(0, SharedMemoryPrefix.size(), SharedMemoryPrefix) == 0)
+    {
+      Source = std::make_unique<libRSF::SensorDataSharedMemorySource>(Config.InputFile.substr(SharedMemoryPrefix.size()),
+                                                                     10.0, Config.Solution.Latency);
+    }
+    /** binary files are mapped instead of parsed, so they can be larger than the memory */
+    else if (libRSF::IsBinaryDataFile(Config.InputFile))
+    {
+      Source = std::make_unique<libRSF::SensorDataBinarySource>(Config.InputFile);
+    }
+    else
+    {
+      Source = std::make_unique<libRSF::SensorDataFileSource>(Config.InputFile);
+    }
+  }
+  else
+  {
+    libRSF::ReadDataFromFile(Config.InputFile, Measurements);
+  }
 
-  /** Build optimization problem from sensor data */
-  libRSF::FactorGraph Graph;
+  return SolveGNSS(Config, Measurements, Source.get(), Result);
+}
+
+int CreateGraphAndSolve(const libRSF::FactorGraphConfig &Config,
+                        const libRSF::SensorDataSet &Input,
+                        libRSF::StateDataSet &Result)
+{
+  /** the copy shares all streams until they are modified, e.g. by the conversion into a local frame */
+  libRSF::SensorDataSet Measurements = Input;
+  return SolveGNSS(Config, Measurements, nullptr, Result);
+}
+
+int SolveGNSS(const libRSF::FactorGraphConfig &Config,
+              libRSF::SensorDataSet &Measurements,
+              libRSF::SensorDataSource * const Source,
+              libRSF::StateDataSet &Result)
+{
+  /** Build optimization problem from sensor data, sweeps and batch workers reuse the memory of the previous run */
+  static thread_local libRSF::FactorGraph Graph;
+  Graph.reset();
+  if (!Config.Solution.TraceFile.empty())
+  {
+    Graph.startTrace(Config.Solution.TraceFile);
+  }
+  Graph.setIterationTelemetry(Config.Solution.IterationTelemetry);
+  Graph.setBackendSelection(Config.Solution.AutoBackend);
+  Graph.setTimeChainOrdering(Config.Solution.OrderTimeChain);
+  MetricsExport Monitoring(Config, Graph);
+  Graph.setWarmStart(Config.Solution.WarmStart);
+
+  /** finalized estimates are either copied directly or kept column-wise until the end */
+  libRSF::MemoryResultSink ResultMemory(Result);
+  std::unique_ptr<libRSF::CompactResultSink> ResultCompact;
+  libRSF::CompactPrecision Precision;
+  if (!Config.Solution.CompactResults.empty())
+  {
+    if (libRSF::CompactResultSink::ParsePrecision(Config.Solution.CompactResults, Precision))
+    {
+      ResultCompact = std::make_unique<libRSF::CompactResultSink>(Precision);
+    }
+    else
+    {
+      PRINT_WARNING("Unknown precision of compact results: ", Config.Solution.CompactResults);
+    }
+  }
+  libRSF::ResultSink &Sink = ResultCompact ? static_cast<libRSF::ResultSink &>(*ResultCompact) : ResultMemory;
+  AdaptiveErrorModel Adaptive;
+
+  /** sliding window of the window solution type */
+  libRSF::FixedLagSmoother Window(Graph, Config);
+  Window.setInflation(1.01);
+  libRSF::WindowController WindowControl(Config);
 
   /** converter from an earth-centered frame to a local (ENU) frame */
   libRSF::TangentPlaneConverter LocalFrame;
@@ -145,66 +259,253 @@ int CreateGraphAndSolve(const libRSF::FactorGraphConfig &Config,
 
   /** get relevant timestamps */
   double TimeFirst, TimeOld, TimeNow, TimeLast;
-  GetFirstTimestamp(Measurements, Config, TimeFirst);
-
-  if (!GetFirstTimestamp(Measurements, Config, TimeFirst))
+  if (!(Source ? GetFirstTimestamp(*Source, Config, TimeFirst) : GetFirstTimestamp(Measurements, Config, TimeFirst)))
   {
     PRINT_ERROR("Could not find first Timestamp! Exit now!");
+    Graph.stopTrace();
     return 1;
   }
-  if (!GetLastTimestamp(Measurements, Config, TimeLast))
+  if (!(Source ? GetLastTimestamp(*Source, Config, TimeLast) : GetLastTimestamp(Measurements, Config, TimeLast)))
   {
     PRINT_ERROR("Could not find last Timestamp! Exit now!");
+    Graph.stopTrace();
     return 1;
   }
 
+  /** the initialization uses up to 2 seconds of data */
+  if (Source)
+  {
+    Source->getMeasurementsUntil(TimeFirst + 2.0, Measurements);
+  }
+
   /** init factor graph */
   InitGraph(Graph, Measurements, Config, LocalFrame, TimeFirst);
 
+  /** estimates of a previous run, positions are stored in the global frame */
+  libRSF::StateDataSet InitialValues;
+  const bool HasInitialValues = LoadInitialValues(Config, InitialValues);
+  if (HasInitialValues && LocalFrame.isInitialized())
+  {
+    LocalFrame.convertAllStatesToLocal(InitialValues, POSITION_STATE);
+  }
+
+  /** the size of offline problems is known in advance */
+  if (!Source && Config.Solution.Type == libRSF::SolutionType::Batch)
+  {
+    ReserveGraph(Graph, Measurements, CountEpochs(Config, Measurements, TimeFirst, TimeLast));
+  }
+
+  /** offline batch problems know all epochs, so each one gets an independent single-point solution in parallel */
+  GNSSEpochCache GNSSSeeds;
+  if (!Source && Config.Solution.Type == libRSF::SolutionType::Batch && Config.GNSS.IsActive)
+  {
+    SolveEpochsWithGNSS(Config, Measurements, TimeFirst, TimeLast, 500, 5.0, GNSSSeeds);
+  }
+
   /** update loop */
   TimeOld = TimeFirst - 1;
   TimeNow = TimeFirst;
   libRSF::Timer IterationTimer;
-  do
-  {
-    /** update current timestamp and reset durations */
-    Summary = libRSF::Data(libRSF::DataType::IterationSummary, TimeNow);
 
-    /** start timer*/
-    IterationTimer.reset();
-
-    /** predict next state */
-    if (TimeNow > TimeFirst)
+  /** offline batch problems know all epochs, so the IMU can be pre-integrated in parallel */
+  IMUIntervalCache IMUCache;
+  if (!Source && Config.Solution.Type == libRSF::SolutionType::Batch &&
+      Config.IMU.IsActive && Config.IMU.Type == libRSF::FactorType::IMUPretintegration &&
+      Graph.getStateData().checkElement(IMU_STATE, TimeFirst))
+  {
+    std::vector<double> Times = {TimeFirst};
+    double EpochOld = TimeOld, EpochNow = TimeNow;
+    EpochCursor Epochs(Config, Measurements);
+    while (IncrementTime(Config, Epochs, EpochOld, EpochNow, TimeLast))
     {
-      Predict(Graph, Config, Measurements, TimeOld, TimeNow);
+      Times.push_back(EpochNow);
     }
 
-    /** add measurements */
-    Measure(Graph, Config, Measurements, TimeOld, TimeNow);
-
-    /** refine error model initially */
-    if (TimeNow == TimeFirst)
+    const libRSF::Vector6 Bias = Graph.getStateData().getElement(IMU_STATE, TimeFirst).getMean().tail(6);
+    if (Times.size() > 1 && !PreintegrateIMU(Config, Measurements, Times, Bias, IMUCache))
     {
-      Graph.solve(Config.SolverConfig);
+      PRINT_WARNING("IMU pre-integration in advance failed, each epoch is integrated separately.");
+      IMUCache.clear();
     }
-    /** solve graph, force solve every 60 seconds */
-    Solve(Graph, Config, Summary, fmod(TimeNow, 60.0) < (TimeNow - TimeOld) * 1.1);
+  }
 
-    /** save iteration timestamp */
-    Summary.setValueScalar(libRSF::DataElement::DurationTotal, IterationTimer.getSeconds());
+  /** lock and prefault the memory before the first epoch, the calling thread solves unless a pipeline takes over */
+  libRSF::EnterRealTime();
+  libRSF::ApplyRealTimeThread((Source && Config.Solution.IsPipelined) ? libRSF::RealTimeThread::Ingestion : libRSF::RealTimeThread::Solver);
 
-    /** save result */
-    Save(Graph, Config, Summary, Result, false);
+  if (Source && Config.Solution.IsPipelined)
+  {
+    /** the solver thread processes an epoch while the next measurements are read */
+    libRSF::AsyncSolver Pipeline(Graph,
+                                 [&](libRSF::FactorGraph &EpochGraph, const libRSF::SensorDataSet &EpochMeasurements, double EpochOld, const double EpochNow)
+    {
+      if (EpochNow == TimeFirst)
+      {
+        EpochOld = TimeFirst - 1;
+        libRSF::ApplyRealTimeThread(libRSF::RealTimeThread::Solver);
+      }
+
+      Summary.reset(libRSF::DataType::IterationSummary, EpochNow);
+      IterationTimer.reset();
+      const libRSF::Deadline EpochDeadline = (Config.Solution.Deadline > 0.0) ? libRSF::Deadline(Config.Solution.Deadline) : libRSF::Deadline();
+
+      if (EpochNow > TimeFirst)
+      {
+        Predict(EpochGraph, Config, EpochMeasurements, EpochOld, EpochNow);
+      }
+      Measure(EpochGraph, Config, EpochMeasurements, EpochOld, EpochNow);
+      if (HasInitialValues)
+      {
+        ApplyInitialValues(EpochGraph, InitialValues, EpochOld, EpochNow);
+      }
+
+      if (EpochNow == TimeFirst)
+      {
+        EpochGraph.solve(Config.SolverConfig);
+      }
+      Solve(EpochGraph, Config, Adaptive, Window, Summary, fmod(EpochNow, 60.0) < (EpochNow - EpochOld) * 1.1, EpochDeadline);
+
+      Summary.setValueScalar(libRSF::DataElement::DurationTotal, IterationTimer.getSeconds());
+      Save(EpochGraph, Config, Summary, Sink, false);
+      Monitoring.recordEpoch(Summary);
+
+      libRSF::PrintProgress((EpochNow - TimeFirst) / (TimeLast - TimeFirst) * 100);
+    });
+
+    /** the sensor thread only reads and queues data */
+    libRSF::SensorDataSet Batch;
+    Pipeline.addMeasurements(Measurements);
+    do
+    {
+      Batch.clear();
+      Source->getMeasurementsUntil(TimeNow, Batch);
+      Pipeline.addMeasurements(Batch);
+      Pipeline.closeEpoch(TimeNow);
+    } while (IncrementTime(Config, *Source, TimeOld, TimeNow, TimeLast));
+
+    /** the graph is owned by the solver thread until here */
+    Pipeline.finish();
+  }
+  else
+  {
+    /** offline data is not modified inside the loop, so the cursor stays valid */
+    EpochCursor Epochs(Config, Measurements);
 
-    /** print progress every 10%*/
-    libRSF::PrintProgress((TimeNow - TimeFirst) / (TimeLast - TimeFirst) * 100);
-  } while (IncrementTime(Config, Measurements, TimeOld, TimeNow, TimeLast));
+    /** heap allocations per phase, saving can only be reported with the next epoch */
+    libRSF::Vector4 Allocations = libRSF::Vector4::Zero();
+
+    /** the real-time profile expects a full window to run without page faults or additional allocations */
+    const bool CheckSteadyState = libRSF::IsRealTimeActive() && Config.Solution.Type == libRSF::SolutionType::Window;
+    libRSF::SteadyStateMonitor SteadyState(libRSF::GetRealTimeConfig().WarmUpEpochs);
+    do
+    {
+      if (CheckSteadyState)
+      {
+        SteadyState.beginEpoch();
+      }
+
+      /** update current timestamp and reset durations */
+      Summary.reset(libRSF::DataType::IterationSummary, TimeNow);
+
+      /** start timer*/
+      IterationTimer.reset();
+
+      /** optional time budget of this epoch */
+      const libRSF::Deadline EpochDeadline = (Config.Solution.Deadline > 0.0) ? libRSF::Deadline(Config.Solution.Deadline) : libRSF::Deadline();
+
+      /** get new measurements */
+      if (Source)
+      {
+        UpdateMeasurements(*Source, Measurements, TimeOld, TimeNow);
+      }
+
+      /** predict next state */
+      if (TimeNow > TimeFirst)
+      {
+        LIBRSF_TRACE_SCOPE("predict");
+        const libRSF::AllocationScope PredictAllocations;
+        Predict(Graph, Config, Measurements, TimeOld, TimeNow, IMUCache.empty() ? nullptr : &IMUCache);
+        Allocations(0) = static_cast<double>(PredictAllocations.getCount());
+      }
+
+      /** add measurements */
+      {
+        LIBRSF_TRACE_SCOPE("measure");
+        const libRSF::AllocationScope MeasureAllocations;
+        Measure(Graph, Config, Measurements, TimeOld, TimeNow);
+        if (Source)
+        {
+          MeasureLate(Graph, Config, *Source, TimeNow);
+        }
+        Allocations(1) = static_cast<double>(MeasureAllocations.getCount());
+      }
+
+      /** replace the predicted states, the first epoch is already initialized */
+      if (TimeNow > TimeFirst && !GNSSSeeds.empty())
+      {
+        SeedWithGNSS(Graph, GNSSSeeds, TimeOld, TimeNow);
+      }
+
+      /** the previous run is the best guess, everything else keeps the prediction */
+      if (HasInitialValues)
+      {
+        ApplyInitialValues(Graph, InitialValues, TimeOld, TimeNow);
+      }
+
+      {
+        LIBRSF_TRACE_SCOPE("solve");
+        const libRSF::AllocationScope SolveAllocations;
+
+        /** refine error model initially */
+        if (TimeNow == TimeFirst)
+        {
+          Graph.solve(Config.SolverConfig);
+        }
+        /** solve graph, force solve every 60 seconds */
+        Solve(Graph, Config, Adaptive, Window, Summary, fmod(TimeNow, 60.0) < (TimeNow - TimeOld) * 1.1, EpochDeadline);
+        Allocations(2) = static_cast<double>(SolveAllocations.getCount());
+      }
+
+      /** save iteration timestamp */
+      Summary.setValueScalar(libRSF::DataElement::DurationTotal, IterationTimer.getSeconds());
+      Summary.setValue(libRSF::DataElement::Allocations, Allocations);
+
+      /** save result */
+      {
+        LIBRSF_TRACE_SCOPE("save");
+        const libRSF::AllocationScope SaveAllocations;
+        Save(Graph, Config, Summary, Sink, false);
+        Allocations(3) = static_cast<double>(SaveAllocations.getCount());
+      }
+      Monitoring.recordEpoch(Summary);
+
+      /** follow the processing time with the window length */
+      AdaptWindowLength(WindowControl, Window, Summary);
+
+      if (CheckSteadyState)
+      {
+        SteadyState.endEpoch();
+      }
+
+      /** print progress every 10%*/
+      libRSF::PrintProgress((TimeNow - TimeFirst) / (TimeLast - TimeFirst) * 100);
+    } while (Source ? IncrementTime(Config, *Source, TimeOld, TimeNow, TimeLast) : IncrementTime(Config, Epochs, TimeOld, TimeNow, TimeLast));
+
+    if (CheckSteadyState && SteadyState.countViolations() > 0)
+    {
+      PRINT_WARNING(SteadyState.countViolations(), " epochs after the warm-up were not in a steady state.");
+    }
+  }
 
   /** calculate and save final solution*/
   Summary.setTimestamp(TimeNow);
-  Solve(Graph, Config, Summary, true);
+  Solve(Graph, Config, Adaptive, Window, Summary, true);
   Summary.setValueScalar(libRSF::DataElement::DurationTotal, IterationTimer.getSeconds());
-  Save(Graph, Config, Summary, Result, true);
+  Save(Graph, Config, Summary, Sink, true);
+  if (ResultCompact)
+  {
+    ResultCompact->exportTo(ResultMemory);
+  }
 
   /** convert back in a global frame */
   if (Config.GNSS.IsActive && LocalFrame.isInitialized())
@@ -221,11 +522,14 @@ int CreateGraphAndSolve(const libRSF::FactorGraphConfig &Config,
   /** print last report */
   Graph.printReport();
 
+  /** the graph outlives this run, so the trace is closed here */
+  Graph.stopTrace();
+
   /** successful end */
   return 0;
 }
 
-#ifndef TESTMODE // only compile main if not used in test context
+#if !defined(TESTMODE) && !defined(BATCHMODE) // only compile main if not used in test or batch context
 
 int main(int ArgC, char ** ArgV)
 {
@@ -243,19 +547,22 @@ int main(int ArgC, char ** ArgV)
   {
     PRINT_ERROR("Something gone wrong while estimating GNSS position!");
   }
+  else if (Config.OutputFile.size() > 4 && Config.OutputFile.compare(Config.OutputFile.size() - 4, 4, ".bin") == 0)
+  {
+    /** binary output keeps the full precision of global coordinates */
+    libRSF::WriteResultToBinaryFile(Config.OutputFile, Result, {POSITION_STATE, ORIENTATION_STATE, ANGLE_STATE, SOLVE_TIME_STATE});
+  }
   else
   {
-    /** export position estimate to file */
-    libRSF::WriteDataToFile(Config.OutputFile, POSITION_STATE, Result, false);
-
-    /** export additional estimates */
-    libRSF::WriteDataToFile(Config.OutputFile, ORIENTATION_STATE, Result, true);
-    libRSF::WriteDataToFile(Config.OutputFile, ANGLE_STATE, Result, true);
-
-    /** export timing information */
-    libRSF::WriteDataToFile(Config.OutputFile, SOLVE_TIME_STATE, Result, true);
+    /** export position estimate, additional estimates and timing information to file */
+    libRSF::WriteDataToFile(Config.OutputFile, {POSITION_STATE, ORIENTATION_STATE, ANGLE_STATE, SOLVE_TIME_STATE}, Result);
   }
 
+#ifdef LIBRSF_TRACING
+  /** export the spans of all processing steps */
+  libRSF::WriteTraceToFile(Config.OutputFile + std::string("_trace.json"));
+#endif
+
   return 0;
 }
 
@@ -43,4 +43,15 @@
 int CreateGraphAndSolve(const libRSF::FactorGraphConfig &Config,
                         libRSF::StateDataSet &Result);
 
+/** solve with measurements that are already in memory, streaming is not possible in this case */
+int CreateGraphAndSolve(const libRSF::FactorGraphConfig &Config,
+                        const libRSF::SensorDataSet &Input,
+                        libRSF::StateDataSet &Result);
+
+/** the source is optional, without it all measurements have to be available */
+int SolveGNSS(const libRSF::FactorGraphConfig &Config,
+              libRSF::SensorDataSet &Measurements,
+              libRSF::SensorDataSource *Source,
+              libRSF::StateDataSet &Result);
+
 #endif // APP_GNSS_H
@@ -0,0 +1,496 @@
+/***************************************************************************
+ * libRSF - A Robust Sensor Fusion Library
+ *
+ * Copyright (C) 2018 Chair of Automation Technology / TU Chemnitz
+ * For more information see https://www.tu-chemnitz.de/etit/proaut/libRSF
+ *
+ * libRSF is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libRSF is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with libRSF.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Tim Pfeifer (tim.pfeifer@etit.tu-chemnitz.de)
+ ***************************************************************************/
+
+/**
+ * @file App_Generate.cpp
+ * @author Tim Pfeifer
+ * @date 14.10.2026
+ * @brief Generator of synthetic 2D ranging and SLAM datasets of arbitrary size for scaling benchmarks.
+ * @copyright GNU Public License.
+ *
+ */
+
+#include "App_Generate.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+/** writes one dataset in the text and/or the binary format, the binary blocks are collected in one temporary file per type */
+class DatasetWriter
+{
+  public:
+    DatasetWriter(const std::string &Filename, const bool Text, const bool Binary) : Filename_(Filename), Binary_(Binary)
+    {
+      if (Text)
+      {
+        Text_.open(Filename_ + ".txt", std::ios::out | std::ios::trunc);
+        if (!Text_)
+        {
+          PRINT_ERROR("Could not open file: ", Filename_, ".txt");
+        }
+      }
+    }
+
+    ~DatasetWriter()
+    {
+      for (auto &Block : Blocks_)
+      {
+        Block.second->File.close();
+        std::remove(Block.second->TempName.c_str());
+      }
+    }
+
+    void add(const libRSF::Data &Object)
+    {
+      if (Text_.is_open())
+      {
+        Text_ << Object.getName() << ' ' << Object.getValueString() << '\n';
+      }
+
+      if (Binary_)
+      {
+        std::unique_ptr<BlockType> &Block = Blocks_[Object.getType()];
+        if (!Block)
+        {
+          Block = std::make_unique<BlockType>();
+          Block->TempName = Filename_ + ".bin." + Object.getName() + ".tmp";
+          Block->File.open(Block->TempName, std::ios::out | std::ios::trunc | std::ios::binary);
+          Block->Values = static_cast<uint32_t>(Object.getBuffer().size());
+        }
+        Block->File.write(reinterpret_cast<const char *>(Object.getBuffer().data()),
+                          static_cast<std::streamsize>(Object.getBuffer().size() * sizeof(double)));
+        Block->Objects++;
+      }
+    }
+
+    /** same layout as WriteDataToBinaryFile() */
+    bool close()
+    {
+      bool Success = true;
+      if (Text_.is_open())
+      {
+        Text_.close();
+        Success &= !Text_.fail();
+      }
+
+      if (!Binary_)
+      {
+        return Success;
+      }
+
+      std::ofstream File(Filename_ + ".bin", std::ios::out | std::ios::trunc | std::ios::binary);
+      if (!File)
+      {
+        PRINT_ERROR("Could not open file: ", Filename_, ".bin");
+        return false;
+      }
+
+      const auto BlockNumber = static_cast<uint32_t>(Blocks_.size());
+      File.write(libRSF::BinaryDataMagic, sizeof(libRSF::BinaryDataMagic));
+      File.write(reinterpret_cast<const char *>(&libRSF::BinaryDataVersion), sizeof(libRSF::BinaryDataVersion));
+      File.write(reinterpret_cast<const char *>(&BlockNumber), sizeof(BlockNumber));
+
+      for (auto &Block : Blocks_)
+      {
+        const std::string Name = libRSF::GlobalDataConfig.getName(Block.first);
+        const auto NameLength = static_cast<uint32_t>(Name.size());
+        File.write(reinterpret_cast<const char *>(&NameLength), sizeof(NameLength));
+        File.write(Name.data(), NameLength);
+        File.write(reinterpret_cast<const char *>(&Block.second->Values), sizeof(Block.second->Values));
+        File.write(reinterpret_cast<const char *>(&Block.second->Objects), sizeof(Block.second->Objects));
+
+        Block.second->File.close();
+        std::ifstream Values(Block.second->TempName, std::ios::binary);
+        if (Block.second->Objects > 0)
+        {
+          File << Values.rdbuf();
+        }
+      }
+
+      File.close();
+      return Success && !File.fail();
+    }
+
+  private:
+    struct BlockType
+    {
+      std::string TempName;
+      std::ofstream File;
+      uint32_t Values = 0;
+      uint64_t Objects = 0;
+    };
+
+    std::string Filename_;
+    std::ofstream Text_;
+    bool Binary_;
+    std::map<libRSF::DataType, std::unique_ptr<BlockType>> Blocks_;
+};
+
+/** points in square cells, for neighborhood queries without a tree */
+class PointGrid
+{
+  public:
+    explicit PointGrid(const double CellSize) : CellSize_(std::max(CellSize, 1e-3)) {}
+
+    void add(const libRSF::Vector2 &Point, const size_t Index)
+    {
+      Cells_[this->getKey_(this->getCell_(Point(0)), this->getCell_(Point(1)))].push_back(Index);
+    }
+
+    /** indices of all points in the cell of Point and its eight neighbors */
+    template <typename Function>
+    void forEachNear(const libRSF::Vector2 &Point, Function &&Visit) const
+    {
+      const int64_t X = this->getCell_(Point(0));
+      const int64_t Y = this->getCell_(Point(1));
+      for (int64_t dX = -1; dX <= 1; dX++)
+      {
+        for (int64_t dY = -1; dY <= 1; dY++)
+        {
+          const auto Cell = Cells_.find(this->getKey_(X + dX, Y + dY));
+          if (Cell != Cells_.end())
+          {
+            for (const size_t Index : Cell->second)
+            {
+              Visit(Index);
+            }
+          }
+        }
+      }
+    }
+
+  private:
+    [[nodiscard]] int64_t getCell_(const double Coordinate) const
+    {
+      return static_cast<int64_t>(std::floor(Coordinate / CellSize_));
+    }
+
+    [[nodiscard]] static int64_t getKey_(const int64_t X, const int64_t Y)
+    {
+      return (X << 32) ^ (Y & 0xFFFFFFFF);
+    }
+
+    double CellSize_;
+    std::unordered_map<int64_t, std::vector<size_t>> Cells_;
+};
+
+static double SampleRangeError(const WorkloadConfig &Config, std::mt19937_64 &Random)
+{
+  std::normal_distribution<double> Normal(0.0, 1.0);
+  std::uniform_real_distribution<double> Uniform(0.0, 1.0);
+
+  const double Error = Config.RangeStdDev * Normal(Random);
+  if (Config.Outliers == OutlierType::None || Uniform(Random) >= Config.OutlierRatio)
+  {
+    return Error;
+  }
+
+  const double Scale = Config.OutlierScale * Config.RangeStdDev;
+  switch (Config.Outliers)
+  {
+    case OutlierType::HeavyTailed:
+      return Scale * Normal(Random);
+
+    case OutlierType::Multimodal:
+    {
+      static const double Modes[3] = {0.5, 1.0, 2.0};
+      return Error + Scale * Modes[static_cast<size_t>(Uniform(Random) * 3.0) % 3];
+    }
+
+    case OutlierType::Skewed:
+      return Error + std::exponential_distribution<double>(1.0 / Scale)(Random);
+
+    default:
+      return Error;
+  }
+}
+
+bool GenerateWorkload(const WorkloadConfig &Config, const std::string &Prefix)
+{
+  if (Config.Epochs == 0 || Config.DeltaTime <= 0.0)
+  {
+    PRINT_ERROR("A workload needs at least one epoch and a positive time step!");
+    return false;
+  }
+
+  std::mt19937_64 Random(Config.Seed);
+  std::normal_distribution<double> Normal(0.0, 1.0);
+  std::uniform_real_distribution<double> Uniform(0.0, 1.0);
+
+  /** a larger area for longer trajectories, so that places are revisited a few times */
+  const double StepLength = Config.Speed * Config.DeltaTime;
+  const double Area = (Config.AreaSize > 0.0) ? Config.AreaSize :
+                      std::max(20.0, std::sqrt(static_cast<double>(Config.Epochs) * StepLength * std::max(Config.LoopRadius, 1.0)));
+  const libRSF::Vector2 Center(Area / 2.0, Area / 2.0);
+
+  /** static points */
+  std::vector<libRSF::Vector2> Anchors(std::max(0, Config.Anchors));
+  for (libRSF::Vector2 &Anchor : Anchors)
+  {
+    Anchor << Uniform(Random) * Area, Uniform(Random) * Area;
+  }
+
+  std::vector<libRSF::Vector2> Landmarks(std::max(0, Config.Landmarks));
+  PointGrid LandmarkGrid(Config.LandmarkRange);
+  for (size_t n = 0; n < Landmarks.size(); n++)
+  {
+    Landmarks.at(n) << Uniform(Random) * Area, Uniform(Random) * Area;
+    LandmarkGrid.add(Landmarks.at(n), n);
+  }
+
+  /** loop closures need all previous positions */
+  const bool HasLoops = (Config.LoopClosures > 0);
+  const size_t LoopGap = static_cast<size_t>(std::ceil(2.0 * Config.LoopRadius / std::max(StepLength, 1e-6))) + 10;
+  std::vector<libRSF::Vector2> Positions;
+  PointGrid LoopGrid(Config.LoopRadius);
+  if (HasLoops)
+  {
+    Positions.reserve(Config.Epochs);
+  }
+
+  DatasetWriter Input(Prefix + "_Input", Config.WriteText, Config.WriteBinary);
+  DatasetWriter GroundTruth(Prefix + "_GT", Config.WriteText, Config.WriteBinary);
+
+  libRSF::Vector2 Position = Center;
+  double Yaw = 0.0;
+  double TurnRate = 0.0;
+  size_t Ranges = 0;
+  size_t Loops = 0;
+
+  libRSF::Timer Clock;
+  for (size_t Epoch = 0; Epoch < Config.Epochs; Epoch++)
+  {
+    const double Time = static_cast<double>(Epoch) * Config.DeltaTime;
+
+    if (Epoch > 0)
+    {
+      /** smooth random turns, close to the border the vehicle is steered back to the center */
+      TurnRate = 0.9 * TurnRate + Config.TurnRateStdDev * Normal(Random);
+      if ((Position - Center).cwiseAbs().maxCoeff() > 0.4 * Area)
+      {
+        const double Heading = std::atan2(Center(1) - Position(1), Center(0) - Position(0));
+        TurnRate = 0.5 * libRSF::NormalizeAngle(Heading - Yaw) / Config.DeltaTime;
+      }
+
+      /** same motion model as the odom2 factor */
+      Position += libRSF::Vector2(std::cos(Yaw), std::sin(Yaw)) * StepLength;
+      Yaw = libRSF::NormalizeAngle(Yaw + TurnRate * Config.DeltaTime);
+
+      libRSF::Data Odom(libRSF::DataType::Odom2, Time);
+      Odom.setMean(libRSF::Vector3(Config.Speed + Config.OdomStdDev * Normal(Random),
+                                   Config.OdomStdDev * Normal(Random),
+                                   TurnRate + Config.OdomStdDev * Normal(Random)));
+      Odom.setCovarianceDiagonal(libRSF::Vector3::Constant(Config.OdomStdDev * Config.OdomStdDev));
+      Input.add(Odom);
+    }
+
+    libRSF::Data Point(libRSF::DataType::Point2, Time);
+    Point.setMean(Position);
+    GroundTruth.add(Point);
+
+    /** ranges to anchors */
+    for (size_t n = 0; n < Anchors.size(); n++)
+    {
+      libRSF::Data Range(libRSF::DataType::Range2, Time);
+      Range.setMean(libRSF::Vector1((Position - Anchors.at(n)).norm() + SampleRangeError(Config, Random)));
+      Range.setCovariance(libRSF::Vector1(Config.RangeStdDev * Config.RangeStdDev));
+      Range.setValue(libRSF::DataElement::SatPos, Anchors.at(n));
+      Range.setValueScalar(libRSF::DataElement::SatID, static_cast<double>(n + 1));
+      Input.add(Range);
+      Ranges++;
+    }
+
+    /** ranges to the landmarks in sensor range */
+    LandmarkGrid.forEachNear(Position, [&](const size_t n)
+    {
+      const double Distance = (Position - Landmarks.at(n)).norm();
+      if (Distance <= Config.LandmarkRange)
+      {
+        libRSF::Data Range(libRSF::DataType::RangeLM2, Time);
+        Range.setMean(libRSF::Vector1(Distance + SampleRangeError(Config, Random)));
+        Range.setCovariance(libRSF::Vector1(Config.RangeStdDev * Config.RangeStdDev));
+        Range.setValueScalar(libRSF::DataElement::SatID, static_cast<double>(n + 1));
+        Input.add(Range);
+        Ranges++;
+      }
+    });
+
+    if (HasLoops)
+    {
+      /** the rate is adapted to reach the requested number, even if there are epochs without a revisited place */
+      const double Rate = static_cast<double>(Config.LoopClosures - std::min(Loops, Config.LoopClosures)) / static_cast<double>(Config.Epochs - Epoch);
+      if (Epoch >= LoopGap && Uniform(Random) < Rate)
+      {
+        size_t Reference = Epoch;
+        double Similarity = 1.0;
+        if (Config.Outliers != OutlierType::None && Uniform(Random) < Config.OutlierRatio)
+        {
+          /** wrong correspondence to an arbitrary place */
+          Reference = static_cast<size_t>(Uniform(Random) * static_cast<double>(Epoch - LoopGap));
+          Similarity = 0.5 + 0.5 * Uniform(Random);
+        }
+        else
+        {
+          double Best = Config.LoopRadius;
+          LoopGrid.forEachNear(Position, [&](const size_t n)
+          {
+            const double Distance = (Position - Positions.at(n)).norm();
+            if (n + LoopGap <= Epoch && Distance <= Best)
+            {
+              Best = Distance;
+              Reference = n;
+            }
+          });
+        }
+
+        if (Reference < Epoch)
+        {
+          libRSF::Data Loop(libRSF::DataType::LoopClosure, Time);
+          Loop.setValueScalar(libRSF::DataElement::TimestampRef, static_cast<double>(Reference) * Config.DeltaTime);
+          Loop.setValueScalar(libRSF::DataElement::Similarity, Similarity);
+          Input.add(Loop);
+          Loops++;
+        }
+      }
+
+      Positions.push_back(Position);
+      LoopGrid.add(Position, Epoch);
+    }
+  }
+
+  if (!Input.close() || !GroundTruth.close())
+  {
+    PRINT_ERROR("Could not write the workload: ", Prefix);
+    return false;
+  }
+
+  PRINT_LOGGING("Generated ", Config.Epochs, " epochs with ", Ranges, " ranges and ", Loops,
+                " loop closures in a ", Area, "m area within ", Clock.getSeconds(), "s");
+  return true;
+}
+
+#ifndef TESTMODE // only compile main if not used in test context
+
+static bool TranslateOutlierType(const std::string &Name, OutlierType &Type)
+{
+  static const std::map<std::string, OutlierType> Dict =
+  {
+    {"none", OutlierType::None},
+    {"heavy-tailed", OutlierType::HeavyTailed},
+    {"multimodal", OutlierType::Multimodal},
+    {"skewed", OutlierType::Skewed}
+  };
+
+  const auto It = Dict.find(Name);
+  if (It == Dict.end())
+  {
+    return false;
+  }
+  Type = It->second;
+  return true;
+}
+
+int main(int ArgC, char ** ArgV)
+{
+  google::InitGoogleLogging(ArgV[0]);
+
+  if (ArgC < 2)
+  {
+    PRINT_ERROR("Usage: libRSF_generate Prefix [--epochs N] [--dt S] [--anchors N] [--landmarks N] [--loops N] "
+                "[--outliers none|heavy-tailed|multimodal|skewed] [--outlier-ratio R] [--seed N] [--binary] [--no-text]");
+    return 1;
+  }
+
+  WorkloadConfig Config;
+  for (int n = 2; n < ArgC; n++)
+  {
+    const std::string Option = ArgV[n];
+    const bool HasValue = (n + 1 < ArgC);
+
+    if (Option == "--binary")
+    {
+      Config.WriteBinary = true;
+    }
+    else if (Option == "--no-text")
+    {
+      Config.WriteText = false;
+    }
+    else if (HasValue && Option == "--epochs")
+    {
+      Config.Epochs = std::stoull(ArgV[++n]);
+    }
+    else if (HasValue && Option == "--dt")
+    {
+      Config.DeltaTime = std::stod(ArgV[++n]);
+    }
+    else if (HasValue && Option == "--anchors")
+    {
+      Config.Anchors = std::stoi(ArgV[++n]);
+    }
+    else if (HasValue && Option == "--landmarks")
+    {
+      Config.Landmarks = std::stoi(ArgV[++n]);
+    }
+    else if (HasValue && Option == "--loops")
+    {
+      Config.LoopClosures = std::stoull(ArgV[++n]);
+    }
+    else if (HasValue && Option == "--outliers")
+    {
+      if (!TranslateOutlierType(ArgV[++n], Config.Outliers))
+      {
+        PRINT_ERROR("Wrong outlier type: ", ArgV[n]);
+        return 1;
+      }
+    }
+    else if (HasValue && Option == "--outlier-ratio")
+    {
+      Config.OutlierRatio = std::stod(ArgV[++n]);
+    }
+    else if (HasValue && Option == "--seed")
+    {
+      Config.Seed = std::stoull(ArgV[++n]);
+    }
+    else
+    {
+      PRINT_ERROR("Unknown option: ", Option);
+      return 1;
+    }
+  }
+
+  if (!Config.WriteText && !Config.WriteBinary)
+  {
+    PRINT_ERROR("At least one output format is required!");
+    return 1;
+  }
+
+  return GenerateWorkload(Config, ArgV[1]) ? 0 : 1;
+}
+
+#endif // TESTMODE
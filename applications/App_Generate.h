@@ -0,0 +1,88 @@
+/***************************************************************************
+ * libRSF - A Robust Sensor Fusion Library
+ *
+ * Copyright (C) 2018 Chair of Automation Technology / TU Chemnitz
+ * For more information see https://www.tu-chemnitz.de/etit/proaut/libRSF
+ *
+ * libRSF is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libRSF is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with libRSF.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Tim Pfeifer (tim.pfeifer@etit.tu-chemnitz.de)
+ ***************************************************************************/
+
+/**
+ * @file App_Generate.h
+ * @author Tim Pfeifer
+ * @date 14.10.2026
+ * @brief Generator of synthetic 2D ranging and SLAM datasets of arbitrary size for scaling benchmarks.
+ * @copyright GNU Public License.
+ *
+ */
+
+#ifndef APP_GENERATE_H
+#define APP_GENERATE_H
+
+#include "libRSF.h"
+
+#include <cstdint>
+#include <string>
+
+/** distribution of the non-Gaussian part of the range errors, similar to the Ranging_Simulation datasets */
+enum class OutlierType
+{
+  None,         /**< pure Gaussian noise */
+  HeavyTailed,  /**< wide zero-mean Gaussian */
+  Multimodal,   /**< positive offsets around three modes, like multipath */
+  Skewed        /**< exponential positive offsets, like NLOS */
+};
+
+/** parameters of a synthetic workload, the defaults resemble M3500 */
+struct WorkloadConfig
+{
+  /** trajectory of a unicycle with a random walk of the turn rate, it is steered back into a square area */
+  size_t Epochs = 3500;
+  double DeltaTime = 1.0;
+  double Speed = 1.0;
+  double TurnRateStdDev = 0.2;
+  double AreaSize = 0.0;          /**< side length in meter, zero scales it with the number of epochs */
+
+  /** range2 measurements to anchors at known positions, every epoch */
+  int Anchors = 8;
+  double RangeStdDev = 0.5;
+
+  /** range_lm2 measurements to landmarks at unknown positions, that are closer than LandmarkRange */
+  int Landmarks = 0;
+  double LandmarkRange = 20.0;
+
+  /** loop closures between epochs closer than LoopRadius, the number is approximately reached */
+  size_t LoopClosures = 0;
+  double LoopRadius = 2.0;
+
+  double OdomStdDev = 0.05;     /**< per axis of the odom2 velocity and turn rate */
+
+  /** a part of the ranges and loop closures are outliers */
+  OutlierType Outliers = OutlierType::None;
+  double OutlierRatio = 0.1;
+  double OutlierScale = 10.0;   /**< relative to RangeStdDev */
+
+  uint64_t Seed = 42;
+
+  /** Prefix_Input and Prefix_GT are written as .txt and/or .bin */
+  bool WriteText = true;
+  bool WriteBinary = false;
+};
+
+/** the objects are streamed into the files, only the positions for loop closures are kept in memory */
+bool GenerateWorkload(const WorkloadConfig &Config, const std::string &Prefix);
+
+#endif // APP_GENERATE_H
@@ -22,8 +22,173 @@
 
 #include "App_Ranging_2D.h"
 
+/** all states, odometry and ranges of the range epochs between both times, the prior is only added to the first epoch of the dataset */
+bool BuildRangingSegment(libRSF::FactorGraph &Graph,
+                         const libRSF::FactorGraphConfig &Config,
+                         const libRSF::SensorDataSet &Measurements,
+                         const double TimeFirst,
+                         const double TimeBegin,
+                         const double TimeEnd)
+{
+  std::vector<double> Times;
+  Measurements.getTimesOfID(libRSF::DataType::Range2, Times);
+
+  double TimePrev = 0.0;
+  bool IsFirst = true;
+  for (const double TimeNow : Times)
+  {
+    if (TimeNow < TimeBegin || TimeNow > TimeEnd)
+    {
+      continue;
+    }
+
+    /** new states */
+    Graph.addState(POSITION_STATE, libRSF::DataType::Point2, TimeNow);
+    Graph.addState(ORIENTATION_STATE, libRSF::DataType::Angle, TimeNow);
+
+    if (TimeNow == TimeFirst)
+    {
+      libRSF::GaussianDiagonal<2> NoisePriorPoint;
+      NoisePriorPoint.setStdDevSharedDiagonal(10.0);
+      libRSF::GaussianDiagonal<1> NoisePriorAngle;
+      NoisePriorAngle.setStdDevSharedDiagonal(2 * M_PI);
+
+      libRSF::Data PriorPoint(libRSF::DataType::Point2, TimeFirst);
+      libRSF::Data PriorAngle(libRSF::DataType::Angle, TimeFirst);
+      PriorPoint.setMean(libRSF::Vector2::Zero());
+      PriorAngle.setMean(libRSF::Vector1::Zero());
+
+      Graph.addFactor<libRSF::FactorType::Prior2>(libRSF::StateID(POSITION_STATE, TimeFirst), PriorPoint, NoisePriorPoint);
+      Graph.addFactor<libRSF::FactorType::PriorAngle>(libRSF::StateID(ORIENTATION_STATE, TimeFirst), PriorAngle, NoisePriorAngle);
+    }
+
+    /** odometry inside the segment */
+    if (!IsFirst)
+    {
+      double TimeOdom = 0.0;
+      if (!Measurements.getTimeBelowOrEqual(libRSF::DataType::Odom2, TimeNow, TimeOdom))
+      {
+        PRINT_ERROR("Could not find measurement below: ", TimeNow);
+        return false;
+      }
+      const libRSF::Data Odom = Measurements.getElement(libRSF::DataType::Odom2, TimeOdom);
+
+      libRSF::GaussianDiagonal<3> GaussianOdom;
+      GaussianOdom.setCovarianceDiagonal(Odom.getCovarianceDiagonal());
+
+      Graph.addFactor<libRSF::FactorType::Odom2>(libRSF::StateID(POSITION_STATE, TimePrev),
+                                                 libRSF::StateID(ORIENTATION_STATE, TimePrev),
+                                                 libRSF::StateID(POSITION_STATE, TimeNow),
+                                                 libRSF::StateID(ORIENTATION_STATE, TimeNow),
+                                                 Odom, GaussianOdom);
+    }
+
+    for (const libRSF::Data &Range: Measurements.getElements(libRSF::DataType::Range2, TimeNow))
+    {
+      AddRange2(Graph, Config, Range, TimeNow);
+    }
+
+    TimePrev = TimeNow;
+    IsFirst = false;
+  }
+
+  return !IsFirst;
+}
+
+/** the Gaussian setup is fixed at compile time, so its epochs are built without decisions on the config */
+using GaussianRangingPipeline = libRSF::FusionPipeline<libRSF::PipelineStates<libRSF::DataType::Point2, libRSF::DataType::Angle>,
+                                                       libRSF::RelativeSensor<libRSF::FactorType::Odom2, libRSF::DataType::Odom2, libRSF::GaussianDiagonal<3>, 0, 1>,
+                                                       libRSF::AbsoluteSensor<libRSF::FactorType::Range2, libRSF::DataType::Range2, libRSF::GaussianDiagonal<1>, 0>>;
+
+/** states, odometry and ranges of one epoch that follows the one at TimePrev */
+bool AddRangingEpoch(libRSF::FactorGraph &Graph,
+                     const libRSF::FactorGraphConfig &Config,
+                     const libRSF::SensorDataSet &Measurements,
+                     const double TimePrev,
+                     const double TimeNow)
+{
+  if (Config.Ranging.ErrorModel.Type == libRSF::ErrorModelType::Gaussian)
+  {
+    static thread_local GaussianRangingPipeline Pipeline({POSITION_STATE, ORIENTATION_STATE});
+    return Pipeline.addEpoch(Graph, Measurements, TimePrev, TimeNow);
+  }
+
+  /** new states */
+  Graph.addState(POSITION_STATE, libRSF::DataType::Point2, TimeNow);
+  Graph.addState(ORIENTATION_STATE, libRSF::DataType::Angle, TimeNow);
+
+  /** get odometry measurement */
+  double TimeOdom = 0.0;
+  if (!Measurements.getTimeBelowOrEqual(libRSF::DataType::Odom2, TimeNow, TimeOdom))
+  {
+    PRINT_ERROR("Could not find measurement below: ", TimeNow);
+    return false;
+  }
+  const libRSF::Data Odom = Measurements.getElement(libRSF::DataType::Odom2, TimeOdom);
+
+  /** create noise model */
+  libRSF::GaussianDiagonal<3> GaussianOdom;
+  GaussianOdom.setCovarianceDiagonal(Odom.getCovarianceDiagonal());
+
+  /** add odometry factor */
+  Graph.addFactor<libRSF::FactorType::Odom2>(libRSF::StateID(POSITION_STATE, TimePrev),
+                                             libRSF::StateID(ORIENTATION_STATE, TimePrev),
+                                             libRSF::StateID(POSITION_STATE, TimeNow),
+                                             libRSF::StateID(ORIENTATION_STATE, TimeNow),
+                                             Odom, GaussianOdom);
+
+  /** add range measurements */
+  for (const libRSF::Data &Range: Measurements.getElements(libRSF::DataType::Range2, TimeNow))
+  {
+    AddRange2(Graph, Config, Range, TimeNow);
+  }
+  return true;
+}
+
+/** batch solution over overlapping segments that are solved concurrently */
+int SolveSegmented(const libRSF::FactorGraphConfig &Config,
+                   const libRSF::SensorDataSet &Measurements,
+                   const double TimeFirst,
+                   libRSF::ResultSink &Sink)
+{
+  /** the segments are solved once, there is no solve between them that could adapt the mixture */
+  if (Config.Ranging.ErrorModel.Type == libRSF::ErrorModelType::GMM &&
+      Config.Ranging.ErrorModel.GMM.TuningType != libRSF::ErrorModelTuningType::None)
+  {
+    PRINT_ERROR("Segmented batch solutions can not adapt the error model, set the tuning of the mixture to none!");
+    return 1;
+  }
+
+  double TimeLast;
+  Measurements.getTimeLast(libRSF::DataType::Range2, TimeLast);
+
+  libRSF::Timer TotalTimer;
+  libRSF::SegmentedBatch Segments(Config);
+  libRSF::StateDataSet Result;
+  const bool IsSolved = Segments.solve(TimeFirst, TimeLast,
+                                       [&](libRSF::FactorGraph &Graph, const double TimeBegin, const double TimeEnd)
+                                       {
+                                         return BuildRangingSegment(Graph, Config, Measurements, TimeFirst, TimeBegin, TimeEnd);
+                                       },
+                                       Config.SolverConfig, Result);
+  if (!IsSolved)
+  {
+    return 1;
+  }
+  Sink.addAll(Result);
+
+  /** save runtime information */
+  libRSF::Data Summary(libRSF::DataType::IterationSummary, TimeLast);
+  Summary.setValueScalar(libRSF::DataElement::DurationSolver, Segments.getSolverDuration());
+  Summary.setValueScalar(libRSF::DataElement::DurationTotal, TotalTimer.getSeconds());
+  Sink.addElement(SOLVE_TIME_STATE, Summary);
+
+  PRINT_LOGGING("Solved ", Segments.countSegments(), " segments in ", Segments.countRounds(), " rounds, remaining disagreement: ", Segments.getDisagreement());
+  return 0;
+}
+
 int CreateGraphAndSolve(const libRSF::FactorGraphConfig &Config,
-                        libRSF::StateDataSet &Result)
+                        libRSF::ResultSink &Sink)
 {
 
   /** read input data */
@@ -38,8 +203,29 @@ int CreateGraphAndSolve(const libRSF::FactorGraphConfig &Config,
     return 1;
   }
 
+  /** overlapping segments instead of one large batch problem */
+  if (Config.Solution.Type == libRSF::SolutionType::Batch && libRSF::SegmentedBatch(Config).isActive())
+  {
+    return SolveSegmented(Config, Measurements, TimeFirst, Sink);
+  }
+
   /** Build optimization problem from sensor data */
   libRSF::FactorGraph Graph;
+  if (!Config.Solution.TraceFile.empty())
+  {
+    Graph.startTrace(Config.Solution.TraceFile);
+  }
+  Graph.setIterationTelemetry(Config.Solution.IterationTelemetry);
+  Graph.setBackendSelection(Config.Solution.AutoBackend);
+  Graph.setTimeChainOrdering(Config.Solution.OrderTimeChain);
+  MetricsExport Monitoring(Config, Graph);
+  Graph.setWarmStart(Config.Solution.WarmStart);
+  AdaptiveErrorModel Adaptive;
+
+  /** sliding window of the window solution type */
+  libRSF::FixedLagSmoother Window(Graph, Config);
+  Window.setInflation(1.01);
+  libRSF::WindowController WindowControl(Config);
 
   /** create prior noise models */
   libRSF::GaussianDiagonal<2> NoisePriorPoint;
@@ -62,6 +248,37 @@ int CreateGraphAndSolve(const libRSF::FactorGraphConfig &Config,
   Graph.addFactor<libRSF::FactorType::Prior2>(libRSF::StateID(POSITION_STATE, TimeFirst), PriorPoint, NoisePriorPoint);
   Graph.addFactor<libRSF::FactorType::PriorAngle>(libRSF::StateID(ORIENTATION_STATE, TimeFirst), PriorAngle, NoisePriorAngle);
 
+  /** the size of offline problems is known in advance, there is one epoch per range timestamp */
+  if (Config.Solution.Type == libRSF::SolutionType::Batch)
+  {
+    std::vector<double> RangeTimes;
+    Measurements.getTimesOfID(libRSF::DataType::Range2, RangeTimes);
+    ReserveGraph(Graph, Measurements, std::max<size_t>(1, RangeTimes.size()));
+  }
+
+  /** optional complete smoother in a second thread next to the window or filter */
+  std::unique_ptr<libRSF::BackgroundSmoother> Smoother;
+  if (Config.Solution.BackgroundSmoother > 0 && (Config.Solution.Type == libRSF::SolutionType::Window ||
+                                                 Config.Solution.Type == libRSF::SolutionType::Filter))
+  {
+    Smoother = std::make_unique<libRSF::BackgroundSmoother>(Config.SolverConfig,
+                                                            [&Config, TimeFirst](libRSF::FactorGraph &SmootherGraph, const libRSF::SensorDataSet &EpochMeasurements, const double EpochOld, const double EpochNow)
+    {
+      if (EpochNow == TimeFirst)
+      {
+        BuildRangingSegment(SmootherGraph, Config, EpochMeasurements, TimeFirst, TimeFirst, TimeFirst);
+      }
+      else
+      {
+        AddRangingEpoch(SmootherGraph, Config, EpochMeasurements, EpochOld, EpochNow);
+      }
+    },
+                                                            std::vector<std::string>{POSITION_STATE, ORIENTATION_STATE},
+                                                            Config.Solution.WindowLength,
+                                                            Config.Solution.BackgroundSmoother);
+    Smoother->addMeasurements(Measurements);
+  }
+
   /** duration of different steps */
   libRSF::Data Summary(libRSF::DataType::IterationSummary, 0.0);
   libRSF::Timer IterationTimer;
@@ -72,59 +289,52 @@ int CreateGraphAndSolve(const libRSF::FactorGraphConfig &Config,
   do
   {
     /** update current timestamp and reset durations */
-    Summary = libRSF::Data(libRSF::DataType::IterationSummary, TimeNow);
+    Summary.reset(libRSF::DataType::IterationSummary, TimeNow);
 
     /** start timer*/
     IterationTimer.reset();
 
-    /** add new states and odometry */
+    /** optional time budget of this epoch */
+    const libRSF::Deadline EpochDeadline = (Config.Solution.Deadline > 0.0) ? libRSF::Deadline(Config.Solution.Deadline) : libRSF::Deadline();
+
+    /** add new states, odometry and ranges */
     if (TimeNow != TimeFirst)
     {
-      /** new states */
-      Graph.addState(POSITION_STATE, libRSF::DataType::Point2, TimeNow);
-      Graph.addState(ORIENTATION_STATE, libRSF::DataType::Angle, TimeNow);
-
-      /** get odometry measurement */
-      double TimeOdom = 0.0;
-      if (!Measurements.getTimeBelowOrEqual(libRSF::DataType::Odom2, TimeNow, TimeOdom))
+      if (!AddRangingEpoch(Graph, Config, Measurements, TimePrev, TimeNow))
       {
-        PRINT_ERROR("Could not find measurement below: ", TimeNow);
         return 1;
       }
-      const libRSF::Data Odom = Measurements.getElement(libRSF::DataType::Odom2, TimeOdom);
-
-      /** create noise model */
-      libRSF::GaussianDiagonal<3> GaussianOdom;
-      GaussianOdom.setCovarianceDiagonal(Odom.getCovarianceDiagonal());
-
-      /** add odometry factor */
-      Graph.addFactor<libRSF::FactorType::Odom2>(libRSF::StateID(POSITION_STATE, TimePrev),
-                                                 libRSF::StateID(ORIENTATION_STATE, TimePrev),
-                                                 libRSF::StateID(POSITION_STATE, TimeNow),
-                                                 libRSF::StateID(ORIENTATION_STATE, TimeNow),
-                                                 Odom, GaussianOdom);
+    }
+    else
+    {
+      for (const libRSF::Data &Range: Measurements.getElements(libRSF::DataType::Range2, TimeNow))
+      {
+        AddRange2(Graph, Config, Range, TimeNow);
+      }
     }
 
-    /** get range measurements */
-    const std::vector<libRSF::Data> Ranges = Measurements.getElements(libRSF::DataType::Range2, TimeNow);
-
-    /** add range measurements */
-    for (const libRSF::Data &Range: Ranges)
+    /** the smoother gets the same epoch, its last solution is the new starting point of the window */
+    if (Smoother)
     {
-      AddRange2(Graph, Config, Range, TimeNow);
+      Smoother->closeEpoch(TimeNow);
+      Smoother->correct(Graph);
     }
 
     /** adapt error model */
-    AdaptErrorModel(Graph, Config, Summary);
+    Adaptive.adapt(Graph, Config, Summary);
 
     /** solve */
-    Solve(Graph, Config, Summary, false);
+    Solve(Graph, Config, Adaptive, Window, Summary, false, EpochDeadline);
 
     /** save iteration timestamp */
     Summary.setValueScalar(libRSF::DataElement::DurationTotal, IterationTimer.getSeconds());
 
     /** save current estimate */
-    Save(Graph, Config, Summary, Result, false);
+    Save(Graph, Config, Summary, Sink, false);
+    Monitoring.recordEpoch(Summary);
+
+    /** follow the processing time with the window length */
+    AdaptWindowLength(WindowControl, Window, Summary);
 
     TimePrev = TimeNow;
   }
@@ -132,14 +342,36 @@ int CreateGraphAndSolve(const libRSF::FactorGraphConfig &Config,
 
   /** calculate and save final solution*/
   Summary.setTimestamp(TimeNow);
-  Solve(Graph, Config, Summary, true);
+  Solve(Graph, Config, Adaptive, Window, Summary, true);
   Summary.setValueScalar(libRSF::DataElement::DurationTotal, IterationTimer.getSeconds());
-  Save(Graph, Config, Summary, Result, true);
+  Save(Graph, Config, Summary, Sink, true);
+
+  /** the smoothed trajectory is available next to the estimates of the window */
+  if (Smoother)
+  {
+    Smoother->finish();
+    const libRSF::StateDataSet &Smoothed = Smoother->getSmoother().getStateData();
+    for (const libRSF::Data &Position : Smoothed.getElementsOfID(POSITION_STATE))
+    {
+      Sink.addElement(POSITION_SMOOTHED_STATE, Position);
+    }
+    for (const libRSF::Data &Orientation : Smoothed.getElementsOfID(ORIENTATION_STATE))
+    {
+      Sink.addElement(ORIENTATION_SMOOTHED_STATE, Orientation);
+    }
+  }
 
   return 0;
 }
 
 
+int CreateGraphAndSolve(const libRSF::FactorGraphConfig &Config,
+                        libRSF::StateDataSet &Result)
+{
+  libRSF::MemoryResultSink Sink(Result);
+  return CreateGraphAndSolve(Config, Sink);
+}
+
 #ifndef TESTMODE // only compile main if not used in test context
 
 int main(int ArgC, char ** ArgV)
@@ -150,23 +382,20 @@ int main(int ArgC, char ** ArgV)
   libRSF::FactorGraphConfig Config;
   Config.ReadCommandLineOptions(ArgC, ArgV);
 
-  /** data structure for estimates*/
-  libRSF::StateDataSet Result;
+  /** estimates and timing information are written while solving */
+  libRSF::FileResultSink Sink(Config.OutputFile, {POSITION_STATE, ORIENTATION_STATE, POSITION_SMOOTHED_STATE, ORIENTATION_SMOOTHED_STATE, SOLVE_TIME_STATE});
 
   /** solve the estimation problem */
-  if (CreateGraphAndSolve(Config,Result) != 0)
+  if (CreateGraphAndSolve(Config, Sink) != 0)
   {
     PRINT_ERROR("Something gone wrong while estimating position!");
   }
-  else
-  {
-    /** export estimates to file */
-    libRSF::WriteDataToFile(Config.OutputFile, POSITION_STATE, Result, false);
-    libRSF::WriteDataToFile(Config.OutputFile, ORIENTATION_STATE, Result, true);
+  Sink.flush();
 
-    /** export timing information */
-    libRSF::WriteDataToFile(Config.OutputFile, SOLVE_TIME_STATE, Result, true);
-  }
+#ifdef LIBRSF_TRACING
+  /** export the spans of all processing steps */
+  libRSF::WriteTraceToFile(Config.OutputFile + std::string("_trace.json"));
+#endif
 
   return 0;
 }
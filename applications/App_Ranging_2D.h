@@ -40,6 +40,10 @@
 
 #include "libRSF.h"
 
+/** estimates are passed to the sink as soon as they are final */
+int CreateGraphAndSolve(const libRSF::FactorGraphConfig &Config,
+                        libRSF::ResultSink &Sink);
+
 int CreateGraphAndSolve(const libRSF::FactorGraphConfig &Config,
                         libRSF::StateDataSet &Result);
 
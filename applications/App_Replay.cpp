@@ -0,0 +1,100 @@
+/***************************************************************************
+ * libRSF - A Robust Sensor Fusion Library
+ *
+ * Copyright (C) 2018 Chair of Automation Technology / TU Chemnitz
+ * For more information see https://www.tu-chemnitz.de/etit/proaut/libRSF
+ *
+ * libRSF is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libRSF is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with libRSF.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Tim Pfeifer (tim.pfeifer@etit.tu-chemnitz.de)
+ ***************************************************************************/
+
+/**
+ * @file App_Replay.cpp
+ * @author Tim Pfeifer
+ * @date 14.10.2026
+ * @brief Re-executes a recorded trace of graph operations, e.g. to profile a reported problem.
+ * @copyright GNU Public License.
+ *
+ */
+
+#include "App_Replay.h"
+
+#include <array>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+
+bool ReplayTrace(const std::string &TraceFile,
+                 const bool PrintTiming)
+{
+  libRSF::FactorGraph Graph;
+  std::vector<libRSF::TraceTiming> Timings;
+
+  libRSF::Timer Clock;
+  if (!Graph.replayTrace(TraceFile, &Timings))
+  {
+    return false;
+  }
+  const double Duration = Clock.getSeconds();
+
+  PRINT_LOGGING("Replayed ", Timings.size(), " operations in ", Duration, "s");
+
+  if (PrintTiming)
+  {
+    /** sum up per operation */
+    constexpr size_t OperationNumber = static_cast<size_t>(libRSF::TraceOperation::Number);
+    std::array<int, OperationNumber> Count{};
+    std::array<double, OperationNumber> Recorded{};
+    std::array<double, OperationNumber> Replayed{};
+    for (const libRSF::TraceTiming &Timing : Timings)
+    {
+      const size_t Index = static_cast<size_t>(Timing.Operation);
+      Count.at(Index)++;
+      Recorded.at(Index) += Timing.Recorded;
+      Replayed.at(Index) += Timing.Replayed;
+    }
+
+    std::cout << std::left << std::setw(36) << "operation" << std::right
+              << std::setw(10) << "count" << std::setw(14) << "recorded [s]" << std::setw(14) << "replayed [s]" << '\n';
+    for (size_t n = 0; n < OperationNumber; n++)
+    {
+      if (Count.at(n) > 0)
+      {
+        std::cout << std::left << std::setw(36) << libRSF::GetTraceOperationName(static_cast<libRSF::TraceOperation>(n)) << std::right
+                  << std::setw(10) << Count.at(n)
+                  << std::setw(14) << std::setprecision(4) << Recorded.at(n)
+                  << std::setw(14) << std::setprecision(4) << Replayed.at(n) << '\n';
+      }
+    }
+  }
+
+  Graph.printReport();
+  return true;
+}
+
+int main(int ArgC, char ** ArgV)
+{
+  google::InitGoogleLogging(ArgV[0]);
+
+  /** parse command line arguments */
+  if (ArgC < 2)
+  {
+    PRINT_ERROR("Usage: libRSF_replay TraceFile [--timing]");
+    return 1;
+  }
+  const bool PrintTiming = (ArgC > 2 && std::strcmp(ArgV[2], "--timing") == 0);
+
+  return ReplayTrace(ArgV[1], PrintTiming) ? 0 : 1;
+}
@@ -0,0 +1,46 @@
+/***************************************************************************
+ * libRSF - A Robust Sensor Fusion Library
+ *
+ * Copyright (C) 2018 Chair of Automation Technology / TU Chemnitz
+ * For more information see https://www.tu-chemnitz.de/etit/proaut/libRSF
+ *
+ * libRSF is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libRSF is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with libRSF.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Tim Pfeifer (tim.pfeifer@etit.tu-chemnitz.de)
+ ***************************************************************************/
+
+/**
+ * @file App_Replay.h
+ * @author Tim Pfeifer
+ * @date 14.10.2026
+ * @brief Re-executes a recorded trace of graph operations, e.g. to profile a reported problem.
+ * @copyright GNU Public License.
+ *
+ */
+
+#ifndef APP_REPLAY_H
+#define APP_REPLAY_H
+
+#include "AppPool_Sensors.h"
+#include "AppPool_Adaptive.h"
+
+#include "libRSF.h"
+
+#include <string>
+
+/** replay the trace into an empty graph, the duration of all operations is printed optionally */
+bool ReplayTrace(const std::string &TraceFile,
+                 bool PrintTiming);
+
+#endif // APP_REPLAY_H
@@ -32,6 +32,7 @@
 #include "App_Robust_Models_3D.h"
 
 int CreateGraphAndSolve(std::vector<std::string> &Arguments,
+                       const libRSF::FactorGraphConfig &Config,
                        libRSF::StateDataSet &CostSurfaceData,
                        libRSF::StateDataSet &PreOptimizationData,
                        libRSF::StateDataSet &PostOptimizationData,
@@ -65,12 +66,15 @@ int CreateGraphAndSolve(std::vector<std::string> &Arguments,
   /** create our own graph object */
   libRSF::FactorGraph SimpleGraph;
 
+  /** the problem is solved many times and is tiny, so the setup of ceres would dominate */
+  SimpleGraph.setDenseSolverThreshold(10);
+
   /** set the solver options for ceres */
   ceres::Solver::Options SolverOptions;
   SolverOptions.linear_solver_type = ceres::LinearSolverType::DENSE_QR;
   SolverOptions.minimizer_type = ceres::MinimizerType::TRUST_REGION;
   SolverOptions.trust_region_strategy_type = ceres::TrustRegionStrategyType::LEVENBERG_MARQUARDT;
-  SolverOptions.num_threads = 1;
+  SolverOptions.num_threads = Config.SolverConfig.num_threads;
   SolverOptions.max_num_iterations = 100;
   SolverOptions.max_solver_time_in_seconds = 1.0;
   SolverOptions.minimizer_progress_to_stdout = false;
@@ -214,7 +218,7 @@ int main(int argc, char** argv)
   libRSF::StateDataSet PostOptimizationData;
   libRSF::StateDataSet SolverData;
 
-  if (CreateGraphAndSolve(Arguments,CostSurfaceData,PreOptimizationData,PostOptimizationData,SolverData) != 0)
+  if (CreateGraphAndSolve(Arguments,Config,CostSurfaceData,PreOptimizationData,PostOptimizationData,SolverData) != 0)
   {
     return 1;
   }
@@ -40,6 +40,7 @@
 #define SOLVE_TIME_STATE "SolveTime"
 
 int CreateGraphAndSolve(std::vector<std::string> &Arguments,
+                       const libRSF::FactorGraphConfig &Config,
                        libRSF::StateDataSet &CostSurfaceData,
                        libRSF::StateDataSet &PreOptimizationData,
                        libRSF::StateDataSet &PostOptimizationData,
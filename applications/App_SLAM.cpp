@@ -53,13 +53,10 @@ void AddLoopClosure2(libRSF::FactorGraph &Graph,
 
     case libRSF::ErrorModelType::GMM:
       {
-        /** init model */
-        libRSF::GaussianMixture<2> const GMM(Config.LoopClosure.ErrorModel.GMM);
-
         /**Max-Mixture GMM [Olson et al.]*/
         if(Config.LoopClosure.ErrorModel.GMM.MixtureType == libRSF::ErrorModelMixtureType::MaxMix)
         {
-          libRSF::MaxMix2 const MixtureNoise(GMM);
+          libRSF::MaxMix2 const MixtureNoise = GetMixturePrototype<libRSF::MaxMix2, 2>(Config.LoopClosure.ErrorModel.GMM);
           Graph.addFactor<libRSF::FactorType::Loop2>(libRSF::StateID(POSITION_STATE, Time1),
                                                          libRSF::StateID(POSITION_STATE, Time2),
                                                          MixtureNoise);
@@ -67,7 +64,7 @@ void AddLoopClosure2(libRSF::FactorGraph &Graph,
         /**Sum-Mixture GMM [Rosen et al.]*/
         else if(Config.LoopClosure.ErrorModel.GMM.MixtureType == libRSF::ErrorModelMixtureType::SumMix)
         {
-          libRSF::SumMix2 const MixtureNoise(GMM);
+          libRSF::SumMix2 const MixtureNoise = GetMixturePrototype<libRSF::SumMix2, 2>(Config.LoopClosure.ErrorModel.GMM);
           Graph.addFactor<libRSF::FactorType::Loop2>(libRSF::StateID(POSITION_STATE, Time1),
                                                          libRSF::StateID(POSITION_STATE, Time2),
                                                          MixtureNoise);
@@ -75,7 +72,7 @@ void AddLoopClosure2(libRSF::FactorGraph &Graph,
         /**Max-Sum-Mix-Mixture GMM [Pfeifer et al.]*/
         else if(Config.LoopClosure.ErrorModel.GMM.MixtureType == libRSF::ErrorModelMixtureType::MaxSumMix)
         {
-          libRSF::MaxSumMix2 const MixtureNoise(GMM);
+          libRSF::MaxSumMix2 const MixtureNoise = GetMixturePrototype<libRSF::MaxSumMix2, 2>(Config.LoopClosure.ErrorModel.GMM);
           Graph.addFactor<libRSF::FactorType::Loop2>(libRSF::StateID(POSITION_STATE, Time1),
                                                          libRSF::StateID(POSITION_STATE, Time2),
                                                          MixtureNoise);
@@ -114,7 +111,7 @@ void AddLoopClosure2(libRSF::FactorGraph &Graph,
         Graph.addFactor<libRSF::FactorType::Loop2>(libRSF::StateID(POSITION_STATE, Time1),
                                                        libRSF::StateID(POSITION_STATE, Time2),
                                                        Noise,
-                                                       new libRSF::DCSLoss(Config.LoopClosure.ErrorModel.Parameter));
+                                                       Graph.getSharedLoss<libRSF::DCSLoss>(Config.LoopClosure.ErrorModel.Parameter));
       }
       break;
 
@@ -151,7 +148,7 @@ void AddLoopClosure2(libRSF::FactorGraph &Graph,
         Graph.addFactor<libRSF::FactorType::Loop2>(libRSF::StateID(POSITION_STATE, Time1),
                                                        libRSF::StateID(POSITION_STATE, Time2),
                                                        Noise,
-                                                       new libRSF::cDCELoss(StdDevLoop));
+                                                       Graph.getSharedLoss<libRSF::cDCELoss>(StdDevLoop));
       }
       break;
 
@@ -161,8 +158,314 @@ void AddLoopClosure2(libRSF::FactorGraph &Graph,
   }
 }
 
+void RebuildTrajectoryIndex(libRSF::FactorGraph &Graph, libRSF::PositionIndex &Trajectory)
+{
+  Trajectory.clear();
+
+  double Time;
+  if (Graph.getStateData().getTimeFirst(POSITION_STATE, Time))
+  {
+    do
+    {
+      Trajectory.insert(Graph.getStateData().getElement(POSITION_STATE, Time).getMean(), Time);
+    }
+    while (Graph.getStateData().getTimeNext(POSITION_STATE, Time, Time));
+  }
+}
+
+libRSF::Data ComposeOdometry2D(const std::vector<libRSF::Data> &OdomVect,
+                               const double StartTime,
+                               const double EndTime,
+                               libRSF::Matrix22 &DriftCov)
+{
+  /** the covariance is averaged as before, the mean is the composed motion expressed as velocity */
+  libRSF::Data Odom = libRSF::AverageMeasurement(OdomVect);
+  DriftCov.setZero();
+  if (OdomVect.empty() || EndTime <= StartTime)
+  {
+    return Odom;
+  }
+
+  libRSF::Vector2 Translation = libRSF::Vector2::Zero();
+  double Yaw = 0.0;
+  double TimeOld = StartTime;
+  for (size_t n = 0; n <= OdomVect.size(); n++)
+  {
+    /** the last measurement is held until the end */
+    const libRSF::Data &Measurement = OdomVect.at(std::min(n, OdomVect.size() - 1));
+    const double Time = (n < OdomVect.size()) ? Measurement.getTimestamp() : EndTime;
+    const double DeltaTime = Time - TimeOld;
+    TimeOld = Time;
+
+    const libRSF::Vector3 Velocity = Measurement.getMean();
+    const libRSF::Vector3 VelocityCov = Measurement.getCovarianceDiagonal();
+    const libRSF::Rotation2D Rotation(Yaw);
+
+    Translation += Rotation * Velocity.head<2>() * DeltaTime;
+    Yaw += Velocity(2) * DeltaTime;
+
+    DriftCov += DeltaTime * DeltaTime * Rotation.toRotationMatrix() * VelocityCov.head<2>().asDiagonal() * Rotation.toRotationMatrix().transpose();
+  }
+
+  const double Duration = EndTime - StartTime;
+  Odom.setMean((libRSF::Vector3() << Translation / Duration, Yaw / Duration).finished());
+  Odom.setTimestamp(EndTime);
+  return Odom;
+}
+
+void InitializeCoarseToFine(libRSF::FactorGraph &Graph,
+                            const libRSF::FactorGraphConfig &Config,
+                            const libRSF::SensorDataSet &Measurements)
+{
+  /** every n-th state and the last one */
+  std::vector<double> TimesFull;
+  Graph.getStateData().getTimesOfID(POSITION_STATE, TimesFull);
+  const size_t Step = static_cast<size_t>(Config.Solution.CoarseToFine);
+  if (TimesFull.size() < 3 * Step)
+  {
+    return;
+  }
+
+  std::vector<double> TimesCoarse;
+  for (size_t n = 0; n < TimesFull.size(); n += Step)
+  {
+    TimesCoarse.push_back(TimesFull.at(n));
+  }
+  if (TimesCoarse.back() != TimesFull.back())
+  {
+    TimesCoarse.push_back(TimesFull.back());
+  }
+
+  /** coarse graph that starts at the current initial guess */
+  libRSF::FactorGraph Coarse;
+  for (const double Time : TimesCoarse)
+  {
+    Coarse.addState(POSITION_STATE, libRSF::DataType::Point2, Time);
+    Coarse.addState(ORIENTATION_STATE, libRSF::DataType::Angle, Time);
+    Coarse.getStateData().getElement(POSITION_STATE, Time).setMean(Graph.getStateData().getElement(POSITION_STATE, Time).getMean());
+    Coarse.getStateData().getElement(ORIENTATION_STATE, Time).setMean(Graph.getStateData().getElement(ORIENTATION_STATE, Time).getMean());
+  }
+
+  /** same prior as the full graph */
+  libRSF::GaussianDiagonal<2> NoisePriorPoint;
+  NoisePriorPoint.setStdDevSharedDiagonal(0.1);
+  libRSF::GaussianDiagonal<1> NoisePriorAngle;
+  NoisePriorAngle.setStdDevSharedDiagonal(0.1);
+
+  const double TimeFirst = TimesCoarse.front();
+  libRSF::Data PriorPoint(libRSF::DataType::Point2, TimeFirst);
+  libRSF::Data PriorAngle(libRSF::DataType::Angle, TimeFirst);
+  PriorPoint.setMean(libRSF::Vector2::Zero());
+  PriorAngle.setMean(libRSF::Vector1::Ones() * M_PI);
+  Coarse.addFactor<libRSF::FactorType::Prior2>(libRSF::StateID(POSITION_STATE, TimeFirst), PriorPoint, NoisePriorPoint);
+  Coarse.addFactor<libRSF::FactorType::PriorAngle>(libRSF::StateID(ORIENTATION_STATE, TimeFirst), PriorAngle, NoisePriorAngle);
+
+  /** composed odometry between the coarse states */
+  for (size_t n = 1; n < TimesCoarse.size(); n++)
+  {
+    const std::vector<libRSF::Data> OdomVect = Measurements.getElementsBetween(libRSF::DataType::Odom2, TimesCoarse.at(n-1), TimesCoarse.at(n));
+    libRSF::Matrix22 DriftCov;
+    const libRSF::Data Odom = ComposeOdometry2D(OdomVect, TimesCoarse.at(n-1), TimesCoarse.at(n), DriftCov);
+
+    libRSF::GaussianDiagonal<3> NoiseOdom;
+    NoiseOdom.setCovarianceDiagonal(Odom.getCovarianceDiagonal());
+
+    Coarse.addFactor<libRSF::FactorType::Odom2>(libRSF::StateID(POSITION_STATE, TimesCoarse.at(n-1)),
+                                                libRSF::StateID(ORIENTATION_STATE, TimesCoarse.at(n-1)),
+                                                libRSF::StateID(POSITION_STATE, TimesCoarse.at(n)),
+                                                libRSF::StateID(ORIENTATION_STATE, TimesCoarse.at(n)),
+                                                Odom,
+                                                NoiseOdom,
+                                                false);
+  }
+
+  /** loop-closures attach to the closest coarse states */
+  for (const libRSF::Data &Loop : Measurements.getElementsOfID(libRSF::DataType::LoopClosure))
+  {
+    if (Loop.getValue(libRSF::DataElement::Similarity)(0) >= Config.LoopClosure.Parameter(0))
+    {
+      AddLoopClosure2(Coarse, Config, Loop);
+    }
+  }
+
+  ceres::Solver::Options Options = Config.SolverConfig;
+  Options.minimizer_progress_to_stdout = false;
+  Coarse.solve(Options);
+
+  /** the correction of the coarse solution is interpolated, so the shape of the odometry between the coarse states is kept */
+  std::vector<libRSF::Vector3> Corrections;
+  for (const double Time : TimesCoarse)
+  {
+    const libRSF::Vector2 PointFull = Graph.getStateData().getElement(POSITION_STATE, Time).getMean();
+    const double YawFull = Graph.getStateData().getElement(ORIENTATION_STATE, Time).getMean()(0);
+    const libRSF::Vector2 PointCoarse = Coarse.getStateData().getElement(POSITION_STATE, Time).getMean();
+    const double YawCoarse = Coarse.getStateData().getElement(ORIENTATION_STATE, Time).getMean()(0);
+
+    const double YawCorrection = libRSF::NormalizeAngle(YawCoarse - YawFull);
+    const libRSF::Vector2 Translation = PointCoarse - libRSF::Rotation2D(YawCorrection) * PointFull;
+    Corrections.emplace_back((libRSF::Vector3() << Translation, YawCorrection).finished());
+  }
+
+  size_t Segment = 0;
+  for (const double Time : TimesFull)
+  {
+    while (Segment + 2 < TimesCoarse.size() && Time > TimesCoarse.at(Segment + 1))
+    {
+      Segment++;
+    }
+    const double Ratio = (Time - TimesCoarse.at(Segment)) / (TimesCoarse.at(Segment + 1) - TimesCoarse.at(Segment));
+
+    libRSF::Vector3 Correction = Corrections.at(Segment);
+    Correction.head<2>() += Ratio * (Corrections.at(Segment + 1).head<2>() - Corrections.at(Segment).head<2>());
+    Correction(2) += Ratio * libRSF::NormalizeAngle(Corrections.at(Segment + 1)(2) - Corrections.at(Segment)(2));
+
+    libRSF::Data &Point = Graph.getStateData().getElement(POSITION_STATE, Time);
+    libRSF::Data &Angle = Graph.getStateData().getElement(ORIENTATION_STATE, Time);
+    Point.setMean(libRSF::Rotation2D(Correction(2)) * libRSF::Vector2(Point.getMean()) + Correction.head<2>());
+    Angle.setMean(libRSF::Vector1::Ones() * libRSF::NormalizeAngle(Angle.getMean()(0) + Correction(2)));
+  }
+}
+
+void InitializePoseGraph(libRSF::FactorGraph &Graph,
+                         const libRSF::FactorGraphConfig &Config,
+                         const libRSF::SensorDataSet &Measurements)
+{
+  /** the orientation is only constrained by the odometry chain, which is the initial guess already,
+   *  so only the positions have to be corrected, which is a linear problem for fixed orientations */
+  std::vector<double> Times;
+  Graph.getStateData().getTimesOfID(POSITION_STATE, Times);
+  const int N = static_cast<int>(Times.size());
+  if (N < 3)
+  {
+    return;
+  }
+
+  std::vector<libRSF::Vector2> Points(N);
+  std::vector<double> Yaws(N);
+  for (int n = 0; n < N; n++)
+  {
+    Points.at(n) = Graph.getStateData().getElement(POSITION_STATE, Times.at(n)).getMean();
+    Yaws.at(n) = Graph.getStateData().getElement(ORIENTATION_STATE, Times.at(n)).getMean()(0);
+  }
+
+  /** odometry edges in the world frame and the accumulated drift along the chain */
+  std::vector<libRSF::Matrix22> InfoOdom(N - 1);
+  std::vector<double> VarTranslation(N, 0.0), VarYaw(N, 0.0), PathLength(N, 0.0);
+  for (int n = 0; n < N - 1; n++)
+  {
+    const double Duration = Times.at(n + 1) - Times.at(n);
+    const libRSF::Data Odom = libRSF::AverageMeasurement(Measurements.getElementsBetween(libRSF::DataType::Odom2, Times.at(n), Times.at(n + 1)));
+    const libRSF::Vector3 Cov = Odom.getCovarianceDiagonal() * Duration * Duration;
+
+    const libRSF::Matrix22 Rotation = libRSF::Rotation2D(Yaws.at(n)).toRotationMatrix();
+    InfoOdom.at(n) = Rotation * libRSF::Vector2(Cov.head<2>().cwiseInverse()).asDiagonal() * Rotation.transpose();
+
+    VarTranslation.at(n + 1) = VarTranslation.at(n) + Cov(0) + Cov(1);
+    VarYaw.at(n + 1) = VarYaw.at(n) + Cov(2);
+    PathLength.at(n + 1) = PathLength.at(n) + (Points.at(n + 1) - Points.at(n)).norm();
+  }
+
+  /** loop-closures that are consistent with the drift of the chain, the others would distort the linear solution */
+  const double StdDevLoop = Config.LoopClosure.Parameter(1);
+  const double Gate = 9.21; /**< 99% of the chi-square distribution with two DOF */
+  std::vector<std::pair<int, int>> Loops;
+  for (const libRSF::Data &Loop : Measurements.getElementsOfID(libRSF::DataType::LoopClosure))
+  {
+    if (Loop.getValue(libRSF::DataElement::Similarity)(0) < Config.LoopClosure.Parameter(0))
+    {
+      continue;
+    }
+
+    double Time1, Time2;
+    Graph.getStateData().getTimeCloseTo(POSITION_STATE, Loop.getTimestamp(), Time1);
+    Graph.getStateData().getTimeCloseTo(POSITION_STATE, Loop.getValue(libRSF::DataElement::TimestampRef)(0), Time2);
+    int Index1 = static_cast<int>(std::lower_bound(Times.begin(), Times.end(), Time1) - Times.begin());
+    int Index2 = static_cast<int>(std::lower_bound(Times.begin(), Times.end(), Time2) - Times.begin());
+    if (Index1 == Index2 || Index1 >= N || Index2 >= N)
+    {
+      continue;
+    }
+    if (Index1 > Index2)
+    {
+      std::swap(Index1, Index2);
+    }
+
+    const double Length = PathLength.at(Index2) - PathLength.at(Index1);
+    const double Drift = VarTranslation.at(Index2) - VarTranslation.at(Index1) + (VarYaw.at(Index2) - VarYaw.at(Index1)) * Length * Length;
+    if ((Points.at(Index2) - Points.at(Index1)).squaredNorm() <= Gate * (StdDevLoop * StdDevLoop + Drift))
+    {
+      Loops.emplace_back(Index1, Index2);
+    }
+  }
+  if (Loops.empty())
+  {
+    return;
+  }
+
+  /** sparse normal equations of the positions, the first one is anchored like the prior of the graph */
+  std::vector<Eigen::Triplet<double>> Triplets;
+  libRSF::Vector Gradient = libRSF::Vector::Zero(2 * N);
+  auto AddEdge = [&](const int Index1, const int Index2, const libRSF::Matrix22 &Info, const libRSF::Vector2 &Delta)
+  {
+    for (int r = 0; r < 2; r++)
+    {
+      for (int c = 0; c < 2; c++)
+      {
+        Triplets.emplace_back(2 * Index1 + r, 2 * Index1 + c, Info(r, c));
+        Triplets.emplace_back(2 * Index2 + r, 2 * Index2 + c, Info(r, c));
+        Triplets.emplace_back(2 * Index1 + r, 2 * Index2 + c, -Info(r, c));
+        Triplets.emplace_back(2 * Index2 + r, 2 * Index1 + c, -Info(r, c));
+      }
+    }
+    Gradient.segment<2>(2 * Index1) -= Info * Delta;
+    Gradient.segment<2>(2 * Index2) += Info * Delta;
+  };
+
+  for (int n = 0; n < N - 1; n++)
+  {
+    AddEdge(n, n + 1, InfoOdom.at(n), Points.at(n + 1) - Points.at(n));
+  }
+  const libRSF::Matrix22 InfoLoop = libRSF::Matrix22::Identity() / (StdDevLoop * StdDevLoop);
+  for (const auto &Loop : Loops)
+  {
+    AddEdge(Loop.first, Loop.second, InfoLoop, libRSF::Vector2::Zero());
+  }
+  const double InfoPrior = 1.0 / (0.1 * 0.1);
+  Triplets.emplace_back(0, 0, InfoPrior);
+  Triplets.emplace_back(1, 1, InfoPrior);
+  Gradient.segment<2>(0) += InfoPrior * Points.at(0);
+
+  libRSF::SparseMatrix Hessian(2 * N, 2 * N);
+  Hessian.setFromTriplets(Triplets.begin(), Triplets.end());
+  const Eigen::SimplicialLDLT<libRSF::SparseMatrix> Solver(Hessian);
+  if (Solver.info() != Eigen::Success)
+  {
+    PRINT_WARNING("Pose graph initialization failed, the odometry chain is kept.");
+    return;
+  }
+  const libRSF::Vector Solution = Solver.solve(Gradient);
+
+  /** the heading follows the corrected direction of travel */
+  double YawCorrection = 0.0;
+  for (int n = 0; n < N; n++)
+  {
+    if (n < N - 1)
+    {
+      const libRSF::Vector2 Old = Points.at(n + 1) - Points.at(n);
+      const libRSF::Vector2 New = Solution.segment<2>(2 * n + 2) - Solution.segment<2>(2 * n);
+      if (Old.norm() > 1e-3 && New.norm() > 1e-3)
+      {
+        YawCorrection = libRSF::NormalizeAngle(std::atan2(New(1), New(0)) - std::atan2(Old(1), Old(0)));
+      }
+    }
+
+    Graph.getStateData().getElement(POSITION_STATE, Times.at(n)).setMean(Solution.segment<2>(2 * n));
+    Graph.getStateData().getElement(ORIENTATION_STATE, Times.at(n)).setMean(libRSF::Vector1::Ones() * libRSF::NormalizeAngle(Yaws.at(n) + YawCorrection));
+  }
+}
+
 int CreateGraphAndSolve(const libRSF::FactorGraphConfig &Config,
-                        libRSF::StateDataSet &Result)
+                        libRSF::ResultSink &Sink)
 {
 
   /** read input data */
@@ -171,10 +474,34 @@ int CreateGraphAndSolve(const libRSF::FactorGraphConfig &Config,
 
   /** Build optimization problem from sensor data */
   libRSF::FactorGraph Graph;
+  if (!Config.Solution.TraceFile.empty())
+  {
+    Graph.startTrace(Config.Solution.TraceFile);
+  }
+  Graph.setIterationTelemetry(Config.Solution.IterationTelemetry);
+  Graph.setBackendSelection(Config.Solution.AutoBackend);
+  Graph.setTimeChainOrdering(Config.Solution.OrderTimeChain);
+  MetricsExport Monitoring(Config, Graph);
+  Graph.setWarmStart(Config.Solution.WarmStart);
+  Graph.setLandmarksFirst(Config.Solution.OrderLandmarksFirst);
+  AdaptiveErrorModel Adaptive;
+
+  /** sliding window of the window solution type */
+  libRSF::FixedLagSmoother Window(Graph, Config);
+  Window.setInflation(1.01);
+  libRSF::WindowController WindowControl(Config);
 
   /** duration of different steps */
   libRSF::Data Summary(libRSF::DataType::IterationSummary, 0.0);
 
+  /** own loop-closure candidates from the estimated trajectory */
+  const double ProposalRadius = Config.LoopClosure.Parameter.size() > 2 ? Config.LoopClosure.Parameter(2) : 0.0;
+  const double ProposalExclusion = Config.LoopClosure.Parameter.size() > 3 ? Config.LoopClosure.Parameter(3) : 0.0;
+  libRSF::PositionIndex Trajectory(2);
+
+  /** epochs without enough motion or information are folded into the last keyframe */
+  libRSF::KeyframePolicy Keyframes(Config.Keyframe);
+
   /** find time boarders */
   double TimeFirst = 0.0, TimeLast = 0.0, TimeNow = 0.0, TimeOld = 0.0;
   Measurements.getTimeFirst(libRSF::DataType::Odom2, TimeFirst);
@@ -205,36 +532,81 @@ int CreateGraphAndSolve(const libRSF::FactorGraphConfig &Config,
   Graph.addFactor<libRSF::FactorType::Prior2>(libRSF::StateID(POSITION_STATE, TimeFirst), PriorPoint, NoisePriorPoint);
   Graph.addFactor<libRSF::FactorType::PriorAngle>(libRSF::StateID(ORIENTATION_STATE, TimeFirst), PriorAngle, NoisePriorAngle);
 
+  /** the size of offline problems is known in advance */
+  if (Config.Solution.Type == libRSF::SolutionType::Batch)
+  {
+    ReserveGraph(Graph, Measurements, CountEpochs(Config, Measurements, TimeFirst, TimeLast));
+  }
+
   /** loop over odometry */
   TimeOld = TimeFirst - 1;
   TimeNow = TimeFirst;
+  double TimeKeyframe = TimeOld;
+  Keyframes.reset(TimeFirst);
+  EpochCursor Epochs(Config, Measurements);
   libRSF::Timer IterationTimer;
   do
   {
     /** update current timestamp and reset durations */
-    Summary = libRSF::Data(libRSF::DataType::IterationSummary, TimeNow);
+    Summary.reset(libRSF::DataType::IterationSummary, TimeNow);
 
     /** start timer*/
     IterationTimer.reset();
 
+    /** optional time budget of this epoch */
+    const libRSF::Deadline EpochDeadline = (Config.Solution.Deadline > 0.0) ? libRSF::Deadline(Config.Solution.Deadline) : libRSF::Deadline();
+
     if (TimeNow > TimeFirst)
     {
+      /** get odometry measurements since the last keyframe */
+      const std::vector<libRSF::Data> OdomVect = Measurements.getElementsBetween(libRSF::DataType::Odom2, TimeKeyframe, TimeNow);
+      libRSF::Data Odom;
+      if (Config.Keyframe.IsActive)
+      {
+        libRSF::Matrix22 DriftCov;
+        Odom = ComposeOdometry2D(OdomVect, TimeKeyframe, TimeNow, DriftCov);
+
+        /** a loop-closure in this interval would constrain the drift of the new state */
+        double InformationGain = 0.0;
+        for (const libRSF::Data &Loop : Measurements.range(libRSF::DataType::LoopClosure, TimeKeyframe, TimeNow))
+        {
+          if (Loop.getValue(libRSF::DataElement::Similarity)(0) >= Config.LoopClosure.Parameter(0))
+          {
+            const double StdDevLoop = Config.LoopClosure.Parameter(1);
+            InformationGain = std::max(InformationGain,
+                                       libRSF::KeyframePolicy::ExpectedInformationGain(DriftCov, libRSF::Matrix22::Identity() / (StdDevLoop * StdDevLoop)));
+          }
+        }
+
+        const libRSF::Vector3 Motion = Odom.getMean() * (TimeNow - TimeKeyframe);
+        if (TimeNow >= TimeLast)
+        {
+          /** the last epoch always gets a state */
+          Keyframes.accept(TimeNow);
+        }
+        else if (!Keyframes.update(TimeNow, Motion.head<2>().norm(), std::abs(Motion(2)), InformationGain))
+        {
+          libRSF::PrintProgress((TimeNow - TimeFirst) / (TimeLast - TimeFirst) * 100);
+          continue;
+        }
+      }
+      else
+      {
+        Odom = libRSF::AverageMeasurement(OdomVect);
+      }
+
       /** add states */
       Graph.addState(POSITION_STATE, libRSF::DataType::Point2, TimeNow);
       Graph.addState(ORIENTATION_STATE, libRSF::DataType::Angle, TimeNow);
 
-       /** get odometry measurements */
-      const std::vector<libRSF::Data> OdomVect = Measurements.getElementsBetween(libRSF::DataType::Odom2, TimeOld, TimeNow);
-      const libRSF::Data Odom =  libRSF::AverageMeasurement(OdomVect);
-
       /** create error model odom */
       libRSF::GaussianDiagonal<3> NoiseOdom;
       NoiseOdom.setCovarianceDiagonal(Odom.getCovarianceDiagonal());
 
       /** add odometry factor */
       Graph.addFactor<libRSF::FactorType::Odom2>(
-                      libRSF::StateID(POSITION_STATE, TimeOld),
-                      libRSF::StateID(ORIENTATION_STATE, TimeOld),
+                      libRSF::StateID(POSITION_STATE, TimeKeyframe),
+                      libRSF::StateID(ORIENTATION_STATE, TimeKeyframe),
                       libRSF::StateID(POSITION_STATE, TimeNow),
                       libRSF::StateID(ORIENTATION_STATE, TimeNow),
                       Odom,
@@ -243,13 +615,13 @@ int CreateGraphAndSolve(const libRSF::FactorGraphConfig &Config,
 
     /** search for next loop */
     double TimeNextLoop = TimeLast + 1e10;
-    Measurements.getTimeAbove(libRSF::DataType::LoopClosure, TimeOld, TimeNextLoop);
+    Measurements.getTimeAbove(libRSF::DataType::LoopClosure, TimeKeyframe, TimeNextLoop);
 
     /** get loops if there is any */
     if (TimeNextLoop <= TimeNow)
     {
       /** get loop-closures between the last and the current timestamp */
-      std::vector<libRSF::Data> const LoopVect = Measurements.getElementsBetween(libRSF::DataType::LoopClosure, TimeOld, TimeNow);
+      const auto LoopVect = Measurements.range(libRSF::DataType::LoopClosure, TimeKeyframe, TimeNow);
 
       /** add loop-closures */
       static double FirstLoop = TimeLast;
@@ -267,34 +639,82 @@ int CreateGraphAndSolve(const libRSF::FactorGraphConfig &Config,
       Graph.setAllVariableInsideWindow(TimeNow - FirstLoop, TimeNow);
     }
 
+    /** propose a loop-closure to the closest earlier position within the radius */
+    bool HasProposal = false;
+    if (ProposalRadius > 0.0 && TimeNow > TimeFirst)
+    {
+      double TimeCandidate;
+      if (Trajectory.queryNearest(Graph.getStateData().getElement(POSITION_STATE, TimeNow).getMean(), ProposalRadius, TimeNow, ProposalExclusion, TimeCandidate) &&
+          Graph.getStateData().checkElement(POSITION_STATE, TimeCandidate))
+      {
+        libRSF::Data Loop(libRSF::DataType::LoopClosure, TimeNow);
+        Loop.setValueScalar(libRSF::DataElement::TimestampRef, TimeCandidate);
+        AddLoopClosure2(Graph, Config, Loop);
+
+        Graph.setAllVariableInsideWindow(TimeNow - TimeCandidate, TimeNow);
+        HasProposal = true;
+      }
+    }
+
     /** refine error model initially */
     if (TimeNow == TimeFirst)
     {
       Graph.solve(Config.SolverConfig);
-      Solve(Graph, Config, Summary, false);
+      Solve(Graph, Config, Adaptive, Window, Summary, false, EpochDeadline);
     }
     else
     {
       /** solve graph, force solve every 60 seconds */
-      Solve(Graph, Config, Summary, fmod(TimeNow, 60.0) < (TimeNow - TimeOld) * 1.1);
+      Solve(Graph, Config, Adaptive, Window, Summary, fmod(TimeNow, 60.0) < (TimeNow - TimeKeyframe) * 1.1, EpochDeadline);
+    }
+
+    /** keep the index current, loop-closures move the whole trajectory */
+    if (ProposalRadius > 0.0)
+    {
+      if (HasProposal || TimeNextLoop <= TimeNow)
+      {
+        RebuildTrajectoryIndex(Graph, Trajectory);
+      }
+      else
+      {
+        Trajectory.insert(Graph.getStateData().getElement(POSITION_STATE, TimeNow).getMean(), TimeNow);
+      }
     }
 
     /** save iteration timestamp */
     Summary.setValueScalar(libRSF::DataElement::DurationTotal, IterationTimer.getSeconds());
 
     /** save result */
-    Save(Graph, Config, Summary, Result, false);
+    Save(Graph, Config, Summary, Sink, false);
+    Monitoring.recordEpoch(Summary);
+
+    /** follow the processing time with the window length */
+    AdaptWindowLength(WindowControl, Window, Summary);
 
     /** print progress every 10%*/
     libRSF::PrintProgress((TimeNow - TimeFirst) / (TimeLast - TimeFirst) * 100);
+
+    TimeKeyframe = TimeNow;
+  }
+  while (IncrementTime(Config, Epochs, TimeOld, TimeNow, TimeLast));
+
+  /** loop-closures bend the odometry chain in closed form */
+  if (Config.Solution.Type == libRSF::SolutionType::Batch && Config.Solution.PoseGraphInit)
+  {
+    InitializePoseGraph(Graph, Config, Measurements);
+  }
+
+  /** long chains converge faster from the solution of a subsampled graph */
+  if (Config.Solution.Type == libRSF::SolutionType::Batch && Config.Solution.CoarseToFine > 1)
+  {
+    InitializeCoarseToFine(Graph, Config, Measurements);
   }
-  while (IncrementTime(Config, Measurements, TimeOld, TimeNow, TimeLast));
 
   /** calculate and save final solution*/
   Summary.setTimestamp(TimeNow);
-  Solve(Graph, Config, Summary, true);
+  Solve(Graph, Config, Adaptive, Window, Summary, true);
   Summary.setValueScalar(libRSF::DataElement::DurationTotal, IterationTimer.getSeconds());
-  Save(Graph, Config, Summary, Result, true);
+  Save(Graph, Config, Summary, Sink, true);
 
   /** print last report */
   Graph.printReport();
@@ -302,6 +722,13 @@ int CreateGraphAndSolve(const libRSF::FactorGraphConfig &Config,
   return 0;
 }
 
+int CreateGraphAndSolve(const libRSF::FactorGraphConfig &Config,
+                        libRSF::StateDataSet &Result)
+{
+  libRSF::MemoryResultSink Sink(Result);
+  return CreateGraphAndSolve(Config, Sink);
+}
+
 #ifndef TESTMODE // only compile main if not used in test context
 
 int main(int ArgC, char ** ArgV)
@@ -312,25 +739,20 @@ int main(int ArgC, char ** ArgV)
   libRSF::FactorGraphConfig Config;
   Config.ReadCommandLineOptions(ArgC, ArgV);
 
-  /** data structure for estimates*/
-  libRSF::StateDataSet Result;
+  /** estimates and timing information are written while solving */
+  libRSF::FileResultSink Sink(Config.OutputFile, {POSITION_STATE, ORIENTATION_STATE, SOLVE_TIME_STATE});
 
   /** solve the estimation problem */
-  if (CreateGraphAndSolve(Config,Result) != 0)
+  if (CreateGraphAndSolve(Config, Sink) != 0)
   {
     PRINT_ERROR("Something gone wrong while estimating GNSS position!");
   }
-  else
-  {
-    /** export position estimate to file */
-    libRSF::WriteDataToFile(Config.OutputFile, POSITION_STATE, Result, false);
+  Sink.flush();
 
-    /** additional estimates */
-    libRSF::WriteDataToFile(Config.OutputFile, ORIENTATION_STATE, Result, true);
-
-    /** export timing information */
-    libRSF::WriteDataToFile(Config.OutputFile, SOLVE_TIME_STATE, Result, true);
-  }
+#ifdef LIBRSF_TRACING
+  /** export the spans of all processing steps */
+  libRSF::WriteTraceToFile(Config.OutputFile + std::string("_trace.json"));
+#endif
 
   return 0;
 }
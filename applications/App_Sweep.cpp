@@ -0,0 +1,251 @@
+/***************************************************************************
+ * libRSF - A Robust Sensor Fusion Library
+ *
+ * Copyright (C) 2018 Chair of Automation Technology / TU Chemnitz
+ * For more information see https://www.tu-chemnitz.de/etit/proaut/libRSF
+ *
+ * libRSF is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libRSF is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with libRSF.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Tim Pfeifer (tim.pfeifer@etit.tu-chemnitz.de)
+ ***************************************************************************/
+
+/**
+ * @file App_Sweep.cpp
+ * @author Tim Pfeifer
+ * @date 14.10.2026
+ * @brief Compares many GNSS configurations on one dataset in parallel.
+ * @copyright GNU Public License.
+ *
+ */
+
+#include "App_Sweep.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <thread>
+
+bool ReadSweepFile(const std::string &SweepFile,
+                   std::vector<SweepRun> &Runs)
+{
+  std::ifstream File(SweepFile);
+  if (!File.is_open())
+  {
+    PRINT_ERROR("Could not open sweep file: ", SweepFile);
+    return false;
+  }
+
+  std::string Line;
+  int LineNumber = 0;
+  while (std::getline(File, Line))
+  {
+    LineNumber++;
+
+    /** split into arguments */
+    std::istringstream Stream(Line);
+    std::vector<std::string> Arguments;
+    std::string Argument;
+    while (Stream >> Argument)
+    {
+      Arguments.push_back(Argument);
+    }
+
+    /** skip empty lines and comments */
+    if (Arguments.empty() || Arguments.front().front() == '#')
+    {
+      continue;
+    }
+
+    if (Arguments.size() != 2)
+    {
+      PRINT_ERROR("Line ", LineNumber, " of ", SweepFile, " should contain [Name ConfigFile]!");
+      return false;
+    }
+
+    SweepRun Run;
+    Run.Name = Arguments.at(0);
+    Run.ConfigFile = Arguments.at(1);
+    Runs.push_back(Run);
+  }
+
+  return true;
+}
+
+void RunConfiguration(SweepRun &Run,
+                      const libRSF::SensorDataSet &Measurements,
+                      const libRSF::SensorDataSet &GT,
+                      const std::string &OutputPrefix,
+                      const int SolverThreads)
+{
+  libRSF::Timer RunTimer;
+
+  /** every run has its own configuration */
+  libRSF::FactorGraphConfig Config;
+  if (!Config.ReadYAMLOptions(Run.ConfigFile))
+  {
+    PRINT_ERROR("Could not read configuration: ", Run.ConfigFile);
+    return;
+  }
+  Config.OutputFile = OutputPrefix + "_" + Run.Name;
+
+  /** the measurements are already in memory */
+  Config.Solution.IsStreaming = false;
+  Config.Solution.IsPipelined = false;
+
+  /** share the cores between all workers */
+  Config.SolverConfig.num_threads = SolverThreads;
+
+  /** solve the estimation problem, the run works on its own copy-on-write overlay */
+  libRSF::StateDataSet Result;
+  if (CreateGraphAndSolve(Config, Measurements, Result) != 0)
+  {
+    PRINT_ERROR("Something gone wrong while estimating GNSS position for: ", Run.Name);
+    return;
+  }
+  Run.Duration = RunTimer.getSeconds();
+
+  /** export position estimate to file */
+  libRSF::WriteDataToFile(Config.OutputFile, POSITION_STATE, Result, false);
+
+  /** evaluate */
+  const libRSF::TrajectoryError Error = libRSF::EvaluateTrajectory(GT, libRSF::DataType::Point3, Result, POSITION_STATE);
+  Run.ATE = Error.ATE;
+  Run.Percentile95 = Error.Percentile95;
+  Run.RPE = Error.RPE;
+  Run.Success = std::isfinite(Run.ATE);
+}
+
+int RunSweep(std::vector<SweepRun> &Runs,
+             const libRSF::SensorDataSet &Measurements,
+             const libRSF::SensorDataSet &GT,
+             const std::string &OutputPrefix,
+             int WorkerNumber)
+{
+  const int CoreNumber = libRSF::GetThreadNumber();
+  const int RunNumber = static_cast<int>(Runs.size());
+
+  /** one worker per core by default, but not more than runs */
+  if (WorkerNumber <= 0)
+  {
+    WorkerNumber = CoreNumber;
+  }
+  WorkerNumber = std::max(1, std::min(WorkerNumber, RunNumber));
+
+  /** avoid oversubscription by the threads of the solver */
+  const int SolverThreads = std::max(1, CoreNumber / WorkerNumber);
+
+  /** idle workers take the next open run, the measurements and the GT are only read */
+  std::atomic<int> NextRun(0);
+  std::atomic<int> FailedRuns(0);
+
+  auto Work = [&](size_t)
+  {
+    for (int Run = NextRun++; Run < RunNumber; Run = NextRun++)
+    {
+      RunConfiguration(Runs.at(Run), Measurements, GT, OutputPrefix, SolverThreads);
+      if (!Runs.at(Run).Success)
+      {
+        FailedRuns++;
+      }
+    }
+  };
+
+  libRSF::GetThreadPool().parallelRun(WorkerNumber, Work);
+
+  return FailedRuns;
+}
+
+bool WriteSweepReport(const std::string &ReportFile,
+                      std::vector<SweepRun> Runs)
+{
+  std::ofstream File(ReportFile);
+  if (!File.is_open())
+  {
+    PRINT_ERROR("Could not write sweep report: ", ReportFile);
+    return false;
+  }
+
+  /** best configuration first, failed ones at the end */
+  std::stable_sort(Runs.begin(), Runs.end(), [](const SweepRun &A, const SweepRun &B)
+  {
+    if (A.Success != B.Success)
+    {
+      return A.Success;
+    }
+    return A.Success && A.ATE < B.ATE;
+  });
+
+  File << "# name ate[m] p95[m] rpe[m] duration[s] config" << std::endl;
+  File << std::setprecision(6) << std::fixed;
+  for (const SweepRun &Run : Runs)
+  {
+    File << Run.Name << " "
+         << Run.ATE << " "
+         << Run.Percentile95 << " "
+         << Run.RPE << " "
+         << Run.Duration << " "
+         << Run.ConfigFile << std::endl;
+  }
+
+  return true;
+}
+
+int main(int ArgC, char ** ArgV)
+{
+  google::InitGoogleLogging(ArgV[0]);
+
+  /** parse command line arguments */
+  if (ArgC < 5)
+  {
+    PRINT_ERROR("Usage: libRSF_sweep SweepFile InputFile GTFile OutputPrefix [WorkerNumber]");
+    return 1;
+  }
+  const std::string OutputPrefix = ArgV[4];
+  const int WorkerNumber = (ArgC > 5) ? std::stoi(ArgV[5]) : 0;
+
+  std::vector<SweepRun> Runs;
+  if (!ReadSweepFile(ArgV[1], Runs) || Runs.empty())
+  {
+    PRINT_ERROR("No configuration to compare!");
+    return 1;
+  }
+
+  /** the dataset is read once and shared by all runs */
+  libRSF::SensorDataSet Input;
+  libRSF::SensorDataSet GT;
+  libRSF::ReadDataFromFile(ArgV[2], Input);
+  if (!libRSF::ReadGroundTruth(ArgV[3], GT))
+  {
+    return 1;
+  }
+  const libRSF::SensorDataView Measurements(std::move(Input));
+
+  /** solve and evaluate all configurations */
+  const int FailedRuns = RunSweep(Runs, Measurements, GT, OutputPrefix, WorkerNumber);
+  if (!WriteSweepReport(OutputPrefix + "_report.txt", Runs))
+  {
+    return 1;
+  }
+
+  if (FailedRuns > 0)
+  {
+    PRINT_ERROR(FailedRuns, " of ", Runs.size(), " runs failed!");
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,75 @@
+/***************************************************************************
+ * libRSF - A Robust Sensor Fusion Library
+ *
+ * Copyright (C) 2018 Chair of Automation Technology / TU Chemnitz
+ * For more information see https://www.tu-chemnitz.de/etit/proaut/libRSF
+ *
+ * libRSF is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libRSF is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with libRSF.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Tim Pfeifer (tim.pfeifer@etit.tu-chemnitz.de)
+ ***************************************************************************/
+
+/**
+ * @file App_Sweep.h
+ * @author Tim Pfeifer
+ * @date 14.10.2026
+ * @brief Compares many GNSS configurations on one dataset in parallel.
+ * @copyright GNU Public License.
+ *
+ */
+
+#ifndef APP_SWEEP_H
+#define APP_SWEEP_H
+
+#include "App_GNSS.h"
+
+#include <string>
+#include <vector>
+
+/** one configuration of the sweep and its outcome */
+struct SweepRun
+{
+  std::string Name;
+  std::string ConfigFile;
+
+  bool Success = false;
+  double ATE = std::numeric_limits<double>::quiet_NaN();
+  double Percentile95 = std::numeric_limits<double>::quiet_NaN();
+  double RPE = std::numeric_limits<double>::quiet_NaN();
+  double Duration = 0.0;
+};
+
+/** each non-empty line that is not a comment (#) contains: Name ConfigFile */
+bool ReadSweepFile(const std::string &SweepFile,
+                   std::vector<SweepRun> &Runs);
+
+/** solve one configuration on the shared measurements and evaluate it against the ground truth */
+void RunConfiguration(SweepRun &Run,
+                      const libRSF::SensorDataSet &Measurements,
+                      const libRSF::SensorDataSet &GT,
+                      const std::string &OutputPrefix,
+                      int SolverThreads);
+
+/** process all configurations on a set of workers, returns the number of failed runs */
+int RunSweep(std::vector<SweepRun> &Runs,
+             const libRSF::SensorDataSet &Measurements,
+             const libRSF::SensorDataSet &GT,
+             const std::string &OutputPrefix,
+             int WorkerNumber);
+
+/** one line per configuration, sorted by ATE */
+bool WriteSweepReport(const std::string &ReportFile,
+                      std::vector<SweepRun> Runs);
+
+#endif // APP_SWEEP_H
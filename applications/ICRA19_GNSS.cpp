@@ -283,7 +283,7 @@ int CreateGraphAndSolve(std::vector<std::string> &Arguments,
   SolverOptions.trust_region_strategy_type = ceres::TrustRegionStrategyType::DOGLEG;
   SolverOptions.dogleg_type = ceres::DoglegType::SUBSPACE_DOGLEG;
   SolverOptions.max_num_iterations = 1000;
-  SolverOptions.num_threads = static_cast<int>(std::thread::hardware_concurrency());
+  SolverOptions.num_threads = libRSF::GetThreadNumber();
   SolverOptions.max_solver_time_in_seconds = 0.25;
 
   const int NumberOfComponents = 2;
@@ -373,8 +373,7 @@ int CreateGraphAndSolve(std::vector<std::string> &Arguments,
     Result.addElement(POSITION_STATE, Graph.getStateData().getElement(POSITION_STATE, Timestamp, 0));
 
     /** apply sliding window */
-    Graph.removeAllFactorsOutsideWindow(60, Timestamp);
-    Graph.removeAllStatesOutsideWindow(60, Timestamp);
+    Graph.removeBefore(Timestamp - 60);
 
     /** save time stamp */
     TimestampOld = Timestamp;
@@ -345,7 +345,7 @@ int CreateGraphAndSolve(std::vector<std::string> &Arguments,
   SolverOptions.use_nonmonotonic_steps = true;
   SolverOptions.trust_region_strategy_type = ceres::TrustRegionStrategyType::DOGLEG;
   SolverOptions.dogleg_type = ceres::DoglegType::SUBSPACE_DOGLEG;
-  SolverOptions.num_threads = static_cast<int>(std::thread::hardware_concurrency());
+  SolverOptions.num_threads = libRSF::GetThreadNumber();
   SolverOptions.max_num_iterations = 100;
 
   /** read input data */
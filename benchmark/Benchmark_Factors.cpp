@@ -0,0 +1,238 @@
+/***************************************************************************
+ * libRSF - A Robust Sensor Fusion Library
+ *
+ * Copyright (C) 2018 Chair of Automation Technology / TU Chemnitz
+ * For more information see https://www.tu-chemnitz.de/etit/proaut/libRSF
+ *
+ * libRSF is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libRSF is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with libRSF.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Tim Pfeifer (tim.pfeifer@etit.tu-chemnitz.de)
+ ***************************************************************************/
+
+/**
+* @file Benchmark_Factors.cpp
+* @author Tim Pfeifer
+* @date 14.10.2026
+* @brief Microbenchmark of the per-residual evaluation time of factors and error models.
+* @copyright GNU Public License.
+*
+*/
+
+#include "libRSF.h"
+
+#include <functional>
+#include <iomanip>
+#include <iostream>
+
+#define STATE "X"
+#define AUX_STATE "Aux"
+
+namespace
+{
+  /** adds one factor between the state at time t and t+1 */
+  using FactorAdder = std::function<void(libRSF::FactorGraph &Graph, double Time)>;
+
+  struct BenchmarkCase
+  {
+    std::string Name;
+    libRSF::FactorType Type;
+    libRSF::DataType StateType;
+    FactorAdder AddFactor;
+  };
+
+  /** time the evaluation of all factors of one case, returns nanoseconds per residual block */
+  double RunCase(const BenchmarkCase &Case, const int FactorNumber, const int Repetitions, const bool ComputeJacobians)
+  {
+    libRSF::FactorGraph Graph;
+    for (int n = 0; n <= FactorNumber; ++n)
+    {
+      Graph.addState(STATE, Case.StateType, n);
+    }
+    for (int n = 0; n < FactorNumber; ++n)
+    {
+      Case.AddFactor(Graph, n);
+    }
+
+    /** warm up caches and the allocation of the buffers */
+    double Cost = Graph.evaluateFactors(Case.Type, ComputeJacobians);
+
+    libRSF::Timer Timer;
+    for (int n = 0; n < Repetitions; ++n)
+    {
+      Cost += Graph.evaluateFactors(Case.Type, ComputeJacobians);
+    }
+    const double Seconds = Timer.getSeconds();
+
+    /** keep the compiler from dropping the evaluation */
+    volatile double Sink = Cost;
+    (void)Sink;
+
+    return Seconds * 1e9 / (static_cast<double>(Repetitions) * FactorNumber);
+  }
+
+  template <int Dim>
+  libRSF::GaussianMixture<Dim> CreateMixture()
+  {
+    libRSF::GaussianComponent<Dim> Component;
+    libRSF::GaussianMixture<Dim> Mixture;
+    Component.setParamsStdDev(libRSF::VectorStatic<Dim>::Ones() * 0.1, libRSF::VectorStatic<Dim>::Zero(), libRSF::Vector1::Ones() * 0.8);
+    Mixture.addComponent(Component);
+    Component.setParamsStdDev(libRSF::VectorStatic<Dim>::Ones() * 5.0, libRSF::VectorStatic<Dim>::Zero(), libRSF::Vector1::Ones() * 0.2);
+    Mixture.addComponent(Component);
+    return Mixture;
+  }
+
+  template <int Dim>
+  libRSF::Data CreateMeasurement(const libRSF::DataType Type, const double Time)
+  {
+    libRSF::Data Measurement(Type, Time);
+    Measurement.setMean(libRSF::VectorStatic<Dim>::Constant(0.1));
+    return Measurement;
+  }
+
+  /** factors with one state (prior) or two states (between value) and a plain error model */
+  template <libRSF::FactorType Type, int Dim, typename ErrorType>
+  FactorAdder MakeAdder(const ErrorType &Model, const libRSF::DataType MeasurementType, const bool IsBinary)
+  {
+    return [Model, MeasurementType, IsBinary](libRSF::FactorGraph &Graph, const double Time)
+    {
+      ErrorType Error = Model;
+      const libRSF::Data Measurement = CreateMeasurement<Dim>(MeasurementType, Time);
+      if (IsBinary)
+      {
+        Graph.addFactor<Type>(libRSF::StateID(STATE, Time), libRSF::StateID(STATE, Time + 1), Measurement, Error, false);
+      }
+      else
+      {
+        Graph.addFactor<Type>(libRSF::StateID(STATE, Time), Measurement, Error, false);
+      }
+    };
+  }
+
+  /** the same with a robust loss function */
+  template <libRSF::FactorType Type, int Dim, typename ErrorType>
+  FactorAdder MakeLossAdder(const ErrorType &Model, const double LossParam, const libRSF::DataType MeasurementType, const bool IsBinary)
+  {
+    return [Model, LossParam, MeasurementType, IsBinary](libRSF::FactorGraph &Graph, const double Time)
+    {
+      ErrorType Error = Model;
+      const libRSF::Data Measurement = CreateMeasurement<Dim>(MeasurementType, Time);
+      if (IsBinary)
+      {
+        Graph.addFactor<Type>(libRSF::StateID(STATE, Time), libRSF::StateID(STATE, Time + 1), Measurement, Error, new libRSF::DCSLoss(LossParam), false);
+      }
+      else
+      {
+        Graph.addFactor<Type>(libRSF::StateID(STATE, Time), Measurement, Error, new libRSF::DCSLoss(LossParam), false);
+      }
+    };
+  }
+
+  /** error models that estimate an additional state per factor (switch or covariance) */
+  template <libRSF::FactorType Type, int Dim, typename ErrorType>
+  FactorAdder MakeAuxAdder(const ErrorType &Model, const libRSF::DataType AuxType, const double AuxValue,
+                           const libRSF::DataType MeasurementType, const bool IsBinary)
+  {
+    return [Model, AuxType, AuxValue, MeasurementType, IsBinary](libRSF::FactorGraph &Graph, const double Time)
+    {
+      ErrorType Error = Model;
+      const libRSF::Data Measurement = CreateMeasurement<Dim>(MeasurementType, Time);
+
+      Graph.addState(AUX_STATE, AuxType, Time);
+      Graph.getStateData().getElement(AUX_STATE, Time).setMean(libRSF::Vector1::Constant(AuxValue));
+
+      if (IsBinary)
+      {
+        Graph.addFactor<Type>(libRSF::StateID(STATE, Time), libRSF::StateID(STATE, Time + 1), libRSF::StateID(AUX_STATE, Time), Measurement, Error, false);
+      }
+      else
+      {
+        Graph.addFactor<Type>(libRSF::StateID(STATE, Time), libRSF::StateID(AUX_STATE, Time), Measurement, Error, false);
+      }
+    };
+  }
+
+  /** all error models for one-dimensional factors */
+  template <libRSF::FactorType Type>
+  void AddCases1D(std::vector<BenchmarkCase> &Cases, const std::string &FactorName, const bool IsBinary)
+  {
+    constexpr libRSF::DataType StateType = libRSF::DataType::Point1;
+    libRSF::GaussianDiagonal<1> Gaussian;
+    Gaussian.setStdDevSharedDiagonal(1.0);
+    const libRSF::GaussianMixture<1> Mixture = CreateMixture<1>();
+
+    Cases.push_back({FactorName + "/GaussianDiagonal", Type, StateType, MakeAdder<Type, 1>(Gaussian, StateType, IsBinary)});
+    Cases.push_back({FactorName + "/MaxMix1", Type, StateType, MakeAdder<Type, 1>(libRSF::MaxMix1(Mixture), StateType, IsBinary)});
+    Cases.push_back({FactorName + "/SumMix1", Type, StateType, MakeAdder<Type, 1>(libRSF::SumMix1(Mixture), StateType, IsBinary)});
+    Cases.push_back({FactorName + "/MaxSumMix1", Type, StateType, MakeAdder<Type, 1>(libRSF::MaxSumMix1(Mixture), StateType, IsBinary)});
+    Cases.push_back({FactorName + "/SC", Type, StateType,
+                     MakeAuxAdder<Type, 1>(libRSF::SwitchableConstraints<1, libRSF::GaussianDiagonal<1>>(Gaussian, 1.0),
+                                           libRSF::DataType::Switch, 1.0, StateType, IsBinary)});
+    Cases.push_back({FactorName + "/DCE", Type, StateType,
+                     MakeAuxAdder<Type, 1>(libRSF::DynamicCovarianceEstimation<1>(libRSF::Vector1::Ones()),
+                                           libRSF::DataType::Covariance1, 1.0, StateType, IsBinary)});
+    Cases.push_back({FactorName + "/DCS", Type, StateType, MakeLossAdder<Type, 1>(Gaussian, 1.0, StateType, IsBinary)});
+  }
+
+  /** Gaussian and max-mixture for two-dimensional factors */
+  template <libRSF::FactorType Type>
+  void AddCases2D(std::vector<BenchmarkCase> &Cases, const std::string &FactorName, const bool IsBinary)
+  {
+    constexpr libRSF::DataType StateType = libRSF::DataType::Point2;
+    libRSF::GaussianDiagonal<2> Gaussian;
+    Gaussian.setStdDevSharedDiagonal(1.0);
+
+    Cases.push_back({FactorName + "/GaussianDiagonal", Type, StateType, MakeAdder<Type, 2>(Gaussian, StateType, IsBinary)});
+    Cases.push_back({FactorName + "/MaxMix2", Type, StateType, MakeAdder<Type, 2>(libRSF::MaxMix2(CreateMixture<2>()), StateType, IsBinary)});
+    Cases.push_back({FactorName + "/DCS", Type, StateType, MakeLossAdder<Type, 2>(Gaussian, 1.0, StateType, IsBinary)});
+  }
+}
+
+int main(int ArgC, char** ArgV)
+{
+  google::InitGoogleLogging(ArgV[0]);
+
+  /** optional arguments: number of factors per case and repetitions */
+  const int FactorNumber = (ArgC > 1) ? std::stoi(ArgV[1]) : 10000;
+  const int Repetitions = (ArgC > 2) ? std::stoi(ArgV[2]) : 20;
+
+  std::vector<BenchmarkCase> Cases;
+  AddCases1D<libRSF::FactorType::Prior1>(Cases, "Prior1", false);
+  AddCases1D<libRSF::FactorType::BetweenValue1>(Cases, "BetweenValue1", true);
+  AddCases2D<libRSF::FactorType::Prior2>(Cases, "Prior2", false);
+  AddCases2D<libRSF::FactorType::BetweenValue2>(Cases, "BetweenValue2", true);
+
+  /** the angle prior is dominated by the normalization of its error */
+  libRSF::GaussianDiagonal<1> GaussianAngle;
+  GaussianAngle.setStdDevSharedDiagonal(1.0);
+  Cases.push_back({"PriorAngle/GaussianDiagonal", libRSF::FactorType::PriorAngle, libRSF::DataType::Angle,
+                   MakeAdder<libRSF::FactorType::PriorAngle, 1>(GaussianAngle, libRSF::DataType::Angle, false)});
+
+  std::cout << std::left << std::setw(36) << "Case"
+            << std::right << std::setw(16) << "Value [ns]"
+            << std::setw(16) << "Jacobian [ns]" << std::endl;
+
+  for (const BenchmarkCase &Case : Cases)
+  {
+    const double ValueTime = RunCase(Case, FactorNumber, Repetitions, false);
+    const double JacobianTime = RunCase(Case, FactorNumber, Repetitions, true);
+
+    std::cout << std::left << std::setw(36) << Case.Name
+              << std::right << std::fixed << std::setprecision(1)
+              << std::setw(16) << ValueTime
+              << std::setw(16) << JacobianTime << std::endl;
+  }
+
+  return 0;
+}
@@ -0,0 +1,178 @@
+/***************************************************************************
+ * libRSF - A Robust Sensor Fusion Library
+ *
+ * Copyright (C) 2018 Chair of Automation Technology / TU Chemnitz
+ * For more information see https://www.tu-chemnitz.de/etit/proaut/libRSF
+ *
+ * libRSF is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libRSF is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with libRSF.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Tim Pfeifer (tim.pfeifer@etit.tu-chemnitz.de)
+ ***************************************************************************/
+
+/**
+* @file Benchmark_Hash.cpp
+* @author Tim Pfeifer
+* @date 14.10.2026
+* @brief Microbenchmark of the bucket load of hashed factor and state IDs of a GNSS problem.
+* @copyright GNU Public License.
+*
+*/
+
+#include "libRSF.h"
+#include "Hash.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <unordered_set>
+
+namespace
+{
+  /** the former combination: XOR of shifted hashes */
+  size_t CombineXOR(const size_t H1, const size_t H2, const size_t H3)
+  {
+    return ((H1 ^ (H2 << 1)) >> 1) ^ (H3 << 1);
+  }
+
+  /** hash of the double timestamp with XOR combination, as before the integer ticks */
+  struct HashDoubleXOR
+  {
+    size_t operator()(const libRSF::FactorID &ID) const
+    {
+      return CombineXOR(std::hash<size_t>()(static_cast<size_t>(ID.ID)),
+                        std::hash<double>()(ID.getTimestamp()),
+                        std::hash<size_t>()(ID.Number));
+    }
+  };
+
+  /** integer ticks with XOR combination */
+  struct HashTickXOR
+  {
+    size_t operator()(const libRSF::FactorID &ID) const
+    {
+      return CombineXOR(std::hash<size_t>()(static_cast<size_t>(ID.ID)),
+                        std::hash<libRSF::TimeTick>()(ID.Tick),
+                        std::hash<size_t>()(ID.Number));
+    }
+  };
+
+  /** pseudorange factors of a daylong 1 Hz GNSS track with 6 to 14 satellites per epoch, plus the motion model */
+  std::vector<libRSF::FactorID> CreateGNSSFactors(const int Epochs)
+  {
+    std::vector<libRSF::FactorID> Factors;
+    const double TimeOfWeek = 345600.0;
+    for (int Epoch = 0; Epoch < Epochs; ++Epoch)
+    {
+      const double Time = TimeOfWeek + Epoch;
+      const int Satellites = 6 + (Epoch / 97) % 9;
+      for (int Sat = 0; Sat < Satellites; ++Sat)
+      {
+        Factors.emplace_back(libRSF::FactorType::Pseudorange3_ECEF, Time, Sat);
+      }
+      Factors.emplace_back(libRSF::FactorType::ConstVal1, Time, 0);
+      Factors.emplace_back(libRSF::FactorType::ConstVal3, Time, 0);
+    }
+    return Factors;
+  }
+
+  template <typename HashType>
+  void Evaluate(const std::string &Name, const std::vector<libRSF::FactorID> &Factors)
+  {
+    std::unordered_set<libRSF::FactorID, HashType> Set(Factors.begin(), Factors.end());
+
+    /** load of the occupied buckets and the expected chain length of a successful lookup */
+    size_t Used = 0;
+    size_t Longest = 0;
+    double Probes = 0;
+    for (size_t Bucket = 0; Bucket < Set.bucket_count(); ++Bucket)
+    {
+      const size_t Size = Set.bucket_size(Bucket);
+      Used += (Size > 0) ? 1 : 0;
+      Longest = std::max(Longest, Size);
+      Probes += 0.5 * static_cast<double>(Size * (Size + 1));
+    }
+    Probes /= static_cast<double>(Set.size());
+
+    /** distinct IDs with the same full hash value and the longest chain of a power-of-two table that uses the low bits */
+    std::vector<size_t> Hashes;
+    Hashes.reserve(Factors.size());
+    for (const libRSF::FactorID &ID : Factors)
+    {
+      Hashes.push_back(HashType()(ID));
+    }
+    size_t Mask = 1;
+    while (Mask < Factors.size())
+    {
+      Mask <<= 1;
+    }
+    std::vector<size_t> Slots(Mask, 0);
+    size_t LongestMasked = 0;
+    for (const size_t Hash : Hashes)
+    {
+      LongestMasked = std::max(LongestMasked, ++Slots[Hash & (Mask - 1)]);
+    }
+    std::sort(Hashes.begin(), Hashes.end());
+    const size_t Collisions = Hashes.size() - static_cast<size_t>(std::distance(Hashes.begin(), std::unique(Hashes.begin(), Hashes.end())));
+
+    /** lookups in random order, like the graph does when it resolves connected states */
+    std::vector<libRSF::FactorID> Queries(Factors);
+    std::shuffle(Queries.begin(), Queries.end(), std::mt19937(42));
+
+    const auto Start = std::chrono::steady_clock::now();
+    size_t Found = 0;
+    for (int Repetition = 0; Repetition < 10; ++Repetition)
+    {
+      for (const libRSF::FactorID &ID : Queries)
+      {
+        Found += Set.count(ID);
+      }
+    }
+    const double Time = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - Start).count()
+                        / static_cast<double>(10 * Factors.size());
+
+    std::cout << std::left << std::setw(20) << Name
+              << std::right << std::fixed << std::setprecision(3)
+              << std::setw(12) << static_cast<double>(Used) / static_cast<double>(Set.bucket_count())
+              << std::setw(12) << Longest
+              << std::setw(12) << Probes
+              << std::setw(12) << Collisions
+              << std::setw(12) << LongestMasked
+              << std::setprecision(1) << std::setw(14) << Time
+              << ((Found == 10 * Factors.size()) ? "" : "  (lookup failed!)") << std::endl;
+  }
+}
+
+int main(int ArgC, char** ArgV)
+{
+  /** optional argument: number of epochs */
+  const int Epochs = (ArgC > 1) ? std::stoi(ArgV[1]) : 86400;
+  const std::vector<libRSF::FactorID> Factors = CreateGNSSFactors(Epochs);
+
+  std::cout << Factors.size() << " factor IDs of " << Epochs << " GNSS epochs" << std::endl;
+  std::cout << std::left << std::setw(20) << "Hash"
+            << std::right << std::setw(12) << "Used"
+            << std::setw(12) << "Longest"
+            << std::setw(12) << "Probes"
+            << std::setw(12) << "Collisions"
+            << std::setw(12) << "Pow2 Chain"
+            << std::setw(14) << "Lookup [ns]" << std::endl;
+
+  Evaluate<HashDoubleXOR>("double + XOR", Factors);
+  Evaluate<HashTickXOR>("tick + XOR", Factors);
+  Evaluate<std::hash<libRSF::FactorID>>("tick + mixing", Factors);
+
+  return 0;
+}
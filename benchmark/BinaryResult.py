@@ -0,0 +1,76 @@
+#!/usr/bin/env python3
+
+# libRSF - A Robust Sensor Fusion Library
+#
+# Copyright (C) 2026 Chair of Automation Technology / TU Chemnitz
+# For more information see https://www.tu-chemnitz.de/etit/proaut/libRSF
+#
+# libRSF is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# libRSF is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with libRSF.  If not, see <http://www.gnu.org/licenses/>.
+#
+# Author: Tim Pfeifer (tim.pfeifer@etit.tu-chemnitz.de)
+
+"""Maps binary result files of libRSF (see WriteResultToBinaryFile) as numpy arrays without parsing or copying.
+
+Usage:
+    BinaryResult.py RESULT_FILE
+
+As a module, read_binary_result() returns a dict from state name to (type name, [objects x values] array).
+The first column of each array holds the timestamps.
+"""
+
+import sys
+
+import numpy as np
+
+MAGIC = b'RSFR'
+VERSION = 1
+
+
+def read_binary_result(file_name):
+    """Returns {state name: (type name, memory mapped [objects x values] array of float64)}."""
+    header = np.memmap(file_name, dtype=np.uint8, mode='r')
+    if bytes(header[0:4]) != MAGIC or int(header[4:8].view(np.uint32)[0]) != VERSION:
+        raise ValueError('Invalid header of binary result file: ' + file_name)
+
+    block_number = int(header[8:12].view(np.uint32)[0])
+    offset = 16
+    result = {}
+    for _ in range(block_number):
+        name_length, type_length, value_number, _ = header[offset:offset + 16].view(np.uint32)
+        object_number = int(header[offset + 16:offset + 24].view(np.uint64)[0])
+        offset += 24
+        name = bytes(header[offset:offset + name_length]).decode()
+        type_name = bytes(header[offset + name_length:offset + name_length + type_length]).decode()
+        offset += int(name_length + type_length)
+        offset += (8 - offset % 8) % 8
+
+        values = np.memmap(file_name, dtype=np.float64, mode='r', offset=offset,
+                           shape=(object_number, int(value_number)))
+        result[name] = (type_name, values)
+        offset += object_number * int(value_number) * 8
+    return result
+
+
+def main():
+    if len(sys.argv) != 2:
+        print(__doc__)
+        return 1
+
+    for name, (type_name, values) in read_binary_result(sys.argv[1]).items():
+        print('{}: {} objects of type {} with {} values'.format(name, values.shape[0], type_name, values.shape[1]))
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,243 @@
+#!/usr/bin/env python3
+
+# libRSF - A Robust Sensor Fusion Library
+#
+# Copyright (C) 2026 Chair of Automation Technology / TU Chemnitz
+# For more information see https://www.tu-chemnitz.de/etit/proaut/libRSF
+#
+# libRSF is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# libRSF is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with libRSF.  If not, see <http://www.gnu.org/licenses/>.
+#
+# Author: Tim Pfeifer (tim.pfeifer@etit.tu-chemnitz.de)
+
+"""Runs the applications of libRSF on the bundled datasets and reports the runtime as JSON.
+
+Usage:
+    RunDatasets.py run BUILD_DIR [-o REPORT] [-f FILTER] [-r REPETITIONS]
+    RunDatasets.py compare BASE_BUILD_DIR NEW_BUILD_DIR [-o REPORT] [-f FILTER] [-r REPETITIONS]
+    RunDatasets.py diff BASE_REPORT NEW_REPORT
+
+The script has to be called from the root of the repository, so that configs and datasets are found.
+"""
+
+import argparse
+import json
+import os
+import subprocess
+import sys
+import tempfile
+import time
+import zipfile
+
+# application, config and dataset prefix (without _Input.txt) of every benchmark case
+CASES = [
+    ("App_GNSS", "config/Default_GNSS.yaml", "datasets/smartLoc-RTKLIB/Berlin_Potsdamer_Platz_RTK"),
+    ("App_GNSS", "config/Default_GNSS.yaml", "datasets/smartLoc-RTKLIB/Berlin_Gendarmenmarkt_RTK"),
+    ("App_GNSS", "config/Default_GNSS.yaml", "datasets/smartLoc-RTKLIB/Frankfurt_Main_Tower_RTK"),
+    ("App_GNSS", "config/Default_GNSS.yaml", "datasets/smartLoc-RTKLIB/Frankfurt_Westend_Tower_RTK"),
+    ("App_GNSS", "config/Default_GNSS.yaml", "datasets/Chemnitz City/Chemnitz"),
+    ("App_GNSS", "config/Default_GNSS.yaml", "datasets/UrbanNav/UrbanNav_HK_Medium_Urban"),
+    ("App_GNSS", "config/Default_GNSS.yaml", "datasets/UrbanNav/UrbanNav_HK_Deep_Urban"),
+    ("App_GNSS", "config/Default_GNSS.yaml", "datasets/UrbanNav/UrbanNav_HK_Harsh_Urban_"),
+    ("App_GNSS", "config/Default_GNSS.yaml", "datasets/UrbanNav/UrbanNav_TK_Obaida"),
+    ("App_GNSS", "config/Default_GNSS.yaml", "datasets/UrbanNav/UrbanNav_TK_Shinjuku"),
+    ("App_Ranging_2D", "config/Default_Ranging.yaml", "datasets/Indoor UWB/Indoor_UWB"),
+    ("App_Ranging_2D", "config/Default_Ranging.yaml", "datasets/Ranging_Simulation/M3500_heavy-tailed"),
+    ("App_Ranging_2D", "config/Default_Ranging.yaml", "datasets/Ranging_Simulation/M3500_multimodal"),
+    ("App_Ranging_2D", "config/Default_Ranging.yaml", "datasets/Ranging_Simulation/M3500_skewed"),
+    ("App_Ranging_2D", "config/Default_Ranging.yaml", "datasets/Ranging_Simulation/W3500_heavy-tailed"),
+    ("App_Ranging_2D", "config/Default_Ranging.yaml", "datasets/Ranging_Simulation/W3500_multimodal"),
+    ("App_Ranging_2D", "config/Default_Ranging.yaml", "datasets/Ranging_Simulation/W3500_skewed"),
+    ("App_SLAM", "config/Default_SLAM_2D.yaml", "datasets/SLAM/Corridor"),
+    ("App_SLAM", "config/Default_SLAM_2D.yaml", "datasets/SLAM/Lecture_Hall"),
+]
+
+# order of the values of a "solver_summary" line, see DataType::IterationSummary in src/Types.cpp
+SUMMARY_FIELDS = ["Timestamp", "DurationTotal", "DurationSolver", "DurationCovariance", "DurationMarginal",
+                  "DurationAdaptive", "IterationSolver", "IterationAdaptive", "DeadlineMisses",
+                  "MemoryStates", "MemorySensors", "MemoryStructure", "MemoryFactors",
+                  "AllocationsPredict", "AllocationsMeasure", "AllocationsSolve", "AllocationsSave",
+                  "WindowLength"]
+
+# values that are summed over all summary lines, memory is reported as maximum
+SUMMED_FIELDS = SUMMARY_FIELDS[1:9] + SUMMARY_FIELDS[13:17]
+MAXIMUM_FIELDS = SUMMARY_FIELDS[9:13] + SUMMARY_FIELDS[17:]
+
+
+def case_name(case):
+    return case[0] + "/" + os.path.basename(case[2])
+
+
+def find_input(prefix, temp_dir):
+    """returns the input file of a dataset, zipped datasets are extracted to a temporary directory"""
+    input_file = prefix + "_Input.txt"
+    if os.path.isfile(input_file):
+        return input_file
+
+    archive = prefix + ".zip"
+    if os.path.isfile(archive):
+        member = os.path.basename(input_file)
+        with zipfile.ZipFile(archive) as zipped:
+            zipped.extract(member, temp_dir)
+        return os.path.join(temp_dir, member)
+
+    return None
+
+
+def parse_summary(output_file):
+    """sums up the per-phase durations and iterations of all solver_summary lines, keeps the peak of the memory"""
+    totals = {field: 0.0 for field in SUMMED_FIELDS + MAXIMUM_FIELDS}
+    lines = 0
+    with open(output_file) as output:
+        for line in output:
+            values = line.split()
+            if len(values) != len(SUMMARY_FIELDS) + 1 or values[0] != "solver_summary":
+                continue
+            for field, value in zip(SUMMARY_FIELDS, values[1:]):
+                if field in SUMMED_FIELDS:
+                    totals[field] += float(value)
+                elif field in MAXIMUM_FIELDS:
+                    totals[field] = max(totals[field], float(value))
+            lines += 1
+    totals["SummaryLines"] = lines
+    return totals
+
+
+def run_case(build_dir, case, temp_dir):
+    application, config, prefix = case
+    result = {"name": case_name(case), "application": application, "config": config, "dataset": prefix}
+
+    executable = os.path.join(build_dir, "applications", application)
+    input_file = find_input(prefix, temp_dir)
+    if not os.path.isfile(executable) or input_file is None:
+        result["status"] = "missing"
+        return result
+
+    output_file = os.path.join(temp_dir, application + "_Result.txt")
+    if os.path.exists(output_file):
+        os.remove(output_file)
+
+    # wait4 provides the resource usage of exactly this child
+    start = time.perf_counter()
+    process = subprocess.Popen([executable, config, input_file, output_file],
+                               stdout=subprocess.DEVNULL, stderr=subprocess.DEVNULL)
+    _, status, usage = os.wait4(process.pid, 0)
+    process.returncode = os.waitstatus_to_exitcode(status)
+    result["WallTime"] = time.perf_counter() - start
+
+    # ru_maxrss is given in kilobytes on Linux
+    result["PeakRSS_MB"] = usage.ru_maxrss / 1024.0
+
+    if process.returncode != 0 or not os.path.isfile(output_file):
+        result["status"] = "failed"
+        return result
+
+    result.update(parse_summary(output_file))
+    result["status"] = "ok"
+    return result
+
+
+def run_build(build_dir, name_filter, repetitions):
+    """runs all cases and keeps the fastest repetition of each"""
+    results = []
+    with tempfile.TemporaryDirectory() as temp_dir:
+        for case in CASES:
+            if name_filter and name_filter not in case_name(case):
+                continue
+            best = None
+            for _ in range(repetitions):
+                current = run_case(build_dir, case, temp_dir)
+                if current["status"] != "ok":
+                    best = current
+                    break
+                if best is None or current["WallTime"] < best["WallTime"]:
+                    best = current
+            print("%-50s %s" % (best["name"], best["status"]), file=sys.stderr)
+            results.append(best)
+    return {"build": os.path.abspath(build_dir), "repetitions": repetitions, "cases": results}
+
+
+def compare_reports(base, new):
+    """relative change of the key metrics for every case that succeeded in both reports"""
+    base_cases = {case["name"]: case for case in base["cases"] if case["status"] == "ok"}
+    comparison = []
+    for case in new["cases"]:
+        if case["status"] != "ok" or case["name"] not in base_cases:
+            continue
+        old = base_cases[case["name"]]
+        entry = {"name": case["name"]}
+        for metric in ["WallTime", "PeakRSS_MB", "DurationSolver", "IterationSolver"]:
+            entry[metric] = {"base": old[metric], "new": case[metric],
+                             "ratio": case[metric] / old[metric] if old[metric] > 0 else None}
+        comparison.append(entry)
+    return comparison
+
+
+def print_comparison(comparison, stream=sys.stdout):
+    print("%-50s %12s %12s %12s %12s" % ("Case", "WallTime", "PeakRSS", "Solver", "Iterations"), file=stream)
+    for entry in comparison:
+        ratios = []
+        for metric in ["WallTime", "PeakRSS_MB", "DurationSolver", "IterationSolver"]:
+            ratio = entry[metric]["ratio"]
+            ratios.append("%11.3fx" % ratio if ratio is not None else "%12s" % "-")
+        print("%-50s %s" % (entry["name"], " ".join(ratios)), file=stream)
+
+
+def write_report(report, output):
+    if output:
+        with open(output, "w") as file:
+            json.dump(report, file, indent=2)
+    else:
+        json.dump(report, sys.stdout, indent=2)
+        print()
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Benchmark the libRSF applications on the bundled datasets.")
+    commands = parser.add_subparsers(dest="command", required=True)
+
+    run = commands.add_parser("run", help="benchmark one build")
+    run.add_argument("build_dir")
+
+    compare = commands.add_parser("compare", help="benchmark two builds and compare them")
+    compare.add_argument("base_build_dir")
+    compare.add_argument("new_build_dir")
+
+    for command in [run, compare]:
+        command.add_argument("-o", "--output", help="JSON report, stdout if not given")
+        command.add_argument("-f", "--filter", help="only run cases whose name contains this string")
+        command.add_argument("-r", "--repetitions", type=int, default=1, help="repetitions per case, the fastest is kept")
+
+    diff = commands.add_parser("diff", help="compare two existing reports")
+    diff.add_argument("base_report")
+    diff.add_argument("new_report")
+
+    args = parser.parse_args()
+
+    if args.command == "run":
+        write_report(run_build(args.build_dir, args.filter, args.repetitions), args.output)
+    elif args.command == "compare":
+        base = run_build(args.base_build_dir, args.filter, args.repetitions)
+        new = run_build(args.new_build_dir, args.filter, args.repetitions)
+        comparison = compare_reports(base, new)
+        print_comparison(comparison, sys.stderr)
+        write_report({"base": base, "new": new, "comparison": comparison}, args.output)
+    else:
+        with open(args.base_report) as base_file, open(args.new_report) as new_file:
+            print_comparison(compare_reports(json.load(base_file), json.load(new_file)))
+
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
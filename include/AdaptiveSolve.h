@@ -0,0 +1,62 @@
+/***************************************************************************
+ * libRSF - A Robust Sensor Fusion Library
+ *
+ * Copyright (C) 2018 Chair of Automation Technology / TU Chemnitz
+ * For more information see https://www.tu-chemnitz.de/etit/proaut/libRSF
+ *
+ * libRSF is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libRSF is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with libRSF.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Tim Pfeifer (tim.pfeifer@etit.tu-chemnitz.de)
+ ***************************************************************************/
+
+/**
+ * @file AdaptiveSolve.h
+ * @author Tim Pfeifer
+ * @date 14.10.2026
+ * @brief Alternating solve and adaption of error models with an increasing accuracy.
+ * @copyright GNU Public License.
+ *
+ */
+
+#ifndef ADAPTIVESOLVE_H
+#define ADAPTIVESOLVE_H
+
+#include "FactorGraph.h"
+#include "FactorGraphConfig.h"
+
+#include <functional>
+
+namespace libRSF
+{
+  /** \brief Alternates Adapt() and a solve until the solution does not move anymore.
+   *
+   * The error model changes after each solve, so the first rounds are solved with a relaxed tolerance
+   * and fewer iterations. Both are tightened geometrically towards the given options. A round that
+   * converges with relaxed options is followed by one with the full options, so the returned solution
+   * always has the full accuracy. Returns the number of rounds.
+   */
+  int SolveAdaptive(FactorGraph &Graph,
+                    const ceres::Solver::Options &Options,
+                    int Rounds,
+                    double RelaxedTolerance,
+                    int RelaxedIterations,
+                    const std::function<bool()> &Adapt);
+
+  /** uses the schedule of Config.Solution */
+  int SolveAdaptive(FactorGraph &Graph,
+                    const FactorGraphConfig &Config,
+                    const std::function<bool()> &Adapt);
+}
+
+#endif // ADAPTIVESOLVE_H
@@ -0,0 +1,62 @@
+/***************************************************************************
+ * libRSF - A Robust Sensor Fusion Library
+ *
+ * Copyright (C) 2019 Chair of Automation Technology / TU Chemnitz
+ * For more information see https://www.tu-chemnitz.de/etit/proaut/libRSF
+ *
+ * libRSF is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libRSF is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with libRSF.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Tim Pfeifer (tim.pfeifer@etit.tu-chemnitz.de)
+ ***************************************************************************/
+
+/**
+ * @file AllocationTracking.h
+ * @author Tim Pfeifer
+ * @date 14.10.2026
+ * @brief Optional counting of heap allocations to audit the processing loop.
+ * @copyright GNU Public License.
+ *
+ */
+
+#ifndef ALLOCATIONTRACKING_H
+#define ALLOCATIONTRACKING_H
+
+#include <cstdint>
+
+namespace libRSF
+{
+  /** true if the global allocation functions are replaced, which requires LIBRSF_ALLOCATION_TRACKING */
+  bool IsAllocationTrackingEnabled();
+
+  /** number of heap allocations of all threads since program start, always zero without tracking */
+  std::uint64_t GetAllocationCount();
+
+  /** counts the heap allocations during its lifetime */
+  class AllocationScope
+  {
+    public:
+      AllocationScope();
+
+      AllocationScope(const AllocationScope&) = delete;
+      AllocationScope& operator=(const AllocationScope&) = delete;
+
+      /** allocations since construction */
+      [[nodiscard]] std::uint64_t getCount() const;
+
+    private:
+      std::uint64_t Begin_;
+  };
+}
+
+#endif // ALLOCATIONTRACKING_H
@@ -0,0 +1,142 @@
+/***************************************************************************
+ * libRSF - A Robust Sensor Fusion Library
+ *
+ * Copyright (C) 2018 Chair of Automation Technology / TU Chemnitz
+ * For more information see https://www.tu-chemnitz.de/etit/proaut/libRSF
+ *
+ * libRSF is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libRSF is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with libRSF.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Tim Pfeifer (tim.pfeifer@etit.tu-chemnitz.de)
+ ***************************************************************************/
+
+/**
+ * @file AsyncPreintegrator.h
+ * @author Tim Pfeifer
+ * @date 14.10.2026
+ * @brief Pre-integrates a high-rate IMU stream in a background thread.
+ * @copyright GNU Public License.
+ *
+ */
+
+#ifndef ASYNCPREINTEGRATOR_H
+#define ASYNCPREINTEGRATOR_H
+
+#include "RingBuffer.h"
+#include "geometric_models/IMUPreintegrator.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace libRSF
+{
+  /** \brief IMU pre-integration as separate pipeline stage.
+   *
+   * The sensor thread queues raw samples and closes intervals at keyframe boundaries.
+   * The integration thread pre-integrates each sample on arrival, so closing an interval only finishes the last step.
+   * Finished intervals are handed to the graph thread through a second lock-free queue, in temporal order.
+   * Bias estimates of the solver can be fed back from any thread, they are used from the next sample on.
+   */
+  class AsyncPreintegrator
+  {
+    public:
+      AsyncPreintegrator(const Vector3 &BiasAcc, const Vector3 &BiasTR,
+                         double NoiseDensityAcc, double NoiseDensityGyro,
+                         double RandomWalkAcc, double RandomWalkGyro,
+                         double StartTime,
+                         double RelinearizationThreshold = 0.0,
+                         size_t QueueCapacity = 4096);
+      ~AsyncPreintegrator();
+
+      AsyncPreintegrator(const AsyncPreintegrator&) = delete;
+      AsyncPreintegrator& operator=(const AsyncPreintegrator&) = delete;
+
+      /** sensor thread interface, returns false if the queue is full */
+      bool addMeasurement(const Data &IMUMeasurement);
+      bool addMeasurement(double Timestamp,
+                          const Vector3 &Acceleration, const Vector3 &TurnRate,
+                          const Vector3 &AccelerationCov, const Vector3 &TurnRateCov);
+
+      /** the interval (last boundary, Timestamp] is finished in the background, waits while the queue is full */
+      void closeInterval(double Timestamp);
+
+      /** graph thread interface, returns false if no finished interval is available */
+      bool getResult(PreintegratedIMUResult &Result);
+
+      /** waits until the next interval is finished, returns false if the thread was stopped before */
+      bool waitForResult(PreintegratedIMUResult &Result);
+
+      /** new linearization point, the open interval is re-integrated if the change exceeds the threshold */
+      void updateBias(const Vector3 &BiasAcc, const Vector3 &BiasTR);
+
+      /** process all queued samples and stop the integration thread */
+      void finish();
+
+      [[nodiscard]] int countIntervals() const;
+
+    private:
+      struct Event
+      {
+        double Timestamp = 0.0;
+        Vector3 Acceleration;
+        Vector3 TurnRate;
+        Vector3 AccelerationCov;
+        Vector3 TurnRateCov;
+        bool IsBoundary = false;
+      };
+
+      /** the integration thread */
+      void process_();
+      void processBoundary_(double Timestamp);
+      void applyBias_();
+
+      /** noise parameters */
+      const double NoiseDensityAcc_;
+      const double NoiseDensityGyro_;
+      const double RandomWalkAcc_;
+      const double RandomWalkGyro_;
+      const double RelinearizationThreshold_;
+
+      /** owned by the integration thread */
+      std::unique_ptr<IMUPreintegrator> Preintegrator_;
+      Vector3 BiasAcc_;
+      Vector3 BiasTR_;
+      double IntervalStart_;
+      size_t IntervalSamples_ = 0;
+      Event LastSample_;
+      bool HasSample_ = false;
+
+      /** bias feedback from the solver */
+      std::mutex BiasMutex_;
+      Vector3 NewBiasAcc_;
+      Vector3 NewBiasTR_;
+      std::atomic<bool> HasNewBias_{false};
+
+      RingBuffer<Event> Samples_;
+      RingBuffer<PreintegratedIMUResult> Results_;
+
+      std::atomic<int> Intervals_{0};
+      std::atomic<bool> Stop_{false};
+      std::atomic<bool> Stopped_{false};
+
+      std::mutex Mutex_;
+      std::condition_variable Condition_;
+      std::condition_variable ResultCondition_;
+      std::thread Worker_;
+  };
+}
+
+#endif // ASYNCPREINTEGRATOR_H
@@ -0,0 +1,118 @@
+/***************************************************************************
+ * libRSF - A Robust Sensor Fusion Library
+ *
+ * Copyright (C) 2018 Chair of Automation Technology / TU Chemnitz
+ * For more information see https://www.tu-chemnitz.de/etit/proaut/libRSF
+ *
+ * libRSF is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libRSF is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with libRSF.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Tim Pfeifer (tim.pfeifer@etit.tu-chemnitz.de)
+ ***************************************************************************/
+
+/**
+ * @file AsyncSolver.h
+ * @author Tim Pfeifer
+ * @date 14.10.2026
+ * @brief Solves a factor graph in a background thread while new measurements arrive.
+ * @copyright GNU Public License.
+ *
+ */
+
+#ifndef ASYNCSOLVER_H
+#define ASYNCSOLVER_H
+
+#include "FactorGraph.h"
+#include "RingBuffer.h"
+#include "SensorDataSet.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <limits>
+#include <mutex>
+#include <thread>
+
+namespace libRSF
+{
+  /** \brief Asynchronous front-end of a factor graph.
+   *
+   * One sensor thread queues measurements and closes epochs without waiting for the optimizer.
+   * The solver thread stages the queued measurements and applies them between two solutions,
+   * so the graph is only touched by the solver thread while it runs.
+   */
+  class AsyncSolver
+  {
+    public:
+      /** adds factors for the measurements of (TimeOld, TimeNow] and solves, TimeOld is lowest() for the first epoch */
+      using EpochFunction = std::function<void(FactorGraph &Graph, const SensorDataSet &Measurements, double TimeOld, double TimeNow)>;
+
+      /** receives the graph after each epoch, e.g. to publish the estimate */
+      using ResultFunction = std::function<void(const FactorGraph &Graph, double TimeNow)>;
+
+      AsyncSolver(FactorGraph &Graph, EpochFunction Epoch, ResultFunction Result = nullptr, size_t QueueCapacity = 4096);
+      ~AsyncSolver();
+
+      AsyncSolver(const AsyncSolver&) = delete;
+      AsyncSolver& operator=(const AsyncSolver&) = delete;
+
+      /** sensor thread interface, returns false if the queue is full */
+      bool addMeasurement(const Data &Measurement);
+
+      /** waits while the queue is full */
+      void addMeasurements(const SensorDataSet &Measurements);
+
+      /** all measurements up to Timestamp are queued, the epoch is solved in the background */
+      void closeEpoch(double Timestamp);
+
+      /** wait until all queued epochs are processed and stop the solver thread */
+      void finish();
+
+      [[nodiscard]] int countProcessedEpochs() const;
+
+    private:
+      struct Event
+      {
+        Data Measurement;
+        double Timestamp = 0.0;
+        bool IsEpoch = false;
+      };
+
+      /** waits until the event fits into the queue */
+      void push_(Event &&Object);
+
+      /** the solver thread */
+      void process_();
+      void processEpoch_(double TimeNow);
+
+      FactorGraph &Graph_;
+      EpochFunction Epoch_;
+      ResultFunction Result_;
+
+      RingBuffer<Event> Queue_;
+
+      /** double buffered measurements, new ones are staged until the next epoch starts */
+      SensorDataSet Staged_;
+      SensorDataSet Active_;
+      double TimeOld_ = std::numeric_limits<double>::lowest();
+
+      std::atomic<int> ProcessedEpochs_{0};
+      std::atomic<bool> Stop_{false};
+
+      std::mutex Mutex_;
+      std::condition_variable Condition_;
+      std::thread Worker_;
+  };
+}
+
+#endif // ASYNCSOLVER_H
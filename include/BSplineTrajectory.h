@@ -0,0 +1,88 @@
+/***************************************************************************
+ * libRSF - A Robust Sensor Fusion Library
+ *
+ * Copyright (C) 2018 Chair of Automation Technology / TU Chemnitz
+ * For more information see https://www.tu-chemnitz.de/etit/proaut/libRSF
+ *
+ * libRSF is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libRSF is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with libRSF.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Tim Pfeifer (tim.pfeifer@etit.tu-chemnitz.de)
+ ***************************************************************************/
+
+/**
+ * @file BSplineTrajectory.h
+ * @author Tim Pfeifer
+ * @date 14.10.2026
+ * @brief Control points of a continuous-time trajectory as states of a factor graph.
+ * @copyright GNU Public License.
+ *
+ */
+
+#ifndef BSPLINETRAJECTORY_H
+#define BSPLINETRAJECTORY_H
+
+#include "FactorGraph.h"
+#include "geometric_models/BSplineModel.h"
+
+namespace libRSF
+{
+  /** \brief Uniform cumulative cubic B-spline whose control points are states of a graph.
+   *
+   * The control point i has the timestamp TimeOrigin + i * KnotTime, a measurement at time t depends
+   * on the four control points of its segment. The number of states grows with the duration and the
+   * knot time, not with the rate of the measurements. An SE(3) trajectory is split into a position
+   * spline and a rotation spline on SO(3), which share their knots.
+   */
+  class BSplineTrajectory
+  {
+    public:
+      /** spline in R^n with states of ValueType, providing a rotation name adds quaternion control points */
+      BSplineTrajectory(FactorGraph &Graph,
+                        double TimeOrigin,
+                        double KnotTime,
+                        const StateKey &ValueName,
+                        DataType ValueType,
+                        const StateKey &RotationName = StateKey());
+      ~BSplineTrajectory() = default;
+
+      /** index of the segment that contains Time, its control points are Index - 1 ... Index + 2 */
+      [[nodiscard]] int getSegment(double Time) const;
+      [[nodiscard]] double getKnotTime(int Index) const;
+
+      /** add the missing control points for Time and return the states for a spline factor,
+       *  first the values and then the rotations */
+      StateList addSegment(double Time);
+
+      /** evaluate the current estimate at an arbitrary time, false if control points are missing */
+      bool evaluate(double Time, Vector &Value) const;
+      bool evaluate(double Time, Vector &Value, Quaternion &Rotation) const;
+
+      [[nodiscard]] bool hasRotation() const;
+
+    private:
+      /** new control points start at the previous one, rotations at the identity otherwise */
+      void addControlPoint_(const StateKey &Name, DataType Type, int Index);
+
+      bool getControlPoints_(const StateKey &Name, int Segment, std::vector<Vector> &Points) const;
+
+      FactorGraph &Graph_;
+      double TimeOrigin_;
+      double KnotTime_;
+      StateKey ValueName_;
+      DataType ValueType_;
+      StateKey RotationName_;
+  };
+}
+
+#endif // BSPLINETRAJECTORY_H
@@ -0,0 +1,91 @@
+/***************************************************************************
+ * libRSF - A Robust Sensor Fusion Library
+ *
+ * Copyright (C) 2018 Chair of Automation Technology / TU Chemnitz
+ * For more information see https://www.tu-chemnitz.de/etit/proaut/libRSF
+ *
+ * libRSF is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libRSF is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with libRSF.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Tim Pfeifer (tim.pfeifer@etit.tu-chemnitz.de)
+ ***************************************************************************/
+
+/**
+ * @file BackendSelection.h
+ * @author Tim Pfeifer
+ * @date 14.10.2026
+ * @brief Benchmark of the available sparse linear algebra backends on the current problem.
+ * @copyright GNU Public License.
+ *
+ */
+
+#ifndef BACKENDSELECTION_H
+#define BACKENDSELECTION_H
+
+#include <ceres/ceres.h>
+#include <ceres/version.h>
+
+#include <string>
+#include <vector>
+
+/** the fill-reducing ordering is selectable since ceres 2.1 */
+#if CERES_VERSION_MAJOR > 2 || (CERES_VERSION_MAJOR == 2 && CERES_VERSION_MINOR >= 1)
+  #define LIBRSF_CERES_ORDERING_TYPE
+#endif
+
+namespace libRSF
+{
+  /** one combination of linear solver, sparse library and fill-reducing ordering */
+  struct LinearBackend
+  {
+    ceres::LinearSolverType LinearSolver = ceres::SPARSE_NORMAL_CHOLESKY;
+    ceres::SparseLinearAlgebraLibraryType Library = ceres::SUITE_SPARSE;
+#ifdef LIBRSF_CERES_ORDERING_TYPE
+    ceres::LinearSolverOrderingType Ordering = ceres::AMD;
+#endif
+
+    /** with an explicit elimination ordering, the linear solver of the options is kept */
+    void apply(ceres::Solver::Options &Options) const;
+
+    [[nodiscard]] std::string getName() const;
+  };
+
+  /** graphs of the same class are expected to prefer the same backend */
+  struct GraphStructureClass
+  {
+    bool HasLandmarks = false;
+    bool HasMarginals = false;
+    int SizeClass = 0;              /**< log2 of the number of factors */
+
+    bool operator<(const GraphStructureClass &Other) const;
+
+    [[nodiscard]] std::string getName() const;
+  };
+
+  /** all combinations that are compiled into ceres and valid with the given options, Schur complements only if there are landmarks */
+  std::vector<LinearBackend> GetLinearBackendCandidates(const ceres::Solver::Options &Options, bool HasLandmarks);
+
+  /** solve with each candidate for a few iterations and restore all parameters afterwards,
+   *  false if no candidate produced a usable solution */
+  bool BenchmarkLinearBackends(ceres::Problem &Problem,
+                               const ceres::Solver::Options &Options,
+                               const std::vector<LinearBackend> &Candidates,
+                               int Iterations,
+                               LinearBackend &Best);
+
+  /** choices are shared by all graphs of the process, so a batch run benchmarks each class only once */
+  bool LookupLinearBackend(const GraphStructureClass &Class, LinearBackend &Backend);
+  void StoreLinearBackend(const GraphStructureClass &Class, const LinearBackend &Backend);
+}
+
+#endif // BACKENDSELECTION_H
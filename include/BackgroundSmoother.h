@@ -0,0 +1,111 @@
+/***************************************************************************
+ * libRSF - A Robust Sensor Fusion Library
+ *
+ * Copyright (C) 2018 Chair of Automation Technology / TU Chemnitz
+ * For more information see https://www.tu-chemnitz.de/etit/proaut/libRSF
+ *
+ * libRSF is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libRSF is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with libRSF.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Tim Pfeifer (tim.pfeifer@etit.tu-chemnitz.de)
+ ***************************************************************************/
+
+/**
+ * @file BackgroundSmoother.h
+ * @author Tim Pfeifer
+ * @date 14.10.2026
+ * @brief A full smoother in a background thread that corrects a low-latency window or filter.
+ * @copyright GNU Public License.
+ *
+ */
+
+#ifndef BACKGROUNDSMOOTHER_H
+#define BACKGROUNDSMOOTHER_H
+
+#include "AsyncSolver.h"
+#include "FactorGraph.h"
+#include "StateDataSet.h"
+
+#include <limits>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace libRSF
+{
+  /** \brief Second graph that keeps every state and factor and is solved in the background.
+   *
+   * The foreground graph is a window or filter, that provides the estimate of each epoch with bounded latency.
+   * Both graphs are built from the same measurements by the same epoch function, but the smoother graph
+   * is only touched by its own thread. It is solved every SolveInterval epochs, afterwards the smoothed states
+   * of the last Horizon seconds are published and can be copied into the foreground graph as new linearization point.
+   */
+  class BackgroundSmoother
+  {
+    public:
+      /** Epoch only adds states and factors, the smoother solves the graph afterwards with Options */
+      BackgroundSmoother(const ceres::Solver::Options &Options,
+                         AsyncSolver::EpochFunction Epoch,
+                         std::vector<std::string> Names,
+                         double Horizon,
+                         int SolveInterval = 1,
+                         size_t QueueCapacity = 4096);
+      ~BackgroundSmoother() = default;
+
+      BackgroundSmoother(const BackgroundSmoother&) = delete;
+      BackgroundSmoother& operator=(const BackgroundSmoother&) = delete;
+
+      /** same interface as AsyncSolver */
+      void addMeasurements(const SensorDataSet &Measurements);
+      void closeEpoch(double Timestamp);
+
+      /** overwrite the states of Graph with the newest smoothed ones, returns the number of corrected states */
+      int correct(FactorGraph &Graph);
+
+      /** copy of the newest published states */
+      void getPublished(StateDataSet &States) const;
+
+      /** end of the newest published solution, lowest() if there is none */
+      [[nodiscard]] double getPublishedTime() const;
+
+      /** wait for the last epoch and solve the complete graph, afterwards getSmoother() holds the final smoothed trajectory */
+      void finish();
+      [[nodiscard]] FactorGraph &getSmoother();
+
+      [[nodiscard]] int countProcessedEpochs() const;
+
+    private:
+      /** called by the solver thread, which owns the smoother graph */
+      void publish_(double TimeNow);
+
+      ceres::Solver::Options Options_;
+      std::vector<std::string> Names_;
+      double Horizon_;
+      int SolveInterval_;
+      int Epochs_ = 0;
+
+      /** the published part of the smoothed solution */
+      mutable std::mutex Mutex_;
+      StateDataSet Published_;
+      double PublishedTime_ = std::numeric_limits<double>::lowest();
+      int PublishedVersion_ = 0;
+      int CorrectedVersion_ = 0;
+
+      /** the solver thread is joined before the graph is destroyed */
+      FactorGraph Graph_;
+      AsyncSolver Solver_;
+      bool IsFinished_ = false;
+  };
+}
+
+#endif // BACKGROUNDSMOOTHER_H
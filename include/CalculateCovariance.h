@@ -37,14 +37,43 @@
 #include "StateDataSet.h"
 #include "Messages.h"
 #include "Tensor.h"
+#include "ThreadPool.h"
 
 #include <ceres/ceres.h>
 
 #include <vector>
-#include <thread>
 
 namespace libRSF
 {
+  /** @brief Adds J^T * J of one factor, linearized at the current estimate, to a dense information matrix.
+   *
+   * @param ceres::Problem& Graph The graph that contains the factor.
+   * @param ceres::ResidualBlockId Factor The factor that is linearized, its loss function is applied.
+   * @param std::vector<double*> States The variable states that span the information matrix.
+   * @param std::vector<int> Offsets Position of each state in the information matrix (local parametrization).
+   * @param Matrix& Information The information matrix that is updated.
+   * @return false if the factor is connected to a variable state that is not part of States.
+   *
+   */
+  bool AccumulateFactorInformation(ceres::Problem &Graph,
+                                   ceres::ResidualBlockId Factor,
+                                   const std::vector<double*> &States,
+                                   const std::vector<int> &Offsets,
+                                   Eigen::Ref<Matrix> Information);
+
+  /** @brief Calculates the Covariance of a state that belongs to a small isolated subsystem (e.g. a GNSS epoch without clock model) with a dense inverse.
+   *
+   * @param ceres::Problem& Graph The graph that contains the factors.
+   * @param double* State The state variable.
+   * @param double* Covariance The covariance in the global parametrization (row-major) is saved here!
+   * @return false if the subsystem is connected to more than MaxIsolatedSize local dimensions or not positive definite.
+   *
+   */
+  constexpr int MaxIsolatedSize = 8;
+  bool CalculateCovarianceIsolated(ceres::Problem &Graph,
+                                   double* State,
+                                   double* Covariance);
+
   /** @brief Calculates the Covariance of one datatype over a complete dataset.
    *
    * @param ceres::Problem& Graph The graph that contains the factors.
@@ -58,6 +87,29 @@ namespace libRSF
                            const std::string &Type);
 
 
+  /** cross-covariance between two states of different type at the same timestamp */
+  struct CrossCovariance
+  {
+    double Timestamp;
+    std::string Type1;
+    std::string Type2;
+    Matrix Covariance; /**< rows belong to Type1, cols to Type2 */
+  };
+
+  /** @brief Calculates the Covariance of multiple datatypes over a complete dataset with a single factorization.
+   *
+   * @param ceres::Problem& Graph The graph that contains the factors.
+   * @param libRSF::StateDataSet &States Struct that contains the data of the Graph. The Covariance is saved here!
+   * @param std::vector<std::string> Types Identifiers of the desired datatypes. (e.g. Position, Velocity...)
+   * @param std::vector<CrossCovariance>* CrossCovariances Optional output for the cross-covariances between types at the same timestamp.
+   * @return true if everything works fine.
+   *
+   */
+  bool CalculateCovariance(ceres::Problem &Graph,
+                           StateDataSet &States,
+                           const std::vector<std::string> &Types,
+                           std::vector<CrossCovariance>* CrossCovariances = nullptr);
+
   /** @brief Calculates the Covariance of one datatype for a specific timestamp.
    *
    * @param ceres::Problem& Graph The graph that contains the factors.
@@ -131,6 +183,87 @@ namespace libRSF
     return Hessian.completeOrthogonalDecomposition().pseudoInverse();
   }
 
+  /** \brief Fill a cost tensor in parallel. Only the factors connected to the state are evaluated.
+   *
+   * \param Indices Tensor indices of the points.
+   * \param Points State values that belong to the indices.
+   * \param CostGrid Tensor that receives the cost values.
+   *
+   */
+  template<int Dim, int Size>
+  void EvaluateCostTensor(ceres::Problem &Graph,
+                          double * const StatePointer,
+                          const VectorVectorSTL<Dim> &Indices,
+                          const VectorVectorSTL<Dynamic> &Points,
+                          Tensor<Dim, Size> &CostGrid,
+                          const int ThreadNumber = 0)
+  {
+    std::vector<double> Cost;
+    EvaluateCostSurfacePoints(Graph, StatePointer, Dim, Points, Cost, nullptr, nullptr, ThreadNumber);
+
+    for (int nPoint = 0; nPoint < static_cast<int>(Points.size()); nPoint++)
+    {
+      CostGrid.setLinear(Cost.at(nPoint), CostGrid.getLinearIndex(Indices.at(nPoint)));
+    }
+  }
+
+  /** \brief Create the grid points that are required to estimate the Hessian numerically.
+   *
+   * \param Mean Center of the grid.
+   * \param Delta Spacing of the grid points.
+   * \param Indices Tensor indices of the points.
+   * \param Points State values that belong to the indices.
+   *
+   */
+  template<int Dim>
+  void CreateSigmaPoints(const VectorStatic<Dim> &Mean,
+                         const VectorStatic<Dim> &Delta,
+                         VectorVectorSTL<Dim> &Indices,
+                         VectorVectorSTL<Dynamic> &Points)
+  {
+    /** add center point */
+    Indices.emplace_back(VectorStatic<Dim>::Ones());
+
+    /** add other points */
+    for (int nDim1 = 0; nDim1 < Dim; nDim1++)
+    {
+      VectorStatic<Dim> Index = VectorStatic<Dim>::Ones();
+
+      /** line for variance */
+      Index(nDim1) = 0;
+      Indices.emplace_back(Index);
+      Index(nDim1) = 2;
+      Indices.emplace_back(Index);
+
+      /** square for covariance */
+      for (int nDim2 = nDim1 + 1; nDim2 < Dim; nDim2++)
+      {
+        Index = VectorStatic<Dim>::Ones();
+
+        Index(nDim1) = 0;
+        Index(nDim2) = 0;
+        Indices.emplace_back(Index);
+
+        Index(nDim2) = 2;
+        Indices.emplace_back(Index);
+
+        Index(nDim1) = 2;
+        Index(nDim2) = 0;
+        Indices.emplace_back(Index);
+
+        Index(nDim2) = 2;
+        Indices.emplace_back(Index);
+      }
+    }
+
+    /** convert indexes to points */
+    for (const VectorStatic<Dim> &Index : Indices)
+    {
+      VectorStatic<Dim> Offset = (Index - VectorStatic<Dim>::Ones()).array() * Delta.array();
+      Points.emplace_back(Mean + Offset);
+    }
+  }
+
   /** @brief Calculates the Covariance of one datatype for a specific timestamp using the sigma point algorithm.
    *
    * @param ceres::Problem& Graph The graph that contains the factors.
@@ -161,59 +294,11 @@ namespace libRSF
       /** create the required evaluation points */
       VectorVectorSTL<Dim> Indices;
       VectorVectorSTL<Dynamic> Points;
+      CreateSigmaPoints<Dim>(Mean, Delta, Indices, Points);
 
-      /** add center point */
-      Indices.emplace_back(VectorStatic<Dim>::Ones());
-
-      /** add other points */
-      for (int nDim1 = 0; nDim1 < Dim; nDim1++)
-      {
-        VectorStatic<Dim> Index = VectorStatic<Dim>::Ones();
-
-        /** line for variance */
-        Index(nDim1) = 0;
-        Indices.emplace_back(Index);
-        Index(nDim1) = 2;
-        Indices.emplace_back(Index);
-
-        /** square for covariance */
-        for (int nDim2 = nDim1 + 1; nDim2 < Dim; nDim2++)
-        {
-          Index = VectorStatic<Dim>::Ones();
-
-          Index(nDim1) = 0;
-          Index(nDim2) = 0;
-          Indices.emplace_back(Index);
-
-          Index(nDim2) = 2;
-          Indices.emplace_back(Index);
-
-          Index(nDim1) = 2;
-          Index(nDim2) = 0;
-          Indices.emplace_back(Index);
-
-          Index(nDim2) = 2;
-          Indices.emplace_back(Index);
-        }
-      }
-
-      /** convert indexes to points */
-      for (const VectorStatic<Dim> &Index : Indices)
-      {
-        VectorStatic<Dim> Offset = (Index - VectorStatic<Dim>::Ones()).array() * Delta.array();
-        Points.emplace_back(Mean + Offset);
-      }
-
-      /** evaluate sigma points */
-      std::vector<double> Cost;
-      EvaluateCostSurfacePoints(Graph, StatePointer, Dim, Points, Cost);
-
-      /** parse them into a tensor */
+      /** evaluate sigma points into a tensor */
       Tensor<Dim, 3> CostTensor;
-      for (int nPoint = 0; nPoint < static_cast<int>(Points.size()); nPoint++)
-      {
-        CostTensor.set(Cost.at(nPoint), Indices.at(nPoint));
-      }
+      EvaluateCostTensor<Dim, 3>(Graph, StatePointer, Indices, Points, CostTensor);
 
       /** estimate covariance again */
       const MatrixStatic<Dim, Dim> Cov = NumericalCovariance<Dim>(CostTensor, Delta);
@@ -225,5 +310,51 @@ namespace libRSF
 
     return Success;
   }
+
+  /** \brief Refine the Hessian based covariance of a single state with sigma points.
+   *  Only the factors connected to the state are evaluated on a private copy, so different states can be refined in parallel.
+   *
+   * \param Graph The graph that contains the factors.
+   * \param State State with an initial covariance, that is overwritten.
+   *
+   */
+  template<int Dim>
+  void RefineCovarianceSigmaPoint(const ceres::Problem &Graph, Data &State)
+  {
+    const VectorStatic<Dim> Mean = State.getMean();
+    const MatrixStatic<Dim, Dim> StdDev = SquareRoot<Dim, double>(State.getCovarianceMatrix());
+    const VectorStatic<Dim> Delta = StdDev.diagonal();
+
+    VectorVectorSTL<Dim> Indices;
+    VectorVectorSTL<Dynamic> Points;
+    CreateSigmaPoints<Dim>(Mean, Delta, Indices, Points);
+
+    /** the cost of the other factors is constant and cancels out in the finite differences */
+    std::vector<double> Cost;
+    EvaluateLocalCostPoints(Graph, State.getMeanPointer(), Dim, Points, Cost);
+
+    Tensor<Dim, 3> CostTensor;
+    for (int nPoint = 0; nPoint < static_cast<int>(Points.size()); nPoint++)
+    {
+      CostTensor.setLinear(Cost.at(nPoint), CostTensor.getLinearIndex(Indices.at(nPoint)));
+    }
+
+    const MatrixStatic<Dim, Dim> Cov = NumericalCovariance<Dim>(CostTensor, Delta);
+    const VectorRefConst<double, Dim* Dim> CovVect(Cov.data());
+    State.setCovariance(CovVect);
+  }
+
+  /** @brief Sigma point covariances of many states. The initial covariances share one factorization,
+   *  the refinement runs in parallel with one state per task.
+   *
+   * @param ceres::Problem& Graph The graph that contains the factors.
+   * @param libRSF::StateDataSet &States Struct that contains the data of the Graph. The Covariances are saved here!
+   * @param std::vector<StateID> IDs States that should be processed.
+   * @return true if all covariances could be computed.
+   *
+   */
+  bool EstimateCovarianceSigmaPoints(ceres::Problem &Graph,
+                                     StateDataSet &States,
+                                     const std::vector<StateID> &IDs);
 }
 #endif // CALCULATECOVARIANCE_H
@@ -0,0 +1,172 @@
+/***************************************************************************
+ * libRSF - A Robust Sensor Fusion Library
+ *
+ * Copyright (C) 2018 Chair of Automation Technology / TU Chemnitz
+ * For more information see https://www.tu-chemnitz.de/etit/proaut/libRSF
+ *
+ * libRSF is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libRSF is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with libRSF.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Tim Pfeifer (tim.pfeifer@etit.tu-chemnitz.de)
+ ***************************************************************************/
+
+/**
+ * @file Checkpoint.h
+ * @author Tim Pfeifer
+ * @date 14.10.2026
+ * @brief Binary archive for checkpoints of a factor graph.
+ * @copyright GNU Public License.
+ *
+ */
+
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include "Data.h"
+#include "Messages.h"
+#include "StateDataSet.h"
+#include "VectorTypes.h"
+
+#include <cstdint>
+#include <cstring>
+#include <iosfwd>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace libRSF
+{
+  /** sequential writer, the content is collected in memory and written at once (native byte order) */
+  class CheckpointWriter
+  {
+    public:
+      CheckpointWriter() = default;
+      ~CheckpointWriter() = default;
+
+      template <typename T>
+      void write(const T &Value)
+      {
+        static_assert(std::is_trivially_copyable_v<T>, "Only trivial types can be written directly!");
+        const char * Bytes = reinterpret_cast<const char *>(&Value);
+        Buffer_.insert(Buffer_.end(), Bytes, Bytes + sizeof(T));
+      }
+
+      void writeString(const std::string &String);
+      void writeData(const Data &Object);
+      void writeStateID(const StateID &ID);
+
+      /** dimensions are stored to check them while reading */
+      template <typename Derived>
+      void writeMatrix(const Eigen::MatrixBase<Derived> &Matrix)
+      {
+        const typename Derived::PlainObject Plain = Matrix;
+        write(static_cast<int64_t>(Plain.rows()));
+        write(static_cast<int64_t>(Plain.cols()));
+        const char * Bytes = reinterpret_cast<const char *>(Plain.data());
+        Buffer_.insert(Buffer_.end(), Bytes, Bytes + Plain.size() * sizeof(double));
+      }
+
+      bool writeToFile(const std::string &Filename) const;
+
+      /** content of another writer, e.g. one that was filled tentatively */
+      void append(const CheckpointWriter &Other)
+      {
+        Buffer_.insert(Buffer_.end(), Other.Buffer_.begin(), Other.Buffer_.end());
+      }
+
+      /** append the collected bytes to an open stream and start with an empty buffer, e.g. for continuous traces */
+      bool flushToStream(std::ostream &Stream);
+
+      [[nodiscard]] size_t size() const
+      {
+        return Buffer_.size();
+      }
+
+    private:
+      std::vector<char> Buffer_;
+  };
+
+  /** sequential reader, every function returns false if the archive ends or does not fit */
+  class CheckpointReader
+  {
+    public:
+      CheckpointReader() = default;
+      ~CheckpointReader() = default;
+
+      bool readFromFile(const std::string &Filename);
+
+      template <typename T>
+      bool read(T &Value)
+      {
+        static_assert(std::is_trivially_copyable_v<T>, "Only trivial types can be read directly!");
+        return readBytes_(&Value, sizeof(T));
+      }
+
+      bool readString(std::string &String);
+      bool readData(Data &Object);
+      bool readStateID(StateID &ID);
+
+      /** fixed dimensions have to match, dynamic ones are resized */
+      template <typename MatrixType>
+      bool readMatrix(MatrixType &Matrix)
+      {
+        int64_t Rows = 0;
+        int64_t Cols = 0;
+        if (!read(Rows) || !read(Cols) || Rows < 0 || Cols < 0)
+        {
+          return false;
+        }
+        if ((MatrixType::RowsAtCompileTime != Dynamic && MatrixType::RowsAtCompileTime != Rows) ||
+            (MatrixType::ColsAtCompileTime != Dynamic && MatrixType::ColsAtCompileTime != Cols))
+        {
+          return false;
+        }
+
+        /** check the size against the remaining bytes before allocating, Rows * Cols may overflow */
+        const uint64_t MaxValues = getRemaining() / sizeof(double);
+        if (Cols > 0 && static_cast<uint64_t>(Rows) > MaxValues / static_cast<uint64_t>(Cols))
+        {
+          return false;
+        }
+        Matrix.resize(Rows, Cols);
+        return readBytes_(Matrix.data(), static_cast<size_t>(Rows * Cols) * sizeof(double));
+      }
+
+      [[nodiscard]] bool isAtEnd() const
+      {
+        return Position_ == Buffer_.size();
+      }
+
+      [[nodiscard]] size_t getRemaining() const
+      {
+        return Buffer_.size() - Position_;
+      }
+
+    private:
+      bool readBytes_(void * Target, size_t Bytes);
+
+      std::vector<char> Buffer_;
+      size_t Position_ = 0;
+  };
+
+  /** error models that can be stored in checkpoints provide serialize() and deserialize() */
+  template <typename ErrorType, typename = void>
+  struct HasCheckpointSupport : std::false_type {};
+
+  template <typename ErrorType>
+  struct HasCheckpointSupport<ErrorType, std::void_t<decltype(std::declval<const ErrorType &>().serialize(std::declval<CheckpointWriter &>())),
+                                                    decltype(std::declval<ErrorType &>().deserialize(std::declval<CheckpointReader &>()))>> : std::true_type {};
+}
+
+#endif // CHECKPOINT_H
@@ -47,6 +47,9 @@ namespace libRSF
 
   /** numerical constants */
   #define NAN_DOUBLE           std::numeric_limits<double>::signaling_NaN()
+
+  /** the local frame of the ECEF odometry is kept until its position moved by more than this [m], zero recomputes it in every evaluation */
+  #define ECEF_FRAME_REFRESH_DISTANCE 1.0
 }
 
 #endif // CONSTANTS_H
@@ -45,11 +45,26 @@ namespace libRSF
       Data();
       ~Data() override = default;
 
+      /** copy and move */
+      Data(const Data &) = default;
+      Data(Data &&) noexcept = default;
+      Data &operator=(const Data &) = default;
+      Data &operator=(Data &&) noexcept = default;
+
       /** default constructor for new empty data */
       Data(DataType Type, double Timestamp);
 
+      /** raw interface for binary files, Values has to follow the layout of Type */
+      Data(DataType Type, const double * Values, Index Size);
+
       /** string interface for files */
-      explicit Data(const std::string& Input);
+      explicit Data(std::string_view Input);
+
+      /** same, but a malformed line is returned in Error instead of being thrown, e.g. to skip it */
+      Data(std::string_view Input, std::string &Error);
+
+      /** turn an existing object into a new empty one, e.g. once per epoch, the buffer is reused if it is large enough */
+      void reset(DataType Type, double Timestamp);
 
       /** specific getters */
       [[nodiscard]] double getTimestamp() const;
@@ -58,7 +73,9 @@ namespace libRSF
       [[nodiscard]] Vector getCovarianceDiagonal() const;
       [[nodiscard]] Vector getStdDevDiagonal() const;
 
-      /** specific pointer getters */
+      /** specific pointer getters
+       *  the mean of a state is the parameter block of the graph, it is a view into the slot of this object in the slab of its type:
+       *  moving the object keeps the pointer valid, a copy has its own buffer that is unknown to the graph */
       double* getMeanPointer();
       double const * getMeanPointerConst();
 
@@ -73,6 +90,10 @@ namespace libRSF
     private:
 
   };
+
+  /** bulk construction of empty objects of one type, the type is resolved once */
+  std::vector<Data> CreateData(DataType Type, size_t Number, double Timestamp = 0.0);
+  std::vector<Data> CreateData(DataType Type, const std::vector<double> &Timestamps);
 }
 
 #endif // DATA_H
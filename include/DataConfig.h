@@ -32,12 +32,19 @@
 #ifndef DATACONFIG_H
 #define DATACONFIG_H
 
-#include <map>
-#include <vector>
+#include "ParameterSlab.h"
+
+#include <algorithm>
+#include <cstdint>
 #include <string>
+#include <string_view>
+#include <vector>
 
 namespace libRSF
 {
+  /** configuration of all data types, stored in flat tables that are indexed by the type enum
+   *  - names are resolved by a perfect hash, so parsing a file needs one hash and one comparison per line
+   *  - the tables are not modified after construction, so pointers to names and layouts stay valid */
   template<typename TypeEnum, typename ElementEnum>
   class DataConfig
   {
@@ -53,60 +60,214 @@ namespace libRSF
       };
       using InitVect = std::vector<InitType>;
 
+      /** precomputed memory layout of one type, indexed by the numeric element value */
+      struct LayoutType
+      {
+        std::vector<int> Offset; /**< -1 marks elements that are not part of the type */
+        std::vector<int> Size;
+        int TotalSize = 0;
+
+        /** zero initialized buffer, new objects of the type start as a copy of it */
+        std::vector<double> Prototype;
+
+        /** contiguous storage for objects of the type that are parameter blocks, see DataGeneric::placeInSlab() */
+        std::shared_ptr<ParameterSlab> Slab;
+
+        [[nodiscard]] bool hasElement(const ElementEnum Element) const
+        {
+          const auto Idx = static_cast<size_t>(Element);
+          return (Idx < Offset.size() && Offset[Idx] >= 0);
+        }
+      };
+
       /** disable the default constructor construction */
       DataConfig() = delete;
 
       /** enforce advanced initialization */
       explicit DataConfig(InitVect InitialConfig)
       {
+        size_t MaxIdx = 0;
+        for (const InitType &Init : InitialConfig)
+        {
+          MaxIdx = std::max(MaxIdx, static_cast<size_t>(Init.Type));
+        }
+        Entries_.resize(MaxIdx + 1);
+
         for (InitType &Init : InitialConfig)
         {
-          TypeMap_.emplace(Init.Type, Init.Elements);
-          NameTypeMap_.emplace(Init.Name, Init.Type);
-          TypeNameMap_.emplace(Init.Type, Init.Name);
+          EntryType &Entry = Entries_[static_cast<size_t>(Init.Type)];
+          Entry.IsValid = true;
+          Entry.Type = Init.Type;
+          Entry.Name = std::move(Init.Name);
+          Entry.Layout = createLayout_(Init.Elements);
+          Entry.Elements = std::move(Init.Elements);
         }
+
+        createNameTable_();
       }
 
       /** destruction */
       virtual ~DataConfig() = default;
 
       /** query string */
-      std::string getName(TypeEnum Type) const
+      const std::string &getName(TypeEnum Type) const
       {
-        return TypeNameMap_.at(Type);
+        return Entries_.at(static_cast<size_t>(Type)).Name;
       }
 
-      TypeEnum getType(std::string Name) const
+      TypeEnum getType(const std::string_view Name) const
       {
-        return NameTypeMap_.at(Name);
+        return Entries_.at(findName_(Name)).Type;
       }
 
       /** check type or string */
-      [[nodiscard]] bool checkName(std::string Name) const
+      [[nodiscard]] bool checkName(const std::string_view Name) const
       {
-        return (NameTypeMap_.count(Name) > 0);
+        return (findName_(Name) < Entries_.size());
       }
 
       bool checkType(TypeEnum Type) const
       {
-        return (TypeNameMap_.count(Type) > 0);
+        const auto Idx = static_cast<size_t>(Type);
+        return (Idx < Entries_.size() && Entries_[Idx].IsValid);
       }
 
       /** query config */
-      const ConfigType &getConfig(std::string ID) const
+      const ConfigType &getConfig(const std::string_view ID) const
       {
-        return TypeMap_.at(NameTypeMap_.at(ID));
+        return Entries_.at(findName_(ID)).Elements;
       }
 
       const ConfigType &getConfig(TypeEnum Type) const
       {
-        return TypeMap_.at(Type);
+        return Entries_.at(static_cast<size_t>(Type)).Elements;
+      }
+
+      const LayoutType &getLayout(TypeEnum Type) const
+      {
+        return Entries_.at(static_cast<size_t>(Type)).Layout;
+      }
+
+      /** name and layout with a single lookup, both stay untouched for unknown types */
+      bool findType(TypeEnum Type, const std::string* &Name, const LayoutType* &Layout) const
+      {
+        if (!this->checkType(Type))
+        {
+          return false;
+        }
+        const EntryType &Entry = Entries_[static_cast<size_t>(Type)];
+        Name = &Entry.Name;
+        Layout = &Entry.Layout;
+        return true;
       }
 
     private:
-      std::map<std::string, TypeEnum> NameTypeMap_;
-      std::map<TypeEnum, std::string> TypeNameMap_;
-      std::map<TypeEnum, ConfigType> TypeMap_;
+      struct EntryType
+      {
+        bool IsValid = false;
+        TypeEnum Type {};
+        std::string Name;
+        ConfigType Elements;
+        LayoutType Layout;
+      };
+
+      /** place all elements of a type consecutively in one buffer */
+      static LayoutType createLayout_(const ConfigType &Elements)
+      {
+        LayoutType Layout;
+
+        size_t MaxIdx = 0;
+        for (const auto &Element : Elements)
+        {
+          MaxIdx = std::max(MaxIdx, static_cast<size_t>(Element.first));
+        }
+        Layout.Offset.assign(MaxIdx + 1, -1);
+        Layout.Size.assign(MaxIdx + 1, 0);
+
+        for (const auto &Element : Elements)
+        {
+          const auto Idx = static_cast<size_t>(Element.first);
+          Layout.Offset[Idx] = Layout.TotalSize;
+          Layout.Size[Idx] = Element.second;
+          Layout.TotalSize += Element.second;
+        }
+        Layout.Prototype.assign(static_cast<size_t>(Layout.TotalSize), 0.0);
+        Layout.Slab = std::make_shared<ParameterSlab>(static_cast<size_t>(Layout.TotalSize));
+
+        return Layout;
+      }
+
+      /** seeded FNV-1a */
+      static uint64_t hashName_(const std::string_view Name, const uint64_t Seed)
+      {
+        uint64_t Hash = 14695981039346656037ULL ^ (Seed * 0x9E3779B97F4A7C15ULL);
+        for (const char Character : Name)
+        {
+          Hash ^= static_cast<unsigned char>(Character);
+          Hash *= 1099511628211ULL;
+        }
+        return Hash ^ (Hash >> 32);
+      }
+
+      /** search a seed that maps every name to its own slot, the table grows if no seed is found */
+      void createNameTable_()
+      {
+        size_t Names = 0;
+        for (const EntryType &Entry : Entries_)
+        {
+          Names += Entry.IsValid ? 1 : 0;
+        }
+
+        size_t TableSize = 1;
+        while (TableSize < 2 * Names)
+        {
+          TableSize <<= 1;
+        }
+
+        constexpr uint64_t SeedsPerSize = 1000;
+        while (true)
+        {
+          for (uint64_t Seed = 0; Seed < SeedsPerSize; ++Seed)
+          {
+            NameTable_.assign(TableSize, Entries_.size());
+            bool IsPerfect = true;
+            for (size_t Idx = 0; Idx < Entries_.size() && IsPerfect; ++Idx)
+            {
+              if (!Entries_[Idx].IsValid)
+              {
+                continue;
+              }
+              size_t &Slot = NameTable_[hashName_(Entries_[Idx].Name, Seed) & (TableSize - 1)];
+
+              /** like std::map::emplace, the first of two equal names is kept */
+              if (Slot < Entries_.size() && Entries_[Slot].Name == Entries_[Idx].Name)
+              {
+                continue;
+              }
+              IsPerfect = (Slot == Entries_.size());
+              Slot = Idx;
+            }
+
+            if (IsPerfect)
+            {
+              NameSeed_ = Seed;
+              return;
+            }
+          }
+          TableSize <<= 1;
+        }
+      }
+
+      /** index of the entry or Entries_.size() if the name is unknown */
+      size_t findName_(const std::string_view Name) const
+      {
+        const size_t Idx = NameTable_[hashName_(Name, NameSeed_) & (NameTable_.size() - 1)];
+        return (Idx < Entries_.size() && Entries_[Idx].Name == Name) ? Idx : Entries_.size();
+      }
+
+      std::vector<EntryType> Entries_;
+      std::vector<size_t> NameTable_;
+      uint64_t NameSeed_ = 0;
   };
 }
 
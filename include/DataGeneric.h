@@ -36,8 +36,16 @@
 #include "VectorTypes.h"
 #include "DataConfig.h"
 
+#include <algorithm>
+#include <charconv>
+#include <cstdint>
 #include <cstdio>
+#include <cstdlib>
+#include <sstream>
+#include <stdexcept>
 #include <string>
+#include <string_view>
+#include <vector>
 
 namespace libRSF
 {
@@ -47,83 +55,145 @@ namespace libRSF
     using ConfigType = DataConfig<TypeEnum, ElementEnum>;
 
     public:
+      /** the buffer is on the heap unless the object is placed in the slab of its type */
+      using BufferType = std::vector<double, SlabAllocator<double>>;
+
       DataGeneric() = default;
       virtual ~DataGeneric() = default;
 
+      /** moving keeps the storage of all elements (and pointers to them) valid */
+      DataGeneric(const DataGeneric &) = default;
+      DataGeneric(DataGeneric &&) noexcept = default;
+      DataGeneric &operator=(const DataGeneric &) = default;
+      DataGeneric &operator=(DataGeneric &&) noexcept = default;
+
       /** get properties */
       TypeEnum getType() const
       {
         return Type_;
       }
 
-      [[nodiscard]] std::string getName() const
+      [[nodiscard]] const std::string &getName() const
       {
-        return Name_;
+        return *Name_;
       }
 
-      /** get elements */
-      Vector getValue(const ElementEnum Element) const
+      /** get elements as view into the internal buffer */
+      VectorRefConst<double, Dynamic> getValue(const ElementEnum Element) const
       {
-        return Data_.at(Element);
+        return VectorRefConst<double, Dynamic>(Buffer_.data() + getOffset_(Element), getSize_(Element));
       }
 
-      /** get pointers */
+      /** get pointers, handing one out counts as a modification since the writes through it can not be seen */
       double* getDataPointer(const ElementEnum Element)
       {
-        return Data_.at(Element).data();
+        Version_.Value++;
+        return Buffer_.data() + getOffset_(Element);
+      }
+
+      /** changes with every modification by the setters, by an assignment or by handing out a data pointer,
+       *  writes through a pointer that was taken before are not counted */
+      [[nodiscard]] uint64_t getVersion() const
+      {
+        return Version_.Value;
+      }
+
+      /** raw access to all elements in the order of the config */
+      [[nodiscard]] const BufferType &getBuffer() const
+      {
+        return Buffer_;
+      }
+
+      /** move the buffer into the slab of the type, so that e.g. the parameter blocks of states lie next to each other
+       *  pointers into the buffer are invalid afterwards, moving keeps the slot, a copy of the object is on the heap */
+      void placeInSlab()
+      {
+        if (Layout_ == nullptr || isInSlab())
+        {
+          return;
+        }
+        BufferType Placed(Buffer_.begin(), Buffer_.end(), SlabAllocator<double>(Layout_->Slab));
+        Buffer_ = std::move(Placed);
+      }
+
+      [[nodiscard]] bool isInSlab() const
+      {
+        return (Buffer_.get_allocator().getSlab() != nullptr);
+      }
+
+      /** bytes of the object and its buffer */
+      [[nodiscard]] size_t getMemorySize() const
+      {
+        return sizeof(*this) + Buffer_.capacity() * sizeof(double);
       }
 
       /** set elements */
       void setValue(const ElementEnum Element, const Vector& Value)
       {
-        Data_.at(Element) = Value;
+        if (Value.size() != getSize_(Element))
+        {
+          PRINT_ERROR("Wrong size of element ", static_cast<int>(Element), " in ", *Name_, ": ", Value.size(), " instead of ", getSize_(Element));
+          return;
+        }
+        VectorRef<double, Dynamic>(getDataPointer(Element), Value.size()) = Value;
       }
 
       void setValueScalar(const ElementEnum Element, const double Value)
       {
-        Data_.at(Element).fill(Value);
+        VectorRef<double, Dynamic>(getDataPointer(Element), getSize_(Element)).fill(Value);
       }
 
       /** check if element exists */
       bool checkElement(const ElementEnum Element) const
       {
-        return (Data_.count(Element) > 0);
+        return (Layout_ != nullptr && Layout_->hasElement(Element));
       }
 
       /** generate pretty output strings */
       [[nodiscard]] std::string getValueString() const
       {
         std::string Out;
+        this->appendValueString(Out);
+        return Out;
+      }
 
-        for(const auto &Element : Config->getConfig(Type_))
+      /** same as getValueString(), but without temporary strings, e.g. for large exports */
+      void appendValueString(std::string &Out) const
+      {
+        /** the buffer follows the order of the config, the format is that of std::scientific with precision 8 */
+        char Formatted[32];
+        for(const double Value : Buffer_)
         {
-          for(Index nElement = 0; nElement < Data_.at(Element.first).size(); nElement++)
-          {
-            std::ostringstream Stream;
-            Stream.precision(8);
-            Stream << std::scientific << Data_.at(Element.first).operator[](nElement);
-
-            Out.append(Stream.str());
-            Out.append(" ");
-          }
+          const int Length = std::snprintf(Formatted, sizeof(Formatted), "%.8e", Value);
+          Out.append(Formatted, static_cast<size_t>(std::max(Length, 0)));
+          Out.push_back(' ');
         }
-
-        return Out;
       }
 
       [[nodiscard]] std::string getNameValueString() const
       {
         std::string Out;
-        Out.append(Name_);
+        Out.append(*Name_);
         Out.append(": ");
 
-        for(auto const &Element : Data_)
+        if (Layout_ == nullptr)
         {
+          return Out;
+        }
+
+        /** elements are printed in order of their enum value */
+        for(size_t nElement = 0; nElement < Layout_->Offset.size(); nElement++)
+        {
+          if (Layout_->Offset[nElement] < 0)
+          {
+            continue;
+          }
+
           Out.append(" ");
 
-          for(Index nElement = 0; nElement < Element.second.size(); nElement++)
+          for(int nValue = 0; nValue < Layout_->Size[nElement]; nValue++)
           {
-            Out.append(std::to_string(Element.second.operator[](nElement)));
+            Out.append(std::to_string(Buffer_[Layout_->Offset[nElement] + nValue]));
             Out.append(" ");
           }
         }
@@ -132,21 +202,20 @@ namespace libRSF
       }
 
     protected:
-      /** construct a specific data configuration */
+      /** construct a specific data configuration, the buffer is a copy of the prototype of the type */
       void constructEmpty(const TypeEnum Type, double Timestamp = 0.0)
       {
-        if(Config->checkType(Type))
+        if(Config->findType(Type, Name_, Layout_))
         {
           Type_ = Type;
-          Name_ = Config->getName(Type);
 
-          for(const auto &Element : Config->getConfig(Type))
+          /** an existing buffer keeps its memory if it is large enough */
+          Buffer_.assign(Layout_->Prototype.begin(), Layout_->Prototype.end());
+          if (Layout_->hasElement(ElementEnum::Timestamp))
           {
-            Data_.emplace(Element.first, Vector(Element.second));
-            Data_.at(Element.first).fill(0.0);
+            Buffer_[static_cast<size_t>(Layout_->Offset[static_cast<size_t>(ElementEnum::Timestamp)])] = Timestamp;
           }
-
-          Data_[ElementEnum::Timestamp].operator[](0) = Timestamp;
+          Version_.Value++;
         }
         else
         {
@@ -154,54 +223,152 @@ namespace libRSF
         }
       }
 
-      void constructFromString(const std::string& Input)
+      /** copy all elements from raw memory that follows the layout of the type */
+      void constructFromBuffer(const TypeEnum Type, const double * Values, const Index Size)
+      {
+        constructEmpty(Type);
+
+        if (Layout_ == nullptr)
+        {
+          return;
+        }
+
+        if (Size != static_cast<Index>(Buffer_.size()))
+        {
+          PRINT_ERROR("Wrong number of values for ", *Name_, ": ", Size, " instead of ", Buffer_.size());
+          return;
+        }
+
+        std::copy(Values, Values + Size, Buffer_.begin());
+        Version_.Value++;
+      }
+
+      /** like std::stod before, a malformed line throws */
+      void constructFromString(const std::string_view Input)
+      {
+        std::string Error;
+        if (!constructFromString(Input, Error))
+        {
+          throw std::invalid_argument(Error);
+        }
+      }
+
+      /** returns false and leaves the object without values if the line is malformed, so that readers can skip it */
+      bool constructFromString(const std::string_view Input, std::string &Error)
       {
         /** read type from string */
-        auto Split = Input.find_first_of(' ');
-        std::string Name = Input.substr(0, Split);
+        const auto Split = std::min(Input.find_first_of(' '), Input.size());
+        const std::string_view Name = Input.substr(0, Split);
 
         /** choose config according to type */
-        if(Config->checkName(Name))
+        if(!Config->checkName(Name))
         {
-          constructEmpty(Config->getType(Name));
-          parseSubstring_(Input.substr(Split));
+          Error = "Type does not exist: " + std::string(Name);
+          return false;
         }
-        else
+
+        constructEmpty(Config->getType(Name));
+        if (!parseSubstring_(Input.data() + Split, Input.data() + Input.size(), Error))
         {
-          PRINT_ERROR("Type does not exist: ", Name);
+          Layout_ = nullptr;
+          Buffer_.clear();
+          return false;
         }
+        return true;
       }
 
     /** pointer to the the list of configurations */
     const ConfigType * Config;
 
     private:
-      /** parse an ASCII input string */
-      std::string parseSubstring_(const std::string& Input)
+      /** parse an ASCII input string in place, returns false if a value is missing or malformed */
+      bool parseSubstring_(const char * Begin, const char * End, std::string &Error)
       {
-        size_t StringEnd = 0;
-        size_t InputStringEnd = 0;
-
-        for(const auto &Element : Config->getConfig(Type_))
+        /** the buffer follows the order of the config */
+        for(double &Value : Buffer_)
         {
-          for(Index nElement = 0; nElement < Data_.at(Element.first).size(); nElement++)
+          /** skip separators, which from_chars does not accept */
+          while(Begin < End && (*Begin == ' ' || *Begin == '\t' || *Begin == '+'))
           {
-            Data_.at(Element.first).operator[](nElement) = std::stod(Input.substr(InputStringEnd), &StringEnd);
-            InputStringEnd += StringEnd;
+            Begin++;
           }
+
+#ifdef __cpp_lib_to_chars
+          const auto Result = std::from_chars(Begin, End, Value);
+          if(Result.ec != std::errc())
+          {
+            Error = "Could not parse value of " + *Name_ + ": " + std::string(Begin, End);
+            return false;
+          }
+          Begin = Result.ptr;
+#else
+          char * ValueEnd = nullptr;
+          Value = std::strtod(Begin, &ValueEnd);
+          if(ValueEnd == Begin)
+          {
+            Error = "Could not parse value of " + *Name_ + ": " + std::string(Begin, End);
+            return false;
+          }
+          Begin = ValueEnd;
+#endif
         }
 
-        return Input.substr(InputStringEnd);
+        return true;
+      }
+
+      /** position of an element inside the buffer */
+      int getOffset_(const ElementEnum Element) const
+      {
+        if (!checkElement(Element))
+        {
+          throw std::out_of_range("Element " + std::to_string(static_cast<int>(Element)) + " does not exist in " + *Name_);
+        }
+        return Layout_->Offset[static_cast<size_t>(Element)];
       }
 
-      /** identifying string */
-      std::string Name_;
+      Index getSize_(const ElementEnum Element) const
+      {
+        if (!checkElement(Element))
+        {
+          throw std::out_of_range("Element " + std::to_string(static_cast<int>(Element)) + " does not exist in " + *Name_);
+        }
+        return Layout_->Size[static_cast<size_t>(Element)];
+      }
+
+      /** identifying string, owned by the config */
+      const std::string * Name_ = &EmptyName_;
+      static inline const std::string EmptyName_;
 
       /** internal type */
       TypeEnum Type_;
 
-      /** where the data is stored */
-      std::map<ElementEnum, Vector> Data_;
+      /** precomputed offsets of all elements, owned by the config */
+      const typename ConfigType::LayoutType * Layout_ = nullptr;
+
+      /** all elements are stored consecutively in one buffer */
+      BufferType Buffer_;
+
+      /** an assigned object gets a version above both old ones, so the result never looks unchanged */
+      struct VersionCounter
+      {
+        VersionCounter() = default;
+        ~VersionCounter() = default;
+        VersionCounter(const VersionCounter &) = default;
+        VersionCounter(VersionCounter &&) noexcept = default;
+        VersionCounter &operator=(const VersionCounter &Other)
+        {
+          Value = std::max(Value, Other.Value) + 1;
+          return *this;
+        }
+        VersionCounter &operator=(VersionCounter &&Other) noexcept
+        {
+          Value = std::max(Value, Other.Value) + 1;
+          return *this;
+        }
+
+        uint64_t Value = 0;
+      };
+      VersionCounter Version_;
   };
 }
 
@@ -36,10 +36,19 @@
 #include "DataStream.h"
 #include "Messages.h"
 
+#include <algorithm>
+#include <iterator>
+#include <limits>
+#include <map>
+#include <memory>
+#include <set>
+#include <utility>
+#include <vector>
+
 namespace libRSF
 {
   /** one class as base for all lists of something in time */
-  template <typename KeyType, typename ObjectType>
+  template <typename KeyType, typename ObjectType, typename StreamType = DefaultDataStream<ObjectType>>
   class DataSet
   {
    public:
@@ -47,50 +56,262 @@ namespace libRSF
     virtual ~DataSet() = default;
 
     /** chronological list of arbitrary objects*/
-    using ObjectStream = DataStream<ObjectType>;
+    using ObjectStream = StreamType;
 
     /** unique ID that identifies one object */
     struct UniqueID
     {
       UniqueID() = default;
 
-      UniqueID(const KeyType &IDNew, const double TimestampNew, const int NumberNew = 0) : ID(IDNew), Timestamp(TimestampNew), Number(NumberNew)
+      UniqueID(const KeyType &IDNew, const double TimestampNew, const int NumberNew = 0) : ID(IDNew), Tick(toTick(TimestampNew)), Number(NumberNew)
+      {
+      }
+
+      /** the time is stored as tick, so comparisons and hashes are exact */
+      [[nodiscard]] double getTimestamp() const
       {
+        return fromTick(Tick);
+      }
+
+      void setTimestamp(const double TimestampNew)
+      {
+        Tick = toTick(TimestampNew);
       }
 
       /** is required to compare keys */
       bool operator==(const UniqueID &Other) const
       {
-        return ID == Other.ID && Timestamp == Other.Timestamp && Number == Other.Number;
+        return ID == Other.ID && Tick == Other.Tick && Number == Other.Number;
       }
 
       KeyType ID;
-      double Timestamp;
-      int Number;
+      TimeTick Tick = 0;
+      int Number = 0;
+    };
+
+    using StreamIterator = typename ObjectStream::const_iterator;
+
+    /** objects of one ID in time order, the range is invalidated by modifications of the set */
+    class ConstRange
+    {
+      public:
+        /** dereferences directly to the object */
+        class Iterator
+        {
+          public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = ObjectType;
+            using difference_type = std::ptrdiff_t;
+            using reference = const ObjectType &;
+            using pointer = const ObjectType *;
+
+            Iterator() = default;
+            explicit Iterator(StreamIterator It) : It_(It) {}
+
+            reference operator*() const {return (*It_).second;}
+            pointer operator->() const {return &((*It_).second);}
+
+            /** key of the current object */
+            [[nodiscard]] double getTime() const {return (*It_).first;}
+
+            Iterator &operator++() {++It_; return *this;}
+            Iterator operator++(int) {Iterator Old = *this; ++It_; return Old;}
+
+            bool operator==(const Iterator &Other) const {return It_ == Other.It_;}
+            bool operator!=(const Iterator &Other) const {return It_ != Other.It_;}
+
+          private:
+            StreamIterator It_;
+        };
+
+        ConstRange(StreamIterator Begin, StreamIterator End) : Begin_(Begin), End_(End) {}
+
+        [[nodiscard]] Iterator begin() const {return Iterator(Begin_);}
+        [[nodiscard]] Iterator end() const {return Iterator(End_);}
+        [[nodiscard]] bool empty() const {return Begin_ == End_;}
+
+      private:
+        StreamIterator Begin_;
+        StreamIterator End_;
+    };
+
+    /** forward cursor over the timestamps of one ID, a sequence of increasing steps is amortized O(1) */
+    class TimeCursor
+    {
+      public:
+        TimeCursor() = default;
+        TimeCursor(StreamIterator Begin, StreamIterator End) : It_(Begin), End_(End) {}
+
+        [[nodiscard]] bool valid() const {return It_ != End_;}
+
+        /** only valid if valid() is true */
+        [[nodiscard]] double getTime() const {return (*It_).first;}
+
+        /** move to the first timestamp above Time, the cursor never moves backwards */
+        bool seekAbove(const double Time)
+        {
+          while (It_ != End_ && (*It_).first <= Time)
+          {
+            ++It_;
+          }
+          return this->valid();
+        }
+
+        /** move to the next distinct timestamp */
+        bool next()
+        {
+          return this->valid() && this->seekAbove(this->getTime());
+        }
+
+      private:
+        StreamIterator It_;
+        StreamIterator End_;
+    };
+
+    /** merges the cursors of multiple IDs into one chronological sequence of events */
+    class EventCursor
+    {
+      public:
+        EventCursor() = default;
+
+        void add(const KeyType &ID, const TimeCursor &Cursor)
+        {
+          Cursors_.emplace_back(ID, Cursor);
+        }
+
+        [[nodiscard]] bool valid() const
+        {
+          for (const auto &Cursor : Cursors_)
+          {
+            if (Cursor.second.valid())
+            {
+              return true;
+            }
+          }
+          return false;
+        }
+
+        /** earliest timestamp of all IDs, only valid if valid() is true */
+        [[nodiscard]] double getTime() const
+        {
+          double Time = std::numeric_limits<double>::infinity();
+          for (const auto &Cursor : Cursors_)
+          {
+            if (Cursor.second.valid() && Cursor.second.getTime() < Time)
+            {
+              Time = Cursor.second.getTime();
+            }
+          }
+          return Time;
+        }
+
+        /** IDs that have an object at the current timestamp */
+        [[nodiscard]] std::vector<KeyType> getKeys() const
+        {
+          std::vector<KeyType> Keys;
+          const double Time = this->getTime();
+          for (const auto &Cursor : Cursors_)
+          {
+            if (Cursor.second.valid() && Cursor.second.getTime() == Time)
+            {
+              Keys.push_back(Cursor.first);
+            }
+          }
+          return Keys;
+        }
+
+        bool seekAbove(const double Time)
+        {
+          for (auto &Cursor : Cursors_)
+          {
+            Cursor.second.seekAbove(Time);
+          }
+          return this->valid();
+        }
+
+        bool next()
+        {
+          return this->valid() && this->seekAbove(this->getTime());
+        }
+
+      private:
+        /** there are only a few sensors, so a linear scan is cheaper than a heap */
+        std::vector<std::pair<KeyType, TimeCursor>> Cursors_;
     };
 
+    /** cursor at the first timestamp of ID, it is invalidated by modifications of the set */
+    TimeCursor cursor(const KeyType &ID) const
+    {
+      const auto Stream = DataStreams.find(ID);
+      if (Stream == DataStreams.end())
+      {
+        return TimeCursor(EmptyStream_.begin(), EmptyStream_.end());
+      }
+      return TimeCursor(Stream->second->begin(), Stream->second->end());
+    }
+
+    /** merged cursor over all IDs */
+    EventCursor cursorAll() const
+    {
+      EventCursor Cursor;
+      for (const auto &Stream : DataStreams)
+      {
+        Cursor.add(Stream.first, TimeCursor(Stream.second->begin(), Stream.second->end()));
+      }
+      return Cursor;
+    }
+
+    /** all objects with TimeBegin <= Timestamp <= TimeEnd, found with a single search */
+    ConstRange range(const KeyType &ID, const double TimeBegin, const double TimeEnd) const
+    {
+      const auto Stream = DataStreams.find(ID);
+      if (Stream == DataStreams.end() || TimeBegin > TimeEnd)
+      {
+        return ConstRange(EmptyStream_.begin(), EmptyStream_.end());
+      }
+
+      const ObjectStream &StreamRef = *Stream->second;
+      return ConstRange(StreamRef.lower_bound(TimeBegin), StreamRef.upper_bound(TimeEnd));
+    }
+
+    /** all objects with TimeOld < Timestamp <= TimeNow, which is the interval of one update step */
+    ConstRange rangeAfter(const KeyType &ID, const double TimeOld, const double TimeNow) const
+    {
+      const auto Stream = DataStreams.find(ID);
+      if (Stream == DataStreams.end() || TimeOld >= TimeNow)
+      {
+        return ConstRange(EmptyStream_.begin(), EmptyStream_.end());
+      }
+
+      const ObjectStream &StreamRef = *Stream->second;
+      return ConstRange(StreamRef.upper_bound(TimeOld), StreamRef.upper_bound(TimeNow));
+    }
+
     /** add an element according to its ID and Timestamp*/
     void addElement(const KeyType &ID, const double &Timestamp, const ObjectType &Object)
     {
       if (!this->checkID(ID))
       {
-        ObjectStream TempStream;
-        DataStreams.emplace(ID, TempStream);
+        DataStreams.emplace(ID, std::make_shared<ObjectStream>());
       }
 
-      DataStreams.at(ID).emplace(Timestamp, Object);
+      ObjectStream &Stream = this->getStreamMutable(ID);
+      const double TimeFirstOld = Stream.empty() ? NAN_DOUBLE : Stream.begin()->first;
+      Stream.emplace(Timestamp, Object);
+      this->updateTimeFirst_(ID, TimeFirstOld);
     }
 
     void removeElement(const KeyType &ID, const double Timestamp, const int Number)
     {
       if (this->checkElement(ID, Timestamp, Number))
       {
-        auto It = DataStreams.at(ID).lower_bound(Timestamp);
-        std::advance(It, Number);
-        DataStreams.at(ID).erase(It);
+        ObjectStream &Stream = this->getStreamMutable(ID);
+        const double TimeFirstOld = Stream.begin()->first;
+        Stream.erase(Timestamp, Number);
+        this->updateTimeFirst_(ID, TimeFirstOld);
 
         /** erase empty IDs */
-        if (DataStreams.at(ID).empty())
+        if (this->getStream(ID).empty())
         {
           DataStreams.erase(ID);
         }
@@ -105,10 +326,13 @@ namespace libRSF
     {
       if (checkElement(ID, Timestamp))
       {
-        DataStreams.at(ID).erase(Timestamp);
+        ObjectStream &Stream = this->getStreamMutable(ID);
+        const double TimeFirstOld = Stream.begin()->first;
+        Stream.erase(Timestamp);
+        this->updateTimeFirst_(ID, TimeFirstOld);
 
         /** erase empty IDs */
-        if (DataStreams.at(ID).empty())
+        if (this->getStream(ID).empty())
         {
           DataStreams.erase(ID);
         }
@@ -119,9 +343,66 @@ namespace libRSF
       }
     }
 
+    /** remove all elements of ID with a timestamp below Timestamp in one pass, returns the number of removed elements */
+    int removeElementsBefore(const KeyType &ID, const double Timestamp)
+    {
+      if (!this->checkID(ID))
+      {
+        return 0;
+      }
+      ObjectStream &Stream = this->getStreamMutable(ID);
+      return this->removeElementsFront_(ID, Stream.lower_bound(Timestamp));
+    }
+
+    /** remove all elements of ID with a timestamp below or equal Timestamp in one pass */
+    int removeElementsBeforeOrEqual(const KeyType &ID, const double Timestamp)
+    {
+      if (!this->checkID(ID))
+      {
+        return 0;
+      }
+      ObjectStream &Stream = this->getStreamMutable(ID);
+      return this->removeElementsFront_(ID, Stream.upper_bound(Timestamp));
+    }
+
+    /** remove the elements below Timestamp of all IDs, only IDs with such elements are visited */
+    int removeAllBefore(const double Timestamp)
+    {
+      int Removed = 0;
+      for (const KeyType &ID : this->getKeysBeforeOrEqual(Timestamp))
+      {
+        Removed += this->removeElementsBefore(ID, Timestamp);
+      }
+      return Removed;
+    }
+
+    int removeAllBeforeOrEqual(const double Timestamp)
+    {
+      int Removed = 0;
+      for (const KeyType &ID : this->getKeysBeforeOrEqual(Timestamp))
+      {
+        Removed += this->removeElementsBeforeOrEqual(ID, Timestamp);
+      }
+      return Removed;
+    }
+
     void clear()
     {
       DataStreams.clear();
+      TimeFirstOrder_.clear();
+    }
+
+    /** take over the streams of another set without copying their elements, streams with the same ID are replaced */
+    void takeStreams(DataSet &&Other)
+    {
+      for (auto &Stream : Other.DataStreams)
+      {
+        std::shared_ptr<ObjectStream> &Target = DataStreams[Stream.first];
+        const double TimeFirstOld = (Target == nullptr || Target->empty()) ? NAN_DOUBLE : Target->begin()->first;
+        Target = std::move(Stream.second);
+        this->updateTimeFirst_(Stream.first, TimeFirstOld);
+      }
+      Other.clear();
     }
 
     /** check if an element exists */
@@ -132,7 +413,7 @@ namespace libRSF
         return 0;
       }
 
-      return DataStreams.at(ID).count(Timestamp);
+      return this->getStream(ID).count(Timestamp);
     }
 
     int countElements(const KeyType &ID) const
@@ -142,7 +423,7 @@ namespace libRSF
         return 0;
       }
 
-      return DataStreams.at(ID).size();
+      return this->getStream(ID).size();
     }
 
     bool checkElement(const KeyType &ID, const double Timestamp, const int Number = 0) const
@@ -166,9 +447,7 @@ namespace libRSF
     {
       if (checkElement(ID, Timestamp, Number))
       {
-        auto It = DataStreams.at(ID).lower_bound(Timestamp);
-        std::advance(It, Number);
-        return It->second;
+        return this->getStreamMutable(ID).at(Timestamp, Number);
       }
 
       PRINT_ERROR("Element doesn't exist at: ", Timestamp, " Type: ", ID, " Number: ", Number);
@@ -179,9 +458,7 @@ namespace libRSF
     {
       if (checkElement(ID, Timestamp, Number))
       {
-        auto It = DataStreams.at(ID).lower_bound(Timestamp);
-        std::advance(It, Number);
-        Element = It->second;
+        Element = this->getStream(ID).at(Timestamp, Number);
         return true;
       }
 
@@ -192,9 +469,7 @@ namespace libRSF
     {
       if (checkElement(ID, Timestamp, Number))
       {
-        auto It = DataStreams.at(ID).lower_bound(Timestamp);
-        std::advance(It, Number);
-        It->second = Element;
+        this->getStreamMutable(ID).at(Timestamp, Number) = Element;
         return true;
       }
 
@@ -206,7 +481,7 @@ namespace libRSF
     {
       if (this->checkID(ID))
       {
-        Timestamp = DataStreams.at(ID).begin()->first;
+        Timestamp = this->getStream(ID).begin()->first;
         return true;
       }
 
@@ -215,32 +490,51 @@ namespace libRSF
 
     bool getTimeFirstOverall(double &Timestamp) const
     {
-      if (DataStreams.empty())
+      if (TimeFirstOrder_.empty())
       {
         PRINT_ERROR("Empty list!");
         return false;
       }
 
-      double TimeFirst = Timestamp;
-      Timestamp = NAN_DOUBLE;
-      std::vector<KeyType> IDs = this->getKeysAll();
-      for (const KeyType &ID : IDs)
+      Timestamp = TimeFirstOrder_.begin()->first;
+      return true;
+    }
+
+    /** first timestamp of the IDs that pass the filter, IDs are visited in the order of their first element */
+    template <typename FilterType>
+    bool getTimeFirstOverall(double &Timestamp, FilterType IsIncluded) const
+    {
+      for (const auto &Entry : TimeFirstOrder_)
       {
-        this->getTimeFirst(ID, TimeFirst);
-        if (std::isnan(Timestamp) || TimeFirst < Timestamp)
+        if (IsIncluded(Entry.second))
         {
-          Timestamp = TimeFirst;
+          Timestamp = Entry.first;
+          return true;
         }
       }
+      return false;
+    }
 
-      return true;
+    /** IDs with at least one element at or before Timestamp, without visiting the other IDs */
+    std::vector<KeyType> getKeysBeforeOrEqual(const double Timestamp) const
+    {
+      std::vector<KeyType> Keys;
+      for (const auto &Entry : TimeFirstOrder_)
+      {
+        if (Entry.first > Timestamp)
+        {
+          break;
+        }
+        Keys.push_back(Entry.second);
+      }
+      return Keys;
     }
 
     bool getTimeLast(const KeyType &ID, double &Timestamp) const
     {
       if (this->checkID(ID))
       {
-        Timestamp = std::prev(DataStreams.at(ID).end())->first;
+        Timestamp = std::prev(this->getStream(ID).end())->first;
         return true;
       }
 
@@ -251,9 +545,9 @@ namespace libRSF
     {
       if (this->checkElement(ID, Timestamp))
       {
-        auto It = DataStreams.at(ID).upper_bound(Timestamp);
+        auto It = this->getStream(ID).upper_bound(Timestamp);
 
-        if (It != DataStreams.at(ID).end())
+        if (It != this->getStream(ID).end())
         {
           NextTimeStamp = It->first;
         }
@@ -288,9 +582,9 @@ namespace libRSF
         return false;
       }
 
-      auto It = DataStreams.at(ID).lower_bound(TimeIn);
+      auto It = this->getStream(ID).lower_bound(TimeIn);
 
-      if (It != DataStreams.at(ID).end())
+      if (It != this->getStream(ID).end())
       {
         TimeOut = It->first;
         return true;
@@ -307,9 +601,9 @@ namespace libRSF
         return false;
       }
 
-      const auto It = DataStreams.at(ID).upper_bound(Timestamp);
+      const auto It = this->getStream(ID).upper_bound(Timestamp);
 
-      if (It != DataStreams.at(ID).end())
+      if (It != this->getStream(ID).end())
       {
         NextTimeStamp = It->first;
         return true;
@@ -326,10 +620,10 @@ namespace libRSF
         return false;
       }
 
-      const auto It = DataStreams.at(ID).lower_bound(TimeIn);
+      const auto It = this->getStream(ID).lower_bound(TimeIn);
 
       /** case 1: there is no element below */
-      if (It == DataStreams.at(ID).begin())
+      if (It == this->getStream(ID).begin())
       {
         return false;
       }
@@ -348,9 +642,9 @@ namespace libRSF
       }
 
       /** catch equal case at first */
-      if (DataStreams.at(ID).count(TimeIn) > 0)
+      if (this->getStream(ID).count(TimeIn) > 0)
       {
-        const auto It = DataStreams.at(ID).lower_bound(TimeIn);
+        const auto It = this->getStream(ID).lower_bound(TimeIn);
         TimeOut = It->first;
         return true; /**< equal */
       }
@@ -405,6 +699,34 @@ namespace libRSF
       return true;
     }
 
+    /** the neighboring timestamps of a query time */
+    struct TimeBracket
+    {
+      double TimeBelow = 0.0;   /**< last timestamp <= query, the first one if there is none */
+      double TimeAbove = 0.0;   /**< first timestamp >= query, the last one if there is none */
+      double Weight = 0.0;      /**< linear interpolation weight of TimeAbove in [0, 1] */
+      bool IsInside = false;    /**< false if the query is outside of the stream and the bracket is clamped */
+
+      /** same choice as getTimeCloseTo() */
+      [[nodiscard]] double getTimeClose() const
+      {
+        return (Weight < 0.5) ? TimeBelow : TimeAbove;
+      }
+    };
+
+    /** merge-join of query times with the timestamps of ID, one search and a linear pass for sorted queries */
+    bool associate(const KeyType &ID, const std::vector<double> &Times, std::vector<TimeBracket> &Brackets) const
+    {
+      return this->associate_(ID, Times.begin(), Times.end(), [](const auto &It) {return *It;}, Brackets);
+    }
+
+    /** same for the timestamps of a range, e.g. the measurements of one epoch */
+    template <typename RangeType>
+    bool associate(const KeyType &ID, const RangeType &Range, std::vector<TimeBracket> &Brackets) const
+    {
+      return this->associate_(ID, Range.begin(), Range.end(), [](const auto &It) {return It.getTime();}, Brackets);
+    }
+
     int countTimes(const KeyType &ID) const
     {
       if (!this->checkID(ID))
@@ -412,7 +734,36 @@ namespace libRSF
         return 0;
       }
 
-      return DataStreams.at(ID).size();
+      return this->getStream(ID).size();
+    }
+
+    /** estimated bytes of all objects of one ID */
+    size_t getMemorySize(const KeyType &ID) const
+    {
+      const auto It = DataStreams.find(ID);
+      return (It != DataStreams.end()) ? It->second->getMemorySize() : 0;
+    }
+
+    /** estimated bytes per ID */
+    std::map<KeyType, size_t> getMemorySizePerID() const
+    {
+      std::map<KeyType, size_t> Bytes;
+      for (const auto &Stream : DataStreams)
+      {
+        Bytes.emplace(Stream.first, Stream.second->getMemorySize());
+      }
+      return Bytes;
+    }
+
+    /** estimated bytes of the whole set */
+    size_t getMemorySize() const
+    {
+      size_t Bytes = sizeof(*this);
+      for (const auto &Stream : DataStreams)
+      {
+        Bytes += TreeNodeOverhead + sizeof(KeyType) + sizeof(std::shared_ptr<ObjectStream>) + Stream.second->getMemorySize();
+      }
+      return Bytes;
     }
 
     std::vector<KeyType> getKeysAll() const
@@ -451,11 +802,13 @@ namespace libRSF
     {
       std::vector<ObjectType> Objects;
 
-      if (DataStreams.count(ID) > 0)
+      const auto Stream = DataStreams.find(ID);
+      if (Stream != DataStreams.end())
       {
-        for (auto it = DataStreams.at(ID).begin(); it != DataStreams.at(ID).end(); ++it)
+        Objects.reserve(Stream->second->size());
+        for (const auto &Element : *Stream->second)
         {
-          Objects.push_back(it->second);
+          Objects.push_back(Element.second);
         }
       }
 
@@ -472,7 +825,7 @@ namespace libRSF
 
       if (this->checkID(ID))
       {
-        auto Range = DataStreams.at(ID).equal_range(Timestamp);
+        auto Range = this->getStream(ID).equal_range(Timestamp);
         for (auto it = Range.first; it != Range.second; ++it)
         {
           Objects.push_back(it->second);
@@ -490,46 +843,10 @@ namespace libRSF
     {
       std::vector<ObjectType> Objects;
 
-      /** catch special case, where timestamps are identical */
-      if (TimeBegin == TimeEnd)
-      {
-        return this->getElements(ID, TimeBegin);
-      }
-
       if (this->checkID(ID))
       {
-        /** identify true boarders */
-        double TimeFirst, TimeLast;
-        if (this->getTimeBelowOrEqual(ID, TimeEnd, TimeLast) == false)
-        {
-          PRINT_WARNING("Did not find upper bound of ", ID, " at ", TimeBegin);
-          return Objects;
-        }
-        if (this->getTimeAboveOrEqual(ID, TimeBegin, TimeFirst) == false)
-        {
-          PRINT_WARNING("Did not find lower bound of ", ID, " at ", TimeBegin);
-          return Objects;
-        }
-
-        if (TimeFirst > TimeLast)
-        {
-          PRINT_WARNING("There is no object between ", TimeBegin, "s and ", TimeEnd, "s of type ", ID);
-          return Objects;
-        }
-
-        /** iterate over timestamps */
-        double Time = TimeFirst;
-        do
-        {
-          std::vector<ObjectType> CurrentObjects = this->getElements(ID, Time);
-          Objects.insert(Objects.end(), CurrentObjects.begin(), CurrentObjects.end());
-
-          /** exit loop if last timestamp is reached */
-          if (Time == TimeLast)
-          {
-            break;
-          }
-        } while (this->getTimeNext(ID, Time, Time));
+        const ConstRange Range = this->range(ID, TimeBegin, TimeEnd);
+        Objects.assign(Range.begin(), Range.end());
       }
       else
       {
@@ -538,7 +855,7 @@ namespace libRSF
 
       if (Objects.empty())
       {
-        PRINT_WARNING("Returned empty vector!");
+        PRINT_WARNING("There is no object between ", TimeBegin, "s and ", TimeEnd, "s of type ", ID);
       }
 
       return Objects;
@@ -549,7 +866,7 @@ namespace libRSF
       if (this->checkID(ID))
       {
         /** loop over timestamps */
-        const ObjectStream &StreamRef = DataStreams.at(ID);
+        const ObjectStream &StreamRef = this->getStream(ID);
         for (auto it = StreamRef.begin(); it != StreamRef.end(); it = StreamRef.upper_bound(it->first))
         {
           /** loop over elements at one timestamp */
@@ -569,7 +886,7 @@ namespace libRSF
     {
       if (this->checkID(ID))
       {
-        const ObjectStream &StreamRef = DataStreams.at(ID);
+        const ObjectStream &StreamRef = this->getStream(ID);
         for (auto it = StreamRef.begin(); it != StreamRef.end(); it = StreamRef.upper_bound(it->first))
         {
           Times.push_back(it->first);
@@ -643,9 +960,13 @@ namespace libRSF
       return true;
     }
 
-    /** functions for range based for-loops */
+    /** functions for range based for-loops, the mutable version detaches all shared streams */
     auto begin()
     {
+      for (auto &Stream : DataStreams)
+      {
+        this->getStreamMutable(Stream.first);
+      }
       return DataStreams.begin();
     }
 
@@ -665,18 +986,154 @@ namespace libRSF
     }
 
     /** combine two lists*/
-    void merge(DataSet<KeyType, ObjectType> &List)
+    void merge(const DataSet<KeyType, ObjectType, StreamType> &List)
     {
-      for (auto &Map : List)
+      for (const auto &Map : List)
       {
-        for (auto &Element : Map.second)
+        for (const auto &Element : *Map.second)
         {
           this->addElement(Map.first, Element.first, Element.second);
         }
       }
     }
 
+    /** direct access to the stream of an existing ID */
+    const ObjectStream &getStream(const KeyType &ID) const
+    {
+      return *DataStreams.at(ID);
+    }
+
+    /** streams are shared between copies of a set and duplicated before the first modification
+     *  elements can be modified, but adding or removing has to be done through the set to keep the time index valid */
+    ObjectStream &getStreamMutable(const KeyType &ID)
+    {
+      std::shared_ptr<ObjectStream> &Stream = DataStreams.at(ID);
+      if (Stream.use_count() > 1)
+      {
+        Stream = std::make_shared<ObjectStream>(*Stream);
+      }
+      return *Stream;
+    }
+
+    /** true if the stream of this ID is still shared with a copy of the set */
+    bool isShared(const KeyType &ID) const
+    {
+      const auto It = DataStreams.find(ID);
+      return (It != DataStreams.end()) && (It->second.use_count() > 1);
+    }
+
    protected:
+    /** erase the front of the stream of an existing ID up to Last and keep the index consistent */
+    template <typename QueryIterator, typename TimeFunction>
+    bool associate_(const KeyType &ID, QueryIterator Begin, const QueryIterator End, TimeFunction GetTime, std::vector<TimeBracket> &Brackets) const
+    {
+      Brackets.clear();
+      if (Begin == End)
+      {
+        return true;
+      }
+
+      const auto Stream = DataStreams.find(ID);
+      if (Stream == DataStreams.end() || Stream->second->empty())
+      {
+        PRINT_ERROR("Container is empty for key: ", ID);
+        return false;
+      }
+      const ObjectStream &StreamRef = *Stream->second;
+      const double TimeFirst = StreamRef.begin()->first;
+      const double TimeLast = std::prev(StreamRef.end())->first;
+
+      /** the stream cursor only moves forward, unsorted queries cost another search */
+      double KeyPrev = roundToTick(GetTime(Begin));
+      auto Above = StreamRef.lower_bound(KeyPrev);
+      for (QueryIterator It = Begin; It != End; ++It)
+      {
+        /** compare with the precision of the keys, like the searches of the stream */
+        const double Time = GetTime(It);
+        const double Key = roundToTick(Time);
+        if (Key < KeyPrev)
+        {
+          Above = StreamRef.lower_bound(Key);
+        }
+        while (Above != StreamRef.end() && Above->first < Key)
+        {
+          ++Above;
+        }
+        KeyPrev = Key;
+
+        TimeBracket Bracket;
+        if (Above == StreamRef.end())
+        {
+          Bracket.TimeBelow = TimeLast;
+          Bracket.TimeAbove = TimeLast;
+        }
+        else if (Above->first == Key)
+        {
+          Bracket.TimeBelow = Above->first;
+          Bracket.TimeAbove = Above->first;
+          Bracket.IsInside = true;
+        }
+        else if (Above == StreamRef.begin())
+        {
+          Bracket.TimeBelow = TimeFirst;
+          Bracket.TimeAbove = TimeFirst;
+          Bracket.Weight = 1.0;
+        }
+        else
+        {
+          Bracket.TimeBelow = std::prev(Above)->first;
+          Bracket.TimeAbove = Above->first;
+          Bracket.Weight = std::clamp((Time - Bracket.TimeBelow) / (Bracket.TimeAbove - Bracket.TimeBelow), 0.0, 1.0);
+          Bracket.IsInside = true;
+        }
+        Brackets.push_back(Bracket);
+      }
+      return true;
+    }
+
+    int removeElementsFront_(const KeyType &ID, const typename ObjectStream::const_iterator Last)
+    {
+      ObjectStream &Stream = *DataStreams.at(ID);
+      if (Last == std::as_const(Stream).begin())
+      {
+        return 0;
+      }
+
+      const double TimeFirstOld = Stream.begin()->first;
+      const int Removed = static_cast<int>(Stream.eraseFront(Last));
+      this->updateTimeFirst_(ID, TimeFirstOld);
+
+      /** erase empty IDs */
+      if (Stream.empty())
+      {
+        DataStreams.erase(ID);
+      }
+      return Removed;
+    }
+
+    /** move the entry of ID in the time index after its stream was modified, TimeFirstOld is NaN for a new stream */
+    void updateTimeFirst_(const KeyType &ID, const double TimeFirstOld)
+    {
+      const auto Stream = DataStreams.find(ID);
+      const bool HasElements = (Stream != DataStreams.end()) && (Stream->second != nullptr) && !Stream->second->empty();
+      const double TimeFirstNew = HasElements ? Stream->second->begin()->first : NAN_DOUBLE;
+
+      /** usually the first element stays the same */
+      if (TimeFirstNew == TimeFirstOld)
+      {
+        return;
+      }
+
+      if (!std::isnan(TimeFirstOld))
+      {
+        TimeFirstOrder_.erase(std::make_pair(TimeFirstOld, ID));
+      }
+      if (HasElements)
+      {
+        TimeFirstOrder_.emplace(TimeFirstNew, ID);
+      }
+    }
+
     bool FindBordersEqual(const KeyType &ID, const double Start, const double End, double &StartTrue, double &EndTrue) const
     {
       if (Start > End)
@@ -721,10 +1178,17 @@ namespace libRSF
       return true;
     }
 
-    std::map<KeyType, ObjectStream> DataStreams;
+    /** copy-on-write: a copy of the set only shares the streams, references handed out before the copy are not tracked */
+    std::map<KeyType, std::shared_ptr<ObjectStream>> DataStreams;
+
+    /** first timestamp of each ID ordered by time, so the oldest IDs are found without a scan over all streams */
+    std::set<std::pair<double, KeyType>> TimeFirstOrder_;
 
     /** for empty references */
     ObjectType NullObject;
+
+    /** for empty ranges */
+    static inline const ObjectStream EmptyStream_{};
   };
 
 }  // namespace libRSF
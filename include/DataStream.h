@@ -25,6 +25,7 @@
  * @author Tim Pfeifer
  * @date 08.03.2021
  * @brief Represents a stream of data objects in time. Keys are rounded to a fixed tick interval.
+ * Two implementations are available: a map of per-tick buckets and a contiguous, time-sorted buffer.
  * @copyright GNU Public License.
  *
  */
@@ -33,87 +34,492 @@
 #define DATASTREAM_H
 
 #include <map>
+#include <vector>
+#include <deque>
+#include <algorithm>
+#include <iterator>
+#include <type_traits>
 #include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
 
 namespace libRSF
 {
+  /** integer timestamp that is used as key, doubles are only converted at the interface */
+  using TimeTick = std::int64_t;
+
+  /** resolution of the tick keys */
+  constexpr double TicksPerSecond = 1e3;
+  constexpr double TickDuration = 1.0 / TicksPerSecond;
+
+  inline TimeTick toTick(const double Time)
+  {
+    return static_cast<TimeTick>(std::llround(Time * TicksPerSecond));
+  }
+
+  inline double fromTick(const TimeTick Tick)
+  {
+    return static_cast<double>(Tick) * TickDuration;
+  }
+
   /** round the timestamp to ticks-precision */
-  double roundToTick(double Time);
+  inline double roundToTick(const double Time)
+  {
+    return fromTick(toTick(Time));
+  }
+
+  /** objects may report their heap memory, otherwise only their own size is counted */
+  template <typename ObjectType, typename = void>
+  struct HasMemorySize : std::false_type {};
+
+  template <typename ObjectType>
+  struct HasMemorySize<ObjectType, std::void_t<decltype(std::declval<const ObjectType&>().getMemorySize())>> : std::true_type {};
 
-  /** stream of objects with ticked timestamps */
+  template <typename ObjectType>
+  size_t getObjectMemorySize(const ObjectType &Object)
+  {
+    if constexpr (HasMemorySize<ObjectType>::value)
+    {
+      return Object.getMemorySize();
+    }
+    else
+    {
+      return sizeof(ObjectType);
+    }
+  }
+
+  /** estimated overhead of a node of std::map or std::set (color + three pointers) */
+  constexpr size_t TreeNodeOverhead = 4 * sizeof(void*);
+
+  /** stream of objects with ticked timestamps
+   *  - objects with the same tick are stored in one bucket
+   *  - (Time, Number) is resolved in O(log T + 1) */
   template<typename ObjectType>
-  class DataStream : private std::multimap<double, ObjectType>
+  class DataStream
   {
     public:
       DataStream() = default;
       virtual ~DataStream() = default;
 
-      /** define base class */
-      using BaseClass = typename std::multimap<double, ObjectType>;
+      /** define storage, the bucket keeps the double timestamp that iterators refer to */
+      struct BucketType
+      {
+        double Time = 0.0;
+        std::vector<ObjectType> Objects;
+      };
+      using StorageType = std::map<TimeTick, BucketType>;
+      using size_type = typename std::vector<ObjectType>::size_type;
+
+      /** iterates over all objects in time order, behaves like a multimap iterator */
+      template<bool IsConst>
+      class Iterator
+      {
+        using MapIterator = std::conditional_t<IsConst, typename StorageType::const_iterator, typename StorageType::iterator>;
+        using ObjectReference = std::conditional_t<IsConst, const ObjectType &, ObjectType &>;
+
+        public:
+          /** key-value proxy with the member names of std::pair */
+          struct Reference
+          {
+            const double &first;
+            ObjectReference second;
+          };
+
+          struct Pointer
+          {
+            Reference Ref;
+            const Reference* operator->() const {return &Ref;}
+          };
+
+          using iterator_category = std::bidirectional_iterator_tag;
+          using value_type = std::pair<double, ObjectType>;
+          using difference_type = std::ptrdiff_t;
+          using reference = Reference;
+          using pointer = Pointer;
 
-      /** use the types of the base class */
-      using iterator = typename BaseClass::iterator;
-      using const_iterator = typename BaseClass::const_iterator;
-      using size_type = typename BaseClass::size_type;
+          Iterator() = default;
+          Iterator(MapIterator MapIt, size_type Index) : MapIt_(MapIt), Index_(Index) {}
+
+          /** non-const to const conversion */
+          template<bool WasConst, typename = std::enable_if_t<IsConst && !WasConst>>
+          Iterator(const Iterator<WasConst> &Other) : MapIt_(Other.getMapIterator()), Index_(Other.getIndex()) {}
+
+          Reference operator*() const {return {MapIt_->second.Time, MapIt_->second.Objects[Index_]};}
+          Pointer operator->() const {return {**this};}
+
+          Iterator &operator++()
+          {
+            if (++Index_ == MapIt_->second.Objects.size())
+            {
+              ++MapIt_;
+              Index_ = 0;
+            }
+            return *this;
+          }
+
+          Iterator &operator--()
+          {
+            if (Index_ == 0)
+            {
+              --MapIt_;
+              Index_ = MapIt_->second.Objects.size();
+            }
+            --Index_;
+            return *this;
+          }
+
+          Iterator operator++(int) {Iterator Old = *this; ++(*this); return Old;}
+          Iterator operator--(int) {Iterator Old = *this; --(*this); return Old;}
+
+          bool operator==(const Iterator &Other) const {return MapIt_ == Other.MapIt_ && Index_ == Other.Index_;}
+          bool operator!=(const Iterator &Other) const {return !(*this == Other);}
+
+          MapIterator getMapIterator() const {return MapIt_;}
+          size_type getIndex() const {return Index_;}
+
+        private:
+          MapIterator MapIt_;
+          size_type Index_ = 0;
+      };
+
+      using iterator = Iterator<false>;
+      using const_iterator = Iterator<true>;
 
       /** implement all functions with a fixed tick size for the double keys */
       iterator find (const double &Time)
       {
-        return BaseClass::find(roundToTick(Time));
+        return {Storage_.find(toTick(Time)), 0};
+      }
+
+      const_iterator find (const double &Time) const
+      {
+        return {Storage_.find(toTick(Time)), 0};
+      }
+
+      size_type count (const double &Time) const
+      {
+        const auto It = Storage_.find(toTick(Time));
+        return (It == Storage_.end()) ? 0 : It->second.Objects.size();
+      }
+
+      iterator lower_bound (const double &Time)
+      {
+        return {Storage_.lower_bound(toTick(Time)), 0};
+      }
+
+      const_iterator lower_bound (const double &Time) const
+      {
+        return {Storage_.lower_bound(toTick(Time)), 0};
+      }
+
+      iterator upper_bound (const double &Time)
+      {
+        return {Storage_.upper_bound(toTick(Time)), 0};
+      }
+
+      const_iterator upper_bound (const double &Time) const
+      {
+        return {Storage_.upper_bound(toTick(Time)), 0};
+      }
+
+      std::pair<iterator,iterator> equal_range (const double &Time)
+      {
+        return {this->lower_bound(Time), this->upper_bound(Time)};
+      }
+
+      std::pair<const_iterator,const_iterator> equal_range (const double &Time) const
+      {
+        return {this->lower_bound(Time), this->upper_bound(Time)};
+      }
+
+      iterator emplace (const double &Time, const ObjectType &Object)
+      {
+        const TimeTick Tick = toTick(Time);
+        auto [MapIt, IsNew] = Storage_.try_emplace(Tick);
+        if (IsNew)
+        {
+          MapIt->second.Time = fromTick(Tick);
+        }
+        MapIt->second.Objects.emplace_back(Object);
+        Size_++;
+        return {MapIt, MapIt->second.Objects.size() - 1};
+      }
+
+      /** direct access to the n-th object of a tick */
+      ObjectType &at (const double &Time, const size_type Number)
+      {
+        return Storage_.at(toTick(Time)).Objects.at(Number);
+      }
+
+      const ObjectType &at (const double &Time, const size_type Number) const
+      {
+        return Storage_.at(toTick(Time)).Objects.at(Number);
+      }
+
+      /** remove objects */
+      iterator erase (const_iterator Position)
+      {
+        auto MapIt = Storage_.erase(Position.getMapIterator(), Position.getMapIterator()); /**< const to non-const */
+        const size_type Index = Position.getIndex();
+
+        MapIt->second.Objects.erase(MapIt->second.Objects.begin() + static_cast<std::ptrdiff_t>(Index));
+        Size_--;
+
+        /** remove empty buckets */
+        if (MapIt->second.Objects.empty())
+        {
+          return {Storage_.erase(MapIt), 0};
+        }
+        if (Index == MapIt->second.Objects.size())
+        {
+          return {std::next(MapIt), 0};
+        }
+        return {MapIt, Index};
+      }
+
+      void erase (const double &Time, const size_type Number)
+      {
+        this->erase(const_iterator(Storage_.find(toTick(Time)), Number));
+      }
+
+      size_type erase (const double &Time)
+      {
+        const auto MapIt = Storage_.find(toTick(Time));
+        if (MapIt == Storage_.end())
+        {
+          return 0;
+        }
+
+        const size_type Count = MapIt->second.Objects.size();
+        Storage_.erase(MapIt);
+        Size_ -= Count;
+        return Count;
+      }
+
+      /** remove all objects before Last in one pass, the common case of a sliding window */
+      size_type eraseFront (const_iterator Last)
+      {
+        size_type Count = 0;
+        for (auto MapIt = Storage_.cbegin(); MapIt != Last.getMapIterator(); ++MapIt)
+        {
+          Count += MapIt->second.Objects.size();
+        }
+        auto MapIt = Storage_.erase(Storage_.cbegin(), Last.getMapIterator());
+
+        /** partially removed bucket */
+        if (Last.getIndex() > 0)
+        {
+          std::vector<ObjectType> &Objects = MapIt->second.Objects;
+          Objects.erase(Objects.begin(), Objects.begin() + static_cast<std::ptrdiff_t>(Last.getIndex()));
+          Count += Last.getIndex();
+        }
+
+        Size_ -= Count;
+        return Count;
+      }
+
+      iterator begin() {return {Storage_.begin(), 0};}
+      const_iterator begin() const {return {Storage_.begin(), 0};}
+      iterator end() {return {Storage_.end(), 0};}
+      const_iterator end() const {return {Storage_.end(), 0};}
+      size_type size() const {return Size_;}
+      bool empty() const {return Storage_.empty();}
+
+      /** estimated bytes of the stream including the heap memory of its objects */
+      size_t getMemorySize() const
+      {
+        size_t Bytes = sizeof(*this);
+        for (const auto &Bucket : Storage_)
+        {
+          Bytes += TreeNodeOverhead + sizeof(typename StorageType::value_type);
+          Bytes += (Bucket.second.Objects.capacity() - Bucket.second.Objects.size()) * sizeof(ObjectType);
+          for (const ObjectType &Object : Bucket.second.Objects)
+          {
+            Bytes += getObjectMemorySize(Object);
+          }
+        }
+        return Bytes;
+      }
+
+    private:
+      StorageType Storage_;
+      size_type Size_ = 0;
+  };
+
+  /** stream of objects with ticked timestamps, stored in a chunked contiguous buffer
+   *  - appending in time order and removing from the front are amortized O(1)
+   *  - lookups are binary searches over the rounded timestamps, because the iterators expose the stored pairs directly
+   *  - objects are moved on insertion in the middle, so they should be cheap to move */
+  template<typename ObjectType>
+  class DataStreamContiguous
+  {
+    public:
+      DataStreamContiguous() = default;
+      virtual ~DataStreamContiguous() = default;
+
+      /** define storage */
+      using ValueType = std::pair<double, ObjectType>;
+      using StorageType = std::deque<ValueType>;
+
+      /** use the types of the storage */
+      using iterator = typename StorageType::iterator;
+      using const_iterator = typename StorageType::const_iterator;
+      using size_type = typename StorageType::size_type;
+
+      /** the same interface as the multimap based stream */
+      iterator find (const double &Time)
+      {
+        const iterator It = this->lower_bound(Time);
+        return (It != Storage_.end() && It->first == roundToTick(Time)) ? It : Storage_.end();
       }
 
       const_iterator find (const double &Time) const
       {
-        return BaseClass::find(roundToTick(Time));
+        const const_iterator It = this->lower_bound(Time);
+        return (It != Storage_.end() && It->first == roundToTick(Time)) ? It : Storage_.end();
       }
 
       size_type count (const double &Time) const
       {
-        return BaseClass::count(roundToTick(Time));
+        const auto Range = this->equal_range(Time);
+        return static_cast<size_type>(std::distance(Range.first, Range.second));
       }
 
       iterator lower_bound (const double &Time)
       {
-        return BaseClass::lower_bound(roundToTick(Time));
+        return std::lower_bound(Storage_.begin(), Storage_.end(), roundToTick(Time), CompareLower_);
       }
 
       const_iterator lower_bound (const double &Time) const
       {
-        return BaseClass::lower_bound(roundToTick(Time));
+        return std::lower_bound(Storage_.begin(), Storage_.end(), roundToTick(Time), CompareLower_);
       }
 
       iterator upper_bound (const double &Time)
       {
-        return BaseClass::upper_bound(roundToTick(Time));
+        return std::upper_bound(Storage_.begin(), Storage_.end(), roundToTick(Time), CompareUpper_);
       }
 
       const_iterator upper_bound (const double &Time) const
       {
-        return BaseClass::upper_bound(roundToTick(Time));
+        return std::upper_bound(Storage_.begin(), Storage_.end(), roundToTick(Time), CompareUpper_);
       }
 
       std::pair<iterator,iterator> equal_range (const double &Time)
       {
-        return BaseClass::equal_range(roundToTick(Time));
+        return {this->lower_bound(Time), this->upper_bound(Time)};
       }
 
       std::pair<const_iterator,const_iterator> equal_range (const double &Time) const
       {
-        return BaseClass::equal_range(roundToTick(Time));
+        return {this->lower_bound(Time), this->upper_bound(Time)};
       }
 
       iterator emplace (const double &Time, const ObjectType &Object)
       {
-        return BaseClass::emplace(roundToTick(Time), Object);
+        const double Rounded = roundToTick(Time);
+
+        /** fast path: data arrives in time order */
+        if (Storage_.empty() || Storage_.back().first <= Rounded)
+        {
+          Storage_.emplace_back(Rounded, Object);
+          return std::prev(Storage_.end());
+        }
+
+        /** insert behind equal keys, like a multimap does */
+        return Storage_.emplace(this->upper_bound(Rounded), Rounded, Object);
       }
 
-      /** expose other functions */
-      using BaseClass::erase;
-      using BaseClass::begin;
-      using BaseClass::end;
-      using BaseClass::size;
-      using BaseClass::empty;
+      /** direct access to the n-th object of a tick */
+      ObjectType &at (const double &Time, const size_type Number)
+      {
+        return std::next(this->lower_bound(Time), static_cast<std::ptrdiff_t>(Number))->second;
+      }
+
+      const ObjectType &at (const double &Time, const size_type Number) const
+      {
+        return std::next(this->lower_bound(Time), static_cast<std::ptrdiff_t>(Number))->second;
+      }
+
+      /** remove objects */
+      void erase (const double &Time, const size_type Number)
+      {
+        this->erase(std::next(this->lower_bound(Time), static_cast<std::ptrdiff_t>(Number)));
+      }
+
+      iterator erase (const_iterator Position)
+      {
+        /** fast path: sliding windows remove the oldest element */
+        if (Position == Storage_.cbegin())
+        {
+          Storage_.pop_front();
+          return Storage_.begin();
+        }
+        return Storage_.erase(Position);
+      }
+
+      iterator erase (const_iterator First, const_iterator Last)
+      {
+        return Storage_.erase(First, Last);
+      }
+
+      size_type erase (const double &Time)
+      {
+        const auto Range = this->equal_range(Time);
+        const auto Count = static_cast<size_type>(std::distance(Range.first, Range.second));
+        Storage_.erase(Range.first, Range.second);
+        return Count;
+      }
+
+      /** remove all objects before Last in one pass, the deque releases the front without moving the rest */
+      size_type eraseFront (const_iterator Last)
+      {
+        const auto Count = static_cast<size_type>(std::distance(Storage_.cbegin(), Last));
+        Storage_.erase(Storage_.cbegin(), Last);
+        return Count;
+      }
+
+      iterator begin() {return Storage_.begin();}
+      const_iterator begin() const {return Storage_.begin();}
+      iterator end() {return Storage_.end();}
+      const_iterator end() const {return Storage_.end();}
+      size_type size() const {return Storage_.size();}
+      bool empty() const {return Storage_.empty();}
+
+      /** estimated bytes of the stream including the heap memory of its objects */
+      size_t getMemorySize() const
+      {
+        size_t Bytes = sizeof(*this);
+        for (const ValueType &Element : Storage_)
+        {
+          Bytes += sizeof(ValueType) - sizeof(ObjectType) + getObjectMemorySize(Element.second);
+        }
+        return Bytes;
+      }
+
+    private:
+      static bool CompareLower_(const ValueType &Element, const double Time)
+      {
+        return Element.first < Time;
+      }
+
+      static bool CompareUpper_(const double Time, const ValueType &Element)
+      {
+        return Time < Element.first;
+      }
+
+      StorageType Storage_;
   };
+
+  /** the default stream of all data sets is selected at compile time */
+#ifdef LIBRSF_CONTIGUOUS_DATASTREAM
+  template<typename ObjectType>
+  using DefaultDataStream = DataStreamContiguous<ObjectType>;
+#else
+  template<typename ObjectType>
+  using DefaultDataStream = DataStream<ObjectType>;
+#endif // LIBRSF_CONTIGUOUS_DATASTREAM
 }
 
 #endif // DATASTREAM_H
@@ -0,0 +1,56 @@
+/***************************************************************************
+ * libRSF - A Robust Sensor Fusion Library
+ *
+ * Copyright (C) 2018 Chair of Automation Technology / TU Chemnitz
+ * For more information see https://www.tu-chemnitz.de/etit/proaut/libRSF
+ *
+ * libRSF is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libRSF is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with libRSF.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Tim Pfeifer (tim.pfeifer@etit.tu-chemnitz.de)
+ ***************************************************************************/
+
+/**
+ * @file DenseGPU.h
+ * @author Tim Pfeifer
+ * @date 14.10.2026
+ * @brief Optional cuSOLVER backend for large dense decompositions.
+ * @copyright GNU Public License.
+ *
+ */
+
+#ifndef DENSEGPU_H
+#define DENSEGPU_H
+
+#include "VectorTypes.h"
+
+namespace libRSF
+{
+  /** smaller systems are faster on the CPU because of the transfer overhead */
+  constexpr Index DenseGPUMinSize = 256;
+
+  /** true if libRSF was build with LIBRSF_CUDA and a device is present */
+  bool IsDenseGPUAvailable();
+
+  /** \brief Solve A * X = B with a Cholesky decomposition on the GPU.
+   *
+   * \param A Symmetric positive definite matrix.
+   * \param B Right hand side, is overwritten with X.
+   * \return false if the GPU is not available, the system is smaller than DenseGPUMinSize or A is not positive definite.
+   * B is unchanged in this case.
+   *
+   */
+  bool SolveCholeskyGPU(const Matrix &A, Matrix &B);
+}
+
+#endif // DENSEGPU_H
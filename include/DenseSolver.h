@@ -0,0 +1,49 @@
+/***************************************************************************
+ * libRSF - A Robust Sensor Fusion Library
+ *
+ * Copyright (C) 2019 Chair of Automation Technology / TU Chemnitz
+ * For more information see https://www.tu-chemnitz.de/etit/proaut/libRSF
+ *
+ * libRSF is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libRSF is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with libRSF.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Tim Pfeifer (tim.pfeifer@etit.tu-chemnitz.de)
+ ***************************************************************************/
+
+/**
+ * @file DenseSolver.h
+ * @author Tim Pfeifer
+ * @date 14.10.2026
+ * @brief Levenberg-Marquardt on dense normal equations for tiny problems.
+ * @copyright GNU Public License.
+ *
+ */
+
+#ifndef DENSESOLVER_H
+#define DENSESOLVER_H
+
+#include "VectorMath.h"
+#include "TimeMeasurement.h"
+
+#include <ceres/ceres.h>
+
+#include <vector>
+
+namespace libRSF
+{
+  /** solves a ceres problem in place without the preprocessing of ceres::Solve, only for problems with a few parameters,
+   *  uses the iteration limits and tolerances of the trust region options and fills the main fields of the summary */
+  bool SolveDense(const ceres::Solver::Options &Options, ceres::Problem &Problem, ceres::Solver::Summary &Summary);
+}
+
+#endif // DENSESOLVER_H
@@ -0,0 +1,118 @@
+/***************************************************************************
+ * libRSF - A Robust Sensor Fusion Library
+ *
+ * Copyright (C) 2018 Chair of Automation Technology / TU Chemnitz
+ * For more information see https://www.tu-chemnitz.de/etit/proaut/libRSF
+ *
+ * libRSF is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libRSF is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with libRSF.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Tim Pfeifer (tim.pfeifer@etit.tu-chemnitz.de)
+ ***************************************************************************/
+
+/**
+ * @file Evaluation.h
+ * @author Tim Pfeifer
+ * @date 14.10.2026
+ * @brief Trajectory errors (ATE, RPE, percentiles) of estimates against a ground truth.
+ * @copyright GNU Public License.
+ *
+ */
+
+#ifndef EVALUATION_H
+#define EVALUATION_H
+
+#include "SensorDataSet.h"
+#include "StateDataSet.h"
+
+#include <limits>
+#include <string>
+#include <vector>
+
+namespace libRSF
+{
+  struct EvaluationConfig
+  {
+    /** estimates that are further away from the closest ground truth are not evaluated */
+    double MaxTimeDifference = std::numeric_limits<double>::infinity();
+
+    /** time between the two estimates of a relative error, zero uses consecutive estimates */
+    double RPEDelta = 1.0;
+  };
+
+  /** errors of one trajectory, all in the unit of the positions */
+  struct TrajectoryError
+  {
+    int Matched = 0;
+
+    /** absolute trajectory error, the RMSE of the euclidean distances */
+    double ATE = std::numeric_limits<double>::quiet_NaN();
+    double Mean = std::numeric_limits<double>::quiet_NaN();
+    double Median = std::numeric_limits<double>::quiet_NaN();
+    double Percentile90 = std::numeric_limits<double>::quiet_NaN();
+    double Percentile95 = std::numeric_limits<double>::quiet_NaN();
+    double Percentile99 = std::numeric_limits<double>::quiet_NaN();
+    double Max = std::numeric_limits<double>::quiet_NaN();
+
+    /** relative pose error (translation), the RMSE of the drift over RPEDelta */
+    int RPEPairs = 0;
+    double RPE = std::numeric_limits<double>::quiet_NaN();
+  };
+
+  /** positions of one type in temporal order, extracted once and shared by all evaluations */
+  struct Trajectory
+  {
+    std::vector<double> Time;
+    Matrix Position; /**< one row per timestamp */
+
+    [[nodiscard]] bool empty() const {return Time.empty();}
+  };
+
+  /** only the first object of each timestamp is used */
+  Trajectory ExtractTrajectory(const SensorDataSet &Set, DataType Type);
+  Trajectory ExtractTrajectory(const StateDataSet &Set, const std::string &Type);
+
+  /** each estimate is compared with the closest ground truth, both are joined in a single linear pass */
+  TrajectoryError EvaluateTrajectory(const Trajectory &GT,
+                                     const Trajectory &Estimate,
+                                     const EvaluationConfig &Config = EvaluationConfig());
+
+  TrajectoryError EvaluateTrajectory(const SensorDataSet &GT,
+                                     DataType TypeGT,
+                                     const StateDataSet &Estimate,
+                                     const std::string &TypeEstimate,
+                                     const EvaluationConfig &Config = EvaluationConfig());
+
+  /** many estimates against the same ground truth, evaluated in parallel, ThreadNumber <= 0 uses all cores */
+  std::vector<TrajectoryError> EvaluateTrajectories(const SensorDataSet &GT,
+                                                    DataType TypeGT,
+                                                    const std::vector<const StateDataSet*> &Estimates,
+                                                    const std::string &TypeEstimate,
+                                                    const EvaluationConfig &Config = EvaluationConfig(),
+                                                    int ThreadNumber = 0);
+
+  /** binary result files (see WriteResultToBinaryFile), read and evaluated in parallel,
+   *  files that can not be read or evaluated return an error with zero matches */
+  std::vector<TrajectoryError> EvaluateResultFiles(const SensorDataSet &GT,
+                                                   DataType TypeGT,
+                                                   const std::vector<std::string> &ResultFiles,
+                                                   const std::string &TypeEstimate,
+                                                   const EvaluationConfig &Config = EvaluationConfig(),
+                                                   int ThreadNumber = 0);
+
+  /** text or binary ground truth, a text file is converted once into a binary copy next to it (Filename.bin),
+   *  which is used as long as it is not older than the text file */
+  bool ReadGroundTruth(const std::string &Filename, SensorDataSet &GT, bool CacheBinary = true);
+}
+
+#endif // EVALUATION_H
@@ -32,18 +32,32 @@
 #ifndef FACTORGRAPH_H
 #define FACTORGRAPH_H
 
+#include "BackendSelection.h"
 #include "CalculateCovariance.h"
 #include "FactorIDSet.h"
+#include "FactorPool.h"
 #include "FactorGraphSampling.h"
 #include "FileAccess.h"
 #include "FactorGraphStructure.h"
 #include "DataSet.h"
+#include "DenseSolver.h"
 #include "LocalParametrization.h"
 #include "Marginalization.h"
+#include "MarginalCovariance.h"
+#include "IncrementalCovariance.h"
+#include "Metrics.h"
+#include "ResidualCache.h"
+#include "SatelliteStore.h"
+#include "SharedObjects.h"
 #include "StateDataSet.h"
+#include "StatePublisher.h"
 #include "SensorDataSet.h"
 #include "Types.h"
 #include "TimeMeasurement.h"
+#include "Tracing.h"
+#include "Checkpoint.h"
+#include "GraphTrace.h"
+#include "ThreadPool.h"
 
 #include "error_models/ErrorModel.h"
 #include "error_models/Gaussian.h"
@@ -55,6 +69,9 @@
 #include "error_models/DynamicCovarianceEstimation.h"
 
 #include "factors/BaseFactor.h"
+#include "factors/AnalyticCostFunction.h"
+#include "factors/LinearCostFunction.h"
+#include "factors/TimedCostFunction.h"
 #include "factors/ConstantValueFactor.h"
 #include "factors/ConstantDriftFactor.h"
 #include "factors/ConstantQuaternionFactor.h"
@@ -62,6 +79,7 @@
 #include "factors/RangeFactor.h"
 #include "factors/RangeToPointFactor.h"
 #include "factors/PseudorangeFactor.h"
+#include "factors/PseudorangeEpochFactor.h"
 #include "factors/OdometryFactor2D.h"
 #include "factors/OdometryFactor2DDifferential.h"
 #include "factors/OdometryFactor3D.h"
@@ -77,11 +95,17 @@
 #include "factors/MarginalPrior.h"
 #include "factors/PointRegistrationFactor.h"
 #include "factors/PressureDifferenceFactor.h"
+#include "factors/BSplineFactor.h"
 
 #include <ceres/ceres.h>
 #include <ceres/normal_prior.h>
 
+#include <array>
+#include <memory>
+#include <set>
 #include <thread>
+#include <typeinfo>
+#include <type_traits>
 
 namespace libRSF
 {
@@ -91,15 +115,181 @@ namespace libRSF
     StateList() = default;
     virtual ~StateList() = default;
 
-    void add(const string& Type, double Timestamp, int Number = 0);
+    void add(const StateKey &Type, double Timestamp, int Number = 0);
     void add(const StateID&);
     void clear();
 
     std::vector<StateID> List_;
   };
 
+  /** number of state IDs in the parameters of FactorGraph::addFactor(), known at compile time */
+  template <typename... Types>
+  constexpr size_t CountStateIDs()
+  {
+    return (static_cast<size_t>(std::is_same_v<std::decay_t<Types>, StateID>) + ... + 0);
+  }
+
+  /** estimated memory of a graph in bytes */
+  struct MemoryUsage
+  {
+    size_t StateData = 0;
+    size_t SensorData = 0;
+    size_t Structure = 0;
+    size_t Factors = 0;                           /**< factors, cost functions and error models */
+    std::map<StateKey, size_t> StatesPerName;
+    std::map<FactorType, size_t> FactorsPerType;  /**< marginal priors are listed as FactorType::Marginal */
+
+    [[nodiscard]] size_t getTotal() const
+    {
+      return StateData + SensorData + Structure + Factors;
+    }
+  };
+
+  /** progress of one solver iteration, iteration zero is the initial evaluation */
+  struct SolverIteration
+  {
+    int Solve = 0;                    /**< counts the solves of a graph */
+    int Iteration = 0;
+    double Cost = 0.0;
+    double GradientNorm = 0.0;
+    double StepNorm = 0.0;
+    double TrustRegionRadius = 0.0;
+    bool StepSuccessful = false;
+    int LinearSolverIterations = 0;
+    double LinearSolverTime = 0.0;    /**< seconds to compute the step */
+    double EvaluationTime = 0.0;      /**< seconds of the iteration that were not spent in the linear solver, mainly the evaluation of residuals and Jacobians */
+
+    /** as DataType::SolverIteration */
+    [[nodiscard]] Data toData(double Timestamp) const;
+  };
+
+  /** summary of all factors of one type */
+  struct FactorStatistics
+  {
+    int Count = 0;
+    double Cost = 0.0;                /**< weighted cost including loss functions */
+    double ResidualRMS = 0.0;         /**< RMS of the unweighted errors */
+    double EvaluationTime = 0.0;      /**< cumulative evaluation time in seconds, only with enabled timing */
+    long long Evaluations = 0;
+  };
+
+  /** the cost function that wraps a factor, constant or hand-written derivatives are used if available */
+  template <typename ErrorType, typename FactorClass,
+            typename FactorDims = typename FactorClass::StateDims, typename ErrorDims = typename ErrorType::StateDims>
+  struct CostFunctionSelector;
+
+  template <typename ErrorType, typename FactorClass, int... FactorStateDims, int... ErrorModelStateDims>
+  struct CostFunctionSelector<ErrorType, FactorClass, std::integer_sequence<int, FactorStateDims...>, std::integer_sequence<int, ErrorModelStateDims...>>
+  {
+    using Type = std::conditional_t<UseLinearJacobian<FactorClass, ErrorType>(),
+                                    LinearCostFunction<FactorClass, ErrorType, FactorStateDims..., ErrorModelStateDims...>,
+                 std::conditional_t<UseAnalyticJacobian<FactorClass, ErrorType>(),
+                                    AnalyticCostFunction<FactorClass, ErrorType, FactorStateDims..., ErrorModelStateDims...>,
+                                    ceres::AutoDiffCostFunction<FactorClass, ErrorType::OutputDim, FactorStateDims..., ErrorModelStateDims...>>>;
+  };
+
+  class FactorGraph;
+
+  /** \brief Factors that are collected first and added to a graph at once with FactorGraph::addFactors().
+   *
+   * The factors and their cost functions are constructed in parallel, the graph is changed in one serial pass.
+   * Predictions and the numbering of the factors follow the order of add(), like a sequence of addFactor() calls.
+   */
+  class FactorBatch
+  {
+    public:
+      FactorBatch() = default;
+      ~FactorBatch() = default;
+
+      FactorBatch(const FactorBatch&) = delete;
+      FactorBatch& operator=(const FactorBatch&) = delete;
+
+      template <FactorType CurrentFactorType, typename ErrorType>
+      void add(const StateList &States, const Data &Measurement, const ErrorType &NoiseModel,
+               ceres::LossFunction* RobustLoss, bool DoPrediction = true);
+
+      template <FactorType CurrentFactorType, typename ErrorType>
+      void add(const StateList &States, const Data &Measurement, const ErrorType &NoiseModel, const bool DoPrediction = true)
+      {
+        this->add<CurrentFactorType>(States, Measurement, NoiseModel, nullptr, DoPrediction);
+      }
+
+      template <FactorType CurrentFactorType, typename ErrorType>
+      void add(const StateList &States, const ErrorType &NoiseModel, const bool DoPrediction = true)
+      {
+        this->add<CurrentFactorType>(States, Data(DataType::Value1, 0.0), NoiseModel, nullptr, DoPrediction);
+      }
+
+      void reserve(const size_t Factors)
+      {
+        Order_.reserve(Factors);
+      }
+
+      [[nodiscard]] size_t size() const
+      {
+        return Order_.size();
+      }
+
+      [[nodiscard]] bool empty() const
+      {
+        return Order_.empty();
+      }
+
+      void clear()
+      {
+        Stages_.clear();
+        Order_.clear();
+        LastStage_ = nullptr;
+      }
+
+    private:
+      friend class FactorGraph;
+
+      /** all factors of one type and error model */
+      class StageBase
+      {
+        public:
+          virtual ~StageBase() = default;
+
+          /** state lookup and construction of all factors */
+          virtual void prepare(FactorGraph &Graph, int ThreadNumber) = 0;
+
+          /** add a single prepared factor to the graph */
+          virtual void commit(FactorGraph &Graph, size_t Index) = 0;
+      };
+
+      template <FactorType CurrentFactorType, typename ErrorType>
+      class Stage : public StageBase
+      {
+        public:
+          using FactorClassType = typename FactorTypeTranslator<CurrentFactorType, ErrorType>::Type;
+
+          void prepare(FactorGraph &Graph, int ThreadNumber) override;
+          void commit(FactorGraph &Graph, size_t Index) override;
+
+          /** input */
+          std::vector<StateList> States;
+          std::vector<Data> Measurements;
+          std::vector<ErrorType> NoiseModels;
+          std::vector<ceres::LossFunction*> RobustLosses;
+          std::vector<bool> Predictions;
+
+          /** output of prepare() */
+          std::vector<std::vector<double*>> StatePointers;
+          std::vector<std::vector<DataType>> StateTypes;
+          std::vector<FactorClassType*> Factors;
+          std::vector<ceres::CostFunction*> CostFunctions;
+      };
+
+      std::vector<std::unique_ptr<StageBase>> Stages_;
+      std::vector<std::pair<StageBase*, size_t>> Order_;
+      StageBase* LastStage_ = nullptr;
+  };
+
   class FactorGraph
   {
+    friend class FactorBatch;
+
     public:
       /** Default constructor */
       FactorGraph();
@@ -107,11 +297,11 @@ namespace libRSF
       virtual ~FactorGraph() = default;
 
       /** access to single states */
-      void addState(const string& Name, DataType Type, double Timestamp);
-      void addState(const string& Name, Data &Element);
+      void addState(const StateKey &Name, DataType Type, double Timestamp);
+      void addState(const StateKey &Name, Data &Element);
 
       /** add states only if they doesn't exist */
-      void addStateWithCheck(const string& Name, DataType Type, double Timestamp);
+      void addStateWithCheck(const StateKey &Name, DataType Type, double Timestamp);
 
       /** access to complete state data */
       StateDataSet& getStateData();
@@ -159,85 +349,252 @@ namespace libRSF
         setNewErrorModel(ModelPointers, NoiseModel);
       }
 
-      /** add factors with variable number of states - first level*/
+      /** add factors with variable number of states - first level, the parameters are passed by reference through all levels */
       template <FactorType CurrentFactorType, typename... FactorParameters>
       void addFactor( const StateID& ID1,
-                      FactorParameters... Params)
+                      FactorParameters&&... Params)
       {
         /** compile time error for IMU pre-integration */
         static_assert(CurrentFactorType != FactorType::IMUPretintegration, "Do not use the default factor interface for IMU pre-integration factor! Use addIMUPreintegrationFactor() instead!");
+        static_assert(CurrentFactorType != FactorType::Pseudorange3_Epoch, "Do not use the default factor interface for the pseudorange epoch factor! Use addPseudorangeEpochFactor() instead!");
+        static_assert(CurrentFactorType != FactorType::Point2Reg_Scan, "Do not use the default factor interface for the scan registration factor! Use addPoint2ScanRegistrationFactor() instead!");
 
+        /** the number of states is known, so the list is allocated once */
         StateList List;
+        List.List_.reserve(1 + CountStateIDs<FactorParameters...>());
         List.add(ID1);
-        addFactor<CurrentFactorType>(List, Params...);
+        collectStates_<CurrentFactorType>(List, Params...);
       }
 
-      /** in-between level */
+      /** in-between level for an existing list of states, which is copied once */
       template <FactorType CurrentFactorType, typename... FactorParameters>
-      void addFactor(StateList List,
+      void addFactor(const StateList &Existing,
                      const StateID& ID,
-                     FactorParameters... Params)
+                     FactorParameters&&... Params)
       {
-        /** move state ID into a state list */
+        StateList List;
+        List.List_.reserve(Existing.List_.size() + 1 + CountStateIDs<FactorParameters...>());
+        List.List_ = Existing.List_;
         List.add(ID);
-        /** evaluate parameter pack again */
-        addFactor<CurrentFactorType>(List, Params...);
+        collectStates_<CurrentFactorType>(List, Params...);
       }
 
       /** last level without measurement*/
       template <FactorType CurrentFactorType, typename ErrorType>
-      void addFactor(StateList List,
-                     ErrorType &NoiseModel,
+      void addFactor(const StateList &List,
+                     const ErrorType &NoiseModel,
                      ceres::LossFunction* RobustLoss,
                      const bool DoPrediction = true)
       {
         addFactorBase_<CurrentFactorType>(List, NoiseModel, Data(DataType::Value1, 0.0), RobustLoss, DoPrediction);
       }
       template <FactorType CurrentFactorType, typename ErrorType>
-      void addFactor(StateList List,
-                     ErrorType &NoiseModel,
+      void addFactor(const StateList &List,
+                     const ErrorType &NoiseModel,
                      const bool DoPrediction = true)
       {
         addFactorBase_<CurrentFactorType>(List, NoiseModel, Data(DataType::Value1, 0.0), nullptr, DoPrediction);
       }
       /** last level with measurement */
       template <FactorType CurrentFactorType, typename ErrorType>
-      void addFactor(StateList List,
+      void addFactor(const StateList &List,
                      const Data &Measurement,
-                     ErrorType &NoiseModel,
+                     const ErrorType &NoiseModel,
                      ceres::LossFunction* RobustLoss,
                      const bool DoPrediction = true)
       {
         addFactorBase_<CurrentFactorType>(List, NoiseModel, Measurement, RobustLoss, DoPrediction);
       }
       template <FactorType CurrentFactorType, typename ErrorType>
-      void addFactor(StateList List,
+      void addFactor(const StateList &List,
                      const Data &Measurement,
-                     ErrorType &NoiseModel,
+                     const ErrorType &NoiseModel,
                      const bool DoPrediction = true)
       {
         addFactorBase_<CurrentFactorType>(List, NoiseModel, Measurement, nullptr, DoPrediction);
       }
 
+      /** one loss function per type and parameters for all factors of this graph, individually created losses are owned by the graph as well */
+      template <typename LossType, typename... ParameterTypes>
+      ceres::LossFunction* getSharedLoss(const ParameterTypes&... Parameters)
+      {
+        return Losses_.get<LossType>(Parameters...);
+      }
+
+      /** capacity hint for the expected total number of states and factors, e.g. for offline problems */
+      void reserve(size_t States, size_t Factors);
+
+      /** re-insert all factors ordered by time, so that the evaluation visits nearby states one after another */
+      void optimizeLayout();
+
+      /** add all factors of a batch, zero threads uses all cores, the batch is empty afterwards */
+      void addFactors(FactorBatch &Batch, int ThreadNumber = 0);
+
+      /** drop eigen directions of new marginal priors with less than this fraction of the strongest information, zero keeps all */
+      void setMarginalCompression(double MinEigenRatio);
+
       /** special case for IMU pre-integration */
       void addIMUPreintegrationFactor(StateList List, const PreintegratedIMUResult& IMUState);
 
+      /** re-integrate IMU factors before solving, if their bias estimate moved more than this from the linearization point, zero disables it */
+      void setIMURelinearizationThreshold(double Threshold);
+
+      /** satellite positions of the pseudorange factors, can be shared between graphs of the same data */
+      void setSatelliteStore(std::shared_ptr<SatelliteStore> Satellites);
+      [[nodiscard]] std::shared_ptr<SatelliteStore> getSatelliteStore() const;
+
+      /** special function for all pseudo ranges of one epoch in a single factor */
+      template <typename ErrorType>
+      void addPseudorangeEpochFactor(const StateID &Position,
+                                     const StateID &ClockError,
+                                     const std::vector<Data> &Pseudoranges,
+                                     const ErrorType &NoiseModel,
+                                     const bool WeightWithCovariance)
+      {
+        if (Pseudoranges.empty())
+        {
+          PRINT_WARNING("No pseudo ranges for the epoch factor at ", ClockError.getTimestamp());
+          return;
+        }
+        if (Trace_ != nullptr)
+        {
+          this->traceUnsupported_("pseudorange epoch factor");
+        }
+
+        const std::vector<StateID> StateList = {Position, ClockError};
+        std::vector<double*> StatePointers;
+        std::vector<DataType> StateTypes;
+        for (const StateID &State : StateList)
+        {
+          StatePointers.emplace_back(StateData_.getElement(State.ID, State.getTimestamp(), State.Number).getMeanPointer());
+          StateTypes.emplace_back(StateData_.getElement(State.ID, State.getTimestamp(), State.Number).getType());
+        }
+
+        auto* Factor = Pool_.create<PseudorangeEpochFactor<ErrorType>>(FactorType::Pseudorange3_Epoch, NoiseModel, Pseudoranges, WeightWithCovariance);
+        const ceres::ResidualBlockId CeresID = Graph_.AddResidualBlock(this->wrapCostFunction_(FactorType::Pseudorange3_Epoch, Factor), nullptr, StatePointers);
+
+        Structure_.addFactor<ErrorType>(FactorType::Pseudorange3_Epoch,
+                                        ClockError.getTimestamp(),
+                                        CeresID,
+                                        Factor->getErrorModel(),
+                                        StateList,
+                                        StatePointers,
+                                        StateTypes);
+      }
+
+      /** special function for all point correspondences of one scan pair in a single factor, Weights is empty or has one entry per point */
+      template <typename ErrorType>
+      void addPoint2ScanRegistrationFactor(const StateID &Position1,
+                                           const StateID &Yaw1,
+                                           const StateID &Position2,
+                                           const StateID &Yaw2,
+                                           const std::vector<Data> &Correspondences,
+                                           const ErrorType &NoiseModel,
+                                           const Vector &Weights = Vector())
+      {
+        if (Correspondences.empty())
+        {
+          PRINT_WARNING("No correspondences for the scan registration factor at ", Position2.getTimestamp());
+          return;
+        }
+        if (Trace_ != nullptr)
+        {
+          this->traceUnsupported_("scan registration factor");
+        }
+
+        const std::vector<StateID> StateList = {Position1, Yaw1, Position2, Yaw2};
+        std::vector<double*> StatePointers;
+        std::vector<DataType> StateTypes;
+        for (const StateID &State : StateList)
+        {
+          StatePointers.emplace_back(StateData_.getElement(State.ID, State.getTimestamp(), State.Number).getMeanPointer());
+          StateTypes.emplace_back(StateData_.getElement(State.ID, State.getTimestamp(), State.Number).getType());
+        }
+
+        auto* Factor = Pool_.create<Point2ScanRegistrationFactor<ErrorType>>(FactorType::Point2Reg_Scan, NoiseModel, Correspondences, Weights);
+        const ceres::ResidualBlockId CeresID = Graph_.AddResidualBlock(this->wrapCostFunction_(FactorType::Point2Reg_Scan, Factor), nullptr, StatePointers);
+
+        Structure_.addFactor<ErrorType>(FactorType::Point2Reg_Scan,
+                                        Position1.getTimestamp(),
+                                        CeresID,
+                                        Factor->getErrorModel(),
+                                        StateList,
+                                        StatePointers,
+                                        StateTypes);
+      }
+
+      /** linear prior around a given mean with the sqrt-information in the tangent space, it is listed as FactorType::StatePrior */
+      bool addStatePrior(const StateID &State, const Vector &Mean, const Matrix &SqrtInformation);
+
       /** for sliding window */
       void removeFactor(FactorType CurrentFactorType, double Timestamp);
+      void removeFactor(FactorType CurrentFactorType, double Timestamp, int Number);
       void removeFactorsOutsideWindow(FactorType CurrentFactorType, double TimeWindow, double CurrentTime);
       void removeAllFactorsOutsideWindow(double TimeWindow, double CurrentTime);
 
+      /** remove all states and factors up to the given time in one pass */
+      void removeBefore(double Time);
+
       /** solve problem */
       void solve();
       void solve(ceres::Solver::Options Options);
 
+      /** solve until the deadline at most, returns false if the solver was stopped by it */
+      bool solve(ceres::Solver::Options Options, const Deadline &Limit);
+
+      /** solve only the part of the problem that changed since the last solve */
+      void solveIncremental();
+      void solveIncremental(ceres::Solver::Options Options);
+
+      /** solve groups of factors that share no variable state as separate problems in parallel, returns the number of groups */
+      int solveComponents();
+      int solveComponents(ceres::Solver::Options Options);
+
+      /** start each solve from the trust region of the previous one and extrapolate new states */
+      void setWarmStart(bool Enable);
+
+      /** eliminate landmarks before poses and switch sparse Cholesky to the Schur complement if there are any */
+      void setLandmarksFirst(bool Enable);
+
+      /** for ITERATIVE_SCHUR without landmarks: eliminate every second epoch, so the reduced system stays a chain in time */
+      void setTimeChainOrdering(bool Enable);
+
+      /** states of an exempt name are neither marginalized nor removed by the *AllStatesOutsideWindow functions,
+       *  e.g. landmarks at timestamp zero whose lifetime is managed by a LandmarkManager */
+      void setWindowExempt(const StateKey &Name, bool Exempt = true);
+      [[nodiscard]] bool isWindowExempt(const StateKey &Name) const;
+
+      /** first timestamp of all states that are not exempt from the window */
+      bool getTimeFirstInWindow(double &Timestamp) const;
+
+      /** solve problems with at most this many parameters by a dense Levenberg-Marquardt without ceres overhead, zero disables it */
+      void setDenseSolverThreshold(int MaxParameters);
+
+      /** the newest estimates of the publisher's states are exported after every solve, nullptr disables it */
+      void setStatePublisher(std::shared_ptr<StatePublisher> Publisher);
+
+      /** export again, e.g. after the covariance was estimated */
+      void publishStates() const;
+
+      /** durations of solver, marginalization and covariance are recorded into these metrics, nullptr disables it */
+      void setMetrics(std::shared_ptr<GraphMetrics> Metrics);
+
       /** compute covariances */
-      bool computeCovarianceSigmaPoints(const string& Name, double Timestamp, int StateNumber = 0);
-      bool computeCovariance(const string& Name, double Timestamp);
-      bool computeCovariance(const string& Name);
+      bool computeCovarianceSigmaPoints(const StateKey &Name, double Timestamp, int StateNumber = 0);
+      bool computeCovarianceSigmaPoints(const std::vector<StateID> &States);
+      bool computeCovariance(const StateKey &Name, double Timestamp);
+      bool computeCovariance(const StateKey &Name);
+      bool computeCovariances(const std::vector<string>& Names, std::vector<CrossCovariance>* CrossCovariances = nullptr);
+
+      /** marginal covariances from a factorization that is reused until the graph changes */
+      bool computeMarginalCovariance(const StateKey &Name, double Timestamp);
+      bool computeMarginalCovariance(const StateKey &Name);
+
+      /** marginal covariance of the newest states, propagated from the previous epoch and anchored by computeMarginalCovariance */
+      bool computeCovarianceIncremental(const StateKey &Name, double Timestamp);
 
       /** marginalize factors */
-      bool marginalizeState(const string& Name, double Timestamp, int Number = 0);
+      bool marginalizeState(const StateKey &Name, double Timestamp, int Number = 0);
       bool marginalizeStates(std::vector<StateID> States, double Inflation = 1.0);
       bool marginalizeAllStatesOutsideWindow(double TimeWindow, double CurrentTime, double Inflation = 1.0);
 
@@ -248,56 +605,79 @@ namespace libRSF
                         int PointCount,
                         double Range,
                         StateDataSet &Result,
-                        const bool OptimizeOther = false);
+                        const bool OptimizeOther = false,
+                        bool ComputeHessian = true);
 
       void sampleCost2D(const string& StateName,
                         double Timestamp,
                         int Number,
                         int PointCount,
                         double Range,
-                        StateDataSet &Result);
+                        StateDataSet &Result,
+                        bool ComputeHessian = true);
 
       void sampleCost3D(const string& StateName,
                         double Timestamp,
                         int Number,
                         int PointCount,
                         double Range,
-                        StateDataSet &Result);
+                        StateDataSet &Result,
+                        bool ComputeHessian = true);
+
+      /** adaptively refined sampling of a 1D to 3D state with at most PointBudget evaluations, see EvaluateCostSurfaceAdaptive() */
+      void sampleCostAdaptive(const string& StateName,
+                              double Timestamp,
+                              int Number,
+                              int PointBudget,
+                              double Range,
+                              StateDataSet &Result,
+                              bool ComputeHessian = true);
 
       /** remove old states*/
-      void removeState(const string& Name, double Timestamp);
-      void removeState(const string& Name, double Timestamp, int Number);
-      void removeStatesOutsideWindow(const string& Name, double TimeWindow, double CurrentTime);
+      void removeState(const StateKey &Name, double Timestamp);
+      void removeState(const StateKey &Name, double Timestamp, int Number);
+      void removeStatesOutsideWindow(const StateKey &Name, double TimeWindow, double CurrentTime);
       void removeAllStatesOutsideWindow(double TimeWindow, double CurrentTime);
 
+      /** remove a set of states and their factors with a single update of the graph structure */
+      bool removeStates(const std::vector<StateID> &States);
+
+      /** remove all states and factors and restore the default settings, the allocated memory is kept for the next run */
+      void reset();
+
       /** handle constant states */
-      void setConstant(const string& Name, double Timestamp);
-      void setVariable(const string& Name, double Timestamp);
-      void setVariable(const string& Name);
+      void setConstant(const StateKey &Name, double Timestamp);
+      void setVariable(const StateKey &Name, double Timestamp);
+      void setVariable(const StateKey &Name);
 
-      void setSubsetConstant(const string& Name, double Timestamp, int Number, const std::vector<int> &ConstantIndex);
+      void setSubsetConstant(const StateKey &Name, double Timestamp, int Number, const std::vector<int> &ConstantIndex);
 
-      void setConstantOutsideWindow(const string& Name, double TimeWindow, double CurrentTime);
-      void setVariableInsideWindow(const string& Name, double TimeWindow, double CurrentTime);
+      void setConstantOutsideWindow(const StateKey &Name, double TimeWindow, double CurrentTime);
+      void setVariableInsideWindow(const StateKey &Name, double TimeWindow, double CurrentTime);
       void setAllConstantOutsideWindow(double TimeWindow, double CurrentTime);
       void setAllVariableInsideWindow(double TimeWindow, double CurrentTime);
       void setAllVariable();
 
       /** handle bound */
-      void setUpperBound(const string &Name, double Timestamp, int StateNumber, const Vector &Bound);
-      void setLowerBound(const string &Name, double Timestamp, int StateNumber, const Vector &Bound);
+      void setUpperBound(const StateKey &Name, double Timestamp, int StateNumber, const Vector &Bound);
+      void setLowerBound(const StateKey &Name, double Timestamp, int StateNumber, const Vector &Bound);
 
       /** get information about the structure */
-      void getFactorsOfState(const string& Name, double Timestamp, int Number, std::vector<FactorID> &Factors) const;
+      void getFactorsOfState(const StateKey &Name, double Timestamp, int Number, std::vector<FactorID> &Factors) const;
       int countFactorsOfType(FactorType CurrentFactorType) const;
 
       /** compute overall error error models */
       double getCost();
+      /** evaluate only the factors of one type directly through their cost functions, returns 0.5*|r|^2 without loss functions */
+      double evaluateFactors(FactorType CurrentFactorType, bool ComputeJacobians = false) const;
 
-      /** compute raw errors without error models */
+      /** compute raw errors without error models, different factor types can be evaluated and get new error models concurrently,
+       *  the shared cache of raw errors is locked during its lookups and stores */
       void computeUnweightedError(FactorType CurrentFactorType, std::vector<double> &ErrorData);
       void computeUnweightedErrorMatrix(FactorType CurrentFactorType, Matrix &ErrorMatrix);
-      void computeUnweightedError(FactorType CurrentFactorType, const string &Name, StateDataSet &ErrorData);
+      /** only the factors after TimeBegin, TimeEnd returns the newest evaluated timestamp */
+      void computeUnweightedErrorMatrix(FactorType CurrentFactorType, double TimeBegin, Matrix &ErrorMatrix, double &TimeEnd);
+      void computeUnweightedError(FactorType CurrentFactorType, const StateKey &Name, StateDataSet &ErrorData);
       void computeUnweightedError(FactorType CurrentFactorType, double Time, int Number, Vector &Error);
 
       /** access solver options */
@@ -306,67 +686,200 @@ namespace libRSF
 
       /** access solver summary */
       void printReport() const;
+      /** per-type breakdown, timing has to be enabled before the factors are added */
+      void setFactorTiming(bool Enable);
+      void resetFactorTiming();
+      std::map<FactorType, FactorStatistics> getFactorStatistics();
+      void printFactorStatistics();
+
+      /** memory breakdown, the sensor data is not part of the graph and can be added optionally */
+      MemoryUsage getMemoryUsage(const SensorDataSet *SensorData = nullptr) const;
+      void printMemoryUsage(const SensorDataSet *SensorData = nullptr) const;
+
+      /** binary checkpoints for a fast restart, only factors that were added during the recording can be stored */
+      void setCheckpointRecording(bool Enable);
+      bool saveCheckpoint(const string &Filename);
+      /** requires an empty graph, factors are rebuilt without prediction and the recording continues */
+      bool loadCheckpoint(const string &Filename);
+
+      /** record all mutating calls with their arguments into a binary trace, IMU and pseudorange epoch factors are not recorded */
+      bool startTrace(const string &Filename);
+      void stopTrace();
+      /** re-execute a trace on an empty graph, the duration of every operation is returned optionally */
+      bool replayTrace(const string &Filename, std::vector<TraceTiming> *Timings = nullptr);
+
       ceres::Solver::Summary getSolverSummary() const;
       int getSolverIterationsAndReset();
       double getSolverDurationAndReset();
       double getMarginalDurationAndReset();
       double getCovarianceDurationAndReset();
+      int getDeadlineMissesAndReset();
+
+      /** benchmark the sparse linear backends once per kind of graph and use the fastest, disabled by default */
+      void setBackendSelection(bool Enable, int BenchmarkIterations = 3);
+
+      /** per-iteration telemetry of all solves since the last call, recording is disabled by default */
+      void setIterationTelemetry(bool Enable);
+      void getIterationTelemetryAndReset(std::vector<SolverIteration> &Iterations);
 
     private:
+      /** call ceres with the given (maybe temporary) options */
+      void solve_(const ceres::Solver::Options &Options);
+
+      /** the fastest backend for the current structure, returns false if the options are kept */
+      bool selectLinearBackend_(const ceres::Solver::Options &Options, ceres::Solver::Options &Selected);
+
+      /** landmarks go in group 0, all other states in group 1, returns false without two non-empty groups */
+      bool getEliminationOrdering_(ceres::ParameterBlockOrdering &Ordering) const;
+
+      /** states of odd epochs go in group 0, the rest in group 1, returns false with less than three epochs */
+      bool getTimeChainOrdering_(ceres::ParameterBlockOrdering &Ordering) const;
+
+      /** initialize a new state from the previous ones of the same key */
+      void extrapolateState_(const StateKey &Name, double Timestamp, int Number);
+
+      /** IMU pre-integration with a bias that is far from the current estimate is repeated */
+      void addIMUPreintegrationFactor_(const StateList &List, const PreintegratedIMUResult& IMUState, bool DoPrediction);
+      void relinearizeIMUPreintegration_();
+
+      /** state lookup that checks the recently added states first */
+      double* getStatePointer_(const StateID &State, DataType &Type);
+      void cacheState_(const StateID &State, double* Mean, DataType Type);
+
+      /** bulk removal, factors are removed before states to track the connected states */
+      void removeFactorsBefore_(double CutTime);
+      void removeStatesBefore_(double CutTime, bool KeepExempt = false);
+      /** without RemoveData, the caller has to erase the states from the data set */
+      bool removeStates_(std::vector<StateID> States, bool RemoveData = true);
+
+      /** remove blocks from ceres and recycle their cost functions */
+      void removeResidualBlock_(ceres::ResidualBlockId CeresID);
 
-      /** helper function to create variadic templated cost functions */
-      template<int NoiseModelOutputDim, typename FactorClass,  int... FactorStateDims, int... ErrorModelStateDims>
-      auto makeAutoDiffCostFunction_(FactorClass *Factor, std::integer_sequence<int, FactorStateDims...>, std::integer_sequence<int, ErrorModelStateDims...>)
+      /** priors from marginalization, the record is kept for checkpoints */
+      struct MarginalRecord
       {
-        return new ceres::AutoDiffCostFunction<FactorClass, NoiseModelOutputDim, FactorStateDims... , ErrorModelStateDims...> (Factor);
+        std::vector<StateID> States;
+        std::vector<int> LocalSize;
+        std::vector<int> GlobalSize;
+        std::vector<Vector> LinearizationPoints;
+        std::vector<DataType> Types;
+        Matrix Jacobian;
+        Vector Residual;
+      };
+      void addMarginalPrior_(const std::shared_ptr<MarginalRecord> &Record, const std::vector<double*> &StatePointers,
+                             FactorType Type = FactorType::Marginal);
+
+      /** raw errors of the given factors with one column per error, the error models are bypassed only on the evaluating threads */
+      void computeRawErrors_(const std::vector<ceres::ResidualBlockId> &IDs, int InputSize, int OutputSize, Matrix &Errors);
+      void removeParameterBlock_(double* State);
+
+      /** helper function to create variadic templated cost functions together with their factor */
+      template<int NoiseModelOutputDim, typename FactorClass,  int... FactorStateDims, int... ErrorModelStateDims, typename... FactorArguments>
+      auto makeAutoDiffCostFunction_(const FactorType Type, FactorClass* &Factor,
+                                     std::integer_sequence<int, FactorStateDims...>, std::integer_sequence<int, ErrorModelStateDims...>,
+                                     FactorArguments&&... Arguments)
+      {
+        using CostFunctionType = ceres::AutoDiffCostFunction<FactorClass, NoiseModelOutputDim, FactorStateDims... , ErrorModelStateDims...>;
+        return Pool_.createWithFactor<CostFunctionType>(Type, Factor, std::forward<FactorArguments>(Arguments)...);
+      }
+
+      template<typename ErrorType, typename FactorClass, int... FactorStateDims, int... ErrorModelStateDims, typename... FactorArguments>
+      auto makeLinearCostFunction_(const FactorType Type, FactorClass* &Factor,
+                                   std::integer_sequence<int, FactorStateDims...>, std::integer_sequence<int, ErrorModelStateDims...>,
+                                   FactorArguments&&... Arguments)
+      {
+        using CostFunctionType = LinearCostFunction<FactorClass, ErrorType, FactorStateDims..., ErrorModelStateDims...>;
+        return Pool_.createWithFactor<CostFunctionType>(Type, Factor, std::forward<FactorArguments>(Arguments)...);
+      }
+
+      template<typename ErrorType, typename FactorClass, int... FactorStateDims, int... ErrorModelStateDims, typename... FactorArguments>
+      auto makeAnalyticCostFunction_(const FactorType Type, FactorClass* &Factor,
+                                     std::integer_sequence<int, FactorStateDims...>, std::integer_sequence<int, ErrorModelStateDims...>,
+                                     FactorArguments&&... Arguments)
+      {
+        using CostFunctionType = AnalyticCostFunction<FactorClass, ErrorType, FactorStateDims..., ErrorModelStateDims...>;
+        return Pool_.createWithFactor<CostFunctionType>(Type, Factor, std::forward<FactorArguments>(Arguments)...);
+      }
+
+      /** append the leading state IDs to the list and pass the remaining parameters to the last level of addFactor() */
+      template <FactorType CurrentFactorType, typename FirstParameter, typename... FactorParameters>
+      void collectStates_(StateList &List, FirstParameter &First, FactorParameters&... Params)
+      {
+        if constexpr (std::is_same_v<std::decay_t<FirstParameter>, StateID>)
+        {
+          List.add(First);
+          collectStates_<CurrentFactorType>(List, Params...);
+        }
+        else
+        {
+          addFactor<CurrentFactorType>(static_cast<const StateList &>(List), First, Params...);
+        }
       }
 
       /** add and remove factors */
       template <typename ErrorType, typename FactorClass, typename... FactorParameters>
-      void addFactorGeneric_ (ErrorType &NoiseModel,
+      void addFactorGeneric_ (const ErrorType &NoiseModel,
                              const std::vector<StateID> &StateList,
                              const FactorType FactorTypeEnum,
                              ceres::LossFunction* RobustLoss,
                              const bool DoPrediction,
                              const double Timestamp,
-                             FactorParameters... Params)
+                             const FactorParameters&... Params)
       {
-        /** build list of states */
+        LIBRSF_TRACE_SCOPE("add_factor");
+
+        /** build list of states and their types */
         std::vector<double*> StatePointers;
+        std::vector<DataType> StateTypes;
+        StatePointers.reserve(StateList.size());
+        StateTypes.reserve(StateList.size());
         for (const StateID &State : StateList)
         {
-          StatePointers.emplace_back(
-              StateData_.getElement(State.ID , State.Timestamp, State.Number).getMeanPointer());
+          DataType Type;
+          StatePointers.emplace_back(this->getStatePointer_(State, Type));
+          StateTypes.emplace_back(Type);
         }
 
-        /** create factor object */
-        auto* Factor = new FactorClass(NoiseModel, Params...);
+        /** create factor object wrapped in a ceres cost function, use constant or hand-written derivatives if available */
+        FactorClass* Factor = nullptr;
+        ceres::CostFunction* CostFunction;
+        if constexpr (UseLinearJacobian<FactorClass, ErrorType>())
+        {
+          CostFunction = makeLinearCostFunction_<ErrorType, FactorClass> (FactorTypeEnum, Factor,
+                                                                          typename FactorClass::StateDims{},
+                                                                          typename ErrorType::StateDims{},
+                                                                          NoiseModel, Params...);
+        }
+        else if constexpr (UseAnalyticJacobian<FactorClass, ErrorType>())
+        {
+          CostFunction = makeAnalyticCostFunction_<ErrorType, FactorClass> (FactorTypeEnum, Factor,
+                                                                            typename FactorClass::StateDims{},
+                                                                            typename ErrorType::StateDims{},
+                                                                            NoiseModel, Params...);
+        }
+        else
+        {
+          CostFunction = makeAutoDiffCostFunction_<ErrorType::OutputDim, FactorClass> (FactorTypeEnum, Factor,
+                                                                                      typename FactorClass::StateDims{},
+                                                                                      typename ErrorType::StateDims{},
+                                                                                      NoiseModel, Params...);
+        }
 
         /** use the factor to predict */
         if (DoPrediction)
         {
+          LIBRSF_TRACE_SCOPE("predict");
           Factor->predict(StatePointers);
+          RawErrorCache_.invalidate();
         }
 
-        /** wrap it in ceres cost function */
-        auto CostFunction = makeAutoDiffCostFunction_<ErrorType::OutputDim, FactorClass> (Factor,
-                                                                                         typename FactorClass::StateDims{},
-                                                                                         typename ErrorType::StateDims{});
-
         /** add it to the estimation problem  */
+        Losses_.adopt(RobustLoss);
         ceres::ResidualBlockId CurrentCeresFactorID =
-            Graph_.AddResidualBlock(CostFunction,
+            Graph_.AddResidualBlock(this->wrapCostFunction_(FactorTypeEnum, CostFunction),
                                                                               RobustLoss,
                                                                               StatePointers);
 
-        /** store state types */
-        std::vector<DataType> StateTypes;
-        for(const StateID &State : StateList)
-        {
-          StateTypes.emplace_back(
-              StateData_.getElement(State.ID , State.Timestamp, State.Number).getType());
-        }
-
         /** store the graphs structure */
         Structure_.addFactor<ErrorType>(FactorTypeEnum,
                                         Timestamp,
@@ -377,71 +890,256 @@ namespace libRSF
                                         StateTypes);
       }
 
+      /** defined below the class, the common combinations are compiled once into the library */
+      template <FactorType CurrentFactorType, typename ErrorType>
+      void addFactorBase_(const StateList &States, const ErrorType &NoiseModel, const Data &Measurement, ceres::LossFunction* RobustLoss, bool DoPrediction);
+
+      /** two phases of addFactors() for one type of factors */
+      template <FactorType CurrentFactorType, typename ErrorType>
+      void prepareFactors_(FactorBatch::Stage<CurrentFactorType, ErrorType> &Stage, const int ThreadNumber)
+      {
+        LIBRSF_TRACE_SCOPE("prepare_factors");
+
+        using FactorClassType = typename FactorBatch::Stage<CurrentFactorType, ErrorType>::FactorClassType;
+        using CostFunctionType = typename CostFunctionSelector<ErrorType, FactorClassType>::Type;
+        const size_t FactorNumber = Stage.States.size();
+
+        /** the state lookup uses the cache and the pool is not thread-safe */
+        Stage.StatePointers.resize(FactorNumber);
+        Stage.StateTypes.resize(FactorNumber);
+        for (size_t n = 0; n < FactorNumber; n++)
+        {
+          for (const StateID &State : Stage.States.at(n).List_)
+          {
+            DataType Type;
+            Stage.StatePointers.at(n).emplace_back(this->getStatePointer_(State, Type));
+            Stage.StateTypes.at(n).emplace_back(Type);
+          }
+        }
+        const std::vector<void*> Blocks = Pool_.allocateWithFactor<CostFunctionType, FactorClassType>(CurrentFactorType, FactorNumber);
+
+        /** construct with the same parameters as addFactorBase_() */
+        Stage.Factors.resize(FactorNumber);
+        Stage.CostFunctions.resize(FactorNumber);
+        auto Worker = [this, &Stage, &Blocks](const size_t Begin, const size_t End)
+        {
+          for (size_t n = Begin; n < End; n++)
+          {
+            const std::vector<StateID> &List = Stage.States.at(n).List_;
+            const double DeltaTime = List.back().getTimestamp() - List.front().getTimestamp();
+            static_cast<void>(DeltaTime);
+
+            CostFunctionType* CostFunction;
+            if constexpr (static_cast<bool>(FactorClassType::UsesStateTimes) && static_cast<bool>(FactorClassType::HasMeasurement))
+            {
+              CostFunction = FactorPool::constructWithFactor<CostFunctionType>(Blocks.at(n), Stage.Factors.at(n), Stage.NoiseModels.at(n),
+                                                                               Stage.Measurements.at(n), List.front().getTimestamp(),
+                                                                               List.back().getTimestamp());
+            }
+            else if constexpr (static_cast<bool>(FactorClassType::HasDeltaTime) && static_cast<bool>(FactorClassType::HasMeasurement))
+            {
+              CostFunction = FactorPool::constructWithFactor<CostFunctionType>(Blocks.at(n), Stage.Factors.at(n), Stage.NoiseModels.at(n),
+                                                                               Stage.Measurements.at(n), DeltaTime);
+            }
+            else if constexpr (!static_cast<bool>(FactorClassType::HasDeltaTime) && static_cast<bool>(FactorClassType::HasMeasurement)
+                               && static_cast<bool>(FactorClassType::UsesSatelliteStore))
+            {
+              CostFunction = FactorPool::constructWithFactor<CostFunctionType>(Blocks.at(n), Stage.Factors.at(n), Stage.NoiseModels.at(n),
+                                                                               Stage.Measurements.at(n), Satellites_);
+            }
+            else if constexpr (!static_cast<bool>(FactorClassType::HasDeltaTime) && static_cast<bool>(FactorClassType::HasMeasurement))
+            {
+              CostFunction = FactorPool::constructWithFactor<CostFunctionType>(Blocks.at(n), Stage.Factors.at(n), Stage.NoiseModels.at(n),
+                                                                               Stage.Measurements.at(n));
+            }
+            else if constexpr (static_cast<bool>(FactorClassType::HasDeltaTime) && !static_cast<bool>(FactorClassType::HasMeasurement))
+            {
+              CostFunction = FactorPool::constructWithFactor<CostFunctionType>(Blocks.at(n), Stage.Factors.at(n), Stage.NoiseModels.at(n),
+                                                                               DeltaTime);
+            }
+            else
+            {
+              CostFunction = FactorPool::constructWithFactor<CostFunctionType>(Blocks.at(n), Stage.Factors.at(n), Stage.NoiseModels.at(n));
+            }
+            Stage.CostFunctions.at(n) = CostFunction;
+          }
+        };
+
+        /** threads are only worth it for larger sets, the satellite store is not thread-safe */
+        constexpr size_t MinFactorsPerThread = 256;
+        size_t Threads = ThreadNumber > 0 ? static_cast<size_t>(ThreadNumber) : static_cast<size_t>(GetThreadNumber());
+        Threads = std::max<size_t>(1, std::min<size_t>(Threads, FactorNumber / MinFactorsPerThread));
+        if (static_cast<bool>(FactorClassType::UsesSatelliteStore) || Threads == 1)
+        {
+          Worker(0, FactorNumber);
+        }
+        else
+        {
+          const size_t Chunk = (FactorNumber + Threads - 1) / Threads;
+          GetThreadPool().parallelFor((FactorNumber + Chunk - 1) / Chunk, [&](const size_t nChunk)
+          {
+            Worker(nChunk * Chunk, std::min(FactorNumber, (nChunk + 1) * Chunk));
+          });
+        }
+
+        Pool_.adoptWithFactor<CostFunctionType, FactorClassType>(CurrentFactorType, Stage.CostFunctions);
+      }
+
       template <FactorType CurrentFactorType, typename ErrorType>
-      void addFactorBase_(StateList &States, ErrorType &NoiseModel, const Data &Measurement, ceres::LossFunction* RobustLoss, const bool DoPrediction)
+      void commitFactor_(FactorBatch::Stage<CurrentFactorType, ErrorType> &Stage, const size_t Index)
       {
-        /** get index timestamp */
-        const double TimestampFirst = States.List_.front().Timestamp;
+        StateList &States = Stage.States.at(Index);
+        const double Timestamp = States.List_.front().getTimestamp();
 
-        /** translate the factor type enum to the class that should be added to the graph */
-        using FactorClassType = typename FactorTypeTranslator<CurrentFactorType, ErrorType>::Type;
+        if (Stage.Predictions.at(Index))
+        {
+          Stage.Factors.at(Index)->predict(Stage.StatePointers.at(Index));
+          RawErrorCache_.invalidate();
+        }
+
+        Losses_.adopt(Stage.RobustLosses.at(Index));
+        const ceres::ResidualBlockId CeresID =
+            Graph_.AddResidualBlock(this->wrapCostFunction_(CurrentFactorType, Stage.CostFunctions.at(Index)),
+                                    Stage.RobustLosses.at(Index),
+                                    Stage.StatePointers.at(Index));
+
+        Structure_.addFactor<ErrorType>(CurrentFactorType,
+                                        Timestamp,
+                                        CeresID,
+                                        Stage.Factors.at(Index)->getErrorModel(),
+                                        States.List_,
+                                        Stage.StatePointers.at(Index),
+                                        Stage.StateTypes.at(Index));
 
-        /** decide at compile time which parameters are required */
-        if constexpr (static_cast<bool>(FactorClassType::HasDeltaTime) && static_cast<bool>(FactorClassType::HasMeasurement))
+        if (CheckpointRecording_)
         {
-          /** calculate delta time */
-          const double DeltaTime = States.List_.back().Timestamp - TimestampFirst;
-
-          addFactorGeneric_<ErrorType, FactorClassType> (NoiseModel,
-                                                        States.List_,
-                                                        CurrentFactorType,
-                                                        RobustLoss,
-                                                        DoPrediction,
-                                                        TimestampFirst,
-                                                        Measurement,
-                                                        DeltaTime);
+          this->recordFactor_(CurrentFactorType, Timestamp, States, Stage.Measurements.at(Index), CheckpointRegistration_<CurrentFactorType, ErrorType>::Key);
         }
-        else if constexpr (!static_cast<bool>(FactorClassType::HasDeltaTime) && static_cast<bool>(FactorClassType::HasMeasurement))
+        if (Trace_ != nullptr)
         {
-          addFactorGeneric_<ErrorType, FactorClassType> (NoiseModel,
-                                                        States.List_,
-                                                        CurrentFactorType,
-                                                        RobustLoss,
-                                                        DoPrediction,
-                                                        TimestampFirst,
-                                                        Measurement);
+          this->traceFactor_(CurrentFactorType, Timestamp, States, Stage.Measurements.at(Index), CheckpointRegistration_<CurrentFactorType, ErrorType>::Key);
         }
-        else if constexpr (static_cast<bool>(FactorClassType::HasDeltaTime) && !static_cast<bool>(FactorClassType::HasMeasurement))
+      }
+
+      /** type-erased access to the error model and the constructor of one combination of factor and error model */
+      struct CheckpointHandler
+      {
+        bool (*Serialize)(const ErrorModelBase* ErrorModel, CheckpointWriter &Writer);
+        bool (*Rebuild)(FactorGraph &Graph, StateList &States, const Data &Measurement, CheckpointReader &Reader);
+      };
+      static std::map<std::string, CheckpointHandler> &getCheckpointHandlers_();
+
+      template <FactorType CurrentFactorType, typename ErrorType>
+      static const std::string* registerCheckpointHandler_()
+      {
+        CheckpointHandler Handler{};
+        Handler.Serialize = [](const ErrorModelBase* ErrorModel, CheckpointWriter &Writer)
+        {
+          if constexpr (HasCheckpointSupport<ErrorType>::value)
+          {
+            static_cast<const ErrorType*>(ErrorModel)->serialize(Writer);
+            return true;
+          }
+          return false;
+        };
+        Handler.Rebuild = [](FactorGraph &Graph, StateList &States, const Data &Measurement, CheckpointReader &Reader)
+        {
+          if constexpr (HasCheckpointSupport<ErrorType>::value)
+          {
+            ErrorType NoiseModel;
+            if (!NoiseModel.deserialize(Reader))
+            {
+              return false;
+            }
+            Graph.addFactorBase_<CurrentFactorType>(States, NoiseModel, Measurement, nullptr, false);
+            return true;
+          }
+          return false;
+        };
+
+        const std::string Key = std::to_string(static_cast<int>(CurrentFactorType)) + ':' + typeid(ErrorType).name();
+        return &getCheckpointHandlers_().emplace(Key, Handler).first->first;
+      }
+
+      template <FactorType CurrentFactorType, typename ErrorType>
+      struct CheckpointRegistration_
+      {
+        static inline const std::string* const Key = registerCheckpointHandler_<CurrentFactorType, ErrorType>();
+      };
+
+      /** everything that is required to rebuild a factor */
+      struct CheckpointRecord
+      {
+        const std::string* Handler = nullptr;
+        uint64_t Sequence = 0;
+        StateList States;
+        Data Measurement;
+      };
+      void recordFactor_(FactorType Type, double Timestamp, const StateList &States, const Data &Measurement, const std::string* Handler);
+      void forgetFactor_(ceres::ResidualBlockId CeresID);
+
+      /** records one public operation, nested calls of the graph itself are not part of the trace */
+      class TraceScope_
+      {
+        public:
+          /** the solver and the marginalization depend on the current means, so they are recorded before */
+          TraceScope_(FactorGraph &Graph, TraceOperation Operation, bool WithMeans = false);
+          ~TraceScope_();
+
+          TraceScope_(const TraceScope_ &) = delete;
+          TraceScope_ &operator=(const TraceScope_ &) = delete;
+
+          /** nullptr if this operation is not recorded */
+          CheckpointWriter* const Writer;
+
+        private:
+          FactorGraph &Graph_;
+          Timer Clock_;
+      };
+      void traceMeans_(CheckpointWriter &Writer);
+      void traceFactor_(FactorType Type, double Timestamp, const StateList &States, const Data &Measurement, const std::string* Handler);
+      void traceUnsupported_(const char* Operation);
+      bool replayOperation_(TraceOperation Operation, CheckpointReader &Reader);
+
+      /** move the records of re-inserted factors to their new IDs */
+      template <typename RecordType>
+      static void replaceKeys_(PointerMap<ceres::ResidualBlockId, RecordType> &Records,
+                               const std::vector<std::pair<ceres::ResidualBlockId, ceres::ResidualBlockId>> &IDs)
+      {
+        std::vector<std::pair<ceres::ResidualBlockId, RecordType>> Moved;
+        for (const auto &ID : IDs)
         {
-          /** calculate delta time */
-          const double DeltaTime = States.List_.back().Timestamp - TimestampFirst;
-
-          addFactorGeneric_<ErrorType, FactorClassType> (NoiseModel,
-                                                        States.List_,
-                                                        CurrentFactorType,
-                                                        RobustLoss,
-                                                        DoPrediction,
-                                                        TimestampFirst,
-                                                        DeltaTime);
+          if (Records.count(ID.first) > 0)
+          {
+            Moved.emplace_back(ID.second, Records.at(ID.first));
+            Records.erase(ID.first);
+          }
         }
-        else if constexpr (!static_cast<bool>(FactorClassType::HasDeltaTime) && !static_cast<bool>(FactorClassType::HasMeasurement))
+        for (const auto &Record : Moved)
         {
-          addFactorGeneric_<ErrorType, FactorClassType> (NoiseModel,
-                                                        States.List_,
-                                                        CurrentFactorType,
-                                                        RobustLoss,
-                                                        DoPrediction,
-                                                        TimestampFirst);
+          Records.emplace(Record.first, Record.second);
         }
       }
 
-      /** default settings for new ceres::Problems, especially enable_fast_removal = true */
-      const ceres::Problem::Options DefaultProblemOptions_ = {ceres::Ownership::TAKE_OWNERSHIP, // cost_function_ownership
-                                                              ceres::Ownership::TAKE_OWNERSHIP, // loss_function_ownership
-                                                              ceres::Ownership::TAKE_OWNERSHIP, // local_parameterization_ownership
+      /** optional measurement of the evaluation time per factor type */
+      ceres::CostFunction* wrapCostFunction_(FactorType Type, ceres::CostFunction* CostFunction);
+      bool FactorTiming_ = false;
+      std::map<FactorType, std::unique_ptr<EvaluationTiming>> FactorTimings_;
+
+      /** memory of all cost functions and factors, has to outlive Graph_ */
+      FactorPool Pool_;
+
+      /** local parametrizations and loss functions are shared between states and factors, have to outlive Graph_ */
+      SharedObjects<ceres::LocalParameterization> Parameterizations_;
+      SharedObjects<ceres::LossFunction> Losses_;
+
+      /** default settings for new ceres::Problems, especially enable_fast_removal = true, cost functions belong to Pool_, parametrizations and losses to the shared objects */
+      const ceres::Problem::Options DefaultProblemOptions_ = {ceres::Ownership::DO_NOT_TAKE_OWNERSHIP, // cost_function_ownership
+                                                              ceres::Ownership::DO_NOT_TAKE_OWNERSHIP, // loss_function_ownership
+                                                              ceres::Ownership::DO_NOT_TAKE_OWNERSHIP, // local_parameterization_ownership
                                                               true, // enable_fast_removal
                                                               false, // disable_all_safety_checks
-                                                              nullptr, // context
+                                                              GetCeresContext(), // context
                                                               nullptr // evaluation_callback
                                                               };
 
@@ -449,15 +1147,240 @@ namespace libRSF
       ceres::Solver::Summary Report_;
       ceres::Solver::Options SolverOptions_;
 
+      /** motion models connect the newest states, so they are found here without a DataSet lookup */
+      struct CachedState
+      {
+        StateID ID;
+        double* Mean = nullptr;
+        DataType Type{};
+      };
+      std::array<CachedState, 16> StateCache_;
+      size_t StateCacheNext_ = 0;
+
+      /** pre-integrated IMU factors that may be re-integrated */
+      struct IMUFactorRecord
+      {
+        StateList States;
+        PreintegratedIMUResult Preintegration;
+      };
+      PointerMap<ceres::ResidualBlockId, std::shared_ptr<IMUFactorRecord>> IMUFactors_;
+      double IMURelinearizationThreshold_ = 0.0;
+
+      /** rank reduction of marginal priors */
+      double MarginalCompression_ = 0.0;
+
+      /** rebuild information of the recorded factors */
+      bool CheckpointRecording_ = false;
+      uint64_t CheckpointSequence_ = 0;
+      PointerMap<ceres::ResidualBlockId, std::shared_ptr<CheckpointRecord>> CheckpointFactors_;
+      PointerMap<ceres::ResidualBlockId, std::shared_ptr<MarginalRecord>> CheckpointMarginals_;
+
+      /** receives the estimates after each solve */
+      std::shared_ptr<StatePublisher> Publisher_;
+
+      /** optional per-iteration telemetry */
+      bool IterationTelemetry_ = false;
+      int SolveCounter_ = 0;
+      std::vector<SolverIteration> Iterations_;
+
+      /** optional monitoring */
+      std::shared_ptr<GraphMetrics> Metrics_;
+      void recordCovariance_(double Duration);
+
+      /** shared satellite positions, factors keep their store alive */
+      std::shared_ptr<SatelliteStore> Satellites_ = std::make_shared<SatelliteStore>();
+
+      /** warm start of the following solve */
+      bool WarmStart_ = false;
+      double WarmStartRadius_ = 0.0;
+
+      /** automatic elimination ordering */
+      bool LandmarksFirst_ = false;
+      bool TimeChainOrdering_ = false;
+
+      /** state names that are managed outside of the sliding window */
+      std::set<StateKey> WindowExempt_;
+
+      /** tiny problems skip ceres::Solve */
+      int DenseSolverThreshold_ = 0;
+
+      /** automatic selection of the sparse linear backend */
+      bool BackendSelection_ = false;
+      int BackendBenchmarkIterations_ = 3;
+      static constexpr int MinBackendBenchmarkFactors_ = 256;
+
+      /** optional trace of all operations */
+      std::unique_ptr<GraphTraceWriter> Trace_;
+      int TraceDepth_ = 0;
+      bool TraceIsComplete_ = true;
+
       StateDataSet StateData_;                      /**< holds all state variables */
       FactorGraphStructure Structure_;              /**< represents the structure of variables and factors */
+      MarginalCovariance CovarianceCache_;          /**< factorization of the last solution */
+      IncrementalCovariance CovarianceTracker_;     /**< covariance of the newest epoch */
+      ResidualCache RawErrorCache_;                 /**< unweighted errors of the last evaluation */
 
       /** store information about the past computational load */
       double SolverDuration_;
       int SolverIterations_;
+      int DeadlineMisses_ = 0;
       double MarginalizationDuration_;
       double CovarianceDuration_;
   };
+
+  template <FactorType CurrentFactorType, typename ErrorType>
+  void FactorGraph::addFactorBase_(const StateList &States, const ErrorType &NoiseModel, const Data &Measurement, ceres::LossFunction* RobustLoss, const bool DoPrediction)
+  {
+    /** get index timestamp */
+    const double TimestampFirst = States.List_.front().getTimestamp();
+
+    /** translate the factor type enum to the class that should be added to the graph */
+    using FactorClassType = typename FactorTypeTranslator<CurrentFactorType, ErrorType>::Type;
+
+    /** decide at compile time which parameters are required */
+    if constexpr (static_cast<bool>(FactorClassType::UsesStateTimes) && static_cast<bool>(FactorClassType::HasMeasurement))
+    {
+      addFactorGeneric_<ErrorType, FactorClassType> (NoiseModel,
+                                                    States.List_,
+                                                    CurrentFactorType,
+                                                    RobustLoss,
+                                                    DoPrediction,
+                                                    TimestampFirst,
+                                                    Measurement,
+                                                    TimestampFirst,
+                                                    States.List_.back().getTimestamp());
+    }
+    else if constexpr (static_cast<bool>(FactorClassType::HasDeltaTime) && static_cast<bool>(FactorClassType::HasMeasurement))
+    {
+      /** calculate delta time */
+      const double DeltaTime = States.List_.back().getTimestamp() - TimestampFirst;
+
+      addFactorGeneric_<ErrorType, FactorClassType> (NoiseModel,
+                                                    States.List_,
+                                                    CurrentFactorType,
+                                                    RobustLoss,
+                                                    DoPrediction,
+                                                    TimestampFirst,
+                                                    Measurement,
+                                                    DeltaTime);
+    }
+    else if constexpr (!static_cast<bool>(FactorClassType::HasDeltaTime) && static_cast<bool>(FactorClassType::HasMeasurement)
+                       && static_cast<bool>(FactorClassType::UsesSatelliteStore))
+    {
+      addFactorGeneric_<ErrorType, FactorClassType> (NoiseModel,
+                                                    States.List_,
+                                                    CurrentFactorType,
+                                                    RobustLoss,
+                                                    DoPrediction,
+                                                    TimestampFirst,
+                                                    Measurement,
+                                                    Satellites_);
+    }
+    else if constexpr (!static_cast<bool>(FactorClassType::HasDeltaTime) && static_cast<bool>(FactorClassType::HasMeasurement))
+    {
+      addFactorGeneric_<ErrorType, FactorClassType> (NoiseModel,
+                                                    States.List_,
+                                                    CurrentFactorType,
+                                                    RobustLoss,
+                                                    DoPrediction,
+                                                    TimestampFirst,
+                                                    Measurement);
+    }
+    else if constexpr (static_cast<bool>(FactorClassType::HasDeltaTime) && !static_cast<bool>(FactorClassType::HasMeasurement))
+    {
+      /** calculate delta time */
+      const double DeltaTime = States.List_.back().getTimestamp() - TimestampFirst;
+
+      addFactorGeneric_<ErrorType, FactorClassType> (NoiseModel,
+                                                    States.List_,
+                                                    CurrentFactorType,
+                                                    RobustLoss,
+                                                    DoPrediction,
+                                                    TimestampFirst,
+                                                    DeltaTime);
+    }
+    else if constexpr (!static_cast<bool>(FactorClassType::HasDeltaTime) && !static_cast<bool>(FactorClassType::HasMeasurement))
+    {
+      addFactorGeneric_<ErrorType, FactorClassType> (NoiseModel,
+                                                    States.List_,
+                                                    CurrentFactorType,
+                                                    RobustLoss,
+                                                    DoPrediction,
+                                                    TimestampFirst);
+    }
+
+    /** the handler is registered for every instantiated combination, so a loading program knows it as well */
+    if (CheckpointRecording_)
+    {
+      this->recordFactor_(CurrentFactorType, TimestampFirst, States, Measurement, CheckpointRegistration_<CurrentFactorType, ErrorType>::Key);
+    }
+    if (Trace_ != nullptr)
+    {
+      this->traceFactor_(CurrentFactorType, TimestampFirst, States, Measurement, CheckpointRegistration_<CurrentFactorType, ErrorType>::Key);
+    }
+  }
+
+  /** factor and error model combinations that most applications use, they are instantiated once in FactorGraphInstances.cpp */
+#define LIBRSF_FACTOR_INSTANCES(INSTANCE) \
+  INSTANCE(Prior1, GaussianDiagonal<1>) \
+  INSTANCE(Prior2, GaussianDiagonal<2>) \
+  INSTANCE(Prior3, GaussianDiagonal<3>) \
+  INSTANCE(ConstVal1, GaussianDiagonal<1>) \
+  INSTANCE(ConstVal2, GaussianDiagonal<2>) \
+  INSTANCE(ConstVal3, GaussianDiagonal<3>) \
+  INSTANCE(ConstDrift1, GaussianDiagonal<2>) \
+  INSTANCE(ConstDriftClock, GaussianDiagonal<2>) \
+  INSTANCE(Loop2, GaussianDiagonal<2>) \
+  INSTANCE(Range2, GaussianDiagonal<1>) \
+  INSTANCE(Range3, GaussianDiagonal<1>) \
+  INSTANCE(Pseudorange3_ECEF, GaussianDiagonal<1>) \
+  INSTANCE(Odom2, GaussianDiagonal<3>) \
+  INSTANCE(Odom4_ECEF, GaussianDiagonal<4>) \
+  INSTANCE(Odom6, GaussianDiagonal<6>)
+
+#define LIBRSF_EXTERN_FACTOR(Type, ErrorModelType) \
+  extern template void FactorGraph::addFactorBase_<FactorType::Type, ErrorModelType>(const StateList&, const ErrorModelType&, const Data&, ceres::LossFunction*, bool);
+
+  LIBRSF_FACTOR_INSTANCES(LIBRSF_EXTERN_FACTOR)
+
+#undef LIBRSF_EXTERN_FACTOR
+
+  template <FactorType CurrentFactorType, typename ErrorType>
+  void FactorBatch::add(const StateList &States, const Data &Measurement, const ErrorType &NoiseModel,
+                        ceres::LossFunction* RobustLoss, const bool DoPrediction)
+  {
+    /** factors of the same kind usually follow each other */
+    auto* Current = dynamic_cast<Stage<CurrentFactorType, ErrorType>*>(LastStage_);
+    for (size_t n = 0; Current == nullptr && n < Stages_.size(); n++)
+    {
+      Current = dynamic_cast<Stage<CurrentFactorType, ErrorType>*>(Stages_.at(n).get());
+    }
+    if (Current == nullptr)
+    {
+      Stages_.emplace_back(std::make_unique<Stage<CurrentFactorType, ErrorType>>());
+      Current = static_cast<Stage<CurrentFactorType, ErrorType>*>(Stages_.back().get());
+    }
+    LastStage_ = Current;
+
+    Order_.emplace_back(Current, Current->States.size());
+    Current->States.push_back(States);
+    Current->Measurements.push_back(Measurement);
+    Current->NoiseModels.push_back(NoiseModel);
+    Current->RobustLosses.push_back(RobustLoss);
+    Current->Predictions.push_back(DoPrediction);
+  }
+
+  template <FactorType CurrentFactorType, typename ErrorType>
+  void FactorBatch::Stage<CurrentFactorType, ErrorType>::prepare(FactorGraph &Graph, const int ThreadNumber)
+  {
+    Graph.prepareFactors_(*this, ThreadNumber);
+  }
+
+  template <FactorType CurrentFactorType, typename ErrorType>
+  void FactorBatch::Stage<CurrentFactorType, ErrorType>::commit(FactorGraph &Graph, const size_t Index)
+  {
+    Graph.commitFactor_(*this, Index);
+  }
 }
 
 #endif // FACTORGRAPH_H
@@ -34,18 +34,54 @@
 
 #include "Messages.h"
 #include "Types.h"
+#include "ThreadPool.h"
+#include "RealTime.h"
 
 #include <ceres/ceres.h>
 #include <yaml-cpp/yaml.h>
 
 #include <cstdio>
-#include <thread>
 #include <iostream>
 #include <string>
 #include <initializer_list>
 
 namespace libRSF
 {
+  /** linear solvers and sparse backends that can be selected in the YAML file */
+  const std::map<std::string, ceres::LinearSolverType> LinearSolverTypeDict =
+  {
+    {"sparse_normal_cholesky", ceres::LinearSolverType::SPARSE_NORMAL_CHOLESKY},
+    {"sparse_schur", ceres::LinearSolverType::SPARSE_SCHUR},
+    {"iterative_schur", ceres::LinearSolverType::ITERATIVE_SCHUR},
+    {"cgnr", ceres::LinearSolverType::CGNR},
+    {"dense_schur", ceres::LinearSolverType::DENSE_SCHUR},
+    {"dense_qr", ceres::LinearSolverType::DENSE_QR},
+    {"dense_normal_cholesky", ceres::LinearSolverType::DENSE_NORMAL_CHOLESKY}
+  };
+
+  const std::map<std::string, ceres::SparseLinearAlgebraLibraryType> SparseBackendTypeDict =
+  {
+    {"suite_sparse", ceres::SparseLinearAlgebraLibraryType::SUITE_SPARSE},
+    {"eigen_sparse", ceres::SparseLinearAlgebraLibraryType::EIGEN_SPARSE},
+    {"accelerate_sparse", ceres::SparseLinearAlgebraLibraryType::ACCELERATE_SPARSE}
+  };
+
+  /** preconditioners of the iterative solvers, the cluster variants require SuiteSparse */
+  const std::map<std::string, ceres::PreconditionerType> PreconditionerTypeDict =
+  {
+    {"identity", ceres::PreconditionerType::IDENTITY},
+    {"jacobi", ceres::PreconditionerType::JACOBI},
+    {"schur_jacobi", ceres::PreconditionerType::SCHUR_JACOBI},
+    {"cluster_jacobi", ceres::PreconditionerType::CLUSTER_JACOBI},
+    {"cluster_tridiagonal", ceres::PreconditionerType::CLUSTER_TRIDIAGONAL}
+  };
+
+  const std::map<std::string, ThreadAffinity> ThreadAffinityDict =
+  {
+    {"none", ThreadAffinity::None},
+    {"compact", ThreadAffinity::Compact},
+    {"scatter", ThreadAffinity::Scatter}
+  };
 
   class FactorGraphConfig
   {
@@ -88,6 +124,19 @@ namespace libRSF
       double PriorDirichletConcentration = 1;
       double PriorNormalInfoScaling = 1e-4;
       double PriorWishartDOF = 1;
+
+      /** threads for the estimation, <= 0 uses all cores */
+      int ThreadNumber = 0;
+
+      /** online estimation that only uses new residuals and decays the old ones */
+      bool OnlineTuning = false;
+      double ForgettingFactor = 1.0;
+
+      /** fit on an importance-weighted coreset of this many residuals, zero uses all of them */
+      int CoresetSize = 0;
+
+      /** SQUAREM extrapolation of the EM iterations */
+      bool AcceleratedTuning = false;
     };
 
     struct ErrorModelConfig
@@ -98,12 +147,23 @@ namespace libRSF
       GaussianMixtureConfig GMM; /**< only if a GMM is used */
     };
 
+    /** cheap rejection of observations before their factors are created */
+    struct ScreeningConfig
+    {
+      bool IsActive = false;
+
+      double MinElevation = -90.0;  /**< in degree */
+      double MinSNR = 0.0;          /**< zero disables it, measurements without SNR (zero) always pass */
+      double MaxResidual = 0.0;     /**< w.r.t. the predicted position after removing the median, zero disables it */
+    };
+
     /** factor configuration */
     struct FactorConfig
     {
       FactorType Type;
       Vector Parameter;
       ErrorModelConfig ErrorModel;
+      ScreeningConfig Screening;
 
       bool IsActive{false};
     }Ranging, GNSS, ClockModel, MotionModel, Odom, IMU, Laser, Radar, Vision, LoopClosure, Tracking, Prior, Pressure;
@@ -113,28 +173,125 @@ namespace libRSF
     {
       SolutionType Type;
 
-      /** available time for one iteration */
-      double MaxTime; //TODO: check why unused???
+      /** available time for one iteration, the target of the adaptive window */
+      double MaxTime;
       int MaxIterations;
 
       /** time handling */
       bool IsAsync;
-      double AsyncRate;
+      double AsyncRate;   /**< fixed rate, or the maximum state rate of event-driven async */
+      bool AsyncEvents;   /**< async epochs at measurement times instead of a fixed rate */
       DataType SyncSensor;
 
+      /** read the input file step by step instead of loading it completely */
+      bool IsStreaming;
+
+      /** solve in a background thread while the next measurements are read (requires streaming) */
+      bool IsPipelined;
+
+      /** streaming: measurements may arrive out of order within this bound in seconds, later ones are inserted into the past states */
+      double Latency;
+
+      /** window/filter: keep a complete smoother in a background thread that is solved and corrects the window every n epochs, zero disables it */
+      int BackgroundSmoother;
+
       /** covariance estimation */
       bool EstimateCov;
 
+      /** propagate the covariance of the newest states instead of computing the exact marginal every epoch */
+      bool IncrementalCovariance;
+
+      /** batch: solve a graph over every n-th state first and interpolate it as initial guess, <= 1 disables it */
+      int CoarseToFine;
+
+      /** batch: initialize the positions of a 2D pose graph in closed form from odometry and consistent loop-closures */
+      bool PoseGraphInit;
+
+      /** batch: adapt the error models every n iterations of one solve instead of an outer loop, zero disables it */
+      int AdaptionInterval;
+
+      /** batch: the outer adaption loop starts with a relaxed function tolerance and iteration limit, zero keeps the full ones */
+      int AdaptionRounds;
+      double AdaptionTolerance;
+      int AdaptionIterations;
+
+      /** batch: solve overlapping time segments in parallel until they agree on the overlap, zero length disables it */
+      double SegmentLength;
+      double SegmentOverlap;
+      int SegmentRounds;
+      double SegmentConsensus;  /**< standard deviation of the consensus prior */
+
+      /** only optimize the recently changed part of the graph (smoother) */
+      bool Incremental;
+
+      /** reuse the trust region of the last solve and extrapolate new states */
+      bool WarmStart;
+
+      /** keep the in-memory result column-wise with covariances in "double", "float" or "half", empty disables it */
+      std::string CompactResults;
+
+      /** binary result of a previous run, its estimates initialize all matching states, empty disables it */
+      std::string InitialValues;
+
+      /** record all graph operations into this file for libRSF_replay, empty disables it */
+      std::string TraceFile;
+
+      /** save the progress of every solver iteration as solver_iteration */
+      bool IterationTelemetry;
+
+      /** sparse_backend: auto selects the fastest linear backend for each kind of graph */
+      bool AutoBackend;
+
+      /** Prometheus metrics are served on this port (zero disables it) and/or written to this file (empty disables it) */
+      int MetricsPort;
+      std::string MetricsFile;
+
       /**only for sliding window */
       bool Marginalize;
       double WindowLength;
+
+      /** scale WindowLength between the bounds, so that one epoch takes less than MaxTime */
+      bool AdaptiveWindow;
+      double MinWindowLength;
+      double MaxWindowLength;
+
+      /** reduce the window every n steps or if it is longer than WindowLength + overflow */
+      int MarginalizationInterval;
+      double MarginalizationOverflow;
+      int MaxMarginalPriors;
+
+      /** landmarks unseen for longer than LandmarkMaxAge are marginalized, at most MaxLandmarks stay active (zero disables both) */
+      double LandmarkMaxAge;
+      int MaxLandmarks;
+
+      /** hard time budget of one epoch in seconds, zero disables it */
+      double Deadline;
+
+      /** eliminate landmarks before poses (Schur-based solvers) */
+      bool OrderLandmarksFirst;
+
+      /** eliminate every second epoch (iterative_schur) */
+      bool OrderTimeChain;
     } Solution{};
 
+    /** keyframe selection, epochs that are no keyframe get no own state */
+    struct KeyframeConfig
+    {
+      bool IsActive = false;
+
+      /** a new keyframe is created if one of the thresholds is reached, zero disables it */
+      double MinTranslation = 0.0;      /**< in meter */
+      double MinRotation = 0.0;         /**< in rad */
+      double MaxInterval = 0.0;         /**< in seconds */
+      double MinInformationGain = 0.0;  /**< in nat */
+    } Keyframe;
+
     ceres::Solver::Options SolverConfig;
 
   private:
     static bool ParseErrorModelFromYAML_(YAML::Node ErrorModelNode, ErrorModelConfig &Model);
     static Vector ParseVectorFromYAML_(const YAML::Node &VectorNode);
+    bool ParseSolverFromYAML_(const YAML::Node &SolverNode);
   };
 }
 
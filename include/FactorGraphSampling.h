@@ -33,9 +33,15 @@
 #define FACTORGRAPHSAMPLING_H
 
 #include "StateDataSet.h"
+#include "ThreadPool.h"
 
 #include <ceres/ceres.h>
-#include <thread>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <unordered_map>
 
 namespace libRSF
 {
@@ -45,6 +51,67 @@ namespace libRSF
                                  const VectorVectorSTL<Dynamic>& Points,
                                  std::vector<double> &Costs);
 
+  /** evaluates only the factors connected to the state, in parallel on private copies of them */
+  void EvaluateCostSurfacePoints(ceres::Problem &Graph,
+                                 double * StatePointer,
+                                 int Dim,
+                                 const VectorVectorSTL<Dynamic>& Points,
+                                 std::vector<double> &Costs,
+                                 std::vector<Vector> *Gradients,
+                                 std::vector<Matrix> *Hessians,
+                                 int ThreadNumber = 0);
+
+  /** cost of only the factors connected to the state, without the constant offset of the others,
+   *  evaluated sequentially on a private copy of them, so multiple threads can sample different states of one graph */
+  void EvaluateLocalCostPoints(const ceres::Problem &Graph,
+                               const double * StatePointer,
+                               int Dim,
+                               const VectorVectorSTL<Dynamic>& Points,
+                               std::vector<double> &Costs);
+
+  template<int Dim>
+  void StoreCostSurfacePoint(const VectorStatic<Dim> &Point,
+                             const double Cost,
+                             const VectorStatic<Dim> &Gradient,
+                             const MatrixStatic<Dim,Dim> &Hessian,
+                             StateDataSet &Result)
+  {
+    /** create state data to store the result */
+    Data CostState;
+    if (Dim == 1)
+    {
+      CostState = Data(DataType::CostGradient1, 0.0);
+    }
+    else if (Dim == 2)
+    {
+      CostState = Data(DataType::CostGradient2, 0.0);
+    }
+    else if (Dim == 3)
+    {
+      CostState = Data(DataType::CostGradient3, 0.0);
+    }
+    else
+    {
+      PRINT_ERROR("There is no data type for ", Dim, " dimensional data!");
+    }
+
+    /** point where the cost is evaluated */
+    CostState.setMean(Point);
+
+    /** actual cost value */
+    CostState.setValueScalar(DataElement::Cost, Cost);
+
+    /** gradient of the cost surface */
+    CostState.setValue(DataElement::Gradient, Gradient);
+
+    /** hessian at the evaluated point */
+    VectorStatic<Dim*Dim> HessianVector(Hessian.data());
+    CostState.setValue(DataElement::Hessian, HessianVector);
+
+    /** push to data set */
+    Result.addElement(CostState);
+  }
+
 
   template<int Dim>
   void EvaluateCostSurface(ceres::Problem &Graph,
@@ -52,14 +119,15 @@ namespace libRSF
                            const int Points,
                            const double Range,
                            StateDataSet &Result,
-                           const bool OptimizeOtherStates = false)
+                           const bool OptimizeOtherStates = false,
+                           const bool ComputeHessian = true)
   {
     using SizedVector = VectorStatic<Dim>;
 
     /** configure evaluation */
     ceres::Problem::EvaluateOptions Options;
     Options.apply_loss_function = true;
-    Options.num_threads = static_cast<int>(std::thread::hardware_concurrency());
+    Options.num_threads = GetThreadNumber();
     Options.parameter_blocks = {StatePointer};
 
     /** save original value */
@@ -87,6 +155,39 @@ namespace libRSF
       Index.push_back(0);
     }
 
+    /** without optimization, only the connected factors have to be evaluated */
+    if (!OptimizeOtherStates)
+    {
+      const uint64_t PointNumber = static_cast<uint64_t>(std::pow(Points,Dim));
+
+      VectorVectorSTL<Dynamic> GridPoints;
+      GridPoints.reserve(PointNumber);
+      for (uint64_t n = 0; n < PointNumber; ++n)
+      {
+        /** first dimension is incremented first */
+        uint64_t Remainder = n;
+        SizedVector Point;
+        for (int nDim = 0; nDim < Dim; ++nDim)
+        {
+          Point(nDim) = Grid.at(nDim)(static_cast<int>(Remainder % Points));
+          Remainder /= Points;
+        }
+        GridPoints.emplace_back(Point);
+      }
+
+      std::vector<double> Costs;
+      std::vector<Vector> Gradients;
+      std::vector<Matrix> Hessians;
+      EvaluateCostSurfacePoints(Graph, StatePointer, Dim, GridPoints, Costs, &Gradients, ComputeHessian ? &Hessians : nullptr);
+
+      for (uint64_t n = 0; n < PointNumber; ++n)
+      {
+        const MatrixStatic<Dim,Dim> Hessian = ComputeHessian ? MatrixStatic<Dim,Dim>(Hessians.at(n)) : MatrixStatic<Dim,Dim>::Zero();
+        StoreCostSurfacePoint<Dim>(GridPoints.at(n), Costs.at(n), Gradients.at(n), Hessian, Result);
+      }
+      return;
+    }
+
     /** loop over grid */
     for (uint64_t n = 0; n < static_cast<uint64_t>(std::pow(Points,Dim)); ++n)
     {
@@ -101,7 +202,7 @@ namespace libRSF
       {
         ceres::Solver::Options Options;
         ceres::Solver::Summary Summary;
-        Options.num_threads = static_cast<int>(std::thread::hardware_concurrency());
+        Options.num_threads = GetThreadNumber();
         ceres::Solve(Options, &Graph, &Summary);
       }
 
@@ -114,43 +215,10 @@ namespace libRSF
       /** calculate the Hessian */
       Matrix Jacobian;
       CRSToMatrix(JacobianCRS, Jacobian);
-      MatrixStatic<Dim,Dim> Hessian = Jacobian.transpose()*Jacobian;
+      const MatrixStatic<Dim,Dim> Hessian = Jacobian.transpose()*Jacobian;
 
-      /** create state data to store the result */
-      Data CostState;
-      if (Dim == 1)
-      {
-        CostState = Data(DataType::CostGradient1, 0.0);
-      }
-      else if (Dim == 2)
-      {
-        CostState = Data(DataType::CostGradient2, 0.0);
-      }
-      else if (Dim == 3)
-      {
-        CostState = Data(DataType::CostGradient3, 0.0);
-      }
-      else
-      {
-        PRINT_ERROR("There is no data type for ", Dim, " dimensional data!");
-      }
-
-      /** point where the cost is evaluated */
-      CostState.setMean(State);
-
-      /** actual cost value */
-      CostState.setValueScalar(DataElement::Cost, Cost);
-
-      /** gradient of the cost surface */
-      SizedVector GradientVector(Gradient.data());
-      CostState.setValue(DataElement::Gradient, GradientVector);
-
-      /** hessian at the evaluated point */
-      VectorStatic<Dim*Dim> HessianVector(Hessian.data());
-      CostState.setValue(DataElement::Hessian, HessianVector);
-
-      /** push to data set */
-      Result.addElement(CostState);
+      /** store the result */
+      StoreCostSurfacePoint<Dim>(State, Cost, SizedVector(Gradient.data()), Hessian, Result);
 
       /**increment indexes */
       Index.at(0)++;
@@ -174,6 +242,234 @@ namespace libRSF
       Graph.SetParameterBlockVariable(StatePointer);
     }
   }
+
+  /** cost surface on a 2^Dim-tree (binary tree, quadtree, octree) over the same cube as EvaluateCostSurface(),
+   *  cells are split where the cost deviates most from a quadratic function along their edges,
+   *  until Budget points are evaluated, the points are stored in the order of their evaluation */
+  template<int Dim>
+  void EvaluateCostSurfaceAdaptive(ceres::Problem &Graph,
+                                   double * StatePointer,
+                                   const int Budget,
+                                   const double Range,
+                                   StateDataSet &Result,
+                                   const bool ComputeHessian = true)
+  {
+    static_assert(Dim >= 1 && Dim <= 3, "Adaptive cost sampling is implemented for 1 to 3 dimensions!");
+
+    using SizedVector = VectorStatic<Dim>;
+    using LatticePoint = Eigen::Matrix<std::int64_t, Dim, 1>;
+
+    /** all points lie on a lattice of the finest level, so shared corners of neighboring cells are evaluated once */
+    constexpr int MaxDepth = 20;
+    constexpr std::int64_t Resolution = std::int64_t(1) << MaxDepth;
+    constexpr int CornerNumber = 1 << Dim;
+    constexpr int RefinedNumber = (Dim == 1) ? 3 : ((Dim == 2) ? 9 : 27); /**< 3^Dim points of a split cell */
+
+    const SizedVector Lower = VectorRef<double, Dim>(StatePointer).array() - Range / 2;
+    const double Step = Range / static_cast<double>(Resolution);
+
+    const auto Key = [](const LatticePoint &Point)
+    {
+      std::uint64_t Value = 0;
+      for (int nDim = 0; nDim < Dim; ++nDim)
+      {
+        Value = (Value << (MaxDepth + 1)) | static_cast<std::uint64_t>(Point(nDim));
+      }
+      return Value;
+    };
+
+    /** evaluated and requested points */
+    std::unordered_map<std::uint64_t, size_t> Known;
+    std::vector<LatticePoint> Lattice;
+    std::vector<double> Costs;
+    std::vector<Vector> Gradients;
+    std::vector<Matrix> Hessians;
+    size_t Evaluated = 0;
+
+    const auto Request = [&](const LatticePoint &Point)
+    {
+      if (Known.emplace(Key(Point), Lattice.size()).second)
+      {
+        Lattice.push_back(Point);
+      }
+    };
+
+    const auto EvaluateRequested = [&]()
+    {
+      VectorVectorSTL<Dynamic> Points;
+      Points.reserve(Lattice.size() - Evaluated);
+      for (size_t n = Evaluated; n < Lattice.size(); ++n)
+      {
+        Points.emplace_back(Lower + Step * Lattice.at(n).template cast<double>());
+      }
+
+      std::vector<double> NewCosts;
+      std::vector<Vector> NewGradients;
+      std::vector<Matrix> NewHessians;
+      EvaluateCostSurfacePoints(Graph, StatePointer, Dim, Points, NewCosts, &NewGradients, ComputeHessian ? &NewHessians : nullptr);
+
+      for (size_t n = 0; n < Points.size(); ++n)
+      {
+        const MatrixStatic<Dim,Dim> Hessian = ComputeHessian ? MatrixStatic<Dim,Dim>(NewHessians.at(n)) : MatrixStatic<Dim,Dim>::Zero();
+        StoreCostSurfacePoint<Dim>(Points.at(n), NewCosts.at(n), NewGradients.at(n), Hessian, Result);
+      }
+
+      Costs.insert(Costs.end(), NewCosts.begin(), NewCosts.end());
+      Gradients.insert(Gradients.end(), NewGradients.begin(), NewGradients.end());
+      Evaluated = Lattice.size();
+    };
+
+    struct Cell
+    {
+      LatticePoint Corner;
+      std::int64_t Size;
+      double Indicator;
+    };
+
+    const auto GetCorner = [](const Cell &Object, const int Number)
+    {
+      LatticePoint Point = Object.Corner;
+      for (int nDim = 0; nDim < Dim; ++nDim)
+      {
+        Point(nDim) += ((Number >> nDim) & 1) * Object.Size;
+      }
+      return Point;
+    };
+
+    /** the trapezoidal rule integrates the gradient of a quadratic function exactly,
+     *  so its error between two corners measures the higher order part (narrow minima, kinks, multiple modes) */
+    const auto ComputeIndicator = [&](Cell &Object)
+    {
+      std::array<size_t, CornerNumber> Index;
+      for (int c = 0; c < CornerNumber; ++c)
+      {
+        Index.at(c) = Known.at(Key(GetCorner(Object, c)));
+      }
+
+      Object.Indicator = 0.0;
+      for (int i = 0; i < CornerNumber; ++i)
+      {
+        for (int j = i + 1; j < CornerNumber; ++j)
+        {
+          const SizedVector Difference = Step * (Lattice.at(Index.at(j)) - Lattice.at(Index.at(i))).template cast<double>();
+          const double Error = Costs.at(Index.at(j)) - Costs.at(Index.at(i))
+                               - 0.5 * (Gradients.at(Index.at(i)) + Gradients.at(Index.at(j))).dot(Difference);
+          if (std::isfinite(Error))
+          {
+            Object.Indicator = std::max(Object.Indicator, std::abs(Error));
+          }
+        }
+      }
+    };
+
+    /** points that a split of the cell would add */
+    const auto CountNewPoints = [&](const Cell &Object)
+    {
+      size_t Number = 0;
+      LatticePoint Offset = LatticePoint::Zero();
+      const std::int64_t Half = Object.Size / 2;
+      for (int n = 0; n < RefinedNumber; ++n)
+      {
+        int Remainder = n;
+        for (int nDim = 0; nDim < Dim; ++nDim)
+        {
+          Offset(nDim) = (Remainder % 3) * Half;
+          Remainder /= 3;
+        }
+        Number += (Known.count(Key(Object.Corner + Offset)) == 0) ? 1 : 0;
+      }
+      return Number;
+    };
+
+    const auto Split = [&](const Cell &Object, std::vector<Cell> &Children)
+    {
+      const std::int64_t Half = Object.Size / 2;
+      for (int c = 0; c < CornerNumber; ++c)
+      {
+        Cell Child {Object.Corner, Half, 0.0};
+        for (int nDim = 0; nDim < Dim; ++nDim)
+        {
+          Child.Corner(nDim) += ((c >> nDim) & 1) * Half;
+        }
+        for (int Corner = 0; Corner < CornerNumber; ++Corner)
+        {
+          Request(GetCorner(Child, Corner));
+        }
+        Children.push_back(Child);
+      }
+    };
+
+    /** uniform start with about a quarter of the budget */
+    int Depth = 1;
+    while (Depth < MaxDepth && std::pow((1 << (Depth + 1)) + 1, Dim) <= std::max(Budget / 4, CornerNumber))
+    {
+      Depth++;
+    }
+
+    std::vector<Cell> Leaves;
+    const std::int64_t CellsPerDim = std::int64_t(1) << Depth;
+    const std::int64_t CellSize = Resolution >> Depth;
+    for (std::int64_t n = 0; n < static_cast<std::int64_t>(std::pow(CellsPerDim, Dim)); ++n)
+    {
+      Cell Object {LatticePoint::Zero(), CellSize, 0.0};
+      std::int64_t Remainder = n;
+      for (int nDim = 0; nDim < Dim; ++nDim)
+      {
+        Object.Corner(nDim) = (Remainder % CellsPerDim) * CellSize;
+        Remainder /= CellsPerDim;
+      }
+      for (int c = 0; c < CornerNumber; ++c)
+      {
+        Request(GetCorner(Object, c));
+      }
+      Leaves.push_back(Object);
+    }
+    EvaluateRequested();
+    for (Cell &Object : Leaves)
+    {
+      ComputeIndicator(Object);
+    }
+
+    /** refine the worst cells in rounds, so each round is evaluated in parallel */
+    while (static_cast<int>(Evaluated) < Budget)
+    {
+      const size_t Remaining = static_cast<size_t>(Budget) - Evaluated;
+      const size_t RoundLimit = std::min(Remaining, std::max(Remaining / 4, static_cast<size_t>(RefinedNumber)));
+
+      std::sort(Leaves.begin(), Leaves.end(), [](const Cell &A, const Cell &B) {return A.Indicator > B.Indicator;});
+
+      std::vector<Cell> Children;
+      size_t SplitNumber = 0;
+      for (const Cell &Object : Leaves)
+      {
+        if (Object.Size < 2 || !(Object.Indicator > 0.0))
+        {
+          break;
+        }
+        if (Lattice.size() - Evaluated + CountNewPoints(Object) > RoundLimit)
+        {
+          break;
+        }
+        Split(Object, Children);
+        SplitNumber++;
+      }
+
+      if (SplitNumber == 0)
+      {
+        break;
+      }
+
+      EvaluateRequested();
+      for (Cell &Object : Children)
+      {
+        ComputeIndicator(Object);
+      }
+
+      /** the split cells are the first ones */
+      Leaves.erase(Leaves.begin(), Leaves.begin() + static_cast<std::ptrdiff_t>(SplitNumber));
+      Leaves.insert(Leaves.end(), Children.begin(), Children.end());
+    }
+  }
 }
 
 #endif // FACTORGRAPHSAMPLING_H
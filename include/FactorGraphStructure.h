@@ -35,10 +35,16 @@
 #include "FactorIDSet.h"
 #include "Hash.h"
 #include "Messages.h"
+#include "PointerMap.h"
 #include "StateDataSet.h"
 #include "SensorDataSet.h"
 #include "error_models/ErrorModel.h"
 
+#include <atomic>
+#include <map>
+#include <memory>
+#include <set>
+
 namespace libRSF
 {
 
@@ -52,7 +58,7 @@ namespace libRSF
       /** define a structure that stores all relevant information */
       struct StateInfo
       {
-        std::string Name;
+        StateKey Name;
         double Timestamp;
         int Number;
         DataType Type;
@@ -101,6 +107,10 @@ namespace libRSF
         Info.ErrorInputSize = ErrorModel->InputDim;
         Info.ErrorOutputSize = ErrorModel->OutputDim;
         Info.ErrorModel = static_cast<ErrorModelBase*>(ErrorModel);
+        if (Info.ErrorModel != nullptr) /**< marginal priors have no error model */
+        {
+          Info.ErrorModel->setGroup(this->getErrorModelGroup_(Type));
+        }
         Factors_.emplace(CeresID, Info);
 
         /** collect state information */
@@ -110,24 +120,42 @@ namespace libRSF
           {
             StateInfo State;
             State.Name = States.at(n).ID;
-            State.Timestamp = States.at(n).Timestamp;
+            State.Timestamp = States.at(n).getTimestamp();
             State.Number = States.at(n).Number;
             State.Type = StateTypes.at(n);
 
             States_.emplace(StatePointers.at(n), State);
           }
+
+          /** remember that this state got new information */
+          ChangedStates_.emplace(StatePointers.at(n));
         }
       }
 
+      /** capacity of the maps for the total number of states and factors */
+      void reserve(size_t States, size_t Factors);
+
       void removeFactor(const FactorID &Factor);
       void removeFactor(ceres::ResidualBlockId Factor);
       void removeState(const StateID &State);
 
+      /** bulk removal, the factor numbers of each affected timestamp are corrected only once */
+      void removeFactors(const std::vector<ceres::ResidualBlockId> &Factors);
+      void removeStates(const std::vector<StateID> &States);
+
+      /** remove all factors up to Timestamp with one erase per type, the removed IDs are returned for ceres */
+      void removeFactorsBeforeOrEqual(double Timestamp, std::vector<ceres::ResidualBlockId> &Factors);
+
       /** query single variables */
       void getResidualID(const FactorID &Factor, ceres::ResidualBlockId &Residual) const;
       void getErrorModel(const FactorID &Factor, ErrorModelBase* &ErrorModel) const;
+      void getErrorModel(ceres::ResidualBlockId Factor, ErrorModelBase* &ErrorModel) const;
       void getErrorInputSize(const FactorID &Factor, int &ResidualSize) const;
       void getErrorOutputSize(const FactorID &Factor, int &ResidualSize) const;
+      [[nodiscard]] bool getFactorInfo(ceres::ResidualBlockId Factor, FactorInfo &Info) const;
+
+      /** factors got new ceres IDs after they were re-inserted, old and new IDs may overlap */
+      void replaceResidualIDs(const std::vector<std::pair<ceres::ResidualBlockId, ceres::ResidualBlockId>> &Factors);
 
       /** query multiple variables */
       void getFactorIDs(FactorType Type, std::vector<FactorID> &Factors) const;
@@ -137,6 +165,10 @@ namespace libRSF
       /** query connected things */
       void getFactorsOfState(const StateID &State, std::vector<FactorID> &Factors) const;
 
+      /** groups of factors that share no variable state, constant states do not connect factors and
+       *  factors without any variable state belong to no group */
+      void getConnectedComponents(std::vector<std::vector<ceres::ResidualBlockId>> &Components) const;
+
       /** query timestamps */
       void getTimesBetween(FactorType Type, double StartTime, double EndTime, std::vector<double> &Times) const;
       void getTimesBelow(FactorType Type, double EndTime, std::vector<double> &Times) const;
@@ -150,15 +182,44 @@ namespace libRSF
       [[nodiscard]] int countFactor(FactorType Type, double Timestamp) const;
       [[nodiscard]] int countFactorType(FactorType Type) const;
 
+      /** estimated bytes of all maps that represent the structure */
+      [[nodiscard]] size_t getMemorySize() const;
+
       /** check stuff */
       [[nodiscard]] bool checkFactor(FactorType Type, double Timestamp, int Number = 0) const;
       [[nodiscard]] bool checkFactor(FactorType Type) const;
+      [[nodiscard]] bool checkResidualID(ceres::ResidualBlockId Residual) const;
+
+      /** landmarks are named "Landmark..." or are static points (timestamp zero) */
+      [[nodiscard]] bool isLandmark(double *State) const;
+
+      /** timestamp of a state, false if the state is unknown */
+      [[nodiscard]] bool getStateTimestamp(double *State, double &Timestamp) const;
+
+      /** compare the registered factors of one type with the ceres problem, only active in debug builds */
+      [[nodiscard]] bool validateResidualIDs(FactorType Type) const;
+
+      /** enable or disable the error models of all factors of one type at once, also for factors added later */
+      void setErrorModelsEnabled(FactorType Type, bool Enable);
+      [[nodiscard]] bool areErrorModelsEnabled(FactorType Type) const;
+
+      /** track modifications of the graph since the last solve */
+      void getChangedStates(std::vector<double*> &States) const;
+      [[nodiscard]] int countChangedStates() const;
+      void resetChangedStates();
 
     private:
+      const std::atomic<bool>* getErrorModelGroup_(FactorType Type);
+
+      /** one shared flag per factor type, the map keeps the addresses stable */
+      std::map<FactorType, std::unique_ptr<std::atomic<bool>>> ErrorModelGroups_;
 
       /** mapping ceres --> libRSF */
-      std::map<double*, StateInfo> States_;
-      std::map<ceres::ResidualBlockId, FactorInfo> Factors_;
+      PointerMap<double*, StateInfo> States_;
+      PointerMap<ceres::ResidualBlockId, FactorInfo> Factors_;
+
+      /** states that are connected to added or removed factors */
+      std::set<double*> ChangedStates_;
 
       /** mapping libRSF --> ceres */
       FactorIDSet FactorList_;
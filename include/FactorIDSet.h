@@ -47,17 +47,10 @@ namespace libRSF
       FactorIDSet() = default;
       ~FactorIDSet() override = default;
 
-      /** specialized hash for FactorType enum */
+      /** specialized hash for FactorType enum, the same as std::hash<FactorID> */
       struct HashGlobalID
       {
-        size_t operator() (const UniqueID &Object) const
-        {
-          size_t H1 = std::hash<size_t>()(static_cast<size_t>(Object.ID));
-          size_t H2 = std::hash<double>()(roundToTick(Object.Timestamp));
-          size_t H3 = std::hash<size_t>()(Object.Number);
-
-          return H1 ^ H2 ^ H3;
-        }
+        size_t operator() (const UniqueID &Object) const;
       };
 
       using DataSet<FactorType, CeresFactorID>::addElement;
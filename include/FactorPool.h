@@ -0,0 +1,189 @@
+/***************************************************************************
+ * libRSF - A Robust Sensor Fusion Library
+ *
+ * Copyright (C) 2018 Chair of Automation Technology / TU Chemnitz
+ * For more information see https://www.tu-chemnitz.de/etit/proaut/libRSF
+ *
+ * libRSF is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libRSF is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with libRSF.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Tim Pfeifer (tim.pfeifer@etit.tu-chemnitz.de)
+ ***************************************************************************/
+
+/**
+ * @file FactorPool.h
+ * @author Tim Pfeifer
+ * @date 14.10.2026
+ * @brief Recycled memory for the cost functions and factors of a graph.
+ * @copyright GNU Public License.
+ *
+ */
+
+#ifndef FACTORPOOL_H
+#define FACTORPOOL_H
+
+#include "PointerMap.h"
+#include "Types.h"
+
+#include <ceres/ceres.h>
+
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace libRSF
+{
+  /** \brief Blocks of a fixed size, allocated in chunks and recycled after deallocation. */
+  class MemoryPool
+  {
+    public:
+      MemoryPool(size_t BlockSize, size_t BlocksPerChunk);
+      ~MemoryPool();
+
+      MemoryPool(const MemoryPool&) = delete;
+      MemoryPool& operator=(const MemoryPool&) = delete;
+
+      void* allocate();
+      void deallocate(void* Block);
+
+      [[nodiscard]] size_t countUsed() const;
+
+      /** bytes of all allocated chunks, used or not */
+      [[nodiscard]] size_t getMemorySize() const;
+
+      /** every block starts at a cache line */
+      static constexpr size_t Alignment = 64;
+
+    private:
+      size_t BlockSize_;
+      size_t BlocksPerChunk_;
+      size_t Used_ = 0;
+
+      std::vector<void*> Chunks_;
+      std::vector<void*> Free_;
+  };
+
+  /** \brief Owns the cost functions of a graph, one set of pools per factor type.
+   *
+   * A cost function can share its block with the factor that it evaluates.
+   * The ceres::Problem must not take the ownership of the created cost functions.
+   */
+  class FactorPool
+  {
+    public:
+      FactorPool() = default;
+      ~FactorPool();
+
+      FactorPool(const FactorPool&) = delete;
+      FactorPool& operator=(const FactorPool&) = delete;
+
+      /** number of blocks that are allocated at once, if a pool of this type grows */
+      void setBlocksPerChunk(FactorType Type, size_t Blocks);
+
+      /** cost function that holds all its data */
+      template <typename CostFunctionType, typename... ArgumentTypes>
+      CostFunctionType* create(const FactorType Type, ArgumentTypes&&... Arguments)
+      {
+        static_assert(alignof(CostFunctionType) <= MemoryPool::Alignment, "Over-aligned cost function!");
+
+        MemoryPool &Pool = this->getPool_(Type, sizeof(CostFunctionType));
+        void* Block = Pool.allocate();
+
+        auto* CostFunction = new (Block) CostFunctionType(std::forward<ArgumentTypes>(Arguments)...);
+        Owners_.emplace(CostFunction, &Pool);
+        return CostFunction;
+      }
+
+      /** factor and the cost function that wraps it in one block, the cost function is constructed from the factor pointer */
+      template <typename CostFunctionType, typename FactorClass, typename... ArgumentTypes>
+      CostFunctionType* createWithFactor(const FactorType Type, FactorClass* &Factor, ArgumentTypes&&... FactorArguments)
+      {
+        MemoryPool &Pool = this->getPool_(Type, getBlockSizeWithFactor_<CostFunctionType, FactorClass>());
+        auto* CostFunction = constructWithFactor<CostFunctionType>(Pool.allocate(), Factor, std::forward<ArgumentTypes>(FactorArguments)...);
+        Owners_.emplace(CostFunction, &Pool);
+        return CostFunction;
+      }
+
+      /** staged version of createWithFactor() for parallel construction, only constructWithFactor() may run concurrently */
+      template <typename CostFunctionType, typename FactorClass>
+      std::vector<void*> allocateWithFactor(const FactorType Type, const size_t Number)
+      {
+        MemoryPool &Pool = this->getPool_(Type, getBlockSizeWithFactor_<CostFunctionType, FactorClass>());
+        std::vector<void*> Blocks(Number);
+        for (void* &Block : Blocks)
+        {
+          Block = Pool.allocate();
+        }
+        return Blocks;
+      }
+
+      template <typename CostFunctionType, typename FactorClass, typename... ArgumentTypes>
+      static CostFunctionType* constructWithFactor(void* Block, FactorClass* &Factor, ArgumentTypes&&... FactorArguments)
+      {
+        Factor = new (static_cast<unsigned char*>(Block) + getFactorOffset_<CostFunctionType, FactorClass>())
+                     FactorClass(std::forward<ArgumentTypes>(FactorArguments)...);
+        return new (Block) CostFunctionType(Factor);
+      }
+
+      /** take the ownership of constructed objects from allocated blocks */
+      template <typename CostFunctionType, typename FactorClass>
+      void adoptWithFactor(const FactorType Type, const std::vector<ceres::CostFunction*> &CostFunctions)
+      {
+        MemoryPool &Pool = this->getPool_(Type, getBlockSizeWithFactor_<CostFunctionType, FactorClass>());
+        Owners_.reserve(Owners_.size() + CostFunctions.size());
+        for (ceres::CostFunction* CostFunction : CostFunctions)
+        {
+          Owners_.emplace(CostFunction, &Pool);
+        }
+      }
+
+      /** destruct and recycle, returns false if the object does not belong to this pool */
+      bool destroy(ceres::CostFunction* CostFunction);
+
+      [[nodiscard]] size_t countObjects() const;
+
+      /** bytes of the pools per factor type and of all pools including the ownership table */
+      [[nodiscard]] std::map<FactorType, size_t> getMemorySizePerType() const;
+      [[nodiscard]] size_t getMemorySize() const;
+
+    private:
+      MemoryPool& getPool_(FactorType Type, size_t BlockSize);
+
+      /** the factor follows its cost function inside the block */
+      template <typename CostFunctionType, typename FactorClass>
+      static constexpr size_t getFactorOffset_()
+      {
+        static_assert(alignof(CostFunctionType) <= MemoryPool::Alignment, "Over-aligned cost function!");
+        static_assert(alignof(FactorClass) <= MemoryPool::Alignment, "Over-aligned factor!");
+
+        return (sizeof(CostFunctionType) + alignof(FactorClass) - 1) / alignof(FactorClass) * alignof(FactorClass);
+      }
+
+      template <typename CostFunctionType, typename FactorClass>
+      static constexpr size_t getBlockSizeWithFactor_()
+      {
+        return getFactorOffset_<CostFunctionType, FactorClass>() + sizeof(FactorClass);
+      }
+
+      std::map<std::pair<FactorType, size_t>, std::unique_ptr<MemoryPool>> Pools_;
+      std::map<FactorType, size_t> BlocksPerChunk_;
+      PointerMap<ceres::CostFunction*, MemoryPool*> Owners_;
+
+      static constexpr size_t DefaultBlocksPerChunk_ = 256;
+  };
+}
+
+#endif // FACTORPOOL_H
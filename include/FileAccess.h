@@ -34,12 +34,16 @@
 
 #include "StateDataSet.h"
 #include "SensorDataSet.h"
+#include "FileView.h"
+#include "Tracing.h"
 
 #include <ceres/ceres.h>
 
 #include <cmath>
+#include <cstdint>
 
 #include <cstdio>
+#include <limits>
 #include <vector>
 #include <random>
 #include <iostream>
@@ -56,10 +60,110 @@ namespace libRSF
   void ReadDataFromFile(const string& Filename,
                         SensorDataSet& Data);
 
+  /** parse a text file on multiple threads, ThreadNumber <= 0 uses all cores */
+  void ReadDataFromFileParallel(const string& Filename,
+                                SensorDataSet& Data,
+                                int ThreadNumber = 0);
+
   void WriteDataToFile(const string& Filename,
                        const string& DataName,
                        const StateDataSet& Data,
                        bool Append = false);
+
+  /** same output as consecutive calls for each name, but the names are formatted concurrently
+   *  and written with a single open of the file, ThreadNumber <= 0 uses all cores */
+  void WriteDataToFile(const string& Filename,
+                       const std::vector<string>& DataNames,
+                       const StateDataSet& Data,
+                       bool Append = false,
+                       int ThreadNumber = 0);
+
+  /** true if the file starts with the header of the binary format */
+  bool IsBinaryDataFile(const string& Filename);
+
+  /** header of the binary format, for writers that have to stream it */
+  constexpr char BinaryDataMagic[4] = {'R', 'S', 'F', 'B'};
+  constexpr uint32_t BinaryDataVersion = 1;
+
+  /** chunked format: every type is split into chunks of objects that are compressed independently, followed by an index */
+  constexpr uint32_t BinaryDataVersionChunked = 2;
+
+  enum class BinaryCompression : uint32_t {None = 0, Zstd = 1};
+
+  /** index entry of one chunk, the timestamps allow to skip chunks without touching them */
+  struct BinaryDataChunk
+  {
+    uint64_t ObjectNumber = 0;
+    double TimeFirst = 0.0;
+    double TimeLast = 0.0;
+    uint64_t Position = 0;    /**< byte position of the stored values */
+    uint64_t Bytes = 0;       /**< stored size, equals the raw size without compression */
+  };
+
+  /** all chunks of one type in temporal order */
+  struct BinaryDataBlock
+  {
+    DataType Type{};
+    int ValueNumber = 0;
+    std::vector<BinaryDataChunk> Chunks;
+  };
+
+  /** selection of a binary file, the defaults select everything */
+  struct BinaryDataFilter
+  {
+    std::vector<DataType> Types;  /**< empty selects all types */
+    double TimeBegin = -std::numeric_limits<double>::infinity();
+    double TimeEnd = std::numeric_limits<double>::infinity();
+
+    [[nodiscard]] bool checkType(DataType Type) const;
+    [[nodiscard]] bool checkTime(double Timestamp) const;
+    [[nodiscard]] bool checkRange(double TimeFirst, double TimeLast) const;
+  };
+
+  /** read the header and the index of both binary versions, the values of the legacy version form one uncompressed chunk per type */
+  bool ReadBinaryDataIndex(FileView &File,
+                           const string& Filename,
+                           BinaryCompression &Compression,
+                           std::vector<BinaryDataBlock> &Blocks);
+
+  /** copy or decompress the values of one chunk, safe to call concurrently */
+  bool DecodeBinaryDataChunk(const FileView &File,
+                             const BinaryDataChunk &Chunk,
+                             int ValueNumber,
+                             BinaryCompression Compression,
+                             std::vector<double> &Values);
+
+  /** binary format: one block of raw Data buffers per type, see FileAccess.cpp */
+  bool ReadDataFromBinaryFile(const string& Filename,
+                              SensorDataSet& Data);
+
+  /** only the chunks that overlap the filter are decoded, on multiple threads, ThreadNumber <= 0 uses all cores */
+  bool ReadDataFromBinaryFile(const string& Filename,
+                              SensorDataSet& Data,
+                              const BinaryDataFilter& Filter,
+                              int ThreadNumber = 0);
+
+  bool WriteDataToBinaryFile(const string& Filename,
+                             const SensorDataSet& Data);
+
+  /** chunked format, Zstd falls back to no compression if libRSF was built without zstd, chunks are compressed concurrently */
+  bool WriteDataToBinaryFile(const string& Filename,
+                             const SensorDataSet& Data,
+                             BinaryCompression Compression,
+                             int Level = 3,
+                             int ObjectsPerChunk = 4096);
+
+  /** convert a text file into the binary format */
+  bool ConvertDataFileToBinary(const string& TextFilename,
+                               const string& BinaryFilename);
+
+  /** binary result format: one aligned [objects x values] block per state name, without loss of precision */
+  bool WriteResultToBinaryFile(const string& Filename,
+                               const StateDataSet& Result,
+                               const std::vector<string>& Names = {});
+
+  bool ReadResultFromBinaryFile(const string& Filename,
+                                StateDataSet& Result);
 }
 
 #endif // FILEACCESS_H
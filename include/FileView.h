@@ -0,0 +1,103 @@
+/***************************************************************************
+ * libRSF - A Robust Sensor Fusion Library
+ *
+ * Copyright (C) 2018 Chair of Automation Technology / TU Chemnitz
+ * For more information see https://www.tu-chemnitz.de/etit/proaut/libRSF
+ *
+ * libRSF is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libRSF is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with libRSF.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Tim Pfeifer (tim.pfeifer@etit.tu-chemnitz.de)
+ ***************************************************************************/
+
+/**
+ * @file FileView.h
+ * @author Tim Pfeifer
+ * @date 14.10.2026
+ * @brief Read-only view of a complete file, memory-mapped where it is supported.
+ * @copyright GNU Public License.
+ *
+ */
+
+#ifndef FILEVIEW_H
+#define FILEVIEW_H
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace libRSF
+{
+  /** the pages of a mapped file are loaded by the operating system on first access and can be dropped again under memory pressure */
+  class FileView
+  {
+    public:
+      explicit FileView(const std::string &Filename);
+      ~FileView();
+
+      FileView(const FileView &) = delete;
+      FileView &operator=(const FileView &) = delete;
+
+      /** an empty file is valid, its content is empty */
+      [[nodiscard]] bool isValid() const
+      {
+        return IsOpen_;
+      }
+
+      /** sequential reading, returns false at the end of the file */
+      template <typename T>
+      bool read(T &Value)
+      {
+        return read(&Value, sizeof(T));
+      }
+
+      bool read(void *Target, size_t Bytes);
+
+      /** random access, returns false outside of the file */
+      bool readAt(size_t Position, void *Target, size_t Bytes) const;
+
+      /** position of the sequential reading */
+      [[nodiscard]] size_t getPosition() const
+      {
+        return Position_;
+      }
+
+      /** bytes behind the sequential reading */
+      [[nodiscard]] size_t getRemaining() const
+      {
+        return Size_ - Position_;
+      }
+
+      /** skip bytes of the sequential reading */
+      bool skip(size_t Bytes);
+
+      /** the complete content */
+      [[nodiscard]] std::string_view getContent() const
+      {
+        return {Begin_, Size_};
+      }
+
+    private:
+      const char *Begin_ = nullptr;
+      size_t Size_ = 0;
+      size_t Position_ = 0;
+      bool IsMapped_ = false;
+      bool IsOpen_ = false;
+
+      /** without mmap, the file is read completely */
+      std::vector<char> Fallback_;
+  };
+}
+
+#endif // FILEVIEW_H
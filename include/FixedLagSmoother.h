@@ -0,0 +1,90 @@
+/***************************************************************************
+ * libRSF - A Robust Sensor Fusion Library
+ *
+ * Copyright (C) 2018 Chair of Automation Technology / TU Chemnitz
+ * For more information see https://www.tu-chemnitz.de/etit/proaut/libRSF
+ *
+ * libRSF is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libRSF is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with libRSF.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Tim Pfeifer (tim.pfeifer@etit.tu-chemnitz.de)
+ ***************************************************************************/
+
+/**
+ * @file FixedLagSmoother.h
+ * @author Tim Pfeifer
+ * @date 14.10.2026
+ * @brief Sliding window on top of a factor graph that reduces the graph in batches.
+ * @copyright GNU Public License.
+ *
+ */
+
+#ifndef FIXEDLAGSMOOTHER_H
+#define FIXEDLAGSMOOTHER_H
+
+#include "FactorGraph.h"
+#include "FactorGraphConfig.h"
+
+namespace libRSF
+{
+  /** \brief Fixed-lag smoother that schedules the reduction of old states.
+   *
+   * Instead of marginalizing each state as soon as it leaves the window, old states are collected
+   * and marginalized together every few steps or when the window overflows too much.
+   * One marginalization of several states is cheaper than several single ones and creates
+   * only one marginal prior per connected group.
+   */
+  class FixedLagSmoother
+  {
+    public:
+      /** the lag is the guaranteed window length in seconds */
+      FixedLagSmoother(FactorGraph &Graph, double Lag, bool Marginalize = true);
+
+      /** window length and schedule from the solution config */
+      FixedLagSmoother(FactorGraph &Graph, const FactorGraphConfig &Config);
+      ~FixedLagSmoother() = default;
+
+      /** knobs, the defaults reduce the graph in every step */
+      void setLag(double Lag);
+      void setInterval(int Steps);
+      void setOverflow(double Seconds);
+      void setMaxMarginalPriors(int Number);
+      void setInflation(double Inflation);
+
+      /** call once per step after solving, returns false if the reduction failed */
+      bool update(double CurrentTime);
+
+      /** true if the next update would reduce the graph */
+      [[nodiscard]] bool isDue(double CurrentTime) const;
+
+      [[nodiscard]] double getLag() const;
+      [[nodiscard]] int countReductions() const;
+
+    private:
+      int countMarginalPriors_() const;
+
+      FactorGraph &Graph_;
+
+      double Lag_;
+      bool Marginalize_;
+      int Interval_ = 1;
+      double Overflow_ = 0.0;
+      int MaxMarginalPriors_ = 0;
+      double Inflation_ = 1.0;
+
+      int StepsSinceReduction_ = 0;
+      int Reductions_ = 0;
+  };
+}
+
+#endif // FIXEDLAGSMOOTHER_H
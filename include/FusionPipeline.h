@@ -0,0 +1,231 @@
+/***************************************************************************
+ * libRSF - A Robust Sensor Fusion Library
+ *
+ * Copyright (C) 2018 Chair of Automation Technology / TU Chemnitz
+ * For more information see https://www.tu-chemnitz.de/etit/proaut/libRSF
+ *
+ * libRSF is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libRSF is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with libRSF.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Tim Pfeifer (tim.pfeifer@etit.tu-chemnitz.de)
+ ***************************************************************************/
+
+/**
+ * @file FusionPipeline.h
+ * @author Tim Pfeifer
+ * @date 14.10.2026
+ * @brief Sensor fusion setups that are fixed at compile time.
+ * @copyright GNU Public License.
+ *
+ */
+
+#ifndef FUSIONPIPELINE_H
+#define FUSIONPIPELINE_H
+
+#include "FactorGraph.h"
+#include "SensorDataSet.h"
+
+#include <array>
+#include <tuple>
+
+namespace libRSF
+{
+  /** the states of one epoch, they are created at every new timestamp */
+  template <DataType... StateTypes>
+  struct PipelineStates
+  {
+    static constexpr size_t Number = sizeof...(StateTypes);
+    static constexpr std::array<DataType, Number> Types = {StateTypes...};
+  };
+
+  /** weighting of a measurement, the prototype of the stage is used as it is */
+  template <typename ErrorType>
+  struct PipelineNoise
+  {
+    static void update(ErrorType &Noise, const Data &Measurement)
+    {
+      static_cast<void>(Noise);
+      static_cast<void>(Measurement);
+    }
+  };
+
+  /** diagonal Gaussians take the covariance of each measurement */
+  template <int Dim>
+  struct PipelineNoise<GaussianDiagonal<Dim>>
+  {
+    static void update(GaussianDiagonal<Dim> &Noise, const Data &Measurement)
+    {
+      Noise.setCovarianceDiagonal(Measurement.getCovarianceDiagonal());
+    }
+  };
+
+  /** \brief Connects every measurement of a sensor to the epoch states.
+   *
+   * All measurements after TimeOld and up to TimeNow become one factor each, with the states
+   * of the given indices at TimeNow.
+   */
+  template <FactorType Type, DataType Sensor, typename ErrorType, size_t... States>
+  class AbsoluteSensor
+  {
+    public:
+      static constexpr DataType SensorType = Sensor;
+      static constexpr size_t FactorsPerEpoch = 0;
+
+      AbsoluteSensor() : AbsoluteSensor(ErrorType())
+      {}
+
+      explicit AbsoluteSensor(const ErrorType &Prototype) : Noise_(Prototype)
+      {
+        List_.List_.reserve(sizeof...(States));
+      }
+
+      template <size_t StateNumber>
+      bool add(FactorGraph &Graph, const std::array<StateKey, StateNumber> &Keys,
+               const SensorDataSet &Measurements, const double TimeOld, const double TimeNow)
+      {
+        static_assert(((States < StateNumber) && ...), "The sensor refers to a state that is not part of the epoch!");
+
+        for (const Data &Measurement : Measurements.rangeAfter(Sensor, TimeOld, TimeNow))
+        {
+          List_.clear();
+          (List_.add(Keys[States], TimeNow), ...);
+
+          PipelineNoise<ErrorType>::update(Noise_, Measurement);
+          Graph.addFactor<Type>(List_, Measurement, Noise_);
+        }
+        return true;
+      }
+
+    private:
+      ErrorType Noise_;
+      StateList List_;
+  };
+
+  /** \brief Connects the states of two consecutive epochs.
+   *
+   * The newest measurement up to TimeNow is used, e.g. the odometry since TimeOld. The states of
+   * the given indices are connected first at TimeOld and then at TimeNow.
+   */
+  template <FactorType Type, DataType Sensor, typename ErrorType, size_t... States>
+  class RelativeSensor
+  {
+    public:
+      static constexpr DataType SensorType = Sensor;
+      static constexpr size_t FactorsPerEpoch = 1;
+
+      RelativeSensor() : RelativeSensor(ErrorType())
+      {}
+
+      explicit RelativeSensor(const ErrorType &Prototype) : Noise_(Prototype)
+      {
+        List_.List_.reserve(2 * sizeof...(States));
+      }
+
+      template <size_t StateNumber>
+      bool add(FactorGraph &Graph, const std::array<StateKey, StateNumber> &Keys,
+               const SensorDataSet &Measurements, const double TimeOld, const double TimeNow)
+      {
+        static_assert(((States < StateNumber) && ...), "The sensor refers to a state that is not part of the epoch!");
+
+        double TimeMeasurement = 0.0;
+        if (!Measurements.getTimeBelowOrEqual(Sensor, TimeNow, TimeMeasurement))
+        {
+          PRINT_ERROR("Could not find measurement below: ", TimeNow);
+          return false;
+        }
+        const Data &Measurement = Measurements.getElement(Sensor, TimeMeasurement);
+
+        List_.clear();
+        (List_.add(Keys[States], TimeOld), ...);
+        (List_.add(Keys[States], TimeNow), ...);
+
+        PipelineNoise<ErrorType>::update(Noise_, Measurement);
+        Graph.addFactor<Type>(List_, Measurement, Noise_);
+        return true;
+      }
+
+    private:
+      ErrorType Noise_;
+      StateList List_;
+  };
+
+  /** \brief Update loop of a sensor fusion setup that is fixed at compile time.
+   *
+   * The epoch states and all sensors with their factor types and error models are template
+   * parameters, so each epoch is a fixed sequence of addFactor() calls without any decision
+   * on the configuration. Invalid combinations of factors and error models fail at compile time.
+   * The state keys are interned once at construction and the state lists of the sensors are
+   * reused. The configurable applications remain the way to experiment with different setups.
+   *
+   * Example of a 2D ranging setup with odometry:
+   *
+   *     using Ranging = FusionPipeline<PipelineStates<DataType::Point2, DataType::Angle>,
+   *                                    RelativeSensor<FactorType::Odom2, DataType::Odom2, GaussianDiagonal<3>, 0, 1>,
+   *                                    AbsoluteSensor<FactorType::Range2, DataType::Range2, GaussianDiagonal<1>, 0>>;
+   *     Ranging Pipeline({"Position", "Orientation"});
+   */
+  template <typename EpochStates, typename... Sensors>
+  class FusionPipeline
+  {
+    public:
+      static constexpr size_t StateNumber = EpochStates::Number;
+
+      /** sensors with a prototype of their error model, e.g. a mixture, are passed in their order */
+      explicit FusionPipeline(const std::array<StateKey, StateNumber> &Keys, std::tuple<Sensors...> Stages = {}) :
+        Keys_(Keys), Sensors_(std::move(Stages))
+      {}
+      ~FusionPipeline() = default;
+
+      /** states of the first epoch without any factor, e.g. to add priors */
+      void addFirstEpoch(FactorGraph &Graph, const double TimeFirst) const
+      {
+        for (size_t n = 0; n < StateNumber; n++)
+        {
+          Graph.addState(Keys_[n], EpochStates::Types[n], TimeFirst);
+        }
+      }
+
+      /** new states at TimeNow and the factors of all sensors, stops at the first sensor without measurement */
+      bool addEpoch(FactorGraph &Graph, const SensorDataSet &Measurements, const double TimeOld, const double TimeNow)
+      {
+        this->addFirstEpoch(Graph, TimeNow);
+        return std::apply([&](auto &... Sensor)
+        {
+          return (Sensor.add(Graph, Keys_, Measurements, TimeOld, TimeNow) && ...);
+        }, Sensors_);
+      }
+
+      /** capacity of the graph for a known number of epochs, e.g. for offline problems */
+      void reserve(FactorGraph &Graph, const SensorDataSet &Measurements, const size_t Epochs) const
+      {
+        size_t Factors = 0;
+        std::apply([&](const auto &... Sensor)
+        {
+          ((Factors += (Sensor.FactorsPerEpoch > 0) ? Sensor.FactorsPerEpoch * Epochs
+                                                    : static_cast<size_t>(Measurements.countElements(Sensor.SensorType))), ...);
+        }, Sensors_);
+        Graph.reserve(Epochs * StateNumber, Factors);
+      }
+
+      [[nodiscard]] const std::array<StateKey, StateNumber> &getKeys() const
+      {
+        return Keys_;
+      }
+
+    private:
+      std::array<StateKey, StateNumber> Keys_;
+      std::tuple<Sensors...> Sensors_;
+  };
+}
+
+#endif // FUSIONPIPELINE_H
@@ -43,6 +43,8 @@
 
 #include <Eigen/Dense>
 
+#include <vector>
+
 namespace libRSF
 {
   /** convert points between the global ECEF system and a local ENU frame */
@@ -70,6 +72,10 @@ namespace libRSF
     void convertAllStatesToLocal(StateDataSet &States, const std::string& ID);
     void convertAllStatesToGlobal(StateDataSet &States, const std::string& ID);
 
+    /** in-place conversion of contiguous 3xN arrays of points */
+    void convertPointsToLocal(double* Points, Index Number) const;
+    void convertPointsToGlobal(double* Points, Index Number) const;
+
   private:
     /** convert mean only */
     [[nodiscard]] Vector3 convertToLocal_(const Vector3 &GlobalPoint) const;
@@ -86,14 +92,44 @@ namespace libRSF
                          Vector3  &GlobalPoint,
                          Matrix33 &GlobalCov) const;
 
+    /** convert all states of one type in place */
+    void convertAllStates_(StateDataSet &States, const std::string& ID, bool ToLocal) const;
+
     bool                              isInitialized_;
     Vector3                           TangentPoint_;
 
+    /** the tangent plane is an affine transformation: Local = RotationToLocal_ * (Global - Origin_) */
+    Matrix33                          RotationToLocal_;
+    Vector3                           Origin_;
+
     GeographicLib::LocalCartesian     LocalProjection_;
     const GeographicLib::Geocentric   Earth_ = GeographicLib::Geocentric::WGS84();
   };
 
-
+  /** raw pseudo range error of one satellite, optionally with the Sagnac correction of the ECEF factor */
+  double PseudorangeError(const Vector3 &Position,
+                          double ClockError,
+                          const Vector3 &SatPos,
+                          double Range,
+                          bool UseSagnac);
+
+  /** Gauss-Newton for position and clock error from exactly four satellites, uses only fixed-size types
+   * Position and ClockError are the initial guess, returns false for a degenerated geometry or without convergence */
+  bool SolveMinimalPseudoranges(const Matrix34 &SatPos,
+                                const Vector4 &Ranges,
+                                bool UseSagnac,
+                                Vector3 &Position,
+                                double &ClockError,
+                                int MaxIterations = 20);
+
+  /** least squares of position and clock error from four or more satellites, the normal equations are fixed-size
+   * Position and ClockError are the initial guess, returns false for a degenerated geometry or without convergence */
+  bool SolvePseudoranges(const std::vector<Vector3> &SatPos,
+                         const std::vector<double> &Ranges,
+                         bool UseSagnac,
+                         Vector3 &Position,
+                         double &ClockError,
+                         int MaxIterations = 20);
 }
 
 #endif // GNSS_H
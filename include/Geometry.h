@@ -53,6 +53,19 @@ namespace libRSF
     return Rot2D.toRotationMatrix();
   }
 
+  /** one sincos instead of the general rotation object */
+  template <>
+  inline MatrixT<double, 2, 2> RotationMatrix2D<double>(const double Yaw)
+  {
+    const double Sin = std::sin(Yaw);
+    const double Cos = std::cos(Yaw);
+
+    MatrixT<double, 2, 2> Rot;
+    Rot << Cos, -Sin,
+           Sin,  Cos;
+    return Rot;
+  }
+
   template <typename T>
   VectorT<T, 3> RelativeMotion2D(const T* PointOld, const T* YawOld, const T* PointNew, const T* const YawNew)
   {
@@ -67,6 +80,23 @@ namespace libRSF
     return RelativeMotion;
   }
 
+  /** the transposed rotation is applied directly */
+  template <>
+  inline VectorT<double, 3> RelativeMotion2D<double>(const double* PointOld, const double* YawOld, const double* PointNew, const double* const YawNew)
+  {
+    const double Sin = std::sin(YawOld[0]);
+    const double Cos = std::cos(YawOld[0]);
+    const double DX = PointNew[0] - PointOld[0];
+    const double DY = PointNew[1] - PointOld[1];
+
+    VectorT<double, 3> RelativeMotion;
+    RelativeMotion(0) =  Cos * DX + Sin * DY;
+    RelativeMotion(1) = -Sin * DX + Cos * DY;
+    RelativeMotion(2) = NormalizeAngle(YawNew[0] - YawOld[0]);
+
+    return RelativeMotion;
+  }
+
   /** 3D */
   template<typename T>
   MatrixT<T,3,3> SkewSymmetricMatrix (const VectorT<T, 3> &Omega)
@@ -118,6 +148,61 @@ namespace libRSF
     return Angle;
   }
 
+  /** below this half angle, the double versions use a Taylor series of fourth order, its error is below 1e-19 */
+  constexpr double SmallHalfAngle = 1e-3;
+
+  /** double versions without axis-angle objects: one sincos (or none) and no normalization of the axis */
+  template<>
+  inline Quaternion QuaternionExpMap<double> (const Vector3 &Angle)
+  {
+    const double HalfSquared = 0.25 * Angle.squaredNorm();
+
+    double Cos, SinByAngle;
+    if (HalfSquared < SmallHalfAngle * SmallHalfAngle)
+    {
+      Cos = 1.0 - HalfSquared / 2.0 + HalfSquared * HalfSquared / 24.0;
+      SinByAngle = 0.5 * (1.0 - HalfSquared / 6.0 + HalfSquared * HalfSquared / 120.0);
+    }
+    else
+    {
+      const double Half = std::sqrt(HalfSquared);
+      Cos = std::cos(Half);
+      SinByAngle = std::sin(Half) / (2.0 * Half);
+    }
+
+    Quaternion Quat;
+    Quat.vec() = Angle * SinByAngle;
+    Quat.w() = Cos;
+    return Quat;
+  }
+
+  template<>
+  inline Vector3 QuaternionLogMap<double> (const Quaternion &Quat)
+  {
+    /** the shorter rotation, like the axis-angle conversion */
+    const double Sign = (Quat.w() < 0.0) ? -1.0 : 1.0;
+    const double W = Sign * Quat.w();
+    const double SinHalf = Quat.vec().norm();
+
+    double AngleBySin;
+    if (SinHalf < SmallHalfAngle * W)
+    {
+      /** atan(x)/x with x = SinHalf/W */
+      const double RatioSquared = (SinHalf * SinHalf) / (W * W);
+      AngleBySin = 2.0 / W * (1.0 - RatioSquared / 3.0 + RatioSquared * RatioSquared / 5.0);
+    }
+    else
+    {
+      AngleBySin = 2.0 * std::atan2(SinHalf, W) / SinHalf;
+    }
+
+    return Quat.vec() * (Sign * AngleBySin);
+  }
+
+  /** column-wise versions for many rotations, the quaternions are stored as [x y z w] columns, evaluated with Eigen's packet math */
+  void QuaternionExpMap(const MatrixT<double, 3, Dynamic> &Angles, MatrixT<double, 4, Dynamic> &Quaternions);
+  void QuaternionLogMap(const MatrixT<double, 4, Dynamic> &Quaternions, MatrixT<double, 3, Dynamic> &Angles);
+
   template<typename T>
   QuaternionT<T> AngularVelocityToQuaternion (const VectorT<T, 3> &Omega, const double DeltaTime)
   {
@@ -176,6 +261,45 @@ namespace libRSF
                           Matrix34 *Jacobian2 = nullptr);
 
 
+  /** \brief Derivative of the exponential map: Exp(Phi + Delta) = Exp(Phi) * Exp(Jr(Phi) * Delta)
+   *
+   * \param Phi rotation vector
+   * \return right Jacobian of SO(3)
+   *
+   */
+  Matrix33 RightJacobianSO3(const Vector3 &Phi);
+
+  /** \brief Derivative of the logarithmic map: Log(Exp(Phi) * Exp(Delta)) = Phi + Jr^-1(Phi) * Delta
+   *
+   * \param Phi rotation vector
+   * \return inverse of the right Jacobian of SO(3), the left one is RightJacobianInverseSO3(-Phi)
+   *
+   */
+  Matrix33 RightJacobianInverseSO3(const Vector3 &Phi);
+
+  /** \brief Maps a derivative w.r.t. the left increment of QuaternionLocalParameterization to the coefficients [x,y,z,w]
+   *
+   * The product with the Jacobian of the parametrization restores the local derivative,
+   * the direction along the quaternion itself gets a zero derivative.
+   *
+   * \param Quat current quaternion
+   * \param Local derivative w.r.t. the rotation vector of the left increment
+   * \param Global row-major Rows x 4 derivative
+   *
+   */
+  template<int Rows>
+  void QuaternionLocalToGlobalJacobian(const Quaternion &Quat, const MatrixStatic<Rows, 3> &Local, double* Global)
+  {
+    /** four times the transposed Jacobian of the parametrization, which has orthogonal columns of length 0.5 */
+    Matrix34 Lift;
+    Lift <<  Quat.w(), -Quat.z(),  Quat.y(), -Quat.x(),
+             Quat.z(),  Quat.w(), -Quat.x(), -Quat.y(),
+            -Quat.y(),  Quat.x(),  Quat.w(), -Quat.z();
+
+    MatrixRef<double, Rows, 4> GlobalMap(Global);
+    GlobalMap.noalias() = 2.0 * Local * Lift;
+  }
+
   template<typename T>
   QuaternionT<T> RPYToQuaternion (const T Roll, const T Pitch, const T Yaw)
   {
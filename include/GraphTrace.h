@@ -0,0 +1,132 @@
+/***************************************************************************
+ * libRSF - A Robust Sensor Fusion Library
+ *
+ * Copyright (C) 2018 Chair of Automation Technology / TU Chemnitz
+ * For more information see https://www.tu-chemnitz.de/etit/proaut/libRSF
+ *
+ * libRSF is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libRSF is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with libRSF.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Tim Pfeifer (tim.pfeifer@etit.tu-chemnitz.de)
+ ***************************************************************************/
+
+/**
+ * @file GraphTrace.h
+ * @author Tim Pfeifer
+ * @date 14.10.2026
+ * @brief Binary trace of all mutating operations of a factor graph for a later replay.
+ * @copyright GNU Public License.
+ *
+ */
+
+#ifndef GRAPHTRACE_H
+#define GRAPHTRACE_H
+
+#include "Checkpoint.h"
+#include "Messages.h"
+
+#include <ceres/ceres.h>
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace libRSF
+{
+  /** every record of a trace starts with one of these codes */
+  enum class TraceOperation : uint8_t
+  {
+    AddState,
+    AddFactor,
+    AddStatePrior,
+    SetMeans,
+    RemoveFactor,
+    RemoveFactors,
+    RemoveFactorsOutsideWindow,
+    RemoveAllFactorsOutsideWindow,
+    RemoveState,
+    RemoveStates,
+    RemoveStatesOutsideWindow,
+    RemoveAllStatesOutsideWindow,
+    RemoveBefore,
+    SetConstant,
+    SetVariable,
+    SetVariableAll,
+    SetConstantOutsideWindow,
+    SetVariableInsideWindow,
+    SetAllConstantOutsideWindow,
+    SetAllVariableInsideWindow,
+    MarginalizeStates,
+    MarginalizeOutsideWindow,
+    EnableErrorModel,
+    DisableErrorModel,
+    EnableErrorModels,
+    DisableErrorModels,
+    SetWarmStart,
+    SetLandmarksFirst,
+    SetDenseSolverThreshold,
+    Solve,
+    SolveIncremental,
+    SetTimeChainOrdering,
+    RemoveStateList,
+    SolveComponents,
+    SetWindowExempt,
+    Number /**< has to be the last one */
+  };
+
+  /** readable name of an operation, e.g. for timing reports */
+  const char* GetTraceOperationName(TraceOperation Operation);
+
+  /** duration of one operation during the recording and during the replay */
+  struct TraceTiming
+  {
+    TraceOperation Operation = TraceOperation::Number;
+    double Recorded = 0.0;
+    double Replayed = 0.0;
+  };
+
+  /** the serializable part of the solver options, callbacks and orderings can not be stored */
+  void WriteSolverOptions(CheckpointWriter &Writer, const ceres::Solver::Options &Options);
+  bool ReadSolverOptions(CheckpointReader &Reader, ceres::Solver::Options &Options);
+
+  /** continuous trace file, records are buffered and written in blocks
+   *
+   * layout: char[4] magic "RSFT", uint32 version, then per record:
+   * uint8 operation, the payload of the operation, double duration of the recorded call
+   * factors are recorded after they were added, so their duration is zero
+   */
+  class GraphTraceWriter
+  {
+    public:
+      explicit GraphTraceWriter(const std::string &Filename);
+      ~GraphTraceWriter();
+
+      [[nodiscard]] bool isValid() const;
+
+      /** the payload is written into the returned writer, end() completes the record */
+      CheckpointWriter &begin(TraceOperation Operation);
+      void end(double Duration);
+
+      void flush();
+
+    private:
+      std::ofstream File_;
+      CheckpointWriter Buffer_;
+  };
+
+  /** read the header of a trace, the reader is positioned at the first record afterwards */
+  bool OpenGraphTrace(const std::string &Filename, CheckpointReader &Reader);
+}
+
+#endif // GRAPHTRACE_H
@@ -43,6 +43,7 @@ namespace std
   using std::hash;
   using std::string;
 
+  /** mixing combination of three hashes, e.g. type, time tick and number */
   size_t CombineHash(size_t H1, size_t H2, size_t H3);
 
   template <>
@@ -60,18 +61,27 @@ namespace std
     size_t operator()(const libRSF::FactorID& Object) const
     {
       return CombineHash(hash<libRSF::FactorType>()(Object.ID),
-                         hash<double>()(Object.Timestamp),
+                         hash<libRSF::TimeTick>()(Object.Tick),
                          hash<size_t>()(Object.Number));
     }
   };
 
+  template <>
+  struct hash<libRSF::StateKey>
+  {
+    size_t operator()(const libRSF::StateKey& Object) const
+    {
+      return hash<int>()(Object.getID());
+    }
+  };
+
   template<>
   struct hash<libRSF::StateID>
   {
     size_t operator()(const libRSF::StateID& Object) const
     {
-      return CombineHash(hash<string>()(Object.ID),
-                         hash<double>()(Object.Timestamp),
+      return CombineHash(hash<libRSF::StateKey>()(Object.ID),
+                         hash<libRSF::TimeTick>()(Object.Tick),
                          hash<size_t>()(Object.Number));
     }
   };
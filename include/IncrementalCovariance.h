@@ -0,0 +1,91 @@
+/***************************************************************************
+ * libRSF - A Robust Sensor Fusion Library
+ *
+ * Copyright (C) 2018 Chair of Automation Technology / TU Chemnitz
+ * For more information see https://www.tu-chemnitz.de/etit/proaut/libRSF
+ *
+ * libRSF is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libRSF is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with libRSF.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Tim Pfeifer (tim.pfeifer@etit.tu-chemnitz.de)
+ ***************************************************************************/
+
+/**
+ * @file IncrementalCovariance.h
+ * @author Tim Pfeifer
+ * @date 14.10.2026
+ * @brief Marginal covariance of the newest states, propagated like an information filter.
+ * @copyright GNU Public License.
+ *
+ */
+
+#ifndef INCREMENTALCOVARIANCE_H
+#define INCREMENTALCOVARIANCE_H
+
+#include "VectorMath.h"
+#include "Messages.h"
+
+#include <ceres/ceres.h>
+
+#include <unordered_set>
+#include <vector>
+
+namespace libRSF
+{
+  /** @brief Tracks the marginal information of the newest epoch of a chain.
+   * A step linearizes only the factors of the new epoch and eliminates the previous one,
+   * so its cost does not depend on the window length. The older factors keep their
+   * linearization point, so the result has to be anchored by an exact marginal covariance
+   * at the start, after a number of steps and whenever a factor does not fit into the chain.
+   */
+  class IncrementalCovariance
+  {
+    public:
+      explicit IncrementalCovariance(int AnchorInterval = 50);
+      ~IncrementalCovariance() = default;
+
+      /** restart from the exact joint covariance (local parametrization) of all variable states of one epoch */
+      bool anchor(const ceres::Problem &Graph, const std::vector<double*> &Epoch, const Matrix &Covariance);
+
+      /** move to the next epoch, false if the factors of Epoch do not only connect it to the current one */
+      bool propagate(ceres::Problem &Graph, const std::vector<double*> &Epoch);
+
+      /** covariance (global parametrization, row-major) of one state of the current epoch */
+      bool getCovarianceBlock(const ceres::Problem &Graph, const double* State, double* Covariance) const;
+
+      [[nodiscard]] bool isValid() const;
+      [[nodiscard]] bool needsAnchor() const;
+      [[nodiscard]] bool hasState(const double* State) const;
+      void reset();
+
+      [[nodiscard]] int countSteps() const;
+
+    private:
+      /** local size and offset of each state of the current epoch */
+      void setEpoch_(const ceres::Problem &Graph, const std::vector<double*> &Epoch);
+
+      std::vector<double*> States_;
+      std::vector<int> Offsets_;
+      std::vector<int> Sizes_;
+      int Size_ = 0;
+
+      Matrix Information_;
+      Matrix Covariance_;
+
+      int AnchorInterval_;
+      int Steps_ = 0;
+      bool IsValid_ = false;
+  };
+}
+
+#endif // INCREMENTALCOVARIANCE_H
@@ -0,0 +1,81 @@
+/***************************************************************************
+ * libRSF - A Robust Sensor Fusion Library
+ *
+ * Copyright (C) 2018 Chair of Automation Technology / TU Chemnitz
+ * For more information see https://www.tu-chemnitz.de/etit/proaut/libRSF
+ *
+ * libRSF is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libRSF is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with libRSF.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Tim Pfeifer (tim.pfeifer@etit.tu-chemnitz.de)
+ ***************************************************************************/
+
+/**
+ * @file KeyframePolicy.h
+ * @author Tim Pfeifer
+ * @date 14.10.2026
+ * @brief Decides whether a new epoch gets its own state or is folded into the last keyframe.
+ * @copyright GNU Public License.
+ *
+ */
+
+#ifndef KEYFRAMEPOLICY_H
+#define KEYFRAMEPOLICY_H
+
+#include "FactorGraphConfig.h"
+#include "VectorTypes.h"
+
+namespace libRSF
+{
+  /** \brief Keyframe selection to bound the growth of the graph.
+   *
+   * A new keyframe is created if the platform moved or turned enough since the last one,
+   * if the measurements of the epoch carry enough new information, or if too much time passed.
+   * Otherwise the caller folds the measurements into relative factors between keyframes,
+   * so stationary or slow segments do not add states.
+   */
+  class KeyframePolicy
+  {
+    public:
+      explicit KeyframePolicy(const FactorGraphConfig::KeyframeConfig &Config);
+      ~KeyframePolicy() = default;
+
+      /** set the first keyframe */
+      void reset(double Time);
+
+      /** decision for an epoch at Time, the motion is relative to the last keyframe */
+      [[nodiscard]] bool isKeyframe(double Time, double Translation, double Rotation, double InformationGain = 0.0) const;
+
+      /** the epoch at Time becomes the last keyframe */
+      void accept(double Time);
+
+      /** combination of both, returns true if a keyframe was created */
+      bool update(double Time, double Translation, double Rotation, double InformationGain = 0.0);
+
+      [[nodiscard]] double getKeyframeTime() const;
+      [[nodiscard]] int countKeyframes() const;
+      [[nodiscard]] int countSkipped() const;
+
+      /** expected gain of a measurement with Information w.r.t. a state with Covariance: 0.5 * log det(I + Covariance * Information) */
+      static double ExpectedInformationGain(const Matrix &Covariance, const Matrix &Information);
+
+    private:
+      FactorGraphConfig::KeyframeConfig Config_;
+
+      double KeyframeTime_ = 0.0;
+      int Keyframes_ = 0;
+      int Skipped_ = 0;
+  };
+}
+
+#endif // KEYFRAMEPOLICY_H
@@ -0,0 +1,98 @@
+/***************************************************************************
+ * libRSF - A Robust Sensor Fusion Library
+ *
+ * Copyright (C) 2018 Chair of Automation Technology / TU Chemnitz
+ * For more information see https://www.tu-chemnitz.de/etit/proaut/libRSF
+ *
+ * libRSF is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libRSF is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with libRSF.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Tim Pfeifer (tim.pfeifer@etit.tu-chemnitz.de)
+ ***************************************************************************/
+
+/**
+ * @file LandmarkManager.h
+ * @author Tim Pfeifer
+ * @date 14.10.2026
+ * @brief Lifecycle of landmark states in long running SLAM graphs.
+ * @copyright GNU Public License.
+ *
+ */
+
+#ifndef LANDMARKMANAGER_H
+#define LANDMARKMANAGER_H
+
+#include "FactorGraph.h"
+#include "FactorGraphConfig.h"
+
+#include <map>
+#include <vector>
+
+namespace libRSF
+{
+  /** \brief Bounds the number of landmarks in a sliding window graph.
+   *
+   * Landmarks are static, so they are created once at timestamp zero and would either leave the
+   * window directly or never. Every observed landmark is exempt from the window of the graph and its
+   * observation count and last observation time are tracked here instead. update() marginalizes all
+   * landmarks that have not been seen for MaxAge seconds and the longest unseen ones beyond
+   * MaxActive, together in one marginalization. Their information is kept as a marginal prior on the
+   * connected poses. A landmark that is observed again after its reduction starts as a new state.
+   */
+  class LandmarkManager
+  {
+    public:
+      /** zero disables the corresponding limit */
+      LandmarkManager(FactorGraph &Graph, double MaxAge, int MaxActive = 0, bool Marginalize = true);
+
+      /** limits from the solution config */
+      LandmarkManager(FactorGraph &Graph, const FactorGraphConfig &Config);
+      ~LandmarkManager() = default;
+
+      void setMaxAge(double MaxAge);
+      void setMaxActive(int MaxActive);
+      void setInflation(double Inflation);
+
+      /** register an observation of a landmark state at Time */
+      void observe(const StateKey &Landmark, double Time);
+
+      /** call once per step after solving, returns the number of reduced landmarks */
+      int update(double CurrentTime);
+
+      [[nodiscard]] bool isActive(const StateKey &Landmark) const;
+      [[nodiscard]] int countActive() const;
+      [[nodiscard]] int countObservations(const StateKey &Landmark) const;
+      bool getLastSeen(const StateKey &Landmark, double &Time) const;
+
+    private:
+      struct LandmarkTrack
+      {
+        int Observations = 0;
+        double LastSeen = 0.0;
+      };
+
+      /** outdated landmarks first, then the oldest ones that exceed the limit */
+      [[nodiscard]] std::vector<StateKey> selectReduction_(double CurrentTime) const;
+
+      FactorGraph &Graph_;
+
+      double MaxAge_;
+      int MaxActive_;
+      bool Marginalize_;
+      double Inflation_ = 1.0;
+
+      std::map<StateKey, LandmarkTrack> Landmarks_;
+  };
+}
+
+#endif // LANDMARKMANAGER_H
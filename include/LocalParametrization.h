@@ -40,85 +40,88 @@
 
 namespace libRSF
 {
-  /** from ceres examples */
-  class AngleLocalParameterization
+  /** angle in [-pi, pi), the Jacobian of the plus operation is one */
+  class AngleLocalParameterization : public ceres::LocalParameterization
   {
     public:
+      AngleLocalParameterization() = default;
+      ~AngleLocalParameterization() override = default;
 
-      template <typename T>
-      bool operator()(const T* Angle, const T* DeltaAngle, T* AnglePlusDelta) const
-      {
-        *AnglePlusDelta = NormalizeAngle(*Angle + *DeltaAngle);
-        return true;
-      }
+      bool Plus(const double* Angle, const double* DeltaAngle, double* AnglePlusDelta) const override;
+      bool ComputeJacobian(const double* Angle, double* Jacobian) const override;
+      [[nodiscard]] int GlobalSize() const override { return 1; }
+      [[nodiscard]] int LocalSize() const override { return 1; }
 
       static ceres::LocalParameterization* Create()
       {
-        return (new ceres::AutoDiffLocalParameterization<AngleLocalParameterization, 1, 1>);
+        return (new AngleLocalParameterization);
       }
   };
 
   /** unit circle to represent angular value */
-  class UnitCircleLocalParameterization
+  class UnitCircleLocalParameterization : public ceres::LocalParameterization
   {
     public:
+      UnitCircleLocalParameterization() = default;
+      ~UnitCircleLocalParameterization() override = default;
 
-      template <typename T>
-      bool operator()(const T* Circle, const T* DeltaCircle, T* CirclePlusDelta) const
-      {
-        /** real part --> cos() */
-        CirclePlusDelta[0] = Circle[0] * cos(DeltaCircle[0]) - Circle[1] * sin(DeltaCircle[0]);
-
-        /** complex part --> sin() */
-        CirclePlusDelta[1] = Circle[1] * cos(DeltaCircle[0]) + Circle[0] * sin(DeltaCircle[0]);
-
-        return true;
-      }
+      bool Plus(const double* Circle, const double* DeltaCircle, double* CirclePlusDelta) const override;
+      bool ComputeJacobian(const double* Circle, double* Jacobian) const override;
+      [[nodiscard]] int GlobalSize() const override { return 2; }
+      [[nodiscard]] int LocalSize() const override { return 1; }
 
       static ceres::LocalParameterization* Create()
       {
-        return (new ceres::AutoDiffLocalParameterization<UnitCircleLocalParameterization, 2, 1>);
+        return (new UnitCircleLocalParameterization);
       }
   };
 
-  /** modified autodiff version of original ceres one */
-  class QuaternionLocalParameterization
+  /** quaternion [x,y,z,w] with a rotation vector as left-multiplied increment, modified version of the original ceres one */
+  class QuaternionLocalParameterization : public ceres::LocalParameterization
   {
     public:
+      QuaternionLocalParameterization() = default;
+      ~QuaternionLocalParameterization() override = default;
 
-      template <typename T>
-      bool operator()(const T* Quaternion, const T* Delta, T* QuaternionPlusDelta) const
-      {
-        QuaternionRefConst<T> Q(Quaternion);
-        VectorRefConst<T, 3> DeltaVec(Delta);
-        QuaternionRef<T> QPlusDelta(QuaternionPlusDelta);
-
-        const T Norm = DeltaVec.norm();
-        if (Norm > T(1e-20))
-        {
-          /** using axis-angle definition */
-          QPlusDelta = AngleAxisT<T> (Norm, DeltaVec / Norm) * Q;
-        }
-        else
-        {
-          /** use linear approximation for small angles (for stable derivative) */
-          QuaternionT<T> QuatDelta;
-          QuatDelta.x() = 0.5 * DeltaVec(0);
-          QuatDelta.y() = 0.5 * DeltaVec(1);
-          QuatDelta.z() = 0.5 * DeltaVec(2);
-          QuatDelta.w() = T(1.0);
-
-          QPlusDelta = QuatDelta * Q;
-        }
-
-        return true;
-      }
+      bool Plus(const double* Quaternion, const double* Delta, double* QuaternionPlusDelta) const override;
+      bool ComputeJacobian(const double* Quaternion, double* Jacobian) const override;
+      [[nodiscard]] int GlobalSize() const override { return 4; }
+      [[nodiscard]] int LocalSize() const override { return 3; }
 
       static ceres::LocalParameterization* Create()
       {
-        return (new ceres::AutoDiffLocalParameterization<QuaternionLocalParameterization, 4, 3>);
+        return (new QuaternionLocalParameterization);
       }
   };
+
+  /** 2D pose [x,y,yaw] as product of a vector space and an angle */
+  class Pose2LocalParameterization : public ceres::LocalParameterization
+  {
+    public:
+      Pose2LocalParameterization() = default;
+      ~Pose2LocalParameterization() override = default;
+
+      bool Plus(const double* Pose, const double* Delta, double* PosePlusDelta) const override;
+      bool ComputeJacobian(const double* Pose, double* Jacobian) const override;
+      [[nodiscard]] int GlobalSize() const override { return 3; }
+      [[nodiscard]] int LocalSize() const override { return 3; }
+  };
+
+  /** 3D pose [x,y,z,qx,qy,qz,qw] as product of a vector space and a quaternion */
+  class Pose3LocalParameterization : public ceres::LocalParameterization
+  {
+    public:
+      Pose3LocalParameterization() = default;
+      ~Pose3LocalParameterization() override = default;
+
+      bool Plus(const double* Pose, const double* Delta, double* PosePlusDelta) const override;
+      bool ComputeJacobian(const double* Pose, double* Jacobian) const override;
+      [[nodiscard]] int GlobalSize() const override { return 7; }
+      [[nodiscard]] int LocalSize() const override { return 6; }
+
+    private:
+      QuaternionLocalParameterization Rotation_;
+  };
 }
 
 #endif  // LOCAL_PARAMETERIZATION_H_
@@ -0,0 +1,94 @@
+/***************************************************************************
+ * libRSF - A Robust Sensor Fusion Library
+ *
+ * Copyright (C) 2018 Chair of Automation Technology / TU Chemnitz
+ * For more information see https://www.tu-chemnitz.de/etit/proaut/libRSF
+ *
+ * libRSF is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libRSF is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with libRSF.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Tim Pfeifer (tim.pfeifer@etit.tu-chemnitz.de)
+ ***************************************************************************/
+
+/**
+ * @file MarginalCovariance.h
+ * @author Tim Pfeifer
+ * @date 14.10.2026
+ * @brief Marginal covariances of single states from a cached sparse factorization.
+ * @copyright GNU Public License.
+ *
+ */
+
+#ifndef MARGINALCOVARIANCE_H
+#define MARGINALCOVARIANCE_H
+
+#include "VectorMath.h"
+#include "Messages.h"
+#include "ThreadPool.h"
+
+#include <Eigen/SparseCholesky>
+#include <ceres/ceres.h>
+
+#include <algorithm>
+#include <map>
+#include <vector>
+
+namespace libRSF
+{
+  /** @brief Factorizes the information matrix J^T*J once and recovers only
+   * the requested diagonal blocks of its inverse with the Takahashi recursion.
+   * States that are requested at factorization time are eliminated last,
+   * so the recursion stays as short as possible.
+   */
+  class MarginalCovariance
+  {
+    public:
+      MarginalCovariance() = default;
+      ~MarginalCovariance() = default;
+
+      /** factorize the linearized problem, the given states are ordered last */
+      bool compute(ceres::Problem &Graph, const std::vector<const double*> &LastStates);
+
+      /** covariance (global parametrization, row-major) of one state */
+      bool getCovarianceBlock(const ceres::Problem &Graph, const double* State, double* Covariance);
+
+      /** joint covariance of states that were ordered last, in the local parametrization */
+      bool getJointCovariance(const std::vector<const double*> &States, Matrix &Covariance);
+
+      [[nodiscard]] bool isValid() const;
+      [[nodiscard]] bool hasState(const double* State) const;
+      void reset();
+
+    private:
+      /** compute the inverse down to this (permuted) index */
+      void recursion_(int IndexMin);
+
+      [[nodiscard]] double getSigma_(int Row, int Col) const;
+
+      /** first index (before permutation) and local size of each state */
+      std::map<const double*, std::pair<int, int>> Blocks_;
+      Eigen::PermutationMatrix<Dynamic, Dynamic, int> Permutation_;
+
+      /** H = L * D * L^T */
+      SparseMatrix L_;
+      Vector DInv_;
+
+      /** elements of the inverse with the sparsity pattern of L */
+      SparseMatrix Sigma_;
+      int SigmaIndex_ = 0;
+
+      bool IsValid_ = false;
+  };
+}
+
+#endif // MARGINALCOVARIANCE_H
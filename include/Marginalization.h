@@ -32,15 +32,43 @@
 #ifndef MARGINALIZATION_H
 #define MARGINALIZATION_H
 
+#include "DenseGPU.h"
 #include "VectorMath.h"
 #include "Messages.h"
 
+#include <Eigen/SparseCholesky>
+
+#include <numeric>
+#include <vector>
+
 namespace libRSF
 {
   void Marginalize(const Vector &Residual, const Matrix &Jacobian,
                    Vector &ResidualMarg, Matrix &JacobianMarg,
                    int MarginalSize, double HessianInflation = 1.0);
 
+  /** sparse version, the returned jacobian has only as many rows as the rank of the marginal */
+  void Marginalize(const Vector &Residual, const SparseMatrix &Jacobian,
+                   Vector &ResidualMarg, Matrix &JacobianMarg,
+                   int MarginalSize, double HessianInflation = 1.0);
+
+  /** normal equations H = J^T * J and b = -J^T * r, accumulated block-wise per residual block and in parallel */
+  void ComputeNormalEquations(const ceres::CRSMatrix &Jacobian, const std::vector<double> &Residual,
+                              SparseMatrix &Hessian, Vector &B);
+
+  /** sparse version that starts from the normal equations,
+   *  eigen directions below MinEigenRatio times the largest eigen value of their component are dropped to compress the prior */
+  void MarginalizeHessian(const SparseMatrix &Hessian, const Vector &B,
+                          Vector &ResidualMarg, Matrix &JacobianMarg,
+                          int MarginalSize, double HessianInflation = 1.0,
+                          double MinEigenRatio = 0.0);
+
+  /** indices of independent sub-systems of a symmetric matrix */
+  std::vector<std::vector<Index>> FindIndependentComponents(const Matrix &Hessian);
+
+  /** groups of state blocks that are connected by a row of the marginal jacobian */
+  std::vector<std::vector<int>> SplitMarginal(const Matrix &Jacobian, const std::vector<int> &BlockSize);
+
 }
 
 #endif // MARGINALIZATION_H
@@ -35,46 +35,83 @@
 #include "Types.h"
 #include "VectorMath.h"
 
+#include <atomic>
 #include <string>
+#include <sstream>
 #include <iostream>
 
+/** messages above this level are removed at compile time: 0 = off, 1 = error, 2 = warning, 3 = logging */
+#ifndef LIBRSF_LOG_LEVEL
+  #define LIBRSF_LOG_LEVEL 3
+#endif
+
 #define FILENAME (__builtin_strrchr(__FILE__, '/') ? __builtin_strrchr(__FILE__, '/') + 1 : __FILE__)
-#define PRINT_ERROR(...) libRSF::PrintError(FILENAME, __FUNCTION__, __LINE__, __VA_ARGS__)
-#define PRINT_WARNING(...) libRSF::PrintWarning(FILENAME, __FUNCTION__, __LINE__, __VA_ARGS__)
-#define PRINT_LOGGING(...) libRSF::PrintLogging(FILENAME, __FUNCTION__, __LINE__, __VA_ARGS__)
+
+/** the arguments are only evaluated and formatted if the level is enabled */
+#define LIBRSF_LOG_(Level, Function, ...) \
+  do \
+  { \
+    if (libRSF::IsLogLevelEnabled(Level)) \
+    { \
+      Function(FILENAME, __FUNCTION__, __LINE__, __VA_ARGS__); \
+    } \
+  } while (false)
+
+#define PRINT_ERROR(...) LIBRSF_LOG_(libRSF::LogLevel::Error, libRSF::PrintError, __VA_ARGS__)
+#define PRINT_WARNING(...) LIBRSF_LOG_(libRSF::LogLevel::Warning, libRSF::PrintWarning, __VA_ARGS__)
+#define PRINT_LOGGING(...) LIBRSF_LOG_(libRSF::LogLevel::Logging, libRSF::PrintLogging, __VA_ARGS__)
 
 namespace libRSF
 {
-  /** recursive variadic function to print multiple strings */
-  template<typename T>
-  void Print(const T Arg)
+  enum class LogLevel {Off, Error, Warning, Logging};
+
+  /** runtime threshold, can only lower the compile-time one */
+  inline std::atomic<int> LogThreshold {static_cast<int>(LogLevel::Logging)};
+
+  inline void SetLogLevel(const LogLevel Level)
   {
-    std::cout << Arg;
+    LogThreshold.store(static_cast<int>(Level), std::memory_order_relaxed);
   }
 
-  void PrintVariadic();
+  inline bool IsLogLevelEnabled(const LogLevel Level)
+  {
+    return static_cast<int>(Level) <= LIBRSF_LOG_LEVEL
+           && static_cast<int>(Level) <= LogThreshold.load(std::memory_order_relaxed);
+  }
+
+  /** write the lines from a background thread, so the caller does not wait for the console */
+  void SetLogAsync(bool Enable);
+
+  /** block until all queued lines are written */
+  void FlushLog();
 
-  template<typename T, typename... MoreStrings>
-  void PrintVariadic(const T Begin, const MoreStrings... Rest)
+  /** write one complete line to the sink */
+  void WriteLogLine(std::string &&Line);
+
+  /** format all parts into one line, so concurrent messages are not interleaved */
+  template<typename... MoreStrings>
+  void PrintVariadic(const MoreStrings&... Messages)
   {
-      Print(Begin);
-      PrintVariadic(Rest...);
+    std::ostringstream Stream;
+    Stream.copyfmt(std::cout);
+    (Stream << ... << Messages);
+    WriteLogLine(Stream.str());
   }
 
   template<typename... MoreStrings>
-  void PrintError (const std::string &File,const  std::string &Function, const int Line, const MoreStrings... Messages)
+  void PrintError (const char* File, const char* Function, const int Line, const MoreStrings&... Messages)
   {
     PrintVariadic("Error in ", File, " | Line ", Line, " | ", Function, "(): ", Messages...);
   }
 
   template<typename... MoreStrings>
-  void PrintWarning (const std::string &File, const std::string &Function, const int Line, const MoreStrings... Messages)
+  void PrintWarning (const char* File, const char* Function, const int Line, const MoreStrings&... Messages)
   {
     PrintVariadic("Warning in ", File, " | Line ", Line, " | ", Function, "(): ", Messages...);
   }
 
   template<typename... MoreStrings>
-  void PrintLogging (const std::string &File, const std::string &Function, const int Line, const MoreStrings... Messages)
+  void PrintLogging (const char* File, const char* Function, const int Line, const MoreStrings&... Messages)
   {
     PrintVariadic("Logging in ", File, " | Line ", Line, " | ", Function, "(): ", Messages...);
   }
@@ -0,0 +1,211 @@
+/***************************************************************************
+ * libRSF - A Robust Sensor Fusion Library
+ *
+ * Copyright (C) 2018 Chair of Automation Technology / TU Chemnitz
+ * For more information see https://www.tu-chemnitz.de/etit/proaut/libRSF
+ *
+ * libRSF is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libRSF is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with libRSF.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Tim Pfeifer (tim.pfeifer@etit.tu-chemnitz.de)
+ ***************************************************************************/
+
+/**
+ * @file Metrics.h
+ * @author Tim Pfeifer
+ * @date 14.10.2026
+ * @brief Lock-free latency histograms and counters for the monitoring of online estimators.
+ * @copyright GNU Public License.
+ *
+ */
+
+#ifndef METRICS_H
+#define METRICS_H
+
+#include "Data.h"
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace libRSF
+{
+  /** @brief HDR histogram of durations with 16 sub-buckets per power of two.
+   * Values are stored in nanoseconds, the relative error is below 6.25% from 16ns to about 1100s.
+   * record() only increments atomics, so any number of threads can record without locks.
+   */
+  class LatencyHistogram
+  {
+    public:
+      LatencyHistogram() = default;
+      ~LatencyHistogram() = default;
+
+      LatencyHistogram(const LatencyHistogram &) = delete;
+      LatencyHistogram &operator=(const LatencyHistogram &) = delete;
+
+      void record(double Seconds);
+
+      [[nodiscard]] uint64_t getCount() const;
+      [[nodiscard]] double getSum() const;
+
+      /** upper bound of the bucket that contains the given quantile, zero if nothing was recorded */
+      [[nodiscard]] double getQuantile(double Quantile) const;
+
+      /** number of values that are surely below or equal to the bound in seconds */
+      [[nodiscard]] uint64_t countBelow(double Seconds) const;
+
+    private:
+      static constexpr int SubBucketBits_ = 4;
+      static constexpr uint64_t SubBuckets_ = 1u << SubBucketBits_;
+      static constexpr int MaxExponent_ = 40;
+      static constexpr size_t BucketNumber_ = SubBuckets_ + (MaxExponent_ - SubBucketBits_ + 1) * SubBuckets_;
+
+      [[nodiscard]] static size_t getIndex_(uint64_t Nanoseconds);
+      [[nodiscard]] static uint64_t getUpperBound_(size_t Index);
+
+      std::array<std::atomic<uint64_t>, BucketNumber_> Buckets_{};
+      std::atomic<uint64_t> SumNanoseconds_{0};
+  };
+
+  class MetricsCounter
+  {
+    public:
+      void add(uint64_t Increment = 1)
+      {
+        Value_.fetch_add(Increment, std::memory_order_relaxed);
+      }
+
+      [[nodiscard]] uint64_t get() const
+      {
+        return Value_.load(std::memory_order_relaxed);
+      }
+
+    private:
+      std::atomic<uint64_t> Value_{0};
+  };
+
+  class MetricsGauge
+  {
+    public:
+      void set(double Value)
+      {
+        Value_.store(Value, std::memory_order_relaxed);
+      }
+
+      [[nodiscard]] double get() const
+      {
+        return Value_.load(std::memory_order_relaxed);
+      }
+
+    private:
+      std::atomic<double> Value_{0.0};
+  };
+
+  /** @brief Named metrics in the Prometheus text exposition format.
+   * Registration locks, so it should happen during the setup; metrics are never removed,
+   * the returned references stay valid for the lifetime of the registry.
+   */
+  class MetricsRegistry
+  {
+    public:
+      MetricsRegistry() = default;
+      ~MetricsRegistry() = default;
+
+      MetricsRegistry(const MetricsRegistry &) = delete;
+      MetricsRegistry &operator=(const MetricsRegistry &) = delete;
+
+      /** an existing metric with the same name is returned, so several graphs can share one */
+      LatencyHistogram &getHistogram(const std::string &Name, const std::string &Help);
+      MetricsCounter &getCounter(const std::string &Name, const std::string &Help);
+      MetricsGauge &getGauge(const std::string &Name, const std::string &Help);
+
+      /** the current values of all metrics, histogram buckets span 10us to 100s */
+      [[nodiscard]] std::string getExposition() const;
+
+      /** for the textfile collector of the node exporter, the file is replaced atomically */
+      bool writeToFile(const std::string &Filename) const;
+
+    private:
+      template <typename MetricType>
+      struct Entry
+      {
+        std::string Help;
+        std::unique_ptr<MetricType> Metric;
+      };
+
+      mutable std::mutex Mutex_;
+      std::map<std::string, Entry<LatencyHistogram>> Histograms_;
+      std::map<std::string, Entry<MetricsCounter>> Counters_;
+      std::map<std::string, Entry<MetricsGauge>> Gauges_;
+  };
+
+  /** process-wide registry that is served by MetricsServer */
+  MetricsRegistry &GetMetricsRegistry();
+
+  /** minimal HTTP endpoint that answers GET /metrics from a background thread */
+  class MetricsServer
+  {
+    public:
+      explicit MetricsServer(MetricsRegistry &Registry = GetMetricsRegistry());
+      ~MetricsServer();
+
+      MetricsServer(const MetricsServer &) = delete;
+      MetricsServer &operator=(const MetricsServer &) = delete;
+
+      /** listens on all interfaces, false if the port is not available */
+      bool start(int Port);
+      void stop();
+
+      [[nodiscard]] bool isRunning() const;
+
+    private:
+      void serve_();
+      void answer_(int Connection) const;
+
+      MetricsRegistry &Registry_;
+      int Socket_ = -1;
+      std::atomic<bool> Running_{false};
+      std::thread Thread_;
+  };
+
+  /** @brief Standard metrics of one estimator.
+   * The graph records the solver, marginalization and covariance; the application records whole epochs.
+   */
+  struct GraphMetrics
+  {
+    explicit GraphMetrics(MetricsRegistry &Registry = GetMetricsRegistry());
+
+    /** adaptive error model and total duration of one epoch from its IterationSummary */
+    void recordEpoch(const Data &Summary);
+
+    LatencyHistogram &Solver;
+    LatencyHistogram &Marginalization;
+    LatencyHistogram &Covariance;
+    LatencyHistogram &Adaptive;
+    LatencyHistogram &Epoch;
+
+    MetricsCounter &Solves;
+    MetricsCounter &Iterations;
+    MetricsCounter &DeadlineMisses;
+
+    MetricsGauge &States;
+    MetricsGauge &Factors;
+  };
+}
+
+#endif // METRICS_H
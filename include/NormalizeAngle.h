@@ -35,33 +35,54 @@
 #include "VectorMath.h"
 #include "Messages.h"
 #include <cmath>
+#include <type_traits>
 
 namespace libRSF
 {
-  /** normalizes an Value between [-Limit Limit] */
+  /** value of a double or of a (nested) ceres::Jet without derivatives */
+  inline double ScalarPart(const double Value)
+  {
+    return Value;
+  }
+
+  template <typename T, int N>
+  double ScalarPart(const ceres::Jet<T, N> &Value)
+  {
+    return ScalarPart(Value.a);
+  }
+
+  /** normalizes an Value between [-Limit Limit] without branches, the subtracted multiple of 2*Limit is constant for jets */
   template <typename T>
   T NormalizeCustom(const T &Value, const double Limit)
   {
-    T ValueWrapped = Value;
-    while (ValueWrapped > Limit)
-    {
-      ValueWrapped -= 2*Limit;
-    }
-    while (ValueWrapped < -Limit)
-    {
-      ValueWrapped += 2*Limit;
-    }
+    const double Period = 2.0 * Limit;
+    return Value - Period * std::round(ScalarPart(Value) / Period);
+  }
 
-    return ValueWrapped;
+  /** the same for many values at once, Eigen vectorizes the rounding */
+  template <typename Derived>
+  void NormalizeCustomArray(Eigen::ArrayBase<Derived> &Values, const double Limit)
+  {
+    const double Period = 2.0 * Limit;
+    Values -= Period * (Values * (1.0 / Period)).round();
   }
 
   template <typename T, int Dim>
   VectorT<T, Dim> NormalizeCustomVector(const VectorT<T, Dim> &Vector, const double Limit)
   {
     VectorT<T, Dim> VectorNormalized;
-    for (int n = 0; n < Dim; n++)
+    if constexpr (std::is_same_v<T, double>)
+    {
+      VectorNormalized = Vector;
+      auto Values = VectorNormalized.array();
+      NormalizeCustomArray(Values, Limit);
+    }
+    else
     {
-      VectorNormalized(n) = NormalizeCustom(Vector(n), Limit);
+      for (int n = 0; n < Dim; n++)
+      {
+        VectorNormalized(n) = NormalizeCustom(Vector(n), Limit);
+      }
     }
     return VectorNormalized;
   }
@@ -79,6 +100,12 @@ namespace libRSF
     return NormalizeCustomVector(Angle, M_PI);
   }
 
+  template <typename Derived>
+  void NormalizeAngleArray(Eigen::ArrayBase<Derived> &Angles)
+  {
+    NormalizeCustomArray(Angles, M_PI);
+  }
+
   /** normalize turn rate  */
   template <typename T>
   T NormalizeAngleVelocity(const T &AngleVel, const double dt)
@@ -0,0 +1,194 @@
+/***************************************************************************
+ * libRSF - A Robust Sensor Fusion Library
+ *
+ * Copyright (C) 2018 Chair of Automation Technology / TU Chemnitz
+ * For more information see https://www.tu-chemnitz.de/etit/proaut/libRSF
+ *
+ * libRSF is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libRSF is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with libRSF.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Tim Pfeifer (tim.pfeifer@etit.tu-chemnitz.de)
+ ***************************************************************************/
+
+/**
+ * @file ParameterSlab.h
+ * @author Tim Pfeifer
+ * @date 14.10.2026
+ * @brief Contiguous storage with fixed-size slots for the parameter blocks of states.
+ * @copyright GNU Public License.
+ *
+ */
+
+#ifndef PARAMETERSLAB_H
+#define PARAMETERSLAB_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <vector>
+
+namespace libRSF
+{
+  /** \brief Slots of one size in large chunks, one slab exists per data type.
+   *
+   * New slots are handed out in order, so states that are created one after another are neighbours in memory.
+   * Released slots are reused first, which makes a sliding window recycle its memory in O(1).
+   * Chunks are never moved or freed while the slab exists, so the address of a slot is stable.
+   */
+  class ParameterSlab
+  {
+    public:
+      explicit ParameterSlab(const size_t SlotSize, const size_t ChunkSlots = 256)
+        : SlotSize_(std::max<size_t>(SlotSize, 1)), ChunkSlots_(std::max<size_t>(ChunkSlots, 1))
+      {}
+      ~ParameterSlab() = default;
+
+      ParameterSlab(const ParameterSlab &) = delete;
+      ParameterSlab &operator=(const ParameterSlab &) = delete;
+
+      /** the content of a new slot is undefined */
+      double * allocate()
+      {
+        const std::lock_guard<std::mutex> Lock(Mutex_);
+        UsedSlots_++;
+
+        if (Free_ != nullptr)
+        {
+          double * Slot = Free_;
+          std::memcpy(&Free_, Slot, sizeof(Free_));
+          return Slot;
+        }
+
+        if (Chunks_.empty() || NextSlot_ == ChunkSlots_)
+        {
+          Chunks_.emplace_back(new double[SlotSize_ * ChunkSlots_]);
+          NextSlot_ = 0;
+        }
+        return Chunks_.back().get() + SlotSize_ * NextSlot_++;
+      }
+
+      /** the released slot stores the link to the next free one */
+      void release(double * const Slot)
+      {
+        const std::lock_guard<std::mutex> Lock(Mutex_);
+        std::memcpy(Slot, &Free_, sizeof(Free_));
+        Free_ = Slot;
+        UsedSlots_--;
+      }
+
+      /** number of doubles per slot */
+      [[nodiscard]] size_t getSlotSize() const
+      {
+        return SlotSize_;
+      }
+
+      [[nodiscard]] size_t countUsedSlots() const
+      {
+        const std::lock_guard<std::mutex> Lock(Mutex_);
+        return UsedSlots_;
+      }
+
+      [[nodiscard]] size_t countChunks() const
+      {
+        const std::lock_guard<std::mutex> Lock(Mutex_);
+        return Chunks_.size();
+      }
+
+    private:
+      const size_t SlotSize_;
+      const size_t ChunkSlots_;
+
+      /** objects are created and destroyed on several threads, e.g. by segmented solutions */
+      mutable std::mutex Mutex_;
+      std::vector<std::unique_ptr<double[]>> Chunks_;
+      size_t NextSlot_ = 0;
+      double * Free_ = nullptr;
+      size_t UsedSlots_ = 0;
+  };
+
+  /** \brief Allocator that places buffers of exactly one slot in a slab and everything else on the heap.
+   *
+   * Without a slab it is a plain heap allocator. A copy of a container starts on the heap again and an assignment keeps
+   * the storage of the target, so only moving transfers a slot to another container.
+   * The allocator shares the ownership of the slab, so buffers can be released after the config that created it.
+   */
+  template <typename T>
+  class SlabAllocator
+  {
+    public:
+      using value_type = T;
+      using propagate_on_container_copy_assignment = std::false_type;
+      using propagate_on_container_move_assignment = std::true_type;
+      using propagate_on_container_swap = std::true_type;
+
+      SlabAllocator() noexcept = default;
+      explicit SlabAllocator(std::shared_ptr<ParameterSlab> Slab) noexcept : Slab_(std::move(Slab)) {}
+
+      template <typename U>
+      SlabAllocator(const SlabAllocator<U> &Other) noexcept : Slab_(Other.getSlab()) {}
+
+      T * allocate(const size_t Number)
+      {
+        if (isSlot_(Number))
+        {
+          return reinterpret_cast<T *>(Slab_->allocate());
+        }
+        return std::allocator<T>().allocate(Number);
+      }
+
+      void deallocate(T * const Pointer, const size_t Number)
+      {
+        if (isSlot_(Number))
+        {
+          Slab_->release(reinterpret_cast<double *>(Pointer));
+          return;
+        }
+        std::allocator<T>().deallocate(Pointer, Number);
+      }
+
+      [[nodiscard]] SlabAllocator select_on_container_copy_construction() const
+      {
+        return SlabAllocator();
+      }
+
+      [[nodiscard]] const std::shared_ptr<ParameterSlab> &getSlab() const
+      {
+        return Slab_;
+      }
+
+      template <typename U>
+      bool operator==(const SlabAllocator<U> &Other) const
+      {
+        return Slab_ == Other.getSlab();
+      }
+
+      template <typename U>
+      bool operator!=(const SlabAllocator<U> &Other) const
+      {
+        return !(*this == Other);
+      }
+
+    private:
+      [[nodiscard]] bool isSlot_(const size_t Number) const
+      {
+        return std::is_same_v<T, double> && Slab_ != nullptr && Number == Slab_->getSlotSize();
+      }
+
+      std::shared_ptr<ParameterSlab> Slab_;
+  };
+}
+
+#endif // PARAMETERSLAB_H
@@ -0,0 +1,252 @@
+/***************************************************************************
+ * libRSF - A Robust Sensor Fusion Library
+ *
+ * Copyright (C) 2018 Chair of Automation Technology / TU Chemnitz
+ * For more information see https://www.tu-chemnitz.de/etit/proaut/libRSF
+ *
+ * libRSF is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libRSF is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with libRSF.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Tim Pfeifer (tim.pfeifer@etit.tu-chemnitz.de)
+ ***************************************************************************/
+
+/**
+ * @file PointerMap.h
+ * @author Tim Pfeifer
+ * @date 14.10.2026
+ * @brief Flat hash map with pointer keys (open addressing, linear probing).
+ * @copyright GNU Public License.
+ *
+ */
+
+#ifndef POINTERMAP_H
+#define POINTERMAP_H
+
+#include <cstdint>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace libRSF
+{
+  /** \brief Map from raw pointers to values without per-element allocations.
+   *
+   * The elements are stored in one contiguous array; nullptr marks an empty slot and can not be used as key.
+   * Erasing uses backward shifting, so no tombstones are left behind.
+   */
+  template <typename KeyType, typename ValueType>
+  class PointerMap
+  {
+    static_assert(std::is_pointer_v<KeyType>, "PointerMap requires a pointer as key!");
+
+    public:
+      PointerMap() = default;
+      ~PointerMap() = default;
+
+      [[nodiscard]] size_t size() const
+      {
+        return Size_;
+      }
+
+      /** bytes of the slot table */
+      [[nodiscard]] size_t getMemorySize() const
+      {
+        return sizeof(*this) + Slots_.capacity() * sizeof(Slot);
+      }
+
+      [[nodiscard]] bool empty() const
+      {
+        return Size_ == 0;
+      }
+
+      [[nodiscard]] size_t count(const KeyType Key) const
+      {
+        return (findSlot_(Key) != NotFound_) ? 1 : 0;
+      }
+
+      /** insert a new element, an existing one is not overwritten */
+      bool emplace(const KeyType Key, const ValueType &Value)
+      {
+        if (Key == nullptr)
+        {
+          return false;
+        }
+
+        /** keep the load factor below 0.5 to get short probe sequences */
+        if (2 * (Size_ + 1) > Slots_.size())
+        {
+          rehash_(Slots_.empty() ? MinCapacity_ : 2 * Slots_.size());
+        }
+
+        size_t Index = home_(Key);
+        while (Slots_[Index].Key != nullptr)
+        {
+          if (Slots_[Index].Key == Key)
+          {
+            return false;
+          }
+          Index = (Index + 1) & Mask_;
+        }
+
+        Slots_[Index].Key = Key;
+        Slots_[Index].Value = Value;
+        Size_++;
+        return true;
+      }
+
+      [[nodiscard]] ValueType &at(const KeyType Key)
+      {
+        const size_t Index = findSlot_(Key);
+        if (Index == NotFound_)
+        {
+          throw std::out_of_range("PointerMap::at(): key not found");
+        }
+        return Slots_[Index].Value;
+      }
+
+      [[nodiscard]] const ValueType &at(const KeyType Key) const
+      {
+        const size_t Index = findSlot_(Key);
+        if (Index == NotFound_)
+        {
+          throw std::out_of_range("PointerMap::at(): key not found");
+        }
+        return Slots_[Index].Value;
+      }
+
+      size_t erase(const KeyType Key)
+      {
+        size_t Hole = findSlot_(Key);
+        if (Hole == NotFound_)
+        {
+          return 0;
+        }
+
+        /** shift following elements back, if the hole is between their home and their slot */
+        size_t Index = Hole;
+        while (true)
+        {
+          Index = (Index + 1) & Mask_;
+          if (Slots_[Index].Key == nullptr)
+          {
+            break;
+          }
+
+          const size_t Home = home_(Slots_[Index].Key);
+          if (((Index - Home) & Mask_) >= ((Index - Hole) & Mask_))
+          {
+            Slots_[Hole] = std::move(Slots_[Index]);
+            Hole = Index;
+          }
+        }
+
+        Slots_[Hole].Key = nullptr;
+        Slots_[Hole].Value = ValueType();
+        Size_--;
+        return 1;
+      }
+
+      /** call Function(Key, Value) for all elements, the map must not be modified meanwhile */
+      template <typename FunctionType>
+      void forEach(FunctionType Function) const
+      {
+        for (const Slot &Current : Slots_)
+        {
+          if (Current.Key != nullptr)
+          {
+            Function(Current.Key, Current.Value);
+          }
+        }
+      }
+
+      /** grow once, so that the given number of keys fits without rehashing */
+      void reserve(const size_t Number)
+      {
+        size_t Capacity = Slots_.empty() ? MinCapacity_ : Slots_.size();
+        while (2 * Number > Capacity)
+        {
+          Capacity *= 2;
+        }
+        if (Capacity > Slots_.size())
+        {
+          rehash_(Capacity);
+        }
+      }
+
+      void clear()
+      {
+        Slots_.clear();
+        Mask_ = 0;
+        Size_ = 0;
+      }
+
+    private:
+      struct Slot
+      {
+        KeyType Key = nullptr;
+        ValueType Value;
+      };
+
+      static constexpr size_t NotFound_ = static_cast<size_t>(-1);
+      static constexpr size_t MinCapacity_ = 16;
+
+      /** Fibonacci hashing, the lower bits of a pointer are zero due to alignment */
+      [[nodiscard]] size_t home_(const KeyType Key) const
+      {
+        const uint64_t Mixed = static_cast<uint64_t>(reinterpret_cast<uintptr_t>(Key)) * UINT64_C(11400714819323198485);
+        return static_cast<size_t>(Mixed >> 32) & Mask_;
+      }
+
+      [[nodiscard]] size_t findSlot_(const KeyType Key) const
+      {
+        if (Slots_.empty() || Key == nullptr)
+        {
+          return NotFound_;
+        }
+
+        size_t Index = home_(Key);
+        while (Slots_[Index].Key != nullptr)
+        {
+          if (Slots_[Index].Key == Key)
+          {
+            return Index;
+          }
+          Index = (Index + 1) & Mask_;
+        }
+        return NotFound_;
+      }
+
+      void rehash_(const size_t Capacity)
+      {
+        std::vector<Slot> OldSlots(Capacity);
+        OldSlots.swap(Slots_);
+        Mask_ = Capacity - 1;
+        Size_ = 0;
+
+        for (Slot &Old : OldSlots)
+        {
+          if (Old.Key != nullptr)
+          {
+            this->emplace(Old.Key, Old.Value);
+          }
+        }
+      }
+
+      std::vector<Slot> Slots_;
+      size_t Mask_ = 0;
+      size_t Size_ = 0;
+  };
+}
+
+#endif // POINTERMAP_H
@@ -0,0 +1,90 @@
+/***************************************************************************
+ * libRSF - A Robust Sensor Fusion Library
+ *
+ * Copyright (C) 2018 Chair of Automation Technology / TU Chemnitz
+ * For more information see https://www.tu-chemnitz.de/etit/proaut/libRSF
+ *
+ * libRSF is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libRSF is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with libRSF.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Tim Pfeifer (tim.pfeifer@etit.tu-chemnitz.de)
+ ***************************************************************************/
+
+/**
+ * @file PositionIndex.h
+ * @author Tim Pfeifer
+ * @date 14.10.2026
+ * @brief Incremental k-d tree over timestamped positions, e.g. to propose loop closures.
+ * @copyright GNU Public License.
+ *
+ */
+
+#ifndef POSITIONINDEX_H
+#define POSITIONINDEX_H
+
+#include "VectorTypes.h"
+
+#include <vector>
+
+namespace libRSF
+{
+  /** \brief k-d tree over the positions of a trajectory.
+   *
+   * Positions are inserted one by one as the trajectory grows. If an insertion makes the tree
+   * deeper than a multiple of log2(N), for example along a straight path, it is rebuilt balanced,
+   * so queries stay O(log N) on average. Queries ignore positions that are closer than an
+   * exclusion time to the query timestamp, as these are the direct predecessors.
+   */
+  class PositionIndex
+  {
+    public:
+      explicit PositionIndex(int Dim);
+      ~PositionIndex() = default;
+
+      void insert(const Vector &Position, double Timestamp);
+      void clear();
+
+      /** timestamps of all positions within the radius, unordered */
+      void queryRadius(const Vector &Position, double Radius, double Timestamp, double Exclusion, std::vector<double> &Timestamps) const;
+
+      /** timestamp of the closest position within the radius, false if there is none */
+      bool queryNearest(const Vector &Position, double Radius, double Timestamp, double Exclusion, double &Found) const;
+
+      [[nodiscard]] size_t size() const;
+      [[nodiscard]] int getDim() const;
+
+    private:
+      struct Node
+      {
+        int Left = -1;
+        int Right = -1;
+        int Axis = 0;
+      };
+
+      [[nodiscard]] VectorRefConst<double, Dynamic> getPoint_(int Index) const;
+      [[nodiscard]] double squaredDistance_(int Index, const Vector &Position) const;
+
+      void rebuild_();
+      int build_(std::vector<int> &Indices, int Begin, int End, int Depth);
+
+      int Dim_;
+      int Root_ = -1;
+
+      /** node n belongs to point n */
+      std::vector<double> Points_;
+      std::vector<double> Timestamps_;
+      std::vector<Node> Nodes_;
+  };
+}
+
+#endif // POSITIONINDEX_H
@@ -0,0 +1,123 @@
+/***************************************************************************
+ * libRSF - A Robust Sensor Fusion Library
+ *
+ * Copyright (C) 2018 Chair of Automation Technology / TU Chemnitz
+ * For more information see https://www.tu-chemnitz.de/etit/proaut/libRSF
+ *
+ * libRSF is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libRSF is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with libRSF.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Tim Pfeifer (tim.pfeifer@etit.tu-chemnitz.de)
+ ***************************************************************************/
+
+/**
+ * @file RealTime.h
+ * @author Tim Pfeifer
+ * @date 14.10.2026
+ * @brief Real-time execution profile with locked and prefaulted memory, pinned threads and fixed priorities.
+ * @copyright GNU Public License.
+ *
+ */
+
+#ifndef REALTIME_H
+#define REALTIME_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace libRSF
+{
+  /** threads that get their own core and priority */
+  enum class RealTimeThread {Solver, Ingestion};
+
+  struct RealTimeThreadConfig
+  {
+    /** core of the thread, negative keeps the inherited affinity */
+    int Core = -1;
+
+    /** SCHED_FIFO priority, zero keeps the default scheduler */
+    int Priority = 0;
+  };
+
+  struct RealTimeConfig
+  {
+    bool IsActive = false;
+
+    /** lock all current and future pages with mlockall() */
+    bool LockMemory = true;
+
+    /** heap that is touched once and kept by the allocator, so later allocations do not fault */
+    size_t PrefaultHeap = 0;
+
+    /** stack of the calling thread that is touched on entering the real-time mode */
+    size_t PrefaultStack = 512 * 1024;
+
+    /** advise transparent huge pages for the prefaulted heap and the factor pools */
+    bool HugePages = false;
+
+    /** epochs until the Window mode is expected to be free of page faults and new allocations */
+    int WarmUpEpochs = 10;
+
+    /** the synchronous loop or the solver thread of a pipeline */
+    RealTimeThreadConfig Solver;
+
+    /** threads that read or receive sensor data */
+    RealTimeThreadConfig Ingestion;
+  };
+
+  /** configure the process-wide profile, only possible before EnterRealTime() */
+  bool SetRealTimeConfig(const RealTimeConfig &Config);
+  [[nodiscard]] RealTimeConfig GetRealTimeConfig();
+  [[nodiscard]] bool IsRealTimeActive();
+
+  /** lock and prefault the memory of the process, does nothing if the profile is not active, later calls return the first result */
+  bool EnterRealTime();
+
+  /** pin the calling thread and set its priority according to its role, does nothing if the profile is not active */
+  bool ApplyRealTimeThread(RealTimeThread Role);
+
+  /** touch every page of the memory without changing it, optionally after advising huge pages */
+  void PrefaultMemory(void *Memory, size_t Bytes);
+
+  /** minor and major page faults of the calling thread */
+  [[nodiscard]] std::uint64_t GetPageFaultCount();
+
+  /** \brief Checks that epochs after a warm-up neither fault nor allocate more than during the warm-up.
+   *
+   * The sliding window has a constant size, so its memory is reused after the warm-up.
+   * Allocations are only counted with LIBRSF_ALLOCATION_TRACKING.
+   */
+  class SteadyStateMonitor
+  {
+    public:
+      explicit SteadyStateMonitor(int WarmUpEpochs);
+
+      void beginEpoch();
+
+      /** returns false if a steady-state epoch faulted or allocated, the first violation is printed */
+      bool endEpoch();
+
+      [[nodiscard]] int countViolations() const;
+
+    private:
+      int WarmUpEpochs_;
+      int Epochs_ = 0;
+      int Violations_ = 0;
+
+      std::uint64_t FaultsBegin_ = 0;
+      std::uint64_t AllocationsBegin_ = 0;
+      std::uint64_t MaxWarmUpAllocations_ = 0;
+  };
+}
+
+#endif // REALTIME_H
@@ -0,0 +1,65 @@
+/***************************************************************************
+ * libRSF - A Robust Sensor Fusion Library
+ *
+ * Copyright (C) 2018 Chair of Automation Technology / TU Chemnitz
+ * For more information see https://www.tu-chemnitz.de/etit/proaut/libRSF
+ *
+ * libRSF is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libRSF is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with libRSF.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Tim Pfeifer (tim.pfeifer@etit.tu-chemnitz.de)
+ ***************************************************************************/
+
+/**
+ * @file RecursiveFilter.h
+ * @author Tim Pfeifer
+ * @date 14.10.2026
+ * @brief Recursive filter on top of a factor graph that keeps only the current states.
+ * @copyright GNU Public License.
+ *
+ */
+
+#ifndef RECURSIVEFILTER_H
+#define RECURSIVEFILTER_H
+
+#include "FactorGraph.h"
+#include "FactorGraphConfig.h"
+
+namespace libRSF
+{
+  /** \brief Filter that turns the previous states into a marginal prior in information form before each step.
+   *
+   * The graph holds only the current states, the prior and the new factors, so each step has a constant cost.
+   * With max_num_iterations = 1 and the Gauss-Newton like solver options of the filter config,
+   * one step is an EKF update, more iterations give an iterated EKF.
+   */
+  class RecursiveFilter
+  {
+    public:
+      explicit RecursiveFilter(FactorGraph &Graph, bool EstimateCov = false);
+      RecursiveFilter(FactorGraph &Graph, const FactorGraphConfig &Config);
+      ~RecursiveFilter() = default;
+
+      /** marginalize everything before CurrentTime, solve and compute the covariance of the current states */
+      bool step(double CurrentTime, const ceres::Solver::Options &Options, const Deadline &Limit = Deadline());
+
+    private:
+      bool marginalizePrevious_(double CurrentTime);
+      bool computeCovariance_(double CurrentTime);
+
+      FactorGraph &Graph_;
+      bool EstimateCov_;
+  };
+}
+
+#endif // RECURSIVEFILTER_H
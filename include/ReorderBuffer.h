@@ -0,0 +1,92 @@
+/***************************************************************************
+ * libRSF - A Robust Sensor Fusion Library
+ *
+ * Copyright (C) 2018 Chair of Automation Technology / TU Chemnitz
+ * For more information see https://www.tu-chemnitz.de/etit/proaut/libRSF
+ *
+ * libRSF is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libRSF is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with libRSF.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Tim Pfeifer (tim.pfeifer@etit.tu-chemnitz.de)
+ ***************************************************************************/
+
+/**
+ * @file ReorderBuffer.h
+ * @author Tim Pfeifer
+ * @date 14.10.2026
+ * @brief Restores the temporal order of measurements with variable latency.
+ * @copyright GNU Public License.
+ *
+ */
+
+#ifndef REORDERBUFFER_H
+#define REORDERBUFFER_H
+
+#include "SensorDataSet.h"
+
+#include <limits>
+
+namespace libRSF
+{
+  /** \brief Holds measurements until all measurements of the same time should have arrived.
+   *
+   * A measurement is complete once a later one arrived that is at least the latency bound
+   * newer, up to that point it may arrive in any order. Measurements behind the already released
+   * time are late, they are collected and returned together, so the graph inserts them in one batch.
+   * The buffer is not synchronized, the owner has to lock it.
+   */
+  class ReorderBuffer
+  {
+    public:
+      /** the latency bound in seconds, zero expects the input in temporal order */
+      explicit ReorderBuffer(double Latency = 0.0);
+      ~ReorderBuffer() = default;
+
+      void setLatency(double Latency);
+      [[nodiscard]] double getLatency() const;
+
+      /** returns false if the object is late */
+      bool add(const Data &Object);
+
+      /** true if all objects up to Timestamp are expected to be buffered */
+      [[nodiscard]] bool isComplete(double Timestamp) const;
+
+      /** move all objects up to Timestamp into Data, in temporal order */
+      void release(double Timestamp, SensorDataSet &Data);
+
+      /** move all late objects since the last call into Data, false if there were none */
+      bool releaseLate(SensorDataSet &Data);
+
+      /** buffered objects that were not released yet */
+      [[nodiscard]] const SensorDataSet &getBuffer() const;
+
+      [[nodiscard]] double getTimeNewest() const;
+      [[nodiscard]] double getTimeReleased() const;
+
+      /** number of late objects since the construction */
+      [[nodiscard]] int countLate() const;
+
+    private:
+      double Latency_;
+
+      SensorDataSet Buffer_;
+      SensorDataSet Late_;
+
+      double TimeNewest_ = -std::numeric_limits<double>::infinity();
+      double TimeReleased_ = -std::numeric_limits<double>::infinity();
+      bool HasLate_ = false;
+      int LateNumber_ = 0;
+  };
+}
+
+#endif // REORDERBUFFER_H
@@ -38,6 +38,70 @@
 
 namespace libRSF
 {
+  /** information-weighted average of a sequence of measurements that is accumulated in place,
+   *  the last added measurement is only referenced and has to stay valid until pop() */
+  class MeasurementAccumulator
+  {
+    public:
+      MeasurementAccumulator() = default;
+      ~MeasurementAccumulator() = default;
+
+      void add(const Data &Measurement);
+
+      [[nodiscard]] bool empty() const
+      {
+        return Number_ == 0;
+      }
+
+      /** average with the timestamp of the last measurement, resets the accumulator but keeps its buffers */
+      Data pop();
+
+    private:
+      template <typename MeanType, typename CovarianceType>
+      void accumulate_(const MeanType &Mean, const CovarianceType &CovarianceDiagonal)
+      {
+        InfoMean_.array() += Mean.array() / CovarianceDiagonal.array();
+        Info_.array() += CovarianceDiagonal.array().inverse();
+      }
+
+      Vector InfoMean_;
+      Vector Info_;
+      const Data *Last_ = nullptr;
+      int Number_ = 0;
+      bool Weighted_ = false;
+  };
+
+  /** sample measurements down in a single pass over a range, windows of sample time length are averaged into the output */
+  template <typename IteratorType>
+  void SampleMeasurementsDown(const IteratorType Begin, const IteratorType End, const double SampleTime, SensorDataSet &Output)
+  {
+    if (Begin == End)
+    {
+      PRINT_ERROR("There is no Measurement!");
+      return;
+    }
+
+    double TimeNext = (*Begin).getTimestamp() + SampleTime;
+
+    MeasurementAccumulator Window;
+    for (IteratorType It = Begin; It != End;)
+    {
+      const Data &Measurement = *It;
+      Window.add(Measurement);
+      ++It;
+
+      /** average when period is over*/
+      if (Measurement.getTimestamp() >= TimeNext || It == End)
+      {
+        Output.addElement(Window.pop());
+        TimeNext += SampleTime;
+      }
+    }
+  }
+
+  /** sample all sensors of a set down, each sensor is processed by its own thread */
+  SensorDataSet SampleMeasurementsDown(const SensorDataSet &Input, double SampleTime);
+
   /** sample measurements down */
   std::vector<Data> SampleMeasurementsDown(const std::vector<Data> &Input, double SampleTime);
 
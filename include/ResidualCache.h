@@ -0,0 +1,96 @@
+/***************************************************************************
+ * libRSF - A Robust Sensor Fusion Library
+ *
+ * Copyright (C) 2018 Chair of Automation Technology / TU Chemnitz
+ * For more information see https://www.tu-chemnitz.de/etit/proaut/libRSF
+ *
+ * libRSF is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libRSF is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with libRSF.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Tim Pfeifer (tim.pfeifer@etit.tu-chemnitz.de)
+ ***************************************************************************/
+
+/**
+ * @file ResidualCache.h
+ * @author Tim Pfeifer
+ * @date 14.10.2026
+ * @brief Reuses the last evaluation of residual blocks as long as their states are unchanged.
+ * @copyright GNU Public License.
+ *
+ */
+
+#ifndef RESIDUALCACHE_H
+#define RESIDUALCACHE_H
+
+#include "StateDataSet.h"
+#include "PointerMap.h"
+
+#include <ceres/ceres.h>
+
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace libRSF
+{
+  /** @brief Stores the residuals of each block together with the versions of its states.
+   * The versions are taken from the Data objects, so changes by setMean() or through a freshly taken mean pointer are detected.
+   * Writes through pointers that were taken before (solver, predictions) are not visible and require invalidate().
+   * All functions are guarded by one mutex, so the errors of different factor types can be extracted concurrently.
+   */
+  class ResidualCache
+  {
+    public:
+      ResidualCache() = default;
+      ~ResidualCache() = default;
+
+      /** drop all entries */
+      void invalidate();
+
+      /** drop the entry of a removed block, its ID may be reused by ceres */
+      void forget(ceres::ResidualBlockId ID);
+
+      /** read the current versions of all states, has to precede lookup() and store() */
+      void synchronize(const StateDataSet &States);
+
+      /** copy the stored residuals, fails if the block is unknown or one of its states has changed */
+      [[nodiscard]] bool lookup(ceres::ResidualBlockId ID, const std::vector<double*> &Parameters, std::vector<double> &Residuals) const;
+
+      /** remember the residuals of the current states */
+      void store(ceres::ResidualBlockId ID, const std::vector<double*> &Parameters, const std::vector<double> &Residuals);
+
+      /** statistics since the last invalidation */
+      [[nodiscard]] size_t countHits() const;
+      [[nodiscard]] size_t countMisses() const;
+
+    private:
+      struct Entry
+      {
+        std::vector<uint64_t> Versions;
+        std::vector<double> Residuals;
+      };
+
+      /** requires the lock */
+      [[nodiscard]] bool getVersion_(const double *State, uint64_t &Version) const;
+
+      mutable std::mutex Mutex_;
+
+      PointerMap<const double*, uint64_t> StateVersions_;
+      PointerMap<ceres::ResidualBlockId, Entry> Entries_;
+
+      mutable size_t Hits_ = 0;
+      mutable size_t Misses_ = 0;
+  };
+}
+
+#endif // RESIDUALCACHE_H
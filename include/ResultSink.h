@@ -0,0 +1,218 @@
+/***************************************************************************
+ * libRSF - A Robust Sensor Fusion Library
+ *
+ * Copyright (C) 2018 Chair of Automation Technology / TU Chemnitz
+ * For more information see https://www.tu-chemnitz.de/etit/proaut/libRSF
+ *
+ * libRSF is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libRSF is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with libRSF.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Tim Pfeifer (tim.pfeifer@etit.tu-chemnitz.de)
+ ***************************************************************************/
+
+/**
+ * @file ResultSink.h
+ * @author Tim Pfeifer
+ * @date 14.10.2026
+ * @brief Destinations for estimates that are exported while the estimation is running.
+ * @copyright GNU Public License.
+ *
+ */
+
+#ifndef RESULTSINK_H
+#define RESULTSINK_H
+
+#include "StateDataSet.h"
+
+#include <cstdint>
+#include <fstream>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace libRSF
+{
+  /** receives estimates as soon as they can no longer change */
+  class ResultSink
+  {
+    public:
+      ResultSink() = default;
+      virtual ~ResultSink() = default;
+
+      /** a single final estimate */
+      virtual void addElement(const std::string &Name, const Data &Element) = 0;
+
+      /** all estimates of a set, e.g. the final batch or smoother solution */
+      virtual void addAll(const StateDataSet &States);
+
+      /** write everything that is still buffered */
+      virtual void flush() {}
+  };
+
+  /** collects all estimates in a StateDataSet, mainly for tests and post-processing */
+  class MemoryResultSink : public ResultSink
+  {
+    public:
+      explicit MemoryResultSink(StateDataSet &Result) : Result_(Result) {}
+      ~MemoryResultSink() override = default;
+
+      void addElement(const std::string &Name, const Data &Element) override;
+      void addAll(const StateDataSet &States) override;
+
+    private:
+      StateDataSet &Result_;
+  };
+
+  /** writes the estimates of the selected names in the format of WriteDataToFile(), only a bounded number of lines is kept in memory */
+  class FileResultSink : public ResultSink
+  {
+    public:
+      FileResultSink(const std::string &Filename, std::vector<std::string> Names, size_t BufferedLines = 1000);
+      ~FileResultSink() override;
+
+      void addElement(const std::string &Name, const Data &Element) override;
+
+      /** keeps the order of the names, so a batch solution is written like with WriteDataToFile() */
+      void addAll(const StateDataSet &States) override;
+
+      void flush() override;
+
+      [[nodiscard]] bool isOpen() const;
+
+    private:
+      bool isSelected_(const std::string &Name) const;
+
+      std::ofstream File_;
+      std::vector<std::string> Names_;
+      std::string Buffer_;
+      size_t BufferedLines_;
+      size_t Lines_ = 0;
+  };
+
+  /** spills the final estimates in their raw binary form to disk, only a small index per estimate stays in memory,
+   *  time ranges can be paged back in, e.g. for a loop closure or a smoother pass over old parts of the trajectory */
+  class ArchiveResultSink : public ResultSink
+  {
+    public:
+      explicit ArchiveResultSink(const std::string &Filename, size_t BufferedBytes = 1 << 20);
+      ~ArchiveResultSink() override;
+
+      /** a second estimate of the same state replaces the first one */
+      void addElement(const std::string &Name, const Data &Element) override;
+
+      void flush() override;
+
+      /** estimates of Name with TimeBegin <= Timestamp <= TimeEnd, including their covariance, are added to States */
+      bool load(const std::string &Name, double TimeBegin, double TimeEnd, StateDataSet &States);
+
+      /** same for all names */
+      bool load(double TimeBegin, double TimeEnd, StateDataSet &States);
+
+      [[nodiscard]] bool isOpen() const;
+      [[nodiscard]] size_t countElements() const;
+
+      /** bytes of the file and of the index in memory */
+      [[nodiscard]] uint64_t getFileSize() const;
+      [[nodiscard]] size_t getIndexSize() const;
+
+    private:
+      struct Record
+      {
+        double Timestamp;
+        uint64_t Position;
+        DataType Type;
+        uint32_t Size;
+      };
+
+      bool readRecord_(const Record &Entry, Data &Element);
+
+      std::fstream File_;
+      std::string Buffer_;
+      size_t BufferedBytes_;
+      uint64_t FileSize_ = 0;
+
+      /** records of each name in temporal order */
+      std::map<std::string, std::vector<Record>> Index_;
+      size_t Elements_ = 0;
+  };
+
+  /** storage of the covariance in a CompactResultSink */
+  enum class CompactPrecision {Double, Float, Half};
+
+  /** keeps the final estimates in memory, but column-wise per name instead of one Data object per estimate:
+   *  - timestamps are delta encoded as variable-length integers in multiples of TimeResolution
+   *  - covariances are stored in double, float or half precision, the latter relative to the largest entry of each estimate
+   *  - all other values are kept exactly */
+  class CompactResultSink : public ResultSink
+  {
+    public:
+      explicit CompactResultSink(CompactPrecision CovariancePrecision = CompactPrecision::Float, double TimeResolution = 1e-9);
+      ~CompactResultSink() override = default;
+
+      void addElement(const std::string &Name, const Data &Element) override;
+
+      /** estimates of Name with TimeBegin <= Timestamp <= TimeEnd are added to States */
+      bool load(const std::string &Name, double TimeBegin, double TimeEnd, StateDataSet &States) const;
+
+      /** decode all estimates name by name in temporal order, e.g. into a FileResultSink or MemoryResultSink */
+      void exportTo(ResultSink &Target) const;
+
+      [[nodiscard]] size_t countElements() const;
+
+      /** bytes of all columns */
+      [[nodiscard]] size_t getMemoryUsage() const;
+
+      /** "double", "float" or "half" */
+      static bool ParsePrecision(const std::string &Name, CompactPrecision &Precision);
+
+    private:
+      struct Column
+      {
+        DataType Type;
+        int TotalSize = 0;
+
+        /** parts of the buffer of the type */
+        int TimeOffset = -1;
+        int CovOffset = -1;
+        int CovSize = 0;
+        std::vector<std::pair<int, int>> ValueRanges; /**< offset and size */
+
+        size_t Rows = 0;
+        int64_t LastTick = 0;
+        std::vector<uint8_t> TimeDeltas;
+        std::vector<double> Values;
+        std::vector<double> CovDouble;
+        std::vector<float> CovFloat;
+        std::vector<Eigen::half> CovHalf;
+        std::vector<double> CovScale;
+      };
+
+      void initColumn_(Column &Col, DataType Type) const;
+      void decodeRow_(const Column &Col, size_t Row, int64_t Tick, std::vector<double> &Buffer) const;
+
+      /** calls Function(Element) for each decoded estimate of the column with TimeBegin <= Timestamp <= TimeEnd */
+      template <typename FunctionType>
+      void decodeColumn_(const Column &Col, double TimeBegin, double TimeEnd, FunctionType Function) const;
+
+      CompactPrecision Precision_;
+      double TimeResolution_;
+
+      std::map<std::string, Column> Columns_;
+
+      /** estimates that arrive older than the newest of their name are rare, they are kept as they are */
+      StateDataSet Unordered_;
+      size_t Elements_ = 0;
+  };
+}
+
+#endif // RESULTSINK_H
@@ -0,0 +1,115 @@
+/***************************************************************************
+ * libRSF - A Robust Sensor Fusion Library
+ *
+ * Copyright (C) 2018 Chair of Automation Technology / TU Chemnitz
+ * For more information see https://www.tu-chemnitz.de/etit/proaut/libRSF
+ *
+ * libRSF is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libRSF is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with libRSF.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Tim Pfeifer (tim.pfeifer@etit.tu-chemnitz.de)
+ ***************************************************************************/
+
+/**
+ * @file RingBuffer.h
+ * @author Tim Pfeifer
+ * @date 14.10.2026
+ * @brief Lock-free queue for one producer and one consumer thread.
+ * @copyright GNU Public License.
+ *
+ */
+
+#ifndef RINGBUFFER_H
+#define RINGBUFFER_H
+
+#include <atomic>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace libRSF
+{
+  /** \brief Bounded single-producer/single-consumer queue.
+   *
+   * push() may only be called by one thread and pop() by one other thread.
+   * The capacity is rounded up to a power of two, one slot stays empty to distinguish a full from an empty buffer.
+   */
+  template <typename ObjectType>
+  class RingBuffer
+  {
+    public:
+      explicit RingBuffer(const size_t Capacity)
+      {
+        size_t Size = 2;
+        while (Size < Capacity + 1)
+        {
+          Size *= 2;
+        }
+        Slots_.resize(Size);
+        Mask_ = Size - 1;
+      }
+      ~RingBuffer() = default;
+
+      RingBuffer(const RingBuffer&) = delete;
+      RingBuffer& operator=(const RingBuffer&) = delete;
+
+      /** producer side, returns false if the buffer is full and leaves the object untouched then */
+      bool push(ObjectType &&Object)
+      {
+        const size_t Head = Head_.load(std::memory_order_relaxed);
+        const size_t Next = (Head + 1) & Mask_;
+        if (Next == Tail_.load(std::memory_order_acquire))
+        {
+          return false;
+        }
+
+        Slots_[Head] = std::move(Object);
+        Head_.store(Next, std::memory_order_release);
+        return true;
+      }
+
+      /** consumer side, returns false if the buffer is empty */
+      bool pop(ObjectType &Object)
+      {
+        const size_t Tail = Tail_.load(std::memory_order_relaxed);
+        if (Tail == Head_.load(std::memory_order_acquire))
+        {
+          return false;
+        }
+
+        Object = std::move(Slots_[Tail]);
+        Tail_.store((Tail + 1) & Mask_, std::memory_order_release);
+        return true;
+      }
+
+      [[nodiscard]] bool empty() const
+      {
+        return Head_.load(std::memory_order_acquire) == Tail_.load(std::memory_order_acquire);
+      }
+
+      [[nodiscard]] size_t capacity() const
+      {
+        return Mask_;
+      }
+
+    private:
+      std::vector<ObjectType> Slots_;
+      size_t Mask_ = 0;
+
+      /** separate cache lines, so that producer and consumer do not invalidate each other */
+      alignas(64) std::atomic<size_t> Head_{0};
+      alignas(64) std::atomic<size_t> Tail_{0};
+  };
+}
+
+#endif // RINGBUFFER_H
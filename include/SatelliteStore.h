@@ -0,0 +1,108 @@
+/***************************************************************************
+ * libRSF - A Robust Sensor Fusion Library
+ *
+ * Copyright (C) 2018 Chair of Automation Technology / TU Chemnitz
+ * For more information see https://www.tu-chemnitz.de/etit/proaut/libRSF
+ *
+ * libRSF is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libRSF is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with libRSF.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Tim Pfeifer (tim.pfeifer@etit.tu-chemnitz.de)
+ ***************************************************************************/
+
+/**
+ * @file SatelliteStore.h
+ * @author Tim Pfeifer
+ * @date 14.10.2026
+ * @brief Shared storage of satellite positions, so that pseudorange factors only keep an index.
+ * @copyright GNU Public License.
+ *
+ */
+
+#ifndef SATELLITESTORE_H
+#define SATELLITESTORE_H
+
+#include "Data.h"
+#include "VectorTypes.h"
+
+#include <map>
+#include <memory>
+#include <tuple>
+#include <vector>
+
+namespace libRSF
+{
+  class SatelliteStore
+  {
+    public:
+      SatelliteStore() = default;
+      ~SatelliteStore() = default;
+
+      /** store the satellite position of a measurement, positions of the same satellite and epoch are stored once */
+      size_t add(const Data &Measurement);
+      size_t add(int SatSystem, int SatID, double Timestamp, const Vector3 &Position);
+
+      /** position without a key, is always stored */
+      size_t add(const Vector3 &Position);
+
+      template <int Dim>
+      [[nodiscard]] VectorStatic<Dim> getPosition(const size_t Index) const
+      {
+        static_assert(Dim == 2 || Dim == 3, "Satellite positions are 2D or 3D!");
+
+        VectorStatic<Dim> Position;
+        Position(0) = X_[Index];
+        Position(1) = Y_[Index];
+        if constexpr (Dim == 3)
+        {
+          Position(2) = Z_[Index];
+        }
+        return Position;
+      }
+
+      [[nodiscard]] size_t size() const;
+      [[nodiscard]] bool empty() const;
+      void clear();
+
+    private:
+      size_t append_(const Vector3 &Position);
+
+      /** positions as structure of arrays */
+      std::vector<double> X_;
+      std::vector<double> Y_;
+      std::vector<double> Z_;
+
+      /** (system, satellite, epoch) -> index */
+      std::map<std::tuple<int, int, double>, size_t> Index_;
+  };
+
+  /** what a factor keeps instead of a copy of the satellite position */
+  class SatelliteReference
+  {
+    public:
+      SatelliteReference() = default;
+      SatelliteReference(std::shared_ptr<const SatelliteStore> Store, const size_t Index) : Store_(std::move(Store)), Index_(Index) {}
+
+      template <int Dim>
+      [[nodiscard]] VectorStatic<Dim> get() const
+      {
+        return Store_->template getPosition<Dim>(Index_);
+      }
+
+    private:
+      std::shared_ptr<const SatelliteStore> Store_;
+      size_t Index_ = 0;
+  };
+}
+
+#endif // SATELLITESTORE_H
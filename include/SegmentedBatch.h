@@ -0,0 +1,114 @@
+/***************************************************************************
+ * libRSF - A Robust Sensor Fusion Library
+ *
+ * Copyright (C) 2018 Chair of Automation Technology / TU Chemnitz
+ * For more information see https://www.tu-chemnitz.de/etit/proaut/libRSF
+ *
+ * libRSF is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libRSF is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with libRSF.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Tim Pfeifer (tim.pfeifer@etit.tu-chemnitz.de)
+ ***************************************************************************/
+
+/**
+ * @file SegmentedBatch.h
+ * @author Tim Pfeifer
+ * @date 14.10.2026
+ * @brief Solves a batch problem as overlapping time segments in parallel.
+ * @copyright GNU Public License.
+ *
+ */
+
+#ifndef SEGMENTEDBATCH_H
+#define SEGMENTEDBATCH_H
+
+#include "FactorGraph.h"
+#include "FactorGraphConfig.h"
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace libRSF
+{
+  /** \brief Splits the time axis of a batch problem into overlapping segments that are solved as independent graphs.
+   *
+   * States inside an overlap exist in both neighboring graphs. After each round, both copies are pulled
+   * towards their mean by a linear prior (consensus ADMM with a fixed penalty), until they agree or the
+   * number of rounds is reached. The final solution is stitched together at the middle of each overlap.
+   * Factors that connect states of different segments, e.g. long loop closures, have to be avoided by the builder.
+   */
+  class SegmentedBatch
+  {
+    public:
+      /** has to add all states and factors between both times, is called concurrently for different segments */
+      using Builder = std::function<bool(FactorGraph &Graph, double TimeBegin, double TimeEnd)>;
+
+      SegmentedBatch(double Length, double Overlap, int Rounds, double ConsensusStdDev = 0.1);
+      explicit SegmentedBatch(const FactorGraphConfig &Config);
+      ~SegmentedBatch() = default;
+
+      /** the problem is split if it is longer than one segment */
+      [[nodiscard]] bool isActive() const;
+
+      /** build, solve and stitch all segments, the result contains the states of all segments */
+      bool solve(double TimeBegin, double TimeEnd, const Builder &Build, const ceres::Solver::Options &Options, StateDataSet &Result);
+
+      /** statistics of the last call of solve() */
+      [[nodiscard]] size_t countSegments() const;
+      [[nodiscard]] int countRounds() const;
+      [[nodiscard]] double getDisagreement() const;
+      [[nodiscard]] double getSolverDuration() const;
+
+    private:
+      struct Segment
+      {
+        double TimeBegin;
+        double TimeEnd;
+        std::unique_ptr<FactorGraph> Graph;
+      };
+
+      /** one state that is estimated by two neighboring segments */
+      struct SharedState
+      {
+        StateID ID;
+        DataType Type;
+        Vector Consensus;
+
+        /** scaled dual variables of both copies in the tangent space */
+        Vector DualLeft;
+        Vector DualRight;
+      };
+
+      void collectSharedStates_(size_t Left);
+      double updateConsensus_(size_t Left, bool IsFirst);
+      void addConsensusPriors_(size_t Left, bool RemoveOld);
+      void stitch_(StateDataSet &Result) const;
+
+      double Length_;
+      double Overlap_;
+      int Rounds_;
+      double ConsensusStdDev_;
+
+      std::vector<Segment> Segments_;
+
+      /** shared states between segment n and n+1 */
+      std::vector<std::vector<SharedState>> Shared_;
+
+      int RoundsDone_ = 0;
+      double Disagreement_ = 0.0;
+      double SolverDuration_ = 0.0;
+  };
+}
+
+#endif // SEGMENTEDBATCH_H
@@ -35,6 +35,8 @@
 #include "DataSet.h"
 #include "Data.h"
 
+#include <memory>
+
 namespace libRSF
 {
 
@@ -52,6 +54,36 @@ namespace libRSF
 
   using MeasurementID = SensorDataSet::UniqueID;
 
+  /** immutable set that can be shared between threads, overlays duplicate only the streams they modify */
+  class SensorDataView
+  {
+    public:
+      SensorDataView() = default;
+      explicit SensorDataView(SensorDataSet Data) : Data_(std::make_shared<const SensorDataSet>(std::move(Data)))
+      {
+      }
+      ~SensorDataView() = default;
+
+      [[nodiscard]] const SensorDataSet &get() const
+      {
+        return *Data_;
+      }
+
+      operator const SensorDataSet &() const
+      {
+        return *Data_;
+      }
+
+      /** copy-on-write copy for the modifications of one run */
+      [[nodiscard]] SensorDataSet makeOverlay() const
+      {
+        return *Data_;
+      }
+
+    private:
+      std::shared_ptr<const SensorDataSet> Data_ = std::make_shared<const SensorDataSet>();
+  };
+
   std::ostream& operator << (std::ostream& Os, const MeasurementID& ID);
 }
 
@@ -0,0 +1,176 @@
+/***************************************************************************
+ * libRSF - A Robust Sensor Fusion Library
+ *
+ * Copyright (C) 2018 Chair of Automation Technology / TU Chemnitz
+ * For more information see https://www.tu-chemnitz.de/etit/proaut/libRSF
+ *
+ * libRSF is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libRSF is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with libRSF.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Tim Pfeifer (tim.pfeifer@etit.tu-chemnitz.de)
+ ***************************************************************************/
+
+/**
+ * @file SensorDataSource.h
+ * @author Tim Pfeifer
+ * @date 14.10.2026
+ * @brief Sequential access to measurements without loading a complete file.
+ * @copyright GNU Public License.
+ *
+ */
+
+#ifndef SENSORDATASOURCE_H
+#define SENSORDATASOURCE_H
+
+#include "SensorDataSet.h"
+#include "FileAccess.h"
+#include "FileView.h"
+
+#include <condition_variable>
+#include <deque>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace libRSF
+{
+  /** interface for everything that delivers measurements in temporal order */
+  class SensorDataSource
+  {
+    public:
+      SensorDataSource() = default;
+      virtual ~SensorDataSource() = default;
+
+      /** move all measurements up to Timestamp, that were not returned before, into Data */
+      virtual void getMeasurementsUntil(double Timestamp, SensorDataSet &Data) = 0;
+
+      /** time range of the complete source */
+      virtual bool getTimeFirst(DataType Type, double &Timestamp) const = 0;
+      virtual bool getTimeLast(DataType Type, double &Timestamp) const = 0;
+
+      /** next timestamp after Timestamp, which must not be before the last requested time */
+      virtual bool getTimeNext(DataType Type, double Timestamp, double &NextTimestamp) = 0;
+
+      [[nodiscard]] virtual std::vector<DataType> getKeysAll() const = 0;
+
+      /** move measurements that arrived after their time was returned into Data, false if there are none */
+      virtual bool getLateMeasurements(SensorDataSet &/*Data*/) {return false;}
+  };
+
+  /** reads a text file in the background, only a few seconds ahead of the requested time
+   *  the objects of each type have to be stored in temporal order */
+  class SensorDataFileSource : public SensorDataSource
+  {
+    public:
+      explicit SensorDataFileSource(const std::string &Filename, double ReadAhead = 10.0);
+      ~SensorDataFileSource() override;
+
+      SensorDataFileSource(const SensorDataFileSource &) = delete;
+      SensorDataFileSource &operator=(const SensorDataFileSource &) = delete;
+
+      void getMeasurementsUntil(double Timestamp, SensorDataSet &Data) override;
+
+      bool getTimeFirst(DataType Type, double &Timestamp) const override;
+      bool getTimeLast(DataType Type, double &Timestamp) const override;
+      bool getTimeNext(DataType Type, double Timestamp, double &NextTimestamp) override;
+
+      [[nodiscard]] std::vector<DataType> getKeysAll() const override;
+
+    private:
+      /** every type is read by its own file handle, starting at its first line */
+      struct StreamType
+      {
+        std::string Name;
+        std::ifstream File;
+        std::deque<Data> Buffer;
+        double TimeFirst = 0.0;
+        double TimeLast = 0.0;
+        bool IsFinished = false;
+      };
+
+      /** find the first line and the time range of each type */
+      void indexFile_(const std::string &Filename);
+
+      /** the background thread */
+      void readAhead_();
+      static bool readNext_(StreamType &Stream, Data &Object);
+
+      /** true, if all objects up to Timestamp are buffered */
+      static bool isAvailable_(const StreamType &Stream, double Timestamp);
+
+      std::map<DataType, StreamType> Streams_;
+      double ReadAhead_;
+      double Horizon_;
+      bool Stop_ = false;
+
+      std::mutex Mutex_;
+      std::condition_variable Condition_;
+      std::thread Worker_;
+  };
+
+  /** reads the binary format through a memory mapping, objects are only decoded when they are requested,
+   *  so the memory grows with the requested time span and not with the size of the file
+   *  compressed chunks are decoded in parallel when they are first needed and dropped once they are returned */
+  class SensorDataBinarySource : public SensorDataSource
+  {
+    public:
+      /** an empty list of types selects all types of the file */
+      explicit SensorDataBinarySource(const std::string &Filename, const std::vector<DataType> &Types = {});
+      ~SensorDataBinarySource() override = default;
+
+      SensorDataBinarySource(const SensorDataBinarySource &) = delete;
+      SensorDataBinarySource &operator=(const SensorDataBinarySource &) = delete;
+
+      void getMeasurementsUntil(double Timestamp, SensorDataSet &Data) override;
+
+      bool getTimeFirst(DataType Type, double &Timestamp) const override;
+      bool getTimeLast(DataType Type, double &Timestamp) const override;
+      bool getTimeNext(DataType Type, double Timestamp, double &NextTimestamp) override;
+
+      [[nodiscard]] std::vector<DataType> getKeysAll() const override;
+
+      [[nodiscard]] bool isValid() const;
+
+    private:
+      /** the chunks of one type in temporal order */
+      struct BlockType
+      {
+        BinaryDataBlock Index;
+        int TimestampOffset = 0;    /**< position of the timestamp in the buffer of an object */
+        size_t NextChunk = 0;       /**< chunk of the first object that was not returned yet */
+        uint64_t NextObject = 0;    /**< position of this object in its chunk */
+        std::map<size_t, std::vector<double>> Decoded;
+      };
+
+      /** check the header and read the index without decoding any chunk */
+      bool indexFile_(const std::string &Filename, const std::vector<DataType> &Types);
+
+      /** decode all compressed chunks that start before Timestamp at once */
+      void decodeUntil_(double Timestamp);
+
+      /** copy Number values of an object, starting at Value */
+      bool readValues_(BlockType &Block, size_t Chunk, uint64_t Object, int Value, double *Target, int Number);
+      double getTimestamp_(BlockType &Block, size_t Chunk, uint64_t Object);
+
+      FileView File_;
+      BinaryCompression Compression_ = BinaryCompression::None;
+      std::map<DataType, BlockType> Blocks_;
+      bool IsValid_ = false;
+  };
+}
+
+#endif // SENSORDATASOURCE_H
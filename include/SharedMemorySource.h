@@ -0,0 +1,162 @@
+/***************************************************************************
+ * libRSF - A Robust Sensor Fusion Library
+ *
+ * Copyright (C) 2019 Chair of Automation Technology / TU Chemnitz
+ * For more information see https://www.tu-chemnitz.de/etit/proaut/libRSF
+ *
+ * libRSF is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libRSF is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with libRSF.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Tim Pfeifer (tim.pfeifer@etit.tu-chemnitz.de)
+ ***************************************************************************/
+
+/**
+ * @file SharedMemorySource.h
+ * @author Tim Pfeifer
+ * @date 14.10.2026
+ * @brief Lock-free single producer single consumer ring in shared memory to receive measurements from other processes.
+ * @copyright GNU Public License.
+ *
+ */
+
+#ifndef SHAREDMEMORYSOURCE_H
+#define SHAREDMEMORYSOURCE_H
+
+#include "SensorDataSource.h"
+#include "ReorderBuffer.h"
+
+#include <atomic>
+#include <cstdint>
+
+namespace libRSF
+{
+  /** ring of fixed size records in a POSIX shared memory segment
+   *  - one process creates the segment and pushes, another one opens it and pops
+   *  - every record is the raw Data buffer in the layout of DataConfig, so nothing has to be parsed */
+  class SharedMemoryRing
+  {
+    public:
+      SharedMemoryRing() = default;
+      ~SharedMemoryRing();
+
+      SharedMemoryRing(const SharedMemoryRing &) = delete;
+      SharedMemoryRing &operator=(const SharedMemoryRing &) = delete;
+
+      /** producer side, the segment is removed again when the creator is destroyed */
+      bool create(const std::string &Name, size_t Capacity);
+
+      /** consumer side, fails until the producer has initialized the segment */
+      bool open(const std::string &Name);
+
+      [[nodiscard]] bool isOpen() const;
+
+      /** false if the ring is full or the type does not fit into a record */
+      bool push(const Data &Object);
+
+      /** false if the ring is empty */
+      bool pop(Data &Object);
+
+      /** the producer marks the end of the stream */
+      void close();
+
+      /** true if the producer closed the stream and all records were popped */
+      [[nodiscard]] bool isFinished() const;
+
+    private:
+      /** layout of the segment (native byte order), followed by Capacity records of
+       *  uint32 type, uint32 number of values, double[RecordValues] values */
+      struct HeaderType
+      {
+        char Magic[4];
+        std::uint32_t Version;
+        std::uint32_t RecordValues;
+        std::uint32_t Reserved;
+        std::uint64_t Capacity;
+        alignas(64) std::atomic<std::uint64_t> Head; /**< written by the producer */
+        alignas(64) std::atomic<std::uint64_t> Tail; /**< written by the consumer */
+        alignas(64) std::atomic<std::uint32_t> IsClosed;
+        std::atomic<std::uint32_t> IsReady;
+      };
+
+      static_assert(std::atomic<std::uint64_t>::is_always_lock_free, "Shared memory requires lock-free atomics!");
+
+      /** map an existing descriptor */
+      bool map_(int FileDescriptor, size_t Bytes);
+      void unmap_();
+
+      [[nodiscard]] std::uint32_t* getRecord_(std::uint64_t Index) const;
+
+      HeaderType* Header_ = nullptr;
+      char* Records_ = nullptr;
+      size_t RecordBytes_ = 0;
+      size_t MappedBytes_ = 0;
+      std::string Name_;
+      bool IsCreator_ = false;
+  };
+
+  /** delivers the measurements of a shared memory ring in the interface of all sources
+   *  - a background thread drains the ring, so the producer is not blocked while the graph is solved
+   *  - records may arrive out of order within the latency bound, later ones are returned as late measurements
+   *  - the end of the data is known when the producer closes the stream */
+  class SensorDataSharedMemorySource : public SensorDataSource
+  {
+    public:
+      /** opening the segment and blocking queries give up after Timeout seconds, Latency is the bound of the reordering */
+      explicit SensorDataSharedMemorySource(const std::string &Name, double Timeout = 10.0, double Latency = 0.0);
+      ~SensorDataSharedMemorySource() override;
+
+      SensorDataSharedMemorySource(const SensorDataSharedMemorySource &) = delete;
+      SensorDataSharedMemorySource &operator=(const SensorDataSharedMemorySource &) = delete;
+
+      /** waits until a later record arrived or the stream is finished */
+      void getMeasurementsUntil(double Timestamp, SensorDataSet &Data) override;
+
+      /** waits for the first record of this type */
+      bool getTimeFirst(DataType Type, double &Timestamp) const override;
+
+      /** infinity until the producer closed the stream */
+      bool getTimeLast(DataType Type, double &Timestamp) const override;
+
+      bool getTimeNext(DataType Type, double Timestamp, double &NextTimestamp) override;
+
+      /** types that were received so far */
+      [[nodiscard]] std::vector<DataType> getKeysAll() const override;
+
+      /** records behind the last requested time */
+      bool getLateMeasurements(SensorDataSet &Data) override;
+
+    private:
+      /** the background thread */
+      void receive_();
+
+      /** wait until Condition is true, the stream is finished or the timeout is reached */
+      template <typename ConditionType>
+      bool waitFor_(std::unique_lock<std::mutex> &Lock, ConditionType Condition) const;
+
+      SharedMemoryRing Ring_;
+      double Timeout_;
+
+      /** received, but not yet requested measurements */
+      ReorderBuffer Buffer_;
+      std::map<DataType, double> TimeFirst_;
+      std::map<DataType, double> TimeLast_;
+      bool IsFinished_ = false;
+      bool Stop_ = false;
+
+      mutable std::mutex Mutex_;
+      mutable std::condition_variable Condition_;
+      std::thread Worker_;
+  };
+}
+
+#endif // SHAREDMEMORYSOURCE_H
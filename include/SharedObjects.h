@@ -0,0 +1,171 @@
+/***************************************************************************
+ * libRSF - A Robust Sensor Fusion Library
+ *
+ * Copyright (C) 2018 Chair of Automation Technology / TU Chemnitz
+ * For more information see https://www.tu-chemnitz.de/etit/proaut/libRSF
+ *
+ * libRSF is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libRSF is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with libRSF.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Tim Pfeifer (tim.pfeifer@etit.tu-chemnitz.de)
+ ***************************************************************************/
+
+/**
+ * @file SharedObjects.h
+ * @author Tim Pfeifer
+ * @date 14.10.2026
+ * @brief Registry of shared polymorphic objects like loss functions and local parametrizations.
+ * @copyright GNU Public License.
+ *
+ */
+
+#ifndef SHAREDOBJECTS_H
+#define SHAREDOBJECTS_H
+
+#include "PointerMap.h"
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <typeindex>
+#include <utility>
+#include <vector>
+
+namespace libRSF
+{
+  /** \brief Flyweight registry that owns polymorphic helper objects of a ceres::Problem.
+   *
+   * get() returns one shared instance per type and parameter set, which lives as long as the registry.
+   * Objects that were created individually can be adopted; they are deleted when the last user releases them.
+   */
+  template <typename BaseType>
+  class SharedObjects
+  {
+    public:
+      SharedObjects() = default;
+      ~SharedObjects()
+      {
+        this->clear();
+      }
+
+      SharedObjects(const SharedObjects&) = delete;
+      SharedObjects& operator=(const SharedObjects&) = delete;
+
+      /** shared instance of ObjectType(Parameters...), created on the first request */
+      template <typename ObjectType, typename... ParameterTypes>
+      BaseType* get(const ParameterTypes&... Parameters)
+      {
+        static_assert(std::is_base_of_v<BaseType, ObjectType>, "Shared object has the wrong base class!");
+
+        Key ID(std::type_index(typeid(ObjectType)), std::vector<double>());
+        (appendParameter_(ID.second, Parameters), ...);
+
+        std::lock_guard<std::mutex> Lock(Mutex_);
+        auto Object = Shared_.find(ID);
+        if (Object == Shared_.end())
+        {
+          Object = Shared_.emplace(std::move(ID), std::make_unique<ObjectType>(Parameters...)).first;
+          SharedPointers_.emplace(Object->second.get(), true);
+        }
+        return Object->second.get();
+      }
+
+      /** take the ownership of an individually created object, shared objects and nullptr are ignored */
+      void adopt(BaseType* Object)
+      {
+        std::lock_guard<std::mutex> Lock(Mutex_);
+        if (Object == nullptr || SharedPointers_.count(Object) > 0)
+        {
+          return;
+        }
+        if (Adopted_.count(Object) > 0)
+        {
+          Adopted_.at(Object)++;
+        }
+        else
+        {
+          Adopted_.emplace(Object, 1);
+        }
+      }
+
+      /** drop one use of an adopted object and delete it after its last use */
+      void release(BaseType* Object)
+      {
+        std::lock_guard<std::mutex> Lock(Mutex_);
+        if (Object == nullptr || Adopted_.count(Object) == 0)
+        {
+          return;
+        }
+        if (--Adopted_.at(Object) == 0)
+        {
+          Adopted_.erase(Object);
+          delete Object;
+        }
+      }
+
+      [[nodiscard]] size_t countShared() const
+      {
+        std::lock_guard<std::mutex> Lock(Mutex_);
+        return Shared_.size();
+      }
+
+      [[nodiscard]] size_t countAdopted() const
+      {
+        std::lock_guard<std::mutex> Lock(Mutex_);
+        return Adopted_.size();
+      }
+
+      /** delete all objects, nothing may use them anymore */
+      void clear()
+      {
+        std::lock_guard<std::mutex> Lock(Mutex_);
+        Adopted_.forEach([](BaseType* Object, int)
+        {
+          delete Object;
+        });
+        Adopted_.clear();
+        SharedPointers_.clear();
+        Shared_.clear();
+      }
+
+    private:
+      /** the type and all constructor parameters identify a shared object */
+      using Key = std::pair<std::type_index, std::vector<double>>;
+
+      template <typename ParameterType>
+      static void appendParameter_(std::vector<double> &Parameters, const ParameterType &Parameter)
+      {
+        if constexpr (std::is_arithmetic_v<ParameterType> || std::is_enum_v<ParameterType>)
+        {
+          Parameters.push_back(static_cast<double>(Parameter));
+        }
+        else
+        {
+          /** containers are stored with their size to keep the keys unique */
+          Parameters.push_back(static_cast<double>(Parameter.size()));
+          for (const auto &Element : Parameter)
+          {
+            appendParameter_(Parameters, Element);
+          }
+        }
+      }
+
+      std::map<Key, std::unique_ptr<BaseType>> Shared_;
+      PointerMap<const BaseType*, bool> SharedPointers_;
+      PointerMap<BaseType*, int> Adopted_;
+      mutable std::mutex Mutex_;
+  };
+}
+
+#endif // SHAREDOBJECTS_H
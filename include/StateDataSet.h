@@ -34,10 +34,11 @@
 
 #include "Data.h"
 #include "DataSet.h"
+#include "StateKey.h"
 
 namespace libRSF
 {
-  class StateDataSet : public DataSet<std::string, Data>
+  class StateDataSet : public DataSet<StateKey, Data>
   {
     public:
       StateDataSet() = default;
@@ -46,11 +47,11 @@ namespace libRSF
       /** add an element according to its internal type and timestamp*/
       void addElement(Data &Element);
       /** use external name */
-      void addElement(const std::string& Name, const Data &Element);
+      void addElement(const StateKey& Name, const Data &Element);
       /** add an empty element*/
-      void addElement(const std::string& Name, DataType Type, double Timestamp);
+      void addElement(const StateKey& Name, DataType Type, double Timestamp);
 
-      using DataSet<std::string, Data>::addElement;
+      using DataSet<StateKey, Data>::addElement;
   };
 
   using StateID = StateDataSet::UniqueID;
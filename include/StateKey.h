@@ -0,0 +1,95 @@
+/***************************************************************************
+ * libRSF - A Robust Sensor Fusion Library
+ *
+ * Copyright (C) 2018 Chair of Automation Technology / TU Chemnitz
+ * For more information see https://www.tu-chemnitz.de/etit/proaut/libRSF
+ *
+ * libRSF is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libRSF is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with libRSF.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Tim Pfeifer (tim.pfeifer@etit.tu-chemnitz.de)
+ ***************************************************************************/
+
+/**
+ * @file StateKey.h
+ * @author Tim Pfeifer
+ * @date 14.10.2026
+ * @brief Interned state names that are compared by an integer.
+ * @copyright GNU Public License.
+ *
+ */
+
+#ifndef STATEKEY_H
+#define STATEKEY_H
+
+#include <ostream>
+#include <string>
+
+namespace libRSF
+{
+  /** \brief Name of a state type, registered once and compared by its integer ID afterwards.
+   *
+   * Implicit conversions from and to std::string keep the string based interface working.
+   * The order follows the registration, not the alphabet.
+   */
+  class StateKey
+  {
+    public:
+      StateKey();
+      StateKey(const std::string &Name);
+      StateKey(const char *Name);
+      ~StateKey() = default;
+
+      [[nodiscard]] int getID() const
+      {
+        return ID_;
+      }
+
+      [[nodiscard]] const std::string &getName() const
+      {
+        return *Name_;
+      }
+
+      operator const std::string &() const
+      {
+        return *Name_;
+      }
+
+      bool operator==(const StateKey &Other) const
+      {
+        return ID_ == Other.ID_;
+      }
+
+      bool operator!=(const StateKey &Other) const
+      {
+        return ID_ != Other.ID_;
+      }
+
+      bool operator<(const StateKey &Other) const
+      {
+        return ID_ < Other.ID_;
+      }
+
+    private:
+      int ID_;
+      const std::string *Name_; /**< points into the registry, whose entries are never removed */
+  };
+
+  std::ostream& operator << (std::ostream& Os, const StateKey& Key);
+
+  /** string concatenation, as used for numbered states */
+  std::string operator + (const StateKey& Key, const std::string& Suffix);
+  std::string operator + (const std::string& Prefix, const StateKey& Key);
+}
+
+#endif // STATEKEY_H
@@ -0,0 +1,112 @@
+/***************************************************************************
+ * libRSF - A Robust Sensor Fusion Library
+ *
+ * Copyright (C) 2019 Chair of Automation Technology / TU Chemnitz
+ * For more information see https://www.tu-chemnitz.de/etit/proaut/libRSF
+ *
+ * libRSF is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libRSF is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with libRSF.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Tim Pfeifer (tim.pfeifer@etit.tu-chemnitz.de)
+ ***************************************************************************/
+
+/**
+ * @file StatePublisher.h
+ * @author Tim Pfeifer
+ * @date 14.10.2026
+ * @brief Wait-free publication of the newest estimates to readers in other threads or processes.
+ * @copyright GNU Public License.
+ *
+ */
+
+#ifndef STATEPUBLISHER_H
+#define STATEPUBLISHER_H
+
+#include "StateDataSet.h"
+#include "VectorMath.h"
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace libRSF
+{
+  /** newest estimate of each published state */
+  struct StateSnapshot
+  {
+    struct Entry
+    {
+      std::string Name;
+      double Timestamp = NAN_DOUBLE; /**< NaN if the state did not exist yet */
+      Vector Mean;
+      Matrix Covariance;             /**< empty if no covariance was estimated */
+    };
+
+    /** increases with every publication */
+    std::uint64_t Version = 0;
+    std::vector<Entry> Entries;
+  };
+
+  /** memory layout of a snapshot that is shared by the publisher and all readers */
+  struct StateSnapshotBlock;
+
+  /** writes the last element of the selected states into a seqlock protected block
+   *  - the publisher never waits, readers retry if a publication overlapped with their copy
+   *  - the block is placed in a POSIX shared memory segment if a name is given */
+  class StatePublisher
+  {
+    public:
+      explicit StatePublisher(const std::vector<StateKey> &Keys, int MaxDimension = 6, const std::string &SharedMemoryName = "");
+      ~StatePublisher();
+
+      StatePublisher(const StatePublisher &) = delete;
+      StatePublisher &operator=(const StatePublisher &) = delete;
+
+      /** must only be called by one thread at a time, usually the thread that solves the graph */
+      void publish(const StateDataSet &States);
+
+      /** in-process readers, false if no consistent copy was possible */
+      bool read(StateSnapshot &Snapshot) const;
+
+    private:
+      StateSnapshotBlock* Block_ = nullptr;
+      size_t Bytes_ = 0;
+      std::string SharedMemoryName_;
+      std::vector<StateKey> Keys_;
+  };
+
+  /** reads the snapshots of a publisher in another process */
+  class StateSubscriber
+  {
+    public:
+      StateSubscriber() = default;
+      ~StateSubscriber();
+
+      StateSubscriber(const StateSubscriber &) = delete;
+      StateSubscriber &operator=(const StateSubscriber &) = delete;
+
+      bool open(const std::string &SharedMemoryName);
+      [[nodiscard]] bool isOpen() const;
+
+      bool read(StateSnapshot &Snapshot) const;
+
+    private:
+      void close_();
+
+      StateSnapshotBlock* Block_ = nullptr;
+      size_t Bytes_ = 0;
+  };
+}
+
+#endif // STATEPUBLISHER_H
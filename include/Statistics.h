@@ -45,18 +45,27 @@ namespace libRSF
   MatrixStatic<Dim, Dim> EstimateSampleCovariance(const MatrixStatic<Dim, Dynamic> &Data)
   {
     /** estimate mean */
-    VectorStatic<Dim> Mean = Data.rowwise().mean();
+    const VectorStatic<Dim> Mean = Data.rowwise().mean();
 
-    /** estimate cov */
+    /** remove the mean block-wise on the stack and accumulate with one matrix product per block */
+    constexpr Index BlockSize = 64;
+    MatrixStatic<Dim, BlockSize> Block;
     MatrixStatic<Dim, Dim> Covariance = MatrixStatic<Dim, Dim>::Zero();
-    for (int n = 0; n < Data.cols(); ++n)
+    Index Column = 0;
+    for (; Column + BlockSize <= Data.cols(); Column += BlockSize)
     {
-      VectorStatic<Dim> Diff = Data.col(n) - Mean;
-      Covariance += Diff * Diff.transpose();
+      Block = Data.template middleCols<BlockSize>(Column).colwise() - Mean;
+      Covariance.noalias() += Block.lazyProduct(Block.transpose());
+    }
+    const Index Rest = Data.cols() - Column;
+    if (Rest > 0)
+    {
+      Block.leftCols(Rest) = Data.rightCols(Rest).colwise() - Mean;
+      Covariance.noalias() += Block.leftCols(Rest).lazyProduct(Block.leftCols(Rest).transpose());
     }
 
     /** return sample covariance */
-    return Covariance / (Data.cols() - 1);
+    return Covariance / static_cast<double>(Data.cols() - 1);
   }
 
   /** median calculation */
@@ -67,6 +76,14 @@ namespace libRSF
   double MAD(const Vector &V);
   double EstimateMADCovariance(const Vector &V);
 
+  /** the same without allocations, the values are copied into a scratch buffer that keeps its capacity between calls */
+  double Median(const Vector &V, std::vector<double> &Scratch);
+  double MAD(const Vector &V, std::vector<double> &Scratch);
+  double EstimateMADCovariance(const Vector &V, std::vector<double> &Scratch);
+
+  /** median of a buffer that is reordered */
+  double MedianInPlace(double* Values, size_t Size);
+
   /** RMSE of a vector */
   double RMSE(const Vector &V);
 }
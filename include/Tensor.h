@@ -36,21 +36,30 @@
 #include "VectorTypes.h"
 #include "Constants.h"
 
-#include <cmath>
+#include <array>
 
 namespace libRSF
 {
   template<int Dim, int Size>
   class Tensor
   {
+    static_assert(Dim > 0 && Size > 0, "Tensor dimension and size have to be positive!");
+
+      static constexpr int Power_(const int Base, const int Exponent)
+      {
+        return Exponent == 0 ? 1 : Base * Power_(Base, Exponent - 1);
+      }
+
     public:
-      Tensor() : Size_(std::pow(Size_, Dim))
+      Tensor()
       {
-        Grid_.resize(Size_);
         Grid_.fill(NAN_DOUBLE);
       }
       ~Tensor() = default;
 
+      /** number of stored elements, known at compile time */
+      static constexpr int Elements = Power_(Size, Dim);
+
       template<typename... IndicesTemplate>
       double get(IndicesTemplate... Indices) const
       {
@@ -58,17 +67,17 @@ namespace libRSF
         static_assert(sizeof...(IndicesTemplate) == Dim, "Number of provided indices have to be equal to the number of dimensions!");
 
         /** get value */
-        return Grid_(Index_(Indices...));
+        return Grid_[Index_(Indices...)];
       }
 
       double get(const VectorStatic<Dim> Indices) const
       {
-        return Grid_(Index_(Indices));
+        return Grid_[Index_(Indices)];
       }
 
       void set(const double Value, const VectorStatic<Dim> Indices)
       {
-        Grid_(Index_(Indices)) = Value;
+        Grid_[Index_(Indices)] = Value;
       }
 
       template<typename... IndicesTemplate>
@@ -77,12 +86,23 @@ namespace libRSF
         /** check parameter number */
         static_assert(sizeof...(IndicesTemplate) == Dim, "Number of provided indices have to be equal to the number of dimensions!");
 
-        Grid_(Index_(Indices...)) = Value;
+        Grid_[Index_(Indices...)] = Value;
+      }
+
+      /** linear access, different elements can be written concurrently */
+      [[nodiscard]] int getLinearIndex(const VectorStatic<Dim> Indices) const
+      {
+        return Index_(Indices);
+      }
+
+      void setLinear(const double Value, const int LinearIndex)
+      {
+        Grid_[LinearIndex] = Value;
       }
 
       void print() const
       {
-        PRINT_LOGGING(Grid_.transpose());
+        PRINT_LOGGING(VectorRefConst<double, Elements>(Grid_.data()).transpose());
       }
 
     private:
@@ -91,16 +111,11 @@ namespace libRSF
       template<typename... IndicesTemplate>
       int Index_(const int Index, IndicesTemplate... Indices) const
       {
-        return Index + Index_(Indices...) * Size_;
+        return CheckIndex_(Index) + Index_(Indices...) * Size;
       }
       [[nodiscard]] int Index_(const int Index) const
       {
-        if(Index >= Size_)
-        {
-          PRINT_ERROR("Index exceed tensor size!");
-        }
-
-        return Index;
+        return CheckIndex_(Index);
       }
 
       /** convert index from vector */
@@ -109,11 +124,16 @@ namespace libRSF
         int Index = 0;
         for (int n = Dim-1; n >=0 ; n--)
         {
-          Index *= Size_;
-          Index += Indices(n);
+          Index *= Size;
+          Index += CheckIndex_(static_cast<int>(Indices(n)));
         }
 
-        if(Index >= Size_)
+        return Index;
+      }
+
+      [[nodiscard]] static int CheckIndex_(const int Index)
+      {
+        if(Index < 0 || Index >= Size)
         {
           PRINT_ERROR("Index exceed tensor size!");
         }
@@ -121,9 +141,8 @@ namespace libRSF
         return Index;
       }
 
-      /** storage for grid points */
-      Vector Grid_;
-      const int Size_;
+      /** storage for grid points, aligned to a cache line */
+      alignas(64) std::array<double, Elements> Grid_;
   };
 
 }
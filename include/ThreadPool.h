@@ -0,0 +1,104 @@
+/***************************************************************************
+ * libRSF - A Robust Sensor Fusion Library
+ *
+ * Copyright (C) 2018 Chair of Automation Technology / TU Chemnitz
+ * For more information see https://www.tu-chemnitz.de/etit/proaut/libRSF
+ *
+ * libRSF is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libRSF is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with libRSF.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Tim Pfeifer (tim.pfeifer@etit.tu-chemnitz.de)
+ ***************************************************************************/
+
+/**
+ * @file ThreadPool.h
+ * @author Tim Pfeifer
+ * @date 14.10.2026
+ * @brief Library-wide pool of worker threads, so that parallel code paths do not oversubscribe the cores.
+ * @copyright GNU Public License.
+ *
+ */
+
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <ceres/ceres.h>
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace libRSF
+{
+  /** pinning of the workers to cores */
+  enum class ThreadAffinity {None, Compact, Scatter};
+
+  struct ThreadPoolConfig
+  {
+    /** threads including the calling one, <= 0 uses all cores */
+    int ThreadNumber = 0;
+
+    /** Compact fills one socket after another, Scatter alternates between the sockets (NUMA nodes) */
+    ThreadAffinity Affinity = ThreadAffinity::None;
+  };
+
+  class ThreadPool
+  {
+    public:
+      explicit ThreadPool(const ThreadPoolConfig &Config = ThreadPoolConfig());
+      ~ThreadPool();
+
+      ThreadPool(const ThreadPool &) = delete;
+      ThreadPool &operator=(const ThreadPool &) = delete;
+
+      /** workers plus the calling thread */
+      [[nodiscard]] int getThreadNumber() const;
+
+      /** call Function(Chunk) for all chunks in [0, ChunkNumber) on at most MaxThreads threads (<= 0 for all) and wait for them,
+       *  the calling thread works as well, so nested calls cannot deadlock */
+      void parallelFor(size_t ChunkNumber, const std::function<void(size_t)> &Function, int MaxThreads = 0);
+
+      /** call Function(Thread) once for each of Threads slots, for workers that keep a local state and share their work */
+      void parallelRun(int Threads, const std::function<void(size_t)> &Function);
+
+    private:
+      void work_();
+
+      std::vector<std::thread> Workers_;
+      std::deque<std::function<void()>> Tasks_;
+      std::mutex Mutex_;
+      std::condition_variable Condition_;
+      bool Stop_ = false;
+  };
+
+  /** configure the process-wide pool, only possible before its first use */
+  bool SetThreadPoolConfig(const ThreadPoolConfig &Config);
+
+  /** size of the process-wide pool, without creating it */
+  int GetThreadNumber();
+
+  /** process-wide pool, created on first use */
+  ThreadPool &GetThreadPool();
+
+  /** run independent tasks on the process-wide pool and wait for all of them, e.g. the adaption of the error models of several sensors */
+  void RunConcurrently(const std::vector<std::function<void()>> &Tasks, int MaxThreads = 0);
+
+  /** shared by all ceres::Problems of libRSF, so Ceres keeps a single set of threads */
+  ceres::Context *GetCeresContext();
+}
+
+#endif // THREADPOOL_H
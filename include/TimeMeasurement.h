@@ -54,6 +54,27 @@ namespace libRSF
     TimestampType Start_;
   };
 
+  /** point in time that limits a sequence of processing steps, without a duration it never passes */
+  class Deadline
+  {
+  public:
+      Deadline();
+      explicit Deadline(double Seconds);
+      ~Deadline() = default;
+
+      [[nodiscard]] bool isFinite() const;
+      [[nodiscard]] bool hasPassed() const;
+      [[nodiscard]] double getRemainingSeconds() const;
+
+      /** earlier deadline after the given fraction of the remaining time */
+      [[nodiscard]] Deadline getFraction(double Fraction) const;
+
+  private:
+    using TimestampType = std::chrono::steady_clock::time_point;
+    TimestampType End_;
+    bool IsFinite_;
+  };
+
 
 }
 
@@ -0,0 +1,73 @@
+/***************************************************************************
+ * libRSF - A Robust Sensor Fusion Library
+ *
+ * Copyright (C) 2018 Chair of Automation Technology / TU Chemnitz
+ * For more information see https://www.tu-chemnitz.de/etit/proaut/libRSF
+ *
+ * libRSF is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libRSF is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with libRSF.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Tim Pfeifer (tim.pfeifer@etit.tu-chemnitz.de)
+ ***************************************************************************/
+
+/**
+ * @file Tracing.h
+ * @author Tim Pfeifer
+ * @date 14.10.2026
+ * @brief Scoped tracing of nested processing steps with export to the Chrome trace format.
+ * @copyright GNU Public License.
+ *
+ */
+
+#ifndef TRACING_H
+#define TRACING_H
+
+#include <cstdint>
+#include <string>
+
+/** spans are only recorded if LIBRSF_TRACING is defined, otherwise the macro vanishes */
+#ifdef LIBRSF_TRACING
+  #define LIBRSF_TRACE_CONCAT_(A, B) A##B
+  #define LIBRSF_TRACE_VARIABLE_(Line) LIBRSF_TRACE_CONCAT_(TraceScope_, Line)
+  #define LIBRSF_TRACE_SCOPE(Name) const libRSF::TraceScope LIBRSF_TRACE_VARIABLE_(__LINE__)(Name)
+#else
+  #define LIBRSF_TRACE_SCOPE(Name) static_cast<void>(0)
+#endif
+
+namespace libRSF
+{
+  /** records the lifetime of an object as span, the name has to be a string literal
+   *  with LIBRSF_ALLOCATION_TRACKING, the heap allocations during the span are recorded as well */
+  class TraceScope
+  {
+    public:
+      explicit TraceScope(const char* Name);
+      ~TraceScope();
+
+      TraceScope(const TraceScope&) = delete;
+      TraceScope& operator=(const TraceScope&) = delete;
+
+    private:
+      const char* Name_;
+      long long Begin_;
+      std::uint64_t Allocations_;
+  };
+
+  /** export all recorded spans as Chrome trace JSON, which can be opened with Perfetto or chrome://tracing */
+  bool WriteTraceToFile(const std::string &Filename);
+
+  /** drop all recorded spans, must not be called while other threads are recording */
+  void ClearTrace();
+}
+
+#endif // TRACING_H
@@ -0,0 +1,97 @@
+/***************************************************************************
+ * libRSF - A Robust Sensor Fusion Library
+ *
+ * Copyright (C) 2018 Chair of Automation Technology / TU Chemnitz
+ * For more information see https://www.tu-chemnitz.de/etit/proaut/libRSF
+ *
+ * libRSF is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libRSF is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with libRSF.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Tim Pfeifer (tim.pfeifer@etit.tu-chemnitz.de)
+ ***************************************************************************/
+
+/**
+ * @file TrackManager.h
+ * @author Tim Pfeifer
+ * @date 14.10.2026
+ * @brief Slot based life cycle of tracks with births and deaths applied once per frame.
+ * @copyright GNU Public License.
+ *
+ */
+
+#ifndef TRACKMANAGER_H
+#define TRACKMANAGER_H
+
+#include "FactorGraph.h"
+
+#include <string>
+#include <vector>
+
+namespace libRSF
+{
+  /** \brief Recycles the state names of short-lived tracks and changes the graph only once per frame.
+   *
+   * Each track occupies a slot, which owns one state name per state type, e.g. "Object3_0" for the
+   * position and "Object3_1" for the velocity of slot 3. Slots of dead tracks are handed to new ones,
+   * so the number of registered state keys is bounded by the maximal number of concurrent tracks.
+   * spawn() and kill() are only queued. update() removes all states of dead tracks with one
+   * structural update of the graph and adds one state per type for every live track. The cost
+   * functions of the removed factors are recycled by the FactorPool of the graph.
+   */
+  class TrackManager
+  {
+    public:
+      TrackManager(FactorGraph &Graph, std::string Prefix, std::vector<DataType> StateTypes);
+      ~TrackManager() = default;
+
+      /** queue a new track and return its slot, the states are added with the next update() */
+      int spawn();
+
+      /** queue the removal of a track with all of its states and connected factors */
+      void kill(int Slot);
+
+      /** apply the queued births and deaths and add the states of all live tracks at Time,
+       *  returns the number of removed states */
+      int update(double Time);
+
+      /** states of a track at one timestamp, in the order of the state types */
+      [[nodiscard]] StateList getStates(int Slot, double Time) const;
+      [[nodiscard]] const StateKey &getKey(int Slot, int TypeIndex = 0) const;
+
+      /** slots of the live tracks in increasing order, valid after update() */
+      [[nodiscard]] const std::vector<int> &getTracks() const;
+
+      [[nodiscard]] bool isAlive(int Slot) const;
+      [[nodiscard]] int countSlots() const;
+
+    private:
+      struct TrackSlot
+      {
+        std::vector<StateKey> Keys;
+        bool Alive = false;
+      };
+
+      [[nodiscard]] bool checkSlot_(int Slot) const;
+
+      FactorGraph &Graph_;
+      std::string Prefix_;
+      std::vector<DataType> StateTypes_;
+
+      std::vector<TrackSlot> Slots_;
+      std::vector<int> Free_;   /**< slots without states, reused last in first out */
+      std::vector<int> Dead_;   /**< killed since the last update */
+      std::vector<int> Tracks_;
+  };
+}
+
+#endif // TRACKMANAGER_H
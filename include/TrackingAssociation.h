@@ -0,0 +1,104 @@
+/***************************************************************************
+ * libRSF - A Robust Sensor Fusion Library
+ *
+ * Copyright (C) 2018 Chair of Automation Technology / TU Chemnitz
+ * For more information see https://www.tu-chemnitz.de/etit/proaut/libRSF
+ *
+ * libRSF is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libRSF is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with libRSF.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Tim Pfeifer (tim.pfeifer@etit.tu-chemnitz.de)
+ ***************************************************************************/
+
+/**
+ * @file TrackingAssociation.h
+ * @author Tim Pfeifer
+ * @date 14.10.2026
+ * @brief Gated global assignment of detections to tracks.
+ * @copyright GNU Public License.
+ *
+ */
+
+#ifndef TRACKINGASSOCIATION_H
+#define TRACKINGASSOCIATION_H
+
+#include "FactorGraph.h"
+
+#include <vector>
+
+namespace libRSF
+{
+  /** \brief Associates all detections of one frame with the tracks at once.
+   *
+   * A detection is a candidate for a track if the squared Mahalanobis distance of their positions,
+   * with the sum of the track covariance (e.g. from computeCovariance()) and the detection covariance,
+   * is below the gate. The assignment with the minimal total distance is found with the Hungarian
+   * algorithm, where leaving a track unassigned costs as much as the gate.
+   */
+  class TrackingAssociation
+  {
+    public:
+      /** squared Mahalanobis gate, the default is the 99 % quantile of the chi-squared distribution with 3 DOF */
+      explicit TrackingAssociation(double Gate = 11.345);
+      ~TrackingAssociation() = default;
+
+      /** detection index of each track or -1, the first three mean values of tracks and detections are the position */
+      bool associate(StateDataSet &States,
+                     const std::vector<StateID> &Tracks,
+                     const std::vector<Data> &Detections,
+                     std::vector<int> &Assignment) const;
+
+      /** associate and add one detection factor per assigned track, the first state of each list is its position,
+       *  returns the number of added factors */
+      template <FactorType DetectionType, typename ErrorType>
+      int addFactors(FactorGraph &Graph,
+                     const std::vector<StateList> &Tracks,
+                     const std::vector<Data> &Detections,
+                     ErrorType &NoiseModel) const
+      {
+        std::vector<StateID> Positions;
+        Positions.reserve(Tracks.size());
+        for (const StateList &Track : Tracks)
+        {
+          Positions.push_back(Track.List_.front());
+        }
+
+        std::vector<int> Assignment;
+        if (!this->associate(Graph.getStateData(), Positions, Detections, Assignment))
+        {
+          return 0;
+        }
+
+        int Added = 0;
+        for (size_t nTrack = 0; nTrack < Tracks.size(); ++nTrack)
+        {
+          if (Assignment.at(nTrack) >= 0)
+          {
+            Graph.addFactor<DetectionType>(Tracks.at(nTrack), Detections.at(Assignment.at(nTrack)), NoiseModel);
+            Added++;
+          }
+        }
+        return Added;
+      }
+
+      [[nodiscard]] double getGate() const;
+
+    private:
+      double Gate_;
+  };
+
+  /** minimal cost assignment of each row to a different column with the Hungarian algorithm, requires rows <= cols */
+  void SolveAssignment(const Matrix &Cost, std::vector<int> &RowToCol);
+}
+
+#endif // TRACKINGASSOCIATION_H
@@ -0,0 +1,133 @@
+/***************************************************************************
+ * libRSF - A Robust Sensor Fusion Library
+ *
+ * Copyright (C) 2018 Chair of Automation Technology / TU Chemnitz
+ * For more information see https://www.tu-chemnitz.de/etit/proaut/libRSF
+ *
+ * libRSF is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libRSF is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with libRSF.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Tim Pfeifer (tim.pfeifer@etit.tu-chemnitz.de)
+ ***************************************************************************/
+
+/**
+ * @file TrackingRepulsion.h
+ * @author Tim Pfeifer
+ * @date 14.10.2026
+ * @brief Repelling factors between nearby tracked objects, paired with a uniform grid.
+ * @copyright GNU Public License.
+ *
+ */
+
+#ifndef TRACKINGREPULSION_H
+#define TRACKINGREPULSION_H
+
+#include "FactorGraph.h"
+
+#include <algorithm>
+#include <map>
+#include <utility>
+#include <vector>
+
+namespace libRSF
+{
+  /** \brief Maintains repelling factors only between objects that are closer than a radius.
+   *
+   * The 1/d² repulsion is negligible for distant objects, so instead of connecting all pairs,
+   * the objects of one timestamp are sorted into a uniform grid with the radius as cell size
+   * and only neighbouring cells are compared. Repeated updates of the same timestamp keep the
+   * factors of pairs that are still close, remove the others and add the new ones.
+   */
+  class TrackingRepulsion
+  {
+    public:
+      TrackingRepulsion(FactorGraph &Graph, double Radius);
+      ~TrackingRepulsion() = default;
+
+      /** pair the 3D positions of one timestamp, all repelling factors at this timestamp have to be created by this helper */
+      template <typename ErrorType>
+      void update(const std::vector<StateID> &Objects, ErrorType &NoiseModel)
+      {
+        if (Objects.empty())
+        {
+          return;
+        }
+        const TimeTick Tick = Objects.front().Tick;
+        const double Timestamp = Objects.front().getTimestamp();
+
+        std::vector<std::pair<int, int>> Close;
+        if (!this->findPairs_(Objects, Close))
+        {
+          return;
+        }
+
+        std::vector<ObjectPair> Wanted;
+        Wanted.reserve(Close.size());
+        for (const auto &Pair : Close)
+        {
+          Wanted.emplace_back(MakePair_(Objects.at(Pair.first), Objects.at(Pair.second)));
+        }
+        std::sort(Wanted.begin(), Wanted.end());
+
+        /** the list follows the factor numbers, removing from the back keeps the numbers of the unprocessed ones valid */
+        std::vector<ObjectPair> &Existing = Pairs_[Tick];
+        for (int n = static_cast<int>(Existing.size()) - 1; n >= 0; n--)
+        {
+          if (!std::binary_search(Wanted.begin(), Wanted.end(), Existing.at(n)))
+          {
+            Graph_.removeFactor(FactorType::Repelling, Timestamp, n);
+            Existing.erase(Existing.begin() + n);
+          }
+        }
+
+        /** add the pairs that came into the radius */
+        std::vector<ObjectPair> Kept = Existing;
+        std::sort(Kept.begin(), Kept.end());
+        for (size_t n = 0; n < Close.size(); ++n)
+        {
+          const StateID &Object1 = Objects.at(Close.at(n).first);
+          const StateID &Object2 = Objects.at(Close.at(n).second);
+          const ObjectPair Pair = MakePair_(Object1, Object2);
+          if (!std::binary_search(Kept.begin(), Kept.end(), Pair))
+          {
+            Graph_.addFactor<FactorType::Repelling>(Object1, Object2, NoiseModel);
+            Existing.push_back(Pair);
+          }
+        }
+      }
+
+      /** forget the pairing of timestamps that were removed from the graph */
+      void removeBefore(double Time);
+
+      [[nodiscard]] int countPairs(double Timestamp) const;
+      [[nodiscard]] double getRadius() const;
+
+    private:
+      /** state name and number of both objects, the smaller one first */
+      using ObjectKey = std::pair<int, int>;
+      using ObjectPair = std::pair<ObjectKey, ObjectKey>;
+
+      static ObjectPair MakePair_(const StateID &Object1, const StateID &Object2);
+
+      /** indices of all objects within the radius */
+      bool findPairs_(const std::vector<StateID> &Objects, std::vector<std::pair<int, int>> &Pairs) const;
+
+      FactorGraph &Graph_;
+      double Radius_;
+
+      /** pairs of each timestamp in the order of their factor numbers */
+      std::map<TimeTick, std::vector<ObjectPair>> Pairs_;
+  };
+}
+
+#endif // TRACKINGREPULSION_H
@@ -51,7 +51,7 @@ namespace libRSF
   enum class FactorType
   {
     ConstVal1, ConstVal2, ConstVal3,
-    ConstDrift1, ConstDrift2, ConstDrift3,
+    ConstDrift1, ConstDrift2, ConstDrift3, ConstDriftClock,
     ConstQuaternion,
     BetweenValue1, BetweenValue2, BetweenValue3,
     Loop1, Loop2, Loop3,
@@ -60,7 +60,9 @@ namespace libRSF
     BetweenBearingRange2,
     Point2Reg,
     Point2RegPose,
-    Range2, Range3, Pseudorange2, Pseudorange3, Pseudorange3_ECEF, Pseudorange3_Bias,
+    Point2Reg_Scan,
+    Range2, Range3, Pseudorange2, Pseudorange3, Pseudorange3_ECEF, Pseudorange3_Bias, Pseudorange3_Epoch,
+    Pseudorange3_Clock, Pseudorange3_ECEF_Clock,
     RangeToPoint2,RangeToPoint3,
     Odom2, Odom2Diff, Odom4, Odom4_ECEF, Odom6,
     Prior1, Prior2, Prior3, Prior4, Prior9, PriorQuat, PriorAngle,
@@ -71,7 +73,8 @@ namespace libRSF
     TrackingDetectionDim, TrackingDetectionRot, TrackingDetectionVel,
     TrackingDetectionDimRot, TrackingDetectionVelDim, TrackingDetectionVelRot,
     TrackingDetectionVelDimRot,
-    Marginal
+    BSplineRange3, BSplinePose3,
+    Marginal, StatePrior
   };
 
   /** more general classification */
@@ -92,6 +95,7 @@ namespace libRSF
     PointConfID2,                                         /**< Point with ID and confidence */
     BoundingBox3,                                         /**< bounding boxes from object detection */
     ClockError, ClockDrift,                               /**< GNSS receiver clock error */
+    Clock,                                                /**< GNSS receiver clock [error, drift] */
     IMUBias,                                              /**< IMU Speedbias [Vel, B_Acc, B_Gyr] */
     GMM1, GMM2, Switch, Covariance1, Covariance2,         /**< dynamic error models */
     Range2, Range3,                                       /**< range to fixed point */
@@ -106,6 +110,7 @@ namespace libRSF
     AirPressure, AirPressureDiff,                         /**< barometric pressure */
     IMU,                                                  /**< IM [Acc, Gyr] */
     IterationSummary,                                     /**< timing of the optimizer */
+    SolverIteration,                                      /**< progress of one solver iteration */
     Error1, Error2, Error3, Error6,                       /**< residuals of cost functions */
     Cost, CostGradient1, CostGradient2, CostGradient3,    /**< cost of the optimizer */
     Value1,                                               /**< generic vector */
@@ -121,7 +126,10 @@ namespace libRSF
                            Other,
                            ID, BoxConf, Idx, BoxWLH, BoxAngle, BoxQuat, BoxClass, Key,
                            DurationSolver, DurationCovariance, DurationMarginal, DurationAdaptive, DurationTotal,
-                           IterationSolver, IterationAdaptive};
+                           IterationSolver, IterationAdaptive, DeadlineMisses,
+                           MemoryUsage, Allocations, WindowLength,
+                           StepNorm, TrustRegionRadius, StepSuccessful,
+                           DurationLinearSolver, DurationEvaluation, IterationLinearSolver};
 
   /** store the configuration of each data type in a global variable */
   using DataTypeConfig = DataConfig<DataType, DataElement>;
@@ -144,10 +152,16 @@ namespace libRSF
     {FactorType::BetweenPose2, DataType::Pose2},
     {FactorType::BetweenPose3, DataType::Pose3},
     {FactorType::Point2Reg, DataType::Point2Set},
+    {FactorType::Point2Reg_Scan, DataType::Point2Set},
     {FactorType::Pseudorange2, DataType::Pseudorange2},
     {FactorType::Pseudorange3, DataType::Pseudorange3},
     {FactorType::Pseudorange3_Bias, DataType::Pseudorange3},
     {FactorType::Pseudorange3_ECEF, DataType::Pseudorange3},
+    {FactorType::Pseudorange3_Epoch, DataType::Pseudorange3},
+    {FactorType::Pseudorange3_Clock, DataType::Pseudorange3},
+    {FactorType::Pseudorange3_ECEF_Clock, DataType::Pseudorange3},
+    {FactorType::BSplineRange3, DataType::Range3},
+    {FactorType::BSplinePose3, DataType::Pose3},
     {FactorType::IMUPretintegration, DataType::IMU},
     {FactorType::IMUSimple, DataType::IMU},
     {FactorType::Odom2, DataType::Odom2},
@@ -169,6 +183,7 @@ namespace libRSF
     {"const_drift1",FactorType::ConstDrift1},
     {"const_drift2",FactorType::ConstDrift2},
     {"const_drift3",FactorType::ConstDrift3},
+    {"const_drift_clock",FactorType::ConstDriftClock},
     {"const_quat",FactorType::ConstQuaternion},
     {"between_val1",FactorType::BetweenValue1},
     {"between_val2",FactorType::BetweenValue2},
@@ -185,6 +200,9 @@ namespace libRSF
     {"pseudorange3",FactorType::Pseudorange3},
     {"pseudorange3_bias",FactorType::Pseudorange3_Bias},
     {"pseudorange3_ecef",FactorType::Pseudorange3_ECEF},
+    {"pseudorange3_epoch",FactorType::Pseudorange3_Epoch},
+    {"pseudorange3_clock",FactorType::Pseudorange3_Clock},
+    {"pseudorange3_ecef_clock",FactorType::Pseudorange3_ECEF_Clock},
     {"odom2",FactorType::Odom2},
     {"odom2diff",FactorType::Odom2Diff},
     {"odom4_ecef",FactorType::Odom4_ECEF},
@@ -202,12 +220,16 @@ namespace libRSF
     {"repelling",FactorType::Repelling},
     {"tracking_detection",FactorType::TrackingDetection},
     {"marginal",FactorType::Marginal},
+    {"state_prior",FactorType::StatePrior},
     {"point2_reg",FactorType::Point2Reg},
+    {"point2_reg_scan",FactorType::Point2Reg_Scan},
     {"pressure_diff2",FactorType::PressureDiff2},
     {"pressure_diff3",FactorType::PressureDiff3},
     {"loop1",FactorType::Loop1},
     {"loop2",FactorType::Loop2},
-    {"loop3",FactorType::Loop3}
+    {"loop3",FactorType::Loop3},
+    {"bspline_range3",FactorType::BSplineRange3},
+    {"bspline_pose3",FactorType::BSplinePose3}
   };
 
   const std::map<std::string, AbstractFactorType> AbstractFactorTypeDict =
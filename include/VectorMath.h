@@ -35,9 +35,12 @@
 #include "VectorTypes.h"
 
 #include <Eigen/Eigenvalues>
+#include <Eigen/Cholesky>
 #include <ceres/ceres.h>
 
 #include <algorithm>
+#include <cmath>
+#include <limits>
 
 namespace libRSF
 {
@@ -74,6 +77,30 @@ namespace libRSF
     return SAES.eigenvectors() * EigValInv.cwiseSqrt().asDiagonal() * SAES.eigenvectors().transpose();
   }
 
+  /** inverse square root R = L^-1 from one Cholesky factorization A = L*L^T, so R^T*R = A^-1 holds for the triangular R,
+   *  the log-determinant of R is a by-product, fails for indefinite or ill-conditioned matrices */
+  template <int Dim, typename T>
+  bool InverseSquareRootCholesky(const MatrixT<T, Dim, Dim> &A, MatrixT<T, Dim, Dim> &InvSqrt, T &LogDeterminant)
+  {
+    const Eigen::LLT<MatrixT<T, Dim, Dim>> LLT(A);
+    if (LLT.info() != Eigen::Success)
+    {
+      return false;
+    }
+
+    /** the squared diagonal of L bounds the eigen values, the eigen decomposition is more robust below this ratio */
+    const VectorT<T, Dim> Diagonal = LLT.matrixLLT().diagonal();
+    const T Tolerance = std::sqrt(std::numeric_limits<T>::epsilon()) * A.cols() * Diagonal.array().square().maxCoeff();
+    if (!(Diagonal.array().square().minCoeff() > Tolerance))
+    {
+      return false;
+    }
+
+    InvSqrt = LLT.matrixL().solve(MatrixT<T, Dim, Dim>::Identity(A.rows(), A.cols()));
+    LogDeterminant = -Diagonal.array().log().sum();
+    return true;
+  }
+
   template <int Dim, typename T>
   MatrixT<T, Dim, Dim> Inverse(MatrixT<T, Dim, Dim> A)
   {
@@ -137,6 +164,7 @@ namespace libRSF
   void RemoveColumn (Matrix& Matrix, int ColToRemove);
 
   void CRSToMatrix(const ceres::CRSMatrix &CRSMat, Matrix &Mat);
+  void CRSToSparseMatrix(const ceres::CRSMatrix &CRSMat, SparseMatrix &Mat);
 }
 
 #endif // VECTORMATH_H
@@ -33,6 +33,7 @@
 #define VECTORTYPES_H
 
 #include <Eigen/Dense>
+#include <Eigen/SparseCore>
 #include <Eigen/StdVector>
 
 namespace libRSF
@@ -91,6 +92,9 @@ namespace libRSF
   using Matrix2X = MatrixStatic<2, Dynamic>;
   using Matrix3X = MatrixStatic<3, Dynamic>;
 
+  /** sparse matrix (column major for the sparse solvers) */
+  using SparseMatrix = Eigen::SparseMatrix<double, Eigen::ColMajor>;
+
   /** reference wrappers */
   template <typename T, int Row, int Col>
   using MatrixRef = Eigen::Map<MatrixT<T, Row, Col>>;
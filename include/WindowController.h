@@ -0,0 +1,72 @@
+/***************************************************************************
+ * libRSF - A Robust Sensor Fusion Library
+ *
+ * Copyright (C) 2018 Chair of Automation Technology / TU Chemnitz
+ * For more information see https://www.tu-chemnitz.de/etit/proaut/libRSF
+ *
+ * libRSF is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libRSF is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with libRSF.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Tim Pfeifer (tim.pfeifer@etit.tu-chemnitz.de)
+ ***************************************************************************/
+
+/**
+ * @file WindowController.h
+ * @author Tim Pfeifer
+ * @date 14.10.2026
+ * @brief Adapts the length of a sliding window to the measured processing time.
+ * @copyright GNU Public License.
+ *
+ */
+
+#ifndef WINDOWCONTROLLER_H
+#define WINDOWCONTROLLER_H
+
+#include "FactorGraphConfig.h"
+
+namespace libRSF
+{
+  /** \brief Keeps the processing time of one epoch below a target by scaling the window length.
+   *
+   * The processing time grows roughly linear with the window length, so the length is scaled
+   * with the ratio of the target and the smoothed processing time. Small deviations are ignored
+   * and the step per epoch is limited, so single outliers do not let the window oscillate.
+   */
+  class WindowController
+  {
+    public:
+      WindowController(double Length, double MinLength, double MaxLength, double TargetTime);
+
+      /** active if the config enables the adaptive window, uses MaxTime as target */
+      explicit WindowController(const FactorGraphConfig &Config);
+      ~WindowController() = default;
+
+      /** feed the processing time of the last epoch, returns the window length for the next one */
+      double update(double Duration);
+
+      [[nodiscard]] double getLength() const;
+      [[nodiscard]] bool isActive() const;
+
+    private:
+      double Length_;
+      double MinLength_;
+      double MaxLength_;
+      double TargetTime_;
+      bool IsActive_;
+
+      /** exponentially smoothed processing time, negative before the first update */
+      double Duration_ = -1.0;
+  };
+}
+
+#endif // WINDOWCONTROLLER_H
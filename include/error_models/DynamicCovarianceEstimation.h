@@ -50,7 +50,7 @@ namespace libRSF
       template <typename T>
       bool weight(const VectorT<T, Dim> &RawError, const T* const Covariance, T* Error) const
       {
-        if (this->Enable_)
+        if (this->isEnabled())
         {
           /** map error to matrix */
           VectorRef <T, Dim+1> ErrorMap(Error);
@@ -77,6 +77,17 @@ namespace libRSF
         return true;
       }
 
+      /** checkpoint interface */
+      void serialize(CheckpointWriter &Writer) const
+      {
+        Writer.write(LogSqrtDetCovMin_);
+      }
+
+      bool deserialize(CheckpointReader &Reader)
+      {
+        return Reader.read(LogSqrtDetCovMin_);
+      }
+
     private:
       double LogSqrtDetCovMin_ = 1.0;
   };
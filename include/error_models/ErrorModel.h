@@ -32,6 +32,9 @@
 #ifndef ERRORMODEL_H
 #define ERRORMODEL_H
 
+#include "../Checkpoint.h"
+
+#include <atomic>
 #include <utility> /**< for integer_sequence */
 
 namespace libRSF
@@ -52,8 +55,43 @@ namespace libRSF
         Enable_ = false;
       }
 
+      [[nodiscard]] bool isEnabled() const
+      {
+        return Enable_ && !RawEvaluation_ && (Group_ == nullptr || Group_->load(std::memory_order_relaxed));
+      }
+
+      /** connect to a flag that is shared by all models of one factor type, so that they are toggled at once */
+      void setGroup(const std::atomic<bool>* Group)
+      {
+        Group_ = Group;
+      }
+
+      /** disables all error models for the calling thread as long as it exists, other threads are not affected */
+      class RawEvaluationScope
+      {
+        public:
+          RawEvaluationScope() : Previous_(RawEvaluation_)
+          {
+            RawEvaluation_ = true;
+          }
+          ~RawEvaluationScope()
+          {
+            RawEvaluation_ = Previous_;
+          }
+
+          RawEvaluationScope(const RawEvaluationScope &) = delete;
+          RawEvaluationScope &operator=(const RawEvaluationScope &) = delete;
+
+        private:
+          const bool Previous_;
+      };
+
     protected:
       bool Enable_ = true;
+
+    private:
+      const std::atomic<bool>* Group_ = nullptr;
+      static inline thread_local bool RawEvaluation_ = false;
   };
 
 
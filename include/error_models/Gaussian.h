@@ -72,7 +72,7 @@ namespace libRSF
         /** wrap raw pointer to vector*/
         VectorRef<T, Dim> ErrorMap(Error);
 
-        if(this->Enable_)
+        if(this->isEnabled())
         {
           /** scale with diagonal information matrix */
           ErrorMap = RawError.cwiseProduct(SqrtInformationDiagonal_.template cast<T>());
@@ -86,6 +86,17 @@ namespace libRSF
         return true;
       }
 
+      /** checkpoint interface */
+      void serialize(CheckpointWriter &Writer) const
+      {
+        Writer.writeMatrix(SqrtInformationDiagonal_);
+      }
+
+      bool deserialize(CheckpointReader &Reader)
+      {
+        return Reader.readMatrix(SqrtInformationDiagonal_);
+      }
+
   private:
     /** square root information is more efficient to apply than covariance */
     VectorStatic<Dim> SqrtInformationDiagonal_;
@@ -114,7 +125,7 @@ namespace libRSF
         /** wrap raw pointer to vector*/
         VectorRef<T, Dim> ErrorMap(Error);
 
-        if(this->Enable_)
+        if(this->isEnabled())
         {
           /** scale with full information matrix */
           ErrorMap = SqrtInformation_.template cast<T>() * RawError;
@@ -128,6 +139,17 @@ namespace libRSF
         return true;
       }
 
+      /** checkpoint interface */
+      void serialize(CheckpointWriter &Writer) const
+      {
+        Writer.writeMatrix(SqrtInformation_);
+      }
+
+      bool deserialize(CheckpointReader &Reader)
+      {
+        return Reader.readMatrix(SqrtInformation_);
+      }
+
   private:
       /** square root information is more efficient to apply than covariance */
       MatrixStatic<Dim, Dim> SqrtInformation_;
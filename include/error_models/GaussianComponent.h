@@ -36,6 +36,7 @@
 #include "../Messages.h"
 
 #include <cmath>
+#include <limits>
 #include <random>
 
 namespace libRSF
@@ -75,9 +76,7 @@ namespace libRSF
         Weight_ = Weight;
 
         /** use decomposition to get square root information matrix */
-        SqrtInformation_ = InverseSquareRoot(Covariance);
-
-        updateScaling_();
+        setCovariance_(Covariance);
       }
 
       void setParamsInformation(const MatrixStatic<Dim, Dim> &Information,
@@ -111,9 +110,7 @@ namespace libRSF
 
       void updateCovariance(const MatrixStatic<Dim, Dim> &Covariance)
       {
-        SqrtInformation_ = InverseSquareRoot(Covariance);
-
-        updateScaling_();
+        setCovariance_(Covariance);
       }
 
       [[nodiscard]] MatrixStatic<Dim, 1> getMean() const
@@ -175,11 +172,8 @@ namespace libRSF
         /** apply mean */
         ErrorMatType WeightedError = (Errors.array().colwise() + Mean_.array()).matrix();
 
-        /** multiply each row with square root information */
-        for (Index n = 0; n < WeightedError.cols(); ++n)
-        {
-          WeightedError.col(n) = (WeightedError.col(n).transpose() * SqrtInformation_).transpose();
-        }
+        /** multiply each column with square root information, which is not necessarily symmetric */
+        WeightedError = SqrtInformation_ * WeightedError;
 
         return ((WeightedError.array().square().colwise().sum() / -2.0).exp() * Scaling_).matrix();
       }
@@ -190,25 +184,37 @@ namespace libRSF
                                bool  EstimateMean)
       {
         const double LikelihoodSum = Likelihoods.sum();
+        const VectorStatic<Dim> MeanX = Errors * Likelihoods / LikelihoodSum;
+        this->estimateParameters(LikelihoodSum,
+                                 MeanX,
+                                 WeightedScatter_(Errors, Likelihoods, MeanX),
+                                 Likelihoods.rows(),
+                                 EstimateMean);
+      }
 
+      /** same, but based on the weighted statistics: Sum(w), the mean Sum(w*x)/Sum(w), the scatter Sum(w*(x-mean)*(x-mean)^T)
+       *  and a possibly effective (non-integer) sample size */
+      void estimateParameters (const double LikelihoodSum,
+                               const VectorStatic<Dim> &MeanX,
+                               const MatrixStatic<Dim, Dim> &ScatterX,
+                               const double SampleSize,
+                               bool  EstimateMean)
+      {
         /** estimate weight */
-        Weight_(0) = LikelihoodSum / static_cast<double>(Likelihoods.rows());
+        Weight_(0) = LikelihoodSum / SampleSize;
 
         /** estimate mean */
         if (EstimateMean)
         {
-           Mean_ = -((Errors.array().rowwise() * Likelihoods.transpose().array()).rowwise().sum() / LikelihoodSum).matrix();
+           Mean_ = -MeanX;
         }
 
-        /** estimate covariance */
-        MatrixStatic<Dim,Dim> Covariance = MatrixStatic<Dim,Dim>::Zero();
-        for (Index n = 0; n < Errors.cols(); ++n)
-        {
-          MatrixStatic<Dim, 1> Diff = Errors.col(n) + Mean_;
-          Covariance += Diff * Diff.transpose() * Likelihoods(n);
-        }
+        /** estimate covariance: Sum(w*(x+mu)*(x+mu)^T) / Sum(w), the scatter is already centered */
+        const VectorStatic<Dim> Offset = MeanX + Mean_;
+        MatrixStatic<Dim,Dim> Covariance = ScatterX + LikelihoodSum * Offset * Offset.transpose();
         Covariance.array() /= LikelihoodSum;
-        SqrtInformation_ = InverseSquareRoot(Covariance);
+        double LogDeterminant = 0.0;
+        bool KnownDeterminant = computeSqrtInformation_(Covariance, LogDeterminant);
 
         /** check for degenerated square root information matrix */
         if(SqrtInformation_.array().isFinite().all() == false)
@@ -217,6 +223,7 @@ namespace libRSF
           Weight_.setZero();
           Mean_.setZero();
           SqrtInformation_ = MatrixStatic<Dim, Dim>::Identity();
+          KnownDeterminant = false;
         }
 
         /** check for extreme numerical values */
@@ -227,9 +234,18 @@ namespace libRSF
           PRINT_WARNING("Limit Square root information to 1e10 for numerical reasons!");
           #endif
           SqrtInformation_ = (SqrtInformation_.array() < 1e10).select(SqrtInformation_, 1e10);
+          KnownDeterminant = false;
         }
 
-        updateScaling_();
+        if (KnownDeterminant)
+        {
+          /** the determinant is already known from the factorization */
+          Scaling_ = Weight_(0) * std::exp(LogDeterminant);
+        }
+        else
+        {
+          updateScaling_();
+        }
       }
 
       void estimateParametersMAP (const ErrorMatType &Errors,
@@ -241,6 +257,33 @@ namespace libRSF
                                   const MatrixStatic<Dim,Dim> &WishartScatterMatrix,
                                   const double WishartDOF,
                                   bool EstimateMean)
+      {
+        const double LikelihoodSum = Likelihoods.sum();
+        const VectorStatic<Dim> MeanX = Errors * Likelihoods / LikelihoodSum;
+        this->estimateParametersMAP(LikelihoodSum,
+                                    MeanX,
+                                    WeightedScatter_(Errors, Likelihoods, MeanX),
+                                    Likelihoods.rows(),
+                                    DirichletConcentration,
+                                    DirichletConcentrationSum,
+                                    NormalInfoScaling,
+                                    NormalMean,
+                                    WishartScatterMatrix,
+                                    WishartDOF,
+                                    EstimateMean);
+      }
+
+      void estimateParametersMAP (const double LikelihoodSum,
+                                  const VectorStatic<Dim> &MeanX,
+                                  const MatrixStatic<Dim, Dim> &ScatterX,
+                                  const double SampleSize,
+                                  const double DirichletConcentration,
+                                  const double DirichletConcentrationSum,
+                                  const double NormalInfoScaling,
+                                  const VectorStatic<Dim> &NormalMean,
+                                  const MatrixStatic<Dim,Dim> &WishartScatterMatrix,
+                                  const double WishartDOF,
+                                  bool EstimateMean)
       {
         /** Implementation based on:
         * Kevin Murphy
@@ -248,28 +291,20 @@ namespace libRSF
         * 2012
         */
 
-        /** pre-calculate shared values */
-        const double LikelihoodSum = Likelihoods.sum();
-
         /** estimate weight */
         Weight_(0) = std::max((LikelihoodSum + DirichletConcentration - 1.0)
                      /
-                     (DirichletConcentrationSum + static_cast<double>(Likelihoods.rows())), 0.0);
+                     (DirichletConcentrationSum + SampleSize), 0.0);
 
         /** estimate mean */
-        const VectorStatic<Dim> MeanML = (Errors.array().rowwise() * Likelihoods.transpose().array()).rowwise().sum() / LikelihoodSum;
+        const VectorStatic<Dim> &MeanML = MeanX;
         if (EstimateMean)
         {
           Mean_ = -(MeanML*LikelihoodSum + NormalMean*NormalInfoScaling) / (NormalInfoScaling + LikelihoodSum);
         }
 
-        /** estimate covariance */
-        MatrixStatic<Dim,Dim> ScatterML = MatrixStatic<Dim,Dim>::Zero();
-        for (Index n = 0; n < Errors.cols(); ++n)
-        {
-          const MatrixStatic<Dim, 1> Diff = Errors.col(n) - MeanML;
-          ScatterML += Diff * Diff.transpose() * Likelihoods(n);
-        }
+        /** estimate covariance: Sum(w*(x-mu)*(x-mu)^T) */
+        const MatrixStatic<Dim,Dim> &ScatterML = ScatterX;
 
         const MatrixStatic<Dim,Dim> DenominatorInfo = WishartScatterMatrix
                                                     + ScatterML
@@ -278,7 +313,13 @@ namespace libRSF
 
         const double EnumeratorInfo = WishartDOF + LikelihoodSum + Dim + 2;
 
-        SqrtInformation_ = SquareRoot<Dim,double>(EnumeratorInfo * Inverse<Dim,double>(DenominatorInfo));
+        /** the information is EnumeratorInfo * DenominatorInfo^-1, so the scaled denominator is the covariance */
+        const MatrixStatic<Dim,Dim> Covariance = DenominatorInfo / EnumeratorInfo;
+        double LogDeterminant = 0.0;
+        if (!InverseSquareRootCholesky<Dim, double>(Covariance, SqrtInformation_, LogDeterminant))
+        {
+          SqrtInformation_ = SquareRoot<Dim,double>(EnumeratorInfo * Inverse<Dim,double>(DenominatorInfo));
+        }
 
         /** check for degenerated square root information matrix */
         if(SqrtInformation_.array().isFinite().all() == false)
@@ -306,11 +347,8 @@ namespace libRSF
           WeightedError = (Errors.array().colwise() - Mean_.array()).matrix();
         }
 
-        /** multiply each row with square root information */
-        for (int n = 0; n < WeightedError.cols(); ++n)
-        {
-          WeightedError.col(n) = (WeightedError.col(n).transpose() * SqrtInformation_).transpose();
-        }
+        /** multiply each column with square root information, which is not necessarily symmetric */
+        WeightedError = SqrtInformation_ * WeightedError;
 
         return ((WeightedError.array().square().colwise().sum() / 2.0) - log(Scaling_)).matrix();
       }
@@ -351,7 +389,8 @@ namespace libRSF
         }
         else
         {
-          if(IsPositiveSemidefinite<Dim>(SqrtInformation_) == false)
+          /** the square root may be triangular, so its product is tested */
+          if(IsPositiveSemidefinite<Dim>(SqrtInformation_.transpose() * SqrtInformation_) == false)
           {
             PRINT_WARNING("Square root information is not positive semi-definite!");
             Passed = false;
@@ -404,6 +443,32 @@ namespace libRSF
       }
 
     private:
+      /** Cholesky for well-conditioned covariances (triangular result), eigen decomposition otherwise (symmetric result),
+       *  returns true if the log-determinant of the result was computed by the factorization */
+      bool computeSqrtInformation_(const MatrixStatic<Dim, Dim> &Covariance, double &LogDeterminant)
+      {
+        if (InverseSquareRootCholesky<Dim, double>(Covariance, SqrtInformation_, LogDeterminant))
+        {
+          return true;
+        }
+
+        SqrtInformation_ = InverseSquareRoot(Covariance);
+        return false;
+      }
+
+      void setCovariance_(const MatrixStatic<Dim, Dim> &Covariance)
+      {
+        double LogDeterminant = 0.0;
+        if (computeSqrtInformation_(Covariance, LogDeterminant))
+        {
+          Scaling_ = Weight_(0) * std::exp(LogDeterminant);
+        }
+        else
+        {
+          updateScaling_();
+        }
+      }
+
       void updateScaling_()
       {
         Scaling_ = calculateNormalization_();
@@ -414,6 +479,18 @@ namespace libRSF
         return Weight_(0, 0) * SqrtInformation_.determinant();
       }
 
+      /** Sum(w*(x-mean)*(x-mean)^T) with a known mean, so no large terms cancel */
+      static MatrixStatic<Dim, Dim> WeightedScatter_(const ErrorMatType &Errors, const Vector &Likelihoods, const VectorStatic<Dim> &MeanX)
+      {
+        MatrixStatic<Dim, Dim> Scatter = MatrixStatic<Dim, Dim>::Zero();
+        for (Index n = 0; n < Errors.cols(); ++n)
+        {
+          const VectorStatic<Dim> Diff = Errors.col(n) - MeanX;
+          Scatter += Diff * Diff.transpose() * Likelihoods(n);
+        }
+        return Scatter;
+      }
+
       MatrixStatic<Dim, 1> Mean_;
       MatrixStatic<1, 1> Weight_;
       MatrixStatic<Dim, Dim> SqrtInformation_;
@@ -453,19 +530,34 @@ namespace libRSF
            (b.getWeight()(0) * b.getSqrtInformation().determinant() / (std::abs(b.getMean().sum()) + 1e-6));
   }
 
-  /** Bhattacharyya distance for merging */
+  /** Bhattacharyya distance for merging, with precomputed covariances and their determinants,
+   *  both terms are positive, so the mean term alone is returned if it already exceeds the bound */
   template <int Dim>
-  double CalculateBhattacharyyaDistance(const GaussianComponent<Dim> & Gaussian1, const GaussianComponent<Dim> & Gaussian2)
+  double CalculateBhattacharyyaDistance(const MatrixStatic<Dim, 1> &Mean1, const MatrixStatic<Dim, Dim> &Cov1, const double Det1,
+                                        const MatrixStatic<Dim, 1> &Mean2, const MatrixStatic<Dim, Dim> &Cov2, const double Det2,
+                                        const double Bound = std::numeric_limits<double>::infinity())
   {
-    MatrixStatic<Dim, Dim> Cov1 = Gaussian1.getCovariance();
-    MatrixStatic<Dim, Dim> Cov2 = Gaussian2.getCovariance();
     MatrixStatic<Dim, Dim> CovMean = (Cov1 + Cov2).array() / 2.0;
 
-    MatrixStatic<Dim, 1> MeanDiff = Gaussian1.getMean() - Gaussian2.getMean();
+    MatrixStatic<Dim, 1> MeanDiff = Mean1 - Mean2;
 
     MatrixStatic<1, 1> Mahala = 0.125 * MeanDiff.transpose() * CovMean.inverse() * MeanDiff;
+    if (Mahala(0) >= Bound)
+    {
+      return Mahala(0);
+    }
+
+    return Mahala(0) + 0.5 * log(CovMean.determinant() / sqrt(Det1 * Det2));
+  }
+
+  template <int Dim>
+  double CalculateBhattacharyyaDistance(const GaussianComponent<Dim> & Gaussian1, const GaussianComponent<Dim> & Gaussian2)
+  {
+    const MatrixStatic<Dim, Dim> Cov1 = Gaussian1.getCovariance();
+    const MatrixStatic<Dim, Dim> Cov2 = Gaussian2.getCovariance();
 
-    return Mahala(0) + 0.5 * log(CovMean.determinant() / sqrt(Cov1.determinant()*Cov2.determinant()));
+    return CalculateBhattacharyyaDistance<Dim>(Gaussian1.getMean(), Cov1, Cov1.determinant(),
+                                               Gaussian2.getMean(), Cov2, Cov2.determinant());
   }
 
   /** merge two Gaussians */
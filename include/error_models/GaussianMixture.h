@@ -33,16 +33,23 @@
 #define GAUSSIANMIXTURE_H
 
 #include "GaussianComponent.h"
+#include "../Checkpoint.h"
 #include "../Data.h"
 #include "../Misc.h"
 #include "../Messages.h"
 #include "../Statistics.h"
+#include "../ThreadPool.h"
 #include "../FactorGraphConfig.h"
 
 #include <Eigen/Dense>
 #include <unsupported/Eigen/SpecialFunctions>
 
 #include <algorithm>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <random>
+#include <vector>
 
 namespace libRSF
 {
@@ -87,6 +94,82 @@ namespace libRSF
         /** check the Bhattacharyya distance between all components to merge similar ones */
         bool MergeSimilarComponents = false;
         double MergingThreshold = 0.1;
+
+        /** threads for the E- and M-step, <= 0 uses all cores (the result does not depend on it) */
+        int ThreadNumber = 1;
+
+        /** decay of the accumulated statistics per online update, 1 keeps the whole history */
+        double ForgettingFactor = 1.0;
+
+        /** estimate on an importance-weighted coreset of this size if there are more samples, zero disables it */
+        Index CoresetSize = 0;
+
+        /** SQUAREM extrapolation for EM and EM_MAP, one iteration then consists of three EM steps */
+        bool AccelerateEM = false;
+
+        /** evaluate the Mahalanobis distances of the EM E-step in single precision (Dim <= 3),
+         *  the responsibilities and sufficient statistics are still accumulated in double */
+        bool SinglePrecisionEStep = false;
+      };
+
+      /** provides the samples [Start, Start + Length) block-wise, so they don't have to be in memory at once,
+       *  it is called sequentially with increasing starts and once more for every iteration */
+      using SampleSource = std::function<void(Index Start, Index Length, ErrorMatType &Samples)>;
+
+      /** streamed samples with optional importance weights, the sum of the weights replaces the sample count */
+      struct SampleStream
+      {
+        SampleSource Source;
+        Index Number = 0;
+        Vector Weights; /**< empty if all samples count once */
+
+        [[nodiscard]] double size() const
+        {
+          return (Weights.size() > 0) ? Weights.sum() : static_cast<double>(Number);
+        }
+      };
+
+      /** weighted statistics of one component, the scatter is accumulated around the running mean, so large offsets do not cancel */
+      struct SufficientStatistics
+      {
+        double Sum = 0.0;
+        VectorStatic<Dim> Mean = VectorStatic<Dim>::Zero();
+        MatrixStatic<Dim, Dim> Scatter = MatrixStatic<Dim, Dim>::Zero();
+
+        /** weighted Welford update with one sample */
+        void add(const VectorStatic<Dim> &X, const double W)
+        {
+          if (W <= 0.0)
+          {
+            return;
+          }
+          const double SumOld = Sum;
+          Sum += W;
+          const VectorStatic<Dim> Diff = X - Mean;
+          Mean += Diff * (W / Sum);
+          Scatter += Diff * Diff.transpose() * (W * SumOld / Sum);
+        }
+
+        /** down-weight all samples by the same factor, the mean is unchanged */
+        void scale(const double Factor)
+        {
+          Sum *= Factor;
+          Scatter *= Factor;
+        }
+
+        /** merge with the statistics of other samples (Chan et al.) */
+        void add(const SufficientStatistics &Other)
+        {
+          if (Other.Sum <= 0.0)
+          {
+            return;
+          }
+          const double SumOld = Sum;
+          Sum += Other.Sum;
+          const VectorStatic<Dim> Diff = Other.Mean - Mean;
+          Mean += Diff * (Other.Sum / Sum);
+          Scatter += Other.Scatter + Diff * Diff.transpose() * (SumOld * Other.Sum / Sum);
+        }
       };
 
       /** Bayesian representation of the parameter estimation problem */
@@ -102,7 +185,8 @@ namespace libRSF
         std::vector<double> NuInfo;
         MatrixVectorSTL<Dim, Dim> WInfo;
 
-        Matrix Responsibilities;
+        /** statistics of the last responsibilities, the responsibilities themselves are not stored */
+        std::vector<SufficientStatistics> Statistics;
       };
 
       /** default constructor */
@@ -189,6 +273,11 @@ namespace libRSF
           NewConfig.RemoveSmallComponents = false;
         }
 
+        NewConfig.ThreadNumber = Config.ThreadNumber;
+        NewConfig.ForgettingFactor = Config.ForgettingFactor;
+        NewConfig.CoresetSize = Config.CoresetSize;
+        NewConfig.AccelerateEM = Config.AcceleratedTuning;
+
         return NewConfig;
       }
 
@@ -209,9 +298,142 @@ namespace libRSF
         return this->estimate(DataMatrix, Config);
       }
 
+      /** online estimation: fold only new samples into the decayed sufficient statistics of each component
+       *  and do a single M-step, so the cost depends on the number of new samples only */
+      bool estimateOnline(const ErrorMatType &NewData, const EstimationConfig &Config)
+      {
+        const int M = Mixture_.size();
+        const Index N = NewData.cols();
+
+        /** (re-)initialize with a batch estimation, if the mixture was changed from outside */
+        if (static_cast<int>(OnlineStatistics_.size()) != M || OnlineSampleSize_ <= 0.0)
+        {
+          if (!this->estimate(NewData, Config))
+          {
+            return false;
+          }
+
+          /** the prior scatter is fixed after initialization */
+          OnlinePriorScatter_ = EstimateSampleCovariance(NewData) * Config.PriorWishartDOF;
+
+          Matrix Probability(Mixture_.size(), N);
+          this->computeProbability(NewData, Probability, Config.ThreadNumber, Config.SinglePrecisionEStep);
+          OnlineStatistics_ = ComputeStatistics_(NewData, Probability, Config.ThreadNumber);
+          OnlineSampleSize_ = static_cast<double>(N);
+          return true;
+        }
+
+        if (N == 0)
+        {
+          return false;
+        }
+
+        /** E-step on the new samples only */
+        Matrix Probability(M, N);
+        this->computeProbability(NewData, Probability, Config.ThreadNumber, Config.SinglePrecisionEStep);
+        const std::vector<SufficientStatistics> NewStatistics = ComputeStatistics_(NewData, Probability, Config.ThreadNumber);
+
+        /** decay the history and add the new samples */
+        const double Lambda = Config.ForgettingFactor;
+        OnlineSampleSize_ = Lambda * OnlineSampleSize_ + static_cast<double>(N);
+        for (int m = 0; m < M; m++)
+        {
+          SufficientStatistics &Stat = OnlineStatistics_.at(m);
+          Stat.scale(Lambda);
+          Stat.add(NewStatistics.at(m));
+        }
+
+        /** M-step on the accumulated statistics (the variational types use the posterior mode) */
+        const double Concentration = (Config.EstimationAlgorithm == ErrorModelTuningType::VBI) ? 1.0 : Config.PriorDirichletConcentration;
+        const double DirichletSum = (Concentration - 1) * M;
+        for (int m = 0; m < M; m++)
+        {
+          const SufficientStatistics &Stat = OnlineStatistics_.at(m);
+          if (Config.EstimationAlgorithm == ErrorModelTuningType::EM)
+          {
+            Mixture_.at(m).estimateParameters(Stat.Sum, Stat.Mean, Stat.Scatter, OnlineSampleSize_, Config.EstimateMean);
+          }
+          else
+          {
+            Mixture_.at(m).estimateParametersMAP(Stat.Sum, Stat.Mean, Stat.Scatter, OnlineSampleSize_,
+                                                 Concentration,
+                                                 DirichletSum,
+                                                 Config.PriorNormalInfoScaling,
+                                                 Config.PriorNormalMean,
+                                                 OnlinePriorScatter_,
+                                                 Config.PriorWishartDOF,
+                                                 Config.EstimateMean);
+          }
+        }
+
+        /** keep the weights normalized, the MAP weights are clamped at zero */
+        double WeightSum = 0.0;
+        for (const GaussianComponent<Dim> &Component : Mixture_)
+        {
+          WeightSum += Component.getWeight()(0);
+        }
+        if (WeightSum > 0.0)
+        {
+          for (GaussianComponent<Dim> &Component : Mixture_)
+          {
+            Component.setParamsSqrtInformation(Component.getSqrtInformation(), Component.getMean(), Component.getWeight() / WeightSum);
+          }
+        }
+
+        return true;
+      }
+
+      /** drop the accumulated statistics, the next online update starts with a batch estimation */
+      void resetOnline()
+      {
+        OnlineStatistics_.clear();
+        OnlineSampleSize_ = 0.0;
+      }
+
       bool estimate(const MatrixStatic<Dim, Dynamic> &DataMatrix, const EstimationConfig &Config)
       {
-        const int N = DataMatrix.cols();
+        /** data in memory is streamed like any other source, so a copy of one chunk is the only overhead */
+        return this->estimate([&DataMatrix](const Index Start, const Index Length, ErrorMatType &Samples)
+                              {
+                                Samples = DataMatrix.middleCols(Start, Length);
+                              },
+                              DataMatrix.cols(), Config);
+      }
+
+      /** estimation over N streamed samples, the memory does not grow with N since the
+       *  expectation step is folded into the sufficient statistics chunk by chunk */
+      bool estimate(const SampleSource &Source, const Index N, const EstimationConfig &Config)
+      {
+        SampleStream Samples;
+        Samples.Source = Source;
+        Samples.Number = N;
+
+        /** replace large sets by a weighted subset, which is kept in memory for all iterations */
+        if (Config.CoresetSize > 0 && N > Config.CoresetSize && N >= Config.MinimalSamples)
+        {
+          Samples = BuildCoreset_(Samples, Config.CoresetSize);
+        }
+
+        return this->estimate(Samples, Config);
+      }
+
+      /** weighted estimation, each sample counts as often as its weight says */
+      bool estimate(const ErrorMatType &DataMatrix, const Vector &SampleWeights, const EstimationConfig &Config)
+      {
+        SampleStream Samples;
+        Samples.Source = [&DataMatrix](const Index Start, const Index Length, ErrorMatType &Chunk)
+                         {
+                           Chunk = DataMatrix.middleCols(Start, Length);
+                         };
+        Samples.Number = DataMatrix.cols();
+        Samples.Weights = SampleWeights;
+
+        return this->estimate(Samples, Config);
+      }
+
+      bool estimate(const SampleStream &Samples, const EstimationConfig &Config)
+      {
+        const double N = Samples.size();
 
         /** check size */
         if (N < Config.MinimalSamples)
@@ -224,7 +446,7 @@ namespace libRSF
         EstimationConfig ModifiedConfig = Config;
         if (Config.EstimationAlgorithm != ErrorModelTuningType::EM)
         {
-          ModifiedConfig.PriorWishartScatter = EstimateSampleCovariance(DataMatrix) * Config.PriorWishartDOF;
+          ModifiedConfig.PriorWishartScatter = StreamSampleCovariance_(Samples) * Config.PriorWishartDOF;
         }
 
         /** init*/
@@ -235,35 +457,26 @@ namespace libRSF
         bool Pruned = false;
         double LikelihoodSumOld = 0;
         double LikelihoodSum = 0;
+        double LogLikelihood = std::numeric_limits<double>::quiet_NaN();
         int k = 1;
+        LikelihoodHistory_.clear();
 
         /** iterate until convergence */
         while ((!Converged && !ReachedMaxIteration) || Merged || Pruned)
         {
-          /** init required variables */
-          int M = Mixture_.size();
-
           switch (Config.EstimationAlgorithm)
           {
             case ErrorModelTuningType::EM:
-            {
-              /** E-step */
-              Matrix Probability(M, N);
-              LikelihoodSum = this->computeProbability(DataMatrix, Probability);
-
-              /** M-Step maximum likelihood */
-              this->computeMixtureParameters(DataMatrix, Probability, ModifiedConfig);
-            }
-            break;
-
             case ErrorModelTuningType::EM_MAP:
             {
-              /** E-step */
-              Matrix Probability(M, N);
-              LikelihoodSum = this->computeProbability(DataMatrix, Probability);
-
-              /** M-Step maximum-a-posteriori*/
-              this->computeMixtureParametersMAP(DataMatrix, Probability, ModifiedConfig);
+              if (Config.AccelerateEM)
+              {
+                LikelihoodSum = this->doAcceleratedStep_(Samples, ModifiedConfig, LogLikelihood);
+              }
+              else
+              {
+                LikelihoodSum = this->doExpectationMaximization_(Samples, ModifiedConfig);
+              }
             }
             break;
 
@@ -273,9 +486,9 @@ namespace libRSF
               if (k == 1)
               {
                 /** first likelihood is not variational */
-                this->computeProbability(DataMatrix, VBIState.Responsibilities);
+                this->streamProbability_(Samples, Config.ThreadNumber, VBIState.Statistics);
               }
-              LikelihoodSum = this->doVariationalStep(DataMatrix, VBIState, ModifiedConfig);
+              LikelihoodSum = this->doVariationalStep(Samples, VBIState, ModifiedConfig);
             }
             break;
 
@@ -285,9 +498,9 @@ namespace libRSF
               if (k == 1)
               {
                 /** first likelihood is not variational */
-                this->computeProbability(DataMatrix, VBIState.Responsibilities);
+                this->streamProbability_(Samples, Config.ThreadNumber, VBIState.Statistics);
               }
-              LikelihoodSum = this->doVariationalStepFull(DataMatrix, VBIState, ModifiedConfig);
+              LikelihoodSum = this->doVariationalStepFull(Samples, VBIState, ModifiedConfig);
             }
             break;
 
@@ -300,24 +513,15 @@ namespace libRSF
           if (Config.EstimationAlgorithm == ErrorModelTuningType::EM ||
               Config.EstimationAlgorithm == ErrorModelTuningType::EM_MAP)
           {
-            /** remove components with a low weight */
-            if (Config.RemoveSmallComponents)
-            {
-              Pruned = this->prunMixture(std::min(Config.MinSamplePerComponent / N, 1.0));
-            }
-            else
-            {
-              Pruned = this->prunMixture(0.0);
-            }
+            /** remove components with a low weight and merge components that are close to each other */
+            this->prunAndReduceMixture(Config.RemoveSmallComponents ? std::min(Config.MinSamplePerComponent / N, 1.0) : 0.0,
+                                       Config.MergeSimilarComponents ? Config.MergingThreshold : std::numeric_limits<double>::infinity(),
+                                       Pruned, Merged);
 
-            /** merge components that are close to each other */
-            if (Config.MergeSimilarComponents)
-            {
-              Merged = this->reduceMixture(Config.MergingThreshold);
-            }
-            else
+            /** the log-likelihood of the last accelerated step belongs to the old mixture */
+            if (Pruned || Merged)
             {
-              Merged = false;
+              LogLikelihood = std::numeric_limits<double>::quiet_NaN();
             }
           }
 
@@ -344,6 +548,7 @@ namespace libRSF
 
           /** save for next iteration */
           LikelihoodSumOld = LikelihoodSum;
+          LikelihoodHistory_.push_back(LikelihoodSum);
 
           /** increment iteration counter */
           k++;
@@ -439,7 +644,45 @@ namespace libRSF
         Mixture = Mixture_;
       }
 
-      void computeLikelihood(const ErrorMatType &DataVector, Matrix &Likelihood) const
+      /** parameters of all components for checkpoints */
+      void serialize(CheckpointWriter &Writer) const
+      {
+        Writer.write(static_cast<uint32_t>(Mixture_.size()));
+        for (const GaussianComponent<Dim> &Component : Mixture_)
+        {
+          Writer.writeMatrix(Component.getMean());
+          Writer.writeMatrix(Component.getWeight());
+          Writer.writeMatrix(Component.getSqrtInformation());
+        }
+      }
+
+      bool deserialize(CheckpointReader &Reader)
+      {
+        uint32_t NumberOfComponents = 0;
+        if (!Reader.read(NumberOfComponents))
+        {
+          return false;
+        }
+
+        Mixture_.clear();
+        for (uint32_t nComponent = 0; nComponent < NumberOfComponents; ++nComponent)
+        {
+          MatrixStatic<Dim, 1> Mean;
+          MatrixStatic<1, 1> Weight;
+          MatrixStatic<Dim, Dim> SqrtInformation;
+          if (!Reader.readMatrix(Mean) || !Reader.readMatrix(Weight) || !Reader.readMatrix(SqrtInformation))
+          {
+            return false;
+          }
+
+          GaussianComponent<Dim> Component;
+          Component.setParamsSqrtInformation(SqrtInformation, Mean, Weight);
+          Mixture_.emplace_back(Component);
+        }
+        return true;
+      }
+
+      void computeLikelihood(const ErrorMatType &DataVector, Matrix &Likelihood, const int ThreadNumber = 1) const
       {
         const int M = Mixture_.size(); /**< number of components */
         const int N = DataVector.cols(); /**< number of data samples */
@@ -447,35 +690,68 @@ namespace libRSF
         /** adapt size of output matrix */
         Likelihood.resize(M, N);
 
-        /** loop over components*/
-        for (int m = 0; m < M; ++m)
+        /** small dimensions use the packed kernel */
+        PackedParameters Packed;
+        if constexpr (Dim <= 3)
         {
-          Likelihood.row(m) = Mixture_.at(m).computeLikelihood(DataVector);
+          Packed = this->packParameters_();
         }
 
-        /** remove NaNs */
-        Likelihood = (Likelihood.array().isFinite()).select(Likelihood, 0.0);
+        /** loop over chunks of samples and components*/
+        ForEachChunk_(N, ThreadNumber, [&](Index, Index Start, Index Length)
+        {
+          if constexpr (Dim <= 3)
+          {
+            Likelihood.middleCols(Start, Length) = LogLikelihoodKernel_(DataVector.middleCols(Start, Length), Packed, 1.0).exp().matrix();
+          }
+          else
+          {
+            const ErrorMatType Chunk = DataVector.middleCols(Start, Length);
+            for (int m = 0; m < M; ++m)
+            {
+              Likelihood.block(m, Start, 1, Length) = Mixture_.at(m).computeLikelihood(Chunk).transpose();
+            }
+          }
+
+          /** remove NaNs */
+          Likelihood.middleCols(Start, Length) = (Likelihood.middleCols(Start, Length).array().isFinite()).select(Likelihood.middleCols(Start, Length), 0.0);
+        });
       }
 
-      double computeProbability(const ErrorMatType &DataVector, Matrix &Probability) const
+      double computeProbability(const ErrorMatType &DataVector, Matrix &Probability, const int ThreadNumber = 1, const bool SinglePrecision = false) const
       {
-        const int M = Mixture_.size(); /**< number of components */
-        const int N = DataVector.cols(); /**< number of data samples */
+        if constexpr (Dim <= 3)
+        {
+          const Index M = Mixture_.size();
+          const Index N = DataVector.cols();
+          const PackedParameters Packed = this->packParameters_();
 
-        /** get likelihood */
-        this->computeLikelihood(DataVector, Probability);
-        const double LikelihoodSum = Probability.sum();
+          Probability.resize(M, N);
+          std::vector<double> ChunkSum((N + ChunkSize_ - 1) / ChunkSize_, 0.0);
 
-        /** normalize over all components */
-        for (int n = 0; n < N; ++n)
-        {
-          Probability.col(n) /= Probability.col(n).sum();
-        }
+          ForEachChunk_(N, ThreadNumber, [&](Index Chunk, Index Start, Index Length)
+          {
+            const ArrayRowMajor LogLikelihood = SinglePrecision ? LogLikelihoodKernel_<float>(DataVector.middleCols(Start, Length), Packed, 1.0)
+                                                                : LogLikelihoodKernel_(DataVector.middleCols(Start, Length), Packed, 1.0);
 
-        /** remove NaNs (occur if sum of likelihoods is zero) */
-        Probability = (Probability.array().isFinite()).select(Probability, 1.0 / M);
+            ChunkSum.at(Chunk) = NormalizeLogLikelihood_(LogLikelihood, Probability.middleCols(Start, Length));
+          });
 
-        return LikelihoodSum;
+          double LikelihoodSum = 0.0;
+          for (const double Sum : ChunkSum)
+          {
+            LikelihoodSum += Sum;
+          }
+          return LikelihoodSum;
+        }
+        else
+        {
+          /** get likelihood */
+          this->computeLikelihood(DataVector, Probability, ThreadNumber);
+
+          /** normalize over all components */
+          return NormalizeResponsibilities_(Probability, ThreadNumber);
+        }
       }
 
       int computeMostLikelyComponent(MatrixStatic<Dim, 1> &Error) const
@@ -501,9 +777,16 @@ namespace libRSF
         NegLogLikelihood.resize(M, N);
 
         /** loop over components*/
-        for (int m = 0; m < M; ++m)
+        if constexpr (Dim <= 3)
+        {
+          NegLogLikelihood = -LogLikelihoodKernel_(DataVector, this->packParameters_(), EvalAsError ? 1.0 : -1.0).matrix();
+        }
+        else
         {
-          NegLogLikelihood.row(m) = Mixture_.at(m).computeNegLogLikelihood(DataVector, EvalAsError);
+          for (int m = 0; m < M; ++m)
+          {
+            NegLogLikelihood.row(m) = Mixture_.at(m).computeNegLogLikelihood(DataVector, EvalAsError);
+          }
         }
 
         /** remove NaNs */
@@ -529,7 +812,7 @@ namespace libRSF
         }
       }
 
-      double doVariationalStep(const ErrorMatType &DataMatrix,
+      double doVariationalStep(const SampleStream &Samples,
                                BayesianState &VBIState,
                                const EstimationConfig &Config) const
       {
@@ -548,10 +831,10 @@ namespace libRSF
         const double Nu0 = Config.PriorWishartDOF;
 
         /** adapt to current size */
-        const int SampleSize = DataMatrix.cols();
-        if (VBIState.Weight.size() < VBIState.Responsibilities.rows())
+        const double SampleSize = Samples.size();
+        if (VBIState.Weight.size() < VBIState.Statistics.size())
         {
-          for (int n = VBIState.Weight.size(); n < VBIState.Responsibilities.rows(); ++n)
+          for (int n = VBIState.Weight.size(); n < static_cast<int>(VBIState.Statistics.size()); ++n)
           {
             VBIState.Weight.push_back(this->Mixture_.at(n).getWeight()(0));
             VBIState.InfoMean.push_back(Beta0); /**< will be overwritten */
@@ -565,102 +848,71 @@ namespace libRSF
         /** Expectation step */
 
         /** pre-calculate some multi-use variables */
-        const Vector SumLike = VBIState.Responsibilities.rowwise().sum();
-        const MatrixStatic<Dynamic, Dim> SumLikeX = VBIState.Responsibilities * DataMatrix.transpose();
-
-        MatrixVectorSTL<Dim, Dim> XX;
-        for (int n = 0; n < SampleSize; n++)
-        {
-          XX.push_back(DataMatrix.col(n) * DataMatrix.col(n).transpose());
-        }
+        const std::vector<SufficientStatistics> Statistics = std::move(VBIState.Statistics);
 
-        MatrixVectorSTL<Dim, Dim> SumLikeXX;
-        for (int m = 0; m < GMMSize; m++)
-        {
-          MatrixStatic<Dim,Dim> SumLikeXXComp = MatrixStatic<Dim,Dim>::Zero();
-          for (int n = 0; n < SampleSize; n++)
-          {
-            SumLikeXXComp += XX.at(n) * VBIState.Responsibilities(m,n);
-          }
-          SumLikeXX.push_back(SumLikeXXComp);
-        }
+        /** expectations that are required for the responsibilities, packed for the likelihood kernel */
+        PackedParameters Packed = AllocatePackedParameters_(GMMSize);
+        ArrayColumn LogDetW(GMMSize);
+        ArrayColumn TraceCovMean(GMMSize);
 
         /** iterate over GMM components */
         for (int m = 0; m < GMMSize; ++m)
         {
+          const double SumLike = Statistics.at(m).Sum;
+          const VectorStatic<Dim> &MeanX = Statistics.at(m).Mean;
+
           /** <T_i> */
           MatrixStatic<Dim,Dim> InfoEx = VBIState.NuInfo.at(m) * VBIState.WInfo.at(m);
 
-          /** update mean posterior */
-          VBIState.InfoMean.at(m) = Beta0 + InfoEx * SumLike(m);
+          /** update mean posterior, its covariance is used for the mean and for <Mu_i*Mu_i^T> */
+          VBIState.InfoMean.at(m) = Beta0 + InfoEx * SumLike;
+          const MatrixStatic<Dim,Dim> CovMean = Inverse(VBIState.InfoMean.at(m));
 
           if (Config.EstimateMean)
           {
-            VBIState.MeanMean.at(m) = Inverse(VBIState.InfoMean.at(m)) * InfoEx * SumLikeX.row(m).transpose();
+            VBIState.MeanMean.at(m) = CovMean * InfoEx * MeanX * SumLike;
           }
 
           /** update variance posterior */
-          VBIState.NuInfo.at(m) = Nu0 + SumLike(m);
-
-          /** <Mu_i*Mu_i^T> */
-          const MatrixStatic<Dim,Dim> MuMuEx = Inverse(VBIState.InfoMean.at(m)) + VBIState.MeanMean.at(m) * VBIState.MeanMean.at(m).transpose();
-
-          MatrixStatic<Dim,Dim> SumXPMu = MatrixStatic<Dim,Dim>::Zero();
-          for (int n = 0; n < SampleSize; n++)
-          {
-            SumXPMu += DataMatrix.col(n) * VBIState.Responsibilities(m,n) * VBIState.MeanMean.at(m).transpose();
-          }
-
-          VBIState.WInfo.at(m) = (V0
-                                 + SumLikeXX.at(m)
-                                 - SumXPMu
-                                 - VBIState.MeanMean.at(m) * SumLikeX.row(m)
-                                 + MuMuEx * SumLike(m)).inverse();
-
-          /** variational likelihood */
-          /** <ln|T_i|> */
-          double LogInfoEx = 0;
-          for (int d = 1; d <= Dim; d++)
-          {
-            LogInfoEx += Eigen::numext::digamma(0.5 * (VBIState.NuInfo.at(m) + 1 - d));
-          }
-          LogInfoEx += Dim*log(2.0) + log(VBIState.WInfo.at(m).determinant());
-
-          /** update <T_i> */
-          InfoEx = VBIState.NuInfo.at(m) * VBIState.WInfo.at(m);
-
-          /** <Mu_i> */
-          const VectorStatic<Dim> MeanEx = VBIState.MeanMean.at(m);
-
-          VBIState.Responsibilities.row(m).fill(0.5 * LogInfoEx + log(VBIState.Weight.at(m)));
-          for (int n = 0; n < SampleSize; n++)
-          {
-            VBIState.Responsibilities(m,n) -= 0.5 * (InfoEx * (XX.at(n)
-                                              - MeanEx * DataMatrix.col(n).transpose()
-                                              - DataMatrix.col(n) * MeanEx.transpose()
-                                              + MuMuEx) ).trace();
-          }
-          VBIState.Responsibilities.row(m) = VBIState.Responsibilities.row(m).array().exp();
+          VBIState.NuInfo.at(m) = Nu0 + SumLike;
+
+          /** Sum(r*(x*x^T - x*<Mu_i>^T - <Mu_i>*x^T + <Mu_i*Mu_i^T>)), expressed by the centered scatter */
+          const VectorStatic<Dim> MeanDiff = MeanX - VBIState.MeanMean.at(m);
+
+          /** one factorization gives W_i, its square root and ln|W_i| */
+          MatrixStatic<Dim,Dim> SqrtW;
+          LogDetW(m) = FactorizeWishartScatter_(V0
+                                                + Statistics.at(m).Scatter
+                                                + SumLike * MeanDiff * MeanDiff.transpose()
+                                                + SumLike * CovMean,
+                                                VBIState.WInfo.at(m), SqrtW);
+
+          /** updated <T_i> = Nu_i * W_i around <Mu_i> */
+          PackWishart_(Packed, m, VBIState.MeanMean.at(m), VBIState.NuInfo.at(m), SqrtW);
+          TraceCovMean(m) = VBIState.NuInfo.at(m) * (VBIState.WInfo.at(m) * CovMean).trace();
         }
 
-        /** "Maximization step" --> update probability */
-        /** remove NaN */
-        VBIState.Responsibilities = (VBIState.Responsibilities.array().isFinite()).select(VBIState.Responsibilities, 0.0);
-
-        /** calculate relative likelihood  */
-        double LikelihoodSum = VBIState.Responsibilities.sum();
-        for (int n = 0; n < static_cast<int>(VBIState.Responsibilities.cols()); ++n)
+        /** variational likelihood of all components at once, <(x-Mu_i)^T*T_i*(x-Mu_i)> splits into the squared norm
+         *  around <Mu_i> and tr(<T_i>*Cov(Mu_i)), so the kernel only evaluates the sample dependent part */
+        const ArrayColumn LogInfoEx = WishartDigammaSum_(Eigen::Map<const ArrayColumn>(VBIState.NuInfo.data(), GMMSize))
+                                      + Dim * std::log(2.0) + LogDetW;
+        Packed.LogScaling = 0.5 * LogInfoEx
+                            + Eigen::Map<const ArrayColumn>(VBIState.Weight.data(), GMMSize).log()
+                            - 0.5 * TraceCovMean;
+
+        /** evaluate responsibilities chunk-wise, the statistics weighted with them are used in the next step */
+        double LikelihoodSum = StreamStatistics_(Samples, GMMSize, Config.ThreadNumber, VBIState.Statistics,
+                                                 [&Packed](const ErrorMatType &Chunk, Matrix &Responsibilities)
         {
-          VBIState.Responsibilities.col(n) /= VBIState.Responsibilities.col(n).sum();
-        }
-
-        /** remove NaN again (occur if sum of likelihoods is zero) */
-        VBIState.Responsibilities = (VBIState.Responsibilities.array().isFinite()).select(VBIState.Responsibilities, 1.0 / GMMSize);
+          /** "Maximization step" --> update probability */
+          Responsibilities.resize(Packed.LogScaling.rows(), Chunk.cols());
+          return NormalizeLogLikelihood_(LogLikelihoodKernel_(Chunk, Packed, -1.0), Responsibilities);
+        });
 
         /** calculate weights */
         for (int m = 0; m < GMMSize; ++m)
         {
-          VBIState.Weight.at(m) = VBIState.Responsibilities.row(m).sum() / VBIState.Responsibilities.cols();
+          VBIState.Weight.at(m) = VBIState.Statistics.at(m).Sum / SampleSize;
         }
 
         /** remove useless or degenerated components */
@@ -675,10 +927,8 @@ namespace libRSF
             VBIState.MeanMean.erase(VBIState.MeanMean.begin() + m);
             VBIState.Weight.erase(VBIState.Weight.begin() + m);
 
-            /** remove row from probability matrix */
-            Matrix ProbTrans = VBIState.Responsibilities.transpose();
-            RemoveColumn(ProbTrans,m);
-            VBIState.Responsibilities = ProbTrans.transpose();
+            /** remove its share of the responsibilities */
+            VBIState.Statistics.erase(VBIState.Statistics.begin() + m);
 
             /** enforce an additional iteration after removal by resetting likelihood */
             LikelihoodSum = 1e40;
@@ -688,7 +938,7 @@ namespace libRSF
         return LikelihoodSum;
       }
 
-      double doVariationalStepFull(const ErrorMatType &DataMatrix,
+      double doVariationalStepFull(const SampleStream &Samples,
                                    BayesianState &VBIState,
                                    const EstimationConfig &Config) const
       {
@@ -706,10 +956,10 @@ namespace libRSF
         const VectorStatic<Dim> Mean0 = Config.PriorNormalMean;
 
         /** adapt state to current size */
-        const int SampleSize = DataMatrix.cols();
-        if (VBIState.AlphaWeight.size() < VBIState.Responsibilities.rows())
+        const double SampleSize = Samples.size();
+        if (VBIState.AlphaWeight.size() < VBIState.Statistics.size())
         {
-          for (int n = VBIState.AlphaWeight.size(); n < VBIState.Responsibilities.rows(); ++n)
+          for (int n = VBIState.AlphaWeight.size(); n < static_cast<int>(VBIState.Statistics.size()); ++n)
           {
             VBIState.AlphaWeight.push_back(Alpha0);
             VBIState.MeanMean.push_back(Mean0);
@@ -722,29 +972,31 @@ namespace libRSF
         const int GMMSize = VBIState.AlphaWeight.size();
 
         /** pre-calculate useful variables */
-        const Vector N = VBIState.Responsibilities.rowwise().sum();
+        const std::vector<SufficientStatistics> Statistics = std::move(VBIState.Statistics);
+
+        Vector N(GMMSize);
+        for (int k = 0; k < GMMSize; k++)
+        {
+          N(k) = Statistics.at(k).Sum;
+        }
         const double NSum = N.sum();
         const Vector NInv = (N.array().inverse().isFinite()).select(N.array().inverse(), 0.0); /**< catch NaN */
         MatrixStatic<Dynamic, Dim> MeanX (GMMSize, Dim);
         for (int k = 0; k < GMMSize; k++)
         {
-          MeanX.row(k) = NInv(k) * (DataMatrix * VBIState.Responsibilities.row(k).asDiagonal()).rowwise().sum();
+          MeanX.row(k) = Statistics.at(k).Mean.transpose(); /**< zero without samples */
         }
 
+        /** S = Sum(r*(x-mu)*(x-mu)^T) / N */
         MatrixVectorSTL<Dim, Dim> S;
         for (int k = 0; k < GMMSize; k++)
         {
-          MatrixStatic<Dim,Dim> Sum = MatrixStatic<Dim,Dim>::Zero();
-          for (int n = 0; n < SampleSize; n++)
-          {
-            Sum += VBIState.Responsibilities(k,n)
-                   * ((DataMatrix.col(n) - MeanX.row(k).transpose())
-                      * (DataMatrix.col(n) - MeanX.row(k).transpose()).transpose());
-          }
-          S.push_back(NInv(k) * Sum);
+          S.push_back(NInv(k) * Statistics.at(k).Scatter);
         }
 
         /** update posteriors */
+        PackedParameters Packed = AllocatePackedParameters_(GMMSize);
+        ArrayColumn LogDetW(GMMSize);
         double SumAlpha = 0;
         for (int k = 0; k < GMMSize; k++)
         {
@@ -761,56 +1013,32 @@ namespace libRSF
                                                + N(k)*S.at(k)
                                                + Beta0*N(k)/(Beta0 + N(k)) * (MeanX.row(k).transpose() - Mean0)*(MeanX.row(k).transpose() - Mean0).transpose();
 
-          VBIState.WInfo.at(k) = Inverse(WInfoInv);
+          MatrixStatic<Dim,Dim> SqrtW;
+          LogDetW(k) = FactorizeWishartScatter_(WInfoInv, VBIState.WInfo.at(k), SqrtW);
           VBIState.NuInfo.at(k) = Nu0 + N(k);
+          PackWishart_(Packed, k, VBIState.MeanMean.at(k), VBIState.NuInfo.at(k), SqrtW);
 
           /** update expected weight */
           VBIState.Weight.at(k) = (Alpha0 + N(k))/(GMMSize*Alpha0 + NSum);
         }
 
-        /** evaluate expectations */
-        Vector ExpLnInfo(GMMSize);
-        Vector ExpLnWeight(GMMSize);
-        for (int k = 0; k < GMMSize; k++)
-        {
-          double Sum = 0;
-          for (int d = 1; d <= Dim; d++)
-          {
-            Sum += Eigen::numext::digamma(0.5 * (VBIState.NuInfo.at(k) + 1 - d));
-          }
-          ExpLnInfo(k) = Sum + Dim*log(2.0) + log(VBIState.WInfo.at(k).determinant());
-          ExpLnWeight(k) = Eigen::numext::digamma(VBIState.AlphaWeight.at(k))
-                           - Eigen::numext::digamma(SumAlpha);
-        }
-
-        /** evaluate responsibilities */
-        for (int k = 0; k < GMMSize; k++)
-        {
-          for (int n = 0; n < SampleSize; n++)
-          {
-            VBIState.Responsibilities(k,n) = exp(ExpLnWeight(k)
-                                                 + ExpLnInfo(k)/2.0
-                                                 - Dim/(2.0*VBIState.BetaMean.at(k))
-                                                 - VBIState.NuInfo.at(k)/2.0
-                                                 * ((DataMatrix.col(n) - VBIState.MeanMean.at(k)).transpose() * VBIState.WInfo.at(k)).dot(
-                                                   (DataMatrix.col(n) - VBIState.MeanMean.at(k))));
-          }
-        }
-
-        /** catch numerical issues with the exp() */
-        VBIState.Responsibilities = (VBIState.Responsibilities.array().isFinite()).select(VBIState.Responsibilities, 0.0);
-
-        /** save likelihood before(!) it is normalized as probability */
-        double LikelihoodSum = VBIState.Responsibilities.sum();
-
-        /** normalize */
-        for (int n = 0; n < static_cast<int>(VBIState.Responsibilities.cols()); ++n)
+        /** evaluate expectations of all components at once */
+        const ArrayColumn ExpLnInfo = WishartDigammaSum_(Eigen::Map<const ArrayColumn>(VBIState.NuInfo.data(), GMMSize))
+                                      + Dim * std::log(2.0) + LogDetW;
+        const ArrayColumn ExpLnWeight = Digamma_(Eigen::Map<const ArrayColumn>(VBIState.AlphaWeight.data(), GMMSize))
+                                        - Eigen::numext::digamma(SumAlpha);
+        Packed.LogScaling = ExpLnWeight
+                            + ExpLnInfo / 2.0
+                            - Dim / (2.0 * Eigen::Map<const ArrayColumn>(VBIState.BetaMean.data(), GMMSize));
+
+        /** evaluate responsibilities chunk-wise, the statistics weighted with them are used in the next step */
+        double LikelihoodSum = StreamStatistics_(Samples, GMMSize, Config.ThreadNumber, VBIState.Statistics,
+                                                 [&Packed](const ErrorMatType &Chunk, Matrix &Responsibilities)
         {
-          VBIState.Responsibilities.col(n) /= VBIState.Responsibilities.col(n).sum();
-        }
-
-        /** remove NaN (occur if sum of likelihoods is zero) */
-        VBIState.Responsibilities = (VBIState.Responsibilities.array().isFinite()).select(VBIState.Responsibilities, 1.0 / GMMSize);
+          /** save likelihood before(!) it is normalized as probability */
+          Responsibilities.resize(Packed.LogScaling.rows(), Chunk.cols());
+          return NormalizeLogLikelihood_(LogLikelihoodKernel_(Chunk, Packed, -1.0), Responsibilities);
+        });
 
         /** remove useless or degenerated components */
         for (int k = GMMSize-1; k >=0 ; --k)
@@ -826,10 +1054,8 @@ namespace libRSF
             VBIState.WInfo.erase(VBIState.WInfo.begin() + k);
             VBIState.Weight.erase(VBIState.Weight.begin() + k);
 
-            /** remove row from probability matrix */
-            Matrix RespTrans = VBIState.Responsibilities.transpose();
-            RemoveColumn(RespTrans, k);
-            VBIState.Responsibilities = RespTrans.transpose();
+            /** remove its share of the responsibilities */
+            VBIState.Statistics.erase(VBIState.Statistics.begin() + k);
 
             /** enforce an additional iteration after removal by resetting likelihood */
             LikelihoodSum = 1e40;
@@ -840,25 +1066,40 @@ namespace libRSF
       }
 
       void computeMixtureParameters(const ErrorMatType &DataVector, const Matrix &Likelihood, const EstimationConfig &Config)
+      {
+        this->computeMixtureParameters(ComputeStatistics_(DataVector, Likelihood, Config.ThreadNumber), DataVector.cols(), Config);
+      }
+
+      void computeMixtureParameters(const std::vector<SufficientStatistics> &Statistics, const double SampleSize, const EstimationConfig &Config)
       {
         const int M = Mixture_.size();
         for (int m = 0; m < M; m++)
         {
-          Mixture_.at(m).estimateParameters(DataVector, Likelihood.row(m), Config.EstimateMean);
+          Mixture_.at(m).estimateParameters(Statistics.at(m).Sum,
+                                            Statistics.at(m).Mean,
+                                            Statistics.at(m).Scatter,
+                                            SampleSize,
+                                            Config.EstimateMean);
         }
       }
 
       void computeMixtureParametersMAP(const ErrorMatType &DataVector, const Matrix &Likelihood, const EstimationConfig &Config)
       {
+        this->computeMixtureParametersMAP(ComputeStatistics_(DataVector, Likelihood, Config.ThreadNumber), DataVector.cols(), Config);
+      }
 
+      void computeMixtureParametersMAP(const std::vector<SufficientStatistics> &Statistics, const double SampleSize, const EstimationConfig &Config)
+      {
         /** sum over components */
         const int M = Mixture_.size();
         const double DirichletSum = (Config.PriorDirichletConcentration - 1) * M;
 
         for (int m = 0; m < M; m++)
         {
-          Mixture_.at(m).estimateParametersMAP(DataVector,
-                                               Likelihood.row(m),
+          Mixture_.at(m).estimateParametersMAP(Statistics.at(m).Sum,
+                                               Statistics.at(m).Mean,
+                                               Statistics.at(m).Scatter,
+                                               SampleSize,
                                                Config.PriorDirichletConcentration,
                                                DirichletSum,
                                                Config.PriorNormalInfoScaling,
@@ -872,50 +1113,183 @@ namespace libRSF
       /** remove components, that are to small */
       bool prunMixture(const double MinWeight)
       {
-        bool Pruned = false;
-        for (int m = Mixture_.size() - 1; m >= 0; m--)
-        {
-          if ((Mixture_.at(m).getWeight()(0) < MinWeight ||
-               Mixture_.at(m).getWeight()(0) == 0.0)
-              &&
-              Mixture_.size() > 1)
-          {
-            Mixture_.erase(Mixture_.begin() + m);
-            Pruned = true;
-          }
-        }
-
+        bool Pruned = false, Merged = false;
+        this->prunAndReduceMixture(MinWeight, std::numeric_limits<double>::infinity(), Pruned, Merged);
         return Pruned;
       }
 
       /** merge components that are identical */
       bool reduceMixture(const double BhattacharyyaLimit)
       {
-        bool PerformedMerge = false;
-        int M = Mixture_.size();
+        bool Pruned = false, Merged = false;
+        this->prunAndReduceMixture(-1.0, BhattacharyyaLimit, Pruned, Merged);
+        return Merged;
+      }
+
+      /** remove small components (MinWeight < 0 keeps all) and merge similar ones in one pass,
+       *  the closest pair is merged first and only the distances of a merged component are updated */
+      void prunAndReduceMixture(const double MinWeight, const double BhattacharyyaLimit, bool &Pruned, bool &Merged)
+      {
+        Pruned = false;
+        Merged = false;
+
+        const int M = static_cast<int>(Mixture_.size());
+        std::vector<char> Active(M, 1);
+        int ActiveNumber = M;
+
+        /** pruning, the first component survives in any case */
+        if (MinWeight >= 0.0)
+        {
+          for (int m = M - 1; m >= 0 && ActiveNumber > 1; m--)
+          {
+            const double Weight = Mixture_.at(m).getWeight()(0);
+            if (Weight < MinWeight || Weight == 0.0)
+            {
+              Active.at(m) = 0;
+              ActiveNumber--;
+              Pruned = true;
+            }
+          }
+        }
 
-        for (int m1 = 0; m1 < M - 1; ++m1)
+        /** greedy merging over a cached matrix of pairwise distances, each row keeps its closest partner */
+        if (std::isfinite(BhattacharyyaLimit) && ActiveNumber > 1)
         {
-          for (int m2 = m1 + 1; m2 < M; ++m2)
+          /** exp(-d) > Limit is equivalent to d < -log(Limit) */
+          const double DistanceLimit = -log(BhattacharyyaLimit);
+
+          std::vector<MatrixStatic<Dim, Dim>> Covariances(M);
+          std::vector<double> Determinants(M, 0.0);
+          Matrix Distance = Matrix::Zero(M, M);
+          std::vector<int> BestPartner(M, -1);
+
+          auto Cache = [&](const int m)
+          {
+            Covariances.at(m) = Mixture_.at(m).getCovariance();
+            Determinants.at(m) = Covariances.at(m).determinant();
+          };
+
+          auto Compute = [&](const int m1, const int m2)
           {
-            /** calculate metric */
-            double d = CalculateBhattacharyyaDistance(Mixture_.at(m1),
-                                                      Mixture_.at(m2));
+            Distance(m1, m2) = CalculateBhattacharyyaDistance<Dim>(Mixture_.at(m1).getMean(), Covariances.at(m1), Determinants.at(m1),
+                                                                   Mixture_.at(m2).getMean(), Covariances.at(m2), Determinants.at(m2),
+                                                                   DistanceLimit);
+            Distance(m2, m1) = Distance(m1, m2);
+          };
 
-            /** perform merge if the distance exceed a specific tuning parameter*/
-            if (exp(-d) > BhattacharyyaLimit)
+          auto FindBest = [&](const int m1)
+          {
+            BestPartner.at(m1) = -1;
+            for (int m2 = 0; m2 < M; ++m2)
             {
-              Mixture_.at(m1) = MergeGaussians<Dim>(Mixture_.at(m1), Mixture_.at(m2));
-              Mixture_.erase(Mixture_.begin() + m2);
+              if (m2 != m1 && Active.at(m2) && (BestPartner.at(m1) < 0 || Distance(m1, m2) < Distance(m1, BestPartner.at(m1))))
+              {
+                BestPartner.at(m1) = m2;
+              }
+            }
+          };
 
-              M -= 1;
-              m2 -= 1;
+          for (int m = 0; m < M; ++m)
+          {
+            if (Active.at(m))
+            {
+              Cache(m);
+            }
+          }
+          for (int m1 = 0; m1 < M; ++m1)
+          {
+            for (int m2 = m1 + 1; m2 < M && Active.at(m1); ++m2)
+            {
+              if (Active.at(m2))
+              {
+                Compute(m1, m2);
+              }
+            }
+          }
+          for (int m = 0; m < M; ++m)
+          {
+            if (Active.at(m))
+            {
+              FindBest(m);
+            }
+          }
 
-              PerformedMerge = true;
+          while (ActiveNumber > 1)
+          {
+            /** closest pair */
+            int m1 = -1;
+            for (int m = 0; m < M; ++m)
+            {
+              if (Active.at(m) && (m1 < 0 || Distance(m, BestPartner.at(m)) < Distance(m1, BestPartner.at(m1))))
+              {
+                m1 = m;
+              }
+            }
+            int m2 = BestPartner.at(m1);
+            if (Distance(m1, m2) >= DistanceLimit)
+            {
+              break;
+            }
+
+            /** the lower index keeps the merged component */
+            if (m2 < m1)
+            {
+              std::swap(m1, m2);
+            }
+            Mixture_.at(m1) = MergeGaussians<Dim>(Mixture_.at(m1), Mixture_.at(m2));
+            Active.at(m2) = 0;
+            ActiveNumber--;
+            Merged = true;
+
+            /** only the entries of the merged component change */
+            Cache(m1);
+            for (int m = 0; m < M; ++m)
+            {
+              if (m != m1 && Active.at(m))
+              {
+                Compute(m1, m);
+              }
+            }
+            FindBest(m1);
+
+            for (int m = 0; m < M; ++m)
+            {
+              if (m == m1 || !Active.at(m))
+              {
+                continue;
+              }
+              if (BestPartner.at(m) == m1 || BestPartner.at(m) == m2)
+              {
+                FindBest(m);
+              }
+              else if (Distance(m, m1) < Distance(m, BestPartner.at(m)))
+              {
+                BestPartner.at(m) = m1;
+              }
+            }
+          }
+        }
+
+        /** remove all marked components at once */
+        if (Pruned || Merged)
+        {
+          std::vector<GaussianComponent<Dim>> Remaining;
+          Remaining.reserve(M);
+          for (int m = 0; m < M; ++m)
+          {
+            if (Active.at(m))
+            {
+              Remaining.push_back(std::move(Mixture_.at(m)));
             }
           }
+          Mixture_ = std::move(Remaining);
         }
-        return PerformedMerge;
+      }
+
+      /** likelihood sum after each iteration of the last estimation */
+      [[nodiscard]] const std::vector<double> &getLikelihoodHistory() const
+      {
+        return LikelihoodHistory_;
       }
 
       void printParameter() const
@@ -948,6 +1322,16 @@ namespace libRSF
         return Mixture_.at(NumberOfComponent).getMaximum();
       }
 
+      [[nodiscard]] VectorStatic<Dim> getMeanOfComponent(int NumberOfComponent) const
+      {
+        return Mixture_.at(NumberOfComponent).getMean();
+      }
+
+      [[nodiscard]] MatrixStatic<Dim, Dim> getSqrtInformationOfComponent(int NumberOfComponent) const
+      {
+        return Mixture_.at(NumberOfComponent).getSqrtInformation();
+      }
+
       /** sampling */
       VectorVectorSTL<Dim> DrawSamples(const int Number) const
       {
@@ -1056,7 +1440,594 @@ namespace libRSF
       Data exportToStateData(double Timestamp);
 
     private:
+      /** likelihoods are stored per component, so each row is contiguous over the samples */
+      using ArrayRowMajor = Eigen::Array<double, Dynamic, Dynamic, Eigen::RowMajor>;
+
+      /** one value per component */
+      using ArrayColumn = Eigen::Array<double, Dynamic, 1>;
+
+      /** component parameters as structure of arrays, one row per component */
+      struct PackedParameters
+      {
+        Eigen::Array<double, Dynamic, Dim> Mean;
+        Eigen::Array<double, Dynamic, Dim * Dim> SqrtInformation; /**< entry (r,c) of R at column r * Dim + c */
+        Eigen::Array<double, Dynamic, 1> LogScaling;
+      };
+
+      static PackedParameters AllocatePackedParameters_(const Index M)
+      {
+        PackedParameters Packed;
+        Packed.Mean.resize(M, Dim);
+        Packed.SqrtInformation.resize(M, Dim * Dim);
+        Packed.LogScaling.resize(M);
+        return Packed;
+      }
+
+      [[nodiscard]] PackedParameters packParameters_() const
+      {
+        const Index M = Mixture_.size();
+
+        PackedParameters Packed = AllocatePackedParameters_(M);
+
+        for (Index m = 0; m < M; ++m)
+        {
+          const MatrixStatic<Dim, Dim> SqrtInfo = Mixture_.at(m).getSqrtInformation();
+          Packed.Mean.row(m) = Mixture_.at(m).getMean().transpose().array();
+          for (int r = 0; r < Dim; ++r)
+          {
+            for (int c = 0; c < Dim; ++c)
+            {
+              Packed.SqrtInformation(m, r * Dim + c) = SqrtInfo(r, c);
+            }
+          }
+          Packed.LogScaling(m) = std::log(Mixture_.at(m).getMaximum());
+        }
+
+        return Packed;
+      }
+
+      /** M x N log-likelihoods of the shifted samples e + Sign * mu, weighted with R * e like computeLikelihood()
+       *  the shifted samples are stored row-wise, so each operation runs over all samples at once,
+       *  the shift is done in double, so a float Scalar only affects the weighting and the squared norm */
+      template <typename Scalar = double, typename DataType>
+      static ArrayRowMajor LogLikelihoodKernel_(const Eigen::MatrixBase<DataType> &DataMatrix,
+                                                  const PackedParameters &Packed,
+                                                  const double MeanSign)
+      {
+        const Index M = Packed.LogScaling.rows();
+        const Index N = DataMatrix.cols();
+
+        ArrayRowMajor LogLikelihood(M, N);
+        Eigen::Array<Scalar, Dim, Dynamic, Eigen::RowMajor> Shifted(Dim, N);
+        Eigen::Array<Scalar, 1, Dynamic> Weighted(N);
+        Eigen::Array<Scalar, 1, Dynamic> SquaredNorm(N);
+
+        for (Index m = 0; m < M; ++m)
+        {
+          for (int d = 0; d < Dim; ++d)
+          {
+            Shifted.row(d) = (DataMatrix.row(d).array() + MeanSign * Packed.Mean(m, d)).template cast<Scalar>();
+          }
+
+          /** squared norm of R * e, row j is sum_d R(j,d) * e_d, the square root information is not necessarily symmetric */
+          SquaredNorm.setZero();
+          for (int j = 0; j < Dim; ++j)
+          {
+            Weighted = Shifted.row(0) * static_cast<Scalar>(Packed.SqrtInformation(m, j * Dim));
+            for (int d = 1; d < Dim; ++d)
+            {
+              Weighted += Shifted.row(d) * static_cast<Scalar>(Packed.SqrtInformation(m, j * Dim + d));
+            }
+            SquaredNorm += Weighted.square();
+          }
+
+          LogLikelihood.row(m) = Packed.LogScaling(m) - 0.5 * SquaredNorm.template cast<double>();
+        }
+
+        return LogLikelihood;
+      }
+
+      /** log-sum-exp over the components of each sample, writes the responsibilities and returns the likelihood sum */
+      template <typename BlockType>
+      static double NormalizeLogLikelihood_(const ArrayRowMajor &LogLikelihood, BlockType &&Block)
+      {
+        const Index M = LogLikelihood.rows();
+
+        const Eigen::Array<double, 1, Dynamic> MaxLogLikelihood = LogLikelihood.colwise().maxCoeff();
+        const ArrayRowMajor Scaled = (LogLikelihood.rowwise() - MaxLogLikelihood).exp();
+        const Eigen::Array<double, 1, Dynamic> ScaledSum = Scaled.colwise().sum();
+        const Eigen::Array<double, 1, Dynamic> LikelihoodSum = ScaledSum * MaxLogLikelihood.exp();
+
+        /** remove NaNs (occur if all likelihoods are zero) */
+        Block = (Scaled.rowwise() / ScaledSum).matrix();
+        Block = (Block.array().isFinite()).select(Block, 1.0 / M);
+
+        return LikelihoodSum.isFinite().select(LikelihoodSum, 0.0).sum();
+      }
+
+      /** digamma of all entries at once for positive arguments,
+       *  psi(x) = psi(x + 6) - sum(1/(x + i)) with the asymptotic series at x + 6, accurate to about 1e-11 */
+      static ArrayColumn Digamma_(const ArrayColumn &X)
+      {
+        ArrayColumn Shift = X.inverse();
+        for (int i = 1; i < 6; ++i)
+        {
+          Shift += (X + i).inverse();
+        }
+
+        const ArrayColumn Y = X + 6.0;
+        const ArrayColumn Y2Inv = Y.square().inverse();
+        return Y.log() - 0.5 * Y.inverse()
+               - Y2Inv * (1.0/12.0 - Y2Inv * (1.0/120.0 - Y2Inv * (1.0/252.0 - Y2Inv * (1.0/240.0 - Y2Inv / 132.0))))
+               - Shift;
+      }
+
+      /** sum(digamma(0.5 * (Nu + 1 - d))) over all dimensions, the Wishart part of <ln|T|> per component */
+      static ArrayColumn WishartDigammaSum_(const ArrayColumn &Nu)
+      {
+        ArrayColumn Sum = ArrayColumn::Zero(Nu.rows());
+        for (int d = 1; d <= Dim; d++)
+        {
+          Sum += Digamma_(0.5 * (Nu + 1 - d));
+        }
+        return Sum;
+      }
+
+      /** W = S^-1 = R^T*R with R = L^-1 from one Cholesky factorization S = L*L^T of the Wishart scatter matrix,
+       *  returns ln|W|, ill-conditioned scatter matrices fall back to the eigen decomposition */
+      static double FactorizeWishartScatter_(const MatrixStatic<Dim, Dim> &Scatter,
+                                             MatrixStatic<Dim, Dim> &W,
+                                             MatrixStatic<Dim, Dim> &SqrtW)
+      {
+        double LogDeterminant = 0.0;
+        if (InverseSquareRootCholesky<Dim, double>(Scatter, SqrtW, LogDeterminant))
+        {
+          W = SqrtW.transpose() * SqrtW;
+          return 2.0 * LogDeterminant;
+        }
+
+        W = Inverse<Dim, double>(Scatter);
+        SqrtW = SquareRoot<Dim, double>(W);
+        return std::log(W.determinant());
+      }
+
+      /** store the expected information Nu * W of one component around its expected mean */
+      static void PackWishart_(PackedParameters &Packed, const Index m, const VectorStatic<Dim> &Mean,
+                               const double Nu, const MatrixStatic<Dim, Dim> &SqrtW)
+      {
+        const MatrixStatic<Dim, Dim> SqrtInfo = std::sqrt(Nu) * SqrtW;
+        Packed.Mean.row(m) = Mean.transpose().array();
+        Packed.SqrtInformation.row(m) = Eigen::Map<const Eigen::Array<double, 1, Dim * Dim>>(SqrtInfo.data());
+      }
+
+      /** fixed chunk size, so the order of all sums is independent of the thread number */
+      static constexpr Index ChunkSize_ = 4096;
+
+      /** call Function(Chunk, Start, Length) for all chunks of N samples on the shared pool */
+      template <typename FunctionType>
+      static void ForEachChunk_(const Index N, const int ThreadNumber, FunctionType Function)
+      {
+        const Index ChunkNumber = (N + ChunkSize_ - 1) / ChunkSize_;
+
+        GetThreadPool().parallelFor(static_cast<size_t>(ChunkNumber), [&](const size_t Chunk)
+        {
+          const Index Start = static_cast<Index>(Chunk) * ChunkSize_;
+          Function(static_cast<Index>(Chunk), Start, std::min(ChunkSize_, N - Start));
+        }, ThreadNumber);
+      }
+
+      /** normalize each sample over all components and return the sum before the normalization */
+      static double NormalizeResponsibilities_(Matrix &Responsibilities, const int ThreadNumber)
+      {
+        const Index M = Responsibilities.rows();
+        const Index N = Responsibilities.cols();
+        std::vector<double> ChunkSum((N + ChunkSize_ - 1) / ChunkSize_, 0.0);
+
+        ForEachChunk_(N, ThreadNumber, [&](Index Chunk, Index Start, Index Length)
+        {
+          auto Block = Responsibilities.middleCols(Start, Length);
+
+          /** catch numerical issues with the exp() */
+          Block = (Block.array().isFinite()).select(Block, 0.0);
+          ChunkSum.at(Chunk) = Block.sum();
+
+          for (Index n = 0; n < Length; ++n)
+          {
+            Block.col(n) /= Block.col(n).sum();
+          }
+
+          /** remove NaNs (occur if sum of likelihoods is zero) */
+          Block = (Block.array().isFinite()).select(Block, 1.0 / M);
+        });
+
+        double LikelihoodSum = 0.0;
+        for (const double Sum : ChunkSum)
+        {
+          LikelihoodSum += Sum;
+        }
+        return LikelihoodSum;
+      }
+
+      /** weighted sums per component, reduced chunk-wise in a fixed order */
+      static std::vector<SufficientStatistics> ComputeStatistics_(const ErrorMatType &DataMatrix, const Matrix &Weights, const int ThreadNumber)
+      {
+        const Index M = Weights.rows();
+        const Index N = DataMatrix.cols();
+        std::vector<std::vector<SufficientStatistics>> ChunkStatistics((N + ChunkSize_ - 1) / ChunkSize_,
+                                                                       std::vector<SufficientStatistics>(M));
+
+        ForEachChunk_(N, ThreadNumber, [&](Index Chunk, Index Start, Index Length)
+        {
+          AddStatistics_(DataMatrix, Weights, Start, Length, ChunkStatistics.at(Chunk));
+        });
+
+        std::vector<SufficientStatistics> Statistics(M);
+        for (const std::vector<SufficientStatistics> &Chunk : ChunkStatistics)
+        {
+          AddStatistics_(Chunk, Statistics);
+        }
+        return Statistics;
+      }
+
+      /** add the weighted samples [Start, Start + Length) to the statistics */
+      static void AddStatistics_(const ErrorMatType &DataMatrix, const Matrix &Weights, const Index Start, const Index Length,
+                                 std::vector<SufficientStatistics> &Statistics)
+      {
+        for (Index m = 0; m < Weights.rows(); ++m)
+        {
+          SufficientStatistics &Stat = Statistics.at(m);
+          for (Index n = Start; n < Start + Length; ++n)
+          {
+            Stat.add(DataMatrix.col(n), Weights(m, n));
+          }
+        }
+      }
+
+      /** merge the statistics of other samples */
+      static void AddStatistics_(const std::vector<SufficientStatistics> &Summand, std::vector<SufficientStatistics> &Statistics)
+      {
+        for (size_t m = 0; m < Statistics.size(); ++m)
+        {
+          Statistics.at(m).add(Summand.at(m));
+        }
+      }
+
+      /** chunks that are loaded and evaluated together, this bounds the memory of a streamed estimation */
+      static constexpr Index StreamGroupSize_ = 64;
+
+      /** Function(Samples, Weights) computes the M x Length weights of one chunk and returns its likelihood sum,
+       *  the statistics of all samples are merged group by group in the order of the chunks,
+       *  importance weights of the samples scale their statistics but not the returned likelihood */
+      template <typename FunctionType>
+      static double StreamStatistics_(const SampleStream &Stream, const Index M, const int ThreadNumber,
+                                      std::vector<SufficientStatistics> &Statistics, FunctionType Function)
+      {
+        const Index N = Stream.Number;
+        const Index ChunkNumber = (N + ChunkSize_ - 1) / ChunkSize_;
+        const Index GroupSize = std::min(StreamGroupSize_, ChunkNumber);
+
+        std::vector<ErrorMatType> Samples(GroupSize);
+        std::vector<std::vector<SufficientStatistics>> ChunkStatistics(GroupSize);
+        std::vector<double> ChunkSum(GroupSize, 0.0);
+
+        Statistics.assign(M, SufficientStatistics());
+        double LikelihoodSum = 0.0;
+
+        for (Index First = 0; First < ChunkNumber; First += GroupSize)
+        {
+          const Index Chunks = std::min(GroupSize, ChunkNumber - First);
+
+          /** the source is not required to be thread-safe */
+          for (Index c = 0; c < Chunks; ++c)
+          {
+            const Index Start = (First + c) * ChunkSize_;
+            Stream.Source(Start, std::min(ChunkSize_, N - Start), Samples.at(c));
+          }
+
+          GetThreadPool().parallelFor(static_cast<size_t>(Chunks), [&](const size_t c)
+          {
+            Matrix Weights;
+            ChunkSum.at(c) = Function(Samples.at(c), Weights);
+
+            if (Stream.Weights.size() > 0)
+            {
+              const Index Start = (First + static_cast<Index>(c)) * ChunkSize_;
+              Weights.array().rowwise() *= Stream.Weights.segment(Start, Samples.at(c).cols()).transpose().array();
+            }
+
+            ChunkStatistics.at(c).assign(M, SufficientStatistics());
+            AddStatistics_(Samples.at(c), Weights, 0, Samples.at(c).cols(), ChunkStatistics.at(c));
+          }, ThreadNumber);
+
+          for (Index c = 0; c < Chunks; ++c)
+          {
+            LikelihoodSum += ChunkSum.at(c);
+            AddStatistics_(ChunkStatistics.at(c), Statistics);
+          }
+        }
+        return LikelihoodSum;
+      }
+
+      /** E-step over all streamed samples, returns the likelihood sum and the statistics weighted with the responsibilities */
+      double streamProbability_(const SampleStream &Samples, const int ThreadNumber,
+                                std::vector<SufficientStatistics> &Statistics, const bool SinglePrecision = false) const
+      {
+        return StreamStatistics_(Samples, Mixture_.size(), ThreadNumber, Statistics,
+                                 [this, SinglePrecision](const ErrorMatType &Chunk, Matrix &Responsibilities)
+                                 {
+                                   return this->computeProbability(Chunk, Responsibilities, 1, SinglePrecision);
+                                 });
+      }
+
+      /** streamed sum of the (importance-weighted) log-likelihoods of all samples,
+       *  it is summed directly since the sufficient statistics only take positive weights */
+      double streamLogLikelihood_(const SampleStream &Stream, const int ThreadNumber) const
+      {
+        const Index N = Stream.Number;
+        const Index ChunkNumber = (N + ChunkSize_ - 1) / ChunkSize_;
+        const Index GroupSize = std::min(StreamGroupSize_, ChunkNumber);
+
+        std::vector<ErrorMatType> Samples(GroupSize);
+        std::vector<double> ChunkSum(GroupSize, 0.0);
+        double LogLikelihoodSum = 0.0;
+
+        for (Index First = 0; First < ChunkNumber; First += GroupSize)
+        {
+          const Index Chunks = std::min(GroupSize, ChunkNumber - First);
+
+          /** the source is not required to be thread-safe */
+          for (Index c = 0; c < Chunks; ++c)
+          {
+            const Index Start = (First + c) * ChunkSize_;
+            Stream.Source(Start, std::min(ChunkSize_, N - Start), Samples.at(c));
+          }
+
+          GetThreadPool().parallelFor(static_cast<size_t>(Chunks), [&](const size_t c)
+          {
+            Matrix NegLogLikelihood;
+            this->computeNegLogLikelihood(Samples.at(c), NegLogLikelihood);
+
+            /** log-sum-exp over the components */
+            const Eigen::Array<double, 1, Dynamic> Min = NegLogLikelihood.colwise().minCoeff().array();
+            const Eigen::Array<double, 1, Dynamic> LogLikelihood = ((-NegLogLikelihood.array()).rowwise() + Min).exp().colwise().sum().log() - Min;
+
+            if (Stream.Weights.size() > 0)
+            {
+              const Index Start = (First + static_cast<Index>(c)) * ChunkSize_;
+              ChunkSum.at(c) = (LogLikelihood * Stream.Weights.segment(Start, Samples.at(c).cols()).transpose().array()).sum();
+            }
+            else
+            {
+              ChunkSum.at(c) = LogLikelihood.sum();
+            }
+          }, ThreadNumber);
+
+          /** summed in the order of the chunks, so the result does not depend on the thread number */
+          for (Index c = 0; c < Chunks; ++c)
+          {
+            LogLikelihoodSum += ChunkSum.at(c);
+          }
+        }
+        return LogLikelihoodSum;
+      }
+
+      /** one E- and M-step */
+      double doExpectationMaximization_(const SampleStream &Samples, const EstimationConfig &Config)
+      {
+        /** E-step */
+        std::vector<SufficientStatistics> Statistics;
+        const double LikelihoodSum = this->streamProbability_(Samples, Config.ThreadNumber, Statistics, Config.SinglePrecisionEStep);
+
+        if (Config.EstimationAlgorithm == ErrorModelTuningType::EM)
+        {
+          /** M-Step maximum likelihood */
+          this->computeMixtureParameters(Statistics, Samples.size(), Config);
+        }
+        else
+        {
+          /** M-Step maximum-a-posteriori*/
+          this->computeMixtureParametersMAP(Statistics, Samples.size(), Config);
+        }
+
+        return LikelihoodSum;
+      }
+
+      /** weights, means and covariances of all components as one vector */
+      [[nodiscard]] Vector packMixture_() const
+      {
+        constexpr int Size = 1 + Dim + Dim * Dim;
+        Vector Parameter(Mixture_.size() * Size);
+        for (size_t m = 0; m < Mixture_.size(); ++m)
+        {
+          const MatrixStatic<Dim, Dim> Covariance = Mixture_.at(m).getCovariance();
+          Parameter(m * Size) = Mixture_.at(m).getWeight()(0);
+          Parameter.segment<Dim>(m * Size + 1) = Mixture_.at(m).getMean();
+          Parameter.segment<Dim * Dim>(m * Size + 1 + Dim) = Eigen::Map<const VectorStatic<Dim * Dim>>(Covariance.data());
+        }
+        return Parameter;
+      }
+
+      /** returns false and keeps the mixture if a weight or covariance is invalid */
+      bool unpackMixture_(const Vector &Parameter)
+      {
+        constexpr int Size = 1 + Dim + Dim * Dim;
+        std::vector<GaussianComponent<Dim>> Mixture(Mixture_.size());
+        for (size_t m = 0; m < Mixture_.size(); ++m)
+        {
+          const double Weight = Parameter(m * Size);
+          MatrixStatic<Dim, Dim> Covariance = Eigen::Map<const MatrixStatic<Dim, Dim>>(Parameter.data() + m * Size + 1 + Dim);
+          Covariance = 0.5 * (Covariance + Covariance.transpose());
+
+          if (!(Weight > 0.0 && Weight <= 1.0) || Eigen::LLT<MatrixStatic<Dim, Dim>>(Covariance).info() != Eigen::Success)
+          {
+            return false;
+          }
+
+          Mixture.at(m).setParamsCovariance(Covariance, Parameter.segment<Dim>(m * Size + 1), (Vector1() << Weight).finished());
+        }
+        Mixture_ = std::move(Mixture);
+        return true;
+      }
+
+      /** Implementation of:
+       * Ravi Varadhan and Christophe Roland
+       * Simple and Globally Convergent Methods for Accelerating the Convergence of Any EM Algorithm
+       * Scandinavian Journal of Statistics, 2008
+       *
+       * two EM steps define the extrapolation with the step length alpha = -|r|/|v| (variant S3),
+       * a third EM step stabilizes the extrapolated mixture, that is rejected if the log-likelihood decreases */
+      double doAcceleratedStep_(const SampleStream &Samples, const EstimationConfig &Config, double &LogLikelihood)
+      {
+        if (!std::isfinite(LogLikelihood))
+        {
+          LogLikelihood = this->streamLogLikelihood_(Samples, Config.ThreadNumber);
+        }
+
+        const Vector Theta0 = this->packMixture_();
+        this->doExpectationMaximization_(Samples, Config);
+        const Vector Theta1 = this->packMixture_();
+        const double LikelihoodSum = this->doExpectationMaximization_(Samples, Config);
+        const std::vector<GaussianComponent<Dim>> Mixture2 = Mixture_;
+        const Vector Theta2 = this->packMixture_();
+
+        const Vector R = Theta1 - Theta0;
+        const Vector V = Theta2 - Theta1 - R;
+        const double Alpha = (V.norm() > 0.0) ? std::min(-R.norm() / V.norm(), -1.0) : -1.0;
+
+        /** alpha = -1 is the plain second EM step */
+        if (Alpha < -1.0 && this->unpackMixture_(Theta0 - 2.0 * Alpha * R + Alpha * Alpha * V))
+        {
+          const double LikelihoodSumExtrapolated = this->doExpectationMaximization_(Samples, Config);
+          const double LogLikelihoodExtrapolated = this->streamLogLikelihood_(Samples, Config.ThreadNumber);
+
+          /** monotonicity safeguard */
+          if (std::isfinite(LogLikelihoodExtrapolated) && LogLikelihoodExtrapolated >= LogLikelihood)
+          {
+            LogLikelihood = LogLikelihoodExtrapolated;
+            return LikelihoodSumExtrapolated;
+          }
+        }
+
+        Mixture_ = Mixture2;
+        LogLikelihood = this->streamLogLikelihood_(Samples, Config.ThreadNumber);
+        return LikelihoodSum;
+      }
+
+      /** two passes like EstimateSampleCovariance(), to subtract the mean before the products are summed */
+      static MatrixStatic<Dim, Dim> StreamSampleCovariance_(const SampleStream &Stream)
+      {
+        const Index N = Stream.Number;
+        const bool IsWeighted = (Stream.Weights.size() > 0);
+        ErrorMatType Samples;
+
+        VectorStatic<Dim> Mean = VectorStatic<Dim>::Zero();
+        for (Index Start = 0; Start < N; Start += ChunkSize_)
+        {
+          const Index Length = std::min(ChunkSize_, N - Start);
+          Stream.Source(Start, Length, Samples);
+          Mean += IsWeighted ? VectorStatic<Dim>(Samples * Stream.Weights.segment(Start, Length)) : VectorStatic<Dim>(Samples.rowwise().sum());
+        }
+        Mean /= Stream.size();
+
+        MatrixStatic<Dim, Dim> Covariance = MatrixStatic<Dim, Dim>::Zero();
+        for (Index Start = 0; Start < N; Start += ChunkSize_)
+        {
+          const Index Length = std::min(ChunkSize_, N - Start);
+          Stream.Source(Start, Length, Samples);
+          Samples.colwise() -= Mean;
+          if (IsWeighted)
+          {
+            Covariance.noalias() += Samples * Stream.Weights.segment(Start, Length).asDiagonal() * Samples.transpose();
+          }
+          else
+          {
+            Covariance.noalias() += Samples * Samples.transpose();
+          }
+        }
+
+        return Covariance / (Stream.size() - 1.0);
+      }
+
+      /** lightweight coreset (Bachem et al., "Scalable k-Means Clustering via Lightweight Coresets", KDD 2018):
+       *  samples are drawn with q(x) = 1/(2N) + d(x, mean)^2 / (2 Sum(d^2)) and weighted with 1/(Size q(x)),
+       *  so the weighted sums are unbiased and the tails, which define the outlier components, are kept */
+      static SampleStream BuildCoreset_(const SampleStream &Stream, const Index Size)
+      {
+        const Index N = Stream.Number;
+        ErrorMatType Samples;
+
+        /** mean and sum of the squared distances */
+        VectorStatic<Dim> Mean = VectorStatic<Dim>::Zero();
+        for (Index Start = 0; Start < N; Start += ChunkSize_)
+        {
+          Stream.Source(Start, std::min(ChunkSize_, N - Start), Samples);
+          Mean += Samples.rowwise().sum();
+        }
+        Mean /= static_cast<double>(N);
+
+        double DistanceSum = 0.0;
+        for (Index Start = 0; Start < N; Start += ChunkSize_)
+        {
+          Stream.Source(Start, std::min(ChunkSize_, N - Start), Samples);
+          DistanceSum += (Samples.colwise() - Mean).colwise().squaredNorm().sum();
+        }
+        const double DistanceScale = (DistanceSum > 0.0) ? 0.5 / DistanceSum : 0.0;
+        const double UniformPart = (DistanceSum > 0.0) ? 0.5 / static_cast<double>(N) : 1.0 / static_cast<double>(N);
+
+        /** sorted positions on the cumulative distribution, so one sequential pass draws all of them (with replacement) */
+        std::mt19937 Generator;
+        std::uniform_real_distribution<double> Uniform(0.0, 1.0);
+        std::vector<double> Positions(Size);
+        for (double &Position : Positions)
+        {
+          Position = Uniform(Generator);
+        }
+        std::sort(Positions.begin(), Positions.end());
+
+        auto Coreset = std::make_shared<ErrorMatType>(Dim, Size);
+        SampleStream Result;
+        Result.Number = Size;
+        Result.Weights.resize(Size);
+
+        double Cumulative = 0.0;
+        Index Drawn = 0;
+        for (Index Start = 0; Start < N && Drawn < Size; Start += ChunkSize_)
+        {
+          Stream.Source(Start, std::min(ChunkSize_, N - Start), Samples);
+          for (Index n = 0; n < Samples.cols() && Drawn < Size; ++n)
+          {
+            const double Probability = UniformPart + DistanceScale * (Samples.col(n) - Mean).squaredNorm();
+            Cumulative += Probability;
+            while (Drawn < Size && Positions.at(Drawn) < Cumulative)
+            {
+              Coreset->col(Drawn) = Samples.col(n);
+              Result.Weights(Drawn) = 1.0 / (static_cast<double>(Size) * Probability);
+              Drawn++;
+            }
+          }
+        }
+
+        /** round-off of the cumulative sum can leave the last positions behind */
+        Coreset->conservativeResize(Dim, Drawn);
+        Result.Weights.conservativeResize(Drawn);
+        Result.Number = Drawn;
+
+        Result.Source = [Coreset](const Index Start, const Index Length, ErrorMatType &Chunk)
+                        {
+                          Chunk = Coreset->middleCols(Start, Length);
+                        };
+        return Result;
+      }
+
       std::vector<GaussianComponent<Dim>> Mixture_;
+
+      /** convergence tracking of the last estimation */
+      std::vector<double> LikelihoodHistory_;
+
+      /** decayed statistics of the online estimation */
+      std::vector<SufficientStatistics> OnlineStatistics_;
+      double OnlineSampleSize_ = 0.0;
+      MatrixStatic<Dim, Dim> OnlinePriorScatter_ = MatrixStatic<Dim, Dim>::Identity();
   };
 }
 
@@ -77,13 +77,14 @@ namespace libRSF
   class cDCELoss : public ceres::LossFunction
   {
   public:
-      explicit cDCELoss(double Sigma) : Sigma_(Sigma) {};
+      explicit cDCELoss(double Sigma) : SigmaSquared_(Sigma * Sigma), InvSigmaSquared_(1.0 / (Sigma * Sigma)) {};
       ~cDCELoss() override = default;
 
       void Evaluate(double, double*) const override;
 
   private:
-    const double Sigma_;
+    const double SigmaSquared_;
+    const double InvSigmaSquared_;
   };
 
   /** \brief M-estimator representing a Student's t-distribution
@@ -93,14 +94,14 @@ namespace libRSF
   class StudentLoss : public ceres::LossFunction
   {
   public:
-      explicit StudentLoss(const double Nu, const double Dim) : Nu_(Nu), Dim_(Dim) {};
+      explicit StudentLoss(const double Nu, const double Dim) : Nu_(Nu), NuPlusDim_(Nu + Dim) {};
       ~StudentLoss() override = default;
 
       void Evaluate(double, double*) const override;
 
   private:
     const double Nu_;
-    const double Dim_;
+    const double NuPlusDim_;
   };
 
   /** \brief M-estimator exactly representing a Cauchy distribution
@@ -133,14 +134,21 @@ namespace libRSF
   class GeneralAdaptiveLoss : public ceres::LossFunction
   {
   public:
-      explicit GeneralAdaptiveLoss(const double Alpha, const double C = 1.0) : Alpha_(Alpha), Cov_(C*C) {};
+      explicit GeneralAdaptiveLoss(double Alpha, double C = 1.0);
       ~GeneralAdaptiveLoss() override = default;
 
       void Evaluate(double, double*) const override;
 
   private:
-    const double Alpha_;
-    const double Cov_;
+    /** special shapes with a closed form that avoids pow() */
+    enum class Shape {Gaussian, Charbonnier, Cauchy, GemanMcClure, Welsch, General};
+
+    Shape Shape_;
+    double Alpha_;
+    double InvCov_;
+    double InvCovScaled_;   /**< 1 / (Cov * |Alpha - 2|) */
+    double Scale0_;         /**< 2 * |Alpha - 2| / Alpha */
+    double Scale2_;         /**< (Alpha/2 - 1) / (Cov^2 * |Alpha - 2|) */
   };
 }
 
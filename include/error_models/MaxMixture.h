@@ -37,6 +37,9 @@
 
 #include <ceres/ceres.h>
 
+#include <memory>
+#include <numeric>
+
 namespace libRSF
 {
   /** \brief The robust Max-Mixture error model
@@ -54,52 +57,54 @@ namespace libRSF
   {
     public:
 
-      MaxMixture()
-      {
-        Normalization_ = std::numeric_limits<double>::lowest();
-      }
+      MaxMixture() : Parameters_(empty_())
+      {}
 
       virtual ~MaxMixture() = default;
 
-      explicit MaxMixture(const MixtureType &Mixture) : Normalization_(std::numeric_limits<double>::lowest())
+      explicit MaxMixture(const MixtureType &Mixture)
       {
         this->addMixture_(Mixture);
       }
 
       void clear()
       {
-        Normalization_ = std::numeric_limits<double>::lowest();
-        Mixture_.clear();
+        Parameters_ = empty_();
       }
 
       template <typename T>
       bool weight(const VectorT<T, Dim> &RawError, T* Error) const
       {
-        if(this->Enable_)
+        if(this->isEnabled())
         {
           /** map the error pointer to a matrix */
           VectorRef<T, Dim+1> ErrorMap(Error);
 
-          T Loglike = T(std::numeric_limits<double>::quiet_NaN());
-
-          MatrixT<T, Dim + 1, 1> ErrorShadow, ErrorShadowBest;
-
-          const int NumberOfComponents = Mixture_.getNumberOfComponents();
-
-          /** calculate Log-Likelihood for each Gaussian component */
-          for(int nComponent = 0; nComponent < NumberOfComponents; ++nComponent)
+          /** the selection does not depend on the derivatives, so it is done with plain doubles */
+          VectorStatic<Dim> RawErrorScalar;
+          if constexpr (std::is_same_v<T, double>)
           {
-            ErrorShadow << Mixture_.template getExponentialPartOfComponent<T>(nComponent, RawError),
-                           sqrt(ceres::fmax(-2.0 * T(log(Mixture_.template getLinearPartOfComponent<T>(nComponent, RawError) / Normalization_)), T(1e-10)));/** fmax() is required to handle numeric tolerances */
-
-            /** keep only the most likely component */
-            if(ErrorShadow.squaredNorm() < Loglike || ceres::IsNaN(Loglike))
+            RawErrorScalar = RawError;
+          }
+          else
+          {
+            for (int nDim = 0; nDim < Dim; ++nDim)
             {
-              Loglike = ErrorShadow.squaredNorm();
-              ErrorShadowBest = ErrorShadow;
+              RawErrorScalar(nDim) = RawError(nDim).a;
             }
           }
-          ErrorMap = ErrorShadowBest;
+          const int Best = this->findMostLikelyComponent_(RawErrorScalar);
+
+          if (Best < 0)
+          {
+            PRINT_ERROR("Max-Mixture without valid component!");
+            return false;
+          }
+
+          /** only the most likely component contributes */
+          const Parameters &Params = *Parameters_;
+          ErrorMap.template head<Dim>() = Params.SqrtInformations.at(Best).template cast<T>() * (RawError + Params.Means.at(Best).template cast<T>());
+          ErrorMap(Dim) = T(Params.NonLinearErrors.at(Best));
         }
         else
         {
@@ -114,25 +119,151 @@ namespace libRSF
         return true;
       }
 
+      /** checkpoint interface, the cached values are recomputed from the mixture */
+      void serialize(CheckpointWriter &Writer) const
+      {
+        Parameters_->Mixture.serialize(Writer);
+      }
+
+      bool deserialize(CheckpointReader &Reader)
+      {
+        MixtureType Mixture;
+        if (!Mixture.deserialize(Reader))
+        {
+          return false;
+        }
+        this->clear();
+        this->addMixture_(Mixture);
+        return true;
+      }
+
     private:
+      /** everything that is derived from the mixture, it is immutable and shared between all copies of the model */
+      struct Parameters
+      {
+        MixtureType Mixture;
+        double Normalization = std::numeric_limits<double>::lowest();
+
+        /** per component constants */
+        VectorVectorSTL<Dim> Means;
+        MatrixVectorSTL<Dim, Dim> SqrtInformations;
+        std::vector<double> NonLinearErrors;
+
+        /** lower bound of the cost: NonLinearError^2 + MinInformation * |RawError + Mean|^2 */
+        std::vector<double> MinInformations;
+
+        /** components sorted by their constant part of the cost */
+        std::vector<int> Order;
+      };
+
+      static const std::shared_ptr<const Parameters> &empty_()
+      {
+        static const std::shared_ptr<const Parameters> Empty = std::make_shared<const Parameters>();
+        return Empty;
+      }
 
       void addMixture_(const MixtureType &Mixture)
       {
-        Mixture_ = Mixture;
+        auto Params = std::make_shared<Parameters>();
+        Params->Mixture = Mixture;
         const int NumberOfComponents = Mixture.getNumberOfComponents();
 
         if (NumberOfComponents > 0)
         {
-          Normalization_ = Mixture.getMaximumOfComponent(0);
+          Params->Normalization = Mixture.getMaximumOfComponent(0);
           for(int nComponent = 1; nComponent < NumberOfComponents; ++nComponent)
           {
-            Normalization_ = std::max(Normalization_, Mixture.getMaximumOfComponent(nComponent));
+            Params->Normalization = std::max(Params->Normalization, Mixture.getMaximumOfComponent(nComponent));
           }
         }
+
+        /** cache the constant parts of each component */
+        Params->Means.resize(NumberOfComponents);
+        Params->SqrtInformations.resize(NumberOfComponents);
+        Params->NonLinearErrors.resize(NumberOfComponents);
+        for(int nComponent = 0; nComponent < NumberOfComponents; ++nComponent)
+        {
+          Params->Means.at(nComponent) = Mixture.getMeanOfComponent(nComponent);
+          Params->SqrtInformations.at(nComponent) = Mixture.getSqrtInformationOfComponent(nComponent);
+
+          /** max() is required to handle numeric tolerances */
+          Params->NonLinearErrors.at(nComponent) = sqrt(std::max(-2.0 * log(Mixture.getMaximumOfComponent(nComponent) / Params->Normalization), 1e-10));
+        }
+
+        /** smallest eigenvalue of each information matrix */
+        Params->MinInformations.resize(NumberOfComponents);
+        for(int nComponent = 0; nComponent < NumberOfComponents; ++nComponent)
+        {
+          const MatrixStatic<Dim, Dim> Information = Params->SqrtInformations.at(nComponent).transpose() * Params->SqrtInformations.at(nComponent);
+          const Eigen::SelfAdjointEigenSolver<MatrixStatic<Dim, Dim>> Solver(Information, Eigen::EigenvaluesOnly);
+          Params->MinInformations.at(nComponent) = std::max(Solver.eigenvalues().minCoeff(), 0.0);
+        }
+
+        Params->Order.resize(NumberOfComponents);
+        std::iota(Params->Order.begin(), Params->Order.end(), 0);
+        std::stable_sort(Params->Order.begin(), Params->Order.end(), [&Params](const int A, const int B)
+        {
+          return Params->NonLinearErrors.at(A) < Params->NonLinearErrors.at(B);
+        });
+
+        Parameters_ = std::move(Params);
+      }
+
+      /** cost of one component */
+      [[nodiscard]] double getCost_(const VectorStatic<Dim> &RawError, const int Component) const
+      {
+        const Parameters &Params = *Parameters_;
+        return (Params.SqrtInformations[Component] * (RawError + Params.Means[Component])).squaredNorm()
+               + Params.NonLinearErrors[Component] * Params.NonLinearErrors[Component];
+      }
+
+      /** index of the component with the lowest negative log-likelihood
+       * The last winner of this factor is evaluated first, the others in the order of their constant cost,
+       * so that the search ends as soon as that constant part alone is higher than the current best.
+       * Ties are resolved to the lowest index like an exhaustive search.
+       */
+      [[nodiscard]] int findMostLikelyComponent_(const VectorStatic<Dim> &RawError) const
+      {
+        const Parameters &Params = *Parameters_;
+        const int NumberOfComponents = Params.NonLinearErrors.size();
+        if (NumberOfComponents == 0)
+        {
+          return -1;
+        }
+
+        int Best = (LastBest_ < NumberOfComponents) ? LastBest_ : 0;
+        double BestCost = this->getCost_(RawError, Best);
+
+        for (const int nComponent : Params.Order)
+        {
+          const double Constant = Params.NonLinearErrors[nComponent] * Params.NonLinearErrors[nComponent];
+          if (Constant > BestCost)
+          {
+            break;
+          }
+          if (nComponent == Best ||
+              Constant + Params.MinInformations[nComponent] * (RawError + Params.Means[nComponent]).squaredNorm() > BestCost)
+          {
+            continue;
+          }
+
+          const double Cost = this->getCost_(RawError, nComponent);
+          if (Cost < BestCost || (Cost == BestCost && nComponent < Best) || std::isnan(BestCost))
+          {
+            BestCost = Cost;
+            Best = nComponent;
+          }
+        }
+
+        LastBest_ = Best;
+        return Best;
       }
 
-      MixtureType Mixture_;
-      double Normalization_;
+      /** copies and assignments only share the pointer */
+      std::shared_ptr<const Parameters> Parameters_;
+
+      /** winner of the last evaluation, each factor holds its own copy of the model */
+      mutable int LastBest_ = 0;
   };
 
   using MaxMix1 = MaxMixture<1, GaussianMixture<1>>;
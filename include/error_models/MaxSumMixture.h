@@ -36,6 +36,8 @@
 #include "GaussianMixture.h"
 #include "../NumericalRobust.h"
 
+#include <memory>
+
 namespace libRSF
 {
   extern const double DampingFactor;
@@ -50,10 +52,8 @@ namespace libRSF
   {
     public:
 
-      MaxSumMixture()
-      {
-        this->clear();
-      }
+      MaxSumMixture() : Mixture_(empty_())
+      {}
 
       virtual ~MaxSumMixture() = default;
 
@@ -65,24 +65,25 @@ namespace libRSF
       void clear()
       {
         Normalization_ = 0;
-        Mixture_.clear();
+        Mixture_ = empty_();
       }
 
       template <typename T>
       bool weight(const VectorT<T, Dim> &RawError, T* Error) const
       {
-        if(this->Enable_)
+        if(this->isEnabled())
         {
           /** calculate linear errors and scalings */
-          const int NumberOfComponents = Mixture_.getNumberOfComponents();
+          const MixtureType &Mixture = *Mixture_;
+          const int NumberOfComponents = Mixture.getNumberOfComponents();
           MatrixT<T, Dynamic, 1> Scalings(NumberOfComponents);
           MatrixT<T, Dynamic, Dim> LinearExponents(NumberOfComponents, Dim);
 
           /** calculate component-wise */
           for(int nComponent = 0; nComponent < NumberOfComponents; ++nComponent)
           {
-            LinearExponents.row(nComponent) = Mixture_.template getExponentialPartOfComponent<T>(nComponent, RawError);
-            Scalings(nComponent) = T(Mixture_.template getLinearPartOfComponent<T>(nComponent, RawError));
+            LinearExponents.row(nComponent) = Mixture.template getExponentialPartOfComponent<T>(nComponent, RawError);
+            Scalings(nComponent) = T(Mixture.template getLinearPartOfComponent<T>(nComponent, RawError));
           }
 
           /** apply the LSE */
@@ -125,14 +126,38 @@ namespace libRSF
 
       MixtureType getMixture()
       {
-        return Mixture_;
+        return *Mixture_;
+      }
+
+      /** checkpoint interface, the cached values are recomputed from the mixture */
+      void serialize(CheckpointWriter &Writer) const
+      {
+        Mixture_->serialize(Writer);
+      }
+
+      bool deserialize(CheckpointReader &Reader)
+      {
+        MixtureType Mixture;
+        if (!Mixture.deserialize(Reader))
+        {
+          return false;
+        }
+        this->clear();
+        this->addMixture_(Mixture);
+        return true;
       }
 
     private:
 
+      static const std::shared_ptr<const MixtureType> &empty_()
+      {
+        static const std::shared_ptr<const MixtureType> Empty = std::make_shared<const MixtureType>();
+        return Empty;
+      }
+
       void addMixture_(const MixtureType &Mixture)
       {
-        Mixture_ = Mixture;
+        Mixture_ = std::make_shared<const MixtureType>(Mixture);
         const int NumberOfComponents = Mixture.getNumberOfComponents();
 
         Normalization_ = Mixture.getMaximumOfComponent(0);
@@ -143,7 +168,8 @@ namespace libRSF
         Normalization_ *= NumberOfComponents;
       }
 
-      MixtureType Mixture_;
+      /** the mixture is immutable and shared between all copies of the model */
+      std::shared_ptr<const MixtureType> Mixture_;
       double Normalization_{0};
   };
 
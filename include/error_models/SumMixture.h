@@ -36,6 +36,8 @@
 #include "GaussianMixture.h"
 #include "../NumericalRobust.h"
 
+#include <memory>
+
 namespace libRSF
 {
   /** \brief The robust Sum-Mixture error model
@@ -52,21 +54,19 @@ namespace libRSF
   class SumMixture : public ErrorModel <Dim, Dim>
   {
   public:
-    SumMixture()
-    { Normalization_ = 0;
-    }
+    SumMixture() : Parameters_(empty_())
+    {}
 
     virtual ~SumMixture() = default;
 
-    explicit SumMixture(const MixtureType &Mixture): Normalization_(0)
+    explicit SumMixture(const MixtureType &Mixture)
     {
       this->addMixture_(Mixture);
     }
 
     void clear()
     {
-      Normalization_ = 0;
-      Mixture_.clear();
+      Parameters_ = empty_();
     }
 
     template <typename T>
@@ -75,22 +75,44 @@ namespace libRSF
       /** map error to eigen matrix for easier access */
       VectorRef<T, Dim> ErrorMap(Error);
 
-      if(this->Enable_)
+      if(this->isEnabled())
       {
-        const int NumberOfComponents = Mixture_.getNumberOfComponents();
-
-        MatrixT<T, Dynamic, 1> Scalings(NumberOfComponents);
-        MatrixT<T, Dynamic, 1> Exponents(NumberOfComponents);
+        /** numerically robust log-sum-exp in a single pass, components with zero scaling are skipped */
+        T MaxExp = T(0.0);
+        T Sum = T(0.0);
+        bool IsFirst = true;
 
-        /** calculate all exponents and scalings */
+        const Parameters &Params = *Parameters_;
+        const int NumberOfComponents = Params.LogScalings.size();
         for(int nComponent = 0; nComponent < NumberOfComponents; ++nComponent)
         {
-          Exponents(nComponent) = - 0.5 * (Mixture_.template getExponentialPartOfComponent<T>(nComponent, RawError).squaredNorm() + 1e-10);
-          Scalings(nComponent) = T(Mixture_.template getLinearPartOfComponent<T>(nComponent, RawError));
+          if (!std::isfinite(Params.LogScalings[nComponent]))
+          {
+            continue;
+          }
+
+          const VectorT<T, Dim> Exponential = Params.SqrtInformations[nComponent].template cast<T>() * (RawError + Params.Means[nComponent].template cast<T>());
+          const T Exponent = -0.5 * (Exponential.squaredNorm() + 1e-10) + Params.LogScalings[nComponent];
+
+          if (IsFirst)
+          {
+            MaxExp = Exponent;
+            Sum = T(1.0);
+            IsFirst = false;
+          }
+          else if (Exponent > MaxExp)
+          {
+            Sum = Sum * exp(MaxExp - Exponent) + 1.0;
+            MaxExp = Exponent;
+          }
+          else
+          {
+            Sum += exp(Exponent - MaxExp);
+          }
         }
 
-        /** combine them numerically robust and distribute the error equally over all dimensions */
-        ErrorMap.fill(sqrt(-2.0* (ScaledLogSumExp(Exponents, Scalings) - log(Normalization_ + 1e-10))) / sqrt(Dim));
+        /** combine them and distribute the error equally over all dimensions */
+        ErrorMap.fill(sqrt(-2.0 * (log(Sum) + MaxExp - Params.LogNormalization)) / sqrt(Dim));
       }
       else
       {
@@ -101,37 +123,88 @@ namespace libRSF
       return true;
     }
 
+    /** checkpoint interface, the cached values are recomputed from the mixture */
+    void serialize(CheckpointWriter &Writer) const
+    {
+      Parameters_->Mixture.serialize(Writer);
+    }
+
+    bool deserialize(CheckpointReader &Reader)
+    {
+      MixtureType Mixture;
+      if (!Mixture.deserialize(Reader))
+      {
+        return false;
+      }
+      this->clear();
+      this->addMixture_(Mixture);
+      return true;
+    }
+
   private:
+    /** everything that is derived from the mixture, it is immutable and shared between all copies of the model */
+    struct Parameters
+    {
+      MixtureType Mixture;
+      double Normalization = 0.0;
+      double LogNormalization = 0.0;
+
+      /** per component constants */
+      VectorVectorSTL<Dim> Means;
+      MatrixVectorSTL<Dim, Dim> SqrtInformations;
+      std::vector<double> LogScalings;
+    };
+
+    static const std::shared_ptr<const Parameters> &empty_()
+    {
+      static const std::shared_ptr<const Parameters> Empty = std::make_shared<const Parameters>();
+      return Empty;
+    }
 
     void addMixture_(const MixtureType &Mixture)
     {
-      Mixture_ = Mixture;
+      auto Params = std::make_shared<Parameters>();
+      Params->Mixture = Mixture;
 
       const int NumberOfComponents = Mixture.getNumberOfComponents();
 
       if constexpr(!SpecialNormalization)
       {
         /** original version */
-        Normalization_ = 0;
+        Params->Normalization = 0;
         for(int nComponent = 0; nComponent < NumberOfComponents; ++nComponent)
         {
-          Normalization_ += Mixture.getMaximumOfComponent(nComponent);
+          Params->Normalization += Mixture.getMaximumOfComponent(nComponent);
         }
       }
       else
       {
         /** version for Reviewer 3 */
-        Normalization_ = Mixture.getMaximumOfComponent(0);
+        Params->Normalization = Mixture.getMaximumOfComponent(0);
         for(int nComponent = 1; nComponent < NumberOfComponents; ++nComponent)
         {
-          Normalization_ = std::max(Normalization_, Mixture.getMaximumOfComponent(nComponent));
+          Params->Normalization = std::max(Params->Normalization, Mixture.getMaximumOfComponent(nComponent));
         }
-        Normalization_ = Normalization_ *NumberOfComponents + 10;
+        Params->Normalization = Params->Normalization *NumberOfComponents + 10;
       }
+      Params->LogNormalization = log(Params->Normalization + 1e-10);
+
+      /** cache the constant parts of each component, a zero scaling results in -inf */
+      Params->Means.resize(NumberOfComponents);
+      Params->SqrtInformations.resize(NumberOfComponents);
+      Params->LogScalings.resize(NumberOfComponents);
+      for(int nComponent = 0; nComponent < NumberOfComponents; ++nComponent)
+      {
+        Params->Means.at(nComponent) = Mixture.getMeanOfComponent(nComponent);
+        Params->SqrtInformations.at(nComponent) = Mixture.getSqrtInformationOfComponent(nComponent);
+        Params->LogScalings.at(nComponent) = log(Mixture.getMaximumOfComponent(nComponent));
+      }
+
+      Parameters_ = std::move(Params);
     }
 
-    MixtureType Mixture_;
-    double Normalization_;
+    /** copies and assignments only share the pointer */
+    std::shared_ptr<const Parameters> Parameters_;
   };
 
   using SumMix1 = SumMixture<1, GaussianMixture<1>, false>;
@@ -66,7 +66,7 @@ namespace libRSF
       template <typename T>
       bool weight(const VectorT<T, Dim> &RawError, const T* const SwitchVariable, T* Error) const
       {
-        if (this->Enable_)
+        if (this->isEnabled())
         {
           /** evaluate with the non-robust model */
           BaseModel_.weight(RawError, Error);
@@ -93,6 +93,18 @@ namespace libRSF
         return true;
       }
 
+      /** checkpoint interface */
+      void serialize(CheckpointWriter &Writer) const
+      {
+        Writer.write(Sigma_);
+        BaseModel_.serialize(Writer);
+      }
+
+      bool deserialize(CheckpointReader &Reader)
+      {
+        return Reader.read(Sigma_) && BaseModel_.deserialize(Reader);
+      }
+
   private:
     double Sigma_ = 1.0;
     BaseModelType BaseModel_;
@@ -0,0 +1,220 @@
+/***************************************************************************
+ * libRSF - A Robust Sensor Fusion Library
+ *
+ * Copyright (C) 2018 Chair of Automation Technology / TU Chemnitz
+ * For more information see https://www.tu-chemnitz.de/etit/proaut/libRSF
+ *
+ * libRSF is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libRSF is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with libRSF.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Tim Pfeifer (tim.pfeifer@etit.tu-chemnitz.de)
+ ***************************************************************************/
+
+/**
+ * @file AnalyticCostFunction.h
+ * @author Tim Pfeifer
+ * @date 14.10.2026
+ * @brief Cost function for factors that provide the derivative of their error.
+ * @copyright GNU Public License.
+ *
+ */
+
+#ifndef ANALYTICCOSTFUNCTION_H
+#define ANALYTICCOSTFUNCTION_H
+
+#include "../VectorTypes.h"
+
+#include <ceres/ceres.h>
+
+#include <array>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace libRSF
+{
+  /** detect factors that implement EvaluateWithJacobian() */
+  template <typename FactorClass, typename = void>
+  struct HasAnalyticJacobian : std::false_type {};
+
+  template <typename FactorClass>
+  struct HasAnalyticJacobian<FactorClass, std::void_t<decltype(&FactorClass::EvaluateWithJacobian)>> : std::true_type {};
+
+  /** detect factors that implement EvaluateWithJacobians() for a vector-valued error */
+  template <typename FactorClass, typename = void>
+  struct HasAnalyticJacobians : std::false_type {};
+
+  template <typename FactorClass>
+  struct HasAnalyticJacobians<FactorClass, std::void_t<decltype(&FactorClass::EvaluateWithJacobians)>> : std::true_type {};
+
+  /** the error model is applied by forward differentiation w.r.t. the raw error and its own states, like the switch of SC */
+  template <typename FactorClass, typename ErrorType>
+  constexpr bool UseAnalyticJacobian()
+  {
+    return (HasAnalyticJacobian<FactorClass>::value && ErrorType::InputDim == 1) || HasAnalyticJacobians<FactorClass>::value;
+  }
+
+  /** sum of the dimensions of an integer sequence */
+  template <int... Dims>
+  constexpr int SumOfDims(std::integer_sequence<int, Dims...> /*Dims*/)
+  {
+    return (0 + ... + Dims);
+  }
+
+  /** \brief Applies the error model to an analytic geometric Jacobian.
+   *
+   * StateDims contains the states of the factor followed by the states of the error model.
+   * Scalar errors come from EvaluateWithJacobian(States, Error, Gradients), vector errors from
+   * EvaluateWithJacobians(States, Error, Jacobians) with one row-major [error x state] block per state,
+   * which is skipped if Jacobians is a null pointer.
+   */
+  template <typename FactorClass, typename ErrorType, int... StateDims>
+  class AnalyticCostFunction : public ceres::SizedCostFunction<ErrorType::OutputDim, StateDims...>
+  {
+    static constexpr int StateNumber = sizeof...(StateDims);
+    static constexpr int ErrorStateNumber = static_cast<int>(ErrorType::StateDims::size());
+    static constexpr int FactorStateNumber = StateNumber - ErrorStateNumber;
+    static constexpr int ErrorStateSize = SumOfDims(typename ErrorType::StateDims{});
+    static constexpr int ErrorDim = ErrorType::InputDim;
+
+    /** one derivative for each entry of the raw error and of the error model states */
+    using JetType = ceres::Jet<double, ErrorDim + ErrorStateSize>;
+
+    public:
+      /** takes the ownership of the factor, like ceres::AutoDiffCostFunction */
+      explicit AnalyticCostFunction(FactorClass *Factor) : Factor_(Factor) {}
+      ~AnalyticCostFunction() override = default;
+
+      bool Evaluate(double const* const* Parameters, double* Residuals, double** Jacobians) const override
+      {
+        constexpr std::array<int, StateNumber> Dims = {StateDims...};
+
+        /** geometric error and its Jacobian for each state of the factor */
+        std::array<double, ErrorDim * (StateDims + ...)> Gradient{};
+        std::array<double*, StateNumber> GradientPointers{};
+        int Offset = 0;
+        for (int nState = 0; nState < FactorStateNumber; nState++)
+        {
+          GradientPointers[nState] = Gradient.data() + Offset;
+          Offset += ErrorDim * Dims[nState];
+        }
+
+        /** the scalar interface always computes the gradient */
+        double **Gradients = (Jacobians != nullptr || !HasAnalyticJacobians<FactorClass>::value) ? GradientPointers.data() : nullptr;
+
+        VectorStatic<ErrorDim> Error;
+        if (!this->evaluate_(Parameters, Error, Gradients))
+        {
+          return false;
+        }
+
+        if (Jacobians == nullptr)
+        {
+          return weight_<double>(Error, Parameters + FactorStateNumber, Residuals, std::make_index_sequence<ErrorStateNumber>{});
+        }
+
+        /** seed the derivatives of the raw error and the error model states */
+        VectorT<JetType, ErrorDim> ErrorJet;
+        for (int nError = 0; nError < ErrorDim; nError++)
+        {
+          ErrorJet(nError) = JetType(Error(nError), nError);
+        }
+
+        std::array<JetType, ErrorStateSize + 1> StateJets;
+        std::array<const JetType*, ErrorStateNumber + 1> StateJetPointers{};
+        int Derivative = 0;
+        for (int nState = FactorStateNumber; nState < StateNumber; nState++)
+        {
+          StateJetPointers[nState - FactorStateNumber] = StateJets.data() + Derivative;
+          for (int nDim = 0; nDim < Dims[nState]; nDim++)
+          {
+            StateJets[Derivative] = JetType(Parameters[nState][nDim], ErrorDim + Derivative);
+            Derivative++;
+          }
+        }
+
+        std::array<JetType, ErrorType::OutputDim> ResidualJets;
+        if (!weight_<JetType>(ErrorJet, StateJetPointers.data(), ResidualJets.data(), std::make_index_sequence<ErrorStateNumber>{}))
+        {
+          return false;
+        }
+
+        /** chain rule for the factor states, the error model states are differentiated directly */
+        for (int nResidual = 0; nResidual < ErrorType::OutputDim; nResidual++)
+        {
+          Residuals[nResidual] = ResidualJets[nResidual].a;
+        }
+
+        for (int nState = 0; nState < FactorStateNumber; nState++)
+        {
+          if (Jacobians[nState] != nullptr)
+          {
+            for (int nResidual = 0; nResidual < ErrorType::OutputDim; nResidual++)
+            {
+              for (int nDim = 0; nDim < Dims[nState]; nDim++)
+              {
+                double Sum = 0.0;
+                for (int nError = 0; nError < ErrorDim; nError++)
+                {
+                  Sum += ResidualJets[nResidual].v(nError) * GradientPointers[nState][nError * Dims[nState] + nDim];
+                }
+                Jacobians[nState][nResidual * Dims[nState] + nDim] = Sum;
+              }
+            }
+          }
+        }
+
+        Derivative = 0;
+        for (int nState = FactorStateNumber; nState < StateNumber; nState++)
+        {
+          if (Jacobians[nState] != nullptr)
+          {
+            for (int nResidual = 0; nResidual < ErrorType::OutputDim; nResidual++)
+            {
+              for (int nDim = 0; nDim < Dims[nState]; nDim++)
+              {
+                Jacobians[nState][nResidual * Dims[nState] + nDim] = ResidualJets[nResidual].v(ErrorDim + Derivative + nDim);
+              }
+            }
+          }
+          Derivative += Dims[nState];
+        }
+
+        return true;
+      }
+
+    private:
+      bool evaluate_(double const* const* Parameters, VectorStatic<ErrorDim> &Error, double **Gradients) const
+      {
+        if constexpr (HasAnalyticJacobians<FactorClass>::value)
+        {
+          return Factor_->EvaluateWithJacobians(Parameters, Error.data(), Gradients);
+        }
+        else
+        {
+          return Factor_->EvaluateWithJacobian(Parameters, Error(0), Gradients);
+        }
+      }
+
+      /** the error model takes its states between the raw error and the output */
+      template <typename T, typename StatePointerType, size_t... ErrorStates>
+      bool weight_(const VectorT<T, ErrorDim> &Error, StatePointerType States, T* Residuals, std::index_sequence<ErrorStates...> /*Index*/) const
+      {
+        return Factor_->getErrorModel()->template weight<T>(Error, States[ErrorStates]..., Residuals);
+      }
+
+      std::unique_ptr<FactorClass> Factor_;
+  };
+}
+
+#endif // ANALYTICCOSTFUNCTION_H
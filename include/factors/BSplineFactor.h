@@ -0,0 +1,133 @@
+/***************************************************************************
+ * libRSF - A Robust Sensor Fusion Library
+ *
+ * Copyright (C) 2018 Chair of Automation Technology / TU Chemnitz
+ * For more information see https://www.tu-chemnitz.de/etit/proaut/libRSF
+ *
+ * libRSF is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libRSF is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with libRSF.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Tim Pfeifer (tim.pfeifer@etit.tu-chemnitz.de)
+ ***************************************************************************/
+
+/**
+ * @file BSplineFactor.h
+ * @author Tim Pfeifer
+ * @date 14.10.2026
+ * @brief Factors that evaluate a continuous-time B-spline trajectory at the time of their measurement.
+ * @copyright GNU Public License.
+ *
+ */
+
+#ifndef BSPLINEFACTOR_H
+#define BSPLINEFACTOR_H
+
+#include "BaseFactor.h"
+#include "../Geometry.h"
+#include "../geometric_models/BSplineModel.h"
+
+namespace libRSF
+{
+  /** range to a known point from a spline position, the states are the four position control points of the segment */
+  template <typename ErrorType>
+  class BSplineRangeFactor : public BaseFactor<ErrorType, true, false, 4, 3, 3, 3, 3>
+  {
+    public:
+      /** the timestamps of the control points define the position of the measurement in the segment */
+      const static bool UsesStateTimes = true;
+
+      /** construct factor and store measurement */
+      BSplineRangeFactor(const ErrorType &Error, const Data &Range, const double TimeFirst, const double TimeLast)
+      {
+        this->Error_ = Error;
+        this->MeasurementVector_[0] = Range.getMean()[0];
+        this->MeasurementVector_.tail(3) = Range.getValue(DataElement::SatPos);
+        Basis_ = CumulativeBSplineBasis(BSplineSegmentTime(Range.getTimestamp(), TimeFirst, TimeLast));
+      }
+
+      /** geometric error model */
+      template <typename T>
+      VectorT<T, 1> Evaluate(const T* const P0, const T* const P1, const T* const P2, const T* const P3) const
+      {
+        const VectorT<T, 3> Position = BSplineValue<T, 3>(P0, P1, P2, P3, Basis_);
+
+        VectorT<T, 1> Error;
+        Error(0) = (Position - this->MeasurementVector_.tail(3).template cast<T>()).norm() - this->MeasurementVector_(0);
+        return Error;
+      }
+
+      /** combine probabilistic and geometric model */
+      template <typename T, typename... ParamsType>
+      bool operator()(const T* const P0, const T* const P1, const T* const P2, const T* const P3,
+                      ParamsType... Params) const
+      {
+        return this->Error_.template weight<T>(this->Evaluate(P0, P1, P2, P3),
+                                               Params...);
+      }
+
+    private:
+      Vector3 Basis_;
+  };
+
+  /** full pose measurement of a spline in SE(3), which is split into a position and a rotation spline,
+   *  the states are the four positions followed by the four quaternions of the segment */
+  template <typename ErrorType>
+  class BSplinePose3Factor : public BaseFactor<ErrorType, true, false, 7, 3, 3, 3, 3, 4, 4, 4, 4>
+  {
+    public:
+      /** the timestamps of the control points define the position of the measurement in the segment */
+      const static bool UsesStateTimes = true;
+
+      /** construct factor and store measurement */
+      BSplinePose3Factor(const ErrorType &Error, const Data &Pose, const double TimeFirst, const double TimeLast)
+      {
+        this->Error_ = Error;
+        this->MeasurementVector_ = Pose.getMean();
+        Basis_ = CumulativeBSplineBasis(BSplineSegmentTime(Pose.getTimestamp(), TimeFirst, TimeLast));
+      }
+
+      /** geometric error model */
+      template <typename T>
+      VectorT<T, 6> Evaluate(const T* const P0, const T* const P1, const T* const P2, const T* const P3,
+                             const T* const Q0, const T* const Q1, const T* const Q2, const T* const Q3) const
+      {
+        const QuaternionT<T> QuatMeas = VectorToQuaternion<double>(this->MeasurementVector_.tail(4)).template cast<T>();
+
+        VectorT<T, 6> Error;
+        Error.template head<3>() = BSplineValue<T, 3>(P0, P1, P2, P3, Basis_) - this->MeasurementVector_.head(3).template cast<T>();
+        Error.template tail<3>() = QuaternionError<T>(QuatMeas, BSplineQuaternion<T>(Q0, Q1, Q2, Q3, Basis_));
+        return Error;
+      }
+
+      /** combine probabilistic and geometric model */
+      template <typename T, typename... ParamsType>
+      bool operator()(const T* const P0, const T* const P1, const T* const P2, const T* const P3,
+                      const T* const Q0, const T* const Q1, const T* const Q2, const T* const Q3,
+                      ParamsType... Params) const
+      {
+        return this->Error_.template weight<T>(this->Evaluate(P0, P1, P2, P3, Q0, Q1, Q2, Q3),
+                                               Params...);
+      }
+
+    private:
+      Vector3 Basis_;
+  };
+
+  /** compile time mapping from factor type enum to corresponding factor class */
+  template<typename ErrorType>
+  struct FactorTypeTranslator<FactorType::BSplineRange3, ErrorType> {using Type = BSplineRangeFactor<ErrorType>;};
+  template<typename ErrorType>
+  struct FactorTypeTranslator<FactorType::BSplinePose3, ErrorType> {using Type = BSplinePose3Factor<ErrorType>;};
+}
+
+#endif // BSPLINEFACTOR_H
@@ -48,6 +48,7 @@ namespace libRSF
   template <typename ErrorType,
             bool HasMeasurementTemp,
             bool HasDeltaTimeTemp,
+            int MeasurementDimTemp, // Size of the stored measurement vector
             int... StateDimsTemp>   // Number of parameters
   class BaseFactor
   {
@@ -59,6 +60,15 @@ namespace libRSF
       /** Default destructor */
       virtual ~BaseFactor() = default;
 
+      /** factors live in the FactorPool of their graph, which also releases the memory */
+      static void* operator new(std::size_t) = delete;
+      static void* operator new(std::size_t, void* Block) noexcept
+      {
+        return Block;
+      }
+      static void operator delete(void*) noexcept {}
+      static void operator delete(void*, void*) noexcept {}
+
       /** access the stored error model */
       ErrorType* getErrorModel()
       {
@@ -74,13 +84,23 @@ namespace libRSF
       /** configuration options */
       const static bool HasDeltaTime = HasDeltaTimeTemp;
       const static bool HasMeasurement = HasMeasurementTemp;
+      const static int MeasurementDim = MeasurementDimTemp;
+
+      /** factors that read satellite positions from the SatelliteStore of their graph */
+      const static bool UsesSatelliteStore = false;
+
+      /** factors whose error is linear in their states, their Jacobian is evaluated only once */
+      const static bool IsLinear = false;
+
+      /** factors with a measurement that also get the timestamps of their first and last state, e.g. to locate it on a spline */
+      const static bool UsesStateTimes = false;
 
     protected:
       ErrorType   Error_; /**< represent the probabilistic error function */
 
       /** optional members */
       double      DeltaTime_ = 0;     /**< the time that has been past between the connected states */
-      Vector      MeasurementVector_; /**< a efficient representation of the measurement */
+      VectorStatic<MeasurementDimTemp> MeasurementVector_; /**< the measurement is stored inline with a fixed size */
   };
 }
 
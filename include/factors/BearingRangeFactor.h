@@ -39,15 +39,14 @@
 namespace libRSF
 {
   template <typename ErrorType>
-  class BetweenBearingRange2Factor : public BaseFactor<ErrorType, true, false, 2, 1, 2>
+  class BetweenBearingRange2Factor : public BaseFactor<ErrorType, true, false, 2, 2, 1, 2>
   {
     public:
 
       /** construct factor and store measurement */
-      BetweenBearingRange2Factor(ErrorType &Error, const Data &Measurement)
+      BetweenBearingRange2Factor(const ErrorType &Error, const Data &Measurement)
       {
         this->Error_ = Error;
-        this->MeasurementVector_.resize(2);
         this->MeasurementVector_ = Measurement.getMean();
       }
 
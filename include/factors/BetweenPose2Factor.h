@@ -39,14 +39,13 @@
 namespace libRSF
 {
   template <typename ErrorType>
-  class BetweenPose2Factor : public BaseFactor<ErrorType, true, false, 2, 1, 2, 1>
+  class BetweenPose2Factor : public BaseFactor<ErrorType, true, false, 3, 2, 1, 2, 1>
   {
     public:
       /** construct factor and store measurement */
-      BetweenPose2Factor(ErrorType &Error, const Data &PoseMeasurement)
+      BetweenPose2Factor(const ErrorType &Error, const Data &PoseMeasurement)
       {
         this->Error_ = Error;
-        this->MeasurementVector_.resize(3);
         this->MeasurementVector_ = PoseMeasurement.getMean();
       }
 
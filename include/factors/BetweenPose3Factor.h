@@ -39,14 +39,13 @@
 namespace libRSF
 {
   template <typename ErrorType>
-  class BetweenPose3Factor : public BaseFactor<ErrorType, true, false, 3, 4, 3, 4>
+  class BetweenPose3Factor : public BaseFactor<ErrorType, true, false, 7, 3, 4, 3, 4>
   {
     public:
       /** construct factor and store measurement */
-      BetweenPose3Factor(ErrorType &Error, const Data &PoseMeasurement)
+      BetweenPose3Factor(const ErrorType &Error, const Data &PoseMeasurement)
       {
         this->Error_ = Error;
-        this->MeasurementVector_.resize(7);
         this->MeasurementVector_ = PoseMeasurement.getMean();
       }
 
@@ -74,6 +73,50 @@ namespace libRSF
         return Error;
       }
 
+      /** analytic error and Jacobians w.r.t. the left increment of the rotations, see AnalyticCostFunction */
+      bool EvaluateWithJacobians(double const* const* States, double* ErrorPointer, double** Jacobians) const
+      {
+        VectorRefConst<double, 3> Pos1(States[0]);
+        VectorRefConst<double, 3> Pos2(States[2]);
+        QuaternionRefConst<double> Quat1(States[1]);
+        QuaternionRefConst<double> Quat2(States[3]);
+        const Quaternion QuatRot = VectorToQuaternion<double>(this->MeasurementVector_.tail(4));
+
+        /** error = estimated measurement - measurement */
+        const Matrix33 Rot1T = Quat1.conjugate().toRotationMatrix();
+        const Vector3 Delta = Pos2 - Pos1;
+        VectorRef<double, 6> Error(ErrorPointer);
+        Error.head<3>() = Rot1T * Delta - this->MeasurementVector_.head(3);
+        Error.tail<3>() = QuaternionError<double>(QuatRot, Quat1.conjugate() * Quat2);
+
+        if (Jacobians == nullptr)
+        {
+          return true;
+        }
+
+        /** the rotation error is Log(R_12 * R_2^T * R_1) */
+        const Matrix33 RotationJac = RightJacobianInverseSO3(Error.tail<3>()) * Rot1T;
+
+        MatrixRef<double, 6, 3> JacPos1(Jacobians[0]);
+        JacPos1.setZero();
+        JacPos1.topRows<3>() = -Rot1T;
+
+        MatrixStatic<6, 3> JacRot1;
+        JacRot1.topRows<3>() = Rot1T * SkewSymmetricMatrix<double>(Delta);
+        JacRot1.bottomRows<3>() = RotationJac;
+        QuaternionLocalToGlobalJacobian<6>(Quat1, JacRot1, Jacobians[1]);
+
+        MatrixRef<double, 6, 3> JacPos2(Jacobians[2]);
+        JacPos2.setZero();
+        JacPos2.topRows<3>() = Rot1T;
+
+        MatrixStatic<6, 3> JacRot2 = MatrixStatic<6, 3>::Zero();
+        JacRot2.bottomRows<3>() = -RotationJac;
+        QuaternionLocalToGlobalJacobian<6>(Quat2, JacRot2, Jacobians[3]);
+
+        return true;
+      }
+
       /** combine probabilistic and geometric model */
       template <typename T, typename... ParamsType>
       bool operator()(const T* const Pos1, const T* const Quat1,
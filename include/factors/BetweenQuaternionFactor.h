@@ -38,14 +38,13 @@
 namespace libRSF
 {
   template <typename ErrorType>
-  class BetweenQuaternionFactor : public BaseFactor<ErrorType, true, false, 4, 4>
+  class BetweenQuaternionFactor : public BaseFactor<ErrorType, true, false, 4, 4, 4>
   {
     public:
       /** construct factor and store measurement */
-      BetweenQuaternionFactor(ErrorType &Error, const Data &QuaternionMeasurement)
+      BetweenQuaternionFactor(const ErrorType &Error, const Data &QuaternionMeasurement)
       {
         this->Error_ = Error;
-        this->MeasurementVector_.resize(4);
         this->MeasurementVector_ = QuaternionMeasurement.getMean();
       }
 
@@ -65,6 +64,29 @@ namespace libRSF
         return RelativeQuaternionError<T>(Q1, Q2, QuatRot.template cast<T>());
       }
 
+      /** analytic error and Jacobians w.r.t. the left increment of the rotations, see AnalyticCostFunction */
+      bool EvaluateWithJacobians(double const* const* States, double* ErrorPointer, double** Jacobians) const
+      {
+        QuaternionRefConst<double> Q1(States[0]);
+        QuaternionRefConst<double> Q2(States[1]);
+        const Quaternion QuatRot(this->MeasurementVector_(3), this->MeasurementVector_(0), this->MeasurementVector_(1), this->MeasurementVector_(2));
+
+        VectorRef<double, 3> Error(ErrorPointer);
+        Error = RelativeQuaternionError<double>(Q1, Q2, QuatRot);
+
+        if (Jacobians == nullptr)
+        {
+          return true;
+        }
+
+        /** the error is Log(R_12 * R_2^T * R_1) */
+        const Matrix33 Jac = RightJacobianInverseSO3(Error) * Q1.conjugate().toRotationMatrix();
+        QuaternionLocalToGlobalJacobian<3>(Q1, Jac, Jacobians[0]);
+        QuaternionLocalToGlobalJacobian<3>(Q2, -Jac, Jacobians[1]);
+
+        return true;
+      }
+
       /** combine probabilistic and geometric model */
       template <typename T, typename... ParamsType>
       bool operator()(const T* const Quat1,
@@ -38,14 +38,16 @@
 namespace libRSF
 {
   template <typename ErrorType, int Dim>
-  class BetweenValueFactorBase : public BaseFactor<ErrorType, true, false, Dim, Dim>
+  class BetweenValueFactorBase : public BaseFactor<ErrorType, true, false, Dim, Dim, Dim>
   {
     public:
+      /** the error is a linear function of the states */
+      const static bool IsLinear = true;
+
       /** construct factor and store measurement */
-      BetweenValueFactorBase(ErrorType &Error, const Data &Measurement)
+      BetweenValueFactorBase(const ErrorType &Error, const Data &Measurement)
       {
         this->Error_ = Error;
-        this->MeasurementVector_.resize(Dim);
         this->MeasurementVector_ = Measurement.getMean();
       }
 
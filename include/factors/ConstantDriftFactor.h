@@ -38,11 +38,14 @@
 namespace libRSF
 {
   template <typename ErrorType, int Dim>
-  class ConstantDriftFactorBase : public BaseFactor<ErrorType, false, true, Dim, Dim, Dim, Dim>
+  class ConstantDriftFactorBase : public BaseFactor<ErrorType, false, true, 0, Dim, Dim, Dim, Dim>
   {
     public:
+      /** the error is a linear function of the states */
+      const static bool IsLinear = true;
+
       /** construct factor and store measurement */
-      ConstantDriftFactorBase(ErrorType &Error, double DeltaTime)
+      ConstantDriftFactorBase(const ErrorType &Error, double DeltaTime)
       {
         this->Error_ = Error;
         this->DeltaTime_ = DeltaTime;
@@ -90,6 +93,73 @@ namespace libRSF
       }
   };
 
+  /** constant drift model for states that keep value and drift in the same block, e.g. [clock error, clock drift] */
+  template <typename ErrorType>
+  class ConstantDriftCombinedFactorBase : public BaseFactor<ErrorType, false, true, 0, 2, 2>
+  {
+    public:
+      /** the error is a linear function of the states */
+      const static bool IsLinear = true;
+
+      /** construct factor and store measurement */
+      ConstantDriftCombinedFactorBase(const ErrorType &Error, double DeltaTime)
+      {
+        this->Error_ = Error;
+        this->DeltaTime_ = DeltaTime;
+      }
+
+      /** geometric error model */
+      template <typename T>
+      VectorT<T, 2> Evaluate(const T* const StateOld, const T* const StateNew) const
+      {
+        VectorT<T, 2> Error;
+        Error(0) = StateNew[0] - StateOld[0] - (StateOld[1] * this->DeltaTime_);
+        Error(1) = StateNew[1] - StateOld[1];
+
+        return Error;
+      }
+
+      /** analytic error and Jacobians, see AnalyticCostFunction */
+      bool EvaluateWithJacobians(double const* const* States, double* ErrorPointer, double** Jacobians) const
+      {
+        VectorRef<double, 2> Error(ErrorPointer);
+        Error = this->Evaluate(States[0], States[1]);
+
+        if (Jacobians == nullptr)
+        {
+          return true;
+        }
+
+        MatrixRef<double, 2, 2> JacOld(Jacobians[0]);
+        JacOld << -1.0, -this->DeltaTime_,
+                   0.0, -1.0;
+
+        MatrixRef<double, 2, 2> JacNew(Jacobians[1]);
+        JacNew.setIdentity();
+
+        return true;
+      }
+
+      /** combine probabilistic and geometric model */
+      template <typename T, typename... ParamsType>
+      bool operator()(const T* const StateOld, const T* const StateNew,
+                      ParamsType... Params) const
+      {
+        return this->Error_.template weight<T>(this->Evaluate(StateOld, StateNew),
+                                               Params...);
+      }
+
+      /** predict the next state for initialization, order is the same as for Evaluate() */
+      void predict(const std::vector<double*> &StatePointers) const
+      {
+        VectorRefConst<double, 2> Old(StatePointers.at(0));
+        VectorRef<double, 2> New(StatePointers.at(1));
+
+        New(0) = Old(0) + (Old(1) * this->DeltaTime_);
+        New(1) = Old(1);
+      }
+  };
+
   /** compile time mapping from factor type enum to corresponding factor class */
   template<typename ErrorType>
   struct FactorTypeTranslator<FactorType::ConstDrift1, ErrorType> {using Type = ConstantDriftFactorBase<ErrorType, 1>;};
@@ -97,5 +167,7 @@ namespace libRSF
   struct FactorTypeTranslator<FactorType::ConstDrift2, ErrorType> {using Type = ConstantDriftFactorBase<ErrorType, 2>;};
   template<typename ErrorType>
   struct FactorTypeTranslator<FactorType::ConstDrift3, ErrorType> {using Type = ConstantDriftFactorBase<ErrorType, 3>;};
+  template<typename ErrorType>
+  struct FactorTypeTranslator<FactorType::ConstDriftClock, ErrorType> {using Type = ConstantDriftCombinedFactorBase<ErrorType>;};
 }
 #endif // CONSTANTDRIFTFACTOR_H
@@ -38,11 +38,11 @@
 namespace libRSF
 {
   template <typename ErrorType>
-  class ConstantQuaternionFactor : public BaseFactor<ErrorType, false, false, 4, 4>
+  class ConstantQuaternionFactor : public BaseFactor<ErrorType, false, false, 0, 4, 4>
   {
    public:
     /** construct factor and store measurement */
-    explicit ConstantQuaternionFactor(ErrorType &Error)
+    explicit ConstantQuaternionFactor(const ErrorType &Error)
     {
       this->Error_ = Error;
     }
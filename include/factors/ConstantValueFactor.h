@@ -38,11 +38,14 @@
 namespace libRSF
 {
   template <typename ErrorType, int Dim>
-  class ConstantValueFactorBase : public BaseFactor<ErrorType, false, false, Dim, Dim>
+  class ConstantValueFactorBase : public BaseFactor<ErrorType, false, false, 0, Dim, Dim>
   {
     public:
+      /** the error is a linear function of the states */
+      const static bool IsLinear = true;
+
       /** construct factor and store error model */
-      explicit ConstantValueFactorBase(ErrorType &Error)
+      explicit ConstantValueFactorBase(const ErrorType &Error)
       {
         this->Error_ = Error;
       }
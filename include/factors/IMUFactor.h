@@ -38,14 +38,13 @@
 namespace libRSF
 {
   template <typename ErrorType>
-  class IMUFactor : public BaseFactor<ErrorType, true, true, 3, 4, 9, 3, 4, 9>
+  class IMUFactor : public BaseFactor<ErrorType, true, true, 6, 3, 4, 9, 3, 4, 9>
   {
     public:
       /** construct factor and store measurement */
-      IMUFactor(ErrorType &Error, const Data &IMUMeasurement, double DeltaTime)
+      IMUFactor(const ErrorType &Error, const Data &IMUMeasurement, double DeltaTime)
       {
         this->Error_ = Error;
-        this->MeasurementVector_.resize(6);
         this->MeasurementVector_ = IMUMeasurement.getMean();
         this->DeltaTime_ = DeltaTime;
       }
@@ -40,11 +40,11 @@
 namespace libRSF
 {
   template<typename ErrorType>
-  class IMUPreintegrationFactor : public BaseFactor<ErrorType, true, true, 3, 4, 9, 3, 4, 9>
+  class IMUPreintegrationFactor : public BaseFactor<ErrorType, true, true, 0, 3, 4, 9, 3, 4, 9>
   {
     public:
       /** construct factor and store measurement */
-      IMUPreintegrationFactor(ErrorType &Error, const PreintegratedIMUResult &Preintegration) : Preintegration_(Preintegration)
+      IMUPreintegrationFactor(const ErrorType &Error, const PreintegratedIMUResult &Preintegration) : Preintegration_(Preintegration)
       {
         /** save noise model */
         this->Error_ = Error;
@@ -103,6 +103,92 @@ namespace libRSF
         return Error;
       }
 
+      /** analytic error and Jacobians w.r.t. the left increment of the rotations, see AnalyticCostFunction */
+      bool EvaluateWithJacobians(double const* const* States, double* ErrorPointer, double** Jacobians) const
+      {
+        /** map pointer to vectors */
+        VectorRefConst<double, 3> P1(States[0]);
+        VectorRefConst<double, 3> P2(States[3]);
+        QuaternionRefConst<double> Rot1(States[1]);
+        QuaternionRefConst<double> Rot2(States[4]);
+        VectorRefConst<double, 9> SpeedBias1(States[2]);
+        VectorRefConst<double, 9> SpeedBias2(States[5]);
+
+        /** linear approximation for biases */
+        const Vector3 DeltaBiasAcc = SpeedBias1.segment<3>(3) - Preintegration_.BiasAcc;
+        const Vector3 DeltaBiasTR = SpeedBias1.tail<3>() - Preintegration_.BiasTR;
+
+        const Vector3 ApproxTranslation = Preintegration_.Translation
+                                          + Preintegration_.JacTransBiasAcc * DeltaBiasAcc
+                                          + Preintegration_.JacTransBiasTR * DeltaBiasTR;
+        const Vector3 ApproxVelocity = Preintegration_.Velocity
+                                       + Preintegration_.JacVelBiasAcc * DeltaBiasAcc
+                                       + Preintegration_.JacVelBiasTR * DeltaBiasTR;
+        const Vector3 BiasRotation = Preintegration_.JacRotBiasTRLocal * DeltaBiasTR;
+        const Quaternion ApproxRotation = Preintegration_.Rotation * QuaternionExpMap<double>(BiasRotation);
+
+        /** calculate error */
+        const double dt = Preintegration_.DeltaTime;
+        const Matrix33 Rot1T = Rot1.conjugate().toRotationMatrix();
+        const Vector3 Translation = P2 - P1 - dt * SpeedBias1.head<3>() + 0.5*dt*dt * GRAVITY_VECTOR;
+        const Vector3 Velocity = SpeedBias2.head<3>() - SpeedBias1.head<3>() + dt * GRAVITY_VECTOR;
+
+        VectorRef<double, 15> Error(ErrorPointer);
+        Error.segment<3>(0) = Rot1T * Translation - ApproxTranslation;
+        Error.segment<3>(3) = Rot1T * Velocity - ApproxVelocity;
+        Error.segment<3>(6) = QuaternionLogMap<double>(ApproxRotation.conjugate() * Rot1.conjugate() * Rot2);
+        Error.segment<3>(9) = SpeedBias2.segment<3>(3) - SpeedBias1.segment<3>(3);
+        Error.segment<3>(12) = SpeedBias2.tail<3>() - SpeedBias1.tail<3>();
+
+        if (Jacobians == nullptr)
+        {
+          return true;
+        }
+
+        /** R1^T * R2 * Exp(d) for both rotations and Exp(-d) * E for the bias */
+        const Vector3 RotationError = Error.segment<3>(6);
+        const Matrix33 RotationRight = RightJacobianInverseSO3(RotationError) * Rot2.conjugate().toRotationMatrix();
+        const Matrix33 RotationBias = RightJacobianInverseSO3(-RotationError) * RightJacobianSO3(BiasRotation) * Preintegration_.JacRotBiasTRLocal;
+
+        MatrixRef<double, 15, 3> JacP1(Jacobians[0]);
+        JacP1.setZero();
+        JacP1.block<3, 3>(0, 0) = -Rot1T;
+
+        MatrixStatic<15, 3> JacRot1 = MatrixStatic<15, 3>::Zero();
+        JacRot1.block<3, 3>(0, 0) = Rot1T * SkewSymmetricMatrix<double>(Translation);
+        JacRot1.block<3, 3>(3, 0) = Rot1T * SkewSymmetricMatrix<double>(Velocity);
+        JacRot1.block<3, 3>(6, 0) = -RotationRight;
+        QuaternionLocalToGlobalJacobian<15>(Rot1, JacRot1, Jacobians[1]);
+
+        MatrixRef<double, 15, 9> JacSB1(Jacobians[2]);
+        JacSB1.setZero();
+        JacSB1.block<3, 3>(0, 0) = -dt * Rot1T;
+        JacSB1.block<3, 3>(0, 3) = -Preintegration_.JacTransBiasAcc;
+        JacSB1.block<3, 3>(0, 6) = -Preintegration_.JacTransBiasTR;
+        JacSB1.block<3, 3>(3, 0) = -Rot1T;
+        JacSB1.block<3, 3>(3, 3) = -Preintegration_.JacVelBiasAcc;
+        JacSB1.block<3, 3>(3, 6) = -Preintegration_.JacVelBiasTR;
+        JacSB1.block<3, 3>(6, 6) = -RotationBias;
+        JacSB1.block<3, 3>(9, 3) = -Matrix33::Identity();
+        JacSB1.block<3, 3>(12, 6) = -Matrix33::Identity();
+
+        MatrixRef<double, 15, 3> JacP2(Jacobians[3]);
+        JacP2.setZero();
+        JacP2.block<3, 3>(0, 0) = Rot1T;
+
+        MatrixStatic<15, 3> JacRot2 = MatrixStatic<15, 3>::Zero();
+        JacRot2.block<3, 3>(6, 0) = RotationRight;
+        QuaternionLocalToGlobalJacobian<15>(Rot2, JacRot2, Jacobians[4]);
+
+        MatrixRef<double, 15, 9> JacSB2(Jacobians[5]);
+        JacSB2.setZero();
+        JacSB2.block<3, 3>(3, 0) = Rot1T;
+        JacSB2.block<3, 3>(9, 3) = Matrix33::Identity();
+        JacSB2.block<3, 3>(12, 6) = Matrix33::Identity();
+
+        return true;
+      }
+
       /** combine probabilistic and geometric model */
       template <typename T>
       bool operator()(const T* const PointOld, const T* const QuatOld, const T* const SpeedBiasOld,
@@ -130,7 +216,8 @@ namespace libRSF
 
         /** loop over measurements to predict incrementally */
         double OldTime = Preintegration_.StartTime;
-        for (const Data &Measurement : Preintegration_.Measurements)
+        const IMUSampleBuffer &Measurements = Preintegration_.Measurements;
+        for (size_t n = 0; n < Measurements.size(); n++)
         {
           IMUModel<double>::applyForward(P1.data(),
                                          Q1.coeffs().data(),
@@ -138,11 +225,11 @@ namespace libRSF
                                          P2.data(),
                                          Q2.coeffs().data(),
                                          SB2.data(),
-                                         Measurement.getMean().head(3),
-                                         Measurement.getMean().tail(3),
-                                         Measurement.getTimestamp() - OldTime);
+                                         Measurements.getAcceleration(n),
+                                         Measurements.getTurnRate(n),
+                                         Measurements.getTimestamp(n) - OldTime);
 
-          OldTime = Measurement.getTimestamp();
+          OldTime = Measurements.getTimestamp(n);
           P1 = P2;
           Q1 = Q2;
           SB1 = SB2;
@@ -0,0 +1,175 @@
+/***************************************************************************
+ * libRSF - A Robust Sensor Fusion Library
+ *
+ * Copyright (C) 2018 Chair of Automation Technology / TU Chemnitz
+ * For more information see https://www.tu-chemnitz.de/etit/proaut/libRSF
+ *
+ * libRSF is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libRSF is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with libRSF.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Tim Pfeifer (tim.pfeifer@etit.tu-chemnitz.de)
+ ***************************************************************************/
+
+/**
+ * @file LinearCostFunction.h
+ * @author Tim Pfeifer
+ * @date 14.10.2026
+ * @brief Cost function for factors that are linear in their states.
+ * @copyright GNU Public License.
+ *
+ */
+
+#ifndef LINEARCOSTFUNCTION_H
+#define LINEARCOSTFUNCTION_H
+
+#include "../VectorTypes.h"
+#include "../error_models/Gaussian.h"
+
+#include <ceres/ceres.h>
+
+#include <array>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace libRSF
+{
+  /** error models that are a linear map of the raw error */
+  template <typename ErrorType>
+  struct IsLinearErrorModel : std::false_type {};
+
+  template <int Dim>
+  struct IsLinearErrorModel<GaussianDiagonal<Dim>> : std::true_type {};
+
+  template <int Dim>
+  struct IsLinearErrorModel<GaussianFull<Dim>> : std::true_type {};
+
+  /** factors mark their linearity with IsLinear, the error model has to be linear as well */
+  template <typename FactorClass, typename ErrorType>
+  constexpr bool UseLinearJacobian()
+  {
+    return static_cast<bool>(FactorClass::IsLinear) && IsLinearErrorModel<ErrorType>::value;
+  }
+
+  /** \brief Evaluates a linear factor as matrix-vector product.
+   *
+   * The geometric Jacobian is derived once by forward differentiation at construction. The error model
+   * is applied at each evaluation, so replaced or disabled models are still respected.
+   */
+  template <typename FactorClass, typename ErrorType, int... StateDims>
+  class LinearCostFunction : public ceres::SizedCostFunction<ErrorType::OutputDim, StateDims...>
+  {
+    static constexpr int StateNumber = sizeof...(StateDims);
+    static constexpr int StateSize = (StateDims + ...);
+    static constexpr int ErrorDim = ErrorType::InputDim;
+    static constexpr int OutputDim = ErrorType::OutputDim;
+
+    using JetType = ceres::Jet<double, StateSize>;
+
+    public:
+      /** takes the ownership of the factor, like ceres::AutoDiffCostFunction */
+      explicit LinearCostFunction(FactorClass *Factor) : Factor_(Factor)
+      {
+        constexpr std::array<int, StateNumber> Dims = {StateDims...};
+
+        /** the derivative at zero is valid everywhere */
+        std::array<JetType, StateSize> StateJets;
+        std::array<const JetType*, StateNumber> StatePointers{};
+        int Offset = 0;
+        for (int nState = 0; nState < StateNumber; nState++)
+        {
+          StatePointers[nState] = StateJets.data() + Offset;
+          Offset += Dims[nState];
+        }
+        for (int nDim = 0; nDim < StateSize; nDim++)
+        {
+          StateJets[nDim] = JetType(0.0, nDim);
+        }
+
+        const VectorT<JetType, ErrorDim> Error = evaluate_(StatePointers.data(), std::make_index_sequence<StateNumber>{});
+        for (int nRow = 0; nRow < ErrorDim; nRow++)
+        {
+          Offset_(nRow) = Error(nRow).a;
+          Jacobian_.row(nRow) = Error(nRow).v.transpose();
+        }
+      }
+      ~LinearCostFunction() override = default;
+
+      bool Evaluate(double const* const* Parameters, double* Residuals, double** Jacobians) const override
+      {
+        constexpr std::array<int, StateNumber> Dims = {StateDims...};
+
+        /** raw error */
+        VectorStatic<ErrorDim> Error = Offset_;
+        int Offset = 0;
+        for (int nState = 0; nState < StateNumber; nState++)
+        {
+          Error += Jacobian_.middleCols(Offset, Dims[nState]) * VectorRefConst<double, Dynamic>(Parameters[nState], Dims[nState]);
+          Offset += Dims[nState];
+        }
+
+        if (!this->weight_(Error, Residuals))
+        {
+          return false;
+        }
+
+        if (Jacobians == nullptr)
+        {
+          return true;
+        }
+
+        /** the weighting is linear, so it is applied to each column of the geometric Jacobian */
+        Offset = 0;
+        for (int nState = 0; nState < StateNumber; nState++)
+        {
+          if (Jacobians[nState] != nullptr)
+          {
+            for (int nDim = 0; nDim < Dims[nState]; nDim++)
+            {
+              const VectorStatic<ErrorDim> Column = Jacobian_.col(Offset + nDim);
+              VectorStatic<OutputDim> WeightedColumn;
+              this->weight_(Column, WeightedColumn.data());
+
+              for (int nResidual = 0; nResidual < OutputDim; nResidual++)
+              {
+                Jacobians[nState][nResidual * Dims[nState] + nDim] = WeightedColumn(nResidual);
+              }
+            }
+          }
+          Offset += Dims[nState];
+        }
+
+        return true;
+      }
+
+    private:
+      template <size_t... States>
+      VectorT<JetType, ErrorDim> evaluate_(const JetType* const* StatePointers, std::index_sequence<States...> /*Index*/) const
+      {
+        return Factor_->template Evaluate<JetType>(StatePointers[States]...);
+      }
+
+      bool weight_(const VectorStatic<ErrorDim> &Error, double* Residuals) const
+      {
+        return Factor_->getErrorModel()->template weight<double>(Error, Residuals);
+      }
+
+      std::unique_ptr<FactorClass> Factor_;
+
+      /** raw error = Jacobian_ * States + Offset_ */
+      MatrixStatic<ErrorDim, StateSize> Jacobian_;
+      VectorStatic<ErrorDim> Offset_;
+  };
+}
+
+#endif // LINEARCOSTFUNCTION_H
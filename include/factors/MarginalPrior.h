@@ -63,7 +63,10 @@ namespace libRSF
       int LocalSizeSum_;
       Vector LinearizationPoints_;
       Vector LinearResidual_;
-      Matrix LinearJacobian_;
+
+      /** block-wise sqrt-information, blocks without information are skipped */
+      std::vector<Matrix> JacobianBlocks_;
+      std::vector<bool> IsZeroBlock_;
   };
 }
 
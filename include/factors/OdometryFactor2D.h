@@ -38,14 +38,13 @@
 namespace libRSF
 {
   template <typename ErrorType>
-  class OdometryFactor2D : public BaseFactor<ErrorType, true, true, 2, 1, 2, 1>
+  class OdometryFactor2D : public BaseFactor<ErrorType, true, true, 3, 2, 1, 2, 1>
   {
     public:
       /** construct factor and store measurement */
-      OdometryFactor2D(ErrorType &Error, const Data &OdometryMeasurement, double DeltaTime)
+      OdometryFactor2D(const ErrorType &Error, const Data &OdometryMeasurement, double DeltaTime)
       {
         this->Error_ = Error;
-        this->MeasurementVector_.resize(3);
         this->MeasurementVector_ = OdometryMeasurement.getMean();
         this->DeltaTime_ = DeltaTime;
       }
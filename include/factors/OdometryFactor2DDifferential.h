@@ -38,14 +38,13 @@
 namespace libRSF
 {
   template <typename ErrorType>
-  class OdometryFactor2DDifferential : public BaseFactor<ErrorType, true, true, 2, 1, 2, 1>
+  class OdometryFactor2DDifferential : public BaseFactor<ErrorType, true, true, 4, 2, 1, 2, 1>
   {
     public:
       /** construct factor and store measurement */
-      OdometryFactor2DDifferential(ErrorType &Error, const Data &OdometryMeasurement, double DeltaTime)
+      OdometryFactor2DDifferential(const ErrorType &Error, const Data &OdometryMeasurement, double DeltaTime)
       {
         this->Error_ = Error;
-        this->MeasurementVector_.resize(4);
         this->MeasurementVector_.head(3) = OdometryMeasurement.getMean();
         this->MeasurementVector_.tail(1) = OdometryMeasurement.getValue(DataElement::WheelBase);
         this->DeltaTime_ = DeltaTime;
@@ -33,21 +33,21 @@
 #define ODOMETRYFACTOR3D_H
 
 #include "BaseFactor.h"
+#include "../Constants.h"
 #include "../Geometry.h"
 #include "../geometric_models/OdometryModel.h"
 
 namespace libRSF
 {
   template <typename ErrorType>
-  class OdometryFactor3D4DOF_ECEF : public BaseFactor<ErrorType, true, true, 3, 1, 3, 1>
+  class OdometryFactor3D4DOF_ECEF : public BaseFactor<ErrorType, true, true, 6, 3, 1, 3, 1>
   {
     public:
       /** construct factor and store measurement */
-      OdometryFactor3D4DOF_ECEF(ErrorType &Error, const Data &OdometryMeasurement, double DeltaTime)
+      OdometryFactor3D4DOF_ECEF(const ErrorType &Error, const Data &OdometryMeasurement, double DeltaTime)
       {
         this->Error_ = Error;
 
-        this->MeasurementVector_.resize(6);
         this->MeasurementVector_ = OdometryMeasurement.getMean();
         this->DeltaTime_ = DeltaTime;
       }
@@ -61,7 +61,14 @@ namespace libRSF
 
         /** estimate measurements */
         VectorT<T, 3> VelocityEst, TurnRateEst;
-        OdometryModel4DOFECEF<T>::applyBackward(Pos1, Yaw1, Pos2, Yaw2, VelocityEst, TurnRateEst, this->DeltaTime_);
+        if constexpr (ECEF_FRAME_REFRESH_DISTANCE > 0.0)
+        {
+          OdometryModel4DOFECEF<T>::applyBackward(Pos1, Yaw1, Pos2, Yaw2, this->getLocalFrame_(Pos1).template cast<T>(), VelocityEst, TurnRateEst, this->DeltaTime_);
+        }
+        else
+        {
+          OdometryModel4DOFECEF<T>::applyBackward(Pos1, Yaw1, Pos2, Yaw2, VelocityEst, TurnRateEst, this->DeltaTime_);
+        }
 
         /** error = estimated measurement - measurement */
         VectorT<T, 4> Error;
@@ -93,17 +100,47 @@ namespace libRSF
                                                     this->MeasurementVector_.tail(3),
                                                     this->DeltaTime_);
       }
+
+    private:
+      /** the local frame only changes by 1.6e-7 rad per meter on the earth's surface, so it is kept constant
+       *  (without derivative) until the position moved by more than ECEF_FRAME_REFRESH_DISTANCE,
+       *  the cache is safe because each residual block is evaluated by one thread at a time */
+      template <typename T>
+      const Quaternion &getLocalFrame_(const T* const Pos1) const
+      {
+        Vector3 Point;
+        for (int n = 0; n < 3; n++)
+        {
+          if constexpr (std::is_same_v<T, double>)
+          {
+            Point(n) = Pos1[n];
+          }
+          else
+          {
+            Point(n) = Pos1[n].a;
+          }
+        }
+
+        if (!((Point - FramePoint_).norm() < ECEF_FRAME_REFRESH_DISTANCE))
+        {
+          LocalFrame_ = Quaternion::FromTwoVectors(Vector3::UnitZ(), Point);
+          FramePoint_ = Point;
+        }
+        return LocalFrame_;
+      }
+
+      mutable Vector3 FramePoint_ = Vector3::Constant(std::numeric_limits<double>::quiet_NaN());
+      mutable Quaternion LocalFrame_ = Quaternion::Identity();
   };
 
   template <typename ErrorType>
-  class OdometryFactor3D4DOF : public BaseFactor<ErrorType, true, true, 3, 1, 3, 1>
+  class OdometryFactor3D4DOF : public BaseFactor<ErrorType, true, true, 6, 3, 1, 3, 1>
   {
     public:
       /** construct factor and store measurement */
-      OdometryFactor3D4DOF(ErrorType &Error, const Data &OdometryMeasurement, double DeltaTime)
+      OdometryFactor3D4DOF(const ErrorType &Error, const Data &OdometryMeasurement, double DeltaTime)
       {
         this->Error_ = Error;
-        this->MeasurementVector_.resize(6);
         this->MeasurementVector_ = OdometryMeasurement.getMean();
         this->DeltaTime_ = DeltaTime;
       }
@@ -151,14 +188,13 @@ namespace libRSF
   };
 
   template <typename ErrorType>
-  class OdometryFactor3D6DOF : public BaseFactor< ErrorType, true, true, 3, 4, 3, 4>
+  class OdometryFactor3D6DOF : public BaseFactor< ErrorType, true, true, 6, 3, 4, 3, 4>
   {
     public:
       /** construct factor and store measurement */
-      OdometryFactor3D6DOF(ErrorType &Error, const Data &OdometryMeasurement, double DeltaTime)
+      OdometryFactor3D6DOF(const ErrorType &Error, const Data &OdometryMeasurement, double DeltaTime)
       {
         this->Error_ = Error;
-        this->MeasurementVector_.resize(6);
         this->MeasurementVector_ = OdometryMeasurement.getMean();
         this->DeltaTime_ = DeltaTime;
       }
@@ -33,19 +33,23 @@
 #define POINTREGISTRATIONFACTOR_H
 
 #include "BaseFactor.h"
+#include "../Data.h"
 #include "../Geometry.h"
 
+#include <ceres/ceres.h>
+
+#include <vector>
+
 namespace libRSF
 {
   template <typename ErrorType>
-  class Point2RegistrationFactor : public BaseFactor<ErrorType, true, false, 2, 1, 2, 1>
+  class Point2RegistrationFactor : public BaseFactor<ErrorType, true, false, 4, 2, 1, 2, 1>
   {
     public:
       /** construct factor and store measurement */
-      Point2RegistrationFactor(ErrorType &Error, const Data &RelativePoint)
+      Point2RegistrationFactor(const ErrorType &Error, const Data &RelativePoint)
       {
         this->Error_ = Error;
-        this->MeasurementVector_.resize(4);
         this->MeasurementVector_ = RelativePoint.getMean();
       }
 
@@ -82,14 +86,13 @@ namespace libRSF
   };
 
   template <typename ErrorType>
-  class Point2RegistrationPoseFactor : public BaseFactor<ErrorType, true, false, 3, 3>
+  class Point2RegistrationPoseFactor : public BaseFactor<ErrorType, true, false, 4, 3, 3>
   {
     public:
       /** construct factor and store measurement */
-      Point2RegistrationPoseFactor(ErrorType &Error, const Data &RelativePoint)
+      Point2RegistrationPoseFactor(const ErrorType &Error, const Data &RelativePoint)
       {
         this->Error_ = Error;
-        this->MeasurementVector_.resize(4);
         this->MeasurementVector_ = RelativePoint.getMean();
       }
 
@@ -123,6 +126,180 @@ namespace libRSF
       }
   };
 
+  /** [Pos1(2), Yaw1(1), Pos2(2), Yaw2(1)] -> one weighted 2D error per correspondence of a scan pair, all points share the error model */
+  template <typename ErrorType>
+  class Point2ScanRegistrationFactor : public ceres::CostFunction
+  {
+    static_assert(ErrorType::InputDim == 2 && ErrorType::StateDims::size() == 0,
+                  "The scan registration factor requires a 2D error model without own states!");
+
+    public:
+      /** Point2Set or Point2SetRadar correspondences, an empty weight vector weights all points with one */
+      Point2ScanRegistrationFactor(const ErrorType &Error, const std::vector<Data> &Correspondences, const Vector &Weights)
+      : Error_(Error)
+      {
+        const Index PointNumber = static_cast<Index>(Correspondences.size());
+
+        /** store points as structure of arrays, so that the geometry is vectorized over points */
+        Point1X_.resize(PointNumber);
+        Point1Y_.resize(PointNumber);
+        Point2X_.resize(PointNumber);
+        Point2Y_.resize(PointNumber);
+        for (Index nPoint = 0; nPoint < PointNumber; nPoint++)
+        {
+          const Vector Mean = Correspondences.at(nPoint).getMean();
+          Point1X_(nPoint) = Mean(0);
+          Point1Y_(nPoint) = Mean(1);
+          Point2X_(nPoint) = Mean(2);
+          Point2Y_(nPoint) = Mean(3);
+        }
+        this->setWeights(Weights);
+
+        this->set_num_residuals(static_cast<int>(PointNumber) * ErrorType::OutputDim);
+        this->mutable_parameter_block_sizes()->push_back(2);
+        this->mutable_parameter_block_sizes()->push_back(1);
+        this->mutable_parameter_block_sizes()->push_back(2);
+        this->mutable_parameter_block_sizes()->push_back(1);
+      }
+
+      ~Point2ScanRegistrationFactor() override = default;
+
+      /** access the stored error model */
+      ErrorType* getErrorModel()
+      {
+        return &Error_;
+      }
+
+      [[nodiscard]] int getPointNumber() const
+      {
+        return static_cast<int>(Point1X_.size());
+      }
+
+      /** robust weight of each correspondence, e.g. from an outer re-weighting loop, the raw errors stay unweighted */
+      void setWeights(const Vector &Weights)
+      {
+        if (Weights.size() == Point1X_.size())
+        {
+          Weight_ = Weights.array();
+        }
+        else
+        {
+          if (Weights.size() > 0)
+          {
+            PRINT_ERROR("Wrong number of weights: ", Weights.size(), " instead of ", Point1X_.size());
+          }
+          Weight_.setOnes(Point1X_.size());
+        }
+      }
+
+      bool Evaluate(double const* const* Parameters, double* Residuals, double** Jacobians) const override
+      {
+        const double * const Pos1 = Parameters[0];
+        const double * const Pos2 = Parameters[2];
+        const double Cos1 = std::cos(Parameters[1][0]);
+        const double Sin1 = std::sin(Parameters[1][0]);
+        const double Cos2 = std::cos(Parameters[3][0]);
+        const double Sin2 = std::sin(Parameters[3][0]);
+        const Index PointNumber = Point1X_.size();
+        constexpr int OutputDim = ErrorType::OutputDim;
+
+        /** second point in the world frame relative to the first pose */
+        const ArrayVector RotX = Cos2 * Point2X_ - Sin2 * Point2Y_;
+        const ArrayVector RotY = Sin2 * Point2X_ + Cos2 * Point2Y_;
+        const ArrayVector DiffX = (Pos1[0] - Pos2[0]) - RotX;
+        const ArrayVector DiffY = (Pos1[1] - Pos2[1]) - RotY;
+
+        /** error in frame 1 */
+        const ArrayVector LocalX = Cos1 * DiffX + Sin1 * DiffY;
+        const ArrayVector LocalY = Cos1 * DiffY - Sin1 * DiffX;
+        ArrayVector ErrorX = Point1X_ + LocalX;
+        ArrayVector ErrorY = Point1Y_ + LocalY;
+        if (Error_.isEnabled())
+        {
+          ErrorX *= Weight_;
+          ErrorY *= Weight_;
+        }
+
+        if (Jacobians == nullptr)
+        {
+          for (Index nPoint = 0; nPoint < PointNumber; nPoint++)
+          {
+            if (!Error_.template weight<double>(Vector2(ErrorX(nPoint), ErrorY(nPoint)), Residuals + nPoint * OutputDim))
+            {
+              return false;
+            }
+          }
+          return true;
+        }
+
+        /** derivatives of the raw error w.r.t. both orientations */
+        const ArrayVector dYaw2X = Cos1 * RotY - Sin1 * RotX;
+        const ArrayVector dYaw2Y = -Sin1 * RotY - Cos1 * RotX;
+
+        /** derivative of the error model w.r.t. the 2D error */
+        using JetType = ceres::Jet<double, 2>;
+        JetType ResidualJets[OutputDim];
+
+        for (Index nPoint = 0; nPoint < PointNumber; nPoint++)
+        {
+          VectorT<JetType, 2> ErrorJet;
+          ErrorJet(0) = JetType(ErrorX(nPoint), 0);
+          ErrorJet(1) = JetType(ErrorY(nPoint), 1);
+
+          if (!Error_.template weight<JetType>(ErrorJet, ResidualJets))
+          {
+            return false;
+          }
+
+          const double Weight = Error_.isEnabled() ? Weight_(nPoint) : 1.0;
+
+          for (int nResidual = 0; nResidual < OutputDim; nResidual++)
+          {
+            const Index Row = nPoint * OutputDim + nResidual;
+            const double DerivativeX = ResidualJets[nResidual].v(0) * Weight;
+            const double DerivativeY = ResidualJets[nResidual].v(1) * Weight;
+
+            Residuals[Row] = ResidualJets[nResidual].a;
+
+            /** d(Error)/d(Pos1) = R1^T and d(Error)/d(Pos2) = -R1^T */
+            const double dPosX = DerivativeX * Cos1 - DerivativeY * Sin1;
+            const double dPosY = DerivativeX * Sin1 + DerivativeY * Cos1;
+            if (Jacobians[0] != nullptr)
+            {
+              Jacobians[0][Row * 2 + 0] = dPosX;
+              Jacobians[0][Row * 2 + 1] = dPosY;
+            }
+            if (Jacobians[1] != nullptr)
+            {
+              Jacobians[1][Row] = DerivativeX * LocalY(nPoint) - DerivativeY * LocalX(nPoint);
+            }
+            if (Jacobians[2] != nullptr)
+            {
+              Jacobians[2][Row * 2 + 0] = -dPosX;
+              Jacobians[2][Row * 2 + 1] = -dPosY;
+            }
+            if (Jacobians[3] != nullptr)
+            {
+              Jacobians[3][Row] = DerivativeX * dYaw2X(nPoint) + DerivativeY * dYaw2Y(nPoint);
+            }
+          }
+        }
+
+        return true;
+      }
+
+    private:
+      using ArrayVector = Eigen::Array<double, Dynamic, 1>;
+
+      ErrorType Error_;
+
+      ArrayVector Point1X_;
+      ArrayVector Point1Y_;
+      ArrayVector Point2X_;
+      ArrayVector Point2Y_;
+      ArrayVector Weight_;
+  };
+
   /** compile time mapping from factor type enum to corresponding factor class */
   template<typename ErrorType>
   struct FactorTypeTranslator<FactorType::Point2Reg, ErrorType> {using Type = Point2RegistrationFactor<ErrorType>;};
@@ -38,14 +38,13 @@
 namespace libRSF
 {
   template <typename ErrorType, int Dim>
-  class PressureDifferenceFactorBase : public BaseFactor<ErrorType, true, false, Dim, Dim>
+  class PressureDifferenceFactorBase : public BaseFactor<ErrorType, true, false, 1, Dim, Dim>
   {
   public:
     /** construct factor and store measurement */
-    PressureDifferenceFactorBase(ErrorType &Error, const Data &PressureMeasurement)
+    PressureDifferenceFactorBase(const ErrorType &Error, const Data &PressureMeasurement)
     {
       this->Error_ = Error;
-      this->MeasurementVector_.resize(1);
       this->MeasurementVector_ = PressureMeasurement.getMean();
     }
 
@@ -38,14 +38,16 @@
 
 namespace libRSF
 {
-  template <typename ErrorType, int Dim>  class PriorFactorBase : public BaseFactor<ErrorType, true, false, Dim>
+  template <typename ErrorType, int Dim>  class PriorFactorBase : public BaseFactor<ErrorType, true, false, Dim, Dim>
   {
     public:
+      /** the error is a linear function of the states */
+      const static bool IsLinear = true;
+
       /** construct factor and store measurement */
-      PriorFactorBase(ErrorType &Error, const Data &PriorMeasurement)
+      PriorFactorBase(const ErrorType &Error, const Data &PriorMeasurement)
       {
         this->Error_ = Error;
-        this->MeasurementVector_.resize(Dim);
         this->MeasurementVector_ = PriorMeasurement.getMean();
       }
 
@@ -78,14 +80,13 @@ namespace libRSF
 
 
   template <typename ErrorType>
-  class PriorFactorAngle : public BaseFactor<ErrorType, true, false, 1>
+  class PriorFactorAngle : public BaseFactor<ErrorType, true, false, 1, 1>
   {
     public:
       /** construct factor and store measurement */
-      PriorFactorAngle(ErrorType &Error, const Data &PriorAngle)
+      PriorFactorAngle(const ErrorType &Error, const Data &PriorAngle)
       {
         this->Error_ = Error;
-        this->MeasurementVector_.resize(1);
         this->MeasurementVector_ = PriorAngle.getMean();
       }
 
@@ -117,14 +118,13 @@ namespace libRSF
   };
 
   template <typename ErrorType>
-  class PriorFactorQuaternion : public BaseFactor<ErrorType, true, false, 4>
+  class PriorFactorQuaternion : public BaseFactor<ErrorType, true, false, 4, 4>
   {
     public:
       /** construct factor and store measurement */
-      PriorFactorQuaternion(ErrorType &Error, const Data &PriorQuaternion)
+      PriorFactorQuaternion(const ErrorType &Error, const Data &PriorQuaternion)
       {
         this->Error_ = Error;
-        this->MeasurementVector_.resize(4);
         this->MeasurementVector_ = PriorQuaternion.getMean();
       }
 
@@ -0,0 +1,185 @@
+/***************************************************************************
+ * libRSF - A Robust Sensor Fusion Library
+ *
+ * Copyright (C) 2018 Chair of Automation Technology / TU Chemnitz
+ * For more information see https://www.tu-chemnitz.de/etit/proaut/libRSF
+ *
+ * libRSF is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libRSF is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with libRSF.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Tim Pfeifer (tim.pfeifer@etit.tu-chemnitz.de)
+ ***************************************************************************/
+
+/**
+ * @file PseudorangeEpochFactor.h
+ * @author Tim Pfeifer
+ * @date 14.10.2026
+ * @brief A factor that evaluates all pseudo ranges of one epoch at once.
+ * @copyright GNU Public License.
+ *
+ */
+
+#ifndef PSEUDORANGEEPOCHFACTOR_H
+#define PSEUDORANGEEPOCHFACTOR_H
+
+#include "BaseFactor.h"
+#include "../Data.h"
+#include "../VectorTypes.h"
+
+#include <ceres/ceres.h>
+
+#include <vector>
+
+namespace libRSF
+{
+  /** [Position(3), ClockError(1)] -> one weighted error per satellite, all satellites share the error model */
+  template <typename ErrorType>
+  class PseudorangeEpochFactor : public ceres::CostFunction
+  {
+    static_assert(ErrorType::InputDim == 1 && ErrorType::StateDims::size() == 0,
+                  "The epoch factor requires an 1D error model without own states!");
+
+    public:
+      /** with WeightWithCovariance, every raw error is scaled by the standard deviation of its measurement */
+      PseudorangeEpochFactor(const ErrorType &Error, const std::vector<Data> &Pseudoranges, const bool WeightWithCovariance)
+      : Error_(Error)
+      {
+        const Index SatNumber = static_cast<Index>(Pseudoranges.size());
+
+        /** store satellites as structure of arrays, so that the geometry is vectorized over satellites */
+        SatX_.resize(SatNumber);
+        SatY_.resize(SatNumber);
+        SatZ_.resize(SatNumber);
+        Range_.resize(SatNumber);
+        Scale_.setOnes(SatNumber);
+
+        for (Index nSat = 0; nSat < SatNumber; nSat++)
+        {
+          const Data &Pseudorange = Pseudoranges.at(nSat);
+          const Vector3 SatPos = Pseudorange.getValue(DataElement::SatPos);
+
+          SatX_(nSat) = SatPos(0);
+          SatY_(nSat) = SatPos(1);
+          SatZ_(nSat) = SatPos(2);
+          Range_(nSat) = Pseudorange.getMean()(0);
+
+          if (WeightWithCovariance)
+          {
+            Scale_(nSat) = 1.0 / Pseudorange.getStdDevDiagonal()(0);
+          }
+        }
+
+        this->set_num_residuals(static_cast<int>(SatNumber) * ErrorType::OutputDim);
+        this->mutable_parameter_block_sizes()->push_back(3);
+        this->mutable_parameter_block_sizes()->push_back(1);
+      }
+
+      ~PseudorangeEpochFactor() override = default;
+
+      /** access the stored error model */
+      ErrorType* getErrorModel()
+      {
+        return &Error_;
+      }
+
+      [[nodiscard]] int getSatelliteNumber() const
+      {
+        return static_cast<int>(Range_.size());
+      }
+
+      bool Evaluate(double const* const* Parameters, double* Residuals, double** Jacobians) const override
+      {
+        const double * const Position = Parameters[0];
+        const double ClockError = Parameters[1][0];
+        const Index SatNumber = Range_.size();
+        constexpr int OutputDim = ErrorType::OutputDim;
+
+        /** geometry of all satellites */
+        const ArrayVector DiffX = Position[0] - SatX_;
+        const ArrayVector DiffY = Position[1] - SatY_;
+        const ArrayVector DiffZ = Position[2] - SatZ_;
+        const ArrayVector Distance = (DiffX.square() + DiffY.square() + DiffZ.square()).sqrt();
+
+        /** the covariance is only applied together with the error model, so that unweighted errors stay raw */
+        ArrayVector RawError = Distance + ClockError - Range_;
+        if (Error_.isEnabled())
+        {
+          RawError *= Scale_;
+        }
+
+        if (Jacobians == nullptr)
+        {
+          for (Index nSat = 0; nSat < SatNumber; nSat++)
+          {
+            if (!Error_.template weight<double>(VectorStatic<1>(RawError(nSat)), Residuals + nSat * OutputDim))
+            {
+              return false;
+            }
+          }
+          return true;
+        }
+
+        /** derivative of the error model w.r.t. the scalar error */
+        using JetType = ceres::Jet<double, 1>;
+        const ArrayVector InvDistance = (Distance > 0.0).select(Distance.inverse(), 0.0);
+        JetType ResidualJets[OutputDim];
+
+        for (Index nSat = 0; nSat < SatNumber; nSat++)
+        {
+          VectorT<JetType, 1> ErrorJet;
+          ErrorJet(0) = JetType(RawError(nSat), 0);
+
+          if (!Error_.template weight<JetType>(ErrorJet, ResidualJets))
+          {
+            return false;
+          }
+
+          const double Scale = Error_.isEnabled() ? Scale_(nSat) : 1.0;
+
+          for (int nResidual = 0; nResidual < OutputDim; nResidual++)
+          {
+            const Index Row = nSat * OutputDim + nResidual;
+            const double Derivative = ResidualJets[nResidual].v(0) * Scale;
+
+            Residuals[Row] = ResidualJets[nResidual].a;
+
+            if (Jacobians[0] != nullptr)
+            {
+              Jacobians[0][Row * 3 + 0] = Derivative * DiffX(nSat) * InvDistance(nSat);
+              Jacobians[0][Row * 3 + 1] = Derivative * DiffY(nSat) * InvDistance(nSat);
+              Jacobians[0][Row * 3 + 2] = Derivative * DiffZ(nSat) * InvDistance(nSat);
+            }
+            if (Jacobians[1] != nullptr)
+            {
+              Jacobians[1][Row] = Derivative;
+            }
+          }
+        }
+
+        return true;
+      }
+
+    private:
+      using ArrayVector = Eigen::Array<double, Dynamic, 1>;
+
+      ErrorType Error_;
+
+      ArrayVector SatX_;
+      ArrayVector SatY_;
+      ArrayVector SatZ_;
+      ArrayVector Range_;
+      ArrayVector Scale_;
+  };
+}
+
+#endif // PSEUDORANGEEPOCHFACTOR_H
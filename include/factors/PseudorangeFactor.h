@@ -35,6 +35,7 @@
 #include "RangeFactor.h"
 #include "BaseFactor.h"
 #include "../Geometry.h"
+#include "../SatelliteStore.h"
 #include "../Constants.h"
 #include "../VectorMath.h"
 
@@ -47,19 +48,22 @@ namespace libRSF
     return (EARTH_ROTATION_RATE * (SatPos[0] * EgoPos[1] - SatPos[1] * EgoPos[0])) / SPEED_OF_LIGHT;
   }
 
-  template <typename ErrorType, int Dim>
-  class PseudorangeFactorBase : public BaseFactor< ErrorType, true, false, Dim, 1>
+  /** the clock block holds the clock error first, with ClockDim = 2 it is the combined [error, drift] state */
+  template <typename ErrorType, int Dim, int ClockDim = 1>
+  class PseudorangeFactorBase : public BaseFactor< ErrorType, true, false, 0, Dim, ClockDim>
   {
     public:
       /** construct factor and store measurement */
-      PseudorangeFactorBase(ErrorType &Error, const Data &Pseudorange)
+      PseudorangeFactorBase(const ErrorType &Error, const Data &Pseudorange, const std::shared_ptr<SatelliteStore> &Satellites)
       {
         this->Error_ = Error;
-        this->MeasurementVector_.resize(Dim + 1);
-        this->MeasurementVector_[0] = Pseudorange.getMean()[0];
-        this->MeasurementVector_.tail(Dim) = Pseudorange.getValue(DataElement::SatPos);
+        Range_ = Pseudorange.getMean()[0];
+        Satellite_ = SatelliteReference(Satellites, Satellites->add(Pseudorange));
       }
 
+      /** the satellite position is shared with all factors of the same satellite and epoch */
+      const static bool UsesSatelliteStore = true;
+
       /** geometric error model */
       template <typename T>
       VectorT<T, 1> Evaluate(const T* const EgoPos,
@@ -74,6 +78,20 @@ namespace libRSF
         return Error;
       }
 
+      /** analytic error and gradient, see AnalyticCostFunction */
+      bool EvaluateWithJacobian(double const* const* States, double &Error, double **Gradients) const
+      {
+        const VectorStatic<Dim> Difference = VectorRefConst<double, Dim>(States[0]) - Satellite_.get<Dim>();
+        const double Distance = Difference.norm();
+
+        Error = Distance + States[1][0] - Range_;
+        VectorRef<double, Dim> Gradient(Gradients[0]);
+        Gradient = (Distance > 0.0) ? VectorStatic<Dim>(Difference / Distance) : VectorStatic<Dim>::Zero();
+        VectorRef<double, ClockDim>(Gradients[1]).setZero();
+        Gradients[1][0] = 1.0;
+        return true;
+      }
+
       /** combine probabilistic and geometric model */
       template <typename T, typename... ParamsType>
       bool operator()(const T* const Position,
@@ -82,25 +100,31 @@ namespace libRSF
       {
         return this->Error_.template weight<T>(this->Evaluate(Position,
                                                Offset,
-                                               this->MeasurementVector_.tail(Dim),
-                                               this->MeasurementVector_(0)),
+                                               Satellite_.get<Dim>(),
+                                               Range_),
                                                Params...);
       }
+
+    private:
+      double Range_;
+      SatelliteReference Satellite_;
   };
 
   template <typename ErrorType, int Dim>
-  class PseudorangeBiasFactorBase : public BaseFactor< ErrorType, true, false, Dim, 1, 1>
+  class PseudorangeBiasFactorBase : public BaseFactor< ErrorType, true, false, 0, Dim, 1, 1>
   {
    public:
     /** construct factor and store measurement */
-    PseudorangeBiasFactorBase(ErrorType &Error, const Data &Pseudorange)
+    PseudorangeBiasFactorBase(const ErrorType &Error, const Data &Pseudorange, const std::shared_ptr<SatelliteStore> &Satellites)
     {
       this->Error_ = Error;
-      this->MeasurementVector_.resize(Dim + 1);
-      this->MeasurementVector_[0] = Pseudorange.getMean()[0];
-      this->MeasurementVector_.tail(Dim) = Pseudorange.getValue(DataElement::SatPos);
+      Range_ = Pseudorange.getMean()[0];
+      Satellite_ = SatelliteReference(Satellites, Satellites->add(Pseudorange));
     }
 
+    /** the satellite position is shared with all factors of the same satellite and epoch */
+    const static bool UsesSatelliteStore = true;
+
     /** geometric error model */
     template <typename T>
     VectorT<T, 1> Evaluate(const T* const EgoPos,
@@ -117,6 +141,20 @@ namespace libRSF
       return Error;
     }
 
+    /** analytic error and gradient, see AnalyticCostFunction */
+    bool EvaluateWithJacobian(double const* const* States, double &Error, double **Gradients) const
+    {
+      const VectorStatic<Dim> Difference = VectorRefConst<double, Dim>(States[0]) - Satellite_.get<Dim>();
+      const double Distance = Difference.norm();
+
+      Error = Distance + States[1][0] + States[2][0] - Range_;
+      VectorRef<double, Dim> Gradient(Gradients[0]);
+      Gradient = (Distance > 0.0) ? VectorStatic<Dim>(Difference / Distance) : VectorStatic<Dim>::Zero();
+      Gradients[1][0] = 1.0;
+      Gradients[2][0] = 1.0;
+      return true;
+    }
+
     /** combine probabilistic and geometric model */
     template <typename T, typename... ParamsType>
     bool operator()(const T* const Position,
@@ -127,25 +165,32 @@ namespace libRSF
       return this->Error_.template weight<T>(this->Evaluate(Position,
                                                             Offset,
                                                             InterSystemBias,
-                                                            this->MeasurementVector_.tail(Dim),
-                                                            this->MeasurementVector_(0)),
+                                                            Satellite_.get<Dim>(),
+                                                            Range_),
                                              Params...);
     }
+
+   private:
+    double Range_;
+    SatelliteReference Satellite_;
   };
 
-  template <typename ErrorType, int Dim>
-  class PseudorangeSagnacFactorBase : public BaseFactor<ErrorType, true, false, Dim, 1>
+  /** the clock block holds the clock error first, with ClockDim = 2 it is the combined [error, drift] state */
+  template <typename ErrorType, int Dim, int ClockDim = 1>
+  class PseudorangeSagnacFactorBase : public BaseFactor<ErrorType, true, false, 0, Dim, ClockDim>
   {
     public:
       /** construct factor and store measurement */
-      PseudorangeSagnacFactorBase(ErrorType &Error, const Data &Pseudorange)
+      PseudorangeSagnacFactorBase(const ErrorType &Error, const Data &Pseudorange, const std::shared_ptr<SatelliteStore> &Satellites)
       {
         this->Error_ = Error;
-        this->MeasurementVector_.resize(Dim + 1);
-        this->MeasurementVector_[0] = Pseudorange.getMean()[0];
-        this->MeasurementVector_.tail(Dim) = Pseudorange.getValue(DataElement::SatPos);
+        Range_ = Pseudorange.getMean()[0];
+        Satellite_ = SatelliteReference(Satellites, Satellites->add(Pseudorange));
       }
 
+      /** the satellite position is shared with all factors of the same satellite and epoch */
+      const static bool UsesSatelliteStore = true;
+
       /** geometric error model */
       template <typename T>
       VectorT<T, 1> Evaluate(const T* const EgoPos,
@@ -161,6 +206,23 @@ namespace libRSF
         return Error;
       }
 
+      /** analytic error and gradient, see AnalyticCostFunction */
+      bool EvaluateWithJacobian(double const* const* States, double &Error, double **Gradients) const
+      {
+        const Vector3 SatPos = Satellite_.get<Dim>();
+        const VectorStatic<Dim> Difference = VectorRefConst<double, Dim>(States[0]) - SatPos;
+        const double Distance = Difference.norm();
+
+        Error = Distance + RelativisticCorrection(States[0], SatPos) + States[1][0] - Range_;
+        VectorRef<double, Dim> Gradient(Gradients[0]);
+        Gradient = (Distance > 0.0) ? VectorStatic<Dim>(Difference / Distance) : VectorStatic<Dim>::Zero();
+        Gradients[0][0] -= EARTH_ROTATION_RATE * SatPos[1] / SPEED_OF_LIGHT;
+        Gradients[0][1] += EARTH_ROTATION_RATE * SatPos[0] / SPEED_OF_LIGHT;
+        VectorRef<double, ClockDim>(Gradients[1]).setZero();
+        Gradients[1][0] = 1.0;
+        return true;
+      }
+
       /** combine probabilistic and geometric model */
       template <typename T, typename... ParamsType>
       bool operator()(const T* const Position,
@@ -168,10 +230,14 @@ namespace libRSF
                       ParamsType... Params) const
       {
         return this->Error_.template weight<T>(this->Evaluate(Position, Offset,
-                                               this->MeasurementVector_.tail(Dim),
-                                               this->MeasurementVector_(0)),
+                                               Satellite_.get<Dim>(),
+                                               Range_),
                                                Params...);
       }
+
+    private:
+      double Range_;
+      SatelliteReference Satellite_;
   };
 
   /** compile time mapping from factor type enum to corresponding factor class */
@@ -183,6 +249,10 @@ namespace libRSF
   struct FactorTypeTranslator<FactorType::Pseudorange3_Bias, ErrorType> {using Type = PseudorangeBiasFactorBase<ErrorType, 3>;};
   template<typename ErrorType>
   struct FactorTypeTranslator<FactorType::Pseudorange3_ECEF, ErrorType> {using Type = PseudorangeSagnacFactorBase<ErrorType, 3>;};
+  template<typename ErrorType>
+  struct FactorTypeTranslator<FactorType::Pseudorange3_Clock, ErrorType> {using Type = PseudorangeFactorBase<ErrorType, 3, 2>;};
+  template<typename ErrorType>
+  struct FactorTypeTranslator<FactorType::Pseudorange3_ECEF_Clock, ErrorType> {using Type = PseudorangeSagnacFactorBase<ErrorType, 3, 2>;};
 }
 
 #endif // PSEUDORANGEFACTOR_H
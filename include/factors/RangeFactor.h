@@ -38,14 +38,13 @@
 namespace libRSF
 {
   template <typename ErrorType, int Dim>
-  class RangeFactorBase : public BaseFactor<ErrorType, true, false, Dim>
+  class RangeFactorBase : public BaseFactor<ErrorType, true, false, Dim + 1, Dim>
   {
     public:
       /** construct factor and store measurement */
-      RangeFactorBase(ErrorType &Error, const Data &Range)
+      RangeFactorBase(const ErrorType &Error, const Data &Range)
       {
         this->Error_ = Error;
-        this->MeasurementVector_.resize(Dim + 1);
         this->MeasurementVector_[0] = Range.getMean()[0];
         this->MeasurementVector_.tail(Dim) = Range.getValue(DataElement::SatPos);
       }
@@ -62,6 +61,19 @@ namespace libRSF
         return Error;
       }
 
+      /** analytic error and gradient, see AnalyticCostFunction */
+      bool EvaluateWithJacobian(double const* const* States, double &Error, double **Gradients) const
+      {
+        const VectorRefConst<double, Dim> Position(States[0]);
+        const VectorStatic<Dim> Difference = Position - this->MeasurementVector_.tail(Dim);
+        const double Distance = Difference.norm();
+
+        Error = Distance - this->MeasurementVector_(0);
+        VectorRef<double, Dim> Gradient(Gradients[0]);
+        Gradient = (Distance > 0.0) ? VectorStatic<Dim>(Difference / Distance) : VectorStatic<Dim>::Zero();
+        return true;
+      }
+
       /** combine probabilistic and geometric model */
       template <typename T, typename... ParamsType>
       bool operator()(const T* const Position,
@@ -38,11 +38,11 @@
 namespace libRSF
 {
   template <typename ErrorType, int Dim>
-  class RangeToPointFactorBase : public BaseFactor<ErrorType, true, false, Dim, Dim>
+  class RangeToPointFactorBase : public BaseFactor<ErrorType, true, false, 1, Dim, Dim>
   {
     public:
       /** construct factor and store measurement */
-     RangeToPointFactorBase(ErrorType &Error, const Data &Range)
+     RangeToPointFactorBase(const ErrorType &Error, const Data &Range)
       {
         this->Error_ = Error;
         this->MeasurementVector_ = Range.getMean();
@@ -60,6 +60,20 @@ namespace libRSF
         return Error;
       }
 
+      /** analytic error and gradient, see AnalyticCostFunction */
+      bool EvaluateWithJacobian(double const* const* States, double &Error, double **Gradients) const
+      {
+        const VectorStatic<Dim> Difference = VectorRefConst<double, Dim>(States[0]) - VectorRefConst<double, Dim>(States[1]);
+        const double Distance = Difference.norm();
+
+        Error = Distance - this->MeasurementVector_(0);
+        VectorRef<double, Dim> Gradient1(Gradients[0]);
+        VectorRef<double, Dim> Gradient2(Gradients[1]);
+        Gradient1 = (Distance > 0.0) ? VectorStatic<Dim>(Difference / Distance) : VectorStatic<Dim>::Zero();
+        Gradient2 = -Gradient1;
+        return true;
+      }
+
       /** combine probabilistic and geometric model */
       template <typename T, typename... ParamsType>
       bool operator()(const T* const Position1,
@@ -0,0 +1,95 @@
+/***************************************************************************
+ * libRSF - A Robust Sensor Fusion Library
+ *
+ * Copyright (C) 2018 Chair of Automation Technology / TU Chemnitz
+ * For more information see https://www.tu-chemnitz.de/etit/proaut/libRSF
+ *
+ * libRSF is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libRSF is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with libRSF.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Tim Pfeifer (tim.pfeifer@etit.tu-chemnitz.de)
+ ***************************************************************************/
+
+/**
+ * @file TimedCostFunction.h
+ * @author Tim Pfeifer
+ * @date 14.10.2026
+ * @brief Cost function wrapper that measures the evaluation time of the wrapped factor.
+ * @copyright GNU Public License.
+ *
+ */
+
+#ifndef TIMEDCOSTFUNCTION_H
+#define TIMEDCOSTFUNCTION_H
+
+#include "../FactorPool.h"
+
+#include <ceres/ceres.h>
+
+#include <atomic>
+#include <chrono>
+
+namespace libRSF
+{
+  /** accumulated over all factors of one type, ceres may evaluate them in parallel */
+  struct EvaluationTiming
+  {
+    std::atomic<long long> Nanoseconds {0};
+    std::atomic<long long> Evaluations {0};
+
+    void reset()
+    {
+      Nanoseconds.store(0, std::memory_order_relaxed);
+      Evaluations.store(0, std::memory_order_relaxed);
+    }
+  };
+
+  class TimedCostFunction : public ceres::CostFunction
+  {
+    public:
+      /** the wrapped cost function is returned to its pool together with the wrapper */
+      TimedCostFunction(ceres::CostFunction *CostFunction, FactorPool *Owner, EvaluationTiming *Timing) :
+        CostFunction_(CostFunction), Owner_(Owner), Timing_(Timing)
+      {
+        this->set_num_residuals(CostFunction_->num_residuals());
+        *this->mutable_parameter_block_sizes() = CostFunction_->parameter_block_sizes();
+      }
+
+      ~TimedCostFunction() override
+      {
+        Owner_->destroy(CostFunction_);
+      }
+
+      TimedCostFunction(const TimedCostFunction&) = delete;
+      TimedCostFunction& operator=(const TimedCostFunction&) = delete;
+
+      bool Evaluate(double const* const* Parameters, double* Residuals, double** Jacobians) const override
+      {
+        const auto Start = std::chrono::steady_clock::now();
+        const bool Success = CostFunction_->Evaluate(Parameters, Residuals, Jacobians);
+        const auto End = std::chrono::steady_clock::now();
+
+        Timing_->Nanoseconds.fetch_add(std::chrono::duration_cast<std::chrono::nanoseconds>(End - Start).count(), std::memory_order_relaxed);
+        Timing_->Evaluations.fetch_add(1, std::memory_order_relaxed);
+
+        return Success;
+      }
+
+    private:
+      ceres::CostFunction *CostFunction_;
+      FactorPool *Owner_;
+      EvaluationTiming *Timing_;
+  };
+}
+
+#endif // TIMEDCOSTFUNCTION_H
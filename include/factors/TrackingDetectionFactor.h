@@ -40,14 +40,13 @@ namespace libRSF
 {
   /**< pure detection factor, only with position*/
   template <typename ErrorType>
-  class TrackingDetectionFactor : public BaseFactor<ErrorType, true, false, 3>
+  class TrackingDetectionFactor : public BaseFactor<ErrorType, true, false, 3, 3>
   {
     public:
       /** construct factor and store error model */
-      TrackingDetectionFactor(ErrorType &Error, const Data &PriorMeasurement)
+      TrackingDetectionFactor(const ErrorType &Error, const Data &PriorMeasurement)
       {
         this->Error_ = Error;
-        this->MeasurementVector_.resize(3);
         this->MeasurementVector_ = PriorMeasurement.getMean().head(3);
       }
 
@@ -73,14 +72,13 @@ namespace libRSF
 
   /**< partial factor only with rotation */
   template <typename ErrorType>
-  class TrackingDetectionRotFactor : public BaseFactor<ErrorType, true, false, 3, 2>
+  class TrackingDetectionRotFactor : public BaseFactor<ErrorType, true, false, 5, 3, 2>
   {
     public:
       /** construct factor and store error model */
-      TrackingDetectionRotFactor(ErrorType &Error, const Data &PriorMeasurement)
+      TrackingDetectionRotFactor(const ErrorType &Error, const Data &PriorMeasurement)
       {
         this->Error_ = Error;
-        this->MeasurementVector_.resize(5);
         this->MeasurementVector_ << PriorMeasurement.getMean().head(3), PriorMeasurement.getMean().tail(2);
       }
 
@@ -114,14 +112,13 @@ namespace libRSF
 
   /**< partial factor only with dimensions*/
   template <typename ErrorType>
-  class TrackingDetectionDimFactor : public BaseFactor<ErrorType, true, false, 3, 3>
+  class TrackingDetectionDimFactor : public BaseFactor<ErrorType, true, false, 6, 3, 3>
   {
     public:
       /** construct factor and store error model */
-      TrackingDetectionDimFactor(ErrorType &Error, const Data &PriorMeasurement)
+      TrackingDetectionDimFactor(const ErrorType &Error, const Data &PriorMeasurement)
       {
         this->Error_ = Error;
-        this->MeasurementVector_.resize(6);
         this->MeasurementVector_ << PriorMeasurement.getMean().head(3), PriorMeasurement.getMean().segment(6,3);
       }
 
@@ -155,14 +152,13 @@ namespace libRSF
 
   /**< partial factor only with velocity*/
   template <typename ErrorType>
-  class TrackingDetectionVelFactor : public BaseFactor<ErrorType, true, false, 3, 3>
+  class TrackingDetectionVelFactor : public BaseFactor<ErrorType, true, false, 6, 3, 3>
   {
     public:
       /** construct factor and store error model */
-      TrackingDetectionVelFactor(ErrorType &Error, const Data &PriorMeasurement)
+      TrackingDetectionVelFactor(const ErrorType &Error, const Data &PriorMeasurement)
       {
         this->Error_ = Error;
-        this->MeasurementVector_.resize(6);
         this->MeasurementVector_ = PriorMeasurement.getMean().head(6);
       }
 
@@ -196,14 +192,13 @@ namespace libRSF
 
   /**< partial factor with dimensions and rotation */
   template <typename ErrorType>
-  class TrackingDetectionDimRotFactor : public BaseFactor<ErrorType, true, false, 3, 3, 2>
+  class TrackingDetectionDimRotFactor : public BaseFactor<ErrorType, true, false, 8, 3, 3, 2>
   {
     public:
       /** construct factor and store error model */
-      TrackingDetectionDimRotFactor(ErrorType &Error, const Data &PriorMeasurement)
+      TrackingDetectionDimRotFactor(const ErrorType &Error, const Data &PriorMeasurement)
       {
         this->Error_ = Error;
-        this->MeasurementVector_.resize(8);
         this->MeasurementVector_ << PriorMeasurement.getMean().head(3), PriorMeasurement.getMean().tail(5);
       }
 
@@ -241,14 +236,13 @@ namespace libRSF
 
   /**< partial factor with velocity and rotation */
   template <typename ErrorType>
-  class TrackingDetectionVelRotFactor : public BaseFactor<ErrorType, true, false, 3, 3, 2>
+  class TrackingDetectionVelRotFactor : public BaseFactor<ErrorType, true, false, 8, 3, 3, 2>
   {
     public:
       /** construct factor and store error model */
-      TrackingDetectionVelRotFactor(ErrorType &Error, const Data &PriorMeasurement)
+      TrackingDetectionVelRotFactor(const ErrorType &Error, const Data &PriorMeasurement)
       {
         this->Error_ = Error;
-        this->MeasurementVector_.resize(8);
         this->MeasurementVector_ << PriorMeasurement.getMean().head(6), PriorMeasurement.getMean().tail(2);
       }
 
@@ -286,14 +280,13 @@ namespace libRSF
 
   /**< partial factor with velocity and dimensions */
   template <typename ErrorType>
-  class TrackingDetectionVelDimFactor : public BaseFactor<ErrorType, true, false, 3, 3, 3>
+  class TrackingDetectionVelDimFactor : public BaseFactor<ErrorType, true, false, 9, 3, 3, 3>
   {
     public:
       /** construct factor and store error model */
-      TrackingDetectionVelDimFactor(ErrorType &Error, const Data &PriorMeasurement)
+      TrackingDetectionVelDimFactor(const ErrorType &Error, const Data &PriorMeasurement)
       {
         this->Error_ = Error;
-        this->MeasurementVector_.resize(9);
         this->MeasurementVector_ = PriorMeasurement.getMean().head(9);
       }
 
@@ -331,14 +324,13 @@ namespace libRSF
 
   /**< complete factor with velocity, dimensions and rotation */
   template <typename ErrorType>
-  class TrackingDetectionVelDimRotFactor : public BaseFactor<ErrorType, true, false, 3, 3, 3, 2>
+  class TrackingDetectionVelDimRotFactor : public BaseFactor<ErrorType, true, false, 11, 3, 3, 3, 2>
   {
     public:
       /** construct factor and store error model */
-      TrackingDetectionVelDimRotFactor(ErrorType &Error, const Data &PriorMeasurement)
+      TrackingDetectionVelDimRotFactor(const ErrorType &Error, const Data &PriorMeasurement)
       {
         this->Error_ = Error;
-        this->MeasurementVector_.resize(11);
         this->MeasurementVector_ = PriorMeasurement.getMean();
       }
 
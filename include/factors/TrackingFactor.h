@@ -38,11 +38,11 @@
 namespace libRSF
 {
   template <typename ErrorType>
-  class RepellingFactor : public BaseFactor<ErrorType, false, false, 3, 3>
+  class RepellingFactor : public BaseFactor<ErrorType, false, false, 0, 3, 3>
   {
     public:
       /** construct factor and store error model */
-      explicit RepellingFactor(ErrorType &Error)
+      explicit RepellingFactor(const ErrorType &Error)
       {
         this->Error_ = Error;
       }
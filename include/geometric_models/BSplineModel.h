@@ -0,0 +1,83 @@
+/***************************************************************************
+ * libRSF - A Robust Sensor Fusion Library
+ *
+ * Copyright (C) 2018 Chair of Automation Technology / TU Chemnitz
+ * For more information see https://www.tu-chemnitz.de/etit/proaut/libRSF
+ *
+ * libRSF is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libRSF is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with libRSF.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Tim Pfeifer (tim.pfeifer@etit.tu-chemnitz.de)
+ ***************************************************************************/
+
+/**
+ * @file BSplineModel.h
+ * @author Tim Pfeifer
+ * @date 14.10.2026
+ * @brief Uniform cumulative cubic B-splines in R^n and on SO(3).
+ * @copyright GNU Public License.
+ *
+ */
+
+#ifndef BSPLINEMODEL_H
+#define BSPLINEMODEL_H
+
+#include "../Geometry.h"
+
+namespace libRSF
+{
+  /** \brief Cumulative basis of a uniform cubic B-spline.
+   *
+   * Between the knots of the control points 1 and 2, the spline is
+   * x(u) = x0 + sum_j B_j(u) * (x_j - x_j-1) for j = 1..3 with the normalized time u in [0, 1].
+   * The same form with Exp() and Log() describes the rotation, so both share this basis.
+   * The first basis is always one and thus not returned.
+   */
+  Vector3 CumulativeBSplineBasis(double U);
+
+  /** normalized time of Time in the segment of four control points with the given first and last timestamp, clamped to [0, 1] */
+  double BSplineSegmentTime(double Time, double TimeFirst, double TimeLast);
+
+  /** value of a spline in R^Dim from four control points */
+  template <typename T, int Dim>
+  VectorT<T, Dim> BSplineValue(const T* const P0, const T* const P1, const T* const P2, const T* const P3,
+                               const Vector3 &Basis)
+  {
+    VectorRefConst<T, Dim> X0(P0);
+    VectorRefConst<T, Dim> X1(P1);
+    VectorRefConst<T, Dim> X2(P2);
+    VectorRefConst<T, Dim> X3(P3);
+
+    return X0 + (X1 - X0) * T(Basis(0)) + (X2 - X1) * T(Basis(1)) + (X3 - X2) * T(Basis(2));
+  }
+
+  /** rotation of a spline on SO(3) from four quaternion control points [x, y, z, w] */
+  template <typename T>
+  QuaternionT<T> BSplineQuaternion(const T* const Q0, const T* const Q1, const T* const Q2, const T* const Q3,
+                                   const Vector3 &Basis)
+  {
+    const T* const Points[4] = {Q0, Q1, Q2, Q3};
+
+    QuaternionT<T> Result = QuaternionRefConst<T>(Q0);
+    for (int j = 1; j < 4; j++)
+    {
+      const QuaternionRefConst<T> Prev(Points[j - 1]);
+      const QuaternionRefConst<T> Next(Points[j]);
+      const VectorT<T, 3> Delta = QuaternionLogMap<T>(Prev.conjugate() * Next) * T(Basis(j - 1));
+      Result = Result * QuaternionExpMap<T>(Delta);
+    }
+    return Result;
+  }
+}
+
+#endif // BSPLINEMODEL_H
@@ -39,6 +39,62 @@
 
 namespace libRSF
 {
+  /** raw IMU samples stored as separate arrays, the memory is reserved in advance */
+  class IMUSampleBuffer
+  {
+    public:
+      explicit IMUSampleBuffer(size_t Capacity = 1024);
+      ~IMUSampleBuffer() = default;
+
+      void add(double Timestamp,
+               const Vector3 &Acceleration, const Vector3 &TurnRate,
+               const Vector3 &AccelerationCov, const Vector3 &TurnRateCov);
+      void add(const Data &IMUMeasurement);
+
+      [[nodiscard]] size_t size() const
+      {
+        return Timestamps_.size();
+      }
+
+      [[nodiscard]] bool empty() const
+      {
+        return Timestamps_.empty();
+      }
+
+      [[nodiscard]] double getTimestamp(const size_t Index) const
+      {
+        return Timestamps_[Index];
+      }
+
+      [[nodiscard]] const Vector3 &getAcceleration(const size_t Index) const
+      {
+        return Acceleration_[Index];
+      }
+
+      [[nodiscard]] const Vector3 &getTurnRate(const size_t Index) const
+      {
+        return TurnRate_[Index];
+      }
+
+      /** diagonal of the measurement covariances */
+      [[nodiscard]] const Vector3 &getAccelerationCov(const size_t Index) const
+      {
+        return AccelerationCov_[Index];
+      }
+
+      [[nodiscard]] const Vector3 &getTurnRateCov(const size_t Index) const
+      {
+        return TurnRateCov_[Index];
+      }
+
+    private:
+      std::vector<double> Timestamps_;
+      std::vector<Vector3> Acceleration_;
+      std::vector<Vector3> TurnRate_;
+      std::vector<Vector3> AccelerationCov_;
+      std::vector<Vector3> TurnRateCov_;
+  };
+
   struct PreintegratedIMUResult
   {
      /** measurement biases (fixed during integration) */
@@ -70,7 +126,13 @@ namespace libRSF
       double StartTime;
 
       /** all IMU measurements */
-      std::vector<libRSF::Data> Measurements;
+      IMUSampleBuffer Measurements;
+
+      /** noise parameters, to repeat the integration with another bias */
+      double NoiseDensityAcc;
+      double NoiseDensityGyro;
+      double RandomWalkAcc;
+      double RandomWalkGyro;
   };
 
   class IMUPreintegrator
@@ -88,18 +150,42 @@ namespace libRSF
       virtual ~IMUPreintegrator() = default;
 
       void addMeasurement(const Data &IMUMeasurement);
+
+      /** raw variant without any Data object, that does not allocate memory */
+      void addMeasurement(double Timestamp,
+                          const Vector3 &Acceleration, const Vector3 &TurnRate,
+                          const Vector3 &AccelerationCov, const Vector3 &TurnRateCov);
       void integrateToTime(double Timestamp);
-      void updateBias(const Vector3 &BiasAcc, const Vector3 &BiasTR);
+      /** full re-integration, skipped if the bias changes less than the threshold; returns true if it was done */
+      bool updateBias(const Vector3 &BiasAcc, const Vector3 &BiasTR, double Threshold = 0.0);
 
       PreintegratedIMUResult getPreintegratedState();
 
+      /** repeat a pre-integration with a new bias as linearization point */
+      static PreintegratedIMUResult Reintegrate(const PreintegratedIMUResult &Preintegration,
+                                                const Vector3 &BiasAcc, const Vector3 &BiasTR);
+
+      /** pre-integrates the samples of each interval (Boundaries[n], Boundaries[n+1]] in parallel, with one common bias */
+      static bool integrateIntervals(const IMUSampleBuffer &Samples,
+                                     const std::vector<double> &Boundaries,
+                                     const Vector3 &BiasAcc, const Vector3 &BiasTR,
+                                     double NoiseDensityAcc, double NoiseDensityGyro,
+                                     double RandomWalkAcc, double RandomWalkGyro,
+                                     std::vector<PreintegratedIMUResult> &Results,
+                                     int ThreadNumber = 0);
+
+      /** true if the first-order bias correction of the factor is not accurate enough anymore */
+      static bool NeedsReintegration(const PreintegratedIMUResult &Preintegration,
+                                     const Vector3 &BiasAcc, const Vector3 &BiasTR,
+                                     double Threshold);
+
     private:
       void initialize_();
-      void integrateSingleMeasurement_(int Index, double Timestamp);
+      void integrateSingleMeasurement_(size_t Index, double Timestamp);
       void integrateFull_(double Timestamp);
 
       /** measurements */
-      std::vector<libRSF::Data> Measurements_;
+      IMUSampleBuffer Measurements_;
 
       /** time stamp that marks the end of the integration */
       double CurrentTime_;
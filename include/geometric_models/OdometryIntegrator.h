@@ -53,6 +53,9 @@ namespace libRSF
                           double DeltaTime);
       void addMeasurement(const Data &Odom, double DeltaTime);
 
+      /** integrate a sequence of measurements from StartTime to EndTime, the last one is held until the end */
+      void addMeasurements(const std::vector<Data> &Odom, double StartTime, double EndTime);
+
       /** get results */
       void getPose(Vector3 &Translation, Quaternion &Rotation) const;
       void getCov(Matrix33 &TranslationCov, Matrix44 &RotationCov) const;
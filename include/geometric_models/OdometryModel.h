@@ -166,14 +166,29 @@ namespace libRSF
                                        VectorT<T, 3> &Velocity,
                                        VectorT<T, 3> &TurnRate,
                                        const double DeltaTime)
+      {
+        /** rotation from ECEF frame to a local frame */
+        const QuaternionT<T> LocalFrame = QuaternionT<T>::FromTwoVectors(VectorT<T,3>::UnitZ(), VectorRefConst<T,3>(Point1Ptr));
+
+        applyBackward(Point1Ptr, Yaw1Ptr, Point2Ptr, Yaw2Ptr, LocalFrame, Velocity, TurnRate, DeltaTime);
+      }
+
+      /** same with a given rotation from ECEF to the local frame at the first point */
+      void static inline applyBackward(const T* Point1Ptr,
+                                       const T* Yaw1Ptr,
+                                       const T* Point2Ptr,
+                                       const T* Yaw2Ptr,
+                                       const QuaternionT<T> &LocalFrame,
+                                       VectorT<T, 3> &Velocity,
+                                       VectorT<T, 3> &TurnRate,
+                                       const double DeltaTime)
       {
         /** wrap as eigen types */
         VectorRefConst<T,3> Point1(Point1Ptr);
         VectorRefConst<T,3> Point2(Point2Ptr);
 
-        /** rotation from ECEF frame to a local frame and add yaw */
-        const VectorT<T, 3> ZAxis = VectorT<T,3>::UnitZ();
-        const QuaternionT<T> QuatWorldToBodyToOdom = QuaternionT<T>::FromTwoVectors(ZAxis, Point1) * AngleAxisT<T>(*Yaw1Ptr, VectorT<T,3>::UnitZ());
+        /** add yaw to the local frame */
+        const QuaternionT<T> QuatWorldToBodyToOdom = LocalFrame * AngleAxisT<T>(*Yaw1Ptr, VectorT<T,3>::UnitZ());
 
         /** estimate translation */
         Velocity =  QuatWorldToBodyToOdom.conjugate() * (Point2 - Point1) / DeltaTime;
@@ -34,14 +34,48 @@
 
 /** most important functions */
 #include "FactorGraph.h"
+#include "AsyncSolver.h"
+#include "BackgroundSmoother.h"
+#include "AsyncPreintegrator.h"
+#include "FixedLagSmoother.h"
+#include "KeyframePolicy.h"
+#include "WindowController.h"
+#include "SegmentedBatch.h"
+#include "AdaptiveSolve.h"
+#include "TrackingRepulsion.h"
+#include "TrackingAssociation.h"
+#include "TrackManager.h"
+#include "LandmarkManager.h"
+#include "FusionPipeline.h"
+#include "BSplineTrajectory.h"
+#include "PositionIndex.h"
+#include "RecursiveFilter.h"
 #include "FactorGraphConfig.h"
 #include "FileAccess.h"
+#include "ResultSink.h"
 #include "Misc.h"
 #include "StateDataSet.h"
 #include "SensorDataSet.h"
+#include "SensorDataSource.h"
+#include "SharedMemorySource.h"
+#include "ReorderBuffer.h"
+#include "StatePublisher.h"
 #include "GNSS.h"
+#include "SatelliteStore.h"
+#include "SharedObjects.h"
 #include "Resampling.h"
 #include "TimeMeasurement.h"
+#include "Tracing.h"
+#include "Metrics.h"
+#include "Evaluation.h"
+#include "BackendSelection.h"
+#include "AllocationTracking.h"
+#include "RealTime.h"
+#include "Checkpoint.h"
+#include "GraphTrace.h"
+#include "DenseGPU.h"
+#include "DenseSolver.h"
+#include "ThreadPool.h"
 #include "geometric_models/OdometryIntegrator.h"
 #include "geometric_models/IMUPreintegrator.h"
 #include "Statistics.h"
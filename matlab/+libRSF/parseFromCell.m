@@ -254,6 +254,9 @@ for n = 1:size(ResultCell,1)
                 ResultStruct.SolverSummary.DurationAdaptive = [];
                 ResultStruct.SolverSummary.IterationSolver = [];
                 ResultStruct.SolverSummary.IterationAdaptive = [];
+                ResultStruct.SolverSummary.DeadlineMisses = [];
+                ResultStruct.SolverSummary.Memory = [];
+                ResultStruct.SolverSummary.Allocations = [];
             end
             ResultStruct.SolverSummary.Time(end+1,1) = cell2mat(ResultCell(n,2));
             ResultStruct.SolverSummary.DurationTotal(end+1,1) = cell2mat(ResultCell(n,3));
@@ -263,6 +266,15 @@ for n = 1:size(ResultCell,1)
             ResultStruct.SolverSummary.DurationAdaptive(end+1,1) = cell2mat(ResultCell(n,7));
             ResultStruct.SolverSummary.IterationSolver(end+1,1) = cell2mat(ResultCell(n,8));
             ResultStruct.SolverSummary.IterationAdaptive(end+1,1) = cell2mat(ResultCell(n,9));
+            if size(ResultCell,2) >= 10 && ~isempty(ResultCell{n,10})
+                ResultStruct.SolverSummary.DeadlineMisses(end+1,1) = cell2mat(ResultCell(n,10));
+            end
+            if size(ResultCell,2) >= 14 && ~isempty(ResultCell{n,14})
+                ResultStruct.SolverSummary.Memory(end+1,:) = cell2mat(ResultCell(n,11:14));
+            end
+            if size(ResultCell,2) >= 18 && ~isempty(ResultCell{n,18})
+                ResultStruct.SolverSummary.Allocations(end+1,:) = cell2mat(ResultCell(n,15:18));
+            end
 
         case 'cov2'
             if ~isfield(ResultStruct,'Covariance2')
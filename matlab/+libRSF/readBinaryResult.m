@@ -0,0 +1,42 @@
+function [ResultStruct] = readBinaryResult(FileName)
+%READBINARYRESULT map a binary result file (see WriteResultToBinaryFile) without parsing
+%   Each state name becomes a field with its type name and a memmapfile,
+%   whose Values are [values x objects], so column n is the n-th object
+%   and the first row holds the timestamps.
+ResultStruct = struct;
+
+File = fopen(FileName, 'r');
+if File < 0
+    error('Could not open file: %s', FileName);
+end
+Cleanup = onCleanup(@() fclose(File));
+
+Magic = fread(File, 4, '*char')';
+Version = fread(File, 1, 'uint32');
+if ~strcmp(Magic, 'RSFR') || Version ~= 1
+    error('Invalid header of binary result file: %s', FileName);
+end
+BlockNumber = fread(File, 1, 'uint32');
+fread(File, 1, 'uint32');
+
+for n = 1:BlockNumber
+    NameLength = fread(File, 1, 'uint32');
+    TypeLength = fread(File, 1, 'uint32');
+    ValueNumber = fread(File, 1, 'uint32');
+    fread(File, 1, 'uint32');
+    ObjectNumber = fread(File, 1, 'uint64');
+    Name = fread(File, NameLength, '*char')';
+    Type = fread(File, TypeLength, '*char')';
+
+    % names are padded to 8 bytes, so the values are aligned
+    Offset = ftell(File) + mod(8 - mod(NameLength + TypeLength, 8), 8);
+
+    Field = matlab.lang.makeValidName(Name);
+    ResultStruct.(Field).Type = Type;
+    ResultStruct.(Field).Map = memmapfile(FileName, 'Offset', Offset, ...
+                                          'Format', {'double', [ValueNumber ObjectNumber], 'Values'}, ...
+                                          'Repeat', 1);
+
+    fseek(File, Offset + 8 * ValueNumber * ObjectNumber, 'bof');
+end
+end
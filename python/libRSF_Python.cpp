@@ -0,0 +1,336 @@
+/***************************************************************************
+ * libRSF - A Robust Sensor Fusion Library
+ *
+ * Copyright (C) 2019 Chair of Automation Technology / TU Chemnitz
+ * For more information see https://www.tu-chemnitz.de/etit/proaut/libRSF
+ *
+ * libRSF is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libRSF is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with libRSF.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Tim Pfeifer (tim.pfeifer@etit.tu-chemnitz.de)
+ ***************************************************************************/
+
+/**
+ * @file libRSF_Python.cpp
+ * @author Tim Pfeifer
+ * @date 14.10.2026
+ * @brief Python bindings of the factor graph, the data sets and the Gaussian mixtures.
+ * @copyright GNU Public License.
+ *
+ * Means, covariances and error matrices are returned as NumPy views without a copy.
+ * Views into a data set stay valid as long as no element is added to or removed from the affected stream.
+ *
+ */
+
+#include <pybind11/pybind11.h>
+#include <pybind11/numpy.h>
+#include <pybind11/stl.h>
+
+#include <cmath>
+
+#include "libRSF.h"
+
+namespace py = pybind11;
+
+namespace libRSF
+{
+  using ArrayType = py::array_t<double, py::array::c_style | py::array::forcecast>;
+
+  DataType GetDataType(const std::string &Name)
+  {
+    if (!GlobalDataConfig.checkName(Name))
+    {
+      throw py::value_error("Unknown data type: " + Name);
+    }
+    return GlobalDataConfig.getType(Name);
+  }
+
+  /** view of one element of a stored object, Base keeps the owning data set alive */
+  py::array GetElementView(Data &Object, const DataElement Element, const py::handle Base)
+  {
+    if (!Object.checkElement(Element))
+    {
+      throw py::key_error("Element not present in " + Object.getName());
+    }
+    const Index Size = Object.getValue(Element).size();
+    return py::array_t<double>({Size}, {sizeof(double)}, Object.getDataPointer(Element), Base);
+  }
+
+  /** covariances are stored as column-major square matrices */
+  py::array GetMatrixView(Data &Object, const DataElement Element, const py::handle Base)
+  {
+    if (!Object.checkElement(Element))
+    {
+      throw py::key_error("Element not present in " + Object.getName());
+    }
+    const auto Dim = static_cast<Index>(std::lround(std::sqrt(Object.getValue(Element).size())));
+    return py::array_t<double>({Dim, Dim},
+                               {static_cast<Index>(sizeof(double)), static_cast<Index>(Dim * sizeof(double))},
+                               Object.getDataPointer(Element), Base);
+  }
+
+  /** hand an Eigen matrix over to NumPy without copying its buffer */
+  py::array MoveToArray(Matrix &&Source)
+  {
+    auto* Owner = new Matrix(std::move(Source));
+    py::capsule Free(Owner, [](void *Pointer) { delete static_cast<Matrix*>(Pointer); });
+    return py::array_t<double>({Owner->rows(), Owner->cols()},
+                               {static_cast<Index>(sizeof(double)), static_cast<Index>(Owner->rows() * sizeof(double))},
+                               Owner->data(), Free);
+  }
+
+  /** rows follow the raw layout of the data type, as in binary files */
+  void AddArray(SensorDataSet &Set, const std::string &TypeName, const ArrayType &Rows)
+  {
+    const DataType Type = GetDataType(TypeName);
+    if (Rows.ndim() != 2 || Rows.shape(1) != GlobalDataConfig.getLayout(Type).TotalSize)
+    {
+      throw py::value_error("Expected an array with " + std::to_string(GlobalDataConfig.getLayout(Type).TotalSize) + " columns for " + TypeName);
+    }
+
+    const auto Values = Rows.unchecked<2>();
+    for (py::ssize_t n = 0; n < Rows.shape(0); n++)
+    {
+      Set.addElement(Data(Type, Values.data(n, 0), Rows.shape(1)));
+    }
+  }
+
+  template <typename SetType, typename KeyType>
+  py::array GetArray(SetType &Set, const KeyType &Key)
+  {
+    std::vector<double> Times;
+    if (!Set.getTimesOfID(Key, Times))
+    {
+      return py::array_t<double>(std::vector<py::ssize_t>{0, 0});
+    }
+
+    std::vector<const Data*> Objects;
+    for (const double Time : Times)
+    {
+      const int Count = Set.countElement(Key, Time);
+      for (int Number = 0; Number < Count; Number++)
+      {
+        Objects.push_back(&Set.getElement(Key, Time, Number));
+      }
+    }
+
+    const auto Cols = static_cast<py::ssize_t>(Objects.front()->getBuffer().size());
+    py::array_t<double> Array({static_cast<py::ssize_t>(Objects.size()), Cols});
+    auto Values = Array.mutable_unchecked<2>();
+    for (size_t n = 0; n < Objects.size(); n++)
+    {
+      std::copy(Objects[n]->getBuffer().begin(), Objects[n]->getBuffer().end(), Values.mutable_data(static_cast<py::ssize_t>(n), 0));
+    }
+    return Array;
+  }
+
+  /** dispatch the precompiled factor instances with a diagonal Gaussian noise model */
+  void AddFactor(FactorGraph &Graph, const std::string &TypeName, const StateList &States,
+                 const Data &Measurement, const ArrayType &StdDev)
+  {
+    const auto It = FactorTypeDict.find(TypeName);
+    if (It == FactorTypeDict.end())
+    {
+      throw py::value_error("Unknown factor type: " + TypeName);
+    }
+    const FactorType CurrentType = It->second;
+    const Vector StdDevVector = Eigen::Map<const Vector>(StdDev.data(), StdDev.size());
+
+#define LIBRSF_PYTHON_FACTOR(Type, ErrorModelType) \
+    if (CurrentType == FactorType::Type && StdDevVector.size() == ErrorModelType::InputDim) \
+    { \
+      ErrorModelType NoiseModel; \
+      NoiseModel.setStdDevDiagonal(StdDevVector); \
+      Graph.addFactor<FactorType::Type>(States, Measurement, NoiseModel); \
+      return; \
+    }
+
+    LIBRSF_FACTOR_INSTANCES(LIBRSF_PYTHON_FACTOR)
+
+#undef LIBRSF_PYTHON_FACTOR
+
+    throw py::value_error("No diagonal Gaussian instance of " + TypeName + " with " + std::to_string(StdDevVector.size()) + " dimensions");
+  }
+
+  template <int Dim>
+  void BindGaussianMixture(py::module_ &Module, const char *Name)
+  {
+    using MixtureType = GaussianMixture<Dim>;
+    using ConfigType = typename MixtureType::EstimationConfig;
+
+    py::class_<MixtureType>(Module, Name)
+      .def(py::init<>())
+      .def("init_spread", &MixtureType::initSpread, py::arg("number_of_components"), py::arg("base_std_dev"), py::arg("is_asymmetric") = false)
+      .def("estimate", [](MixtureType &Mixture, const ArrayType &Samples, const std::string &Algorithm, const int MaxIterations)
+      {
+        /** samples are columns, a C-contiguous (N, Dim) array has exactly this layout */
+        if (Samples.ndim() != 2 || Samples.shape(1) != Dim)
+        {
+          throw py::value_error("Expected an array with " + std::to_string(Dim) + " columns");
+        }
+        ConfigType Config;
+        Config.EstimationAlgorithm = ErrorModelTuningTypeDict.at(Algorithm);
+        Config.MaxIterations = MaxIterations;
+        const MatrixStatic<Dim, Dynamic> DataMatrix = Eigen::Map<const MatrixStatic<Dim, Dynamic>>(Samples.data(), Dim, Samples.shape(0));
+        return Mixture.estimate(DataMatrix, Config);
+      }, py::arg("samples"), py::arg("algorithm") = "EM", py::arg("max_iterations") = 100)
+      .def("number_of_components", &MixtureType::getNumberOfComponents)
+      .def("means", [](MixtureType &Mixture)
+      {
+        std::vector<GaussianComponent<Dim>> Components;
+        Mixture.getMixture(Components);
+        Matrix Means(Components.size(), Dim);
+        for (size_t n = 0; n < Components.size(); n++)
+        {
+          Means.row(static_cast<Index>(n)) = Components[n].getMean().transpose();
+        }
+        return MoveToArray(std::move(Means));
+      })
+      .def("weights", [](MixtureType &Mixture)
+      {
+        std::vector<GaussianComponent<Dim>> Components;
+        Mixture.getMixture(Components);
+        Matrix Weights(Components.size(), 1);
+        for (size_t n = 0; n < Components.size(); n++)
+        {
+          Weights(static_cast<Index>(n)) = Components[n].getWeight()(0);
+        }
+        return MoveToArray(std::move(Weights));
+      })
+      .def("covariances", [](MixtureType &Mixture)
+      {
+        std::vector<GaussianComponent<Dim>> Components;
+        Mixture.getMixture(Components);
+        std::vector<Matrix> Covariances;
+        for (const auto &Component : Components)
+        {
+          Covariances.emplace_back(Component.getCovariance());
+        }
+        py::list List;
+        for (auto &Cov : Covariances)
+        {
+          List.append(MoveToArray(std::move(Cov)));
+        }
+        return List;
+      });
+  }
+}
+
+PYBIND11_MODULE(pylibRSF, Module)
+{
+  using namespace libRSF;
+
+  Module.doc() = "Python bindings of the libRSF";
+
+  py::class_<StateKey>(Module, "StateKey")
+    .def(py::init<const std::string &>())
+    .def("name", &StateKey::getName)
+    .def("__repr__", [](const StateKey &Key) { return Key.getName(); });
+  py::implicitly_convertible<std::string, StateKey>();
+
+  py::class_<StateList>(Module, "StateList")
+    .def(py::init<>())
+    .def("add", [](StateList &List, const StateKey &Name, const double Timestamp, const int Number)
+    {
+      List.add(Name, Timestamp, Number);
+    }, py::arg("name"), py::arg("timestamp"), py::arg("number") = 0)
+    .def("clear", &StateList::clear);
+
+  py::class_<Data>(Module, "Data")
+    .def(py::init([](const std::string &TypeName, const double Timestamp)
+    {
+      return Data(GetDataType(TypeName), Timestamp);
+    }), py::arg("type"), py::arg("timestamp"))
+    .def(py::init([](const std::string &TypeName, const ArrayType &Values)
+    {
+      const DataType Type = GetDataType(TypeName);
+      if (Values.size() != GlobalDataConfig.getLayout(Type).TotalSize)
+      {
+        throw py::value_error("Wrong number of values for " + TypeName);
+      }
+      return Data(Type, Values.data(), Values.size());
+    }), py::arg("type"), py::arg("values"))
+    .def("name", &Data::getName)
+    .def("timestamp", &Data::getTimestamp)
+    .def("mean", [](py::object Self) { return GetElementView(Self.cast<Data&>(), DataElement::Mean, Self); })
+    .def("covariance", [](py::object Self) { return GetMatrixView(Self.cast<Data&>(), DataElement::Covariance, Self); })
+    .def("set_mean", [](Data &Object, const ArrayType &Mean) { Object.setMean(Eigen::Map<const Vector>(Mean.data(), Mean.size())); })
+    .def("__repr__", &Data::getNameValueString);
+
+  py::class_<SensorDataSet>(Module, "SensorDataSet")
+    .def(py::init<>())
+    .def("add", static_cast<void (SensorDataSet::*)(const Data &)>(&SensorDataSet::addElement))
+    .def("add_array", &AddArray, py::arg("type"), py::arg("rows"),
+         "Add one measurement per row, the columns follow the raw layout of the type.")
+    .def("get_array", [](SensorDataSet &Set, const std::string &TypeName) { return GetArray(Set, GetDataType(TypeName)); },
+         "Copy of all measurements of one type, one raw buffer per row.")
+    .def("count", [](const SensorDataSet &Set, const std::string &TypeName) { return Set.countElements(GetDataType(TypeName)); })
+    .def("time_first", [](const SensorDataSet &Set) { double Time = 0; Set.getTimeFirstOverall(Time); return Time; });
+
+  py::class_<StateDataSet>(Module, "StateDataSet")
+    .def(py::init<>())
+    .def("timestamps", [](const StateDataSet &Set, const StateKey &Name)
+    {
+      std::vector<double> Times;
+      Set.getTimesOfID(Name, Times);
+      return Times;
+    })
+    .def("mean", [](py::object Self, const StateKey &Name, const double Timestamp, const int Number)
+    {
+      auto &Set = Self.cast<StateDataSet&>();
+      if (!Set.checkElement(Name, Timestamp, Number))
+      {
+        throw py::key_error("No state " + Name.getName() + " at " + std::to_string(Timestamp));
+      }
+      return GetElementView(Set.getElement(Name, Timestamp, Number), DataElement::Mean, Self);
+    }, py::arg("name"), py::arg("timestamp"), py::arg("number") = 0,
+       "View of the mean, writing into it moves the parameter block of the graph.")
+    .def("covariance", [](py::object Self, const StateKey &Name, const double Timestamp, const int Number)
+    {
+      auto &Set = Self.cast<StateDataSet&>();
+      if (!Set.checkElement(Name, Timestamp, Number))
+      {
+        throw py::key_error("No state " + Name.getName() + " at " + std::to_string(Timestamp));
+      }
+      return GetMatrixView(Set.getElement(Name, Timestamp, Number), DataElement::Covariance, Self);
+    }, py::arg("name"), py::arg("timestamp"), py::arg("number") = 0)
+    .def("get_array", [](StateDataSet &Set, const StateKey &Name) { return GetArray(Set, Name); },
+         "Copy of all states of one name, one raw buffer per row.");
+
+  py::class_<FactorGraph>(Module, "FactorGraph")
+    .def(py::init<>())
+    .def("add_state", [](FactorGraph &Graph, const StateKey &Name, const std::string &TypeName, const double Timestamp)
+    {
+      Graph.addState(Name, GetDataType(TypeName), Timestamp);
+    }, py::arg("name"), py::arg("type"), py::arg("timestamp"))
+    .def("add_factor", &AddFactor, py::arg("type"), py::arg("states"), py::arg("measurement"), py::arg("std_dev"),
+         "Add a factor with diagonal Gaussian noise, the combinations of LIBRSF_FACTOR_INSTANCES are available.")
+    .def("set_constant", &FactorGraph::setConstant, py::arg("name"), py::arg("timestamp"))
+    .def("solve", static_cast<void (FactorGraph::*)()>(&FactorGraph::solve), py::call_guard<py::gil_scoped_release>())
+    .def("compute_covariance", [](FactorGraph &Graph, const StateKey &Name) { return Graph.computeCovariance(Name); })
+    .def("state_data", &FactorGraph::getStateData, py::return_value_policy::reference_internal)
+    .def("unweighted_error_matrix", [](FactorGraph &Graph, const std::string &TypeName)
+    {
+      const auto It = FactorTypeDict.find(TypeName);
+      if (It == FactorTypeDict.end())
+      {
+        throw py::value_error("Unknown factor type: " + TypeName);
+      }
+      Matrix ErrorMatrix;
+      Graph.computeUnweightedErrorMatrix(It->second, ErrorMatrix);
+      return MoveToArray(std::move(ErrorMatrix));
+    }, "Errors of all factors of one type, one column per factor.");
+
+  BindGaussianMixture<1>(Module, "GaussianMixture1");
+  BindGaussianMixture<2>(Module, "GaussianMixture2");
+}
@@ -0,0 +1,96 @@
+/***************************************************************************
+ * libRSF - A Robust Sensor Fusion Library
+ *
+ * Copyright (C) 2018 Chair of Automation Technology / TU Chemnitz
+ * For more information see https://www.tu-chemnitz.de/etit/proaut/libRSF
+ *
+ * libRSF is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libRSF is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with libRSF.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Tim Pfeifer (tim.pfeifer@etit.tu-chemnitz.de)
+ ***************************************************************************/
+
+#include "AdaptiveSolve.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace libRSF
+{
+  /** a solve with at most this many successful steps did not move the solution */
+  static constexpr int ConvergedSteps = 2;
+
+  int SolveAdaptive(FactorGraph &Graph,
+                    const ceres::Solver::Options &Options,
+                    const int Rounds,
+                    const double RelaxedTolerance,
+                    const int RelaxedIterations,
+                    const std::function<bool()> &Adapt)
+  {
+    const bool RelaxTolerance = RelaxedTolerance > Options.function_tolerance;
+    const bool RelaxIterations = RelaxedIterations > 0 && RelaxedIterations < Options.max_num_iterations;
+
+    int Round = 0;
+    bool ForceFull = false;
+    bool IsFull = false;
+    bool IsConverged = false;
+    while (Round < Rounds && !IsConverged)
+    {
+      /** 0 for the first and 1 for the last round */
+      const double Progress = (ForceFull || Rounds <= 1) ? 1.0 : static_cast<double>(Round) / (Rounds - 1);
+      IsFull = (Progress >= 1.0) || (!RelaxTolerance && !RelaxIterations);
+
+      ceres::Solver::Options RoundOptions = Options;
+      if (!IsFull && RelaxTolerance)
+      {
+        RoundOptions.function_tolerance = RelaxedTolerance * std::pow(Options.function_tolerance / RelaxedTolerance, Progress);
+      }
+      if (!IsFull && RelaxIterations)
+      {
+        RoundOptions.max_num_iterations = RelaxedIterations
+                                          + static_cast<int>(std::round(Progress * (Options.max_num_iterations - RelaxedIterations)));
+      }
+
+      Adapt();
+      Graph.solve(RoundOptions);
+      Round++;
+
+      /** a relaxed round can stop early, so only a full one ends the loop */
+      if (Graph.getSolverSummary().num_successful_steps <= ConvergedSteps)
+      {
+        IsConverged = IsFull;
+        ForceFull = true;
+      }
+    }
+
+    /** the round limit was reached with relaxed options */
+    if (!IsFull && Round > 0)
+    {
+      Graph.solve(Options);
+    }
+
+    return Round;
+  }
+
+  int SolveAdaptive(FactorGraph &Graph,
+                    const FactorGraphConfig &Config,
+                    const std::function<bool()> &Adapt)
+  {
+    return SolveAdaptive(Graph,
+                         Config.SolverConfig,
+                         Config.Solution.AdaptionRounds,
+                         Config.Solution.AdaptionTolerance,
+                         Config.Solution.AdaptionIterations,
+                         Adapt);
+  }
+}
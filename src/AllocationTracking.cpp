@@ -0,0 +1,236 @@
+/***************************************************************************
+ * libRSF - A Robust Sensor Fusion Library
+ *
+ * Copyright (C) 2019 Chair of Automation Technology / TU Chemnitz
+ * For more information see https://www.tu-chemnitz.de/etit/proaut/libRSF
+ *
+ * libRSF is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libRSF is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with libRSF.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Tim Pfeifer (tim.pfeifer@etit.tu-chemnitz.de)
+ ***************************************************************************/
+
+#include "AllocationTracking.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace libRSF
+{
+#ifdef LIBRSF_ALLOCATION_TRACKING
+  namespace
+  {
+    /** constant initialized, so it is valid before any static constructor allocates */
+    std::atomic<std::uint64_t> AllocationCounter {0};
+
+    void* Allocate(const std::size_t Size)
+    {
+      AllocationCounter.fetch_add(1, std::memory_order_relaxed);
+      void* Pointer = std::malloc(Size == 0 ? 1 : Size);
+      while (Pointer == nullptr)
+      {
+        const std::new_handler Handler = std::get_new_handler();
+        if (Handler == nullptr)
+        {
+          throw std::bad_alloc();
+        }
+        Handler();
+        Pointer = std::malloc(Size == 0 ? 1 : Size);
+      }
+      return Pointer;
+    }
+
+    void* AllocateAligned(const std::size_t Size, const std::align_val_t Alignment)
+    {
+      AllocationCounter.fetch_add(1, std::memory_order_relaxed);
+      const std::size_t Align = static_cast<std::size_t>(Alignment);
+
+      /** aligned_alloc requires a multiple of the alignment */
+      const std::size_t Padded = ((Size == 0 ? 1 : Size) + Align - 1) / Align * Align;
+      void* Pointer = std::aligned_alloc(Align, Padded);
+      while (Pointer == nullptr)
+      {
+        const std::new_handler Handler = std::get_new_handler();
+        if (Handler == nullptr)
+        {
+          throw std::bad_alloc();
+        }
+        Handler();
+        Pointer = std::aligned_alloc(Align, Padded);
+      }
+      return Pointer;
+    }
+  }
+
+  bool IsAllocationTrackingEnabled()
+  {
+    return true;
+  }
+
+  std::uint64_t GetAllocationCount()
+  {
+    return AllocationCounter.load(std::memory_order_relaxed);
+  }
+#else
+  bool IsAllocationTrackingEnabled()
+  {
+    return false;
+  }
+
+  std::uint64_t GetAllocationCount()
+  {
+    return 0;
+  }
+#endif // LIBRSF_ALLOCATION_TRACKING
+
+  AllocationScope::AllocationScope() : Begin_(GetAllocationCount())
+  {}
+
+  std::uint64_t AllocationScope::getCount() const
+  {
+    return GetAllocationCount() - Begin_;
+  }
+}
+
+#ifdef LIBRSF_ALLOCATION_TRACKING
+/** replacements of the global allocation functions, the linker picks them instead of the ones of the standard library */
+void* operator new(std::size_t Size)
+{
+  return libRSF::Allocate(Size);
+}
+
+void* operator new[](std::size_t Size)
+{
+  return libRSF::Allocate(Size);
+}
+
+void* operator new(std::size_t Size, const std::nothrow_t&) noexcept
+{
+  try
+  {
+    return libRSF::Allocate(Size);
+  }
+  catch (...)
+  {
+    return nullptr;
+  }
+}
+
+void* operator new[](std::size_t Size, const std::nothrow_t&) noexcept
+{
+  try
+  {
+    return libRSF::Allocate(Size);
+  }
+  catch (...)
+  {
+    return nullptr;
+  }
+}
+
+void* operator new(std::size_t Size, std::align_val_t Alignment)
+{
+  return libRSF::AllocateAligned(Size, Alignment);
+}
+
+void* operator new[](std::size_t Size, std::align_val_t Alignment)
+{
+  return libRSF::AllocateAligned(Size, Alignment);
+}
+
+void* operator new(std::size_t Size, std::align_val_t Alignment, const std::nothrow_t&) noexcept
+{
+  try
+  {
+    return libRSF::AllocateAligned(Size, Alignment);
+  }
+  catch (...)
+  {
+    return nullptr;
+  }
+}
+
+void* operator new[](std::size_t Size, std::align_val_t Alignment, const std::nothrow_t&) noexcept
+{
+  try
+  {
+    return libRSF::AllocateAligned(Size, Alignment);
+  }
+  catch (...)
+  {
+    return nullptr;
+  }
+}
+
+/** all variants end in free, since aligned_alloc memory is released with it as well */
+void operator delete(void* Pointer) noexcept
+{
+  std::free(Pointer);
+}
+
+void operator delete[](void* Pointer) noexcept
+{
+  std::free(Pointer);
+}
+
+void operator delete(void* Pointer, std::size_t) noexcept
+{
+  std::free(Pointer);
+}
+
+void operator delete[](void* Pointer, std::size_t) noexcept
+{
+  std::free(Pointer);
+}
+
+void operator delete(void* Pointer, const std::nothrow_t&) noexcept
+{
+  std::free(Pointer);
+}
+
+void operator delete[](void* Pointer, const std::nothrow_t&) noexcept
+{
+  std::free(Pointer);
+}
+
+void operator delete(void* Pointer, std::align_val_t) noexcept
+{
+  std::free(Pointer);
+}
+
+void operator delete[](void* Pointer, std::align_val_t) noexcept
+{
+  std::free(Pointer);
+}
+
+void operator delete(void* Pointer, std::size_t, std::align_val_t) noexcept
+{
+  std::free(Pointer);
+}
+
+void operator delete[](void* Pointer, std::size_t, std::align_val_t) noexcept
+{
+  std::free(Pointer);
+}
+
+void operator delete(void* Pointer, std::align_val_t, const std::nothrow_t&) noexcept
+{
+  std::free(Pointer);
+}
+
+void operator delete[](void* Pointer, std::align_val_t, const std::nothrow_t&) noexcept
+{
+  std::free(Pointer);
+}
+#endif // LIBRSF_ALLOCATION_TRACKING
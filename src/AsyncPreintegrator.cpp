@@ -0,0 +1,277 @@
+/***************************************************************************
+ * libRSF - A Robust Sensor Fusion Library
+ *
+ * Copyright (C) 2018 Chair of Automation Technology / TU Chemnitz
+ * For more information see https://www.tu-chemnitz.de/etit/proaut/libRSF
+ *
+ * libRSF is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libRSF is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with libRSF.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Tim Pfeifer (tim.pfeifer@etit.tu-chemnitz.de)
+ ***************************************************************************/
+
+#include "AsyncPreintegrator.h"
+#include "RealTime.h"
+
+#include <chrono>
+
+namespace libRSF
+{
+  /** finished intervals are fetched by the graph thread at each keyframe, so only a few have to be buffered */
+  static constexpr size_t ResultQueueCapacity = 64;
+
+  AsyncPreintegrator::AsyncPreintegrator(const Vector3 &BiasAcc, const Vector3 &BiasTR,
+                                         const double NoiseDensityAcc, const double NoiseDensityGyro,
+                                         const double RandomWalkAcc, const double RandomWalkGyro,
+                                         const double StartTime,
+                                         const double RelinearizationThreshold,
+                                         const size_t QueueCapacity) :
+      NoiseDensityAcc_(NoiseDensityAcc),
+      NoiseDensityGyro_(NoiseDensityGyro),
+      RandomWalkAcc_(RandomWalkAcc),
+      RandomWalkGyro_(RandomWalkGyro),
+      RelinearizationThreshold_(RelinearizationThreshold),
+      BiasAcc_(BiasAcc),
+      BiasTR_(BiasTR),
+      IntervalStart_(StartTime),
+      Samples_(QueueCapacity),
+      Results_(ResultQueueCapacity)
+  {
+    Preintegrator_ = std::make_unique<IMUPreintegrator>(BiasAcc_, BiasTR_,
+                                                        NoiseDensityAcc_, NoiseDensityGyro_,
+                                                        RandomWalkAcc_, RandomWalkGyro_,
+                                                        IntervalStart_);
+    Worker_ = std::thread(&AsyncPreintegrator::process_, this);
+  }
+
+  AsyncPreintegrator::~AsyncPreintegrator()
+  {
+    this->finish();
+  }
+
+  bool AsyncPreintegrator::addMeasurement(const Data &IMUMeasurement)
+  {
+    const VectorRefConst<double, Dynamic> Mean = IMUMeasurement.getValue(DataElement::Mean);
+
+    Vector6 CovDiagonal;
+    if (IMUMeasurement.checkElement(DataElement::CovarianceDiagonal))
+    {
+      CovDiagonal = IMUMeasurement.getValue(DataElement::CovarianceDiagonal);
+    }
+    else
+    {
+      CovDiagonal = IMUMeasurement.getCovarianceDiagonal();
+    }
+
+    return this->addMeasurement(IMUMeasurement.getTimestamp(),
+                                Mean.head<3>(), Mean.tail<3>(),
+                                CovDiagonal.head<3>(), CovDiagonal.tail<3>());
+  }
+
+  bool AsyncPreintegrator::addMeasurement(const double Timestamp,
+                                          const Vector3 &Acceleration, const Vector3 &TurnRate,
+                                          const Vector3 &AccelerationCov, const Vector3 &TurnRateCov)
+  {
+    Event Object;
+    Object.Timestamp = Timestamp;
+    Object.Acceleration = Acceleration;
+    Object.TurnRate = TurnRate;
+    Object.AccelerationCov = AccelerationCov;
+    Object.TurnRateCov = TurnRateCov;
+
+    if (!Samples_.push(std::move(Object)))
+    {
+      return false;
+    }
+    Condition_.notify_one();
+    return true;
+  }
+
+  void AsyncPreintegrator::closeInterval(const double Timestamp)
+  {
+    Event Object;
+    Object.Timestamp = Timestamp;
+    Object.IsBoundary = true;
+
+    /** a failed push leaves the object untouched */
+    while (!Samples_.push(std::move(Object)))
+    {
+      Condition_.notify_one();
+      std::this_thread::yield();
+    }
+    Condition_.notify_one();
+  }
+
+  bool AsyncPreintegrator::getResult(PreintegratedIMUResult &Result)
+  {
+    return Results_.pop(Result);
+  }
+
+  bool AsyncPreintegrator::waitForResult(PreintegratedIMUResult &Result)
+  {
+    while (!Results_.pop(Result))
+    {
+      /** a result that was pushed before the thread stopped is still returned */
+      if (Stopped_)
+      {
+        return Results_.pop(Result);
+      }
+
+      std::unique_lock<std::mutex> Lock(Mutex_);
+      ResultCondition_.wait_for(Lock, std::chrono::milliseconds(1), [this] {return Stopped_ || !Results_.empty();});
+    }
+    return true;
+  }
+
+  void AsyncPreintegrator::updateBias(const Vector3 &BiasAcc, const Vector3 &BiasTR)
+  {
+    {
+      std::lock_guard<std::mutex> Lock(BiasMutex_);
+      NewBiasAcc_ = BiasAcc;
+      NewBiasTR_ = BiasTR;
+    }
+    HasNewBias_.store(true, std::memory_order_release);
+    Condition_.notify_one();
+  }
+
+  void AsyncPreintegrator::finish()
+  {
+    if (Worker_.joinable())
+    {
+      Stop_ = true;
+      Condition_.notify_one();
+      Worker_.join();
+    }
+  }
+
+  int AsyncPreintegrator::countIntervals() const
+  {
+    return Intervals_;
+  }
+
+  void AsyncPreintegrator::applyBias_()
+  {
+    if (!HasNewBias_.exchange(false, std::memory_order_acquire))
+    {
+      return;
+    }
+
+    {
+      std::lock_guard<std::mutex> Lock(BiasMutex_);
+      BiasAcc_ = NewBiasAcc_;
+      BiasTR_ = NewBiasTR_;
+    }
+
+    /** the samples of the open interval are repeated only if the linear correction is not sufficient */
+    Preintegrator_->updateBias(BiasAcc_, BiasTR_, RelinearizationThreshold_);
+  }
+
+  void AsyncPreintegrator::process_()
+  {
+    ApplyRealTimeThread(RealTimeThread::Ingestion);
+
+    Event Object;
+    while (true)
+    {
+      this->applyBias_();
+
+      if (!Samples_.pop(Object))
+      {
+        /** the queue is only left if everything was processed */
+        if (Stop_)
+        {
+          if (Samples_.empty())
+          {
+            break;
+          }
+          continue;
+        }
+
+        /** the producer does not lock, so a notification could be missed and the wait is limited */
+        std::unique_lock<std::mutex> Lock(Mutex_);
+        Condition_.wait_for(Lock, std::chrono::milliseconds(1),
+                            [this] {return Stop_ || HasNewBias_ || !Samples_.empty();});
+        continue;
+      }
+
+      if (Object.IsBoundary)
+      {
+        this->processBoundary_(Object.Timestamp);
+      }
+      else if (Object.Timestamp > IntervalStart_)
+      {
+        Preintegrator_->addMeasurement(Object.Timestamp,
+                                       Object.Acceleration, Object.TurnRate,
+                                       Object.AccelerationCov, Object.TurnRateCov);
+        LastSample_ = Object;
+        HasSample_ = true;
+        IntervalSamples_++;
+      }
+    }
+
+    Stopped_ = true;
+    ResultCondition_.notify_all();
+  }
+
+  void AsyncPreintegrator::processBoundary_(const double Timestamp)
+  {
+    if (Timestamp <= IntervalStart_)
+    {
+      PRINT_WARNING("The IMU interval boundary ", Timestamp, " is not after the start of the interval ", IntervalStart_, ". It is ignored!");
+      return;
+    }
+
+    if (IntervalSamples_ == 0)
+    {
+      if (!HasSample_)
+      {
+        PRINT_WARNING("There is no IMU measurement below ", Timestamp, ". The interval is skipped!");
+        IntervalStart_ = Timestamp;
+        Preintegrator_ = std::make_unique<IMUPreintegrator>(BiasAcc_, BiasTR_,
+                                                            NoiseDensityAcc_, NoiseDensityGyro_,
+                                                            RandomWalkAcc_, RandomWalkGyro_,
+                                                            IntervalStart_);
+        return;
+      }
+
+      /** same fallback as in the synchronous case: the last measurement is extrapolated */
+      Preintegrator_->addMeasurement(Timestamp,
+                                     LastSample_.Acceleration, LastSample_.TurnRate,
+                                     LastSample_.AccelerationCov, LastSample_.TurnRateCov);
+    }
+    else
+    {
+      /** constant extrapolation of the last sample to the boundary */
+      Preintegrator_->integrateToTime(Timestamp);
+    }
+
+    PreintegratedIMUResult Result = Preintegrator_->getPreintegratedState();
+
+    /** hand over, the graph thread is waiting if the queue is full */
+    while (!Results_.push(std::move(Result)))
+    {
+      ResultCondition_.notify_all();
+      std::this_thread::yield();
+    }
+    Intervals_++;
+    ResultCondition_.notify_all();
+
+    /** start the next interval with the newest bias */
+    IntervalStart_ = Timestamp;
+    IntervalSamples_ = 0;
+    Preintegrator_ = std::make_unique<IMUPreintegrator>(BiasAcc_, BiasTR_,
+                                                        NoiseDensityAcc_, NoiseDensityGyro_,
+                                                        RandomWalkAcc_, RandomWalkGyro_,
+                                                        IntervalStart_);
+  }
+}
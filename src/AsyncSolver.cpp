@@ -0,0 +1,163 @@
+/***************************************************************************
+ * libRSF - A Robust Sensor Fusion Library
+ *
+ * Copyright (C) 2018 Chair of Automation Technology / TU Chemnitz
+ * For more information see https://www.tu-chemnitz.de/etit/proaut/libRSF
+ *
+ * libRSF is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libRSF is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with libRSF.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Tim Pfeifer (tim.pfeifer@etit.tu-chemnitz.de)
+ ***************************************************************************/
+
+#include "AsyncSolver.h"
+
+#include <chrono>
+
+namespace libRSF
+{
+  AsyncSolver::AsyncSolver(FactorGraph &Graph, EpochFunction Epoch, ResultFunction Result, const size_t QueueCapacity) :
+      Graph_(Graph), Epoch_(std::move(Epoch)), Result_(std::move(Result)), Queue_(QueueCapacity)
+  {
+    Worker_ = std::thread(&AsyncSolver::process_, this);
+  }
+
+  AsyncSolver::~AsyncSolver()
+  {
+    this->finish();
+  }
+
+  bool AsyncSolver::addMeasurement(const Data &Measurement)
+  {
+    Event Object;
+    Object.Measurement = Measurement;
+    Object.Timestamp = Measurement.getTimestamp();
+
+    if (!Queue_.push(std::move(Object)))
+    {
+      return false;
+    }
+    Condition_.notify_one();
+    return true;
+  }
+
+  void AsyncSolver::addMeasurements(const SensorDataSet &Measurements)
+  {
+    for (const DataType Type : Measurements.getKeysAll())
+    {
+      for (const Data &Measurement : Measurements.getElementsOfID(Type))
+      {
+        Event Object;
+        Object.Measurement = Measurement;
+        Object.Timestamp = Measurement.getTimestamp();
+        this->push_(std::move(Object));
+      }
+    }
+  }
+
+  void AsyncSolver::closeEpoch(const double Timestamp)
+  {
+    Event Object;
+    Object.Timestamp = Timestamp;
+    Object.IsEpoch = true;
+    this->push_(std::move(Object));
+  }
+
+  void AsyncSolver::push_(Event &&Object)
+  {
+    /** a failed push leaves the object untouched */
+    while (!Queue_.push(std::move(Object)))
+    {
+      Condition_.notify_one();
+      std::this_thread::yield();
+    }
+    Condition_.notify_one();
+  }
+
+  void AsyncSolver::finish()
+  {
+    if (Worker_.joinable())
+    {
+      Stop_ = true;
+      Condition_.notify_one();
+      Worker_.join();
+    }
+  }
+
+  int AsyncSolver::countProcessedEpochs() const
+  {
+    return ProcessedEpochs_;
+  }
+
+  void AsyncSolver::process_()
+  {
+    Event Object;
+    while (true)
+    {
+      if (!Queue_.pop(Object))
+      {
+        /** the queue is only left if everything was processed */
+        if (Stop_)
+        {
+          if (Queue_.empty())
+          {
+            break;
+          }
+          continue;
+        }
+
+        /** the producer does not lock, so a notification could be missed and the wait is limited */
+        std::unique_lock<std::mutex> Lock(Mutex_);
+        Condition_.wait_for(Lock, std::chrono::milliseconds(1), [this] {return Stop_ || !Queue_.empty();});
+        continue;
+      }
+
+      if (Object.IsEpoch)
+      {
+        this->processEpoch_(Object.Timestamp);
+      }
+      else
+      {
+        Staged_.addElement(Object.Measurement);
+      }
+    }
+  }
+
+  void AsyncSolver::processEpoch_(const double TimeNow)
+  {
+    /** apply the staged delta */
+    Active_.merge(Staged_);
+    Staged_.clear();
+
+    Epoch_(Graph_, Active_, TimeOld_, TimeNow);
+    if (Result_)
+    {
+      Result_(Graph_, TimeNow);
+    }
+
+    /** keep the last measurement before TimeNow, some sensors fall back to it */
+    for (const DataType Type : Active_.getKeysAll())
+    {
+      double TimeFirst, TimeSecond;
+      while (Active_.getTimeFirst(Type, TimeFirst) &&
+             Active_.getTimeAbove(Type, TimeFirst, TimeSecond) &&
+             TimeSecond <= TimeNow)
+      {
+        Active_.removeElement(Type, TimeFirst);
+      }
+    }
+
+    TimeOld_ = TimeNow;
+    ProcessedEpochs_++;
+  }
+}
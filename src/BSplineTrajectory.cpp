@@ -0,0 +1,150 @@
+/***************************************************************************
+ * libRSF - A Robust Sensor Fusion Library
+ *
+ * Copyright (C) 2018 Chair of Automation Technology / TU Chemnitz
+ * For more information see https://www.tu-chemnitz.de/etit/proaut/libRSF
+ *
+ * libRSF is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libRSF is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with libRSF.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Tim Pfeifer (tim.pfeifer@etit.tu-chemnitz.de)
+ ***************************************************************************/
+
+#include "BSplineTrajectory.h"
+
+#include <cmath>
+
+namespace libRSF
+{
+  BSplineTrajectory::BSplineTrajectory(FactorGraph &Graph,
+                                       const double TimeOrigin,
+                                       const double KnotTime,
+                                       const StateKey &ValueName,
+                                       const DataType ValueType,
+                                       const StateKey &RotationName):
+      Graph_(Graph), TimeOrigin_(TimeOrigin), KnotTime_(KnotTime),
+      ValueName_(ValueName), ValueType_(ValueType), RotationName_(RotationName)
+  {
+    if (KnotTime_ <= 0.0)
+    {
+      PRINT_ERROR("The knot time of a spline has to be positive, but it is ", KnotTime_);
+    }
+  }
+
+  int BSplineTrajectory::getSegment(const double Time) const
+  {
+    return static_cast<int>(std::floor((Time - TimeOrigin_) / KnotTime_));
+  }
+
+  double BSplineTrajectory::getKnotTime(const int Index) const
+  {
+    return TimeOrigin_ + Index * KnotTime_;
+  }
+
+  bool BSplineTrajectory::hasRotation() const
+  {
+    return !RotationName_.getName().empty();
+  }
+
+  void BSplineTrajectory::addControlPoint_(const StateKey &Name, const DataType Type, const int Index)
+  {
+    const double Time = this->getKnotTime(Index);
+    if (Graph_.getStateData().checkElement(Name, Time))
+    {
+      return;
+    }
+
+    Graph_.addState(Name, Type, Time);
+
+    double TimePrev;
+    if (Graph_.getStateData().getTimeBelow(Name, Time, TimePrev))
+    {
+      Graph_.getStateData().getElement(Name, Time, 0).setMean(Graph_.getStateData().getElement(Name, TimePrev, 0).getMean());
+    }
+  }
+
+  StateList BSplineTrajectory::addSegment(const double Time)
+  {
+    const int Segment = this->getSegment(Time);
+
+    StateList States;
+    for (int Index = Segment - 1; Index <= Segment + 2; Index++)
+    {
+      this->addControlPoint_(ValueName_, ValueType_, Index);
+      States.add(ValueName_, this->getKnotTime(Index));
+    }
+    if (this->hasRotation())
+    {
+      for (int Index = Segment - 1; Index <= Segment + 2; Index++)
+      {
+        this->addControlPoint_(RotationName_, DataType::Quaternion, Index);
+        States.add(RotationName_, this->getKnotTime(Index));
+      }
+    }
+    return States;
+  }
+
+  bool BSplineTrajectory::getControlPoints_(const StateKey &Name, const int Segment, std::vector<Vector> &Points) const
+  {
+    const StateDataSet &States = Graph_.getStateData();
+
+    Points.clear();
+    Data ControlPoint;
+    for (int Index = Segment - 1; Index <= Segment + 2; Index++)
+    {
+      if (!States.getElement(Name, this->getKnotTime(Index), 0, ControlPoint))
+      {
+        return false;
+      }
+      Points.push_back(ControlPoint.getMean());
+    }
+    return true;
+  }
+
+  bool BSplineTrajectory::evaluate(const double Time, Vector &Value) const
+  {
+    const int Segment = this->getSegment(Time);
+    std::vector<Vector> Points;
+    if (!this->getControlPoints_(ValueName_, Segment, Points))
+    {
+      return false;
+    }
+
+    const Vector3 Basis = CumulativeBSplineBasis(BSplineSegmentTime(Time, this->getKnotTime(Segment - 1), this->getKnotTime(Segment + 2)));
+    Value = Points.at(0);
+    for (int j = 1; j < 4; j++)
+    {
+      Value += (Points.at(j) - Points.at(j - 1)) * Basis(j - 1);
+    }
+    return true;
+  }
+
+  bool BSplineTrajectory::evaluate(const double Time, Vector &Value, Quaternion &Rotation) const
+  {
+    if (!this->hasRotation() || !this->evaluate(Time, Value))
+    {
+      return false;
+    }
+
+    const int Segment = this->getSegment(Time);
+    std::vector<Vector> Points;
+    if (!this->getControlPoints_(RotationName_, Segment, Points))
+    {
+      return false;
+    }
+
+    const Vector3 Basis = CumulativeBSplineBasis(BSplineSegmentTime(Time, this->getKnotTime(Segment - 1), this->getKnotTime(Segment + 2)));
+    Rotation = BSplineQuaternion<double>(Points.at(0).data(), Points.at(1).data(), Points.at(2).data(), Points.at(3).data(), Basis);
+    return true;
+  }
+}
@@ -0,0 +1,202 @@
+/***************************************************************************
+ * libRSF - A Robust Sensor Fusion Library
+ *
+ * Copyright (C) 2018 Chair of Automation Technology / TU Chemnitz
+ * For more information see https://www.tu-chemnitz.de/etit/proaut/libRSF
+ *
+ * libRSF is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libRSF is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with libRSF.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Tim Pfeifer (tim.pfeifer@etit.tu-chemnitz.de)
+ ***************************************************************************/
+
+/**
+ * @file BackendSelection.cpp
+ * @author Tim Pfeifer
+ * @date 14.10.2026
+ * @brief Benchmark of the available sparse linear algebra backends on the current problem.
+ * @copyright GNU Public License.
+ *
+ */
+
+#include "BackendSelection.h"
+#include "Messages.h"
+
+#include <algorithm>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <tuple>
+
+namespace libRSF
+{
+  void LinearBackend::apply(ceres::Solver::Options &Options) const
+  {
+    if (Options.linear_solver_ordering == nullptr)
+    {
+      Options.linear_solver_type = LinearSolver;
+    }
+    Options.sparse_linear_algebra_library_type = Library;
+#ifdef LIBRSF_CERES_ORDERING_TYPE
+    Options.linear_solver_ordering_type = Ordering;
+#endif
+  }
+
+  std::string LinearBackend::getName() const
+  {
+    std::string Name = std::string(ceres::LinearSolverTypeToString(LinearSolver)) + "/" + ceres::SparseLinearAlgebraLibraryTypeToString(Library);
+#ifdef LIBRSF_CERES_ORDERING_TYPE
+    Name += std::string("/") + ceres::LinearSolverOrderingTypeToString(Ordering);
+#endif
+    return Name;
+  }
+
+  bool GraphStructureClass::operator<(const GraphStructureClass &Other) const
+  {
+    return std::tie(HasLandmarks, HasMarginals, SizeClass) < std::tie(Other.HasLandmarks, Other.HasMarginals, Other.SizeClass);
+  }
+
+  std::string GraphStructureClass::getName() const
+  {
+    return std::string(HasLandmarks ? "landmarks" : "chain") + (HasMarginals ? "+marginals" : "") + " 2^" + std::to_string(SizeClass) + " factors";
+  }
+
+  std::vector<LinearBackend> GetLinearBackendCandidates(const ceres::Solver::Options &Options, const bool HasLandmarks)
+  {
+    std::vector<ceres::SparseLinearAlgebraLibraryType> Libraries = {ceres::SUITE_SPARSE,
+                                                                    ceres::EIGEN_SPARSE,
+                                                                    ceres::ACCELERATE_SPARSE};
+#if CERES_VERSION_MAJOR < 2 || (CERES_VERSION_MAJOR == 2 && CERES_VERSION_MINOR < 2)
+    Libraries.push_back(ceres::CX_SPARSE);
+#else
+    Libraries.push_back(ceres::CUDA_SPARSE);
+#endif
+
+    std::vector<ceres::LinearSolverType> Solvers = {ceres::SPARSE_NORMAL_CHOLESKY};
+    if (HasLandmarks)
+    {
+      Solvers.push_back(ceres::SPARSE_SCHUR);
+    }
+
+    std::vector<LinearBackend> Candidates;
+    for (const ceres::SparseLinearAlgebraLibraryType Library : Libraries)
+    {
+      if (!ceres::IsSparseLinearAlgebraLibraryTypeAvailable(Library))
+      {
+        continue;
+      }
+
+      for (const ceres::LinearSolverType Solver : Solvers)
+      {
+#ifdef LIBRSF_CERES_ORDERING_TYPE
+        for (const ceres::LinearSolverOrderingType Ordering : {ceres::AMD, ceres::NESDIS})
+#endif
+        {
+          LinearBackend Candidate;
+          Candidate.LinearSolver = Solver;
+          Candidate.Library = Library;
+#ifdef LIBRSF_CERES_ORDERING_TYPE
+          Candidate.Ordering = Ordering;
+#endif
+
+          /** e.g. nested dissection is not supported by all libraries */
+          ceres::Solver::Options Test = Options;
+          Candidate.apply(Test);
+          std::string Error;
+          if (Test.IsValid(&Error))
+          {
+            Candidates.push_back(Candidate);
+          }
+        }
+      }
+    }
+
+    return Candidates;
+  }
+
+  bool BenchmarkLinearBackends(ceres::Problem &Problem,
+                               const ceres::Solver::Options &Options,
+                               const std::vector<LinearBackend> &Candidates,
+                               const int Iterations,
+                               LinearBackend &Best)
+  {
+    /** every candidate starts from the same point */
+    std::vector<double*> Blocks;
+    Problem.GetParameterBlocks(&Blocks);
+    std::vector<std::vector<double>> Backup(Blocks.size());
+    for (size_t n = 0; n < Blocks.size(); ++n)
+    {
+      Backup.at(n).assign(Blocks.at(n), Blocks.at(n) + Problem.ParameterBlockSize(Blocks.at(n)));
+    }
+    auto Restore = [&]()
+    {
+      for (size_t n = 0; n < Blocks.size(); ++n)
+      {
+        std::copy(Backup.at(n).begin(), Backup.at(n).end(), Blocks.at(n));
+      }
+    };
+
+    ceres::Solver::Options BenchmarkOptions = Options;
+    BenchmarkOptions.max_num_iterations = std::max(1, Iterations);
+    BenchmarkOptions.callbacks.clear();
+    BenchmarkOptions.logging_type = ceres::SILENT;
+    BenchmarkOptions.minimizer_progress_to_stdout = false;
+
+    double BestTime = std::numeric_limits<double>::infinity();
+    for (const LinearBackend &Candidate : Candidates)
+    {
+      ceres::Solver::Options CandidateOptions = BenchmarkOptions;
+      Candidate.apply(CandidateOptions);
+
+      ceres::Solver::Summary Summary;
+      ceres::Solve(CandidateOptions, &Problem, &Summary);
+      Restore();
+
+      if (!Summary.IsSolutionUsable())
+      {
+        continue;
+      }
+
+      /** the symbolic analysis is part of the time, it is repeated by every solve */
+      const double Time = Summary.total_time_in_seconds / std::max(1, Summary.num_successful_steps + Summary.num_unsuccessful_steps);
+      if (Time < BestTime)
+      {
+        BestTime = Time;
+        Best = Candidate;
+      }
+    }
+
+    return BestTime < std::numeric_limits<double>::infinity();
+  }
+
+  static std::mutex BackendMutex;
+  static std::map<GraphStructureClass, LinearBackend> BackendChoices;
+
+  bool LookupLinearBackend(const GraphStructureClass &Class, LinearBackend &Backend)
+  {
+    std::lock_guard<std::mutex> Lock(BackendMutex);
+    const auto Choice = BackendChoices.find(Class);
+    if (Choice == BackendChoices.end())
+    {
+      return false;
+    }
+    Backend = Choice->second;
+    return true;
+  }
+
+  void StoreLinearBackend(const GraphStructureClass &Class, const LinearBackend &Backend)
+  {
+    std::lock_guard<std::mutex> Lock(BackendMutex);
+    BackendChoices[Class] = Backend;
+  }
+}
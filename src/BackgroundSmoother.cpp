@@ -0,0 +1,158 @@
+/***************************************************************************
+ * libRSF - A Robust Sensor Fusion Library
+ *
+ * Copyright (C) 2018 Chair of Automation Technology / TU Chemnitz
+ * For more information see https://www.tu-chemnitz.de/etit/proaut/libRSF
+ *
+ * libRSF is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libRSF is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with libRSF.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Tim Pfeifer (tim.pfeifer@etit.tu-chemnitz.de)
+ ***************************************************************************/
+
+#include "BackgroundSmoother.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace libRSF
+{
+  BackgroundSmoother::BackgroundSmoother(const ceres::Solver::Options &Options,
+                                         AsyncSolver::EpochFunction Epoch,
+                                         std::vector<std::string> Names,
+                                         const double Horizon,
+                                         const int SolveInterval,
+                                         const size_t QueueCapacity) :
+      Options_(Options), Names_(std::move(Names)), Horizon_(Horizon), SolveInterval_(std::max(1, SolveInterval)),
+      Solver_(Graph_,
+              [this, Epoch = std::move(Epoch)](FactorGraph &Graph, const SensorDataSet &Measurements, const double TimeOld, const double TimeNow)
+              {
+                Epoch(Graph, Measurements, TimeOld, TimeNow);
+
+                /** the complete graph grows with every epoch, so it is not solved for each of them */
+                if (++Epochs_ % SolveInterval_ == 0)
+                {
+                  Graph.solve(Options_);
+                  this->publish_(TimeNow);
+                }
+              },
+              nullptr,
+              QueueCapacity)
+  {
+  }
+
+  void BackgroundSmoother::addMeasurements(const SensorDataSet &Measurements)
+  {
+    Solver_.addMeasurements(Measurements);
+  }
+
+  void BackgroundSmoother::closeEpoch(const double Timestamp)
+  {
+    Solver_.closeEpoch(Timestamp);
+  }
+
+  void BackgroundSmoother::publish_(const double TimeNow)
+  {
+    /** the copy is prepared outside of the lock, so the foreground thread is never blocked by it */
+    StateDataSet States;
+    const StateDataSet &Smoothed = Graph_.getStateData();
+    for (const std::string &Name : Names_)
+    {
+      for (const Data &State : Smoothed.range(Name, TimeNow - Horizon_, TimeNow))
+      {
+        States.addElement(Name, State);
+      }
+    }
+
+    std::lock_guard<std::mutex> Lock(Mutex_);
+    Published_ = std::move(States);
+    PublishedTime_ = TimeNow;
+    PublishedVersion_++;
+  }
+
+  int BackgroundSmoother::correct(FactorGraph &Graph)
+  {
+    std::lock_guard<std::mutex> Lock(Mutex_);
+
+    /** the same solution is applied only once, so the window can move away from it */
+    if (CorrectedVersion_ == PublishedVersion_)
+    {
+      return 0;
+    }
+    CorrectedVersion_ = PublishedVersion_;
+
+    int Corrected = 0;
+    StateDataSet &Foreground = Graph.getStateData();
+    for (const std::string &Name : Names_)
+    {
+      const auto States = Published_.range(Name, std::numeric_limits<double>::lowest(), PublishedTime_);
+      double TimePrev = std::numeric_limits<double>::lowest();
+      int Number = 0;
+      for (auto State = States.begin(); State != States.end(); ++State)
+      {
+        /** several states with the same timestamp are distinguished by their number */
+        Number = (State.getTime() == TimePrev) ? Number + 1 : 0;
+        TimePrev = State.getTime();
+
+        if (Foreground.checkElement(Name, TimePrev, Number))
+        {
+          Foreground.getElement(Name, TimePrev, Number).setMean(State->getMean());
+          Corrected++;
+        }
+      }
+    }
+    return Corrected;
+  }
+
+  void BackgroundSmoother::getPublished(StateDataSet &States) const
+  {
+    std::lock_guard<std::mutex> Lock(Mutex_);
+    States = Published_;
+  }
+
+  double BackgroundSmoother::getPublishedTime() const
+  {
+    std::lock_guard<std::mutex> Lock(Mutex_);
+    return PublishedTime_;
+  }
+
+  void BackgroundSmoother::finish()
+  {
+    if (IsFinished_)
+    {
+      return;
+    }
+    Solver_.finish();
+    IsFinished_ = true;
+
+    /** the thread is joined, so the last epochs can be solved here */
+    if (Epochs_ % SolveInterval_ != 0)
+    {
+      Graph_.solve(Options_);
+    }
+  }
+
+  FactorGraph &BackgroundSmoother::getSmoother()
+  {
+    if (!IsFinished_)
+    {
+      PRINT_WARNING("The smoother graph is still owned by its thread, call finish() first!");
+    }
+    return Graph_;
+  }
+
+  int BackgroundSmoother::countProcessedEpochs() const
+  {
+    return Solver_.countProcessedEpochs();
+  }
+}
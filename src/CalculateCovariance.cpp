@@ -22,8 +22,168 @@
 
 #include "CalculateCovariance.h"
 
+#include <algorithm>
+
 namespace libRSF
 {
+  bool AccumulateFactorInformation(ceres::Problem &Graph,
+                                   const ceres::ResidualBlockId Factor,
+                                   const std::vector<double*> &States,
+                                   const std::vector<int> &Offsets,
+                                   Eigen::Ref<Matrix> Information)
+  {
+    std::vector<double*> Blocks;
+    Graph.GetParameterBlocksForResidualBlock(Factor, &Blocks);
+
+    /** position of each connected state, constant ones are skipped */
+    std::vector<int> Position(Blocks.size(), -1);
+    for (size_t n = 0; n < Blocks.size(); n++)
+    {
+      const auto It = std::find(States.begin(), States.end(), Blocks.at(n));
+      if (It != States.end())
+      {
+        Position.at(n) = static_cast<int>(It - States.begin());
+      }
+      else if (!Graph.IsParameterBlockConstant(Blocks.at(n)))
+      {
+        return false;
+      }
+    }
+
+    /** linearize at the current estimate */
+    Vector Residual(Graph.GetCostFunctionForResidualBlock(Factor)->num_residuals());
+    std::vector<Matrix> Jacobians(Blocks.size());
+    std::vector<double*> JacobianPointers(Blocks.size(), nullptr);
+    for (size_t n = 0; n < Blocks.size(); n++)
+    {
+      if (Position.at(n) >= 0)
+      {
+        Jacobians.at(n).resize(Residual.size(), Graph.ParameterBlockSize(Blocks.at(n)));
+        JacobianPointers.at(n) = Jacobians.at(n).data();
+      }
+    }
+
+    double Cost;
+    if (!Graph.EvaluateResidualBlock(Factor, true, &Cost, Residual.data(), JacobianPointers.data()))
+    {
+      return false;
+    }
+
+    /** map to the local parametrization */
+    for (size_t n = 0; n < Blocks.size(); n++)
+    {
+      const ceres::LocalParameterization* Parametrization = Graph.GetParameterization(Blocks.at(n));
+      if (Position.at(n) >= 0 && Parametrization != nullptr)
+      {
+        Matrix JacobianPlus(Graph.ParameterBlockSize(Blocks.at(n)), Parametrization->LocalSize());
+        Parametrization->ComputeJacobian(Blocks.at(n), JacobianPlus.data());
+        Jacobians.at(n) = Jacobians.at(n) * JacobianPlus;
+      }
+    }
+
+    /** accumulate J^T * J */
+    for (size_t n = 0; n < Blocks.size(); n++)
+    {
+      for (size_t m = 0; m < Blocks.size() && Position.at(n) >= 0; m++)
+      {
+        if (Position.at(m) >= 0)
+        {
+          Information.block(Offsets.at(Position.at(n)), Offsets.at(Position.at(m)), Jacobians.at(n).cols(), Jacobians.at(m).cols())
+              += Jacobians.at(n).transpose() * Jacobians.at(m);
+        }
+      }
+    }
+
+    return true;
+  }
+
+  bool CalculateCovarianceIsolated(ceres::Problem &Graph,
+                                   double* const State,
+                                   double* const Covariance)
+  {
+    /** bounded storage, so that the small system does not allocate */
+    using SmallMatrix = Eigen::Matrix<double, Dynamic, Dynamic, Eigen::RowMajor, MaxIsolatedSize, MaxIsolatedSize>;
+
+    if (!Graph.HasParameterBlock(State) || Graph.IsParameterBlockConstant(State))
+    {
+      return false;
+    }
+
+    /** collect the connected component, abort as soon as it gets too big */
+    std::vector<double*> Component = {State};
+    std::vector<int> Offsets = {0};
+    int Size = Graph.ParameterBlockLocalSize(State);
+    std::vector<ceres::ResidualBlockId> Factors;
+    std::vector<ceres::ResidualBlockId> Connected;
+    std::vector<double*> Blocks;
+    for (size_t nState = 0; nState < Component.size(); nState++)
+    {
+      Graph.GetResidualBlocksForParameterBlock(Component.at(nState), &Connected);
+      for (const ceres::ResidualBlockId Factor : Connected)
+      {
+        if (std::find(Factors.begin(), Factors.end(), Factor) != Factors.end())
+        {
+          continue;
+        }
+        Factors.push_back(Factor);
+
+        Graph.GetParameterBlocksForResidualBlock(Factor, &Blocks);
+        for (double* const Block : Blocks)
+        {
+          if (!Graph.IsParameterBlockConstant(Block) && std::find(Component.begin(), Component.end(), Block) == Component.end())
+          {
+            Offsets.push_back(Size);
+            Component.push_back(Block);
+            Size += Graph.ParameterBlockLocalSize(Block);
+            if (Size > MaxIsolatedSize)
+            {
+              return false;
+            }
+          }
+        }
+      }
+    }
+
+    /** dense information matrix J^T * W * J */
+    SmallMatrix Information = SmallMatrix::Zero(Size, Size);
+    for (const ceres::ResidualBlockId Factor : Factors)
+    {
+      if (!AccumulateFactorInformation(Graph, Factor, Component, Offsets, Information))
+      {
+        return false;
+      }
+    }
+
+    const Eigen::LLT<SmallMatrix> LLT(Information);
+    if (LLT.info() != Eigen::Success)
+    {
+      return false;
+    }
+
+    /** only the block of the requested state is needed */
+    const int LocalSize = Graph.ParameterBlockLocalSize(State);
+    SmallMatrix Unit = SmallMatrix::Zero(Size, LocalSize);
+    Unit.topRows(LocalSize).setIdentity();
+    const SmallMatrix Solution = LLT.solve(Unit);
+    const SmallMatrix CovLocal = Solution.topRows(LocalSize);
+
+    /** lift to the global parametrization */
+    const int GlobalSize = Graph.ParameterBlockSize(State);
+    MatrixRef<double, Dynamic, Dynamic> CovGlobal(Covariance, GlobalSize, GlobalSize);
+    const ceres::LocalParameterization* Parametrization = Graph.GetParameterization(State);
+    if (Parametrization != nullptr)
+    {
+      Matrix JacobianPlus(GlobalSize, LocalSize);
+      Parametrization->ComputeJacobian(State, JacobianPlus.data());
+      CovGlobal = JacobianPlus * CovLocal * JacobianPlus.transpose();
+    }
+    else
+    {
+      CovGlobal = CovLocal;
+    }
+
+    return true;
+  }
 
   bool CalculateCovariance(ceres::Problem &Graph,
                            StateDataSet &States,
@@ -34,7 +194,7 @@ namespace libRSF
     /** create covariance object */
     ceres::Covariance::Options CovOptions;
     CovOptions.algorithm_type = ceres::CovarianceAlgorithmType::SPARSE_QR;
-    CovOptions.num_threads = static_cast<int>(std::thread::hardware_concurrency());
+    CovOptions.num_threads = GetThreadNumber();
     CovOptions.apply_loss_function = true;
     ceres::Covariance Covariance(CovOptions);
 
@@ -43,28 +203,31 @@ namespace libRSF
 
     if (States.getTimeFirst(Type, Timestamp))
     {
-      /** make pairs of pointers to each state variable */
+      /** make pairs of pointers to each state variable, isolated ones are solved directly */
+      std::vector<Data*> Remaining;
       do
       {
-        CovarianceBlocks.emplace_back(States.getElement(Type, Timestamp).getMeanPointer(),
-                                   States.getElement(Type, Timestamp).getMeanPointer());
+        Data &State = States.getElement(Type, Timestamp);
+        if (!CalculateCovarianceIsolated(Graph, State.getMeanPointer(), State.getDataPointer(DataElement::Covariance)))
+        {
+          Remaining.push_back(&State);
+          CovarianceBlocks.emplace_back(State.getMeanPointer(), State.getMeanPointer());
+        }
       }
       while (States.getTimeNext(Type, Timestamp, Timestamp));
 
       /** at first we try the more efficient algorithm */
-      bool const Success = Covariance.Compute(CovarianceBlocks, &Graph);
+      bool const Success = CovarianceBlocks.empty() || Covariance.Compute(CovarianceBlocks, &Graph);
 
       if (Success)
       {
         /** read covariance values to vector */
-        States.getTimeFirst(Type, Timestamp);
-        do
+        for (Data *State : Remaining)
         {
-          Covariance.GetCovarianceBlock(States.getElement(Type, Timestamp).getMeanPointer(),
-                                        States.getElement(Type, Timestamp).getMeanPointer(),
-                                        States.getElement(Type, Timestamp).getDataPointer(DataElement::Covariance));
+          Covariance.GetCovarianceBlock(State->getMeanPointer(),
+                                        State->getMeanPointer(),
+                                        State->getDataPointer(DataElement::Covariance));
         }
-        while (States.getTimeNext(Type, Timestamp, Timestamp));
       }
       else
       {
@@ -81,6 +244,99 @@ namespace libRSF
     return true;
   }
 
+  bool CalculateCovariance(ceres::Problem &Graph,
+                           StateDataSet &States,
+                           const std::vector<std::string> &Types,
+                           std::vector<CrossCovariance>* CrossCovariances)
+  {
+    /** create covariance object */
+    ceres::Covariance::Options CovOptions;
+    CovOptions.algorithm_type = ceres::CovarianceAlgorithmType::SPARSE_QR;
+    CovOptions.num_threads = GetThreadNumber();
+    CovOptions.apply_loss_function = true;
+    ceres::Covariance Covariance(CovOptions);
+
+    /** collect the diagonal blocks of all types */
+    std::vector<std::pair<const double*, const double*>> CovarianceBlocks;
+    for (const std::string &Type : Types)
+    {
+      double Timestamp;
+      if (!States.getTimeFirst(Type, Timestamp))
+      {
+        PRINT_ERROR("Covariance computation of ", Type, " went wrong. No ", Type, " in state data!");
+        return false;
+      }
+
+      do
+      {
+        CovarianceBlocks.emplace_back(States.getElement(Type, Timestamp).getMeanPointer(),
+                                      States.getElement(Type, Timestamp).getMeanPointer());
+      }
+      while (States.getTimeNext(Type, Timestamp, Timestamp));
+    }
+
+    /** collect the off-diagonal blocks between types at the same timestamp */
+    std::vector<CrossCovariance> CrossBlocks;
+    if (CrossCovariances != nullptr)
+    {
+      for (int n1 = 0; n1 < static_cast<int>(Types.size()); n1++)
+      {
+        double Timestamp;
+        States.getTimeFirst(Types.at(n1), Timestamp);
+        do
+        {
+          for (int n2 = n1 + 1; n2 < static_cast<int>(Types.size()); n2++)
+          {
+            if (States.checkElement(Types.at(n2), Timestamp))
+            {
+              CrossBlocks.push_back({Timestamp, Types.at(n1), Types.at(n2), Matrix()});
+              CovarianceBlocks.emplace_back(States.getElement(Types.at(n1), Timestamp).getMeanPointer(),
+                                            States.getElement(Types.at(n2), Timestamp).getMeanPointer());
+            }
+          }
+        }
+        while (States.getTimeNext(Types.at(n1), Timestamp, Timestamp));
+      }
+    }
+
+    /** one factorization for all blocks */
+    if (!Covariance.Compute(CovarianceBlocks, &Graph))
+    {
+      PRINT_ERROR("Covariance computation of multiple types went wrong.");
+      return false;
+    }
+
+    /** read covariance values to vector */
+    for (const std::string &Type : Types)
+    {
+      double Timestamp;
+      States.getTimeFirst(Type, Timestamp);
+      do
+      {
+        Covariance.GetCovarianceBlock(States.getElement(Type, Timestamp).getMeanPointer(),
+                                      States.getElement(Type, Timestamp).getMeanPointer(),
+                                      States.getElement(Type, Timestamp).getDataPointer(DataElement::Covariance));
+      }
+      while (States.getTimeNext(Type, Timestamp, Timestamp));
+    }
+
+    /** read cross-covariances */
+    if (CrossCovariances != nullptr)
+    {
+      for (CrossCovariance &Cross : CrossBlocks)
+      {
+        Data &State1 = States.getElement(Cross.Type1, Cross.Timestamp);
+        Data &State2 = States.getElement(Cross.Type2, Cross.Timestamp);
+
+        Cross.Covariance.resize(State1.getMean().size(), State2.getMean().size());
+        Covariance.GetCovarianceBlock(State1.getMeanPointer(), State2.getMeanPointer(), Cross.Covariance.data());
+      }
+      *CrossCovariances = std::move(CrossBlocks);
+    }
+
+    return true;
+  }
+
   bool CalculateCovariance(ceres::Problem &Graph,
                            StateDataSet &States,
                            const std::string &Type,
@@ -90,7 +346,7 @@ namespace libRSF
 
     /** create covariance object */
     ceres::Covariance::Options CovOptions;
-    CovOptions.num_threads = static_cast<int>(std::thread::hardware_concurrency());
+    CovOptions.num_threads = GetThreadNumber();
     CovOptions.apply_loss_function = true;
     ceres::Covariance Covariance(CovOptions);
 
@@ -99,6 +355,14 @@ namespace libRSF
 
     if (States.countElement(Type, Timestamp) == 1)
     {
+      /** small isolated subsystems do not need a sparse factorization */
+      if (CalculateCovarianceIsolated(Graph,
+                                      States.getElement(Type, Timestamp, StateNumber).getMeanPointer(),
+                                      States.getElement(Type, Timestamp, StateNumber).getDataPointer(DataElement::Covariance)))
+      {
+        return true;
+      }
+
       /** make a pair of pointers to state variable */
       ParameterBlock.push_back(States.getElement(Type, Timestamp, StateNumber).getMeanPointer());
 
@@ -152,4 +416,83 @@ namespace libRSF
 
     return true;
   }
+
+  bool EstimateCovarianceSigmaPoints(ceres::Problem &Graph,
+                                     StateDataSet &States,
+                                     const std::vector<StateID> &IDs)
+  {
+    /** collect the states before the threads start, the set is not modified concurrently */
+    std::vector<Data*> Elements;
+    std::vector<std::pair<const double*, const double*>> CovarianceBlocks;
+    for (const StateID &ID : IDs)
+    {
+      if (!States.checkElement(ID.ID, ID.getTimestamp(), ID.Number))
+      {
+        PRINT_ERROR("Covariance computation of ", ID.ID, " went wrong. No ", ID.ID, " at ", ID.getTimestamp(), "s in state data!");
+        return false;
+      }
+      Data &State = States.getElement(ID.ID, ID.getTimestamp(), ID.Number);
+      Elements.push_back(&State);
+      CovarianceBlocks.emplace_back(State.getMeanPointer(), State.getMeanPointer());
+    }
+
+    /** initial covariances of all states with a single factorization */
+    ceres::Covariance::Options CovOptions;
+    CovOptions.num_threads = GetThreadNumber();
+    CovOptions.apply_loss_function = true;
+    ceres::Covariance Covariance(CovOptions);
+
+    std::vector<char> Success(Elements.size(), 1);
+    if (Covariance.Compute(CovarianceBlocks, &Graph))
+    {
+      for (Data *State : Elements)
+      {
+        Covariance.GetCovarianceBlock(State->getMeanPointer(), State->getMeanPointer(), State->getDataPointer(DataElement::Covariance));
+      }
+    }
+    else
+    {
+      /** fall back to the single states, which can use SVD for rank-deficient ones */
+      for (size_t nState = 0; nState < IDs.size(); ++nState)
+      {
+        Success.at(nState) = CalculateCovariance(Graph, States, IDs.at(nState).ID, IDs.at(nState).getTimestamp(), IDs.at(nState).Number);
+      }
+    }
+
+    /** refine each state on its own copy of the connected factors */
+    GetThreadPool().parallelFor(Elements.size(), [&](const size_t nState)
+    {
+      if (!Success.at(nState))
+      {
+        return;
+      }
+
+      Data &State = *Elements.at(nState);
+      switch (State.getMean().size())
+      {
+        case 1:
+          RefineCovarianceSigmaPoint<1>(Graph, State);
+          break;
+
+        case 2:
+          RefineCovarianceSigmaPoint<2>(Graph, State);
+          break;
+
+        case 3:
+          RefineCovarianceSigmaPoint<3>(Graph, State);
+          break;
+
+        case 4:
+          RefineCovarianceSigmaPoint<4>(Graph, State);
+          break;
+
+        default:
+          PRINT_ERROR("Sigma_ Point Covariance for ", State.getMean().size(), " dimensions is missing. Add case!");
+          Success.at(nState) = 0;
+          break;
+      }
+    });
+
+    return std::all_of(Success.begin(), Success.end(), [](const char StateSuccess){return StateSuccess != 0;});
+  }
 }
@@ -0,0 +1,156 @@
+/***************************************************************************
+ * libRSF - A Robust Sensor Fusion Library
+ *
+ * Copyright (C) 2018 Chair of Automation Technology / TU Chemnitz
+ * For more information see https://www.tu-chemnitz.de/etit/proaut/libRSF
+ *
+ * libRSF is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libRSF is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with libRSF.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Tim Pfeifer (tim.pfeifer@etit.tu-chemnitz.de)
+ ***************************************************************************/
+
+#include "Checkpoint.h"
+
+#include <fstream>
+
+namespace libRSF
+{
+  void CheckpointWriter::writeString(const std::string &String)
+  {
+    write(static_cast<uint32_t>(String.size()));
+    Buffer_.insert(Buffer_.end(), String.begin(), String.end());
+  }
+
+  void CheckpointWriter::writeData(const Data &Object)
+  {
+    /** the type is stored by name, like in the binary data files */
+    writeString(Object.getName());
+    write(static_cast<uint32_t>(Object.getBuffer().size()));
+    const char * Bytes = reinterpret_cast<const char *>(Object.getBuffer().data());
+    Buffer_.insert(Buffer_.end(), Bytes, Bytes + Object.getBuffer().size() * sizeof(double));
+  }
+
+  void CheckpointWriter::writeStateID(const StateID &ID)
+  {
+    writeString(ID.ID.getName());
+    write(ID.getTimestamp());
+    write(static_cast<int32_t>(ID.Number));
+  }
+
+  bool CheckpointWriter::writeToFile(const std::string &Filename) const
+  {
+    std::ofstream File(Filename, std::ios::out | std::ios::trunc | std::ios::binary);
+    if (!File)
+    {
+      PRINT_ERROR("Could not open file: ", Filename);
+      return false;
+    }
+
+    File.write(Buffer_.data(), static_cast<std::streamsize>(Buffer_.size()));
+    File.close();
+    return !File.fail();
+  }
+
+  bool CheckpointWriter::flushToStream(std::ostream &Stream)
+  {
+    Stream.write(Buffer_.data(), static_cast<std::streamsize>(Buffer_.size()));
+    Buffer_.clear();
+    return !Stream.fail();
+  }
+
+  bool CheckpointReader::readFromFile(const std::string &Filename)
+  {
+    std::ifstream File(Filename, std::ios::binary | std::ios::ate);
+    if (!File)
+    {
+      PRINT_ERROR("Could not open file: ", Filename);
+      return false;
+    }
+
+    Buffer_.resize(static_cast<size_t>(File.tellg()));
+    File.seekg(0);
+    File.read(Buffer_.data(), static_cast<std::streamsize>(Buffer_.size()));
+    Position_ = 0;
+    return !File.fail();
+  }
+
+  bool CheckpointReader::readString(std::string &String)
+  {
+    uint32_t Length = 0;
+    if (!read(Length) || Length > getRemaining())
+    {
+      return false;
+    }
+    String.assign(Buffer_.data() + Position_, Length);
+    Position_ += Length;
+    return true;
+  }
+
+  bool CheckpointReader::readData(Data &Object)
+  {
+    std::string Name;
+    uint32_t Size = 0;
+    if (!readString(Name) || !read(Size))
+    {
+      return false;
+    }
+
+    if (!GlobalDataConfig.checkName(Name))
+    {
+      PRINT_ERROR("Type does not exist: ", Name);
+      return false;
+    }
+
+    const DataType Type = GlobalDataConfig.getType(Name);
+    if (static_cast<int>(Size) != GlobalDataConfig.getLayout(Type).TotalSize)
+    {
+      PRINT_ERROR("Layout of ", Name, " does not match the current config: ", Size, " values");
+      return false;
+    }
+
+    std::vector<double> Values(Size);
+    if (!readBytes_(Values.data(), Size * sizeof(double)))
+    {
+      return false;
+    }
+    Object = Data(Type, Values.data(), Size);
+    return true;
+  }
+
+  bool CheckpointReader::readStateID(StateID &ID)
+  {
+    std::string Name;
+    double Timestamp = 0.0;
+    int32_t Number = 0;
+    if (!readString(Name) || !read(Timestamp) || !read(Number))
+    {
+      return false;
+    }
+    ID.ID = StateKey(Name);
+    ID.setTimestamp(Timestamp);
+    ID.Number = Number;
+    return true;
+  }
+
+  bool CheckpointReader::readBytes_(void * Target, const size_t Bytes)
+  {
+    if (Bytes > getRemaining())
+    {
+      return false;
+    }
+    std::memcpy(Target, Buffer_.data() + Position_, Bytes);
+    Position_ += Bytes;
+    return true;
+  }
+}
@@ -30,18 +30,35 @@ namespace libRSF
     this->Config = &GlobalDataConfig;
   }
 
-  Data::Data(const std::string& Input)
+  Data::Data(const std::string_view Input)
   {
     this->Config = &GlobalDataConfig;
     this->constructFromString(Input);
   }
 
+  Data::Data(const std::string_view Input, std::string &Error)
+  {
+    this->Config = &GlobalDataConfig;
+    this->constructFromString(Input, Error);
+  }
+
   Data::Data(DataType Type, double Timestamp)
   {
     this->Config = &GlobalDataConfig;
     this->constructEmpty(Type, Timestamp);
   }
 
+  void Data::reset(const DataType Type, const double Timestamp)
+  {
+    this->constructEmpty(Type, Timestamp);
+  }
+
+  Data::Data(DataType Type, const double * Values, const Index Size)
+  {
+    this->Config = &GlobalDataConfig;
+    this->constructFromBuffer(Type, Values, Size);
+  }
+
   double Data::getTimestamp() const
   {
     return this->getValue(DataElement::Timestamp)(0);
@@ -106,7 +123,7 @@ namespace libRSF
 
   double const* Data::getMeanPointerConst()
   {
-    return this->getDataPointer(DataElement::Mean);
+    return this->getValue(DataElement::Mean).data();
   }
 
   void Data::setMean(const Vector& Mean)
@@ -151,4 +168,20 @@ namespace libRSF
   {
     this->setCovarianceDiagonal(StdDev.array().square());
   }
+
+  std::vector<Data> CreateData(const DataType Type, const size_t Number, const double Timestamp)
+  {
+    /** copies of one object do not look up the type again */
+    return std::vector<Data>(Number, Data(Type, Timestamp));
+  }
+
+  std::vector<Data> CreateData(const DataType Type, const std::vector<double> &Timestamps)
+  {
+    std::vector<Data> Objects = CreateData(Type, Timestamps.size());
+    for (size_t n = 0; n < Timestamps.size(); n++)
+    {
+      Objects[n].setTimestamp(Timestamps[n]);
+    }
+    return Objects;
+  }
 }
@@ -25,8 +25,4 @@
 
 namespace libRSF
 {
-  double roundToTick(const double Time)
-  {
-    return round(Time * 1e3) * 1e-3;
-  }
 }
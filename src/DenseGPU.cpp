@@ -0,0 +1,170 @@
+/***************************************************************************
+ * libRSF - A Robust Sensor Fusion Library
+ *
+ * Copyright (C) 2018 Chair of Automation Technology / TU Chemnitz
+ * For more information see https://www.tu-chemnitz.de/etit/proaut/libRSF
+ *
+ * libRSF is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libRSF is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with libRSF.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Tim Pfeifer (tim.pfeifer@etit.tu-chemnitz.de)
+ ***************************************************************************/
+
+#include "DenseGPU.h"
+#include "Messages.h"
+
+#ifdef LIBRSF_CUDA
+#include <cuda_runtime.h>
+#include <cusolverDn.h>
+
+#include <mutex>
+#endif // LIBRSF_CUDA
+
+namespace libRSF
+{
+#ifdef LIBRSF_CUDA
+  namespace
+  {
+    /** one handle for the whole process, cuSOLVER calls on it are serialized */
+    struct DenseGPUContext
+    {
+      DenseGPUContext()
+      {
+        int Devices = 0;
+        if (cudaGetDeviceCount(&Devices) == cudaSuccess && Devices > 0)
+        {
+          IsValid = (cusolverDnCreate(&Handle) == CUSOLVER_STATUS_SUCCESS);
+        }
+      }
+
+      ~DenseGPUContext()
+      {
+        if (IsValid)
+        {
+          cusolverDnDestroy(Handle);
+        }
+      }
+
+      DenseGPUContext(const DenseGPUContext &) = delete;
+      DenseGPUContext &operator=(const DenseGPUContext &) = delete;
+
+      cusolverDnHandle_t Handle = nullptr;
+      bool IsValid = false;
+      std::mutex Mutex;
+    };
+
+    DenseGPUContext &GetDenseGPUContext()
+    {
+      static DenseGPUContext Context;
+      return Context;
+    }
+
+    /** device memory that is released with the scope */
+    template <typename T>
+    struct DeviceBuffer
+    {
+      explicit DeviceBuffer(const size_t Number)
+      {
+        if (cudaMalloc(reinterpret_cast<void**>(&Data), Number * sizeof(T)) != cudaSuccess)
+        {
+          Data = nullptr;
+        }
+      }
+
+      ~DeviceBuffer()
+      {
+        cudaFree(Data);
+      }
+
+      DeviceBuffer(const DeviceBuffer &) = delete;
+      DeviceBuffer &operator=(const DeviceBuffer &) = delete;
+
+      T *Data = nullptr;
+    };
+  }
+#endif // LIBRSF_CUDA
+
+  bool IsDenseGPUAvailable()
+  {
+#ifdef LIBRSF_CUDA
+    return GetDenseGPUContext().IsValid;
+#else
+    return false;
+#endif // LIBRSF_CUDA
+  }
+
+  bool SolveCholeskyGPU(const Matrix &A, Matrix &B)
+  {
+#ifdef LIBRSF_CUDA
+    const Index Size = A.rows();
+    if (Size < DenseGPUMinSize || A.cols() != Size || B.rows() != Size || B.cols() == 0 || !IsDenseGPUAvailable())
+    {
+      return false;
+    }
+
+    DenseGPUContext &Context = GetDenseGPUContext();
+    const std::lock_guard<std::mutex> Lock(Context.Mutex);
+
+    const int N = static_cast<int>(Size);
+    const int NRHS = static_cast<int>(B.cols());
+
+    /** Eigen matrices are column-major like cuSOLVER */
+    DeviceBuffer<double> DeviceA(static_cast<size_t>(A.size()));
+    DeviceBuffer<double> DeviceB(static_cast<size_t>(B.size()));
+    DeviceBuffer<int> DeviceInfo(1);
+    if (DeviceA.Data == nullptr || DeviceB.Data == nullptr || DeviceInfo.Data == nullptr)
+    {
+      PRINT_WARNING("Could not allocate GPU memory for a system of size ", Size, ", use the CPU instead.");
+      return false;
+    }
+
+    if (cudaMemcpy(DeviceA.Data, A.data(), A.size() * sizeof(double), cudaMemcpyHostToDevice) != cudaSuccess ||
+        cudaMemcpy(DeviceB.Data, B.data(), B.size() * sizeof(double), cudaMemcpyHostToDevice) != cudaSuccess)
+    {
+      return false;
+    }
+
+    int WorkSize = 0;
+    if (cusolverDnDpotrf_bufferSize(Context.Handle, CUBLAS_FILL_MODE_LOWER, N, DeviceA.Data, N, &WorkSize) != CUSOLVER_STATUS_SUCCESS)
+    {
+      return false;
+    }
+    DeviceBuffer<double> DeviceWork(static_cast<size_t>(WorkSize));
+    if (DeviceWork.Data == nullptr)
+    {
+      return false;
+    }
+
+    /** A = L * L^T */
+    int Info = 0;
+    if (cusolverDnDpotrf(Context.Handle, CUBLAS_FILL_MODE_LOWER, N, DeviceA.Data, N, DeviceWork.Data, WorkSize, DeviceInfo.Data) != CUSOLVER_STATUS_SUCCESS ||
+        cudaMemcpy(&Info, DeviceInfo.Data, sizeof(int), cudaMemcpyDeviceToHost) != cudaSuccess || Info != 0)
+    {
+      return false;
+    }
+
+    /** X = L^-T * L^-1 * B */
+    if (cusolverDnDpotrs(Context.Handle, CUBLAS_FILL_MODE_LOWER, N, NRHS, DeviceA.Data, N, DeviceB.Data, N, DeviceInfo.Data) != CUSOLVER_STATUS_SUCCESS ||
+        cudaMemcpy(&Info, DeviceInfo.Data, sizeof(int), cudaMemcpyDeviceToHost) != cudaSuccess || Info != 0)
+    {
+      return false;
+    }
+
+    return (cudaMemcpy(B.data(), DeviceB.Data, B.size() * sizeof(double), cudaMemcpyDeviceToHost) == cudaSuccess);
+#else
+    static_cast<void>(A);
+    static_cast<void>(B);
+    return false;
+#endif // LIBRSF_CUDA
+  }
+}
@@ -0,0 +1,473 @@
+/***************************************************************************
+ * libRSF - A Robust Sensor Fusion Library
+ *
+ * Copyright (C) 2019 Chair of Automation Technology / TU Chemnitz
+ * For more information see https://www.tu-chemnitz.de/etit/proaut/libRSF
+ *
+ * libRSF is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libRSF is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with libRSF.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Tim Pfeifer (tim.pfeifer@etit.tu-chemnitz.de)
+ ***************************************************************************/
+
+#include "DenseSolver.h"
+
+#include <algorithm>
+#include <unordered_map>
+
+namespace libRSF
+{
+  namespace
+  {
+    using RowMajorMatrix = Eigen::Matrix<double, Dynamic, Dynamic, Eigen::RowMajor>;
+
+    struct DenseParameter
+    {
+      double *State;
+      int GlobalSize;
+      int LocalSize;
+      int Offset; /**< position in the tangent space vector, -1 for constant blocks */
+      const ceres::LocalParameterization *Parameterization;
+    };
+
+    struct DenseResidual
+    {
+      const ceres::CostFunction *CostFunction;
+      const ceres::LossFunction *LossFunction;
+      std::vector<double*> States;
+      std::vector<int> Parameters;
+    };
+
+    class DenseProblem
+    {
+      public:
+        explicit DenseProblem(ceres::Problem &Problem)
+        {
+          std::vector<double*> States;
+          Problem.GetParameterBlocks(&States);
+
+          std::unordered_map<double*, int> Index;
+          for (double *State : States)
+          {
+            DenseParameter Parameter;
+            Parameter.State = State;
+            Parameter.GlobalSize = Problem.ParameterBlockSize(State);
+            Parameter.LocalSize = Problem.ParameterBlockLocalSize(State);
+            Parameter.Parameterization = Problem.GetParameterization(State);
+            Parameter.Offset = -1;
+            if (!Problem.IsParameterBlockConstant(State))
+            {
+              Parameter.Offset = Size_;
+              Size_ += Parameter.LocalSize;
+            }
+
+            /** bounds are applied after each step */
+            Vector Lower(Parameter.GlobalSize), Upper(Parameter.GlobalSize);
+            for (int n = 0; n < Parameter.GlobalSize; n++)
+            {
+              Lower(n) = Problem.GetParameterLowerBound(State, n);
+              Upper(n) = Problem.GetParameterUpperBound(State, n);
+            }
+            Lower_.push_back(Lower);
+            Upper_.push_back(Upper);
+
+            Index.emplace(State, static_cast<int>(Parameters_.size()));
+            Parameters_.push_back(Parameter);
+          }
+
+          std::vector<ceres::ResidualBlockId> IDs;
+          Problem.GetResidualBlocks(&IDs);
+          for (const ceres::ResidualBlockId ID : IDs)
+          {
+            DenseResidual Residual;
+            Residual.CostFunction = Problem.GetCostFunctionForResidualBlock(ID);
+            Residual.LossFunction = Problem.GetLossFunctionForResidualBlock(ID);
+            Problem.GetParameterBlocksForResidualBlock(ID, &Residual.States);
+            bool IsFixed = true;
+            for (double *State : Residual.States)
+            {
+              Residual.Parameters.push_back(Index.at(State));
+              IsFixed = IsFixed && (Parameters_.at(Index.at(State)).Offset < 0);
+            }
+
+            /** factors of constant states add a constant cost, like the preprocessor of ceres they are evaluated only once */
+            double Cost = 0.0;
+            if (IsFixed && evaluateCost_(Residual, Cost))
+            {
+              FixedCost_ += Cost;
+              continue;
+            }
+            Residuals_.push_back(Residual);
+          }
+        }
+
+        [[nodiscard]] int getSize() const
+        {
+          return Size_;
+        }
+
+        /** cost of the factors that are only connected to constant states */
+        [[nodiscard]] double getFixedCost() const
+        {
+          return FixedCost_;
+        }
+
+        [[nodiscard]] int countActiveResiduals() const
+        {
+          return static_cast<int>(Residuals_.size());
+        }
+
+        /** cost and the normal equations with the same loss correction as ceres, H and G stay untouched without ComputeDerivatives */
+        bool evaluate(double &Cost, Matrix &H, Vector &G, const bool ComputeDerivatives) const
+        {
+          Cost = 0.0;
+          if (ComputeDerivatives)
+          {
+            H.setZero(Size_, Size_);
+            G.setZero(Size_);
+          }
+
+          std::vector<RowMajorMatrix> Jacobians;
+          std::vector<double*> JacobianPointers;
+          std::vector<Matrix> LocalJacobians;
+          for (const DenseResidual &Residual : Residuals_)
+          {
+            const int ResidualSize = Residual.CostFunction->num_residuals();
+            const size_t BlockNumber = Residual.States.size();
+
+            Jacobians.resize(BlockNumber);
+            JacobianPointers.assign(BlockNumber, nullptr);
+            for (size_t n = 0; n < BlockNumber && ComputeDerivatives; n++)
+            {
+              const DenseParameter &Parameter = Parameters_.at(Residual.Parameters.at(n));
+              if (Parameter.Offset >= 0)
+              {
+                Jacobians.at(n).resize(ResidualSize, Parameter.GlobalSize);
+                JacobianPointers.at(n) = Jacobians.at(n).data();
+              }
+            }
+
+            Vector Error(ResidualSize);
+            if (!Residual.CostFunction->Evaluate(Residual.States.data(), Error.data(), ComputeDerivatives ? JacobianPointers.data() : nullptr))
+            {
+              return false;
+            }
+
+            /** robust loss, rho = [rho(s), rho'(s), rho''(s)] */
+            const double SquaredNorm = Error.squaredNorm();
+            double Rho[3] = {SquaredNorm, 1.0, 0.0};
+            if (Residual.LossFunction != nullptr)
+            {
+              Residual.LossFunction->Evaluate(SquaredNorm, Rho);
+            }
+            Cost += 0.5 * Rho[0];
+
+            if (!ComputeDerivatives || Rho[1] <= 0.0)
+            {
+              continue;
+            }
+
+            /** Triggs correction: J' = sqrt(rho') * (I - alpha * r * r^T / |r|^2) * J and r' = sqrt(rho') / (1 - alpha) * r */
+            const double SqrtRho1 = std::sqrt(Rho[1]);
+            double Alpha = 0.0;
+            if (SquaredNorm > 0.0 && Rho[2] > 0.0)
+            {
+              Alpha = 1.0 - std::sqrt(1.0 + 2.0 * SquaredNorm * Rho[2] / Rho[1]);
+            }
+            const double AlphaSquaredNorm = (SquaredNorm > 0.0) ? Alpha / SquaredNorm : 0.0;
+            const Vector ErrorScaled = (SqrtRho1 / (1.0 - Alpha)) * Error;
+
+            LocalJacobians.resize(BlockNumber);
+            for (size_t n = 0; n < BlockNumber; n++)
+            {
+              const DenseParameter &Parameter = Parameters_.at(Residual.Parameters.at(n));
+              if (Parameter.Offset < 0)
+              {
+                continue;
+              }
+
+              /** map into the tangent space */
+              if (Parameter.Parameterization != nullptr)
+              {
+                RowMajorMatrix Plus(Parameter.GlobalSize, Parameter.LocalSize);
+                Parameter.Parameterization->ComputeJacobian(Parameter.State, Plus.data());
+                LocalJacobians.at(n) = Jacobians.at(n) * Plus;
+              }
+              else
+              {
+                LocalJacobians.at(n) = Jacobians.at(n);
+              }
+
+              LocalJacobians.at(n) = SqrtRho1 * (LocalJacobians.at(n) - AlphaSquaredNorm * Error * (Error.transpose() * LocalJacobians.at(n)));
+              G.segment(Parameter.Offset, Parameter.LocalSize) += LocalJacobians.at(n).transpose() * ErrorScaled;
+            }
+
+            for (size_t n = 0; n < BlockNumber; n++)
+            {
+              const DenseParameter &ParameterN = Parameters_.at(Residual.Parameters.at(n));
+              for (size_t m = 0; m < BlockNumber && ParameterN.Offset >= 0; m++)
+              {
+                const DenseParameter &ParameterM = Parameters_.at(Residual.Parameters.at(m));
+                if (ParameterM.Offset >= 0)
+                {
+                  H.block(ParameterN.Offset, ParameterM.Offset, ParameterN.LocalSize, ParameterM.LocalSize) +=
+                      LocalJacobians.at(n).transpose() * LocalJacobians.at(m);
+                }
+              }
+            }
+          }
+          return true;
+        }
+
+        void getState(std::vector<Vector> &State) const
+        {
+          State.resize(Parameters_.size());
+          for (size_t n = 0; n < Parameters_.size(); n++)
+          {
+            State.at(n) = VectorRef<double, Dynamic>(Parameters_.at(n).State, Parameters_.at(n).GlobalSize);
+          }
+        }
+
+        void setState(const std::vector<Vector> &State) const
+        {
+          for (size_t n = 0; n < Parameters_.size(); n++)
+          {
+            VectorRef<double, Dynamic>(Parameters_.at(n).State, Parameters_.at(n).GlobalSize) = State.at(n);
+          }
+        }
+
+        /** coordinates at a bound with a gradient that points outside are kept fixed for the next step */
+        void fixActiveBounds(Matrix &H, Vector &G) const
+        {
+          for (size_t n = 0; n < Parameters_.size(); n++)
+          {
+            const DenseParameter &Parameter = Parameters_.at(n);
+            if (Parameter.Offset < 0 || Parameter.Parameterization != nullptr)
+            {
+              continue;
+            }
+
+            for (int m = 0; m < Parameter.GlobalSize; m++)
+            {
+              const int Index = Parameter.Offset + m;
+              const double Value = Parameter.State[m];
+              if ((Value <= Lower_.at(n)(m) && G(Index) > 0.0) || (Value >= Upper_.at(n)(m) && G(Index) < 0.0))
+              {
+                H.row(Index).setZero();
+                H.col(Index).setZero();
+                H(Index, Index) = 1.0;
+                G(Index) = 0.0;
+              }
+            }
+          }
+        }
+
+        /** x = x [+] dx, projected onto the bounds */
+        bool plus(const std::vector<Vector> &State, const Vector &Step) const
+        {
+          for (size_t n = 0; n < Parameters_.size(); n++)
+          {
+            const DenseParameter &Parameter = Parameters_.at(n);
+            if (Parameter.Offset < 0)
+            {
+              continue;
+            }
+
+            VectorRef<double, Dynamic> NewState(Parameter.State, Parameter.GlobalSize);
+            if (Parameter.Parameterization != nullptr)
+            {
+              if (!Parameter.Parameterization->Plus(State.at(n).data(), Step.data() + Parameter.Offset, Parameter.State))
+              {
+                return false;
+              }
+            }
+            else
+            {
+              NewState = State.at(n) + Step.segment(Parameter.Offset, Parameter.LocalSize);
+            }
+            NewState = NewState.cwiseMax(Lower_.at(n)).cwiseMin(Upper_.at(n));
+          }
+          return true;
+        }
+
+      private:
+        /** cost including the robust loss, without derivatives */
+        static bool evaluateCost_(const DenseResidual &Residual, double &Cost)
+        {
+          Vector Error(Residual.CostFunction->num_residuals());
+          if (!Residual.CostFunction->Evaluate(Residual.States.data(), Error.data(), nullptr))
+          {
+            return false;
+          }
+
+          const double SquaredNorm = Error.squaredNorm();
+          double Rho[3] = {SquaredNorm, 1.0, 0.0};
+          if (Residual.LossFunction != nullptr)
+          {
+            Residual.LossFunction->Evaluate(SquaredNorm, Rho);
+          }
+          Cost = 0.5 * Rho[0];
+          return true;
+        }
+
+        std::vector<DenseParameter> Parameters_;
+        std::vector<Vector> Lower_;
+        std::vector<Vector> Upper_;
+        std::vector<DenseResidual> Residuals_;
+        int Size_ = 0;
+        double FixedCost_ = 0.0;
+    };
+  }
+
+  bool SolveDense(const ceres::Solver::Options &Options, ceres::Problem &Problem, ceres::Solver::Summary &Summary)
+  {
+    Timer SolveTimer;
+    Summary = ceres::Solver::Summary();
+    Summary.minimizer_type = ceres::TRUST_REGION;
+    Summary.linear_solver_type_used = ceres::DENSE_NORMAL_CHOLESKY;
+    Summary.num_successful_steps = 0;
+    Summary.num_unsuccessful_steps = 0;
+    Summary.termination_type = ceres::NO_CONVERGENCE;
+
+    const DenseProblem Dense(Problem);
+    const int Size = Dense.getSize();
+
+    double Cost;
+    Matrix H;
+    Vector G;
+    if (!Dense.evaluate(Cost, H, G, true))
+    {
+      Summary.termination_type = ceres::FAILURE;
+      Summary.message = "Initial evaluation failed.";
+      Summary.total_time_in_seconds = SolveTimer.getSeconds();
+      return false;
+    }
+    Summary.fixed_cost = Dense.getFixedCost();
+    Summary.initial_cost = Cost + Summary.fixed_cost;
+
+    std::vector<Vector> State, NewState;
+    Dense.getState(State);
+
+    double Radius = Options.initial_trust_region_radius;
+    double DecreaseFactor = 2.0;
+    Summary.message = "Maximum number of iterations reached.";
+
+    for (int Iteration = 0; Iteration < Options.max_num_iterations && Size > 0; Iteration++)
+    {
+      Dense.fixActiveBounds(H, G);
+      if (G.lpNorm<Eigen::Infinity>() <= Options.gradient_tolerance)
+      {
+        Summary.termination_type = ceres::CONVERGENCE;
+        Summary.message = "Gradient tolerance reached.";
+        break;
+      }
+      if (SolveTimer.getSeconds() > Options.max_solver_time_in_seconds)
+      {
+        Summary.message = "Maximum solver time reached.";
+        break;
+      }
+
+      /** (H + D / radius) * dx = -g, with the clamped diagonal of H as in ceres */
+      Matrix Damped = H;
+      Damped.diagonal() += H.diagonal().cwiseMax(Options.min_lm_diagonal).cwiseMin(Options.max_lm_diagonal) / Radius;
+      const Vector Step = Damped.ldlt().solve(-G);
+      const double ModelDecrease = -(G.dot(Step) + 0.5 * Step.dot(H * Step));
+
+      double NewCost = 0.0;
+      Matrix NewH;
+      Vector NewG;
+      const bool IsValid = Step.allFinite() && ModelDecrease > 0.0 && Dense.plus(State, Step) && Dense.evaluate(NewCost, NewH, NewG, true);
+      const double Quality = IsValid ? (Cost - NewCost) / ModelDecrease : 0.0;
+
+      ceres::IterationSummary IterationInfo;
+      IterationInfo.iteration = Iteration + 1;
+      IterationInfo.step_is_valid = IsValid;
+      IterationInfo.step_is_nonmonotonic = false;
+      IterationInfo.step_is_successful = (IsValid && Quality > Options.min_relative_decrease);
+
+      if (IterationInfo.step_is_successful)
+      {
+        Summary.num_successful_steps++;
+        const double CostChange = Cost - NewCost;
+        Dense.getState(NewState);
+
+        Radius = std::min(Options.max_trust_region_radius, Radius / std::max(1.0 / 3.0, 1.0 - std::pow(2.0 * Quality - 1.0, 3)));
+        DecreaseFactor = 2.0;
+
+        std::swap(State, NewState);
+        Cost = NewCost;
+        H = std::move(NewH);
+        G = std::move(NewG);
+
+        IterationInfo.cost = Cost + Summary.fixed_cost;
+        IterationInfo.cost_change = CostChange;
+        IterationInfo.trust_region_radius = Radius;
+        Summary.iterations.push_back(IterationInfo);
+
+        if (CostChange <= Options.function_tolerance * Cost)
+        {
+          Summary.termination_type = ceres::CONVERGENCE;
+          Summary.message = "Function tolerance reached.";
+          break;
+        }
+
+        double StateNorm = 0.0;
+        for (const Vector &Block : State)
+        {
+          StateNorm += Block.squaredNorm();
+        }
+        if (Step.norm() <= (std::sqrt(StateNorm) + Options.parameter_tolerance) * Options.parameter_tolerance)
+        {
+          Summary.termination_type = ceres::CONVERGENCE;
+          Summary.message = "Parameter tolerance reached.";
+          break;
+        }
+      }
+      else
+      {
+        Summary.num_unsuccessful_steps++;
+        Dense.setState(State);
+
+        Radius /= DecreaseFactor;
+        DecreaseFactor *= 2.0;
+
+        IterationInfo.cost = Cost + Summary.fixed_cost;
+        IterationInfo.cost_change = 0.0;
+        IterationInfo.trust_region_radius = Radius;
+        Summary.iterations.push_back(IterationInfo);
+
+        if (Radius < Options.min_trust_region_radius)
+        {
+          Summary.termination_type = ceres::CONVERGENCE;
+          Summary.message = "Minimum trust region radius reached.";
+          break;
+        }
+      }
+    }
+
+    if (Size == 0)
+    {
+      Summary.termination_type = ceres::CONVERGENCE;
+      Summary.message = "No parameters to optimize.";
+    }
+
+    Summary.final_cost = Cost + Summary.fixed_cost;
+    Summary.num_residual_blocks = Problem.NumResidualBlocks();
+    Summary.num_residual_blocks_reduced = Dense.countActiveResiduals();
+    Summary.num_parameter_blocks = Problem.NumParameterBlocks();
+    Summary.num_effective_parameters = Size;
+    Summary.total_time_in_seconds = SolveTimer.getSeconds();
+    Summary.minimizer_time_in_seconds = Summary.total_time_in_seconds;
+    return true;
+  }
+}
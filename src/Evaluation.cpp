@@ -0,0 +1,311 @@
+/***************************************************************************
+ * libRSF - A Robust Sensor Fusion Library
+ *
+ * Copyright (C) 2018 Chair of Automation Technology / TU Chemnitz
+ * For more information see https://www.tu-chemnitz.de/etit/proaut/libRSF
+ *
+ * libRSF is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libRSF is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with libRSF.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Tim Pfeifer (tim.pfeifer@etit.tu-chemnitz.de)
+ ***************************************************************************/
+
+#include "Evaluation.h"
+#include "FileAccess.h"
+#include "Messages.h"
+#include "Statistics.h"
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include <sys/stat.h>
+
+namespace libRSF
+{
+  namespace
+  {
+    template <typename SetType, typename KeyType>
+    Trajectory ExtractTrajectoryGeneric(const SetType &Set, const KeyType &Type)
+    {
+      Trajectory Result;
+      if (!Set.checkID(Type))
+      {
+        return Result;
+      }
+
+      const auto Range = Set.range(Type, std::numeric_limits<double>::lowest(), std::numeric_limits<double>::max());
+      Index Dim = 0;
+      for (auto It = Range.begin(); It != Range.end(); ++It)
+      {
+        if (Result.Time.empty() || It.getTime() != Result.Time.back())
+        {
+          Result.Time.push_back(It.getTime());
+          Dim = std::max(Dim, It->getMean().size());
+        }
+      }
+
+      Result.Position.resize(static_cast<Index>(Result.Time.size()), Dim);
+      Index Row = -1;
+      double TimeLast = std::numeric_limits<double>::quiet_NaN();
+      for (auto It = Range.begin(); It != Range.end(); ++It)
+      {
+        if (It.getTime() != TimeLast)
+        {
+          TimeLast = It.getTime();
+          Row++;
+          const Vector Mean = It->getMean();
+          Result.Position.row(Row).setZero();
+          Result.Position.row(Row).head(Mean.size()) = Mean.transpose();
+        }
+      }
+      return Result;
+    }
+
+    /** nearest-rank percentile, the values are reordered */
+    double PercentileInPlace(std::vector<double> &Values, const double Fraction)
+    {
+      const size_t Rank = static_cast<size_t>(std::ceil(Fraction * static_cast<double>(Values.size())));
+      const size_t n = std::min(Values.size() - 1, std::max<size_t>(Rank, 1) - 1);
+      std::nth_element(Values.begin(), Values.begin() + static_cast<std::ptrdiff_t>(n), Values.end());
+      return Values.at(n);
+    }
+
+    double RootMeanSquare(const std::vector<double> &Values)
+    {
+      double Sum = 0.0;
+      for (const double Value : Values)
+      {
+        Sum += Value * Value;
+      }
+      return std::sqrt(Sum / static_cast<double>(Values.size()));
+    }
+
+    bool GetModificationTime(const std::string &Filename, double &Time)
+    {
+      struct stat FileStat {};
+      if (stat(Filename.c_str(), &FileStat) != 0)
+      {
+        return false;
+      }
+      Time = static_cast<double>(FileStat.st_mtime);
+      return true;
+    }
+  }
+
+  Trajectory ExtractTrajectory(const SensorDataSet &Set, const DataType Type)
+  {
+    return ExtractTrajectoryGeneric(Set, Type);
+  }
+
+  Trajectory ExtractTrajectory(const StateDataSet &Set, const std::string &Type)
+  {
+    return ExtractTrajectoryGeneric(Set, Type);
+  }
+
+  TrajectoryError EvaluateTrajectory(const Trajectory &GT,
+                                     const Trajectory &Estimate,
+                                     const EvaluationConfig &Config)
+  {
+    TrajectoryError Error;
+    if (GT.empty() || Estimate.empty())
+    {
+      return Error;
+    }
+    if (GT.Position.cols() != Estimate.Position.cols())
+    {
+      PRINT_ERROR("Dimension of GT and estimate are not equal: ", GT.Position.cols(), " vs. ", Estimate.Position.cols());
+      return Error;
+    }
+
+    /** merge-join: the ground truth below the current estimate only moves forward */
+    const size_t SizeGT = GT.Time.size();
+    std::vector<double> Distances;
+    std::vector<size_t> MatchedEstimate;
+    std::vector<size_t> MatchedGT;
+    Distances.reserve(Estimate.Time.size());
+    MatchedEstimate.reserve(Estimate.Time.size());
+    MatchedGT.reserve(Estimate.Time.size());
+
+    size_t Below = 0;
+    for (size_t n = 0; n < Estimate.Time.size(); ++n)
+    {
+      const double Time = Estimate.Time.at(n);
+      while (Below + 1 < SizeGT && GT.Time.at(Below + 1) <= Time)
+      {
+        Below++;
+      }
+
+      /** same choice as DataSet::getTimeCloseTo() */
+      size_t Close = Below;
+      if (GT.Time.at(Below) < Time && Below + 1 < SizeGT && !(Time - GT.Time.at(Below) < GT.Time.at(Below + 1) - Time))
+      {
+        Close = Below + 1;
+      }
+
+      if (std::abs(GT.Time.at(Close) - Time) > Config.MaxTimeDifference)
+      {
+        continue;
+      }
+
+      Distances.push_back((Estimate.Position.row(static_cast<Index>(n)) - GT.Position.row(static_cast<Index>(Close))).norm());
+      MatchedEstimate.push_back(n);
+      MatchedGT.push_back(Close);
+    }
+
+    Error.Matched = static_cast<int>(Distances.size());
+    if (Distances.empty())
+    {
+      return Error;
+    }
+
+    /** absolute errors */
+    Error.ATE = RootMeanSquare(Distances);
+    Error.Mean = 0.0;
+    Error.Max = 0.0;
+    for (const double Distance : Distances)
+    {
+      Error.Mean += Distance;
+      Error.Max = std::max(Error.Max, Distance);
+    }
+    Error.Mean /= static_cast<double>(Distances.size());
+
+    std::vector<double> Sorted = Distances;
+    Error.Median = MedianInPlace(Sorted.data(), Sorted.size());
+    Error.Percentile90 = PercentileInPlace(Sorted, 0.90);
+    Error.Percentile95 = PercentileInPlace(Sorted, 0.95);
+    Error.Percentile99 = PercentileInPlace(Sorted, 0.99);
+
+    /** relative errors, the end of each pair only moves forward as well */
+    std::vector<double> Drifts;
+    Drifts.reserve(MatchedEstimate.size());
+    size_t End = 0;
+    for (size_t Begin = 0; Begin < MatchedEstimate.size(); ++Begin)
+    {
+      const double TimeBegin = Estimate.Time.at(MatchedEstimate.at(Begin));
+      End = std::max(End, Begin + 1);
+      while (End < MatchedEstimate.size() && Estimate.Time.at(MatchedEstimate.at(End)) < TimeBegin + Config.RPEDelta)
+      {
+        End++;
+      }
+      if (End >= MatchedEstimate.size())
+      {
+        break;
+      }
+
+      const Vector DeltaEstimate = Estimate.Position.row(static_cast<Index>(MatchedEstimate.at(End)))
+                                   - Estimate.Position.row(static_cast<Index>(MatchedEstimate.at(Begin)));
+      const Vector DeltaGT = GT.Position.row(static_cast<Index>(MatchedGT.at(End)))
+                             - GT.Position.row(static_cast<Index>(MatchedGT.at(Begin)));
+      Drifts.push_back((DeltaEstimate - DeltaGT).norm());
+    }
+
+    Error.RPEPairs = static_cast<int>(Drifts.size());
+    if (!Drifts.empty())
+    {
+      Error.RPE = RootMeanSquare(Drifts);
+    }
+
+    return Error;
+  }
+
+  TrajectoryError EvaluateTrajectory(const SensorDataSet &GT,
+                                     const DataType TypeGT,
+                                     const StateDataSet &Estimate,
+                                     const std::string &TypeEstimate,
+                                     const EvaluationConfig &Config)
+  {
+    return EvaluateTrajectory(ExtractTrajectory(GT, TypeGT), ExtractTrajectory(Estimate, TypeEstimate), Config);
+  }
+
+  std::vector<TrajectoryError> EvaluateTrajectories(const SensorDataSet &GT,
+                                                    const DataType TypeGT,
+                                                    const std::vector<const StateDataSet*> &Estimates,
+                                                    const std::string &TypeEstimate,
+                                                    const EvaluationConfig &Config,
+                                                    const int ThreadNumber)
+  {
+    const Trajectory TrajectoryGT = ExtractTrajectory(GT, TypeGT);
+
+    std::vector<TrajectoryError> Errors(Estimates.size());
+    GetThreadPool().parallelFor(Estimates.size(), [&](const size_t n)
+    {
+      if (Estimates.at(n) != nullptr)
+      {
+        Errors.at(n) = EvaluateTrajectory(TrajectoryGT, ExtractTrajectory(*Estimates.at(n), TypeEstimate), Config);
+      }
+    }, ThreadNumber);
+
+    return Errors;
+  }
+
+  std::vector<TrajectoryError> EvaluateResultFiles(const SensorDataSet &GT,
+                                                   const DataType TypeGT,
+                                                   const std::vector<std::string> &ResultFiles,
+                                                   const std::string &TypeEstimate,
+                                                   const EvaluationConfig &Config,
+                                                   const int ThreadNumber)
+  {
+    const Trajectory TrajectoryGT = ExtractTrajectory(GT, TypeGT);
+
+    /** only one result is in memory per thread */
+    std::vector<TrajectoryError> Errors(ResultFiles.size());
+    GetThreadPool().parallelFor(ResultFiles.size(), [&](const size_t n)
+    {
+      StateDataSet Result;
+      if (!ReadResultFromBinaryFile(ResultFiles.at(n), Result))
+      {
+        PRINT_WARNING("Could not read result file: ", ResultFiles.at(n));
+        return;
+      }
+      Errors.at(n) = EvaluateTrajectory(TrajectoryGT, ExtractTrajectory(Result, TypeEstimate), Config);
+    }, ThreadNumber);
+
+    return Errors;
+  }
+
+  bool ReadGroundTruth(const std::string &Filename, SensorDataSet &GT, const bool CacheBinary)
+  {
+    if (IsBinaryDataFile(Filename))
+    {
+      return ReadDataFromBinaryFile(Filename, GT);
+    }
+
+    double TimeText = 0.0;
+    if (!GetModificationTime(Filename, TimeText))
+    {
+      PRINT_ERROR("There is no ground truth file with the name ", Filename);
+      return false;
+    }
+
+    /** a cache that is not older than the text is valid */
+    const std::string Cache = Filename + ".bin";
+    double TimeCache = 0.0;
+    if (CacheBinary && GetModificationTime(Cache, TimeCache) && TimeCache >= TimeText && IsBinaryDataFile(Cache))
+    {
+      GT.clear();
+      if (ReadDataFromBinaryFile(Cache, GT))
+      {
+        return true;
+      }
+    }
+
+    GT.clear();
+    ReadDataFromFileParallel(Filename, GT);
+    if (CacheBinary && !WriteDataToBinaryFile(Cache, GT))
+    {
+      PRINT_WARNING("Could not write binary ground truth: ", Cache);
+    }
+    return true;
+  }
+}
@@ -22,10 +22,18 @@
 
 #include "FactorGraph.h"
 
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iomanip>
+#include <limits>
+#include <numeric>
+#include <unordered_map>
+#include <unordered_set>
 
 namespace libRSF
 {
-  void StateList::add(const string& Type, double Timestamp, int Number)
+  void StateList::add(const StateKey &Type, double Timestamp, int Number)
   {
     this->add(StateID(Type, Timestamp, Number));
   }
@@ -46,144 +54,1645 @@ namespace libRSF
         MarginalizationDuration_(0.0)
   {}
 
+  /** stops the optimization at a fixed point in time and keeps the current solution */
+  class DeadlineCallback : public ceres::IterationCallback
+  {
+    public:
+      explicit DeadlineCallback(const Deadline &Limit) : Limit_(Limit) {}
+      ~DeadlineCallback() override = default;
+
+      ceres::CallbackReturnType operator()(const ceres::IterationSummary &Summary) override
+      {
+        if (Limit_.hasPassed())
+        {
+          HasStopped_ = true;
+          return ceres::SOLVER_TERMINATE_SUCCESSFULLY;
+        }
+        return ceres::SOLVER_CONTINUE;
+      }
+
+      [[nodiscard]] bool hasStopped() const
+      {
+        return HasStopped_;
+      }
+
+    private:
+      const Deadline &Limit_;
+      bool HasStopped_ = false;
+  };
+
+  /** the solver writes the states through their mean pointers, which the cache of raw errors cannot detect */
+  class ResidualCacheCallback : public ceres::IterationCallback
+  {
+    public:
+      explicit ResidualCacheCallback(ResidualCache &Cache) : Cache_(Cache) {}
+      ~ResidualCacheCallback() override = default;
+
+      ceres::CallbackReturnType operator()(const ceres::IterationSummary &Summary) override
+      {
+        Cache_.invalidate();
+        return ceres::SOLVER_CONTINUE;
+      }
+
+    private:
+      ResidualCache &Cache_;
+  };
+
   void FactorGraph::solve()
   {
-    /** check if config is valid */
-    std::string OptionsError;
-    if (!SolverOptions_.IsValid(&OptionsError))
+    const TraceScope_ Trace(*this, TraceOperation::Solve, true);
+    if (Trace.Writer != nullptr)
+    {
+      WriteSolverOptions(*Trace.Writer, SolverOptions_);
+      Trace.Writer->write(static_cast<uint8_t>(0));
+      Trace.Writer->write(0.0);
+    }
+
+    this->solve_(SolverOptions_);
+  }
+
+  void FactorGraph::solve_(const ceres::Solver::Options &Options)
+  {
+    LIBRSF_TRACE_SCOPE("solve");
+
+    /** the states may have been moved since the last evaluation */
+    RawErrorCache_.invalidate();
+
+    /** move the linearization point of IMU factors with outdated biases */
+    this->relinearizeIMUPreintegration_();
+
+    /** check if config is valid */
+    std::string OptionsError;
+    if (!Options.IsValid(&OptionsError))
+    {
+      PRINT_ERROR("The given solver options are wrong: ", OptionsError);
+    }
+    else
+    {
+      /** the last radius is a good guess for the next window, as long as it is in the valid range */
+      const ceres::Solver::Options *CurrentOptions = &Options;
+      ceres::Solver::Options WarmOptions;
+      if (WarmStart_ && WarmStartRadius_ > 0.0 && Options.minimizer_type == ceres::TRUST_REGION)
+      {
+        WarmOptions = *CurrentOptions;
+        WarmOptions.initial_trust_region_radius = std::clamp(WarmStartRadius_,
+                                                             100.0 * Options.min_trust_region_radius,
+                                                             Options.max_trust_region_radius);
+        CurrentOptions = &WarmOptions;
+      }
+
+      /** a user-defined ordering has precedence */
+      ceres::Solver::Options OrderedOptions;
+      auto Ordering = std::make_shared<ceres::ParameterBlockOrdering>();
+      if (LandmarksFirst_ && CurrentOptions->linear_solver_ordering == nullptr && this->getEliminationOrdering_(*Ordering))
+      {
+        OrderedOptions = *CurrentOptions;
+        OrderedOptions.linear_solver_ordering = Ordering;
+        if (OrderedOptions.linear_solver_type == ceres::SPARSE_NORMAL_CHOLESKY)
+        {
+          OrderedOptions.linear_solver_type = ceres::SPARSE_SCHUR;
+        }
+        CurrentOptions = &OrderedOptions;
+      }
+      else if (TimeChainOrdering_
+               && CurrentOptions->linear_solver_type == ceres::ITERATIVE_SCHUR
+               && CurrentOptions->linear_solver_ordering == nullptr
+               && this->getTimeChainOrdering_(*Ordering))
+      {
+        OrderedOptions = *CurrentOptions;
+        OrderedOptions.linear_solver_ordering = Ordering;
+        CurrentOptions = &OrderedOptions;
+      }
+
+      /** call ceres to solve the optimization problem, tiny LM problems are solved directly */
+      if (DenseSolverThreshold_ > 0
+          && Graph_.NumParameters() <= DenseSolverThreshold_
+          && CurrentOptions->minimizer_type == ceres::TRUST_REGION
+          && CurrentOptions->trust_region_strategy_type == ceres::LEVENBERG_MARQUARDT
+          && CurrentOptions->callbacks.empty())
+      {
+        SolveDense(*CurrentOptions, Graph_, Report_);
+      }
+      else
+      {
+        /** the benchmarked backend replaces the configured sparse library */
+        ceres::Solver::Options BackendOptions;
+        if (BackendSelection_ && this->selectLinearBackend_(*CurrentOptions, BackendOptions))
+        {
+          CurrentOptions = &BackendOptions;
+        }
+
+        /** callbacks that see the intermediate states must not get cached errors of previous iterations */
+        ResidualCacheCallback CacheCallback(RawErrorCache_);
+        ceres::Solver::Options CallbackOptions;
+        if (CurrentOptions->update_state_every_iteration && !CurrentOptions->callbacks.empty())
+        {
+          CallbackOptions = *CurrentOptions;
+          CallbackOptions.callbacks.insert(CallbackOptions.callbacks.begin(), &CacheCallback);
+          CurrentOptions = &CallbackOptions;
+        }
+        ceres::Solve(*CurrentOptions, &Graph_, &Report_);
+      }
+      SolverDuration_ += Report_.total_time_in_seconds;
+      SolverIterations_ +=
+          Report_.num_successful_steps + Report_.num_unsuccessful_steps;
+
+      if (IterationTelemetry_)
+      {
+        for (const ceres::IterationSummary &Iteration : Report_.iterations)
+        {
+          SolverIteration &Entry = Iterations_.emplace_back();
+          Entry.Solve = SolveCounter_;
+          Entry.Iteration = Iteration.iteration;
+          Entry.Cost = Iteration.cost;
+          Entry.GradientNorm = Iteration.gradient_norm;
+          Entry.StepNorm = Iteration.step_norm;
+          Entry.TrustRegionRadius = Iteration.trust_region_radius;
+          Entry.StepSuccessful = Iteration.step_is_successful;
+          Entry.LinearSolverIterations = Iteration.linear_solver_iterations;
+          Entry.LinearSolverTime = Iteration.step_solver_time_in_seconds;
+          Entry.EvaluationTime = std::max(0.0, Iteration.iteration_time_in_seconds - Iteration.step_solver_time_in_seconds);
+        }
+      }
+      SolveCounter_++;
+
+      if (Metrics_ != nullptr)
+      {
+        Metrics_->Solver.record(Report_.total_time_in_seconds);
+        Metrics_->Solves.add();
+        Metrics_->Iterations.add(static_cast<uint64_t>(Report_.num_successful_steps + Report_.num_unsuccessful_steps));
+        Metrics_->States.set(Graph_.NumParameterBlocks());
+        Metrics_->Factors.set(Graph_.NumResidualBlocks());
+      }
+
+      /** all modifications are part of the current solution now */
+      Structure_.resetChangedStates();
+
+      /** the linearization point has changed */
+      CovarianceCache_.reset();
+      RawErrorCache_.invalidate();
+
+      /** store the final trust region for the next solve */
+      if (WarmStart_ && Report_.IsSolutionUsable() && !Report_.iterations.empty())
+      {
+        WarmStartRadius_ = Report_.iterations.back().trust_region_radius;
+      }
+
+      this->publishStates();
+    }
+  }
+
+  void FactorGraph::setStatePublisher(std::shared_ptr<StatePublisher> Publisher)
+  {
+    Publisher_ = std::move(Publisher);
+  }
+
+  void FactorGraph::setMetrics(std::shared_ptr<GraphMetrics> Metrics)
+  {
+    Metrics_ = std::move(Metrics);
+  }
+
+  void FactorGraph::recordCovariance_(const double Duration)
+  {
+    CovarianceDuration_ += Duration;
+    if (Metrics_ != nullptr)
+    {
+      Metrics_->Covariance.record(Duration);
+    }
+  }
+
+  void FactorGraph::publishStates() const
+  {
+    if (Publisher_ != nullptr)
+    {
+      Publisher_->publish(StateData_);
+    }
+  }
+
+  void FactorGraph::setWarmStart(const bool Enable)
+  {
+    const TraceScope_ Trace(*this, TraceOperation::SetWarmStart);
+    if (Trace.Writer != nullptr)
+    {
+      Trace.Writer->write(static_cast<uint8_t>(Enable));
+    }
+
+    WarmStart_ = Enable;
+    WarmStartRadius_ = 0.0;
+  }
+
+  void FactorGraph::setLandmarksFirst(const bool Enable)
+  {
+    const TraceScope_ Trace(*this, TraceOperation::SetLandmarksFirst);
+    if (Trace.Writer != nullptr)
+    {
+      Trace.Writer->write(static_cast<uint8_t>(Enable));
+    }
+
+    LandmarksFirst_ = Enable;
+  }
+
+  void FactorGraph::setWindowExempt(const StateKey &Name, const bool Exempt)
+  {
+    const TraceScope_ Trace(*this, TraceOperation::SetWindowExempt);
+    if (Trace.Writer != nullptr)
+    {
+      Trace.Writer->writeString(Name.getName());
+      Trace.Writer->write(static_cast<uint8_t>(Exempt));
+    }
+
+    if (Exempt)
+    {
+      WindowExempt_.insert(Name);
+    }
+    else
+    {
+      WindowExempt_.erase(Name);
+    }
+  }
+
+  bool FactorGraph::isWindowExempt(const StateKey &Name) const
+  {
+    return WindowExempt_.count(Name) > 0;
+  }
+
+  bool FactorGraph::getTimeFirstInWindow(double &Timestamp) const
+  {
+    if (WindowExempt_.empty())
+    {
+      return StateData_.getTimeFirstOverall(Timestamp);
+    }
+    return StateData_.getTimeFirstOverall(Timestamp, [this](const StateKey &Name){return !this->isWindowExempt(Name);});
+  }
+
+  void FactorGraph::setTimeChainOrdering(const bool Enable)
+  {
+    const TraceScope_ Trace(*this, TraceOperation::SetTimeChainOrdering);
+    if (Trace.Writer != nullptr)
+    {
+      Trace.Writer->write(static_cast<uint8_t>(Enable));
+    }
+
+    TimeChainOrdering_ = Enable;
+  }
+
+  void FactorGraph::setDenseSolverThreshold(const int MaxParameters)
+  {
+    const TraceScope_ Trace(*this, TraceOperation::SetDenseSolverThreshold);
+    if (Trace.Writer != nullptr)
+    {
+      Trace.Writer->write(static_cast<int32_t>(MaxParameters));
+    }
+
+    DenseSolverThreshold_ = std::max(0, MaxParameters);
+  }
+
+  bool FactorGraph::getEliminationOrdering_(ceres::ParameterBlockOrdering &Ordering) const
+  {
+    std::vector<double*> Blocks;
+    Graph_.GetParameterBlocks(&Blocks);
+
+    std::unordered_set<double*> Landmarks;
+    for (double* const Block : Blocks)
+    {
+      if (Structure_.isLandmark(Block))
+      {
+        Landmarks.emplace(Block);
+      }
+    }
+
+    if (Landmarks.empty() || Landmarks.size() == Blocks.size())
+    {
+      return false;
+    }
+
+    /** group 0 has to be an independent set, so only the first landmark of a factor is eliminated */
+    std::vector<ceres::ResidualBlockId> Residuals;
+    Graph_.GetResidualBlocks(&Residuals);
+    std::vector<double*> FactorBlocks;
+    for (const ceres::ResidualBlockId Residual : Residuals)
+    {
+      Graph_.GetParameterBlocksForResidualBlock(Residual, &FactorBlocks);
+
+      bool HasLandmark = false;
+      for (double* const Block : FactorBlocks)
+      {
+        if (Landmarks.count(Block) > 0)
+        {
+          if (HasLandmark)
+          {
+            Landmarks.erase(Block);
+          }
+          HasLandmark = true;
+        }
+      }
+    }
+
+    Ordering.Clear();
+    for (double* const Block : Blocks)
+    {
+      Ordering.AddElementToGroup(Block, (Landmarks.count(Block) > 0) ? 0 : 1);
+    }
+    return true;
+  }
+
+  bool FactorGraph::getTimeChainOrdering_(ceres::ParameterBlockOrdering &Ordering) const
+  {
+    std::vector<double*> Blocks;
+    Graph_.GetParameterBlocks(&Blocks);
+
+    /** number the epochs, static states can not be part of the chain */
+    std::vector<double> Epochs;
+    std::unordered_map<double*, double> Timestamps;
+    Timestamps.reserve(Blocks.size());
+    for (double* const Block : Blocks)
+    {
+      double Timestamp;
+      if (!Structure_.isLandmark(Block) && Structure_.getStateTimestamp(Block, Timestamp))
+      {
+        Timestamps.emplace(Block, Timestamp);
+        Epochs.push_back(Timestamp);
+      }
+    }
+    std::sort(Epochs.begin(), Epochs.end());
+    Epochs.erase(std::unique(Epochs.begin(), Epochs.end()), Epochs.end());
+
+    if (Epochs.size() < 3)
+    {
+      return false;
+    }
+
+    std::unordered_set<double*> Eliminated;
+    for (const auto &[Block, Timestamp] : Timestamps)
+    {
+      const auto Epoch = std::lower_bound(Epochs.begin(), Epochs.end(), Timestamp) - Epochs.begin();
+      if (Epoch % 2 == 1)
+      {
+        Eliminated.emplace(Block);
+      }
+    }
+
+    /** group 0 has to be an independent set, so states of the same epoch that share a factor are eliminated only once */
+    std::vector<ceres::ResidualBlockId> Residuals;
+    Graph_.GetResidualBlocks(&Residuals);
+    std::vector<double*> FactorBlocks;
+    for (const ceres::ResidualBlockId Residual : Residuals)
+    {
+      Graph_.GetParameterBlocksForResidualBlock(Residual, &FactorBlocks);
+
+      bool HasEliminated = false;
+      for (double* const Block : FactorBlocks)
+      {
+        if (Eliminated.count(Block) > 0)
+        {
+          if (HasEliminated)
+          {
+            Eliminated.erase(Block);
+          }
+          HasEliminated = true;
+        }
+      }
+    }
+
+    if (Eliminated.empty())
+    {
+      return false;
+    }
+
+    Ordering.Clear();
+    for (double* const Block : Blocks)
+    {
+      Ordering.AddElementToGroup(Block, (Eliminated.count(Block) > 0) ? 0 : 1);
+    }
+    return true;
+  }
+
+  void FactorGraph::setSatelliteStore(std::shared_ptr<SatelliteStore> Satellites)
+  {
+    if (Satellites == nullptr)
+    {
+      PRINT_ERROR("Satellite store is missing!");
+      return;
+    }
+    Satellites_ = std::move(Satellites);
+  }
+
+  std::shared_ptr<SatelliteStore> FactorGraph::getSatelliteStore() const
+  {
+    return Satellites_;
+  }
+
+  void FactorGraph::solve(ceres::Solver::Options Options)
+  {
+    const TraceScope_ Trace(*this, TraceOperation::Solve, true);
+    if (Trace.Writer != nullptr)
+    {
+      WriteSolverOptions(*Trace.Writer, Options);
+      Trace.Writer->write(static_cast<uint8_t>(0));
+      Trace.Writer->write(0.0);
+    }
+
+    SolverOptions_ = Options;
+    this->solve();
+  }
+
+  bool FactorGraph::solve(ceres::Solver::Options Options, const Deadline &Limit)
+  {
+    const TraceScope_ Trace(*this, TraceOperation::Solve, true);
+    if (Trace.Writer != nullptr)
+    {
+      WriteSolverOptions(*Trace.Writer, Options);
+      Trace.Writer->write(static_cast<uint8_t>(Limit.isFinite()));
+      Trace.Writer->write(Limit.isFinite() ? Limit.getRemainingSeconds() : 0.0);
+    }
+
+    SolverOptions_ = Options;
+
+    if (!Limit.isFinite())
+    {
+      this->solve();
+      return true;
+    }
+
+    /** nothing left to do */
+    const double Remaining = Limit.getRemainingSeconds();
+    if (Remaining <= 0.0)
+    {
+      DeadlineMisses_++;
+      if (Metrics_ != nullptr)
+      {
+        Metrics_->DeadlineMisses.add();
+      }
+      return false;
+    }
+
+    /** the callback stops between iterations, the time limit of ceres also covers the preprocessing */
+    DeadlineCallback Callback(Limit);
+    Options.callbacks.push_back(&Callback);
+    Options.max_solver_time_in_seconds = std::min(Options.max_solver_time_in_seconds, Remaining);
+    this->solve_(Options);
+
+    if (Callback.hasStopped() || Limit.hasPassed())
+    {
+      DeadlineMisses_++;
+      if (Metrics_ != nullptr)
+      {
+        Metrics_->DeadlineMisses.add();
+      }
+      return false;
+    }
+    return true;
+  }
+
+  void FactorGraph::solveIncremental()
+  {
+    const TraceScope_ Trace(*this, TraceOperation::SolveIncremental, true);
+    if (Trace.Writer != nullptr)
+    {
+      WriteSolverOptions(*Trace.Writer, SolverOptions_);
+    }
+
+    /** get states that are connected to added or removed factors */
+    std::vector<double*> ChangedStates;
+    Structure_.getChangedStates(ChangedStates);
+
+    /** nothing changed since the last solve */
+    if (ChangedStates.empty())
+    {
+      return;
+    }
+
+    /** the direct neighbors of changed states are optimized as well */
+    std::set<double*> ActiveStates;
+    for (double* const State : ChangedStates)
+    {
+      ActiveStates.emplace(State);
+
+      std::vector<ceres::ResidualBlockId> Factors;
+      Graph_.GetResidualBlocksForParameterBlock(State, &Factors);
+      for (const ceres::ResidualBlockId Factor : Factors)
+      {
+        std::vector<double*> ConnectedStates;
+        Graph_.GetParameterBlocksForResidualBlock(Factor, &ConnectedStates);
+        ActiveStates.insert(ConnectedStates.begin(), ConnectedStates.end());
+      }
+    }
+
+    /** freeze everything else, ceres removes the frozen part from the linear system */
+    std::vector<double*> AllStates;
+    std::vector<double*> FrozenStates;
+    Graph_.GetParameterBlocks(&AllStates);
+    for (double* const State : AllStates)
+    {
+      if (ActiveStates.count(State) == 0 && !Graph_.IsParameterBlockConstant(State))
+      {
+        Graph_.SetParameterBlockConstant(State);
+        FrozenStates.emplace_back(State);
+      }
+    }
+
+    /** solve the reduced problem */
+    this->solve();
+
+    /** restore the original state */
+    for (double* const State : FrozenStates)
+    {
+      Graph_.SetParameterBlockVariable(State);
+    }
+  }
+
+  void FactorGraph::solveIncremental(ceres::Solver::Options Options)
+  {
+    const TraceScope_ Trace(*this, TraceOperation::SolveIncremental, true);
+    if (Trace.Writer != nullptr)
+    {
+      WriteSolverOptions(*Trace.Writer, Options);
+    }
+
+    SolverOptions_ = Options;
+    this->solveIncremental();
+  }
+
+  int FactorGraph::solveComponents()
+  {
+    const TraceScope_ Trace(*this, TraceOperation::SolveComponents, true);
+    if (Trace.Writer != nullptr)
+    {
+      WriteSolverOptions(*Trace.Writer, SolverOptions_);
+    }
+
+    LIBRSF_TRACE_SCOPE("solve_components");
+
+    /** re-integration replaces residual blocks, so it has to happen before the grouping */
+    this->relinearizeIMUPreintegration_();
+
+    std::vector<std::vector<ceres::ResidualBlockId>> Components;
+    Structure_.getConnectedComponents(Components);
+
+    /** a single group is the whole problem */
+    if (Components.size() <= 1)
+    {
+      this->solve_(SolverOptions_);
+      return static_cast<int>(Components.size());
+    }
+
+    std::string OptionsError;
+    if (!SolverOptions_.IsValid(&OptionsError))
+    {
+      PRINT_ERROR("The given solver options are wrong: ", OptionsError);
+      return 0;
+    }
+
+    /** orderings refer to the whole problem and callbacks are not made for concurrent calls,
+     *  the parallelism comes from the number of groups */
+    ceres::Solver::Options Options = SolverOptions_;
+    Options.linear_solver_ordering = nullptr;
+    Options.callbacks.clear();
+    Options.num_threads = 1;
+
+    /** the groups share no variable state, so each problem writes into its own part of the state data */
+    Timer SolveTimer;
+    std::vector<ceres::Solver::Summary> Summaries(Components.size());
+    GetThreadPool().parallelFor(Components.size(), [&](const size_t nComponent)
+    {
+      ceres::Problem Problem(DefaultProblemOptions_);
+      std::unordered_set<double*> States;
+      std::vector<double*> StatePointers;
+      for (const ceres::ResidualBlockId Factor : Components.at(nComponent))
+      {
+        Graph_.GetParameterBlocksForResidualBlock(Factor, &StatePointers);
+        Problem.AddResidualBlock(const_cast<ceres::CostFunction*>(Graph_.GetCostFunctionForResidualBlock(Factor)),
+                                 const_cast<ceres::LossFunction*>(Graph_.GetLossFunctionForResidualBlock(Factor)),
+                                 StatePointers);
+        States.insert(StatePointers.begin(), StatePointers.end());
+      }
+
+      /** mirror the configuration of the parameter blocks */
+      for (double* const State : States)
+      {
+        const ceres::LocalParameterization * const Parametrization = Graph_.GetParameterization(State);
+        if (Parametrization != nullptr)
+        {
+          Problem.SetParameterization(State, const_cast<ceres::LocalParameterization*>(Parametrization));
+        }
+        for (int n = 0; n < Graph_.ParameterBlockSize(State); n++)
+        {
+          const double Lower = Graph_.GetParameterLowerBound(State, n);
+          const double Upper = Graph_.GetParameterUpperBound(State, n);
+          if (Lower > -std::numeric_limits<double>::max())
+          {
+            Problem.SetParameterLowerBound(State, n, Lower);
+          }
+          if (Upper < std::numeric_limits<double>::max())
+          {
+            Problem.SetParameterUpperBound(State, n, Upper);
+          }
+        }
+        if (Graph_.IsParameterBlockConstant(State))
+        {
+          Problem.SetParameterBlockConstant(State);
+        }
+      }
+
+      ceres::Solve(Options, &Problem, &Summaries.at(nComponent));
+    });
+
+    /** the report sums up all groups, the first failed group determines the termination */
+    Report_ = Summaries.front();
+    Report_.initial_cost = 0.0;
+    Report_.final_cost = 0.0;
+    Report_.num_successful_steps = 0;
+    Report_.num_unsuccessful_steps = 0;
+    Report_.iterations.clear();
+    for (const ceres::Solver::Summary &Summary : Summaries)
+    {
+      Report_.initial_cost += Summary.initial_cost;
+      Report_.final_cost += Summary.final_cost;
+      Report_.num_successful_steps += Summary.num_successful_steps;
+      Report_.num_unsuccessful_steps += Summary.num_unsuccessful_steps;
+      if (!Summary.IsSolutionUsable() && Report_.IsSolutionUsable())
+      {
+        Report_.termination_type = Summary.termination_type;
+        Report_.message = Summary.message;
+      }
+    }
+    Report_.num_parameter_blocks = Graph_.NumParameterBlocks();
+    Report_.num_residual_blocks = Graph_.NumResidualBlocks();
+    Report_.total_time_in_seconds = SolveTimer.getSeconds();
+
+    SolverDuration_ += Report_.total_time_in_seconds;
+    SolverIterations_ += Report_.num_successful_steps + Report_.num_unsuccessful_steps;
+    SolveCounter_++;
+
+    if (Metrics_ != nullptr)
+    {
+      Metrics_->Solver.record(Report_.total_time_in_seconds);
+      Metrics_->Solves.add();
+      Metrics_->Iterations.add(static_cast<uint64_t>(Report_.num_successful_steps + Report_.num_unsuccessful_steps));
+      Metrics_->States.set(Graph_.NumParameterBlocks());
+      Metrics_->Factors.set(Graph_.NumResidualBlocks());
+    }
+
+    /** all modifications are part of the current solution now */
+    Structure_.resetChangedStates();
+    CovarianceCache_.reset();
+    RawErrorCache_.invalidate();
+
+    this->publishStates();
+
+    return static_cast<int>(Components.size());
+  }
+
+  int FactorGraph::solveComponents(ceres::Solver::Options Options)
+  {
+    const TraceScope_ Trace(*this, TraceOperation::SolveComponents, true);
+    if (Trace.Writer != nullptr)
+    {
+      WriteSolverOptions(*Trace.Writer, Options);
+    }
+
+    SolverOptions_ = Options;
+    return this->solveComponents();
+  }
+
+  void FactorGraph::addState(const StateKey &Name, DataType Type, double Timestamp)
+  {
+    LIBRSF_TRACE_SCOPE("add_state");
+
+    Data Element(Type, Timestamp);
+    addState(Name, Element);
+
+    /** without a given value, the trajectory so far is the best guess */
+    if (WarmStart_)
+    {
+      this->extrapolateState_(Name, Timestamp, StateData_.countElement(Name, Timestamp) - 1);
+    }
+  }
+
+  void FactorGraph::cacheState_(const StateID &State, double* Mean, const DataType Type)
+  {
+    CachedState &Entry = StateCache_[StateCacheNext_];
+    Entry.ID = State;
+    Entry.Mean = Mean;
+    Entry.Type = Type;
+    StateCacheNext_ = (StateCacheNext_ + 1) % StateCache_.size();
+  }
+
+  double* FactorGraph::getStatePointer_(const StateID &State, DataType &Type)
+  {
+    /** newest entries first */
+    for (size_t n = 1; n <= StateCache_.size(); n++)
+    {
+      const CachedState &Entry = StateCache_[(StateCacheNext_ + StateCache_.size() - n) % StateCache_.size()];
+      if (Entry.Mean != nullptr && Entry.ID == State)
+      {
+        Type = Entry.Type;
+        return Entry.Mean;
+      }
+    }
+
+    Data &Element = StateData_.getElement(State.ID, State.getTimestamp(), State.Number);
+    Type = Element.getType();
+    return Element.getMeanPointer();
+  }
+
+  void FactorGraph::extrapolateState_(const StateKey &Name, const double Timestamp, const int Number)
+  {
+    /** previous state with the same number */
+    double TimePrev;
+    if (!StateData_.getTimeBelow(Name, Timestamp, TimePrev) || StateData_.countElement(Name, TimePrev) <= Number)
+    {
+      return;
+    }
+    Data &State = StateData_.getElement(Name, Timestamp, Number);
+    const Data &Prev = StateData_.getElement(Name, TimePrev, Number);
+    if (Prev.getType() != State.getType())
+    {
+      return;
+    }
+
+    /** states on a manifold are only copied, vector states are extrapolated linearly */
+    Vector Mean = Prev.getMean();
+    switch (State.getType())
+    {
+      case DataType::Angle:
+      case DataType::UnitCircle:
+      case DataType::Quaternion:
+      case DataType::Pose2:
+      case DataType::Pose3:
+      case DataType::Switch:
+        break;
+
+      default:
+        {
+          double TimePrevPrev;
+          if (StateData_.getTimeBelow(Name, TimePrev, TimePrevPrev) && StateData_.countElement(Name, TimePrevPrev) > Number)
+          {
+            const Vector Delta = Mean - StateData_.getElement(Name, TimePrevPrev, Number).getMean();
+            Mean += Delta * (Timestamp - TimePrev) / (TimePrev - TimePrevPrev);
+          }
+          break;
+        }
+    }
+    State.setMean(Mean);
+  }
+
+  void FactorGraph::addState(const StateKey &Name, Data &Element)
+  {
+    const TraceScope_ Trace(*this, TraceOperation::AddState);
+    if (Trace.Writer != nullptr)
+    {
+      Trace.Writer->writeString(Name.getName());
+      Trace.Writer->writeData(Element);
+    }
+
+    LIBRSF_TRACE_SCOPE("add_state");
+
+    StateData_.addElement(Name, Element);
+    double Timestamp = Element.getTimestamp();
+    int StateNumber = StateData_.countElement(Name, Timestamp) - 1;
+
+    /** parameter blocks of one type share contiguous memory, released states are recycled by the next ones */
+    Data &State = StateData_.getElement(Name, Timestamp, StateNumber);
+    State.placeInSlab();
+    double* StatePointer = State.getMeanPointer();
+    const int StateSize = static_cast<int>(State.getMean().size());
+    const DataType Type = State.getType();
+    this->cacheState_(StateID(Name, Timestamp, StateNumber), StatePointer, Type);
+
+    /** add state vector as parameter block with local parametrization if required */
+    switch (Type)
+    {
+      case DataType::Angle:
+        Graph_.AddParameterBlock(StatePointer, StateSize, Parameterizations_.get<AngleLocalParameterization>());
+        break;
+
+      case DataType::UnitCircle:
+        {
+          /** initialize with 0 degree rotation */
+          Vector2 Circle;
+          Circle << 1, 0;
+          State.setMean(Circle);
+
+          Graph_.AddParameterBlock(StatePointer, StateSize, Parameterizations_.get<UnitCircleLocalParameterization>());
+          break;
+        }
+
+      case DataType::Quaternion:
+        {
+          /** initialize with valid quaternion */
+          Vector4 Quat;
+          Quat << 0, 0, 0, 1; /**< x,y,z,w */
+          State.setMean(Quat);
+
+          Graph_.AddParameterBlock(StatePointer, StateSize, Parameterizations_.get<QuaternionLocalParameterization>());
+          break;
+        }
+
+      case DataType::Pose2:
+        Graph_.AddParameterBlock(StatePointer, StateSize, Parameterizations_.get<Pose2LocalParameterization>());
+        break;
+
+      case DataType::Pose3:
+        {
+          /** initialize with valid quaternion */
+          Vector7 Pose3;
+          Pose3 << 0,0,0, 0,0,0,1;
+          State.setMean(Pose3);
+
+          Graph_.AddParameterBlock(StatePointer, StateSize, Parameterizations_.get<Pose3LocalParameterization>());
+          break;
+        }
+
+      case DataType::Switch:
+        {
+          /** initialize with one */
+          State.setMean(Vector1::Identity());
+
+          Graph_.AddParameterBlock(StatePointer, StateSize);
+
+          /** limit between zero and one */
+          Graph_.SetParameterLowerBound(StatePointer, 0, 0.0);
+          Graph_.SetParameterUpperBound(StatePointer, 0, 1.0);
+          break;
+        }
+
+      default:
+        Graph_.AddParameterBlock(StatePointer, StateSize);
+        break;
+    }
+  }
+
+  void FactorGraph::addStateWithCheck(const StateKey &Name, DataType Type, double Timestamp)
+  {
+    if (!this->getStateData().checkElement(Name, Timestamp))
+    {
+      this->addState(Name, Type, Timestamp);
+    }
+  }
+
+  void FactorGraph::addFactors(FactorBatch &Batch, const int ThreadNumber)
+  {
+    LIBRSF_TRACE_SCOPE("add_factors");
+
+    /** construction happens per type, the graph is changed in the original order */
+    for (const std::unique_ptr<FactorBatch::StageBase> &Stage : Batch.Stages_)
+    {
+      Stage->prepare(*this, ThreadNumber);
+    }
+
+    this->reserve(0, static_cast<size_t>(Graph_.NumResidualBlocks()) + Batch.size());
+    for (const auto &Factor : Batch.Order_)
+    {
+      Factor.first->commit(*this, Factor.second);
+    }
+
+    Batch.clear();
+  }
+
+  void FactorGraph::reserve(const size_t States, const size_t Factors)
+  {
+    /** ceres::Problem has no capacity interface and the time-ordered data sets are node based */
+    Structure_.reserve(States, Factors);
+    if (CheckpointRecording_)
+    {
+      CheckpointFactors_.reserve(Factors);
+    }
+  }
+
+  void FactorGraph::optimizeLayout()
+  {
+    /** ceres evaluates the residuals in the order of insertion, which is scattered by the fast removal of a sliding window */
+    struct ResidualBlock
+    {
+      ceres::ResidualBlockId ID;
+      const ceres::CostFunction* CostFunction;
+      const ceres::LossFunction* LossFunction;
+      std::vector<double*> States;
+      double Timestamp;
+    };
+
+    std::vector<ceres::ResidualBlockId> IDs;
+    Graph_.GetResidualBlocks(&IDs);
+
+    std::vector<ResidualBlock> Blocks(IDs.size());
+    for (size_t n = 0; n < IDs.size(); n++)
+    {
+      ResidualBlock &Block = Blocks.at(n);
+      Block.ID = IDs.at(n);
+      Block.CostFunction = Graph_.GetCostFunctionForResidualBlock(Block.ID);
+      Block.LossFunction = Graph_.GetLossFunctionForResidualBlock(Block.ID);
+      Graph_.GetParameterBlocksForResidualBlock(Block.ID, &Block.States);
+
+      FactorGraphStructure::FactorInfo Info;
+      Block.Timestamp = Structure_.getFactorInfo(Block.ID, Info) ? Info.Timestamp : std::numeric_limits<double>::max();
+    }
+
+    /** factors of the same time are grouped by their first state */
+    std::stable_sort(Blocks.begin(), Blocks.end(), [](const ResidualBlock &A, const ResidualBlock &B)
+    {
+      if (A.Timestamp != B.Timestamp)
+      {
+        return A.Timestamp < B.Timestamp;
+      }
+      const double *StateA = A.States.empty() ? nullptr : A.States.front();
+      const double *StateB = B.States.empty() ? nullptr : B.States.front();
+      return std::less<const double*>()(StateA, StateB);
+    });
+
+    /** the problem does not own cost and loss functions, so they survive the removal */
+    for (const ResidualBlock &Block : Blocks)
+    {
+      Graph_.RemoveResidualBlock(Block.ID);
+    }
+
+    std::vector<std::pair<ceres::ResidualBlockId, ceres::ResidualBlockId>> Registered;
+    std::vector<std::pair<ceres::ResidualBlockId, ceres::ResidualBlockId>> Replaced;
+    Registered.reserve(Blocks.size());
+    Replaced.reserve(Blocks.size());
+    for (const ResidualBlock &Block : Blocks)
+    {
+      const ceres::ResidualBlockId NewID = Graph_.AddResidualBlock(const_cast<ceres::CostFunction*>(Block.CostFunction),
+                                                                   const_cast<ceres::LossFunction*>(Block.LossFunction),
+                                                                   Block.States);
+      if (Block.Timestamp != std::numeric_limits<double>::max())
+      {
+        Registered.emplace_back(Block.ID, NewID);
+      }
+      Replaced.emplace_back(Block.ID, NewID);
+    }
+
+    Structure_.replaceResidualIDs(Registered);
+    RawErrorCache_.invalidate();
+    replaceKeys_(IMUFactors_, Replaced);
+    replaceKeys_(CheckpointFactors_, Replaced);
+    replaceKeys_(CheckpointMarginals_, Replaced);
+  }
+
+  void FactorGraph::setMarginalCompression(const double MinEigenRatio)
+  {
+    if (MinEigenRatio < 0.0 || MinEigenRatio >= 1.0)
+    {
+      PRINT_ERROR("The compression ratio of marginal priors has to be in [0, 1) and not ", MinEigenRatio, "!");
+      return;
+    }
+    MarginalCompression_ = MinEigenRatio;
+  }
+
+  void FactorGraph::addIMUPreintegrationFactor(StateList List, const PreintegratedIMUResult& IMUState)
+  {
+    if (Trace_ != nullptr)
+    {
+      this->traceUnsupported_("IMU pre-integration factor");
+    }
+
+    this->addIMUPreintegrationFactor_(List, IMUState, true);
+  }
+
+  void FactorGraph::setIMURelinearizationThreshold(const double Threshold)
+  {
+    IMURelinearizationThreshold_ = Threshold;
+    if (Threshold <= 0.0)
+    {
+      IMUFactors_.clear();
+    }
+  }
+
+  void FactorGraph::addIMUPreintegrationFactor_(const StateList &List, const PreintegratedIMUResult& IMUState, const bool DoPrediction)
+  {
+    /** create noise model */
+    GaussianFull<15> IMUNoiseModel;
+    IMUNoiseModel.setCovarianceMatrix(IMUState.PreIntCov);
+
+    /** add to factor graph */
+    using FactorClassType = typename FactorTypeTranslator<FactorType::IMUPretintegration, GaussianFull<15>>::Type;
+    addFactorGeneric_<GaussianFull<15>, FactorClassType> (IMUNoiseModel,
+                                                          List.List_,
+                                                          FactorType::IMUPretintegration,
+                                                          nullptr,
+                                                          DoPrediction,
+                                                          List.List_.front().getTimestamp(),
+                                                          IMUState);
+
+    /** remember the pre-integration, it is repeated if the bias changes too much */
+    if (IMURelinearizationThreshold_ > 0.0)
+    {
+      const double Timestamp = List.List_.front().getTimestamp();
+      ceres::ResidualBlockId CeresID;
+      Structure_.getResidualID(FactorID(FactorType::IMUPretintegration, Timestamp,
+                                        Structure_.countFactor(FactorType::IMUPretintegration, Timestamp) - 1), CeresID);
+
+      /** an address of a removed factor might be reused */
+      IMUFactors_.erase(CeresID);
+      IMUFactors_.emplace(CeresID, std::make_shared<IMUFactorRecord>(IMUFactorRecord{List, IMUState}));
+    }
+  }
+
+  void FactorGraph::relinearizeIMUPreintegration_()
+  {
+    if (IMURelinearizationThreshold_ <= 0.0 || IMUFactors_.empty())
+    {
+      return;
+    }
+
+    /** factors outside of the window might be gone already */
+    std::vector<ceres::ResidualBlockId> Factors;
+    Structure_.getResidualIDs(FactorType::IMUPretintegration, Factors);
+
+    PointerMap<ceres::ResidualBlockId, std::shared_ptr<IMUFactorRecord>> Remaining;
+    std::vector<std::shared_ptr<IMUFactorRecord>> Outdated;
+    for (const ceres::ResidualBlockId CeresID : Factors)
+    {
+      if (IMUFactors_.count(CeresID) == 0)
+      {
+        continue;
+      }
+      const std::shared_ptr<IMUFactorRecord> Record = IMUFactors_.at(CeresID);
+
+      /** speed and bias state at the begin [Speed, BiasAcc, BiasTR] */
+      const StateID &SpeedBias = Record->States.List_.at(2);
+      const Vector9 SpeedBiasMean = StateData_.getElement(SpeedBias.ID, SpeedBias.getTimestamp(), SpeedBias.Number).getMean();
+      const Vector3 BiasAcc = SpeedBiasMean.segment<3>(3);
+      const Vector3 BiasTR = SpeedBiasMean.segment<3>(6);
+
+      if (IMUPreintegrator::NeedsReintegration(Record->Preintegration, BiasAcc, BiasTR, IMURelinearizationThreshold_))
+      {
+        Record->Preintegration = IMUPreintegrator::Reintegrate(Record->Preintegration, BiasAcc, BiasTR);
+        Outdated.push_back(Record);
+
+        Structure_.removeFactor(CeresID);
+        this->removeResidualBlock_(CeresID);
+      }
+      else
+      {
+        Remaining.emplace(CeresID, Record);
+      }
+    }
+    IMUFactors_ = std::move(Remaining);
+
+    /** the states keep their values */
+    for (const std::shared_ptr<IMUFactorRecord> &Record : Outdated)
+    {
+      this->addIMUPreintegrationFactor_(Record->States, Record->Preintegration, false);
+    }
+  }
+
+  void FactorGraph::printReport() const
+  {
+    std::cout << Report_.FullReport() << "\n";
+  }
+
+  void FactorGraph::setFactorTiming(const bool Enable)
+  {
+    FactorTiming_ = Enable;
+  }
+
+  void FactorGraph::resetFactorTiming()
+  {
+    for (auto &Timing : FactorTimings_)
+    {
+      Timing.second->reset();
+    }
+  }
+
+  ceres::CostFunction* FactorGraph::wrapCostFunction_(const FactorType Type, ceres::CostFunction* CostFunction)
+  {
+    if (!FactorTiming_)
+    {
+      return CostFunction;
+    }
+
+    std::unique_ptr<EvaluationTiming> &Timing = FactorTimings_[Type];
+    if (Timing == nullptr)
+    {
+      Timing = std::make_unique<EvaluationTiming>();
+    }
+    return Pool_.create<TimedCostFunction>(Type, CostFunction, &Pool_, Timing.get());
+  }
+
+  std::map<FactorType, FactorStatistics> FactorGraph::getFactorStatistics()
+  {
+    std::map<FactorType, FactorStatistics> Statistics;
+
+    /** the evaluations of this function should not appear in the timing */
+    std::map<FactorType, std::pair<long long, long long>> TimingBefore;
+    for (const auto &Timing : FactorTimings_)
+    {
+      TimingBefore[Timing.first] = {Timing.second->Nanoseconds.load(std::memory_order_relaxed),
+                                    Timing.second->Evaluations.load(std::memory_order_relaxed)};
+    }
+
+    std::vector<FactorType> Types;
+    Structure_.getFactorTypes(Types);
+    for (const FactorType Type : Types)
+    {
+      std::vector<ceres::ResidualBlockId> IDs;
+      Structure_.getResidualIDs(Type, IDs);
+      if (IDs.empty())
+      {
+        continue;
+      }
+
+      FactorStatistics &Current = Statistics[Type];
+      Current.Count = static_cast<int>(IDs.size());
+
+      /** timing is only available for wrapped cost functions */
+      const auto Timing = TimingBefore.find(Type);
+      if (Timing != TimingBefore.end())
+      {
+        Current.EvaluationTime = static_cast<double>(Timing->second.first) / 1e9;
+        Current.Evaluations = Timing->second.second;
+      }
+
+      /** weighted cost of this type only */
+      ceres::Problem::EvaluateOptions Options;
+      Options.residual_blocks = IDs;
+      Graph_.Evaluate(Options, &Current.Cost, nullptr, nullptr, nullptr);
+
+      /** unweighted errors, factors without error model (like marginals) are unweighted already */
+      double TimeFirst;
+      Structure_.getTimeFirst(Type, TimeFirst);
+      int InputSize;
+      int OutputSize;
+      Structure_.getErrorInputSize(FactorID(Type, TimeFirst, 0), InputSize);
+      Structure_.getErrorOutputSize(FactorID(Type, TimeFirst, 0), OutputSize);
+
+      if (InputSize > 0 && OutputSize > 0)
+      {
+        Matrix Errors;
+        this->computeRawErrors_(IDs, InputSize, OutputSize, Errors);
+        Current.ResidualRMS = (Errors.size() > 0) ? std::sqrt(Errors.squaredNorm() / static_cast<double>(Errors.size())) : 0.0;
+      }
+      else
+      {
+        double Residuals = 0.0;
+        for (const ceres::ResidualBlockId &ID : IDs)
+        {
+          Residuals += Graph_.GetCostFunctionForResidualBlock(ID)->num_residuals();
+        }
+        Current.ResidualRMS = (Residuals > 0) ? std::sqrt(2.0 * this->evaluateFactors(Type) / Residuals) : 0.0;
+      }
+    }
+
+    for (const auto &Timing : TimingBefore)
+    {
+      FactorTimings_.at(Timing.first)->Nanoseconds.store(Timing.second.first, std::memory_order_relaxed);
+      FactorTimings_.at(Timing.first)->Evaluations.store(Timing.second.second, std::memory_order_relaxed);
+    }
+
+    return Statistics;
+  }
+
+  void FactorGraph::printFactorStatistics()
+  {
+    for (const auto &Type : this->getFactorStatistics())
     {
-      PRINT_ERROR("The given solver options are wrong: ", OptionsError);
+      std::cout << std::left << std::setw(28) << Type.first
+                << " Count: " << std::setw(8) << Type.second.Count
+                << " Cost: " << std::setw(12) << Type.second.Cost
+                << " RMS: " << std::setw(12) << Type.second.ResidualRMS
+                << " Time: " << Type.second.EvaluationTime << "s"
+                << " (" << Type.second.Evaluations << " evaluations)\n";
     }
-    else
+  }
+
+  MemoryUsage FactorGraph::getMemoryUsage(const SensorDataSet *SensorData) const
+  {
+    MemoryUsage Usage;
+
+    Usage.StateData = StateData_.getMemorySize();
+    Usage.StatesPerName = StateData_.getMemorySizePerID();
+
+    if (SensorData != nullptr)
     {
-      /** call ceres to solve the optimization problem */
-      ceres::Solve(SolverOptions_, &Graph_, &Report_);
-      SolverDuration_ += Report_.total_time_in_seconds;
-      SolverIterations_ +=
-          Report_.num_successful_steps + Report_.num_unsuccessful_steps;
+      Usage.SensorData = SensorData->getMemorySize();
     }
+
+    Usage.Structure = Structure_.getMemorySize() + IMUFactors_.getMemorySize();
+
+    /** error models are stored inside the factors, which share their block with the cost function */
+    Usage.Factors = Pool_.getMemorySize();
+    Usage.FactorsPerType = Pool_.getMemorySizePerType();
+
+    return Usage;
   }
 
-  void FactorGraph::solve(ceres::Solver::Options Options)
+  void FactorGraph::printMemoryUsage(const SensorDataSet *SensorData) const
   {
-    SolverOptions_ = Options;
-    this->solve();
+    const MemoryUsage Usage = this->getMemoryUsage(SensorData);
+
+    std::cout << "Memory usage: " << Usage.getTotal() / 1024 << " KiB\n"
+              << "  States:    " << Usage.StateData / 1024 << " KiB\n"
+              << "  Sensors:   " << Usage.SensorData / 1024 << " KiB\n"
+              << "  Structure: " << Usage.Structure / 1024 << " KiB\n"
+              << "  Factors:   " << Usage.Factors / 1024 << " KiB\n";
+    for (const auto &State : Usage.StatesPerName)
+    {
+      std::cout << "    State " << State.first << ": " << State.second / 1024 << " KiB\n";
+    }
+    for (const auto &Factor : Usage.FactorsPerType)
+    {
+      std::cout << "    Factor " << Factor.first << ": " << Factor.second / 1024 << " KiB\n";
+    }
   }
 
-  void FactorGraph::addState(const string& Name, DataType Type, double Timestamp)
+  /**
+   * Layout of a checkpoint (native byte order, it is only valid for the same build):
+   * char[4]  magic "RSFC"
+   * uint32   version
+   * uint64   number of states, per state: key, Data, uint8 constant flag, lower and upper bound of each dimension
+   * uint32   number of factor types, per type: int32 type, uint8 flag of the error models
+   * uint64   number of factors, per factor: handler key, uint32 number of states, state IDs, measurement, error model
+   * uint64   number of marginal priors, per prior: uint32 number of states, per state: ID, int32 type, local and global size,
+   *          linearization point, followed by the Jacobian and the residual
+   */
+  static const char CheckpointMagic[4] = {'R', 'S', 'F', 'C'};
+  static const uint32_t CheckpointVersion = 1;
+
+  std::map<std::string, FactorGraph::CheckpointHandler> &FactorGraph::getCheckpointHandlers_()
   {
-    Data Element(Type, Timestamp);
-    addState(Name, Element);
+    /** filled during static initialization by all instantiated handlers */
+    static std::map<std::string, CheckpointHandler> Handlers;
+    return Handlers;
   }
 
-  void FactorGraph::addState(const string& Name, Data &Element)
+  void FactorGraph::setCheckpointRecording(const bool Enable)
   {
-    StateData_.addElement(Name, Element);
-    double Timestamp = Element.getTimestamp();
-    int StateNumber = StateData_.countElement(Name, Timestamp) - 1;
+    CheckpointRecording_ = Enable;
+    if (!Enable)
+    {
+      CheckpointFactors_.clear();
+      CheckpointMarginals_.clear();
+    }
+  }
 
-    double* StatePointer =
-        StateData_.getElement(Name, Timestamp, StateNumber).getMeanPointer();
-    const int StateSize = static_cast<int>(
-        StateData_.getElement(Name, Timestamp, StateNumber).getMean().size());
+  void FactorGraph::recordFactor_(const FactorType Type, const double Timestamp, const StateList &States, const Data &Measurement, const std::string* Handler)
+  {
+    ceres::ResidualBlockId CeresID;
+    Structure_.getResidualID(FactorID(Type, Timestamp, Structure_.countFactor(Type, Timestamp) - 1), CeresID);
 
-    /** add state vector as parameter block with local parametrization if required */
-    switch (StateData_.getElement(Name, Timestamp, StateNumber).getType())
+    const std::shared_ptr<CheckpointRecord> Record = std::make_shared<CheckpointRecord>();
+    Record->Handler = Handler;
+    Record->Sequence = CheckpointSequence_++;
+    Record->States = States;
+    Record->Measurement = Measurement;
+
+    /** an address of a removed factor might be reused */
+    CheckpointFactors_.erase(CeresID);
+    CheckpointFactors_.emplace(CeresID, Record);
+  }
+
+  void FactorGraph::forgetFactor_(const ceres::ResidualBlockId CeresID)
+  {
+    RawErrorCache_.forget(CeresID);
+
+    if (CheckpointRecording_)
     {
-      case DataType::Angle:
-        Graph_.AddParameterBlock(StatePointer, StateSize, AngleLocalParameterization::Create());
-        break;
+      CheckpointFactors_.erase(CeresID);
+      CheckpointMarginals_.erase(CeresID);
+    }
+  }
 
-      case DataType::UnitCircle:
-        {
-          /** initialize with 0 degree rotation */
-          Vector2 Circle;
-          Circle << 1, 0;
-          StateData_.getElement(Name, Timestamp, StateNumber).setMean(Circle);
+  bool FactorGraph::saveCheckpoint(const string &Filename)
+  {
+    LIBRSF_TRACE_SCOPE("save_checkpoint");
 
-          Graph_.AddParameterBlock(StatePointer, StateSize, UnitCircleLocalParameterization::Create());
-          break;
-        }
+    /** every factor has to be rebuildable */
+    std::vector<ceres::ResidualBlockId> Blocks;
+    Graph_.GetResidualBlocks(&Blocks);
 
-      case DataType::Quaternion:
+    std::vector<std::pair<ceres::ResidualBlockId, std::shared_ptr<CheckpointRecord>>> Factors;
+    std::vector<std::pair<ceres::ResidualBlockId, std::shared_ptr<MarginalRecord>>> Marginals;
+    int RobustFactors = 0;
+    for (const ceres::ResidualBlockId CeresID : Blocks)
+    {
+      if (CheckpointMarginals_.count(CeresID) > 0)
+      {
+        Marginals.emplace_back(CeresID, CheckpointMarginals_.at(CeresID));
+      }
+      else if (CheckpointFactors_.count(CeresID) > 0)
+      {
+        Factors.emplace_back(CeresID, CheckpointFactors_.at(CeresID));
+        if (Graph_.GetLossFunctionForResidualBlock(CeresID) != nullptr)
         {
-          /** initialize with valid quaternion */
-          Vector4 Quat;
-          Quat << 0, 0, 0, 1; /**< x,y,z,w */
-          StateData_.getElement(Name, Timestamp, StateNumber).setMean(Quat);
-
-          Graph_.AddParameterBlock(StatePointer, StateSize, QuaternionLocalParameterization::Create());
-          break;
+          RobustFactors++;
         }
+      }
+      else
+      {
+        PRINT_ERROR("Graph contains factors that were not recorded, IMU pre-integration, pseudorange epoch and state prior factors are not supported!");
+        return false;
+      }
+    }
 
-      case DataType::Pose2:
+    if (RobustFactors > 0)
+    {
+      PRINT_WARNING("Loss functions of ", RobustFactors, " factors are not part of the checkpoint!");
+    }
+
+    /** keep the original order, so that the factor numbers are the same */
+    std::sort(Factors.begin(), Factors.end(), [](const auto &A, const auto &B)
+    {
+      return A.second->Sequence < B.second->Sequence;
+    });
+    std::sort(Marginals.begin(), Marginals.end(), [](const auto &A, const auto &B)
+    {
+      return A.second->States.front().Tick < B.second->States.front().Tick;
+    });
+
+    CheckpointWriter Writer;
+    Writer.write(CheckpointMagic);
+    Writer.write(CheckpointVersion);
+
+    /** states in the order of their numbers */
+    std::vector<StateID> States;
+    for (const StateKey &Key : StateData_.getKeysAll())
+    {
+      std::vector<StateID> IDs;
+      StateData_.getUniqueIDs(Key, IDs);
+      States.insert(States.end(), IDs.begin(), IDs.end());
+    }
+
+    Writer.write(static_cast<uint64_t>(States.size()));
+    for (const StateID &ID : States)
+    {
+      Data &State = StateData_.getElement(ID.ID, ID.getTimestamp(), ID.Number);
+      double* StatePointer = State.getMeanPointer();
+
+      Writer.writeString(ID.ID.getName());
+      Writer.writeData(State);
+      Writer.write(static_cast<uint8_t>(Graph_.IsParameterBlockConstant(StatePointer)));
+      for (int n = 0; n < static_cast<int>(State.getMean().size()); n++)
+      {
+        Writer.write(Graph_.GetParameterLowerBound(StatePointer, n));
+        Writer.write(Graph_.GetParameterUpperBound(StatePointer, n));
+      }
+    }
+
+    /** error models that are toggled per type */
+    std::vector<FactorType> Types;
+    Structure_.getFactorTypes(Types);
+    Writer.write(static_cast<uint32_t>(Types.size()));
+    for (const FactorType Type : Types)
+    {
+      Writer.write(static_cast<int32_t>(Type));
+      Writer.write(static_cast<uint8_t>(Structure_.areErrorModelsEnabled(Type)));
+    }
+
+    /** factors with the current state of their error models, which includes adapted mixtures */
+    Writer.write(static_cast<uint64_t>(Factors.size()));
+    for (const auto &[CeresID, Record] : Factors)
+    {
+      Writer.writeString(*Record->Handler);
+      Writer.write(static_cast<uint32_t>(Record->States.List_.size()));
+      for (const StateID &ID : Record->States.List_)
+      {
+        Writer.writeStateID(ID);
+      }
+      Writer.writeData(Record->Measurement);
+
+      ErrorModelBase* Model;
+      Structure_.getErrorModel(CeresID, Model);
+      if (!getCheckpointHandlers_().at(*Record->Handler).Serialize(Model, Writer))
+      {
+        PRINT_ERROR("Error model can not be stored in a checkpoint: ", *Record->Handler);
+        return false;
+      }
+    }
+
+    Writer.write(static_cast<uint64_t>(Marginals.size()));
+    for (const auto &Marginal : Marginals)
+    {
+      const MarginalRecord &Prior = *Marginal.second;
+      Writer.write(static_cast<uint32_t>(Prior.States.size()));
+      for (size_t n = 0; n < Prior.States.size(); n++)
+      {
+        Writer.writeStateID(Prior.States.at(n));
+        Writer.write(static_cast<int32_t>(Prior.Types.at(n)));
+        Writer.write(static_cast<int32_t>(Prior.LocalSize.at(n)));
+        Writer.write(static_cast<int32_t>(Prior.GlobalSize.at(n)));
+        Writer.writeMatrix(Prior.LinearizationPoints.at(n));
+      }
+      Writer.writeMatrix(Prior.Jacobian);
+      Writer.writeMatrix(Prior.Residual);
+    }
+
+    return Writer.writeToFile(Filename);
+  }
+
+  bool FactorGraph::loadCheckpoint(const string &Filename)
+  {
+    LIBRSF_TRACE_SCOPE("load_checkpoint");
+
+    if (Graph_.NumParameterBlocks() > 0)
+    {
+      PRINT_ERROR("A checkpoint can only be loaded into an empty graph!");
+      return false;
+    }
+
+    CheckpointReader Reader;
+    if (!Reader.readFromFile(Filename))
+    {
+      return false;
+    }
+
+    const auto Corrupted = [&Filename]()
+    {
+      PRINT_ERROR("Unexpected end of checkpoint: ", Filename);
+      return false;
+    };
+
+    char Magic[sizeof(CheckpointMagic)];
+    uint32_t Version = 0;
+    if (!Reader.read(Magic) || std::memcmp(Magic, CheckpointMagic, sizeof(Magic)) != 0 ||
+        !Reader.read(Version) || Version != CheckpointVersion)
+    {
+      PRINT_ERROR("Invalid header of checkpoint: ", Filename);
+      return false;
+    }
+
+    /** the restored graph can be stored again */
+    CheckpointRecording_ = true;
+
+    uint64_t StateNumber = 0;
+    if (!Reader.read(StateNumber))
+    {
+      return Corrupted();
+    }
+    for (uint64_t nState = 0; nState < StateNumber; nState++)
+    {
+      std::string Name;
+      Data Element;
+      uint8_t IsConstant = 0;
+      if (!Reader.readString(Name) || !Reader.readData(Element) || !Reader.read(IsConstant))
+      {
+        return Corrupted();
+      }
+
+      const double Timestamp = Element.getTimestamp();
+      this->addState(Name, Element);
+
+      /** some types are initialized by addState() */
+      Data &State = StateData_.getElement(Name, Timestamp, StateData_.countElement(Name, Timestamp) - 1);
+      State.setMean(Element.getMean());
+      if (Element.checkElement(DataElement::Covariance))
+      {
+        State.setValue(DataElement::Covariance, Element.getValue(DataElement::Covariance));
+      }
+
+      double* StatePointer = State.getMeanPointer();
+      for (int n = 0; n < static_cast<int>(Element.getMean().size()); n++)
+      {
+        double Lower = 0.0;
+        double Upper = 0.0;
+        if (!Reader.read(Lower) || !Reader.read(Upper))
         {
-          ceres::LocalParameterization *LocalParamPose2 = new ceres::ProductParameterization(new ceres::IdentityParameterization(2), AngleLocalParameterization::Create());
-          Graph_.AddParameterBlock(StatePointer, StateSize, LocalParamPose2);
-          break;
+          return Corrupted();
         }
-
-      case DataType::Pose3:
+        if (Lower > -std::numeric_limits<double>::max())
         {
-          /** initialize with valid quaternion */
-          Vector7 Pose3;
-          Pose3 << 0,0,0, 0,0,0,1;
-          StateData_.getElement(Name, Timestamp, StateNumber).setMean(Pose3);
-
-          ceres::LocalParameterization *LocalParamPose3 = new ceres::ProductParameterization(new ceres::IdentityParameterization(3), QuaternionLocalParameterization::Create());
-          Graph_.AddParameterBlock(StatePointer, StateSize, LocalParamPose3);
-          break;
+          Graph_.SetParameterLowerBound(StatePointer, n, Lower);
         }
-
-      case DataType::Switch:
+        if (Upper < std::numeric_limits<double>::max())
         {
-          /** initialize with one */
-          StateData_.getElement(Name, Timestamp, StateNumber).setMean(Vector1::Identity());
+          Graph_.SetParameterUpperBound(StatePointer, n, Upper);
+        }
+      }
 
-          Graph_.AddParameterBlock(StatePointer, StateSize);
+      if (IsConstant != 0)
+      {
+        Graph_.SetParameterBlockConstant(StatePointer);
+      }
+    }
 
-          /** limit between zero and one */
-          Graph_.SetParameterLowerBound(
-              StateData_.getElement(Name, Timestamp, StateNumber).getMeanPointer(), 0, 0.0);
-          Graph_.SetParameterUpperBound(
-              StateData_.getElement(Name, Timestamp, StateNumber).getMeanPointer(), 0, 1.0);
-          break;
+    uint32_t TypeNumber = 0;
+    if (!Reader.read(TypeNumber))
+    {
+      return Corrupted();
+    }
+    std::vector<std::pair<FactorType, bool>> Types;
+    for (uint32_t nType = 0; nType < TypeNumber; nType++)
+    {
+      int32_t Type = 0;
+      uint8_t Enabled = 0;
+      if (!Reader.read(Type) || !Reader.read(Enabled))
+      {
+        return Corrupted();
+      }
+      Types.emplace_back(static_cast<FactorType>(Type), Enabled != 0);
+    }
+
+    uint64_t FactorNumber = 0;
+    if (!Reader.read(FactorNumber))
+    {
+      return Corrupted();
+    }
+    for (uint64_t nFactor = 0; nFactor < FactorNumber; nFactor++)
+    {
+      std::string Key;
+      uint32_t Number = 0;
+      if (!Reader.readString(Key) || !Reader.read(Number))
+      {
+        return Corrupted();
+      }
+
+      StateList States;
+      for (uint32_t nState = 0; nState < Number; nState++)
+      {
+        StateID ID;
+        if (!Reader.readStateID(ID))
+        {
+          return Corrupted();
         }
+        States.add(ID);
+      }
 
-      default:
-        Graph_.AddParameterBlock(StatePointer, StateSize);
-        break;
+      Data Measurement;
+      if (!Reader.readData(Measurement))
+      {
+        return Corrupted();
+      }
+
+      /** the handler exists only if the loading program adds the same kind of factor somewhere */
+      const auto Handler = getCheckpointHandlers_().find(Key);
+      if (Handler == getCheckpointHandlers_().end())
+      {
+        PRINT_ERROR("Factor of the checkpoint is not available in this program: ", Key);
+        return false;
+      }
+      if (!Handler->second.Rebuild(*this, States, Measurement, Reader))
+      {
+        return Corrupted();
+      }
     }
-  }
 
-  void FactorGraph::addStateWithCheck(const string& Name, DataType Type, double Timestamp)
-  {
-    if (!this->getStateData().checkElement(Name, Timestamp))
+    uint64_t MarginalNumber = 0;
+    if (!Reader.read(MarginalNumber))
     {
-      this->addState(Name, Type, Timestamp);
+      return Corrupted();
     }
-  }
+    for (uint64_t nMarginal = 0; nMarginal < MarginalNumber; nMarginal++)
+    {
+      uint32_t Number = 0;
+      if (!Reader.read(Number))
+      {
+        return Corrupted();
+      }
 
-  void FactorGraph::addIMUPreintegrationFactor(StateList List, const PreintegratedIMUResult& IMUState)
-  {
-    /** create noise model */
-    GaussianFull<15> IMUNoiseModel;
-    IMUNoiseModel.setCovarianceMatrix(IMUState.PreIntCov);
+      const std::shared_ptr<MarginalRecord> Prior = std::make_shared<MarginalRecord>();
+      std::vector<double*> StatePointers;
+      for (uint32_t nState = 0; nState < Number; nState++)
+      {
+        StateID ID;
+        int32_t Type = 0;
+        int32_t LocalSize = 0;
+        int32_t GlobalSize = 0;
+        Vector LinearizationPoint;
+        if (!Reader.readStateID(ID) || !Reader.read(Type) || !Reader.read(LocalSize) || !Reader.read(GlobalSize) ||
+            !Reader.readMatrix(LinearizationPoint))
+        {
+          return Corrupted();
+        }
 
-    /** add to factor graph */
-    using FactorClassType = typename FactorTypeTranslator<FactorType::IMUPretintegration, GaussianFull<15>>::Type;
-    addFactorGeneric_<GaussianFull<15>, FactorClassType> (IMUNoiseModel,
-                                                          List.List_,
-                                                          FactorType::IMUPretintegration,
-                                                          nullptr,
-                                                          true,
-                                                          List.List_.front().Timestamp,
-                                                          IMUState);
-  }
+        /** the prior has to fit the restored state */
+        if (!StateData_.checkElement(ID.ID, ID.Timestamp, ID.Number) || LocalSize < 0 ||
+            GlobalSize != static_cast<int32_t>(StateData_.getElement(ID.ID, ID.Timestamp, ID.Number).getMean().size()) ||
+            GlobalSize != static_cast<int32_t>(LinearizationPoint.size()))
+        {
+          PRINT_ERROR("Marginal prior of checkpoint does not match its states: ", Filename);
+          return false;
+        }
 
-  void FactorGraph::printReport() const
-  {
-    std::cout << Report_.FullReport() << "\n";
+        Prior->States.push_back(ID);
+        Prior->Types.push_back(static_cast<DataType>(Type));
+        Prior->LocalSize.push_back(LocalSize);
+        Prior->GlobalSize.push_back(GlobalSize);
+        Prior->LinearizationPoints.push_back(LinearizationPoint);
+
+        DataType StateType;
+        StatePointers.push_back(this->getStatePointer_(ID, StateType));
+      }
+
+      if (Number == 0 || !Reader.readMatrix(Prior->Jacobian) || !Reader.readMatrix(Prior->Residual))
+      {
+        return Corrupted();
+      }
+
+      const int LocalSizeSum = std::accumulate(Prior->LocalSize.begin(), Prior->LocalSize.end(), 0);
+      if (Prior->Jacobian.cols() != LocalSizeSum || Prior->Jacobian.rows() != Prior->Residual.size())
+      {
+        PRINT_ERROR("Marginal prior of checkpoint has a wrong size: ", Filename);
+        return false;
+      }
+      this->addMarginalPrior_(Prior, StatePointers);
+    }
+
+    for (const auto &Type : Types)
+    {
+      Structure_.setErrorModelsEnabled(Type.first, Type.second);
+    }
+
+    return true;
   }
 
   ceres::Solver::Summary FactorGraph::getSolverSummary() const
@@ -191,8 +1700,15 @@ namespace libRSF
     return Report_;
   }
 
-  void FactorGraph::setConstant(const string& Name, const double Timestamp)
+  void FactorGraph::setConstant(const StateKey &Name, const double Timestamp)
   {
+    const TraceScope_ Trace(*this, TraceOperation::SetConstant);
+    if (Trace.Writer != nullptr)
+    {
+      Trace.Writer->writeString(Name.getName());
+      Trace.Writer->write(Timestamp);
+    }
+
     for (int StateNumber = StateData_.countElement(Name, Timestamp); StateNumber > 0; --StateNumber)
     {
       Graph_.SetParameterBlockConstant(
@@ -200,8 +1716,15 @@ namespace libRSF
     }
   }
 
-  void FactorGraph::setVariable(const string& Name, const double Timestamp)
+  void FactorGraph::setVariable(const StateKey &Name, const double Timestamp)
   {
+    const TraceScope_ Trace(*this, TraceOperation::SetVariable);
+    if (Trace.Writer != nullptr)
+    {
+      Trace.Writer->writeString(Name.getName());
+      Trace.Writer->write(Timestamp);
+    }
+
     for (int StateNumber = StateData_.countElement(Name, Timestamp); StateNumber > 0; --StateNumber)
     {
       Graph_.SetParameterBlockVariable(
@@ -209,15 +1732,14 @@ namespace libRSF
     }
   }
 
-  void FactorGraph::setSubsetConstant(const string& Name, const double Timestamp, const int Number, const std::vector<int> &ConstantIndex)
+  void FactorGraph::setSubsetConstant(const StateKey &Name, const double Timestamp, const int Number, const std::vector<int> &ConstantIndex)
   {
-    Graph_.SetParameterization(
-        StateData_.getElement(Name, Timestamp, Number).getMeanPointer(),
-                               new ceres::SubsetParameterization(
-            StateData_.getElement(Name, Timestamp, Number).getMean().size(), ConstantIndex));
+    Data &State = StateData_.getElement(Name, Timestamp, Number);
+    Graph_.SetParameterization(State.getMeanPointer(),
+                               Parameterizations_.get<ceres::SubsetParameterization>(static_cast<int>(State.getMean().size()), ConstantIndex));
   }
 
-  void FactorGraph::setUpperBound(const string &Name, const double Timestamp, const int StateNumber, const Vector &Bound)
+  void FactorGraph::setUpperBound(const StateKey &Name, const double Timestamp, const int StateNumber, const Vector &Bound)
   {
     const int Dim = static_cast<int>(
         StateData_.getElement(Name, Timestamp, StateNumber).getMean().size());
@@ -236,7 +1758,7 @@ namespace libRSF
     }
   }
 
-  void FactorGraph::setLowerBound(const string &Name, const double Timestamp, const int StateNumber, const Vector &Bound)
+  void FactorGraph::setLowerBound(const StateKey &Name, const double Timestamp, const int StateNumber, const Vector &Bound)
   {
     const int Dim = static_cast<int>(
         StateData_.getElement(Name, Timestamp, StateNumber).getMean().size());
@@ -257,6 +1779,19 @@ namespace libRSF
 
   bool FactorGraph::marginalizeStates(std::vector<StateID> States, const double Inflation)
   {
+    const TraceScope_ Trace(*this, TraceOperation::MarginalizeStates, true);
+    if (Trace.Writer != nullptr)
+    {
+      Trace.Writer->write(static_cast<uint32_t>(States.size()));
+      for (const StateID &State : States)
+      {
+        Trace.Writer->writeStateID(State);
+      }
+      Trace.Writer->write(Inflation);
+    }
+
+    LIBRSF_TRACE_SCOPE("marginalize");
+
     /** time measurement */
     Timer MargTimer;
 
@@ -272,15 +1807,15 @@ namespace libRSF
     for (const StateID &State : States)
     {
       /** check if this is a set of valid states */
-      if (!this->StateData_.checkElement(State.ID, State.Timestamp, State.Number))
+      if (!this->StateData_.checkElement(State.ID, State.getTimestamp(), State.Number))
       {
-        PRINT_ERROR("State doesn't exist at: ", State.Timestamp, " Type: ", State.ID, " Number: ", State.Number);
+        PRINT_ERROR("State doesn't exist at: ", State.getTimestamp(), " Type: ", State.ID, " Number: ", State.Number);
         return false;
       }
 
       /** store pointer */
       MarginalStates.push_back(
-          StateData_.getElement(State.ID, State.Timestamp, State.Number).getMeanPointer());
+          StateData_.getElement(State.ID, State.getTimestamp(), State.Number).getMeanPointer());
 
       /** compute size of the marginalized system */
       MarginalSize += Graph_.ParameterBlockLocalSize(MarginalStates.back());
@@ -300,7 +1835,7 @@ namespace libRSF
       /** calculate mean and uncertainty*/
       ceres::Problem::EvaluateOptions Options;
       Options.apply_loss_function = true;
-      Options.num_threads = static_cast<int>(std::thread::hardware_concurrency());
+      Options.num_threads = GetThreadNumber();
 
       /** set which states should be evaluated (base + the connected ones) */
       std::vector<double*> CombinedStates;
@@ -316,58 +1851,183 @@ namespace libRSF
       std::vector<double> ResidualVec;
       Graph_.Evaluate(Options, nullptr, &ResidualVec, nullptr, &JacobianCRS);
 
-      /** map error to vector */
-      Vector Residuals = Eigen::Map<Vector, Eigen::Unaligned>(ResidualVec.data(), ResidualVec.size());
+      /** accumulate the normal equations directly from the residual blocks */
+      SparseMatrix Hessian;
+      Vector B;
+      ComputeNormalEquations(JacobianCRS, ResidualVec, Hessian, B);
+
+      /** compute marginalization */
+      Matrix JacobianMarg;
+      Vector ResidualMarg;
+      MarginalizeHessian(Hessian, B, ResidualMarg, JacobianMarg, MarginalSize, Inflation, MarginalCompression_);
+
+      if (JacobianMarg.rows() > 0)
+      {
+        /** split into independent priors */
+        const std::vector<std::vector<int>> Groups = SplitMarginal(JacobianMarg, LocalSize);
+
+        std::vector<int> ColumnStart(LocalSize.size(), 0);
+        for (int n = 1; n < static_cast<int>(LocalSize.size()); n++)
+        {
+          ColumnStart.at(n) = ColumnStart.at(n - 1) + LocalSize.at(n - 1);
+        }
+
+        for (const std::vector<int> &Group : Groups)
+        {
+          std::vector<double*> GroupStates;
+          const std::shared_ptr<MarginalRecord> Prior = std::make_shared<MarginalRecord>();
+          std::vector<Index> Columns;
+
+          for (int n : Group)
+          {
+            GroupStates.push_back(ConnectedStates.at(n));
+            Prior->GlobalSize.push_back(GlobalSize.at(n));
+            Prior->LocalSize.push_back(LocalSize.at(n));
+            Prior->States.push_back(StateIDs.at(n));
+            Prior->Types.push_back(StateTypes.at(n));
+
+            /** store original states */
+            VectorRef<double, Dynamic> State(ConnectedStates.at(n), GlobalSize.at(n));
+            Prior->LinearizationPoints.emplace_back(State);
+
+            for (int Col = 0; Col < LocalSize.at(n); Col++)
+            {
+              Columns.push_back(ColumnStart.at(n) + Col);
+            }
+          }
+
+          /** select the rows that belong to this group */
+          std::vector<Index> Rows;
+          for (Index Row = 0; Row < JacobianMarg.rows(); Row++)
+          {
+            bool IsConnected = false;
+            for (Index Col : Columns)
+            {
+              IsConnected = IsConnected || (JacobianMarg(Row, Col) != 0.0);
+            }
+            if (IsConnected)
+            {
+              Rows.push_back(Row);
+            }
+          }
 
-      /** convert into eigen matrix */
-      Matrix Jacobian;
-      CRSToMatrix(JacobianCRS, Jacobian);
+          /** states without information do not need a prior */
+          if (Rows.empty())
+          {
+            continue;
+          }
 
-      /** compute marginalization */
-      Matrix JacobianMarg;
-      Vector ResidualMarg;
-      Marginalize(Residuals, Jacobian, ResidualMarg, JacobianMarg, MarginalSize, Inflation);
+          Prior->Jacobian.resize(Rows.size(), Columns.size());
+          Prior->Residual.resize(Rows.size());
+          for (Index Row = 0; Row < static_cast<Index>(Rows.size()); Row++)
+          {
+            for (Index Col = 0; Col < static_cast<Index>(Columns.size()); Col++)
+            {
+              Prior->Jacobian(Row, Col) = JacobianMarg(Rows.at(Row), Columns.at(Col));
+            }
+            Prior->Residual(Row) = ResidualMarg(Rows.at(Row));
+          }
 
-      /** store original states */
-      std::vector<Vector> OriginalStates;
-      for (int n = 0; n < static_cast<int>(ConnectedStates.size()); n++)
+          this->addMarginalPrior_(Prior, GroupStates);
+        }
+      }
+      else
       {
-        VectorRef<double, Dynamic> State(ConnectedStates.at(n), GlobalSize.at(n));
-        OriginalStates.emplace_back(State);
+        PRINT_WARNING("Marginal prior contains no information. Marginalized states get deleted directly!");
       }
 
-      /** add factor */
-      ceres::ResidualBlockId ID =
-          Graph_.AddResidualBlock(new MarginalPrior(LocalSize,
-                                  GlobalSize,
-                                  OriginalStates,
-                                  StateTypes,
-                                  JacobianMarg,
-                                  ResidualMarg),
-                                  nullptr,
-                                  ConnectedStates);
-
-      /** add factor to internal structure */
-      Structure_.addFactor<ErrorModel<0, 0>>(FactorType::Marginal, StateIDs.front().Timestamp, ID, nullptr, StateIDs, ConnectedStates, StateTypes);
-
-      MarginalizationDuration_ += MargTimer.getSeconds();
+      const double Duration = MargTimer.getSeconds();
+      MarginalizationDuration_ += Duration;
+      if (Metrics_ != nullptr)
+      {
+        Metrics_->Marginalization.record(Duration);
+      }
     }
     else
     {
       PRINT_WARNING("No connected states in marginalization. Marginalized states get deleted directly!");
     }
 
-    /** remove marginalized states in reverse order */
-    std::reverse(States.begin(), States.end());
-    for (const StateID &State : States)
+    /** remove marginalized states at once */
+    this->removeStates_(States);
+
+    return true;
+  }
+
+  void FactorGraph::addMarginalPrior_(const std::shared_ptr<MarginalRecord> &Record, const std::vector<double*> &StatePointers,
+                                      const FactorType Type)
+  {
+    /** add factor */
+    ceres::ResidualBlockId ID =
+        Graph_.AddResidualBlock(this->wrapCostFunction_(Type,
+                                Pool_.create<MarginalPrior>(Type,
+                                Record->LocalSize,
+                                Record->GlobalSize,
+                                Record->LinearizationPoints,
+                                Record->Types,
+                                Record->Jacobian,
+                                Record->Residual)),
+                                nullptr,
+                                StatePointers);
+
+    /** add factor to internal structure */
+    Structure_.addFactor<ErrorModel<0, 0>>(Type, Record->States.front().getTimestamp(), ID, nullptr, Record->States, StatePointers, Record->Types);
+
+    /** state priors are set again by their owner, e.g. in every round of a segmented batch */
+    if (CheckpointRecording_ && Type == FactorType::Marginal)
+    {
+      CheckpointMarginals_.erase(ID);
+      CheckpointMarginals_.emplace(ID, Record);
+    }
+  }
+
+  bool FactorGraph::addStatePrior(const StateID &State, const Vector &Mean, const Matrix &SqrtInformation)
+  {
+    const TraceScope_ Trace(*this, TraceOperation::AddStatePrior);
+    if (Trace.Writer != nullptr)
+    {
+      Trace.Writer->writeStateID(State);
+      Trace.Writer->writeMatrix(Mean);
+      Trace.Writer->writeMatrix(SqrtInformation);
+    }
+
+    if (!StateData_.checkElement(State.ID, State.getTimestamp(), State.Number))
+    {
+      PRINT_ERROR("State doesn't exist: ", State.ID, " at ", State.getTimestamp());
+      return false;
+    }
+
+    DataType Type;
+    double* const StatePointer = this->getStatePointer_(State, Type);
+    if (!Graph_.HasParameterBlock(StatePointer))
+    {
+      PRINT_ERROR("State is not part of the problem: ", State.ID, " at ", State.getTimestamp());
+      return false;
+    }
+
+    const int GlobalSize = Graph_.ParameterBlockSize(StatePointer);
+    const int LocalSize = Graph_.ParameterBlockLocalSize(StatePointer);
+    if (Mean.size() != GlobalSize || SqrtInformation.cols() != LocalSize)
     {
-      this->removeState(State.ID, State.Timestamp, State.Number);
+      PRINT_ERROR("Wrong dimension of the prior for: ", State.ID, " Mean: ", Mean.size(), " Information: ", SqrtInformation.cols());
+      return false;
     }
 
+    /** a marginal prior with the mean as linearization point and no residual */
+    const std::shared_ptr<MarginalRecord> Prior = std::make_shared<MarginalRecord>();
+    Prior->States.push_back(State);
+    Prior->Types.push_back(Type);
+    Prior->LocalSize.push_back(LocalSize);
+    Prior->GlobalSize.push_back(GlobalSize);
+    Prior->LinearizationPoints.push_back(Mean);
+    Prior->Jacobian = SqrtInformation;
+    Prior->Residual = Vector::Zero(SqrtInformation.rows());
+
+    this->addMarginalPrior_(Prior, {StatePointer}, FactorType::StatePrior);
     return true;
   }
 
-  bool FactorGraph::marginalizeState(const string& Name, const double Timestamp, const int Number)
+  bool FactorGraph::marginalizeState(const StateKey &Name, const double Timestamp, const int Number)
   {
     std::vector<StateID> SingleState;
     SingleState.emplace_back(StateID(Name, Timestamp, Number));
@@ -377,13 +2037,20 @@ namespace libRSF
 
   bool FactorGraph::marginalizeAllStatesOutsideWindow(const double TimeWindow, const double CurrentTime, const double Inflation)
   {
+    const TraceScope_ Trace(*this, TraceOperation::MarginalizeOutsideWindow, true);
+    if (Trace.Writer != nullptr)
+    {
+      Trace.Writer->write(TimeWindow);
+      Trace.Writer->write(CurrentTime);
+      Trace.Writer->write(Inflation);
+    }
+
     /** calculate time boarder */
     const double CutTime = roundToTick(CurrentTime - TimeWindow);
 
     /** check if marginalization is required before doing anything  */
     double TimeFirst = CutTime;
-    StateData_.getTimeFirstOverall(TimeFirst);
-    if (TimeFirst > CutTime)
+    if (!this->getTimeFirstInWindow(TimeFirst) || TimeFirst > CutTime)
     {
       /** no marginalization required, exit here... */
       return true;
@@ -392,29 +2059,25 @@ namespace libRSF
     /** collect relevant states */
     std::vector<StateID> States;
 
-    /** iterate over state names */
-    const std::vector<string> StateNames = StateData_.getKeysAll();
-    for (const string &Name : StateNames)
+    /** iterate only over state names with an element below cut time */
+    for (const StateKey &Name : StateData_.getKeysBeforeOrEqual(CutTime))
     {
-      /** check if there is an element below cut time */
-      double TimeFirstState;
-      if (StateData_.getTimeFirst(Name, TimeFirstState))
+      if (this->isWindowExempt(Name))
+      {
+        continue;
+      }
+
+      /** iterate over timestamps */
+      std::vector<double> Times;
+      if (StateData_.getTimesBelowOrEqual(Name, CutTime, Times))
       {
-        if (TimeFirstState <= CutTime)
+        for (const double Time : Times)
         {
-          /** iterate over timestamps */
-          std::vector<double> Times;
-          if (StateData_.getTimesBelowOrEqual(Name, CutTime, Times))
+          /** iterate over number */
+          const int Numbers = StateData_.countElement(Name, Time);
+          for (int n = 0; n < Numbers; n++)
           {
-            for (const double Time : Times)
-            {
-              /** iterate over number */
-              const int Numbers = StateData_.countElement(Name, Time);
-              for (int n = 0; n < Numbers; n++)
-              {
-                States.emplace_back(StateID(Name, Time, n));
-              }
-            }
+            States.emplace_back(StateID(Name, Time, n));
           }
         }
       }
@@ -424,32 +2087,185 @@ namespace libRSF
     return this->marginalizeStates(States, Inflation);
   }
 
-  bool FactorGraph::computeCovariance(const string& Name, const double Timestamp)
+  bool FactorGraph::computeCovariance(const StateKey &Name, const double Timestamp)
   {
+    LIBRSF_TRACE_SCOPE("covariance");
+
     /** time measurement */
     Timer CovTimer;
 
     const bool Success = CalculateCovariance(Graph_, StateData_, Name, Timestamp);
 
-    CovarianceDuration_ += CovTimer.getSeconds();
+    this->recordCovariance_(CovTimer.getSeconds());
 
     return Success;
   }
 
-  bool FactorGraph::computeCovariance(const string& Name)
+  bool FactorGraph::computeCovariance(const StateKey &Name)
   {
+    LIBRSF_TRACE_SCOPE("covariance");
+
     /** time measurement */
     Timer CovTimer;
 
     const bool Success = CalculateCovariance(Graph_, StateData_, Name);
 
-    CovarianceDuration_ += CovTimer.getSeconds();
+    this->recordCovariance_(CovTimer.getSeconds());
+
+    return Success;
+  }
+
+  bool FactorGraph::computeCovariances(const std::vector<string>& Names, std::vector<CrossCovariance>* CrossCovariances)
+  {
+    LIBRSF_TRACE_SCOPE("covariance");
+
+    /** time measurement */
+    Timer CovTimer;
+
+    const bool Success = CalculateCovariance(Graph_, StateData_, Names, CrossCovariances);
+
+    this->recordCovariance_(CovTimer.getSeconds());
+
+    return Success;
+  }
+
+  bool FactorGraph::computeMarginalCovariance(const StateKey &Name, const double Timestamp)
+  {
+    LIBRSF_TRACE_SCOPE("marginal_covariance");
+
+    /** time measurement */
+    Timer CovTimer;
+
+    if (StateData_.countElement(Name, Timestamp) < 1)
+    {
+      PRINT_ERROR("Covariance computation of ", Name, " went wrong. No ", Name, " at ", Timestamp, "s in state data!");
+      return false;
+    }
+
+    std::vector<const double*> States;
+    for (int n = 0; n < StateData_.countElement(Name, Timestamp); n++)
+    {
+      States.push_back(StateData_.getElement(Name, Timestamp, n).getMeanPointer());
+    }
+
+    bool Success = true;
+    for (int n = 0; n < static_cast<int>(States.size()) && Success; n++)
+    {
+      /** factorize again only if the graph was changed */
+      if (!CovarianceCache_.hasState(States.at(n)) || Structure_.countChangedStates() > 0)
+      {
+        /** all states at this timestamp are ordered last, so following requests are cheap as well */
+        std::vector<const double*> LastStates;
+        for (const StateKey &ID : StateData_.getKeysAll())
+        {
+          for (int m = 0; m < StateData_.countElement(ID, Timestamp); m++)
+          {
+            LastStates.push_back(StateData_.getElement(ID, Timestamp, m).getMeanPointer());
+          }
+        }
+
+        Success = CovarianceCache_.compute(Graph_, LastStates);
+      }
+
+      Success = Success && CovarianceCache_.getCovarianceBlock(Graph_, States.at(n),
+                                                               StateData_.getElement(Name, Timestamp, n).getDataPointer(DataElement::Covariance));
+    }
+
+    this->recordCovariance_(CovTimer.getSeconds());
+
+    /** use ceres as fallback */
+    if (!Success)
+    {
+      return this->computeCovariance(Name, Timestamp);
+    }
+
+    return true;
+  }
+
+  bool FactorGraph::computeMarginalCovariance(const StateKey &Name)
+  {
+    LIBRSF_TRACE_SCOPE("marginal_covariance");
+
+    double Timestamp;
+    if (!StateData_.getTimeFirst(Name, Timestamp))
+    {
+      PRINT_ERROR("Covariance computation of ", Name, " went wrong. No ", Name, " in state data!");
+      return false;
+    }
+
+    bool Success = true;
+    do
+    {
+      Success = this->computeMarginalCovariance(Name, Timestamp) && Success;
+    }
+    while (StateData_.getTimeNext(Name, Timestamp, Timestamp));
 
     return Success;
   }
 
-  bool FactorGraph::computeCovarianceSigmaPoints(const string& Name, const double Timestamp, const int StateNumber)
+  bool FactorGraph::computeCovarianceIncremental(const StateKey &Name, const double Timestamp)
+  {
+    LIBRSF_TRACE_SCOPE("incremental_covariance");
+
+    /** time measurement */
+    Timer CovTimer;
+
+    if (StateData_.countElement(Name, Timestamp) < 1)
+    {
+      PRINT_ERROR("Covariance computation of ", Name, " went wrong. No ", Name, " at ", Timestamp, "s in state data!");
+      return false;
+    }
+
+    /** all variable states of this epoch */
+    std::vector<double*> Epoch;
+    for (const StateKey &ID : StateData_.getKeysAll())
+    {
+      for (int m = 0; m < StateData_.countElement(ID, Timestamp); m++)
+      {
+        double* const State = StateData_.getElement(ID, Timestamp, m).getMeanPointer();
+        if (Graph_.HasParameterBlock(State) && !Graph_.IsParameterBlockConstant(State))
+        {
+          Epoch.push_back(State);
+        }
+      }
+    }
+
+    /** propagate or start again from the exact solution */
+    bool Success = !CovarianceTracker_.needsAnchor() && CovarianceTracker_.propagate(Graph_, Epoch);
+    if (!Success)
+    {
+      const std::vector<const double*> LastStates(Epoch.begin(), Epoch.end());
+      Matrix Covariance;
+      Success = CovarianceCache_.compute(Graph_, LastStates)
+                && CovarianceCache_.getJointCovariance(LastStates, Covariance)
+                && CovarianceTracker_.anchor(Graph_, Epoch, Covariance);
+    }
+
+    for (int n = 0; n < StateData_.countElement(Name, Timestamp) && Success; n++)
+    {
+      Data &State = StateData_.getElement(Name, Timestamp, n);
+      if (CovarianceTracker_.hasState(State.getMeanPointer()))
+      {
+        Success = CovarianceTracker_.getCovarianceBlock(Graph_, State.getMeanPointer(), State.getDataPointer(DataElement::Covariance));
+      }
+    }
+
+    this->recordCovariance_(CovTimer.getSeconds());
+
+    /** use the exact marginal as fallback */
+    if (!Success)
+    {
+      CovarianceTracker_.reset();
+      return this->computeMarginalCovariance(Name, Timestamp);
+    }
+
+    return true;
+  }
+
+  bool FactorGraph::computeCovarianceSigmaPoints(const StateKey &Name, const double Timestamp, const int StateNumber)
   {
+    LIBRSF_TRACE_SCOPE("covariance_sigma_points");
+
     switch (
         StateData_.getElement(Name, Timestamp, StateNumber).getMean().size())
     {
@@ -482,17 +2298,25 @@ namespace libRSF
     return false;
   }
 
+  bool FactorGraph::computeCovarianceSigmaPoints(const std::vector<StateID> &States)
+  {
+    LIBRSF_TRACE_SCOPE("covariance_sigma_points");
+
+    return EstimateCovarianceSigmaPoints(Graph_, StateData_, States);
+  }
+
   void FactorGraph::sampleCost1D(const string& StateName,
                                  const double Timestamp,
                                  const int Number,
                                  const int PointCount,
                                  const double Range,
                                  StateDataSet &Result,
-                                 const bool OptimizeOther)
+                                 const bool OptimizeOther,
+                                 const bool ComputeHessian)
   {
     EvaluateCostSurface<1>(
         Graph_,
-        StateData_.getElement(StateName, Timestamp, Number).getMeanPointer(), PointCount, Range, Result, OptimizeOther);
+        StateData_.getElement(StateName, Timestamp, Number).getMeanPointer(), PointCount, Range, Result, OptimizeOther, ComputeHessian);
   }
 
   void FactorGraph::sampleCost2D(const string& StateName,
@@ -500,11 +2324,12 @@ namespace libRSF
                                  const int Number,
                                  const int PointCount,
                                  const double Range,
-                                 StateDataSet &Result)
+                                 StateDataSet &Result,
+                                 const bool ComputeHessian)
   {
     EvaluateCostSurface<2>(
         Graph_,
-        StateData_.getElement(StateName, Timestamp, Number).getMeanPointer(), PointCount, Range, Result);
+        StateData_.getElement(StateName, Timestamp, Number).getMeanPointer(), PointCount, Range, Result, false, ComputeHessian);
   }
 
   void FactorGraph::sampleCost3D(const string& StateName,
@@ -512,11 +2337,41 @@ namespace libRSF
                                  const int Number,
                                  const int PointCount,
                                  const double Range,
-                                 StateDataSet &Result)
+                                 StateDataSet &Result,
+                                 const bool ComputeHessian)
   {
     EvaluateCostSurface<3>(
         Graph_,
-        StateData_.getElement(StateName, Timestamp, Number).getMeanPointer(), PointCount, Range, Result);
+        StateData_.getElement(StateName, Timestamp, Number).getMeanPointer(), PointCount, Range, Result, false, ComputeHessian);
+  }
+
+  void FactorGraph::sampleCostAdaptive(const string& StateName,
+                                       const double Timestamp,
+                                       const int Number,
+                                       const int PointBudget,
+                                       const double Range,
+                                       StateDataSet &Result,
+                                       const bool ComputeHessian)
+  {
+    Data &State = StateData_.getElement(StateName, Timestamp, Number);
+    switch (State.getMean().size())
+    {
+      case 1:
+        EvaluateCostSurfaceAdaptive<1>(Graph_, State.getMeanPointer(), PointBudget, Range, Result, ComputeHessian);
+        break;
+
+      case 2:
+        EvaluateCostSurfaceAdaptive<2>(Graph_, State.getMeanPointer(), PointBudget, Range, Result, ComputeHessian);
+        break;
+
+      case 3:
+        EvaluateCostSurfaceAdaptive<3>(Graph_, State.getMeanPointer(), PointBudget, Range, Result, ComputeHessian);
+        break;
+
+      default:
+        PRINT_ERROR("Adaptive cost sampling is not implemented for ", State.getMean().size(), " dimensional states!");
+        break;
+    }
   }
 
   StateDataSet &FactorGraph::getStateData()
@@ -524,8 +2379,16 @@ namespace libRSF
     return StateData_;
   }
 
-  void FactorGraph::removeState(const string& Name, double Timestamp, int Number)
+  void FactorGraph::removeState(const StateKey &Name, double Timestamp, int Number)
   {
+    const TraceScope_ Trace(*this, TraceOperation::RemoveState);
+    if (Trace.Writer != nullptr)
+    {
+      Trace.Writer->writeString(Name.getName());
+      Trace.Writer->write(Timestamp);
+      Trace.Writer->write(static_cast<int32_t>(Number));
+    }
+
     /** safety check */
     if (StateData_.checkElement(Name, Timestamp, Number))
     {
@@ -534,8 +2397,7 @@ namespace libRSF
       Structure_.removeState(State);
 
       /** remove from ceres */
-      Graph_.RemoveParameterBlock(
-          StateData_.getElement(Name, Timestamp, Number).getMeanPointer());
+      this->removeParameterBlock_(StateData_.getElement(Name, Timestamp, Number).getMeanPointer());
 
       /** remove from our StateDataSet */
       StateData_.removeElement(Name, Timestamp, Number);
@@ -546,8 +2408,15 @@ namespace libRSF
     }
   }
 
-  void FactorGraph::removeState(const string& Name, const double Timestamp)
+  void FactorGraph::removeState(const StateKey &Name, const double Timestamp)
   {
+    const TraceScope_ Trace(*this, TraceOperation::RemoveStates);
+    if (Trace.Writer != nullptr)
+    {
+      Trace.Writer->writeString(Name.getName());
+      Trace.Writer->write(Timestamp);
+    }
+
     if (StateData_.checkElement(Name, Timestamp))
     {
       /** remove from ceres::problem */
@@ -558,8 +2427,7 @@ namespace libRSF
         Structure_.removeState(State);
 
         /** remove from ceres */
-        Graph_.RemoveParameterBlock(
-            StateData_.getElement(Name, Timestamp, StateNumber - 1).getMeanPointer());
+        this->removeParameterBlock_(StateData_.getElement(Name, Timestamp, StateNumber - 1).getMeanPointer());
 
         /** remove from our StateDataSet */
         StateData_.removeElement(Name, Timestamp, StateNumber - 1);
@@ -571,39 +2439,244 @@ namespace libRSF
     }
   }
 
-  void FactorGraph::removeStatesOutsideWindow(const string& Name, const double TimeWindow, const double CurrentTime)
+  void FactorGraph::removeStatesOutsideWindow(const StateKey &Name, const double TimeWindow, const double CurrentTime)
   {
+    const TraceScope_ Trace(*this, TraceOperation::RemoveStatesOutsideWindow);
+    if (Trace.Writer != nullptr)
+    {
+      Trace.Writer->writeString(Name.getName());
+      Trace.Writer->write(TimeWindow);
+      Trace.Writer->write(CurrentTime);
+    }
+
     const double CutTime = CurrentTime - TimeWindow;
     double Timestamp;
     bool TimestampExists;
 
-    /** loop over timestamps */
-    TimestampExists = StateData_.getTimeFirst(Name, Timestamp);
-    if (TimestampExists)
+    /** loop over timestamps */
+    TimestampExists = StateData_.getTimeFirst(Name, Timestamp);
+    if (TimestampExists)
+    {
+      while ((Timestamp <= CutTime) && TimestampExists)
+      {
+        double TimestampTemp = Timestamp;
+        TimestampExists = StateData_.getTimeNext(Name, Timestamp, Timestamp);
+        removeState(Name, TimestampTemp);
+      }
+    }
+    else
+    {
+      PRINT_ERROR("State Type doesn't exist: ", Name);
+    }
+  }
+
+  void FactorGraph::removeAllStatesOutsideWindow(const double TimeWindow, const double CurrentTime)
+  {
+    const TraceScope_ Trace(*this, TraceOperation::RemoveAllStatesOutsideWindow);
+    if (Trace.Writer != nullptr)
+    {
+      Trace.Writer->write(TimeWindow);
+      Trace.Writer->write(CurrentTime);
+    }
+
+    this->removeStatesBefore_(CurrentTime - TimeWindow, true);
+  }
+
+  bool FactorGraph::removeStates(const std::vector<StateID> &States)
+  {
+    const TraceScope_ Trace(*this, TraceOperation::RemoveStateList);
+    if (Trace.Writer != nullptr)
+    {
+      Trace.Writer->write(static_cast<uint32_t>(States.size()));
+      for (const StateID &State : States)
+      {
+        Trace.Writer->writeStateID(State);
+      }
+    }
+
+    if (States.empty())
+    {
+      return true;
+    }
+    return this->removeStates_(States, true);
+  }
+
+  void FactorGraph::reset()
+  {
+    /** a trace describes a single run */
+    this->stopTrace();
+    TraceDepth_ = 0;
+    TraceIsComplete_ = true;
+
+    /** removing all states removes all factors, the cost functions go back to the pool */
+    std::vector<StateID> States;
+    for (const StateKey &Name : StateData_.getKeysAll())
+    {
+      std::vector<double> Times;
+      StateData_.getTimesOfID(Name, Times);
+      for (const double Time : Times)
+      {
+        const int Numbers = StateData_.countElement(Name, Time);
+        for (int n = 0; n < Numbers; n++)
+        {
+          States.emplace_back(StateID(Name, Time, n));
+        }
+      }
+    }
+    if (!States.empty())
+    {
+      this->removeStates_(States, false);
+    }
+    StateData_.clear();
+
+    /** records of the removed factors */
+    IMUFactors_.clear();
+    CheckpointFactors_.clear();
+    CheckpointMarginals_.clear();
+    Iterations_.clear();
+    FactorTimings_.clear();
+
+    /** caches of the old solution */
+    CovarianceCache_.reset();
+    CovarianceTracker_.reset();
+    RawErrorCache_.invalidate();
+    StateCache_.fill(CachedState());
+    StateCacheNext_ = 0;
+
+    /** a store that is shared with other graphs is left to them */
+    if (Satellites_.use_count() == 1)
+    {
+      Satellites_->clear();
+    }
+    else
+    {
+      Satellites_ = std::make_shared<SatelliteStore>();
+    }
+
+    /** settings as after the construction */
+    WindowExempt_.clear();
+    Publisher_.reset();
+    Metrics_.reset();
+    FactorTiming_ = false;
+    IterationTelemetry_ = false;
+    CheckpointRecording_ = false;
+    CheckpointSequence_ = 0;
+    SolveCounter_ = 0;
+    WarmStart_ = false;
+    WarmStartRadius_ = 0.0;
+    LandmarksFirst_ = false;
+    TimeChainOrdering_ = false;
+    DenseSolverThreshold_ = 0;
+    BackendSelection_ = false;
+    BackendBenchmarkIterations_ = 3;
+    IMURelinearizationThreshold_ = 0.0;
+    MarginalCompression_ = 0.0;
+    SolverOptions_ = ceres::Solver::Options();
+    Report_ = ceres::Solver::Summary();
+
+    SolverDuration_ = 0.0;
+    SolverIterations_ = 0;
+    DeadlineMisses_ = 0;
+    MarginalizationDuration_ = 0.0;
+    CovarianceDuration_ = 0.0;
+  }
+
+  void FactorGraph::removeStatesBefore_(const double CutTime, const bool KeepExempt)
+  {
+    /** collect all states of all types */
+    std::vector<StateID> States;
+    std::vector<StateKey> Names;
+    for (const StateKey &Name : StateData_.getKeysBeforeOrEqual(CutTime))
+    {
+      if (KeepExempt && this->isWindowExempt(Name))
+      {
+        continue;
+      }
+      Names.push_back(Name);
+
+      std::vector<double> Times;
+      StateData_.getTimesBelowOrEqual(Name, CutTime, Times);
+      for (const double Time : Times)
+      {
+        const int Numbers = StateData_.countElement(Name, Time);
+        for (int n = 0; n < Numbers; n++)
+        {
+          States.emplace_back(StateID(Name, Time, n));
+        }
+      }
+    }
+
+    /** the data set is cut with one erase per state name */
+    if (this->removeStates_(States, false))
+    {
+      for (const StateKey &Name : Names)
+      {
+        StateData_.removeElementsBeforeOrEqual(Name, CutTime);
+      }
+    }
+  }
+
+  bool FactorGraph::removeStates_(std::vector<StateID> States, const bool RemoveData)
+  {
+    LIBRSF_TRACE_SCOPE("remove_states");
+
+    /** remove higher numbers first, so the remaining numbers stay valid */
+    std::sort(States.begin(), States.end(), [](const StateID &A, const StateID &B)
+    {
+      if (A.ID != B.ID)
+      {
+        return A.ID < B.ID;
+      }
+      if (A.Tick != B.Tick)
+      {
+        return A.Tick < B.Tick;
+      }
+      return A.Number > B.Number;
+    });
+    States.erase(std::unique(States.begin(), States.end(), [](const StateID &A, const StateID &B)
+    {
+      return A == B;
+    }), States.end());
+
+    /** safety check */
+    for (const StateID &State : States)
     {
-      while ((Timestamp <= CutTime) && TimestampExists)
+      if (!StateData_.checkElement(State.ID, State.getTimestamp(), State.Number))
       {
-        double TimestampTemp = Timestamp;
-        TimestampExists = StateData_.getTimeNext(Name, Timestamp, Timestamp);
-        removeState(Name, TimestampTemp);
+        PRINT_ERROR("State doesn't exist at: ", State.getTimestamp(), " Type: ", State.ID, " Number: ", State.Number);
+        return false;
       }
     }
-    else
+
+    /** remove from internal lists, including all connected factors */
+    Structure_.removeStates(States);
+
+    /** remove from ceres, which also removes the connected residuals */
+    for (const StateID &State : States)
     {
-      PRINT_ERROR("State Type doesn't exist: ", Name);
+      this->removeParameterBlock_(StateData_.getElement(State.ID, State.getTimestamp(), State.Number).getMeanPointer());
     }
-  }
 
-  void FactorGraph::removeAllStatesOutsideWindow(const double TimeWindow, const double CurrentTime)
-  {
-    for (auto const &State : StateData_)
+    /** remove from our StateDataSet */
+    if (RemoveData)
     {
-      removeStatesOutsideWindow(State.first, TimeWindow, CurrentTime);
+      for (const StateID &State : States)
+      {
+        StateData_.removeElement(State.ID, State.getTimestamp(), State.Number);
+      }
     }
+    return true;
   }
 
   void FactorGraph::removeFactor(const FactorType CurrentFactorType, const double Timestamp)
   {
+    const TraceScope_ Trace(*this, TraceOperation::RemoveFactors);
+    if (Trace.Writer != nullptr)
+    {
+      Trace.Writer->write(static_cast<int32_t>(CurrentFactorType));
+      Trace.Writer->write(Timestamp);
+    }
+
     if (Structure_.checkFactor(CurrentFactorType, Timestamp))
     {
       /** loop over factors */
@@ -614,11 +2687,11 @@ namespace libRSF
         FactorID Factor(CurrentFactorType, Timestamp, FactorNumber - 1);
         Structure_.getResidualID(Factor, CeresID);
 
-        /** remove factor in ceres */
-        Graph_.RemoveResidualBlock(CeresID);
-
-        /** remove factor in libRSF */
+        /** remove factor in libRSF (before ceres, to track the connected states) */
         Structure_.removeFactor(Factor);
+
+        /** remove factor in ceres */
+        this->removeResidualBlock_(CeresID);
       }
     }
     else
@@ -627,8 +2700,42 @@ namespace libRSF
     }
   }
 
+  void FactorGraph::removeFactor(const FactorType CurrentFactorType, const double Timestamp, const int Number)
+  {
+    const TraceScope_ Trace(*this, TraceOperation::RemoveFactor);
+    if (Trace.Writer != nullptr)
+    {
+      Trace.Writer->write(static_cast<int32_t>(CurrentFactorType));
+      Trace.Writer->write(Timestamp);
+      Trace.Writer->write(static_cast<int32_t>(Number));
+    }
+
+    if (Structure_.checkFactor(CurrentFactorType, Timestamp, Number))
+    {
+      ceres::ResidualBlockId CeresID;
+      const FactorID Factor(CurrentFactorType, Timestamp, Number);
+      Structure_.getResidualID(Factor, CeresID);
+
+      /** remove factor in libRSF (before ceres, to track the connected states), the following numbers are shifted down */
+      Structure_.removeFactor(Factor);
+      this->removeResidualBlock_(CeresID);
+    }
+    else
+    {
+      PRINT_ERROR("Factor doesn't exist: ", CurrentFactorType, " at ", Timestamp, " number ", Number);
+    }
+  }
+
   void FactorGraph::removeFactorsOutsideWindow(const FactorType CurrentFactorType, const double TimeWindow, const double CurrentTime)
   {
+    const TraceScope_ Trace(*this, TraceOperation::RemoveFactorsOutsideWindow);
+    if (Trace.Writer != nullptr)
+    {
+      Trace.Writer->write(static_cast<int32_t>(CurrentFactorType));
+      Trace.Writer->write(TimeWindow);
+      Trace.Writer->write(CurrentTime);
+    }
+
     /** find start of the existing factors */
     double FirstTime;
     Structure_.getTimeFirst(CurrentFactorType, FirstTime);
@@ -653,16 +2760,96 @@ namespace libRSF
 
   void FactorGraph::removeAllFactorsOutsideWindow(const double TimeWindow, const double CurrentTime)
   {
-    std::vector<FactorType> Factors;
-    Structure_.getFactorTypes(Factors);
-    for (auto const &Factor : Factors)
+    const TraceScope_ Trace(*this, TraceOperation::RemoveAllFactorsOutsideWindow);
+    if (Trace.Writer != nullptr)
+    {
+      Trace.Writer->write(TimeWindow);
+      Trace.Writer->write(CurrentTime);
+    }
+
+    this->removeFactorsBefore_(roundToTick(CurrentTime - TimeWindow));
+  }
+
+  void FactorGraph::removeFactorsBefore_(const double CutTime)
+  {
+    LIBRSF_TRACE_SCOPE("remove_factors");
+
+    /** remove factor in libRSF (before ceres, to track the connected states) */
+    std::vector<ceres::ResidualBlockId> Factors;
+    Structure_.removeFactorsBeforeOrEqual(CutTime, Factors);
+
+    /** remove factor in ceres */
+    for (const ceres::ResidualBlockId CeresID : Factors)
+    {
+      this->removeResidualBlock_(CeresID);
+    }
+  }
+
+  void FactorGraph::removeResidualBlock_(const ceres::ResidualBlockId CeresID)
+  {
+    /** ceres does not own the cost function, so it has to be fetched before */
+    const ceres::CostFunction* CostFunction = Graph_.GetCostFunctionForResidualBlock(CeresID);
+    const ceres::LossFunction* LossFunction = Graph_.GetLossFunctionForResidualBlock(CeresID);
+    Graph_.RemoveResidualBlock(CeresID);
+    Pool_.destroy(const_cast<ceres::CostFunction*>(CostFunction));
+    Losses_.release(const_cast<ceres::LossFunction*>(LossFunction));
+    this->forgetFactor_(CeresID);
+  }
+
+  void FactorGraph::removeParameterBlock_(double* State)
+  {
+    /** state numbers may change after a removal */
+    StateCache_.fill(CachedState());
+
+    /** ceres removes all connected residuals implicitly */
+    std::vector<ceres::ResidualBlockId> ConnectedFactors;
+    Graph_.GetResidualBlocksForParameterBlock(State, &ConnectedFactors);
+
+    std::vector<const ceres::CostFunction*> CostFunctions;
+    std::vector<const ceres::LossFunction*> LossFunctions;
+    CostFunctions.reserve(ConnectedFactors.size());
+    LossFunctions.reserve(ConnectedFactors.size());
+    for (const ceres::ResidualBlockId CeresID : ConnectedFactors)
+    {
+      CostFunctions.push_back(Graph_.GetCostFunctionForResidualBlock(CeresID));
+      LossFunctions.push_back(Graph_.GetLossFunctionForResidualBlock(CeresID));
+      this->forgetFactor_(CeresID);
+    }
+
+    Graph_.RemoveParameterBlock(State);
+
+    for (const ceres::CostFunction* CostFunction : CostFunctions)
+    {
+      Pool_.destroy(const_cast<ceres::CostFunction*>(CostFunction));
+    }
+    for (const ceres::LossFunction* LossFunction : LossFunctions)
+    {
+      Losses_.release(const_cast<ceres::LossFunction*>(LossFunction));
+    }
+  }
+
+  void FactorGraph::removeBefore(const double Time)
+  {
+    const TraceScope_ Trace(*this, TraceOperation::RemoveBefore);
+    if (Trace.Writer != nullptr)
     {
-      removeFactorsOutsideWindow(Factor, TimeWindow, CurrentTime);
+      Trace.Writer->write(Time);
     }
+
+    this->removeFactorsBefore_(roundToTick(Time));
+    this->removeStatesBefore_(Time);
   }
 
-  void FactorGraph::setConstantOutsideWindow(const string& Name, const double TimeWindow, const double CurrentTime)
+  void FactorGraph::setConstantOutsideWindow(const StateKey &Name, const double TimeWindow, const double CurrentTime)
   {
+    const TraceScope_ Trace(*this, TraceOperation::SetConstantOutsideWindow);
+    if (Trace.Writer != nullptr)
+    {
+      Trace.Writer->writeString(Name.getName());
+      Trace.Writer->write(TimeWindow);
+      Trace.Writer->write(CurrentTime);
+    }
+
     /** find start of the current state */
     double Timestamp;
     bool TimestampExists = StateData_.getTimeFirst(Name, Timestamp);
@@ -685,8 +2872,16 @@ namespace libRSF
     }
   }
 
-  void FactorGraph::setVariableInsideWindow(const string& Name, const double TimeWindow, const double CurrentTime)
+  void FactorGraph::setVariableInsideWindow(const StateKey &Name, const double TimeWindow, const double CurrentTime)
   {
+    const TraceScope_ Trace(*this, TraceOperation::SetVariableInsideWindow);
+    if (Trace.Writer != nullptr)
+    {
+      Trace.Writer->writeString(Name.getName());
+      Trace.Writer->write(TimeWindow);
+      Trace.Writer->write(CurrentTime);
+    }
+
     /** find end of the current state */
     double Timestamp;
     bool TimestampExists = StateData_.getTimeLast(Name, Timestamp);
@@ -711,6 +2906,13 @@ namespace libRSF
 
   void FactorGraph::setAllVariableInsideWindow(const double TimeWindow, const double CurrentTime)
   {
+    const TraceScope_ Trace(*this, TraceOperation::SetAllVariableInsideWindow);
+    if (Trace.Writer != nullptr)
+    {
+      Trace.Writer->write(TimeWindow);
+      Trace.Writer->write(CurrentTime);
+    }
+
     for (auto const &State : StateData_)
     {
       setVariableInsideWindow(State.first, TimeWindow, CurrentTime);
@@ -719,14 +2921,27 @@ namespace libRSF
 
   void FactorGraph::setAllConstantOutsideWindow(const double TimeWindow, const double CurrentTime)
   {
+    const TraceScope_ Trace(*this, TraceOperation::SetAllConstantOutsideWindow);
+    if (Trace.Writer != nullptr)
+    {
+      Trace.Writer->write(TimeWindow);
+      Trace.Writer->write(CurrentTime);
+    }
+
     for (auto const &State : StateData_)
     {
       setConstantOutsideWindow(State.first, TimeWindow, CurrentTime);
     }
   }
 
-  void FactorGraph::setVariable(const string& Name)
+  void FactorGraph::setVariable(const StateKey &Name)
   {
+    const TraceScope_ Trace(*this, TraceOperation::SetVariableAll);
+    if (Trace.Writer != nullptr)
+    {
+      Trace.Writer->writeString(Name.getName());
+    }
+
     /** find end of the current state */
     double Timestamp;
     bool TimestampExists = StateData_.getTimeLast(Name, Timestamp);
@@ -780,6 +2995,79 @@ namespace libRSF
     return Duration;
   }
 
+  void FactorGraph::setBackendSelection(const bool Enable, const int BenchmarkIterations)
+  {
+    BackendSelection_ = Enable;
+    BackendBenchmarkIterations_ = std::max(1, BenchmarkIterations);
+  }
+
+  bool FactorGraph::selectLinearBackend_(const ceres::Solver::Options &Options, ceres::Solver::Options &Selected)
+  {
+    /** dense and iterative solvers are a deliberate choice, small graphs are not worth the benchmark */
+    if ((Options.linear_solver_type != ceres::SPARSE_NORMAL_CHOLESKY && Options.linear_solver_type != ceres::SPARSE_SCHUR)
+        || Graph_.NumResidualBlocks() < MinBackendBenchmarkFactors_)
+    {
+      return false;
+    }
+
+    std::vector<double*> Blocks;
+    Graph_.GetParameterBlocks(&Blocks);
+
+    GraphStructureClass Class;
+    Class.HasLandmarks = std::any_of(Blocks.begin(), Blocks.end(), [this](double *Block){return Structure_.isLandmark(Block);});
+    Class.HasMarginals = Structure_.countFactorType(FactorType::Marginal) > 0;
+    Class.SizeClass = static_cast<int>(std::floor(std::log2(Graph_.NumResidualBlocks())));
+
+    LinearBackend Backend;
+    if (!LookupLinearBackend(Class, Backend))
+    {
+      const std::vector<LinearBackend> Candidates = GetLinearBackendCandidates(Options, Class.HasLandmarks);
+      if (Candidates.size() < 2 || !BenchmarkLinearBackends(Graph_, Options, Candidates, BackendBenchmarkIterations_, Backend))
+      {
+        return false;
+      }
+      StoreLinearBackend(Class, Backend);
+      PRINT_LOGGING("Linear backend for ", Class.getName(), ": ", Backend.getName(), " out of ", Candidates.size(), " candidates");
+    }
+
+    Selected = Options;
+    Backend.apply(Selected);
+    return true;
+  }
+
+  void FactorGraph::setIterationTelemetry(const bool Enable)
+  {
+    IterationTelemetry_ = Enable;
+  }
+
+  void FactorGraph::getIterationTelemetryAndReset(std::vector<SolverIteration> &Iterations)
+  {
+    Iterations.swap(Iterations_);
+    Iterations_.clear();
+  }
+
+  Data SolverIteration::toData(const double Timestamp) const
+  {
+    Data Element(DataType::SolverIteration, Timestamp);
+    Element.setValue(DataElement::Idx, (Vector2() << Solve, Iteration).finished());
+    Element.setValueScalar(DataElement::Cost, Cost);
+    Element.setValueScalar(DataElement::Gradient, GradientNorm);
+    Element.setValueScalar(DataElement::StepNorm, StepNorm);
+    Element.setValueScalar(DataElement::TrustRegionRadius, TrustRegionRadius);
+    Element.setValueScalar(DataElement::StepSuccessful, StepSuccessful ? 1.0 : 0.0);
+    Element.setValueScalar(DataElement::DurationLinearSolver, LinearSolverTime);
+    Element.setValueScalar(DataElement::DurationEvaluation, EvaluationTime);
+    Element.setValueScalar(DataElement::IterationLinearSolver, LinearSolverIterations);
+    return Element;
+  }
+
+  int FactorGraph::getDeadlineMissesAndReset()
+  {
+    const int Misses = DeadlineMisses_;
+    DeadlineMisses_ = 0;
+    return Misses;
+  }
+
   int FactorGraph::getSolverIterationsAndReset()
   {
     /** reset marginalization duration before value is returned */
@@ -790,27 +3078,31 @@ namespace libRSF
 
   void FactorGraph::enableErrorModel(FactorType CurrentFactorType)
   {
-    /** loop over all models */
-    std::vector<ErrorModelBase*> ErrorModels;
-    Structure_.getErrorModels(CurrentFactorType, ErrorModels);
-    for (const auto &ErrorModel : ErrorModels)
+    const TraceScope_ Trace(*this, TraceOperation::EnableErrorModel);
+    if (Trace.Writer != nullptr)
     {
-      ErrorModel->enable();
+      Trace.Writer->write(static_cast<int32_t>(CurrentFactorType));
     }
+
+    /** all models of a type share one flag */
+    Structure_.setErrorModelsEnabled(CurrentFactorType, true);
   }
 
   void FactorGraph::disableErrorModel(FactorType CurrentFactorType)
   {
-    std::vector<ErrorModelBase*> ErrorModels;
-    Structure_.getErrorModels(CurrentFactorType, ErrorModels);
-    for (const auto &ErrorModel : ErrorModels)
+    const TraceScope_ Trace(*this, TraceOperation::DisableErrorModel);
+    if (Trace.Writer != nullptr)
     {
-      ErrorModel->disable();
+      Trace.Writer->write(static_cast<int32_t>(CurrentFactorType));
     }
+
+    Structure_.setErrorModelsEnabled(CurrentFactorType, false);
   }
 
   void FactorGraph::enableErrorModels()
   {
+    const TraceScope_ Trace(*this, TraceOperation::EnableErrorModels);
+
     std::vector<FactorType> Factors;
     Structure_.getFactorTypes(Factors);
     for (const auto &Factor : Factors)
@@ -821,6 +3113,8 @@ namespace libRSF
 
   void FactorGraph::disableErrorModels()
   {
+    const TraceScope_ Trace(*this, TraceOperation::DisableErrorModels);
+
     std::vector<FactorType> Factors;
     Structure_.getFactorTypes(Factors);
     for (const auto &Factor : Factors)
@@ -829,7 +3123,7 @@ namespace libRSF
     }
   }
 
-  void FactorGraph::getFactorsOfState(const string& Name, const double Timestamp, const int Number, std::vector<FactorID> &Factors) const
+  void FactorGraph::getFactorsOfState(const StateKey &Name, const double Timestamp, const int Number, std::vector<FactorID> &Factors) const
   {
     StateID State(Name, Timestamp, Number);
     Structure_.getFactorsOfState(State, Factors);
@@ -847,101 +3141,257 @@ namespace libRSF
     return Cost;
   }
 
-  void FactorGraph::computeUnweightedError(const FactorType CurrentFactorType, std::vector<double> &ErrorData)
+  double FactorGraph::evaluateFactors(const FactorType CurrentFactorType, const bool ComputeJacobians) const
   {
-    /** get residual IDs */
     std::vector<ceres::ResidualBlockId> IDs;
     Structure_.getResidualIDs(CurrentFactorType, IDs);
 
-    /** terminate here, if factors are missing */
-    if (IDs.empty())
+    /** buffers are reused over all factors of this type */
+    std::vector<double*> Parameters;
+    std::vector<double> Residuals;
+    std::vector<std::vector<double>> JacobianData;
+    std::vector<double*> Jacobians;
+
+    double Cost = 0.0;
+    for (const ceres::ResidualBlockId &ID : IDs)
     {
-      PRINT_WARNING("Factors of type ", CurrentFactorType, " are missing!");
-      return;
+      const ceres::CostFunction * const CostFunction = Graph_.GetCostFunctionForResidualBlock(ID);
+      Graph_.GetParameterBlocksForResidualBlock(ID, &Parameters);
+      Residuals.resize(CostFunction->num_residuals());
+
+      if (ComputeJacobians)
+      {
+        const std::vector<int32_t> &BlockSizes = CostFunction->parameter_block_sizes();
+        JacobianData.resize(BlockSizes.size());
+        Jacobians.resize(BlockSizes.size());
+        for (size_t n = 0; n < BlockSizes.size(); ++n)
+        {
+          JacobianData.at(n).resize(static_cast<size_t>(BlockSizes.at(n)) * CostFunction->num_residuals());
+          Jacobians.at(n) = JacobianData.at(n).data();
+        }
+      }
+
+      if (!CostFunction->Evaluate(Parameters.data(), Residuals.data(), ComputeJacobians ? Jacobians.data() : nullptr))
+      {
+        PRINT_WARNING("Evaluation of a factor failed!");
+        continue;
+      }
+
+      for (const double Residual : Residuals)
+      {
+        Cost += 0.5 * Residual * Residual;
+      }
     }
+    return Cost;
+  }
 
-    /** check IDs */
-    std::vector<ceres::ResidualBlockId> IDsCeres;
-    std::vector<bool> Existence;
-    Graph_.GetResidualBlocks(&IDsCeres);
-    for (auto const &ID1 : IDs)
+  void FactorGraph::computeRawErrors_(const std::vector<ceres::ResidualBlockId> &IDs,
+                                      const int InputSize,
+                                      const int OutputSize,
+                                      Matrix &Errors)
+  {
+    /** factors like the pseudorange epoch factor contain several errors, so columns are counted first */
+    const size_t FactorNumber = IDs.size();
+    std::vector<int> FirstColumn(FactorNumber + 1, 0);
+    for (size_t n = 0; n < FactorNumber; ++n)
+    {
+      FirstColumn.at(n + 1) = FirstColumn.at(n) + Graph_.GetCostFunctionForResidualBlock(IDs.at(n))->num_residuals() / OutputSize;
+    }
+    Errors.resize(InputSize, FirstColumn.back());
+
+    auto WriteColumns = [&](const size_t n, const std::vector<double> &Residuals)
+    {
+      for (int nError = 0; nError < FirstColumn.at(n + 1) - FirstColumn.at(n); ++nError)
+      {
+        Errors.col(FirstColumn.at(n) + nError) = VectorRefConst<double, Dynamic>(Residuals.data() + nError * OutputSize, InputSize);
+      }
+    };
+
+    /** factors with unchanged states are taken from the last evaluation, a single factor is not worth the synchronization */
+    const bool UseCache = (FactorNumber > 1);
+    std::vector<size_t> Outdated;
+    if (UseCache)
+    {
+      RawErrorCache_.synchronize(StateData_);
+
+      std::vector<double*> Parameters;
+      std::vector<double> Residuals;
+      for (size_t n = 0; n < FactorNumber; ++n)
+      {
+        Graph_.GetParameterBlocksForResidualBlock(IDs.at(n), &Parameters);
+        Residuals.resize(Graph_.GetCostFunctionForResidualBlock(IDs.at(n))->num_residuals());
+        if (RawErrorCache_.lookup(IDs.at(n), Parameters, Residuals))
+        {
+          WriteColumns(n, Residuals);
+        }
+        else
+        {
+          Outdated.push_back(n);
+        }
+      }
+    }
+    else
+    {
+      Outdated.resize(FactorNumber);
+      std::iota(Outdated.begin(), Outdated.end(), 0);
+    }
+
+    /** the new residuals are kept until they are stored in the cache */
+    const size_t OutdatedNumber = Outdated.size();
+    std::vector<std::vector<double>> Fresh(UseCache ? OutdatedNumber : 0);
+
+    /** every thread writes its own columns */
+    auto Worker = [&](const size_t Begin, const size_t End)
     {
-      bool Exists = false;
-      for (auto const &ID2 : IDsCeres)
+      /** bypasses the error models only for this thread */
+      ErrorModelBase::RawEvaluationScope RawEvaluation;
+
+      std::vector<double*> Parameters;
+      std::vector<double> Residuals;
+      for (size_t m = Begin; m < End; ++m)
       {
-        if (ID1 == ID2)
+        const size_t n = Outdated.at(m);
+        const ceres::CostFunction * const CostFunction = Graph_.GetCostFunctionForResidualBlock(IDs.at(n));
+        Graph_.GetParameterBlocksForResidualBlock(IDs.at(n), &Parameters);
+        Residuals.resize(CostFunction->num_residuals());
+
+        if (!CostFunction->Evaluate(Parameters.data(), Residuals.data(), nullptr))
+        {
+          PRINT_WARNING("Evaluation of a factor failed!");
+        }
+        else if (UseCache)
         {
-          Exists = true;
+          Fresh.at(m) = Residuals;
         }
+
+        WriteColumns(n, Residuals);
       }
-      Existence.push_back(Exists);
-      if (!Exists)
+    };
+
+    /** threads are only worth it for larger sets */
+    constexpr size_t MinFactorsPerThread = 256;
+    const size_t Threads = std::max<size_t>(1, std::min<size_t>(static_cast<size_t>(GetThreadNumber()), OutdatedNumber / MinFactorsPerThread));
+    if (Threads == 1)
+    {
+      Worker(0, OutdatedNumber);
+    }
+    else
+    {
+      const size_t Chunk = (OutdatedNumber + Threads - 1) / Threads;
+      GetThreadPool().parallelFor((OutdatedNumber + Chunk - 1) / Chunk, [&](const size_t nChunk)
+      {
+        Worker(nChunk * Chunk, std::min(OutdatedNumber, (nChunk + 1) * Chunk));
+      });
+    }
+
+    /** the cache is not thread-safe, so it is filled afterwards */
+    std::vector<double*> Parameters;
+    for (size_t m = 0; m < Fresh.size(); ++m)
+    {
+      if (!Fresh.at(m).empty())
       {
-        PRINT_ERROR("Found missing ID");
+        Graph_.GetParameterBlocksForResidualBlock(IDs.at(Outdated.at(m)), &Parameters);
+        RawErrorCache_.store(IDs.at(Outdated.at(m)), Parameters, Fresh.at(m));
       }
     }
+  }
+
+  void FactorGraph::computeUnweightedError(const FactorType CurrentFactorType, std::vector<double> &ErrorData)
+  {
+    Matrix ErrorMatrix;
+    this->computeUnweightedErrorMatrix(CurrentFactorType, ErrorMatrix);
+
+    /** column major, so the errors of one factor stay together */
+    ErrorData.assign(ErrorMatrix.data(), ErrorMatrix.data() + ErrorMatrix.size());
+  }
 
-    /** configure evaluation */
-    ceres::Problem::EvaluateOptions Options;
-    Options.num_threads = static_cast<int>(std::thread::hardware_concurrency());
-    Options.residual_blocks = IDs;
-    Options.apply_loss_function = false;
+  void FactorGraph::computeUnweightedErrorMatrix(const FactorType CurrentFactorType, Matrix &ErrorMatrix)
+  {
+    ErrorMatrix.resize(0, 0);
 
-    /** disable error model during evaluation */
-    disableErrorModel(CurrentFactorType);
+    /** get residual IDs */
+    std::vector<ceres::ResidualBlockId> IDs;
+    Structure_.getResidualIDs(CurrentFactorType, IDs);
 
-    /** compute the errors */
-    Graph_.Evaluate(Options, nullptr, &ErrorData, nullptr, nullptr);
+    /** terminate here, if factors are missing */
+    if (IDs.empty())
+    {
+      PRINT_WARNING("Factors of type ", CurrentFactorType, " are missing!");
+      return;
+    }
 
-    /** re-enable error model */
-    enableErrorModel(CurrentFactorType);
+    /** check IDs */
+    if (!Structure_.validateResidualIDs(CurrentFactorType))
+    {
+      return;
+    }
 
-    /** create factor ID */
+    /** get the dimensions */
     double TimeFirst;
     Structure_.getTimeFirst(CurrentFactorType, TimeFirst);
-    FactorID FirstID(CurrentFactorType, TimeFirst, 0);
+    const FactorID FirstID(CurrentFactorType, TimeFirst, 0);
 
-    /** remove unused dimensions */
     int InputSize;
     int OutputSize;
     Structure_.getErrorInputSize(FirstID, InputSize);
     Structure_.getErrorOutputSize(FirstID, OutputSize);
 
-    for (int n = static_cast<int>(ErrorData.size()) - 1; n > 0; n -= OutputSize)
+    this->computeRawErrors_(IDs, InputSize, OutputSize, ErrorMatrix);
+  }
+
+  void FactorGraph::computeUnweightedErrorMatrix(const FactorType CurrentFactorType, const double TimeBegin, Matrix &ErrorMatrix, double &TimeEnd)
+  {
+    ErrorMatrix.resize(0, 0);
+    TimeEnd = TimeBegin;
+
+    /** terminate here, if there are no new factors */
+    double TimeLast;
+    if (!Structure_.getTimeLast(CurrentFactorType, TimeLast) || TimeLast <= TimeBegin)
+    {
+      return;
+    }
+
+    /** collect only the factors after the given time */
+    std::vector<double> Times;
+    Structure_.getTimesBetween(CurrentFactorType, TimeBegin, TimeLast, Times);
+
+    std::vector<ceres::ResidualBlockId> IDs;
+    for (const double Time : Times)
     {
-      for (int m = 0 ; m < (OutputSize - InputSize); m++)
+      if (Time <= TimeBegin)
       {
-        ErrorData.erase(ErrorData.begin() + n - m);
+        continue;
       }
-    }
-  }
 
-  void FactorGraph::computeUnweightedErrorMatrix(const FactorType CurrentFactorType, Matrix &ErrorMatrix)
-  {
-    /** get the data */
-    std::vector<double> ErrorVector;
-    this->computeUnweightedError(CurrentFactorType, ErrorVector);
+      const int Number = Structure_.countFactor(CurrentFactorType, Time);
+      for (int n = 0; n < Number; n++)
+      {
+        const FactorID Factor(CurrentFactorType, Time, n);
 
-    /** check for empty vector */
-    if (ErrorVector.empty())
+        ceres::ResidualBlockId Residual;
+        Structure_.getResidualID(Factor, Residual);
+        IDs.push_back(Residual);
+      }
+    }
+
+    if (IDs.empty())
     {
-      PRINT_WARNING("Factors of type ", CurrentFactorType, " are missing!");
       return;
     }
 
-    /** get the factor IDs */
-    std::vector<FactorID> FactorVector;
-    Structure_.getFactorIDs(CurrentFactorType, FactorVector);
+    /** compute the errors without the error models */
+    int InputSize;
+    int OutputSize;
+    const FactorID FirstID(CurrentFactorType, Times.back(), 0);
+    Structure_.getErrorInputSize(FirstID, InputSize);
+    Structure_.getErrorOutputSize(FirstID, OutputSize);
 
-    /** get the dimensions */
-    const int Dim = static_cast<int>(ErrorVector.size() / FactorVector.size());
-    const int Length = static_cast<int>(FactorVector.size());
+    this->computeRawErrors_(IDs, InputSize, OutputSize, ErrorMatrix);
 
-    /** map std vector to matrix */
-    ErrorMatrix = Eigen::Map<Matrix, Eigen::Unaligned, Eigen::Stride<1, Dynamic>>(ErrorVector.data(), Dim, Length, Eigen::Stride<1,Dynamic>(1, Dim));
+    TimeEnd = TimeLast;
   }
 
-  void FactorGraph::computeUnweightedError(const FactorType CurrentFactorType, const string &Name, StateDataSet &ErrorData)
+  void FactorGraph::computeUnweightedError(const FactorType CurrentFactorType, const StateKey &Name, StateDataSet &ErrorData)
   {
     /** get the data */
     std::vector<double> ErrorVector;
@@ -959,8 +3409,21 @@ namespace libRSF
     Structure_.getFactorIDs(CurrentFactorType, FactorVector);
 
     /** get the dimensions */
-    const int Dim = static_cast<int>(ErrorVector.size() / FactorVector.size());
-    const int Length = static_cast<int>(FactorVector.size());
+    int Dim;
+    int OutputSize;
+    Structure_.getErrorInputSize(FactorVector.front(), Dim);
+    Structure_.getErrorOutputSize(FactorVector.front(), OutputSize);
+    const int Length = static_cast<int>(ErrorVector.size()) / Dim;
+
+    /** one timestamp per error, a factor can contain several errors */
+    std::vector<double> Timestamps;
+    for (const FactorID &Factor : FactorVector)
+    {
+      ceres::ResidualBlockId CeresID;
+      Structure_.getResidualID(Factor, CeresID);
+      const int ErrorNumber = Graph_.GetCostFunctionForResidualBlock(CeresID)->num_residuals() / OutputSize;
+      Timestamps.insert(Timestamps.end(), ErrorNumber, Factor.getTimestamp());
+    }
 
     /** convert to Data */
     switch (Dim)
@@ -971,7 +3434,7 @@ namespace libRSF
           for (int i = 0; i < Length; i++)
           {
             const int Index = i*Dim;
-            ErrorState.setTimestamp(FactorVector.at(i).Timestamp);
+            ErrorState.setTimestamp(Timestamps.at(i));
             ErrorState.setMean((Vector1() << ErrorVector.at(Index)).finished());
             ErrorData.addElement(Name, ErrorState);
           }
@@ -984,7 +3447,7 @@ namespace libRSF
           for (int i = 0; i < Length; i++)
           {
             const int Index = i*Dim;
-            ErrorState.setTimestamp(FactorVector.at(i).Timestamp);
+            ErrorState.setTimestamp(Timestamps.at(i));
             ErrorState.setMean((Vector2() << ErrorVector.at(Index), ErrorVector.at(Index+1)).finished());
             ErrorData.addElement(Name, ErrorState);
           }
@@ -997,7 +3460,7 @@ namespace libRSF
           for (int i = 0; i < Length; i++)
           {
             const int Index = i*Dim;
-            ErrorState.setTimestamp(FactorVector.at(i).Timestamp);
+            ErrorState.setTimestamp(Timestamps.at(i));
             ErrorState.setMean((Vector3() << ErrorVector.at(Index), ErrorVector.at(Index+1), ErrorVector.at(Index+2)).finished());
             ErrorData.addElement(Name, ErrorState);
           }
@@ -1010,7 +3473,7 @@ namespace libRSF
           for (int i = 0; i < Length; i++)
           {
             const int Index = i*Dim;
-            ErrorState.setTimestamp(FactorVector.at(i).Timestamp);
+            ErrorState.setTimestamp(Timestamps.at(i));
             ErrorState.setMean((Vector6() << ErrorVector.at(Index), ErrorVector.at(Index+1), ErrorVector.at(Index+2),
                                              ErrorVector.at(Index+3), ErrorVector.at(Index+4), ErrorVector.at(Index+5)).finished());
             ErrorData.addElement(Name, ErrorState);
@@ -1039,33 +3502,15 @@ namespace libRSF
     FactorID OurID(CurrentFactorType, Time, Number);
     Structure_.getResidualID(OurID, CeresID);
 
-    std::vector<ceres::ResidualBlockId> CeresIDs;
-    CeresIDs.push_back(CeresID);
-
-    /** configure evaluation */
-    ceres::Problem::EvaluateOptions Options;
-    Options.num_threads = 1;
-    Options.residual_blocks = CeresIDs;
-    Options.apply_loss_function = false;
-
-    /** disable error model */
-    disableErrorModel(CurrentFactorType);
-
-    /** compute error */
-    std::vector<double> ErrorData;
-    Graph_.Evaluate(Options, nullptr, &ErrorData, nullptr, nullptr);
-
-    /** re-enable error model again */
-    enableErrorModel(CurrentFactorType);
+    /** compute error, factors like the pseudorange epoch factor contain several errors */
+    int InputSize;
+    int OutputSize;
+    Structure_.getErrorInputSize(OurID, InputSize);
+    Structure_.getErrorOutputSize(OurID, OutputSize);
 
-    /** copy to eigen vector */
-    int Size;
-    Structure_.getErrorInputSize(OurID, Size);
-    Error.resize(Size);
-    for (int n = 0; n < Size; n++)
-    {
-      Error(n) = ErrorData.at(n);
-    }
+    Matrix ErrorMatrix;
+    this->computeRawErrors_({CeresID}, InputSize, OutputSize, ErrorMatrix);
+    Error = VectorRefConst<double, Dynamic>(ErrorMatrix.data(), ErrorMatrix.size());
   }
 
     void FactorGraph::setSolverOptions(const ceres::Solver::Options &Options)
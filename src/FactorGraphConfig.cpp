@@ -62,7 +62,7 @@ namespace libRSF
     SolverConfig.dogleg_type = ceres::DoglegType::SUBSPACE_DOGLEG;
     SolverConfig.linear_solver_type = ceres::LinearSolverType::SPARSE_NORMAL_CHOLESKY;
     SolverConfig.use_nonmonotonic_steps = true;
-    SolverConfig.num_threads = static_cast<int>(std::thread::hardware_concurrency());
+    SolverConfig.num_threads = GetThreadNumber();
     SolverConfig.max_num_iterations = 100;
     SolverConfig.max_solver_time_in_seconds = 10.0;
     SolverConfig.minimizer_progress_to_stdout = true;
@@ -159,6 +159,31 @@ namespace libRSF
               break;
           }
 
+          /** optional number of threads for the estimation */
+          if(ErrorModelNode["threads"].IsDefined())
+          {
+            Model.GMM.ThreadNumber = ErrorModelNode["threads"].as<int>();
+          }
+
+          /** optional online estimation with decayed statistics */
+          if(ErrorModelNode["forgetting"].IsDefined())
+          {
+            Model.GMM.OnlineTuning = true;
+            Model.GMM.ForgettingFactor = ErrorModelNode["forgetting"].as<double>();
+          }
+
+          /** optional subsampling of large residual sets */
+          if(ErrorModelNode["coreset"].IsDefined())
+          {
+            Model.GMM.CoresetSize = ErrorModelNode["coreset"].as<int>();
+          }
+
+          /** optional acceleration of EM */
+          if(ErrorModelNode["accelerate"].IsDefined())
+          {
+            Model.GMM.AcceleratedTuning = ErrorModelNode["accelerate"].as<bool>();
+          }
+
         }
         break;
 
@@ -170,6 +195,68 @@ namespace libRSF
     return true;
   }
 
+  bool FactorGraphConfig::ParseSolverFromYAML_(const YAML::Node &SolverNode)
+  {
+    if(SolverNode["linear_solver"].IsDefined())
+    {
+      auto SolverString = SolverNode["linear_solver"].as<std::string>();
+      if(!TranslateSafe(LinearSolverTypeDict, SolverString, SolverConfig.linear_solver_type))
+      {
+        PRINT_ERROR("Wrong linear solver type: ", SolverString);
+        return false;
+      }
+    }
+
+    if(SolverNode["sparse_backend"].IsDefined())
+    {
+      auto BackendString = SolverNode["sparse_backend"].as<std::string>();
+      if(BackendString == "auto")
+      {
+        /** the FactorGraph benchmarks the available libraries */
+        Solution.AutoBackend = true;
+      }
+      else if(!TranslateSafe(SparseBackendTypeDict, BackendString, SolverConfig.sparse_linear_algebra_library_type))
+      {
+        PRINT_ERROR("Wrong sparse backend type: ", BackendString);
+        return false;
+      }
+    }
+
+    /** zero uses all available cores */
+    if(SolverNode["threads"].IsDefined())
+    {
+      SolverConfig.num_threads = SolverNode["threads"].as<int>();
+      if(SolverConfig.num_threads <= 0)
+      {
+        SolverConfig.num_threads = GetThreadNumber();
+      }
+    }
+
+    if(SolverNode["landmarks_first"].IsDefined())
+    {
+      Solution.OrderLandmarksFirst = SolverNode["landmarks_first"].as<bool>();
+    }
+
+    if(SolverNode["preconditioner"].IsDefined())
+    {
+      auto PreconditionerString = SolverNode["preconditioner"].as<std::string>();
+      if(!TranslateSafe(PreconditionerTypeDict, PreconditionerString, SolverConfig.preconditioner_type))
+      {
+        PRINT_ERROR("Wrong preconditioner type: ", PreconditionerString);
+        return false;
+      }
+    }
+
+    /** the Schur complement is applied matrix-free, so memory stays linear in the number of states */
+    if(SolverNode["time_chain"].IsDefined())
+    {
+      Solution.OrderTimeChain = SolverNode["time_chain"].as<bool>();
+      SolverConfig.use_explicit_schur_complement = false;
+    }
+
+    return true;
+  }
+
   bool FactorGraphConfig::ReadYAMLOptions(const std::string& YAMLFile)
   {
     /** check if file available */
@@ -189,6 +276,62 @@ namespace libRSF
     /** config node holds the relevant configuration */
     const YAML::Node YAMLConfig  = YAMLComplete["config"];
 
+    /** optional size of the process-wide thread pool, zero uses all cores */
+    if(YAMLConfig["threads"].IsDefined())
+    {
+      ThreadPoolConfig Threads;
+      Threads.ThreadNumber = YAMLConfig["threads"]["number"].IsDefined() ? YAMLConfig["threads"]["number"].as<int>() : 0;
+      if(YAMLConfig["threads"]["affinity"].IsDefined())
+      {
+        auto AffinityString = YAMLConfig["threads"]["affinity"].as<std::string>();
+        if(!TranslateSafe(ThreadAffinityDict, AffinityString, Threads.Affinity))
+        {
+          PRINT_ERROR("Wrong thread affinity: ", AffinityString);
+          return false;
+        }
+      }
+      SetThreadPoolConfig(Threads);
+
+      /** the solver uses the same number of threads, unless it is set separately */
+      SolverConfig.num_threads = GetThreadNumber();
+    }
+
+    /** optional real-time profile, the memory is locked when the application enters it */
+    if(YAMLConfig["realtime"].IsDefined())
+    {
+      const YAML::Node RealTimeNode = YAMLConfig["realtime"];
+      RealTimeConfig RealTime;
+      RealTime.IsActive = RealTimeNode["active"].IsDefined() ? RealTimeNode["active"].as<bool>() : true;
+      RealTime.LockMemory = RealTimeNode["lock_memory"].IsDefined() ? RealTimeNode["lock_memory"].as<bool>() : true;
+      RealTime.HugePages = RealTimeNode["huge_pages"].IsDefined() ? RealTimeNode["huge_pages"].as<bool>() : false;
+      if(RealTimeNode["prefault_heap"].IsDefined())
+      {
+        RealTime.PrefaultHeap = RealTimeNode["prefault_heap"].as<size_t>() * 1024 * 1024; /**< in MiB */
+      }
+      if(RealTimeNode["prefault_stack"].IsDefined())
+      {
+        RealTime.PrefaultStack = RealTimeNode["prefault_stack"].as<size_t>() * 1024; /**< in KiB */
+      }
+      if(RealTimeNode["warm_up"].IsDefined())
+      {
+        RealTime.WarmUpEpochs = RealTimeNode["warm_up"].as<int>();
+      }
+
+      /** core and SCHED_FIFO priority per thread role */
+      const auto ParseThread = [](const YAML::Node &ThreadNode, RealTimeThreadConfig &Thread)
+      {
+        if(ThreadNode.IsDefined())
+        {
+          Thread.Core = ThreadNode["core"].IsDefined() ? ThreadNode["core"].as<int>() : -1;
+          Thread.Priority = ThreadNode["priority"].IsDefined() ? ThreadNode["priority"].as<int>() : 0;
+        }
+      };
+      ParseThread(RealTimeNode["solver"], RealTime.Solver);
+      ParseThread(RealTimeNode["ingestion"], RealTime.Ingestion);
+
+      SetRealTimeConfig(RealTime);
+    }
+
     /** solution */
     auto SolTypeString = YAMLConfig["solution"]["solver_mode"].as<std::string>();
     if(!TranslateSafe(SolutionTypeDict, SolTypeString, Solution.Type))
@@ -206,6 +349,51 @@ namespace libRSF
         SolverConfig.max_solver_time_in_seconds = YAMLConfig["solution"]["max_time"].as<double>();
 
         Solution.EstimateCov = YAMLConfig["solution"]["estimate_cov"].as<bool>();
+
+        /** optional initialization with a graph over every n-th state */
+        if(YAMLConfig["solution"]["coarse_to_fine"].IsDefined())
+        {
+          Solution.CoarseToFine = YAMLConfig["solution"]["coarse_to_fine"].as<int>();
+        }
+
+        /** optional closed-form initialization of pose graphs */
+        if(YAMLConfig["solution"]["pose_graph_init"].IsDefined())
+        {
+          Solution.PoseGraphInit = YAMLConfig["solution"]["pose_graph_init"].as<bool>();
+        }
+
+        /** optional adaption inside the solver */
+        if(YAMLConfig["solution"]["adaption_interval"].IsDefined())
+        {
+          Solution.AdaptionInterval = YAMLConfig["solution"]["adaption_interval"].as<int>();
+        }
+
+        /** schedule of the outer adaption loop */
+        Solution.AdaptionRounds = 10;
+        if(YAMLConfig["solution"]["adaption_schedule"].IsDefined())
+        {
+          const YAML::Node Schedule = YAMLConfig["solution"]["adaption_schedule"];
+          if(Schedule["rounds"].IsDefined())
+          {
+            Solution.AdaptionRounds = Schedule["rounds"].as<int>();
+          }
+          Solution.AdaptionTolerance = Schedule["tolerance"].as<double>();
+          Solution.AdaptionIterations = Schedule["iterations"].as<int>();
+        }
+
+        /** optional split into overlapping segments */
+        if(YAMLConfig["solution"]["segments"].IsDefined())
+        {
+          const YAML::Node Segments = YAMLConfig["solution"]["segments"];
+          Solution.SegmentLength = Segments["length"].as<double>();
+          Solution.SegmentOverlap = Segments["overlap"].as<double>();
+          Solution.SegmentRounds = Segments["rounds"].as<int>();
+          Solution.SegmentConsensus = 0.1;
+          if(Segments["consensus_std_dev"].IsDefined())
+          {
+            Solution.SegmentConsensus = Segments["consensus_std_dev"].as<double>();
+          }
+        }
         break;
 
     case SolutionType::Smoother:
@@ -215,6 +403,12 @@ namespace libRSF
         SolverConfig.max_solver_time_in_seconds = YAMLConfig["solution"]["max_time"].as<double>();
 
         Solution.EstimateCov = YAMLConfig["solution"]["estimate_cov"].as<bool>();
+
+        /** optional incremental solving */
+        if(YAMLConfig["solution"]["incremental"].IsDefined())
+        {
+          Solution.Incremental = YAMLConfig["solution"]["incremental"].as<bool>();
+        }
         break;
 
     case SolutionType::SmootherRT:
@@ -225,6 +419,12 @@ namespace libRSF
         Solution.WindowLength = YAMLConfig["solution"]["window_length"].as<double>();
 
         Solution.EstimateCov = YAMLConfig["solution"]["estimate_cov"].as<bool>();
+
+        /** optional incremental solving */
+        if(YAMLConfig["solution"]["incremental"].IsDefined())
+        {
+          Solution.Incremental = YAMLConfig["solution"]["incremental"].as<bool>();
+        }
         break;
 
     case SolutionType::Window:
@@ -236,6 +436,30 @@ namespace libRSF
         Solution.WindowLength = YAMLConfig["solution"]["window_length"].as<double>();
         Solution.EstimateCov = YAMLConfig["solution"]["estimate_cov"].as<bool>();
         Solution.Marginalize = YAMLConfig["solution"]["marginalize"].as<bool>();
+
+        /** optional batched marginalization */
+        if(YAMLConfig["solution"]["marginalize_every"].IsDefined())
+        {
+          Solution.MarginalizationInterval = YAMLConfig["solution"]["marginalize_every"].as<int>();
+        }
+        if(YAMLConfig["solution"]["window_overflow"].IsDefined())
+        {
+          Solution.MarginalizationOverflow = YAMLConfig["solution"]["window_overflow"].as<double>();
+        }
+        if(YAMLConfig["solution"]["max_marginal_priors"].IsDefined())
+        {
+          Solution.MaxMarginalPriors = YAMLConfig["solution"]["max_marginal_priors"].as<int>();
+        }
+
+        /** optional landmark lifecycle */
+        if(YAMLConfig["solution"]["landmark_max_age"].IsDefined())
+        {
+          Solution.LandmarkMaxAge = YAMLConfig["solution"]["landmark_max_age"].as<double>();
+        }
+        if(YAMLConfig["solution"]["max_landmarks"].IsDefined())
+        {
+          Solution.MaxLandmarks = YAMLConfig["solution"]["max_landmarks"].as<int>();
+        }
         break;
 
     case SolutionType::Filter:
@@ -264,11 +488,99 @@ namespace libRSF
         break;
     }
 
+    /** optional solver section, a sub-node named like the solution type overrides the common settings */
+    if(YAMLConfig["solver"].IsDefined())
+    {
+      const YAML::Node YAMLSolver = YAMLConfig["solver"];
+      if(!ParseSolverFromYAML_(YAMLSolver))
+      {
+        return false;
+      }
+
+      if(YAMLSolver[SolTypeString].IsDefined() && !ParseSolverFromYAML_(YAMLSolver[SolTypeString]))
+      {
+        return false;
+      }
+    }
+
+    /** available time of one epoch */
+    if(YAMLConfig["solution"]["max_time"].IsDefined())
+    {
+      Solution.MaxTime = YAMLConfig["solution"]["max_time"].as<double>();
+    }
+
+    /** optional window length that follows the processing time, bounded to [min_length, max_length] */
+    const YAML::Node AdaptiveWindowNode = YAMLConfig["solution"]["adaptive_window"];
+    if(AdaptiveWindowNode.IsDefined())
+    {
+      Solution.AdaptiveWindow = true;
+      Solution.MinWindowLength = AdaptiveWindowNode["min_length"].IsDefined() ? AdaptiveWindowNode["min_length"].as<double>() : 0.1 * Solution.WindowLength;
+      Solution.MaxWindowLength = AdaptiveWindowNode["max_length"].IsDefined() ? AdaptiveWindowNode["max_length"].as<double>() : Solution.WindowLength;
+    }
+
+    /** optional warm start of consecutive solves */
+    if(YAMLConfig["solution"]["warm_start"].IsDefined())
+    {
+      Solution.WarmStart = YAMLConfig["solution"]["warm_start"].as<bool>();
+    }
+
+    /** optional incremental covariance of the newest states */
+    if(YAMLConfig["solution"]["incremental_covariance"].IsDefined())
+    {
+      Solution.IncrementalCovariance = YAMLConfig["solution"]["incremental_covariance"].as<bool>();
+    }
+
+    /** optional compact storage of the result */
+    if(YAMLConfig["solution"]["compact_results"].IsDefined())
+    {
+      Solution.CompactResults = YAMLConfig["solution"]["compact_results"].as<std::string>();
+    }
+
+    /** optional initialization from the result of a previous run */
+    if(YAMLConfig["solution"]["initial_values"].IsDefined())
+    {
+      Solution.InitialValues = YAMLConfig["solution"]["initial_values"].as<std::string>();
+    }
+
+    /** optional trace of the graph operations */
+    if(YAMLConfig["solution"]["trace"].IsDefined())
+    {
+      Solution.TraceFile = YAMLConfig["solution"]["trace"].as<std::string>();
+    }
+
+    /** optional telemetry of each solver iteration */
+    if(YAMLConfig["solution"]["iteration_telemetry"].IsDefined())
+    {
+      Solution.IterationTelemetry = YAMLConfig["solution"]["iteration_telemetry"].as<bool>();
+    }
+
+    /** optional monitoring */
+    if(YAMLConfig["solution"]["metrics_port"].IsDefined())
+    {
+      Solution.MetricsPort = YAMLConfig["solution"]["metrics_port"].as<int>();
+    }
+    if(YAMLConfig["solution"]["metrics_file"].IsDefined())
+    {
+      Solution.MetricsFile = YAMLConfig["solution"]["metrics_file"].as<std::string>();
+    }
+
+    /** optional time budget per epoch */
+    if(YAMLConfig["solution"]["deadline"].IsDefined())
+    {
+      Solution.Deadline = YAMLConfig["solution"]["deadline"].as<double>();
+    }
+
     /** get sensor synchronization strategy*/
     Solution.IsAsync = YAMLConfig["graph"]["is_async"].as<bool>();
     if(Solution.IsAsync)
     {
       Solution.AsyncRate = YAMLConfig["graph"]["async_rate"].as<double>();
+
+      /** optional: no states during sensor dropouts */
+      if(YAMLConfig["graph"]["async_events"].IsDefined())
+      {
+        Solution.AsyncEvents = YAMLConfig["graph"]["async_events"].as<bool>();
+      }
     }
     else
     {
@@ -282,6 +594,53 @@ namespace libRSF
       Solution.SyncSensor = FactorSensorDict.at(SyncFactor);
     }
 
+    /** optional streaming of the input file */
+    if(YAMLConfig["graph"]["streaming"].IsDefined())
+    {
+      Solution.IsStreaming = YAMLConfig["graph"]["streaming"].as<bool>();
+    }
+
+    /** optional reordering of measurements with variable latency */
+    if(YAMLConfig["graph"]["latency"].IsDefined())
+    {
+      Solution.Latency = YAMLConfig["graph"]["latency"].as<double>();
+    }
+
+    /** optional asynchronous solver thread */
+    if(YAMLConfig["graph"]["pipeline"].IsDefined())
+    {
+      Solution.IsPipelined = YAMLConfig["graph"]["pipeline"].as<bool>();
+    }
+
+    /** optional smoother next to the window or filter */
+    if(YAMLConfig["graph"]["background_smoother"].IsDefined())
+    {
+      Solution.BackgroundSmoother = YAMLConfig["graph"]["background_smoother"].as<int>();
+    }
+
+    /** optional keyframe selection */
+    const YAML::Node KeyframeNode = YAMLConfig["graph"]["keyframes"];
+    if(KeyframeNode.IsDefined())
+    {
+      Keyframe.IsActive = true;
+      if(KeyframeNode["min_translation"].IsDefined())
+      {
+        Keyframe.MinTranslation = KeyframeNode["min_translation"].as<double>();
+      }
+      if(KeyframeNode["min_rotation"].IsDefined())
+      {
+        Keyframe.MinRotation = KeyframeNode["min_rotation"].as<double>();
+      }
+      if(KeyframeNode["max_interval"].IsDefined())
+      {
+        Keyframe.MaxInterval = KeyframeNode["max_interval"].as<double>();
+      }
+      if(KeyframeNode["min_information"].IsDefined())
+      {
+        Keyframe.MinInformationGain = KeyframeNode["min_information"].as<double>();
+      }
+    }
+
     /** parse factors */
     for(int nFactor = 0; nFactor < static_cast<int>(YAMLConfig["factors"].size()); nFactor++)
     {
@@ -304,12 +663,32 @@ namespace libRSF
         return false;
       }
 
+      /** optional pre-screening of the measurements */
+      const YAML::Node ScreeningNode = YAMLConfig["factors"][nFactor]["screening"];
+      if(ScreeningNode.IsDefined())
+      {
+        Factor.Screening.IsActive = true;
+        if(ScreeningNode["min_elevation"].IsDefined())
+        {
+          Factor.Screening.MinElevation = ScreeningNode["min_elevation"].as<double>();
+        }
+        if(ScreeningNode["min_snr"].IsDefined())
+        {
+          Factor.Screening.MinSNR = ScreeningNode["min_snr"].as<double>();
+        }
+        if(ScreeningNode["max_residual"].IsDefined())
+        {
+          Factor.Screening.MaxResidual = ScreeningNode["max_residual"].as<double>();
+        }
+      }
+
       /** read type dependent parameters and save config */
       if(TranslateSafe(FactorTypeDict, FactorTypeString, Factor.Type))
       {
         switch(Factor.Type)
         {
           case FactorType::ConstDrift1:
+          case FactorType::ConstDriftClock:
           case FactorType::ConstVal1:
             Factor.Parameter = ParseVectorFromYAML_(YAMLConfig["factors"][nFactor]["std_dev"]);
             break;
@@ -331,11 +710,18 @@ namespace libRSF
             break;
 
           case FactorType::IMUPretintegration:
-            Factor.Parameter.resize(4);
+            Factor.Parameter.resize(5);
             Factor.Parameter(0) = YAMLConfig["factors"][nFactor]["noise_acc"].as<double>();
             Factor.Parameter(1) = YAMLConfig["factors"][nFactor]["noise_tr"].as<double>();
             Factor.Parameter(2) = YAMLConfig["factors"][nFactor]["noise_b_acc"].as<double>();
             Factor.Parameter(3) = YAMLConfig["factors"][nFactor]["noise_b_tr"].as<double>();
+
+            /** optional bias change that triggers a re-integration, zero keeps the first-order correction only */
+            Factor.Parameter(4) = 0.0;
+            if(YAMLConfig["factors"][nFactor]["relinearize_bias"].IsDefined())
+            {
+              Factor.Parameter(4) = YAMLConfig["factors"][nFactor]["relinearize_bias"].as<double>();
+            }
             break;
 
           case FactorType::Pseudorange3_Bias:
@@ -346,9 +732,21 @@ namespace libRSF
           case FactorType::Loop1:
           case FactorType::Loop2:
           case FactorType::Loop3:
-            Factor.Parameter.resize(2);
+            Factor.Parameter.resize(4);
             Factor.Parameter(0) = YAMLConfig["factors"][nFactor]["threshold"].as<double>();
             Factor.Parameter(1) = YAMLConfig["factors"][nFactor]["std_dev"].as<double>();
+
+            /** optional own candidates within a radius around the estimated trajectory, zero disables them */
+            Factor.Parameter(2) = 0.0;
+            Factor.Parameter(3) = 0.0;
+            if(YAMLConfig["factors"][nFactor]["proposal_radius"].IsDefined())
+            {
+              Factor.Parameter(2) = YAMLConfig["factors"][nFactor]["proposal_radius"].as<double>();
+            }
+            if(YAMLConfig["factors"][nFactor]["proposal_exclusion"].IsDefined())
+            {
+              Factor.Parameter(3) = YAMLConfig["factors"][nFactor]["proposal_exclusion"].as<double>();
+            }
             break;
 
           default:
@@ -0,0 +1,43 @@
+/***************************************************************************
+ * libRSF - A Robust Sensor Fusion Library
+ *
+ * Copyright (C) 2019 Chair of Automation Technology / TU Chemnitz
+ * For more information see https://www.tu-chemnitz.de/etit/proaut/libRSF
+ *
+ * libRSF is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libRSF is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with libRSF.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Tim Pfeifer (tim.pfeifer@etit.tu-chemnitz.de)
+ ***************************************************************************/
+
+/**
+ * @file FactorGraphInstances.cpp
+ * @author Tim Pfeifer
+ * @date 14.10.2026
+ * @brief Explicit instantiations of the common factor and error model combinations.
+ * @copyright GNU Public License.
+ *
+ */
+
+#include "FactorGraph.h"
+
+namespace libRSF
+{
+  /** the auto-diff cost functions of these combinations are compiled here instead of in every application */
+#define LIBRSF_INSTANTIATE_FACTOR(Type, ErrorModelType) \
+  template void FactorGraph::addFactorBase_<FactorType::Type, ErrorModelType>(const StateList&, const ErrorModelType&, const Data&, ceres::LossFunction*, bool);
+
+  LIBRSF_FACTOR_INSTANCES(LIBRSF_INSTANTIATE_FACTOR)
+
+#undef LIBRSF_INSTANTIATE_FACTOR
+}
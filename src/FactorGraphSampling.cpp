@@ -22,39 +22,235 @@
 
 #include "FactorGraphSampling.h"
 
+#include <algorithm>
+#include <atomic>
+#include <map>
+
 namespace libRSF
 {
+  namespace
+  {
+    /** private copy of all factors that are connected to one state */
+    class LocalCostProblem
+    {
+      public:
+        LocalCostProblem(const ceres::Problem &Graph,
+                         const double * const StatePointer,
+                         const std::vector<ceres::ResidualBlockId> &Blocks)
+          : Problem_(CreateOptions_())
+        {
+          std::vector<double*> Pointers;
+          for (const ceres::ResidualBlockId &Block : Blocks)
+          {
+            /** copy the connected parameter blocks once */
+            std::vector<double*> OriginalPointers;
+            Graph.GetParameterBlocksForResidualBlock(Block, &OriginalPointers);
+
+            Pointers.clear();
+            for (double * const Original : OriginalPointers)
+            {
+              auto It = Copies_.find(Original);
+              if (It == Copies_.end())
+              {
+                It = Copies_.emplace(Original, VectorRefConst<double, Dynamic>(Original, Graph.ParameterBlockSize(Original))).first;
+              }
+              Pointers.push_back(It->second.data());
+            }
+
+            /** cost and loss functions are shared, they are only evaluated */
+            Problem_.AddResidualBlock(const_cast<ceres::CostFunction*>(Graph.GetCostFunctionForResidualBlock(Block)),
+                                      const_cast<ceres::LossFunction*>(Graph.GetLossFunctionForResidualBlock(Block)),
+                                      Pointers);
+          }
+
+          /** mirror the configuration of the parameter blocks */
+          for (auto &Copy : Copies_)
+          {
+            const ceres::LocalParameterization * const Parametrization = Graph.GetParameterization(Copy.first);
+            if (Parametrization != nullptr)
+            {
+              Problem_.SetParameterization(Copy.second.data(), const_cast<ceres::LocalParameterization*>(Parametrization));
+            }
+            if (Graph.IsParameterBlockConstant(Copy.first))
+            {
+              Problem_.SetParameterBlockConstant(Copy.second.data());
+            }
+          }
+
+          State_ = Copies_.at(StatePointer).data();
+        }
+
+        ceres::Problem &getProblem()
+        {
+          return Problem_;
+        }
+
+        double *getState()
+        {
+          return State_;
+        }
+
+      private:
+        static ceres::Problem::Options CreateOptions_()
+        {
+          ceres::Problem::Options Options;
+          Options.cost_function_ownership = ceres::DO_NOT_TAKE_OWNERSHIP;
+          Options.loss_function_ownership = ceres::DO_NOT_TAKE_OWNERSHIP;
+          Options.local_parameterization_ownership = ceres::DO_NOT_TAKE_OWNERSHIP;
+          Options.context = GetCeresContext();
+          return Options;
+        }
+
+        ceres::Problem Problem_;
+
+        /** node based to keep the pointers stable */
+        std::map<const double*, Vector> Copies_;
+        double *State_ = nullptr;
+    };
+  }
+
   void EvaluateCostSurfacePoints(ceres::Problem &Graph,
                                  double * const StatePointer,
                                  const int Dim,
                                  const VectorVectorSTL<Dynamic> &Points,
                                  std::vector<double> &Costs)
   {
-    /** save original value */
-    VectorRef<double, Dynamic> State(StatePointer, Dim);
-    const Vector OriginalState = State;
+    EvaluateCostSurfacePoints(Graph, StatePointer, Dim, Points, Costs, nullptr, nullptr);
+  }
+
+  void EvaluateCostSurfacePoints(ceres::Problem &Graph,
+                                 double * const StatePointer,
+                                 const int Dim,
+                                 const VectorVectorSTL<Dynamic> &Points,
+                                 std::vector<double> &Costs,
+                                 std::vector<Vector> * const Gradients,
+                                 std::vector<Matrix> * const Hessians,
+                                 const int ThreadNumber)
+  {
+    const size_t PointNumber = Points.size();
+    Costs.assign(PointNumber, 0.0);
+    if (Gradients != nullptr)
+    {
+      Gradients->assign(PointNumber, Vector::Zero(Dim));
+    }
+    if (Hessians != nullptr)
+    {
+      Hessians->assign(PointNumber, Matrix::Zero(Dim, Dim));
+    }
+    if (PointNumber == 0)
+    {
+      return;
+    }
 
-    /** configure evaluation */
+    /** only factors that are connected to the sampled state change their cost */
+    std::vector<ceres::ResidualBlockId> Blocks;
+    Graph.GetResidualBlocksForParameterBlock(StatePointer, &Blocks);
+
+    /** the remaining factors are a constant offset */
     ceres::Problem::EvaluateOptions Options;
     Options.apply_loss_function = true;
-    Options.num_threads = static_cast<int>(std::thread::hardware_concurrency());
-    Options.parameter_blocks = {StatePointer};
+    Options.num_threads = GetThreadNumber();
+
+    double TotalCost = 0.0;
+    Graph.Evaluate(Options, &TotalCost, nullptr, nullptr, nullptr);
+
+    double LocalCost = 0.0;
+    if (!Blocks.empty())
+    {
+      Options.residual_blocks = Blocks;
+      Graph.Evaluate(Options, &LocalCost, nullptr, nullptr, nullptr);
+    }
+    const double ConstantCost = TotalCost - LocalCost;
+
+    if (Blocks.empty())
+    {
+      Costs.assign(PointNumber, ConstantCost);
+      return;
+    }
+
+    /** batches of points are distributed over the threads, small grids are split evenly */
+    size_t Threads = ThreadNumber > 0 ? static_cast<size_t>(ThreadNumber) : static_cast<size_t>(GetThreadNumber());
+    Threads = std::max<size_t>(1, std::min(Threads, PointNumber));
 
-    /** loop over grid */
-    Costs.clear();
-    for (const auto &Point : Points)
+    const size_t BatchSize = std::min<size_t>(64, (PointNumber + Threads - 1) / Threads);
+    const size_t BatchNumber = (PointNumber + BatchSize - 1) / BatchSize;
+    Threads = std::min(Threads, BatchNumber);
+
+    std::atomic<size_t> NextBatch(0);
+    auto Worker = [&](size_t)
     {
-      State = Point;
+      /** every thread works on its own copy of the sub-problem */
+      LocalCostProblem Local(Graph, StatePointer, Blocks);
+      VectorRef<double, Dynamic> State(Local.getState(), Dim);
+
+      ceres::Problem::EvaluateOptions LocalOptions;
+      LocalOptions.apply_loss_function = true;
+      LocalOptions.num_threads = 1;
+      LocalOptions.parameter_blocks = {Local.getState()};
+
+      std::vector<double> Gradient;
+      ceres::CRSMatrix JacobianCRS;
+      Matrix Jacobian;
+
+      for (size_t Batch = NextBatch++; Batch < BatchNumber; Batch = NextBatch++)
+      {
+        const size_t End = std::min(PointNumber, (Batch + 1) * BatchSize);
+        for (size_t n = Batch * BatchSize; n < End; ++n)
+        {
+          State = Points.at(n);
+
+          double Cost = 0.0;
+          Local.getProblem().Evaluate(LocalOptions,
+                                      &Cost,
+                                      nullptr,
+                                      Gradients != nullptr ? &Gradient : nullptr,
+                                      Hessians != nullptr ? &JacobianCRS : nullptr);
 
-      /** evaluate */
-      double Cost;
-      Graph.Evaluate(Options, &Cost, nullptr, nullptr, nullptr);
+          Costs.at(n) = ConstantCost + Cost;
 
-      /** save result */
-      Costs.push_back(Cost);
+          if (Gradients != nullptr)
+          {
+            Gradients->at(n) = VectorRefConst<double, Dynamic>(Gradient.data(), static_cast<Index>(Gradient.size()));
+          }
+
+          if (Hessians != nullptr)
+          {
+            CRSToMatrix(JacobianCRS, Jacobian);
+            Hessians->at(n) = Jacobian.transpose() * Jacobian;
+          }
+        }
+      }
+    };
+
+    GetThreadPool().parallelRun(static_cast<int>(Threads), Worker);
+  }
+
+  void EvaluateLocalCostPoints(const ceres::Problem &Graph,
+                               const double * const StatePointer,
+                               const int Dim,
+                               const VectorVectorSTL<Dynamic> &Points,
+                               std::vector<double> &Costs)
+  {
+    Costs.assign(Points.size(), 0.0);
+
+    std::vector<ceres::ResidualBlockId> Blocks;
+    Graph.GetResidualBlocksForParameterBlock(StatePointer, &Blocks);
+    if (Blocks.empty() || Points.empty())
+    {
+      return;
     }
 
-    /** restore original cost */
-    State = OriginalState;
+    LocalCostProblem Local(Graph, StatePointer, Blocks);
+    VectorRef<double, Dynamic> State(Local.getState(), Dim);
+
+    ceres::Problem::EvaluateOptions Options;
+    Options.apply_loss_function = true;
+    Options.num_threads = 1;
+
+    for (size_t n = 0; n < Points.size(); ++n)
+    {
+      State = Points.at(n);
+      Local.getProblem().Evaluate(Options, &Costs.at(n), nullptr, nullptr, nullptr);
+    }
   }
 }  // namespace libRSF
@@ -22,6 +22,12 @@
 
 #include "FactorGraphStructure.h"
 
+#include <algorithm>
+#include <functional>
+#include <map>
+#include <unordered_map>
+#include <unordered_set>
+
 namespace libRSF
 {
   FactorGraphStructure::FactorGraphStructure(ceres::Problem *GraphPointer, StateDataSet * Data): Data_(Data), Graph_(GraphPointer)
@@ -100,7 +106,7 @@ namespace libRSF
       StateDimsLocal.emplace_back(Graph_->ParameterBlockLocalSize(State));
 
       /** find state info */
-      StateInfo Info = States_.at(State);
+      const StateInfo &Info = States_.at(State);
       StateIDs.emplace_back(StateID(Info.Name, Info.Timestamp, Info.Number));
       StateTypes.emplace_back(Info.Type);
     }
@@ -108,15 +114,15 @@ namespace libRSF
 
   void FactorGraphStructure::getFactorsOfState(const StateID &State, std::vector<FactorID> &Factors) const
   {
-    if (!Data_->checkElement(State.ID, State.Timestamp, State.Number))
+    if (!Data_->checkElement(State.ID, State.getTimestamp(), State.Number))
     {
-      PRINT_ERROR("State does not exist: ", State.ID, " ", State.Timestamp, " ", State.Number);
+      PRINT_ERROR("State does not exist: ", State.ID, " ", State.getTimestamp(), " ", State.Number);
       return;
     }
 
     /** get state pointer */
     double* StatePointer;
-    StatePointer = Data_->getElement(State.ID, State.Timestamp, State.Number).getMeanPointer();
+    StatePointer = Data_->getElement(State.ID, State.getTimestamp(), State.Number).getMeanPointer();
 
     /** get connected residual IDs */
     std::vector<ceres::ResidualBlockId> Residuals;
@@ -126,16 +132,87 @@ namespace libRSF
     Factors.clear();
     for(const ceres::ResidualBlockId Res: Residuals)
     {
-      FactorID Factor(Factors_.at(Res).Type, Factors_.at(Res).Timestamp, Factors_.at(Res).Number);
+      const FactorInfo &Info = Factors_.at(Res);
+      FactorID Factor(Info.Type, Info.Timestamp, Info.Number);
       Factors.push_back(Factor);
     }
 
   }
 
+  void FactorGraphStructure::getConnectedComponents(std::vector<std::vector<ceres::ResidualBlockId>> &Components) const
+  {
+    Components.clear();
+
+    /** union-find over the variable states, roots are found with path halving */
+    std::unordered_map<double*, size_t> Index;
+    std::vector<size_t> Parent;
+    const auto Find = [&Parent](size_t Node)
+    {
+      while (Parent[Node] != Node)
+      {
+        Parent[Node] = Parent[Parent[Node]];
+        Node = Parent[Node];
+      }
+      return Node;
+    };
+
+    /** connect all variable states of each factor with its first one */
+    std::vector<std::pair<ceres::ResidualBlockId, size_t>> FactorNodes;
+    FactorNodes.reserve(Factors_.size());
+    std::vector<double*> StatePointers;
+    Factors_.forEach([&](const ceres::ResidualBlockId Factor, const FactorInfo &/*Info*/)
+    {
+      Graph_->GetParameterBlocksForResidualBlock(Factor, &StatePointers);
+
+      bool HasVariable = false;
+      size_t First = 0;
+      for (double* const State : StatePointers)
+      {
+        if (Graph_->IsParameterBlockConstant(State))
+        {
+          continue;
+        }
+
+        const auto Inserted = Index.emplace(State, Parent.size());
+        if (Inserted.second)
+        {
+          Parent.push_back(Parent.size());
+        }
+
+        if (!HasVariable)
+        {
+          HasVariable = true;
+          First = Inserted.first->second;
+        }
+        else
+        {
+          Parent[Find(Inserted.first->second)] = Find(First);
+        }
+      }
+
+      if (HasVariable)
+      {
+        FactorNodes.emplace_back(Factor, First);
+      }
+    });
+
+    /** one group per root */
+    std::unordered_map<size_t, size_t> Groups;
+    for (const auto &FactorNode : FactorNodes)
+    {
+      const auto Group = Groups.emplace(Find(FactorNode.second), Components.size());
+      if (Group.second)
+      {
+        Components.emplace_back();
+      }
+      Components.at(Group.first->second).push_back(FactorNode.first);
+    }
+  }
+
   void FactorGraphStructure::removeState(const StateID &State)
   {
     /** get raw pointer*/
-    double* StatePointer = Data_->getElement(State.ID, State.Timestamp, State.Number).getMeanPointer();
+    double* StatePointer = Data_->getElement(State.ID, State.getTimestamp(), State.Number).getMeanPointer();
 
     /** remove state info */
     States_.erase(StatePointer);
@@ -149,6 +226,9 @@ namespace libRSF
     {
       this->removeFactor(Factor);
     }
+
+    /** a removed state can not be changed anymore */
+    ChangedStates_.erase(StatePointer);
   }
 
   void FactorGraphStructure::removeFactor(const ceres::ResidualBlockId Factor)
@@ -160,6 +240,11 @@ namespace libRSF
     /** clear mapping ceres --> libRSF */
     Factors_.erase(Factor);
 
+    /** the connected states lost information */
+    std::vector<double*> StatePointers;
+    Graph_->GetParameterBlocksForResidualBlock(Factor, &StatePointers);
+    ChangedStates_.insert(StatePointers.begin(), StatePointers.end());
+
     /** decrement index in factor info to correct the number of the elements above the deleted one*/
     for (int n = Info.Number; n < FactorList_.countElement(Info.Type, Info.Timestamp); n++)
     {
@@ -167,14 +252,117 @@ namespace libRSF
     }
   }
 
+  void FactorGraphStructure::removeFactors(const std::vector<ceres::ResidualBlockId> &Factors)
+  {
+    /** group the removed numbers by type and timestamp */
+    std::map<std::pair<FactorType, double>, std::vector<int>> Groups;
+    for (const ceres::ResidualBlockId Factor : Factors)
+    {
+      if (Factors_.count(Factor) == 0)
+      {
+        continue; /**< already removed or a duplicate */
+      }
+
+      const FactorInfo &Info = Factors_.at(Factor);
+      Groups[std::make_pair(Info.Type, Info.Timestamp)].push_back(Info.Number);
+
+      /** the connected states lost information */
+      std::vector<double*> StatePointers;
+      Graph_->GetParameterBlocksForResidualBlock(Factor, &StatePointers);
+      ChangedStates_.insert(StatePointers.begin(), StatePointers.end());
+
+      /** clear mapping ceres --> libRSF */
+      Factors_.erase(Factor);
+    }
+
+    /** clear mapping libRSF --> ceres */
+    for (auto &Group : Groups)
+    {
+      const FactorType Type = Group.first.first;
+      const double Timestamp = Group.first.second;
+      std::vector<int> &Numbers = Group.second;
+
+      if (static_cast<int>(Numbers.size()) == FactorList_.countElement(Type, Timestamp))
+      {
+        /** the whole timestamp is gone, nothing to renumber */
+        FactorList_.removeElement(Type, Timestamp);
+        continue;
+      }
+
+      /** remove from the back to keep the remaining numbers valid */
+      std::sort(Numbers.begin(), Numbers.end(), std::greater<>());
+      for (const int Number : Numbers)
+      {
+        FactorList_.removeElement(Type, Timestamp, Number);
+      }
+
+      /** renumber the remaining factors once */
+      for (int n = 0; n < FactorList_.countElement(Type, Timestamp); n++)
+      {
+        Factors_.at(FactorList_.getElement(Type, Timestamp, n)).Number = n;
+      }
+    }
+  }
+
+  void FactorGraphStructure::removeFactorsBeforeOrEqual(const double Timestamp, std::vector<ceres::ResidualBlockId> &Factors)
+  {
+    Factors.clear();
+    for (const FactorType Type : FactorList_.getKeysBeforeOrEqual(Timestamp))
+    {
+      double TimeFirst = Timestamp;
+      FactorList_.getTimeFirst(Type, TimeFirst);
+      for (const ceres::ResidualBlockId Factor : FactorList_.range(Type, TimeFirst, Timestamp))
+      {
+        /** the connected states lost information */
+        std::vector<double*> StatePointers;
+        Graph_->GetParameterBlocksForResidualBlock(Factor, &StatePointers);
+        ChangedStates_.insert(StatePointers.begin(), StatePointers.end());
+
+        /** clear mapping ceres --> libRSF */
+        Factors_.erase(Factor);
+        Factors.push_back(Factor);
+      }
+
+      /** whole timestamps are removed, so no factor has to be renumbered */
+      FactorList_.removeElementsBeforeOrEqual(Type, Timestamp);
+    }
+  }
+
+  void FactorGraphStructure::removeStates(const std::vector<StateID> &States)
+  {
+    std::vector<ceres::ResidualBlockId> Factors;
+    for (const StateID &State : States)
+    {
+      /** get raw pointer*/
+      double* StatePointer = Data_->getElement(State.ID, State.getTimestamp(), State.Number).getMeanPointer();
+
+      /** remove state info */
+      States_.erase(StatePointer);
+
+      /** collect connected factors */
+      std::vector<ceres::ResidualBlockId> Connected;
+      Graph_->GetResidualBlocksForParameterBlock(StatePointer, &Connected);
+      Factors.insert(Factors.end(), Connected.begin(), Connected.end());
+    }
+
+    /** remove connected factors, duplicates are skipped */
+    this->removeFactors(Factors);
+
+    /** removed states can not be changed anymore */
+    for (const StateID &State : States)
+    {
+      ChangedStates_.erase(Data_->getElement(State.ID, State.getTimestamp(), State.Number).getMeanPointer());
+    }
+  }
+
   void FactorGraphStructure::removeFactor(const FactorID &Factor)
   {
-    this->removeFactor(FactorList_.getElement(Factor.ID, Factor.Timestamp, Factor.Number));
+    this->removeFactor(FactorList_.getElement(Factor.ID, Factor.getTimestamp(), Factor.Number));
   }
 
   void FactorGraphStructure::getResidualID(const FactorID &Factor, ceres::ResidualBlockId &Residual) const
   {
-    FactorList_.getElement(Factor.ID, Factor.Timestamp, Factor.Number, Residual);
+    FactorList_.getElement(Factor.ID, Factor.getTimestamp(), Factor.Number, Residual);
   }
 
   void FactorGraphStructure::getErrorModel(const FactorID &Factor, ErrorModelBase* &ErrorModel) const
@@ -184,6 +372,46 @@ namespace libRSF
     ErrorModel = Factors_.at(ID).ErrorModel;
   }
 
+  void FactorGraphStructure::reserve(const size_t States, const size_t Factors)
+  {
+    States_.reserve(States);
+    Factors_.reserve(Factors);
+  }
+
+  void FactorGraphStructure::getErrorModel(const ceres::ResidualBlockId Factor, ErrorModelBase* &ErrorModel) const
+  {
+    ErrorModel = Factors_.at(Factor).ErrorModel;
+  }
+
+  bool FactorGraphStructure::getFactorInfo(const ceres::ResidualBlockId Factor, FactorInfo &Info) const
+  {
+    if (Factors_.count(Factor) == 0)
+    {
+      return false;
+    }
+    Info = Factors_.at(Factor);
+    return true;
+  }
+
+  void FactorGraphStructure::replaceResidualIDs(const std::vector<std::pair<ceres::ResidualBlockId, ceres::ResidualBlockId>> &Factors)
+  {
+    /** remove all old IDs first, a new ID might be the address of another old one */
+    std::vector<FactorInfo> Infos;
+    Infos.reserve(Factors.size());
+    for (const auto &Factor : Factors)
+    {
+      Infos.push_back(Factors_.at(Factor.first));
+      Factors_.erase(Factor.first);
+    }
+
+    for (size_t n = 0; n < Factors.size(); n++)
+    {
+      ceres::ResidualBlockId NewFactor = Factors.at(n).second;
+      FactorList_.setElement(Infos.at(n).Type, Infos.at(n).Timestamp, Infos.at(n).Number, NewFactor);
+      Factors_.emplace(NewFactor, Infos.at(n));
+    }
+  }
+
   void FactorGraphStructure::getErrorInputSize(const FactorID &Factor, int &ResidualSize) const
   {
     ceres::ResidualBlockId ID;
@@ -223,6 +451,93 @@ namespace libRSF
     Blocks = FactorList_.getElementsOfID(Type);
   }
 
+  const std::atomic<bool>* FactorGraphStructure::getErrorModelGroup_(const FactorType Type)
+  {
+    std::unique_ptr<std::atomic<bool>> &Group = ErrorModelGroups_[Type];
+    if (Group == nullptr)
+    {
+      Group = std::make_unique<std::atomic<bool>>(true);
+    }
+    return Group.get();
+  }
+
+  void FactorGraphStructure::setErrorModelsEnabled(const FactorType Type, const bool Enable)
+  {
+    std::unique_ptr<std::atomic<bool>> &Group = ErrorModelGroups_[Type];
+    if (Group == nullptr)
+    {
+      Group = std::make_unique<std::atomic<bool>>(Enable);
+    }
+    else
+    {
+      Group->store(Enable);
+    }
+  }
+
+  bool FactorGraphStructure::areErrorModelsEnabled(const FactorType Type) const
+  {
+    const auto It = ErrorModelGroups_.find(Type);
+    return It == ErrorModelGroups_.end() || It->second->load();
+  }
+
+  bool FactorGraphStructure::checkResidualID(const ceres::ResidualBlockId Residual) const
+  {
+    return Factors_.count(Residual) > 0;
+  }
+
+  bool FactorGraphStructure::isLandmark(double * const State) const
+  {
+    if (States_.count(State) == 0)
+    {
+      return false;
+    }
+
+    const StateInfo &Info = States_.at(State);
+    if (Info.Name.getName().rfind("Landmark", 0) == 0)
+    {
+      return true;
+    }
+
+    const bool IsPoint = (Info.Type == DataType::Point1 || Info.Type == DataType::Point2 || Info.Type == DataType::Point3);
+    return IsPoint && Info.Timestamp == 0.0;
+  }
+
+  bool FactorGraphStructure::getStateTimestamp(double * const State, double &Timestamp) const
+  {
+    if (States_.count(State) == 0)
+    {
+      return false;
+    }
+
+    Timestamp = States_.at(State).Timestamp;
+    return true;
+  }
+
+  bool FactorGraphStructure::validateResidualIDs(const FactorType Type) const
+  {
+#ifndef NDEBUG
+    std::vector<ceres::ResidualBlockId> CeresIDs;
+    Graph_->GetResidualBlocks(&CeresIDs);
+    const std::unordered_set<ceres::ResidualBlockId> CeresSet(CeresIDs.begin(), CeresIDs.end());
+
+    std::vector<ceres::ResidualBlockId> IDs;
+    this->getResidualIDs(Type, IDs);
+
+    bool Valid = true;
+    for (const ceres::ResidualBlockId ID : IDs)
+    {
+      if (CeresSet.count(ID) == 0 || !this->checkResidualID(ID))
+      {
+        PRINT_ERROR("Found missing ID of factor type ", Type);
+        Valid = false;
+      }
+    }
+    return Valid;
+#else
+    return true;
+#endif // NDEBUG
+  }
+
   void FactorGraphStructure::getTimesBetween(const FactorType Type, const double StartTime, const double EndTime, std::vector<double> &Times) const
   {
     FactorList_.getTimesBetween(Type, StartTime, EndTime, Times);
@@ -259,6 +574,15 @@ namespace libRSF
     Factors = FactorList_.getKeysAll();
   }
 
+  size_t FactorGraphStructure::getMemorySize() const
+  {
+    return States_.getMemorySize()
+           + Factors_.getMemorySize()
+           + ChangedStates_.size() * (TreeNodeOverhead + sizeof(double*))
+           + ErrorModelGroups_.size() * (TreeNodeOverhead + sizeof(FactorType) + sizeof(std::unique_ptr<std::atomic<bool>>) + sizeof(std::atomic<bool>))
+           + FactorList_.getMemorySize();
+  }
+
   int FactorGraphStructure::countFactor(const FactorType Type, const double Timestamp) const
   {
     return FactorList_.countElement(Type, Timestamp);
@@ -278,4 +602,19 @@ namespace libRSF
   {
     return FactorList_.checkID(Type);
   }
+
+  void FactorGraphStructure::getChangedStates(std::vector<double*> &States) const
+  {
+    States.assign(ChangedStates_.begin(), ChangedStates_.end());
+  }
+
+  int FactorGraphStructure::countChangedStates() const
+  {
+    return static_cast<int>(ChangedStates_.size());
+  }
+
+  void FactorGraphStructure::resetChangedStates()
+  {
+    ChangedStates_.clear();
+  }
 }
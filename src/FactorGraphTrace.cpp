@@ -0,0 +1,572 @@
+/***************************************************************************
+ * libRSF - A Robust Sensor Fusion Library
+ *
+ * Copyright (C) 2018 Chair of Automation Technology / TU Chemnitz
+ * For more information see https://www.tu-chemnitz.de/etit/proaut/libRSF
+ *
+ * libRSF is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libRSF is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with libRSF.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Tim Pfeifer (tim.pfeifer@etit.tu-chemnitz.de)
+ ***************************************************************************/
+
+#include "FactorGraph.h"
+
+namespace libRSF
+{
+  FactorGraph::TraceScope_::TraceScope_(FactorGraph &Graph, const TraceOperation Operation, const bool WithMeans)
+    : Writer((Graph.Trace_ != nullptr && Graph.TraceDepth_ == 0) ? &Graph.Trace_->begin(WithMeans ? TraceOperation::SetMeans : Operation) : nullptr),
+      Graph_(Graph)
+  {
+    /** the means are a record of their own in front of the operation */
+    if (Writer != nullptr && WithMeans)
+    {
+      Graph_.traceMeans_(*Writer);
+      Graph_.Trace_->end(0.0);
+      Graph_.Trace_->begin(Operation);
+    }
+    Graph_.TraceDepth_++;
+    Clock_.reset();
+  }
+
+  FactorGraph::TraceScope_::~TraceScope_()
+  {
+    Graph_.TraceDepth_--;
+    if (Writer != nullptr)
+    {
+      Graph_.Trace_->end(Clock_.getSeconds());
+    }
+  }
+
+  bool FactorGraph::startTrace(const string &Filename)
+  {
+    auto Trace = std::make_unique<GraphTraceWriter>(Filename);
+    if (!Trace->isValid())
+    {
+      return false;
+    }
+
+    /** an existing graph can not be reproduced from the operations that follow */
+    if (Graph_.NumParameterBlocks() > 0)
+    {
+      PRINT_WARNING("The trace starts with a non-empty graph, it can not be replayed without the current content!");
+    }
+
+    Trace_ = std::move(Trace);
+    TraceDepth_ = 0;
+    TraceIsComplete_ = true;
+    return true;
+  }
+
+  void FactorGraph::stopTrace()
+  {
+    Trace_.reset();
+  }
+
+  void FactorGraph::traceMeans_(CheckpointWriter &Writer)
+  {
+    std::vector<StateID> States;
+    for (const StateKey &Key : StateData_.getKeysAll())
+    {
+      std::vector<StateID> IDs;
+      StateData_.getUniqueIDs(Key, IDs);
+      States.insert(States.end(), IDs.begin(), IDs.end());
+    }
+
+    Writer.write(static_cast<uint64_t>(States.size()));
+    for (const StateID &ID : States)
+    {
+      Writer.writeStateID(ID);
+      Writer.writeMatrix(StateData_.getElement(ID.ID, ID.getTimestamp(), ID.Number).getMean());
+    }
+  }
+
+  void FactorGraph::traceFactor_(const FactorType Type, const double Timestamp, const StateList &States, const Data &Measurement, const std::string* Handler)
+  {
+    /** factors that are added by the graph itself are part of the recorded operation */
+    if (TraceDepth_ > 0)
+    {
+      return;
+    }
+
+    ceres::ResidualBlockId CeresID;
+    ErrorModelBase* Model;
+    Structure_.getResidualID(FactorID(Type, Timestamp, Structure_.countFactor(Type, Timestamp) - 1), CeresID);
+    Structure_.getErrorModel(CeresID, Model);
+
+    /** the error model is serialized first, because not every model supports it */
+    CheckpointWriter ErrorModel;
+    if (!getCheckpointHandlers_().at(*Handler).Serialize(Model, ErrorModel))
+    {
+      this->traceUnsupported_(Handler->c_str());
+      return;
+    }
+
+    CheckpointWriter &Writer = Trace_->begin(TraceOperation::AddFactor);
+    Writer.writeString(*Handler);
+    Writer.write(static_cast<uint32_t>(States.List_.size()));
+    for (const StateID &ID : States.List_)
+    {
+      Writer.writeStateID(ID);
+    }
+    Writer.writeData(Measurement);
+    Writer.append(ErrorModel);
+    Trace_->end(0.0);
+  }
+
+  void FactorGraph::traceUnsupported_(const char* Operation)
+  {
+    if (TraceIsComplete_ && TraceDepth_ == 0)
+    {
+      PRINT_WARNING("The trace does not contain: ", Operation, ", the replay will differ!");
+      TraceIsComplete_ = false;
+    }
+  }
+
+  bool FactorGraph::replayTrace(const string &Filename, std::vector<TraceTiming> *Timings)
+  {
+    LIBRSF_TRACE_SCOPE("replay_trace");
+
+    if (Graph_.NumParameterBlocks() > 0 || Trace_ != nullptr)
+    {
+      PRINT_ERROR("A trace can only be replayed into an empty graph that does not record itself!");
+      return false;
+    }
+
+    CheckpointReader Reader;
+    if (!OpenGraphTrace(Filename, Reader))
+    {
+      return false;
+    }
+
+    if (Timings != nullptr)
+    {
+      Timings->clear();
+    }
+
+    Timer Clock;
+    while (!Reader.isAtEnd())
+    {
+      uint8_t Code = 0;
+      if (!Reader.read(Code) || Code >= static_cast<uint8_t>(TraceOperation::Number))
+      {
+        PRINT_ERROR("Unknown operation in graph trace: ", Filename);
+        return false;
+      }
+      const TraceOperation Operation = static_cast<TraceOperation>(Code);
+
+      Clock.reset();
+      const bool IsReplayed = this->replayOperation_(Operation, Reader);
+      const double Duration = Clock.getSeconds();
+
+      double Recorded = 0.0;
+      if (!IsReplayed || !Reader.read(Recorded))
+      {
+        PRINT_ERROR("Corrupted ", GetTraceOperationName(Operation), " record in graph trace: ", Filename);
+        return false;
+      }
+
+      if (Timings != nullptr)
+      {
+        TraceTiming Timing;
+        Timing.Operation = Operation;
+        Timing.Recorded = Recorded;
+        Timing.Replayed = Duration;
+        Timings->push_back(Timing);
+      }
+    }
+    return true;
+  }
+
+  bool FactorGraph::replayOperation_(const TraceOperation Operation, CheckpointReader &Reader)
+  {
+    std::string Name;
+    double Timestamp = 0.0, TimeWindow = 0.0, CurrentTime = 0.0, Inflation = 1.0;
+    int32_t Number = 0, Type = 0;
+    uint8_t Flag = 0;
+
+    switch (Operation)
+    {
+      case TraceOperation::AddState:
+        {
+          Data Element;
+          if (!Reader.readString(Name) || !Reader.readData(Element))
+          {
+            return false;
+          }
+          this->addState(Name, Element);
+          return true;
+        }
+
+      case TraceOperation::AddFactor:
+        {
+          std::string Key;
+          uint32_t StateNumber = 0;
+          if (!Reader.readString(Key) || !Reader.read(StateNumber))
+          {
+            return false;
+          }
+
+          StateList States;
+          for (uint32_t nState = 0; nState < StateNumber; nState++)
+          {
+            StateID ID;
+            if (!Reader.readStateID(ID))
+            {
+              return false;
+            }
+            States.add(ID);
+          }
+
+          Data Measurement;
+          if (!Reader.readData(Measurement))
+          {
+            return false;
+          }
+
+          /** like checkpoints, the replaying program has to instantiate the same factors */
+          const auto Handler = getCheckpointHandlers_().find(Key);
+          if (Handler == getCheckpointHandlers_().end())
+          {
+            PRINT_ERROR("Factor of the trace is not available in this program: ", Key);
+            return false;
+          }
+          return Handler->second.Rebuild(*this, States, Measurement, Reader);
+        }
+
+      case TraceOperation::AddStatePrior:
+        {
+          StateID ID;
+          Vector Mean;
+          Matrix SqrtInformation;
+          if (!Reader.readStateID(ID) || !Reader.readMatrix(Mean) || !Reader.readMatrix(SqrtInformation))
+          {
+            return false;
+          }
+          this->addStatePrior(ID, Mean, SqrtInformation);
+          return true;
+        }
+
+      case TraceOperation::SetMeans:
+        {
+          uint64_t StateNumber = 0;
+          if (!Reader.read(StateNumber))
+          {
+            return false;
+          }
+          for (uint64_t nState = 0; nState < StateNumber; nState++)
+          {
+            StateID ID;
+            Vector Mean;
+            if (!Reader.readStateID(ID) || !Reader.readMatrix(Mean))
+            {
+              return false;
+            }
+            if (StateData_.checkElement(ID.ID, ID.getTimestamp(), ID.Number))
+            {
+              StateData_.getElement(ID.ID, ID.getTimestamp(), ID.Number).setMean(Mean);
+            }
+          }
+          return true;
+        }
+
+      case TraceOperation::RemoveFactor:
+        if (!Reader.read(Type) || !Reader.read(Timestamp) || !Reader.read(Number))
+        {
+          return false;
+        }
+        this->removeFactor(static_cast<FactorType>(Type), Timestamp, Number);
+        return true;
+
+      case TraceOperation::RemoveFactors:
+        if (!Reader.read(Type) || !Reader.read(Timestamp))
+        {
+          return false;
+        }
+        this->removeFactor(static_cast<FactorType>(Type), Timestamp);
+        return true;
+
+      case TraceOperation::RemoveFactorsOutsideWindow:
+        if (!Reader.read(Type) || !Reader.read(TimeWindow) || !Reader.read(CurrentTime))
+        {
+          return false;
+        }
+        this->removeFactorsOutsideWindow(static_cast<FactorType>(Type), TimeWindow, CurrentTime);
+        return true;
+
+      case TraceOperation::RemoveAllFactorsOutsideWindow:
+        if (!Reader.read(TimeWindow) || !Reader.read(CurrentTime))
+        {
+          return false;
+        }
+        this->removeAllFactorsOutsideWindow(TimeWindow, CurrentTime);
+        return true;
+
+      case TraceOperation::RemoveState:
+        if (!Reader.readString(Name) || !Reader.read(Timestamp) || !Reader.read(Number))
+        {
+          return false;
+        }
+        this->removeState(Name, Timestamp, Number);
+        return true;
+
+      case TraceOperation::RemoveStates:
+        if (!Reader.readString(Name) || !Reader.read(Timestamp))
+        {
+          return false;
+        }
+        this->removeState(Name, Timestamp);
+        return true;
+
+      case TraceOperation::RemoveStatesOutsideWindow:
+        if (!Reader.readString(Name) || !Reader.read(TimeWindow) || !Reader.read(CurrentTime))
+        {
+          return false;
+        }
+        this->removeStatesOutsideWindow(Name, TimeWindow, CurrentTime);
+        return true;
+
+      case TraceOperation::RemoveAllStatesOutsideWindow:
+        if (!Reader.read(TimeWindow) || !Reader.read(CurrentTime))
+        {
+          return false;
+        }
+        this->removeAllStatesOutsideWindow(TimeWindow, CurrentTime);
+        return true;
+
+      case TraceOperation::RemoveBefore:
+        if (!Reader.read(Timestamp))
+        {
+          return false;
+        }
+        this->removeBefore(Timestamp);
+        return true;
+
+      case TraceOperation::SetConstant:
+        if (!Reader.readString(Name) || !Reader.read(Timestamp))
+        {
+          return false;
+        }
+        this->setConstant(Name, Timestamp);
+        return true;
+
+      case TraceOperation::SetVariable:
+        if (!Reader.readString(Name) || !Reader.read(Timestamp))
+        {
+          return false;
+        }
+        this->setVariable(Name, Timestamp);
+        return true;
+
+      case TraceOperation::SetVariableAll:
+        if (!Reader.readString(Name))
+        {
+          return false;
+        }
+        this->setVariable(Name);
+        return true;
+
+      case TraceOperation::SetConstantOutsideWindow:
+        if (!Reader.readString(Name) || !Reader.read(TimeWindow) || !Reader.read(CurrentTime))
+        {
+          return false;
+        }
+        this->setConstantOutsideWindow(Name, TimeWindow, CurrentTime);
+        return true;
+
+      case TraceOperation::SetVariableInsideWindow:
+        if (!Reader.readString(Name) || !Reader.read(TimeWindow) || !Reader.read(CurrentTime))
+        {
+          return false;
+        }
+        this->setVariableInsideWindow(Name, TimeWindow, CurrentTime);
+        return true;
+
+      case TraceOperation::SetAllConstantOutsideWindow:
+        if (!Reader.read(TimeWindow) || !Reader.read(CurrentTime))
+        {
+          return false;
+        }
+        this->setAllConstantOutsideWindow(TimeWindow, CurrentTime);
+        return true;
+
+      case TraceOperation::SetAllVariableInsideWindow:
+        if (!Reader.read(TimeWindow) || !Reader.read(CurrentTime))
+        {
+          return false;
+        }
+        this->setAllVariableInsideWindow(TimeWindow, CurrentTime);
+        return true;
+
+      case TraceOperation::MarginalizeStates:
+        {
+          uint32_t StateNumber = 0;
+          if (!Reader.read(StateNumber))
+          {
+            return false;
+          }
+          std::vector<StateID> States(StateNumber);
+          for (StateID &ID : States)
+          {
+            if (!Reader.readStateID(ID))
+            {
+              return false;
+            }
+          }
+          if (!Reader.read(Inflation))
+          {
+            return false;
+          }
+          this->marginalizeStates(States, Inflation);
+          return true;
+        }
+
+      case TraceOperation::MarginalizeOutsideWindow:
+        if (!Reader.read(TimeWindow) || !Reader.read(CurrentTime) || !Reader.read(Inflation))
+        {
+          return false;
+        }
+        this->marginalizeAllStatesOutsideWindow(TimeWindow, CurrentTime, Inflation);
+        return true;
+
+      case TraceOperation::EnableErrorModel:
+      case TraceOperation::DisableErrorModel:
+        if (!Reader.read(Type))
+        {
+          return false;
+        }
+        if (Operation == TraceOperation::EnableErrorModel)
+        {
+          this->enableErrorModel(static_cast<FactorType>(Type));
+        }
+        else
+        {
+          this->disableErrorModel(static_cast<FactorType>(Type));
+        }
+        return true;
+
+      case TraceOperation::EnableErrorModels:
+        this->enableErrorModels();
+        return true;
+
+      case TraceOperation::DisableErrorModels:
+        this->disableErrorModels();
+        return true;
+
+      case TraceOperation::SetWarmStart:
+        if (!Reader.read(Flag))
+        {
+          return false;
+        }
+        this->setWarmStart(Flag != 0);
+        return true;
+
+      case TraceOperation::SetLandmarksFirst:
+        if (!Reader.read(Flag))
+        {
+          return false;
+        }
+        this->setLandmarksFirst(Flag != 0);
+        return true;
+
+      case TraceOperation::RemoveStateList:
+        {
+          uint32_t StateNumber = 0;
+          if (!Reader.read(StateNumber))
+          {
+            return false;
+          }
+          std::vector<StateID> States(StateNumber);
+          for (StateID &ID : States)
+          {
+            if (!Reader.readStateID(ID))
+            {
+              return false;
+            }
+          }
+          this->removeStates(States);
+          return true;
+        }
+
+      case TraceOperation::SetTimeChainOrdering:
+        if (!Reader.read(Flag))
+        {
+          return false;
+        }
+        this->setTimeChainOrdering(Flag != 0);
+        return true;
+
+      case TraceOperation::SetDenseSolverThreshold:
+        if (!Reader.read(Number))
+        {
+          return false;
+        }
+        this->setDenseSolverThreshold(Number);
+        return true;
+
+      case TraceOperation::Solve:
+        {
+          ceres::Solver::Options Options;
+          double Remaining = 0.0;
+          if (!ReadSolverOptions(Reader, Options) || !Reader.read(Flag) || !Reader.read(Remaining))
+          {
+            return false;
+          }
+
+          /** the budget is the one that was left at the recorded call */
+          if (Flag != 0)
+          {
+            this->solve(Options, Deadline(Remaining));
+          }
+          else
+          {
+            this->solve(Options);
+          }
+          return true;
+        }
+
+      case TraceOperation::SolveComponents:
+        {
+          ceres::Solver::Options Options;
+          if (!ReadSolverOptions(Reader, Options))
+          {
+            return false;
+          }
+          this->solveComponents(Options);
+          return true;
+        }
+
+      case TraceOperation::SetWindowExempt:
+        if (!Reader.readString(Name) || !Reader.read(Flag))
+        {
+          return false;
+        }
+        this->setWindowExempt(Name, Flag != 0);
+        return true;
+
+      case TraceOperation::SolveIncremental:
+        {
+          ceres::Solver::Options Options;
+          if (!ReadSolverOptions(Reader, Options))
+          {
+            return false;
+          }
+          this->solveIncremental(Options);
+          return true;
+        }
+
+      default:
+        return false;
+    }
+  }
+}
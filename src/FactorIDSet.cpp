@@ -21,12 +21,18 @@
  ***************************************************************************/
 
 #include "FactorIDSet.h"
+#include "Hash.h"
 
 namespace libRSF
 {
   std::ostream& operator << (std::ostream& Os, const FactorID& ID)
   {
-    Os << ID.ID << " " << ID.Timestamp << " " << ID.Number << " ";
+    Os << ID.ID << " " << ID.getTimestamp() << " " << ID.Number << " ";
     return Os;
   }
+
+  size_t FactorIDSet::HashGlobalID::operator() (const UniqueID &Object) const
+  {
+    return std::hash<FactorID>()(Object);
+  }
 }
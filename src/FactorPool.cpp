@@ -0,0 +1,159 @@
+/***************************************************************************
+ * libRSF - A Robust Sensor Fusion Library
+ *
+ * Copyright (C) 2018 Chair of Automation Technology / TU Chemnitz
+ * For more information see https://www.tu-chemnitz.de/etit/proaut/libRSF
+ *
+ * libRSF is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libRSF is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with libRSF.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Tim Pfeifer (tim.pfeifer@etit.tu-chemnitz.de)
+ ***************************************************************************/
+
+#include "FactorPool.h"
+#include "RealTime.h"
+
+namespace libRSF
+{
+  MemoryPool::MemoryPool(const size_t BlockSize, const size_t BlocksPerChunk) :
+      BlockSize_((BlockSize + Alignment - 1) / Alignment * Alignment),
+      BlocksPerChunk_(BlocksPerChunk > 0 ? BlocksPerChunk : 1)
+  {}
+
+  MemoryPool::~MemoryPool()
+  {
+    for (void* Chunk : Chunks_)
+    {
+      ::operator delete(Chunk, std::align_val_t(Alignment));
+    }
+  }
+
+  void* MemoryPool::allocate()
+  {
+    /** grow by a complete chunk */
+    if (Free_.empty())
+    {
+      auto* Chunk = static_cast<unsigned char*>(::operator new(BlockSize_ * BlocksPerChunk_, std::align_val_t(Alignment)));
+      Chunks_.push_back(Chunk);
+
+      /** fault the chunk at once instead of block by block during the construction of factors */
+      if (IsRealTimeActive())
+      {
+        PrefaultMemory(Chunk, BlockSize_ * BlocksPerChunk_);
+      }
+
+      Free_.reserve(Free_.size() + BlocksPerChunk_);
+      for (size_t n = BlocksPerChunk_; n > 0; n--)
+      {
+        Free_.push_back(Chunk + (n - 1) * BlockSize_);
+      }
+    }
+
+    void* Block = Free_.back();
+    Free_.pop_back();
+    Used_++;
+    return Block;
+  }
+
+  void MemoryPool::deallocate(void* Block)
+  {
+    Free_.push_back(Block);
+    Used_--;
+  }
+
+  size_t MemoryPool::countUsed() const
+  {
+    return Used_;
+  }
+
+  size_t MemoryPool::getMemorySize() const
+  {
+    return Chunks_.size() * BlockSize_ * BlocksPerChunk_;
+  }
+
+  FactorPool::~FactorPool()
+  {
+    /** destroy remaining objects before the memory is released */
+    std::vector<ceres::CostFunction*> Remaining;
+    Remaining.reserve(Owners_.size());
+    Owners_.forEach([&Remaining](ceres::CostFunction* CostFunction, MemoryPool*)
+    {
+      Remaining.push_back(CostFunction);
+    });
+
+    for (ceres::CostFunction* CostFunction : Remaining)
+    {
+      this->destroy(CostFunction);
+    }
+  }
+
+  void FactorPool::setBlocksPerChunk(const FactorType Type, const size_t Blocks)
+  {
+    BlocksPerChunk_[Type] = Blocks;
+  }
+
+  bool FactorPool::destroy(ceres::CostFunction* CostFunction)
+  {
+    if (Owners_.count(CostFunction) == 0)
+    {
+      return false;
+    }
+
+    MemoryPool* const Pool = Owners_.at(CostFunction);
+    Owners_.erase(CostFunction);
+
+    /** the destructor of a wrapping cost function also destroys its factor */
+    CostFunction->~CostFunction();
+    Pool->deallocate(CostFunction);
+
+    return true;
+  }
+
+  size_t FactorPool::countObjects() const
+  {
+    return Owners_.size();
+  }
+
+  std::map<FactorType, size_t> FactorPool::getMemorySizePerType() const
+  {
+    std::map<FactorType, size_t> Bytes;
+    for (const auto &Pool : Pools_)
+    {
+      Bytes[Pool.first.first] += Pool.second->getMemorySize();
+    }
+    return Bytes;
+  }
+
+  size_t FactorPool::getMemorySize() const
+  {
+    size_t Bytes = Owners_.getMemorySize();
+    for (const auto &Pool : Pools_)
+    {
+      Bytes += Pool.second->getMemorySize();
+    }
+    return Bytes;
+  }
+
+  MemoryPool& FactorPool::getPool_(const FactorType Type, const size_t BlockSize)
+  {
+    const auto Key = std::make_pair(Type, BlockSize);
+    auto It = Pools_.find(Key);
+    if (It == Pools_.end())
+    {
+      const auto Config = BlocksPerChunk_.find(Type);
+      const size_t Blocks = (Config != BlocksPerChunk_.end()) ? Config->second : DefaultBlocksPerChunk_;
+      It = Pools_.emplace(Key, std::make_unique<MemoryPool>(BlockSize, Blocks)).first;
+    }
+    return *It->second;
+  }
+}
@@ -21,27 +21,297 @@
  ***************************************************************************/
 
 #include "FileAccess.h"
+#include "FileView.h"
+#include "ThreadPool.h"
 
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <cstdint>
+#include <string_view>
+
+#ifdef LIBRSF_ZSTD
+#include <zstd.h>
+#endif
 
 namespace libRSF
 {
+  /**
+   * Layout of the binary format (native byte order):
+   * char[4]  magic "RSFB"
+   * uint32   version
+   * uint32   number of blocks
+   * per block:
+   *   uint32   length of the type name
+   *   char[]   type name as used in the text format
+   *   uint32   values per object (size of the Data buffer of this type)
+   *   uint64   number of objects
+   *   double[] values of all objects, each one in the layout of DataConfig
+   */
+
+  /**
+   * Layout of the chunked binary format (native byte order), the index is written last, so the
+   * writer does not need to know the compressed sizes in advance:
+   * char[4]  magic "RSFB"
+   * uint32   version 2
+   * uint32   number of blocks
+   * uint32   compression (0 = none, 1 = zstd)
+   * uint64   byte position of the index
+   * char[]   stored values of all chunks, each chunk is compressed on its own
+   * index, per block:
+   *   uint32   length of the type name
+   *   char[]   type name as used in the text format
+   *   uint32   values per object
+   *   uint32   number of chunks
+   *   per chunk:
+   *     uint64   number of objects
+   *     double   first and last timestamp
+   *     uint64   byte position and stored size of the values
+   */
+
+  /**
+   * Layout of the binary result format (native byte order), every block starts 8 byte aligned,
+   * so the values can be mapped directly as a [objects x values] row-major double matrix:
+   * char[4]  magic "RSFR"
+   * uint32   version
+   * uint32   number of blocks
+   * uint32   reserved
+   * per block:
+   *   uint32   length of the state name
+   *   uint32   length of the type name
+   *   uint32   values per object (size of the Data buffer of this type)
+   *   uint32   reserved
+   *   uint64   number of objects
+   *   char[]   state name, followed by the type name, zero padded to a multiple of 8 bytes
+   *   double[] values of all objects, each one in the layout of DataConfig
+   */
+  static const char ResultMagic[4] = {'R', 'S', 'F', 'R'};
+  static const uint32_t ResultVersion = 1;
+
+  static size_t PaddingTo8(const size_t Bytes)
+  {
+    return (8 - Bytes % 8) % 8;
+  }
+
+  /** size of the stream buffer for writing */
+  static const size_t WriteBufferSize = 1 << 20;
+
+  /** multiplication of sizes read from a file, returns false on overflow */
+  static bool MultiplySize(const uint64_t A, const uint64_t B, uint64_t &Product)
+  {
+    if (A != 0 && B > std::numeric_limits<uint64_t>::max() / A)
+    {
+      return false;
+    }
+    Product = A * B;
+    return true;
+  }
+
+  /** raw size of the values of a chunk, returns false if it can not be allocated */
+  static bool GetRawChunkSize(const uint64_t ObjectNumber, const uint64_t ValueNumber, uint64_t &RawBytes)
+  {
+    uint64_t ValueTotal = 0;
+    return MultiplySize(ObjectNumber, ValueNumber, ValueTotal) &&
+           MultiplySize(ValueTotal, sizeof(double), RawBytes) &&
+           ValueTotal <= std::vector<double>().max_size();
+  }
+
+  /** an index entry has to point into the file and match the raw size of its values */
+  static bool CheckBinaryDataChunk(const BinaryDataChunk &Chunk,
+                                   const uint32_t ValueNumber,
+                                   const BinaryCompression Compression,
+                                   const uint64_t FileSize)
+  {
+    uint64_t RawBytes = 0;
+    if (!GetRawChunkSize(Chunk.ObjectNumber, ValueNumber, RawBytes) ||
+        Chunk.Position > FileSize || Chunk.Bytes > FileSize - Chunk.Position)
+    {
+      return false;
+    }
+    return (Compression != BinaryCompression::None || Chunk.Bytes == RawBytes);
+  }
+
+  bool IsBinaryDataFile(const string& Filename)
+  {
+    char Magic[sizeof(BinaryDataMagic)] = {};
+    std::ifstream File(Filename, std::ios::binary);
+    File.read(Magic, sizeof(Magic));
+    return (File.gcount() == sizeof(Magic) && std::memcmp(Magic, BinaryDataMagic, sizeof(Magic)) == 0);
+  }
+
+  /** malformed lines of a text file, they are skipped and reported once by the calling thread */
+  struct ParseErrors
+  {
+    size_t Number = 0;
+    size_t FirstLine = 0;
+    std::string First;
+
+    void add(const size_t Line, std::string &Error)
+    {
+      if (Number == 0)
+      {
+        FirstLine = Line;
+        First = std::move(Error);
+      }
+      Number++;
+      Error.clear();
+    }
+
+    void report(const string& Filename) const
+    {
+      if (Number > 0)
+      {
+        PRINT_ERROR("Skipped ", Number, " malformed lines of ", Filename, ", the first is line ", FirstLine, ": ", First);
+      }
+    }
+  };
 
   void ReadDataFromFile(const string& Filename,
                         SensorDataSet& SensorData)
   {
+    LIBRSF_TRACE_SCOPE("read_file");
+
+    /** binary files are detected by their header */
+    if (IsBinaryDataFile(Filename))
+    {
+      ReadDataFromBinaryFile(Filename, SensorData);
+      return;
+    }
+
     string Buffer;
     std::ifstream File;
 
     File.open(Filename);
     std::getline(File, Buffer);
 
+    ParseErrors Errors;
+    std::string Error;
+    size_t LineNumber = 0;
     while(Buffer.length() > 0)
     {
-      SensorData.addElement(Data(Buffer));
+      LineNumber++;
+      const Data Object(Buffer, Error);
+      if (Error.empty())
+      {
+        SensorData.addElement(Object);
+      }
+      else
+      {
+        Errors.add(LineNumber, Error);
+      }
       std::getline(File, Buffer);
     }
 
     File.close();
+    Errors.report(Filename);
+  }
+
+  /** the valid objects of one part of a text file */
+  struct ParsedLines
+  {
+    std::vector<Data> Objects;
+    size_t LineNumber = 0;
+    ParseErrors Errors;
+  };
+
+  /** parse all lines of a part of a text file, malformed ones are skipped */
+  static void ParseLines(std::string_view Text, ParsedLines &Parsed)
+  {
+    std::string Error;
+    while (!Text.empty())
+    {
+      const size_t LineEnd = std::min(Text.find('\n'), Text.size());
+      Parsed.LineNumber++;
+      Parsed.Objects.emplace_back(Text.substr(0, LineEnd), Error);
+      if (!Error.empty())
+      {
+        Parsed.Objects.pop_back();
+        Parsed.Errors.add(Parsed.LineNumber, Error);
+      }
+      Text.remove_prefix(std::min(LineEnd + 1, Text.size()));
+    }
+  }
+
+  void ReadDataFromFileParallel(const string& Filename,
+                                SensorDataSet& SensorData,
+                                int ThreadNumber)
+  {
+    LIBRSF_TRACE_SCOPE("read_file");
+
+    if (IsBinaryDataFile(Filename))
+    {
+      ReadDataFromBinaryFile(Filename, SensorData);
+      return;
+    }
+
+    FileView File(Filename);
+    if (!File.isValid())
+    {
+      PRINT_ERROR("Could not open file: ", Filename);
+      return;
+    }
+
+    /** like the sequential version, stop at the first empty line */
+    std::string_view Text = File.getContent();
+    if (Text.substr(0, 1) == "\n")
+    {
+      return;
+    }
+    const size_t TextEnd = Text.find("\n\n");
+    if (TextEnd != std::string_view::npos)
+    {
+      Text = Text.substr(0, TextEnd + 1);
+    }
+
+    if (ThreadNumber <= 0)
+    {
+      ThreadNumber = GetThreadNumber();
+    }
+
+    /** split into chunks at line boundaries */
+    std::vector<std::string_view> Chunks;
+    size_t ChunkBegin = 0;
+    for (int nChunk = 1; nChunk <= ThreadNumber && ChunkBegin < Text.size(); nChunk++)
+    {
+      size_t ChunkEnd = Text.size();
+      if (nChunk < ThreadNumber)
+      {
+        ChunkEnd = std::min(Text.find('\n', std::max(ChunkBegin, Text.size() * nChunk / ThreadNumber)), Text.size());
+        ChunkEnd = std::min(ChunkEnd + 1, Text.size());
+      }
+      Chunks.push_back(Text.substr(ChunkBegin, ChunkEnd - ChunkBegin));
+      ChunkBegin = ChunkEnd;
+    }
+
+    /** parse in parallel */
+    std::vector<ParsedLines> Parsed(Chunks.size());
+    GetThreadPool().parallelFor(Chunks.size(), [&](const size_t nChunk)
+    {
+      ParseLines(Chunks.at(nChunk), Parsed.at(nChunk));
+    });
+
+    /** merge in file order, the data set sorts by time */
+    ParseErrors Errors;
+    size_t LineNumber = 0;
+    for (ParsedLines &Chunk : Parsed)
+    {
+      if (Chunk.Errors.Number > 0)
+      {
+        if (Errors.Number == 0)
+        {
+          Errors.FirstLine = LineNumber + Chunk.Errors.FirstLine;
+          Errors.First = std::move(Chunk.Errors.First);
+        }
+        Errors.Number += Chunk.Errors.Number;
+      }
+      LineNumber += Chunk.LineNumber;
+
+      for (const Data &Object : Chunk.Objects)
+      {
+        SensorData.addElement(Object);
+      }
+    }
+    Errors.report(Filename);
   }
 
   void WriteDataToFile(const string& Filename,
@@ -49,6 +319,8 @@ namespace libRSF
                        const StateDataSet& SensorData,
                        const bool Append)
   {
+    LIBRSF_TRACE_SCOPE("write_file");
+
     double Timestamp;
 
     if(!SensorData.getTimeFirst(DataName,Timestamp))
@@ -56,7 +328,10 @@ namespace libRSF
       return;
     }
 
+    /** a large buffer and no flush per line */
+    std::vector<char> WriteBuffer(WriteBufferSize);
     std::ofstream File;
+    File.rdbuf()->pubsetbuf(WriteBuffer.data(), static_cast<std::streamsize>(WriteBuffer.size()));
 
     if(Append)
     {
@@ -74,11 +349,719 @@ namespace libRSF
       {
         Data State;
         SensorData.getElement(DataName, Timestamp, nState, State);
-        File << State.getName() << ' ' << State.getValueString() << std::endl;
+        File << State.getName() << ' ' << State.getValueString() << '\n';
       }
     }
     while(SensorData.getTimeNext(DataName, Timestamp, Timestamp));
 
     File.close();
   }
+
+  void WriteDataToFile(const string& Filename,
+                       const std::vector<string>& DataNames,
+                       const StateDataSet& SensorData,
+                       const bool Append,
+                       const int ThreadNumber)
+  {
+    LIBRSF_TRACE_SCOPE("write_file");
+
+    /** each name is formatted into its own buffer, the objects are read in place */
+    std::vector<std::string> Buffers(DataNames.size());
+    GetThreadPool().parallelFor(DataNames.size(), [&](const size_t nName)
+    {
+      double TimeFirst, TimeLast;
+      if (!SensorData.getTimeFirst(DataNames.at(nName), TimeFirst) || !SensorData.getTimeLast(DataNames.at(nName), TimeLast))
+      {
+        return;
+      }
+
+      std::string &Buffer = Buffers.at(nName);
+      for (const Data &State : SensorData.range(DataNames.at(nName), TimeFirst, TimeLast))
+      {
+        Buffer.append(State.getName());
+        Buffer.push_back(' ');
+        State.appendValueString(Buffer);
+        Buffer.push_back('\n');
+      }
+    }, ThreadNumber);
+
+    /** like the single version, a name without data does not touch the file */
+    size_t nFirst = 0;
+    while (nFirst < Buffers.size() && Buffers.at(nFirst).empty())
+    {
+      nFirst++;
+    }
+    if (nFirst == Buffers.size())
+    {
+      return;
+    }
+
+    std::FILE *File = std::fopen(Filename.c_str(), (Append || nFirst > 0) ? "ab" : "wb");
+    if (File == nullptr)
+    {
+      PRINT_ERROR("Could not open file: ", Filename);
+      return;
+    }
+
+    /** one large sequential write per name */
+    for (const std::string &Buffer : Buffers)
+    {
+      if (!Buffer.empty() && std::fwrite(Buffer.data(), 1, Buffer.size(), File) != Buffer.size())
+      {
+        PRINT_ERROR("Could not write file: ", Filename);
+        break;
+      }
+    }
+    std::fclose(File);
+  }
+
+  bool BinaryDataFilter::checkType(const DataType Type) const
+  {
+    return Types.empty() || std::find(Types.begin(), Types.end(), Type) != Types.end();
+  }
+
+  bool BinaryDataFilter::checkTime(const double Timestamp) const
+  {
+    const double Time = roundToTick(Timestamp);
+    return (!std::isfinite(TimeBegin) || Time >= roundToTick(TimeBegin)) &&
+           (!std::isfinite(TimeEnd) || Time <= roundToTick(TimeEnd));
+  }
+
+  bool BinaryDataFilter::checkRange(const double TimeFirst, const double TimeLast) const
+  {
+    return (!std::isfinite(TimeBegin) || roundToTick(TimeLast) >= roundToTick(TimeBegin)) &&
+           (!std::isfinite(TimeEnd) || roundToTick(TimeFirst) <= roundToTick(TimeEnd));
+  }
+
+  bool ReadBinaryDataIndex(FileView &File,
+                           const string& Filename,
+                           BinaryCompression &Compression,
+                           std::vector<BinaryDataBlock> &Blocks)
+  {
+    char Magic[sizeof(BinaryDataMagic)];
+    uint32_t Version = 0;
+    uint32_t BlockNumber = 0;
+    if (!File.read(Magic, sizeof(Magic)) || std::memcmp(Magic, BinaryDataMagic, sizeof(Magic)) != 0 ||
+        !File.read(Version) || (Version != BinaryDataVersion && Version != BinaryDataVersionChunked) || !File.read(BlockNumber))
+    {
+      PRINT_ERROR("Invalid header of binary file: ", Filename);
+      return false;
+    }
+
+    /** the chunked version jumps to its index */
+    Compression = BinaryCompression::None;
+    if (Version == BinaryDataVersionChunked)
+    {
+      uint32_t CompressionCode = 0;
+      uint64_t IndexPosition = 0;
+      if (!File.read(CompressionCode) || CompressionCode > static_cast<uint32_t>(BinaryCompression::Zstd) ||
+          !File.read(IndexPosition) || IndexPosition < File.getPosition() || !File.skip(IndexPosition - File.getPosition()))
+      {
+        PRINT_ERROR("Invalid header of binary file: ", Filename);
+        return false;
+      }
+      Compression = static_cast<BinaryCompression>(CompressionCode);
+    }
+
+    /** every size is checked against the file before it is used to allocate */
+    const uint64_t FileSize = File.getContent().size();
+
+    Blocks.clear();
+    for (uint32_t nBlock = 0; nBlock < BlockNumber; nBlock++)
+    {
+      uint32_t NameLength = 0;
+      string Name;
+      uint32_t ValueNumber = 0;
+
+      if (!File.read(NameLength) || NameLength > File.getRemaining())
+      {
+        PRINT_ERROR("Unexpected end of binary file: ", Filename);
+        return false;
+      }
+      Name.resize(NameLength);
+      if (!File.read(&Name[0], NameLength) || !File.read(ValueNumber))
+      {
+        PRINT_ERROR("Unexpected end of binary file: ", Filename);
+        return false;
+      }
+
+      if (!GlobalDataConfig.checkName(Name))
+      {
+        PRINT_ERROR("Type does not exist: ", Name);
+        return false;
+      }
+
+      const DataType Type = GlobalDataConfig.getType(Name);
+      const auto &Layout = GlobalDataConfig.getLayout(Type);
+      if (static_cast<int>(ValueNumber) != Layout.TotalSize)
+      {
+        PRINT_ERROR("Layout of ", Name, " does not match the current config: ", ValueNumber, " values");
+        return false;
+      }
+
+      BinaryDataBlock Block;
+      Block.Type = Type;
+      Block.ValueNumber = static_cast<int>(ValueNumber);
+
+      if (Version == BinaryDataVersion)
+      {
+        /** the legacy version stores all values of a block directly after its header */
+        BinaryDataChunk Chunk;
+        if (!File.read(Chunk.ObjectNumber))
+        {
+          PRINT_ERROR("Unexpected end of binary file: ", Filename);
+          return false;
+        }
+        Chunk.Position = File.getPosition();
+        if (!GetRawChunkSize(Chunk.ObjectNumber, ValueNumber, Chunk.Bytes) ||
+            !CheckBinaryDataChunk(Chunk, ValueNumber, BinaryCompression::None, FileSize) ||
+            !File.skip(Chunk.Bytes))
+        {
+          PRINT_ERROR("Unexpected end of binary file: ", Filename);
+          return false;
+        }
+
+        /** only two values are touched to get the time range */
+        if (Chunk.ObjectNumber > 0 && Layout.hasElement(DataElement::Timestamp))
+        {
+          const size_t TimestampOffset = Layout.Offset.at(static_cast<size_t>(DataElement::Timestamp)) * sizeof(double);
+          File.readAt(Chunk.Position + TimestampOffset, &Chunk.TimeFirst, sizeof(double));
+          File.readAt(Chunk.Position + Chunk.Bytes - ValueNumber * sizeof(double) + TimestampOffset, &Chunk.TimeLast, sizeof(double));
+        }
+
+        if (Chunk.ObjectNumber > 0)
+        {
+          Block.Chunks.push_back(Chunk);
+        }
+      }
+      else
+      {
+        /** each index entry of a chunk has a fixed size */
+        constexpr uint64_t ChunkEntryBytes = 3 * sizeof(uint64_t) + 2 * sizeof(double);
+        uint32_t ChunkNumber = 0;
+        if (!File.read(ChunkNumber) || ChunkNumber > File.getRemaining() / ChunkEntryBytes)
+        {
+          PRINT_ERROR("Unexpected end of binary file: ", Filename);
+          return false;
+        }
+        Block.Chunks.resize(ChunkNumber);
+        for (BinaryDataChunk &Chunk : Block.Chunks)
+        {
+          if (!File.read(Chunk.ObjectNumber) || !File.read(Chunk.TimeFirst) || !File.read(Chunk.TimeLast) ||
+              !File.read(Chunk.Position) || !File.read(Chunk.Bytes))
+          {
+            PRINT_ERROR("Unexpected end of binary file: ", Filename);
+            return false;
+          }
+          if (!CheckBinaryDataChunk(Chunk, ValueNumber, Compression, FileSize))
+          {
+            PRINT_ERROR("Invalid chunk in binary file: ", Filename);
+            return false;
+          }
+        }
+      }
+
+      if (!Block.Chunks.empty())
+      {
+        Blocks.push_back(std::move(Block));
+      }
+    }
+
+    return true;
+  }
+
+  bool DecodeBinaryDataChunk(const FileView &File,
+                             const BinaryDataChunk &Chunk,
+                             const int ValueNumber,
+                             const BinaryCompression Compression,
+                             std::vector<double> &Values)
+  {
+    /** the entry is checked again, so a chunk that was not read by ReadBinaryDataIndex can not allocate blindly */
+    const std::string_view Content = File.getContent();
+    if (ValueNumber < 0 || !CheckBinaryDataChunk(Chunk, static_cast<uint32_t>(ValueNumber), Compression, Content.size()))
+    {
+      return false;
+    }
+    const size_t RawBytes = static_cast<size_t>(Chunk.ObjectNumber) * static_cast<size_t>(ValueNumber) * sizeof(double);
+
+    if (Compression == BinaryCompression::None)
+    {
+      /** copy out of the mapping to avoid unaligned access */
+      Values.resize(RawBytes / sizeof(double));
+      return File.readAt(Chunk.Position, Values.data(), RawBytes);
+    }
+
+#ifdef LIBRSF_ZSTD
+    /** the frame header has to announce the expected size before anything is allocated */
+    const unsigned long long FrameSize = ZSTD_getFrameContentSize(Content.data() + Chunk.Position, Chunk.Bytes);
+    if (FrameSize != RawBytes)
+    {
+      return false;
+    }
+    Values.resize(RawBytes / sizeof(double));
+    const size_t Size = ZSTD_decompress(Values.data(), RawBytes, Content.data() + Chunk.Position, Chunk.Bytes);
+    return !ZSTD_isError(Size) && Size == RawBytes;
+#else
+    PRINT_ERROR("libRSF was built without zstd, compressed chunks can not be decoded!");
+    return false;
+#endif
+  }
+
+  bool ReadDataFromBinaryFile(const string& Filename,
+                              SensorDataSet& SensorData)
+  {
+    return ReadDataFromBinaryFile(Filename, SensorData, BinaryDataFilter());
+  }
+
+  bool ReadDataFromBinaryFile(const string& Filename,
+                              SensorDataSet& SensorData,
+                              const BinaryDataFilter& Filter,
+                              const int ThreadNumber)
+  {
+    LIBRSF_TRACE_SCOPE("read_file");
+
+    FileView File(Filename);
+    if (!File.isValid())
+    {
+      PRINT_ERROR("Could not open file: ", Filename);
+      return false;
+    }
+
+    BinaryCompression Compression;
+    std::vector<BinaryDataBlock> Blocks;
+    if (!ReadBinaryDataIndex(File, Filename, Compression, Blocks))
+    {
+      return false;
+    }
+
+    /** select chunks by their index entry, the others are never touched */
+    std::vector<std::pair<const BinaryDataBlock*, const BinaryDataChunk*>> Selection;
+    for (const BinaryDataBlock &Block : Blocks)
+    {
+      if (!Filter.checkType(Block.Type))
+      {
+        continue;
+      }
+      for (const BinaryDataChunk &Chunk : Block.Chunks)
+      {
+        if (Filter.checkRange(Chunk.TimeFirst, Chunk.TimeLast))
+        {
+          Selection.emplace_back(&Block, &Chunk);
+        }
+      }
+    }
+
+    /** decode in parallel */
+    std::vector<std::vector<Data>> Objects(Selection.size());
+    std::atomic<bool> Success(true);
+    GetThreadPool().parallelFor(Selection.size(), [&](const size_t nChunk)
+    {
+      const BinaryDataBlock &Block = *Selection.at(nChunk).first;
+      const BinaryDataChunk &Chunk = *Selection.at(nChunk).second;
+
+      std::vector<double> Values;
+      if (!DecodeBinaryDataChunk(File, Chunk, Block.ValueNumber, Compression, Values))
+      {
+        Success = false;
+        return;
+      }
+
+      Objects.at(nChunk).reserve(Chunk.ObjectNumber);
+      for (uint64_t nObject = 0; nObject < Chunk.ObjectNumber; nObject++)
+      {
+        Data Object(Block.Type, Values.data() + nObject * Block.ValueNumber, Block.ValueNumber);
+        if (Filter.checkTime(Object.getTimestamp()))
+        {
+          Objects.at(nChunk).push_back(std::move(Object));
+        }
+      }
+    }, ThreadNumber);
+
+    if (!Success)
+    {
+      PRINT_ERROR("Could not decode binary file: ", Filename);
+      return false;
+    }
+
+    /** merge in file order, so every stream is filled in temporal order */
+    for (const std::vector<Data> &ChunkObjects : Objects)
+    {
+      for (const Data &Object : ChunkObjects)
+      {
+        SensorData.addElement(Object);
+      }
+    }
+
+    return true;
+  }
+
+  bool WriteDataToBinaryFile(const string& Filename,
+                             const SensorDataSet& SensorData)
+  {
+    LIBRSF_TRACE_SCOPE("write_file");
+
+    std::vector<char> WriteBuffer(WriteBufferSize);
+    std::ofstream File;
+    File.rdbuf()->pubsetbuf(WriteBuffer.data(), static_cast<std::streamsize>(WriteBuffer.size()));
+    File.open(Filename, std::ios::out | std::ios::trunc | std::ios::binary);
+
+    if (!File)
+    {
+      PRINT_ERROR("Could not open file: ", Filename);
+      return false;
+    }
+
+    const std::vector<DataType> Types = SensorData.getKeysAll();
+    const auto BlockNumber = static_cast<uint32_t>(Types.size());
+
+    File.write(BinaryDataMagic, sizeof(BinaryDataMagic));
+    File.write(reinterpret_cast<const char *>(&BinaryDataVersion), sizeof(BinaryDataVersion));
+    File.write(reinterpret_cast<const char *>(&BlockNumber), sizeof(BlockNumber));
+
+    for (const DataType Type : Types)
+    {
+      const string Name = GlobalDataConfig.getName(Type);
+      const auto NameLength = static_cast<uint32_t>(Name.size());
+      const auto ValueNumber = static_cast<uint32_t>(GlobalDataConfig.getLayout(Type).TotalSize);
+      const auto ObjectNumber = static_cast<uint64_t>(SensorData.countElements(Type));
+
+      File.write(reinterpret_cast<const char *>(&NameLength), sizeof(NameLength));
+      File.write(Name.data(), NameLength);
+      File.write(reinterpret_cast<const char *>(&ValueNumber), sizeof(ValueNumber));
+      File.write(reinterpret_cast<const char *>(&ObjectNumber), sizeof(ObjectNumber));
+
+      /** objects are written in temporal order */
+      for (const Data &Object : SensorData.getElementsOfID(Type))
+      {
+        File.write(reinterpret_cast<const char *>(Object.getBuffer().data()),
+                   static_cast<std::streamsize>(Object.getBuffer().size() * sizeof(double)));
+      }
+    }
+
+    File.close();
+    return !File.fail();
+  }
+
+  bool WriteDataToBinaryFile(const string& Filename,
+                             const SensorDataSet& SensorData,
+                             BinaryCompression Compression,
+                             const int Level,
+                             const int ObjectsPerChunk)
+  {
+    LIBRSF_TRACE_SCOPE("write_file");
+
+#ifndef LIBRSF_ZSTD
+    if (Compression == BinaryCompression::Zstd)
+    {
+      PRINT_WARNING("libRSF was built without zstd, the file is written without compression!");
+      Compression = BinaryCompression::None;
+    }
+#endif
+
+    /** split every type into chunks of consecutive objects */
+    const auto ChunkSize = static_cast<uint64_t>(std::max(ObjectsPerChunk, 1));
+    std::vector<BinaryDataBlock> Blocks;
+    std::vector<std::vector<double>> RawChunks;
+    for (const DataType Type : SensorData.getKeysAll())
+    {
+      BinaryDataBlock Block;
+      Block.Type = Type;
+      Block.ValueNumber = GlobalDataConfig.getLayout(Type).TotalSize;
+
+      for (const Data &Object : SensorData.getElementsOfID(Type))
+      {
+        if (Block.Chunks.empty() || Block.Chunks.back().ObjectNumber == ChunkSize)
+        {
+          Block.Chunks.emplace_back();
+          Block.Chunks.back().TimeFirst = Object.getTimestamp();
+          RawChunks.emplace_back();
+          RawChunks.back().reserve(ChunkSize * Block.ValueNumber);
+        }
+        Block.Chunks.back().ObjectNumber++;
+        Block.Chunks.back().TimeLast = Object.getTimestamp();
+        RawChunks.back().insert(RawChunks.back().end(), Object.getBuffer().begin(), Object.getBuffer().end());
+      }
+
+      Blocks.push_back(std::move(Block));
+    }
+
+    /** compress in parallel */
+    std::vector<std::vector<char>> StoredChunks(RawChunks.size());
+    std::atomic<bool> Success(true);
+#ifdef LIBRSF_ZSTD
+    if (Compression == BinaryCompression::Zstd)
+    {
+      GetThreadPool().parallelFor(RawChunks.size(), [&](const size_t nChunk)
+      {
+        const size_t RawBytes = RawChunks.at(nChunk).size() * sizeof(double);
+        std::vector<char> &Stored = StoredChunks.at(nChunk);
+        Stored.resize(ZSTD_compressBound(RawBytes));
+
+        const size_t Size = ZSTD_compress(Stored.data(), Stored.size(), RawChunks.at(nChunk).data(), RawBytes, Level);
+        if (ZSTD_isError(Size))
+        {
+          Success = false;
+          return;
+        }
+        Stored.resize(Size);
+      });
+    }
+#else
+    (void)Level;
+#endif
+
+    if (!Success)
+    {
+      PRINT_ERROR("Could not compress data for: ", Filename);
+      return false;
+    }
+
+    std::vector<char> WriteBuffer(WriteBufferSize);
+    std::ofstream File;
+    File.rdbuf()->pubsetbuf(WriteBuffer.data(), static_cast<std::streamsize>(WriteBuffer.size()));
+    File.open(Filename, std::ios::out | std::ios::trunc | std::ios::binary);
+
+    if (!File)
+    {
+      PRINT_ERROR("Could not open file: ", Filename);
+      return false;
+    }
+
+    const auto BlockNumber = static_cast<uint32_t>(Blocks.size());
+    const auto CompressionCode = static_cast<uint32_t>(Compression);
+    uint64_t IndexPosition = 0;
+
+    File.write(BinaryDataMagic, sizeof(BinaryDataMagic));
+    File.write(reinterpret_cast<const char *>(&BinaryDataVersionChunked), sizeof(BinaryDataVersionChunked));
+    File.write(reinterpret_cast<const char *>(&BlockNumber), sizeof(BlockNumber));
+    File.write(reinterpret_cast<const char *>(&CompressionCode), sizeof(CompressionCode));
+    const std::streampos IndexPositionField = File.tellp();
+    File.write(reinterpret_cast<const char *>(&IndexPosition), sizeof(IndexPosition));
+
+    /** stored values in the order of the index */
+    size_t nChunk = 0;
+    for (BinaryDataBlock &Block : Blocks)
+    {
+      for (BinaryDataChunk &Chunk : Block.Chunks)
+      {
+        const char *Stored = reinterpret_cast<const char *>(RawChunks.at(nChunk).data());
+        Chunk.Bytes = RawChunks.at(nChunk).size() * sizeof(double);
+        if (Compression != BinaryCompression::None)
+        {
+          Stored = StoredChunks.at(nChunk).data();
+          Chunk.Bytes = StoredChunks.at(nChunk).size();
+        }
+
+        Chunk.Position = static_cast<uint64_t>(File.tellp());
+        File.write(Stored, static_cast<std::streamsize>(Chunk.Bytes));
+        nChunk++;
+      }
+    }
+
+    /** index */
+    IndexPosition = static_cast<uint64_t>(File.tellp());
+    for (const BinaryDataBlock &Block : Blocks)
+    {
+      const string Name = GlobalDataConfig.getName(Block.Type);
+      const auto NameLength = static_cast<uint32_t>(Name.size());
+      const auto ValueNumber = static_cast<uint32_t>(Block.ValueNumber);
+      const auto ChunkNumber = static_cast<uint32_t>(Block.Chunks.size());
+
+      File.write(reinterpret_cast<const char *>(&NameLength), sizeof(NameLength));
+      File.write(Name.data(), NameLength);
+      File.write(reinterpret_cast<const char *>(&ValueNumber), sizeof(ValueNumber));
+      File.write(reinterpret_cast<const char *>(&ChunkNumber), sizeof(ChunkNumber));
+
+      for (const BinaryDataChunk &Chunk : Block.Chunks)
+      {
+        File.write(reinterpret_cast<const char *>(&Chunk.ObjectNumber), sizeof(Chunk.ObjectNumber));
+        File.write(reinterpret_cast<const char *>(&Chunk.TimeFirst), sizeof(Chunk.TimeFirst));
+        File.write(reinterpret_cast<const char *>(&Chunk.TimeLast), sizeof(Chunk.TimeLast));
+        File.write(reinterpret_cast<const char *>(&Chunk.Position), sizeof(Chunk.Position));
+        File.write(reinterpret_cast<const char *>(&Chunk.Bytes), sizeof(Chunk.Bytes));
+      }
+    }
+
+    File.seekp(IndexPositionField);
+    File.write(reinterpret_cast<const char *>(&IndexPosition), sizeof(IndexPosition));
+
+    File.close();
+    return !File.fail();
+  }
+
+  bool ConvertDataFileToBinary(const string& TextFilename,
+                               const string& BinaryFilename)
+  {
+    SensorDataSet SensorData;
+    ReadDataFromFile(TextFilename, SensorData);
+
+    if (SensorData.empty())
+    {
+      PRINT_ERROR("No data in file: ", TextFilename);
+      return false;
+    }
+
+    return WriteDataToBinaryFile(BinaryFilename, SensorData);
+  }
+
+  bool WriteResultToBinaryFile(const string& Filename,
+                               const StateDataSet& Result,
+                               const std::vector<string>& Names)
+  {
+    LIBRSF_TRACE_SCOPE("write_file");
+
+    /** all states by default, missing ones are skipped */
+    std::vector<string> StateNames;
+    if (Names.empty())
+    {
+      for (const auto &Stream : Result)
+      {
+        StateNames.push_back(Stream.first);
+      }
+    }
+    else
+    {
+      for (const string &Name : Names)
+      {
+        if (Result.countElements(Name) > 0)
+        {
+          StateNames.push_back(Name);
+        }
+      }
+    }
+
+    std::vector<char> WriteBuffer(WriteBufferSize);
+    std::ofstream File;
+    File.rdbuf()->pubsetbuf(WriteBuffer.data(), static_cast<std::streamsize>(WriteBuffer.size()));
+    File.open(Filename, std::ios::out | std::ios::trunc | std::ios::binary);
+
+    if (!File)
+    {
+      PRINT_ERROR("Could not open file: ", Filename);
+      return false;
+    }
+
+    const auto BlockNumber = static_cast<uint32_t>(StateNames.size());
+    const uint32_t Reserved = 0;
+    const char Padding[8] = {};
+
+    File.write(ResultMagic, sizeof(ResultMagic));
+    File.write(reinterpret_cast<const char *>(&ResultVersion), sizeof(ResultVersion));
+    File.write(reinterpret_cast<const char *>(&BlockNumber), sizeof(BlockNumber));
+    File.write(reinterpret_cast<const char *>(&Reserved), sizeof(Reserved));
+
+    for (const string &Name : StateNames)
+    {
+      const StateDataSet::ObjectStream &Stream = Result.getStream(Name);
+      const Data &First = Stream.begin()->second;
+
+      const string TypeName = First.getName();
+      const auto NameLength = static_cast<uint32_t>(Name.size());
+      const auto TypeLength = static_cast<uint32_t>(TypeName.size());
+      const auto ValueNumber = static_cast<uint32_t>(First.getBuffer().size());
+      const auto ObjectNumber = static_cast<uint64_t>(Stream.size());
+
+      File.write(reinterpret_cast<const char *>(&NameLength), sizeof(NameLength));
+      File.write(reinterpret_cast<const char *>(&TypeLength), sizeof(TypeLength));
+      File.write(reinterpret_cast<const char *>(&ValueNumber), sizeof(ValueNumber));
+      File.write(reinterpret_cast<const char *>(&Reserved), sizeof(Reserved));
+      File.write(reinterpret_cast<const char *>(&ObjectNumber), sizeof(ObjectNumber));
+      File.write(Name.data(), NameLength);
+      File.write(TypeName.data(), TypeLength);
+      File.write(Padding, static_cast<std::streamsize>(PaddingTo8(NameLength + TypeLength)));
+
+      /** one state name has a single type, so the rows are of equal length */
+      for (const auto &Element : Stream)
+      {
+        if (Element.second.getBuffer().size() != ValueNumber)
+        {
+          PRINT_ERROR("State ", Name, " contains different types, the binary file is incomplete!");
+          return false;
+        }
+        File.write(reinterpret_cast<const char *>(Element.second.getBuffer().data()),
+                   static_cast<std::streamsize>(ValueNumber * sizeof(double)));
+      }
+    }
+
+    File.close();
+    return !File.fail();
+  }
+
+  bool ReadResultFromBinaryFile(const string& Filename,
+                                StateDataSet& Result)
+  {
+    LIBRSF_TRACE_SCOPE("read_file");
+
+    FileView File(Filename);
+    if (!File.isValid())
+    {
+      PRINT_ERROR("Could not open file: ", Filename);
+      return false;
+    }
+
+    char Magic[sizeof(ResultMagic)];
+    uint32_t Version = 0;
+    uint32_t BlockNumber = 0;
+    uint32_t Reserved = 0;
+    if (!File.read(Magic, sizeof(Magic)) || std::memcmp(Magic, ResultMagic, sizeof(Magic)) != 0 ||
+        !File.read(Version) || Version != ResultVersion || !File.read(BlockNumber) || !File.read(Reserved))
+    {
+      PRINT_ERROR("Invalid header of binary result file: ", Filename);
+      return false;
+    }
+
+    for (uint32_t nBlock = 0; nBlock < BlockNumber; nBlock++)
+    {
+      uint32_t NameLength = 0, TypeLength = 0, ValueNumber = 0;
+      uint64_t ObjectNumber = 0;
+      if (!File.read(NameLength) || !File.read(TypeLength) || !File.read(ValueNumber) || !File.read(Reserved) || !File.read(ObjectNumber))
+      {
+        PRINT_ERROR("Unexpected end of binary result file: ", Filename);
+        return false;
+      }
+
+      /** check the lengths before allocating the names */
+      if (static_cast<uint64_t>(NameLength) + TypeLength > File.getRemaining())
+      {
+        PRINT_ERROR("Unexpected end of binary result file: ", Filename);
+        return false;
+      }
+
+      string Name(NameLength, ' ');
+      string TypeName(TypeLength, ' ');
+      char Padding[8];
+      if (!File.read(&Name[0], NameLength) || !File.read(&TypeName[0], TypeLength) ||
+          !File.read(Padding, PaddingTo8(NameLength + TypeLength)))
+      {
+        PRINT_ERROR("Unexpected end of binary result file: ", Filename);
+        return false;
+      }
+
+      if (!GlobalDataConfig.checkName(TypeName))
+      {
+        PRINT_ERROR("Type does not exist: ", TypeName);
+        return false;
+      }
+
+      const DataType Type = GlobalDataConfig.getType(TypeName);
+      if (static_cast<int>(ValueNumber) != GlobalDataConfig.getLayout(Type).TotalSize)
+      {
+        PRINT_ERROR("Layout of ", TypeName, " does not match the current config: ", ValueNumber, " values");
+        return false;
+      }
+
+      std::vector<double> Values(ValueNumber);
+      for (uint64_t nObject = 0; nObject < ObjectNumber; nObject++)
+      {
+        if (!File.read(Values.data(), ValueNumber * sizeof(double)))
+        {
+          PRINT_ERROR("Unexpected end of binary result file: ", Filename);
+          return false;
+        }
+        Result.addElement(Name, Data(Type, Values.data(), ValueNumber));
+      }
+    }
+
+    return true;
+  }
 }
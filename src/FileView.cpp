@@ -0,0 +1,131 @@
+/***************************************************************************
+ * libRSF - A Robust Sensor Fusion Library
+ *
+ * Copyright (C) 2018 Chair of Automation Technology / TU Chemnitz
+ * For more information see https://www.tu-chemnitz.de/etit/proaut/libRSF
+ *
+ * libRSF is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libRSF is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with libRSF.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Tim Pfeifer (tim.pfeifer@etit.tu-chemnitz.de)
+ ***************************************************************************/
+
+/**
+ * @file FileView.cpp
+ * @author Tim Pfeifer
+ * @date 14.10.2026
+ * @brief Read-only view of a complete file, memory-mapped where it is supported.
+ * @copyright GNU Public License.
+ *
+ */
+
+#include "FileView.h"
+
+#include <cstring>
+#include <fstream>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define LIBRSF_USE_MMAP
+#endif
+
+namespace libRSF
+{
+  FileView::FileView(const std::string &Filename)
+  {
+#ifdef LIBRSF_USE_MMAP
+    const int FileDescriptor = open(Filename.c_str(), O_RDONLY);
+    if (FileDescriptor < 0)
+    {
+      return;
+    }
+
+    struct stat FileStat {};
+    if (fstat(FileDescriptor, &FileStat) == 0)
+    {
+      /** a file without content can not be mapped */
+      if (FileStat.st_size == 0)
+      {
+        IsOpen_ = true;
+      }
+      else
+      {
+        void * Mapping = mmap(nullptr, static_cast<size_t>(FileStat.st_size), PROT_READ, MAP_PRIVATE, FileDescriptor, 0);
+        if (Mapping != MAP_FAILED)
+        {
+          Begin_ = static_cast<const char *>(Mapping);
+          Size_ = static_cast<size_t>(FileStat.st_size);
+          IsMapped_ = true;
+          IsOpen_ = true;
+        }
+      }
+    }
+    close(FileDescriptor);
+#else
+    std::ifstream File(Filename, std::ios::binary | std::ios::ate);
+    if (!File)
+    {
+      return;
+    }
+    Fallback_.resize(static_cast<size_t>(File.tellg()));
+    File.seekg(0);
+    File.read(Fallback_.data(), static_cast<std::streamsize>(Fallback_.size()));
+    Begin_ = Fallback_.data();
+    Size_ = Fallback_.size();
+    IsOpen_ = true;
+#endif
+  }
+
+  FileView::~FileView()
+  {
+#ifdef LIBRSF_USE_MMAP
+    if (IsMapped_)
+    {
+      munmap(const_cast<char *>(Begin_), Size_);
+    }
+#endif
+  }
+
+  bool FileView::read(void * const Target, const size_t Bytes)
+  {
+    if (!this->readAt(Position_, Target, Bytes))
+    {
+      return false;
+    }
+    Position_ += Bytes;
+    return true;
+  }
+
+  bool FileView::readAt(const size_t Position, void * const Target, const size_t Bytes) const
+  {
+    if (Position > Size_ || Bytes > Size_ - Position)
+    {
+      return false;
+    }
+    std::memcpy(Target, Begin_ + Position, Bytes);
+    return true;
+  }
+
+  bool FileView::skip(const size_t Bytes)
+  {
+    if (Position_ > Size_ || Bytes > Size_ - Position_)
+    {
+      return false;
+    }
+    Position_ += Bytes;
+    return true;
+  }
+}
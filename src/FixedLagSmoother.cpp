@@ -0,0 +1,129 @@
+/***************************************************************************
+ * libRSF - A Robust Sensor Fusion Library
+ *
+ * Copyright (C) 2018 Chair of Automation Technology / TU Chemnitz
+ * For more information see https://www.tu-chemnitz.de/etit/proaut/libRSF
+ *
+ * libRSF is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libRSF is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with libRSF.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Tim Pfeifer (tim.pfeifer@etit.tu-chemnitz.de)
+ ***************************************************************************/
+
+#include "FixedLagSmoother.h"
+
+#include <algorithm>
+
+namespace libRSF
+{
+  FixedLagSmoother::FixedLagSmoother(FactorGraph &Graph, const double Lag, const bool Marginalize):
+      Graph_(Graph), Lag_(Lag), Marginalize_(Marginalize)
+  {}
+
+  FixedLagSmoother::FixedLagSmoother(FactorGraph &Graph, const FactorGraphConfig &Config):
+      FixedLagSmoother(Graph, Config.Solution.WindowLength, Config.Solution.Marginalize)
+  {
+    this->setInterval(Config.Solution.MarginalizationInterval);
+    this->setOverflow(Config.Solution.MarginalizationOverflow);
+    this->setMaxMarginalPriors(Config.Solution.MaxMarginalPriors);
+  }
+
+  void FixedLagSmoother::setLag(const double Lag)
+  {
+    Lag_ = Lag;
+  }
+
+  void FixedLagSmoother::setInterval(const int Steps)
+  {
+    Interval_ = std::max(Steps, 1);
+  }
+
+  void FixedLagSmoother::setOverflow(const double Seconds)
+  {
+    Overflow_ = std::max(Seconds, 0.0);
+  }
+
+  void FixedLagSmoother::setMaxMarginalPriors(const int Number)
+  {
+    MaxMarginalPriors_ = std::max(Number, 0);
+  }
+
+  void FixedLagSmoother::setInflation(const double Inflation)
+  {
+    Inflation_ = Inflation;
+  }
+
+  double FixedLagSmoother::getLag() const
+  {
+    return Lag_;
+  }
+
+  int FixedLagSmoother::countReductions() const
+  {
+    return Reductions_;
+  }
+
+  int FixedLagSmoother::countMarginalPriors_() const
+  {
+    return Graph_.countFactorsOfType(FactorType::Marginal);
+  }
+
+  bool FixedLagSmoother::isDue(const double CurrentTime) const
+  {
+    /** nothing is outside of the window */
+    double TimeFirst;
+    if (!Graph_.getTimeFirstInWindow(TimeFirst) || TimeFirst > CurrentTime - Lag_)
+    {
+      return false;
+    }
+
+    /** regular schedule */
+    if (StepsSinceReduction_ + 1 >= Interval_)
+    {
+      return true;
+    }
+
+    /** the window should not grow without limit */
+    if (TimeFirst <= CurrentTime - Lag_ - Overflow_)
+    {
+      return true;
+    }
+
+    /** old states carry the existing priors, marginalizing them merges the priors */
+    return Marginalize_ && MaxMarginalPriors_ > 0 && countMarginalPriors_() > MaxMarginalPriors_;
+  }
+
+  bool FixedLagSmoother::update(const double CurrentTime)
+  {
+    if (!this->isDue(CurrentTime))
+    {
+      StepsSinceReduction_++;
+      return true;
+    }
+
+    bool Success = true;
+    if (Marginalize_)
+    {
+      Success = Graph_.marginalizeAllStatesOutsideWindow(Lag_, CurrentTime, Inflation_);
+    }
+    else
+    {
+      Graph_.removeAllStatesOutsideWindow(Lag_, CurrentTime);
+    }
+
+    StepsSinceReduction_ = 0;
+    Reductions_++;
+
+    return Success;
+  }
+}
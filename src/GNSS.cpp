@@ -22,6 +22,8 @@
 
 #include "GNSS.h"
 
+#include <algorithm>
+
 namespace libRSF
 {
   TangentPlaneConverter::TangentPlaneConverter()
@@ -43,6 +45,18 @@ namespace libRSF
     /** init converter */
     LocalProjection_.Reset(Lat0, Lon0, H0);
 
+    /** cache the origin and the ECEF to ENU rotation */
+    Earth_.Forward(Lat0, Lon0, H0, Origin_(0), Origin_(1), Origin_(2));
+
+    const double SinLat = sin(deg2rad(Lat0));
+    const double CosLat = cos(deg2rad(Lat0));
+    const double SinLon = sin(deg2rad(Lon0));
+    const double CosLon = cos(deg2rad(Lon0));
+
+    RotationToLocal_ << -SinLon,           CosLon,          0.0,
+                        -SinLat * CosLon, -SinLat * SinLon, CosLat,
+                         CosLat * CosLon,  CosLat * SinLon, SinLat;
+
     TangentPoint_ = TangentPoint;
     isInitialized_ = true;
   }
@@ -56,14 +70,7 @@ namespace libRSF
       return GlobalPoint;
     }
 
-    double Lat, Lon, H;
-    double X,Y,Z;
-    Vector3 LocalPoint;
-    Earth_.Reverse(GlobalPoint(0), GlobalPoint(1), GlobalPoint(2), Lat, Lon, H);
-    LocalProjection_.Forward(Lat, Lon, H, X, Y, Z);
-    LocalPoint << X, Y, Z;
-
-    return LocalPoint;
+    return RotationToLocal_ * (GlobalPoint - Origin_);
   }
 
   Vector3 TangentPlaneConverter::convertToGlobal_(const Vector3 &LocalPoint) const
@@ -75,15 +82,7 @@ namespace libRSF
       return LocalPoint;
     }
 
-    double Lat, Lon, H;
-    double X,Y,Z;
-    Vector3 GlobalPoint;
-
-    LocalProjection_.Reverse(LocalPoint(0), LocalPoint(1), LocalPoint(2), Lat, Lon, H);
-    Earth_.Forward(Lat, Lon, H, X, Y, Z);
-    GlobalPoint << X, Y, Z;
-
-    return GlobalPoint;
+    return RotationToLocal_.transpose() * LocalPoint + Origin_;
   }
 
   void TangentPlaneConverter::convertToLocal_(const Vector3   &GlobalPoint,
@@ -98,21 +97,8 @@ namespace libRSF
       return;
     }
 
-    double Lat, Lon, H;
-    double X,Y,Z;
-    std::vector<double> R1(9);
-    std::vector<double> R2(9);
-
-    /** calculate transformation */
-    Earth_.Reverse(GlobalPoint(0), GlobalPoint(1), GlobalPoint(2), Lat, Lon, H, R1);
-    LocalProjection_.Forward(Lat, Lon, H, X, Y, Z, R2);
-
-    /** convert to eigen */
-    Matrix33 R1e(R1.data());
-    Matrix33 R2e(R2.data());
-
-    LocalPoint << X, Y, Z;
-    LocalCov = R2e*R1e*GlobalCov*(R2e*R1e).transpose();
+    LocalPoint = RotationToLocal_ * (GlobalPoint - Origin_);
+    LocalCov = RotationToLocal_ * GlobalCov * RotationToLocal_.transpose();
   }
 
   void TangentPlaneConverter::convertToGlobal_(const Vector3   &LocalPoint,
@@ -127,25 +113,37 @@ namespace libRSF
       return;
     }
 
-    double Lat, Lon, H;
-    double X,Y,Z;
-    std::vector<double> R1(9);
-    std::vector<double> R2(9);
+    GlobalPoint = RotationToLocal_.transpose() * LocalPoint + Origin_;
+    GlobalCov = RotationToLocal_.transpose() * LocalCov * RotationToLocal_;
+  }
 
-    /** calculate transformation */
-    LocalProjection_.Reverse(LocalPoint(0), LocalPoint(1), LocalPoint(2), Lat, Lon, H, R1);
-    Earth_.Forward(Lat, Lon, H, X, Y, Z, R2);
+  void TangentPlaneConverter::convertPointsToLocal(double * const Points, const Index Number) const
+  {
+    if(!isInitialized_)
+    {
+      PRINT_WARNING("Converter is not initialized!");
+      return;
+    }
 
+    /** one vectorized product for all points */
+    MatrixRef<double, 3, Dynamic> PointMap(Points, 3, Number);
+    PointMap.colwise() -= Origin_;
+    PointMap = RotationToLocal_ * PointMap;
+  }
 
-    /** convert to eigen */
-    Matrix33 R1e(R1.data());
-    Matrix33 R2e(R2.data());
+  void TangentPlaneConverter::convertPointsToGlobal(double * const Points, const Index Number) const
+  {
+    if(!isInitialized_)
+    {
+      PRINT_WARNING("Converter is not initialized!");
+      return;
+    }
 
-    GlobalPoint << X, Y, Z;
-    GlobalCov = R2e*R1e*LocalCov*(R2e*R1e).transpose();
+    MatrixRef<double, 3, Dynamic> PointMap(Points, 3, Number);
+    PointMap = RotationToLocal_.transpose() * PointMap;
+    PointMap.colwise() += Origin_;
   }
 
-
   void TangentPlaneConverter::convertStateToLocal(Data &State)
   {
     /** check if the state has the right type */
@@ -234,76 +232,266 @@ namespace libRSF
 
   void TangentPlaneConverter::convertAllPseudorangesToLocal(SensorDataSet &Measurements)
   {
-    double Timestamp;
+    if(!isInitialized_)
+    {
+      PRINT_WARNING("Converter is not initialized!");
+      return;
+    }
 
     /** check if right measurements are available */
-    if(!Measurements.getTimeFirst(DataType::Pseudorange3, Timestamp))
+    if(Measurements.countElements(DataType::Pseudorange3) == 0)
     {
       PRINT_ERROR("There is no pseudorange measurement!");
       return;
     }
 
-    /** iterate over all measurements and convert them */
-    do
+    /** only the pseudoranges are detached from a shared set */
+    auto &Stream = Measurements.getStreamMutable(DataType::Pseudorange3);
+
+    /** gather all satellite positions into one contiguous array */
+    std::vector<double*> Ranges;
+    std::vector<double*> SatPositions;
+    Ranges.reserve(Stream.size());
+    SatPositions.reserve(Stream.size());
+    for (auto Element : Stream)
     {
-      int N = Measurements.countElement(DataType::Pseudorange3, Timestamp);
-      for (int n = 0; n < N; n++)
-      {
-        convertMeasurementToLocal(Measurements.getElement(DataType::Pseudorange3, Timestamp, n));
-      }
+      Ranges.push_back(Element.second.getMeanPointer());
+      SatPositions.push_back(Element.second.getDataPointer(DataElement::SatPos));
+    }
+
+    const Index Number = static_cast<Index>(SatPositions.size());
+    Matrix SatPos(3, Number);
+    for (Index n = 0; n < Number; n++)
+    {
+      SatPos.col(n) = VectorRefConst<double, 3>(SatPositions.at(n));
+
+      /** remove earth rotation effect with the global position */
+      *Ranges.at(n) -= RelativisticCorrection(TangentPoint_.data(), Vector3(SatPos.col(n)));
+    }
+
+    /** convert and write back */
+    this->convertPointsToLocal(SatPos.data(), Number);
+    for (Index n = 0; n < Number; n++)
+    {
+      VectorRef<double, 3>(SatPositions.at(n)) = SatPos.col(n);
     }
-    while (Measurements.getTimeNext(DataType::Pseudorange3, Timestamp, Timestamp));
   }
 
-  void TangentPlaneConverter::convertAllStatesToLocal(StateDataSet &States, const std::string& ID)
+  void TangentPlaneConverter::convertAllStates_(StateDataSet &States, const std::string& ID, const bool ToLocal) const
   {
-    double Timestamp;
+    if(!isInitialized_)
+    {
+      PRINT_WARNING("Converter is not initialized!");
+      return;
+    }
 
     /** check if right States are available */
-    if(!States.getTimeFirst(ID, Timestamp))
+    if(States.countElements(ID) == 0)
     {
       PRINT_ERROR("There is no position state!");
       return;
     }
+    auto &Stream = States.getStreamMutable(ID);
 
-    /** iterate over all States and convert them */
-    do
+    const Matrix33 Rotation = ToLocal ? Matrix33(RotationToLocal_) : Matrix33(RotationToLocal_.transpose());
+
+    /** update mean and covariance through their pointers */
+    std::vector<double*> Means;
+    Means.reserve(Stream.size());
+    for (auto Element : Stream)
     {
-      int N = States.countElement(ID, Timestamp);
-      for (int n = 0; n < N; n++)
+      Data &State = Element.second;
+
+      /** check if the state has the right type */
+      if(State.getType() != DataType::Point3)
       {
-        convertStateToLocal(States.getElement(ID, Timestamp, n));
+        PRINT_ERROR("Wrong state Type: ", State.getType());
+        continue;
       }
+
+      Means.push_back(State.getMeanPointer());
+
+      MatrixRef<double, 3, 3> Cov(State.getDataPointer(DataElement::Covariance));
+      Cov = Rotation * Cov * Rotation.transpose();
+    }
+
+    /** means are converted in one batch */
+    const Index Number = static_cast<Index>(Means.size());
+    Matrix Points(3, Number);
+    for (Index n = 0; n < Number; n++)
+    {
+      Points.col(n) = VectorRefConst<double, 3>(Means.at(n));
     }
-    while (States.getTimeNext(ID, Timestamp, Timestamp));
+
+    if (ToLocal)
+    {
+      this->convertPointsToLocal(Points.data(), Number);
+    }
+    else
+    {
+      this->convertPointsToGlobal(Points.data(), Number);
+    }
+
+    for (Index n = 0; n < Number; n++)
+    {
+      VectorRef<double, 3>(Means.at(n)) = Points.col(n);
+    }
+  }
+
+  void TangentPlaneConverter::convertAllStatesToLocal(StateDataSet &States, const std::string& ID)
+  {
+    this->convertAllStates_(States, ID, true);
   }
 
   void TangentPlaneConverter::convertAllStatesToGlobal(StateDataSet &States, const std::string& ID)
   {
-    double Timestamp;
+    this->convertAllStates_(States, ID, false);
+  }
 
-    /** check if right States are available */
-    if(!States.getTimeFirst(ID, Timestamp))
+  bool TangentPlaneConverter::isInitialized() const
+  {
+    return isInitialized_;
+  }
+
+  double PseudorangeError(const Vector3 &Position,
+                          const double ClockError,
+                          const Vector3 &SatPos,
+                          const double Range,
+                          const bool UseSagnac)
+  {
+    double Error = (Position - SatPos).norm() + ClockError - Range;
+    if (UseSagnac)
     {
-      PRINT_ERROR("There is no position state!");
-      return;
+      Error += RelativisticCorrection(Position.data(), SatPos);
     }
+    return Error;
+  }
 
-    /** iterate over all States and convert them */
-    do
+  bool SolveMinimalPseudoranges(const Matrix34 &SatPos,
+                                const Vector4 &Ranges,
+                                const bool UseSagnac,
+                                Vector3 &Position,
+                                double &ClockError,
+                                const int MaxIterations)
+  {
+    for (int n = 0; n < MaxIterations; n++)
     {
-      int N = States.countElement(ID, Timestamp);
-      for (int n = 0; n < N; n++)
+      /** linearize all four pseudo ranges */
+      Matrix44 Jacobian;
+      Vector4 Error;
+      for (int nSat = 0; nSat < 4; nSat++)
+      {
+        const Vector3 Sat = SatPos.col(nSat);
+        const Vector3 Difference = Position - Sat;
+        const double Distance = Difference.norm();
+        if (Distance <= 0.0)
+        {
+          return false;
+        }
+
+        Error(nSat) = PseudorangeError(Position, ClockError, Sat, Ranges(nSat), UseSagnac);
+        Jacobian.block<1, 3>(nSat, 0) = Difference.transpose() / Distance;
+        Jacobian(nSat, 3) = 1.0;
+
+        if (UseSagnac)
+        {
+          Jacobian(nSat, 0) -= EARTH_ROTATION_RATE * Sat(1) / SPEED_OF_LIGHT;
+          Jacobian(nSat, 1) += EARTH_ROTATION_RATE * Sat(0) / SPEED_OF_LIGHT;
+        }
+      }
+
+      /** the system is square, so each step solves it exactly for the linearization */
+      const Eigen::FullPivLU<Matrix44> Decomposition(Jacobian);
+      if (!Decomposition.isInvertible())
+      {
+        return false;
+      }
+      const Vector4 Step = -Decomposition.solve(Error);
+
+      Position += Step.head<3>();
+      ClockError += Step(3);
+
+      if (!Step.allFinite())
       {
-        convertStateToGlobal(States.getElement(ID, Timestamp, n));
+        return false;
+      }
+
+      /** converged below a millimeter */
+      if (Step.norm() < 1e-3)
+      {
+        return true;
       }
     }
-    while (States.getTimeNext(ID, Timestamp, Timestamp));
+
+    return false;
   }
 
-  bool TangentPlaneConverter::isInitialized() const
+  bool SolvePseudoranges(const std::vector<Vector3> &SatPos,
+                         const std::vector<double> &Ranges,
+                         const bool UseSagnac,
+                         Vector3 &Position,
+                         double &ClockError,
+                         const int MaxIterations)
   {
-    return isInitialized_;
-  }
+    const size_t SatNumber = std::min(SatPos.size(), Ranges.size());
+    if (SatNumber < 4)
+    {
+      return false;
+    }
 
+    for (int n = 0; n < MaxIterations; n++)
+    {
+      /** accumulate the normal equations satellite by satellite */
+      Matrix44 Hessian = Matrix44::Zero();
+      Vector4 Gradient = Vector4::Zero();
+      for (size_t nSat = 0; nSat < SatNumber; nSat++)
+      {
+        const Vector3 &Sat = SatPos[nSat];
+        const Vector3 Difference = Position - Sat;
+        const double Distance = Difference.norm();
+        if (Distance <= 0.0)
+        {
+          return false;
+        }
+
+        Vector4 Jacobian;
+        Jacobian.head<3>() = Difference / Distance;
+        Jacobian(3) = 1.0;
+
+        if (UseSagnac)
+        {
+          Jacobian(0) -= EARTH_ROTATION_RATE * Sat(1) / SPEED_OF_LIGHT;
+          Jacobian(1) += EARTH_ROTATION_RATE * Sat(0) / SPEED_OF_LIGHT;
+        }
+
+        const double Error = PseudorangeError(Position, ClockError, Sat, Ranges[nSat], UseSagnac);
+        Hessian.noalias() += Jacobian * Jacobian.transpose();
+        Gradient.noalias() += Jacobian * Error;
+      }
+
+      /** the normal equations are positive definite for a non-degenerated geometry */
+      const Eigen::LDLT<Matrix44> Decomposition(Hessian);
+      if (Decomposition.info() != Eigen::Success || !Decomposition.isPositive())
+      {
+        return false;
+      }
+      const Vector4 Step = -Decomposition.solve(Gradient);
+
+      if (!Step.allFinite())
+      {
+        return false;
+      }
+
+      Position += Step.head<3>();
+      ClockError += Step(3);
+
+      /** converged below a millimeter */
+      if (Step.norm() < 1e-3)
+      {
+        return true;
+      }
+    }
+
+    return false;
+  }
 }
@@ -22,6 +22,8 @@
 
 #include "Geometry.h"
 
+#include <limits>
+
 namespace libRSF
 {
   /** angular conversion */
@@ -34,6 +36,87 @@ namespace libRSF
     return Rad * 180.0 / M_PI;
   }
 
+  void QuaternionExpMap(const MatrixT<double, 3, Dynamic> &Angles, MatrixT<double, 4, Dynamic> &Quaternions)
+  {
+    using RowArray = Eigen::Array<double, 1, Dynamic>;
+
+    const RowArray HalfSquared = 0.25 * Angles.colwise().squaredNorm().array();
+    const RowArray Half = HalfSquared.sqrt();
+    const auto IsSmall = HalfSquared < (SmallHalfAngle * SmallHalfAngle);
+
+    /** both branches are evaluated for all columns, the select avoids branches inside the packets */
+    const RowArray Cos = IsSmall.select(1.0 - HalfSquared / 2.0 + HalfSquared.square() / 24.0, Half.cos());
+    const RowArray SinByAngle = IsSmall.select(0.5 * (1.0 - HalfSquared / 6.0 + HalfSquared.square() / 120.0),
+                                               Half.sin() / (2.0 * Half.max(SmallHalfAngle)));
+
+    Quaternions.resize(4, Angles.cols());
+    Quaternions.topRows<3>() = (Angles.array().rowwise() * SinByAngle).matrix();
+    Quaternions.row(3) = Cos.matrix();
+  }
+
+  void QuaternionLogMap(const MatrixT<double, 4, Dynamic> &Quaternions, MatrixT<double, 3, Dynamic> &Angles)
+  {
+    using RowArray = Eigen::Array<double, 1, Dynamic>;
+
+    /** the shorter rotation, like the axis-angle conversion */
+    const RowArray Sign = (Quaternions.row(3).array() < 0.0).select(RowArray::Constant(Quaternions.cols(), -1.0),
+                                                                  RowArray::Constant(Quaternions.cols(), 1.0));
+    const RowArray W = Sign * Quaternions.row(3).array();
+    const RowArray SinHalf = Quaternions.topRows<3>().colwise().norm().array();
+    const auto IsSmall = SinHalf < (SmallHalfAngle * W);
+
+    /** atan2(s, w) = atan(s/w) for w > 0 and pi/2 for w = 0 */
+    const RowArray Ratio = SinHalf / W.max(std::numeric_limits<double>::min());
+    const RowArray RatioSquared = Ratio.square();
+    const RowArray HalfAngle = (W > 0.0).select(Ratio.atan(), RowArray::Constant(Quaternions.cols(), M_PI / 2.0));
+    const RowArray AngleBySin = IsSmall.select(2.0 / W.max(std::numeric_limits<double>::min()) * (1.0 - RatioSquared / 3.0 + RatioSquared.square() / 5.0),
+                                               2.0 * HalfAngle / SinHalf.max(std::numeric_limits<double>::min()));
+
+    Angles = (Quaternions.topRows<3>().array().rowwise() * (Sign * AngleBySin)).matrix();
+  }
+
+  Matrix33 RightJacobianSO3(const Vector3 &Phi)
+  {
+    const double AngleSquared = Phi.squaredNorm();
+    const Matrix33 Skew = SkewSymmetricMatrix<double>(Phi);
+
+    /** (1 - cos(a)) / a^2 and (a - sin(a)) / a^3 */
+    double A, B;
+    if (AngleSquared < SmallHalfAngle * SmallHalfAngle)
+    {
+      A = 0.5 - AngleSquared / 24.0;
+      B = 1.0 / 6.0 - AngleSquared / 120.0;
+    }
+    else
+    {
+      const double Angle = std::sqrt(AngleSquared);
+      A = (1.0 - std::cos(Angle)) / AngleSquared;
+      B = (Angle - std::sin(Angle)) / (AngleSquared * Angle);
+    }
+
+    return Matrix33::Identity() - A * Skew + B * Skew * Skew;
+  }
+
+  Matrix33 RightJacobianInverseSO3(const Vector3 &Phi)
+  {
+    const double AngleSquared = Phi.squaredNorm();
+    const Matrix33 Skew = SkewSymmetricMatrix<double>(Phi);
+
+    /** 1/a^2 - (1 + cos(a)) / (2 a sin(a)) */
+    double C;
+    if (AngleSquared < SmallHalfAngle * SmallHalfAngle)
+    {
+      C = 1.0 / 12.0 + AngleSquared / 720.0;
+    }
+    else
+    {
+      const double Angle = std::sqrt(AngleSquared);
+      C = 1.0 / AngleSquared - (1.0 + std::cos(Angle)) / (2.0 * Angle * std::sin(Angle));
+    }
+
+    return Matrix33::Identity() + 0.5 * Skew + C * Skew * Skew;
+  }
+
   Vector3 QuaternionError(const Quaternion& Q1,
                           const Quaternion& Q2,
                           Matrix34 *Jacobian1,
@@ -0,0 +1,206 @@
+/***************************************************************************
+ * libRSF - A Robust Sensor Fusion Library
+ *
+ * Copyright (C) 2018 Chair of Automation Technology / TU Chemnitz
+ * For more information see https://www.tu-chemnitz.de/etit/proaut/libRSF
+ *
+ * libRSF is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libRSF is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with libRSF.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Tim Pfeifer (tim.pfeifer@etit.tu-chemnitz.de)
+ ***************************************************************************/
+
+#include "GraphTrace.h"
+
+#include <cstring>
+
+namespace libRSF
+{
+  static const char TraceMagic[4] = {'R', 'S', 'F', 'T'};
+  static const uint32_t TraceVersion = 1;
+
+  /** records are written in blocks of this size */
+  static constexpr size_t TraceBlockSize = 1 << 20;
+
+  const char* GetTraceOperationName(const TraceOperation Operation)
+  {
+    switch (Operation)
+    {
+      case TraceOperation::AddState: return "add_state";
+      case TraceOperation::AddFactor: return "add_factor";
+      case TraceOperation::AddStatePrior: return "add_state_prior";
+      case TraceOperation::SetMeans: return "set_means";
+      case TraceOperation::RemoveFactor: return "remove_factor";
+      case TraceOperation::RemoveFactors: return "remove_factors";
+      case TraceOperation::RemoveFactorsOutsideWindow: return "remove_factors_outside_window";
+      case TraceOperation::RemoveAllFactorsOutsideWindow: return "remove_all_factors_outside_window";
+      case TraceOperation::RemoveState: return "remove_state";
+      case TraceOperation::RemoveStates: return "remove_states";
+      case TraceOperation::RemoveStatesOutsideWindow: return "remove_states_outside_window";
+      case TraceOperation::RemoveAllStatesOutsideWindow: return "remove_all_states_outside_window";
+      case TraceOperation::RemoveBefore: return "remove_before";
+      case TraceOperation::SetConstant: return "set_constant";
+      case TraceOperation::SetVariable: return "set_variable";
+      case TraceOperation::SetVariableAll: return "set_variable_all";
+      case TraceOperation::SetConstantOutsideWindow: return "set_constant_outside_window";
+      case TraceOperation::SetVariableInsideWindow: return "set_variable_inside_window";
+      case TraceOperation::SetAllConstantOutsideWindow: return "set_all_constant_outside_window";
+      case TraceOperation::SetAllVariableInsideWindow: return "set_all_variable_inside_window";
+      case TraceOperation::MarginalizeStates: return "marginalize_states";
+      case TraceOperation::MarginalizeOutsideWindow: return "marginalize_outside_window";
+      case TraceOperation::EnableErrorModel: return "enable_error_model";
+      case TraceOperation::DisableErrorModel: return "disable_error_model";
+      case TraceOperation::EnableErrorModels: return "enable_error_models";
+      case TraceOperation::DisableErrorModels: return "disable_error_models";
+      case TraceOperation::SetWarmStart: return "set_warm_start";
+      case TraceOperation::SetLandmarksFirst: return "set_landmarks_first";
+      case TraceOperation::SetDenseSolverThreshold: return "set_dense_solver_threshold";
+      case TraceOperation::Solve: return "solve";
+      case TraceOperation::SolveIncremental: return "solve_incremental";
+      case TraceOperation::SetTimeChainOrdering: return "set_time_chain_ordering";
+      case TraceOperation::RemoveStateList: return "remove_state_list";
+      case TraceOperation::SolveComponents: return "solve_components";
+      case TraceOperation::SetWindowExempt: return "set_window_exempt";
+      default: return "unknown";
+    }
+  }
+
+  void WriteSolverOptions(CheckpointWriter &Writer, const ceres::Solver::Options &Options)
+  {
+    Writer.write(static_cast<int32_t>(Options.minimizer_type));
+    Writer.write(static_cast<int32_t>(Options.line_search_direction_type));
+    Writer.write(static_cast<int32_t>(Options.trust_region_strategy_type));
+    Writer.write(static_cast<int32_t>(Options.dogleg_type));
+    Writer.write(static_cast<int32_t>(Options.linear_solver_type));
+    Writer.write(static_cast<int32_t>(Options.preconditioner_type));
+    Writer.write(static_cast<int32_t>(Options.sparse_linear_algebra_library_type));
+    Writer.write(static_cast<int32_t>(Options.dense_linear_algebra_library_type));
+    Writer.write(static_cast<int32_t>(Options.max_num_iterations));
+    Writer.write(static_cast<int32_t>(Options.max_num_consecutive_invalid_steps));
+    Writer.write(static_cast<int32_t>(Options.num_threads));
+    Writer.write(Options.max_solver_time_in_seconds);
+    Writer.write(Options.initial_trust_region_radius);
+    Writer.write(Options.max_trust_region_radius);
+    Writer.write(Options.min_trust_region_radius);
+    Writer.write(Options.function_tolerance);
+    Writer.write(Options.gradient_tolerance);
+    Writer.write(Options.parameter_tolerance);
+    Writer.write(static_cast<uint8_t>(Options.use_nonmonotonic_steps));
+    Writer.write(static_cast<uint8_t>(Options.use_inner_iterations));
+    Writer.write(static_cast<uint8_t>(Options.jacobi_scaling));
+    Writer.write(static_cast<uint8_t>(Options.minimizer_progress_to_stdout));
+  }
+
+  bool ReadSolverOptions(CheckpointReader &Reader, ceres::Solver::Options &Options)
+  {
+    int32_t Minimizer = 0, LineSearch = 0, TrustRegion = 0, Dogleg = 0, LinearSolver = 0, Preconditioner = 0, Sparse = 0, Dense = 0;
+    int32_t Iterations = 0, InvalidSteps = 0, Threads = 0;
+    uint8_t Nonmonotonic = 0, InnerIterations = 0, JacobiScaling = 0, Progress = 0;
+    if (!Reader.read(Minimizer) || !Reader.read(LineSearch) || !Reader.read(TrustRegion) || !Reader.read(Dogleg) ||
+        !Reader.read(LinearSolver) || !Reader.read(Preconditioner) || !Reader.read(Sparse) || !Reader.read(Dense) ||
+        !Reader.read(Iterations) || !Reader.read(InvalidSteps) || !Reader.read(Threads) ||
+        !Reader.read(Options.max_solver_time_in_seconds) ||
+        !Reader.read(Options.initial_trust_region_radius) ||
+        !Reader.read(Options.max_trust_region_radius) ||
+        !Reader.read(Options.min_trust_region_radius) ||
+        !Reader.read(Options.function_tolerance) ||
+        !Reader.read(Options.gradient_tolerance) ||
+        !Reader.read(Options.parameter_tolerance) ||
+        !Reader.read(Nonmonotonic) || !Reader.read(InnerIterations) || !Reader.read(JacobiScaling) || !Reader.read(Progress))
+    {
+      return false;
+    }
+
+    Options.minimizer_type = static_cast<ceres::MinimizerType>(Minimizer);
+    Options.line_search_direction_type = static_cast<ceres::LineSearchDirectionType>(LineSearch);
+    Options.trust_region_strategy_type = static_cast<ceres::TrustRegionStrategyType>(TrustRegion);
+    Options.dogleg_type = static_cast<ceres::DoglegType>(Dogleg);
+    Options.linear_solver_type = static_cast<ceres::LinearSolverType>(LinearSolver);
+    Options.preconditioner_type = static_cast<ceres::PreconditionerType>(Preconditioner);
+    Options.sparse_linear_algebra_library_type = static_cast<ceres::SparseLinearAlgebraLibraryType>(Sparse);
+    Options.dense_linear_algebra_library_type = static_cast<ceres::DenseLinearAlgebraLibraryType>(Dense);
+    Options.max_num_iterations = Iterations;
+    Options.max_num_consecutive_invalid_steps = InvalidSteps;
+    Options.num_threads = Threads;
+    Options.use_nonmonotonic_steps = (Nonmonotonic != 0);
+    Options.use_inner_iterations = (InnerIterations != 0);
+    Options.jacobi_scaling = (JacobiScaling != 0);
+    Options.minimizer_progress_to_stdout = (Progress != 0);
+    return true;
+  }
+
+  GraphTraceWriter::GraphTraceWriter(const std::string &Filename)
+    : File_(Filename, std::ios::out | std::ios::trunc | std::ios::binary)
+  {
+    if (!File_)
+    {
+      PRINT_ERROR("Could not open file: ", Filename);
+      return;
+    }
+
+    Buffer_.write(TraceMagic);
+    Buffer_.write(TraceVersion);
+  }
+
+  GraphTraceWriter::~GraphTraceWriter()
+  {
+    this->flush();
+  }
+
+  bool GraphTraceWriter::isValid() const
+  {
+    return static_cast<bool>(File_);
+  }
+
+  CheckpointWriter &GraphTraceWriter::begin(const TraceOperation Operation)
+  {
+    Buffer_.write(static_cast<uint8_t>(Operation));
+    return Buffer_;
+  }
+
+  void GraphTraceWriter::end(const double Duration)
+  {
+    Buffer_.write(Duration);
+    if (Buffer_.size() >= TraceBlockSize)
+    {
+      this->flush();
+    }
+  }
+
+  void GraphTraceWriter::flush()
+  {
+    if (File_)
+    {
+      Buffer_.flushToStream(File_);
+      File_.flush();
+    }
+  }
+
+  bool OpenGraphTrace(const std::string &Filename, CheckpointReader &Reader)
+  {
+    if (!Reader.readFromFile(Filename))
+    {
+      return false;
+    }
+
+    char Magic[sizeof(TraceMagic)];
+    uint32_t Version = 0;
+    if (!Reader.read(Magic) || std::memcmp(Magic, TraceMagic, sizeof(Magic)) != 0 ||
+        !Reader.read(Version) || Version != TraceVersion)
+    {
+      PRINT_ERROR("Invalid header of graph trace: ", Filename);
+      return false;
+    }
+    return true;
+  }
+}
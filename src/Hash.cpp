@@ -22,10 +22,30 @@
 
 #include "Hash.h"
 
+#include <cstdint>
+
+namespace
+{
+  /** finalizer of splitmix64, every input bit affects every output bit */
+  uint64_t MixHash(uint64_t X)
+  {
+    X ^= X >> 30;
+    X *= UINT64_C(0xbf58476d1ce4e5b9);
+    X ^= X >> 27;
+    X *= UINT64_C(0x94d049bb133111eb);
+    X ^= X >> 31;
+    return X;
+  }
+}
+
 namespace std
 {
   size_t CombineHash(size_t H1, size_t H2, size_t H3)
   {
-    return ((H1 ^ (H2 << 1)) >> 1) ^ (H3 << 1);
+    /** the std::hash of integers is the identity, so the small parts are spread with odd multipliers before one common finalizer */
+    const uint64_t Seed = static_cast<uint64_t>(H2)
+                          ^ (static_cast<uint64_t>(H1) * UINT64_C(0x9e3779b97f4a7c15))
+                          ^ (static_cast<uint64_t>(H3) * UINT64_C(0xc2b2ae3d27d4eb4f));
+    return static_cast<size_t>(MixHash(Seed));
   }
 }
@@ -0,0 +1,223 @@
+/***************************************************************************
+ * libRSF - A Robust Sensor Fusion Library
+ *
+ * Copyright (C) 2018 Chair of Automation Technology / TU Chemnitz
+ * For more information see https://www.tu-chemnitz.de/etit/proaut/libRSF
+ *
+ * libRSF is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libRSF is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with libRSF.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Tim Pfeifer (tim.pfeifer@etit.tu-chemnitz.de)
+ ***************************************************************************/
+
+/**
+ * @file IncrementalCovariance.cpp
+ * @author Tim Pfeifer
+ * @date 14.10.2026
+ * @brief Marginal covariance of the newest states, propagated like an information filter.
+ * @copyright GNU Public License.
+ *
+ */
+
+#include "IncrementalCovariance.h"
+#include "CalculateCovariance.h"
+
+#include <algorithm>
+
+namespace libRSF
+{
+  IncrementalCovariance::IncrementalCovariance(const int AnchorInterval) : AnchorInterval_(std::max(1, AnchorInterval))
+  {
+  }
+
+  void IncrementalCovariance::setEpoch_(const ceres::Problem &Graph, const std::vector<double*> &Epoch)
+  {
+    States_ = Epoch;
+    Offsets_.clear();
+    Sizes_.clear();
+    Size_ = 0;
+    for (double* const State : States_)
+    {
+      Offsets_.push_back(Size_);
+      Sizes_.push_back(Graph.ParameterBlockLocalSize(State));
+      Size_ += Sizes_.back();
+    }
+  }
+
+  bool IncrementalCovariance::anchor(const ceres::Problem &Graph, const std::vector<double*> &Epoch, const Matrix &Covariance)
+  {
+    this->reset();
+    this->setEpoch_(Graph, Epoch);
+
+    if (Size_ == 0 || Covariance.rows() != Size_ || Covariance.cols() != Size_)
+    {
+      this->reset();
+      return false;
+    }
+
+    const Eigen::LLT<Matrix> LLT(Covariance);
+    if (LLT.info() != Eigen::Success)
+    {
+      this->reset();
+      return false;
+    }
+
+    Covariance_ = Covariance;
+    Information_ = LLT.solve(Matrix::Identity(Size_, Size_));
+    IsValid_ = true;
+    return true;
+  }
+
+  bool IncrementalCovariance::propagate(ceres::Problem &Graph, const std::vector<double*> &Epoch)
+  {
+    if (!IsValid_)
+    {
+      return false;
+    }
+
+    /** repeated requests for the same epoch */
+    if (Epoch == States_)
+    {
+      return true;
+    }
+
+    /** the previous epoch has to be part of the graph, e.g. it is removed by a filter */
+    for (double* const State : States_)
+    {
+      if (!Graph.HasParameterBlock(State))
+      {
+        return false;
+      }
+    }
+
+    /** joint system of [previous, new] */
+    std::vector<double*> Joint = States_;
+    Joint.insert(Joint.end(), Epoch.begin(), Epoch.end());
+    std::vector<int> Offsets;
+    int JointSize = 0;
+    for (double* const State : Joint)
+    {
+      Offsets.push_back(JointSize);
+      JointSize += Graph.ParameterBlockLocalSize(State);
+    }
+    const int NewSize = JointSize - Size_;
+    if (NewSize == 0)
+    {
+      return false;
+    }
+
+    Matrix Hessian = Matrix::Zero(JointSize, JointSize);
+    Hessian.topLeftCorner(Size_, Size_) = Information_;
+
+    /** all factors of the new epoch */
+    std::unordered_set<ceres::ResidualBlockId> Factors;
+    std::vector<ceres::ResidualBlockId> Connected;
+    for (double* const State : Epoch)
+    {
+      Graph.GetResidualBlocksForParameterBlock(State, &Connected);
+      Factors.insert(Connected.begin(), Connected.end());
+    }
+
+    for (const ceres::ResidualBlockId Factor : Factors)
+    {
+      /** the chain is broken by factors to older or other variable states */
+      if (!AccumulateFactorInformation(Graph, Factor, Joint, Offsets, Hessian))
+      {
+        return false;
+      }
+    }
+
+    /** eliminate the previous epoch with the Schur complement */
+    const Eigen::LDLT<Matrix> Previous(Hessian.topLeftCorner(Size_, Size_));
+    if (Previous.info() != Eigen::Success)
+    {
+      return false;
+    }
+    const Matrix Information = Hessian.bottomRightCorner(NewSize, NewSize)
+                               - Hessian.bottomLeftCorner(NewSize, Size_) * Previous.solve(Hessian.topRightCorner(Size_, NewSize));
+
+    const Eigen::LLT<Matrix> LLT(Information);
+    if (LLT.info() != Eigen::Success)
+    {
+      PRINT_WARNING("Propagated information matrix is not positive definite.");
+      return false;
+    }
+
+    this->setEpoch_(Graph, Epoch);
+    Information_ = Information;
+    Covariance_ = LLT.solve(Matrix::Identity(NewSize, NewSize));
+    Steps_++;
+    return true;
+  }
+
+  bool IncrementalCovariance::getCovarianceBlock(const ceres::Problem &Graph, const double* State, double* Covariance) const
+  {
+    const auto It = std::find(States_.begin(), States_.end(), State);
+    if (!IsValid_ || It == States_.end())
+    {
+      return false;
+    }
+
+    const auto Index = static_cast<size_t>(It - States_.begin());
+    const int LocalSize = Sizes_.at(Index);
+    const int GlobalSize = Graph.ParameterBlockSize(State);
+    const Matrix CovLocal = Covariance_.block(Offsets_.at(Index), Offsets_.at(Index), LocalSize, LocalSize);
+
+    /** lift to the global parametrization */
+    MatrixRef<double, Dynamic, Dynamic> CovGlobal(Covariance, GlobalSize, GlobalSize);
+    const ceres::LocalParameterization* Parametrization = Graph.GetParameterization(State);
+    if (Parametrization != nullptr)
+    {
+      Matrix JacobianPlus(GlobalSize, LocalSize);
+      Parametrization->ComputeJacobian(State, JacobianPlus.data());
+      CovGlobal = JacobianPlus * CovLocal * JacobianPlus.transpose();
+    }
+    else
+    {
+      CovGlobal = CovLocal;
+    }
+    return true;
+  }
+
+  bool IncrementalCovariance::isValid() const
+  {
+    return IsValid_;
+  }
+
+  bool IncrementalCovariance::needsAnchor() const
+  {
+    return !IsValid_ || Steps_ >= AnchorInterval_;
+  }
+
+  bool IncrementalCovariance::hasState(const double* State) const
+  {
+    return IsValid_ && std::find(States_.begin(), States_.end(), State) != States_.end();
+  }
+
+  int IncrementalCovariance::countSteps() const
+  {
+    return Steps_;
+  }
+
+  void IncrementalCovariance::reset()
+  {
+    States_.clear();
+    Offsets_.clear();
+    Sizes_.clear();
+    Size_ = 0;
+    Information_.resize(0, 0);
+    Covariance_.resize(0, 0);
+    Steps_ = 0;
+    IsValid_ = false;
+  }
+}
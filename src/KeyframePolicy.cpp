@@ -0,0 +1,111 @@
+/***************************************************************************
+ * libRSF - A Robust Sensor Fusion Library
+ *
+ * Copyright (C) 2018 Chair of Automation Technology / TU Chemnitz
+ * For more information see https://www.tu-chemnitz.de/etit/proaut/libRSF
+ *
+ * libRSF is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libRSF is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with libRSF.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Tim Pfeifer (tim.pfeifer@etit.tu-chemnitz.de)
+ ***************************************************************************/
+
+#include "KeyframePolicy.h"
+
+#include <cmath>
+
+namespace libRSF
+{
+  KeyframePolicy::KeyframePolicy(const FactorGraphConfig::KeyframeConfig &Config) : Config_(Config)
+  {
+  }
+
+  void KeyframePolicy::reset(const double Time)
+  {
+    KeyframeTime_ = Time;
+    Keyframes_ = 1;
+    Skipped_ = 0;
+  }
+
+  bool KeyframePolicy::isKeyframe(const double Time, const double Translation, const double Rotation, const double InformationGain) const
+  {
+    /** without an active policy every epoch is a keyframe */
+    if (!Config_.IsActive)
+    {
+      return true;
+    }
+
+    if (Config_.MaxInterval > 0.0 && Time - KeyframeTime_ >= Config_.MaxInterval)
+    {
+      return true;
+    }
+
+    if (Config_.MinTranslation > 0.0 && Translation >= Config_.MinTranslation)
+    {
+      return true;
+    }
+
+    if (Config_.MinRotation > 0.0 && Rotation >= Config_.MinRotation)
+    {
+      return true;
+    }
+
+    return Config_.MinInformationGain > 0.0 && InformationGain >= Config_.MinInformationGain;
+  }
+
+  void KeyframePolicy::accept(const double Time)
+  {
+    KeyframeTime_ = Time;
+    Keyframes_++;
+  }
+
+  bool KeyframePolicy::update(const double Time, const double Translation, const double Rotation, const double InformationGain)
+  {
+    if (this->isKeyframe(Time, Translation, Rotation, InformationGain))
+    {
+      this->accept(Time);
+      return true;
+    }
+
+    Skipped_++;
+    return false;
+  }
+
+  double KeyframePolicy::getKeyframeTime() const
+  {
+    return KeyframeTime_;
+  }
+
+  int KeyframePolicy::countKeyframes() const
+  {
+    return Keyframes_;
+  }
+
+  int KeyframePolicy::countSkipped() const
+  {
+    return Skipped_;
+  }
+
+  double KeyframePolicy::ExpectedInformationGain(const Matrix &Covariance, const Matrix &Information)
+  {
+    if (Covariance.rows() != Information.rows() || Covariance.cols() != Information.cols())
+    {
+      PRINT_ERROR("Dimensions of covariance and information do not match: ", Covariance.rows(), " vs. ", Information.rows());
+      return 0.0;
+    }
+
+    /** I + Cov * Info is similar to a symmetric positive definite matrix, so its determinant is positive */
+    const Matrix Gain = Matrix::Identity(Covariance.rows(), Covariance.cols()) + Covariance * Information;
+    return 0.5 * std::log(Gain.determinant());
+  }
+}
@@ -0,0 +1,178 @@
+/***************************************************************************
+ * libRSF - A Robust Sensor Fusion Library
+ *
+ * Copyright (C) 2018 Chair of Automation Technology / TU Chemnitz
+ * For more information see https://www.tu-chemnitz.de/etit/proaut/libRSF
+ *
+ * libRSF is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libRSF is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with libRSF.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Tim Pfeifer (tim.pfeifer@etit.tu-chemnitz.de)
+ ***************************************************************************/
+
+#include "LandmarkManager.h"
+
+#include <algorithm>
+#include <tuple>
+
+namespace libRSF
+{
+  LandmarkManager::LandmarkManager(FactorGraph &Graph, const double MaxAge, const int MaxActive, const bool Marginalize):
+      Graph_(Graph), MaxAge_(std::max(MaxAge, 0.0)), MaxActive_(std::max(MaxActive, 0)), Marginalize_(Marginalize)
+  {}
+
+  LandmarkManager::LandmarkManager(FactorGraph &Graph, const FactorGraphConfig &Config):
+      LandmarkManager(Graph, Config.Solution.LandmarkMaxAge, Config.Solution.MaxLandmarks, Config.Solution.Marginalize)
+  {}
+
+  void LandmarkManager::setMaxAge(const double MaxAge)
+  {
+    MaxAge_ = std::max(MaxAge, 0.0);
+  }
+
+  void LandmarkManager::setMaxActive(const int MaxActive)
+  {
+    MaxActive_ = std::max(MaxActive, 0);
+  }
+
+  void LandmarkManager::setInflation(const double Inflation)
+  {
+    Inflation_ = Inflation;
+  }
+
+  void LandmarkManager::observe(const StateKey &Landmark, const double Time)
+  {
+    const auto Inserted = Landmarks_.emplace(Landmark, LandmarkTrack());
+    LandmarkTrack &Track = Inserted.first->second;
+
+    /** the sliding window must not touch the landmark anymore */
+    if (Inserted.second)
+    {
+      Graph_.setWindowExempt(Landmark);
+      Track.LastSeen = Time;
+    }
+
+    Track.Observations++;
+    Track.LastSeen = std::max(Track.LastSeen, Time);
+  }
+
+  std::vector<StateKey> LandmarkManager::selectReduction_(const double CurrentTime) const
+  {
+    std::vector<StateKey> Reduced;
+    std::vector<std::tuple<double, int, StateKey>> Remaining;
+    for (const auto &Landmark : Landmarks_)
+    {
+      if (MaxAge_ > 0.0 && CurrentTime - Landmark.second.LastSeen > MaxAge_)
+      {
+        Reduced.push_back(Landmark.first);
+      }
+      else
+      {
+        Remaining.emplace_back(Landmark.second.LastSeen, Landmark.second.Observations, Landmark.first);
+      }
+    }
+
+    /** the longest unseen landmarks with the fewest observations go first */
+    if (MaxActive_ > 0 && static_cast<int>(Remaining.size()) > MaxActive_)
+    {
+      const auto Border = Remaining.begin() + (static_cast<int>(Remaining.size()) - MaxActive_);
+      std::nth_element(Remaining.begin(), Border, Remaining.end());
+      for (auto It = Remaining.begin(); It != Border; ++It)
+      {
+        Reduced.push_back(std::get<2>(*It));
+      }
+    }
+
+    return Reduced;
+  }
+
+  int LandmarkManager::update(const double CurrentTime)
+  {
+    const std::vector<StateKey> Reduced = this->selectReduction_(CurrentTime);
+    if (Reduced.empty())
+    {
+      return 0;
+    }
+
+    /** all states of the reduced landmarks are handled at once */
+    const StateDataSet &StateData = Graph_.getStateData();
+    std::vector<StateID> States;
+    for (const StateKey &Name : Reduced)
+    {
+      std::vector<double> Times;
+      if (StateData.getTimesOfID(Name, Times))
+      {
+        for (const double Time : Times)
+        {
+          const int Numbers = StateData.countElement(Name, Time);
+          for (int n = 0; n < Numbers; n++)
+          {
+            States.emplace_back(StateID(Name, Time, n));
+          }
+        }
+      }
+    }
+
+    if (!States.empty())
+    {
+      if (Marginalize_)
+      {
+        if (!Graph_.marginalizeStates(States, Inflation_))
+        {
+          PRINT_ERROR("Marginalization of ", Reduced.size(), " landmarks failed!");
+          return 0;
+        }
+      }
+      else
+      {
+        Graph_.removeStates(States);
+      }
+    }
+
+    /** a returning landmark is a new one */
+    for (const StateKey &Name : Reduced)
+    {
+      Graph_.setWindowExempt(Name, false);
+      Landmarks_.erase(Name);
+    }
+
+    return static_cast<int>(Reduced.size());
+  }
+
+  bool LandmarkManager::isActive(const StateKey &Landmark) const
+  {
+    return Landmarks_.count(Landmark) > 0;
+  }
+
+  int LandmarkManager::countActive() const
+  {
+    return static_cast<int>(Landmarks_.size());
+  }
+
+  int LandmarkManager::countObservations(const StateKey &Landmark) const
+  {
+    const auto It = Landmarks_.find(Landmark);
+    return (It != Landmarks_.end()) ? It->second.Observations : 0;
+  }
+
+  bool LandmarkManager::getLastSeen(const StateKey &Landmark, double &Time) const
+  {
+    const auto It = Landmarks_.find(Landmark);
+    if (It == Landmarks_.end())
+    {
+      return false;
+    }
+    Time = It->second.LastSeen;
+    return true;
+  }
+}
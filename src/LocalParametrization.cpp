@@ -24,5 +24,118 @@
 
 namespace libRSF
 {
+  bool AngleLocalParameterization::Plus(const double* Angle, const double* DeltaAngle, double* AnglePlusDelta) const
+  {
+    *AnglePlusDelta = NormalizeAngle(*Angle + *DeltaAngle);
+    return true;
+  }
+
+  bool AngleLocalParameterization::ComputeJacobian(const double* Angle, double* Jacobian) const
+  {
+    Jacobian[0] = 1.0;
+    return true;
+  }
+
+  bool UnitCircleLocalParameterization::Plus(const double* Circle, const double* DeltaCircle, double* CirclePlusDelta) const
+  {
+    const double Cos = cos(DeltaCircle[0]);
+    const double Sin = sin(DeltaCircle[0]);
+
+    /** real part --> cos() */
+    CirclePlusDelta[0] = Circle[0] * Cos - Circle[1] * Sin;
+
+    /** complex part --> sin() */
+    CirclePlusDelta[1] = Circle[1] * Cos + Circle[0] * Sin;
+
+    return true;
+  }
+
+  bool UnitCircleLocalParameterization::ComputeJacobian(const double* Circle, double* Jacobian) const
+  {
+    /** derivative of the rotation at zero increment */
+    Jacobian[0] = -Circle[1];
+    Jacobian[1] = Circle[0];
+    return true;
+  }
+
+  bool QuaternionLocalParameterization::Plus(const double* Quaternion, const double* Delta, double* QuaternionPlusDelta) const
+  {
+    QuaternionRefConst<double> Q(Quaternion);
+    VectorRefConst<double, 3> DeltaVec(Delta);
+    QuaternionRef<double> QPlusDelta(QuaternionPlusDelta);
+
+    const double Norm = DeltaVec.norm();
+    if (Norm > 1e-20)
+    {
+      /** using axis-angle definition */
+      QPlusDelta = AngleAxis(Norm, DeltaVec / Norm) * Q;
+    }
+    else
+    {
+      /** use linear approximation for small angles (consistent with the Jacobian) */
+      libRSF::Quaternion QuatDelta;
+      QuatDelta.x() = 0.5 * DeltaVec(0);
+      QuatDelta.y() = 0.5 * DeltaVec(1);
+      QuatDelta.z() = 0.5 * DeltaVec(2);
+      QuatDelta.w() = 1.0;
+
+      QPlusDelta = QuatDelta * Q;
+    }
+
+    return true;
+  }
+
+  bool QuaternionLocalParameterization::ComputeJacobian(const double* Quaternion, double* Jacobian) const
+  {
+    /** derivative of [0.5 * Delta, 1] * Q at zero increment, row-major 4x3 */
+    const double X = Quaternion[0];
+    const double Y = Quaternion[1];
+    const double Z = Quaternion[2];
+    const double W = Quaternion[3];
+
+    Jacobian[0] =  0.5 * W; Jacobian[1]  =  0.5 * Z; Jacobian[2]  = -0.5 * Y;
+    Jacobian[3] = -0.5 * Z; Jacobian[4]  =  0.5 * W; Jacobian[5]  =  0.5 * X;
+    Jacobian[6] =  0.5 * Y; Jacobian[7]  = -0.5 * X; Jacobian[8]  =  0.5 * W;
+    Jacobian[9] = -0.5 * X; Jacobian[10] = -0.5 * Y; Jacobian[11] = -0.5 * Z;
+
+    return true;
+  }
+
+  bool Pose2LocalParameterization::Plus(const double* Pose, const double* Delta, double* PosePlusDelta) const
+  {
+    PosePlusDelta[0] = Pose[0] + Delta[0];
+    PosePlusDelta[1] = Pose[1] + Delta[1];
+    PosePlusDelta[2] = NormalizeAngle(Pose[2] + Delta[2]);
+    return true;
+  }
+
+  bool Pose2LocalParameterization::ComputeJacobian(const double* Pose, double* Jacobian) const
+  {
+    MatrixRef<double, 3, 3> J(Jacobian);
+    J.setIdentity();
+    return true;
+  }
+
+  bool Pose3LocalParameterization::Plus(const double* Pose, const double* Delta, double* PosePlusDelta) const
+  {
+    PosePlusDelta[0] = Pose[0] + Delta[0];
+    PosePlusDelta[1] = Pose[1] + Delta[1];
+    PosePlusDelta[2] = Pose[2] + Delta[2];
+    return Rotation_.Plus(Pose + 3, Delta + 3, PosePlusDelta + 3);
+  }
+
+  bool Pose3LocalParameterization::ComputeJacobian(const double* Pose, double* Jacobian) const
+  {
+    /** block diagonal, row-major 7x6 */
+    MatrixRef<double, 7, 6> J(Jacobian);
+    J.setZero();
+    J.topLeftCorner<3, 3>().setIdentity();
+
+    MatrixStatic<4, 3> JacobianRotation;
+    Rotation_.ComputeJacobian(Pose + 3, JacobianRotation.data());
+    J.bottomRightCorner<4, 3>() = JacobianRotation;
+
+    return true;
+  }
 }
 
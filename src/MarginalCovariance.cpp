@@ -0,0 +1,341 @@
+/***************************************************************************
+ * libRSF - A Robust Sensor Fusion Library
+ *
+ * Copyright (C) 2018 Chair of Automation Technology / TU Chemnitz
+ * For more information see https://www.tu-chemnitz.de/etit/proaut/libRSF
+ *
+ * libRSF is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libRSF is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with libRSF.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Tim Pfeifer (tim.pfeifer@etit.tu-chemnitz.de)
+ ***************************************************************************/
+
+#include "MarginalCovariance.h"
+
+namespace libRSF
+{
+  bool MarginalCovariance::compute(ceres::Problem &Graph, const std::vector<const double*> &LastStates)
+  {
+    this->reset();
+
+    /** constant states have no uncertainty and are not part of the system */
+    std::vector<double*> AllStates;
+    std::vector<double*> States;
+    Graph.GetParameterBlocks(&AllStates);
+    for (double* const State : AllStates)
+    {
+      if (!Graph.IsParameterBlockConstant(State))
+      {
+        States.push_back(State);
+      }
+    }
+
+    if (States.empty())
+    {
+      PRINT_ERROR("There are no variable states for the covariance computation.");
+      return false;
+    }
+
+    /** linearize the problem */
+    ceres::Problem::EvaluateOptions Options;
+    Options.apply_loss_function = true;
+    Options.num_threads = GetThreadNumber();
+    Options.parameter_blocks = States;
+
+    ceres::CRSMatrix JacobianCRS;
+    Graph.Evaluate(Options, nullptr, nullptr, nullptr, &JacobianCRS);
+
+    SparseMatrix Jacobian;
+    CRSToSparseMatrix(JacobianCRS, Jacobian);
+
+    /** column index of each state */
+    std::vector<int> StateIndex;
+    std::vector<int> StateSize;
+    int Size = 0;
+    for (double* const State : States)
+    {
+      StateIndex.push_back(Size);
+      StateSize.push_back(Graph.ParameterBlockLocalSize(State));
+      Size += StateSize.back();
+    }
+
+    /** H = J^T * J with (at least structurally) dense diagonal blocks */
+    std::vector<Eigen::Triplet<double>> Entries;
+    for (int n = 0; n < static_cast<int>(States.size()); n++)
+    {
+      for (int Row = 0; Row < StateSize.at(n); Row++)
+      {
+        for (int Col = 0; Col < StateSize.at(n); Col++)
+        {
+          Entries.emplace_back(StateIndex.at(n) + Row, StateIndex.at(n) + Col, 0.0);
+        }
+      }
+    }
+
+    /** the last states are coupled structurally, so their joint covariance is part of the recovered pattern */
+    std::vector<int> Last;
+    for (int n = 0; n < static_cast<int>(States.size()); n++)
+    {
+      if (std::find(LastStates.begin(), LastStates.end(), States.at(n)) != LastStates.end())
+      {
+        Last.push_back(n);
+      }
+    }
+    for (const int n : Last)
+    {
+      for (const int m : Last)
+      {
+        for (int Row = 0; Row < StateSize.at(n) && n != m; Row++)
+        {
+          for (int Col = 0; Col < StateSize.at(m); Col++)
+          {
+            Entries.emplace_back(StateIndex.at(n) + Row, StateIndex.at(m) + Col, 0.0);
+          }
+        }
+      }
+    }
+
+    SparseMatrix Hessian(Size, Size);
+    Hessian.setFromTriplets(Entries.begin(), Entries.end());
+    Hessian += SparseMatrix(Jacobian.transpose()) * Jacobian;
+
+    /** fill reducing ordering */
+    Eigen::PermutationMatrix<Dynamic, Dynamic, int> OrderingInv;
+    Eigen::AMDOrdering<int> AMD;
+    AMD(Hessian, OrderingInv);
+
+    /** move the requested states to the end */
+    std::vector<bool> IsLast(Size, false);
+    for (int n = 0; n < static_cast<int>(States.size()); n++)
+    {
+      if (std::find(LastStates.begin(), LastStates.end(), States.at(n)) != LastStates.end())
+      {
+        std::fill_n(IsLast.begin() + StateIndex.at(n), StateSize.at(n), true);
+      }
+    }
+
+    std::vector<int> Order;
+    for (int k = 0; k < Size; k++)
+    {
+      if (!IsLast.at(OrderingInv.indices()(k)))
+      {
+        Order.push_back(OrderingInv.indices()(k));
+      }
+    }
+    for (int k = 0; k < Size; k++)
+    {
+      if (IsLast.at(OrderingInv.indices()(k)))
+      {
+        Order.push_back(OrderingInv.indices()(k));
+      }
+    }
+
+    Eigen::PermutationMatrix<Dynamic, Dynamic, int> Permutation(Size);
+    for (int k = 0; k < Size; k++)
+    {
+      Permutation.indices()(Order.at(k)) = k;
+    }
+
+    /** factorize the permuted system */
+    SparseMatrix HessianPermuted;
+    HessianPermuted = Hessian.twistedBy(Permutation);
+    Eigen::SimplicialLDLT<SparseMatrix, Eigen::Lower, Eigen::NaturalOrdering<int>> LDLT(HessianPermuted);
+
+    if (LDLT.info() != Eigen::Success)
+    {
+      PRINT_ERROR("Factorization of the information matrix failed.");
+      return false;
+    }
+
+    const Vector D = LDLT.vectorD();
+    const double Tolerance = std::numeric_limits<double>::epsilon() * Size * D.cwiseAbs().maxCoeff();
+    if (D.minCoeff() <= Tolerance)
+    {
+      PRINT_WARNING("Information matrix is rank-deficient.");
+      return false;
+    }
+    DInv_ = D.cwiseInverse();
+
+    /** strictly lower part of the unit triangular factor */
+    L_ = LDLT.matrixL().nestedExpression().triangularView<Eigen::StrictlyLower>();
+
+    /** the inverse is stored with the pattern of L plus the diagonal */
+    std::vector<Eigen::Triplet<double>> Pattern;
+    for (int Col = 0; Col < Size; Col++)
+    {
+      Pattern.emplace_back(Col, Col, 0.0);
+      for (SparseMatrix::InnerIterator It(L_, Col); It; ++It)
+      {
+        Pattern.emplace_back(It.row(), Col, 0.0);
+      }
+    }
+    Sigma_.resize(Size, Size);
+    Sigma_.setFromTriplets(Pattern.begin(), Pattern.end());
+    SigmaIndex_ = Size;
+
+    /** store position of the states */
+    for (int n = 0; n < static_cast<int>(States.size()); n++)
+    {
+      Blocks_.emplace(States.at(n), std::make_pair(StateIndex.at(n), StateSize.at(n)));
+    }
+    Permutation_ = Permutation;
+
+    IsValid_ = true;
+    return true;
+  }
+
+  bool MarginalCovariance::getCovarianceBlock(const ceres::Problem &Graph, const double* State, double* Covariance)
+  {
+    if (!this->hasState(State))
+    {
+      PRINT_ERROR("State is not part of the factorized system.");
+      return false;
+    }
+
+    const int Index = Blocks_.at(State).first;
+    const int LocalSize = Blocks_.at(State).second;
+    const int GlobalSize = Graph.ParameterBlockSize(State);
+
+    /** permuted indices of all dimensions */
+    std::vector<int> Indices;
+    for (int n = 0; n < LocalSize; n++)
+    {
+      Indices.push_back(Permutation_.indices()(Index + n));
+    }
+    this->recursion_(*std::min_element(Indices.begin(), Indices.end()));
+
+    /** covariance in the local parametrization */
+    Matrix CovLocal(LocalSize, LocalSize);
+    for (int Row = 0; Row < LocalSize; Row++)
+    {
+      for (int Col = 0; Col < LocalSize; Col++)
+      {
+        CovLocal(Row, Col) = this->getSigma_(Indices.at(Row), Indices.at(Col));
+      }
+    }
+
+    /** lift to the global parametrization */
+    MatrixRef<double, Dynamic, Dynamic> CovGlobal(Covariance, GlobalSize, GlobalSize);
+    const ceres::LocalParameterization* Parametrization = Graph.GetParameterization(State);
+    if (Parametrization != nullptr)
+    {
+      Matrix JacobianPlus(GlobalSize, LocalSize);
+      Parametrization->ComputeJacobian(State, JacobianPlus.data());
+      CovGlobal = JacobianPlus * CovLocal * JacobianPlus.transpose();
+    }
+    else
+    {
+      CovGlobal = CovLocal;
+    }
+
+    return true;
+  }
+
+  bool MarginalCovariance::getJointCovariance(const std::vector<const double*> &States, Matrix &Covariance)
+  {
+    /** permuted indices of all dimensions */
+    std::vector<int> Indices;
+    for (const double* const State : States)
+    {
+      if (!this->hasState(State))
+      {
+        PRINT_ERROR("State is not part of the factorized system.");
+        return false;
+      }
+
+      for (int n = 0; n < Blocks_.at(State).second; n++)
+      {
+        Indices.push_back(Permutation_.indices()(Blocks_.at(State).first + n));
+      }
+    }
+
+    if (Indices.empty())
+    {
+      return false;
+    }
+    this->recursion_(*std::min_element(Indices.begin(), Indices.end()));
+
+    const int Size = static_cast<int>(Indices.size());
+    Covariance.resize(Size, Size);
+    for (int Row = 0; Row < Size; Row++)
+    {
+      for (int Col = 0; Col < Size; Col++)
+      {
+        Covariance(Row, Col) = this->getSigma_(Indices.at(Row), Indices.at(Col));
+      }
+    }
+    return true;
+  }
+
+  bool MarginalCovariance::isValid() const
+  {
+    return IsValid_;
+  }
+
+  bool MarginalCovariance::hasState(const double* State) const
+  {
+    return IsValid_ && (Blocks_.count(State) > 0);
+  }
+
+  void MarginalCovariance::reset()
+  {
+    Blocks_.clear();
+    L_.resize(0, 0);
+    DInv_.resize(0);
+    Sigma_.resize(0, 0);
+    SigmaIndex_ = 0;
+    IsValid_ = false;
+  }
+
+  void MarginalCovariance::recursion_(const int IndexMin)
+  {
+    /**
+    Takahashi recursion, for all entries in the pattern of L:
+    Sigma_ji = -sum_k Sigma_jk * L_ki          (j > i)
+    Sigma_ii = 1/D_i - sum_k L_ki * Sigma_ki
+    */
+    std::vector<int> Rows;
+    std::vector<double> Values;
+    for (int Col = SigmaIndex_ - 1; Col >= IndexMin; Col--)
+    {
+      Rows.clear();
+      Values.clear();
+      for (SparseMatrix::InnerIterator It(L_, Col); It; ++It)
+      {
+        Rows.push_back(static_cast<int>(It.row()));
+        Values.push_back(It.value());
+      }
+
+      double Diagonal = DInv_(Col);
+      for (int j = 0; j < static_cast<int>(Rows.size()); j++)
+      {
+        double Sum = 0.0;
+        for (int k = 0; k < static_cast<int>(Rows.size()); k++)
+        {
+          Sum += this->getSigma_(Rows.at(j), Rows.at(k)) * Values.at(k);
+        }
+        Sigma_.coeffRef(Rows.at(j), Col) = -Sum;
+        Diagonal += Values.at(j) * Sum;
+      }
+      Sigma_.coeffRef(Col, Col) = Diagonal;
+    }
+
+    SigmaIndex_ = std::min(SigmaIndex_, IndexMin);
+  }
+
+  double MarginalCovariance::getSigma_(const int Row, const int Col) const
+  {
+    /** only the lower triangle is stored */
+    return (Row >= Col) ? Sigma_.coeff(Row, Col) : Sigma_.coeff(Col, Row);
+  }
+}
@@ -21,6 +21,9 @@
  ***************************************************************************/
 
 #include "Marginalization.h"
+#include "ThreadPool.h"
+
+#include <algorithm>
 
 namespace libRSF
 {
@@ -74,13 +77,20 @@ namespace libRSF
     b^* = b_R - H_RM * H_MM^-1 * b_M
     */
 
-    /** at first, invert the marginalized Hessian part */
-    Eigen::CompleteOrthogonalDecomposition<Matrix> CODHess(HessMM);
-    const Matrix HessMMInv = CODHess.pseudoInverse(); /**< pseudo-inverse for rank deficient matrices*/
+    /** large systems are solved on the GPU if possible: |H_MM^-1 * H_MR  H_MM^-1 * b_M| */
+    Matrix HessMMInvMRBM(SizeMarginal, SizeRemain + 1);
+    HessMMInvMRBM << HessMR, BM;
+    if (!SolveCholeskyGPU(HessMM, HessMMInvMRBM))
+    {
+      /** at first, invert the marginalized Hessian part */
+      Eigen::CompleteOrthogonalDecomposition<Matrix> CODHess(HessMM);
+      const Matrix HessMMInv = CODHess.pseudoInverse(); /**< pseudo-inverse for rank deficient matrices*/
+      HessMMInvMRBM = HessMMInv * HessMMInvMRBM;
+    }
 
     /** than compute the new system */
-    Matrix HessRRStar = HessRR - HessRM * HessMMInv * HessMR;
-    const Vector BRStar = BR - HessRM * HessMMInv * BM;
+    Matrix HessRRStar = HessRR - HessRM * HessMMInvMRBM.leftCols(SizeRemain);
+    const Vector BRStar = BR - HessRM * HessMMInvMRBM.col(SizeRemain);
 
     /** add a small uncertainty to prevent accumulation of error (I recommend a value of 1.01)*/
     if (HessianInflation != 1.0)
@@ -105,4 +115,338 @@ namespace libRSF
     ResidualMarg = -JacobianMargInv.transpose() * BRStar;
   }
 
+  void Marginalize(const Vector &Residual, const SparseMatrix &Jacobian,
+                   Vector &ResidualMarg, Matrix &JacobianMarg,
+                   const int SizeMarginal, const double HessianInflation)
+  {
+    /** H = J^T * J */
+    SparseMatrix Hessian = SparseMatrix(Jacobian.transpose()) * Jacobian;
+    Hessian.prune([](Index, Index, const double &Value){return std::abs(Value) > 1e-8;}); /**< remove small non-zero entries for stability */
+
+    /** b = -J^T * r */
+    const Vector B = -(Jacobian.transpose() * Residual);
+
+    MarginalizeHessian(Hessian, B, ResidualMarg, JacobianMarg, SizeMarginal, HessianInflation);
+  }
+
+  void ComputeNormalEquations(const ceres::CRSMatrix &Jacobian, const std::vector<double> &Residual,
+                              SparseMatrix &Hessian, Vector &B)
+  {
+    const Index Rows = Jacobian.num_rows;
+    const Index Cols = Jacobian.num_cols;
+
+    /** threads are only worth it for larger jacobians */
+    constexpr Index MinRowsPerThread = 256;
+    const Index Threads = std::max<Index>(1, std::min<Index>(GetThreadNumber(), Rows / MinRowsPerThread));
+    const Index Chunk = std::max<Index>(1, (Rows + Threads - 1) / Threads);
+
+    std::vector<SparseMatrix> Hessians(Threads, SparseMatrix(Cols, Cols));
+    std::vector<Vector> Bs(Threads, Vector::Zero(Cols));
+
+    const auto Worker = [&](const size_t nChunk)
+    {
+      std::vector<Eigen::Triplet<double>> Entries;
+      const Index End = std::min(Rows, static_cast<Index>(nChunk + 1) * Chunk);
+      Index First = static_cast<Index>(nChunk) * Chunk;
+      while (First < End)
+      {
+        /** consecutive rows with the same columns belong to one residual block and form a dense block J_i */
+        const int Start = Jacobian.rows[First];
+        const int Size = Jacobian.rows[First + 1] - Start;
+        Index Last = First + 1;
+        while (Last < End
+               && Jacobian.rows[Last + 1] - Jacobian.rows[Last] == Size
+               && std::equal(Jacobian.cols.begin() + Start, Jacobian.cols.begin() + Start + Size, Jacobian.cols.begin() + Jacobian.rows[Last]))
+        {
+          Last++;
+        }
+
+        /** the values of these rows are a row-major matrix */
+        const Eigen::Map<const Eigen::Matrix<double, Dynamic, Dynamic, Eigen::RowMajor>> Block(Jacobian.values.data() + Start, Last - First, Size);
+        const Eigen::Map<const Vector> Error(Residual.data() + First, Last - First);
+
+        /** H += J_i^T * J_i and b -= J_i^T * r_i */
+        const Matrix HessianBlock = Block.transpose() * Block;
+        const Vector BBlock = Block.transpose() * Error;
+        for (int Col = 0; Col < Size; Col++)
+        {
+          for (int Row = 0; Row < Size; Row++)
+          {
+            Entries.emplace_back(Jacobian.cols[Start + Row], Jacobian.cols[Start + Col], HessianBlock(Row, Col));
+          }
+          Bs.at(nChunk)(Jacobian.cols[Start + Col]) -= BBlock(Col);
+        }
+
+        First = Last;
+      }
+      Hessians.at(nChunk).setFromTriplets(Entries.begin(), Entries.end());
+    };
+
+    if (Threads == 1)
+    {
+      Worker(0);
+    }
+    else
+    {
+      GetThreadPool().parallelFor(static_cast<size_t>(Threads), Worker);
+    }
+
+    /** reduce the partial systems */
+    Hessian = std::move(Hessians.front());
+    B = std::move(Bs.front());
+    for (Index n = 1; n < Threads; n++)
+    {
+      Hessian += Hessians.at(n);
+      B += Bs.at(n);
+    }
+    Hessian.prune([](Index, Index, const double &Value){return std::abs(Value) > 1e-8;}); /**< remove small non-zero entries for stability */
+  }
+
+  void MarginalizeHessian(const SparseMatrix &Hessian, const Vector &B,
+                          Vector &ResidualMarg, Matrix &JacobianMarg,
+                          const int SizeMarginal, const double HessianInflation,
+                          const double MinEigenRatio)
+  {
+    /** calculate size of the linear system */
+    const int SizeTotal = static_cast<int>(Hessian.cols());
+    const int SizeRemain = SizeTotal - SizeMarginal;
+
+    /** select sub matrices (same layout as the dense version) */
+    const SparseMatrix HessMM = Hessian.topLeftCorner(SizeMarginal, SizeMarginal);
+    const SparseMatrix HessMR = Hessian.topRightCorner(SizeMarginal, SizeRemain);
+    Matrix HessRRStar = Matrix(Hessian.bottomRightCorner(SizeRemain, SizeRemain));
+
+    const Vector BM = B.head(SizeMarginal);
+    Vector BRStar = B.tail(SizeRemain);
+
+    /** only the remaining columns that are connected to the marginalized states are modified */
+    std::vector<Index> Connected;
+    for (Index Col = 0; Col < HessMR.outerSize(); Col++)
+    {
+      if (HessMR.outerIndexPtr()[Col + 1] > HessMR.outerIndexPtr()[Col])
+      {
+        Connected.push_back(Col);
+      }
+    }
+    const Index SizeConnected = static_cast<Index>(Connected.size());
+
+    Matrix HessMC(SizeMarginal, SizeConnected);
+    for (Index n = 0; n < SizeConnected; n++)
+    {
+      HessMC.col(n) = HessMR.col(Connected.at(n));
+    }
+
+    /** solve H_MM * X = |H_MC b_M|, a large and dense H_MM is decomposed on the GPU if possible */
+    Matrix HessMMInvMC;
+    Vector HessMMInvBM;
+    bool IsSolved = false;
+    if (SizeMarginal >= DenseGPUMinSize && 4 * HessMM.nonZeros() > static_cast<Index>(SizeMarginal) * SizeMarginal)
+    {
+      Matrix HessMMInvMCBM(SizeMarginal, SizeConnected + 1);
+      HessMMInvMCBM << HessMC, BM;
+      IsSolved = SolveCholeskyGPU(Matrix(HessMM), HessMMInvMCBM);
+      if (IsSolved)
+      {
+        HessMMInvMC = HessMMInvMCBM.leftCols(SizeConnected);
+        HessMMInvBM = HessMMInvMCBM.col(SizeConnected);
+      }
+    }
+
+    /** otherwise with a sparse decomposition */
+    if (!IsSolved)
+    {
+      Eigen::SimplicialLDLT<SparseMatrix> LDLT(HessMM);
+
+      bool IsRegular = (LDLT.info() == Eigen::Success);
+      if (IsRegular)
+      {
+        const Vector D = LDLT.vectorD();
+        const double Tolerance = std::numeric_limits<double>::epsilon() * SizeMarginal * D.cwiseAbs().maxCoeff();
+        IsRegular = (D.minCoeff() > Tolerance);
+      }
+
+      if (IsRegular)
+      {
+        HessMMInvMC = LDLT.solve(HessMC);
+        HessMMInvBM = LDLT.solve(BM);
+      }
+      else
+      {
+        /** pseudo-inverse for rank deficient matrices*/
+        Eigen::CompleteOrthogonalDecomposition<Matrix> CODHess{Matrix(HessMM)};
+        const Matrix HessMMInv = CODHess.pseudoInverse();
+        HessMMInvMC = HessMMInv * HessMC;
+        HessMMInvBM = HessMMInv * BM;
+      }
+    }
+
+    /**
+    Schur complement on the connected block:
+    H^*_CC = H_CC - H_CM * H_MM^-1 x H_MC
+    b^*_C = b_C - H_CM * H_MM^-1 * b_M
+    */
+    const Matrix SchurCC = HessMC.transpose() * HessMMInvMC;
+    const Vector SchurC = HessMC.transpose() * HessMMInvBM;
+    for (Index Col = 0; Col < SizeConnected; Col++)
+    {
+      for (Index Row = 0; Row < SizeConnected; Row++)
+      {
+        HessRRStar(Connected.at(Row), Connected.at(Col)) -= SchurCC(Row, Col);
+      }
+      BRStar(Connected.at(Col)) -= SchurC(Col);
+    }
+
+    /** add a small uncertainty to prevent accumulation of error */
+    if (HessianInflation != 1.0)
+    {
+      HessRRStar /= HessianInflation;
+    }
+
+    /**
+    New linear factor with one row per non-zero eigen value:
+    H^* = V * D * V^T
+
+    J^* = sqrt(D) * V^T
+    r^* = -sqrt(D)^-1 * V^T * b^*
+
+    Independent parts of H^* are decomposed separately to keep J^* block-sparse.
+    */
+    const std::vector<std::vector<Index>> Components = FindIndependentComponents(HessRRStar);
+    const double Tolerance = std::numeric_limits<double>::epsilon() * SizeRemain * HessRRStar.diagonal().cwiseAbs().maxCoeff();
+
+    std::vector<Vector> Rows;
+    std::vector<double> Residuals;
+    for (const std::vector<Index> &Component : Components)
+    {
+      const Index SizeComponent = static_cast<Index>(Component.size());
+
+      Matrix HessComponent(SizeComponent, SizeComponent);
+      for (Index Row = 0; Row < SizeComponent; Row++)
+      {
+        for (Index Col = 0; Col < SizeComponent; Col++)
+        {
+          HessComponent(Row, Col) = HessRRStar(Component.at(Row), Component.at(Col));
+        }
+      }
+
+      Eigen::SelfAdjointEigenSolver<Matrix> SAES(HessComponent);
+
+      /** compression: directions with less information than a fraction of the strongest one are dropped as well */
+      const double ToleranceComponent = std::max(Tolerance, MinEigenRatio * SAES.eigenvalues().maxCoeff());
+      for (Index n = 0; n < SizeComponent; n++)
+      {
+        const double EigVal = SAES.eigenvalues()(n);
+        if (EigVal > ToleranceComponent)
+        {
+          Vector Row = Vector::Zero(SizeRemain);
+          double Projection = 0.0;
+          for (Index m = 0; m < SizeComponent; m++)
+          {
+            Row(Component.at(m)) = SAES.eigenvectors()(m, n);
+            Projection += SAES.eigenvectors()(m, n) * BRStar(Component.at(m));
+          }
+
+          Rows.emplace_back(std::sqrt(EigVal) * Row);
+          Residuals.push_back(-Projection / std::sqrt(EigVal));
+        }
+      }
+    }
+
+    const Index Rank = static_cast<Index>(Rows.size());
+    JacobianMarg.resize(Rank, SizeRemain);
+    ResidualMarg.resize(Rank);
+    for (Index n = 0; n < Rank; n++)
+    {
+      JacobianMarg.row(n) = Rows.at(n).transpose();
+      ResidualMarg(n) = Residuals.at(n);
+    }
+  }
+
+  std::vector<std::vector<Index>> FindIndependentComponents(const Matrix &Hessian)
+  {
+    const Index Size = Hessian.rows();
+    std::vector<std::vector<Index>> Components;
+    std::vector<bool> Visited(Size, false);
+
+    /** depth-first search over the non-zero pattern */
+    for (Index Start = 0; Start < Size; Start++)
+    {
+      if (Visited.at(Start))
+      {
+        continue;
+      }
+
+      std::vector<Index> Component;
+      std::vector<Index> Stack = {Start};
+      Visited.at(Start) = true;
+
+      while (!Stack.empty())
+      {
+        const Index Current = Stack.back();
+        Stack.pop_back();
+        Component.push_back(Current);
+
+        for (Index Next = 0; Next < Size; Next++)
+        {
+          if (!Visited.at(Next) && Hessian(Current, Next) != 0.0)
+          {
+            Visited.at(Next) = true;
+            Stack.push_back(Next);
+          }
+        }
+      }
+
+      std::sort(Component.begin(), Component.end());
+      Components.push_back(Component);
+    }
+
+    return Components;
+  }
+
+  std::vector<std::vector<int>> SplitMarginal(const Matrix &Jacobian, const std::vector<int> &BlockSize)
+  {
+    const int BlockNumber = static_cast<int>(BlockSize.size());
+
+    /** one group per block at the beginning */
+    std::vector<int> Group(BlockNumber);
+    std::iota(Group.begin(), Group.end(), 0);
+
+    /** merge all blocks that share a row */
+    for (Index Row = 0; Row < Jacobian.rows(); Row++)
+    {
+      int First = -1;
+      int Col = 0;
+      for (int Block = 0; Block < BlockNumber; Block++)
+      {
+        if (!Jacobian.block(Row, Col, 1, BlockSize.at(Block)).isZero(0.0))
+        {
+          if (First < 0)
+          {
+            First = Group.at(Block);
+          }
+          else
+          {
+            const int Old = Group.at(Block);
+            std::replace(Group.begin(), Group.end(), Old, First);
+          }
+        }
+        Col += BlockSize.at(Block);
+      }
+    }
+
+    /** collect block indices per group in original order */
+    std::vector<std::vector<int>> Groups;
+    std::vector<int> GroupIndex(BlockNumber, -1);
+    for (int Block = 0; Block < BlockNumber; Block++)
+    {
+      if (GroupIndex.at(Group.at(Block)) < 0)
+      {
+        GroupIndex.at(Group.at(Block)) = static_cast<int>(Groups.size());
+        Groups.emplace_back();
+      }
+      Groups.at(GroupIndex.at(Group.at(Block))).push_back(Block);
+    }
+
+    return Groups;
+  }
 }
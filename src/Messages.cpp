@@ -22,10 +22,128 @@
 
 #include "Messages.h"
 
+#include <condition_variable>
+#include <cstdlib>
+#include <deque>
+#include <mutex>
+#include <thread>
+
 namespace libRSF
 {
-  void PrintVariadic()
+  namespace
+  {
+    /** single consumer queue that writes to std::cout */
+    class LogSink
+    {
+      public:
+        void write(std::string &&Line)
+        {
+          {
+            std::unique_lock<std::mutex> Lock(Mutex_);
+            if (Active_)
+            {
+              Queue_.push_back(std::move(Line));
+              Lock.unlock();
+              Condition_.notify_one();
+              return;
+            }
+          }
+          std::cout << Line << std::endl;
+        }
+
+        void setAsync(const bool Enable)
+        {
+          const std::lock_guard<std::mutex> Guard(Control_);
+          if (Enable && !Worker_.joinable())
+          {
+            const std::lock_guard<std::mutex> Lock(Mutex_);
+            Active_ = true;
+            Worker_ = std::thread(&LogSink::run_, this);
+          }
+          else if (!Enable && Worker_.joinable())
+          {
+            {
+              const std::lock_guard<std::mutex> Lock(Mutex_);
+              Active_ = false;
+            }
+            Condition_.notify_one();
+            Worker_.join();
+          }
+        }
+
+        void flush()
+        {
+          std::unique_lock<std::mutex> Lock(Mutex_);
+          Idle_.wait(Lock, [this]{ return Queue_.empty() && !Writing_; });
+        }
+
+      private:
+        void run_()
+        {
+          std::unique_lock<std::mutex> Lock(Mutex_);
+          while (true)
+          {
+            Condition_.wait(Lock, [this]{ return !Active_ || !Queue_.empty(); });
+            if (Queue_.empty())
+            {
+              break;
+            }
+
+            /** write without holding the lock, producers are never blocked by the console */
+            std::deque<std::string> Lines;
+            Lines.swap(Queue_);
+            Writing_ = true;
+            Lock.unlock();
+            for (const std::string &Line : Lines)
+            {
+              std::cout << Line << '\n';
+            }
+            std::cout.flush();
+            Lock.lock();
+            Writing_ = false;
+            Idle_.notify_all();
+          }
+        }
+
+        std::mutex Control_;
+        std::mutex Mutex_;
+        std::condition_variable Condition_;
+        std::condition_variable Idle_;
+        std::deque<std::string> Queue_;
+        std::thread Worker_;
+        bool Active_ = false;
+        bool Writing_ = false;
+    };
+
+    /** never destroyed, so messages from static destructors are still valid */
+    LogSink& GetLogSink()
+    {
+      static LogSink* const Sink = new LogSink;
+      return *Sink;
+    }
+
+    void StopLogSink()
+    {
+      GetLogSink().setAsync(false);
+    }
+  }
+
+  void SetLogAsync(const bool Enable)
+  {
+    /** remaining lines are written when the program exits */
+    static const bool IsRegistered = (std::atexit(StopLogSink) == 0);
+    static_cast<void>(IsRegistered);
+
+    GetLogSink().setAsync(Enable);
+  }
+
+  void FlushLog()
+  {
+    GetLogSink().flush();
+  }
+
+  void WriteLogLine(std::string &&Line)
   {
-    std::cout << std::endl;
+    GetLogSink().write(std::move(Line));
   }
 }
@@ -0,0 +1,419 @@
+/***************************************************************************
+ * libRSF - A Robust Sensor Fusion Library
+ *
+ * Copyright (C) 2018 Chair of Automation Technology / TU Chemnitz
+ * For more information see https://www.tu-chemnitz.de/etit/proaut/libRSF
+ *
+ * libRSF is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libRSF is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with libRSF.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Tim Pfeifer (tim.pfeifer@etit.tu-chemnitz.de)
+ ***************************************************************************/
+
+/**
+ * @file Metrics.cpp
+ * @author Tim Pfeifer
+ * @date 14.10.2026
+ * @brief Lock-free latency histograms and counters for the monitoring of online estimators.
+ * @copyright GNU Public License.
+ *
+ */
+
+#include "Metrics.h"
+#include "Messages.h"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <limits>
+#include <sstream>
+
+namespace libRSF
+{
+  /** bucket bounds of the exposition, 1-2.5-5 steps are the Prometheus convention */
+  static constexpr std::array<double, 22> ExpositionBounds = {1e-5, 2.5e-5, 5e-5,
+                                                             1e-4, 2.5e-4, 5e-4,
+                                                             1e-3, 2.5e-3, 5e-3,
+                                                             1e-2, 2.5e-2, 5e-2,
+                                                             1e-1, 2.5e-1, 5e-1,
+                                                             1.0, 2.5, 5.0,
+                                                             10.0, 25.0, 50.0,
+                                                             100.0};
+
+  size_t LatencyHistogram::getIndex_(const uint64_t Nanoseconds)
+  {
+    /** small values are stored exactly */
+    if (Nanoseconds < SubBuckets_)
+    {
+      return static_cast<size_t>(Nanoseconds);
+    }
+
+    const int Exponent = 63 - __builtin_clzll(Nanoseconds);
+    if (Exponent > MaxExponent_)
+    {
+      return BucketNumber_ - 1;
+    }
+
+    /** the leading bit is implicit, the following bits select the sub-bucket */
+    const int Shift = Exponent - SubBucketBits_;
+    const uint64_t SubBucket = (Nanoseconds >> Shift) & (SubBuckets_ - 1);
+    return static_cast<size_t>(SubBuckets_ + static_cast<uint64_t>(Shift) * SubBuckets_ + SubBucket);
+  }
+
+  uint64_t LatencyHistogram::getUpperBound_(const size_t Index)
+  {
+    if (Index < SubBuckets_)
+    {
+      return Index + 1;
+    }
+    if (Index == BucketNumber_ - 1)
+    {
+      return std::numeric_limits<uint64_t>::max();
+    }
+
+    const uint64_t Shift = (Index - SubBuckets_) / SubBuckets_;
+    const uint64_t SubBucket = (Index - SubBuckets_) % SubBuckets_;
+    return (SubBuckets_ + SubBucket + 1) << Shift;
+  }
+
+  void LatencyHistogram::record(const double Seconds)
+  {
+    const double Nanoseconds = std::max(0.0, Seconds * 1e9);
+    const uint64_t Value = (Nanoseconds < 1.8e19) ? static_cast<uint64_t>(Nanoseconds) : std::numeric_limits<uint64_t>::max();
+
+    Buckets_[getIndex_(Value)].fetch_add(1, std::memory_order_relaxed);
+    SumNanoseconds_.fetch_add(Value, std::memory_order_relaxed);
+  }
+
+  uint64_t LatencyHistogram::getCount() const
+  {
+    /** the sum of all buckets is consistent with the bucket counts, a separate counter would not be */
+    uint64_t Count = 0;
+    for (const std::atomic<uint64_t> &Bucket : Buckets_)
+    {
+      Count += Bucket.load(std::memory_order_relaxed);
+    }
+    return Count;
+  }
+
+  double LatencyHistogram::getSum() const
+  {
+    return static_cast<double>(SumNanoseconds_.load(std::memory_order_relaxed)) / 1e9;
+  }
+
+  double LatencyHistogram::getQuantile(const double Quantile) const
+  {
+    const uint64_t Count = this->getCount();
+    if (Count == 0)
+    {
+      return 0.0;
+    }
+
+    const uint64_t Rank = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(std::clamp(Quantile, 0.0, 1.0) * static_cast<double>(Count))));
+    uint64_t Cumulative = 0;
+    for (size_t n = 0; n < BucketNumber_ - 1; ++n)
+    {
+      Cumulative += Buckets_[n].load(std::memory_order_relaxed);
+      if (Cumulative >= Rank)
+      {
+        return static_cast<double>(getUpperBound_(n)) / 1e9;
+      }
+    }
+    return static_cast<double>(uint64_t(1) << (MaxExponent_ + 1)) / 1e9;
+  }
+
+  uint64_t LatencyHistogram::countBelow(const double Seconds) const
+  {
+    /** a bucket is counted only if all of its values are below the bound */
+    const double Bound = Seconds * 1e9 + 1.0;
+    uint64_t Count = 0;
+    for (size_t n = 0; n < BucketNumber_; ++n)
+    {
+      if (static_cast<double>(getUpperBound_(n)) > Bound)
+      {
+        break;
+      }
+      Count += Buckets_[n].load(std::memory_order_relaxed);
+    }
+    return Count;
+  }
+
+  LatencyHistogram &MetricsRegistry::getHistogram(const std::string &Name, const std::string &Help)
+  {
+    std::lock_guard<std::mutex> Lock(Mutex_);
+    auto &Current = Histograms_[Name];
+    if (!Current.Metric)
+    {
+      Current.Help = Help;
+      Current.Metric = std::make_unique<LatencyHistogram>();
+    }
+    return *Current.Metric;
+  }
+
+  MetricsCounter &MetricsRegistry::getCounter(const std::string &Name, const std::string &Help)
+  {
+    std::lock_guard<std::mutex> Lock(Mutex_);
+    auto &Current = Counters_[Name];
+    if (!Current.Metric)
+    {
+      Current.Help = Help;
+      Current.Metric = std::make_unique<MetricsCounter>();
+    }
+    return *Current.Metric;
+  }
+
+  MetricsGauge &MetricsRegistry::getGauge(const std::string &Name, const std::string &Help)
+  {
+    std::lock_guard<std::mutex> Lock(Mutex_);
+    auto &Current = Gauges_[Name];
+    if (!Current.Metric)
+    {
+      Current.Help = Help;
+      Current.Metric = std::make_unique<MetricsGauge>();
+    }
+    return *Current.Metric;
+  }
+
+  std::string MetricsRegistry::getExposition() const
+  {
+    std::lock_guard<std::mutex> Lock(Mutex_);
+
+    std::ostringstream Out;
+    Out.precision(9);
+
+    for (const auto &Histogram : Histograms_)
+    {
+      const LatencyHistogram &Metric = *Histogram.second.Metric;
+      Out << "# HELP " << Histogram.first << ' ' << Histogram.second.Help << '\n';
+      Out << "# TYPE " << Histogram.first << " histogram\n";
+      for (const double Bound : ExpositionBounds)
+      {
+        Out << Histogram.first << "_bucket{le=\"" << Bound << "\"} " << Metric.countBelow(Bound) << '\n';
+      }
+      const uint64_t Count = Metric.getCount();
+      Out << Histogram.first << "_bucket{le=\"+Inf\"} " << Count << '\n';
+      Out << Histogram.first << "_sum " << Metric.getSum() << '\n';
+      Out << Histogram.first << "_count " << Count << '\n';
+    }
+
+    for (const auto &Counter : Counters_)
+    {
+      Out << "# HELP " << Counter.first << ' ' << Counter.second.Help << '\n';
+      Out << "# TYPE " << Counter.first << " counter\n";
+      Out << Counter.first << ' ' << Counter.second.Metric->get() << '\n';
+    }
+
+    for (const auto &Gauge : Gauges_)
+    {
+      Out << "# HELP " << Gauge.first << ' ' << Gauge.second.Help << '\n';
+      Out << "# TYPE " << Gauge.first << " gauge\n";
+      Out << Gauge.first << ' ' << Gauge.second.Metric->get() << '\n';
+    }
+
+    return Out.str();
+  }
+
+  bool MetricsRegistry::writeToFile(const std::string &Filename) const
+  {
+    /** the collector must never see a partial file */
+    const std::string Temporary = Filename + ".tmp";
+    {
+      std::ofstream File(Temporary, std::ios::trunc);
+      if (!File.is_open())
+      {
+        PRINT_ERROR("Could not open metrics file: ", Temporary);
+        return false;
+      }
+      File << this->getExposition();
+      if (!File.good())
+      {
+        PRINT_ERROR("Could not write metrics file: ", Temporary);
+        return false;
+      }
+    }
+
+    if (std::rename(Temporary.c_str(), Filename.c_str()) != 0)
+    {
+      PRINT_ERROR("Could not replace metrics file: ", Filename);
+      return false;
+    }
+    return true;
+  }
+
+  MetricsRegistry &GetMetricsRegistry()
+  {
+    static MetricsRegistry Registry;
+    return Registry;
+  }
+
+  MetricsServer::MetricsServer(MetricsRegistry &Registry) : Registry_(Registry)
+  {
+  }
+
+  MetricsServer::~MetricsServer()
+  {
+    this->stop();
+  }
+
+  bool MetricsServer::start(const int Port)
+  {
+    if (Running_)
+    {
+      PRINT_WARNING("Metrics server is already running!");
+      return false;
+    }
+
+    Socket_ = ::socket(AF_INET, SOCK_STREAM, 0);
+    if (Socket_ < 0)
+    {
+      PRINT_ERROR("Could not create the socket of the metrics server!");
+      return false;
+    }
+
+    /** a restarted process may bind again immediately */
+    const int Enable = 1;
+    ::setsockopt(Socket_, SOL_SOCKET, SO_REUSEADDR, &Enable, sizeof(Enable));
+
+    sockaddr_in Address{};
+    Address.sin_family = AF_INET;
+    Address.sin_addr.s_addr = htonl(INADDR_ANY);
+    Address.sin_port = htons(static_cast<uint16_t>(Port));
+    if (::bind(Socket_, reinterpret_cast<sockaddr*>(&Address), sizeof(Address)) != 0 || ::listen(Socket_, 8) != 0)
+    {
+      PRINT_ERROR("Metrics server could not listen on port ", Port);
+      ::close(Socket_);
+      Socket_ = -1;
+      return false;
+    }
+
+    Running_ = true;
+    Thread_ = std::thread(&MetricsServer::serve_, this);
+    return true;
+  }
+
+  void MetricsServer::stop()
+  {
+    Running_ = false;
+    if (Thread_.joinable())
+    {
+      Thread_.join();
+    }
+    if (Socket_ >= 0)
+    {
+      ::close(Socket_);
+      Socket_ = -1;
+    }
+  }
+
+  bool MetricsServer::isRunning() const
+  {
+    return Running_;
+  }
+
+  void MetricsServer::serve_()
+  {
+    while (Running_)
+    {
+      /** wake up regularly to check for the stop request */
+      pollfd Listening{Socket_, POLLIN, 0};
+      if (::poll(&Listening, 1, 200) <= 0 || (Listening.revents & POLLIN) == 0)
+      {
+        continue;
+      }
+
+      const int Connection = ::accept(Socket_, nullptr, nullptr);
+      if (Connection < 0)
+      {
+        continue;
+      }
+      this->answer_(Connection);
+      ::close(Connection);
+    }
+  }
+
+  void MetricsServer::answer_(const int Connection) const
+  {
+    /** slow clients must not block the server */
+    timeval Timeout{1, 0};
+    ::setsockopt(Connection, SOL_SOCKET, SO_RCVTIMEO, &Timeout, sizeof(Timeout));
+
+    /** only the request line is relevant */
+    std::string Request;
+    char Buffer[1024];
+    while (Request.size() < 4096 && Request.find("\r\n\r\n") == std::string::npos)
+    {
+      const ssize_t Received = ::recv(Connection, Buffer, sizeof(Buffer), 0);
+      if (Received <= 0)
+      {
+        break;
+      }
+      Request.append(Buffer, static_cast<size_t>(Received));
+    }
+
+    const bool IsMetrics = (Request.rfind("GET /metrics ", 0) == 0 || Request.rfind("GET / ", 0) == 0);
+    const std::string Body = IsMetrics ? Registry_.getExposition() : std::string("not found\n");
+
+    std::ostringstream Response;
+    Response << (IsMetrics ? "HTTP/1.1 200 OK\r\n" : "HTTP/1.1 404 Not Found\r\n")
+             << "Content-Type: text/plain; version=0.0.4; charset=utf-8\r\n"
+             << "Content-Length: " << Body.size() << "\r\n"
+             << "Connection: close\r\n\r\n"
+             << Body;
+    const std::string Message = Response.str();
+
+    size_t Sent = 0;
+    while (Sent < Message.size())
+    {
+      const ssize_t Result = ::send(Connection, Message.data() + Sent, Message.size() - Sent, MSG_NOSIGNAL);
+      if (Result <= 0)
+      {
+        break;
+      }
+      Sent += static_cast<size_t>(Result);
+    }
+  }
+
+  GraphMetrics::GraphMetrics(MetricsRegistry &Registry)
+      : Solver(Registry.getHistogram("librsf_solver_duration_seconds", "Duration of one solve.")),
+        Marginalization(Registry.getHistogram("librsf_marginalization_duration_seconds", "Duration of one marginalization.")),
+        Covariance(Registry.getHistogram("librsf_covariance_duration_seconds", "Duration of one covariance estimation.")),
+        Adaptive(Registry.getHistogram("librsf_adaptive_duration_seconds", "Duration of the error model adaptation per epoch.")),
+        Epoch(Registry.getHistogram("librsf_epoch_duration_seconds", "Total processing time of one epoch.")),
+        Solves(Registry.getCounter("librsf_solves_total", "Number of solves.")),
+        Iterations(Registry.getCounter("librsf_solver_iterations_total", "Number of solver iterations.")),
+        DeadlineMisses(Registry.getCounter("librsf_deadline_misses_total", "Number of solves that missed their deadline.")),
+        States(Registry.getGauge("librsf_graph_states", "Number of states after the last solve.")),
+        Factors(Registry.getGauge("librsf_graph_factors", "Number of factors after the last solve."))
+  {
+  }
+
+  void GraphMetrics::recordEpoch(const Data &Summary)
+  {
+    if (Summary.checkElement(DataElement::DurationAdaptive))
+    {
+      Adaptive.record(Summary.getValue(DataElement::DurationAdaptive)(0));
+    }
+    if (Summary.checkElement(DataElement::DurationTotal))
+    {
+      Epoch.record(Summary.getValue(DataElement::DurationTotal)(0));
+    }
+  }
+}
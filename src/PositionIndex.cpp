@@ -0,0 +1,228 @@
+/***************************************************************************
+ * libRSF - A Robust Sensor Fusion Library
+ *
+ * Copyright (C) 2018 Chair of Automation Technology / TU Chemnitz
+ * For more information see https://www.tu-chemnitz.de/etit/proaut/libRSF
+ *
+ * libRSF is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libRSF is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with libRSF.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Tim Pfeifer (tim.pfeifer@etit.tu-chemnitz.de)
+ ***************************************************************************/
+
+#include "PositionIndex.h"
+#include "Messages.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <utility>
+
+namespace libRSF
+{
+  PositionIndex::PositionIndex(const int Dim): Dim_(Dim)
+  {
+    if (Dim_ < 1)
+    {
+      PRINT_ERROR("The dimension of the index has to be positive, but it is ", Dim_);
+      Dim_ = 1;
+    }
+  }
+
+  size_t PositionIndex::size() const
+  {
+    return Timestamps_.size();
+  }
+
+  int PositionIndex::getDim() const
+  {
+    return Dim_;
+  }
+
+  void PositionIndex::clear()
+  {
+    Root_ = -1;
+    Points_.clear();
+    Timestamps_.clear();
+    Nodes_.clear();
+  }
+
+  VectorRefConst<double, Dynamic> PositionIndex::getPoint_(const int Index) const
+  {
+    return VectorRefConst<double, Dynamic>(Points_.data() + static_cast<size_t>(Index) * Dim_, Dim_);
+  }
+
+  double PositionIndex::squaredDistance_(const int Index, const Vector &Position) const
+  {
+    return (this->getPoint_(Index) - Position).squaredNorm();
+  }
+
+  void PositionIndex::insert(const Vector &Position, const double Timestamp)
+  {
+    if (Position.size() != Dim_)
+    {
+      PRINT_ERROR("Wrong dimension of the position: ", Position.size(), " instead of ", Dim_);
+      return;
+    }
+
+    const int Index = static_cast<int>(Timestamps_.size());
+    Points_.insert(Points_.end(), Position.data(), Position.data() + Dim_);
+    Timestamps_.push_back(Timestamp);
+    Nodes_.emplace_back();
+
+    if (Root_ < 0)
+    {
+      Root_ = Index;
+      return;
+    }
+
+    /** descend to a free leaf */
+    int Current = Root_;
+    int Depth = 1;
+    while (true)
+    {
+      Node &Parent = Nodes_.at(Current);
+      int &Child = (Position(Parent.Axis) < Points_.at(static_cast<size_t>(Current) * Dim_ + Parent.Axis)) ? Parent.Left : Parent.Right;
+      if (Child < 0)
+      {
+        Child = Index;
+        Nodes_.at(Index).Axis = (Parent.Axis + 1) % Dim_;
+        break;
+      }
+      Current = Child;
+      Depth++;
+    }
+
+    /** a degenerated tree is rebuilt balanced */
+    if (Depth > 2 * static_cast<int>(std::log2(static_cast<double>(Index + 1))) + 4)
+    {
+      this->rebuild_();
+    }
+  }
+
+  void PositionIndex::rebuild_()
+  {
+    std::vector<int> Indices(Timestamps_.size());
+    std::iota(Indices.begin(), Indices.end(), 0);
+    for (Node &Current : Nodes_)
+    {
+      Current = Node();
+    }
+    Root_ = this->build_(Indices, 0, static_cast<int>(Indices.size()), 0);
+  }
+
+  int PositionIndex::build_(std::vector<int> &Indices, const int Begin, const int End, const int Depth)
+  {
+    if (Begin >= End)
+    {
+      return -1;
+    }
+
+    const int Axis = Depth % Dim_;
+    const int Median = Begin + (End - Begin) / 2;
+    std::nth_element(Indices.begin() + Begin, Indices.begin() + Median, Indices.begin() + End, [&](const int A, const int B)
+    {
+      return Points_.at(static_cast<size_t>(A) * Dim_ + Axis) < Points_.at(static_cast<size_t>(B) * Dim_ + Axis);
+    });
+
+    /** equal values may lie on both sides, the queries search both sides of the split anyway */
+    const int Index = Indices.at(Median);
+    Nodes_.at(Index).Axis = Axis;
+    Nodes_.at(Index).Left = this->build_(Indices, Begin, Median, Depth + 1);
+    Nodes_.at(Index).Right = this->build_(Indices, Median + 1, End, Depth + 1);
+    return Index;
+  }
+
+  void PositionIndex::queryRadius(const Vector &Position, const double Radius, const double Timestamp, const double Exclusion,
+                                  std::vector<double> &Timestamps) const
+  {
+    Timestamps.clear();
+    if (Root_ < 0 || Position.size() != Dim_)
+    {
+      return;
+    }
+
+    const double SquaredRadius = Radius * Radius;
+    std::vector<int> Stack = {Root_};
+    while (!Stack.empty())
+    {
+      const int Current = Stack.back();
+      Stack.pop_back();
+
+      if (std::abs(Timestamps_.at(Current) - Timestamp) >= Exclusion && this->squaredDistance_(Current, Position) <= SquaredRadius)
+      {
+        Timestamps.push_back(Timestamps_.at(Current));
+      }
+
+      const Node &Split = Nodes_.at(Current);
+      const double Diff = Position(Split.Axis) - Points_.at(static_cast<size_t>(Current) * Dim_ + Split.Axis);
+      const int Near = Diff < 0 ? Split.Left : Split.Right;
+      const int Far = Diff < 0 ? Split.Right : Split.Left;
+      if (Far >= 0 && Diff * Diff <= SquaredRadius)
+      {
+        Stack.push_back(Far);
+      }
+      if (Near >= 0)
+      {
+        Stack.push_back(Near);
+      }
+    }
+  }
+
+  bool PositionIndex::queryNearest(const Vector &Position, const double Radius, const double Timestamp, const double Exclusion,
+                                   double &Found) const
+  {
+    if (Root_ < 0 || Position.size() != Dim_)
+    {
+      return false;
+    }
+
+    double BestDistance = Radius * Radius;
+    bool Success = false;
+
+    /** the near side is searched first to shrink the radius early, the far side keeps the distance to the split as bound */
+    std::vector<std::pair<int, double>> Stack = {{Root_, 0.0}};
+    while (!Stack.empty())
+    {
+      const auto [Current, Bound] = Stack.back();
+      Stack.pop_back();
+      if (Bound > BestDistance)
+      {
+        continue;
+      }
+
+      const double Distance = this->squaredDistance_(Current, Position);
+      if (std::abs(Timestamps_.at(Current) - Timestamp) >= Exclusion && Distance <= BestDistance)
+      {
+        BestDistance = Distance;
+        Found = Timestamps_.at(Current);
+        Success = true;
+      }
+
+      const Node &Split = Nodes_.at(Current);
+      const double Diff = Position(Split.Axis) - Points_.at(static_cast<size_t>(Current) * Dim_ + Split.Axis);
+      const int Near = Diff < 0 ? Split.Left : Split.Right;
+      const int Far = Diff < 0 ? Split.Right : Split.Left;
+      if (Far >= 0 && Diff * Diff <= BestDistance)
+      {
+        Stack.emplace_back(Far, Diff * Diff);
+      }
+      if (Near >= 0)
+      {
+        Stack.emplace_back(Near, Bound);
+      }
+    }
+
+    return Success;
+  }
+}
@@ -0,0 +1,277 @@
+/***************************************************************************
+ * libRSF - A Robust Sensor Fusion Library
+ *
+ * Copyright (C) 2018 Chair of Automation Technology / TU Chemnitz
+ * For more information see https://www.tu-chemnitz.de/etit/proaut/libRSF
+ *
+ * libRSF is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libRSF is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with libRSF.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Tim Pfeifer (tim.pfeifer@etit.tu-chemnitz.de)
+ ***************************************************************************/
+
+#include "RealTime.h"
+#include "AllocationTracking.h"
+#include "Messages.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <mutex>
+
+#ifdef __linux__
+#include <alloca.h>
+#include <malloc.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <unistd.h>
+#endif
+
+namespace libRSF
+{
+  namespace
+  {
+    std::mutex GlobalMutex;
+    RealTimeConfig GlobalConfig;
+    bool IsEntered = false;
+    bool EnterResult = true;
+
+    size_t GetPageSize()
+    {
+#ifdef __linux__
+      return static_cast<size_t>(sysconf(_SC_PAGESIZE));
+#else
+      return 4096;
+#endif
+    }
+
+    /** touch every page of the range, optionally after advising huge pages */
+    void PrefaultRange(void *Memory, const size_t Bytes, const bool HugePages)
+    {
+      if (Memory == nullptr || Bytes == 0)
+      {
+        return;
+      }
+      const size_t PageSize = GetPageSize();
+
+#ifdef __linux__
+      /** only the complete pages inside the range can be advised */
+      if (HugePages)
+      {
+        const auto Begin = (reinterpret_cast<std::uintptr_t>(Memory) + PageSize - 1) / PageSize * PageSize;
+        const auto End = (reinterpret_cast<std::uintptr_t>(Memory) + Bytes) / PageSize * PageSize;
+        if (End > Begin)
+        {
+          madvise(reinterpret_cast<void *>(Begin), End - Begin, MADV_HUGEPAGE);
+        }
+      }
+#endif
+
+      /** read and write back one byte per page, so the content is kept */
+      auto *Bytewise = static_cast<volatile unsigned char *>(Memory);
+      for (size_t n = 0; n < Bytes; n += PageSize)
+      {
+        Bytewise[n] = Bytewise[n];
+      }
+      Bytewise[Bytes - 1] = Bytewise[Bytes - 1];
+    }
+
+#ifdef __linux__
+    /** grow the stack of the calling thread, so later calls do not fault */
+    void PrefaultStack(const size_t Bytes)
+    {
+      auto *Stack = static_cast<volatile unsigned char *>(alloca(Bytes));
+      for (size_t n = 0; n < Bytes; n += GetPageSize())
+      {
+        Stack[n] = 0;
+      }
+    }
+
+    /** the touched heap stays with the allocator, because it is neither trimmed nor mapped separately */
+    bool PrefaultHeap(const size_t Bytes, const bool HugePages)
+    {
+#ifdef __GLIBC__
+      mallopt(M_TRIM_THRESHOLD, -1);
+      mallopt(M_MMAP_MAX, 0);
+#endif
+      if (Bytes == 0)
+      {
+        return true;
+      }
+
+      void *Heap = std::malloc(Bytes);
+      if (Heap == nullptr)
+      {
+        PRINT_WARNING("Could not prefault ", Bytes, " bytes of heap!");
+        return false;
+      }
+      PrefaultRange(Heap, Bytes, HugePages);
+      std::free(Heap);
+      return true;
+    }
+#endif
+  }
+
+  bool SetRealTimeConfig(const RealTimeConfig &Config)
+  {
+    std::lock_guard<std::mutex> Lock(GlobalMutex);
+    if (IsEntered)
+    {
+      PRINT_WARNING("The real-time mode is already entered, the new config is ignored.");
+      return false;
+    }
+    GlobalConfig = Config;
+    return true;
+  }
+
+  RealTimeConfig GetRealTimeConfig()
+  {
+    std::lock_guard<std::mutex> Lock(GlobalMutex);
+    return GlobalConfig;
+  }
+
+  bool IsRealTimeActive()
+  {
+    std::lock_guard<std::mutex> Lock(GlobalMutex);
+    return GlobalConfig.IsActive;
+  }
+
+  bool EnterRealTime()
+  {
+    std::lock_guard<std::mutex> Lock(GlobalMutex);
+    if (IsEntered || !GlobalConfig.IsActive)
+    {
+      return EnterResult;
+    }
+    IsEntered = true;
+
+#ifdef __linux__
+    /** future pages are locked as well, so the heap is resident once it is touched */
+    if (GlobalConfig.LockMemory && mlockall(MCL_CURRENT | MCL_FUTURE) != 0)
+    {
+      PRINT_WARNING("Could not lock the memory, this requires CAP_IPC_LOCK or a sufficient memlock limit!");
+      EnterResult = false;
+    }
+
+    EnterResult = PrefaultHeap(GlobalConfig.PrefaultHeap, GlobalConfig.HugePages) && EnterResult;
+    PrefaultStack(GlobalConfig.PrefaultStack);
+#else
+    PRINT_WARNING("The real-time mode is only supported on Linux!");
+    EnterResult = false;
+#endif
+
+    return EnterResult;
+  }
+
+  bool ApplyRealTimeThread(const RealTimeThread Role)
+  {
+    const RealTimeConfig Config = GetRealTimeConfig();
+    if (!Config.IsActive)
+    {
+      return true;
+    }
+    const RealTimeThreadConfig &Thread = (Role == RealTimeThread::Solver) ? Config.Solver : Config.Ingestion;
+
+    bool Success = true;
+#ifdef __linux__
+    if (Thread.Core >= 0)
+    {
+      cpu_set_t Set;
+      CPU_ZERO(&Set);
+      CPU_SET(Thread.Core, &Set);
+      if (pthread_setaffinity_np(pthread_self(), sizeof(Set), &Set) != 0)
+      {
+        PRINT_WARNING("Could not pin thread to core ", Thread.Core);
+        Success = false;
+      }
+    }
+
+    if (Thread.Priority > 0)
+    {
+      sched_param Parameter{};
+      Parameter.sched_priority = std::clamp(Thread.Priority, sched_get_priority_min(SCHED_FIFO), sched_get_priority_max(SCHED_FIFO));
+      if (pthread_setschedparam(pthread_self(), SCHED_FIFO, &Parameter) != 0)
+      {
+        PRINT_WARNING("Could not set SCHED_FIFO priority ", Parameter.sched_priority, ", this requires CAP_SYS_NICE or a sufficient rtprio limit!");
+        Success = false;
+      }
+    }
+#else
+    if (Thread.Core >= 0 || Thread.Priority > 0)
+    {
+      PRINT_WARNING("Real-time threads are only supported on Linux!");
+      Success = false;
+    }
+#endif
+
+    return Success;
+  }
+
+  void PrefaultMemory(void *Memory, const size_t Bytes)
+  {
+    PrefaultRange(Memory, Bytes, GetRealTimeConfig().HugePages);
+  }
+
+  std::uint64_t GetPageFaultCount()
+  {
+#ifdef __linux__
+    rusage Usage{};
+    if (getrusage(RUSAGE_THREAD, &Usage) == 0)
+    {
+      return static_cast<std::uint64_t>(Usage.ru_minflt) + static_cast<std::uint64_t>(Usage.ru_majflt);
+    }
+#endif
+    return 0;
+  }
+
+  SteadyStateMonitor::SteadyStateMonitor(const int WarmUpEpochs) : WarmUpEpochs_(std::max(0, WarmUpEpochs))
+  {}
+
+  void SteadyStateMonitor::beginEpoch()
+  {
+    FaultsBegin_ = GetPageFaultCount();
+    AllocationsBegin_ = GetAllocationCount();
+  }
+
+  bool SteadyStateMonitor::endEpoch()
+  {
+    const std::uint64_t Faults = GetPageFaultCount() - FaultsBegin_;
+    const std::uint64_t Allocations = GetAllocationCount() - AllocationsBegin_;
+
+    Epochs_++;
+    if (Epochs_ <= WarmUpEpochs_)
+    {
+      MaxWarmUpAllocations_ = std::max(MaxWarmUpAllocations_, Allocations);
+      return true;
+    }
+
+    if (Faults == 0 && Allocations <= MaxWarmUpAllocations_)
+    {
+      return true;
+    }
+
+    if (Violations_ == 0)
+    {
+      PRINT_WARNING("Epoch ", Epochs_, " is not in a steady state: ", Faults, " page faults and ",
+                    Allocations, " allocations (", MaxWarmUpAllocations_, " during the warm-up)!");
+    }
+    Violations_++;
+    return false;
+  }
+
+  int SteadyStateMonitor::countViolations() const
+  {
+    return Violations_;
+  }
+}
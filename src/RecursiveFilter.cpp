@@ -0,0 +1,86 @@
+/***************************************************************************
+ * libRSF - A Robust Sensor Fusion Library
+ *
+ * Copyright (C) 2018 Chair of Automation Technology / TU Chemnitz
+ * For more information see https://www.tu-chemnitz.de/etit/proaut/libRSF
+ *
+ * libRSF is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libRSF is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with libRSF.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Tim Pfeifer (tim.pfeifer@etit.tu-chemnitz.de)
+ ***************************************************************************/
+
+#include "RecursiveFilter.h"
+
+namespace libRSF
+{
+  RecursiveFilter::RecursiveFilter(FactorGraph &Graph, const bool EstimateCov):
+      Graph_(Graph), EstimateCov_(EstimateCov)
+  {}
+
+  RecursiveFilter::RecursiveFilter(FactorGraph &Graph, const FactorGraphConfig &Config):
+      RecursiveFilter(Graph, Config.Solution.EstimateCov)
+  {}
+
+  bool RecursiveFilter::step(const double CurrentTime, const ceres::Solver::Options &Options, const Deadline &Limit)
+  {
+    /** the old states are optimal, so their linearization point is the one of the last update */
+    bool Success = this->marginalizePrevious_(CurrentTime);
+
+    Graph_.solve(Options, Limit);
+
+    /** the graph is small now, so the factorization for the covariance is cheap as well */
+    if (EstimateCov_)
+    {
+      Success = this->computeCovariance_(CurrentTime) && Success;
+    }
+
+    return Success;
+  }
+
+  bool RecursiveFilter::marginalizePrevious_(const double CurrentTime)
+  {
+    std::vector<StateID> States;
+    const StateDataSet &StateData = Graph_.getStateData();
+    for (const StateKey &Name : StateData.getKeysAll())
+    {
+      StateDataSet::TimeCursor Cursor = StateData.cursor(Name);
+      while (Cursor.valid() && Cursor.getTime() < CurrentTime)
+      {
+        for (int n = 0; n < StateData.countElement(Name, Cursor.getTime()); n++)
+        {
+          States.emplace_back(Name, Cursor.getTime(), n);
+        }
+        Cursor.next();
+      }
+    }
+
+    /** the first step has no history */
+    if (States.empty())
+    {
+      return true;
+    }
+
+    return Graph_.marginalizeStates(States);
+  }
+
+  bool RecursiveFilter::computeCovariance_(const double CurrentTime)
+  {
+    bool Success = true;
+    for (const StateKey &Name : Graph_.getStateData().getKeysAtTime(CurrentTime))
+    {
+      Success = Graph_.computeMarginalCovariance(Name, CurrentTime) && Success;
+    }
+    return Success;
+  }
+}
@@ -0,0 +1,122 @@
+/***************************************************************************
+ * libRSF - A Robust Sensor Fusion Library
+ *
+ * Copyright (C) 2018 Chair of Automation Technology / TU Chemnitz
+ * For more information see https://www.tu-chemnitz.de/etit/proaut/libRSF
+ *
+ * libRSF is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libRSF is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with libRSF.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Tim Pfeifer (tim.pfeifer@etit.tu-chemnitz.de)
+ ***************************************************************************/
+
+#include "ReorderBuffer.h"
+
+#include <algorithm>
+
+namespace libRSF
+{
+  ReorderBuffer::ReorderBuffer(const double Latency) : Latency_(std::max(Latency, 0.0))
+  {
+  }
+
+  void ReorderBuffer::setLatency(const double Latency)
+  {
+    Latency_ = std::max(Latency, 0.0);
+  }
+
+  double ReorderBuffer::getLatency() const
+  {
+    return Latency_;
+  }
+
+  bool ReorderBuffer::add(const Data &Object)
+  {
+    const DataType Type = Object.getType();
+    const double Timestamp = roundToTick(Object.getTimestamp());
+
+    /** this time was already returned, so it has to be inserted into the past */
+    if (Timestamp <= TimeReleased_)
+    {
+      Late_.addElement(Type, Timestamp, Object);
+      HasLate_ = true;
+      LateNumber_++;
+      return false;
+    }
+
+    /** the set keeps each type sorted, no matter in which order it arrives */
+    TimeNewest_ = std::max(TimeNewest_, Timestamp);
+    Buffer_.addElement(Type, Timestamp, Object);
+    return true;
+  }
+
+  bool ReorderBuffer::isComplete(const double Timestamp) const
+  {
+    return TimeNewest_ > roundToTick(Timestamp) + Latency_;
+  }
+
+  void ReorderBuffer::release(const double Timestamp, SensorDataSet &Data)
+  {
+    const double Time = roundToTick(Timestamp);
+    for (const DataType Type : Buffer_.getKeysBeforeOrEqual(Time))
+    {
+      double TimeFirst = Time;
+      Buffer_.getTimeFirst(Type, TimeFirst);
+      for (const libRSF::Data &Object : Buffer_.range(Type, TimeFirst, Time))
+      {
+        Data.addElement(Type, Object.getTimestamp(), Object);
+      }
+      Buffer_.removeElementsBeforeOrEqual(Type, Time);
+    }
+    TimeReleased_ = std::max(TimeReleased_, Time);
+  }
+
+  bool ReorderBuffer::releaseLate(SensorDataSet &Data)
+  {
+    if (!HasLate_)
+    {
+      return false;
+    }
+
+    for (const DataType Type : Late_.getKeysAll())
+    {
+      for (const libRSF::Data &Object : Late_.range(Type, std::numeric_limits<double>::lowest(), std::numeric_limits<double>::max()))
+      {
+        Data.addElement(Type, Object.getTimestamp(), Object);
+      }
+    }
+    Late_.clear();
+    HasLate_ = false;
+    return true;
+  }
+
+  const SensorDataSet &ReorderBuffer::getBuffer() const
+  {
+    return Buffer_;
+  }
+
+  double ReorderBuffer::getTimeNewest() const
+  {
+    return TimeNewest_;
+  }
+
+  double ReorderBuffer::getTimeReleased() const
+  {
+    return TimeReleased_;
+  }
+
+  int ReorderBuffer::countLate() const
+  {
+    return LateNumber_;
+  }
+}
@@ -21,9 +21,110 @@
  ***************************************************************************/
 
 #include "Resampling.h"
+#include "ThreadPool.h"
 
 namespace libRSF
 {
+  void MeasurementAccumulator::add(const Data &Measurement)
+  {
+    const VectorRefConst<double, Dynamic> Mean = Measurement.getValue(DataElement::Mean);
+
+    /** the first measurement defines the layout of the window */
+    if (Number_ == 0)
+    {
+      Weighted_ = (Measurement.checkElement(DataElement::CovarianceDiagonal) &&
+                   Measurement.getValue(DataElement::CovarianceDiagonal).size() == Mean.size()) ||
+                  (Measurement.checkElement(DataElement::Covariance) &&
+                   Measurement.getValue(DataElement::Covariance).size() == Mean.size() * Mean.size());
+      InfoMean_.setZero(Mean.size());
+      Info_.setZero(Mean.size());
+    }
+
+    if (Weighted_)
+    {
+      /** read the diagonal directly from the buffer, a full matrix is strided */
+      if (Measurement.checkElement(DataElement::CovarianceDiagonal))
+      {
+        accumulate_(Mean, Measurement.getValue(DataElement::CovarianceDiagonal));
+      }
+      else
+      {
+        const Eigen::Map<const Vector, 0, Eigen::InnerStride<>> Diagonal(Measurement.getValue(DataElement::Covariance).data(),
+                                                                          Mean.size(), Eigen::InnerStride<>(Mean.size() + 1));
+        accumulate_(Mean, Diagonal);
+      }
+    }
+    else
+    {
+      InfoMean_ += Mean;
+    }
+
+    Last_ = &Measurement;
+    Number_++;
+  }
+
+  Data MeasurementAccumulator::pop()
+  {
+    if (Number_ == 0)
+    {
+      PRINT_ERROR("There is no Measurement!");
+      return {};
+    }
+
+    /** the last measurement provides type and timestamp */
+    Data Output = *Last_;
+    if (Number_ > 1)
+    {
+      if (Weighted_)
+      {
+        Output.setMean(InfoMean_.cwiseQuotient(Info_));
+        if (Output.checkElement(DataElement::CovarianceDiagonal))
+        {
+          Output.setCovarianceDiagonal(Info_.cwiseInverse());
+        }
+        else
+        {
+          Output.setCovarianceMatrix(Matrix(Info_.cwiseInverse().asDiagonal()));
+        }
+      }
+      else
+      {
+        Output.setMean(InfoMean_ / static_cast<double>(Number_));
+      }
+    }
+
+    Last_ = nullptr;
+    Number_ = 0;
+
+    return Output;
+  }
+
+  SensorDataSet SampleMeasurementsDown(const SensorDataSet &Input, const double SampleTime)
+  {
+    /** each sensor writes into its own set, so the threads share nothing */
+    const std::vector<DataType> Types = Input.getKeysAll();
+    std::vector<SensorDataSet> Sampled(Types.size());
+
+    GetThreadPool().parallelFor(Types.size(), [&](const size_t nType)
+    {
+      double TimeFirst = 0.0, TimeLast = 0.0;
+      if (Input.getTimeFirst(Types.at(nType), TimeFirst) && Input.getTimeLast(Types.at(nType), TimeLast))
+      {
+        const SensorDataSet::ConstRange Range = Input.range(Types.at(nType), TimeFirst, TimeLast);
+        SampleMeasurementsDown(Range.begin(), Range.end(), SampleTime, Sampled.at(nType));
+      }
+    });
+
+    /** merge the streams without copying */
+    SensorDataSet Output;
+    for (SensorDataSet &Set : Sampled)
+    {
+      Output.takeStreams(std::move(Set));
+    }
+
+    return Output;
+  }
+
   std::vector<Data> SampleMeasurementsDown(const std::vector<Data> &Input, const double SampleTime)
   {
     std::vector<Data> Output;
@@ -34,27 +135,19 @@ namespace libRSF
       return Output;
     }
 
-    double Time = Input.front().getTimestamp();
-    double TimeNext = Time + SampleTime;
-    double TimeMax = Input.back().getTimestamp();
+    double TimeNext = Input.front().getTimestamp() + SampleTime;
 
-    std::vector<Data> AveragingWindow;
-    for(const Data &Sensor : Input)
+    MeasurementAccumulator Window;
+    for (auto It = Input.begin(); It != Input.end();)
     {
-      /** group measurements in periods of sample time length*/
-      AveragingWindow.push_back(Sensor);
+      const Data &Measurement = *It;
+      Window.add(Measurement);
+      ++It;
 
       /** average when period is over*/
-      if(Sensor.getTimestamp() >= TimeNext || Sensor.getTimestamp() == TimeMax)
+      if (Measurement.getTimestamp() >= TimeNext || It == Input.end())
       {
-        /** average measurements */
-        Output.push_back(AverageMeasurement(AveragingWindow));
-
-        /** set timestamp to last used measurements */
-        Output.back().setTimestamp(AveragingWindow.back().getTimestamp());
-
-        /** set end of new window and clear old one */
-        AveragingWindow.clear();
+        Output.push_back(Window.pop());
         TimeNext += SampleTime;
       }
     }
@@ -0,0 +1,149 @@
+/***************************************************************************
+ * libRSF - A Robust Sensor Fusion Library
+ *
+ * Copyright (C) 2018 Chair of Automation Technology / TU Chemnitz
+ * For more information see https://www.tu-chemnitz.de/etit/proaut/libRSF
+ *
+ * libRSF is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libRSF is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with libRSF.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Tim Pfeifer (tim.pfeifer@etit.tu-chemnitz.de)
+ ***************************************************************************/
+
+/**
+ * @file ResidualCache.cpp
+ * @author Tim Pfeifer
+ * @date 14.10.2026
+ * @brief Reuses the last evaluation of residual blocks as long as their states are unchanged.
+ * @copyright GNU Public License.
+ *
+ */
+
+#include "ResidualCache.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace libRSF
+{
+  void ResidualCache::invalidate()
+  {
+    const std::lock_guard<std::mutex> Lock(Mutex_);
+    Entries_.clear();
+    Hits_ = 0;
+    Misses_ = 0;
+  }
+
+  void ResidualCache::forget(const ceres::ResidualBlockId ID)
+  {
+    const std::lock_guard<std::mutex> Lock(Mutex_);
+    Entries_.erase(ID);
+  }
+
+  void ResidualCache::synchronize(const StateDataSet &States)
+  {
+    const std::lock_guard<std::mutex> Lock(Mutex_);
+    /** removed states are dropped as well, their memory may be reused by new ones */
+    StateVersions_.clear();
+
+    constexpr double Infinity = std::numeric_limits<double>::infinity();
+    for (const StateKey &Key : States.getKeysAll())
+    {
+      for (const Data &State : States.range(Key, -Infinity, Infinity))
+      {
+        if (State.checkElement(DataElement::Mean))
+        {
+          StateVersions_.emplace(State.getValue(DataElement::Mean).data(), State.getVersion());
+        }
+      }
+    }
+  }
+
+  bool ResidualCache::getVersion_(const double *State, uint64_t &Version) const
+  {
+    if (StateVersions_.count(State) == 0)
+    {
+      return false;
+    }
+    Version = StateVersions_.at(State);
+    return true;
+  }
+
+  bool ResidualCache::lookup(const ceres::ResidualBlockId ID, const std::vector<double*> &Parameters, std::vector<double> &Residuals) const
+  {
+    const std::lock_guard<std::mutex> Lock(Mutex_);
+    if (Entries_.count(ID) == 0)
+    {
+      Misses_++;
+      return false;
+    }
+
+    const Entry &Cached = Entries_.at(ID);
+    if (Cached.Versions.size() != Parameters.size() || Cached.Residuals.size() != Residuals.size())
+    {
+      Misses_++;
+      return false;
+    }
+
+    for (size_t n = 0; n < Parameters.size(); ++n)
+    {
+      uint64_t Version;
+      if (!getVersion_(Parameters.at(n), Version) || Version != Cached.Versions.at(n))
+      {
+        Misses_++;
+        return false;
+      }
+    }
+
+    std::copy(Cached.Residuals.begin(), Cached.Residuals.end(), Residuals.begin());
+    Hits_++;
+    return true;
+  }
+
+  void ResidualCache::store(const ceres::ResidualBlockId ID, const std::vector<double*> &Parameters, const std::vector<double> &Residuals)
+  {
+    const std::lock_guard<std::mutex> Lock(Mutex_);
+    Entry New;
+    New.Versions.resize(Parameters.size());
+    for (size_t n = 0; n < Parameters.size(); ++n)
+    {
+      /** blocks with unknown states are not cached */
+      if (!getVersion_(Parameters.at(n), New.Versions.at(n)))
+      {
+        return;
+      }
+    }
+    New.Residuals = Residuals;
+
+    if (Entries_.count(ID) > 0)
+    {
+      Entries_.at(ID) = std::move(New);
+    }
+    else
+    {
+      Entries_.emplace(ID, New);
+    }
+  }
+
+  size_t ResidualCache::countHits() const
+  {
+    const std::lock_guard<std::mutex> Lock(Mutex_);
+    return Hits_;
+  }
+
+  size_t ResidualCache::countMisses() const
+  {
+    const std::lock_guard<std::mutex> Lock(Mutex_);
+    return Misses_;
+  }
+}
@@ -0,0 +1,565 @@
+/***************************************************************************
+ * libRSF - A Robust Sensor Fusion Library
+ *
+ * Copyright (C) 2018 Chair of Automation Technology / TU Chemnitz
+ * For more information see https://www.tu-chemnitz.de/etit/proaut/libRSF
+ *
+ * libRSF is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libRSF is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with libRSF.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Tim Pfeifer (tim.pfeifer@etit.tu-chemnitz.de)
+ ***************************************************************************/
+
+#include "ResultSink.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <limits>
+
+namespace libRSF
+{
+  void ResultSink::addAll(const StateDataSet &States)
+  {
+    for (const auto &Stream : States)
+    {
+      for (const auto &Element : *Stream.second)
+      {
+        this->addElement(Stream.first, Element.second);
+      }
+    }
+  }
+
+  void MemoryResultSink::addElement(const std::string &Name, const Data &Element)
+  {
+    Result_.addElement(Name, Element);
+  }
+
+  void MemoryResultSink::addAll(const StateDataSet &States)
+  {
+    /** an empty result can share the streams of the set */
+    if (Result_.empty())
+    {
+      Result_ = States;
+    }
+    else
+    {
+      Result_.merge(States);
+    }
+  }
+
+  FileResultSink::FileResultSink(const std::string &Filename, std::vector<std::string> Names, const size_t BufferedLines)
+    : Names_(std::move(Names)), BufferedLines_(std::max<size_t>(1, BufferedLines))
+  {
+    File_.open(Filename, std::ios::out | std::ios::trunc);
+    if (!File_.is_open())
+    {
+      PRINT_ERROR("Could not open result file: ", Filename);
+    }
+  }
+
+  FileResultSink::~FileResultSink()
+  {
+    this->flush();
+  }
+
+  bool FileResultSink::isOpen() const
+  {
+    return File_.is_open();
+  }
+
+  bool FileResultSink::isSelected_(const std::string &Name) const
+  {
+    return std::find(Names_.begin(), Names_.end(), Name) != Names_.end();
+  }
+
+  void FileResultSink::addElement(const std::string &Name, const Data &Element)
+  {
+    if (!this->isSelected_(Name))
+    {
+      return;
+    }
+
+    Buffer_ += Element.getName();
+    Buffer_ += ' ';
+    Buffer_ += Element.getValueString();
+    Buffer_ += '\n';
+
+    if (++Lines_ >= BufferedLines_)
+    {
+      this->flush();
+    }
+  }
+
+  void FileResultSink::addAll(const StateDataSet &States)
+  {
+    for (const std::string &Name : Names_)
+    {
+      if (States.checkID(Name))
+      {
+        for (const auto &Element : States.getStream(Name))
+        {
+          this->addElement(Name, Element.second);
+        }
+      }
+    }
+  }
+
+  void FileResultSink::flush()
+  {
+    if (File_.is_open() && !Buffer_.empty())
+    {
+      File_ << Buffer_;
+      File_.flush();
+    }
+    Buffer_.clear();
+    Lines_ = 0;
+  }
+
+  ArchiveResultSink::ArchiveResultSink(const std::string &Filename, const size_t BufferedBytes)
+    : BufferedBytes_(std::max<size_t>(1, BufferedBytes))
+  {
+    File_.open(Filename, std::ios::in | std::ios::out | std::ios::trunc | std::ios::binary);
+    if (!File_.is_open())
+    {
+      PRINT_ERROR("Could not open archive file: ", Filename);
+    }
+  }
+
+  ArchiveResultSink::~ArchiveResultSink()
+  {
+    this->flush();
+  }
+
+  bool ArchiveResultSink::isOpen() const
+  {
+    return File_.is_open();
+  }
+
+  size_t ArchiveResultSink::countElements() const
+  {
+    return Elements_;
+  }
+
+  uint64_t ArchiveResultSink::getFileSize() const
+  {
+    return FileSize_;
+  }
+
+  size_t ArchiveResultSink::getIndexSize() const
+  {
+    size_t Bytes = 0;
+    for (const auto &Entry : Index_)
+    {
+      Bytes += Entry.first.capacity() + Entry.second.capacity() * sizeof(Record);
+    }
+    return Bytes;
+  }
+
+  void ArchiveResultSink::addElement(const std::string &Name, const Data &Element)
+  {
+    if (!File_.is_open())
+    {
+      return;
+    }
+
+    const Data::BufferType &Values = Element.getBuffer();
+
+    Record Entry;
+    Entry.Timestamp = Element.getTimestamp();
+    Entry.Position = FileSize_;
+    Entry.Type = Element.getType();
+    Entry.Size = static_cast<uint32_t>(Values.size());
+
+    Buffer_.append(reinterpret_cast<const char *>(Values.data()), Values.size() * sizeof(double));
+    FileSize_ += Values.size() * sizeof(double);
+
+    /** estimates arrive nearly in temporal order, so this is almost always an append */
+    std::vector<Record> &Records = Index_[Name];
+    auto It = std::upper_bound(Records.begin(), Records.end(), Entry.Timestamp,
+                               [](const double Time, const Record &Other){return Time < Other.Timestamp;});
+    if (It != Records.begin() && std::prev(It)->Timestamp == Entry.Timestamp)
+    {
+      /** the old bytes stay unused in the file */
+      *std::prev(It) = Entry;
+    }
+    else
+    {
+      Records.insert(It, Entry);
+      Elements_++;
+    }
+
+    if (Buffer_.size() >= BufferedBytes_)
+    {
+      this->flush();
+    }
+  }
+
+  void ArchiveResultSink::flush()
+  {
+    if (File_.is_open() && !Buffer_.empty())
+    {
+      File_.seekp(0, std::ios::end);
+      File_.write(Buffer_.data(), static_cast<std::streamsize>(Buffer_.size()));
+      File_.flush();
+    }
+    Buffer_.clear();
+  }
+
+  bool ArchiveResultSink::readRecord_(const Record &Entry, Data &Element)
+  {
+    /** the record has to be inside the written part of the file */
+    if (Entry.Position > FileSize_ || Entry.Size > (FileSize_ - Entry.Position) / sizeof(double))
+    {
+      return false;
+    }
+
+    std::vector<double> Values(Entry.Size);
+    File_.seekg(static_cast<std::streamoff>(Entry.Position));
+    if (!File_.read(reinterpret_cast<char *>(Values.data()), static_cast<std::streamsize>(Values.size() * sizeof(double))))
+    {
+      File_.clear();
+      return false;
+    }
+    Element = Data(Entry.Type, Values.data(), static_cast<int>(Values.size()));
+    return true;
+  }
+
+  bool ArchiveResultSink::load(const std::string &Name, const double TimeBegin, const double TimeEnd, StateDataSet &States)
+  {
+    const auto Records = Index_.find(Name);
+    if (Records == Index_.end())
+    {
+      return false;
+    }
+
+    /** buffered records have to be written before they can be read */
+    this->flush();
+
+    auto It = std::lower_bound(Records->second.begin(), Records->second.end(), TimeBegin,
+                               [](const Record &Other, const double Time){return Other.Timestamp < Time;});
+    bool HasLoaded = false;
+    for (; It != Records->second.end() && It->Timestamp <= TimeEnd; ++It)
+    {
+      Data Element;
+      if (!this->readRecord_(*It, Element))
+      {
+        PRINT_ERROR("Could not read archived state ", Name, " at ", It->Timestamp);
+        return false;
+      }
+      States.addElement(Name, Element);
+      HasLoaded = true;
+    }
+    return HasLoaded;
+  }
+
+  bool ArchiveResultSink::load(const double TimeBegin, const double TimeEnd, StateDataSet &States)
+  {
+    bool HasLoaded = false;
+    for (const auto &Entry : Index_)
+    {
+      HasLoaded |= this->load(Entry.first, TimeBegin, TimeEnd, States);
+    }
+    return HasLoaded;
+  }
+
+  CompactResultSink::CompactResultSink(const CompactPrecision CovariancePrecision, const double TimeResolution)
+      : Precision_(CovariancePrecision), TimeResolution_(TimeResolution)
+  {
+  }
+
+  bool CompactResultSink::ParsePrecision(const std::string &Name, CompactPrecision &Precision)
+  {
+    if (Name == "double")
+    {
+      Precision = CompactPrecision::Double;
+    }
+    else if (Name == "float")
+    {
+      Precision = CompactPrecision::Float;
+    }
+    else if (Name == "half")
+    {
+      Precision = CompactPrecision::Half;
+    }
+    else
+    {
+      return false;
+    }
+    return true;
+  }
+
+  void CompactResultSink::initColumn_(Column &Col, const DataType Type) const
+  {
+    const DataTypeConfig::LayoutType &Layout = GlobalDataConfig.getLayout(Type);
+
+    Col.Type = Type;
+    Col.TotalSize = Layout.TotalSize;
+    for (size_t nElement = 0; nElement < Layout.Offset.size(); nElement++)
+    {
+      if (Layout.Offset[nElement] < 0)
+      {
+        continue;
+      }
+
+      switch (static_cast<DataElement>(nElement))
+      {
+        case DataElement::Timestamp:
+          Col.TimeOffset = Layout.Offset[nElement];
+          break;
+
+        case DataElement::Covariance:
+          Col.CovOffset = Layout.Offset[nElement];
+          Col.CovSize = Layout.Size[nElement];
+          break;
+
+        default:
+          Col.ValueRanges.emplace_back(Layout.Offset[nElement], Layout.Size[nElement]);
+          break;
+      }
+    }
+  }
+
+  void CompactResultSink::addElement(const std::string &Name, const Data &Element)
+  {
+    const auto Found = Columns_.find(Name);
+    if (Found == Columns_.end())
+    {
+      this->initColumn_(Columns_[Name], Element.getType());
+    }
+    Column &Col = Columns_[Name];
+
+    const int64_t Tick = std::llround(Element.getTimestamp() / TimeResolution_);
+    const Data::BufferType &Buffer = Element.getBuffer();
+    if (Element.getType() != Col.Type || (Col.Rows > 0 && Tick < Col.LastTick) ||
+        Col.TimeOffset < 0 || static_cast<int>(Buffer.size()) != Col.TotalSize)
+    {
+      Unordered_.addElement(Name, Element);
+      Elements_++;
+      return;
+    }
+
+    /** zigzag variable-length delta, the first one is relative to zero */
+    const int64_t Delta = Tick - Col.LastTick;
+    uint64_t Encoded = (static_cast<uint64_t>(Delta) << 1) ^ static_cast<uint64_t>(Delta >> 63);
+    do
+    {
+      const auto Byte = static_cast<uint8_t>(Encoded & 0x7F);
+      Encoded >>= 7;
+      Col.TimeDeltas.push_back(Encoded > 0 ? static_cast<uint8_t>(Byte | 0x80) : Byte);
+    }
+    while (Encoded > 0);
+    Col.LastTick = Tick;
+
+    for (const auto &Range : Col.ValueRanges)
+    {
+      Col.Values.insert(Col.Values.end(), Buffer.begin() + Range.first, Buffer.begin() + Range.first + Range.second);
+    }
+
+    if (Col.CovSize > 0)
+    {
+      const auto First = Buffer.begin() + Col.CovOffset;
+      const auto Last = First + Col.CovSize;
+      switch (Precision_)
+      {
+        case CompactPrecision::Double:
+          Col.CovDouble.insert(Col.CovDouble.end(), First, Last);
+          break;
+
+        case CompactPrecision::Float:
+          std::transform(First, Last, std::back_inserter(Col.CovFloat), [](const double Value){return static_cast<float>(Value);});
+          break;
+
+        case CompactPrecision::Half:
+        {
+          /** the range of half precision does not cover typical variances, so each estimate is scaled to its largest entry */
+          double Scale = 0.0;
+          std::for_each(First, Last, [&Scale](const double Value){Scale = std::max(Scale, std::abs(Value));});
+          Scale = (Scale > 0.0 && std::isfinite(Scale)) ? Scale : 1.0;
+          Col.CovScale.push_back(Scale);
+          std::transform(First, Last, std::back_inserter(Col.CovHalf), [Scale](const double Value){return Eigen::half(static_cast<float>(Value / Scale));});
+        }
+        break;
+      }
+    }
+
+    Col.Rows++;
+    Elements_++;
+  }
+
+  void CompactResultSink::decodeRow_(const Column &Col, const size_t Row, const int64_t Tick, std::vector<double> &Buffer) const
+  {
+    Buffer.assign(Col.TotalSize, 0.0);
+    Buffer[Col.TimeOffset] = static_cast<double>(Tick) * TimeResolution_;
+
+    size_t Value = Row * (Col.Values.size() / Col.Rows);
+    for (const auto &Range : Col.ValueRanges)
+    {
+      std::copy_n(Col.Values.begin() + static_cast<std::ptrdiff_t>(Value), Range.second, Buffer.begin() + Range.first);
+      Value += Range.second;
+    }
+
+    if (Col.CovSize > 0)
+    {
+      const size_t First = Row * Col.CovSize;
+      for (int n = 0; n < Col.CovSize; n++)
+      {
+        switch (Precision_)
+        {
+          case CompactPrecision::Double:
+            Buffer[Col.CovOffset + n] = Col.CovDouble[First + n];
+            break;
+
+          case CompactPrecision::Float:
+            Buffer[Col.CovOffset + n] = static_cast<double>(Col.CovFloat[First + n]);
+            break;
+
+          case CompactPrecision::Half:
+            Buffer[Col.CovOffset + n] = static_cast<double>(static_cast<float>(Col.CovHalf[First + n])) * Col.CovScale[Row];
+            break;
+        }
+      }
+    }
+  }
+
+  template <typename FunctionType>
+  void CompactResultSink::decodeColumn_(const Column &Col, const double TimeBegin, const double TimeEnd, FunctionType Function) const
+  {
+    std::vector<double> Buffer;
+    int64_t Tick = 0;
+    size_t Byte = 0;
+    for (size_t Row = 0; Row < Col.Rows; Row++)
+    {
+      /** the deltas have to be decoded sequentially */
+      uint64_t Encoded = 0;
+      int Shift = 0;
+      uint8_t Current;
+      do
+      {
+        Current = Col.TimeDeltas[Byte++];
+        Encoded |= static_cast<uint64_t>(Current & 0x7F) << Shift;
+        Shift += 7;
+      }
+      while ((Current & 0x80) != 0);
+      Tick += static_cast<int64_t>(Encoded >> 1) ^ -static_cast<int64_t>(Encoded & 1);
+
+      const double Timestamp = static_cast<double>(Tick) * TimeResolution_;
+      if (Timestamp > TimeEnd)
+      {
+        break;
+      }
+      if (Timestamp >= TimeBegin)
+      {
+        this->decodeRow_(Col, Row, Tick, Buffer);
+        Function(Data(Col.Type, Buffer.data(), Col.TotalSize));
+      }
+    }
+  }
+
+  bool CompactResultSink::load(const std::string &Name, const double TimeBegin, const double TimeEnd, StateDataSet &States) const
+  {
+    bool HasLoaded = false;
+
+    const auto Col = Columns_.find(Name);
+    if (Col != Columns_.end())
+    {
+      this->decodeColumn_(Col->second, TimeBegin, TimeEnd, [&](const Data &Element)
+      {
+        States.addElement(Name, Element);
+        HasLoaded = true;
+      });
+    }
+
+    double Timestamp;
+    if (Unordered_.checkID(Name) && Unordered_.getTimeAboveOrEqual(Name, TimeBegin, Timestamp))
+    {
+      do
+      {
+        if (Timestamp > TimeEnd)
+        {
+          break;
+        }
+        Data Element;
+        for (int n = 0; n < Unordered_.countElement(Name, Timestamp); n++)
+        {
+          if (Unordered_.getElement(Name, Timestamp, n, Element))
+          {
+            States.addElement(Name, Element);
+            HasLoaded = true;
+          }
+        }
+      }
+      while (Unordered_.getTimeNext(Name, Timestamp, Timestamp));
+    }
+
+    return HasLoaded;
+  }
+
+  void CompactResultSink::exportTo(ResultSink &Target) const
+  {
+    for (const auto &Entry : Columns_)
+    {
+      /** the rare unordered estimates are merged in by time */
+      std::vector<Data> Unordered;
+      double Timestamp;
+      if (Unordered_.checkID(Entry.first) && Unordered_.getTimeFirst(Entry.first, Timestamp))
+      {
+        do
+        {
+          for (int n = 0; n < Unordered_.countElement(Entry.first, Timestamp); n++)
+          {
+            Unordered.emplace_back();
+            Unordered_.getElement(Entry.first, Timestamp, n, Unordered.back());
+          }
+        }
+        while (Unordered_.getTimeNext(Entry.first, Timestamp, Timestamp));
+      }
+
+      auto Next = Unordered.begin();
+      this->decodeColumn_(Entry.second, std::numeric_limits<double>::lowest(), std::numeric_limits<double>::max(), [&](const Data &Element)
+      {
+        for (; Next != Unordered.end() && Next->getTimestamp() < Element.getTimestamp(); ++Next)
+        {
+          Target.addElement(Entry.first, *Next);
+        }
+        Target.addElement(Entry.first, Element);
+      });
+      for (; Next != Unordered.end(); ++Next)
+      {
+        Target.addElement(Entry.first, *Next);
+      }
+    }
+  }
+
+  size_t CompactResultSink::countElements() const
+  {
+    return Elements_;
+  }
+
+  size_t CompactResultSink::getMemoryUsage() const
+  {
+    size_t Bytes = 0;
+    for (const auto &Entry : Columns_)
+    {
+      const Column &Col = Entry.second;
+      Bytes += Col.TimeDeltas.capacity() * sizeof(uint8_t)
+               + Col.Values.capacity() * sizeof(double)
+               + Col.CovDouble.capacity() * sizeof(double)
+               + Col.CovFloat.capacity() * sizeof(float)
+               + Col.CovHalf.capacity() * sizeof(Eigen::half)
+               + Col.CovScale.capacity() * sizeof(double)
+               + Col.ValueRanges.capacity() * sizeof(std::pair<int, int>);
+    }
+    return Bytes;
+  }
+}
@@ -0,0 +1,98 @@
+/***************************************************************************
+ * libRSF - A Robust Sensor Fusion Library
+ *
+ * Copyright (C) 2018 Chair of Automation Technology / TU Chemnitz
+ * For more information see https://www.tu-chemnitz.de/etit/proaut/libRSF
+ *
+ * libRSF is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libRSF is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with libRSF.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Tim Pfeifer (tim.pfeifer@etit.tu-chemnitz.de)
+ ***************************************************************************/
+
+#include "SatelliteStore.h"
+#include "DataStream.h"
+
+namespace libRSF
+{
+  size_t SatelliteStore::add(const Data &Measurement)
+  {
+    /** 2D and 3D positions share the storage */
+    const VectorRefConst<double, Dynamic> SatPos = Measurement.getValue(DataElement::SatPos);
+    Vector3 Position = Vector3::Zero();
+    Position.head(SatPos.size()) = SatPos;
+
+    /** without an ID, the position can not be shared */
+    if (!Measurement.checkElement(DataElement::SatID))
+    {
+      return this->add(Position);
+    }
+
+    const int SatID = static_cast<int>(Measurement.getValue(DataElement::SatID)(0));
+    const int SatSystem = Measurement.checkElement(DataElement::SatSys) ? static_cast<int>(Measurement.getValue(DataElement::SatSys)(0)) : 0;
+
+    return this->add(SatSystem, SatID, Measurement.getTimestamp(), Position);
+  }
+
+  size_t SatelliteStore::add(const int SatSystem, const int SatID, const double Timestamp, const Vector3 &Position)
+  {
+    const auto Key = std::make_tuple(SatSystem, SatID, roundToTick(Timestamp));
+
+    /** re-use the stored position if it is the same */
+    const auto It = Index_.find(Key);
+    if (It != Index_.end())
+    {
+      const size_t Index = It->second;
+      if (X_[Index] == Position(0) && Y_[Index] == Position(1) && Z_[Index] == Position(2))
+      {
+        return Index;
+      }
+    }
+
+    /** new or changed position, e.g. after a conversion of the measurements */
+    const size_t Index = this->append_(Position);
+    Index_[Key] = Index;
+    return Index;
+  }
+
+  size_t SatelliteStore::add(const Vector3 &Position)
+  {
+    return this->append_(Position);
+  }
+
+  size_t SatelliteStore::append_(const Vector3 &Position)
+  {
+    X_.push_back(Position(0));
+    Y_.push_back(Position(1));
+    Z_.push_back(Position(2));
+    return X_.size() - 1;
+  }
+
+  size_t SatelliteStore::size() const
+  {
+    return X_.size();
+  }
+
+  bool SatelliteStore::empty() const
+  {
+    return X_.empty();
+  }
+
+  void SatelliteStore::clear()
+  {
+    X_.clear();
+    Y_.clear();
+    Z_.clear();
+    Index_.clear();
+  }
+}
@@ -0,0 +1,317 @@
+/***************************************************************************
+ * libRSF - A Robust Sensor Fusion Library
+ *
+ * Copyright (C) 2018 Chair of Automation Technology / TU Chemnitz
+ * For more information see https://www.tu-chemnitz.de/etit/proaut/libRSF
+ *
+ * libRSF is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libRSF is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with libRSF.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Tim Pfeifer (tim.pfeifer@etit.tu-chemnitz.de)
+ ***************************************************************************/
+
+#include "SegmentedBatch.h"
+#include "ThreadPool.h"
+#include "TimeMeasurement.h"
+
+#include <algorithm>
+#include <limits>
+#include <set>
+
+namespace libRSF
+{
+  /** the copies agree if they differ less than this fraction of the consensus standard deviation */
+  static constexpr double ConsensusTolerance = 0.01;
+
+  /** difference of two states in the tangent space: A - B */
+  static Vector TangentDifference(const DataType Type, const Vector &A, const Vector &B)
+  {
+    if (Type == DataType::Angle)
+    {
+      return NormalizeAngleVector<double, 1>(A - B);
+    }
+    if (Type == DataType::Quaternion)
+    {
+      return QuaternionError<double>(QuaternionRefConst<double>(A.data()), QuaternionRefConst<double>(B.data()));
+    }
+    return A - B;
+  }
+
+  /** move a state in the tangent space: X + Delta */
+  static Vector TangentApply(const DataType Type, const Vector &X, const Vector &Delta)
+  {
+    if (Type == DataType::Angle)
+    {
+      return NormalizeAngleVector<double, 1>(X + Delta);
+    }
+    if (Type == DataType::Quaternion)
+    {
+      const Quaternion Result = QuaternionExpMap<double>(Delta) * QuaternionRefConst<double>(X.data());
+      return Result.coeffs();
+    }
+    return X + Delta;
+  }
+
+  SegmentedBatch::SegmentedBatch(const double Length, const double Overlap, const int Rounds, const double ConsensusStdDev) :
+      Length_(Length), Overlap_(Overlap), Rounds_(std::max(1, Rounds)), ConsensusStdDev_(ConsensusStdDev)
+  {
+  }
+
+  SegmentedBatch::SegmentedBatch(const FactorGraphConfig &Config) :
+      SegmentedBatch(Config.Solution.SegmentLength,
+                     Config.Solution.SegmentOverlap,
+                     Config.Solution.SegmentRounds,
+                     Config.Solution.SegmentConsensus)
+  {
+  }
+
+  bool SegmentedBatch::isActive() const
+  {
+    return Length_ > 0.0 && Overlap_ >= 0.0 && Overlap_ < Length_ && ConsensusStdDev_ > 0.0;
+  }
+
+  size_t SegmentedBatch::countSegments() const
+  {
+    return Segments_.size();
+  }
+
+  int SegmentedBatch::countRounds() const
+  {
+    return RoundsDone_;
+  }
+
+  double SegmentedBatch::getDisagreement() const
+  {
+    return Disagreement_;
+  }
+
+  double SegmentedBatch::getSolverDuration() const
+  {
+    return SolverDuration_;
+  }
+
+  bool SegmentedBatch::solve(const double TimeBegin, const double TimeEnd, const Builder &Build,
+                             const ceres::Solver::Options &Options, StateDataSet &Result)
+  {
+    if (!this->isActive())
+    {
+      PRINT_ERROR("Segmented batch needs a positive length and an overlap that is shorter than it!");
+      return false;
+    }
+
+    /** split the time axis */
+    Segments_.clear();
+    Shared_.clear();
+    const double Step = Length_ - Overlap_;
+    double Begin = TimeBegin;
+    do
+    {
+      Segment Current;
+      Current.TimeBegin = Begin;
+      Current.TimeEnd = std::min(Begin + Length_, TimeEnd);
+      Current.Graph = std::make_unique<FactorGraph>();
+      Segments_.push_back(std::move(Current));
+      Begin += Step;
+    }
+    while (Segments_.back().TimeEnd < TimeEnd);
+
+    /** build all graphs concurrently */
+    std::vector<char> IsBuilt(Segments_.size(), 0);
+    GetThreadPool().parallelFor(Segments_.size(), [&](const size_t nSegment)
+    {
+      Segment &Current = Segments_.at(nSegment);
+      IsBuilt.at(nSegment) = Build(*Current.Graph, Current.TimeBegin, Current.TimeEnd) ? 1 : 0;
+    });
+    if (std::find(IsBuilt.begin(), IsBuilt.end(), 0) != IsBuilt.end())
+    {
+      PRINT_ERROR("Could not build all segments!");
+      return false;
+    }
+
+    Shared_.resize(Segments_.size() - 1);
+    for (size_t nLeft = 0; nLeft + 1 < Segments_.size(); nLeft++)
+    {
+      this->collectSharedStates_(nLeft);
+    }
+
+    /** the segments share the cores instead of competing for all of them */
+    ceres::Solver::Options SegmentOptions = Options;
+    SegmentOptions.num_threads = std::max(1, GetThreadNumber() / static_cast<int>(Segments_.size()));
+
+    Timer SolverTimer;
+    RoundsDone_ = 0;
+    Disagreement_ = 0.0;
+    for (int nRound = 0; nRound < Rounds_; nRound++)
+    {
+      GetThreadPool().parallelFor(Segments_.size(), [&](const size_t nSegment)
+      {
+        Segments_.at(nSegment).Graph->solve(SegmentOptions);
+      });
+      RoundsDone_++;
+
+      /** compare the copies of all overlaps */
+      Disagreement_ = 0.0;
+      for (size_t nLeft = 0; nLeft < Shared_.size(); nLeft++)
+      {
+        Disagreement_ = std::max(Disagreement_, this->updateConsensus_(nLeft, nRound == 0));
+      }
+
+      if (Disagreement_ < ConsensusTolerance * ConsensusStdDev_ || nRound + 1 == Rounds_)
+      {
+        break;
+      }
+
+      for (size_t nLeft = 0; nLeft < Shared_.size(); nLeft++)
+      {
+        this->addConsensusPriors_(nLeft, nRound > 0);
+      }
+    }
+    SolverDuration_ = SolverTimer.getSeconds();
+
+    this->stitch_(Result);
+    return true;
+  }
+
+  void SegmentedBatch::collectSharedStates_(const size_t Left)
+  {
+    const StateDataSet &StatesLeft = Segments_.at(Left).Graph->getStateData();
+    const StateDataSet &StatesRight = Segments_.at(Left + 1).Graph->getStateData();
+    const double OverlapBegin = Segments_.at(Left + 1).TimeBegin;
+    const double OverlapEnd = Segments_.at(Left).TimeEnd;
+
+    for (const StateKey &Name : StatesLeft.getKeysAll())
+    {
+      std::vector<double> Times;
+      StatesLeft.getTimesOfID(Name, Times);
+      for (const double Time : Times)
+      {
+        if (Time < OverlapBegin || Time > OverlapEnd)
+        {
+          continue;
+        }
+
+        for (int Number = 0; Number < static_cast<int>(StatesLeft.countElement(Name, Time)); Number++)
+        {
+          if (!StatesRight.checkElement(Name, Time, Number))
+          {
+            continue;
+          }
+
+          Data Element;
+          StatesLeft.getElement(Name, Time, Number, Element);
+
+          SharedState State;
+          State.ID = StateID(Name, Time, Number);
+          State.Type = Element.getType();
+          Shared_.at(Left).push_back(State);
+        }
+      }
+    }
+  }
+
+  double SegmentedBatch::updateConsensus_(const size_t Left, const bool IsFirst)
+  {
+    const StateDataSet &StatesLeft = Segments_.at(Left).Graph->getStateData();
+    const StateDataSet &StatesRight = Segments_.at(Left + 1).Graph->getStateData();
+
+    double Disagreement = 0.0;
+    for (SharedState &State : Shared_.at(Left))
+    {
+      Data ElementLeft, ElementRight;
+      StatesLeft.getElement(State.ID.ID, State.ID.getTimestamp(), State.ID.Number, ElementLeft);
+      StatesRight.getElement(State.ID.ID, State.ID.getTimestamp(), State.ID.Number, ElementRight);
+      const Vector MeanLeft = ElementLeft.getMean();
+      const Vector MeanRight = ElementRight.getMean();
+
+      if (IsFirst)
+      {
+        State.Consensus = MeanRight;
+        State.DualLeft = Vector::Zero(TangentDifference(State.Type, MeanLeft, MeanRight).size());
+        State.DualRight = State.DualLeft;
+      }
+
+      /** consensus step: mean of both copies shifted by their duals */
+      const Vector StepLeft = TangentDifference(State.Type, MeanLeft, State.Consensus) + State.DualLeft;
+      const Vector StepRight = TangentDifference(State.Type, MeanRight, State.Consensus) + State.DualRight;
+      State.Consensus = TangentApply(State.Type, State.Consensus, 0.5 * (StepLeft + StepRight));
+
+      /** dual step */
+      State.DualLeft += TangentDifference(State.Type, MeanLeft, State.Consensus);
+      State.DualRight += TangentDifference(State.Type, MeanRight, State.Consensus);
+
+      Disagreement = std::max(Disagreement, TangentDifference(State.Type, MeanLeft, MeanRight).norm());
+    }
+    return Disagreement;
+  }
+
+  void SegmentedBatch::addConsensusPriors_(const size_t Left, const bool RemoveOld)
+  {
+    FactorGraph &GraphLeft = *Segments_.at(Left).Graph;
+    FactorGraph &GraphRight = *Segments_.at(Left + 1).Graph;
+
+    /** the priors of the last round are replaced */
+    if (RemoveOld)
+    {
+      std::set<double> Times;
+      for (const SharedState &State : Shared_.at(Left))
+      {
+        Times.insert(State.ID.getTimestamp());
+      }
+      for (const double Time : Times)
+      {
+        GraphLeft.removeFactor(FactorType::StatePrior, Time);
+        GraphRight.removeFactor(FactorType::StatePrior, Time);
+      }
+    }
+
+    for (const SharedState &State : Shared_.at(Left))
+    {
+      const Matrix SqrtInformation = Matrix::Identity(State.DualLeft.size(), State.DualLeft.size()) / ConsensusStdDev_;
+      GraphLeft.addStatePrior(State.ID, TangentApply(State.Type, State.Consensus, -State.DualLeft), SqrtInformation);
+      GraphRight.addStatePrior(State.ID, TangentApply(State.Type, State.Consensus, -State.DualRight), SqrtInformation);
+    }
+  }
+
+  void SegmentedBatch::stitch_(StateDataSet &Result) const
+  {
+    for (size_t nSegment = 0; nSegment < Segments_.size(); nSegment++)
+    {
+      /** each segment owns the states up to the middle of its overlaps */
+      const double Lower = (nSegment == 0) ? -std::numeric_limits<double>::infinity()
+                         : 0.5 * (Segments_.at(nSegment).TimeBegin + Segments_.at(nSegment - 1).TimeEnd);
+      const double Upper = (nSegment + 1 == Segments_.size()) ? std::numeric_limits<double>::infinity()
+                         : 0.5 * (Segments_.at(nSegment + 1).TimeBegin + Segments_.at(nSegment).TimeEnd);
+
+      const StateDataSet &States = Segments_.at(nSegment).Graph->getStateData();
+      for (const StateKey &Name : States.getKeysAll())
+      {
+        std::vector<double> Times;
+        States.getTimesOfID(Name, Times);
+        for (const double Time : Times)
+        {
+          if (Time < Lower || Time >= Upper)
+          {
+            continue;
+          }
+
+          for (int Number = 0; Number < static_cast<int>(States.countElement(Name, Time)); Number++)
+          {
+            Data Element;
+            States.getElement(Name, Time, Number, Element);
+            Result.addElement(Name, Element);
+          }
+        }
+      }
+    }
+  }
+}
@@ -31,7 +31,7 @@ namespace libRSF
 
   std::ostream& operator << (std::ostream& Os, const MeasurementID& ID)
   {
-    Os << ID.ID << " " << ID.Timestamp << " " << ID.Number << " ";
+    Os << ID.ID << " " << ID.getTimestamp() << " " << ID.Number << " ";
     return Os;
   }
 }
@@ -0,0 +1,512 @@
+/***************************************************************************
+ * libRSF - A Robust Sensor Fusion Library
+ *
+ * Copyright (C) 2018 Chair of Automation Technology / TU Chemnitz
+ * For more information see https://www.tu-chemnitz.de/etit/proaut/libRSF
+ *
+ * libRSF is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libRSF is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with libRSF.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Tim Pfeifer (tim.pfeifer@etit.tu-chemnitz.de)
+ ***************************************************************************/
+
+#include "SensorDataSource.h"
+#include "FileAccess.h"
+#include "RealTime.h"
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+
+namespace libRSF
+{
+  /** number of lines that is read without locking */
+  static const int ReadBatchSize = 256;
+
+  SensorDataFileSource::SensorDataFileSource(const std::string &Filename, const double ReadAhead)
+  : ReadAhead_(ReadAhead), Horizon_(-std::numeric_limits<double>::infinity())
+  {
+    indexFile_(Filename);
+    Worker_ = std::thread(&SensorDataFileSource::readAhead_, this);
+  }
+
+  SensorDataFileSource::~SensorDataFileSource()
+  {
+    {
+      std::lock_guard<std::mutex> Lock(Mutex_);
+      Stop_ = true;
+    }
+    Condition_.notify_all();
+
+    if (Worker_.joinable())
+    {
+      Worker_.join();
+    }
+  }
+
+  void SensorDataFileSource::indexFile_(const std::string &Filename)
+  {
+    std::ifstream File(Filename);
+    if (!File)
+    {
+      PRINT_ERROR("Could not open file: ", Filename);
+      return;
+    }
+
+    std::string Line;
+    std::streampos Position = File.tellg();
+    while (std::getline(File, Line) && !Line.empty())
+    {
+      const std::string Name = Line.substr(0, Line.find_first_of(' '));
+      const double Timestamp = roundToTick(std::strtod(Line.c_str() + Name.size(), nullptr));
+
+      if (GlobalDataConfig.checkName(Name))
+      {
+        const DataType Type = GlobalDataConfig.getType(Name);
+        auto It = Streams_.find(Type);
+
+        if (It == Streams_.end())
+        {
+          /** open a separate handle at the first line of this type */
+          StreamType &Stream = Streams_[Type];
+          Stream.Name = Name;
+          Stream.File.open(Filename);
+          Stream.File.seekg(Position);
+          Stream.TimeFirst = Timestamp;
+          Stream.TimeLast = Timestamp;
+        }
+        else
+        {
+          It->second.TimeFirst = std::min(It->second.TimeFirst, Timestamp);
+          It->second.TimeLast = std::max(It->second.TimeLast, Timestamp);
+        }
+      }
+      else
+      {
+        PRINT_ERROR("Type does not exist: ", Name);
+      }
+
+      Position = File.tellg();
+    }
+  }
+
+  bool SensorDataFileSource::readNext_(StreamType &Stream, Data &Object)
+  {
+    std::string Line;
+    while (std::getline(Stream.File, Line) && !Line.empty())
+    {
+      /** skip lines of other types */
+      if (Line.compare(0, Stream.Name.size(), Stream.Name) == 0 && Line.size() > Stream.Name.size() && Line[Stream.Name.size()] == ' ')
+      {
+        /** malformed lines are skipped */
+        std::string Error;
+        Object = Data(Line, Error);
+        if (Error.empty())
+        {
+          return true;
+        }
+        PRINT_ERROR("Skipped malformed line: ", Error);
+      }
+    }
+    return false;
+  }
+
+  bool SensorDataFileSource::isAvailable_(const StreamType &Stream, const double Timestamp)
+  {
+    return (Stream.IsFinished || (!Stream.Buffer.empty() && roundToTick(Stream.Buffer.back().getTimestamp()) > Timestamp));
+  }
+
+  void SensorDataFileSource::readAhead_()
+  {
+    ApplyRealTimeThread(RealTimeThread::Ingestion);
+
+    std::unique_lock<std::mutex> Lock(Mutex_);
+
+    while (!Stop_)
+    {
+      bool HasRead = false;
+
+      for (auto &Entry : Streams_)
+      {
+        StreamType &Stream = Entry.second;
+
+        if (Stream.IsFinished || (!Stream.Buffer.empty() && roundToTick(Stream.Buffer.back().getTimestamp()) > Horizon_))
+        {
+          continue;
+        }
+
+        /** parse without holding the lock, the file handle is only used by this thread */
+        const double Horizon = Horizon_;
+        Lock.unlock();
+
+        std::vector<Data> Objects;
+        bool IsFinished = false;
+        Data Object;
+        while (static_cast<int>(Objects.size()) < ReadBatchSize)
+        {
+          if (!readNext_(Stream, Object))
+          {
+            IsFinished = true;
+            break;
+          }
+          Objects.push_back(std::move(Object));
+          if (roundToTick(Objects.back().getTimestamp()) > Horizon)
+          {
+            break;
+          }
+        }
+
+        Lock.lock();
+        for (Data &Element : Objects)
+        {
+          Stream.Buffer.push_back(std::move(Element));
+        }
+        Stream.IsFinished = IsFinished;
+        HasRead = true;
+      }
+
+      if (HasRead)
+      {
+        Condition_.notify_all();
+      }
+      else
+      {
+        Condition_.wait(Lock);
+      }
+    }
+  }
+
+  void SensorDataFileSource::getMeasurementsUntil(const double Timestamp, SensorDataSet &Data)
+  {
+    std::vector<libRSF::Data> Objects;
+
+    {
+      std::unique_lock<std::mutex> Lock(Mutex_);
+      Horizon_ = std::max(Horizon_, Timestamp + ReadAhead_);
+      Condition_.notify_all();
+
+      Condition_.wait(Lock, [&]
+      {
+        return std::all_of(Streams_.begin(), Streams_.end(), [&](const auto &Entry){return isAvailable_(Entry.second, Timestamp);});
+      });
+
+      for (auto &Entry : Streams_)
+      {
+        std::deque<libRSF::Data> &Buffer = Entry.second.Buffer;
+        while (!Buffer.empty() && roundToTick(Buffer.front().getTimestamp()) <= Timestamp)
+        {
+          Objects.push_back(std::move(Buffer.front()));
+          Buffer.pop_front();
+        }
+      }
+    }
+
+    for (const libRSF::Data &Object : Objects)
+    {
+      Data.addElement(Object);
+    }
+  }
+
+  bool SensorDataFileSource::getTimeFirst(const DataType Type, double &Timestamp) const
+  {
+    const auto It = Streams_.find(Type);
+    if (It == Streams_.end())
+    {
+      return false;
+    }
+    Timestamp = It->second.TimeFirst;
+    return true;
+  }
+
+  bool SensorDataFileSource::getTimeLast(const DataType Type, double &Timestamp) const
+  {
+    const auto It = Streams_.find(Type);
+    if (It == Streams_.end())
+    {
+      return false;
+    }
+    Timestamp = It->second.TimeLast;
+    return true;
+  }
+
+  bool SensorDataFileSource::getTimeNext(const DataType Type, const double Timestamp, double &NextTimestamp)
+  {
+    const auto It = Streams_.find(Type);
+    if (It == Streams_.end())
+    {
+      return false;
+    }
+
+    std::unique_lock<std::mutex> Lock(Mutex_);
+    Horizon_ = std::max(Horizon_, Timestamp + ReadAhead_);
+    Condition_.notify_all();
+
+    const StreamType &Stream = It->second;
+    Condition_.wait(Lock, [&]{return isAvailable_(Stream, Timestamp);});
+
+    for (const Data &Object : Stream.Buffer)
+    {
+      if (roundToTick(Object.getTimestamp()) > Timestamp)
+      {
+        NextTimestamp = roundToTick(Object.getTimestamp());
+        return true;
+      }
+    }
+
+    return false;
+  }
+
+  std::vector<DataType> SensorDataFileSource::getKeysAll() const
+  {
+    std::vector<DataType> Keys;
+    for (const auto &Entry : Streams_)
+    {
+      Keys.push_back(Entry.first);
+    }
+    return Keys;
+  }
+
+  SensorDataBinarySource::SensorDataBinarySource(const std::string &Filename, const std::vector<DataType> &Types)
+  : File_(Filename)
+  {
+    IsValid_ = this->indexFile_(Filename, Types);
+  }
+
+  bool SensorDataBinarySource::isValid() const
+  {
+    return IsValid_;
+  }
+
+  bool SensorDataBinarySource::indexFile_(const std::string &Filename, const std::vector<DataType> &Types)
+  {
+    if (!File_.isValid() || !IsBinaryDataFile(Filename))
+    {
+      PRINT_ERROR("Could not open binary file: ", Filename);
+      return false;
+    }
+
+    /** same index as ReadDataFromBinaryFile() */
+    std::vector<BinaryDataBlock> Index;
+    if (!ReadBinaryDataIndex(File_, Filename, Compression_, Index))
+    {
+      return false;
+    }
+
+    for (BinaryDataBlock &Entry : Index)
+    {
+      if (!Types.empty() && std::find(Types.begin(), Types.end(), Entry.Type) == Types.end())
+      {
+        continue;
+      }
+
+      const auto &Layout = GlobalDataConfig.getLayout(Entry.Type);
+      if (!Layout.hasElement(DataElement::Timestamp))
+      {
+        PRINT_ERROR("Type has no timestamp: ", GlobalDataConfig.getName(Entry.Type));
+        return false;
+      }
+
+      BlockType Block;
+      Block.TimestampOffset = Layout.Offset.at(static_cast<size_t>(DataElement::Timestamp));
+      Block.Index = std::move(Entry);
+      Blocks_.emplace(Block.Index.Type, std::move(Block));
+    }
+
+    return true;
+  }
+
+  bool SensorDataBinarySource::readValues_(BlockType &Block, const size_t Chunk, const uint64_t Object, const int Value, double *Target, const int Number)
+  {
+    const BinaryDataChunk &Entry = Block.Index.Chunks.at(Chunk);
+    const size_t Offset = Object * Block.Index.ValueNumber + Value;
+
+    /** uncompressed values are copied out of the mapping to avoid unaligned access */
+    if (Compression_ == BinaryCompression::None)
+    {
+      return File_.readAt(Entry.Position + Offset * sizeof(double), Target, Number * sizeof(double));
+    }
+
+    auto It = Block.Decoded.find(Chunk);
+    if (It == Block.Decoded.end())
+    {
+      std::vector<double> Values;
+      if (!DecodeBinaryDataChunk(File_, Entry, Block.Index.ValueNumber, Compression_, Values))
+      {
+        PRINT_ERROR("Could not decode chunk ", Chunk, " of type ", GlobalDataConfig.getName(Block.Index.Type));
+        return false;
+      }
+      It = Block.Decoded.emplace(Chunk, std::move(Values)).first;
+    }
+    std::copy_n(It->second.data() + Offset, Number, Target);
+    return true;
+  }
+
+  double SensorDataBinarySource::getTimestamp_(BlockType &Block, const size_t Chunk, const uint64_t Object)
+  {
+    double Timestamp = 0.0;
+    this->readValues_(Block, Chunk, Object, Block.TimestampOffset, &Timestamp, 1);
+    return roundToTick(Timestamp);
+  }
+
+  void SensorDataBinarySource::decodeUntil_(const double Timestamp)
+  {
+    if (Compression_ == BinaryCompression::None)
+    {
+      return;
+    }
+
+    /** collect the chunks of all types that are touched by this request */
+    std::vector<std::pair<BlockType*, size_t>> Missing;
+    for (auto &Entry : Blocks_)
+    {
+      BlockType &Block = Entry.second;
+      for (size_t nChunk = Block.NextChunk;
+           nChunk < Block.Index.Chunks.size() && roundToTick(Block.Index.Chunks.at(nChunk).TimeFirst) <= Timestamp;
+           nChunk++)
+      {
+        if (Block.Decoded.count(nChunk) == 0)
+        {
+          Missing.emplace_back(&Block, nChunk);
+        }
+      }
+    }
+
+    std::vector<std::vector<double>> Values(Missing.size());
+    std::vector<char> Success(Missing.size(), 0);
+    GetThreadPool().parallelFor(Missing.size(), [&](const size_t n)
+    {
+      const BlockType &Block = *Missing.at(n).first;
+      Success.at(n) = DecodeBinaryDataChunk(File_, Block.Index.Chunks.at(Missing.at(n).second), Block.Index.ValueNumber, Compression_, Values.at(n));
+    });
+
+    /** failed chunks are retried and reported by readValues_() */
+    for (size_t n = 0; n < Missing.size(); n++)
+    {
+      if (Success.at(n) != 0)
+      {
+        Missing.at(n).first->Decoded.emplace(Missing.at(n).second, std::move(Values.at(n)));
+      }
+    }
+  }
+
+  void SensorDataBinarySource::getMeasurementsUntil(const double Timestamp, SensorDataSet &Data)
+  {
+    this->decodeUntil_(Timestamp);
+
+    for (auto &[Type, Block] : Blocks_)
+    {
+      std::vector<double> Values(Block.Index.ValueNumber);
+
+      while (Block.NextChunk < Block.Index.Chunks.size())
+      {
+        if (Block.NextObject == Block.Index.Chunks.at(Block.NextChunk).ObjectNumber)
+        {
+          Block.NextChunk++;
+          Block.NextObject = 0;
+          continue;
+        }
+
+        if (this->getTimestamp_(Block, Block.NextChunk, Block.NextObject) > Timestamp ||
+            !this->readValues_(Block, Block.NextChunk, Block.NextObject, 0, Values.data(), Block.Index.ValueNumber))
+        {
+          break;
+        }
+        Data.addElement(libRSF::Data(Type, Values.data(), Block.Index.ValueNumber));
+        Block.NextObject++;
+      }
+
+      /** returned chunks are not needed anymore */
+      Block.Decoded.erase(Block.Decoded.begin(), Block.Decoded.lower_bound(Block.NextChunk));
+    }
+  }
+
+  bool SensorDataBinarySource::getTimeFirst(const DataType Type, double &Timestamp) const
+  {
+    const auto It = Blocks_.find(Type);
+    if (It == Blocks_.end())
+    {
+      return false;
+    }
+    Timestamp = roundToTick(It->second.Index.Chunks.front().TimeFirst);
+    return true;
+  }
+
+  bool SensorDataBinarySource::getTimeLast(const DataType Type, double &Timestamp) const
+  {
+    const auto It = Blocks_.find(Type);
+    if (It == Blocks_.end())
+    {
+      return false;
+    }
+    Timestamp = roundToTick(It->second.Index.Chunks.back().TimeLast);
+    return true;
+  }
+
+  bool SensorDataBinarySource::getTimeNext(const DataType Type, const double Timestamp, double &NextTimestamp)
+  {
+    const auto It = Blocks_.find(Type);
+    if (It == Blocks_.end())
+    {
+      return false;
+    }
+
+    /** the index selects the chunk, so only one chunk is searched */
+    BlockType &Block = It->second;
+    const std::vector<BinaryDataChunk> &Chunks = Block.Index.Chunks;
+    const auto ChunkIt = std::partition_point(Chunks.begin(), Chunks.end(), [Timestamp](const BinaryDataChunk &Chunk)
+    {
+      return roundToTick(Chunk.TimeLast) <= Timestamp;
+    });
+    if (ChunkIt == Chunks.end())
+    {
+      return false;
+    }
+    const auto Chunk = static_cast<size_t>(ChunkIt - Chunks.begin());
+
+    /** binary search on the mapping, only a few pages are touched */
+    uint64_t Low = 0;
+    uint64_t High = ChunkIt->ObjectNumber;
+    while (Low < High)
+    {
+      const uint64_t Middle = Low + (High - Low) / 2;
+      if (this->getTimestamp_(Block, Chunk, Middle) <= Timestamp)
+      {
+        Low = Middle + 1;
+      }
+      else
+      {
+        High = Middle;
+      }
+    }
+
+    if (Low == ChunkIt->ObjectNumber)
+    {
+      return false;
+    }
+    NextTimestamp = this->getTimestamp_(Block, Chunk, Low);
+    return true;
+  }
+
+  std::vector<DataType> SensorDataBinarySource::getKeysAll() const
+  {
+    std::vector<DataType> Keys;
+    for (const auto &Entry : Blocks_)
+    {
+      Keys.push_back(Entry.first);
+    }
+    return Keys;
+  }
+}
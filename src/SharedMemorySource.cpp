@@ -0,0 +1,514 @@
+/***************************************************************************
+ * libRSF - A Robust Sensor Fusion Library
+ *
+ * Copyright (C) 2019 Chair of Automation Technology / TU Chemnitz
+ * For more information see https://www.tu-chemnitz.de/etit/proaut/libRSF
+ *
+ * libRSF is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libRSF is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with libRSF.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Tim Pfeifer (tim.pfeifer@etit.tu-chemnitz.de)
+ ***************************************************************************/
+
+#include "SharedMemorySource.h"
+#include "RealTime.h"
+
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <limits>
+#include <new>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define LIBRSF_USE_SHM
+#endif
+
+namespace libRSF
+{
+  static const char RingMagic[4] = {'R', 'S', 'F', 'S'};
+  static const std::uint32_t RingVersion = 1;
+
+  /** records that are moved out of the ring before the lock of the source is taken */
+  static const int ReceiveBatchSize = 256;
+
+  /** idle iterations that are only yielded before the receiver starts to sleep */
+  static const int ReceiveSpinCount = 1000;
+
+  /** names of shared memory objects have to start with a slash */
+  static std::string GetSharedMemoryName(const std::string &Name)
+  {
+    return (!Name.empty() && Name.front() == '/') ? Name : "/" + Name;
+  }
+
+  /** the largest Data buffer of all configured types */
+  static std::uint32_t GetMaxRecordValues()
+  {
+    int MaxValues = 0;
+    for (int Type = 0; Type <= std::numeric_limits<std::uint8_t>::max(); Type++)
+    {
+      if (GlobalDataConfig.checkType(static_cast<DataType>(Type)))
+      {
+        MaxValues = std::max(MaxValues, GlobalDataConfig.getLayout(static_cast<DataType>(Type)).TotalSize);
+      }
+    }
+    return static_cast<std::uint32_t>(MaxValues);
+  }
+
+  SharedMemoryRing::~SharedMemoryRing()
+  {
+    this->unmap_();
+  }
+
+  bool SharedMemoryRing::create(const std::string &Name, const size_t Capacity)
+  {
+#ifdef LIBRSF_USE_SHM
+    this->unmap_();
+
+    /** the index is wrapped with a mask */
+    size_t Records = 1;
+    while (Records < Capacity)
+    {
+      Records <<= 1;
+    }
+
+    const std::uint32_t RecordValues = GetMaxRecordValues();
+    const size_t RecordBytes = 2 * sizeof(std::uint32_t) + RecordValues * sizeof(double);
+    const size_t Bytes = sizeof(HeaderType) + Records * RecordBytes;
+
+    /** a segment of a crashed producer is replaced */
+    const std::string ShmName = GetSharedMemoryName(Name);
+    int FileDescriptor = shm_open(ShmName.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (FileDescriptor < 0 && errno == EEXIST)
+    {
+      PRINT_WARNING("Replace existing shared memory: ", ShmName);
+      shm_unlink(ShmName.c_str());
+      FileDescriptor = shm_open(ShmName.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    }
+    if (FileDescriptor < 0)
+    {
+      PRINT_ERROR("Could not create shared memory: ", ShmName);
+      return false;
+    }
+
+    if (ftruncate(FileDescriptor, static_cast<off_t>(Bytes)) != 0 || !this->map_(FileDescriptor, Bytes))
+    {
+      PRINT_ERROR("Could not allocate shared memory: ", ShmName);
+      ::close(FileDescriptor);
+      shm_unlink(ShmName.c_str());
+      return false;
+    }
+    ::close(FileDescriptor);
+
+    /** the segment is zero initialized, the consumer waits for IsReady */
+    Header_ = new (Header_) HeaderType;
+    std::memcpy(Header_->Magic, RingMagic, sizeof(RingMagic));
+    Header_->Version = RingVersion;
+    Header_->RecordValues = RecordValues;
+    Header_->Reserved = 0;
+    Header_->Capacity = Records;
+    Header_->Head.store(0, std::memory_order_relaxed);
+    Header_->Tail.store(0, std::memory_order_relaxed);
+    Header_->IsClosed.store(0, std::memory_order_relaxed);
+    Header_->IsReady.store(1, std::memory_order_release);
+
+    RecordBytes_ = RecordBytes;
+    Name_ = ShmName;
+    IsCreator_ = true;
+    return true;
+#else
+    PRINT_ERROR("Shared memory is not supported on this platform: ", Name, " ", Capacity);
+    return false;
+#endif // LIBRSF_USE_SHM
+  }
+
+  bool SharedMemoryRing::open(const std::string &Name)
+  {
+#ifdef LIBRSF_USE_SHM
+    this->unmap_();
+
+    const std::string ShmName = GetSharedMemoryName(Name);
+    const int FileDescriptor = shm_open(ShmName.c_str(), O_RDWR, 0600);
+    if (FileDescriptor < 0)
+    {
+      return false;
+    }
+
+    struct stat FileStat {};
+    if (fstat(FileDescriptor, &FileStat) != 0 || static_cast<size_t>(FileStat.st_size) < sizeof(HeaderType)
+        || !this->map_(FileDescriptor, static_cast<size_t>(FileStat.st_size)))
+    {
+      ::close(FileDescriptor);
+      return false;
+    }
+    ::close(FileDescriptor);
+
+    /** check that both sides agree on the layout */
+    if (Header_->IsReady.load(std::memory_order_acquire) == 0)
+    {
+      this->unmap_();
+      return false;
+    }
+    const size_t RecordBytes = 2 * sizeof(std::uint32_t) + Header_->RecordValues * sizeof(double);
+    if (std::memcmp(Header_->Magic, RingMagic, sizeof(RingMagic)) != 0 || Header_->Version != RingVersion
+        || Header_->RecordValues != GetMaxRecordValues()
+        || MappedBytes_ != sizeof(HeaderType) + Header_->Capacity * RecordBytes)
+    {
+      PRINT_ERROR("Shared memory has an incompatible layout: ", ShmName);
+      this->unmap_();
+      return false;
+    }
+
+    RecordBytes_ = RecordBytes;
+    Name_ = ShmName;
+    IsCreator_ = false;
+    return true;
+#else
+    PRINT_ERROR("Shared memory is not supported on this platform: ", Name);
+    return false;
+#endif // LIBRSF_USE_SHM
+  }
+
+  bool SharedMemoryRing::isOpen() const
+  {
+    return Header_ != nullptr;
+  }
+
+  bool SharedMemoryRing::map_(const int FileDescriptor, const size_t Bytes)
+  {
+#ifdef LIBRSF_USE_SHM
+    void* Mapping = mmap(nullptr, Bytes, PROT_READ | PROT_WRITE, MAP_SHARED, FileDescriptor, 0);
+    if (Mapping == MAP_FAILED)
+    {
+      return false;
+    }
+
+    Header_ = static_cast<HeaderType*>(Mapping);
+    Records_ = static_cast<char*>(Mapping) + sizeof(HeaderType);
+    MappedBytes_ = Bytes;
+    return true;
+#else
+    static_cast<void>(FileDescriptor);
+    static_cast<void>(Bytes);
+    return false;
+#endif // LIBRSF_USE_SHM
+  }
+
+  void SharedMemoryRing::unmap_()
+  {
+#ifdef LIBRSF_USE_SHM
+    if (Header_ != nullptr)
+    {
+      munmap(Header_, MappedBytes_);
+      if (IsCreator_)
+      {
+        shm_unlink(Name_.c_str());
+      }
+    }
+#endif // LIBRSF_USE_SHM
+    Header_ = nullptr;
+    Records_ = nullptr;
+    MappedBytes_ = 0;
+    IsCreator_ = false;
+  }
+
+  std::uint32_t* SharedMemoryRing::getRecord_(const std::uint64_t Index) const
+  {
+    return reinterpret_cast<std::uint32_t*>(Records_ + (Index & (Header_->Capacity - 1)) * RecordBytes_);
+  }
+
+  bool SharedMemoryRing::push(const Data &Object)
+  {
+    if (Header_ == nullptr)
+    {
+      PRINT_ERROR("Shared memory is not open!");
+      return false;
+    }
+
+    const Data::BufferType &Values = Object.getBuffer();
+    if (Values.size() > Header_->RecordValues)
+    {
+      PRINT_ERROR("Object does not fit into a record: ", Object.getName());
+      return false;
+    }
+
+    const std::uint64_t Head = Header_->Head.load(std::memory_order_relaxed);
+    if (Head - Header_->Tail.load(std::memory_order_acquire) >= Header_->Capacity)
+    {
+      return false;
+    }
+
+    std::uint32_t* Record = this->getRecord_(Head);
+    Record[0] = static_cast<std::uint32_t>(Object.getType());
+    Record[1] = static_cast<std::uint32_t>(Values.size());
+    std::memcpy(Record + 2, Values.data(), Values.size() * sizeof(double));
+
+    /** publish the record */
+    Header_->Head.store(Head + 1, std::memory_order_release);
+    return true;
+  }
+
+  bool SharedMemoryRing::pop(Data &Object)
+  {
+    if (Header_ == nullptr)
+    {
+      return false;
+    }
+
+    std::uint64_t Tail = Header_->Tail.load(std::memory_order_relaxed);
+    const std::uint64_t Head = Header_->Head.load(std::memory_order_acquire);
+    while (Tail != Head)
+    {
+      const std::uint32_t* Record = this->getRecord_(Tail);
+      const auto Type = static_cast<DataType>(Record[0]);
+      const std::uint32_t Size = Record[1];
+      const bool IsValid = GlobalDataConfig.checkType(Type) && Size <= Header_->RecordValues
+                           && static_cast<int>(Size) == GlobalDataConfig.getLayout(Type).TotalSize;
+      if (IsValid)
+      {
+        /** the record has the alignment of a double behind the two integers */
+        Object = Data(Type, reinterpret_cast<const double*>(Record + 2), static_cast<Index>(Size));
+      }
+      else
+      {
+        PRINT_ERROR("Skip invalid record of type ", Record[0], " with ", Size, " values!");
+      }
+
+      /** release the record to the producer */
+      Tail++;
+      Header_->Tail.store(Tail, std::memory_order_release);
+
+      if (IsValid)
+      {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  void SharedMemoryRing::close()
+  {
+    if (Header_ != nullptr)
+    {
+      Header_->IsClosed.store(1, std::memory_order_release);
+    }
+  }
+
+  bool SharedMemoryRing::isFinished() const
+  {
+    if (Header_ == nullptr)
+    {
+      return true;
+    }
+
+    /** closed is read first, so no record that was pushed before closing is missed */
+    const bool IsClosed = Header_->IsClosed.load(std::memory_order_acquire) != 0;
+    return IsClosed && Header_->Head.load(std::memory_order_acquire) == Header_->Tail.load(std::memory_order_relaxed);
+  }
+
+  SensorDataSharedMemorySource::SensorDataSharedMemorySource(const std::string &Name, const double Timeout, const double Latency)
+  : Timeout_(Timeout), Buffer_(Latency)
+  {
+    /** the producer may start later */
+    const auto Deadline = std::chrono::steady_clock::now() + std::chrono::duration<double>(Timeout);
+    while (!Ring_.open(Name) && std::chrono::steady_clock::now() < Deadline)
+    {
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+
+    if (!Ring_.isOpen())
+    {
+      PRINT_ERROR("Could not open shared memory: ", Name);
+      IsFinished_ = true;
+      return;
+    }
+
+    Worker_ = std::thread(&SensorDataSharedMemorySource::receive_, this);
+  }
+
+  SensorDataSharedMemorySource::~SensorDataSharedMemorySource()
+  {
+    {
+      std::lock_guard<std::mutex> Lock(Mutex_);
+      Stop_ = true;
+    }
+    Condition_.notify_all();
+
+    if (Worker_.joinable())
+    {
+      Worker_.join();
+    }
+  }
+
+  void SensorDataSharedMemorySource::receive_()
+  {
+    ApplyRealTimeThread(RealTimeThread::Ingestion);
+
+    std::vector<Data> Batch;
+    Batch.reserve(ReceiveBatchSize);
+    int IdleCount = 0;
+
+    while (true)
+    {
+      /** pop without holding the lock, the ring is only used by this thread */
+      Data Object;
+      while (static_cast<int>(Batch.size()) < ReceiveBatchSize && Ring_.pop(Object))
+      {
+        Batch.push_back(std::move(Object));
+      }
+      const bool IsFinished = Batch.empty() && Ring_.isFinished();
+
+      {
+        std::lock_guard<std::mutex> Lock(Mutex_);
+        if (Stop_)
+        {
+          return;
+        }
+
+        for (Data &Received : Batch)
+        {
+          const DataType Type = Received.getType();
+          const double Timestamp = roundToTick(Received.getTimestamp());
+          const auto First = TimeFirst_.find(Type);
+          if (First == TimeFirst_.end())
+          {
+            TimeFirst_[Type] = Timestamp;
+            TimeLast_[Type] = Timestamp;
+          }
+          else
+          {
+            First->second = std::min(First->second, Timestamp);
+            TimeLast_[Type] = std::max(TimeLast_[Type], Timestamp);
+          }
+          Buffer_.add(Received);
+        }
+        IsFinished_ = IsFinished;
+      }
+
+      if (!Batch.empty() || IsFinished)
+      {
+        Condition_.notify_all();
+      }
+      if (IsFinished)
+      {
+        return;
+      }
+
+      /** spin shortly to keep the latency low, then back off */
+      if (Batch.empty())
+      {
+        if (++IdleCount < ReceiveSpinCount)
+        {
+          std::this_thread::yield();
+        }
+        else
+        {
+          std::this_thread::sleep_for(std::chrono::microseconds(50));
+        }
+      }
+      else
+      {
+        IdleCount = 0;
+      }
+      Batch.clear();
+    }
+  }
+
+  template <typename ConditionType>
+  bool SensorDataSharedMemorySource::waitFor_(std::unique_lock<std::mutex> &Lock, ConditionType Condition) const
+  {
+    Condition_.wait_for(Lock, std::chrono::duration<double>(Timeout_), [&]{ return IsFinished_ || Condition(); });
+    return Condition();
+  }
+
+  void SensorDataSharedMemorySource::getMeasurementsUntil(const double Timestamp, SensorDataSet &Data)
+  {
+    std::unique_lock<std::mutex> Lock(Mutex_);
+
+    /** a record that is newer by the latency bound completes the requested interval */
+    if (!this->waitFor_(Lock, [&]{ return Buffer_.isComplete(Timestamp); }) && !IsFinished_)
+    {
+      PRINT_WARNING("Timeout while waiting for measurements until ", Timestamp);
+    }
+
+    Buffer_.release(Timestamp, Data);
+  }
+
+  bool SensorDataSharedMemorySource::getLateMeasurements(SensorDataSet &Data)
+  {
+    const std::lock_guard<std::mutex> Lock(Mutex_);
+    return Buffer_.releaseLate(Data);
+  }
+
+  bool SensorDataSharedMemorySource::getTimeFirst(const DataType Type, double &Timestamp) const
+  {
+    std::unique_lock<std::mutex> Lock(Mutex_);
+    if (!this->waitFor_(Lock, [&]{ return TimeFirst_.count(Type) > 0; }))
+    {
+      return false;
+    }
+    Timestamp = TimeFirst_.at(Type);
+    return true;
+  }
+
+  bool SensorDataSharedMemorySource::getTimeLast(const DataType Type, double &Timestamp) const
+  {
+    const std::lock_guard<std::mutex> Lock(Mutex_);
+    if (!IsFinished_)
+    {
+      Timestamp = std::numeric_limits<double>::infinity();
+      return true;
+    }
+
+    const auto It = TimeLast_.find(Type);
+    if (It == TimeLast_.end())
+    {
+      return false;
+    }
+    Timestamp = It->second;
+    return true;
+  }
+
+  bool SensorDataSharedMemorySource::getTimeNext(const DataType Type, const double Timestamp, double &NextTimestamp)
+  {
+    std::unique_lock<std::mutex> Lock(Mutex_);
+    const double Time = roundToTick(Timestamp);
+    if (!this->waitFor_(Lock, [&]{ const auto It = TimeLast_.find(Type); return It != TimeLast_.end() && It->second > Time; }))
+    {
+      return false;
+    }
+
+    /** the interface guarantees that nothing after Timestamp was moved out of the buffer */
+    SensorDataSet::TimeCursor Cursor = Buffer_.getBuffer().cursor(Type);
+    if (!Cursor.seekAbove(Time))
+    {
+      return false;
+    }
+    NextTimestamp = Cursor.getTime();
+    return true;
+  }
+
+  std::vector<DataType> SensorDataSharedMemorySource::getKeysAll() const
+  {
+    const std::lock_guard<std::mutex> Lock(Mutex_);
+    std::vector<DataType> Keys;
+    for (const auto &Entry : TimeFirst_)
+    {
+      Keys.push_back(Entry.first);
+    }
+    return Keys;
+  }
+}
@@ -29,18 +29,12 @@ namespace libRSF
     addElement(Element.getName(),Element);
   }
 
-  void StateDataSet::addElement(const std::string& Name, const Data &Element)
+  void StateDataSet::addElement(const StateKey& Name, const Data &Element)
   {
-    if (!this->checkID(Name))
-    {
-      ObjectStream TempStream;
-      DataStreams.emplace(Name, TempStream);
-    }
-
-    DataStreams[Name].emplace(Element.getTimestamp(), Element);
+    DataSet::addElement(Name, Element.getTimestamp(), Element);
   }
 
-  void StateDataSet::addElement(const std::string& Name, DataType Type, double Timestamp)
+  void StateDataSet::addElement(const StateKey& Name, DataType Type, double Timestamp)
   {
     Data Element(Type, Timestamp);
     addElement(Name, Element);
@@ -48,7 +42,7 @@ namespace libRSF
 
   std::ostream& operator << (std::ostream& Os, const StateID& ID)
   {
-    Os << ID.ID << " " << ID.Timestamp << " " << ID.Number << " ";
+    Os << ID.ID << " " << ID.getTimestamp() << " " << ID.Number << " ";
     return Os;
   }
 }
@@ -0,0 +1,89 @@
+/***************************************************************************
+ * libRSF - A Robust Sensor Fusion Library
+ *
+ * Copyright (C) 2018 Chair of Automation Technology / TU Chemnitz
+ * For more information see https://www.tu-chemnitz.de/etit/proaut/libRSF
+ *
+ * libRSF is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libRSF is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with libRSF.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Tim Pfeifer (tim.pfeifer@etit.tu-chemnitz.de)
+ ***************************************************************************/
+
+#include "StateKey.h"
+
+#include <mutex>
+#include <unordered_map>
+
+namespace libRSF
+{
+  namespace
+  {
+    /** the node based map keeps the address of each name stable */
+    struct StateKeyRegistry
+    {
+      /** the empty name is always registered with ID 0 */
+      StateKeyRegistry() : IDs({{std::string(), 0}}), Empty(&IDs.begin()->first)
+      {}
+
+      std::mutex Mutex;
+      std::unordered_map<std::string, int> IDs;
+      const std::string *Empty;
+    };
+
+    StateKeyRegistry &GetRegistry()
+    {
+      static StateKeyRegistry Registry;
+      return Registry;
+    }
+
+    void Register(const std::string &Name, int &ID, const std::string* &NamePointer)
+    {
+      StateKeyRegistry &Registry = GetRegistry();
+      std::lock_guard<std::mutex> Lock(Registry.Mutex);
+
+      const auto Result = Registry.IDs.emplace(Name, static_cast<int>(Registry.IDs.size()));
+      ID = Result.first->second;
+      NamePointer = &Result.first->first;
+    }
+  }
+
+  StateKey::StateKey() : ID_(0), Name_(GetRegistry().Empty)
+  {}
+
+  StateKey::StateKey(const std::string &Name)
+  {
+    Register(Name, ID_, Name_);
+  }
+
+  StateKey::StateKey(const char *Name)
+  {
+    Register(std::string(Name), ID_, Name_);
+  }
+
+  std::ostream& operator << (std::ostream& Os, const StateKey& Key)
+  {
+    Os << Key.getName();
+    return Os;
+  }
+
+  std::string operator + (const StateKey& Key, const std::string& Suffix)
+  {
+    return Key.getName() + Suffix;
+  }
+
+  std::string operator + (const std::string& Prefix, const StateKey& Key)
+  {
+    return Prefix + Key.getName();
+  }
+}
@@ -0,0 +1,386 @@
+/***************************************************************************
+ * libRSF - A Robust Sensor Fusion Library
+ *
+ * Copyright (C) 2019 Chair of Automation Technology / TU Chemnitz
+ * For more information see https://www.tu-chemnitz.de/etit/proaut/libRSF
+ *
+ * libRSF is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libRSF is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with libRSF.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Tim Pfeifer (tim.pfeifer@etit.tu-chemnitz.de)
+ ***************************************************************************/
+
+#include "StatePublisher.h"
+
+#include <cstring>
+#include <new>
+#include <thread>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define LIBRSF_USE_SHM
+#endif
+
+namespace libRSF
+{
+  /** layout (native byte order): this header, the zero terminated names of all slots and the seqlock protected words
+   *  one slot consists of timestamp, dimension, covariance flag, mean[Dimension] and covariance[Dimension^2] */
+  struct StateSnapshotBlock
+  {
+    char Magic[4];
+    std::uint32_t Version;
+    std::uint32_t Slots;
+    std::uint32_t Dimension;
+    std::atomic<std::uint32_t> IsReady;
+    alignas(64) std::atomic<std::uint64_t> Sequence; /**< odd while the publisher is writing */
+  };
+
+  static_assert(std::atomic<std::uint64_t>::is_always_lock_free, "Snapshots require lock-free atomics!");
+
+  static const char SnapshotMagic[4] = {'R', 'S', 'F', 'P'};
+  static const std::uint32_t SnapshotVersion = 1;
+  static const size_t SnapshotNameLength = 64;
+
+  /** a reader gives up after this many overlapping publications */
+  static const int SnapshotReadAttempts = 64;
+
+  static size_t GetSlotWords(const size_t Dimension)
+  {
+    return 3 + Dimension + Dimension * Dimension;
+  }
+
+  static size_t GetWordOffset(const size_t Slots)
+  {
+    const size_t Offset = sizeof(StateSnapshotBlock) + Slots * SnapshotNameLength;
+    return (Offset + alignof(std::atomic<std::uint64_t>) - 1) / alignof(std::atomic<std::uint64_t>) * alignof(std::atomic<std::uint64_t>);
+  }
+
+  static size_t GetBlockBytes(const size_t Slots, const size_t Dimension)
+  {
+    return GetWordOffset(Slots) + Slots * GetSlotWords(Dimension) * sizeof(std::atomic<std::uint64_t>);
+  }
+
+  static char* GetNames(StateSnapshotBlock* Block)
+  {
+    return reinterpret_cast<char*>(Block) + sizeof(StateSnapshotBlock);
+  }
+
+  static std::atomic<std::uint64_t>* GetWords(const StateSnapshotBlock* Block)
+  {
+    return reinterpret_cast<std::atomic<std::uint64_t>*>(reinterpret_cast<char*>(const_cast<StateSnapshotBlock*>(Block)) + GetWordOffset(Block->Slots));
+  }
+
+  static std::uint64_t ToWord(const double Value)
+  {
+    std::uint64_t Word;
+    std::memcpy(&Word, &Value, sizeof(Word));
+    return Word;
+  }
+
+  static double FromWord(const std::uint64_t Word)
+  {
+    double Value;
+    std::memcpy(&Value, &Word, sizeof(Value));
+    return Value;
+  }
+
+  static std::string GetSnapshotMemoryName(const std::string &Name)
+  {
+    return (!Name.empty() && Name.front() == '/') ? Name : "/" + Name;
+  }
+
+  /** construct header, names and words in raw memory */
+  static StateSnapshotBlock* InitializeBlock(void* Memory, const std::vector<StateKey> &Keys, const size_t Dimension)
+  {
+    auto* Block = new (Memory) StateSnapshotBlock;
+    std::memcpy(Block->Magic, SnapshotMagic, sizeof(SnapshotMagic));
+    Block->Version = SnapshotVersion;
+    Block->Slots = static_cast<std::uint32_t>(Keys.size());
+    Block->Dimension = static_cast<std::uint32_t>(Dimension);
+    Block->Sequence.store(0, std::memory_order_relaxed);
+
+    char* Names = GetNames(Block);
+    for (size_t Slot = 0; Slot < Keys.size(); Slot++)
+    {
+      std::strncpy(Names + Slot * SnapshotNameLength, Keys.at(Slot).getName().c_str(), SnapshotNameLength - 1);
+    }
+
+    std::atomic<std::uint64_t>* Words = new (GetWords(Block)) std::atomic<std::uint64_t>[Keys.size() * GetSlotWords(Dimension)];
+    for (size_t Slot = 0; Slot < Keys.size(); Slot++)
+    {
+      Words[Slot * GetSlotWords(Dimension)].store(ToWord(NAN_DOUBLE), std::memory_order_relaxed);
+    }
+
+    Block->IsReady.store(1, std::memory_order_release);
+    return Block;
+  }
+
+  /** seqlock read, the words are copied first and only decoded if no publication overlapped */
+  static bool ReadBlock(const StateSnapshotBlock* Block, StateSnapshot &Snapshot)
+  {
+    if (Block == nullptr)
+    {
+      return false;
+    }
+
+    const size_t Slots = Block->Slots;
+    const size_t Dimension = Block->Dimension;
+    const size_t SlotWords = GetSlotWords(Dimension);
+    const std::atomic<std::uint64_t>* Words = GetWords(Block);
+
+    std::vector<std::uint64_t> Copy(Slots * SlotWords);
+    std::uint64_t Sequence = 0;
+    bool IsConsistent = false;
+    for (int Attempt = 0; Attempt < SnapshotReadAttempts && !IsConsistent; Attempt++)
+    {
+      Sequence = Block->Sequence.load(std::memory_order_acquire);
+      if ((Sequence & 1U) != 0)
+      {
+        std::this_thread::yield();
+        continue;
+      }
+
+      for (size_t Word = 0; Word < Copy.size(); Word++)
+      {
+        Copy[Word] = Words[Word].load(std::memory_order_relaxed);
+      }
+
+      std::atomic_thread_fence(std::memory_order_acquire);
+      IsConsistent = (Block->Sequence.load(std::memory_order_relaxed) == Sequence);
+    }
+
+    if (!IsConsistent)
+    {
+      return false;
+    }
+
+    /** decode */
+    const char* Names = reinterpret_cast<const char*>(Block) + sizeof(StateSnapshotBlock);
+    Snapshot.Version = Sequence / 2;
+    Snapshot.Entries.resize(Slots);
+    for (size_t Slot = 0; Slot < Slots; Slot++)
+    {
+      const std::uint64_t* SlotCopy = Copy.data() + Slot * SlotWords;
+      StateSnapshot::Entry &Entry = Snapshot.Entries.at(Slot);
+
+      Entry.Name.assign(Names + Slot * SnapshotNameLength, strnlen(Names + Slot * SnapshotNameLength, SnapshotNameLength));
+      Entry.Timestamp = FromWord(SlotCopy[0]);
+      const auto Size = static_cast<Index>(std::isnan(Entry.Timestamp) ? 0 : SlotCopy[1]);
+      const bool HasCovariance = (SlotCopy[2] != 0);
+
+      Entry.Mean.resize(Size);
+      for (Index n = 0; n < Size; n++)
+      {
+        Entry.Mean(n) = FromWord(SlotCopy[3 + n]);
+      }
+
+      Entry.Covariance.resize(HasCovariance ? Size : 0, HasCovariance ? Size : 0);
+      for (Index n = 0; n < Entry.Covariance.size(); n++)
+      {
+        Entry.Covariance.data()[n] = FromWord(SlotCopy[3 + Dimension + n]);
+      }
+    }
+    return true;
+  }
+
+  StatePublisher::StatePublisher(const std::vector<StateKey> &Keys, const int MaxDimension, const std::string &SharedMemoryName)
+  : Keys_(Keys)
+  {
+    const size_t Dimension = static_cast<size_t>(std::max(1, MaxDimension));
+    Bytes_ = GetBlockBytes(Keys.size(), Dimension);
+
+#ifdef LIBRSF_USE_SHM
+    if (!SharedMemoryName.empty())
+    {
+      const std::string Name = GetSnapshotMemoryName(SharedMemoryName);
+      shm_unlink(Name.c_str()); /**< remove the segment of a crashed publisher */
+      const int FileDescriptor = shm_open(Name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+      if (FileDescriptor >= 0 && ftruncate(FileDescriptor, static_cast<off_t>(Bytes_)) == 0)
+      {
+        void* Mapping = mmap(nullptr, Bytes_, PROT_READ | PROT_WRITE, MAP_SHARED, FileDescriptor, 0);
+        if (Mapping != MAP_FAILED)
+        {
+          Block_ = InitializeBlock(Mapping, Keys, Dimension);
+          SharedMemoryName_ = Name;
+        }
+      }
+      if (FileDescriptor >= 0)
+      {
+        close(FileDescriptor);
+      }
+      if (Block_ == nullptr)
+      {
+        PRINT_ERROR("Could not create shared memory: ", Name, ", snapshots are only available in this process!");
+        shm_unlink(Name.c_str());
+      }
+    }
+#else
+    if (!SharedMemoryName.empty())
+    {
+      PRINT_ERROR("Shared memory is not supported on this platform: ", SharedMemoryName);
+    }
+#endif // LIBRSF_USE_SHM
+
+    if (Block_ == nullptr)
+    {
+      Block_ = InitializeBlock(::operator new(Bytes_, std::align_val_t(64)), Keys, Dimension);
+    }
+  }
+
+  StatePublisher::~StatePublisher()
+  {
+#ifdef LIBRSF_USE_SHM
+    if (!SharedMemoryName_.empty())
+    {
+      munmap(Block_, Bytes_);
+      shm_unlink(SharedMemoryName_.c_str());
+      return;
+    }
+#endif // LIBRSF_USE_SHM
+    ::operator delete(Block_, std::align_val_t(64));
+  }
+
+  void StatePublisher::publish(const StateDataSet &States)
+  {
+    const size_t Dimension = Block_->Dimension;
+    const size_t SlotWords = GetSlotWords(Dimension);
+    std::atomic<std::uint64_t>* Words = GetWords(Block_);
+
+    /** mark the block as inconsistent */
+    const std::uint64_t Sequence = Block_->Sequence.load(std::memory_order_relaxed);
+    Block_->Sequence.store(Sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    for (size_t Slot = 0; Slot < Keys_.size(); Slot++)
+    {
+      std::atomic<std::uint64_t>* SlotWord = Words + Slot * SlotWords;
+
+      double Timestamp;
+      if (!States.getTimeLast(Keys_.at(Slot), Timestamp))
+      {
+        SlotWord[0].store(ToWord(NAN_DOUBLE), std::memory_order_relaxed);
+        continue;
+      }
+
+      /** the buffers are read in place, so publishing does not allocate */
+      const Data &State = States.getStream(Keys_.at(Slot)).at(Timestamp, 0);
+      const VectorRefConst<double, Dynamic> Mean = State.getValue(DataElement::Mean);
+      if (static_cast<size_t>(Mean.size()) > Dimension)
+      {
+        SlotWord[0].store(ToWord(NAN_DOUBLE), std::memory_order_relaxed);
+        continue;
+      }
+
+      const bool HasCovariance = State.checkElement(DataElement::Covariance)
+                                 && State.getValue(DataElement::Covariance).size() == Mean.size() * Mean.size();
+      SlotWord[0].store(ToWord(Timestamp), std::memory_order_relaxed);
+      SlotWord[1].store(static_cast<std::uint64_t>(Mean.size()), std::memory_order_relaxed);
+      SlotWord[2].store(HasCovariance ? 1 : 0, std::memory_order_relaxed);
+      for (Index n = 0; n < Mean.size(); n++)
+      {
+        SlotWord[3 + n].store(ToWord(Mean(n)), std::memory_order_relaxed);
+      }
+      if (HasCovariance)
+      {
+        const VectorRefConst<double, Dynamic> Covariance = State.getValue(DataElement::Covariance);
+        for (Index n = 0; n < Covariance.size(); n++)
+        {
+          SlotWord[3 + Dimension + n].store(ToWord(Covariance(n)), std::memory_order_relaxed);
+        }
+      }
+    }
+
+    /** publish */
+    Block_->Sequence.store(Sequence + 2, std::memory_order_release);
+  }
+
+  bool StatePublisher::read(StateSnapshot &Snapshot) const
+  {
+    return ReadBlock(Block_, Snapshot);
+  }
+
+  StateSubscriber::~StateSubscriber()
+  {
+    this->close_();
+  }
+
+  bool StateSubscriber::open(const std::string &SharedMemoryName)
+  {
+    this->close_();
+
+#ifdef LIBRSF_USE_SHM
+    const std::string Name = GetSnapshotMemoryName(SharedMemoryName);
+    const int FileDescriptor = shm_open(Name.c_str(), O_RDONLY, 0600);
+    if (FileDescriptor < 0)
+    {
+      return false;
+    }
+
+    /** readers never write, the seqlock only requires atomic loads */
+    struct stat FileStat {};
+    void* Mapping = MAP_FAILED;
+    if (fstat(FileDescriptor, &FileStat) == 0 && static_cast<size_t>(FileStat.st_size) >= sizeof(StateSnapshotBlock))
+    {
+      Mapping = mmap(nullptr, static_cast<size_t>(FileStat.st_size), PROT_READ, MAP_SHARED, FileDescriptor, 0);
+    }
+    close(FileDescriptor);
+    if (Mapping == MAP_FAILED)
+    {
+      return false;
+    }
+
+    Block_ = static_cast<StateSnapshotBlock*>(Mapping);
+    Bytes_ = static_cast<size_t>(FileStat.st_size);
+
+    /** check that both sides agree on the layout */
+    if (Block_->IsReady.load(std::memory_order_acquire) == 0
+        || std::memcmp(Block_->Magic, SnapshotMagic, sizeof(SnapshotMagic)) != 0
+        || Block_->Version != SnapshotVersion
+        || Bytes_ != GetBlockBytes(Block_->Slots, Block_->Dimension))
+    {
+      PRINT_ERROR("Shared memory has an incompatible layout: ", Name);
+      this->close_();
+      return false;
+    }
+    return true;
+#else
+    PRINT_ERROR("Shared memory is not supported on this platform: ", SharedMemoryName);
+    return false;
+#endif // LIBRSF_USE_SHM
+  }
+
+  bool StateSubscriber::isOpen() const
+  {
+    return Block_ != nullptr;
+  }
+
+  bool StateSubscriber::read(StateSnapshot &Snapshot) const
+  {
+    return ReadBlock(Block_, Snapshot);
+  }
+
+  void StateSubscriber::close_()
+  {
+#ifdef LIBRSF_USE_SHM
+    if (Block_ != nullptr)
+    {
+      munmap(Block_, Bytes_);
+    }
+#endif // LIBRSF_USE_SHM
+    Block_ = nullptr;
+    Bytes_ = 0;
+  }
+}
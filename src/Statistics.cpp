@@ -24,23 +24,46 @@
 
 namespace libRSF
 {
+  double MedianInPlace(double* Values, const size_t Size)
+  {
+    const size_t n = Size / 2;
+    std::nth_element(Values, Values + n, Values + Size);
+    return Values[n];
+  }
+
   double Median(const std::vector<double> &V)
   {
     std::vector<double> VCopy = V;
-    int n = static_cast<int>(VCopy.size()) / 2;
-    std::nth_element(VCopy.begin(), VCopy.begin() + n, VCopy.end());
-    return VCopy[n];
+    return MedianInPlace(VCopy.data(), VCopy.size());
   }
 
   double Median(const Vector &V)
   {
-    std::vector<double> Vec(V.data(), V.data() + V.rows() * V.cols());
-    return Median(Vec);
+    std::vector<double> Scratch;
+    return Median(V, Scratch);
+  }
+
+  double Median(const Vector &V, std::vector<double> &Scratch)
+  {
+    Scratch.assign(V.data(), V.data() + V.size());
+    return MedianInPlace(Scratch.data(), Scratch.size());
   }
 
   double MAD(const Vector &V)
   {
-    return Median((V.array() - Median(V)).abs().matrix());
+    std::vector<double> Scratch;
+    return MAD(V, Scratch);
+  }
+
+  double MAD(const Vector &V, std::vector<double> &Scratch)
+  {
+    const double MedianValue = Median(V, Scratch);
+
+    /** the order does not matter for the second median, so the deviations overwrite the reordered copy */
+    VectorRef<double, Dynamic> Deviation(Scratch.data(), static_cast<Index>(Scratch.size()));
+    Deviation = (Deviation.array() - MedianValue).abs();
+
+    return MedianInPlace(Scratch.data(), Scratch.size());
   }
 
   double EstimateMADCovariance(const Vector &V)
@@ -48,6 +71,11 @@ namespace libRSF
     return MAD(V) * 1.4826;
   }
 
+  double EstimateMADCovariance(const Vector &V, std::vector<double> &Scratch)
+  {
+    return MAD(V, Scratch) * 1.4826;
+  }
+
   double RMSE(const Vector &V)
   {
     return sqrt(V.squaredNorm() / static_cast<double>(V.size()));
@@ -0,0 +1,275 @@
+/***************************************************************************
+ * libRSF - A Robust Sensor Fusion Library
+ *
+ * Copyright (C) 2018 Chair of Automation Technology / TU Chemnitz
+ * For more information see https://www.tu-chemnitz.de/etit/proaut/libRSF
+ *
+ * libRSF is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libRSF is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with libRSF.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Tim Pfeifer (tim.pfeifer@etit.tu-chemnitz.de)
+ ***************************************************************************/
+
+#include "ThreadPool.h"
+#include "Messages.h"
+
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <map>
+#include <memory>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace libRSF
+{
+  namespace
+  {
+    int ResolveThreadNumber(const int ThreadNumber)
+    {
+      return (ThreadNumber > 0) ? ThreadNumber : std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    }
+
+#ifdef __linux__
+    /** allowed cores in the order of the affinity policy */
+    std::vector<int> OrderCores(const ThreadAffinity Affinity)
+    {
+      cpu_set_t Allowed;
+      CPU_ZERO(&Allowed);
+      sched_getaffinity(0, sizeof(Allowed), &Allowed);
+
+      std::map<int, std::vector<int>> CoresPerSocket;
+      for (int Core = 0; Core < CPU_SETSIZE; Core++)
+      {
+        if (CPU_ISSET(Core, &Allowed))
+        {
+          int Socket = 0;
+          std::ifstream File("/sys/devices/system/cpu/cpu" + std::to_string(Core) + "/topology/physical_package_id");
+          File >> Socket;
+          CoresPerSocket[Socket].push_back(Core);
+        }
+      }
+
+      std::vector<int> Cores;
+      if (Affinity == ThreadAffinity::Compact)
+      {
+        for (const auto &Socket : CoresPerSocket)
+        {
+          Cores.insert(Cores.end(), Socket.second.begin(), Socket.second.end());
+        }
+      }
+      else
+      {
+        for (size_t n = 0; Cores.size() < static_cast<size_t>(CPU_COUNT(&Allowed)); n++)
+        {
+          for (const auto &Socket : CoresPerSocket)
+          {
+            if (n < Socket.second.size())
+            {
+              Cores.push_back(Socket.second.at(n));
+            }
+          }
+        }
+      }
+      return Cores;
+    }
+
+    void PinThread(std::thread::native_handle_type Thread, const int Core)
+    {
+      cpu_set_t Set;
+      CPU_ZERO(&Set);
+      CPU_SET(Core, &Set);
+      if (pthread_setaffinity_np(Thread, sizeof(Set), &Set) != 0)
+      {
+        PRINT_WARNING("Could not pin thread to core ", Core);
+      }
+    }
+#endif
+
+    std::mutex GlobalMutex;
+    ThreadPoolConfig GlobalConfig;
+    std::unique_ptr<ThreadPool> GlobalPool;
+  }
+
+  ThreadPool::ThreadPool(const ThreadPoolConfig &Config)
+  {
+    const int ThreadNumber = ResolveThreadNumber(Config.ThreadNumber);
+    for (int n = 1; n < ThreadNumber; n++)
+    {
+      Workers_.emplace_back(&ThreadPool::work_, this);
+    }
+
+    if (Config.Affinity != ThreadAffinity::None)
+    {
+#ifdef __linux__
+      /** the calling thread is the first one */
+      const std::vector<int> Cores = OrderCores(Config.Affinity);
+      if (!Cores.empty())
+      {
+        PinThread(pthread_self(), Cores.front());
+        for (size_t n = 0; n < Workers_.size(); n++)
+        {
+          PinThread(Workers_.at(n).native_handle(), Cores.at((n + 1) % Cores.size()));
+        }
+      }
+#else
+      PRINT_WARNING("Thread affinity is only supported on Linux!");
+#endif
+    }
+  }
+
+  ThreadPool::~ThreadPool()
+  {
+    {
+      std::lock_guard<std::mutex> Lock(Mutex_);
+      Stop_ = true;
+    }
+    Condition_.notify_all();
+
+    for (std::thread &Worker : Workers_)
+    {
+      Worker.join();
+    }
+  }
+
+  int ThreadPool::getThreadNumber() const
+  {
+    return static_cast<int>(Workers_.size()) + 1;
+  }
+
+  void ThreadPool::work_()
+  {
+    while (true)
+    {
+      std::function<void()> Task;
+      {
+        std::unique_lock<std::mutex> Lock(Mutex_);
+        Condition_.wait(Lock, [this] {return Stop_ || !Tasks_.empty();});
+        if (Tasks_.empty())
+        {
+          return;
+        }
+        Task = std::move(Tasks_.front());
+        Tasks_.pop_front();
+      }
+      Task();
+    }
+  }
+
+  void ThreadPool::parallelFor(const size_t ChunkNumber, const std::function<void(size_t)> &Function, const int MaxThreads)
+  {
+    int Threads = this->getThreadNumber();
+    if (MaxThreads > 0)
+    {
+      Threads = std::min(Threads, MaxThreads);
+    }
+    Threads = static_cast<int>(std::min<size_t>(static_cast<size_t>(Threads), ChunkNumber));
+
+    if (Threads <= 1)
+    {
+      for (size_t Chunk = 0; Chunk < ChunkNumber; Chunk++)
+      {
+        Function(Chunk);
+      }
+      return;
+    }
+
+    /** helpers that start after all chunks are taken return immediately, so the state outlives this call */
+    struct SharedState
+    {
+      std::atomic<size_t> Next{0};
+      std::atomic<size_t> Done{0};
+      std::mutex Mutex;
+      std::condition_variable Finished;
+    };
+    const auto State = std::make_shared<SharedState>();
+
+    auto Run = [State, &Function, ChunkNumber]()
+    {
+      for (size_t Chunk = State->Next++; Chunk < ChunkNumber; Chunk = State->Next++)
+      {
+        Function(Chunk);
+        if (++State->Done == ChunkNumber)
+        {
+          std::lock_guard<std::mutex> Lock(State->Mutex);
+          State->Finished.notify_all();
+        }
+      }
+    };
+
+    {
+      std::lock_guard<std::mutex> Lock(Mutex_);
+      for (int n = 1; n < Threads; n++)
+      {
+        Tasks_.emplace_back(Run);
+      }
+    }
+    Condition_.notify_all();
+
+    Run();
+
+    std::unique_lock<std::mutex> Lock(State->Mutex);
+    State->Finished.wait(Lock, [&State, ChunkNumber] {return State->Done == ChunkNumber;});
+  }
+
+  void ThreadPool::parallelRun(const int Threads, const std::function<void(size_t)> &Function)
+  {
+    this->parallelFor(static_cast<size_t>(std::max(1, Threads)), Function, Threads);
+  }
+
+  bool SetThreadPoolConfig(const ThreadPoolConfig &Config)
+  {
+    std::lock_guard<std::mutex> Lock(GlobalMutex);
+    if (GlobalPool)
+    {
+      PRINT_WARNING("The thread pool is already in use, the new config is ignored.");
+      return false;
+    }
+    GlobalConfig = Config;
+    return true;
+  }
+
+  int GetThreadNumber()
+  {
+    std::lock_guard<std::mutex> Lock(GlobalMutex);
+    return ResolveThreadNumber(GlobalConfig.ThreadNumber);
+  }
+
+  ThreadPool &GetThreadPool()
+  {
+    std::lock_guard<std::mutex> Lock(GlobalMutex);
+    if (!GlobalPool)
+    {
+      GlobalPool = std::make_unique<ThreadPool>(GlobalConfig);
+    }
+    return *GlobalPool;
+  }
+
+  void RunConcurrently(const std::vector<std::function<void()>> &Tasks, const int MaxThreads)
+  {
+    GetThreadPool().parallelFor(Tasks.size(), [&Tasks](const size_t nTask)
+    {
+      Tasks.at(nTask)();
+    }, MaxThreads);
+  }
+
+  ceres::Context *GetCeresContext()
+  {
+    /** never deleted, problems may be destroyed during static destruction */
+    static ceres::Context * const Context = ceres::Context::Create();
+    return Context;
+  }
+}
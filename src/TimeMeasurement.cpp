@@ -22,6 +22,9 @@
 
 #include "TimeMeasurement.h"
 
+#include <algorithm>
+#include <limits>
+
 namespace libRSF
 {
   Timer::Timer()
@@ -58,4 +61,40 @@ namespace libRSF
     return TimeDifference;
   }
 
+  Deadline::Deadline() : End_(TimestampType::max()), IsFinite_(false)
+  {}
+
+  Deadline::Deadline(const double Seconds) :
+      End_(std::chrono::steady_clock::now() + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(Seconds))),
+      IsFinite_(true)
+  {}
+
+  bool Deadline::isFinite() const
+  {
+    return IsFinite_;
+  }
+
+  bool Deadline::hasPassed() const
+  {
+    return IsFinite_ && std::chrono::steady_clock::now() >= End_;
+  }
+
+  double Deadline::getRemainingSeconds() const
+  {
+    if (!IsFinite_)
+    {
+      return std::numeric_limits<double>::infinity();
+    }
+    return std::chrono::duration<double>(End_ - std::chrono::steady_clock::now()).count();
+  }
+
+  Deadline Deadline::getFraction(const double Fraction) const
+  {
+    if (!IsFinite_)
+    {
+      return Deadline();
+    }
+    return Deadline(std::max(this->getRemainingSeconds(), 0.0) * Fraction);
+  }
+
 }
@@ -0,0 +1,242 @@
+/***************************************************************************
+ * libRSF - A Robust Sensor Fusion Library
+ *
+ * Copyright (C) 2018 Chair of Automation Technology / TU Chemnitz
+ * For more information see https://www.tu-chemnitz.de/etit/proaut/libRSF
+ *
+ * libRSF is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libRSF is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with libRSF.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Tim Pfeifer (tim.pfeifer@etit.tu-chemnitz.de)
+ ***************************************************************************/
+
+#include "Tracing.h"
+#include "AllocationTracking.h"
+#include "Messages.h"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace libRSF
+{
+#ifdef LIBRSF_TRACING
+  namespace
+  {
+    struct TraceEvent
+    {
+      const char* Name;
+      long long Begin;
+      long long End;
+      std::uint64_t Allocations;
+    };
+
+    /** single producer buffer of one thread, chunks are never moved so the exporter can read without locks */
+    class TraceBuffer
+    {
+      public:
+        static constexpr size_t ChunkSize = 4096;
+        static constexpr size_t ChunkNumber = 1024;
+
+        explicit TraceBuffer(const int ThreadID) : ThreadID_(ThreadID)
+        {
+          for (std::atomic<TraceEvent*> &Chunk : Chunks_)
+          {
+            Chunk.store(nullptr, std::memory_order_relaxed);
+          }
+        }
+
+        ~TraceBuffer()
+        {
+          for (std::atomic<TraceEvent*> &Chunk : Chunks_)
+          {
+            delete[] Chunk.load(std::memory_order_relaxed);
+          }
+        }
+
+        void add(const TraceEvent &Event)
+        {
+          const size_t Index = Size_.load(std::memory_order_relaxed);
+          const size_t ChunkIndex = Index / ChunkSize;
+          if (ChunkIndex >= ChunkNumber)
+          {
+            Dropped_.fetch_add(1, std::memory_order_relaxed);
+            return;
+          }
+
+          TraceEvent* Chunk = Chunks_[ChunkIndex].load(std::memory_order_relaxed);
+          if (Chunk == nullptr)
+          {
+            Chunk = new TraceEvent[ChunkSize];
+            Chunks_[ChunkIndex].store(Chunk, std::memory_order_relaxed);
+          }
+          Chunk[Index % ChunkSize] = Event;
+
+          /** publish the event to the exporter */
+          Size_.store(Index + 1, std::memory_order_release);
+        }
+
+        template <typename Function>
+        void forEach(Function Callback) const
+        {
+          const size_t Size = Size_.load(std::memory_order_acquire);
+          for (size_t Index = 0; Index < Size; ++Index)
+          {
+            Callback(Chunks_[Index / ChunkSize].load(std::memory_order_relaxed)[Index % ChunkSize]);
+          }
+        }
+
+        void clear()
+        {
+          Size_.store(0, std::memory_order_relaxed);
+          Dropped_.store(0, std::memory_order_relaxed);
+        }
+
+        [[nodiscard]] int getThreadID() const
+        {
+          return ThreadID_;
+        }
+
+        [[nodiscard]] size_t getDropped() const
+        {
+          return Dropped_.load(std::memory_order_relaxed);
+        }
+
+      private:
+        const int ThreadID_;
+        std::atomic<size_t> Size_ {0};
+        std::atomic<size_t> Dropped_ {0};
+        std::array<std::atomic<TraceEvent*>, ChunkNumber> Chunks_;
+    };
+
+    /** buffers outlive their threads, so spans of finished workers can be exported */
+    class TraceRegistry
+    {
+      public:
+        std::shared_ptr<TraceBuffer> create()
+        {
+          const std::lock_guard<std::mutex> Lock(Mutex_);
+          Buffers_.push_back(std::make_shared<TraceBuffer>(static_cast<int>(Buffers_.size())));
+          return Buffers_.back();
+        }
+
+        std::vector<std::shared_ptr<TraceBuffer>> getBuffers()
+        {
+          const std::lock_guard<std::mutex> Lock(Mutex_);
+          return Buffers_;
+        }
+
+      private:
+        std::mutex Mutex_;
+        std::vector<std::shared_ptr<TraceBuffer>> Buffers_;
+    };
+
+    TraceRegistry& GetRegistry()
+    {
+      static TraceRegistry Registry;
+      return Registry;
+    }
+
+    /** the mutex of the registry is only locked once per thread */
+    TraceBuffer& GetThreadBuffer()
+    {
+      thread_local const std::shared_ptr<TraceBuffer> Buffer = GetRegistry().create();
+      return *Buffer;
+    }
+
+    long long GetTraceTime()
+    {
+      static const std::chrono::steady_clock::time_point Start = std::chrono::steady_clock::now();
+      return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - Start).count();
+    }
+  }
+
+  TraceScope::TraceScope(const char* Name) : Name_(Name), Begin_(GetTraceTime()), Allocations_(GetAllocationCount())
+  {}
+
+  TraceScope::~TraceScope()
+  {
+    /** the count is taken before the buffer may allocate a new chunk */
+    const std::uint64_t Allocations = GetAllocationCount() - Allocations_;
+    GetThreadBuffer().add({Name_, Begin_, GetTraceTime(), Allocations});
+  }
+
+  bool WriteTraceToFile(const std::string &Filename)
+  {
+    std::ofstream File(Filename, std::ios::out | std::ios::trunc);
+    if (!File.is_open())
+    {
+      PRINT_ERROR("Could not open trace file: ", Filename);
+      return false;
+    }
+
+    /** complete events with microsecond timestamps */
+    File << std::fixed << std::setprecision(3) << "{\"traceEvents\":[";
+    bool IsFirst = true;
+    size_t Dropped = 0;
+    for (const std::shared_ptr<TraceBuffer> &Buffer : GetRegistry().getBuffers())
+    {
+      const int ThreadID = Buffer->getThreadID();
+      Buffer->forEach([&](const TraceEvent &Event)
+      {
+        File << (IsFirst ? "" : ",") << "\n{\"name\":\"" << Event.Name
+             << "\",\"ph\":\"X\",\"pid\":0,\"tid\":" << ThreadID
+             << ",\"ts\":" << static_cast<double>(Event.Begin) / 1e3
+             << ",\"dur\":" << static_cast<double>(Event.End - Event.Begin) / 1e3;
+        if (IsAllocationTrackingEnabled())
+        {
+          File << ",\"args\":{\"allocations\":" << Event.Allocations << "}";
+        }
+        File << "}";
+        IsFirst = false;
+      });
+      Dropped += Buffer->getDropped();
+    }
+    File << "\n],\"displayTimeUnit\":\"ms\"}\n";
+
+    if (Dropped > 0)
+    {
+      PRINT_WARNING(Dropped, " spans were dropped because the trace buffer was full!");
+    }
+
+    return File.good();
+  }
+
+  void ClearTrace()
+  {
+    for (const std::shared_ptr<TraceBuffer> &Buffer : GetRegistry().getBuffers())
+    {
+      Buffer->clear();
+    }
+  }
+#else
+  TraceScope::TraceScope(const char* Name) : Name_(Name), Begin_(0), Allocations_(0)
+  {}
+
+  TraceScope::~TraceScope() = default;
+
+  bool WriteTraceToFile(const std::string &Filename)
+  {
+    PRINT_WARNING("Tracing is disabled, build with LIBRSF_TRACING to write ", Filename);
+    return false;
+  }
+
+  void ClearTrace()
+  {}
+#endif // LIBRSF_TRACING
+}
@@ -0,0 +1,154 @@
+/***************************************************************************
+ * libRSF - A Robust Sensor Fusion Library
+ *
+ * Copyright (C) 2018 Chair of Automation Technology / TU Chemnitz
+ * For more information see https://www.tu-chemnitz.de/etit/proaut/libRSF
+ *
+ * libRSF is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libRSF is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with libRSF.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Tim Pfeifer (tim.pfeifer@etit.tu-chemnitz.de)
+ ***************************************************************************/
+
+#include "TrackManager.h"
+
+#include <utility>
+
+namespace libRSF
+{
+  TrackManager::TrackManager(FactorGraph &Graph, std::string Prefix, std::vector<DataType> StateTypes):
+      Graph_(Graph), Prefix_(std::move(Prefix)), StateTypes_(std::move(StateTypes))
+  {
+    if (StateTypes_.empty())
+    {
+      PRINT_ERROR("A track needs at least one state type!");
+    }
+  }
+
+  int TrackManager::spawn()
+  {
+    int Slot;
+    if (!Free_.empty())
+    {
+      Slot = Free_.back();
+      Free_.pop_back();
+    }
+    else
+    {
+      Slot = static_cast<int>(Slots_.size());
+      TrackSlot &New = Slots_.emplace_back();
+      New.Keys.reserve(StateTypes_.size());
+      for (size_t nType = 0; nType < StateTypes_.size(); ++nType)
+      {
+        New.Keys.emplace_back(Prefix_ + std::to_string(Slot) + "_" + std::to_string(nType));
+      }
+    }
+
+    Slots_.at(Slot).Alive = true;
+    return Slot;
+  }
+
+  void TrackManager::kill(const int Slot)
+  {
+    if (!this->isAlive(Slot))
+    {
+      PRINT_ERROR("Track ", Slot, " is not alive!");
+      return;
+    }
+    Slots_.at(Slot).Alive = false;
+    Dead_.push_back(Slot);
+  }
+
+  int TrackManager::update(const double Time)
+  {
+    /** collect all remaining states of dead tracks */
+    const StateDataSet &Data = Graph_.getStateData();
+    std::vector<StateID> States;
+    for (const int Slot : Dead_)
+    {
+      for (const StateKey &Key : Slots_.at(Slot).Keys)
+      {
+        for (auto Cursor = Data.cursor(Key); Cursor.valid(); Cursor.next())
+        {
+          const int Numbers = Data.countElement(Key, Cursor.getTime());
+          for (int n = 0; n < Numbers; n++)
+          {
+            States.emplace_back(Key, Cursor.getTime(), n);
+          }
+        }
+      }
+    }
+
+    /** one structural update for all deaths of this frame */
+    if (!Graph_.removeStates(States))
+    {
+      PRINT_ERROR("Could not remove the states of ", Dead_.size(), " dead tracks at ", Time);
+    }
+    Free_.insert(Free_.end(), Dead_.begin(), Dead_.end());
+    Dead_.clear();
+
+    /** live tracks, including the ones born in this frame */
+    Tracks_.clear();
+    for (int Slot = 0; Slot < static_cast<int>(Slots_.size()); ++Slot)
+    {
+      if (Slots_.at(Slot).Alive)
+      {
+        Tracks_.push_back(Slot);
+        for (size_t nType = 0; nType < StateTypes_.size(); ++nType)
+        {
+          Graph_.addStateWithCheck(Slots_.at(Slot).Keys.at(nType), StateTypes_.at(nType), Time);
+        }
+      }
+    }
+
+    return static_cast<int>(States.size());
+  }
+
+  StateList TrackManager::getStates(const int Slot, const double Time) const
+  {
+    StateList States;
+    if (this->checkSlot_(Slot))
+    {
+      for (const StateKey &Key : Slots_.at(Slot).Keys)
+      {
+        States.add(Key, Time);
+      }
+    }
+    return States;
+  }
+
+  const StateKey &TrackManager::getKey(const int Slot, const int TypeIndex) const
+  {
+    return Slots_.at(Slot).Keys.at(TypeIndex);
+  }
+
+  const std::vector<int> &TrackManager::getTracks() const
+  {
+    return Tracks_;
+  }
+
+  bool TrackManager::isAlive(const int Slot) const
+  {
+    return this->checkSlot_(Slot) && Slots_.at(Slot).Alive;
+  }
+
+  int TrackManager::countSlots() const
+  {
+    return static_cast<int>(Slots_.size());
+  }
+
+  bool TrackManager::checkSlot_(const int Slot) const
+  {
+    return Slot >= 0 && Slot < static_cast<int>(Slots_.size());
+  }
+}
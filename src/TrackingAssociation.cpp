@@ -0,0 +1,217 @@
+/***************************************************************************
+ * libRSF - A Robust Sensor Fusion Library
+ *
+ * Copyright (C) 2018 Chair of Automation Technology / TU Chemnitz
+ * For more information see https://www.tu-chemnitz.de/etit/proaut/libRSF
+ *
+ * libRSF is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libRSF is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with libRSF.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Tim Pfeifer (tim.pfeifer@etit.tu-chemnitz.de)
+ ***************************************************************************/
+
+#include "TrackingAssociation.h"
+
+#include <limits>
+
+namespace libRSF
+{
+  TrackingAssociation::TrackingAssociation(const double Gate): Gate_(Gate)
+  {
+  }
+
+  double TrackingAssociation::getGate() const
+  {
+    return Gate_;
+  }
+
+  bool TrackingAssociation::associate(StateDataSet &States,
+                                      const std::vector<StateID> &Tracks,
+                                      const std::vector<Data> &Detections,
+                                      std::vector<int> &Assignment) const
+  {
+    const int TrackNumber = static_cast<int>(Tracks.size());
+    const int DetectionNumber = static_cast<int>(Detections.size());
+    Assignment.assign(Tracks.size(), -1);
+
+    if (TrackNumber == 0 || DetectionNumber == 0)
+    {
+      return true;
+    }
+
+    /** gather positions and covariances once */
+    Matrix TrackMeans(3, TrackNumber);
+    std::vector<Matrix33> TrackCovs(TrackNumber);
+    for (int nTrack = 0; nTrack < TrackNumber; ++nTrack)
+    {
+      const StateID &Track = Tracks.at(nTrack);
+      if (!States.checkElement(Track.ID, Track.getTimestamp(), Track.Number))
+      {
+        PRINT_ERROR("State does not exist: ", Track.ID, " ", Track.getTimestamp(), " ", Track.Number);
+        return false;
+      }
+      const Data &State = States.getElement(Track.ID, Track.getTimestamp(), Track.Number);
+      if (State.getValue(DataElement::Mean).size() < 3 || !State.checkElement(DataElement::Covariance))
+      {
+        PRINT_ERROR("Track ", Track.ID, " at ", Track.getTimestamp(), "s has no 3D position with covariance!");
+        return false;
+      }
+      TrackMeans.col(nTrack) = State.getValue(DataElement::Mean).head(3);
+      TrackCovs.at(nTrack) = State.getCovarianceMatrix().topLeftCorner(3, 3);
+    }
+
+    Matrix DetectionMeans(3, DetectionNumber);
+    std::vector<Matrix33> DetectionCovs(DetectionNumber);
+    for (int nDet = 0; nDet < DetectionNumber; ++nDet)
+    {
+      const Data &Detection = Detections.at(nDet);
+      if (Detection.getValue(DataElement::Mean).size() < 3)
+      {
+        PRINT_ERROR("Detection ", nDet, " has no 3D position!");
+        return false;
+      }
+      DetectionMeans.col(nDet) = Detection.getValue(DataElement::Mean).head(3);
+      DetectionCovs.at(nDet) = (Detection.checkElement(DataElement::Covariance) || Detection.checkElement(DataElement::CovarianceDiagonal)) ?
+                               Matrix33(Detection.getCovarianceMatrix().topLeftCorner(3, 3)) : Matrix33::Zero();
+    }
+
+    /** each track can take a detection or its own dummy column, which costs the gate */
+    constexpr double Infeasible = 1e12;
+    Matrix Cost = Matrix::Constant(TrackNumber, DetectionNumber + TrackNumber, Infeasible);
+    for (int nTrack = 0; nTrack < TrackNumber; ++nTrack)
+    {
+      Cost(nTrack, DetectionNumber + nTrack) = Gate_;
+
+      /** squared Euclidean distances reject far detections before any solve */
+      const Vector Squared = (DetectionMeans.colwise() - TrackMeans.col(nTrack)).colwise().squaredNorm().transpose();
+      const double MaxVariance = TrackCovs.at(nTrack).selfadjointView<Eigen::Lower>().eigenvalues().maxCoeff();
+
+      for (int nDet = 0; nDet < DetectionNumber; ++nDet)
+      {
+        const Matrix33 Innovation = TrackCovs.at(nTrack) + DetectionCovs.at(nDet);
+
+        /** d^T S^-1 d >= |d|^2 / lambda_max(S) and lambda_max(S) <= lambda_max(P) + trace(R) */
+        if (Squared(nDet) > Gate_ * (MaxVariance + DetectionCovs.at(nDet).trace()))
+        {
+          continue;
+        }
+
+        const Eigen::LDLT<Matrix33> Solver(Innovation);
+        const Vector3 Diff = DetectionMeans.col(nDet) - TrackMeans.col(nTrack);
+        const double Distance = Diff.dot(Solver.solve(Diff));
+        if (Distance < Gate_)
+        {
+          Cost(nTrack, nDet) = Distance;
+        }
+      }
+    }
+
+    std::vector<int> RowToCol;
+    SolveAssignment(Cost, RowToCol);
+
+    for (int nTrack = 0; nTrack < TrackNumber; ++nTrack)
+    {
+      if (RowToCol.at(nTrack) < DetectionNumber)
+      {
+        Assignment.at(nTrack) = RowToCol.at(nTrack);
+      }
+    }
+
+    return true;
+  }
+
+  void SolveAssignment(const Matrix &Cost, std::vector<int> &RowToCol)
+  {
+    const int Rows = static_cast<int>(Cost.rows());
+    const int Cols = static_cast<int>(Cost.cols());
+    RowToCol.assign(Rows, -1);
+
+    if (Rows > Cols)
+    {
+      PRINT_ERROR("The assignment requires at least as many columns as rows, but there are ", Rows, " rows and ", Cols, " columns!");
+      return;
+    }
+
+    /** shortest augmenting paths with potentials, index 0 is a virtual column */
+    const double Inf = std::numeric_limits<double>::infinity();
+    std::vector<double> U(Rows + 1, 0.0), V(Cols + 1, 0.0), MinV(Cols + 1);
+    std::vector<int> ColToRow(Cols + 1, 0), Way(Cols + 1, 0);
+    std::vector<char> Used(Cols + 1);
+
+    for (int Row = 1; Row <= Rows; ++Row)
+    {
+      ColToRow.at(0) = Row;
+      int Col0 = 0;
+      std::fill(MinV.begin(), MinV.end(), Inf);
+      std::fill(Used.begin(), Used.end(), 0);
+
+      do
+      {
+        Used.at(Col0) = 1;
+        const int Row0 = ColToRow.at(Col0);
+        double Delta = Inf;
+        int Col1 = 0;
+
+        for (int Col = 1; Col <= Cols; ++Col)
+        {
+          if (!Used.at(Col))
+          {
+            const double Reduced = Cost(Row0 - 1, Col - 1) - U.at(Row0) - V.at(Col);
+            if (Reduced < MinV.at(Col))
+            {
+              MinV.at(Col) = Reduced;
+              Way.at(Col) = Col0;
+            }
+            if (MinV.at(Col) < Delta)
+            {
+              Delta = MinV.at(Col);
+              Col1 = Col;
+            }
+          }
+        }
+
+        for (int Col = 0; Col <= Cols; ++Col)
+        {
+          if (Used.at(Col))
+          {
+            U.at(ColToRow.at(Col)) += Delta;
+            V.at(Col) -= Delta;
+          }
+          else
+          {
+            MinV.at(Col) -= Delta;
+          }
+        }
+        Col0 = Col1;
+      }
+      while (ColToRow.at(Col0) != 0);
+
+      /** flip the augmenting path */
+      do
+      {
+        const int Col1 = Way.at(Col0);
+        ColToRow.at(Col0) = ColToRow.at(Col1);
+        Col0 = Col1;
+      }
+      while (Col0 != 0);
+    }
+
+    for (int Col = 1; Col <= Cols; ++Col)
+    {
+      if (ColToRow.at(Col) > 0)
+      {
+        RowToCol.at(ColToRow.at(Col) - 1) = Col - 1;
+      }
+    }
+  }
+}
@@ -0,0 +1,145 @@
+/***************************************************************************
+ * libRSF - A Robust Sensor Fusion Library
+ *
+ * Copyright (C) 2018 Chair of Automation Technology / TU Chemnitz
+ * For more information see https://www.tu-chemnitz.de/etit/proaut/libRSF
+ *
+ * libRSF is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libRSF is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with libRSF.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Tim Pfeifer (tim.pfeifer@etit.tu-chemnitz.de)
+ ***************************************************************************/
+
+#include "TrackingRepulsion.h"
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <unordered_map>
+
+namespace libRSF
+{
+  namespace
+  {
+    /** 21 bits per axis of the cell index */
+    std::uint64_t PackCell(const std::array<std::int64_t, 3> &Cell)
+    {
+      constexpr std::uint64_t Mask = (std::uint64_t(1) << 21) - 1;
+      return ((static_cast<std::uint64_t>(Cell[0]) & Mask) << 42) |
+             ((static_cast<std::uint64_t>(Cell[1]) & Mask) << 21) |
+             (static_cast<std::uint64_t>(Cell[2]) & Mask);
+    }
+  }
+
+  TrackingRepulsion::TrackingRepulsion(FactorGraph &Graph, const double Radius):
+      Graph_(Graph), Radius_(Radius)
+  {
+    if (Radius_ <= 0.0)
+    {
+      PRINT_ERROR("The repelling radius has to be positive, but it is ", Radius_);
+    }
+  }
+
+  void TrackingRepulsion::removeBefore(const double Time)
+  {
+    Pairs_.erase(Pairs_.begin(), Pairs_.lower_bound(toTick(Time)));
+  }
+
+  int TrackingRepulsion::countPairs(const double Timestamp) const
+  {
+    const auto It = Pairs_.find(toTick(Timestamp));
+    return It == Pairs_.end() ? 0 : static_cast<int>(It->second.size());
+  }
+
+  double TrackingRepulsion::getRadius() const
+  {
+    return Radius_;
+  }
+
+  TrackingRepulsion::ObjectPair TrackingRepulsion::MakePair_(const StateID &Object1, const StateID &Object2)
+  {
+    const ObjectKey Key1(Object1.ID.getID(), Object1.Number);
+    const ObjectKey Key2(Object2.ID.getID(), Object2.Number);
+    return Key1 < Key2 ? ObjectPair(Key1, Key2) : ObjectPair(Key2, Key1);
+  }
+
+  bool TrackingRepulsion::findPairs_(const std::vector<StateID> &Objects, std::vector<std::pair<int, int>> &Pairs) const
+  {
+    if (Radius_ <= 0.0)
+    {
+      return false;
+    }
+
+    StateDataSet &States = Graph_.getStateData();
+    const int ObjectNumber = static_cast<int>(Objects.size());
+
+    /** sort the current positions into cells of radius size */
+    std::vector<Vector3> Positions(ObjectNumber);
+    std::vector<std::array<std::int64_t, 3>> Cells(ObjectNumber);
+    std::unordered_map<std::uint64_t, std::vector<int>> Grid;
+    Grid.reserve(Objects.size());
+    for (int n = 0; n < ObjectNumber; ++n)
+    {
+      const StateID &Object = Objects.at(n);
+      if (!States.checkElement(Object.ID, Object.getTimestamp(), Object.Number))
+      {
+        PRINT_ERROR("State does not exist: ", Object.ID, " ", Object.getTimestamp(), " ", Object.Number);
+        return false;
+      }
+
+      const Data &State = States.getElement(Object.ID, Object.getTimestamp(), Object.Number);
+      if (State.getValue(DataElement::Mean).size() != 3)
+      {
+        PRINT_ERROR("Repelling factors require 3D positions, but ", Object.ID, " has ", State.getValue(DataElement::Mean).size(), " dimensions!");
+        return false;
+      }
+      Positions.at(n) = State.getValue(DataElement::Mean);
+
+      for (int Axis = 0; Axis < 3; ++Axis)
+      {
+        Cells.at(n)[Axis] = static_cast<std::int64_t>(std::floor(Positions.at(n)(Axis) / Radius_));
+      }
+      Grid[PackCell(Cells.at(n))].push_back(n);
+    }
+
+    /** compare each object with the later ones in its own and the neighbouring cells */
+    const double SquaredRadius = Radius_ * Radius_;
+    for (int n = 0; n < ObjectNumber; ++n)
+    {
+      for (std::int64_t dx = -1; dx <= 1; ++dx)
+      {
+        for (std::int64_t dy = -1; dy <= 1; ++dy)
+        {
+          for (std::int64_t dz = -1; dz <= 1; ++dz)
+          {
+            const auto Cell = Grid.find(PackCell({Cells.at(n)[0] + dx, Cells.at(n)[1] + dy, Cells.at(n)[2] + dz}));
+            if (Cell == Grid.end())
+            {
+              continue;
+            }
+
+            for (const int Other : Cell->second)
+            {
+              if (Other > n && (Positions.at(Other) - Positions.at(n)).squaredNorm() < SquaredRadius)
+              {
+                Pairs.emplace_back(n, Other);
+              }
+            }
+          }
+        }
+      }
+    }
+
+    return true;
+  }
+}
@@ -227,6 +227,14 @@ namespace libRSF
         {DataElement::Covariance, 1}
       }
     },
+    {
+      "clock_combined", DataType::Clock,
+      {
+        {DataElement::Timestamp, 1},
+        {DataElement::Mean, 2},
+        {DataElement::Covariance, 4}
+      }
+    },
 
     /** IMU speed and bias */
     {
@@ -585,7 +593,28 @@ namespace libRSF
         {DataElement::DurationMarginal, 1},
         {DataElement::DurationAdaptive, 1},
         {DataElement::IterationSolver, 1},
-        {DataElement::IterationAdaptive, 1}
+        {DataElement::IterationAdaptive, 1},
+        {DataElement::DeadlineMisses, 1},
+        {DataElement::MemoryUsage, 4},
+        {DataElement::Allocations, 4},
+        {DataElement::WindowLength, 1}
+      }
+    },
+
+    /** telemetry of single solver iterations, Idx holds the number of the solve and of the iteration, Gradient is the norm of the gradient */
+    {
+      "solver_iteration", DataType::SolverIteration,
+      {
+        {DataElement::Timestamp, 1},
+        {DataElement::Idx, 2},
+        {DataElement::Cost, 1},
+        {DataElement::Gradient, 1},
+        {DataElement::StepNorm, 1},
+        {DataElement::TrustRegionRadius, 1},
+        {DataElement::StepSuccessful, 1},
+        {DataElement::DurationLinearSolver, 1},
+        {DataElement::DurationEvaluation, 1},
+        {DataElement::IterationLinearSolver, 1}
       }
     },
 
@@ -74,4 +74,23 @@ namespace libRSF
       }
     }
   }
+
+  void CRSToSparseMatrix(const ceres::CRSMatrix &CRSMat, SparseMatrix &Mat)
+  {
+    /** collect non-zero entries */
+    std::vector<Eigen::Triplet<double>> Entries;
+    Entries.reserve(CRSMat.values.size());
+
+    for (int Row = 0; Row < CRSMat.num_rows; Row++)
+    {
+      for (int n = CRSMat.rows[Row]; n < CRSMat.rows[Row + 1]; n++)
+      {
+        Entries.emplace_back(Row, CRSMat.cols[n], CRSMat.values[n]);
+      }
+    }
+
+    /** construct compressed matrix */
+    Mat.resize(CRSMat.num_rows, CRSMat.num_cols);
+    Mat.setFromTriplets(Entries.begin(), Entries.end());
+  }
 }
@@ -0,0 +1,98 @@
+/***************************************************************************
+ * libRSF - A Robust Sensor Fusion Library
+ *
+ * Copyright (C) 2018 Chair of Automation Technology / TU Chemnitz
+ * For more information see https://www.tu-chemnitz.de/etit/proaut/libRSF
+ *
+ * libRSF is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libRSF is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with libRSF.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Tim Pfeifer (tim.pfeifer@etit.tu-chemnitz.de)
+ ***************************************************************************/
+
+#include "WindowController.h"
+
+#include <algorithm>
+
+namespace libRSF
+{
+  /** weight of the newest duration in the smoothed one */
+  static constexpr double DurationSmoothing = 0.3;
+
+  /** part of the target that is planned for, the rest absorbs the variance of single epochs */
+  static constexpr double TargetHeadroom = 0.8;
+
+  /** ratios inside this band do not change the window */
+  static constexpr double Deadband = 0.1;
+
+  /** the window at most halves or grows by a quarter per epoch */
+  static constexpr double MinStep = 0.5;
+  static constexpr double MaxStep = 1.25;
+
+  WindowController::WindowController(const double Length, const double MinLength, const double MaxLength, const double TargetTime) :
+      Length_(Length), MinLength_(MinLength), MaxLength_(std::max(MinLength, MaxLength)), TargetTime_(TargetTime), IsActive_(TargetTime > 0.0)
+  {
+  }
+
+  WindowController::WindowController(const FactorGraphConfig &Config) :
+      WindowController(Config.Solution.WindowLength,
+                       Config.Solution.MinWindowLength,
+                       Config.Solution.MaxWindowLength,
+                       Config.Solution.MaxTime)
+  {
+    IsActive_ = Config.Solution.AdaptiveWindow && Config.Solution.MaxTime > 0.0;
+  }
+
+  double WindowController::update(const double Duration)
+  {
+    if (!IsActive_)
+    {
+      return Length_;
+    }
+
+    /** smooth the measured time */
+    if (Duration_ < 0.0)
+    {
+      Duration_ = Duration;
+    }
+    else
+    {
+      Duration_ = DurationSmoothing * Duration + (1.0 - DurationSmoothing) * Duration_;
+    }
+
+    /** nothing to learn from an epoch without any work */
+    if (Duration_ <= 0.0)
+    {
+      return Length_;
+    }
+
+    const double Ratio = TargetHeadroom * TargetTime_ / Duration_;
+    if (Ratio > 1.0 - Deadband && Ratio < 1.0 + Deadband)
+    {
+      return Length_;
+    }
+
+    Length_ = std::clamp(Length_ * std::clamp(Ratio, MinStep, MaxStep), MinLength_, MaxLength_);
+    return Length_;
+  }
+
+  double WindowController::getLength() const
+  {
+    return Length_;
+  }
+
+  bool WindowController::isActive() const
+  {
+    return IsActive_;
+  }
+}
@@ -22,6 +22,8 @@
 
 #include "error_models/LossFunction.h"
 
+#include <cmath>
+
 namespace libRSF
 {
   /** @brief Implements the original DCS loss function
@@ -39,9 +41,13 @@ namespace libRSF
     }
     else
     {
-      rho[0] = Phi_ * (3 * s - Phi_) / (s + Phi_);
-      rho[1] = (3*Phi_)/(Phi_ + s) + (Phi_*(Phi_ - 3*s))/pow((Phi_ + s), 2);
-      rho[2] = - (6*Phi_)/pow((Phi_ + s), 2) - (2*Phi_*(Phi_ - 3*s))/pow((Phi_ + s), 3);
+      /** simplified derivatives of Phi * (3s - Phi) / (s + Phi) */
+      const double InvSum = 1.0 / (Phi_ + s);
+      const double Factor = 4.0 * Phi_ * Phi_ * InvSum * InvSum;
+
+      rho[0] = Phi_ * (3 * s - Phi_) * InvSum;
+      rho[1] = Factor;
+      rho[2] = -2.0 * Factor * InvSum;
     }
   }
 
@@ -52,19 +58,20 @@ namespace libRSF
    */
   void cDCELoss::Evaluate(double s, double rho[3]) const
   {
-    double e = sqrt(s);
-
-    if (e <= Sigma_)
+    /** compare squared values to avoid the square root */
+    if (s <= SigmaSquared_)
     {
-      rho[0] = s / (Sigma_ * Sigma_);
-      rho[1] = 1.0 / (Sigma_ * Sigma_);
+      rho[0] = s * InvSigmaSquared_;
+      rho[1] = InvSigmaSquared_;
       rho[2] = 0.0;
     }
     else
     {
-      rho[0] = 1.0 + log(e / Sigma_) * 2;
-      rho[1] = 1.0 / (s);
-      rho[2] = -1.0 / (s * s);
+      const double InvS = 1.0 / s;
+
+      rho[0] = 1.0 + log(s * InvSigmaSquared_);
+      rho[1] = InvS;
+      rho[2] = -InvS * InvS;
     }
   }
 
@@ -75,9 +82,11 @@ namespace libRSF
    */
   void StudentLoss::Evaluate(double s, double rho[3]) const
   {
-    rho[0] = (Nu_ + Dim_) * log(1 + s/Nu_);
-    rho[1] = (Nu_ + Dim_) / (Nu_ + s);
-    rho[2] = -(Nu_ + Dim_) / (Nu_ + s)*(Nu_ + s);
+    const double InvSum = 1.0 / (Nu_ + s);
+
+    rho[0] = NuPlusDim_ * log(1 + s / Nu_);
+    rho[1] = NuPlusDim_ * InvSum;
+    rho[2] = -NuPlusDim_ * InvSum * InvSum;
   }
 
   /** @brief Implements a M-estimator that represents a Cauchy distribution
@@ -87,41 +96,112 @@ namespace libRSF
    */
   void CauchyPDFLoss::Evaluate(double s, double rho[3]) const
   {
-    rho[0] = 2 * log(1 + s/c_);
-    rho[1] = 2 / (c_ + s);
-    rho[2] = -2 / pow(c_ + s, 2);
+    const double InvSum = 1.0 / (c_ + s);
+
+    rho[0] = 2 * log(1 + s / c_);
+    rho[1] = 2 * InvSum;
+    rho[2] = -2 * InvSum * InvSum;
   }
 
-  /** @brief Implements a M-estimator that represents a general adaptive loss function
-   *
-   * @param s   squared non-weighted error
-   * @param rho [p(s) p'(s) p''(s)]
-   */
-  void GeneralAdaptiveLoss::Evaluate(double s, double rho[3]) const
+  GeneralAdaptiveLoss::GeneralAdaptiveLoss(const double Alpha, const double C) : Alpha_(Alpha), InvCov_(1.0 / (C * C))
   {
-    if(Alpha_ == 2.0)
+    if (Alpha == 2.0)
     {
-      rho[0] = s/Cov_;
-      rho[1] = Cov_;
-      rho[2] = 0.0;
+      Shape_ = Shape::Gaussian;
+    }
+    else if (Alpha == 1.0)
+    {
+      Shape_ = Shape::Charbonnier;
+    }
+    else if (Alpha == 0.0)
+    {
+      Shape_ = Shape::Cauchy;
     }
-    else if (Alpha_ == 0.0)
+    else if (Alpha == -2.0)
     {
-      rho[0] = 2 * log(0.5 * s/Cov_ + 1);
-      rho[1] = 1 / (Cov_ + 0.5*s);
-      rho[2] = - 0.5 / pow(Cov_ + 0.5*s, 2);
+      Shape_ = Shape::GemanMcClure;
     }
-    else if (Alpha_ < -1e10)/**< this approximates negative infinity */
+    else if (Alpha < -1e10)/**< this approximates negative infinity */
     {
-      rho[0] = 2 * (1 - exp(-0.5 * s/Cov_));
-      rho[1] = exp(-0.5 * s/Cov_) / Cov_;
-      rho[2] = -0.5 * exp(-0.5 * s/Cov_) / pow(Cov_,2);
+      Shape_ = Shape::Welsch;
     }
     else
     {
-      rho[0] = 2 * abs(Alpha_ - 2) / Alpha_  * (pow(s/Cov_ / abs(Alpha_ - 2) + 1, Alpha_/2) - 1);
-      rho[1] = pow(s/Cov_ / abs(Alpha_ - 2) + 1, Alpha_/2 - 1) / Cov_;
-      rho[2] = (Alpha_/2 - 1) * pow(s/Cov_ / abs(Alpha_ - 2) + 1, Alpha_/2 - 2) / (pow(Cov_,2) * abs(Alpha_ - 2));
+      Shape_ = Shape::General;
+    }
+
+    const double AbsAlphaMinus2 = std::abs(Alpha - 2.0);
+    InvCovScaled_ = InvCov_ / AbsAlphaMinus2;
+    Scale0_ = 2.0 * AbsAlphaMinus2 / Alpha;
+    Scale2_ = (Alpha / 2.0 - 1.0) * InvCov_ * InvCovScaled_;
+  }
+
+  /** @brief Implements a M-estimator that represents a general adaptive loss function
+   *
+   * @param s   squared non-weighted error
+   * @param rho [p(s) p'(s) p''(s)]
+   */
+  void GeneralAdaptiveLoss::Evaluate(double s, double rho[3]) const
+  {
+    switch (Shape_)
+    {
+      case Shape::Gaussian:
+        rho[0] = s * InvCov_;
+        rho[1] = InvCov_;
+        rho[2] = 0.0;
+        break;
+
+      case Shape::Charbonnier:
+        {
+          /** Alpha = 1: 2 * (sqrt(s/Cov + 1) - 1) */
+          const double Root = sqrt(s * InvCov_ + 1.0);
+          const double InvRoot = 1.0 / Root;
+          rho[0] = 2.0 * (Root - 1.0);
+          rho[1] = InvRoot * InvCov_;
+          rho[2] = -0.5 * InvRoot * InvRoot * InvRoot * InvCov_ * InvCov_;
+          break;
+        }
+
+      case Shape::Cauchy:
+        {
+          const double InvSum = 1.0 / (1.0 + 0.5 * s * InvCov_);
+          rho[0] = 2 * log(0.5 * s * InvCov_ + 1);
+          rho[1] = InvSum * InvCov_;
+          rho[2] = -0.5 * InvSum * InvSum * InvCov_ * InvCov_;
+          break;
+        }
+
+      case Shape::GemanMcClure:
+        {
+          /** Alpha = -2: 4 * z / (z + 1) with z = s / (4 Cov) */
+          const double Z = 0.25 * s * InvCov_;
+          const double InvSum = 1.0 / (Z + 1.0);
+          rho[0] = 4.0 * Z * InvSum;
+          rho[1] = InvSum * InvSum * InvCov_;
+          rho[2] = -0.5 * InvSum * InvSum * InvSum * InvCov_ * InvCov_;
+          break;
+        }
+
+      case Shape::Welsch:
+        {
+          const double Exp = exp(-0.5 * s * InvCov_);
+          rho[0] = 2 * (1 - Exp);
+          rho[1] = Exp * InvCov_;
+          rho[2] = -0.5 * Exp * InvCov_ * InvCov_;
+          break;
+        }
+
+      default:
+        {
+          /** one pow() for all three values, the others follow by multiplication with the base */
+          const double Base = s * InvCovScaled_ + 1.0;
+          const double Pow2 = pow(Base, Alpha_ / 2 - 2);
+          const double Pow1 = Pow2 * Base;
+          rho[0] = Scale0_ * (Pow1 * Base - 1);
+          rho[1] = Pow1 * InvCov_;
+          rho[2] = Scale2_ * Pow2;
+          break;
+        }
     }
   }
 }
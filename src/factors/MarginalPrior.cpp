@@ -51,9 +51,15 @@ namespace libRSF
       LocalSizeSum_ = LocalSum;
       GlobalSizeSum_ = GlobalSum;
 
-      /** store linear system */
-      LinearJacobian_ = J;
+      /** store linear system as column blocks */
       LinearResidual_ = R;
+      int Col = 0;
+      for (int LocalSizeBlock : LocalSize)
+      {
+        JacobianBlocks_.emplace_back(J.middleCols(Col, LocalSizeBlock));
+        IsZeroBlock_.push_back(JacobianBlocks_.back().isZero(0.0));
+        Col += LocalSizeBlock;
+      }
 
       /** store linearization points */
       LinearizationPoints_.resize(GlobalSizeSum_);
@@ -64,8 +70,8 @@ namespace libRSF
         CumSum += GlobalSize.at(n);
       }
 
-      /** parametrize factor */
-      this->set_num_residuals(LocalSizeSum_);
+      /** parametrize factor (the linear system might be compressed to its rank) */
+      this->set_num_residuals(static_cast<int>(J.rows()));
       for (int BlockSize : GlobalSize)
       {
         this->mutable_parameter_block_sizes()->push_back(BlockSize);
@@ -81,45 +87,46 @@ namespace libRSF
                                double* Residuals,
                                double** Jacobians) const
   {
-
-    /** use separate jacobian to represent the manifold operations */
-    Matrix JacobianManifold;
-    bool HasJacobian = false;
-    if(Jacobians != nullptr)
-    {
-      JacobianManifold.resize(LocalSizeSum_, GlobalSizeSum_);
-      JacobianManifold.setZero();
-      HasJacobian = true;
-    }
-
-    VectorRef<double, Dynamic> Error(Residuals, LocalSizeSum_);
-    Vector DeltaState(LocalSizeSum_);
+    VectorRef<double, Dynamic> Error(Residuals, LinearResidual_.size());
+    Error = LinearResidual_;
 
     /** compute block-wise error */
-    int IndexError = 0;
     int IndexState = 0;
     for (int nState = 0; nState < static_cast<int>(GlobalSize_.size()); nState++)
     {
       /** get dimensions of sub-block */
-      int GlobalSize = GlobalSize_.at(nState);
-      int LocalSize = LocalSize_.at(nState);
+      const int GlobalSize = GlobalSize_.at(nState);
+      const int LocalSize = LocalSize_.at(nState);
+
+      const bool HasJacobian = (Jacobians != nullptr && Jacobians[nState] != nullptr);
+
+      /** blocks without information contribute nothing */
+      if (IsZeroBlock_.at(nState))
+      {
+        if (HasJacobian)
+        {
+          MatrixRef<double, Dynamic, Dynamic>(Jacobians[nState], Error.size(), GlobalSize).setZero();
+        }
+        IndexState += GlobalSize;
+        continue;
+      }
 
       /** map relevant variables */
       const VectorRefConst<double, Dynamic> State(Parameters[nState], GlobalSize);
-      const Vector LinearState =
-          LinearizationPoints_.segment(IndexState, GlobalSize);
+      const Vector LinearState = LinearizationPoints_.segment(IndexState, GlobalSize);
+      const Matrix &JacobianBlock = JacobianBlocks_.at(nState);
+
+      Vector DeltaState(LocalSize);
 
       if (StateTypes_.at(nState) == DataType::Angle)
       {
-        /** angle case */
-        DeltaState.segment(IndexError, LocalSize) = NormalizeAngleVector<double, 1>(State - LinearState);
+        /** angle case with identity jacobian */
+        DeltaState = NormalizeAngleVector<double, 1>(State - LinearState);
 
-        /** identity jacobian */
-        if(HasJacobian)
+        if (HasJacobian)
         {
-          JacobianManifold.block(IndexError, IndexState, LocalSize, GlobalSize).setIdentity();
+          MatrixRef<double, Dynamic, Dynamic>(Jacobians[nState], Error.size(), GlobalSize) = JacobianBlock;
         }
-
       }
       else if (StateTypes_.at(nState) == DataType::Quaternion)
       {
@@ -127,65 +134,50 @@ namespace libRSF
         QuaternionRefConst<double> QState (State.data());
         QuaternionRefConst<double> QPrior (LinearState.data());
 
-        if(HasJacobian)
+        if (HasJacobian)
         {
           /** tangent space error and jacobian */
           Matrix34 JacState;
-          DeltaState.segment(IndexError, LocalSize) = QuaternionError(QState, QPrior, &JacState, nullptr);
-          JacobianManifold.block(IndexError, IndexState, LocalSize, GlobalSize) = JacState;
+          DeltaState = QuaternionError(QState, QPrior, &JacState, nullptr);
+          MatrixRef<double, Dynamic, Dynamic>(Jacobians[nState], Error.size(), GlobalSize) = JacobianBlock * JacState;
         }
         else
         {
           /** tangent space error */
-          DeltaState.segment(IndexError, LocalSize) = QuaternionError<double>(QState, QPrior);
+          DeltaState = QuaternionError<double>(QState, QPrior);
         }
       }
       else
       {
-        if(LocalSize != GlobalSize)
+        if (LocalSize != GlobalSize)
         {
           PRINT_ERROR("You are using a local parametrization that is not handled here! We disable the marginal prior for this error block!");
 
           /** disable error block */
-          DeltaState.segment(IndexError, LocalSize).setZero();
+          DeltaState.setZero();
+
+          if (HasJacobian)
+          {
+            MatrixRef<double, Dynamic, Dynamic>(Jacobians[nState], Error.size(), GlobalSize).setZero();
+          }
         }
         else
         {
-          /** normal case */
-          DeltaState.segment(IndexError, LocalSize) = State - LinearState;
-        }
+          /** normal case with identity jacobian */
+          DeltaState = State - LinearState;
 
-        /** identity jacobian */
-        if(HasJacobian)
-        {
-          JacobianManifold.block(IndexError, IndexState, LocalSize, GlobalSize).setIdentity();
+          if (HasJacobian)
+          {
+            MatrixRef<double, Dynamic, Dynamic>(Jacobians[nState], Error.size(), GlobalSize) = JacobianBlock;
+          }
         }
       }
 
-      /** move index to the next error block*/
-      IndexError += LocalSize;
-      IndexState += GlobalSize;
-    }
-
-    /** apply linear jacobian and residual */
-    Error = LinearJacobian_ * DeltaState + LinearResidual_;
-
-    /** jacobians are composed of linear jacobian and manifold jacobian */
-    if(HasJacobian)
-    {
-      int IndexStateJac = 0;
-      for (int nState = 0; nState < static_cast<int>(GlobalSize_.size()); nState++)
-      {
-        int GlobalSize = GlobalSize_.at(nState);
+      /** apply linear jacobian */
+      Error += JacobianBlock * DeltaState;
 
-        if(Jacobians[nState] != nullptr)
-        {
-          MatrixRef<double, Dynamic, Dynamic> Jacobian(Jacobians[nState], LocalSizeSum_, GlobalSize);
-          Jacobian = LinearJacobian_ * JacobianManifold.middleCols(IndexStateJac, GlobalSize);
-        }
-
-        IndexStateJac += GlobalSize;
-      }
+      /** move index to the next state block*/
+      IndexState += GlobalSize;
     }
 
     return true;
@@ -0,0 +1,53 @@
+/***************************************************************************
+ * libRSF - A Robust Sensor Fusion Library
+ *
+ * Copyright (C) 2018 Chair of Automation Technology / TU Chemnitz
+ * For more information see https://www.tu-chemnitz.de/etit/proaut/libRSF
+ *
+ * libRSF is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libRSF is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with libRSF.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Tim Pfeifer (tim.pfeifer@etit.tu-chemnitz.de)
+ ***************************************************************************/
+
+#include "geometric_models/BSplineModel.h"
+#include "Messages.h"
+
+#include <algorithm>
+
+namespace libRSF
+{
+  Vector3 CumulativeBSplineBasis(const double U)
+  {
+    const double U2 = U * U;
+    const double U3 = U2 * U;
+
+    Vector3 Basis;
+    Basis(0) = (5.0 + 3.0 * U - 3.0 * U2 + U3) / 6.0;
+    Basis(1) = (1.0 + 3.0 * U + 3.0 * U2 - 2.0 * U3) / 6.0;
+    Basis(2) = U3 / 6.0;
+    return Basis;
+  }
+
+  double BSplineSegmentTime(const double Time, const double TimeFirst, const double TimeLast)
+  {
+    /** the segment lies between the second and the third control point */
+    const double KnotTime = (TimeLast - TimeFirst) / 3.0;
+    if (KnotTime <= 0.0)
+    {
+      PRINT_ERROR("The control points of a spline segment need increasing timestamps!");
+      return 0.0;
+    }
+    return std::clamp((Time - TimeFirst) / KnotTime - 1.0, 0.0, 1.0);
+  }
+}
@@ -21,9 +21,52 @@
  ***************************************************************************/
 
 #include "geometric_models/IMUPreintegrator.h"
+#include "ThreadPool.h"
+
+#include <algorithm>
 
 namespace libRSF
 {
+  IMUSampleBuffer::IMUSampleBuffer(const size_t Capacity)
+  {
+    Timestamps_.reserve(Capacity);
+    Acceleration_.reserve(Capacity);
+    TurnRate_.reserve(Capacity);
+    AccelerationCov_.reserve(Capacity);
+    TurnRateCov_.reserve(Capacity);
+  }
+
+  void IMUSampleBuffer::add(const double Timestamp,
+                            const Vector3 &Acceleration, const Vector3 &TurnRate,
+                            const Vector3 &AccelerationCov, const Vector3 &TurnRateCov)
+  {
+    Timestamps_.push_back(Timestamp);
+    Acceleration_.push_back(Acceleration);
+    TurnRate_.push_back(TurnRate);
+    AccelerationCov_.push_back(AccelerationCov);
+    TurnRateCov_.push_back(TurnRateCov);
+  }
+
+  void IMUSampleBuffer::add(const Data &IMUMeasurement)
+  {
+    /** the mean is mapped instead of copied */
+    const VectorRefConst<double, Dynamic> Mean = IMUMeasurement.getValue(DataElement::Mean);
+
+    Vector6 CovDiagonal;
+    if (IMUMeasurement.checkElement(DataElement::CovarianceDiagonal))
+    {
+      CovDiagonal = IMUMeasurement.getValue(DataElement::CovarianceDiagonal);
+    }
+    else
+    {
+      CovDiagonal = IMUMeasurement.getCovarianceDiagonal();
+    }
+
+    this->add(IMUMeasurement.getTimestamp(),
+              Mean.head<3>(), Mean.tail<3>(),
+              CovDiagonal.head<3>(), CovDiagonal.tail<3>());
+  }
+
   IMUPreintegrator::IMUPreintegrator(const Vector3 &BiasAcc, const Vector3 &BiasTR,
                                      const double RandomWalkAcc, const double RandomWalkGyro,
                                      const double CurrentTime): CurrentTime_(CurrentTime),
@@ -72,8 +115,15 @@ namespace libRSF
     DeltaTime_ = 0;
   }
 
-  void IMUPreintegrator::updateBias(const Vector3 &BiasAcc, const Vector3 &BiasTR)
+  bool IMUPreintegrator::updateBias(const Vector3 &BiasAcc, const Vector3 &BiasTR, const double Threshold)
   {
+    /** small changes are covered by the linear bias correction */
+    if ((BiasAcc - BiasAcc_).norm() <= Threshold && (BiasTR - BiasTR_).norm() <= Threshold)
+    {
+      return false;
+    }
+
+    const double EndTime = CurrentTime_;
     const double StartTime = CurrentTime_ - DeltaTime_;
     this->initialize_();
 
@@ -83,7 +133,112 @@ namespace libRSF
     BiasTR_ = BiasTR;
 
     /** perform full pre-integration */
-    integrateFull_(CurrentTime_);
+    integrateFull_(EndTime);
+    return true;
+  }
+
+  PreintegratedIMUResult IMUPreintegrator::Reintegrate(const PreintegratedIMUResult &Preintegration,
+                                                       const Vector3 &BiasAcc, const Vector3 &BiasTR)
+  {
+    IMUPreintegrator PreInt(BiasAcc, BiasTR,
+                            Preintegration.NoiseDensityAcc, Preintegration.NoiseDensityGyro,
+                            Preintegration.RandomWalkAcc, Preintegration.RandomWalkGyro,
+                            Preintegration.StartTime);
+
+    const IMUSampleBuffer &Samples = Preintegration.Measurements;
+    for (size_t n = 0; n < Samples.size(); n++)
+    {
+      PreInt.addMeasurement(Samples.getTimestamp(n),
+                            Samples.getAcceleration(n), Samples.getTurnRate(n),
+                            Samples.getAccelerationCov(n), Samples.getTurnRateCov(n));
+    }
+
+    /** the last sample might be extrapolated up to the end */
+    const double EndTime = Preintegration.StartTime + Preintegration.DeltaTime;
+    if (!Samples.empty() && Samples.getTimestamp(Samples.size() - 1) < EndTime)
+    {
+      PreInt.integrateToTime(EndTime);
+    }
+
+    return PreInt.getPreintegratedState();
+  }
+
+  bool IMUPreintegrator::integrateIntervals(const IMUSampleBuffer &Samples,
+                                            const std::vector<double> &Boundaries,
+                                            const Vector3 &BiasAcc, const Vector3 &BiasTR,
+                                            const double NoiseDensityAcc, const double NoiseDensityGyro,
+                                            const double RandomWalkAcc, const double RandomWalkGyro,
+                                            std::vector<PreintegratedIMUResult> &Results,
+                                            int ThreadNumber)
+  {
+    if (Boundaries.size() < 2)
+    {
+      PRINT_ERROR("At least two boundaries are required!");
+      return false;
+    }
+    const size_t IntervalNumber = Boundaries.size() - 1;
+
+    /** samples of each interval as index range [Begin, End), the timestamps are sorted */
+    std::vector<std::pair<size_t, size_t>> Ranges(IntervalNumber);
+    size_t Begin = 0;
+    for (size_t n = 0; n < IntervalNumber; n++)
+    {
+      while (Begin < Samples.size() && Samples.getTimestamp(Begin) <= Boundaries[n])
+      {
+        Begin++;
+      }
+      size_t End = Begin;
+      while (End < Samples.size() && Samples.getTimestamp(End) <= Boundaries[n + 1])
+      {
+        End++;
+      }
+
+      /** without a sample, the last one before the end is held */
+      if (End == Begin)
+      {
+        if (Begin == 0)
+        {
+          PRINT_ERROR("There is no IMU measurement below ", Boundaries[n + 1], "!");
+          return false;
+        }
+        Ranges[n] = {Begin - 1, Begin};
+      }
+      else
+      {
+        Ranges[n] = {Begin, End};
+      }
+      Begin = End;
+    }
+
+    /** the intervals are independent, so each thread takes the next one */
+    Results.assign(IntervalNumber, PreintegratedIMUResult());
+    GetThreadPool().parallelFor(IntervalNumber, [&](const size_t n)
+    {
+      IMUPreintegrator PreInt(BiasAcc, BiasTR,
+                              NoiseDensityAcc, NoiseDensityGyro,
+                              RandomWalkAcc, RandomWalkGyro,
+                              Boundaries[n]);
+
+      /** the last sample is held until the end of the interval */
+      for (size_t i = Ranges[n].first; i < Ranges[n].second; i++)
+      {
+        const double Timestamp = (i + 1 == Ranges[n].second) ? Boundaries[n + 1] : Samples.getTimestamp(i);
+        PreInt.addMeasurement(Timestamp,
+                              Samples.getAcceleration(i), Samples.getTurnRate(i),
+                              Samples.getAccelerationCov(i), Samples.getTurnRateCov(i));
+      }
+      Results[n] = PreInt.getPreintegratedState();
+    }, ThreadNumber);
+
+    return true;
+  }
+
+  bool IMUPreintegrator::NeedsReintegration(const PreintegratedIMUResult &Preintegration,
+                                            const Vector3 &BiasAcc, const Vector3 &BiasTR,
+                                            const double Threshold)
+  {
+    return (BiasAcc - Preintegration.BiasAcc).norm() > Threshold ||
+           (BiasTR - Preintegration.BiasTR).norm() > Threshold;
   }
 
   PreintegratedIMUResult IMUPreintegrator::getPreintegratedState()
@@ -131,46 +286,70 @@ namespace libRSF
     /** measurements */
     Result.Measurements = Measurements_;
 
+    /** noise */
+    Result.NoiseDensityAcc = NoiseDensityAcc_;
+    Result.NoiseDensityGyro = NoiseDensityGyro_;
+    Result.RandomWalkAcc = RandomWalkAcc_;
+    Result.RandomWalkGyro = RandomWalkGyro_;
+
     return Result;
   }
 
   void IMUPreintegrator::addMeasurement(const Data &IMUMeasurement)
+  {
+    Measurements_.add(IMUMeasurement);
+    this->integrateSingleMeasurement_(Measurements_.size()-1, IMUMeasurement.getTimestamp());
+  }
+
+  void IMUPreintegrator::addMeasurement(const double Timestamp,
+                                        const Vector3 &Acceleration, const Vector3 &TurnRate,
+                                        const Vector3 &AccelerationCov, const Vector3 &TurnRateCov)
   {
     /** add to measurement list and perform an integration step */
-    Measurements_.emplace_back(IMUMeasurement);
-    this->integrateSingleMeasurement_(Measurements_.size()-1,IMUMeasurement.getTimestamp());
+    Measurements_.add(Timestamp, Acceleration, TurnRate, AccelerationCov, TurnRateCov);
+    this->integrateSingleMeasurement_(Measurements_.size()-1, Timestamp);
   }
 
   void IMUPreintegrator::integrateToTime(const double Timestamp)
   {
+    if (Measurements_.empty())
+    {
+      PRINT_ERROR("There is no IMU measurement to integrate!");
+      return;
+    }
     this->integrateSingleMeasurement_(Measurements_.size()-1,Timestamp);
   }
 
   void IMUPreintegrator::integrateFull_(const double Timestamp)
   {
+    if (Measurements_.empty())
+    {
+      return;
+    }
+
     /** loop over measurements and integrate */
-    for(int i = 0; i < static_cast<int>(Measurements_.size()); i++)
+    for(size_t i = 0; i < Measurements_.size(); i++)
     {
-      this->integrateSingleMeasurement_(i, Measurements_.at(i).getTimestamp());
+      this->integrateSingleMeasurement_(i, Measurements_.getTimestamp(i));
     }
     this->integrateSingleMeasurement_(Measurements_.size()-1,Timestamp);
   }
 
-  void IMUPreintegrator::integrateSingleMeasurement_(const int Index, const double Timestamp)
+  void IMUPreintegrator::integrateSingleMeasurement_(const size_t Index, const double Timestamp)
   {
     /** calculate delta t */
     const double dt = Timestamp - CurrentTime_;
 
     /** get measurements*/
-    Vector3 Acceleration2 = Measurements_.at(Index).getMean().head(3);
-    Vector3 TurnRate = Measurements_.at(Index).getMean().tail(3);
+    const Vector3 &Acceleration2 = Measurements_.getAcceleration(Index);
+    Vector3 TurnRate = Measurements_.getTurnRate(Index);
 
     /** average for mid-point integration */
     Vector3 Acceleration1;
     if (Index > 0)
     {
-      Acceleration1 = Measurements_.at(Index-1).getMean().head(3);
-      TurnRate = 0.5*(TurnRate + Measurements_.at(Index-1).getMean().tail(3));
+      Acceleration1 = Measurements_.getAcceleration(Index-1);
+      TurnRate = 0.5*(TurnRate + Measurements_.getTurnRate(Index-1));
     }
     else
     {
@@ -181,8 +360,7 @@ namespace libRSF
     Matrix33 AccelerationCov;
     if(NoiseDensityAcc_ <= 0.0)
     {
-      AccelerationCov =
-          Measurements_.at(Index).getCovarianceDiagonal().head(3).asDiagonal();
+      AccelerationCov = Measurements_.getAccelerationCov(Index).asDiagonal();
     }
     else
     {
@@ -192,8 +370,7 @@ namespace libRSF
     Matrix33 TurnRateCov ;
     if(NoiseDensityGyro_ <= 0.0)
     {
-      TurnRateCov =
-          Measurements_.at(Index).getCovarianceDiagonal().tail(3).asDiagonal();
+      TurnRateCov = Measurements_.getTurnRateCov(Index).asDiagonal();
     }
     else
     {
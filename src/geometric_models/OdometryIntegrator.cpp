@@ -88,81 +88,127 @@ namespace libRSF
 
   void OdometryIntegrator::addMeasurement(const libRSF::Data &Odom, const double DeltaTime)
   {
-    this->addMeasurement(Odom.getMean().head(3), Odom.getMean().tail(3),
-                         Odom.getCovarianceDiagonal().head(3), Odom.getCovarianceDiagonal().tail(3),
+    /** map instead of copying the dynamic vectors */
+    const VectorRefConst<double, Dynamic> Mean = Odom.getValue(DataElement::Mean);
+
+    Vector6 CovDiagonal;
+    if (Odom.checkElement(DataElement::CovarianceDiagonal))
+    {
+      CovDiagonal = Odom.getValue(DataElement::CovarianceDiagonal);
+    }
+    else
+    {
+      CovDiagonal = Odom.getCovarianceDiagonal();
+    }
+
+    this->addMeasurement(Mean.head<3>(), Mean.tail<3>(),
+                         CovDiagonal.head<3>(), CovDiagonal.tail<3>(),
                          DeltaTime);
   }
 
+  void OdometryIntegrator::addMeasurements(const std::vector<Data> &Odom, const double StartTime, const double EndTime)
+  {
+    if (Odom.empty())
+    {
+      return;
+    }
+
+    double TimeOld = StartTime;
+    for (const Data &Measurement : Odom)
+    {
+      const double Time = Measurement.getTimestamp();
+      this->addMeasurement(Measurement, Time - TimeOld);
+      TimeOld = Time;
+    }
+
+    /** hold the last measurement up to the end */
+    this->addMeasurement(Odom.back(), EndTime - TimeOld);
+  }
+
   void OdometryIntegrator::addMeasurement(const Vector3 &Velocity, const Vector3 &TurnRate,
                                               const Vector3 &VelocityCov, const Vector3 &TurnRateCov,
                                               const double DeltaTime)
   {
-    /** define basic autodiff type [Quat1, Vel, TR] */
-    using JetType = ceres::Jet<double, 13>;
-
-    /** old states */
-    VectorT<JetType,3> Point1Jet = this->Translation_.template cast<JetType>();
-    Point1Jet.x().v(0) = 1;
-    Point1Jet.y().v(1) = 1;
-    Point1Jet.z().v(2) = 1;
-
-    QuaternionT<JetType> Quat1Jet = this->Rotation_.template cast<JetType>();
-    Quat1Jet.x().v(3) = 1;
-    Quat1Jet.y().v(4) = 1;
-    Quat1Jet.z().v(5) = 1;
-    Quat1Jet.w().v(6) = 1;
-
-    /** measurements */
-    VectorT<JetType,3> VelocityJet = Velocity.template cast<JetType>();
-    VelocityJet.x().v(7) = 1;
-    VelocityJet.y().v(8) = 1;
-    VelocityJet.z().v(9) = 1;
-
-    VectorT<JetType,3> TurnRateJet = TurnRate.template cast<JetType>();
-    TurnRateJet.x().v(10) = 1;
-    TurnRateJet.y().v(11) = 1;
-    TurnRateJet.z().v(12) = 1;
-
-    /** new result states */
-    VectorT<JetType,3> Point2Jet;
-    QuaternionT<JetType> Quat2Jet;
-
-    /** perform integration */
-    OdometryModel6DOF<JetType>::applyForward(Point1Jet.data(), Quat1Jet.coeffs().data(),
-                                             Point2Jet.data(), Quat2Jet.coeffs().data(),
-                                             VelocityJet, TurnRateJet, DeltaTime);
-
-    /** store mean */
-    this->Translation_.x() = Point2Jet.x().a;
-    this->Translation_.y() = Point2Jet.y().a;
-    this->Translation_.z() = Point2Jet.z().a;
-
-    this->Rotation_.x() = Quat2Jet.x().a;
-    this->Rotation_.y() = Quat2Jet.y().a;
-    this->Rotation_.z() = Quat2Jet.z().a;
-    this->Rotation_.w() = Quat2Jet.w().a;
-
-    /** extract jacobian */
-    MatrixStatic<7,13> Jacobian;
-
-    Jacobian.row(0) = Point2Jet.x().v;
-    Jacobian.row(1) = Point2Jet.y().v;
-    Jacobian.row(2) = Point2Jet.z().v;
-
-    Jacobian.row(3) = Quat2Jet.x().v;
-    Jacobian.row(4) = Quat2Jet.y().v;
-    Jacobian.row(5) = Quat2Jet.z().v;
-    Jacobian.row(6) = Quat2Jet.w().v;
-
-    /** build full covariance */
-    MatrixStatic<13,13> Covariance;
-    Covariance.setZero();
-    Covariance.topLeftCorner<7,7>() = this->PoseCov_;
-    Covariance.bottomRightCorner<6,6>().topLeftCorner<3,3>() = VelocityCov.asDiagonal();
-    Covariance.bottomRightCorner<3,3>() = TurnRateCov.asDiagonal();
-
-    /** propagate covariance */
-    this->PoseCov_ = Jacobian*Covariance*Jacobian.transpose();
+    /** the same model as OdometryModel6DOF::applyForward(), but with closed-form Jacobians */
+    const Vector3 QuatVec = Rotation_.vec();
+    const double QuatW = Rotation_.w();
+
+    /** rotation increment as exponential map of the turn rate */
+    const Vector3 Angle = TurnRate * DeltaTime;
+    const double Norm = Angle.norm();
+    Quaternion Increment;
+    Matrix43 JacIncrement; /**< d Increment / d Angle, coefficient order x,y,z,w */
+    if (Norm > 1e-10)
+    {
+      const double Sin = sin(0.5 * Norm);
+      const double Cos = cos(0.5 * Norm);
+      const double Scale = Sin / Norm;
+      const double ScaleDerivative = (0.5 * Cos * Norm - Sin) / (Norm * Norm);
+
+      Increment.vec() = Scale * Angle;
+      Increment.w() = Cos;
+
+      JacIncrement.topRows<3>() = Scale * Matrix33::Identity() + (ScaleDerivative / Norm) * Angle * Angle.transpose();
+      JacIncrement.bottomRows<1>() = (-0.5 * Sin / Norm) * Angle.transpose();
+    }
+    else
+    {
+      /** linear approximation for small angles */
+      Increment.vec() = 0.5 * Angle;
+      Increment.w() = 1.0;
+
+      JacIncrement.topRows<3>() = 0.5 * Matrix33::Identity();
+      JacIncrement.bottomRows<1>().setZero();
+    }
+
+    /** translation: Point2 = Point1 + Rot1 * U with U = Velocity * dt, as evaluated by Eigen */
+    const Vector3 U = Velocity * DeltaTime;
+    const Vector3 QxU = QuatVec.cross(U);
+    const Matrix33 SkewQ = SkewSymmetricMatrix<double>(QuatVec);
+    const Matrix33 RotU = Matrix33::Identity() + 2.0 * QuatW * SkewQ + 2.0 * SkewQ * SkewQ;
+
+    Matrix34 JacTransQuat;
+    JacTransQuat.leftCols<3>() = -2.0 * QuatW * SkewSymmetricMatrix<double>(U) - 2.0 * SkewSymmetricMatrix<double>(QxU) - 2.0 * SkewQ * SkewSymmetricMatrix<double>(U);
+    JacTransQuat.col(3) = 2.0 * QxU;
+
+    /** rotation: Quat2 = Quat1 * Increment, linear in both factors */
+    Matrix44 JacQuatQuat; /**< right multiplication with the increment */
+    JacQuatQuat.topLeftCorner<3,3>() = Increment.w() * Matrix33::Identity() - SkewSymmetricMatrix<double>(Increment.vec());
+    JacQuatQuat.topRightCorner<3,1>() = Increment.vec();
+    JacQuatQuat.bottomLeftCorner<1,3>() = -Increment.vec().transpose();
+    JacQuatQuat(3,3) = Increment.w();
+
+    Matrix44 JacQuatIncrement; /**< left multiplication with the old rotation */
+    JacQuatIncrement.topLeftCorner<3,3>() = QuatW * Matrix33::Identity() + SkewQ;
+    JacQuatIncrement.topRightCorner<3,1>() = QuatVec;
+    JacQuatIncrement.bottomLeftCorner<1,3>() = -QuatVec.transpose();
+    JacQuatIncrement(3,3) = QuatW;
+
+    /** covariance with the block structure of the Jacobian [I, JacTransQuat; 0, JacQuatQuat] */
+    const Matrix33 CovTT = PoseCov_.topLeftCorner<3,3>();
+    const Matrix34 CovTQ = PoseCov_.topRightCorner<3,4>();
+    const Matrix44 CovQQ = PoseCov_.bottomRightCorner<4,4>();
+
+    const Matrix34 Temp = CovTQ + JacTransQuat * CovQQ;
+    Matrix33 CovTTNew = CovTT + JacTransQuat * CovTQ.transpose() + Temp * JacTransQuat.transpose();
+    const Matrix34 CovTQNew = Temp * JacQuatQuat.transpose();
+    Matrix44 CovQQNew = JacQuatQuat * CovQQ * JacQuatQuat.transpose();
+
+    /** measurement noise is diagonal */
+    const Matrix33 JacTransVel = RotU * DeltaTime;
+    const Matrix43 JacQuatTR = JacQuatIncrement * JacIncrement * DeltaTime;
+    CovTTNew.noalias() += JacTransVel * VelocityCov.asDiagonal() * JacTransVel.transpose();
+    CovQQNew.noalias() += JacQuatTR * TurnRateCov.asDiagonal() * JacQuatTR.transpose();
+
+    PoseCov_.topLeftCorner<3,3>() = CovTTNew;
+    PoseCov_.topRightCorner<3,4>() = CovTQNew;
+    PoseCov_.bottomLeftCorner<4,3>() = CovTQNew.transpose();
+    PoseCov_.bottomRightCorner<4,4>() = CovQQNew;
+
+    /** mean */
+    Translation_ += U + 2.0 * QuatW * QxU + 2.0 * QuatVec.cross(QxU);
+    Rotation_ = Rotation_ * Increment;
+
     this->Time_ += DeltaTime;
   }
 }
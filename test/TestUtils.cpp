@@ -22,6 +22,15 @@
 
 #include "TestUtils.h"
 
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <sstream>
+
+#ifdef LIBRSF_PERF_TEST
+#include <sys/resource.h>
+#endif
+
 namespace libRSF
 {
 
@@ -62,35 +71,8 @@ namespace libRSF
       PRINT_LOGGING("Length of estimate: " + std::to_string(LengthEstimate));
     }
 
-    /** vector to store errors */
-    Vector Error(LengthEstimate);
-
-    /** get first timestamp */
-    double Time = 0.0;
-    Estimate.getTimeFirst(TypeEstimate, Time);
-
-    /** fill error vector */
-    int n = 0;
-    do
-    {
-      /** get estimate at this timestamp */
-      Data DataEstimate;
-      Estimate.getElement(TypeEstimate, Time, 0, DataEstimate);
-
-      /** find closest GT */
-      double TimeGT = 0.0;
-      GT.getTimeCloseTo(TypeGT, Time, TimeGT);
-      Data DataGT;
-      GT.getElement(TypeGT, TimeGT, 0, DataGT);
-
-      /** euclidean distance*/
-      Error(n) = (DataEstimate.getMean() - DataGT.getMean()).norm();
-      n++;
-    }
-    while(Estimate.getTimeNext(TypeEstimate, Time, Time));
-
-    /** apply RMSE */
-    return RMSE(Error);
+    /** closest GT points in one linear pass */
+    return EvaluateTrajectory(GT, TypeGT, Estimate, TypeEstimate).ATE;
   }
 
 
@@ -219,4 +201,102 @@ namespace libRSF
         AlignedEstimate.getElement(PosID, Pos.getTimestamp(), 0).setMean(Pos.getMean() + Translation);
       }
   }
+
+  bool CheckPerformance(const std::string &Name,
+                        const std::string &TypeSummary,
+                        const StateDataSet &Result,
+                        const double DurationTotal)
+  {
+#ifndef LIBRSF_PERF_TEST
+    (void) Name;
+    (void) TypeSummary;
+    (void) Result;
+    (void) DurationTotal;
+    return true;
+#else
+    /** collect the solver information of the whole run */
+    PerformanceRecord Record;
+    Record.DurationTotal = DurationTotal;
+    if (Result.checkID(TypeSummary))
+    {
+      for (const Data &Summary : Result.getElementsOfID(TypeSummary))
+      {
+        if (Summary.checkElement(DataElement::DurationSolver))
+        {
+          Record.DurationSolver += Summary.getValue(DataElement::DurationSolver)(0);
+        }
+        if (Summary.checkElement(DataElement::IterationSolver))
+        {
+          Record.Iterations += Summary.getValue(DataElement::IterationSolver)(0);
+        }
+      }
+    }
+
+    /** linux reports kilobytes */
+    rusage Usage {};
+    getrusage(RUSAGE_SELF, &Usage);
+    Record.PeakMemory = static_cast<double>(Usage.ru_maxrss) / 1024.0;
+
+    PRINT_LOGGING("Performance of ", Name, ": ", Record.DurationTotal, "s total, ", Record.DurationSolver, "s solver, ",
+                  Record.Iterations, " iterations, ", Record.PeakMemory, "MB peak memory");
+
+    /** same format as the baselines */
+    const char* OutputFile = std::getenv("LIBRSF_PERF_OUTPUT");
+    std::ofstream Output(OutputFile != nullptr ? OutputFile : "PerformanceResults.txt", std::ios::app);
+    Output << Name << " " << Record.DurationTotal << " " << Record.DurationSolver << " " << Record.Iterations << " " << Record.PeakMemory << std::endl;
+
+    /** read baselines: name, total duration, solver duration, iterations, peak memory */
+    std::map<std::string, PerformanceRecord> Baselines;
+    std::ifstream BaselineFile("test/PerformanceBaselines.txt");
+    std::string Line;
+    while (std::getline(BaselineFile, Line))
+    {
+      std::istringstream Stream(Line);
+      std::string Key;
+      PerformanceRecord Baseline;
+      if (Line.empty() || Line.front() == '#')
+      {
+        continue;
+      }
+      if (Stream >> Key >> Baseline.DurationTotal >> Baseline.DurationSolver >> Baseline.Iterations >> Baseline.PeakMemory)
+      {
+        Baselines.emplace(Key, Baseline);
+      }
+    }
+
+    if (Baselines.count(Name) == 0)
+    {
+      PRINT_WARNING("There is no performance baseline for ", Name, "!");
+      return true;
+    }
+    const PerformanceRecord &Baseline = Baselines.at(Name);
+
+    /** runtime depends on the machine, so its tolerance can be changed */
+    const char* ToleranceString = std::getenv("LIBRSF_PERF_TOLERANCE");
+    const double Tolerance = (ToleranceString != nullptr) ? std::stod(ToleranceString) : 1.5;
+
+    bool IsValid = true;
+    if (Record.DurationTotal > Tolerance * Baseline.DurationTotal)
+    {
+      PRINT_ERROR(Name, " took ", Record.DurationTotal, "s instead of ", Baseline.DurationTotal, "s!");
+      IsValid = false;
+    }
+    if (Record.DurationSolver > Tolerance * Baseline.DurationSolver)
+    {
+      PRINT_ERROR(Name, " spent ", Record.DurationSolver, "s in the solver instead of ", Baseline.DurationSolver, "s!");
+      IsValid = false;
+    }
+    if (Record.Iterations > std::max(1.1 * Baseline.Iterations, Baseline.Iterations + 5.0))
+    {
+      PRINT_ERROR(Name, " needed ", Record.Iterations, " iterations instead of ", Baseline.Iterations, "!");
+      IsValid = false;
+    }
+    if (Record.PeakMemory > 1.25 * Baseline.PeakMemory)
+    {
+      PRINT_ERROR(Name, " used ", Record.PeakMemory, "MB instead of ", Baseline.PeakMemory, "MB!");
+      IsValid = false;
+    }
+    return IsValid;
+#endif
+  }
 }
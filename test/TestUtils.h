@@ -55,6 +55,22 @@ namespace libRSF
                          const std::string &RotID,
                          const StateDataSet &Estimate,
                          StateDataSet &AlignedEstimate);
+
+  /** runtime behavior of one test case */
+  struct PerformanceRecord
+  {
+    double DurationTotal = 0.0;  /**< seconds */
+    double DurationSolver = 0.0; /**< seconds, summed over all solver calls */
+    double Iterations = 0.0;     /**< summed over all solver calls */
+    double PeakMemory = 0.0;     /**< peak resident memory of the process in MB, ctest runs every test in its own process */
+  };
+
+  /** compare a test case with its baseline in test/PerformanceBaselines.txt, only active if built with LIBRSF_BUILD_PERF_TEST,
+   *  every record is appended to PerformanceResults.txt (or $LIBRSF_PERF_OUTPUT) to create new baselines */
+  bool CheckPerformance(const std::string &Name,
+                        const std::string &TypeSummary,
+                        const StateDataSet &Result,
+                        double DurationTotal);
 }
 
 #endif // TESTUTILS_H
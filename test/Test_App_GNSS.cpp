@@ -61,7 +61,15 @@ bool RunGNSS(const std::string& DataSet,
   Config.Solution.EstimateCov = false;
 
   /** run optimization */
-  return CreateGraphAndSolve(Config, Result) > 0;
+  libRSF::Timer Runtime;
+  const bool Failed = CreateGraphAndSolve(Config, Result) > 0;
+
+  /** compare with the performance baseline, only with LIBRSF_BUILD_PERF_TEST */
+  const ::testing::TestInfo* const Test = ::testing::UnitTest::GetInstance()->current_test_info();
+  EXPECT_TRUE(libRSF::CheckPerformance(std::string(Test->test_suite_name()) + "." + Test->name(), SOLVE_TIME_STATE, Result, Runtime.getSeconds()))
+      << "Performance regression";
+
+  return Failed;
 }
 
 TEST(App_GNSS, Berlin_Potsdamer_Platz)
@@ -88,4 +96,37 @@ TEST(App_GNSS, Frankfurt_Main_Tower)
   const double ATE = libRSF::ATE(libRSF::DataType::Point3, GT, POSITION_STATE, Result);
   PRINT_LOGGING("ATE: ", ATE, "m");
   EXPECT_NEAR(ATE, 13.9, 0.1);
-}
\ No newline at end of file
+}
+#ifdef LIBRSF_ALLOCATION_TRACKING
+TEST(App_GNSS, Window_Allocations)
+{
+  /** calculate example */
+  libRSF::StateDataSet Result;
+  libRSF::SensorDataSet GT;
+  ASSERT_FALSE(RunGNSS(DATA_BPB, Result, GT)) << "Error calculating example";
+  ASSERT_TRUE(Result.checkID(SOLVE_TIME_STATE)) << "No solver summary";
+
+  /** the window has a constant size, so allocations per epoch must not grow with the length of the dataset */
+  const std::vector<libRSF::Data> Summaries = Result.getElementsOfID(SOLVE_TIME_STATE);
+  ASSERT_GT(Summaries.size(), 100U);
+  const size_t WarmUp = Summaries.size() / 4;
+
+  libRSF::Vector4 Bound = libRSF::Vector4::Zero();
+  for (size_t n = 0; n < WarmUp; ++n)
+  {
+    Bound = Bound.cwiseMax(Summaries.at(n).getValue(libRSF::DataElement::Allocations));
+  }
+
+  /** twice the peak of the first quarter, the window is already full at this point */
+  Bound *= 2.0;
+  PRINT_LOGGING("Allocation bound [Predict, Measure, Solve, Save]: ", Bound.transpose());
+
+  /** skip the final solve, it is outside the loop */
+  for (size_t n = WarmUp; n + 1 < Summaries.size(); ++n)
+  {
+    const libRSF::Vector4 Allocations = Summaries.at(n).getValue(libRSF::DataElement::Allocations);
+    EXPECT_TRUE((Allocations.array() <= Bound.array()).all())
+        << "Allocations at " << Summaries.at(n).getTimestamp() << ": " << Allocations.transpose();
+  }
+}
+#endif // LIBRSF_ALLOCATION_TRACKING
@@ -62,7 +62,15 @@ bool RunRanging(const std::string& DataSet,
   Config.Solution.EstimateCov = false;
 
   /** run optimization */
-  return CreateGraphAndSolve(Config, Result) > 0;
+  libRSF::Timer Runtime;
+  const bool Failed = CreateGraphAndSolve(Config, Result) > 0;
+
+  /** compare with the performance baseline, only with LIBRSF_BUILD_PERF_TEST */
+  const ::testing::TestInfo* const Test = ::testing::UnitTest::GetInstance()->current_test_info();
+  EXPECT_TRUE(libRSF::CheckPerformance(std::string(Test->test_suite_name()) + "." + Test->name(), SOLVE_TIME_STATE, Result, Runtime.getSeconds()))
+      << "Performance regression";
+
+  return Failed;
 }
 
 TEST(App_Ranging_2D, M3500_heavy_tailed)
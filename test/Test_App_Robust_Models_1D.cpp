@@ -61,7 +61,7 @@ void App_Robust_Models_1D_Testfunction(std::string Model, const double Mean, con
   libRSF::StateDataSet PostOptimizationData;
   libRSF::StateDataSet SolverData;
 
-  ASSERT_FALSE(CreateGraphAndSolve(Arguments,
+  ASSERT_FALSE(CreateGraphAndSolve(Arguments, Config,
                                    CostSurfaceData, PreOptimizationData, PostOptimizationData,
                                    SolverData)) << "Error calculating example";
 
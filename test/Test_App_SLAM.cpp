@@ -59,11 +59,17 @@ bool RunSLAM(const std::string& DataSet,
   Config.Solution.EstimateCov = false;
 
   /** run optimization */
+  libRSF::Timer Runtime;
   if (CreateGraphAndSolve(Config, Result) > 0)
   {
     return false;
   }
 
+  /** compare with the performance baseline, only with LIBRSF_BUILD_PERF_TEST */
+  const ::testing::TestInfo* const Test = ::testing::UnitTest::GetInstance()->current_test_info();
+  EXPECT_TRUE(libRSF::CheckPerformance(std::string(Test->test_suite_name()) + "." + Test->name(), SOLVE_TIME_STATE, Result, Runtime.getSeconds()))
+      << "Performance regression";
+
   /** align trajectory and GT*/
   libRSF::StateDataSet ResultAligned;
   libRSF::AlignTrajectory2D(GT, POSITION_STATE, ORIENTATION_STATE, Result, ResultAligned);
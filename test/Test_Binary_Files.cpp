@@ -0,0 +1,251 @@
+/***************************************************************************
+ * libRSF - A Robust Sensor Fusion Library
+ *
+ * Copyright (C) 2018 Chair of Automation Technology / TU Chemnitz
+ * For more information see https://www.tu-chemnitz.de/etit/proaut/libRSF
+ *
+ * libRSF is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libRSF is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with libRSF.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Tim Pfeifer (tim.pfeifer@etit.tu-chemnitz.de)
+ ***************************************************************************/
+
+ /**
+ * @file Test_Binary_Files.cpp
+ * @author Tim Pfeifer
+ * @date 14.10.2026
+ * @brief Round trips of the binary data formats, filtered reads and the streaming binary source.
+ * @copyright GNU Public License.
+ *
+ */
+
+#include "TestUtils.h"
+#include "gtest/gtest.h"
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+
+namespace
+{
+  constexpr int ObjectNumber = 5000;
+  constexpr double SampleTime = 0.1;
+
+  /** two types with different layouts, the second one at half the rate and with an offset in time */
+  libRSF::SensorDataSet CreateDataSet()
+  {
+    libRSF::SensorDataSet Set;
+    for (int n = 0; n < ObjectNumber; n++)
+    {
+      libRSF::Data Point2(libRSF::DataType::Point2, n * SampleTime);
+      Point2.setMean(libRSF::Vector2(n, -0.5 * n));
+      Point2.setCovarianceMatrix(libRSF::Matrix22(libRSF::Vector2(1.0 + n * 1e-3, 2.0).asDiagonal()));
+      Set.addElement(Point2);
+
+      if (n % 2 == 0)
+      {
+        libRSF::Data Point3(libRSF::DataType::Point3, n * SampleTime + 0.05);
+        Point3.setMean(libRSF::Vector3(n, 1.0 / (n + 1.0), -n));
+        Set.addElement(Point3);
+      }
+    }
+    return Set;
+  }
+
+  std::string TempFile(const std::string &Name)
+  {
+    return (std::filesystem::temp_directory_path() / ("libRSF_" + Name)).string();
+  }
+
+  int Count(const libRSF::SensorDataSet &Set, const libRSF::DataType Type)
+  {
+    return Set.checkID(Type) ? Set.countElements(Type) : 0;
+  }
+
+  /** compares the complete buffers, so every element of the layout survives the round trip */
+  void ExpectEqual(const libRSF::SensorDataSet &Expected, const libRSF::SensorDataSet &Actual, const libRSF::DataType Type)
+  {
+    const std::vector<libRSF::Data> ExpectedObjects = Expected.getElementsOfID(Type);
+    const std::vector<libRSF::Data> ActualObjects = Actual.getElementsOfID(Type);
+    ASSERT_EQ(ExpectedObjects.size(), ActualObjects.size());
+    for (size_t n = 0; n < ExpectedObjects.size(); n++)
+    {
+      EXPECT_EQ(ExpectedObjects.at(n).getBuffer(), ActualObjects.at(n).getBuffer());
+    }
+  }
+
+  void ExpectRoundTrip(const std::string &Filename)
+  {
+    const libRSF::SensorDataSet Original = CreateDataSet();
+    libRSF::SensorDataSet Read;
+    ASSERT_TRUE(libRSF::ReadDataFromBinaryFile(Filename, Read));
+    ExpectEqual(Original, Read, libRSF::DataType::Point2);
+    ExpectEqual(Original, Read, libRSF::DataType::Point3);
+  }
+
+  /** the types are selected by block and the time range by chunk and object */
+  void ExpectFilteredRead(const std::string &Filename)
+  {
+    libRSF::BinaryDataFilter Filter;
+    Filter.Types = {libRSF::DataType::Point2};
+    Filter.TimeBegin = 100.0;
+    Filter.TimeEnd = 200.0;
+
+    libRSF::SensorDataSet Read;
+    ASSERT_TRUE(libRSF::ReadDataFromBinaryFile(Filename, Read, Filter, 4));
+    EXPECT_EQ(Count(Read, libRSF::DataType::Point2), 1001);
+    EXPECT_EQ(Count(Read, libRSF::DataType::Point3), 0);
+
+    double Timestamp = 0.0;
+    ASSERT_TRUE(Read.getTimeFirst(libRSF::DataType::Point2, Timestamp));
+    EXPECT_DOUBLE_EQ(Timestamp, 100.0);
+    ASSERT_TRUE(Read.getTimeLast(libRSF::DataType::Point2, Timestamp));
+    EXPECT_DOUBLE_EQ(Timestamp, 200.0);
+  }
+
+  /** small steps across many chunk borders have to return every object exactly once */
+  void ExpectStepping(const std::string &Filename)
+  {
+    const libRSF::SensorDataSet Original = CreateDataSet();
+    libRSF::SensorDataBinarySource Source(Filename);
+    ASSERT_TRUE(Source.isValid());
+
+    double Timestamp = 0.0;
+    ASSERT_TRUE(Source.getTimeFirst(libRSF::DataType::Point3, Timestamp));
+    EXPECT_DOUBLE_EQ(Timestamp, 0.05);
+    ASSERT_TRUE(Source.getTimeLast(libRSF::DataType::Point2, Timestamp));
+    EXPECT_NEAR(Timestamp, (ObjectNumber - 1) * SampleTime, 1e-9);
+
+    double Next = 0.0;
+    ASSERT_TRUE(Source.getTimeNext(libRSF::DataType::Point3, libRSF::roundToTick(50.05), Next));
+    EXPECT_NEAR(Next, 50.25, 1e-9);
+
+    libRSF::SensorDataSet Read;
+    Source.getMeasurementsUntil(100.0, Read);
+    EXPECT_EQ(Count(Read, libRSF::DataType::Point2), 1001);
+    EXPECT_EQ(Count(Read, libRSF::DataType::Point3), 500);
+
+    const double TimeEnd = ObjectNumber * SampleTime;
+    for (double Time = 100.0; Time < TimeEnd; Time += 3.7)
+    {
+      Source.getMeasurementsUntil(Time, Read);
+    }
+    Source.getMeasurementsUntil(TimeEnd, Read);
+    ExpectEqual(Original, Read, libRSF::DataType::Point2);
+    ExpectEqual(Original, Read, libRSF::DataType::Point3);
+  }
+
+  std::string ReadFile(const std::string &Filename)
+  {
+    std::ifstream File(Filename, std::ios::binary);
+    return {std::istreambuf_iterator<char>(File), std::istreambuf_iterator<char>()};
+  }
+
+  void WriteFile(const std::string &Filename, const std::string &Content)
+  {
+    std::ofstream File(Filename, std::ios::binary | std::ios::trunc);
+    File.write(Content.data(), static_cast<std::streamsize>(Content.size()));
+  }
+}
+
+TEST(BinaryFile, Legacy)
+{
+  const std::string Filename = TempFile("legacy.bin");
+  ASSERT_TRUE(libRSF::WriteDataToBinaryFile(Filename, CreateDataSet()));
+  EXPECT_TRUE(libRSF::IsBinaryDataFile(Filename));
+
+  ExpectRoundTrip(Filename);
+  ExpectFilteredRead(Filename);
+  ExpectStepping(Filename);
+
+  std::filesystem::remove(Filename);
+}
+
+TEST(BinaryFile, Chunked)
+{
+  const std::string Filename = TempFile("chunked.bin");
+  ASSERT_TRUE(libRSF::WriteDataToBinaryFile(Filename, CreateDataSet(), libRSF::BinaryCompression::None, 3, 97));
+
+  /** the chunk size is not aligned with the filter, so chunks are cut on both ends */
+  libRSF::FileView File(Filename);
+  libRSF::BinaryCompression Compression;
+  std::vector<libRSF::BinaryDataBlock> Blocks;
+  ASSERT_TRUE(libRSF::ReadBinaryDataIndex(File, Filename, Compression, Blocks));
+  EXPECT_EQ(Compression, libRSF::BinaryCompression::None);
+  ASSERT_EQ(Blocks.size(), 2U);
+  for (const libRSF::BinaryDataBlock &Block : Blocks)
+  {
+    EXPECT_EQ(Block.Chunks.size(), static_cast<size_t>((Count(CreateDataSet(), Block.Type) + 96) / 97));
+  }
+
+  ExpectRoundTrip(Filename);
+  ExpectFilteredRead(Filename);
+  ExpectStepping(Filename);
+
+  std::filesystem::remove(Filename);
+}
+
+TEST(BinaryFile, Chunked_Zstd)
+{
+  const std::string Filename = TempFile("zstd.bin");
+  ASSERT_TRUE(libRSF::WriteDataToBinaryFile(Filename, CreateDataSet(), libRSF::BinaryCompression::Zstd, 3, 97));
+
+  /** without zstd the writer falls back to uncompressed chunks */
+  libRSF::FileView File(Filename);
+  libRSF::BinaryCompression Compression;
+  std::vector<libRSF::BinaryDataBlock> Blocks;
+  ASSERT_TRUE(libRSF::ReadBinaryDataIndex(File, Filename, Compression, Blocks));
+#ifdef LIBRSF_ZSTD
+  EXPECT_EQ(Compression, libRSF::BinaryCompression::Zstd);
+#else
+  EXPECT_EQ(Compression, libRSF::BinaryCompression::None);
+#endif
+
+  ExpectRoundTrip(Filename);
+  ExpectFilteredRead(Filename);
+  ExpectStepping(Filename);
+
+  std::filesystem::remove(Filename);
+}
+
+TEST(BinaryFile, Corrupt_Index)
+{
+  const std::string Name = libRSF::GlobalDataConfig.getName(libRSF::DataType::Point2);
+  const uint64_t Huge = (uint64_t(1) << 61) + 1;
+  libRSF::SensorDataSet Read;
+
+  /** legacy: the object number of the first block would overflow the size of its values */
+  const std::string Legacy = TempFile("corrupt_legacy.bin");
+  ASSERT_TRUE(libRSF::WriteDataToBinaryFile(Legacy, CreateDataSet()));
+  std::string Content = ReadFile(Legacy);
+  const size_t LegacyPosition = Content.find(Name) + Name.size() + sizeof(uint32_t);
+  std::memcpy(&Content.at(LegacyPosition), &Huge, sizeof(Huge));
+  WriteFile(Legacy, Content);
+  EXPECT_FALSE(libRSF::ReadDataFromBinaryFile(Legacy, Read));
+  EXPECT_FALSE(libRSF::SensorDataBinarySource(Legacy).isValid());
+  std::filesystem::remove(Legacy);
+
+  /** chunked: the first chunk entry claims more objects than the file can hold */
+  const std::string Chunked = TempFile("corrupt_chunked.bin");
+  ASSERT_TRUE(libRSF::WriteDataToBinaryFile(Chunked, CreateDataSet(), libRSF::BinaryCompression::None, 3, 97));
+  Content = ReadFile(Chunked);
+  uint64_t IndexPosition = 0;
+  std::memcpy(&IndexPosition, Content.data() + sizeof(libRSF::BinaryDataMagic) + 3 * sizeof(uint32_t), sizeof(IndexPosition));
+  const size_t ChunkPosition = Content.find(Name, IndexPosition) + Name.size() + 2 * sizeof(uint32_t);
+  std::memcpy(&Content.at(ChunkPosition), &Huge, sizeof(Huge));
+  WriteFile(Chunked, Content);
+  EXPECT_FALSE(libRSF::ReadDataFromBinaryFile(Chunked, Read));
+  EXPECT_FALSE(libRSF::SensorDataBinarySource(Chunked).isValid());
+  std::filesystem::remove(Chunked);
+}
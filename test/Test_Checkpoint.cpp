@@ -0,0 +1,216 @@
+/***************************************************************************
+ * libRSF - A Robust Sensor Fusion Library
+ *
+ * Copyright (C) 2018 Chair of Automation Technology / TU Chemnitz
+ * For more information see https://www.tu-chemnitz.de/etit/proaut/libRSF
+ *
+ * libRSF is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libRSF is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with libRSF.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Tim Pfeifer (tim.pfeifer@etit.tu-chemnitz.de)
+ ***************************************************************************/
+
+
+ /**
+ * @file Test_Checkpoint.cpp
+ * @author Tim Pfeifer
+ * @date 14.10.2026
+ * @brief Restore factor graphs from binary checkpoints and reject broken ones.
+ * @copyright GNU Public License.
+ *
+ */
+
+#include "TestUtils.h"
+#include "gtest/gtest.h"
+
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+namespace
+{
+  const std::string State = "Position";
+  const int StateNumber = 5;
+
+  std::string TempFile(const std::string &Name)
+  {
+    return (std::filesystem::temp_directory_path() / ("libRSF_" + Name)).string();
+  }
+
+  std::string ReadFile(const std::string &Filename)
+  {
+    std::ifstream File(Filename, std::ios::binary);
+    std::stringstream Stream;
+    Stream << File.rdbuf();
+    return Stream.str();
+  }
+
+  void WriteFile(const std::string &Filename, const std::string &Content)
+  {
+    std::ofstream File(Filename, std::ios::binary | std::ios::trunc);
+    File.write(Content.data(), static_cast<std::streamsize>(Content.size()));
+  }
+
+  ceres::Solver::Options SolverOptions()
+  {
+    ceres::Solver::Options Options;
+    Options.linear_solver_type = ceres::LinearSolverType::DENSE_QR;
+    Options.function_tolerance = 1e-12;
+    Options.gradient_tolerance = 1e-14;
+    Options.parameter_tolerance = 1e-12;
+    return Options;
+  }
+
+  /** 1D chain with a bounded state and a marginalized first state */
+  void CreateGraph(libRSF::FactorGraph &Graph)
+  {
+    Graph.setCheckpointRecording(true);
+
+    libRSF::GaussianDiagonal<1> Noise;
+    Noise.setStdDevSharedDiagonal(0.5);
+
+    for (int n = 0; n < StateNumber; n++)
+    {
+      Graph.addState(State, libRSF::DataType::Point1, n);
+
+      libRSF::Data Prior(libRSF::DataType::Point1, n);
+      Prior.setMean(libRSF::Vector1::Constant(n + 0.1 * (n % 2)));
+      Graph.addFactor<libRSF::FactorType::Prior1>(libRSF::StateID(State, n), Prior, Noise);
+
+      if (n > 0)
+      {
+        libRSF::Data Odometry(libRSF::DataType::Point1, n);
+        Odometry.setMean(libRSF::Vector1::Constant(1.05));
+        Graph.addFactor<libRSF::FactorType::BetweenValue1>(libRSF::StateID(State, n - 1), libRSF::StateID(State, n), Odometry, Noise);
+      }
+    }
+
+    /** the bound is active at the optimum */
+    Graph.setLowerBound(State, 2, 0, libRSF::Vector1::Constant(2.5));
+
+    Graph.solve(SolverOptions());
+    ASSERT_TRUE(Graph.marginalizeState(State, 0));
+  }
+}
+
+TEST(Checkpoint, Round_Trip)
+{
+  const std::string Filename = TempFile("checkpoint.bin");
+
+  libRSF::FactorGraph Graph;
+  CreateGraph(Graph);
+  ASSERT_TRUE(Graph.saveCheckpoint(Filename));
+
+  libRSF::FactorGraph Restored;
+  ASSERT_TRUE(Restored.loadCheckpoint(Filename));
+
+  EXPECT_EQ(Restored.countFactorsOfType(libRSF::FactorType::Prior1), Graph.countFactorsOfType(libRSF::FactorType::Prior1));
+  EXPECT_EQ(Restored.countFactorsOfType(libRSF::FactorType::BetweenValue1), Graph.countFactorsOfType(libRSF::FactorType::BetweenValue1));
+  EXPECT_EQ(Restored.getStateData().countElements(State), Graph.getStateData().countElements(State));
+
+  /** a restored graph is stored again without changes */
+  const std::string Filename2 = TempFile("checkpoint_2.bin");
+  ASSERT_TRUE(Restored.saveCheckpoint(Filename2));
+  EXPECT_EQ(ReadFile(Filename), ReadFile(Filename2));
+
+  /** both graphs reach the same optimum, including the bound and the marginal prior */
+  Graph.solve(SolverOptions());
+  Restored.solve(SolverOptions());
+  for (int n = 1; n < StateNumber; n++)
+  {
+    const libRSF::Vector Expected = Graph.getStateData().getElement(State, n).getMean();
+    EXPECT_LT((Restored.getStateData().getElement(State, n).getMean() - Expected).norm(), 1e-8);
+  }
+  EXPECT_GE(Restored.getStateData().getElement(State, 2).getMean()(0), 2.5 - 1e-12);
+
+  std::filesystem::remove(Filename);
+  std::filesystem::remove(Filename2);
+}
+
+TEST(Checkpoint, Truncated)
+{
+  const std::string Filename = TempFile("checkpoint_truncated.bin");
+
+  libRSF::FactorGraph Graph;
+  CreateGraph(Graph);
+  ASSERT_TRUE(Graph.saveCheckpoint(Filename));
+  const std::string Content = ReadFile(Filename);
+
+  /** every strict prefix has to be rejected */
+  for (size_t Length = 0; Length < Content.size(); Length += std::max<size_t>(1, Content.size() / 64))
+  {
+    WriteFile(Filename, Content.substr(0, Length));
+    libRSF::FactorGraph Restored;
+    EXPECT_FALSE(Restored.loadCheckpoint(Filename)) << "Prefix of " << Length << " bytes was accepted.";
+  }
+
+  std::filesystem::remove(Filename);
+}
+
+TEST(Checkpoint, Header)
+{
+  const std::string Filename = TempFile("checkpoint_header.bin");
+
+  libRSF::FactorGraph Graph;
+  CreateGraph(Graph);
+  ASSERT_TRUE(Graph.saveCheckpoint(Filename));
+  const std::string Content = ReadFile(Filename);
+
+  /** magic number */
+  std::string Broken = Content;
+  Broken.at(0) = 'X';
+  WriteFile(Filename, Broken);
+  libRSF::FactorGraph BadMagic;
+  EXPECT_FALSE(BadMagic.loadCheckpoint(Filename));
+
+  /** version follows the four bytes of the magic number */
+  Broken = Content;
+  Broken.at(4) = static_cast<char>(Broken.at(4) + 1);
+  WriteFile(Filename, Broken);
+  libRSF::FactorGraph BadVersion;
+  EXPECT_FALSE(BadVersion.loadCheckpoint(Filename));
+
+  std::filesystem::remove(Filename);
+}
+
+TEST(Checkpoint, Matrix_Size)
+{
+  const std::string Filename = TempFile("checkpoint_matrix.bin");
+
+  /** dimensions whose product overflows and exceeds the archive */
+  libRSF::CheckpointWriter Writer;
+  Writer.write(static_cast<int64_t>(1) << 62);
+  Writer.write(static_cast<int64_t>(8));
+  Writer.write(1.0);
+  ASSERT_TRUE(Writer.writeToFile(Filename));
+
+  libRSF::CheckpointReader Reader;
+  ASSERT_TRUE(Reader.readFromFile(Filename));
+  libRSF::Matrix Matrix;
+  EXPECT_FALSE(Reader.readMatrix(Matrix));
+
+  /** a matching size is read */
+  libRSF::CheckpointWriter Valid;
+  Valid.writeMatrix(libRSF::Matrix22::Identity());
+  ASSERT_TRUE(Valid.writeToFile(Filename));
+
+  libRSF::CheckpointReader ValidReader;
+  ASSERT_TRUE(ValidReader.readFromFile(Filename));
+  ASSERT_TRUE(ValidReader.readMatrix(Matrix));
+  EXPECT_EQ(Matrix, libRSF::Matrix22::Identity());
+  EXPECT_TRUE(ValidReader.isAtEnd());
+
+  std::filesystem::remove(Filename);
+}
+
+/** main provided by linking to gtest_main */
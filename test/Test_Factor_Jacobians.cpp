@@ -0,0 +1,424 @@
+/***************************************************************************
+ * libRSF - A Robust Sensor Fusion Library
+ *
+ * Copyright (C) 2018 Chair of Automation Technology / TU Chemnitz
+ * For more information see https://www.tu-chemnitz.de/etit/proaut/libRSF
+ *
+ * libRSF is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libRSF is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with libRSF.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Tim Pfeifer (tim.pfeifer@etit.tu-chemnitz.de)
+ ***************************************************************************/
+
+ /**
+ * @file Test_Factor_Jacobians.cpp
+ * @author Tim Pfeifer
+ * @date 14.10.2026
+ * @brief Compares the analytic Jacobians of factors with automatic differentiation.
+ * @copyright GNU Public License.
+ *
+ */
+
+#include "TestUtils.h"
+#include "gtest/gtest.h"
+
+#include <memory>
+#include <random>
+
+namespace
+{
+  std::mt19937 Generator(42);
+
+  libRSF::Vector RandomVector(const int Size, const double Scale)
+  {
+    std::normal_distribution<double> Normal(0.0, Scale);
+    libRSF::Vector Random(Size);
+    for (int n = 0; n < Size; n++)
+    {
+      Random(n) = Normal(Generator);
+    }
+    return Random;
+  }
+
+  libRSF::Matrix33 RandomMatrix(const double Scale)
+  {
+    libRSF::Matrix33 Random;
+    Random.row(0) = RandomVector(3, Scale).transpose();
+    Random.row(1) = RandomVector(3, Scale).transpose();
+    Random.row(2) = RandomVector(3, Scale).transpose();
+    return Random;
+  }
+
+  libRSF::Vector4 RandomQuaternion()
+  {
+    return libRSF::QuaternionExpMap<double>(RandomVector(3, 1.0)).coeffs();
+  }
+
+  /** dense Jacobians of all states, quaternion states are projected into their tangent space */
+  void EvaluateLocal(const ceres::CostFunction &CostFunction,
+                     std::vector<libRSF::Vector> &States,
+                     const std::vector<bool> &IsQuaternion,
+                     libRSF::Vector &Residuals,
+                     std::vector<libRSF::Matrix> &Jacobians)
+  {
+    const std::vector<int32_t> &Dims = CostFunction.parameter_block_sizes();
+    const int ResidualNumber = CostFunction.num_residuals();
+
+    std::vector<const double*> StatePointers;
+    std::vector<libRSF::Matrix> Global;
+    std::vector<double*> JacobianPointers;
+    for (size_t n = 0; n < States.size(); n++)
+    {
+      StatePointers.push_back(States.at(n).data());
+      Global.emplace_back(ResidualNumber, Dims.at(n));
+    }
+    for (libRSF::Matrix &Jacobian : Global)
+    {
+      JacobianPointers.push_back(Jacobian.data());
+    }
+
+    Residuals.resize(ResidualNumber);
+    ASSERT_TRUE(CostFunction.Evaluate(StatePointers.data(), Residuals.data(), JacobianPointers.data()));
+
+    /** the residual alone has to be the same */
+    libRSF::Vector ResidualsOnly(ResidualNumber);
+    ASSERT_TRUE(CostFunction.Evaluate(StatePointers.data(), ResidualsOnly.data(), nullptr));
+    EXPECT_LT((ResidualsOnly - Residuals).norm(), 1e-12);
+
+    const libRSF::QuaternionLocalParameterization Parametrization;
+    Jacobians.clear();
+    for (size_t n = 0; n < States.size(); n++)
+    {
+      if (IsQuaternion.at(n))
+      {
+        libRSF::Matrix43 Plus;
+        Parametrization.ComputeJacobian(States.at(n).data(), Plus.data());
+        Jacobians.emplace_back(Global.at(n) * Plus);
+      }
+      else
+      {
+        Jacobians.push_back(Global.at(n));
+      }
+    }
+  }
+
+  void CompareJacobians(const ceres::CostFunction &Analytic,
+                        const ceres::CostFunction &AutoDiff,
+                        std::vector<libRSF::Vector> States,
+                        const std::vector<bool> &IsQuaternion)
+  {
+    libRSF::Vector ResidualsAnalytic, ResidualsAutoDiff;
+    std::vector<libRSF::Matrix> JacobiansAnalytic, JacobiansAutoDiff;
+    EvaluateLocal(Analytic, States, IsQuaternion, ResidualsAnalytic, JacobiansAnalytic);
+    EvaluateLocal(AutoDiff, States, IsQuaternion, ResidualsAutoDiff, JacobiansAutoDiff);
+
+    EXPECT_LT((ResidualsAnalytic - ResidualsAutoDiff).norm(), 1e-9 * (1.0 + ResidualsAutoDiff.norm()));
+    for (size_t n = 0; n < States.size(); n++)
+    {
+      EXPECT_LT((JacobiansAnalytic.at(n) - JacobiansAutoDiff.at(n)).norm(), 1e-8 * (1.0 + JacobiansAutoDiff.at(n).norm())) << "State: " << n;
+    }
+  }
+
+  libRSF::GaussianDiagonal<1> RandomNoise1D()
+  {
+    libRSF::GaussianDiagonal<1> Noise;
+    Noise.setStdDevSharedDiagonal(0.1 + std::abs(RandomVector(1, 1.0)(0)));
+    return Noise;
+  }
+
+  /** a switch between its bounds, so the robust weight is active */
+  libRSF::Vector RandomSwitch()
+  {
+    return libRSF::Vector1::Constant(0.1 + 0.9 * std::abs(std::tanh(RandomVector(1, 1.0)(0))));
+  }
+
+  /** range to a random anchor with a measurement close to the true distance */
+  libRSF::Data RandomRange(const libRSF::DataType Type, const int Dim, const libRSF::Vector &Position)
+  {
+    libRSF::Data Range(Type, 0.0);
+    const libRSF::Vector Anchor = RandomVector(Dim, 10.0);
+    Range.setMean(libRSF::Vector1::Constant((Position - Anchor).norm() + RandomVector(1, 1.0)(0)));
+    Range.setValue(libRSF::DataElement::SatPos, Anchor);
+    return Range;
+  }
+
+  /** ECEF scaled geometry, the Sagnac correction is only significant at this distance */
+  libRSF::Vector RandomReceiverECEF()
+  {
+    return RandomVector(3, 1.0).normalized() * 6.371e6 + RandomVector(3, 100.0);
+  }
+
+  /** the clock error of the measurement is far from the random clock states, so the residual is not dominated by rounding at ECEF scale */
+  libRSF::Data RandomPseudorange(const libRSF::Vector &Position, const int SatID)
+  {
+    libRSF::Data Pseudorange(libRSF::DataType::Pseudorange3, 0.0);
+    const libRSF::Vector Satellite = RandomVector(3, 1.0).normalized() * 2.66e7;
+    Pseudorange.setMean(libRSF::Vector1::Constant((Position - Satellite).norm() + 500.0 + RandomVector(1, 10.0)(0)));
+    Pseudorange.setValue(libRSF::DataElement::SatPos, Satellite);
+    Pseudorange.setValue(libRSF::DataElement::SatID, libRSF::Vector1::Constant(SatID));
+    return Pseudorange;
+  }
+}
+
+TEST(Factor, Jacobian_IMUPreintegration)
+{
+  using FactorType = libRSF::IMUPreintegrationFactor<libRSF::GaussianFull<15>>;
+  static_assert(libRSF::UseAnalyticJacobian<FactorType, libRSF::GaussianFull<15>>(), "The IMU factor should be analytic!");
+
+  for (int nTrial = 0; nTrial < 20; nTrial++)
+  {
+    /** arbitrary pre-integration */
+    libRSF::PreintegratedIMUResult Preintegration;
+    Preintegration.BiasAcc = RandomVector(3, 0.1);
+    Preintegration.BiasTR = RandomVector(3, 0.01);
+    Preintegration.Translation = RandomVector(3, 1.0);
+    Preintegration.Velocity = RandomVector(3, 1.0);
+    Preintegration.Rotation = libRSF::VectorToQuaternion<double>(RandomQuaternion());
+    Preintegration.JacTransBiasAcc = RandomMatrix(0.2);
+    Preintegration.JacTransBiasTR = RandomMatrix(0.2);
+    Preintegration.JacVelBiasAcc = RandomMatrix(0.2);
+    Preintegration.JacVelBiasTR = RandomMatrix(0.2);
+    Preintegration.JacRotBiasTRLocal = RandomMatrix(0.5);
+    Preintegration.DeltaTime = 0.1 + std::abs(RandomVector(1, 1.0)(0));
+    Preintegration.StartTime = 0.0;
+
+    const libRSF::MatrixStatic<15, 15> Root = libRSF::MatrixStatic<15, 15>(libRSF::Matrix::Random(15, 15));
+    libRSF::GaussianFull<15> Noise;
+    Noise.setCovarianceMatrix(Root * Root.transpose() + libRSF::MatrixStatic<15, 15>::Identity());
+
+    libRSF::AnalyticCostFunction<FactorType, libRSF::GaussianFull<15>, 3, 4, 9, 3, 4, 9> Analytic(new FactorType(Noise, Preintegration));
+    ceres::AutoDiffCostFunction<FactorType, 15, 3, 4, 9, 3, 4, 9> AutoDiff(new FactorType(Noise, Preintegration));
+
+    CompareJacobians(Analytic, AutoDiff,
+                     {RandomVector(3, 5.0), RandomQuaternion(), RandomVector(9, 0.1), RandomVector(3, 5.0), RandomQuaternion(), RandomVector(9, 0.1)},
+                     {false, true, false, false, true, false});
+  }
+}
+
+TEST(Factor, Jacobian_BetweenPose3)
+{
+  using FactorType = libRSF::BetweenPose3Factor<libRSF::GaussianDiagonal<6>>;
+  static_assert(libRSF::UseAnalyticJacobian<FactorType, libRSF::GaussianDiagonal<6>>(), "The pose factor should be analytic!");
+
+  for (int nTrial = 0; nTrial < 20; nTrial++)
+  {
+    libRSF::Data Measurement(libRSF::DataType::Pose3, 0.0);
+    libRSF::Vector7 Mean;
+    Mean << RandomVector(3, 1.0), RandomQuaternion();
+    Measurement.setMean(Mean);
+
+    libRSF::GaussianDiagonal<6> Noise;
+    Noise.setStdDevDiagonal(libRSF::VectorStatic<6>(RandomVector(6, 1.0).cwiseAbs()) + libRSF::VectorStatic<6>::Constant(0.1));
+
+    libRSF::AnalyticCostFunction<FactorType, libRSF::GaussianDiagonal<6>, 3, 4, 3, 4> Analytic(new FactorType(Noise, Measurement));
+    ceres::AutoDiffCostFunction<FactorType, 6, 3, 4, 3, 4> AutoDiff(new FactorType(Noise, Measurement));
+
+    CompareJacobians(Analytic, AutoDiff,
+                     {RandomVector(3, 5.0), RandomQuaternion(), RandomVector(3, 5.0), RandomQuaternion()},
+                     {false, true, false, true});
+  }
+}
+
+TEST(Factor, Jacobian_BetweenQuaternion)
+{
+  using FactorType = libRSF::BetweenQuaternionFactor<libRSF::GaussianDiagonal<3>>;
+  static_assert(libRSF::UseAnalyticJacobian<FactorType, libRSF::GaussianDiagonal<3>>(), "The rotation factor should be analytic!");
+
+  for (int nTrial = 0; nTrial < 20; nTrial++)
+  {
+    libRSF::Data Measurement(libRSF::DataType::Quaternion, 0.0);
+    Measurement.setMean(RandomQuaternion());
+
+    libRSF::GaussianDiagonal<3> Noise;
+    Noise.setStdDevSharedDiagonal(0.1);
+
+    libRSF::AnalyticCostFunction<FactorType, libRSF::GaussianDiagonal<3>, 4, 4> Analytic(new FactorType(Noise, Measurement));
+    ceres::AutoDiffCostFunction<FactorType, 3, 4, 4> AutoDiff(new FactorType(Noise, Measurement));
+
+    CompareJacobians(Analytic, AutoDiff, {RandomQuaternion(), RandomQuaternion()}, {true, true});
+  }
+}
+
+TEST(Factor, Jacobian_Range2)
+{
+  using FactorType = libRSF::RangeFactorBase<libRSF::GaussianDiagonal<1>, 2>;
+  static_assert(libRSF::UseAnalyticJacobian<FactorType, libRSF::GaussianDiagonal<1>>(), "The range factor should be analytic!");
+
+  for (int nTrial = 0; nTrial < 20; nTrial++)
+  {
+    const libRSF::Vector Position = RandomVector(2, 10.0);
+    const libRSF::Data Range = RandomRange(libRSF::DataType::Range2, 2, Position);
+    const libRSF::GaussianDiagonal<1> Noise = RandomNoise1D();
+
+    libRSF::AnalyticCostFunction<FactorType, libRSF::GaussianDiagonal<1>, 2> Analytic(new FactorType(Noise, Range));
+    ceres::AutoDiffCostFunction<FactorType, 1, 2> AutoDiff(new FactorType(Noise, Range));
+
+    CompareJacobians(Analytic, AutoDiff, {Position}, {false});
+  }
+}
+
+TEST(Factor, Jacobian_Range3)
+{
+  using FactorType = libRSF::RangeFactorBase<libRSF::GaussianDiagonal<1>, 3>;
+  static_assert(libRSF::UseAnalyticJacobian<FactorType, libRSF::GaussianDiagonal<1>>(), "The range factor should be analytic!");
+
+  for (int nTrial = 0; nTrial < 20; nTrial++)
+  {
+    const libRSF::Vector Position = RandomVector(3, 10.0);
+    const libRSF::Data Range = RandomRange(libRSF::DataType::Range3, 3, Position);
+    const libRSF::GaussianDiagonal<1> Noise = RandomNoise1D();
+
+    libRSF::AnalyticCostFunction<FactorType, libRSF::GaussianDiagonal<1>, 3> Analytic(new FactorType(Noise, Range));
+    ceres::AutoDiffCostFunction<FactorType, 1, 3> AutoDiff(new FactorType(Noise, Range));
+
+    CompareJacobians(Analytic, AutoDiff, {Position}, {false});
+  }
+}
+
+TEST(Factor, Jacobian_Range2_SC)
+{
+  using ErrorType = libRSF::SwitchableConstraints<1, libRSF::GaussianDiagonal<1>>;
+  using FactorType = libRSF::RangeFactorBase<ErrorType, 2>;
+  static_assert(libRSF::UseAnalyticJacobian<FactorType, ErrorType>(), "The SC range factor should be analytic!");
+
+  for (int nTrial = 0; nTrial < 20; nTrial++)
+  {
+    const libRSF::Vector Position = RandomVector(2, 10.0);
+    const libRSF::Data Range = RandomRange(libRSF::DataType::Range2, 2, Position);
+    const ErrorType SC(RandomNoise1D(), 0.5);
+
+    /** the switch is differentiated by the error model, the position by the factor */
+    libRSF::AnalyticCostFunction<FactorType, ErrorType, 2, 1> Analytic(new FactorType(SC, Range));
+    ceres::AutoDiffCostFunction<FactorType, 2, 2, 1> AutoDiff(new FactorType(SC, Range));
+
+    CompareJacobians(Analytic, AutoDiff, {Position, RandomSwitch()}, {false, false});
+  }
+}
+
+TEST(Factor, Jacobian_RangeToPoint3)
+{
+  using FactorType = libRSF::RangeToPointFactorBase<libRSF::GaussianDiagonal<1>, 3>;
+  static_assert(libRSF::UseAnalyticJacobian<FactorType, libRSF::GaussianDiagonal<1>>(), "The range factor should be analytic!");
+
+  for (int nTrial = 0; nTrial < 20; nTrial++)
+  {
+    const libRSF::Vector Position1 = RandomVector(3, 10.0);
+    const libRSF::Vector Position2 = RandomVector(3, 10.0);
+    libRSF::Data Range(libRSF::DataType::Range3, 0.0);
+    Range.setMean(libRSF::Vector1::Constant((Position1 - Position2).norm() + RandomVector(1, 1.0)(0)));
+    const libRSF::GaussianDiagonal<1> Noise = RandomNoise1D();
+
+    libRSF::AnalyticCostFunction<FactorType, libRSF::GaussianDiagonal<1>, 3, 3> Analytic(new FactorType(Noise, Range));
+    ceres::AutoDiffCostFunction<FactorType, 1, 3, 3> AutoDiff(new FactorType(Noise, Range));
+
+    CompareJacobians(Analytic, AutoDiff, {Position1, Position2}, {false, false});
+  }
+}
+
+TEST(Factor, Jacobian_Pseudorange3)
+{
+  using FactorType = libRSF::PseudorangeFactorBase<libRSF::GaussianDiagonal<1>, 3>;
+  static_assert(libRSF::UseAnalyticJacobian<FactorType, libRSF::GaussianDiagonal<1>>(), "The pseudorange factor should be analytic!");
+
+  const auto Satellites = std::make_shared<libRSF::SatelliteStore>();
+  for (int nTrial = 0; nTrial < 20; nTrial++)
+  {
+    const libRSF::Vector Position = RandomReceiverECEF();
+    const libRSF::Data Pseudorange = RandomPseudorange(Position, nTrial);
+    const libRSF::GaussianDiagonal<1> Noise = RandomNoise1D();
+
+    libRSF::AnalyticCostFunction<FactorType, libRSF::GaussianDiagonal<1>, 3, 1> Analytic(new FactorType(Noise, Pseudorange, Satellites));
+    ceres::AutoDiffCostFunction<FactorType, 1, 3, 1> AutoDiff(new FactorType(Noise, Pseudorange, Satellites));
+
+    CompareJacobians(Analytic, AutoDiff, {Position, RandomVector(1, 10.0)}, {false, false});
+  }
+}
+
+TEST(Factor, Jacobian_Pseudorange3_SC)
+{
+  using ErrorType = libRSF::SwitchableConstraints<1, libRSF::GaussianDiagonal<1>>;
+  using FactorType = libRSF::PseudorangeFactorBase<ErrorType, 3>;
+  static_assert(libRSF::UseAnalyticJacobian<FactorType, ErrorType>(), "The SC pseudorange factor should be analytic!");
+
+  const auto Satellites = std::make_shared<libRSF::SatelliteStore>();
+  for (int nTrial = 0; nTrial < 20; nTrial++)
+  {
+    const libRSF::Vector Position = RandomReceiverECEF();
+    const libRSF::Data Pseudorange = RandomPseudorange(Position, nTrial);
+    const ErrorType SC(RandomNoise1D(), 0.5);
+
+    libRSF::AnalyticCostFunction<FactorType, ErrorType, 3, 1, 1> Analytic(new FactorType(SC, Pseudorange, Satellites));
+    ceres::AutoDiffCostFunction<FactorType, 2, 3, 1, 1> AutoDiff(new FactorType(SC, Pseudorange, Satellites));
+
+    CompareJacobians(Analytic, AutoDiff, {Position, RandomVector(1, 10.0), RandomSwitch()}, {false, false, false});
+  }
+}
+
+TEST(Factor, Jacobian_Pseudorange3_Bias)
+{
+  using FactorType = libRSF::PseudorangeBiasFactorBase<libRSF::GaussianDiagonal<1>, 3>;
+  static_assert(libRSF::UseAnalyticJacobian<FactorType, libRSF::GaussianDiagonal<1>>(), "The pseudorange factor should be analytic!");
+
+  const auto Satellites = std::make_shared<libRSF::SatelliteStore>();
+
+  for (int nTrial = 0; nTrial < 20; nTrial++)
+  {
+    const libRSF::Vector Position = RandomReceiverECEF();
+    const libRSF::Data Pseudorange = RandomPseudorange(Position, nTrial);
+    const libRSF::GaussianDiagonal<1> Noise = RandomNoise1D();
+
+    libRSF::AnalyticCostFunction<FactorType, libRSF::GaussianDiagonal<1>, 3, 1, 1> Analytic(new FactorType(Noise, Pseudorange, Satellites));
+    ceres::AutoDiffCostFunction<FactorType, 1, 3, 1, 1> AutoDiff(new FactorType(Noise, Pseudorange, Satellites));
+
+    CompareJacobians(Analytic, AutoDiff, {Position, RandomVector(1, 10.0), RandomVector(1, 10.0)}, {false, false, false});
+  }
+}
+
+TEST(Factor, Jacobian_Pseudorange3_ECEF)
+{
+  using FactorType = libRSF::PseudorangeSagnacFactorBase<libRSF::GaussianDiagonal<1>, 3>;
+  static_assert(libRSF::UseAnalyticJacobian<FactorType, libRSF::GaussianDiagonal<1>>(), "The Sagnac pseudorange factor should be analytic!");
+
+  const auto Satellites = std::make_shared<libRSF::SatelliteStore>();
+  for (int nTrial = 0; nTrial < 20; nTrial++)
+  {
+    const libRSF::Vector Position = RandomReceiverECEF();
+    const libRSF::Data Pseudorange = RandomPseudorange(Position, nTrial);
+    const libRSF::GaussianDiagonal<1> Noise = RandomNoise1D();
+
+    libRSF::AnalyticCostFunction<FactorType, libRSF::GaussianDiagonal<1>, 3, 1> Analytic(new FactorType(Noise, Pseudorange, Satellites));
+    ceres::AutoDiffCostFunction<FactorType, 1, 3, 1> AutoDiff(new FactorType(Noise, Pseudorange, Satellites));
+
+    CompareJacobians(Analytic, AutoDiff, {Position, RandomVector(1, 10.0)}, {false, false});
+  }
+}
+
+TEST(Factor, Jacobian_Pseudorange3_ECEF_Clock)
+{
+  using FactorType = libRSF::PseudorangeSagnacFactorBase<libRSF::GaussianDiagonal<1>, 3, 2>;
+  static_assert(libRSF::UseAnalyticJacobian<FactorType, libRSF::GaussianDiagonal<1>>(), "The Sagnac pseudorange factor should be analytic!");
+
+  const auto Satellites = std::make_shared<libRSF::SatelliteStore>();
+  for (int nTrial = 0; nTrial < 20; nTrial++)
+  {
+    const libRSF::Vector Position = RandomReceiverECEF();
+    const libRSF::Data Pseudorange = RandomPseudorange(Position, nTrial);
+    const libRSF::GaussianDiagonal<1> Noise = RandomNoise1D();
+
+    /** the drift of the combined clock state does not enter the pseudorange */
+    libRSF::AnalyticCostFunction<FactorType, libRSF::GaussianDiagonal<1>, 3, 2> Analytic(new FactorType(Noise, Pseudorange, Satellites));
+    ceres::AutoDiffCostFunction<FactorType, 1, 3, 2> AutoDiff(new FactorType(Noise, Pseudorange, Satellites));
+
+    CompareJacobians(Analytic, AutoDiff, {Position, RandomVector(2, 10.0)}, {false, false});
+  }
+}
@@ -0,0 +1,534 @@
+/***************************************************************************
+ * libRSF - A Robust Sensor Fusion Library
+ *
+ * Copyright (C) 2018 Chair of Automation Technology / TU Chemnitz
+ * For more information see https://www.tu-chemnitz.de/etit/proaut/libRSF
+ *
+ * libRSF is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libRSF is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with libRSF.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Tim Pfeifer (tim.pfeifer@etit.tu-chemnitz.de)
+ ***************************************************************************/
+
+ /**
+ * @file Test_File_Access.cpp
+ * @author Tim Pfeifer
+ * @date 14.10.2026
+ * @brief Round trips, byte order and truncation of the dataset file formats and the text readers.
+ * @copyright GNU Public License.
+ *
+ */
+
+#include "TestUtils.h"
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+
+namespace
+{
+  constexpr int ObjectNumber = 5000;
+  constexpr double SampleTime = 0.1;
+
+  /** two types with different layouts, the second one at half the rate and with an offset in time */
+  libRSF::SensorDataSet CreateDataSet()
+  {
+    libRSF::SensorDataSet Set;
+    for (int n = 0; n < ObjectNumber; n++)
+    {
+      libRSF::Data Point2(libRSF::DataType::Point2, n * SampleTime);
+      Point2.setMean(libRSF::Vector2(n, -0.5 * n));
+      Point2.setCovarianceMatrix(libRSF::Matrix22(libRSF::Vector2(1.0 + n * 1e-3, 2.0).asDiagonal()));
+      Set.addElement(Point2);
+
+      if (n % 2 == 0)
+      {
+        libRSF::Data Point3(libRSF::DataType::Point3, n * SampleTime + 0.05);
+        Point3.setMean(libRSF::Vector3(n, 1.0 / (n + 1.0), -n));
+        Set.addElement(Point3);
+      }
+    }
+    return Set;
+  }
+
+  std::string TempFile(const std::string &Name)
+  {
+    return (std::filesystem::temp_directory_path() / ("libRSF_" + Name)).string();
+  }
+
+  int Count(const libRSF::SensorDataSet &Set, const libRSF::DataType Type)
+  {
+    return Set.checkID(Type) ? Set.countElements(Type) : 0;
+  }
+
+  /** compares the complete buffers, so every element of the layout survives the round trip */
+  void ExpectEqual(const libRSF::SensorDataSet &Expected, const libRSF::SensorDataSet &Actual, const libRSF::DataType Type)
+  {
+    const std::vector<libRSF::Data> ExpectedObjects = Expected.getElementsOfID(Type);
+    const std::vector<libRSF::Data> ActualObjects = Actual.getElementsOfID(Type);
+    ASSERT_EQ(ExpectedObjects.size(), ActualObjects.size());
+    for (size_t n = 0; n < ExpectedObjects.size(); n++)
+    {
+      EXPECT_EQ(ExpectedObjects.at(n).getBuffer(), ActualObjects.at(n).getBuffer());
+    }
+  }
+
+  void ExpectRoundTrip(const std::string &Filename)
+  {
+    const libRSF::SensorDataSet Original = CreateDataSet();
+    libRSF::SensorDataSet Read;
+    ASSERT_TRUE(libRSF::ReadDataFromBinaryFile(Filename, Read));
+    ExpectEqual(Original, Read, libRSF::DataType::Point2);
+    ExpectEqual(Original, Read, libRSF::DataType::Point3);
+  }
+
+  /** large ECEF-like values that lose precision in the text format */
+  libRSF::StateDataSet CreateResult()
+  {
+    libRSF::StateDataSet Result;
+    for (int n = 0; n < 100; n++)
+    {
+      libRSF::Data Position(libRSF::DataType::Point3, n * SampleTime);
+      Position.setMean(libRSF::Vector3(3.9e6 + n / 3.0, 9.1e5 - n / 7.0, 4.9e6 + 1.0 / (n + 3.0)));
+      Position.setCovarianceMatrix(libRSF::Matrix33::Identity() * (1.0 + n / 11.0));
+      Result.addElement("Position", Position);
+
+      libRSF::Data Clock(libRSF::DataType::ClockError, n * SampleTime);
+      Clock.setMean(libRSF::Vector1::Constant(std::exp(-n / 13.0)));
+      Result.addElement("Clock", Clock);
+    }
+    return Result;
+  }
+
+  void ExpectEqual(const libRSF::StateDataSet &Expected, const libRSF::StateDataSet &Actual, const std::string &Name)
+  {
+    const std::vector<libRSF::Data> ExpectedObjects = Expected.getElementsOfID(Name);
+    const std::vector<libRSF::Data> ActualObjects = Actual.getElementsOfID(Name);
+    ASSERT_EQ(ExpectedObjects.size(), ActualObjects.size());
+    for (size_t n = 0; n < ExpectedObjects.size(); n++)
+    {
+      EXPECT_EQ(ExpectedObjects.at(n).getType(), ActualObjects.at(n).getType());
+      EXPECT_EQ(ExpectedObjects.at(n).getBuffer(), ActualObjects.at(n).getBuffer());
+    }
+  }
+
+  /** timestamps are quantized to the resolution of the sink, the covariance to its precision */
+  void ExpectCompact(const libRSF::StateDataSet &Expected, const libRSF::StateDataSet &Actual, const std::string &Name, const double Tolerance)
+  {
+    const std::vector<libRSF::Data> ExpectedObjects = Expected.getElementsOfID(Name);
+    const std::vector<libRSF::Data> ActualObjects = Actual.getElementsOfID(Name);
+    ASSERT_EQ(ExpectedObjects.size(), ActualObjects.size());
+    for (size_t n = 0; n < ExpectedObjects.size(); n++)
+    {
+      const libRSF::Data &Object = ExpectedObjects.at(n);
+      EXPECT_EQ(Object.getType(), ActualObjects.at(n).getType());
+      EXPECT_NEAR(Object.getTimestamp(), ActualObjects.at(n).getTimestamp(), 1e-9);
+      EXPECT_EQ(Object.getMean(), ActualObjects.at(n).getMean());
+
+      const libRSF::Matrix Covariance = Object.getCovarianceMatrix();
+      EXPECT_LE((Covariance - ActualObjects.at(n).getCovarianceMatrix()).cwiseAbs().maxCoeff(), Tolerance * Covariance.cwiseAbs().maxCoeff());
+    }
+  }
+
+  std::string ReadFile(const std::string &Filename)
+  {
+    std::ifstream File(Filename, std::ios::binary);
+    return {std::istreambuf_iterator<char>(File), std::istreambuf_iterator<char>()};
+  }
+
+  void WriteFile(const std::string &Filename, const std::string &Content)
+  {
+    std::ofstream File(Filename, std::ios::binary | std::ios::trunc);
+    File.write(Content.data(), static_cast<std::streamsize>(Content.size()));
+  }
+}
+
+TEST(BinaryFile, Round_Trip)
+{
+  const std::string Filename = TempFile("round_trip.bin");
+  ASSERT_TRUE(libRSF::WriteDataToBinaryFile(Filename, CreateDataSet()));
+  ExpectRoundTrip(Filename);
+
+  /** the text interface detects the format by its header */
+  libRSF::SensorDataSet Read;
+  libRSF::ReadDataFromFile(Filename, Read);
+  ExpectEqual(CreateDataSet(), Read, libRSF::DataType::Point2);
+
+  std::filesystem::remove(Filename);
+}
+
+TEST(BinaryFile, Byte_Order)
+{
+  const std::string Filename = TempFile("byte_order.bin");
+  ASSERT_TRUE(libRSF::WriteDataToBinaryFile(Filename, CreateDataSet()));
+  std::string Content = ReadFile(Filename);
+
+  /** the header is the magic and the version in native byte order */
+  ASSERT_GT(Content.size(), 12U);
+  EXPECT_EQ(Content.substr(0, 4), "RSFB");
+  uint32_t Version = 0;
+  std::memcpy(&Version, Content.data() + 4, sizeof(Version));
+  EXPECT_EQ(Version, 1U);
+
+  /** a file of the other byte order fails at the version instead of being read as garbage */
+  std::reverse(Content.begin() + 4, Content.begin() + 8);
+  WriteFile(Filename, Content);
+  libRSF::SensorDataSet Read;
+  EXPECT_FALSE(libRSF::ReadDataFromBinaryFile(Filename, Read));
+  EXPECT_TRUE(Read.getKeysAll().empty());
+
+  std::filesystem::remove(Filename);
+}
+
+TEST(BinaryFile, Truncated)
+{
+  const std::string Filename = TempFile("truncated.bin");
+  ASSERT_TRUE(libRSF::WriteDataToBinaryFile(Filename, CreateDataSet()));
+  const std::string Content = ReadFile(Filename);
+
+  /** cut inside the header, the first type name, the first values and the last object */
+  const std::string Name = libRSF::GlobalDataConfig.getName(libRSF::DataType::Point2);
+  const size_t NamePosition = Content.find(Name);
+  ASSERT_NE(NamePosition, std::string::npos);
+  for (const size_t Size : {size_t(0), size_t(6), NamePosition + 1, NamePosition + Name.size() + 10, Content.size() / 2, Content.size() - 1})
+  {
+    WriteFile(Filename, Content.substr(0, Size));
+    libRSF::SensorDataSet Read;
+    EXPECT_FALSE(libRSF::ReadDataFromBinaryFile(Filename, Read)) << "Size: " << Size;
+  }
+
+  /** a name that is longer than the rest of the file */
+  std::string Corrupt = Content;
+  const uint32_t Huge = 0xFFFFFFF0U;
+  std::memcpy(&Corrupt.at(NamePosition - sizeof(uint32_t)), &Huge, sizeof(Huge));
+  WriteFile(Filename, Corrupt);
+  libRSF::SensorDataSet Read;
+  EXPECT_FALSE(libRSF::ReadDataFromBinaryFile(Filename, Read));
+
+  std::filesystem::remove(Filename);
+}
+
+TEST(ResultFile, Round_Trip)
+{
+  const std::string Filename = TempFile("result.bin");
+  const libRSF::StateDataSet Original = CreateResult();
+  ASSERT_TRUE(libRSF::WriteResultToBinaryFile(Filename, Original));
+
+  /** values are bit-exact */
+  libRSF::StateDataSet Read;
+  ASSERT_TRUE(libRSF::ReadResultFromBinaryFile(Filename, Read));
+  ExpectEqual(Original, Read, "Position");
+  ExpectEqual(Original, Read, "Clock");
+
+  /** blocks start aligned, so the values can be mapped */
+  const std::string Content = ReadFile(Filename);
+  EXPECT_EQ(Content.size() % 8, 0U);
+
+  /** only the selected states are written */
+  ASSERT_TRUE(libRSF::WriteResultToBinaryFile(Filename, Original, {"Clock", "Missing"}));
+  libRSF::StateDataSet Selected;
+  ASSERT_TRUE(libRSF::ReadResultFromBinaryFile(Filename, Selected));
+  EXPECT_FALSE(Selected.checkID("Position"));
+  ExpectEqual(Original, Selected, "Clock");
+
+  std::filesystem::remove(Filename);
+}
+
+TEST(ResultFile, Truncated)
+{
+  const std::string Filename = TempFile("result_truncated.bin");
+  ASSERT_TRUE(libRSF::WriteResultToBinaryFile(Filename, CreateResult()));
+  const std::string Content = ReadFile(Filename);
+
+  for (const size_t Size : {size_t(0), size_t(6), size_t(20), size_t(40), Content.size() / 2, Content.size() - 1})
+  {
+    WriteFile(Filename, Content.substr(0, Size));
+    libRSF::StateDataSet Read;
+    EXPECT_FALSE(libRSF::ReadResultFromBinaryFile(Filename, Read)) << "Size: " << Size;
+  }
+
+  /** a state name that is longer than the rest of the file, it follows the 16 byte header */
+  std::string Corrupt = Content;
+  const uint32_t Huge = 0xFFFFFFF0U;
+  std::memcpy(&Corrupt.at(16), &Huge, sizeof(Huge));
+  WriteFile(Filename, Corrupt);
+  libRSF::StateDataSet Read;
+  EXPECT_FALSE(libRSF::ReadResultFromBinaryFile(Filename, Read));
+
+  std::filesystem::remove(Filename);
+}
+
+TEST(BinarySource, Round_Trip)
+{
+  const std::string Filename = TempFile("source.bin");
+  const libRSF::SensorDataSet Original = CreateDataSet();
+  ASSERT_TRUE(libRSF::WriteDataToBinaryFile(Filename, Original));
+
+  libRSF::SensorDataBinarySource Source(Filename);
+  ASSERT_TRUE(Source.isValid());
+
+  double First = 0.0, Last = 0.0;
+  ASSERT_TRUE(Source.getTimeFirst(libRSF::DataType::Point3, First));
+  ASSERT_TRUE(Source.getTimeLast(libRSF::DataType::Point3, Last));
+  EXPECT_DOUBLE_EQ(First, 0.05);
+  EXPECT_DOUBLE_EQ(Last, (ObjectNumber - 2) * SampleTime + 0.05);
+
+  /** the first half, then the rest of the file */
+  libRSF::SensorDataSet Read;
+  Source.getMeasurementsUntil(ObjectNumber * SampleTime / 2.0, Read);
+  EXPECT_EQ(Count(Read, libRSF::DataType::Point2), ObjectNumber / 2 + 1);
+  Source.getMeasurementsUntil(ObjectNumber * SampleTime, Read);
+  ExpectEqual(Original, Read, libRSF::DataType::Point2);
+  ExpectEqual(Original, Read, libRSF::DataType::Point3);
+
+  std::filesystem::remove(Filename);
+}
+
+TEST(BinarySource, Truncated)
+{
+  const std::string Filename = TempFile("source_truncated.bin");
+  ASSERT_TRUE(libRSF::WriteDataToBinaryFile(Filename, CreateDataSet()));
+  const std::string Content = ReadFile(Filename);
+
+  const std::string Name = libRSF::GlobalDataConfig.getName(libRSF::DataType::Point2);
+  const size_t NamePosition = Content.find(Name);
+  ASSERT_NE(NamePosition, std::string::npos);
+  for (const size_t Size : {size_t(0), size_t(6), NamePosition + 1, NamePosition + Name.size() + 10, Content.size() / 2, Content.size() - 1})
+  {
+    WriteFile(Filename, Content.substr(0, Size));
+    libRSF::SensorDataBinarySource Source(Filename);
+    EXPECT_FALSE(Source.isValid()) << "Size: " << Size;
+  }
+
+  /** a name that is longer than the rest of the file */
+  std::string Corrupt = Content;
+  const uint32_t Huge = 0xFFFFFFF0U;
+  std::memcpy(&Corrupt.at(NamePosition - sizeof(uint32_t)), &Huge, sizeof(Huge));
+  WriteFile(Filename, Corrupt);
+  libRSF::SensorDataBinarySource HugeName(Filename);
+  EXPECT_FALSE(HugeName.isValid());
+
+  /** an object number whose size in bytes overflows, it follows the name and the number of values */
+  Corrupt = Content;
+  const uint64_t Overflow = (uint64_t(1) << 63) + 1;
+  std::memcpy(&Corrupt.at(NamePosition + Name.size() + sizeof(uint32_t)), &Overflow, sizeof(Overflow));
+  WriteFile(Filename, Corrupt);
+  libRSF::SensorDataBinarySource HugeNumber(Filename);
+  EXPECT_FALSE(HugeNumber.isValid());
+
+  std::filesystem::remove(Filename);
+}
+
+TEST(ArchiveSink, Round_Trip)
+{
+  const std::string Filename = TempFile("archive.bin");
+  const libRSF::StateDataSet Original = CreateResult();
+
+  /** a small buffer, so most records are already written */
+  libRSF::ArchiveResultSink Sink(Filename, 256);
+  ASSERT_TRUE(Sink.isOpen());
+  for (const std::string &Name : {std::string("Position"), std::string("Clock")})
+  {
+    for (const libRSF::Data &Element : Original.getElementsOfID(Name))
+    {
+      Sink.addElement(Name, Element);
+    }
+  }
+  EXPECT_EQ(Sink.countElements(), 200U);
+
+  libRSF::StateDataSet Read;
+  ASSERT_TRUE(Sink.load(0.0, 100 * SampleTime, Read));
+  ExpectEqual(Original, Read, "Position");
+  ExpectEqual(Original, Read, "Clock");
+
+  /** a second estimate replaces the first one */
+  libRSF::Data Replaced = Original.getElementsOfID("Clock").at(10);
+  Replaced.setMean(libRSF::Vector1::Constant(-1.0));
+  Sink.addElement("Clock", Replaced);
+  EXPECT_EQ(Sink.countElements(), 200U);
+
+  libRSF::StateDataSet Range;
+  ASSERT_TRUE(Sink.load("Clock", 9.5 * SampleTime, 10.5 * SampleTime, Range));
+  ASSERT_EQ(Range.countElements("Clock"), 1);
+  EXPECT_EQ(Range.getElement("Clock", 10 * SampleTime).getBuffer(), Replaced.getBuffer());
+
+  libRSF::StateDataSet Missing;
+  EXPECT_FALSE(Sink.load("Missing", 0.0, 100 * SampleTime, Missing));
+
+  std::filesystem::remove(Filename);
+}
+
+TEST(ArchiveSink, Truncated)
+{
+  const std::string Filename = TempFile("archive_truncated.bin");
+  const libRSF::StateDataSet Original = CreateResult();
+
+  libRSF::ArchiveResultSink Sink(Filename);
+  for (const libRSF::Data &Element : Original.getElementsOfID("Position"))
+  {
+    Sink.addElement("Position", Element);
+  }
+  Sink.flush();
+
+  /** records behind the end of the file can not be read */
+  std::filesystem::resize_file(Filename, Sink.getFileSize() / 2);
+  libRSF::StateDataSet Read;
+  EXPECT_FALSE(Sink.load("Position", 0.0, 100 * SampleTime, Read));
+
+  std::filesystem::remove(Filename);
+}
+
+TEST(CompactSink, Round_Trip)
+{
+  const libRSF::StateDataSet Original = CreateResult();
+
+  for (const auto &[Precision, Tolerance] : {std::make_pair(libRSF::CompactPrecision::Double, 0.0),
+                                             std::make_pair(libRSF::CompactPrecision::Float, 1e-7),
+                                             std::make_pair(libRSF::CompactPrecision::Half, 1e-3)})
+  {
+    libRSF::CompactResultSink Sink(Precision);
+    for (const std::string &Name : {std::string("Position"), std::string("Clock")})
+    {
+      for (const libRSF::Data &Element : Original.getElementsOfID(Name))
+      {
+        Sink.addElement(Name, Element);
+      }
+    }
+    EXPECT_EQ(Sink.countElements(), 200U);
+
+    libRSF::StateDataSet Read;
+    ASSERT_TRUE(Sink.load("Position", 0.0, 100 * SampleTime, Read));
+    ASSERT_TRUE(Sink.load("Clock", 0.0, 100 * SampleTime, Read));
+    ExpectCompact(Original, Read, "Position", Tolerance);
+    ExpectCompact(Original, Read, "Clock", Tolerance);
+
+    /** the export decodes the same estimates */
+    libRSF::StateDataSet Exported;
+    libRSF::MemoryResultSink Memory(Exported);
+    Sink.exportTo(Memory);
+    ExpectCompact(Original, Exported, "Position", Tolerance);
+    ExpectCompact(Original, Exported, "Clock", Tolerance);
+
+    /** a time range */
+    libRSF::StateDataSet Range;
+    ASSERT_TRUE(Sink.load("Position", 9.5 * SampleTime, 20.5 * SampleTime, Range));
+    EXPECT_EQ(Range.countElements("Position"), 11);
+
+    libRSF::StateDataSet Missing;
+    EXPECT_FALSE(Sink.load("Missing", 0.0, 100 * SampleTime, Missing));
+  }
+}
+
+TEST(CompactSink, Unordered)
+{
+  const std::vector<libRSF::Data> Positions = CreateResult().getElementsOfID("Position");
+
+  /** an estimate that is older than the newest one is kept as it is */
+  libRSF::CompactResultSink Sink(libRSF::CompactPrecision::Double);
+  Sink.addElement("Position", Positions.at(5));
+  Sink.addElement("Position", Positions.at(7));
+  Sink.addElement("Position", Positions.at(6));
+  EXPECT_EQ(Sink.countElements(), 3U);
+
+  libRSF::StateDataSet Read;
+  ASSERT_TRUE(Sink.load("Position", 0.0, 100 * SampleTime, Read));
+  ASSERT_EQ(Read.countElements("Position"), 3);
+  EXPECT_EQ(Read.getElementsOfID("Position").at(1).getBuffer(), Positions.at(6).getBuffer());
+}
+
+TEST(TextFile, Parallel)
+{
+  /** text files are not exact, so the sequential reader is the reference */
+  std::string Text;
+  int nLine = 0;
+  for (const libRSF::DataType Type : {libRSF::DataType::Point2, libRSF::DataType::Point3})
+  {
+    for (const libRSF::Data &Object : CreateDataSet().getElementsOfID(Type))
+    {
+      Text.append(Object.getName()).append(" ").append(Object.getValueString()).append("\n");
+      if (++nLine % 1000 == 0)
+      {
+        Text.append("point2 1.0 x\n");
+      }
+    }
+  }
+  const std::string Filename = TempFile("parallel.txt");
+  WriteFile(Filename, Text);
+
+  libRSF::SensorDataSet Sequential;
+  libRSF::ReadDataFromFile(Filename, Sequential);
+  EXPECT_EQ(Count(Sequential, libRSF::DataType::Point2), ObjectNumber);
+  EXPECT_EQ(Count(Sequential, libRSF::DataType::Point3), ObjectNumber / 2);
+  for (const int ThreadNumber : {1, 3, 8})
+  {
+    libRSF::SensorDataSet Parallel;
+    libRSF::ReadDataFromFileParallel(Filename, Parallel, ThreadNumber);
+    ExpectEqual(Sequential, Parallel, libRSF::DataType::Point2);
+    ExpectEqual(Sequential, Parallel, libRSF::DataType::Point3);
+  }
+  std::filesystem::remove(Filename);
+}
+
+TEST(TextFile, Malformed_Lines)
+{
+  /** a bad value or an unknown type does not end up in the dataset */
+  const std::string Filename = TempFile("malformed.txt");
+  WriteFile(Filename, "point1 1.0 1.0 1.0\n"
+                      "point1 2.0 x 1.0\n"
+                      "pointx 3.0 1.0 1.0\n"
+                      "point1 4.0\n"
+                      "point1 5.0 2.0 1.0\n");
+
+  for (const int ThreadNumber : {0, 1, 4})
+  {
+    libRSF::SensorDataSet Read;
+    if (ThreadNumber == 0)
+    {
+      libRSF::ReadDataFromFile(Filename, Read);
+    }
+    else
+    {
+      libRSF::ReadDataFromFileParallel(Filename, Read, ThreadNumber);
+    }
+
+    ASSERT_EQ(Count(Read, libRSF::DataType::Point1), 2);
+    const std::vector<libRSF::Data> Objects = Read.getElementsOfID(libRSF::DataType::Point1);
+    EXPECT_DOUBLE_EQ(Objects.at(0).getTimestamp(), 1.0);
+    EXPECT_DOUBLE_EQ(Objects.at(1).getTimestamp(), 5.0);
+    EXPECT_DOUBLE_EQ(Objects.at(1).getMean()(0), 2.0);
+  }
+  std::filesystem::remove(Filename);
+
+  /** the single object interface throws like std::stod before */
+  EXPECT_THROW(libRSF::Data("point1 2.0 x 1.0"), std::invalid_argument);
+  std::string Error;
+  const libRSF::Data Object("point1 2.0 x 1.0", Error);
+  EXPECT_FALSE(Error.empty());
+  EXPECT_TRUE(Object.getBuffer().empty());
+}
+
+TEST(TextFile, Parallel_Empty)
+{
+  /** an existing empty file is an empty dataset */
+  const std::string Filename = TempFile("empty.txt");
+  WriteFile(Filename, "");
+  ASSERT_TRUE(std::filesystem::exists(Filename));
+
+  libRSF::SensorDataSet Read;
+  libRSF::ReadDataFromFileParallel(Filename, Read, 4);
+  EXPECT_TRUE(Read.getKeysAll().empty());
+  std::filesystem::remove(Filename);
+}
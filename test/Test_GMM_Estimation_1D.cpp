@@ -93,4 +93,56 @@ TEST(Example, GMM_Estimation_1D)
   }
 }
 
+TEST(Example, GMM_Estimation_1D_SinglePrecision)
+{
+  /** create data */
+  const int N = 10000;
+
+  /** define component 1 */
+  const libRSF::Vector1 Mean1 = libRSF::Vector1::Zero();
+  const libRSF::Matrix11 Cov1 = libRSF::Matrix11::Identity() * 5*5;
+  const libRSF::Vector1 Weight1 = libRSF::Vector1::Ones() * 0.75;
+
+  /** define component 2 */
+  const libRSF::Vector1 Mean2 = libRSF::Vector1::Ones() * 100;
+  const libRSF::Matrix11 Cov2 = libRSF::Matrix11::Identity() * 50*50;
+  const libRSF::Vector1 Weight2= libRSF::Vector1::Ones() - Weight1;
+
+  /** sample from GMM */
+  const libRSF::Vector Data = GenerateSamplesGMM<1>(N,
+                                                    -Mean1,Cov1,Weight1,
+                                                    -Mean2,Cov2,Weight2);
+
+  /** the single precision E-step has to converge to the same mixture */
+  for (const libRSF::ErrorModelTuningType Type : {libRSF::ErrorModelTuningType::EM, libRSF::ErrorModelTuningType::EM_MAP})
+  {
+    libRSF::GaussianMixture<1>::EstimationConfig Config;
+    Config.RemoveSmallComponents = true;
+    Config.EstimationAlgorithm = Type;
+
+    libRSF::GaussianMixture<1> GMMDouble;
+    GMMDouble.initSpread(2, 10);
+    GMMDouble.estimate(Data, Config);
+
+    Config.SinglePrecisionEStep = true;
+    libRSF::GaussianMixture<1> GMMFloat;
+    GMMFloat.initSpread(2, 10);
+    GMMFloat.estimate(Data, Config);
+
+    /** extract components */
+    std::vector<libRSF::GaussianComponent<1>> MixtureDouble, MixtureFloat;
+    GMMDouble.getMixture(MixtureDouble);
+    GMMFloat.getMixture(MixtureFloat);
+    ASSERT_EQ(MixtureDouble.size(), MixtureFloat.size());
+
+    for (size_t n = 0; n < MixtureDouble.size(); n++)
+    {
+      const double Scale = std::sqrt(MixtureDouble.at(n).getCovariance().norm());
+      EXPECT_LT((MixtureDouble.at(n).getMean() - MixtureFloat.at(n).getMean()).norm(), 1e-3 * Scale);
+      EXPECT_LT((MixtureDouble.at(n).getCovariance() - MixtureFloat.at(n).getCovariance()).norm(), 1e-3 * Scale * Scale);
+      EXPECT_LT((MixtureDouble.at(n).getWeight() - MixtureFloat.at(n).getWeight()).norm(), 1e-4);
+    }
+  }
+}
+
 /** main provided by linking to gtest_main */
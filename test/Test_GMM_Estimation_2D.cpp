@@ -94,4 +94,57 @@ TEST(Example, GMM_Estimation_2D)
   }
 }
 
+TEST(Example, GMM_Estimation_2D_SinglePrecision)
+{
+  /** create data */
+  const int N = 10000;
+
+  /** define component 1 */
+  const libRSF::Vector2 Mean1 = libRSF::Vector2::Ones() * 0.0;
+  const libRSF::Matrix22 Cov1 = libRSF::Matrix22::Identity() * 1.0;
+  const libRSF::Vector1 Weight1 = libRSF::Vector1::Ones() * 0.6;
+
+  /** define component 2 */
+  const libRSF::Vector2 Mean2 = libRSF::Vector2::Ones() * 5.0;
+  libRSF::Matrix22 Cov2 = libRSF::Matrix22::Identity() * 9.0;
+  Cov2(1,1) = 16;
+  const libRSF::Vector1 Weight2 = libRSF::Vector1::Ones() - Weight1;
+
+  /** sample from GMM */
+  const libRSF::Matrix Data = GenerateSamplesGMM<2>(N,
+                                                    -Mean1,Cov1,Weight1,
+                                                    -Mean2,Cov2,Weight2);
+
+  /** the single precision E-step has to converge to the same mixture */
+  for (const libRSF::ErrorModelTuningType Type : {libRSF::ErrorModelTuningType::EM, libRSF::ErrorModelTuningType::EM_MAP})
+  {
+    libRSF::GaussianMixture<2>::EstimationConfig Config;
+    Config.RemoveSmallComponents = true;
+    Config.EstimationAlgorithm = Type;
+
+    libRSF::GaussianMixture<2> GMMDouble;
+    GMMDouble.initSpread(2, 10);
+    GMMDouble.estimate(Data, Config);
+
+    Config.SinglePrecisionEStep = true;
+    libRSF::GaussianMixture<2> GMMFloat;
+    GMMFloat.initSpread(2, 10);
+    GMMFloat.estimate(Data, Config);
+
+    /** extract components */
+    std::vector<libRSF::GaussianComponent<2>> MixtureDouble, MixtureFloat;
+    GMMDouble.getMixture(MixtureDouble);
+    GMMFloat.getMixture(MixtureFloat);
+    ASSERT_EQ(MixtureDouble.size(), MixtureFloat.size());
+
+    for (size_t n = 0; n < MixtureDouble.size(); n++)
+    {
+      const double Scale = std::sqrt(MixtureDouble.at(n).getCovariance().norm());
+      EXPECT_LT((MixtureDouble.at(n).getMean() - MixtureFloat.at(n).getMean()).norm(), 1e-3 * Scale);
+      EXPECT_LT((MixtureDouble.at(n).getCovariance() - MixtureFloat.at(n).getCovariance()).norm(), 1e-3 * Scale * Scale);
+      EXPECT_LT((MixtureDouble.at(n).getWeight() - MixtureFloat.at(n).getWeight()).norm(), 1e-4);
+    }
+  }
+}
+
 /** main provided by linking to gtest_main */
@@ -0,0 +1,510 @@
+/***************************************************************************
+ * libRSF - A Robust Sensor Fusion Library
+ *
+ * Copyright (C) 2018 Chair of Automation Technology / TU Chemnitz
+ * For more information see https://www.tu-chemnitz.de/etit/proaut/libRSF
+ *
+ * libRSF is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libRSF is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with libRSF.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Tim Pfeifer (tim.pfeifer@etit.tu-chemnitz.de)
+ ***************************************************************************/
+
+
+ /**
+ * @file Test_GMM_Numerics.cpp
+ * @author Tim Pfeifer
+ * @date 14.10.2026
+ * @brief Numerical properties of the GMM estimation that do not depend on the data set.
+ * @copyright GNU Public License.
+ *
+ */
+
+#include "../examples/Example_GMM_Estimation.h"
+#include "TestUtils.h"
+#include "gtest/gtest.h"
+
+#include <cmath>
+#include <vector>
+
+namespace
+{
+  /** two-pass reference of the maximum likelihood covariance */
+  libRSF::Matrix22 SampleCovariance(const libRSF::Matrix &Data)
+  {
+    const libRSF::Vector2 Mean = Data.rowwise().mean();
+    const libRSF::Matrix Centered = Data.colwise() - Mean;
+    return Centered * Centered.transpose() / static_cast<double>(Data.cols());
+  }
+
+  std::vector<libRSF::GaussianComponent<2>> EstimateGMM(const libRSF::Matrix &Data,
+                                                        const libRSF::ErrorModelTuningType Algorithm,
+                                                        const int ThreadNumber)
+  {
+    libRSF::GaussianMixture<2>::EstimationConfig Config;
+    Config.EstimationAlgorithm = Algorithm;
+    Config.ThreadNumber = ThreadNumber;
+
+    libRSF::GaussianMixture<2> GMM;
+    GMM.initSpread(2, 10);
+    GMM.estimate(Data, Config);
+
+    std::vector<libRSF::GaussianComponent<2>> Mixture;
+    GMM.getMixture(Mixture);
+    return Mixture;
+  }
+
+  /** textbook EM on means, covariances and weights, as reference for the square root information of the components */
+  struct PlainMixture
+  {
+    std::vector<libRSF::Vector2> Mean;
+    std::vector<libRSF::Matrix22> Covariance;
+    std::vector<double> Weight;
+  };
+
+  PlainMixture GetPlainMixture(libRSF::GaussianMixture<2> &GMM)
+  {
+    std::vector<libRSF::GaussianComponent<2>> Mixture;
+    GMM.getMixture(Mixture);
+
+    PlainMixture Plain;
+    for (const libRSF::GaussianComponent<2> &Component : Mixture)
+    {
+      Plain.Mean.emplace_back(Component.getMean());
+      Plain.Covariance.emplace_back(Component.getCovariance());
+      Plain.Weight.push_back(Component.getWeight()(0));
+    }
+    return Plain;
+  }
+
+  /** M x N weighted densities, the mean of a component is added to the error like in the library */
+  libRSF::Matrix PlainDensity(const PlainMixture &Mixture, const libRSF::Matrix &Data)
+  {
+    libRSF::Matrix Density(Mixture.Weight.size(), Data.cols());
+    for (size_t m = 0; m < Mixture.Weight.size(); ++m)
+    {
+      const Eigen::LLT<libRSF::Matrix22> LLT(Mixture.Covariance.at(m));
+      const libRSF::Matrix Whitened = LLT.matrixL().solve(libRSF::Matrix(Data.colwise() + Mixture.Mean.at(m)));
+      const double LogNorm = std::log(Mixture.Weight.at(m)) - std::log(2.0 * M_PI) - LLT.matrixL().toDenseMatrix().diagonal().array().log().sum();
+      Density.row(static_cast<libRSF::Index>(m)) = (LogNorm - 0.5 * Whitened.array().square().colwise().sum()).exp().matrix();
+    }
+    return Density;
+  }
+
+  double PlainLogLikelihood(const PlainMixture &Mixture, const libRSF::Matrix &Data)
+  {
+    return PlainDensity(Mixture, Data).colwise().sum().array().log().sum();
+  }
+
+  void PlainEMStep(PlainMixture &Mixture, const libRSF::Matrix &Data)
+  {
+    const libRSF::Matrix Density = PlainDensity(Mixture, Data);
+    const libRSF::Matrix Responsibility = (Density.array().rowwise() / Density.colwise().sum().array()).matrix();
+
+    for (size_t m = 0; m < Mixture.Weight.size(); ++m)
+    {
+      const libRSF::Vector Weights = Responsibility.row(static_cast<libRSF::Index>(m)).transpose();
+      const double Sum = Weights.sum();
+      const libRSF::Vector2 MeanX = Data * Weights / Sum;
+      const libRSF::Matrix Centered = Data.colwise() - MeanX;
+
+      Mixture.Mean.at(m) = -MeanX;
+      Mixture.Covariance.at(m) = Centered * Weights.asDiagonal() * Centered.transpose() / Sum;
+      Mixture.Weight.at(m) = Sum / static_cast<double>(Data.cols());
+    }
+  }
+
+  /** compare the packed kernel of small dimensions with the per-component likelihood */
+  template <int Dim>
+  double PackedKernelError()
+  {
+    std::default_random_engine Generator(42);
+    std::normal_distribution<double> Gaussian(0, 1);
+    auto Random = [&](){ return Gaussian(Generator); };
+
+    /** triangular square root information, so R and R^T give different results */
+    libRSF::GaussianMixture<Dim> GMM;
+    for (int m = 0; m < 3; ++m)
+    {
+      libRSF::MatrixStatic<Dim, Dim> SqrtInfo = libRSF::MatrixStatic<Dim, Dim>::NullaryExpr(Random).template triangularView<Eigen::Upper>();
+      SqrtInfo.diagonal() = SqrtInfo.diagonal().cwiseAbs().array() + 0.5;
+
+      libRSF::GaussianComponent<Dim> Component;
+      Component.setParamsSqrtInformation(SqrtInfo, libRSF::VectorStatic<Dim>::NullaryExpr(Random), libRSF::Vector1::Ones() / 3.0);
+      GMM.addComponent(Component);
+    }
+
+    const libRSF::MatrixStatic<Dim, libRSF::Dynamic> Data = libRSF::MatrixStatic<Dim, libRSF::Dynamic>::NullaryExpr(Dim, 1000, Random);
+
+    libRSF::Matrix Likelihood;
+    GMM.computeLikelihood(Data, Likelihood);
+
+    std::vector<libRSF::GaussianComponent<Dim>> Mixture;
+    GMM.getMixture(Mixture);
+
+    double MaxError = 0.0;
+    for (int m = 0; m < 3; ++m)
+    {
+      const libRSF::Vector Reference = Mixture.at(m).computeLikelihood(Data);
+      MaxError = std::max(MaxError, ((Likelihood.row(m).transpose() - Reference).array().abs() / Reference.array().max(1e-300)).maxCoeff());
+    }
+    return MaxError;
+  }
+}
+
+TEST(GMM, Large_Offset)
+{
+  /** unit covariance far away from the origin */
+  const libRSF::Vector2 Offset = libRSF::Vector2::Ones() * 1e8;
+  libRSF::Matrix22 Cov = libRSF::Matrix22::Identity();
+  Cov(0,1) = Cov(1,0) = 0.5;
+
+  const libRSF::Matrix Data = GenerateSamplesGMM<2>(10000,
+                                                    -Offset, Cov, libRSF::Vector1::Ones(),
+                                                    -Offset, Cov, libRSF::Vector1::Zero());
+
+  /** a single component that starts at the right place */
+  libRSF::GaussianComponent<2> Component;
+  Component.setParamsCovariance(libRSF::Matrix22::Identity(), Offset, libRSF::Vector1::Ones());
+
+  libRSF::GaussianMixture<2>::EstimationConfig Config;
+  Config.EstimationAlgorithm = libRSF::ErrorModelTuningType::EM;
+  Config.ThreadNumber = 0;
+
+  libRSF::GaussianMixture<2> GMM;
+  GMM.addComponent(Component);
+  GMM.estimate(Data, Config);
+
+  std::vector<libRSF::GaussianComponent<2>> Mixture;
+  GMM.getMixture(Mixture);
+  ASSERT_EQ(Mixture.size(), 1);
+
+  /** the covariance has to stay positive definite and match the centered reference */
+  const libRSF::Matrix22 Estimate = Mixture.at(0).getCovariance();
+  Eigen::SelfAdjointEigenSolver<libRSF::Matrix22> Solver(Estimate);
+  EXPECT_GT(Solver.eigenvalues().minCoeff(), 0.1);
+  EXPECT_LT((Estimate - SampleCovariance(Data)).cwiseAbs().maxCoeff(), 1e-6);
+  EXPECT_LT((Mixture.at(0).getMean() + Data.rowwise().mean()).cwiseAbs().maxCoeff(), 1e-6);
+}
+
+TEST(GMM, Thread_Number_Independent)
+{
+  /** enough samples for several chunks */
+  const libRSF::Vector2 Mean1 = libRSF::Vector2::Zero();
+  const libRSF::Matrix22 Cov1 = libRSF::Matrix22::Identity();
+  const libRSF::Vector2 Mean2 = libRSF::Vector2::Ones() * 5.0;
+  const libRSF::Matrix22 Cov2 = libRSF::Matrix22::Identity() * 9.0;
+
+  const libRSF::Matrix Data = GenerateSamplesGMM<2>(20000,
+                                                    -Mean1, Cov1, libRSF::Vector1::Ones() * 0.6,
+                                                    -Mean2, Cov2, libRSF::Vector1::Ones() * 0.4);
+
+  for (const libRSF::ErrorModelTuningType Algorithm : {libRSF::ErrorModelTuningType::EM,
+                                                       libRSF::ErrorModelTuningType::VBI,
+                                                       libRSF::ErrorModelTuningType::VBI_Full})
+  {
+    const std::vector<libRSF::GaussianComponent<2>> Reference = EstimateGMM(Data, Algorithm, 1);
+
+    for (const int ThreadNumber : {3, 0})
+    {
+      const std::vector<libRSF::GaussianComponent<2>> Mixture = EstimateGMM(Data, Algorithm, ThreadNumber);
+
+      /** the reduction order is fixed, so the results are bit-identical */
+      ASSERT_EQ(Mixture.size(), Reference.size());
+      for (size_t n = 0; n < Mixture.size(); ++n)
+      {
+        EXPECT_EQ(Mixture.at(n).getMean(), Reference.at(n).getMean());
+        EXPECT_EQ(Mixture.at(n).getCovariance(), Reference.at(n).getCovariance());
+        EXPECT_EQ(Mixture.at(n).getWeight(), Reference.at(n).getWeight());
+      }
+    }
+  }
+}
+
+TEST(GMM, Packed_Kernel)
+{
+  EXPECT_LT(PackedKernelError<1>(), 1e-12);
+  EXPECT_LT(PackedKernelError<2>(), 1e-12);
+  EXPECT_LT(PackedKernelError<3>(), 1e-12);
+}
+
+TEST(GMM, Cholesky_Inverse_Square_Root)
+{
+  libRSF::Matrix33 Factor;
+  Factor << 2.0, 0.3, -0.7,
+            0.5, 1.5, 0.2,
+            -0.4, 0.9, 3.0;
+  const libRSF::Matrix33 A = Factor * Factor.transpose() + libRSF::Matrix33::Identity();
+
+  /** triangular R with R^T * R = A^-1 and log|R| = -0.5 * log|A| */
+  libRSF::Matrix33 R;
+  double LogDeterminant = 0.0;
+  ASSERT_TRUE(libRSF::InverseSquareRootCholesky<3>(A, R, LogDeterminant));
+  EXPECT_TRUE(R.isLowerTriangular());
+  EXPECT_LT((R.transpose() * R - A.inverse()).cwiseAbs().maxCoeff(), 1e-12);
+  EXPECT_NEAR(LogDeterminant, -0.5 * std::log(A.determinant()), 1e-12);
+
+  /** indefinite and nearly singular matrices are left to the eigen decomposition */
+  libRSF::Matrix33 Indefinite = A;
+  Indefinite(0, 0) = -1.0;
+  EXPECT_FALSE(libRSF::InverseSquareRootCholesky<3>(Indefinite, R, LogDeterminant));
+
+  const libRSF::Vector3 Direction(1.0, 2.0, 3.0);
+  const libRSF::Matrix33 Singular = Direction * Direction.transpose() + libRSF::Matrix33::Identity() * 1e-12;
+  EXPECT_FALSE(libRSF::InverseSquareRootCholesky<3>(Singular, R, LogDeterminant));
+}
+
+TEST(GMM, EM_Reference)
+{
+  /** correlated components, so the square root information is not diagonal */
+  const libRSF::Vector2 Mean1 = libRSF::Vector2::Zero();
+  libRSF::Matrix22 Cov1 = libRSF::Matrix22::Identity();
+  Cov1(0,1) = Cov1(1,0) = 0.6;
+  const libRSF::Vector2 Mean2(4.0, -2.0);
+  libRSF::Matrix22 Cov2 = libRSF::Matrix22::Identity() * 9.0;
+  Cov2(0,1) = Cov2(1,0) = -4.0;
+
+  const libRSF::Matrix Data = GenerateSamplesGMM<2>(5000,
+                                                    -Mean1, Cov1, libRSF::Vector1::Ones() * 0.7,
+                                                    -Mean2, Cov2, libRSF::Vector1::Ones() * 0.3);
+
+  libRSF::GaussianMixture<2> GMM;
+  GMM.initSpread(2, 2.0);
+  PlainMixture Reference = GetPlainMixture(GMM);
+
+  /** one EM step per call */
+  libRSF::GaussianMixture<2>::EstimationConfig Config;
+  Config.EstimationAlgorithm = libRSF::ErrorModelTuningType::EM;
+  Config.MaxIterations = 1;
+
+  double LogLikelihoodOld = PlainLogLikelihood(Reference, Data);
+  for (int k = 0; k < 100; ++k)
+  {
+    GMM.estimate(Data, Config);
+    PlainEMStep(Reference, Data);
+
+    /** EM never decreases the likelihood */
+    const double LogLikelihood = PlainLogLikelihood(GetPlainMixture(GMM), Data);
+    EXPECT_GE(LogLikelihood, LogLikelihoodOld - 1e-9 * std::abs(LogLikelihoodOld)) << "Iteration: " << k;
+    LogLikelihoodOld = LogLikelihood;
+  }
+
+  const PlainMixture Estimate = GetPlainMixture(GMM);
+  ASSERT_EQ(Estimate.Weight.size(), Reference.Weight.size());
+  for (size_t m = 0; m < Estimate.Weight.size(); ++m)
+  {
+    EXPECT_LT((Estimate.Mean.at(m) - Reference.Mean.at(m)).cwiseAbs().maxCoeff(), 1e-6) << "Component: " << m;
+    EXPECT_LT((Estimate.Covariance.at(m) - Reference.Covariance.at(m)).cwiseAbs().maxCoeff(), 1e-6) << "Component: " << m;
+    EXPECT_NEAR(Estimate.Weight.at(m), Reference.Weight.at(m), 1e-8) << "Component: " << m;
+  }
+}
+
+TEST(GMM, Streamed_Source)
+{
+  /** more samples than one group of chunks, so the source is paged */
+  const libRSF::Vector2 Mean1 = libRSF::Vector2::Zero();
+  const libRSF::Matrix22 Cov1 = libRSF::Matrix22::Identity();
+  const libRSF::Vector2 Mean2 = libRSF::Vector2::Ones() * 5.0;
+  const libRSF::Matrix22 Cov2 = libRSF::Matrix22::Identity() * 9.0;
+
+  const libRSF::Matrix Data = GenerateSamplesGMM<2>(300000,
+                                                    -Mean1, Cov1, libRSF::Vector1::Ones() * 0.6,
+                                                    -Mean2, Cov2, libRSF::Vector1::Ones() * 0.4);
+  const libRSF::Index N = Data.cols();
+
+  for (const libRSF::ErrorModelTuningType Algorithm : {libRSF::ErrorModelTuningType::EM,
+                                                       libRSF::ErrorModelTuningType::VBI})
+  {
+    libRSF::GaussianMixture<2>::EstimationConfig Config;
+    Config.EstimationAlgorithm = Algorithm;
+    Config.ThreadNumber = 0;
+
+    libRSF::GaussianMixture<2> InMemory;
+    InMemory.initSpread(2, 10);
+    InMemory.estimate(Data, Config);
+
+    /** the source is called sequentially, every pass starts at the first sample */
+    libRSF::Index Next = 0;
+    int Violations = 0;
+    const libRSF::GaussianMixture<2>::SampleSource Source = [&](const libRSF::Index Start, const libRSF::Index Length, libRSF::GaussianMixture<2>::ErrorMatType &Samples)
+    {
+      if (Start != Next && Start != 0)
+      {
+        Violations++;
+      }
+      Next = Start + Length;
+      Samples = Data.middleCols(Start, Length);
+    };
+
+    libRSF::GaussianMixture<2> Streamed;
+    Streamed.initSpread(2, 10);
+    Streamed.estimate(Source, N, Config);
+    EXPECT_EQ(Violations, 0);
+
+    std::vector<libRSF::GaussianComponent<2>> Reference, Mixture;
+    InMemory.getMixture(Reference);
+    Streamed.getMixture(Mixture);
+    ASSERT_EQ(Mixture.size(), Reference.size());
+    for (size_t n = 0; n < Mixture.size(); ++n)
+    {
+      EXPECT_EQ(Mixture.at(n).getMean(), Reference.at(n).getMean());
+      EXPECT_EQ(Mixture.at(n).getCovariance(), Reference.at(n).getCovariance());
+      EXPECT_EQ(Mixture.at(n).getWeight(), Reference.at(n).getWeight());
+    }
+  }
+}
+
+TEST(GMM, Importance_Weights)
+{
+  const libRSF::Vector2 Mean1 = libRSF::Vector2::Zero();
+  const libRSF::Matrix22 Cov1 = libRSF::Matrix22::Identity();
+  const libRSF::Vector2 Mean2 = libRSF::Vector2::Ones() * 5.0;
+  const libRSF::Matrix22 Cov2 = libRSF::Matrix22::Identity() * 9.0;
+
+  const libRSF::GaussianMixture<2>::ErrorMatType Data = GenerateSamplesGMM<2>(5000,
+                                                                               -Mean1, Cov1, libRSF::Vector1::Ones() * 0.6,
+                                                                               -Mean2, Cov2, libRSF::Vector1::Ones() * 0.4);
+  const libRSF::Index N = Data.cols();
+
+  /** a weight of two counts like a duplicated sample */
+  libRSF::GaussianMixture<2>::ErrorMatType Duplicated(2, 2 * N);
+  Duplicated << Data, Data;
+
+  for (const libRSF::ErrorModelTuningType Algorithm : {libRSF::ErrorModelTuningType::EM,
+                                                       libRSF::ErrorModelTuningType::VBI})
+  {
+    libRSF::GaussianMixture<2>::EstimationConfig Config;
+    Config.EstimationAlgorithm = Algorithm;
+
+    libRSF::GaussianMixture<2> Reference;
+    Reference.initSpread(2, 10);
+    Reference.estimate(Duplicated, Config);
+
+    libRSF::GaussianMixture<2> Weighted;
+    Weighted.initSpread(2, 10);
+    Weighted.estimate(Data, libRSF::Vector::Constant(N, 2.0), Config);
+
+    std::vector<libRSF::GaussianComponent<2>> Expected, Mixture;
+    Reference.getMixture(Expected);
+    Weighted.getMixture(Mixture);
+    ASSERT_EQ(Mixture.size(), Expected.size());
+    for (size_t n = 0; n < Mixture.size(); ++n)
+    {
+      EXPECT_LT((Mixture.at(n).getMean() - Expected.at(n).getMean()).cwiseAbs().maxCoeff(), 1e-6);
+      EXPECT_LT((Mixture.at(n).getCovariance() - Expected.at(n).getCovariance()).cwiseAbs().maxCoeff(), 1e-6);
+      EXPECT_LT((Mixture.at(n).getWeight() - Expected.at(n).getWeight()).cwiseAbs().maxCoeff(), 1e-6);
+    }
+  }
+}
+
+TEST(GMM, Coreset)
+{
+  const libRSF::Vector2 Mean1 = libRSF::Vector2::Zero();
+  const libRSF::Matrix22 Cov1 = libRSF::Matrix22::Identity();
+  const libRSF::Vector2 Mean2 = libRSF::Vector2::Ones() * 8.0;
+  const libRSF::Matrix22 Cov2 = libRSF::Matrix22::Identity() * 9.0;
+
+  const libRSF::Matrix Data = GenerateSamplesGMM<2>(200000,
+                                                    -Mean1, Cov1, libRSF::Vector1::Ones() * 0.7,
+                                                    -Mean2, Cov2, libRSF::Vector1::Ones() * 0.3);
+
+  libRSF::GaussianMixture<2>::EstimationConfig Config;
+  Config.EstimationAlgorithm = libRSF::ErrorModelTuningType::EM;
+
+  libRSF::GaussianMixture<2> Full;
+  Full.initSpread(2, 10);
+  Full.estimate(Data, Config);
+
+  /** a coreset that is not smaller than the data is not used */
+  Config.CoresetSize = Data.cols();
+  libRSF::GaussianMixture<2> Unused;
+  Unused.initSpread(2, 10);
+  Unused.estimate(Data, Config);
+
+  Config.CoresetSize = 20000;
+  libRSF::GaussianMixture<2> Coreset;
+  Coreset.initSpread(2, 10);
+  Coreset.estimate(Data, Config);
+
+  std::vector<libRSF::GaussianComponent<2>> Reference, Same, Mixture;
+  Full.getMixture(Reference);
+  Unused.getMixture(Same);
+  Coreset.getMixture(Mixture);
+  ASSERT_EQ(Same.size(), Reference.size());
+  ASSERT_EQ(Mixture.size(), Reference.size());
+  for (size_t n = 0; n < Reference.size(); ++n)
+  {
+    EXPECT_EQ(Same.at(n).getMean(), Reference.at(n).getMean());
+    EXPECT_EQ(Same.at(n).getCovariance(), Reference.at(n).getCovariance());
+
+    /** the coreset is an unbiased estimate, so only the sampling noise of 20000 draws remains */
+    EXPECT_LT((Mixture.at(n).getMean() - Reference.at(n).getMean()).cwiseAbs().maxCoeff(), 0.15);
+    EXPECT_LT((Mixture.at(n).getCovariance() - Reference.at(n).getCovariance()).cwiseAbs().maxCoeff(),
+              0.1 * Reference.at(n).getCovariance().cwiseAbs().maxCoeff());
+    EXPECT_LT((Mixture.at(n).getWeight() - Reference.at(n).getWeight()).cwiseAbs().maxCoeff(), 0.02);
+  }
+}
+
+TEST(GMM, Accelerated_EM)
+{
+  /** overlapping components, where plain EM converges slowly */
+  const libRSF::Vector2 Mean1 = libRSF::Vector2::Zero();
+  libRSF::Matrix22 Cov1 = libRSF::Matrix22::Identity();
+  Cov1(0,1) = Cov1(1,0) = 0.6;
+  const libRSF::Vector2 Mean2(1.0, -1.0);
+  libRSF::Matrix22 Cov2 = libRSF::Matrix22::Identity() * 9.0;
+  Cov2(0,1) = Cov2(1,0) = -4.0;
+
+  const libRSF::Matrix Data = GenerateSamplesGMM<2>(5000,
+                                                    -Mean1, Cov1, libRSF::Vector1::Ones() * 0.7,
+                                                    -Mean2, Cov2, libRSF::Vector1::Ones() * 0.3);
+
+  libRSF::GaussianMixture<2> GMM;
+  GMM.initSpread(2, 2.0);
+
+  /** plain EM until the parameters do not change anymore */
+  PlainMixture Reference = GetPlainMixture(GMM);
+  for (int k = 0; k < 5000; ++k)
+  {
+    PlainEMStep(Reference, Data);
+  }
+
+  /** one SQUAREM cycle per call */
+  libRSF::GaussianMixture<2>::EstimationConfig Config;
+  Config.EstimationAlgorithm = libRSF::ErrorModelTuningType::EM;
+  Config.AccelerateEM = true;
+  Config.MaxIterations = 1;
+
+  double LogLikelihoodOld = PlainLogLikelihood(GetPlainMixture(GMM), Data);
+  for (int k = 0; k < 500; ++k)
+  {
+    GMM.estimate(Data, Config);
+
+    /** the safeguard keeps the likelihood monotone like plain EM */
+    const double LogLikelihood = PlainLogLikelihood(GetPlainMixture(GMM), Data);
+    EXPECT_GE(LogLikelihood, LogLikelihoodOld - 1e-9 * std::abs(LogLikelihoodOld)) << "Iteration: " << k;
+    LogLikelihoodOld = LogLikelihood;
+  }
+
+  /** the same fixed point as plain EM */
+  const PlainMixture Estimate = GetPlainMixture(GMM);
+  ASSERT_EQ(Estimate.Weight.size(), Reference.Weight.size());
+  for (size_t m = 0; m < Estimate.Weight.size(); ++m)
+  {
+    EXPECT_LT((Estimate.Mean.at(m) - Reference.Mean.at(m)).cwiseAbs().maxCoeff(), 1e-4) << "Component: " << m;
+    EXPECT_LT((Estimate.Covariance.at(m) - Reference.Covariance.at(m)).cwiseAbs().maxCoeff(), 1e-4) << "Component: " << m;
+    EXPECT_NEAR(Estimate.Weight.at(m), Reference.Weight.at(m), 1e-5) << "Component: " << m;
+  }
+}
+
+/** main provided by linking to gtest_main */
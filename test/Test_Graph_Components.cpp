@@ -0,0 +1,103 @@
+/***************************************************************************
+ * libRSF - A Robust Sensor Fusion Library
+ *
+ * Copyright (C) 2018 Chair of Automation Technology / TU Chemnitz
+ * For more information see https://www.tu-chemnitz.de/etit/proaut/libRSF
+ *
+ * libRSF is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libRSF is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with libRSF.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Tim Pfeifer (tim.pfeifer@etit.tu-chemnitz.de)
+ ***************************************************************************/
+
+ /**
+ * @file Test_Graph_Components.cpp
+ * @author Tim Pfeifer
+ * @date 14.10.2026
+ * @brief Solve the independent parts of a factor graph separately and compare with a regular solve.
+ * @copyright GNU Public License.
+ *
+ */
+
+#include "TestUtils.h"
+#include "gtest/gtest.h"
+
+namespace
+{
+  const std::vector<std::string> States = {"PositionA", "PositionB"};
+  const int StateNumber = 5;
+
+  ceres::Solver::Options SolverOptions()
+  {
+    ceres::Solver::Options Options;
+    Options.linear_solver_type = ceres::LinearSolverType::DENSE_QR;
+    Options.function_tolerance = 1e-12;
+    Options.gradient_tolerance = 1e-14;
+    Options.parameter_tolerance = 1e-12;
+    return Options;
+  }
+
+  /** two unconnected 1D chains, the first one with a bounded state */
+  void CreateGraph(libRSF::FactorGraph &Graph)
+  {
+    libRSF::GaussianDiagonal<1> Noise;
+    Noise.setStdDevSharedDiagonal(0.5);
+
+    for (const std::string &State : States)
+    {
+      for (int n = 0; n < StateNumber; n++)
+      {
+        Graph.addState(State, libRSF::DataType::Point1, n);
+
+        libRSF::Data Prior(libRSF::DataType::Point1, n);
+        Prior.setMean(libRSF::Vector1::Constant(n + 0.1 * (n % 2)));
+        Graph.addFactor<libRSF::FactorType::Prior1>(libRSF::StateID(State, n), Prior, Noise);
+
+        if (n > 0)
+        {
+          libRSF::Data Odometry(libRSF::DataType::Point1, n);
+          Odometry.setMean(libRSF::Vector1::Constant(1.05));
+          Graph.addFactor<libRSF::FactorType::BetweenValue1>(libRSF::StateID(State, n - 1), libRSF::StateID(State, n), Odometry, Noise);
+        }
+      }
+    }
+
+    /** the bound is active at the optimum */
+    Graph.setLowerBound(States.front(), 2, 0, libRSF::Vector1::Constant(2.5));
+  }
+}
+
+TEST(GraphComponents, Bounded_State)
+{
+  libRSF::FactorGraph Graph;
+  CreateGraph(Graph);
+  Graph.solve(SolverOptions());
+
+  libRSF::FactorGraph Components;
+  CreateGraph(Components);
+  EXPECT_EQ(Components.solveComponents(SolverOptions()), 2);
+
+  /** both solutions are the same, including the bounded state */
+  for (const std::string &State : States)
+  {
+    for (int n = 0; n < StateNumber; n++)
+    {
+      const libRSF::Vector Expected = Graph.getStateData().getElement(State, n).getMean();
+      EXPECT_LT((Components.getStateData().getElement(State, n).getMean() - Expected).norm(), 1e-8) << State << " " << n;
+    }
+  }
+  EXPECT_GE(Components.getStateData().getElement(States.front(), 2).getMean()(0), 2.5 - 1e-12);
+  EXPECT_NEAR(Components.getSolverSummary().final_cost, Graph.getSolverSummary().final_cost, 1e-10);
+}
+
+/** main provided by linking to gtest_main */
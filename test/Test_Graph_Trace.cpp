@@ -0,0 +1,242 @@
+/***************************************************************************
+ * libRSF - A Robust Sensor Fusion Library
+ *
+ * Copyright (C) 2018 Chair of Automation Technology / TU Chemnitz
+ * For more information see https://www.tu-chemnitz.de/etit/proaut/libRSF
+ *
+ * libRSF is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libRSF is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with libRSF.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Tim Pfeifer (tim.pfeifer@etit.tu-chemnitz.de)
+ ***************************************************************************/
+
+
+/**
+ * @file Test_Graph_Trace.cpp
+ * @author Tim Pfeifer
+ * @date 14.10.2026
+ * @brief Record graph operations into a binary trace and replay them.
+ * @copyright GNU Public License.
+ *
+ */
+
+#include "TestUtils.h"
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+namespace
+{
+  const std::string State = "Position";
+  const int StateNumber = 5;
+
+  std::string TempFile(const std::string &Name)
+  {
+    return (std::filesystem::temp_directory_path() / ("libRSF_" + Name)).string();
+  }
+
+  std::string ReadFile(const std::string &Filename)
+  {
+    std::ifstream File(Filename, std::ios::binary);
+    std::stringstream Stream;
+    Stream << File.rdbuf();
+    return Stream.str();
+  }
+
+  void WriteFile(const std::string &Filename, const std::string &Content)
+  {
+    std::ofstream File(Filename, std::ios::binary | std::ios::trunc);
+    File.write(Content.data(), static_cast<std::streamsize>(Content.size()));
+  }
+
+  ceres::Solver::Options SolverOptions()
+  {
+    ceres::Solver::Options Options;
+    Options.linear_solver_type = ceres::LinearSolverType::DENSE_QR;
+    Options.function_tolerance = 1e-12;
+    Options.gradient_tolerance = 1e-14;
+    Options.parameter_tolerance = 1e-12;
+    return Options;
+  }
+
+  /** 1D chain that is solved, moved and marginalized while it is traced */
+  void CreateGraph(libRSF::FactorGraph &Graph)
+  {
+    libRSF::GaussianDiagonal<1> Noise;
+    Noise.setStdDevSharedDiagonal(0.5);
+
+    for (int n = 0; n < StateNumber; n++)
+    {
+      Graph.addState(State, libRSF::DataType::Point1, n);
+
+      libRSF::Data Prior(libRSF::DataType::Point1, n);
+      Prior.setMean(libRSF::Vector1::Constant(n + 0.1 * (n % 2)));
+      Graph.addFactor<libRSF::FactorType::Prior1>(libRSF::StateID(State, n), Prior, Noise);
+
+      if (n > 0)
+      {
+        libRSF::Data Odometry(libRSF::DataType::Point1, n);
+        Odometry.setMean(libRSF::Vector1::Constant(1.05));
+        Graph.addFactor<libRSF::FactorType::BetweenValue1>(libRSF::StateID(State, n - 1), libRSF::StateID(State, n), Odometry, Noise);
+      }
+    }
+
+    Graph.solve(SolverOptions());
+    ASSERT_TRUE(Graph.marginalizeState(State, 0));
+
+    /** means that are set from outside have to be recorded as well */
+    Graph.getStateData().getElement(State, StateNumber - 1).setMean(libRSF::Vector1::Constant(10.0));
+    Graph.solve(SolverOptions());
+  }
+}
+
+TEST(Graph_Trace, Records)
+{
+  const std::string Filename = TempFile("trace_records.bin");
+
+  /** more than one block of records, so the writer flushes in between */
+  const int RecordNumber = 100000;
+  const libRSF::Matrix Payload = libRSF::Matrix::Random(3, 2);
+  {
+    libRSF::GraphTraceWriter Writer(Filename);
+    ASSERT_TRUE(Writer.isValid());
+    for (int n = 0; n < RecordNumber; n++)
+    {
+      libRSF::CheckpointWriter &Record = Writer.begin(static_cast<libRSF::TraceOperation>(n % static_cast<int>(libRSF::TraceOperation::Number)));
+      Record.write(static_cast<int32_t>(n));
+      Record.writeString(State);
+      Record.writeMatrix(Payload);
+      Writer.end(0.5 * n);
+    }
+  }
+
+  libRSF::CheckpointReader Reader;
+  ASSERT_TRUE(libRSF::OpenGraphTrace(Filename, Reader));
+  for (int n = 0; n < RecordNumber; n++)
+  {
+    uint8_t Code = 0;
+    int32_t Number = 0;
+    std::string Name;
+    libRSF::Matrix Matrix;
+    double Duration = 0.0;
+    ASSERT_TRUE(Reader.read(Code) && Reader.read(Number) && Reader.readString(Name) && Reader.readMatrix(Matrix) && Reader.read(Duration));
+    EXPECT_EQ(Code, n % static_cast<int>(libRSF::TraceOperation::Number));
+    EXPECT_EQ(Number, n);
+    EXPECT_EQ(Name, State);
+    EXPECT_EQ(Matrix, Payload);
+    EXPECT_EQ(Duration, 0.5 * n);
+  }
+  EXPECT_TRUE(Reader.isAtEnd());
+
+  std::filesystem::remove(Filename);
+}
+
+TEST(Graph_Trace, Header)
+{
+  const std::string Filename = TempFile("trace_header.bin");
+  {
+    libRSF::GraphTraceWriter Writer(Filename);
+    Writer.begin(libRSF::TraceOperation::SetWarmStart).write(static_cast<uint8_t>(1));
+    Writer.end(0.0);
+  }
+  const std::string Content = ReadFile(Filename);
+
+  /** magic number */
+  std::string Broken = Content;
+  Broken.at(0) = 'X';
+  WriteFile(Filename, Broken);
+  libRSF::CheckpointReader BadMagic;
+  EXPECT_FALSE(libRSF::OpenGraphTrace(Filename, BadMagic));
+
+  /** version follows the four bytes of the magic number */
+  Broken = Content;
+  Broken.at(4) = static_cast<char>(Broken.at(4) + 1);
+  WriteFile(Filename, Broken);
+  libRSF::CheckpointReader BadVersion;
+  EXPECT_FALSE(libRSF::OpenGraphTrace(Filename, BadVersion));
+
+  /** a header without records is a valid trace */
+  WriteFile(Filename, Content.substr(0, 8));
+  libRSF::CheckpointReader Empty;
+  ASSERT_TRUE(libRSF::OpenGraphTrace(Filename, Empty));
+  EXPECT_TRUE(Empty.isAtEnd());
+
+  std::filesystem::remove(Filename);
+}
+
+TEST(Graph_Trace, Replay)
+{
+  const std::string Filename = TempFile("trace_replay.bin");
+
+  libRSF::FactorGraph Graph;
+  ASSERT_TRUE(Graph.startTrace(Filename));
+  CreateGraph(Graph);
+  Graph.stopTrace();
+
+  libRSF::FactorGraph Replayed;
+  std::vector<libRSF::TraceTiming> Timings;
+  ASSERT_TRUE(Replayed.replayTrace(Filename, &Timings));
+
+  /** every operation is replayed in order, including both solves */
+  ASSERT_FALSE(Timings.empty());
+  EXPECT_EQ(Timings.front().Operation, libRSF::TraceOperation::AddState);
+  EXPECT_EQ(Timings.back().Operation, libRSF::TraceOperation::Solve);
+  EXPECT_EQ(std::count_if(Timings.begin(), Timings.end(), [](const libRSF::TraceTiming &Timing)
+                          { return Timing.Operation == libRSF::TraceOperation::Solve; }), 2);
+  for (const libRSF::TraceTiming &Timing : Timings)
+  {
+    EXPECT_GE(Timing.Recorded, 0.0);
+    EXPECT_GE(Timing.Replayed, 0.0);
+  }
+
+  EXPECT_EQ(Replayed.countFactorsOfType(libRSF::FactorType::Prior1), Graph.countFactorsOfType(libRSF::FactorType::Prior1));
+  EXPECT_EQ(Replayed.countFactorsOfType(libRSF::FactorType::BetweenValue1), Graph.countFactorsOfType(libRSF::FactorType::BetweenValue1));
+  EXPECT_EQ(Replayed.countFactorsOfType(libRSF::FactorType::Marginal), Graph.countFactorsOfType(libRSF::FactorType::Marginal));
+  ASSERT_EQ(Replayed.getStateData().countElements(State), Graph.getStateData().countElements(State));
+
+  /** the replayed graph ends at the same solution */
+  for (int n = 1; n < StateNumber; n++)
+  {
+    const libRSF::Vector Expected = Graph.getStateData().getElement(State, n).getMean();
+    EXPECT_LT((Replayed.getStateData().getElement(State, n).getMean() - Expected).norm(), 1e-8) << "State: " << n;
+  }
+
+  /** only empty graphs can replay a trace */
+  EXPECT_FALSE(Replayed.replayTrace(Filename));
+
+  std::filesystem::remove(Filename);
+}
+
+TEST(Graph_Trace, Truncated)
+{
+  const std::string Filename = TempFile("trace_truncated.bin");
+
+  libRSF::FactorGraph Graph;
+  ASSERT_TRUE(Graph.startTrace(Filename));
+  CreateGraph(Graph);
+  Graph.stopTrace();
+
+  /** the duration of the last record is incomplete */
+  const std::string Content = ReadFile(Filename);
+  WriteFile(Filename, Content.substr(0, Content.size() - 1));
+
+  libRSF::FactorGraph Replayed;
+  EXPECT_FALSE(Replayed.replayTrace(Filename));
+
+  std::filesystem::remove(Filename);
+}
+
+/** main provided by linking to gtest_main */
@@ -0,0 +1,448 @@
+/***************************************************************************
+ * libRSF - A Robust Sensor Fusion Library
+ *
+ * Copyright (C) 2018 Chair of Automation Technology / TU Chemnitz
+ * For more information see https://www.tu-chemnitz.de/etit/proaut/libRSF
+ *
+ * libRSF is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libRSF is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with libRSF.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Tim Pfeifer (tim.pfeifer@etit.tu-chemnitz.de)
+ ***************************************************************************/
+
+ /**
+ * @file Test_Marginalization.cpp
+ * @author Tim Pfeifer
+ * @date 14.10.2026
+ * @brief Sparse marginal covariance, Schur complement and marginal prior against dense references.
+ * @copyright GNU Public License.
+ *
+ */
+
+#include "TestUtils.h"
+#include "gtest/gtest.h"
+
+#include <memory>
+#include <random>
+
+namespace
+{
+  constexpr int StateNumber = 8;
+  constexpr int Dim = 2;
+  constexpr int Size = StateNumber * Dim;
+
+  /** r = sum_i A_i * x_i + c, with one block A_i per state */
+  class LinearCost : public ceres::CostFunction
+  {
+    public:
+      LinearCost(std::vector<libRSF::Matrix> Blocks, libRSF::Vector Offset) : Blocks_(std::move(Blocks)), Offset_(std::move(Offset))
+      {
+        this->set_num_residuals(static_cast<int>(Offset_.size()));
+        for (const libRSF::Matrix &Block : Blocks_)
+        {
+          this->mutable_parameter_block_sizes()->push_back(static_cast<int32_t>(Block.cols()));
+        }
+      }
+
+      bool Evaluate(double const* const* Parameters, double* Residuals, double** Jacobians) const override
+      {
+        libRSF::VectorRef<double, libRSF::Dynamic> Error(Residuals, Offset_.size());
+        Error = Offset_;
+        for (size_t n = 0; n < Blocks_.size(); n++)
+        {
+          Error += Blocks_.at(n) * libRSF::VectorRefConst<double, libRSF::Dynamic>(Parameters[n], Blocks_.at(n).cols());
+          if (Jacobians != nullptr && Jacobians[n] != nullptr)
+          {
+            libRSF::MatrixRef<double, libRSF::Dynamic, libRSF::Dynamic>(Jacobians[n], Blocks_.at(n).rows(), Blocks_.at(n).cols()) = Blocks_.at(n);
+          }
+        }
+        return true;
+      }
+
+    private:
+      std::vector<libRSF::Matrix> Blocks_;
+      libRSF::Vector Offset_;
+  };
+
+  /** a 2D chain with a prior on the first state, odometry between neighbors and one loop closure from the last to the first state */
+  class ChainWithLoop
+  {
+    public:
+      explicit ChainWithLoop(const unsigned int Seed) : Generator_(Seed), States_(StateNumber)
+      {
+        for (libRSF::Vector &State : States_)
+        {
+          State = randomVector_(Dim, 5.0);
+        }
+
+        this->addFactor_({0}, {randomInformation_()});
+        for (int n = 0; n < StateNumber - 1; n++)
+        {
+          const libRSF::Matrix Information = randomInformation_();
+          this->addFactor_({n, n + 1}, {-Information, Information});
+        }
+        const libRSF::Matrix Information = randomInformation_();
+        this->addFactor_({StateNumber - 1, 0}, {-Information, Information});
+      }
+
+      /** dense linear system of all states, ordered like the states */
+      [[nodiscard]] const libRSF::Matrix &getJacobian() const
+      {
+        return Jacobian_;
+      }
+
+      [[nodiscard]] const libRSF::Vector &getResidual() const
+      {
+        return Residual_;
+      }
+
+      [[nodiscard]] const libRSF::Vector &getState(const int n) const
+      {
+        return States_.at(n);
+      }
+
+      [[nodiscard]] double *getStatePointer(const int n)
+      {
+        return States_.at(n).data();
+      }
+
+      /** the problem owns its cost functions */
+      void fillProblem(ceres::Problem &Problem)
+      {
+        for (libRSF::Vector &State : States_)
+        {
+          Problem.AddParameterBlock(State.data(), Dim);
+        }
+        for (const Factor &Entry : Factors_)
+        {
+          std::vector<double*> Parameters;
+          for (const int n : Entry.States)
+          {
+            Parameters.push_back(States_.at(n).data());
+          }
+          Problem.AddResidualBlock(new LinearCost(Entry.Blocks, Entry.Offset), nullptr, Parameters);
+        }
+      }
+
+    private:
+      struct Factor
+      {
+        std::vector<int> States;
+        std::vector<libRSF::Matrix> Blocks;
+        libRSF::Vector Offset;
+      };
+
+      libRSF::Vector randomVector_(const int Length, const double Scale)
+      {
+        std::normal_distribution<double> Normal(0.0, Scale);
+        libRSF::Vector Random(Length);
+        for (int n = 0; n < Length; n++)
+        {
+          Random(n) = Normal(Generator_);
+        }
+        return Random;
+      }
+
+      /** well conditioned sqrt-information */
+      libRSF::Matrix randomInformation_()
+      {
+        libRSF::Matrix Information(Dim, Dim);
+        for (int n = 0; n < Dim; n++)
+        {
+          Information.col(n) = randomVector_(Dim, 0.3);
+        }
+        return Information + 2.0 * libRSF::Matrix::Identity(Dim, Dim);
+      }
+
+      /** the offset is chosen so the residual at the current states is small but not zero */
+      void addFactor_(const std::vector<int> &States, const std::vector<libRSF::Matrix> &Blocks)
+      {
+        Factor Entry{States, Blocks, randomVector_(Dim, 1.0)};
+        for (size_t n = 0; n < States.size(); n++)
+        {
+          Entry.Offset -= Blocks.at(n) * States_.at(States.at(n));
+        }
+
+        const libRSF::Index Row = Jacobian_.rows();
+        Jacobian_.conservativeResize(Row + Dim, Size);
+        Residual_.conservativeResize(Row + Dim);
+        Jacobian_.bottomRows(Dim).setZero();
+        for (size_t n = 0; n < States.size(); n++)
+        {
+          Jacobian_.block(Row, States.at(n) * Dim, Dim, Dim) = Blocks.at(n);
+        }
+        Residual_.tail(Dim) = Entry.Offset;
+        for (size_t n = 0; n < States.size(); n++)
+        {
+          Residual_.tail(Dim) += Blocks.at(n) * States_.at(States.at(n));
+        }
+
+        Factors_.push_back(std::move(Entry));
+      }
+
+      std::mt19937 Generator_;
+      std::vector<libRSF::Vector> States_;
+      std::vector<Factor> Factors_;
+      libRSF::Matrix Jacobian_ = libRSF::Matrix(0, Size);
+      libRSF::Vector Residual_ = libRSF::Vector(0);
+  };
+
+  /** reduced system of the remaining states: H^* = H_RR - H_RM * H_MM^-1 * H_MR and b^* = b_R - H_RM * H_MM^-1 * b_M */
+  void DenseSchurComplement(const libRSF::Matrix &Jacobian, const libRSF::Vector &Residual, const int SizeMarginal,
+                            libRSF::Matrix &HessianReduced, libRSF::Vector &BReduced)
+  {
+    const libRSF::Matrix Hessian = Jacobian.transpose() * Jacobian;
+    const libRSF::Vector B = -Jacobian.transpose() * Residual;
+    const int SizeRemain = static_cast<int>(Hessian.cols()) - SizeMarginal;
+
+    const libRSF::Matrix HessMMInv = Hessian.topLeftCorner(SizeMarginal, SizeMarginal).inverse();
+    const libRSF::Matrix HessRM = Hessian.bottomLeftCorner(SizeRemain, SizeMarginal);
+    HessianReduced = Hessian.bottomRightCorner(SizeRemain, SizeRemain) - HessRM * HessMMInv * HessRM.transpose();
+    BReduced = B.tail(SizeRemain) - HessRM * HessMMInv * B.head(SizeMarginal);
+  }
+
+  double MaxRelativeError(const libRSF::Matrix &Actual, const libRSF::Matrix &Expected)
+  {
+    return (Actual - Expected).cwiseAbs().maxCoeff() / (1.0 + Expected.cwiseAbs().maxCoeff());
+  }
+}
+
+TEST(Marginalization, Normal_Equations)
+{
+  ChainWithLoop Chain(7);
+  ceres::Problem Problem;
+  Chain.fillProblem(Problem);
+
+  /** the parameter blocks are evaluated in the order of the states */
+  ceres::Problem::EvaluateOptions Options;
+  for (int n = 0; n < StateNumber; n++)
+  {
+    Options.parameter_blocks.push_back(Chain.getStatePointer(n));
+  }
+  std::vector<double> Residual;
+  ceres::CRSMatrix Jacobian;
+  ASSERT_TRUE(Problem.Evaluate(Options, nullptr, &Residual, nullptr, &Jacobian));
+
+  libRSF::SparseMatrix Hessian;
+  libRSF::Vector B;
+  libRSF::ComputeNormalEquations(Jacobian, Residual, Hessian, B);
+
+  const libRSF::Matrix HessianDense = Chain.getJacobian().transpose() * Chain.getJacobian();
+  const libRSF::Vector BDense = -Chain.getJacobian().transpose() * Chain.getResidual();
+  EXPECT_LT(MaxRelativeError(libRSF::Matrix(Hessian), HessianDense), 1e-12);
+  EXPECT_LT(MaxRelativeError(B, BDense), 1e-12);
+}
+
+TEST(Marginalization, Covariance_Takahashi)
+{
+  for (unsigned int Seed = 0; Seed < 5; Seed++)
+  {
+    ChainWithLoop Chain(Seed);
+    ceres::Problem Problem;
+    Chain.fillProblem(Problem);
+
+    /** dense reference */
+    const libRSF::Matrix CovarianceDense = (Chain.getJacobian().transpose() * Chain.getJacobian()).inverse();
+
+    /** the last two states are ordered last, all others need a longer recursion */
+    const std::vector<const double*> LastStates = {Chain.getState(StateNumber - 2).data(), Chain.getState(StateNumber - 1).data()};
+    libRSF::MarginalCovariance Covariance;
+    ASSERT_TRUE(Covariance.compute(Problem, LastStates));
+    ASSERT_TRUE(Covariance.isValid());
+
+    for (int n = 0; n < StateNumber; n++)
+    {
+      EXPECT_TRUE(Covariance.hasState(Chain.getState(n).data()));
+
+      libRSF::Matrix22 Block;
+      ASSERT_TRUE(Covariance.getCovarianceBlock(Problem, Chain.getState(n).data(), Block.data()));
+      EXPECT_LT(MaxRelativeError(Block, CovarianceDense.block<Dim, Dim>(n * Dim, n * Dim)), 1e-10) << "State: " << n;
+    }
+
+    /** the joint covariance of the last states includes their cross-covariance */
+    libRSF::Matrix Joint;
+    ASSERT_TRUE(Covariance.getJointCovariance(LastStates, Joint));
+    EXPECT_LT(MaxRelativeError(Joint, CovarianceDense.bottomRightCorner(2 * Dim, 2 * Dim)), 1e-10);
+
+    /** ceres as second reference */
+    ceres::Covariance::Options Options;
+    ceres::Covariance CeresCovariance(Options);
+    std::vector<std::pair<const double*, const double*>> Blocks;
+    for (int n = 0; n < StateNumber; n++)
+    {
+      Blocks.emplace_back(Chain.getState(n).data(), Chain.getState(n).data());
+    }
+    ASSERT_TRUE(CeresCovariance.Compute(Blocks, &Problem));
+    for (int n = 0; n < StateNumber; n++)
+    {
+      libRSF::Matrix22 CeresBlock, Block;
+      ASSERT_TRUE(CeresCovariance.GetCovarianceBlock(Chain.getState(n).data(), Chain.getState(n).data(), CeresBlock.data()));
+      ASSERT_TRUE(Covariance.getCovarianceBlock(Problem, Chain.getState(n).data(), Block.data()));
+      EXPECT_LT(MaxRelativeError(Block, CeresBlock), 1e-8) << "State: " << n;
+    }
+  }
+}
+
+TEST(Marginalization, Schur_Complement_Sparse)
+{
+  for (unsigned int Seed = 0; Seed < 5; Seed++)
+  {
+    ChainWithLoop Chain(Seed);
+
+    /** the first state is connected to the second one and by the loop to the last one */
+    for (const int StatesMarginal : {1, 3})
+    {
+      const int SizeMarginal = StatesMarginal * Dim;
+      const int SizeRemain = Size - SizeMarginal;
+
+      libRSF::Matrix HessianReduced;
+      libRSF::Vector BReduced;
+      DenseSchurComplement(Chain.getJacobian(), Chain.getResidual(), SizeMarginal, HessianReduced, BReduced);
+
+      libRSF::Vector ResidualMarg;
+      libRSF::Matrix JacobianMarg;
+      libRSF::Marginalize(Chain.getResidual(), libRSF::SparseMatrix(Chain.getJacobian().sparseView()), ResidualMarg, JacobianMarg, SizeMarginal);
+
+      /** the compact prior has at most one row per remaining dimension and has to reproduce the reduced system */
+      ASSERT_EQ(JacobianMarg.cols(), SizeRemain);
+      ASSERT_LE(JacobianMarg.rows(), SizeRemain);
+      ASSERT_EQ(ResidualMarg.size(), JacobianMarg.rows());
+      EXPECT_LT(MaxRelativeError(JacobianMarg.transpose() * JacobianMarg, HessianReduced), 1e-10) << "Seed: " << Seed;
+      EXPECT_LT(MaxRelativeError(-JacobianMarg.transpose() * ResidualMarg, BReduced), 1e-10) << "Seed: " << Seed;
+
+      /** the dense version has to be equivalent */
+      libRSF::Vector ResidualDense;
+      libRSF::Matrix JacobianDense;
+      libRSF::Marginalize(Chain.getResidual(), Chain.getJacobian(), ResidualDense, JacobianDense, SizeMarginal);
+      EXPECT_LT(MaxRelativeError(JacobianDense.transpose() * JacobianDense, HessianReduced), 1e-8) << "Seed: " << Seed;
+      EXPECT_LT(MaxRelativeError(-JacobianDense.transpose() * ResidualDense, BReduced), 1e-8) << "Seed: " << Seed;
+    }
+  }
+}
+
+TEST(Marginalization, Schur_Complement_Independent)
+{
+  /** two independent chains, the second one without its first state */
+  ChainWithLoop First(1);
+  ChainWithLoop Second(2);
+  libRSF::Matrix Jacobian = libRSF::Matrix::Zero(First.getJacobian().rows() + Second.getJacobian().rows(), Size + Size - Dim);
+  libRSF::Vector Residual(Jacobian.rows());
+  Jacobian.topLeftCorner(First.getJacobian().rows(), Size) = First.getJacobian();
+  Jacobian.bottomRightCorner(Second.getJacobian().rows(), Size - Dim) = Second.getJacobian().rightCols(Size - Dim);
+  Residual << First.getResidual(), Second.getResidual();
+
+  /** marginalizing the first state of the first chain must not couple both chains */
+  libRSF::Vector ResidualMarg;
+  libRSF::Matrix JacobianMarg;
+  libRSF::Marginalize(Residual, libRSF::SparseMatrix(Jacobian.sparseView()), ResidualMarg, JacobianMarg, Dim);
+
+  libRSF::Matrix HessianReduced;
+  libRSF::Vector BReduced;
+  DenseSchurComplement(Jacobian, Residual, Dim, HessianReduced, BReduced);
+  EXPECT_LT(MaxRelativeError(JacobianMarg.transpose() * JacobianMarg, HessianReduced), 1e-10);
+  EXPECT_LT(MaxRelativeError(-JacobianMarg.transpose() * ResidualMarg, BReduced), 1e-10);
+
+  /** no row of the prior connects both chains */
+  const int SizeFirst = Size - Dim;
+  for (libRSF::Index nRow = 0; nRow < JacobianMarg.rows(); nRow++)
+  {
+    const bool IsFirst = JacobianMarg.row(nRow).head(SizeFirst).cwiseAbs().maxCoeff() > 1e-12;
+    const bool IsSecond = JacobianMarg.row(nRow).tail(JacobianMarg.cols() - SizeFirst).cwiseAbs().maxCoeff() > 1e-12;
+    EXPECT_FALSE(IsFirst && IsSecond) << "Row: " << nRow;
+  }
+
+  /** so the prior is split into one group per chain */
+  const std::vector<int> BlockSize(2 * StateNumber - 2, Dim);
+  const std::vector<std::vector<int>> Groups = libRSF::SplitMarginal(JacobianMarg, BlockSize);
+  ASSERT_EQ(Groups.size(), 2U);
+  EXPECT_EQ(Groups.at(0).size(), static_cast<size_t>(StateNumber - 1));
+  EXPECT_EQ(Groups.at(1).size(), static_cast<size_t>(StateNumber - 1));
+}
+
+TEST(Marginalization, Prior_Block_Sparse)
+{
+  ChainWithLoop Chain(3);
+  const int SizeMarginal = Dim;
+  const int RemainNumber = StateNumber - 1;
+
+  libRSF::Vector ResidualMarg;
+  libRSF::Matrix JacobianMarg;
+  libRSF::Marginalize(Chain.getResidual(), libRSF::SparseMatrix(Chain.getJacobian().sparseView()), ResidualMarg, JacobianMarg, SizeMarginal);
+
+  /** an additional state without information exercises the skipped blocks */
+  libRSF::Matrix JacobianPrior = libRSF::Matrix::Zero(JacobianMarg.rows(), JacobianMarg.cols() + Dim);
+  JacobianPrior.leftCols(JacobianMarg.cols()) = JacobianMarg;
+
+  std::vector<libRSF::Vector> LinearizationPoints;
+  for (int n = 1; n < StateNumber; n++)
+  {
+    LinearizationPoints.push_back(Chain.getState(n));
+  }
+  LinearizationPoints.push_back(libRSF::Vector::Zero(Dim));
+
+  const std::vector<int> BlockSize(RemainNumber + 1, Dim);
+  const std::vector<libRSF::DataType> Types(RemainNumber + 1, libRSF::DataType::Point2);
+  const libRSF::MarginalPrior Prior(BlockSize, BlockSize, LinearizationPoints, Types, JacobianPrior, ResidualMarg);
+  ASSERT_EQ(Prior.num_residuals(), JacobianMarg.rows());
+
+  std::mt19937 Generator(11);
+  std::normal_distribution<double> Normal(0.0, 1.0);
+  const libRSF::Matrix &J = Chain.getJacobian();
+  const libRSF::Vector &R = Chain.getResidual();
+  const libRSF::Matrix JM = J.leftCols(SizeMarginal);
+
+  for (int nTrial = 0; nTrial < 10; nTrial++)
+  {
+    std::vector<libRSF::Vector> States;
+    libRSF::Vector Delta(Size - SizeMarginal + Dim);
+    for (int n = 0; n <= RemainNumber; n++)
+    {
+      States.emplace_back(Dim);
+      for (int d = 0; d < Dim; d++)
+      {
+        States.back()(d) = LinearizationPoints.at(n)(d) + Normal(Generator);
+      }
+      Delta.segment(n * Dim, Dim) = States.back() - LinearizationPoints.at(n);
+    }
+
+    /** the matrices are row-major like the jacobians of ceres */
+    std::vector<const double*> Parameters;
+    std::vector<libRSF::Matrix> Jacobians(RemainNumber + 1, libRSF::Matrix(Prior.num_residuals(), Dim));
+    std::vector<double*> JacobianPointers;
+    for (int n = 0; n <= RemainNumber; n++)
+    {
+      Parameters.push_back(States.at(n).data());
+      JacobianPointers.push_back(Jacobians.at(n).data());
+    }
+
+    libRSF::Vector Error(Prior.num_residuals());
+    ASSERT_TRUE(Prior.Evaluate(Parameters.data(), Error.data(), JacobianPointers.data()));
+
+    /** linear prior: r = r^* + J^* * dx */
+    EXPECT_LT(MaxRelativeError(Error, ResidualMarg + JacobianPrior * Delta), 1e-12);
+    for (int n = 0; n <= RemainNumber; n++)
+    {
+      EXPECT_LT(MaxRelativeError(Jacobians.at(n), JacobianPrior.middleCols(n * Dim, Dim)), 1e-14) << "State: " << n;
+    }
+
+    /** the prior replaces the marginalized state: its cost equals the full cost, minimized over that state, up to a constant */
+    const libRSF::Vector DeltaRemain = Delta.head(Size - SizeMarginal);
+    const libRSF::Vector RFull = R + J.rightCols(Size - SizeMarginal) * DeltaRemain;
+    const libRSF::Vector DeltaMarginal = -(JM.transpose() * JM).ldlt().solve(JM.transpose() * RFull);
+    const double CostFull = (RFull + JM * DeltaMarginal).squaredNorm();
+
+    const libRSF::Vector RLinear = R - JM * (JM.transpose() * JM).ldlt().solve(JM.transpose() * R);
+    const double ConstantFull = RLinear.squaredNorm() - ResidualMarg.squaredNorm();
+    EXPECT_NEAR(Error.squaredNorm() + ConstantFull, CostFull, 1e-9 * (1.0 + CostFull));
+  }
+}
@@ -0,0 +1,160 @@
+/***************************************************************************
+ * libRSF - A Robust Sensor Fusion Library
+ *
+ * Copyright (C) 2018 Chair of Automation Technology / TU Chemnitz
+ * For more information see https://www.tu-chemnitz.de/etit/proaut/libRSF
+ *
+ * libRSF is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libRSF is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with libRSF.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Tim Pfeifer (tim.pfeifer@etit.tu-chemnitz.de)
+ ***************************************************************************/
+
+ /**
+ * @file Test_Parameter_Slab.cpp
+ * @author Tim Pfeifer
+ * @date 14.10.2026
+ * @brief Slot recycling of the parameter slab and the storage of states in it.
+ * @copyright GNU Public License.
+ *
+ */
+
+#include "TestUtils.h"
+#include "gtest/gtest.h"
+
+#include <utility>
+
+namespace
+{
+  const libRSF::ParameterSlab &GetSlab(const libRSF::DataType Type)
+  {
+    return *libRSF::GlobalDataConfig.getLayout(Type).Slab;
+  }
+
+  libRSF::Data CreateState(const double Timestamp)
+  {
+    libRSF::Data State(libRSF::DataType::Point3, Timestamp);
+    State.setMean(libRSF::Vector3(Timestamp, 2 * Timestamp, 3 * Timestamp));
+    State.placeInSlab();
+    return State;
+  }
+}
+
+TEST(ParameterSlab, Slots)
+{
+  libRSF::ParameterSlab Slab(3, 4);
+
+  /** new slots are consecutive inside a chunk */
+  std::vector<double *> Slots;
+  for (int n = 0; n < 6; n++)
+  {
+    Slots.push_back(Slab.allocate());
+  }
+  for (int n = 1; n < 4; n++)
+  {
+    EXPECT_EQ(Slots.at(n), Slots.at(n - 1) + 3);
+  }
+  EXPECT_EQ(Slots.at(5), Slots.at(4) + 3);
+  EXPECT_EQ(Slab.countChunks(), 2);
+  EXPECT_EQ(Slab.countUsedSlots(), 6);
+
+  /** released slots are reused last in, first out */
+  Slab.release(Slots.at(1));
+  Slab.release(Slots.at(3));
+  EXPECT_EQ(Slab.countUsedSlots(), 4);
+  EXPECT_EQ(Slab.allocate(), Slots.at(3));
+  EXPECT_EQ(Slab.allocate(), Slots.at(1));
+  EXPECT_EQ(Slab.countChunks(), 2);
+
+  for (double * Slot : Slots)
+  {
+    Slab.release(Slot);
+  }
+  EXPECT_EQ(Slab.countUsedSlots(), 0);
+}
+
+TEST(ParameterSlab, Data)
+{
+  const size_t UsedBefore = GetSlab(libRSF::DataType::Point3).countUsedSlots();
+  const auto SlotSize = static_cast<std::ptrdiff_t>(GetSlab(libRSF::DataType::Point3).getSlotSize());
+  {
+    libRSF::Data First = CreateState(1.0);
+    libRSF::Data Second = CreateState(2.0);
+    ASSERT_TRUE(First.isInSlab());
+    EXPECT_EQ(GetSlab(libRSF::DataType::Point3).countUsedSlots(), UsedBefore + 2);
+
+    /** states of one type lie next to each other */
+    double * const Mean = Second.getMeanPointer();
+    EXPECT_EQ(std::abs(Mean - First.getMeanPointer()), SlotSize);
+
+    /** moving keeps the parameter block */
+    libRSF::Data Moved = std::move(Second);
+    EXPECT_EQ(Moved.getMeanPointer(), Mean);
+    EXPECT_TRUE(Moved.isInSlab());
+
+    /** a copy is not a parameter block */
+    libRSF::Data Copy = Moved;
+    EXPECT_FALSE(Copy.isInSlab());
+    EXPECT_NE(Copy.getMeanPointer(), Mean);
+    EXPECT_EQ(Copy.getBuffer(), Moved.getBuffer());
+
+    /** an assignment writes into the existing slot */
+    Moved = First;
+    EXPECT_EQ(Moved.getMeanPointer(), Mean);
+    EXPECT_EQ(Moved.getMean(), First.getMean());
+
+    /** a smaller type reuses the slot */
+    Moved.reset(libRSF::DataType::Point2, 3.0);
+    EXPECT_TRUE(Moved.isInSlab());
+    EXPECT_EQ(Moved.getBuffer().size(), GetSlab(libRSF::DataType::Point2).getSlotSize());
+    EXPECT_EQ(GetSlab(libRSF::DataType::Point3).countUsedSlots(), UsedBefore + 2);
+  }
+  EXPECT_EQ(GetSlab(libRSF::DataType::Point3).countUsedSlots(), UsedBefore);
+
+  /** the slot of a removed state is recycled by the next one */
+  double * Released = nullptr;
+  {
+    libRSF::Data State = CreateState(4.0);
+    Released = State.getMeanPointer();
+  }
+  libRSF::Data Next = CreateState(5.0);
+  EXPECT_EQ(Next.getMeanPointer(), Released);
+}
+
+TEST(ParameterSlab, State_Data_Set)
+{
+  /** the parameter blocks survive the growth of the container */
+  libRSF::StateDataSet States;
+  std::vector<std::pair<double, double *>> Pointers;
+  for (int n = 0; n < 2000; n++)
+  {
+    const double Timestamp = n * 0.1;
+    States.addElement("Position", libRSF::DataType::Point3, Timestamp);
+    libRSF::Data &State = States.getElement("Position", Timestamp);
+    State.placeInSlab();
+    State.setMean(libRSF::Vector3(n, -n, 0.5 * n));
+    Pointers.emplace_back(Timestamp, State.getMeanPointer());
+  }
+
+  for (const auto &[Timestamp, Mean] : Pointers)
+  {
+    libRSF::Data &State = States.getElement("Position", Timestamp);
+    ASSERT_EQ(State.getMeanPointer(), Mean);
+    EXPECT_EQ(Mean[0], State.getMean()(0));
+  }
+
+  /** erasing releases the slots */
+  const size_t Used = GetSlab(libRSF::DataType::Point3).countUsedSlots();
+  States.removeElement("Position", Pointers.front().first);
+  EXPECT_EQ(GetSlab(libRSF::DataType::Point3).countUsedSlots(), Used - 1);
+}
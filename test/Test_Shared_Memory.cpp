@@ -0,0 +1,207 @@
+/***************************************************************************
+ * libRSF - A Robust Sensor Fusion Library
+ *
+ * Copyright (C) 2018 Chair of Automation Technology / TU Chemnitz
+ * For more information see https://www.tu-chemnitz.de/etit/proaut/libRSF
+ *
+ * libRSF is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libRSF is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with libRSF.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Tim Pfeifer (tim.pfeifer@etit.tu-chemnitz.de)
+ ***************************************************************************/
+
+ /**
+ * @file Test_Shared_Memory.cpp
+ * @author Tim Pfeifer
+ * @date 14.10.2026
+ * @brief Wrap-around of the shared memory ring and streaming through the shared memory source.
+ * @copyright GNU Public License.
+ *
+ */
+
+#include "TestUtils.h"
+#include "gtest/gtest.h"
+
+#include <thread>
+#include <unistd.h>
+
+namespace
+{
+  std::string RingName(const std::string &Test)
+  {
+    return "libRSF_Test_" + Test + "_" + std::to_string(getpid());
+  }
+
+  /** the content of each record is derived from its number */
+  libRSF::Data CreateRecord(const int Number)
+  {
+    libRSF::Data Object(libRSF::DataType::Point2, Number * 0.01);
+    Object.setMean(libRSF::Vector2(Number, -Number));
+    return Object;
+  }
+
+  bool IsRecord(const libRSF::Data &Object, const int Number)
+  {
+    const libRSF::Data Expected = CreateRecord(Number);
+    return Object.getType() == Expected.getType() && Object.getBuffer() == Expected.getBuffer();
+  }
+}
+
+TEST(SharedMemory, Ring_Wrap_Around)
+{
+  libRSF::SharedMemoryRing Producer;
+  if (!Producer.create(RingName("Wrap"), 5))
+  {
+    GTEST_SKIP() << "Shared memory is not available.";
+  }
+  libRSF::SharedMemoryRing Consumer;
+  ASSERT_TRUE(Consumer.open(RingName("Wrap")));
+
+  /** the capacity is rounded up to a power of two */
+  int Pushed = 0;
+  while (Producer.push(CreateRecord(Pushed)))
+  {
+    Pushed++;
+  }
+  EXPECT_EQ(Pushed, 8);
+
+  /** the released records are reused behind the end of the segment */
+  libRSF::Data Object;
+  int Popped = 0;
+  for (; Popped < 3; Popped++)
+  {
+    ASSERT_TRUE(Consumer.pop(Object));
+    EXPECT_TRUE(IsRecord(Object, Popped));
+  }
+  for (int n = 0; n < 3; n++)
+  {
+    ASSERT_TRUE(Producer.push(CreateRecord(Pushed++)));
+  }
+  EXPECT_FALSE(Producer.push(CreateRecord(Pushed)));
+
+  while (Consumer.pop(Object))
+  {
+    EXPECT_TRUE(IsRecord(Object, Popped));
+    Popped++;
+  }
+  EXPECT_EQ(Popped, Pushed);
+
+  EXPECT_FALSE(Consumer.isFinished());
+  Producer.close();
+  EXPECT_TRUE(Consumer.isFinished());
+}
+
+TEST(SharedMemory, Ring_Concurrent)
+{
+  constexpr int RecordNumber = 50000;
+
+  libRSF::SharedMemoryRing Producer;
+  if (!Producer.create(RingName("Concurrent"), 16))
+  {
+    GTEST_SKIP() << "Shared memory is not available.";
+  }
+  libRSF::SharedMemoryRing Consumer;
+  ASSERT_TRUE(Consumer.open(RingName("Concurrent")));
+
+  /** the ring wraps around many times while both sides run */
+  std::thread Thread([&Producer]()
+  {
+    for (int n = 0; n < RecordNumber; n++)
+    {
+      while (!Producer.push(CreateRecord(n)))
+      {
+        std::this_thread::yield();
+      }
+    }
+    Producer.close();
+  });
+
+  int Popped = 0;
+  int Wrong = 0;
+  libRSF::Data Object;
+  while (!Consumer.isFinished())
+  {
+    if (Consumer.pop(Object))
+    {
+      Wrong += IsRecord(Object, Popped) ? 0 : 1;
+      Popped++;
+    }
+    else
+    {
+      std::this_thread::yield();
+    }
+  }
+  Thread.join();
+
+  EXPECT_EQ(Popped, RecordNumber);
+  EXPECT_EQ(Wrong, 0);
+}
+
+TEST(SharedMemory, Ring_Open)
+{
+  libRSF::SharedMemoryRing Consumer;
+  EXPECT_FALSE(Consumer.open(RingName("Missing")));
+  EXPECT_FALSE(Consumer.isOpen());
+
+  libRSF::Data Object;
+  EXPECT_FALSE(Consumer.pop(Object));
+  EXPECT_TRUE(Consumer.isFinished());
+}
+
+TEST(SharedMemory, Source)
+{
+  constexpr int RecordNumber = 5000;
+
+  libRSF::SharedMemoryRing Producer;
+  if (!Producer.create(RingName("Source"), 64))
+  {
+    GTEST_SKIP() << "Shared memory is not available.";
+  }
+
+  std::thread Thread([&Producer]()
+  {
+    for (int n = 0; n < RecordNumber; n++)
+    {
+      while (!Producer.push(CreateRecord(n)))
+      {
+        std::this_thread::yield();
+      }
+    }
+    Producer.close();
+  });
+
+  libRSF::SensorDataSharedMemorySource Source(RingName("Source"));
+
+  double Timestamp = 0.0;
+  ASSERT_TRUE(Source.getTimeFirst(libRSF::DataType::Point2, Timestamp));
+  EXPECT_DOUBLE_EQ(Timestamp, 0.0);
+
+  /** the requested steps are independent of the chunks of the receiver */
+  libRSF::SensorDataSet Received;
+  for (double Time = 0.0; Time < RecordNumber * 0.01; Time += 0.37)
+  {
+    Source.getMeasurementsUntil(Time, Received);
+  }
+  Source.getMeasurementsUntil(RecordNumber * 0.01, Received);
+  Thread.join();
+
+  ASSERT_EQ(Received.countElements(libRSF::DataType::Point2), RecordNumber);
+  const std::vector<libRSF::Data> Objects = Received.getElementsOfID(libRSF::DataType::Point2);
+  for (int n = 0; n < RecordNumber; n++)
+  {
+    EXPECT_TRUE(IsRecord(Objects.at(n), n)) << "Record: " << n;
+  }
+
+  ASSERT_TRUE(Source.getTimeLast(libRSF::DataType::Point2, Timestamp));
+  EXPECT_NEAR(Timestamp, (RecordNumber - 1) * 0.01, 1e-9);
+}
@@ -0,0 +1,203 @@
+/***************************************************************************
+ * libRSF - A Robust Sensor Fusion Library
+ *
+ * Copyright (C) 2018 Chair of Automation Technology / TU Chemnitz
+ * For more information see https://www.tu-chemnitz.de/etit/proaut/libRSF
+ *
+ * libRSF is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libRSF is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with libRSF.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Tim Pfeifer (tim.pfeifer@etit.tu-chemnitz.de)
+ ***************************************************************************/
+
+ /**
+ * @file Test_State_Publisher.cpp
+ * @author Tim Pfeifer
+ * @date 14.10.2026
+ * @brief Consistency of the seqlock snapshots under concurrent publications.
+ * @copyright GNU Public License.
+ *
+ */
+
+#include "TestUtils.h"
+#include "gtest/gtest.h"
+
+#include <atomic>
+#include <thread>
+#include <unistd.h>
+
+namespace
+{
+  constexpr int Publications = 20000;
+  constexpr int Readers = 3;
+
+  /** many slots make a publication long enough to overlap with the copies of the readers */
+  constexpr int Slots = 32;
+
+  std::vector<libRSF::StateKey> CreateKeys(const int Number)
+  {
+    std::vector<libRSF::StateKey> Keys;
+    for (int n = 0; n < Number; n++)
+    {
+      Keys.emplace_back("State" + std::to_string(n));
+    }
+    return Keys;
+  }
+
+  /** all values of one publication are derived from its number, so a torn copy is detected */
+  void SetPublication(libRSF::StateDataSet &States, const int Number)
+  {
+    for (int n = 0; n < Slots; n++)
+    {
+      libRSF::Data &State = States.getElement("State" + std::to_string(n), 0.0);
+      State.setMean(libRSF::Vector3::Constant((n % 2 == 0) ? Number : -Number));
+      State.setCovarianceMatrix(libRSF::Matrix33::Constant(2.0 * Number));
+    }
+  }
+
+  void CreateStates(libRSF::StateDataSet &States)
+  {
+    for (int n = 0; n < Slots; n++)
+    {
+      States.addElement("State" + std::to_string(n), libRSF::Data(libRSF::DataType::Point3, 0.0));
+    }
+    SetPublication(States, 0);
+  }
+
+  /** false if the values of the snapshot belong to different publications */
+  bool IsConsistent(const libRSF::StateSnapshot &Snapshot)
+  {
+    if (Snapshot.Entries.size() != Slots || Snapshot.Entries.front().Mean.size() != 3)
+    {
+      return false;
+    }
+    const double Number = Snapshot.Entries.front().Mean(0);
+    for (int n = 0; n < Slots; n++)
+    {
+      const libRSF::StateSnapshot::Entry &Entry = Snapshot.Entries.at(n);
+      if (Entry.Mean.size() != 3 || !Entry.Mean.isApproxToConstant((n % 2 == 0) ? Number : -Number, 0.0) ||
+          Entry.Covariance.size() != 9 || !Entry.Covariance.isApproxToConstant(2.0 * Number, 0.0))
+      {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  /** read until the publisher is done, every successful copy has to be consistent and the versions must not go back */
+  template <typename ReaderType>
+  void ReadConcurrently(const ReaderType &Reader, const std::atomic<bool> &IsDone, int &Successes, int &Torn)
+  {
+    std::uint64_t LastVersion = 0;
+    libRSF::StateSnapshot Snapshot;
+    while (!IsDone.load())
+    {
+      /** nothing was published before the first version */
+      if (!Reader.read(Snapshot) || Snapshot.Version == 0)
+      {
+        continue;
+      }
+      Successes++;
+      if (!IsConsistent(Snapshot) || Snapshot.Version < LastVersion)
+      {
+        Torn++;
+      }
+      LastVersion = Snapshot.Version;
+    }
+  }
+
+  template <typename ReaderType>
+  void ExpectNoTornReads(libRSF::StatePublisher &Publisher, const ReaderType &Reader)
+  {
+    libRSF::StateDataSet States;
+    CreateStates(States);
+
+    std::atomic<bool> IsDone(false);
+    std::vector<int> Successes(Readers, 0);
+    std::vector<int> Torn(Readers, 0);
+    std::vector<std::thread> Threads;
+    for (int n = 0; n < Readers; n++)
+    {
+      Threads.emplace_back([&, n]()
+      {
+        ReadConcurrently(Reader, IsDone, Successes.at(n), Torn.at(n));
+      });
+    }
+
+    for (int Number = 1; Number <= Publications; Number++)
+    {
+      SetPublication(States, Number);
+      Publisher.publish(States);
+    }
+    IsDone = true;
+    for (std::thread &Thread : Threads)
+    {
+      Thread.join();
+    }
+
+    for (int n = 0; n < Readers; n++)
+    {
+      EXPECT_EQ(Torn.at(n), 0) << "Reader: " << n;
+    }
+
+    /** without a concurrent writer, the last publication is returned */
+    libRSF::StateSnapshot Snapshot;
+    ASSERT_TRUE(Reader.read(Snapshot));
+    EXPECT_TRUE(IsConsistent(Snapshot));
+    EXPECT_EQ(Snapshot.Version, static_cast<std::uint64_t>(Publications));
+    EXPECT_EQ(Snapshot.Entries.at(1).Name, "State1");
+    EXPECT_EQ(Snapshot.Entries.at(0).Mean(0), Publications);
+  }
+}
+
+TEST(StatePublisher, Unpublished)
+{
+  libRSF::StatePublisher Publisher(CreateKeys(Slots), 3);
+
+  /** states without a publication have no timestamp and no values */
+  libRSF::StateSnapshot Snapshot;
+  ASSERT_TRUE(Publisher.read(Snapshot));
+  EXPECT_EQ(Snapshot.Version, 0U);
+  ASSERT_EQ(Snapshot.Entries.size(), static_cast<size_t>(Slots));
+  EXPECT_TRUE(std::isnan(Snapshot.Entries.at(0).Timestamp));
+  EXPECT_EQ(Snapshot.Entries.at(0).Mean.size(), 0);
+
+  /** a state that exceeds the maximum dimension is not published */
+  libRSF::StateDataSet States;
+  CreateStates(States);
+  libRSF::StatePublisher Small(CreateKeys(1), 2);
+  Small.publish(States);
+  ASSERT_TRUE(Small.read(Snapshot));
+  EXPECT_EQ(Snapshot.Version, 1U);
+  EXPECT_TRUE(std::isnan(Snapshot.Entries.at(0).Timestamp));
+}
+
+TEST(StatePublisher, Torn_Read_In_Process)
+{
+  libRSF::StatePublisher Publisher(CreateKeys(Slots), 3);
+  ExpectNoTornReads(Publisher, Publisher);
+}
+
+TEST(StatePublisher, Torn_Read_Shared_Memory)
+{
+  const std::string Name = "libRSF_Test_Publisher_" + std::to_string(getpid());
+  libRSF::StatePublisher Publisher(CreateKeys(Slots), 3, Name);
+
+  libRSF::StateSubscriber Subscriber;
+  if (!Subscriber.open(Name))
+  {
+    GTEST_SKIP() << "Shared memory is not available.";
+  }
+  ASSERT_TRUE(Subscriber.isOpen());
+  ExpectNoTornReads(Publisher, Subscriber);
+}
@@ -0,0 +1,172 @@
+/***************************************************************************
+ * libRSF - A Robust Sensor Fusion Library
+ *
+ * Copyright (C) 2018 Chair of Automation Technology / TU Chemnitz
+ * For more information see https://www.tu-chemnitz.de/etit/proaut/libRSF
+ *
+ * libRSF is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libRSF is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with libRSF.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Tim Pfeifer (tim.pfeifer@etit.tu-chemnitz.de)
+ ***************************************************************************/
+
+ /**
+ * @file Test_Thread_Pool.cpp
+ * @author Tim Pfeifer
+ * @date 14.10.2026
+ * @brief Chunk distribution, thread limits and nested calls of the thread pool.
+ * @copyright GNU Public License.
+ *
+ */
+
+#include "TestUtils.h"
+#include "gtest/gtest.h"
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+
+namespace
+{
+  constexpr int PoolThreads = 4;
+
+  /** every chunk has to be called exactly once */
+  void ExpectCalledOnce(const std::vector<std::atomic<int>> &Calls)
+  {
+    for (size_t n = 0; n < Calls.size(); n++)
+    {
+      EXPECT_EQ(Calls.at(n).load(), 1) << "Chunk: " << n;
+    }
+  }
+}
+
+TEST(ThreadPool, Parallel_For)
+{
+  libRSF::ThreadPoolConfig Config;
+  Config.ThreadNumber = PoolThreads;
+  libRSF::ThreadPool Pool(Config);
+  EXPECT_EQ(Pool.getThreadNumber(), PoolThreads);
+
+  for (const size_t ChunkNumber : {0, 1, 3, 10000})
+  {
+    std::vector<std::atomic<int>> Calls(ChunkNumber);
+    Pool.parallelFor(ChunkNumber, [&Calls](const size_t Chunk)
+    {
+      Calls.at(Chunk)++;
+    });
+    ExpectCalledOnce(Calls);
+  }
+}
+
+TEST(ThreadPool, Nested_Parallel_For)
+{
+  libRSF::ThreadPoolConfig Config;
+  Config.ThreadNumber = PoolThreads;
+  libRSF::ThreadPool Pool(Config);
+
+  /** more outer chunks than threads, so every worker blocks in an inner call while others are still queued */
+  constexpr size_t Outer = 4 * PoolThreads;
+  constexpr size_t Middle = 8;
+  constexpr size_t Inner = 16;
+  std::vector<std::atomic<int>> Calls(Outer * Middle * Inner);
+
+  for (int nRepetition = 0; nRepetition < 20; nRepetition++)
+  {
+    for (std::atomic<int> &Call : Calls)
+    {
+      Call = 0;
+    }
+
+    Pool.parallelFor(Outer, [&](const size_t nOuter)
+    {
+      Pool.parallelFor(Middle, [&](const size_t nMiddle)
+      {
+        Pool.parallelFor(Inner, [&](const size_t nInner)
+        {
+          Calls.at((nOuter * Middle + nMiddle) * Inner + nInner)++;
+        });
+      });
+    });
+
+    ExpectCalledOnce(Calls);
+  }
+}
+
+TEST(ThreadPool, Max_Threads)
+{
+  libRSF::ThreadPoolConfig Config;
+  Config.ThreadNumber = PoolThreads;
+  libRSF::ThreadPool Pool(Config);
+
+  /** the chunks take long enough that all allowed threads join */
+  std::mutex Mutex;
+  std::set<std::thread::id> Threads;
+  std::atomic<int> Running(0);
+  std::atomic<int> MaxRunning(0);
+  Pool.parallelFor(64, [&](const size_t /*Chunk*/)
+  {
+    const int Now = ++Running;
+    int Max = MaxRunning.load();
+    while (Now > Max && !MaxRunning.compare_exchange_weak(Max, Now)) {}
+
+    std::this_thread::sleep_for(std::chrono::microseconds(200));
+    {
+      const std::lock_guard<std::mutex> Lock(Mutex);
+      Threads.insert(std::this_thread::get_id());
+    }
+    Running--;
+  }, 2);
+
+  EXPECT_LE(Threads.size(), 2U);
+  EXPECT_LE(MaxRunning.load(), 2);
+}
+
+TEST(ThreadPool, Parallel_Run)
+{
+  libRSF::ThreadPoolConfig Config;
+  Config.ThreadNumber = PoolThreads;
+  libRSF::ThreadPool Pool(Config);
+
+  /** each slot is called once, even if there are more slots than threads */
+  for (const int Slots : {1, PoolThreads, 3 * PoolThreads})
+  {
+    std::vector<std::atomic<int>> Calls(Slots);
+    Pool.parallelRun(Slots, [&Calls](const size_t Slot)
+    {
+      Calls.at(Slot)++;
+    });
+    ExpectCalledOnce(Calls);
+  }
+}
+
+TEST(ThreadPool, Run_Concurrently)
+{
+  std::vector<std::atomic<int>> Calls(10);
+  std::vector<std::function<void()>> Tasks;
+  for (size_t n = 0; n < Calls.size(); n++)
+  {
+    Tasks.emplace_back([&Calls, n]()
+    {
+      /** tasks may use the process-wide pool themselves */
+      libRSF::GetThreadPool().parallelFor(4, [](const size_t /*Chunk*/) {});
+      Calls.at(n)++;
+    });
+  }
+  libRSF::RunConcurrently(Tasks);
+  ExpectCalledOnce(Calls);
+}
+
+/** main provided by linking to gtest_main */
@@ -0,0 +1,232 @@
+/***************************************************************************
+ * libRSF - A Robust Sensor Fusion Library
+ *
+ * Copyright (C) 2018 Chair of Automation Technology / TU Chemnitz
+ * For more information see https://www.tu-chemnitz.de/etit/proaut/libRSF
+ *
+ * libRSF is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libRSF is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with libRSF.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Author: Tim Pfeifer (tim.pfeifer@etit.tu-chemnitz.de)
+ ***************************************************************************/
+
+ /**
+ * @file Test_Unweighted_Errors.cpp
+ * @author Tim Pfeifer
+ * @date 14.10.2026
+ * @brief Raw error extraction with the residual cache, concurrently and during a solve.
+ * @copyright GNU Public License.
+ *
+ */
+
+#include "TestUtils.h"
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <random>
+#include <thread>
+
+#define STATE "X"
+
+namespace
+{
+  constexpr int StateNumber = 2000;
+
+  /** a chain of 1D values with one prior and one between factor per state */
+  void BuildChain(libRSF::FactorGraph &Graph, std::mt19937 &Generator)
+  {
+    std::normal_distribution<double> Normal(0.0, 1.0);
+
+    libRSF::GaussianDiagonal<1> Noise;
+    Noise.setStdDevSharedDiagonal(1.0);
+
+    for (int n = 0; n < StateNumber; n++)
+    {
+      Graph.addState(STATE, libRSF::DataType::Point1, n);
+      Graph.getStateData().getElement(STATE, n).setMean(libRSF::Vector1::Constant(Normal(Generator)));
+
+      libRSF::Data Prior(libRSF::DataType::Point1, n);
+      Prior.setMean(libRSF::Vector1::Constant(Normal(Generator)));
+      Graph.addFactor<libRSF::FactorType::Prior1>(libRSF::StateID(STATE, n), Prior, Noise, false);
+
+      if (n > 0)
+      {
+        libRSF::Data Between(libRSF::DataType::Point1, n);
+        Between.setMean(libRSF::Vector1::Constant(Normal(Generator)));
+        Graph.addFactor<libRSF::FactorType::BetweenValue1>(libRSF::StateID(STATE, n - 1), libRSF::StateID(STATE, n), Between, Noise, false);
+      }
+    }
+  }
+
+  /** the columns are compared without relying on their order */
+  std::vector<double> SortedErrors(const libRSF::Matrix &Errors)
+  {
+    std::vector<double> Sorted(Errors.data(), Errors.data() + Errors.size());
+    std::sort(Sorted.begin(), Sorted.end());
+    return Sorted;
+  }
+
+  void ExpectSameErrors(const libRSF::Matrix &A, const libRSF::Matrix &B)
+  {
+    ASSERT_EQ(A.rows(), B.rows());
+    ASSERT_EQ(A.cols(), B.cols());
+    const std::vector<double> SortedA = SortedErrors(A);
+    const std::vector<double> SortedB = SortedErrors(B);
+    for (size_t n = 0; n < SortedA.size(); n++)
+    {
+      EXPECT_NEAR(SortedA.at(n), SortedB.at(n), 1e-12);
+    }
+  }
+
+  /** prior errors from the state memory, without the graph */
+  libRSF::Matrix DirectPriorErrors(libRSF::FactorGraph &Graph, const std::vector<double> &Priors)
+  {
+    libRSF::Matrix Errors(1, StateNumber);
+    for (int n = 0; n < StateNumber; n++)
+    {
+      Errors(0, n) = *Graph.getStateData().getElement(STATE, n).getMeanPointer() - Priors.at(n);
+    }
+    return Errors;
+  }
+
+  /** extracts the prior errors in every iteration of the solve */
+  class ExtractionCallback : public ceres::IterationCallback
+  {
+    public:
+      ExtractionCallback(libRSF::FactorGraph &Graph, const std::vector<double> &Priors) : Graph_(Graph), Priors_(Priors) {}
+      ~ExtractionCallback() override = default;
+
+      ceres::CallbackReturnType operator()(const ceres::IterationSummary &Summary) override
+      {
+        libRSF::Matrix Errors;
+        Graph_.computeUnweightedErrorMatrix(libRSF::FactorType::Prior1, Errors);
+        ExpectSameErrors(Errors, DirectPriorErrors(Graph_, Priors_));
+        Calls_++;
+        return ceres::SOLVER_CONTINUE;
+      }
+
+      [[nodiscard]] int countCalls() const
+      {
+        return Calls_;
+      }
+
+    private:
+      libRSF::FactorGraph &Graph_;
+      const std::vector<double> &Priors_;
+      int Calls_ = 0;
+  };
+}
+
+TEST(UnweightedErrors, Concurrent_Factor_Types)
+{
+  std::mt19937 Generator(42);
+  libRSF::FactorGraph Graph;
+  BuildChain(Graph, Generator);
+
+  /** sequential reference, which also fills the cache */
+  libRSF::Matrix PriorReference, BetweenReference;
+  Graph.computeUnweightedErrorMatrix(libRSF::FactorType::Prior1, PriorReference);
+  Graph.computeUnweightedErrorMatrix(libRSF::FactorType::BetweenValue1, BetweenReference);
+  ASSERT_EQ(PriorReference.cols(), StateNumber);
+  ASSERT_EQ(BetweenReference.cols(), StateNumber - 1);
+
+  std::uniform_int_distribution<int> Index(0, StateNumber - 1);
+  std::normal_distribution<double> Normal(0.0, 1.0);
+  for (int nRound = 0; nRound < 20; nRound++)
+  {
+    /** changed states turn a part of the entries into misses, so both threads look up and store */
+    for (int n = 0; n < StateNumber / 10; n++)
+    {
+      Graph.getStateData().getElement(STATE, Index(Generator)).setMean(libRSF::Vector1::Constant(Normal(Generator)));
+    }
+
+    libRSF::Matrix PriorErrors, BetweenErrors;
+    std::thread PriorThread([&Graph, &PriorErrors]()
+    {
+      Graph.computeUnweightedErrorMatrix(libRSF::FactorType::Prior1, PriorErrors);
+    });
+    std::thread BetweenThread([&Graph, &BetweenErrors]()
+    {
+      Graph.computeUnweightedErrorMatrix(libRSF::FactorType::BetweenValue1, BetweenErrors);
+    });
+    PriorThread.join();
+    BetweenThread.join();
+
+    /** the same as a sequential extraction after the change */
+    Graph.computeUnweightedErrorMatrix(libRSF::FactorType::Prior1, PriorReference);
+    Graph.computeUnweightedErrorMatrix(libRSF::FactorType::BetweenValue1, BetweenReference);
+    ExpectSameErrors(PriorErrors, PriorReference);
+    ExpectSameErrors(BetweenErrors, BetweenReference);
+  }
+}
+
+TEST(UnweightedErrors, Callback_During_Solve)
+{
+  std::mt19937 Generator(7);
+  libRSF::FactorGraph Graph;
+  BuildChain(Graph, Generator);
+
+  /** the measurements of the priors, to compute the errors directly */
+  std::vector<double> Priors(StateNumber);
+  libRSF::Matrix Errors;
+  Graph.computeUnweightedErrorMatrix(libRSF::FactorType::Prior1, Errors);
+  for (int n = 0; n < StateNumber; n++)
+  {
+    Priors.at(n) = *Graph.getStateData().getElement(STATE, n).getMeanPointer() - Errors(0, n);
+  }
+
+  /** the cache is filled before the solve, as by an adaption */
+  ExpectSameErrors(Errors, DirectPriorErrors(Graph, Priors));
+
+  ExtractionCallback Callback(Graph, Priors);
+  ceres::Solver::Options Options;
+  Options.linear_solver_type = ceres::SPARSE_NORMAL_CHOLESKY;
+  Options.max_num_iterations = 5;
+  Options.update_state_every_iteration = true;
+  Options.callbacks.push_back(&Callback);
+  Graph.solve(Options);
+
+  EXPECT_GT(Callback.countCalls(), 1);
+}
+
+TEST(UnweightedErrors, Raw_Pointer)
+{
+  std::mt19937 Generator(3);
+  libRSF::FactorGraph Graph;
+  BuildChain(Graph, Generator);
+
+  std::vector<double> Priors(StateNumber);
+  libRSF::Matrix Errors;
+  Graph.computeUnweightedErrorMatrix(libRSF::FactorType::Prior1, Errors);
+  for (int n = 0; n < StateNumber; n++)
+  {
+    Priors.at(n) = *Graph.getStateData().getElement(STATE, n).getMeanPointer() - Errors(0, n);
+  }
+
+  /** fill the cache, then move some states through their mean pointers instead of the setters */
+  Graph.computeUnweightedErrorMatrix(libRSF::FactorType::Prior1, Errors);
+  const uint64_t Version = Graph.getStateData().getElement(STATE, 0).getVersion();
+  for (int n = 0; n < StateNumber; n += 7)
+  {
+    *Graph.getStateData().getElement(STATE, n).getMeanPointer() += 1.0;
+  }
+  EXPECT_NE(Graph.getStateData().getElement(STATE, 0).getVersion(), Version);
+
+  /** reading the memory does not count as a change */
+  const uint64_t VersionRead = Graph.getStateData().getElement(STATE, 0).getVersion();
+  EXPECT_NE(Graph.getStateData().getElement(STATE, 0).getMeanPointerConst(), nullptr);
+  EXPECT_EQ(Graph.getStateData().getElement(STATE, 0).getVersion(), VersionRead);
+
+  Graph.computeUnweightedErrorMatrix(libRSF::FactorType::Prior1, Errors);
+  ExpectSameErrors(Errors, DirectPriorErrors(Graph, Priors));
+}